@@ -292,6 +292,9 @@ protected:
     bool lifetime_managed_internally_{
         false}; // some factory classes may deallocate states on their own
     io_priority io_priority_{io_priority::normal};
+    // set when an NVMe passthrough read failed, so that it is retried through
+    // the block layer
+    bool nvme_passthrough_failed_{false};
     std::atomic<AsyncIO *> io_{
         nullptr}; // set at construction if associated with an AsyncIO instance,
                   // which isn't mandatory
@@ -574,6 +577,16 @@ public:
         io_priority_ = v;
     }
 
+    bool nvme_passthrough_failed() const noexcept
+    {
+        return nvme_passthrough_failed_;
+    }
+
+    void set_nvme_passthrough_failed() noexcept
+    {
+        nvme_passthrough_failed_ = true;
+    }
+
     //! The executor instance being used, which may be none.
     AsyncIO *executor() noexcept
     {
@@ -630,6 +643,7 @@ public:
     void reset()
     {
         io_priority_ = io_priority::normal;
+        nvme_passthrough_failed_ = false;
     }
 };
 
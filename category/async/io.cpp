@@ -27,6 +27,7 @@
 #include <category/core/tl_tid.h>
 #include <category/core/unordered_map.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cerrno>
@@ -53,6 +54,7 @@
 #include <liburing.h>
 #include <liburing/io_uring.h>
 #include <linux/ioprio.h>
+#include <linux/nvme_ioctl.h>
 #include <poll.h>
 #include <sys/resource.h> // for setrlimit
 #include <unistd.h>
@@ -87,6 +89,44 @@ namespace detail
     static void *const ASYNC_IO_MSG_PIPE_READY_IO_URING_DATA_MAGIC =
         (void *)(uintptr_t)0xd15ea5eddeadbeef;
 
+    // NVMe passthrough reads complete with a command status rather than a
+    // byte count, so the bytes requested ride in the top bits of the user
+    // data, which are always clear in user space pointers
+    static constexpr unsigned NVME_PASSTHROUGH_BYTES_SHIFT = 48;
+    static_assert(AsyncIO::READ_BUFFER_SIZE < (1U << 16));
+
+    static void *
+    tag_nvme_passthrough_read(void *const uring_data, size_t const bytes)
+    {
+        MONAD_DEBUG_ASSERT(
+            (uintptr_t(uring_data) >> NVME_PASSTHROUGH_BYTES_SHIFT) == 0);
+        MONAD_DEBUG_ASSERT(bytes > 0 && bytes < (1U << 16));
+        return (void *)(uintptr_t(uring_data) |
+                        (uintptr_t(bytes) << NVME_PASSTHROUGH_BYTES_SHIFT));
+    }
+
+    // Prepares an NVMe read command of `buffer` from byte `offset` of the
+    // namespace
+    static void prep_nvme_passthrough_read(
+        io_uring_sqe *const sqe,
+        storage_pool::device::nvme_passthrough_t const &nvme,
+        std::span<std::byte> const buffer, file_offset_t const offset)
+    {
+        io_uring_prep_rw(IORING_OP_URING_CMD, sqe, nvme.fd, nullptr, 0, 0);
+        sqe->cmd_op = NVME_URING_CMD_IO;
+        auto *const cmd = reinterpret_cast<struct nvme_uring_cmd *>(sqe->cmd);
+        memset(cmd, 0, sizeof(*cmd));
+        cmd->opcode = 0x02; // nvme_cmd_read
+        cmd->nsid = nvme.nsid;
+        uint64_t const slba = offset >> nvme.lba_shift;
+        cmd->cdw10 = uint32_t(slba);
+        cmd->cdw11 = uint32_t(slba >> 32);
+        // Number of logical blocks, zero based
+        cmd->cdw12 = uint32_t((buffer.size() >> nvme.lba_shift) - 1);
+        cmd->addr = reinterpret_cast<uint64_t>(buffer.data());
+        cmd->data_len = uint32_t(buffer.size());
+    }
+
     struct AsyncIO_per_thread_state_t::within_completions_holder
     {
         AsyncIO_per_thread_state_t *parent;
@@ -151,6 +191,10 @@ AsyncIO::AsyncIO(class storage_pool &pool, monad::io::Buffers &rwbuf)
     , wr_pool_(monad::io::BufferPool(rwbuf, false))
 {
     extant_write_operations_::init_header(&extant_write_operations_header_);
+    // NVMe passthrough commands need big ring entries
+    constexpr unsigned big_entries = IORING_SETUP_SQE128 | IORING_SETUP_CQE32;
+    nvme_passthrough_reads_ =
+        (uring_.get_ring().flags & big_entries) == big_entries;
     if (wr_uring_ != nullptr) {
         // The write ring must have at least as many submission entries as there
         // are write i/o buffers
@@ -198,6 +242,9 @@ AsyncIO::AsyncIO(class storage_pool &pool, monad::io::Buffers &rwbuf)
     cnv_chunk_ = std::static_pointer_cast<storage_pool::cnv_chunk>(
         pool.activate_chunk(storage_pool::cnv, 0));
     auto count = pool.chunks(storage_pool::seq);
+    auto const write_size = std::max(
+        MONAD_IO_BUFFERS_WRITE_SIZE,
+        rwbuf.is_read_only() ? size_t(0) : rwbuf.get_write_size());
     seq_chunks_.reserve(count);
     std::vector<int> fds;
     fds.reserve(count * 2 + 2);
@@ -209,14 +256,12 @@ AsyncIO::AsyncIO(class storage_pool &pool, monad::io::Buffers &rwbuf)
                 pool.activate_chunk(
                     storage_pool::seq, static_cast<uint32_t>(n))));
         MONAD_ASSERT_PRINTF(
-            seq_chunks_.back().ptr->capacity() >= MONAD_IO_BUFFERS_WRITE_SIZE,
+            seq_chunks_.back().ptr->capacity() >= write_size,
             "sequential chunk capacity %llu must equal or exceed i/o buffer "
             "size %zu",
             seq_chunks_.back().ptr->capacity(),
-            MONAD_IO_BUFFERS_WRITE_SIZE);
-        MONAD_ASSERT(
-            (seq_chunks_.back().ptr->capacity() %
-             MONAD_IO_BUFFERS_WRITE_SIZE) == 0);
+            write_size);
+        MONAD_ASSERT((seq_chunks_.back().ptr->capacity() % write_size) == 0);
         fds.push_back(seq_chunks_[n].io_uring_read_fd);
         fds.push_back(seq_chunks_[n].io_uring_write_fd);
     }
@@ -296,6 +341,55 @@ AsyncIO::~AsyncIO()
     ::close(fds_.msgwrite);
 }
 
+size_t AsyncIO::poll_blocking_for(
+    std::chrono::nanoseconds const timeout, size_t const count)
+{
+    MONAD_ASSERT(timeout.count() > 0);
+    poll_blocking_timeout_ = timeout;
+    auto const n = poll_blocking(count);
+    poll_blocking_timeout_ = std::chrono::nanoseconds{0};
+    return n;
+}
+
+bool AsyncIO::wake() noexcept
+{
+    if (!wake_supported()) {
+        return false;
+    }
+    // Coalesce wakeups so the blocking pipe can never fill up
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        erased_connected_operation *const msg = nullptr;
+        auto const written = ::write(fds_.msgwrite, &msg, sizeof(msg));
+        MONAD_ASSERT_PRINTF(
+            written == sizeof(msg), "failed due to %s", std::strerror(errno));
+    }
+    return true;
+}
+
+erased_connected_operation *AsyncIO::next_pending_read_io_() noexcept
+{
+    using prio = enum erased_connected_operation::io_priority;
+    auto &highest = concurrent_read_ios_pending_[size_t(prio::highest)];
+    auto &normal = concurrent_read_ios_pending_[size_t(prio::normal)];
+    auto &idle = concurrent_read_ios_pending_[size_t(prio::idle)];
+    if (highest.first != nullptr) {
+        return highest.pop_front();
+    }
+    bool const idle_may_go = idle.first != nullptr &&
+                             records_.inflight_rd_idle < idle_read_io_limit_();
+    if (normal.first != nullptr &&
+        (!idle_may_go ||
+         normal_reads_since_idle_read_ < NORMAL_READS_PER_IDLE_READ)) {
+        ++normal_reads_since_idle_read_;
+        return normal.pop_front();
+    }
+    if (idle_may_go) {
+        normal_reads_since_idle_read_ = 0;
+        return idle.pop_front();
+    }
+    return nullptr;
+}
+
 void AsyncIO::submit_request_(
     std::span<std::byte> buffer, chunk_offset_t chunk_and_offset,
     void *uring_data, enum erased_connected_operation::io_priority prio)
@@ -312,24 +406,40 @@ void AsyncIO::submit_request_(
     MONAD_ASSERT(sqe);
 
     auto const &ci = seq_chunks_[chunk_and_offset.id];
-    io_uring_prep_read_fixed(
-        sqe,
-        ci.io_uring_read_fd,
-        buffer.data(),
-        static_cast<unsigned int>(buffer.size()),
-        ci.ptr->read_fd().second + chunk_and_offset.offset,
-        0);
-    sqe->flags |= IOSQE_FIXED_FILE;
-    switch (prio) {
-    case erased_connected_operation::io_priority::highest:
-        sqe->ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_RT, 7);
-        break;
-    case erased_connected_operation::io_priority::idle:
-        sqe->ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0);
-        break;
-    default:
-        sqe->ioprio = 0;
-        break;
+    auto const offset = ci.ptr->read_fd().second + chunk_and_offset.offset;
+    auto const *const nvme =
+        nvme_passthrough_reads_ &&
+                !static_cast<erased_connected_operation *>(uring_data)
+                     ->nvme_passthrough_failed()
+            ? ci.ptr->device().nvme_passthrough()
+            : nullptr;
+    if (nvme != nullptr && buffer.size() <= nvme->max_transfer_bytes &&
+        ((offset | buffer.size()) & ((1ULL << nvme->lba_shift) - 1)) == 0) {
+        // Bypass the block layer, the NVMe driver ignores i/o priority
+        detail::prep_nvme_passthrough_read(sqe, *nvme, buffer, offset);
+        uring_data =
+            detail::tag_nvme_passthrough_read(uring_data, buffer.size());
+    }
+    else {
+        io_uring_prep_read_fixed(
+            sqe,
+            ci.io_uring_read_fd,
+            buffer.data(),
+            static_cast<unsigned int>(buffer.size()),
+            offset,
+            0);
+        sqe->flags |= IOSQE_FIXED_FILE;
+        switch (prio) {
+        case erased_connected_operation::io_priority::highest:
+            sqe->ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_RT, 7);
+            break;
+        case erased_connected_operation::io_priority::idle:
+            sqe->ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0);
+            break;
+        default:
+            sqe->ioprio = 0;
+            break;
+        }
     }
 
     io_uring_sqe_set_data(sqe, uring_data);
@@ -354,7 +464,19 @@ void AsyncIO::submit_request_(
     MONAD_ASSERT(sqe);
 
     auto const &ci = seq_chunks_[chunk_and_offset.id];
-    if (buffers.size() == 1) {
+    if (buffers.size() == 1 &&
+        rwbuf_.is_within_read_region(
+            buffers.front().iov_base, buffers.front().iov_len)) {
+        // Already pinned by registration, skip the per-i/o page pinning
+        io_uring_prep_read_fixed(
+            sqe,
+            ci.io_uring_read_fd,
+            buffers.front().iov_base,
+            static_cast<unsigned int>(buffers.front().iov_len),
+            ci.ptr->read_fd().second + chunk_and_offset.offset,
+            monad::io::Buffers::get_read_index());
+    }
+    else if (buffers.size() == 1) {
         io_uring_prep_read(
             sqe,
             ci.io_uring_read_fd,
@@ -394,7 +516,7 @@ void AsyncIO::submit_request_(
     MONAD_DEBUG_ASSERT(uring_data != nullptr);
     MONAD_ASSERT(!rwbuf_.is_read_only());
     MONAD_DEBUG_ASSERT((chunk_and_offset.offset & (DISK_PAGE_SIZE - 1)) == 0);
-    MONAD_DEBUG_ASSERT(buffer.size() <= WRITE_BUFFER_SIZE);
+    MONAD_DEBUG_ASSERT(buffer.size() <= rwbuf_.get_write_size());
 
     auto const &ci = seq_chunks_[chunk_and_offset.id];
     auto offset = ci.ptr->write_fd(buffer.size()).second;
@@ -492,26 +614,13 @@ size_t AsyncIO::poll_uring_(bool blocking, unsigned poll_rings_mask)
         if (concurrent_read_io_limit_ > 0) {
             auto const max_cq_entries =
                 eager_completions_ ? 0 : (*other_ring->cq.kring_entries >> 1);
-            for (auto *state = concurrent_read_ios_pending_.first;
-                 state != nullptr;
-                 state = concurrent_read_ios_pending_.first) {
-                if (records_.inflight_rd >= concurrent_read_io_limit_ ||
-                    io_uring_sq_space_left(other_ring) == 0 ||
-                    io_uring_cq_ready(other_ring) > max_cq_entries) {
+            while (records_.inflight_rd < concurrent_read_io_limit_ &&
+                   io_uring_sq_space_left(other_ring) != 0 &&
+                   io_uring_cq_ready(other_ring) <= max_cq_entries) {
+                auto *const state = next_pending_read_io_();
+                if (state == nullptr) {
                     break;
                 }
-                auto *next =
-                    erased_connected_operation::rbtree_node_traits::get_right(
-                        state);
-                if (next == nullptr) {
-                    MONAD_DEBUG_ASSERT(concurrent_read_ios_pending_.count == 1);
-                    concurrent_read_ios_pending_.first =
-                        concurrent_read_ios_pending_.last = nullptr;
-                }
-                else {
-                    concurrent_read_ios_pending_.first = next;
-                }
-                concurrent_read_ios_pending_.count--;
                 state->reinitiate();
             }
         }
@@ -562,7 +671,26 @@ size_t AsyncIO::poll_uring_(bool blocking, unsigned poll_rings_mask)
             }
             if (blocking && inflight_ts == 0 && records_.inflight_wr == 0 &&
                 detail::AsyncIO_per_thread_state().empty()) {
-                MONAD_ASYNC_IO_URING_RETRYABLE(io_uring_wait_cqe(ring, &cqe));
+                if (poll_blocking_timeout_.count() == 0) {
+                    MONAD_ASYNC_IO_URING_RETRYABLE(
+                        io_uring_wait_cqe(ring, &cqe));
+                }
+                else {
+                    auto const ns = poll_blocking_timeout_.count();
+                    __kernel_timespec ts{};
+                    ts.tv_sec = ns / 1000000000;
+                    ts.tv_nsec = ns % 1000000000;
+                    int r;
+                    do {
+                        r = io_uring_wait_cqe_timeout(ring, &cqe, &ts);
+                    }
+                    while (r == -EINTR);
+                    if (r == -ETIME) {
+                        return false;
+                    }
+                    MONAD_ASSERT_PRINTF(
+                        r == 0, "failed due to %s", std::strerror(-r));
+                }
             }
             else {
                 // If nothing in io_uring and there are no threadsafe ops in
@@ -597,6 +725,15 @@ size_t AsyncIO::poll_uring_(bool blocking, unsigned poll_rings_mask)
                 // Writes flushed in the submitting thread must be acquired now
                 // before state can be dereferenced
                 std::atomic_thread_fence(std::memory_order_acquire);
+                if (state == nullptr) {
+                    // Sent by wake(), there is nothing to complete
+                    wake_pending_.exchange(false, std::memory_order_acq_rel);
+                    if (cqe != nullptr) {
+                        io_uring_cqe_seen(ring, cqe);
+                        cqe = nullptr;
+                    }
+                    return true;
+                }
             }
             else {
                 if (EAGAIN == errno || EWOULDBLOCK == errno) {
@@ -613,9 +750,29 @@ size_t AsyncIO::poll_uring_(bool blocking, unsigned poll_rings_mask)
             }
         }
         else {
-            state = reinterpret_cast<erased_connected_operation *>(data);
-            res = (cqe->res < 0) ? result<size_t>(posix_code(-cqe->res))
-                                 : result<size_t>(cqe->res);
+            auto const nvme_bytes =
+                uintptr_t(data) >> detail::NVME_PASSTHROUGH_BYTES_SHIFT;
+            if (nvme_bytes != 0) {
+                state = reinterpret_cast<erased_connected_operation *>(
+                    uintptr_t(data) &
+                    ((uintptr_t(1) << detail::NVME_PASSTHROUGH_BYTES_SHIFT) -
+                     1));
+                if (cqe->res == 0) {
+                    res = result<size_t>(nvme_bytes);
+                }
+                else {
+                    // A positive result is an NVMe status code, which has no
+                    // errno. Retried through the block layer, the read either
+                    // succeeds or fails with one.
+                    state->set_nvme_passthrough_failed();
+                    res = result<size_t>(posix_code(EAGAIN));
+                }
+            }
+            else {
+                state = reinterpret_cast<erased_connected_operation *>(data);
+                res = (cqe->res < 0) ? result<size_t>(posix_code(-cqe->res))
+                                     : result<size_t>(cqe->res);
+            }
         }
         if (cqe != nullptr) {
             io_uring_cqe_seen(ring, cqe);
@@ -654,10 +811,20 @@ size_t AsyncIO::poll_uring_(bool blocking, unsigned poll_rings_mask)
         bool is_read_or_write = false;
         if (state->is_read()) {
             --records_.inflight_rd;
+            if (state->io_priority() ==
+                erased_connected_operation::io_priority::idle) {
+                --records_.inflight_rd_idle;
+            }
             is_read_or_write = true;
             if (retry_operation_if_temporary_failure()) {
                 return true;
             }
+            if (read_io_limit_controller_ && capture_io_latencies_) {
+                if (auto const limit =
+                        read_io_limit_controller_->record(state->elapsed)) {
+                    concurrent_read_io_limit_ = *limit;
+                }
+            }
             // Speculative read i/o deque
             dequeue_concurrent_read_ios_pending();
         }
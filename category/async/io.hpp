@@ -17,6 +17,7 @@
 
 #include <category/async/connected_operation.hpp>
 
+#include <category/async/read_io_limit_controller.hpp>
 #include <category/async/storage_pool.hpp>
 
 #include <category/core/io/buffer_pool.hpp>
@@ -25,13 +26,18 @@
 
 #include <category/core/mem/allocators.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <concepts>
 #include <cstddef>
 #include <filesystem>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <span>
 #include <tuple>
 
@@ -43,6 +49,8 @@ class read_single_buffer_sender;
 struct IORecord
 {
     unsigned inflight_rd{0};
+    // of inflight_rd, those at io_priority::idle
+    unsigned inflight_rd_idle{0};
     unsigned inflight_rd_scatter{0};
     unsigned inflight_wr{0};
     unsigned inflight_tm{0};
@@ -100,16 +108,92 @@ private:
     monad::io::BufferPool wr_pool_;
     bool eager_completions_{false};
     bool capture_io_latencies_{false};
+    // single buffer reads of NVMe passthrough devices bypass the block layer
+    bool nvme_passthrough_reads_{false};
+    // set by wake() until the polling thread consumes the wakeup message
+    std::atomic<bool> wake_pending_{false};
+    // bounds blocking waits on the read ring when nonzero
+    std::chrono::nanoseconds poll_blocking_timeout_{0};
 
     // IO records
     IORecord records_;
     unsigned concurrent_read_io_limit_{0};
+    // when set, drives concurrent_read_io_limit_ from read latencies.
+    // Held out of line, as its latency window is larger than the rest
+    // of AsyncIO put together.
+    std::unique_ptr<ReadIOLimitController> read_io_limit_controller_;
 
-    struct
+    // Reads held back by concurrent_read_io_limit_, one FIFO per io_priority
+    // so that background reads queue behind execution reads
+    struct concurrent_read_ios_pending_queue_
     {
         unsigned count{0};
         erased_connected_operation *first{nullptr}, *last{nullptr};
-    } concurrent_read_ios_pending_;
+
+        void push_back(erased_connected_operation *const state) noexcept
+        {
+            using traits = erased_connected_operation::rbtree_node_traits;
+            traits::set_right(state, nullptr);
+            if (last == nullptr) {
+                MONAD_DEBUG_ASSERT(first == nullptr);
+                MONAD_DEBUG_ASSERT(count == 0);
+                first = last = state;
+            }
+            else {
+                MONAD_DEBUG_ASSERT(traits::get_right(last) == nullptr);
+                traits::set_right(last, state);
+                last = state;
+            }
+            count++;
+        }
+
+        erased_connected_operation *pop_front() noexcept
+        {
+            auto *const state = first;
+            MONAD_DEBUG_ASSERT(state != nullptr);
+            auto *const next =
+                erased_connected_operation::rbtree_node_traits::get_right(
+                    state);
+            if (next == nullptr) {
+                MONAD_DEBUG_ASSERT(count == 1);
+                first = last = nullptr;
+            }
+            else {
+                first = next;
+            }
+            count--;
+            return state;
+        }
+    };
+
+    std::array<concurrent_read_ios_pending_queue_, 3>
+        concurrent_read_ios_pending_;
+    // normal priority reads dispatched since the last idle one
+    unsigned normal_reads_since_idle_read_{0};
+
+    // Out of the pending queues, at most one idle read is dispatched for
+    // every NORMAL_READS_PER_IDLE_READ normal reads while both are waiting,
+    // and idle reads may hold at most 1/IDLE_READ_LIMIT_DIVISOR of the
+    // concurrent read limit. Highest priority reads always go first.
+    static constexpr unsigned NORMAL_READS_PER_IDLE_READ = 8;
+    static constexpr unsigned IDLE_READ_LIMIT_DIVISOR = 4;
+
+    unsigned concurrent_read_ios_pending_count_() const noexcept
+    {
+        unsigned count = 0;
+        for (auto const &queue : concurrent_read_ios_pending_) {
+            count += queue.count;
+        }
+        return count;
+    }
+
+    unsigned idle_read_io_limit_() const noexcept
+    {
+        return std::max(
+            1U, concurrent_read_io_limit_ / IDLE_READ_LIMIT_DIVISOR);
+    }
+
+    erased_connected_operation *next_pending_read_io_() noexcept;
 
     void submit_request_(
         std::span<std::byte> buffer, chunk_offset_t chunk_and_offset,
@@ -152,6 +236,13 @@ public:
         return *storage_pool_;
     }
 
+    //! Bytes carried by each write i/o, which is the size of the write
+    //! buffers this instance was constructed with
+    size_t write_buffer_size() const noexcept
+    {
+        return rwbuf_.is_read_only() ? 0 : rwbuf_.get_write_size();
+    }
+
     size_t chunk_count() const noexcept
     {
         return seq_chunks_.size();
@@ -175,7 +266,7 @@ public:
 
     unsigned io_in_flight() const noexcept
     {
-        return records_.inflight_rd + concurrent_read_ios_pending_.count +
+        return records_.inflight_rd + concurrent_read_ios_pending_count_() +
                records_.inflight_rd_scatter + records_.inflight_wr +
                records_.inflight_tm +
                records_.inflight_ts.load(std::memory_order_relaxed) +
@@ -184,7 +275,7 @@ public:
 
     unsigned reads_in_flight() const noexcept
     {
-        return records_.inflight_rd + concurrent_read_ios_pending_.count;
+        return records_.inflight_rd + concurrent_read_ios_pending_count_();
     }
 
     unsigned max_reads_in_flight() const noexcept
@@ -202,6 +293,12 @@ public:
         return records_.max_inflight_rd_scatter;
     }
 
+    //! Reads submitted since construction or the last `reset_records()`
+    unsigned reads_submitted() const noexcept
+    {
+        return records_.nreads;
+    }
+
     unsigned writes_in_flight() const noexcept
     {
         return records_.inflight_wr;
@@ -234,6 +331,32 @@ public:
         concurrent_read_io_limit_ = v;
     }
 
+    //! \brief Let the concurrent read limit float between the configured
+    //! bounds so as to hold read p99 latency at the target. Enables latency
+    //! capture, as the controller feeds on it.
+    void enable_adaptive_read_io_limit(
+        ReadIOLimitController::Config const &config)
+    {
+        read_io_limit_controller_ =
+            std::make_unique<ReadIOLimitController>(config);
+        concurrent_read_io_limit_ = read_io_limit_controller_->state().limit;
+        capture_io_latencies_ = true;
+    }
+
+    void disable_adaptive_read_io_limit() noexcept
+    {
+        read_io_limit_controller_.reset();
+    }
+
+    std::optional<ReadIOLimitController::State>
+    adaptive_read_io_limit_state() const noexcept
+    {
+        if (!read_io_limit_controller_) {
+            return std::nullopt;
+        }
+        return read_io_limit_controller_->state();
+    }
+
     bool eager_completions() const noexcept
     {
         return eager_completions_;
@@ -277,6 +400,21 @@ public:
         return n;
     }
 
+    // As `poll_blocking()`, but gives up after `timeout` and returns zero.
+    // Also returns early if another thread calls `wake()`.
+    size_t
+    poll_blocking_for(std::chrono::nanoseconds timeout, size_t count = 1);
+
+    // Threadsafe. Wakes the owning thread if it is blocked polling the read
+    // ring. Returns false if this instance cannot be woken this way, which is
+    // the case when i/o polling is enabled.
+    bool wake() noexcept;
+
+    bool wake_supported() const noexcept
+    {
+        return fds_.msgwrite != -1;
+    }
+
     std::optional<size_t>
     poll_blocking_if_not_within_completions(size_t count = 1)
     {
@@ -333,28 +471,15 @@ public:
         std::span<std::byte> buffer, chunk_offset_t offset,
         erased_connected_operation *uring_data)
     {
+        auto const prio = uring_data->io_priority();
+        bool const is_idle =
+            prio == erased_connected_operation::io_priority::idle;
         if (concurrent_read_io_limit_ > 0) {
-            if (records_.inflight_rd >= concurrent_read_io_limit_) {
-                auto *state = (erased_connected_operation *)uring_data;
-                erased_connected_operation::rbtree_node_traits::set_right(
-                    state, nullptr);
-                if (concurrent_read_ios_pending_.last == nullptr) {
-                    MONAD_DEBUG_ASSERT(
-                        concurrent_read_ios_pending_.first == nullptr);
-                    concurrent_read_ios_pending_.first =
-                        concurrent_read_ios_pending_.last = state;
-                    MONAD_DEBUG_ASSERT(concurrent_read_ios_pending_.count == 0);
-                }
-                else {
-                    MONAD_DEBUG_ASSERT(
-                        erased_connected_operation::rbtree_node_traits::
-                            get_right(concurrent_read_ios_pending_.last) ==
-                        nullptr);
-                    erased_connected_operation::rbtree_node_traits::set_right(
-                        concurrent_read_ios_pending_.last, state);
-                    concurrent_read_ios_pending_.last = state;
-                }
-                concurrent_read_ios_pending_.count++;
+            if (records_.inflight_rd >= concurrent_read_io_limit_ ||
+                (is_idle &&
+                 records_.inflight_rd_idle >= idle_read_io_limit_())) {
+                concurrent_read_ios_pending_[static_cast<size_t>(prio)]
+                    .push_back(uring_data);
                 return size_t(-1); // we never complete immediately
             }
         }
@@ -362,10 +487,13 @@ public:
         if (capture_io_latencies_) {
             uring_data->initiated = std::chrono::steady_clock::now();
         }
-        submit_request_(buffer, offset, uring_data, uring_data->io_priority());
+        submit_request_(buffer, offset, uring_data, prio);
         if (++records_.inflight_rd > records_.max_inflight_rd) {
             records_.max_inflight_rd = records_.inflight_rd;
         }
+        if (is_idle) {
+            ++records_.inflight_rd_idle;
+        }
         ++records_.nreads;
         return size_t(-1); // we never complete immediately
     }
@@ -668,7 +796,7 @@ private:
 using erased_connected_operation_ptr =
     AsyncIO::erased_connected_operation_unique_ptr_type;
 
-static_assert(sizeof(AsyncIO) == 224);
+static_assert(sizeof(AsyncIO) == 296);
 static_assert(alignof(AsyncIO) == 8);
 
 namespace detail
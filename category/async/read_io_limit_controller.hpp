@@ -0,0 +1,116 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+#include <category/async/config.hpp>
+#include <category/core/assert.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+MONAD_ASYNC_NAMESPACE_BEGIN
+
+/*! \brief Additive-increase/multiplicative-decrease controller for the number
+of concurrent reads `AsyncIO` may have in flight.
+
+Completion latencies are collected into fixed size windows. When a window
+fills, its p99 is compared with the target: above it the limit is cut by
+`decrease_factor`, at or below it the limit grows by `increase_step`. The
+limit always stays within `[min_limit, max_limit]`.
+*/
+class ReadIOLimitController
+{
+public:
+    static constexpr size_t WINDOW = 512;
+
+    struct Config
+    {
+        std::chrono::nanoseconds target_p99{std::chrono::microseconds(500)};
+        unsigned min_limit{16};
+        unsigned max_limit{1024};
+        unsigned increase_step{8};
+        double decrease_factor{0.75};
+    };
+
+    struct State
+    {
+        unsigned limit{0};
+        std::chrono::nanoseconds last_p99{0};
+        uint64_t windows{0};
+        uint64_t increases{0};
+        uint64_t decreases{0};
+    };
+
+private:
+    Config config_;
+    State state_;
+    std::array<std::chrono::nanoseconds, WINDOW> samples_;
+    size_t count_{0};
+
+public:
+    explicit ReadIOLimitController(Config const &config)
+        : config_(config)
+    {
+        MONAD_ASSERT(
+            config_.min_limit > 0 && config_.min_limit <= config_.max_limit);
+        MONAD_ASSERT(
+            config_.decrease_factor > 0 && config_.decrease_factor < 1);
+        state_.limit = config_.max_limit;
+    }
+
+    Config const &config() const noexcept
+    {
+        return config_;
+    }
+
+    State const &state() const noexcept
+    {
+        return state_;
+    }
+
+    //! \brief Records the latency of one completed read, returning the new
+    //! limit if this sample closed a window.
+    std::optional<unsigned> record(std::chrono::nanoseconds const latency)
+    {
+        samples_[count_++] = latency;
+        if (count_ < WINDOW) {
+            return std::nullopt;
+        }
+        count_ = 0;
+        auto const p99 = samples_.begin() + (WINDOW * 99) / 100;
+        std::nth_element(samples_.begin(), p99, samples_.end());
+        state_.last_p99 = *p99;
+        ++state_.windows;
+        if (state_.last_p99 > config_.target_p99) {
+            state_.limit = std::max(
+                config_.min_limit,
+                static_cast<unsigned>(
+                    state_.limit * config_.decrease_factor));
+            ++state_.decreases;
+        }
+        else if (state_.limit < config_.max_limit) {
+            state_.limit = std::min(
+                config_.max_limit, state_.limit + config_.increase_step);
+            ++state_.increases;
+        }
+        return state_.limit;
+    }
+};
+
+MONAD_ASYNC_NAMESPACE_END
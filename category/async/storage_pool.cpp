@@ -24,19 +24,26 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <span>
 #include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -47,14 +54,76 @@
 #include <fcntl.h>
 #include <linux/falloc.h>
 #include <linux/limits.h>
+#include <linux/nvme_ioctl.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/sysmacros.h>
 #include <unistd.h>
 
 MONAD_ASYNC_NAMESPACE_BEGIN
 
+namespace
+{
+    // Opens the NVMe generic character device (e.g. /dev/ng0n1) matching the
+    // block device (e.g. /dev/nvme0n1) open as `fd`. Partitions are refused,
+    // as passthrough commands address the whole namespace.
+    storage_pool::device::nvme_passthrough_t open_nvme_passthrough(int const fd)
+    {
+        storage_pool::device::nvme_passthrough_t ret;
+        struct stat stat;
+        if (-1 == ::fstat(fd, &stat) || (stat.st_mode & S_IFMT) != S_IFBLK) {
+            return ret;
+        }
+        char sysfs[64];
+        snprintf(
+            sysfs,
+            sizeof(sysfs),
+            "/sys/dev/block/%u:%u",
+            major(stat.st_rdev),
+            minor(stat.st_rdev));
+        std::error_code ec;
+        auto const name =
+            std::filesystem::read_symlink(sysfs, ec).filename().string();
+        if (ec || !name.starts_with("nvme") ||
+            name.find('p') != std::string::npos) {
+            return ret;
+        }
+        int const nsid = ::ioctl(fd, NVME_IOCTL_ID);
+        if (nsid <= 0) {
+            return ret;
+        }
+        unsigned lba_size = 0;
+        if (::ioctl(fd, _IO(0x12, 104) /*BLKSSZGET*/, &lba_size) != 0 ||
+            !std::has_single_bit(lba_size)) {
+            return ret;
+        }
+        unsigned max_hw_sectors_kb = 0;
+        auto const queue = "/sys/block/" + name + "/queue/max_hw_sectors_kb";
+        if (FILE *const f = ::fopen(queue.c_str(), "r")) {
+            if (::fscanf(f, "%u", &max_hw_sectors_kb) != 1) {
+                max_hw_sectors_kb = 0;
+            }
+            (void)::fclose(f);
+        }
+        if (max_hw_sectors_kb < (lba_size >> 10)) {
+            return ret;
+        }
+        auto const path = "/dev/ng" + name.substr(4);
+        ret.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (ret.fd == -1) {
+            return ret;
+        }
+        ret.nsid = uint32_t(nsid);
+        ret.lba_shift = uint32_t(std::countr_zero(lba_size));
+        ret.max_transfer_bytes = uint32_t(
+            std::min(uint64_t(max_hw_sectors_kb) << 10, uint64_t(UINT32_MAX)));
+        return ret;
+    }
+}
+
 std::filesystem::path storage_pool::device::current_path() const
 {
     std::filesystem::path::string_type ret;
@@ -492,12 +561,24 @@ storage_pool::device storage_pool::make_device_(
     if (auto const **const dev = std::get_if<1>(&dev_no_or_dev)) {
         unique_hash = (*dev)->unique_hash_;
     }
+    device::nvme_passthrough_t nvme_passthrough;
+    if (flags.nvme_passthrough && type == device::type_t_::block_device) {
+        nvme_passthrough = open_nvme_passthrough(readwritefd);
+        if (nvme_passthrough.fd == -1) {
+            fprintf(
+                stderr,
+                "WARNING: Storage pool source %s does not support NVMe "
+                "passthrough, using ordinary reads\n",
+                path.string().c_str());
+        }
+    }
     return device(
         readwritefd,
         type,
         unique_hash,
         static_cast<size_t>(stat.st_size),
-        metadata);
+        metadata,
+        nvme_passthrough);
 }
 
 void storage_pool::fill_chunks_(creation_flags const &flags)
@@ -621,6 +702,220 @@ void storage_pool::fill_chunks_(creation_flags const &flags)
     }
 }
 
+struct storage_pool::discard_queue_
+{
+    // Discards of more chunks than this are split, so a reclaimed chunk never
+    // waits long for the batch it is in
+    static constexpr size_t MAX_BATCH_CHUNKS = 16;
+
+    std::mutex lock;
+    std::condition_variable cond;
+    // Not yet taken by the worker
+    std::vector<std::shared_ptr<class chunk>> pending;
+    // Being discarded by the worker right now
+    std::vector<std::shared_ptr<class chunk>> in_flight;
+    file_offset_t bytes_per_second{1ULL << 30};
+    // Set when the rate limit is to be ignored until pending is empty
+    bool draining{false};
+    bool done{false};
+    std::thread worker;
+
+    ~discard_queue_()
+    {
+        {
+            std::unique_lock const g(lock);
+            draining = true;
+            done = true;
+        }
+        cond.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    bool is_pending_reset(class chunk const &chunk) const noexcept
+    {
+        auto const is = [&](auto const &p) { return p.get() == &chunk; };
+        return std::any_of(pending.begin(), pending.end(), is) ||
+               std::any_of(in_flight.begin(), in_flight.end(), is);
+    }
+
+    // Moves the run of chunks contiguous on one device at the lowest offset
+    // pending into `in_flight`
+    void take_batch()
+    {
+        std::sort(
+            pending.begin(), pending.end(), [](auto const &a, auto const &b) {
+                if (&a->device() != &b->device()) {
+                    return std::less<>{}(&a->device(), &b->device());
+                }
+                return a->offset_ < b->offset_;
+            });
+        auto end = pending.begin() + 1;
+        while (end != pending.end() &&
+               size_t(end - pending.begin()) < MAX_BATCH_CHUNKS &&
+               &(*end)->device() == &pending.front()->device() &&
+               (*(end - 1))->offset_ + (*(end - 1))->capacity_ ==
+                   (*end)->offset_) {
+            ++end;
+        }
+        in_flight.assign(
+            std::make_move_iterator(pending.begin()),
+            std::make_move_iterator(end));
+        pending.erase(pending.begin(), end);
+    }
+
+    // Releases the backing storage of `in_flight` in a single discard
+    void discard_in_flight() const
+    {
+        auto const &front = *in_flight.front();
+        auto const offset = front.offset_;
+        auto const bytes = in_flight.back()->offset_ +
+                           in_flight.back()->capacity_ - front.offset_;
+        MONAD_DEBUG_ASSERT(offset <= std::numeric_limits<off_t>::max());
+        MONAD_DEBUG_ASSERT(bytes <= std::numeric_limits<off_t>::max());
+        if (front.device().is_file()) {
+            MONAD_ASSERT_PRINTF(
+                -1 != ::fallocate(
+                          front.write_fd_,
+                          FALLOC_FL_KEEP_SIZE | FALLOC_FL_PUNCH_HOLE,
+                          static_cast<off_t>(offset),
+                          static_cast<off_t>(bytes)),
+                "failed due to %s",
+                std::strerror(errno));
+            return;
+        }
+        if (front.device().is_block_device()) {
+            uint64_t range[2] = {offset, bytes};
+            MONAD_DEBUG_ASSERT((range[0] & (DISK_PAGE_SIZE - 1)) == 0);
+            MONAD_DEBUG_ASSERT((range[1] & (DISK_PAGE_SIZE - 1)) == 0);
+            MONAD_ASSERT_PRINTF(
+                !ioctl(front.write_fd_, _IO(0x12, 119) /*BLKDISCARD*/, &range),
+                "failed due to %s",
+                std::strerror(errno));
+            return;
+        }
+        MONAD_ABORT("zonefs support isn't implemented yet");
+    }
+
+    void run()
+    {
+        pthread_setname_np(pthread_self(), "storage discard");
+        std::unique_lock g(lock);
+        for (;;) {
+            cond.wait(g, [&] { return done || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            take_batch();
+            g.unlock();
+            discard_in_flight();
+            g.lock();
+            auto const bytes = in_flight.back()->offset_ +
+                               in_flight.back()->capacity_ -
+                               in_flight.front()->offset_;
+            in_flight.clear();
+            cond.notify_all();
+            if (!draining && bytes_per_second != 0) {
+                // Pace the device so it can keep up with foreground i/o
+                cond.wait_for(
+                    g,
+                    std::chrono::microseconds(
+                        int64_t(bytes * 1000000 / bytes_per_second)),
+                    [&] { return draining; });
+            }
+            if (pending.empty()) {
+                draining = done;
+            }
+        }
+    }
+};
+
+void storage_pool::destroy_contents_deferred(std::shared_ptr<class chunk> chunk)
+{
+    MONAD_ASSERT(discard_ != nullptr);
+    MONAD_ASSERT(chunk);
+    if (!chunk->device().is_file() && !chunk->device().is_block_device()) {
+        MONAD_ABORT("zonefs support isn't implemented yet");
+    }
+    if (chunk->append_only_) {
+        auto const *metadata = chunk->device().metadata_;
+        auto const chunk_bytes_used =
+            metadata->chunk_bytes_used(chunk->device().size_of_file_);
+        chunk_bytes_used[chunk->chunkid_within_device_].store(
+            0, std::memory_order_release);
+    }
+    auto &q = *discard_;
+    {
+        std::unique_lock const g(q.lock);
+        if (q.is_pending_reset(*chunk)) {
+            return;
+        }
+        q.pending.push_back(std::move(chunk));
+        if (!q.worker.joinable()) {
+            q.worker = std::thread([&q] { q.run(); });
+        }
+    }
+    q.cond.notify_all();
+}
+
+void storage_pool::reclaim_pending_reset(class chunk const &chunk)
+{
+    if (discard_ == nullptr) {
+        return;
+    }
+    auto &q = *discard_;
+    std::unique_lock g(q.lock);
+    std::erase_if(
+        q.pending, [&](auto const &p) { return p.get() == &chunk; });
+    q.cond.wait(g, [&] { return !q.is_pending_reset(chunk); });
+}
+
+std::vector<uint32_t>
+storage_pool::discarding_chunks(chunk_type const which) const
+{
+    std::vector<uint32_t> ids;
+    if (discard_ == nullptr) {
+        return ids;
+    }
+    std::unique_lock const g(discard_->lock);
+    for (auto const &chunk : discard_->in_flight) {
+        auto const [type, id] = chunk->zone_id();
+        if (type == which) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+size_t storage_pool::pending_resets() const
+{
+    if (discard_ == nullptr) {
+        return 0;
+    }
+    std::unique_lock const g(discard_->lock);
+    return discard_->pending.size() + discard_->in_flight.size();
+}
+
+void storage_pool::wait_for_pending_resets()
+{
+    if (discard_ == nullptr) {
+        return;
+    }
+    auto &q = *discard_;
+    std::unique_lock g(q.lock);
+    q.draining = true;
+    q.cond.notify_all();
+    q.cond.wait(g, [&] { return q.pending.empty() && q.in_flight.empty(); });
+}
+
+void storage_pool::set_discard_rate_limit(file_offset_t const bytes_per_second)
+{
+    MONAD_ASSERT(discard_ != nullptr);
+    std::unique_lock const g(discard_->lock);
+    discard_->bytes_per_second = bytes_per_second;
+}
+
 storage_pool::storage_pool(storage_pool const *src, clone_as_read_only_tag_)
     : is_read_only_(true)
     , is_read_only_allow_dirty_(false)
@@ -630,6 +925,7 @@ storage_pool::storage_pool(storage_pool const *src, clone_as_read_only_tag_)
     creation_flags flags;
     flags.open_read_only = true;
     for (auto const &src_device : src->devices_) {
+        flags.nvme_passthrough = src_device.nvme_passthrough() != nullptr;
         devices_.push_back([&] {
             auto const path = src_device.current_path();
             int const fd = [&] {
@@ -679,6 +975,7 @@ storage_pool::storage_pool(
     : is_read_only_(flags.open_read_only || flags.open_read_only_allow_dirty)
     , is_read_only_allow_dirty_(flags.open_read_only_allow_dirty)
     , is_newly_truncated_(mode == mode::truncate)
+    , discard_(is_read_only_ ? nullptr : std::make_unique<discard_queue_>())
 {
     devices_.reserve(sources.size());
     for (auto const &source : sources) {
@@ -739,6 +1036,7 @@ storage_pool::storage_pool(
     : is_read_only_(flags.open_read_only || flags.open_read_only_allow_dirty)
     , is_read_only_allow_dirty_(flags.open_read_only_allow_dirty)
     , is_newly_truncated_(false)
+    , discard_(is_read_only_ ? nullptr : std::make_unique<discard_queue_>())
 {
     int const fd = make_temporary_inode();
     auto unfd = make_scope_exit([fd]() noexcept { ::close(fd); });
@@ -752,6 +1050,8 @@ storage_pool::storage_pool(
 
 storage_pool::~storage_pool()
 {
+    // Chunk file descriptors must outlive their discards
+    discard_.reset();
     auto const cleanupchunks_ = [&](chunk_type which) {
         for (auto &chunk_ : chunks_[which]) {
             auto chunk(chunk_.chunk.lock());
@@ -788,6 +1088,9 @@ storage_pool::~storage_pool()
             (void)::fsync(device.readwritefd_);
             (void)::close(device.readwritefd_);
         }
+        if (device.nvme_passthrough_.fd != -1) {
+            (void)::close(device.nvme_passthrough_.fd);
+        }
     }
     devices_.clear();
 }
@@ -814,6 +1117,15 @@ storage_pool::chunk(chunk_type which, uint32_t id) const
     return chunks_[which][id].chunk.lock();
 }
 
+size_t storage_pool::device_index(chunk_type which, uint32_t id) const
+{
+    std::unique_lock const g(lock_);
+    if (id >= chunks_[which].size()) {
+        MONAD_ABORT("Requested chunk which does not exist");
+    }
+    return size_t(&chunks_[which][id].device - devices_.data());
+}
+
 std::shared_ptr<class storage_pool::chunk>
 storage_pool::activate_chunk(chunk_type const which, uint32_t const id)
 {
@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <variant>
@@ -81,6 +82,22 @@ public:
     {
         friend class storage_pool;
 
+    public:
+        //! \brief The NVMe generic character device of a block device, which
+        //! reads can be issued to as passthrough commands bypassing the block
+        //! layer
+        struct nvme_passthrough_t
+        {
+            int fd{-1};
+            uint32_t nsid{0};
+            uint32_t lba_shift{0};
+            //! The largest read the controller accepts in one command, its
+            //! maximum data transfer size (MDTS). Unlike the block layer, the
+            //! driver does not split passthrough commands.
+            uint32_t max_transfer_bytes{0};
+        };
+
+    private:
         int const readwritefd_; // shared by all chunks for cached i/o
         const enum class type_t_ : uint8_t {
             unknown,
@@ -143,14 +160,18 @@ public:
 
         static_assert(sizeof(metadata_t) == 64);
 
+        nvme_passthrough_t const nvme_passthrough_;
+
         constexpr device(
             int readwritefd, type_t_ type, uint64_t unique_hash,
-            file_offset_t size_of_file, metadata_t *metadata)
+            file_offset_t size_of_file, metadata_t *metadata,
+            nvme_passthrough_t nvme_passthrough)
             : readwritefd_(readwritefd)
             , type_(type)
             , unique_hash_(unique_hash)
             , size_of_file_(size_of_file)
             , metadata_(metadata)
+            , nvme_passthrough_(nvme_passthrough)
         {
         }
 
@@ -176,6 +197,14 @@ public:
             return type_ == type_t_::zoned_device;
         }
 
+        //! Returns the NVMe passthrough for this block device, if the pool
+        //! was opened with `creation_flags::nvme_passthrough` and the device
+        //! is a whole NVMe namespace with a generic character device
+        nvme_passthrough_t const *nvme_passthrough() const noexcept
+        {
+            return (nvme_passthrough_.fd != -1) ? &nvme_passthrough_ : nullptr;
+        }
+
         //! Returns the number of chunks on this device
         size_t chunks() const;
         //! Returns the capacity of the device, and how much of that is
@@ -364,6 +393,10 @@ public:
         //! can cause pool data loss, as well as system data loss as it will
         //! happily use any partition you feed it, including the system drive.
         uint32_t disable_mismatching_storage_pool_check : 1;
+        //! Whether to also open the NVMe generic character device of block
+        //! devices, so reads can bypass the block layer. Devices which
+        //! don't support it fall back to ordinary reads.
+        uint32_t nvme_passthrough : 1;
 
         constexpr creation_flags()
             : chunk_capacity(28)
@@ -371,6 +404,7 @@ public:
             , open_read_only(false)
             , open_read_only_allow_dirty(false)
             , disable_mismatching_storage_pool_check(false)
+            , nvme_passthrough(false)
         {
         }
     };
@@ -408,6 +442,11 @@ private:
 
     storage_pool(storage_pool const *src, clone_as_read_only_tag_);
 
+    // Chunks pending reset and the thread discarding them, only present if
+    // the pool is writable
+    struct discard_queue_;
+    std::unique_ptr<discard_queue_> discard_;
+
 public:
     //! \brief Constructs a storage pool from the list of backing storage
     //! sources
@@ -461,11 +500,38 @@ public:
     //! \brief Returns the number of currently active chunks for the specified
     //! type
     size_t currently_active_chunks(chunk_type which) const noexcept;
+    //! \brief Returns the index into `devices()` of the device backing a
+    //! chunk. Does not activate the chunk.
+    size_t device_index(chunk_type which, uint32_t id) const;
     //! \brief Get an existing chunk, if it is activated
     std::shared_ptr<class chunk> chunk(chunk_type which, uint32_t id) const;
     //! \brief Activate a chunk (i.e. open file descriptors to it, if necessary)
     std::shared_ptr<class chunk> activate_chunk(chunk_type which, uint32_t id);
 
+    /*! \brief Empties a chunk immediately like `chunk::destroy_contents()`,
+    but leaves releasing its backing storage to a background thread. That
+    thread batches adjacent chunks into single discards, issuing no more than
+    `set_discard_rate_limit()` bytes of them per second. Until its discard
+    completes the chunk is pending reset.
+    */
+    void destroy_contents_deferred(std::shared_ptr<class chunk> chunk);
+    /*! \brief Must be called before a chunk which may be pending reset is
+    written again. A discard not yet begun is cancelled, as the chunk is about
+    to be overwritten anyway, otherwise this waits for it to complete.
+    */
+    void reclaim_pending_reset(class chunk const &chunk);
+    //! \brief Returns the ids of the chunks of type `which` whose discard is
+    //! under way, which `reclaim_pending_reset()` would have to wait for
+    std::vector<uint32_t> discarding_chunks(chunk_type which) const;
+    //! \brief Returns the number of chunks pending reset
+    size_t pending_resets() const;
+    //! \brief Blocks until no chunks are pending reset, ignoring the rate
+    //! limit
+    void wait_for_pending_resets();
+    //! \brief Sets how many bytes per second deferred destroys may discard,
+    //! zero for no limit. The default is 1Gb.
+    void set_discard_rate_limit(file_offset_t bytes_per_second);
+
     //! \brief Clones an existing storage pool as read-only
     storage_pool clone_as_read_only() const;
 };
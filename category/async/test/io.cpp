@@ -21,12 +21,14 @@
 #include <category/async/erased_connected_operation.hpp>
 #include <category/async/io.hpp>
 #include <category/async/io_senders.hpp>
+#include <category/async/read_io_limit_controller.hpp>
 #include <category/async/storage_pool.hpp>
 #include <category/core/assert.h>
 #include <category/core/io/buffers.hpp>
 #include <category/core/io/ring.hpp>
 #include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
@@ -35,6 +37,7 @@
 #include <optional>
 #include <ostream>
 #include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -150,6 +153,147 @@ namespace
         testio.wait_until_done();
     }
 
+    TEST(AsyncIO, nvme_passthrough_falls_back_to_ordinary_reads)
+    {
+        monad::async::storage_pool::creation_flags flags;
+        flags.nvme_passthrough = true;
+        monad::async::storage_pool pool(
+            monad::async::use_anonymous_inode_tag{}, flags);
+        // not a whole NVMe namespace
+        EXPECT_EQ(pool.devices().front().nvme_passthrough(), nullptr);
+
+        // the big entries that passthrough commands need do not change
+        // ordinary reads
+        monad::io::RingConfig config;
+        config.enable_big_entries = true;
+        monad::io::Ring testring{config};
+        monad::io::Buffers testrwbuf = monad::io::make_buffers_for_read_only(
+            testring, 4, monad::async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE);
+        monad::async::AsyncIO testio(pool, testrwbuf);
+
+        struct count_receiver
+        {
+            size_t &bytes;
+
+            enum
+            {
+                lifetime_managed_internally = true
+            };
+
+            void set_value(
+                monad::async::erased_connected_operation *,
+                monad::async::read_single_buffer_sender::result_type r)
+            {
+                MONAD_ASSERT(r);
+                bytes += r.assume_value().get().size();
+            }
+        };
+
+        size_t bytes = 0;
+        for (size_t n = 0; n < 16; n++) {
+            auto state(testio.make_connected(
+                monad::async::read_single_buffer_sender(
+                    {0, n * monad::async::DISK_PAGE_SIZE},
+                    monad::async::DISK_PAGE_SIZE),
+                count_receiver{bytes}));
+            state->initiate();
+            state.release();
+        }
+        testio.wait_until_done();
+        EXPECT_EQ(bytes, 16 * monad::async::DISK_PAGE_SIZE);
+    }
+
+    TEST(AsyncIO, wake_interrupts_blocking_poll)
+    {
+        using namespace std::chrono_literals;
+        monad::async::storage_pool pool(
+            monad::async::use_anonymous_inode_tag{});
+        monad::io::Ring testring;
+        monad::io::Buffers testrwbuf = monad::io::make_buffers_for_read_only(
+            testring, 1, monad::async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE);
+        monad::async::AsyncIO testio(pool, testrwbuf);
+        ASSERT_TRUE(testio.wake_supported());
+
+        // Nothing in flight and nobody waking, so the poll times out
+        auto begin = std::chrono::steady_clock::now();
+        EXPECT_EQ(testio.poll_blocking_for(10ms), 0);
+        EXPECT_GE(std::chrono::steady_clock::now() - begin, 10ms);
+
+        // A wakeup posted before polling is consumed exactly once
+        EXPECT_TRUE(testio.wake());
+        EXPECT_TRUE(testio.wake());
+        EXPECT_EQ(testio.poll_blocking_for(10s), 1);
+        EXPECT_EQ(testio.poll_blocking_for(10ms), 0);
+
+        // A wakeup from another thread ends the wait early
+        std::jthread waker([&] {
+            std::this_thread::sleep_for(10ms);
+            testio.wake();
+        });
+        begin = std::chrono::steady_clock::now();
+        EXPECT_EQ(testio.poll_blocking_for(10s), 1);
+        EXPECT_LT(std::chrono::steady_clock::now() - begin, 5s);
+    }
+
+    TEST(AsyncIO, pending_reads_dispatch_by_priority)
+    {
+        using io_priority =
+            enum monad::async::erased_connected_operation::io_priority;
+        monad::async::storage_pool pool(
+            monad::async::use_anonymous_inode_tag{});
+        monad::io::Ring testring;
+        monad::io::Buffers testrwbuf = monad::io::make_buffers_for_read_only(
+            testring, 32, monad::async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE);
+        monad::async::AsyncIO testio(pool, testrwbuf);
+        testio.set_concurrent_read_io_limit(1);
+        std::vector<io_priority> completed;
+
+        struct recording_receiver
+        {
+            std::vector<io_priority> &completed;
+
+            enum
+            {
+                lifetime_managed_internally = true
+            };
+
+            void set_value(
+                monad::async::erased_connected_operation *io_state,
+                monad::async::read_single_buffer_sender::result_type r)
+            {
+                MONAD_ASSERT(r);
+                completed.push_back(io_state->io_priority());
+            }
+        };
+
+        auto submit = [&](io_priority const prio) {
+            auto state(testio.make_connected(
+                monad::async::read_single_buffer_sender(
+                    {0, 0}, monad::async::DISK_PAGE_SIZE),
+                recording_receiver{completed}));
+            state->set_io_priority(prio);
+            state->initiate();
+            state.release();
+        };
+        // The first idle read takes the only slot, everything else queues
+        for (size_t n = 0; n < 8; n++) {
+            submit(io_priority::idle);
+        }
+        for (size_t n = 0; n < 8; n++) {
+            submit(io_priority::normal);
+        }
+        testio.wait_until_done();
+
+        ASSERT_EQ(completed.size(), 16);
+        EXPECT_EQ(completed[0], io_priority::idle);
+        for (size_t n = 1; n <= 8; n++) {
+            EXPECT_EQ(completed[n], io_priority::normal) << n;
+        }
+        for (size_t n = 9; n < 16; n++) {
+            EXPECT_EQ(completed[n], io_priority::idle) << n;
+        }
+    }
+
     struct sqe_exhaustion_does_not_reorder_writes_receiver
     {
         static constexpr size_t COUNT = 128;
@@ -252,4 +396,44 @@ namespace
         }
         EXPECT_EQ(seq.back(), offset - monad::async::DISK_PAGE_SIZE);
     }
+
+    TEST(ReadIOLimitController, aimd)
+    {
+        using namespace std::chrono_literals;
+        using controller = monad::async::ReadIOLimitController;
+        controller c{controller::Config{
+            .target_p99 = 100us,
+            .min_limit = 16,
+            .max_limit = 64,
+            .increase_step = 8,
+            .decrease_factor = 0.5}};
+        EXPECT_EQ(c.state().limit, 64);
+
+        auto fill_window = [&](std::chrono::nanoseconds const slow_latency,
+                               size_t const slow_count) {
+            std::optional<unsigned> ret;
+            for (size_t i = 0; i < controller::WINDOW; ++i) {
+                EXPECT_FALSE(ret.has_value());
+                ret = c.record(i < slow_count ? slow_latency : 10us);
+            }
+            return ret;
+        };
+
+        // A p99 over target halves the limit, down to the floor
+        EXPECT_EQ(fill_window(1ms, controller::WINDOW / 10), 32);
+        EXPECT_EQ(fill_window(1ms, controller::WINDOW / 10), 16);
+        EXPECT_EQ(fill_window(1ms, controller::WINDOW / 10), 16);
+        EXPECT_EQ(c.state().decreases, 3);
+        EXPECT_EQ(c.state().last_p99, 1ms);
+
+        // Fewer than 1% slow completions leaves p99 on target, so the limit
+        // climbs additively back to the ceiling
+        EXPECT_EQ(fill_window(1ms, 2), 24);
+        for (unsigned i = 0; i < 8; ++i) {
+            fill_window(1ms, 2);
+        }
+        EXPECT_EQ(c.state().limit, 64);
+        EXPECT_EQ(c.state().increases, 6);
+        EXPECT_EQ(c.state().windows, 12);
+    }
 }
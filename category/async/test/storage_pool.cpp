@@ -257,6 +257,71 @@ namespace
         run_tests(pool);
     }
 
+    TEST(StoragePool, deferred_destroy_contents)
+    {
+        storage_pool pool(use_anonymous_inode_tag{});
+        pool.set_discard_rate_limit(0);
+        std::vector<storage_pool::chunk_ptr> chunks;
+        std::vector<std::byte> buffer(1024 * 1024);
+        std::vector<std::byte> buffer2(buffer.size());
+        auto read = [&](storage_pool::chunk_ptr const &chunk) {
+            auto fd = chunk->read_fd();
+            MONAD_ASSERT(
+                -1 != ::pread(
+                          fd.first,
+                          buffer2.data(),
+                          buffer2.size(),
+                          static_cast<off_t>(fd.second)));
+        };
+        memset(buffer.data(), 0x42, buffer.size());
+        for (uint32_t n = 0; n < 4; n++) {
+            chunks.push_back(pool.activate_chunk(storage_pool::seq, n));
+            auto fd = chunks.back()->write_fd(buffer.size());
+            MONAD_ASSERT(
+                -1 != ::pwrite(
+                          fd.first,
+                          buffer.data(),
+                          buffer.size(),
+                          static_cast<off_t>(fd.second)));
+        }
+        for (size_t n = 0; n < 3; n++) {
+            pool.destroy_contents_deferred(chunks[n]);
+            // Empty straight away, whether discarded yet or not
+            EXPECT_EQ(chunks[n]->size(), 0);
+        }
+        EXPECT_LE(pool.pending_resets(), 3);
+        for (auto const id : pool.discarding_chunks(storage_pool::seq)) {
+            EXPECT_LT(id, 3);
+        }
+
+        // A reclaimed chunk is no longer pending reset and can be rewritten
+        pool.reclaim_pending_reset(*chunks[1]);
+        memset(buffer.data(), 0x11, buffer.size());
+        auto fd = chunks[1]->write_fd(buffer.size());
+        EXPECT_EQ(fd.second, chunks[1]->read_fd().second);
+        MONAD_ASSERT(
+            -1 != ::pwrite(
+                      fd.first,
+                      buffer.data(),
+                      buffer.size(),
+                      static_cast<off_t>(fd.second)));
+
+        pool.wait_for_pending_resets();
+        EXPECT_EQ(pool.pending_resets(), 0);
+        EXPECT_TRUE(pool.discarding_chunks(storage_pool::seq).empty());
+        read(chunks[1]);
+        EXPECT_EQ(0, memcmp(buffer.data(), buffer2.data(), buffer.size()));
+        memset(buffer.data(), 0, buffer.size());
+        read(chunks[0]);
+        EXPECT_EQ(0, memcmp(buffer.data(), buffer2.data(), buffer.size()));
+        read(chunks[2]);
+        EXPECT_EQ(0, memcmp(buffer.data(), buffer2.data(), buffer.size()));
+        memset(buffer.data(), 0x42, buffer.size());
+        read(chunks[3]);
+        EXPECT_EQ(0, memcmp(buffer.data(), buffer2.data(), buffer.size()));
+        EXPECT_EQ(chunks[3]->size(), buffer.size());
+    }
+
     TEST(StoragePool, raw_partitions)
     {
         ASSERT_DEATH(
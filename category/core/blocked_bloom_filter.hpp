@@ -0,0 +1,110 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Insert-only Bloom filter of 64 byte blocks, each the size of a cache
+/// line, so a lookup touches one line whatever the number of probes. A key
+/// is given as a 64 bit hash which must already be uniform: the upper half
+/// picks the block and the lower half, multiplied by one odd constant per
+/// word, sets one bit in each of the block's eight words. With 16 bits per
+/// key the false positive rate is about 0.1%.
+///
+/// Inserts and lookups may run concurrently; an insert is visible to the
+/// lookups which happen after it.
+class BlockedBloomFilter
+{
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+
+    struct alignas(64) Block
+    {
+        std::array<std::atomic<uint64_t>, WORDS_PER_BLOCK> words{};
+    };
+
+    static constexpr std::array<uint32_t, WORDS_PER_BLOCK> SALT{
+        0x47b6137bU,
+        0x44974d91U,
+        0x8824ad5bU,
+        0xa2b7289dU,
+        0x705495c7U,
+        0x2df1424bU,
+        0x9efc4947U,
+        0x5c6bfb31U};
+
+    size_t num_blocks_;
+    std::unique_ptr<Block[]> blocks_;
+
+    Block &block(uint64_t const hash) const noexcept
+    {
+        return blocks_[((hash >> 32) * num_blocks_) >> 32];
+    }
+
+    static uint64_t bit(uint64_t const hash, size_t const word) noexcept
+    {
+        uint32_t const x = static_cast<uint32_t>(hash) * SALT[word];
+        return uint64_t{1} << (x >> 26);
+    }
+
+public:
+    static constexpr size_t block_bytes = sizeof(Block);
+
+    /// Rounds down to whole blocks, of which there is at least one and at
+    /// most 2^32
+    explicit BlockedBloomFilter(size_t const bytes)
+        : num_blocks_{bytes < block_bytes ? 1 : bytes / block_bytes}
+    {
+        MONAD_ASSERT(num_blocks_ <= (size_t{1} << 32));
+        blocks_ = std::make_unique<Block[]>(num_blocks_);
+    }
+
+    void insert(uint64_t const hash) noexcept
+    {
+        Block &b = block(hash);
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+            b.words[i].fetch_or(bit(hash, i), std::memory_order_release);
+        }
+    }
+
+    /// False means the key was definitely never inserted
+    bool may_contain(uint64_t const hash) const noexcept
+    {
+        Block const &b = block(hash);
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i) {
+            uint64_t const mask = bit(hash, i);
+            if ((b.words[i].load(std::memory_order_acquire) & mask) != mask) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t size_bytes() const noexcept
+    {
+        return num_blocks_ * block_bytes;
+    }
+};
+
+MONAD_NAMESPACE_END
@@ -15,10 +15,15 @@
 
 #include <category/core/cpuset.h>
 
+#include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <linux/mempolicy.h>
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 cpu_set_t monad_parse_cpuset(char *const s)
 {
@@ -52,3 +57,37 @@ cpu_set_t monad_parse_cpuset(char *const s)
 
     return set;
 }
+
+bool monad_numa_node_cpuset(unsigned const node, cpu_set_t *const set)
+{
+    CPU_ZERO(set);
+
+    char path[64];
+    snprintf(
+        path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    FILE *const f = fopen(path, "r");
+    if (f == nullptr) {
+        return false;
+    }
+    char list[4096];
+    bool const ok = fgets(list, sizeof(list), f) != nullptr;
+    fclose(f);
+    if (!ok) {
+        return false;
+    }
+    list[strcspn(list, "\n")] = '\0';
+    *set = monad_parse_cpuset(list);
+    return CPU_COUNT(set) > 0;
+}
+
+bool monad_numa_prefer_node(unsigned const node)
+{
+    unsigned long mask = 0;
+    if (node >= sizeof(mask) * 8) {
+        return false;
+    }
+    mask = 1ul << node;
+    // the kernel reads one bit fewer than maxnode
+    unsigned long const maxnode = sizeof(mask) * 8 + 1;
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, maxnode) == 0;
+}
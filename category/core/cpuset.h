@@ -16,6 +16,7 @@
 #pragma once
 
 #include <sched.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -24,6 +25,15 @@ extern "C"
 
 cpu_set_t monad_parse_cpuset(char *);
 
+/// Reads the CPUs of NUMA node `node` from sysfs into `set`. Returns false,
+/// leaving `set` empty, if the node does not exist.
+bool monad_numa_node_cpuset(unsigned node, cpu_set_t *set);
+
+/// Makes the calling thread allocate new pages on NUMA node `node` when it
+/// has free memory, falling back to other nodes otherwise. Returns false if
+/// the kernel rejected the policy, e.g. because NUMA is not supported.
+bool monad_numa_prefer_node(unsigned node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@ extern "C"
 {
 #endif
 
+struct monad_event_batch;
 struct monad_event_descriptor;
 struct monad_event_iterator;
 struct monad_event_ring_control;
@@ -59,6 +60,25 @@ static enum monad_event_iter_result monad_event_iterator_try_next(
 static enum monad_event_iter_result monad_event_iterator_try_copy(
     struct monad_event_iterator const *, struct monad_event_descriptor *);
 
+/// Zero-copy, batched form of `monad_event_iterator_try_next`: find up to
+/// `max` consecutive ready events starting at the iteration point and advance
+/// the iterator past them. The descriptors are not copied; the batch refers to
+/// them in place in the descriptor array, and never crosses the end of that
+/// array, so it is always a contiguous span. Because the writer may overwrite
+/// them at any time (as may happen to payloads obtained through them with
+/// `monad_event_ring_payload_peek`), the caller must consume the batch and
+/// then call `monad_event_iterator_check_batch` before trusting anything it
+/// read; on MONAD_EVENT_SUCCESS, `batch->count` is at least one
+static enum monad_event_iter_result monad_event_iterator_try_next_batch(
+    struct monad_event_iterator *, size_t max, struct monad_event_batch *);
+
+/// Return true if no descriptor in the batch, and no payload referred to by
+/// any of them, has been overwritten since `try_next_batch` returned it; this
+/// replaces the per-event sequence number and payload window checks with one
+/// check (two atomic loads) for the entire batch
+static bool monad_event_iterator_check_batch(
+    struct monad_event_iterator const *, struct monad_event_batch const *);
+
 /// Set the iterator so that the next call to `monad_event_iterator_try_next`
 /// or `monad_event_iterator_try_copy` will read the event descriptor with the
 /// specified sequence number; this performs no checking
@@ -80,6 +100,16 @@ struct monad_event_iterator
     struct monad_event_ring_control const *control;
 };
 
+/// A run of consecutive events returned by `try_next_batch`; `events` points
+/// directly into the event ring's descriptor array
+struct monad_event_batch
+{
+    struct monad_event_descriptor const *events; ///< First event in the batch
+    size_t count;                                ///< Number of events
+    uint64_t first_seqno;                        ///< Seqno of events[0]
+    uint64_t min_payload_offset;                 ///< Earliest payload byte
+};
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -112,6 +112,72 @@ inline enum monad_event_iter_result monad_event_iterator_try_next(
     return r;
 }
 
+inline enum monad_event_iter_result monad_event_iterator_try_next_batch(
+    struct monad_event_iterator *iter, size_t max,
+    struct monad_event_batch *batch)
+{
+    size_t const start = iter->read_last_seqno & iter->desc_capacity_mask;
+    struct monad_event_descriptor const *const ring_events =
+        &iter->descriptors[start];
+    uint64_t const first_seqno = iter->read_last_seqno + 1;
+    uint64_t const seqno =
+        __atomic_load_n(&ring_events[0].seqno, __ATOMIC_ACQUIRE);
+    if (MONAD_UNLIKELY(seqno != first_seqno || max == 0)) {
+        batch->count = 0;
+        if (seqno == first_seqno || seqno < iter->read_last_seqno ||
+            (seqno == 0 && iter->read_last_seqno == 0)) {
+            return MONAD_EVENT_NOT_READY;
+        }
+        return MONAD_EVENT_GAP;
+    }
+
+    // Stop at the end of the descriptor array so the batch stays contiguous;
+    // the next call picks up from the start of the array
+    size_t const contiguous = iter->desc_capacity_mask + 1 - start;
+    size_t const limit = max < contiguous ? max : contiguous;
+    uint64_t min_payload_offset = ring_events[0].payload_buf_offset;
+    size_t n = 1;
+    while (n < limit &&
+           __atomic_load_n(&ring_events[n].seqno, __ATOMIC_ACQUIRE) ==
+               first_seqno + n) {
+        // Writers allocate payload space and sequence numbers separately, so
+        // offsets are not quite monotonic when there are several of them
+        uint64_t const offset = ring_events[n].payload_buf_offset;
+        if (offset < min_payload_offset) {
+            min_payload_offset = offset;
+        }
+        ++n;
+    }
+    batch->events = ring_events;
+    batch->count = n;
+    batch->first_seqno = first_seqno;
+    batch->min_payload_offset = min_payload_offset;
+    iter->read_last_seqno += n;
+    return MONAD_EVENT_SUCCESS;
+}
+
+inline bool monad_event_iterator_check_batch(
+    struct monad_event_iterator const *iter,
+    struct monad_event_batch const *batch)
+{
+    // Order every read the caller made from the batch before the loads below,
+    // as the second sequence number load in `try_copy` does for one event
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    // The slot holding `first_seqno` is the first in the batch to be reused;
+    // that happens when the writer allocates `first_seqno + capacity`, so
+    // until then none of the batch's descriptors can have been touched
+    uint64_t const write_last_seqno =
+        __atomic_load_n(&iter->control->last_seqno, __ATOMIC_RELAXED);
+    if (MONAD_UNLIKELY(
+            write_last_seqno - batch->first_seqno > iter->desc_capacity_mask)) {
+        return false;
+    }
+    return batch->min_payload_offset >=
+           __atomic_load_n(
+               &iter->control->buffer_window_start, __ATOMIC_RELAXED);
+}
+
 inline void monad_event_iterator_set_seqno(
     struct monad_event_iterator *iter, uint64_t seqno)
 {
@@ -0,0 +1,420 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/event/event_spool.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/event/event_iterator.h>
+#include <category/core/event/event_ring.h>
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include <quill/Quill.h>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+constexpr char SEGMENT_EXTENSION[] = ".seg";
+
+std::filesystem::path
+segment_path(std::filesystem::path const &dir, uint64_t const first_seqno)
+{
+    return dir / std::format("{:020}{}", first_seqno, SEGMENT_EXTENSION);
+}
+
+// Segment files in `dir`, ordered by first sequence number; the zero padding
+// in their names makes that the lexicographic order
+std::vector<std::filesystem::path>
+list_segments(std::filesystem::path const &dir)
+{
+    std::vector<std::filesystem::path> paths;
+    std::error_code ec;
+    for (auto const &entry : std::filesystem::directory_iterator{dir, ec}) {
+        if (entry.is_regular_file() &&
+            entry.path().extension() == SEGMENT_EXTENSION) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+    return paths;
+}
+
+struct FileCloser
+{
+    void operator()(std::FILE *const f) const
+    {
+        (void)std::fclose(f);
+    }
+};
+
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+std::optional<EventSpoolSegmentHeader>
+read_header(std::filesystem::path const &path, File *file = nullptr)
+{
+    File f{std::fopen(path.c_str(), "rb")};
+    EventSpoolSegmentHeader header;
+    if (!f || std::fread(&header, sizeof header, 1, f.get()) != 1 ||
+        std::memcmp(
+            header.magic,
+            EVENT_SPOOL_MAGIC,
+            sizeof header.magic) != 0) {
+        return std::nullopt;
+    }
+    if (file) {
+        *file = std::move(f);
+    }
+    return header;
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+EventSpoolWriter::EventSpoolWriter(
+    monad_event_ring const &event_ring, Config config)
+    : ring_{event_ring}
+    , config_{std::move(config)}
+    , last_block_{0}
+{
+    std::filesystem::create_directories(config_.dir);
+    for (auto const &path : list_segments(config_.dir)) {
+        std::filesystem::remove(path);
+    }
+    // The iterator starts here rather than on the thread, so that no event
+    // recorded after construction is missed
+    monad_event_iterator iter;
+    MONAD_ASSERT(monad_event_ring_init_iterator(&ring_, &iter) == 0);
+    thread_ = std::jthread{[this, iter](std::stop_token token) {
+        run(token, iter);
+    }};
+}
+
+EventSpoolWriter::~EventSpoolWriter()
+{
+    thread_.request_stop();
+    thread_.join();
+}
+
+void EventSpoolWriter::run(
+    std::stop_token const token, monad_event_iterator iter)
+{
+    pthread_setname_np(pthread_self(), "event spool");
+    monad_event_descriptor event;
+    for (;;) {
+        switch (monad_event_iterator_try_next(&iter, &event)) {
+        case MONAD_EVENT_SUCCESS:
+            append(event);
+            continue;
+
+        case MONAD_EVENT_GAP:
+            // Segments are contiguous, so the one in progress ends here
+            LOG_WARNING(
+                "event spool fell behind the ring after seqno {}",
+                iter.read_last_seqno);
+            flush();
+            monad_event_iterator_reset(&iter);
+            continue;
+
+        case MONAD_EVENT_NOT_READY:
+            break;
+        }
+        // Stopping only once caught up spools everything recorded before the
+        // destructor was called
+        if (token.stop_requested()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    flush();
+}
+
+void EventSpoolWriter::append(monad_event_descriptor const &event)
+{
+    uint64_t block_number = 0;
+    bool const has_block =
+        config_.block_number &&
+        config_.block_number(&ring_, &event, &block_number);
+    bool const boundary = has_block || !config_.block_number;
+    if (boundary && !descriptors_.empty() &&
+        descriptors_.size() * sizeof(monad_event_descriptor) +
+                payload_.size() >=
+            config_.segment_bytes) {
+        flush();
+    }
+
+    // Keep the payload alignment the recorder gave it, since readers cast
+    // payload pointers to the event's C structure
+    size_t const offset = (payload_.size() + MONAD_EVENT_PAYLOAD_ALIGN - 1) &
+                          ~(MONAD_EVENT_PAYLOAD_ALIGN - 1);
+    payload_.resize(offset + event.payload_size);
+    if (monad_event_ring_payload_memcpy(
+            &ring_, &event, payload_.data() + offset, event.payload_size) ==
+        nullptr) {
+        LOG_WARNING(
+            "event spool lost payload of seqno {}; it expired before it could "
+            "be copied",
+            event.seqno);
+        payload_.resize(offset);
+        flush();
+        return;
+    }
+    monad_event_descriptor &spooled = descriptors_.emplace_back(event);
+    spooled.payload_buf_offset = offset;
+    if (has_block) {
+        first_block_ =
+            std::min(first_block_.value_or(block_number), block_number);
+        last_block_ = std::max(last_block_, block_number);
+    }
+}
+
+void EventSpoolWriter::flush()
+{
+    if (descriptors_.empty()) {
+        return;
+    }
+
+    EventSpoolSegmentHeader header{};
+    std::memcpy(header.magic, EVENT_SPOOL_MAGIC, sizeof header.magic);
+    header.content_type = ring_.header->content_type;
+    std::memcpy(
+        header.schema_hash,
+        ring_.header->schema_hash,
+        sizeof header.schema_hash);
+    header.first_seqno = descriptors_.front().seqno;
+    header.last_seqno = descriptors_.back().seqno;
+    header.first_block = first_block_.value_or(0);
+    header.last_block = last_block_;
+    header.payload_bytes = payload_.size();
+
+    size_t const descriptor_bytes =
+        descriptors_.size() * sizeof(monad_event_descriptor);
+    std::vector<uint8_t> compressed(
+        ZSTD_compressBound(descriptor_bytes + payload_.size()));
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> const cctx{
+        ZSTD_createCCtx(), &ZSTD_freeCCtx};
+    MONAD_ASSERT(cctx);
+    ZSTD_CCtx_setParameter(
+        cctx.get(), ZSTD_c_compressionLevel, config_.compression_level);
+    ZSTD_CCtx_setPledgedSrcSize(cctx.get(), descriptor_bytes + payload_.size());
+    ZSTD_outBuffer out{compressed.data(), compressed.size(), 0};
+    ZSTD_inBuffer in{descriptors_.data(), descriptor_bytes, 0};
+    size_t rc = 0;
+    while (in.pos < in.size && !ZSTD_isError(rc)) {
+        rc = ZSTD_compressStream2(cctx.get(), &out, &in, ZSTD_e_continue);
+    }
+    in = {payload_.data(), payload_.size(), 0};
+    do {
+        if (ZSTD_isError(rc)) {
+            break;
+        }
+        rc = ZSTD_compressStream2(cctx.get(), &out, &in, ZSTD_e_end);
+    }
+    while (rc != 0);
+    header.compressed_bytes = out.pos;
+
+    // Written under a temporary name, so readers never see a partial segment
+    std::filesystem::path const path =
+        segment_path(config_.dir, header.first_seqno);
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp";
+    bool ok = !ZSTD_isError(rc);
+    if (ok) {
+        File const f{std::fopen(tmp_path.c_str(), "wb")};
+        ok = f && std::fwrite(&header, sizeof header, 1, f.get()) == 1 &&
+             std::fwrite(compressed.data(), out.pos, 1, f.get()) == 1 &&
+             std::fflush(f.get()) == 0;
+    }
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(tmp_path, path, ec);
+        ok = !ec;
+    }
+    if (ok) {
+        segments_.push_back(path);
+        while (config_.max_segments &&
+               segments_.size() > config_.max_segments) {
+            std::filesystem::remove(segments_.front(), ec);
+            segments_.pop_front();
+        }
+    }
+    else {
+        LOG_ERROR(
+            "event spool could not write segment {} (seqnos {} - {}): {}",
+            path.string(),
+            header.first_seqno,
+            header.last_seqno,
+            ZSTD_isError(rc) ? ZSTD_getErrorName(rc) : std::strerror(errno));
+        std::filesystem::remove(tmp_path, ec);
+    }
+
+    descriptors_.clear();
+    payload_.clear();
+    first_block_.reset();
+    last_block_ = 0;
+}
+
+EventSpoolReader::EventSpoolReader(std::filesystem::path dir)
+    : dir_{std::move(dir)}
+    , ring_header_{}
+    , ring_{}
+    , iter_{}
+{
+}
+
+std::vector<EventSpoolSegmentHeader> EventSpoolReader::segments() const
+{
+    std::vector<EventSpoolSegmentHeader> headers;
+    for (auto const &path : list_segments(dir_)) {
+        if (auto const header = read_header(path)) {
+            headers.push_back(*header);
+        }
+    }
+    return headers;
+}
+
+bool EventSpoolReader::seek_seqno(uint64_t const seqno)
+{
+    for (auto const &header : segments()) {
+        if (header.first_seqno <= seqno && seqno <= header.last_seqno) {
+            return load(header, seqno);
+        }
+    }
+    return false;
+}
+
+bool EventSpoolReader::seek_block(uint64_t const block_number)
+{
+    for (auto const &header : segments()) {
+        if (header.first_block != 0 && header.first_block <= block_number &&
+            block_number <= header.last_block) {
+            return load(header, header.first_seqno);
+        }
+    }
+    return false;
+}
+
+bool EventSpoolReader::next_segment()
+{
+    if (!header_) {
+        return false;
+    }
+    for (auto const &header : segments()) {
+        if (header.first_seqno > header_->last_seqno) {
+            return load(header, header.first_seqno);
+        }
+    }
+    return false;
+}
+
+bool EventSpoolReader::load(
+    EventSpoolSegmentHeader const &header, uint64_t const seqno)
+{
+    File f;
+    if (!read_header(segment_path(dir_, header.first_seqno), &f)) {
+        return false; // Removed by the writer's retention since listing
+    }
+    std::vector<uint8_t> compressed(header.compressed_bytes);
+    if (std::fread(compressed.data(), compressed.size(), 1, f.get()) != 1) {
+        return false;
+    }
+
+    // Descriptors are decompressed into a staging array, since they need to
+    // be scattered to the ring slots their sequence numbers map to; payload
+    // bytes go straight to the payload buffer
+    size_t const n_events = header.last_seqno - header.first_seqno + 1;
+    size_t const descriptor_capacity = std::bit_ceil(n_events);
+    size_t const payload_buf_size =
+        std::bit_ceil(std::max(header.payload_bytes, uint64_t{1}));
+    std::vector<monad_event_descriptor> staged(n_events);
+    std::vector<monad_event_descriptor> descriptors(descriptor_capacity);
+    std::vector<uint8_t> payload(payload_buf_size);
+
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> const dctx{
+        ZSTD_createDCtx(), &ZSTD_freeDCtx};
+    MONAD_ASSERT(dctx);
+    ZSTD_inBuffer in{compressed.data(), compressed.size(), 0};
+    ZSTD_outBuffer outs[] = {
+        {staged.data(), n_events * sizeof(monad_event_descriptor), 0},
+        {payload.data(), header.payload_bytes, 0}};
+    for (ZSTD_outBuffer &out : outs) {
+        while (out.pos < out.size) {
+            size_t const rc = ZSTD_decompressStream(dctx.get(), &out, &in);
+            if (ZSTD_isError(rc) || (rc == 0 && out.pos < out.size)) {
+                return false; // The current segment, if any, stays loaded
+            }
+        }
+    }
+    for (monad_event_descriptor const &event : staged) {
+        descriptors[(event.seqno - 1) & (descriptor_capacity - 1)] = event;
+    }
+    descriptors_ = std::move(descriptors);
+    payload_ = std::move(payload);
+
+    ring_header_ = {};
+    std::memcpy(
+        ring_header_.magic,
+        MONAD_EVENT_RING_HEADER_VERSION,
+        sizeof ring_header_.magic);
+    ring_header_.content_type =
+        static_cast<monad_event_content_type>(header.content_type);
+    std::memcpy(
+        ring_header_.schema_hash,
+        header.schema_hash,
+        sizeof ring_header_.schema_hash);
+    ring_header_.size = {
+        .descriptor_capacity = descriptor_capacity,
+        .payload_buf_size = payload_buf_size,
+        .context_area_size = 0};
+    ring_header_.control.last_seqno = header.last_seqno;
+    ring_header_.control.next_payload_byte = header.payload_bytes;
+    ring_header_.control.buffer_window_start = 0;
+    ring_ = {
+        .mmap_prot = PROT_READ,
+        .header = &ring_header_,
+        .descriptors = descriptors_.data(),
+        .payload_buf = payload_.data(),
+        .context_area = nullptr,
+        .desc_capacity_mask = descriptor_capacity - 1,
+        .payload_buf_mask = payload_buf_size - 1};
+    MONAD_ASSERT(monad_event_ring_init_iterator(&ring_, &iter_) == 0);
+    monad_event_iterator_set_seqno(&iter_, seqno);
+    header_ = header;
+    return true;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,177 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+/**
+ * @file
+ *
+ * On-disk spool for an event ring. The ring only holds a sliding window of
+ * recent events, so a consumer that falls behind `buffer_window_start` or
+ * restarts loses whatever expired in the meantime. A spool writer follows the
+ * ring from a thread of the recording process and appends every committed
+ * event to zstd-compressed segment files; a spool reader loads segments back
+ * into private memory laid out as an event ring, so the usual iterator and
+ * payload functions work on them unchanged.
+ *
+ * Each segment holds a contiguous range of sequence numbers and is named after
+ * the first of them; its header also records the block number range it covers
+ * (if the writer was told how to find block numbers), so segments can be
+ * located by either.
+ */
+
+#include <category/core/config.hpp>
+#include <category/core/event/event_iterator.h>
+#include <category/core/event/event_ring.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Leading bytes of a segment file; followed by one zstd frame holding the
+/// segment's descriptors (in sequence number order) then its payload bytes.
+/// Descriptor payload offsets are relative to the start of those bytes.
+struct EventSpoolSegmentHeader
+{
+    char magic[8];
+    uint16_t content_type;
+    uint8_t schema_hash[32];
+    uint64_t first_seqno;
+    uint64_t last_seqno;
+    uint64_t first_block; ///< 0 if no event in the segment has a block number
+    uint64_t last_block;
+    uint64_t payload_bytes;
+    uint64_t compressed_bytes;
+};
+
+static_assert(std::is_trivially_copyable_v<EventSpoolSegmentHeader>);
+
+inline constexpr char EVENT_SPOOL_MAGIC[8] = {
+    'M', 'N', 'D', 'S', 'P', 'L', '0', '1'};
+
+/// Follows an event ring and writes its events to a spool directory
+class EventSpoolWriter
+{
+public:
+    /// Returns true and sets the block number if the event is a block-level
+    /// consensus event; the writer only starts new segments at such events,
+    /// so that a block's events stay together. Without one, any event may
+    /// start a new segment and no block ranges are recorded.
+    using BlockNumberFn = std::function<bool(
+        monad_event_ring const *, monad_event_descriptor const *, uint64_t *)>;
+
+    struct Config
+    {
+        std::filesystem::path dir;
+        /// Uncompressed size at which the current segment is closed
+        size_t segment_bytes = size_t{64} << 20;
+        /// Oldest segments are deleted beyond this many; 0 keeps them all
+        size_t max_segments = 0;
+        int compression_level = 3;
+        BlockNumberFn block_number = {};
+    };
+
+    /// Segments left in `config.dir` by an earlier run are removed, since
+    /// sequence numbers restart with each new event ring
+    EventSpoolWriter(monad_event_ring const &, Config);
+
+    /// Spools everything recorded before the call, then stops the thread
+    ~EventSpoolWriter();
+
+    EventSpoolWriter(EventSpoolWriter const &) = delete;
+    EventSpoolWriter &operator=(EventSpoolWriter const &) = delete;
+
+private:
+    void run(std::stop_token, monad_event_iterator);
+    void append(monad_event_descriptor const &);
+    void flush();
+
+    monad_event_ring ring_;
+    Config config_;
+    std::vector<monad_event_descriptor> descriptors_;
+    std::vector<uint8_t> payload_;
+    std::optional<uint64_t> first_block_;
+    uint64_t last_block_;
+    std::deque<std::filesystem::path> segments_;
+    std::jthread thread_;
+};
+
+/// Serves spooled events through the event ring API: the loaded segment is an
+/// event ring whose descriptors and payloads never expire, and `iterator()`
+/// reads it with the ordinary `monad_event_iterator_*` functions. When the
+/// iterator reports MONAD_EVENT_NOT_READY at the end of a segment, call
+/// `next_segment` to continue with the following one.
+class EventSpoolReader
+{
+public:
+    explicit EventSpoolReader(std::filesystem::path dir);
+
+    EventSpoolReader(EventSpoolReader const &) = delete;
+    EventSpoolReader &operator=(EventSpoolReader const &) = delete;
+
+    /// Headers of every segment in the spool, oldest first
+    std::vector<EventSpoolSegmentHeader> segments() const;
+
+    /// Load the segment holding `seqno`, and position the iterator so that
+    /// `seqno` is the next event read; returns false if no segment holds it
+    bool seek_seqno(uint64_t seqno);
+
+    /// Load the oldest segment whose block range includes `block_number`, and
+    /// position the iterator at the start of that segment
+    bool seek_block(uint64_t block_number);
+
+    /// Load the segment after the current one and position the iterator at
+    /// its first event; returns false if there is none yet. If events were
+    /// lost between the two segments, the iterator skips over them.
+    bool next_segment();
+
+    /// Header of the loaded segment, if one is loaded
+    std::optional<EventSpoolSegmentHeader> const &segment() const
+    {
+        return header_;
+    }
+
+    monad_event_ring const *event_ring() const
+    {
+        return &ring_;
+    }
+
+    monad_event_iterator *iterator()
+    {
+        return &iter_;
+    }
+
+private:
+    bool load(EventSpoolSegmentHeader const &, uint64_t seqno);
+
+    std::filesystem::path dir_;
+    std::optional<EventSpoolSegmentHeader> header_;
+    monad_event_ring_header ring_header_;
+    std::vector<monad_event_descriptor> descriptors_;
+    std::vector<uint8_t> payload_;
+    monad_event_ring ring_;
+    monad_event_iterator iter_;
+};
+
+MONAD_NAMESPACE_END
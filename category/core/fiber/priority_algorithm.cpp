@@ -15,6 +15,7 @@
 
 #include <category/core/fiber/priority_algorithm.hpp>
 
+#include <category/core/assert.h>
 #include <category/core/fiber/config.hpp>
 #include <category/core/fiber/priority_properties.hpp>
 #include <category/core/fiber/priority_queue.hpp>
@@ -30,11 +31,12 @@
 MONAD_FIBER_NAMESPACE_BEGIN
 
 PriorityAlgorithm::PriorityAlgorithm(
-    PriorityQueue &rqueue, bool const prevent_spin)
+    PriorityQueue &rqueue, unsigned const index, bool const prevent_spin)
     : prevent_spin_(prevent_spin)
     , rqueue_{rqueue}
-
+    , index_{index}
 {
+    MONAD_ASSERT(index < rqueue.n_shards());
 }
 
 void PriorityAlgorithm::awakened(
@@ -45,14 +47,24 @@ void PriorityAlgorithm::awakened(
     }
     else {
         ctx->detach();
-        rqueue_.push(ctx);
+        rqueue_.push(index_, ctx);
         recent_ = true;
     }
 }
 
 context *PriorityAlgorithm::pick_next() noexcept
 {
-    context *ctx = rqueue_.pop();
+    context *ctx = nullptr;
+    if (MONAD_UNLIKELY(++picks_ == balance_period)) {
+        picks_ = 0;
+        ctx = rqueue_.pop_if_better(index_);
+    }
+    if (MONAD_LIKELY(!ctx)) {
+        ctx = rqueue_.pop(index_);
+    }
+    if (!ctx) {
+        ctx = rqueue_.steal(index_);
+    }
     if (prevent_spin_ && !ctx) {
         if (!recent_) {
             std::this_thread::sleep_for(std::chrono::microseconds(10));
@@ -32,18 +32,25 @@ using boost::fibers::context;
 class PriorityAlgorithm final
     : public boost::fibers::algo::algorithm_with_properties<PriorityProperties>
 {
+    // every this many picks, check whether another thread holds a fiber of
+    // higher priority than our own best
+    static constexpr unsigned balance_period = 16;
+
     bool recent_{true};
     // if set true, threads do not spin when no fiber available
     bool prevent_spin_{false};
 
     PriorityQueue &rqueue_;
+    unsigned const index_;
+    unsigned picks_{0};
 
     using lqueue_type = boost::fibers::scheduler::ready_queue_type;
 
     lqueue_type lqueue_{};
 
 public:
-    explicit PriorityAlgorithm(PriorityQueue &, bool prevent_spin = false);
+    PriorityAlgorithm(
+        PriorityQueue &, unsigned index, bool prevent_spin = false);
 
     PriorityAlgorithm(PriorityAlgorithm const &) = delete;
     PriorityAlgorithm(PriorityAlgorithm &&) = delete;
@@ -16,42 +16,66 @@
 #include <category/core/fiber/priority_pool.hpp>
 
 #include <category/core/assert.h>
+#include <category/core/cpuset.h>
 #include <category/core/fiber/config.hpp>
 #include <category/core/fiber/priority_algorithm.hpp>
 #include <category/core/fiber/priority_properties.hpp>
 #include <category/core/fiber/priority_task.hpp>
+#include <category/core/fiber/stack_pool.hpp>
 
-#include <boost/fiber/channel_op_status.hpp>
+#include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/fiber.hpp>
 #include <boost/fiber/mutex.hpp>
 #include <boost/fiber/operations.hpp>
 #include <boost/fiber/properties.hpp>
-#include <boost/fiber/protected_fixedsize_stack.hpp>
 
 #include <cstdio>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <thread>
 #include <utility>
 
 #include <pthread.h>
+#include <sched.h>
 
 MONAD_FIBER_NAMESPACE_BEGIN
 
+namespace
+{
+    void place_on_node(std::optional<unsigned> const numa_node)
+    {
+        if (!numa_node.has_value()) {
+            return;
+        }
+        cpu_set_t set;
+        if (monad_numa_node_cpuset(*numa_node, &set)) {
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+        (void)monad_numa_prefer_node(*numa_node);
+    }
+}
+
 PriorityPool::PriorityPool(
-    unsigned const n_threads, unsigned const n_fibers, bool const prevent_spin)
+    unsigned const n_threads, unsigned const n_fibers, bool const prevent_spin,
+    std::optional<unsigned> const numa_node, size_t const stack_size,
+    bool const huge_page_stacks)
+    : queue_{n_threads}
+    , stacks_{n_fibers, stack_size, huge_page_stacks}
 {
     MONAD_ASSERT(n_threads);
     MONAD_ASSERT(n_fibers);
 
     threads_.reserve(n_threads);
     for (unsigned i = n_threads - 1; i > 0; --i) {
-        auto thread = std::thread([this, i, prevent_spin] {
+        auto thread = std::thread([this, i, prevent_spin, numa_node] {
             char name[16];
             std::snprintf(name, 16, "worker %u", i);
             pthread_setname_np(pthread_self(), name);
+            place_on_node(numa_node);
             boost::fibers::use_scheduling_algorithm<PriorityAlgorithm>(
-                queue_, prevent_spin);
+                queue_, i, prevent_spin);
             std::unique_lock<boost::fibers::mutex> lock{mutex_};
             cv_.wait(lock, [this] { return done_; });
         });
@@ -59,21 +83,20 @@ PriorityPool::PriorityPool(
     }
 
     fibers_.reserve(n_fibers);
-    auto thread = std::thread([this, n_fibers, prevent_spin] {
+    auto thread = std::thread([this, n_fibers, prevent_spin, numa_node] {
         pthread_setname_np(pthread_self(), "worker 0");
+        place_on_node(numa_node);
         boost::fibers::use_scheduling_algorithm<PriorityAlgorithm>(
-            queue_, prevent_spin);
+            queue_, 0u, prevent_spin);
         for (unsigned i = 0; i < n_fibers; ++i) {
             auto *const properties = new PriorityProperties{nullptr};
             boost::fibers::fiber fiber{
                 static_cast<boost::fibers::fiber_properties *>(properties),
                 std::allocator_arg,
-                boost::fibers::protected_fixedsize_stack{
-                    static_cast<size_t>(8 * 1024 * 1024)},
+                PooledStack{stacks_},
                 [this, properties] {
                     PriorityTask task;
-                    while (channel_.pop(task) ==
-                           boost::fibers::channel_op_status::success) {
+                    while (pop(task)) {
                         properties->set_priority(task.priority);
                         boost::this_fiber::yield();
                         task.task();
@@ -91,7 +114,11 @@ PriorityPool::PriorityPool(
 
 PriorityPool::~PriorityPool()
 {
-    channel_.close();
+    {
+        std::unique_lock<boost::fibers::mutex> const lock{tasks_mutex_};
+        closed_ = true;
+    }
+    tasks_cv_.notify_all();
 
     start_.get_future().wait();
 
@@ -115,4 +142,47 @@ PriorityPool::~PriorityPool()
     }
 }
 
+void PriorityPool::submit_batch(std::span<PriorityTask> const tasks)
+{
+    if (tasks.empty()) {
+        return;
+    }
+    {
+        std::unique_lock<boost::fibers::mutex> const lock{tasks_mutex_};
+        MONAD_ASSERT(!closed_);
+        for (auto &task : tasks) {
+            tasks_.push_back(std::move(task));
+        }
+    }
+    if (tasks.size() == 1) {
+        tasks_cv_.notify_one();
+    }
+    else {
+        tasks_cv_.notify_all();
+    }
+}
+
+void PriorityPool::push(PriorityTask &&task)
+{
+    {
+        std::unique_lock<boost::fibers::mutex> const lock{tasks_mutex_};
+        MONAD_ASSERT(!closed_);
+        tasks_.push_back(std::move(task));
+    }
+    tasks_cv_.notify_one();
+}
+
+// Tasks queued before the pool closes are still run
+bool PriorityPool::pop(PriorityTask &task)
+{
+    std::unique_lock<boost::fibers::mutex> lock{tasks_mutex_};
+    tasks_cv_.wait(lock, [this] { return closed_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+        return false;
+    }
+    task = std::move(tasks_.front());
+    tasks_.pop_front();
+    return true;
+}
+
 MONAD_FIBER_NAMESPACE_END
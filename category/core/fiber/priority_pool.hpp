@@ -18,20 +18,27 @@
 #include <category/core/fiber/config.hpp>
 #include <category/core/fiber/priority_queue.hpp>
 #include <category/core/fiber/priority_task.hpp>
+#include <category/core/fiber/stack_pool.hpp>
 
-#include <boost/fiber/buffered_channel.hpp>
 #include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/mutex.hpp>
 
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <future>
+#include <optional>
+#include <span>
 #include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 MONAD_FIBER_NAMESPACE_BEGIN
 
 class PriorityPool final
 {
-    PriorityQueue queue_{};
+    PriorityQueue queue_;
 
     bool done_{false};
 
@@ -40,25 +47,64 @@ class PriorityPool final
 
     std::vector<std::thread> threads_{};
 
-    boost::fibers::buffered_channel<PriorityTask> channel_{1024};
+    // tasks waiting for a fiber; guarded by tasks_mutex_
+    boost::fibers::mutex tasks_mutex_{};
+    boost::fibers::condition_variable tasks_cv_{};
+    std::deque<PriorityTask> tasks_{};
+    bool closed_{false};
+
+    // declared before the fibers, which must be joined before their stacks
+    // are unmapped
+    StackPool stacks_;
 
     std::vector<boost::fibers::fiber> fibers_{};
 
     std::promise<void> start_{};
 
 public:
+    // With a `numa_node`, every pool thread runs on the CPUs of that node and
+    // prefers to allocate memory there, so that fibers do not migrate across
+    // sockets and the memory they first touch stays local
     PriorityPool(
-        unsigned n_threads, unsigned n_fibers, bool prevent_spin = false);
+        unsigned n_threads, unsigned n_fibers, bool prevent_spin = false,
+        std::optional<unsigned> numa_node = std::nullopt,
+        size_t stack_size = size_t{8} << 20, bool huge_page_stacks = false);
 
     PriorityPool(PriorityPool const &) = delete;
     PriorityPool &operator=(PriorityPool const &) = delete;
 
     ~PriorityPool();
 
-    void submit(uint64_t const priority, std::function<void()> task)
+    unsigned n_threads() const noexcept
+    {
+        return static_cast<unsigned>(threads_.size());
+    }
+
+    StackPool::Stats stack_stats() const
+    {
+        return stacks_.stats();
+    }
+
+    // Callables too large to be stored inline are wrapped in a
+    // std::function, which allocates
+    template <typename F>
+    void submit(uint64_t const priority, F &&f)
     {
-        channel_.push({priority, std::move(task)});
+        if constexpr (InplaceTask::fits<std::decay_t<F>>) {
+            push({priority, InplaceTask{std::forward<F>(f)}});
+        }
+        else {
+            push({priority, std::function<void()>{std::forward<F>(f)}});
+        }
     }
+
+    // Queues every task, moving out of `tasks`, under one lock acquisition
+    void submit_batch(std::span<PriorityTask> tasks);
+
+private:
+    void push(PriorityTask &&);
+
+    bool pop(PriorityTask &);
 };
 
 MONAD_FIBER_NAMESPACE_END
@@ -15,25 +15,123 @@
 
 #include <category/core/fiber/priority_queue.hpp>
 
+#include <category/core/assert.h>
 #include <category/core/fiber/config.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
 MONAD_FIBER_NAMESPACE_BEGIN
 
+void PriorityQueue::Shard::publish() noexcept
+{
+    best.store(
+        entries.empty() ? empty_priority : entries.back().priority,
+        std::memory_order_release);
+    size.store(entries.size(), std::memory_order_release);
+}
+
+PriorityQueue::PriorityQueue(unsigned const n_shards)
+    : shards_{std::make_unique<Shard[]>(n_shards)}
+    , n_shards_{n_shards}
+{
+    MONAD_ASSERT(n_shards);
+}
+
 bool PriorityQueue::empty() const
 {
-    return queue_.empty();
+    for (unsigned i = 0; i < n_shards_; ++i) {
+        if (shards_[i].size.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-context *PriorityQueue::pop()
+context *PriorityQueue::pop(unsigned const shard)
 {
-    context *ctx = nullptr;
-    queue_.try_pop(ctx);
+    MONAD_DEBUG_ASSERT(shard < n_shards_);
+    auto &s = shards_[shard];
+    if (!s.size.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    std::lock_guard const lock{s.lock};
+    if (s.entries.empty()) {
+        return nullptr;
+    }
+    context *const ctx = s.entries.back().ctx;
+    s.entries.pop_back();
+    s.publish();
     return ctx;
 }
 
-void PriorityQueue::push(context *const ctx)
+context *PriorityQueue::pop_if_better(unsigned const shard)
 {
-    queue_.push(ctx);
+    MONAD_DEBUG_ASSERT(shard < n_shards_);
+    uint64_t best = shards_[shard].best.load(std::memory_order_acquire);
+    unsigned victim = shard;
+    for (unsigned i = 0; i < n_shards_; ++i) {
+        uint64_t const priority =
+            shards_[i].best.load(std::memory_order_acquire);
+        if (priority < best) {
+            best = priority;
+            victim = i;
+        }
+    }
+    if (victim == shard) {
+        return nullptr;
+    }
+
+    auto &s = shards_[victim];
+    std::lock_guard const lock{s.lock};
+    // the victim may have run its best fiber since it was published
+    if (s.entries.empty() || s.entries.back().priority != best) {
+        return nullptr;
+    }
+    context *const ctx = s.entries.back().ctx;
+    s.entries.pop_back();
+    s.publish();
+    return ctx;
+}
+
+context *PriorityQueue::steal(unsigned const shard)
+{
+    MONAD_DEBUG_ASSERT(shard < n_shards_);
+    for (unsigned i = 1; i < n_shards_; ++i) {
+        auto &s = shards_[(shard + i) % n_shards_];
+        if (!s.size.load(std::memory_order_acquire) || !s.lock.try_lock()) {
+            continue;
+        }
+        std::lock_guard const lock{s.lock, std::adopt_lock};
+        if (s.entries.empty()) {
+            continue;
+        }
+        context *const ctx = s.entries.front().ctx;
+        s.entries.erase(s.entries.begin());
+        s.publish();
+        return ctx;
+    }
+    return nullptr;
+}
+
+void PriorityQueue::push(unsigned const shard, context *const ctx)
+{
+    MONAD_DEBUG_ASSERT(shard < n_shards_);
+    uint64_t const priority = get_priority(ctx);
+    auto &s = shards_[shard];
+
+    std::lock_guard const lock{s.lock};
+    // insert ahead of fibers of equal priority so that they run first
+    auto const it = std::lower_bound(
+        s.entries.begin(),
+        s.entries.end(),
+        priority,
+        [](Entry const &e, uint64_t const p) { return e.priority > p; });
+    s.entries.insert(it, Entry{priority, ctx});
+    s.publish();
 }
 
 MONAD_FIBER_NAMESPACE_END
@@ -19,42 +19,86 @@
 #include <category/core/fiber/config.hpp>
 #include <category/core/fiber/priority_properties.hpp>
 #include <category/core/likely.h>
+#include <category/core/synchronization/adaptive_lock.hpp>
 
 #include <boost/fiber/context.hpp>
 
-#include <oneapi/tbb/concurrent_priority_queue.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
 
 MONAD_FIBER_NAMESPACE_BEGIN
 
 using boost::fibers::context;
 
+inline LockStats priority_queue_lock_stats{"priority_queue"};
+
+/**
+ * Ready queue shared by the threads of a PriorityPool, split into one
+ * priority deque per thread. A thread pushes and pops the highest priority
+ * (lowest value) end of its own deque; an idle thread steals from the lowest
+ * priority end of another, so that it does not compete with the owner for the
+ * fiber the owner is about to run. The best priority of each deque is
+ * published so that threads can compare against the others without locking
+ * them, which is how the global priority order is restored periodically.
+ */
 class PriorityQueue final
 {
-    struct Compare
+    static constexpr uint64_t empty_priority =
+        std::numeric_limits<uint64_t>::max();
+
+    struct Entry
     {
-        static constexpr uint64_t get_priority(context const *const ctx)
-        {
-            auto const *const properties =
-                static_cast<PriorityProperties const *>(ctx->get_properties());
-            MONAD_ASSERT(properties); // TODO debug assert
-            return properties->get_priority();
-        }
-
-        constexpr bool
-        operator()(context const *const ctx1, context const *const ctx2)
-        {
-            return get_priority(ctx1) > get_priority(ctx2);
-        }
+        uint64_t priority;
+        context *ctx;
     };
 
-    oneapi::tbb::concurrent_priority_queue<context *, Compare> queue_;
+    struct alignas(64) Shard
+    {
+        AdaptiveLock lock{priority_queue_lock_stats};
+        // sorted by descending priority value, so the next fiber is at the back
+        std::vector<Entry> entries{};
+        std::atomic<uint64_t> best{empty_priority};
+        std::atomic<size_t> size{0};
+
+        void publish() noexcept;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    unsigned n_shards_;
+
+    static uint64_t get_priority(context const *const ctx)
+    {
+        auto const *const properties =
+            static_cast<PriorityProperties const *>(ctx->get_properties());
+        MONAD_ASSERT(properties); // TODO debug assert
+        return properties->get_priority();
+    }
 
 public:
+    explicit PriorityQueue(unsigned n_shards);
+
+    unsigned n_shards() const noexcept
+    {
+        return n_shards_;
+    }
+
     bool empty() const;
 
-    context *pop();
+    // highest priority fiber of the given shard
+    context *pop(unsigned shard);
+
+    // highest priority fiber of any other shard, if it is strictly better
+    // than the best fiber of the given shard
+    context *pop_if_better(unsigned shard);
+
+    // lowest priority fiber of the first non-empty shard after the given one
+    context *steal(unsigned shard);
 
-    void push(context *);
+    void push(unsigned shard, context *);
 };
 
 MONAD_FIBER_NAMESPACE_END
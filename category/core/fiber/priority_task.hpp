@@ -15,20 +15,122 @@
 
 #pragma once
 
+#include <category/core/assert.h>
 #include <category/core/fiber/config.hpp>
 
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 MONAD_FIBER_NAMESPACE_BEGIN
 
+// Move-only `void()` callable stored inline. Unlike std::function it never
+// allocates: only callables that fit in `capacity` bytes can be stored.
+class InplaceTask
+{
+public:
+    static constexpr size_t capacity = 56;
+
+    template <typename F>
+    static constexpr bool fits = sizeof(F) <= capacity && alignof(F) <= 8 &&
+                                 std::is_nothrow_move_constructible_v<F>;
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *);
+        void (*relocate)(void *dst, void *src) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    template <typename F>
+    static constexpr Ops ops_for{
+        .invoke = [](void *const p) { (*std::launder(static_cast<F *>(p)))(); },
+        .relocate =
+            [](void *const dst, void *const src) noexcept {
+                auto *const f = std::launder(static_cast<F *>(src));
+                ::new (dst) F(std::move(*f));
+                f->~F();
+            },
+        .destroy =
+            [](void *const p) noexcept {
+                std::launder(static_cast<F *>(p))->~F();
+            },
+    };
+
+    alignas(8) std::byte storage_[capacity];
+    Ops const *ops_{nullptr};
+
+    void reset() noexcept
+    {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+public:
+    InplaceTask() = default;
+
+    template <typename F>
+        requires(
+            !std::same_as<std::decay_t<F>, InplaceTask> &&
+            std::invocable<std::decay_t<F> &> && fits<std::decay_t<F>>)
+    InplaceTask(F &&f) // NOLINT(google-explicit-constructor)
+        : ops_{&ops_for<std::decay_t<F>>}
+    {
+        ::new (storage_) std::decay_t<F>(std::forward<F>(f));
+    }
+
+    InplaceTask(InplaceTask &&other) noexcept
+        : ops_{std::exchange(other.ops_, nullptr)}
+    {
+        if (ops_) {
+            ops_->relocate(storage_, other.storage_);
+        }
+    }
+
+    InplaceTask &operator=(InplaceTask &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            ops_ = std::exchange(other.ops_, nullptr);
+            if (ops_) {
+                ops_->relocate(storage_, other.storage_);
+            }
+        }
+        return *this;
+    }
+
+    ~InplaceTask()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    void operator()()
+    {
+        MONAD_ASSERT(ops_);
+        ops_->invoke(storage_);
+    }
+};
+
+static_assert(sizeof(InplaceTask) == 64);
+
 struct PriorityTask
 {
     uint64_t priority{0};
-    std::function<void()> task{};
+    InplaceTask task{};
 };
 
-static_assert(sizeof(PriorityTask) == 40);
+static_assert(sizeof(PriorityTask) == 72);
 static_assert(alignof(PriorityTask) == 8);
 
 MONAD_FIBER_NAMESPACE_END
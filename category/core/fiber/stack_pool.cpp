@@ -0,0 +1,157 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/fiber/stack_pool.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/fiber/config.hpp>
+
+#include <boost/context/stack_context.hpp>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+MONAD_FIBER_NAMESPACE_BEGIN
+
+namespace
+{
+    constexpr size_t huge_page_size = size_t{1} << 21;
+
+    size_t page_size()
+    {
+        static size_t const size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    size_t round_up(size_t const size, size_t const align)
+    {
+        return (size + align - 1) / align * align;
+    }
+}
+
+StackPool::StackPool(
+    size_t const n_stacks, size_t const stack_size, bool const huge_pages)
+    : n_stacks_{n_stacks}
+    , slot_size_{round_up(
+          stack_size + page_size(), huge_pages ? huge_page_size : page_size())}
+    , base_{nullptr}
+{
+    MONAD_ASSERT(n_stacks);
+    MONAD_ASSERT(stack_size);
+
+    size_t const size = n_stacks_ * slot_size_;
+    size_t const align = huge_pages ? huge_page_size : 0;
+    void *const data = mmap(
+        nullptr,
+        size + align,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+        -1,
+        0);
+    MONAD_ASSERT(data != MAP_FAILED);
+    auto *const raw = static_cast<unsigned char *>(data);
+    base_ = huge_pages ? reinterpret_cast<unsigned char *>(round_up(
+                             reinterpret_cast<size_t>(raw), huge_page_size))
+                       : raw;
+    if (huge_pages) {
+        // trim the alignment slack on either side
+        if (base_ != raw) {
+            MONAD_ASSERT(!munmap(raw, static_cast<size_t>(base_ - raw)));
+        }
+        size_t const tail = static_cast<size_t>(raw + align - base_);
+        if (tail) {
+            MONAD_ASSERT(!munmap(base_ + size, tail));
+        }
+        (void)madvise(base_, size, MADV_HUGEPAGE);
+    }
+
+    free_.reserve(n_stacks_);
+    for (size_t i = n_stacks_; i > 0; --i) {
+        unsigned char *const slot = base_ + (i - 1) * slot_size_;
+        MONAD_ASSERT(!mprotect(slot, page_size(), PROT_NONE));
+        free_.push_back(i - 1);
+    }
+}
+
+StackPool::~StackPool()
+{
+    MONAD_ASSERT(!munmap(base_, n_stacks_ * slot_size_));
+}
+
+boost::context::stack_context StackPool::allocate()
+{
+    size_t slot;
+    {
+        std::lock_guard const lock{mutex_};
+        MONAD_ASSERT(!free_.empty(), "fiber stack pool exhausted");
+        slot = free_.back();
+        free_.pop_back();
+    }
+
+    boost::context::stack_context sctx;
+    sctx.size = slot_size_ - page_size();
+    // stacks grow down from the top of the slot towards the guard page
+    sctx.sp = base_ + (slot + 1) * slot_size_;
+    return sctx;
+}
+
+void StackPool::deallocate(boost::context::stack_context &sctx) noexcept
+{
+    auto *const top = static_cast<unsigned char *>(sctx.sp);
+    MONAD_ASSERT(top > base_ && top <= base_ + n_stacks_ * slot_size_);
+    size_t const slot = static_cast<size_t>(top - base_) / slot_size_ - 1;
+
+    std::lock_guard const lock{mutex_};
+    free_.push_back(slot);
+}
+
+StackPool::Stats StackPool::stats() const
+{
+    size_t const pages = slot_size_ / page_size();
+    std::vector<unsigned char> residency(pages);
+
+    Stats stats{
+        .n_stacks = n_stacks_,
+        .in_use = 0,
+        .stack_size = slot_size_ - page_size(),
+        .resident_bytes = 0,
+        .max_stack_resident_bytes = 0};
+    {
+        std::lock_guard const lock{mutex_};
+        stats.in_use = n_stacks_ - free_.size();
+    }
+    for (size_t i = 0; i < n_stacks_; ++i) {
+        if (mincore(base_ + i * slot_size_, slot_size_, residency.data())) {
+            continue;
+        }
+        size_t const resident =
+            static_cast<size_t>(std::count_if(
+                residency.begin(),
+                residency.end(),
+                [](unsigned char const c) { return c & 1; })) *
+            page_size();
+        stats.resident_bytes += resident;
+        stats.max_stack_resident_bytes =
+            std::max(stats.max_stack_resident_bytes, resident);
+    }
+    return stats;
+}
+
+MONAD_FIBER_NAMESPACE_END
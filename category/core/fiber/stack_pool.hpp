@@ -0,0 +1,96 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/fiber/config.hpp>
+
+#include <boost/context/stack_context.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+MONAD_FIBER_NAMESPACE_BEGIN
+
+// Fixed number of fiber stacks carved out of one reserved range. Pages are
+// only committed when a fiber first touches them, and each stack has a guard
+// page below it. Released stacks are handed out again without remapping, so
+// their committed pages are reused by the next fiber.
+class StackPool final
+{
+public:
+    struct Stats
+    {
+        size_t n_stacks;
+        size_t in_use;
+        size_t stack_size;
+        // pages committed over all stacks
+        size_t resident_bytes;
+        // pages committed by the deepest stack, i.e. how much stack the
+        // deepest call tree so far needed
+        size_t max_stack_resident_bytes;
+    };
+
+private:
+    size_t n_stacks_;
+    size_t slot_size_;
+    unsigned char *base_;
+
+    mutable std::mutex mutex_{};
+    std::vector<size_t> free_{};
+
+public:
+    // With `huge_pages`, each stack is 2MB aligned and transparent huge pages
+    // are requested for the range; deep stacks then take fewer TLB misses,
+    // but every stack commits at least one huge page
+    StackPool(size_t n_stacks, size_t stack_size, bool huge_pages = false);
+
+    StackPool(StackPool const &) = delete;
+    StackPool &operator=(StackPool const &) = delete;
+
+    ~StackPool();
+
+    boost::context::stack_context allocate();
+
+    void deallocate(boost::context::stack_context &) noexcept;
+
+    Stats stats() const;
+};
+
+// StackAllocator handing out stacks of a StackPool, which must outlive every
+// fiber created with it
+class PooledStack final
+{
+    StackPool *pool_;
+
+public:
+    explicit PooledStack(StackPool &pool) noexcept
+        : pool_{&pool}
+    {
+    }
+
+    boost::context::stack_context allocate()
+    {
+        return pool_->allocate();
+    }
+
+    void deallocate(boost::context::stack_context &sctx) noexcept
+    {
+        pool_->deallocate(sctx);
+    }
+};
+
+MONAD_FIBER_NAMESPACE_END
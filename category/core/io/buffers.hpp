@@ -111,6 +111,17 @@ public:
         return 1;
     }
 
+    // True if [p, p + len) lies within the registered read region, so a read
+    // into it can be submitted with IORING_OP_READ_FIXED
+    [[gnu::always_inline]] bool
+    is_within_read_region(void const *const p, size_t const len) const
+    {
+        auto const *const begin = read_buf_.get_data();
+        auto const *const q = static_cast<unsigned char const *>(p);
+        return q >= begin && len <= read_buf_.get_size() &&
+               size_t(q - begin) <= read_buf_.get_size() - len;
+    }
+
     [[gnu::always_inline]] unsigned char *get_read_buffer(size_t const i) const
     {
         MONAD_DEBUG_ASSERT(i < read_count_);
@@ -40,6 +40,9 @@ Ring::Ring(RingConfig const &config)
         if (config.enable_io_polling) {
             ret.flags |= IORING_SETUP_IOPOLL;
         }
+        if (config.enable_big_entries) {
+            ret.flags |= IORING_SETUP_SQE128 | IORING_SETUP_CQE32;
+        }
         return ret;
     }()}
 {
@@ -34,6 +34,10 @@ struct RingConfig
     bool enable_io_polling{false};
     //! If set, turn on kernel polling of submission ring on the specified CPU
     std::optional<unsigned> sq_thread_cpu;
+    /*! Use 128 byte submission and 32 byte completion entries, which NVMe
+    passthrough commands (`IORING_OP_URING_CMD`) require.
+    */
+    bool enable_big_entries{false};
 
     RingConfig() = default;
 
@@ -18,6 +18,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
 #define BLOCK_SIZE ((1600 - 2 * 256) / 8)
 
 extern size_t
@@ -46,3 +50,154 @@ void keccak256(
 
     SHA3_squeeze(A, out, 32, BLOCK_SIZE);
 }
+
+#if defined(__AVX2__)
+
+static uint64_t const keccak_round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// rotation offsets, indexed by x + 5 * y
+static int const keccak_rho[25] = {0,  1,  62, 28, 27, 36, 44, 6,  55,
+                                   20, 3,  10, 43, 25, 39, 41, 45, 15,
+                                   21, 8,  18, 2,  61, 56, 14};
+
+static inline __m256i rol64x4(__m256i const v, int const n)
+{
+    return n == 0 ? v
+                  : _mm256_or_si256(
+                        _mm256_sll_epi64(v, _mm_cvtsi32_si128(n)),
+                        _mm256_srl_epi64(v, _mm_cvtsi32_si128(64 - n)));
+}
+
+static void keccak_f1600_x4(__m256i A[25])
+{
+    for (int round = 0; round < 24; ++round) {
+        // theta
+        __m256i C[5];
+        for (int x = 0; x < 5; ++x) {
+            C[x] = _mm256_xor_si256(
+                _mm256_xor_si256(A[x], A[x + 5]),
+                _mm256_xor_si256(
+                    _mm256_xor_si256(A[x + 10], A[x + 15]), A[x + 20]));
+        }
+        for (int x = 0; x < 5; ++x) {
+            __m256i const D = _mm256_xor_si256(
+                C[(x + 4) % 5], rol64x4(C[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5) {
+                A[x + y] = _mm256_xor_si256(A[x + y], D);
+            }
+        }
+        // rho and pi
+        __m256i B[25];
+        for (int x = 0; x < 5; ++x) {
+            for (int y = 0; y < 5; ++y) {
+                B[y + 5 * ((2 * x + 3 * y) % 5)] =
+                    rol64x4(A[x + 5 * y], keccak_rho[x + 5 * y]);
+            }
+        }
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; ++x) {
+                A[x + y] = _mm256_xor_si256(
+                    B[x + y],
+                    _mm256_andnot_si256(
+                        B[(x + 1) % 5 + y], B[(x + 2) % 5 + y]));
+            }
+        }
+        // iota
+        A[0] = _mm256_xor_si256(
+            A[0], _mm256_set1_epi64x((long long)keccak_round_constants[round]));
+    }
+}
+
+void keccak256_x4(
+    unsigned char const *const in[4], unsigned long const len[4],
+    unsigned char out[4][KECCAK256_SIZE])
+{
+    enum
+    {
+        RATE_LANES = BLOCK_SIZE / 8
+    };
+
+    size_t nblocks[4];
+    size_t max_blocks = 0;
+    for (int i = 0; i < 4; ++i) {
+        // padding always adds at least one byte
+        nblocks[i] = len[i] / BLOCK_SIZE + 1;
+        if (nblocks[i] > max_blocks) {
+            max_blocks = nblocks[i];
+        }
+    }
+
+    __m256i A[25];
+    for (int i = 0; i < 25; ++i) {
+        A[i] = _mm256_setzero_si256();
+    }
+
+    for (size_t b = 0; b < max_blocks; ++b) {
+        uint64_t blk[4][RATE_LANES];
+        for (int i = 0; i < 4; ++i) {
+            if (b + 1 < nblocks[i]) {
+                __builtin_memcpy(blk[i], &in[i][b * BLOCK_SIZE], BLOCK_SIZE);
+            }
+            else if (b + 1 == nblocks[i]) {
+                size_t const rem = len[i] - b * BLOCK_SIZE;
+                unsigned char *const bytes = (unsigned char *)blk[i];
+                if (rem > 0) {
+                    __builtin_memcpy(bytes, &in[i][b * BLOCK_SIZE], rem);
+                }
+                __builtin_memset(&bytes[rem], 0, BLOCK_SIZE - rem);
+                bytes[rem] = 0x01;
+                bytes[BLOCK_SIZE - 1] |= 0x80;
+            }
+            else {
+                // this input is done; keep its lane busy with zeroes
+                __builtin_memset(blk[i], 0, BLOCK_SIZE);
+            }
+        }
+        for (int j = 0; j < RATE_LANES; ++j) {
+            A[j] = _mm256_xor_si256(
+                A[j],
+                _mm256_set_epi64x(
+                    (long long)blk[3][j],
+                    (long long)blk[2][j],
+                    (long long)blk[1][j],
+                    (long long)blk[0][j]));
+        }
+        keccak_f1600_x4(A);
+
+        uint64_t digest[4][4];
+        for (int j = 0; j < 4; ++j) {
+            uint64_t lanes[4];
+            _mm256_storeu_si256((__m256i *)lanes, A[j]);
+            for (int i = 0; i < 4; ++i) {
+                digest[i][j] = lanes[i];
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (b + 1 == nblocks[i]) {
+                __builtin_memcpy(out[i], digest[i], KECCAK256_SIZE);
+            }
+        }
+    }
+}
+
+#else
+
+void keccak256_x4(
+    unsigned char const *const in[4], unsigned long const len[4],
+    unsigned char out[4][KECCAK256_SIZE])
+{
+    for (int i = 0; i < 4; ++i) {
+        keccak256(in[i], len[i], out[i]);
+    }
+}
+
+#endif
@@ -26,6 +26,13 @@ void keccak256(
     unsigned char const *in, unsigned long len,
     unsigned char out[KECCAK256_SIZE]);
 
+/// Hashes four independent inputs of any lengths at once, interleaving their
+/// Keccak-f[1600] permutations in AVX2 lanes when available. Intended for
+/// batches of short inputs, where the scalar permutation dominates.
+void keccak256_x4(
+    unsigned char const *const in[4], unsigned long const len[4],
+    unsigned char out[4][KECCAK256_SIZE]);
+
 #ifdef __cplusplus
 }
 #endif
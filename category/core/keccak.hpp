@@ -15,11 +15,15 @@
 
 #pragma once
 
+#include <category/core/assert.h>
 #include <category/core/byte_string.hpp>
 #include <category/core/keccak.h>
 
 #include <ethash/hash_types.hpp>
 
+#include <cstring>
+#include <span>
+
 MONAD_NAMESPACE_BEGIN
 
 using ::keccak256;
@@ -39,4 +43,28 @@ inline hash256 keccak256(unsigned char const (&a)[N])
     return keccak256(to_byte_string_view(a));
 }
 
+// Hashes each input into the matching output, four at a time
+inline void keccak256(
+    std::span<byte_string_view const> const in, std::span<hash256> const out)
+{
+    MONAD_ASSERT(in.size() == out.size());
+    size_t i = 0;
+    for (; i + 4 <= in.size(); i += 4) {
+        unsigned char const *data[4];
+        unsigned long len[4];
+        unsigned char digests[4][KECCAK256_SIZE];
+        for (size_t j = 0; j < 4; ++j) {
+            data[j] = in[i + j].data();
+            len[j] = in[i + j].size();
+        }
+        keccak256_x4(data, len, digests);
+        for (size_t j = 0; j < 4; ++j) {
+            std::memcpy(out[i + j].bytes, digests[j], KECCAK256_SIZE);
+        }
+    }
+    for (; i < in.size(); ++i) {
+        out[i] = keccak256(in[i]);
+    }
+}
+
 MONAD_NAMESPACE_END
@@ -0,0 +1,293 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/synchronization/adaptive_lock.hpp>
+
+#include <tbb/concurrent_hash_map.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+inline LockStats clock_cache_lock_stats{"clock_cache"};
+
+/// Concurrent cache evicting with the CLOCK approximation of LRU. A hit only
+/// sets the entry's reference bit, so lookups never take a lock shared with
+/// other keys. Keys are split into shards by hash; each shard has its own
+/// clock ring and lock, taken only when an insert needs a slot. The hand of
+/// the ring clears reference bits as it passes and evicts the first entry it
+/// finds unreferenced.
+///
+/// Capacity is given in bytes and converted to entries with `entry_bytes`,
+/// an estimate of the memory one entry takes in the map and the ring. It can
+/// be changed while the cache is in use.
+template <
+    class Key, class Value, class KeyHashCompare = tbb::tbb_hash_compare<Key>>
+class ClockCache
+{
+    /// TYPES
+    using Mutex = AdaptiveLock;
+
+    struct alignas(64) Shard
+    {
+        Mutex mutex{clock_cache_lock_stats};
+        // keys of the shard's entries, in clock order
+        std::vector<Key> ring{};
+        size_t hand{0};
+        size_t limit{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+    }; /// Shard
+
+    /// HashMapValue
+    struct HashMapValue
+    {
+        Value value_{};
+        mutable std::atomic<bool> referenced_{false};
+
+        HashMapValue() = default;
+
+        HashMapValue(HashMapValue const &other)
+            : value_(other.value_)
+            , referenced_(other.referenced_.load(std::memory_order_relaxed))
+        {
+        }
+
+        // only write the bit when it is clear, so that hits on hot entries
+        // do not keep invalidating the cache line in other cores
+        void touch() const
+        {
+            if (!referenced_.load(std::memory_order_relaxed)) {
+                referenced_.store(true, std::memory_order_relaxed);
+            }
+        }
+    }; /// HashMapValue
+
+    using HashMap = tbb::concurrent_hash_map<Key, HashMapValue, KeyHashCompare>;
+    using Accessor = HashMap::accessor;
+
+public:
+    using ConstAccessor = HashMap::const_accessor;
+
+    /// CONSTANTS
+    // key and value in the map node, the next pointer and reader-writer lock
+    // of the node, a bucket, and the key again in the clock ring
+    static constexpr size_t entry_bytes =
+        sizeof(std::pair<Key const, HashMapValue>) + 4 * sizeof(void *) +
+        sizeof(Key);
+
+    static constexpr unsigned default_shards = 64;
+
+private:
+    /// DATA
+    KeyHashCompare hash_compare_{};
+    unsigned shard_bits_;
+    std::atomic<size_t> max_size_{0};
+    std::atomic<size_t> size_{0};
+    std::unique_ptr<Shard[]> shards_;
+    HashMap hmap_;
+    uint64_t printed_hits_{0};
+    uint64_t printed_misses_{0};
+
+public:
+    explicit ClockCache(
+        size_t const max_bytes, unsigned const n_shards = default_shards)
+        : shard_bits_{static_cast<unsigned>(std::countr_zero(n_shards))}
+        , shards_{std::make_unique<Shard[]>(n_shards)}
+        , hmap_(max_bytes / entry_bytes)
+    {
+        MONAD_ASSERT(std::has_single_bit(n_shards));
+        set_capacity_bytes(max_bytes);
+    }
+
+    ClockCache(ClockCache const &) = delete;
+    ClockCache &operator=(ClockCache const &) = delete;
+
+    bool find(ConstAccessor &acc, Key const &key)
+    {
+        Shard &shard = shard_of(key);
+        if (!hmap_.find(acc, key)) {
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        acc->second.touch();
+        return true;
+    }
+
+    bool insert(Key const &key, Value const &value)
+    {
+        {
+            Accessor acc;
+            if (!hmap_.insert(acc, key)) {
+                acc->second.value_ = value;
+                acc->second.touch();
+                return false;
+            }
+            acc->second.value_ = value;
+        }
+        Shard &shard = shard_of(key);
+        std::unique_lock const l(shard.mutex);
+        // after a shrink, evict a few extra entries per insert until the
+        // shard is back within its limit
+        for (unsigned n = 0; n < 4 && shard.ring.size() >= shard.limit; ++n) {
+            evict(shard);
+        }
+        shard.ring.push_back(key);
+        size_.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    // The key keeps its slot in the ring until the hand drops it
+    bool erase(Key const &key)
+    {
+        if (!hmap_.erase(key)) {
+            return false;
+        }
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    // Shrinking takes effect lazily, as the shards see inserts
+    void set_capacity_bytes(size_t const max_bytes)
+    {
+        size_t const per_shard = std::max(
+            size_t{1}, (max_bytes / entry_bytes) >> shard_bits_);
+        for (size_t i = 0; i < n_shards(); ++i) {
+            std::unique_lock const l(shards_[i].mutex);
+            shards_[i].limit = per_shard;
+        }
+        max_size_.store(per_shard << shard_bits_, std::memory_order_release);
+    }
+
+    void clear() // Not thread-safe with other cache operations
+    {
+        hmap_.clear();
+        for (size_t i = 0; i < n_shards(); ++i) {
+            shards_[i].ring.clear();
+            shards_[i].hand = 0;
+        }
+        size_.store(0, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return max_size_.load(std::memory_order_acquire);
+    }
+
+    // lookups since construction
+    uint64_t hits() const
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < n_shards(); ++i) {
+            total += shards_[i].hits.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t misses() const
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < n_shards(); ++i) {
+            total += shards_[i].misses.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // occupancy, and the hit ratio since the previous call
+    std::string print_stats()
+    {
+        uint64_t const hits = this->hits();
+        uint64_t const misses = this->misses();
+        uint64_t const window_hits = hits - printed_hits_;
+        uint64_t const window_lookups = window_hits + misses - printed_misses_;
+        printed_hits_ = hits;
+        printed_misses_ = misses;
+        return std::format(
+            "{:8}/{} {:5.1f}%",
+            size(),
+            capacity(),
+            window_lookups ? 100.0 * static_cast<double>(window_hits) /
+                                 static_cast<double>(window_lookups)
+                           : 0.0);
+    }
+
+private:
+    size_t n_shards() const
+    {
+        return size_t{1} << shard_bits_;
+    }
+
+    Shard &shard_of(Key const &key)
+    {
+        if (shard_bits_ == 0) {
+            return shards_[0];
+        }
+        // the map buckets use the low bits of the hash, so mix it and take
+        // the high bits for the shard
+        uint64_t const h = static_cast<uint64_t>(hash_compare_.hash(key)) *
+                           0x9e3779b97f4a7c15ull;
+        return shards_[h >> (64 - shard_bits_)];
+    }
+
+    // Erases the first unreferenced entry from the hand on, clearing the bits
+    // of the referenced entries it passes. The last key of the ring takes the
+    // victim's slot. Slots of erased keys are dropped as the hand passes.
+    void evict(Shard &shard)
+    {
+        while (!shard.ring.empty()) {
+            if (shard.hand >= shard.ring.size()) {
+                shard.hand = 0;
+            }
+            Accessor acc;
+            bool const found = hmap_.find(acc, shard.ring[shard.hand]);
+            if (found &&
+                acc->second.referenced_.load(std::memory_order_relaxed)) {
+                acc->second.referenced_.store(
+                    false, std::memory_order_relaxed);
+                ++shard.hand;
+                continue;
+            }
+            shard.ring[shard.hand] = std::move(shard.ring.back());
+            shard.ring.pop_back();
+            if (found) {
+                hmap_.erase(acc);
+                size_.fetch_sub(1, std::memory_order_acq_rel);
+                return;
+            }
+        }
+    }
+}; /// ClockCache
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,161 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/lru/clock_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using Cache = monad::ClockCache<int, int>;
+
+TEST(clock_cache_test, capacity_in_bytes)
+{
+    Cache cache(Cache::entry_bytes * 100, 4);
+    EXPECT_EQ(cache.capacity(), 100);
+
+    Cache small(Cache::entry_bytes * 10 + 1, 4);
+    EXPECT_EQ(small.capacity(), 8);
+}
+
+TEST(clock_cache_test, evicts_unreferenced)
+{
+    Cache cache(Cache::entry_bytes * 8, 1);
+    Cache::ConstAccessor acc;
+
+    for (int i = 1; i <= 8; ++i) {
+        EXPECT_TRUE(cache.insert(i, i * 10));
+    }
+    EXPECT_EQ(cache.size(), 8);
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(cache.find(acc, i));
+        EXPECT_EQ(acc->second.value_, i * 10);
+        acc.release();
+    }
+
+    // the hand passes the referenced 1-4, clearing their bits, and evicts 5
+    EXPECT_TRUE(cache.insert(9, 90));
+    EXPECT_EQ(cache.size(), 8);
+    EXPECT_FALSE(cache.find(acc, 5));
+    for (int i : {1, 2, 3, 4, 6, 7, 8, 9}) {
+        EXPECT_TRUE(cache.find(acc, i));
+        acc.release();
+    }
+
+    // updating an existing key does not take a slot
+    EXPECT_FALSE(cache.insert(9, 91));
+    ASSERT_TRUE(cache.find(acc, 9));
+    EXPECT_EQ(acc->second.value_, 91);
+    acc.release();
+    EXPECT_EQ(cache.size(), 8);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_FALSE(cache.find(acc, 1));
+}
+
+TEST(clock_cache_test, concurrent)
+{
+    Cache cache(Cache::entry_bytes * 1024, 8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            Cache::ConstAccessor acc;
+            for (int i = 0; i < 20000; ++i) {
+                int const key = (i * 7 + t) % 4096;
+                if (cache.find(acc, key)) {
+                    EXPECT_EQ(acc->second.value_, key);
+                    acc.release();
+                }
+                else {
+                    cache.insert(key, key);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_LE(cache.size(), cache.capacity());
+}
+
+TEST(clock_cache_test, shrinks_lazily)
+{
+    Cache cache(Cache::entry_bytes * 64, 1);
+    Cache::ConstAccessor acc;
+    for (int i = 0; i < 64; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_EQ(cache.size(), 64);
+
+    cache.set_capacity_bytes(Cache::entry_bytes * 16);
+    EXPECT_EQ(cache.capacity(), 16);
+    EXPECT_EQ(cache.size(), 64);
+
+    for (int i = 64; i < 96; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_EQ(cache.size(), 16);
+
+    cache.set_capacity_bytes(Cache::entry_bytes * 32);
+    for (int i = 96; i < 128; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_EQ(cache.size(), 32);
+}
+
+TEST(clock_cache_test, hit_counts)
+{
+    Cache cache(Cache::entry_bytes * 8, 2);
+    Cache::ConstAccessor acc;
+    cache.insert(1, 1);
+    EXPECT_TRUE(cache.find(acc, 1));
+    acc.release();
+    EXPECT_FALSE(cache.find(acc, 2));
+    EXPECT_FALSE(cache.find(acc, 3));
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 2);
+}
+
+TEST(clock_cache_test, erase)
+{
+    Cache cache(Cache::entry_bytes * 8, 1);
+    Cache::ConstAccessor acc;
+    for (int i = 1; i <= 4; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_TRUE(cache.erase(2));
+    EXPECT_FALSE(cache.erase(2));
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_FALSE(cache.find(acc, 2));
+
+    // an erased key can come back while its old slot is still in the ring
+    EXPECT_TRUE(cache.insert(2, 20));
+    ASSERT_TRUE(cache.find(acc, 2));
+    EXPECT_EQ(acc->second.value_, 20);
+    acc.release();
+    EXPECT_EQ(cache.size(), 4);
+
+    // the hand drops the stale slot as it passes, without losing the entry
+    for (int i = 5; i <= 12; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_LE(cache.size(), cache.capacity());
+    ASSERT_TRUE(cache.find(acc, 2));
+    EXPECT_EQ(acc->second.value_, 20);
+    acc.release();
+    EXPECT_TRUE(cache.find(acc, 12));
+}
@@ -17,7 +17,7 @@
 
 #include <category/core/assert.h>
 #include <category/core/mem/batch_mem_pool.hpp>
-#include <category/core/synchronization/spin_lock.hpp>
+#include <category/core/synchronization/adaptive_lock.hpp>
 
 #include <tbb/concurrent_hash_map.h>
 
@@ -28,6 +28,8 @@
 
 MONAD_NAMESPACE_BEGIN
 
+inline LockStats lru_cache_lock_stats{"lru_cache"};
+
 template <
     class Key, class Value, class KeyHashCompare = tbb::tbb_hash_compare<Key>>
 class LruCache
@@ -39,7 +41,7 @@ class LruCache
     using HashMap = tbb::concurrent_hash_map<Key, HashMapValue, KeyHashCompare>;
     using HashMapKeyValue = std::pair<Key, HashMapValue>;
     using Accessor = HashMap::accessor;
-    using Mutex = SpinLock;
+    using Mutex = AdaptiveLock;
     using Pool = BatchMemPool<ListNode>;
 
     /// CONSTANTS
@@ -49,7 +51,7 @@ class LruCache
     size_t max_size_;
     std::atomic<size_t> size_;
     LruList lru_;
-    Mutex mutex_;
+    Mutex mutex_{lru_cache_lock_stats};
     HashMap hmap_;
     Pool pool_;
 
@@ -17,6 +17,7 @@
 
 #include <category/core/assert.h>
 #include <category/core/config.hpp>
+#include <category/core/mem/huge_slab.hpp>
 
 #include <algorithm>
 #include <concepts>
@@ -155,6 +156,43 @@ namespace allocators
         return {a, b};
     }
 
+    /**************************************************************************/
+    //! \brief A STL allocator which uses `HugeSlabAllocator::instance()` once
+    //! it is enabled, and `malloc`-`free` for sizes it does not serve.
+    template <class T>
+        requires(alignof(T) <= alignof(max_align_t))
+    struct huge_slab_allocator
+    {
+        using value_type = T;
+
+        [[nodiscard]] T *allocate(size_t const no)
+        {
+            MONAD_ASSERT(no < size_t(-1) / sizeof(T));
+            if (void *const p =
+                    HugeSlabAllocator::instance().allocate(no * sizeof(T))) {
+                return static_cast<T *>(p);
+            }
+            return reinterpret_cast<T *>(std::malloc(no * sizeof(T)));
+        }
+
+        void deallocate(T *const p, size_t const)
+        {
+            if (!HugeSlabAllocator::instance().deallocate(p)) {
+                std::free(p);
+            }
+        }
+    };
+
+    template <class T>
+    detail::type_raw_alloc_pair<
+        std::allocator<T>, huge_slab_allocator<std::byte>>
+    huge_slab_aliasing_allocator_pair()
+    {
+        static std::allocator<T> a;
+        static huge_slab_allocator<std::byte> b;
+        return {a, b};
+    }
+
     //! \brief A unique ptr deleter for a STL allocator where underlying storage
     //! exceeds type
     template <
@@ -0,0 +1,106 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/config.hpp>
+#include <category/core/mem/arena.hpp>
+
+#include <boost/fiber/fss.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+struct FiberArena
+{
+    Arena arena{};
+    bool active{false};
+};
+
+boost::fibers::fiber_specific_ptr<FiberArena> &fiber_arena()
+{
+    // Leaked so that fibers still running during static destruction can
+    // clean up their arenas
+    static auto *const ptr = new boost::fibers::fiber_specific_ptr<FiberArena>;
+    return *ptr;
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+void *Arena::allocate_slow(size_t const bytes, size_t const align)
+{
+    auto const align_up = [align](std::byte *const p) {
+        auto const addr = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<std::byte *>(
+            (addr + align - 1) & ~(align - 1));
+    };
+
+    if (bytes + align > LARGE_SIZE) {
+        auto const &buf = large_.emplace_back(
+            std::make_unique_for_overwrite<std::byte[]>(bytes + align));
+        return align_up(buf.get());
+    }
+
+    if (next_chunk_ == chunks_.size()) {
+        chunks_.emplace_back(
+            std::make_unique_for_overwrite<std::byte[]>(CHUNK_SIZE));
+    }
+    std::byte *const chunk = chunks_[next_chunk_++].get();
+    end_ = chunk + CHUNK_SIZE;
+    std::byte *const p = align_up(chunk);
+    cur_ = p + bytes;
+    return p;
+}
+
+void Arena::reset()
+{
+    next_chunk_ = 0;
+    cur_ = nullptr;
+    end_ = nullptr;
+    large_.clear();
+}
+
+Arena *Arena::current()
+{
+    FiberArena *const f = fiber_arena().get();
+    return (f && f->active) ? &f->arena : nullptr;
+}
+
+ArenaScope::ArenaScope()
+    : arena_{nullptr}
+{
+    FiberArena *f = fiber_arena().get();
+    if (!f) {
+        f = new FiberArena;
+        fiber_arena().reset(f);
+    }
+    if (!f->active) {
+        f->active = true;
+        arena_ = &f->arena;
+    }
+}
+
+ArenaScope::~ArenaScope()
+{
+    if (arena_) {
+        fiber_arena().get()->active = false;
+        arena_->reset();
+    }
+}
+
+MONAD_NAMESPACE_END
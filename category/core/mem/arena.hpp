@@ -0,0 +1,155 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/likely.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Bump allocator for memory whose lifetime ends at a known point, e.g. the
+/// end of a transaction. Deallocation is a no-op; `reset()` rewinds the arena
+/// in constant time and keeps its chunks for reuse. Allocations too large to
+/// share a chunk get their own buffer, released on reset.
+class Arena
+{
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;
+    static constexpr size_t LARGE_SIZE = CHUNK_SIZE / 4;
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_{};
+    std::vector<std::unique_ptr<std::byte[]>> large_{};
+    size_t next_chunk_{0};
+    std::byte *cur_{nullptr};
+    std::byte *end_{nullptr};
+
+    void *allocate_slow(size_t bytes, size_t align);
+
+public:
+    Arena() = default;
+    Arena(Arena const &) = delete;
+    Arena &operator=(Arena const &) = delete;
+
+    void *allocate(size_t const bytes, size_t const align)
+    {
+        MONAD_ASSERT((align & (align - 1)) == 0);
+        auto const addr = reinterpret_cast<uintptr_t>(cur_);
+        auto const aligned = (addr + align - 1) & ~(align - 1);
+        auto const end = reinterpret_cast<uintptr_t>(end_);
+        if (MONAD_LIKELY(cur_ && aligned <= end && bytes <= end - aligned)) {
+            cur_ = reinterpret_cast<std::byte *>(aligned + bytes);
+            return reinterpret_cast<void *>(aligned);
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    void reset();
+
+    size_t num_chunks() const
+    {
+        return chunks_.size();
+    }
+
+    /// The arena of the calling fiber if it is inside an `ArenaScope`,
+    /// otherwise nullptr
+    static Arena *current();
+};
+
+/// Makes the calling fiber's arena the one that default constructed
+/// `ArenaAllocator`s use, until the scope ends and the arena is reset.
+/// Everything allocated from the arena must be destroyed before then. A
+/// nested scope on the same fiber is a no-op.
+class ArenaScope
+{
+    Arena *arena_;
+
+public:
+    ArenaScope();
+    ~ArenaScope();
+
+    ArenaScope(ArenaScope const &) = delete;
+    ArenaScope &operator=(ArenaScope const &) = delete;
+};
+
+/// STL allocator drawing from an `Arena`, or from the heap when constructed
+/// outside of an `ArenaScope`
+template <class T>
+class ArenaAllocator
+{
+    template <class U>
+    friend class ArenaAllocator;
+
+    Arena *arena_;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept
+        : arena_{Arena::current()}
+    {
+    }
+
+    explicit ArenaAllocator(Arena *const arena) noexcept
+        : arena_{arena}
+    {
+    }
+
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const &other) noexcept
+        : arena_{other.arena_}
+    {
+    }
+
+    [[nodiscard]] T *allocate(size_t const n)
+    {
+        if (arena_) {
+            MONAD_ASSERT(n <= std::numeric_limits<size_t>::max() / sizeof(T));
+            return static_cast<T *>(
+                arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *const p, size_t const n) noexcept
+    {
+        if (!arena_) {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+    }
+
+    Arena *arena() const noexcept
+    {
+        return arena_;
+    }
+
+    template <class U>
+    bool operator==(ArenaAllocator<U> const &other) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+};
+
+MONAD_NAMESPACE_END
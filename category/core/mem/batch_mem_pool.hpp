@@ -15,11 +15,10 @@
 
 #pragma once
 
-#include <category/core/synchronization/spin_lock.hpp>
+#include <category/core/synchronization/adaptive_lock.hpp>
 
 #include <boost/pool/pool.hpp>
 
-#include <concepts>
 #include <mutex>
 #include <new>
 #include <string>
@@ -27,6 +26,8 @@
 
 MONAD_NAMESPACE_BEGIN
 
+inline LockStats batch_mem_pool_lock_stats{"batch_mem_pool"};
+
 /// Memory pool for objects of type 'T' that supports preallocation
 /// and batch allocation. It grows but does not shrink. Memory is
 /// deallocated at the destruction of the pool.
@@ -35,12 +36,12 @@ template <class T>
 class BatchMemPool
 {
     /// TYPES
-    using Mutex = SpinLock;
+    using Mutex = AdaptiveLock;
 
     using Pool = boost::pool<>;
 
     /// DATA
-    Mutex mutex_{};
+    Mutex mutex_{batch_mem_pool_lock_stats};
     Pool pool_;
 
 /// STATS MACROS
@@ -106,9 +107,6 @@ public:
         std::string str;
 #ifdef MONAD_BATCH_MEM_POOL_STATS
         str += stats_.print_stats();
-        if constexpr (std::same_as<Mutex, SpinLock>) {
-            str += " " + mutex_.print_stats();
-        }
         stats_.clear_stats();
 #endif
         return str;
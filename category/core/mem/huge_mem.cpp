@@ -22,6 +22,7 @@
 #include <sys/mman.h>
 
 #include <cstddef>
+#include <cstdint>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -44,14 +45,40 @@ HugeMem::HugeMem(size_t const size)
         return round_up(size, MAP_HUGE_2MB >> MAP_HUGE_SHIFT);
     }()}
     , data_{[this] {
-        void *const data = mmap(
+        void *data = mmap(
             nullptr,
             size_,
             PROT_READ | PROT_WRITE,
             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB,
             -1,
             0);
-        MONAD_ASSERT(data != MAP_FAILED);
+        if (data == MAP_FAILED) {
+            // No huge pages reserved, fall back to transparent huge pages.
+            // The mapping is over-allocated by a huge page so that it can
+            // be trimmed to start on a huge page boundary.
+            size_t const huge_page = 1UL << (MAP_HUGE_2MB >> MAP_HUGE_SHIFT);
+            data = mmap(
+                nullptr,
+                size_ + huge_page,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+            MONAD_ASSERT(data != MAP_FAILED);
+            auto *const begin = static_cast<unsigned char *>(data);
+            auto *const aligned = reinterpret_cast<unsigned char *>(
+                (reinterpret_cast<uintptr_t>(begin) + huge_page - 1) &
+                ~(huge_page - 1));
+            auto const head = static_cast<size_t>(aligned - begin);
+            if (head > 0) {
+                MONAD_ASSERT(!munmap(begin, head));
+            }
+            if (head < huge_page) {
+                MONAD_ASSERT(!munmap(aligned + size_, huge_page - head));
+            }
+            (void)madvise(aligned, size_, MADV_HUGEPAGE);
+            data = aligned;
+        }
         return static_cast<unsigned char *>(data);
     }()}
 {
@@ -0,0 +1,300 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/mem/huge_slab.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/likely.h>
+
+#include <sys/mman.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+
+MONAD_NAMESPACE_BEGIN
+
+HugeSlabAllocator::~HugeSlabAllocator()
+{
+    if (base_ != nullptr) {
+        MONAD_ASSERT(!munmap(base_, reserved_slabs_ * slab_size));
+    }
+}
+
+HugeSlabAllocator &HugeSlabAllocator::instance()
+{
+    static auto *const allocator =
+        new HugeSlabAllocator{/*thread_caches=*/true};
+    return *allocator;
+}
+
+bool HugeSlabAllocator::enable(size_t const max_bytes)
+{
+    static std::mutex mutex;
+    std::lock_guard const lock{mutex};
+    auto const slabs = max_bytes / slab_size;
+    if (enabled() || slabs == 0) {
+        return false;
+    }
+    // Over-reserve by a slab so that slabs can be aligned to huge pages
+    auto const reserved = (slabs + 1) * slab_size;
+    void *const p = mmap(
+        nullptr,
+        reserved,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+        -1,
+        0);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    auto *const begin = static_cast<unsigned char *>(p);
+    auto *const base = reinterpret_cast<unsigned char *>(
+        (reinterpret_cast<uintptr_t>(begin) + slab_size - 1) &
+        ~(slab_size - 1));
+    if (base != begin) {
+        MONAD_ASSERT(!munmap(begin, static_cast<size_t>(base - begin)));
+    }
+    auto *const end = base + slabs * slab_size;
+    if (end != begin + reserved) {
+        MONAD_ASSERT(
+            !munmap(end, static_cast<size_t>(begin + reserved - end)));
+    }
+    base_ = base;
+    reserved_slabs_ = slabs;
+    slab_class_ = std::make_unique<uint8_t[]>(slabs);
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool HugeSlabAllocator::new_slab(
+    SizeClass &c, uint8_t const size_class) noexcept
+{
+    auto const i = slabs_.fetch_add(1, std::memory_order_relaxed);
+    if (MONAD_UNLIKELY(i >= reserved_slabs_)) {
+        slabs_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    auto *const slab = base_ + i * slab_size;
+    void *p = mmap(
+        slab,
+        slab_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB | MAP_HUGE_2MB,
+        -1,
+        0);
+    if (p != MAP_FAILED) {
+        huge_tlb_slabs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        // No huge pages reserved, fall back to transparent huge pages
+        p = mmap(
+            slab,
+            slab_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+            -1,
+            0);
+        MONAD_ASSERT(p != MAP_FAILED);
+        (void)madvise(slab, slab_size, MADV_HUGEPAGE);
+    }
+    slab_class_[i] = size_class;
+    c.next = slab;
+    c.end = slab + slab_size;
+    return true;
+}
+
+struct HugeSlabAllocator::ThreadCache
+{
+    struct Bin
+    {
+        FreeBlock *head{nullptr};
+        uint32_t count{0};
+    };
+
+    HugeSlabAllocator *owner{nullptr};
+    std::array<Bin, size_classes> bins{};
+
+    ThreadCache() = default;
+    ThreadCache(ThreadCache const &) = delete;
+    ThreadCache &operator=(ThreadCache const &) = delete;
+
+    ~ThreadCache()
+    {
+        for (uint8_t i = 0; i < size_classes; ++i) {
+            flush(i, bins[i].count);
+        }
+    }
+
+    void refill(uint8_t const size_class) noexcept
+    {
+        auto &bin = bins[size_class];
+        auto &c = owner->classes_[size_class];
+        std::lock_guard const lock{c.lock};
+        while (bin.count < thread_cache_blocks / 2) {
+            void *const p = owner->pop_locked(c, size_class);
+            if (p == nullptr) {
+                break;
+            }
+            bin.head = new (p) FreeBlock{bin.head};
+            ++bin.count;
+        }
+    }
+
+    void flush(uint8_t const size_class, uint32_t n) noexcept
+    {
+        auto &bin = bins[size_class];
+        if (n == 0) {
+            return;
+        }
+        auto &c = owner->classes_[size_class];
+        std::lock_guard const lock{c.lock};
+        for (; n > 0; --n, --bin.count) {
+            auto *const block = bin.head;
+            bin.head = block->next;
+            owner->push_locked(c, block);
+        }
+    }
+};
+
+thread_local HugeSlabAllocator::ThreadCache HugeSlabAllocator::thread_cache_;
+
+void *HugeSlabAllocator::pop_locked(
+    SizeClass &c, uint8_t const size_class) noexcept
+{
+    if (c.free != nullptr) {
+        auto *const block = c.free;
+        c.free = block->next;
+        --c.free_count;
+        return block;
+    }
+    auto const bytes = block_size(size_class);
+    if (static_cast<size_t>(c.end - c.next) < bytes &&
+        !new_slab(c, size_class)) {
+        return nullptr;
+    }
+    auto *const block = c.next;
+    c.next += bytes;
+    ++c.carved;
+    return block;
+}
+
+void HugeSlabAllocator::push_locked(SizeClass &c, void *const p) noexcept
+{
+    c.free = new (p) FreeBlock{c.free};
+    ++c.free_count;
+}
+
+uint8_t HugeSlabAllocator::slab_class(void const *const p) const noexcept
+{
+    auto const offset = static_cast<size_t>(
+        static_cast<unsigned char const *>(p) - base_);
+    return slab_class_[offset / slab_size];
+}
+
+void *HugeSlabAllocator::allocate(size_t const size) noexcept
+{
+    if (MONAD_UNLIKELY(!enabled() || size > max_block_size)) {
+        return nullptr;
+    }
+    auto const size_class = HugeSlabAllocator::size_class(size);
+    if (thread_caches_) {
+        auto &tc = thread_cache_;
+        if (MONAD_UNLIKELY(tc.owner == nullptr)) {
+            tc.owner = this;
+        }
+        if (MONAD_LIKELY(tc.owner == this)) {
+            auto &bin = tc.bins[size_class];
+            if (MONAD_UNLIKELY(bin.head == nullptr)) {
+                tc.refill(size_class);
+                if (bin.head == nullptr) {
+                    return nullptr;
+                }
+            }
+            auto *const block = bin.head;
+            bin.head = block->next;
+            --bin.count;
+            return block;
+        }
+    }
+    auto &c = classes_[size_class];
+    std::lock_guard const lock{c.lock};
+    return pop_locked(c, size_class);
+}
+
+bool HugeSlabAllocator::deallocate(void *const p) noexcept
+{
+    if (!enabled() || !owns(p)) {
+        return false;
+    }
+    auto const size_class = slab_class(p);
+    if (thread_caches_) {
+        auto &tc = thread_cache_;
+        if (MONAD_UNLIKELY(tc.owner == nullptr)) {
+            tc.owner = this;
+        }
+        if (MONAD_LIKELY(tc.owner == this)) {
+            auto &bin = tc.bins[size_class];
+            bin.head = new (p) FreeBlock{bin.head};
+            if (MONAD_UNLIKELY(++bin.count > thread_cache_blocks)) {
+                tc.flush(size_class, thread_cache_blocks / 2);
+            }
+            return true;
+        }
+    }
+    auto &c = classes_[size_class];
+    std::lock_guard const lock{c.lock};
+    push_locked(c, p);
+    return true;
+}
+
+HugeSlabAllocator::Stats HugeSlabAllocator::stats() noexcept
+{
+    size_t used_bytes = 0;
+    for (uint8_t i = 0; i < size_classes; ++i) {
+        auto &c = classes_[i];
+        std::lock_guard const lock{c.lock};
+        used_bytes += (c.carved - c.free_count) * block_size(i);
+    }
+    return {
+        .slabs = slabs_.load(std::memory_order_relaxed),
+        .huge_tlb_slabs = huge_tlb_slabs_.load(std::memory_order_relaxed),
+        .reserved_slabs = reserved_slabs_,
+        .used_bytes = used_bytes};
+}
+
+std::string HugeSlabAllocator::print_stats()
+{
+    if (!enabled()) {
+        return {};
+    }
+    auto const s = stats();
+    return std::format(
+        ",nsl={}/{},nslh={},nsu={}MB,nsf={:.1f}%",
+        s.slabs,
+        s.reserved_slabs,
+        s.huge_tlb_slabs,
+        s.used_bytes >> 20,
+        s.fragmentation() * 100);
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,185 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/core/synchronization/adaptive_lock.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+MONAD_NAMESPACE_BEGIN
+
+inline LockStats huge_slab_lock_stats{"huge_slab"};
+
+/// Allocator of small blocks carved out of 2MB slabs, backed by huge pages
+/// if the kernel has them reserved and by transparent huge pages otherwise,
+/// so that objects walked on a hot path share few TLB entries. Each slab
+/// holds blocks of one size class, and freed blocks are only reused for
+/// the same size class. Slabs are never returned to the system.
+///
+/// Until `enable()` succeeds, and for sizes above `max_block_size`,
+/// `allocate()` returns `nullptr` and the caller allocates elsewhere.
+///
+/// With thread caches, each thread keeps up to `thread_cache_blocks` free
+/// blocks per size class and moves them to and from the central free lists
+/// in batches, so most allocations and frees take no lock. Such an
+/// allocator must outlive every thread using it.
+class HugeSlabAllocator final
+{
+public:
+    static constexpr size_t slab_size = 1UL << 21;
+    static constexpr size_t max_block_size = 4096;
+    static constexpr size_t size_classes = 40;
+    static constexpr uint32_t thread_cache_blocks = 64;
+
+    struct Stats
+    {
+        size_t slabs;
+        size_t huge_tlb_slabs;
+        size_t reserved_slabs;
+        // Bytes of the blocks handed out, including the free blocks held by
+        // thread caches
+        size_t used_bytes;
+
+        size_t committed_bytes() const noexcept
+        {
+            return slabs * slab_size;
+        }
+
+        // Share of committed memory in no block handed out: freed blocks of
+        // some size class, and the unused tail of the slab of each class
+        double fragmentation() const noexcept
+        {
+            return slabs ? 1.0 - static_cast<double>(used_bytes) /
+                                     static_cast<double>(committed_bytes())
+                         : 0.0;
+        }
+    };
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    struct SizeClass
+    {
+        AdaptiveLock lock{huge_slab_lock_stats};
+        FreeBlock *free{nullptr};
+        unsigned char *next{nullptr};
+        unsigned char *end{nullptr};
+        size_t carved{0};
+        size_t free_count{0};
+    };
+
+    struct ThreadCache;
+    static thread_local ThreadCache thread_cache_;
+
+    unsigned char *base_{nullptr};
+    size_t reserved_slabs_{0};
+    std::atomic<size_t> slabs_{0};
+    std::atomic<size_t> huge_tlb_slabs_{0};
+    std::unique_ptr<uint8_t[]> slab_class_;
+    std::array<SizeClass, size_classes> classes_;
+    std::atomic<bool> enabled_{false};
+    bool const thread_caches_{false};
+
+    bool new_slab(SizeClass &, uint8_t size_class) noexcept;
+
+    // Callers hold the lock of the size class
+    void *pop_locked(SizeClass &, uint8_t size_class) noexcept;
+    void push_locked(SizeClass &, void *) noexcept;
+
+    uint8_t slab_class(void const *p) const noexcept;
+
+public:
+    explicit HugeSlabAllocator(bool thread_caches = false)
+        : thread_caches_{thread_caches}
+    {
+    }
+
+    HugeSlabAllocator(HugeSlabAllocator const &) = delete;
+    HugeSlabAllocator &operator=(HugeSlabAllocator const &) = delete;
+    ~HugeSlabAllocator();
+
+    /// The allocator shared by all users, with thread caches. It must
+    /// outlive the blocks allocated from it and so is never destroyed.
+    static HugeSlabAllocator &instance();
+
+    static constexpr uint8_t size_class(size_t const size) noexcept
+    {
+        if (size <= 256) {
+            return static_cast<uint8_t>(size == 0 ? 0 : (size - 1) / 16);
+        }
+        if (size <= 1024) {
+            return static_cast<uint8_t>(16 + (size - 257) / 64);
+        }
+        return static_cast<uint8_t>(28 + (size - 1025) / 256);
+    }
+
+    static constexpr size_t block_size(uint8_t const size_class) noexcept
+    {
+        if (size_class < 16) {
+            return (size_class + 1UL) * 16;
+        }
+        if (size_class < 28) {
+            return 256 + (size_class - 15UL) * 64;
+        }
+        return 1024 + (size_class - 27UL) * 256;
+    }
+
+    /// Reserve address space for `max_bytes` of slabs, which are committed
+    /// on demand. Returns false if already enabled or if the address space
+    /// cannot be reserved.
+    bool enable(size_t max_bytes);
+
+    [[gnu::always_inline]] bool enabled() const noexcept
+    {
+        return enabled_.load(std::memory_order_acquire);
+    }
+
+    [[gnu::always_inline]] bool owns(void const *const p) const noexcept
+    {
+        auto const *const q = static_cast<unsigned char const *>(p);
+        return q >= base_ && q < base_ + reserved_slabs_ * slab_size;
+    }
+
+    /// A block of at least `size` bytes aligned to 16 bytes, or `nullptr`
+    /// if not enabled, `size` is too large or all slabs are in use.
+    void *allocate(size_t size) noexcept;
+
+    /// Free a block if it was allocated here, returning whether it was.
+    bool deallocate(void *p) noexcept;
+
+    Stats stats() noexcept;
+
+    /// Slab usage as `name=value` pairs, for the periodic stats log
+    std::string print_stats();
+};
+
+static_assert(
+    HugeSlabAllocator::size_class(HugeSlabAllocator::max_block_size) ==
+    HugeSlabAllocator::size_classes - 1);
+static_assert(
+    HugeSlabAllocator::block_size(HugeSlabAllocator::size_classes - 1) ==
+    HugeSlabAllocator::max_block_size);
+
+MONAD_NAMESPACE_END
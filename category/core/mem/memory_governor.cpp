@@ -0,0 +1,183 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/mem/memory_governor.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/procfs/statm.h>
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    size_t read_self_rss()
+    {
+        long const rss = monad_procfs_self_resident();
+        return rss > 0 ? static_cast<size_t>(rss) : 0;
+    }
+}
+
+MemoryGovernor::MemoryGovernor(
+    size_t const rss_cap_bytes, std::function<size_t()> read_rss)
+    : rss_cap_{rss_cap_bytes}
+    , read_rss_{read_rss ? std::move(read_rss) : read_self_rss}
+{
+    MONAD_ASSERT(rss_cap_ > 0);
+}
+
+void MemoryGovernor::add(Consumer consumer)
+{
+    MONAD_ASSERT(consumer.min_bytes <= consumer.max_bytes);
+    MONAD_ASSERT(consumer.misses && consumer.set_budget);
+    std::lock_guard const lock{mutex_};
+    auto const budget = consumer.max_bytes;
+    auto const misses = consumer.misses();
+    states_.push_back(
+        State{.consumer = std::move(consumer),
+              .budget = budget,
+              .misses = misses});
+}
+
+void MemoryGovernor::rebalance()
+{
+    std::lock_guard const lock{mutex_};
+    auto const rss = read_rss_();
+    last_rss_ = rss;
+    if (states_.empty()) {
+        return;
+    }
+    auto const step = std::max<size_t>(rss_cap_ / 64, 1);
+
+    std::vector<size_t> old_budgets;
+    for (auto &s : states_) {
+        old_budgets.push_back(s.budget);
+        auto const misses = s.consumer.misses();
+        s.value = static_cast<double>(s.consumer.priority) *
+                  static_cast<double>(misses - s.misses) /
+                  static_cast<double>(std::max<size_t>(s.budget, 1));
+        s.misses = misses;
+    }
+
+    // The least valuable consumer that can shrink, other than `except`
+    auto const lowest = [&](State const *const except) -> State * {
+        State *lo = nullptr;
+        for (auto &s : states_) {
+            if (&s != except && s.budget > s.consumer.min_bytes &&
+                (!lo || s.value < lo->value)) {
+                lo = &s;
+            }
+        }
+        return lo;
+    };
+
+    if (rss > rss_cap_) {
+        auto excess = rss - rss_cap_;
+        while (excess > 0) {
+            auto *const lo = lowest(nullptr);
+            if (!lo) {
+                break;
+            }
+            auto const cut =
+                std::min(excess, lo->budget - lo->consumer.min_bytes);
+            lo->budget -= cut;
+            excess -= cut;
+        }
+    }
+    else {
+        // The most valuable consumer that can grow and missed at all
+        State *hi = nullptr;
+        for (auto &s : states_) {
+            if (s.budget < s.consumer.max_bytes && s.value > 0 &&
+                (!hi || s.value > hi->value)) {
+                hi = &s;
+            }
+        }
+        if (hi) {
+            auto const room =
+                std::min(step, hi->consumer.max_bytes - hi->budget);
+            auto *const lo = lowest(hi);
+            if (rss + room <= rss_cap_) {
+                hi->budget += room;
+            }
+            else if (lo && hi->value > 2 * lo->value) {
+                auto const moved =
+                    std::min(room, lo->budget - lo->consumer.min_bytes);
+                lo->budget -= moved;
+                hi->budget += moved;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < states_.size(); ++i) {
+        if (states_[i].budget != old_budgets[i]) {
+            states_[i].consumer.set_budget(states_[i].budget);
+        }
+    }
+}
+
+size_t MemoryGovernor::budget(std::string const &name) const
+{
+    std::lock_guard const lock{mutex_};
+    for (auto const &s : states_) {
+        if (s.consumer.name == name) {
+            return s.budget;
+        }
+    }
+    return 0;
+}
+
+std::string MemoryGovernor::print_stats() const
+{
+    std::lock_guard const lock{mutex_};
+    auto ret = std::format(
+        ",rss={}MB,rss_cap={}MB", last_rss_ >> 20, rss_cap_ >> 20);
+    for (auto const &s : states_) {
+        ret += std::format(",{}={}MB", s.consumer.name, s.budget >> 20);
+    }
+    return ret;
+}
+
+std::jthread MemoryGovernor::start(std::chrono::milliseconds const interval)
+{
+    return std::jthread([this, interval](std::stop_token const token) {
+        pthread_setname_np(pthread_self(), "memory governor");
+        std::mutex mutex;
+        std::condition_variable_any cv;
+        std::unique_lock lock{mutex};
+        while (!cv.wait_for(lock, token, interval, [] { return false; }) &&
+               !token.stop_requested()) {
+            rebalance();
+        }
+    });
+}
+
+MONAD_NAMESPACE_END
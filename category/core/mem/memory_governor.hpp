@@ -0,0 +1,92 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Shares a cap on the resident set size of the process between caches.
+/// Each call to `rebalance()` values every cache by its misses since the
+/// previous call per byte of budget, scaled by its priority. While RSS is
+/// above the cap, the least valuable caches are shrunk by the excess.
+/// Below the cap, the most valuable cache grows by a sixty-fourth of the
+/// cap as long as RSS stays under the cap, and otherwise takes that from
+/// the least valuable cache if it is worth less than half as much.
+///
+/// Budgets stay within the bounds of each cache. `set_budget` is called
+/// from the thread calling `rebalance()`, so caches apply it in a
+/// thread-safe way, possibly later.
+class MemoryGovernor final
+{
+public:
+    struct Consumer
+    {
+        std::string name;
+        unsigned priority{1};
+        size_t min_bytes{0};
+        // Also the initial budget
+        size_t max_bytes{0};
+        // Misses since construction
+        std::function<uint64_t()> misses;
+        std::function<void(size_t)> set_budget;
+    };
+
+private:
+    struct State
+    {
+        Consumer consumer;
+        size_t budget;
+        uint64_t misses;
+        double value{0};
+    };
+
+    size_t const rss_cap_;
+    std::function<size_t()> const read_rss_;
+    mutable std::mutex mutex_;
+    std::vector<State> states_;
+    size_t last_rss_{0};
+
+public:
+    /// `read_rss` defaults to reading the RSS of the process from procfs.
+    explicit MemoryGovernor(
+        size_t rss_cap_bytes, std::function<size_t()> read_rss = {});
+
+    void add(Consumer);
+
+    void rebalance();
+
+    /// The budget of the consumer named `name`, or 0 if there is none.
+    size_t budget(std::string const &name) const;
+
+    /// RSS and budgets as `name=value` pairs, for the periodic stats log
+    std::string print_stats() const;
+
+    /// Calls `rebalance()` every `interval` until the returned thread is
+    /// stopped. The governor must outlive the thread.
+    std::jthread start(std::chrono::milliseconds interval);
+};
+
+MONAD_NAMESPACE_END
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstring>
 #include <span>
@@ -162,4 +163,86 @@ encode_list(std::span<unsigned char> d, byte_string_view const s)
     return d;
 }
 
+/**
+ * Header-only encoders for two-pass serialization: the caller sums the
+ * lengths of the items first, sizes one buffer, and then writes each header
+ * followed by its payload in place, so no intermediate strings are built.
+ */
+
+/**
+ * length of the header of a string of `size` bytes; not valid for a single
+ * byte below 0x80, which is its own encoding
+ */
+constexpr size_t string_header_length(size_t const size)
+{
+    return size <= 55 ? 1 : 1 + impl::length_length(size);
+}
+
+constexpr size_t list_header_length(size_t const payload_size)
+{
+    return list_length(payload_size) - payload_size;
+}
+
+/**
+ * writes the header of a string of `size` bytes, with the same restriction
+ * as string_header_length; the payload must be written next
+ */
+constexpr std::span<unsigned char>
+encode_string_header(std::span<unsigned char> d, size_t const size)
+{
+    if (size <= 55) {
+        d[0] = 0x80 + static_cast<unsigned char>(size);
+        return d.subspan(1);
+    }
+    d[0] = 0xB7 + static_cast<unsigned char>(impl::length_length(size));
+    return impl::encode_length(d.subspan(1), size);
+}
+
+/**
+ * writes the header of a list whose items take `payload_size` bytes; the
+ * items must be written next
+ */
+constexpr std::span<unsigned char>
+encode_list_header(std::span<unsigned char> d, size_t const payload_size)
+{
+    if (payload_size <= 55) {
+        d[0] = 0xC0 + static_cast<unsigned char>(payload_size);
+        return d.subspan(1);
+    }
+    d[0] = 0xF7 + static_cast<unsigned char>(impl::length_length(payload_size));
+    return impl::encode_length(d.subspan(1), payload_size);
+}
+
+template <std::unsigned_integral T>
+constexpr size_t unsigned_length(T const n)
+{
+    if (n < 0x80) {
+        return 1;
+    }
+    return 1 + sizeof(T) - static_cast<size_t>(std::countl_zero(n)) / 8;
+}
+
+/**
+ * encodes `n` as a string of its big endian bytes without leading zeros
+ */
+template <std::unsigned_integral T>
+constexpr std::span<unsigned char>
+encode_unsigned(std::span<unsigned char> d, T const n)
+{
+    if (n == 0) {
+        d[0] = 0x80;
+        return d.subspan(1);
+    }
+    if (n < 0x80) {
+        d[0] = static_cast<unsigned char>(n);
+        return d.subspan(1);
+    }
+    size_t const size = unsigned_length(n) - 1;
+    d[0] = 0x80 + static_cast<unsigned char>(size);
+    for (size_t i = 0; i < size; ++i) {
+        d[size - i] = static_cast<unsigned char>(n >> (8 * i));
+    }
+    return d.subspan(1 + size);
+}
+
 MONAD_RLP_NAMESPACE_END
@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/synchronization/adaptive_lock.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/cpu_relax.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <string>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    std::atomic<LockStats *> lock_stats_head{nullptr};
+
+    LockStats *push_lock_stats(LockStats *const stats)
+    {
+        auto *head = lock_stats_head.load(std::memory_order_relaxed);
+        while (!lock_stats_head.compare_exchange_weak(
+            head, stats, std::memory_order_release,
+            std::memory_order_relaxed)) {
+        }
+        return head;
+    }
+}
+
+LockStats::LockStats(char const *const name)
+    : name_{name}
+    , next_{push_lock_stats(this)}
+{
+}
+
+LockStats &LockStats::unnamed()
+{
+    static LockStats stats{"unnamed"};
+    return stats;
+}
+
+std::string LockStats::print_stats()
+{
+    std::string ret;
+    for (auto *s = lock_stats_head.load(std::memory_order_acquire); s;
+         s = s->next_) {
+        // The two counters are not reset together, which can only skew their
+        // ratio within one print
+        auto const contended =
+            s->contended.exchange(0, std::memory_order_relaxed);
+        auto const parked = s->parked.exchange(0, std::memory_order_relaxed);
+        if (contended > 0) {
+            ret += std::format(",lk_{}={}/{}", s->name_, contended, parked);
+        }
+    }
+    return ret;
+}
+
+void AdaptiveLock::lock_slow() noexcept
+{
+    stats_.contended.fetch_add(1, std::memory_order_relaxed);
+
+    int32_t const spins = spins_.load(std::memory_order_relaxed);
+    int32_t const limit = std::min(max_spins, 2 * spins + 10);
+    int32_t n = 0;
+    for (; n < limit; ++n) {
+        if (state_.load(std::memory_order_relaxed) == Unlocked &&
+            try_lock()) {
+            spins_.store(spins + (n - spins) / 8, std::memory_order_relaxed);
+            return;
+        }
+        cpu_relax();
+    }
+    spins_.store(spins + (n - spins) / 8, std::memory_order_relaxed);
+
+    stats_.parked.fetch_add(1, std::memory_order_relaxed);
+    // Taking the lock as LockedWithWaiters, as other threads may still be
+    // parked on it
+    while (state_.exchange(LockedWithWaiters, std::memory_order_acquire) !=
+           Unlocked) {
+        syscall(
+            SYS_futex,
+            &state_,
+            FUTEX_WAIT_PRIVATE,
+            LockedWithWaiters,
+            nullptr,
+            nullptr,
+            0);
+    }
+}
+
+void AdaptiveLock::wake() noexcept
+{
+    syscall(SYS_futex, &state_, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+MONAD_NAMESPACE_END
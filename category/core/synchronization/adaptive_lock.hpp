@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/core/likely.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Contention counters shared by the locks of one kind, e.g. the shard locks
+/// of all clock caches. Instances register themselves by name for
+/// `print_stats()` and must have static storage duration.
+class LockStats final
+{
+    char const *const name_;
+    LockStats *const next_;
+
+public:
+    /// `lock()` calls which found the lock taken
+    std::atomic<uint64_t> contended{0};
+    /// Of those, the calls which stopped spinning and parked
+    std::atomic<uint64_t> parked{0};
+
+    explicit LockStats(char const *name);
+
+    LockStats(LockStats const &) = delete;
+    LockStats &operator=(LockStats const &) = delete;
+
+    /// Stats for locks constructed without a kind
+    static LockStats &unnamed();
+
+    /// The counters of every kind of lock which was contended since the
+    /// previous call, as `lk_<name>=<contended>/<parked>` pairs. Resets them.
+    static std::string print_stats();
+};
+
+/// Lock which spins while the lock is held briefly and parks on a futex
+/// otherwise, so that waiters do not burn the timeslices of preempted or
+/// oversubscribed threads. Like the adaptive mutex of glibc, each lock
+/// keeps a moving average of the spins a contended `lock()` took, and
+/// spins for at most twice as many before parking.
+class AdaptiveLock final
+{
+    static constexpr int32_t max_spins = 1000;
+
+    enum : uint32_t
+    {
+        Unlocked = 0,
+        Locked = 1,
+        LockedWithWaiters = 2,
+    };
+
+    std::atomic<uint32_t> state_{Unlocked};
+    std::atomic<int32_t> spins_{0};
+    LockStats &stats_;
+
+    void lock_slow() noexcept;
+    void wake() noexcept;
+
+public:
+    explicit AdaptiveLock(LockStats &stats = LockStats::unnamed()) noexcept
+        : stats_{stats}
+    {
+    }
+
+    AdaptiveLock(AdaptiveLock const &) = delete;
+    AdaptiveLock &operator=(AdaptiveLock const &) = delete;
+
+    bool try_lock() noexcept
+    {
+        uint32_t expected = Unlocked;
+        return state_.compare_exchange_strong(
+            expected, Locked, std::memory_order_acquire,
+            std::memory_order_relaxed);
+    }
+
+    void lock() noexcept
+    {
+        if (MONAD_UNLIKELY(!try_lock())) {
+            lock_slow();
+        }
+    }
+
+    void unlock() noexcept
+    {
+        if (MONAD_UNLIKELY(
+                state_.exchange(Unlocked, std::memory_order_release) ==
+                LockedWithWaiters)) {
+            wake();
+        }
+    }
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,92 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/config.hpp>
+#include <category/core/synchronization/epoch_domain.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    std::atomic<size_t> next_slot{0};
+}
+
+size_t EpochDomain::this_thread_slot() noexcept
+{
+    thread_local size_t const slot =
+        next_slot.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+    return slot;
+}
+
+bool EpochDomain::drained(uint64_t const parity) const noexcept
+{
+    for (auto const &slot : slots_) {
+        if (slot.readers[parity].load(std::memory_order_seq_cst) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Readers are only on the parities of the current epoch and the one
+// before, so the epoch may advance when the one before has drained, which
+// at most twice frees what the current epoch retired.
+void EpochDomain::advance_and_reclaim()
+{
+    for (int i = 0; i < 2; ++i) {
+        uint64_t const epoch = epoch_.load(std::memory_order_seq_cst);
+        if (!drained((epoch + 1) & 1)) {
+            break;
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    }
+    uint64_t const epoch = epoch_.load(std::memory_order_seq_cst);
+    size_t n = 0;
+    while (n < retired_.size() && retired_[n].first + 2 <= epoch) {
+        retired_[n].second();
+        ++n;
+    }
+    retired_.erase(retired_.begin(), retired_.begin() + std::ptrdiff_t(n));
+}
+
+EpochDomain::~EpochDomain()
+{
+    for (auto &[epoch, free] : retired_) {
+        free();
+    }
+}
+
+void EpochDomain::retire(std::function<void()> free)
+{
+    std::lock_guard const g(mutex_);
+    retired_.emplace_back(
+        epoch_.load(std::memory_order_seq_cst), std::move(free));
+    advance_and_reclaim();
+}
+
+size_t EpochDomain::num_retired()
+{
+    std::lock_guard const g(mutex_);
+    return retired_.size();
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Epoch based reclamation, for data which readers reach through atomic
+/// pointers without taking a lock. A reader pins the current epoch for as
+/// long as it uses what it loaded; a writer swaps in a new object and
+/// retires the old one, which is freed once every reader which could have
+/// loaded it has unpinned.
+///
+/// Readers count themselves in one of two counters per slot, by the parity
+/// of the epoch they pinned, and threads share slots by hash, so there is no
+/// registration. The epoch advances only when no reader is left on the
+/// parity it is about to reuse, so an object retired in epoch `e` is free
+/// once the epoch reaches `e + 2`. Retiring is serialized and reclaims
+/// whatever is free; readers never wait, and a pin must not be held across
+/// a fiber switch.
+class EpochDomain final
+{
+    static constexpr size_t SLOTS = 64;
+
+    struct alignas(64) Slot
+    {
+        std::array<std::atomic<uint64_t>, 2> readers{};
+    };
+
+    std::atomic<uint64_t> epoch_{0};
+    std::array<Slot, SLOTS> slots_{};
+    std::mutex mutex_;
+    // the epoch each was retired in, oldest first
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired_;
+
+    static size_t this_thread_slot() noexcept;
+
+    bool drained(uint64_t parity) const noexcept;
+    void advance_and_reclaim();
+
+public:
+    class Guard
+    {
+        std::atomic<uint64_t> *readers_;
+
+        friend class EpochDomain;
+
+        explicit Guard(std::atomic<uint64_t> *const readers) noexcept
+            : readers_{readers}
+        {
+        }
+
+    public:
+        Guard(Guard const &) = delete;
+        Guard &operator=(Guard const &) = delete;
+
+        Guard(Guard &&other) noexcept
+            : readers_{std::exchange(other.readers_, nullptr)}
+        {
+        }
+
+        ~Guard()
+        {
+            if (readers_ != nullptr) {
+                readers_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+    };
+
+    EpochDomain() = default;
+    EpochDomain(EpochDomain const &) = delete;
+    EpochDomain &operator=(EpochDomain const &) = delete;
+    // frees everything retired; no reader may be pinned
+    ~EpochDomain();
+
+    [[nodiscard]] Guard pin() noexcept
+    {
+        Slot &slot = slots_[this_thread_slot()];
+        while (true) {
+            uint64_t const epoch = epoch_.load(std::memory_order_seq_cst);
+            auto &readers = slot.readers[epoch & 1];
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            // a writer which advanced meanwhile may not have seen this pin
+            if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+                return Guard{&readers};
+            }
+            readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    /// `free` runs once no reader can hold what it frees, which must
+    /// already be unreachable for new readers
+    void retire(std::function<void()> free);
+
+    /// objects retired and not yet freed
+    size_t num_retired();
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,87 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/synchronization/adaptive_lock.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace MONAD_NAMESPACE;
+
+namespace
+{
+    LockStats test_lock_stats{"adaptive_lock_test"};
+}
+
+TEST(AdaptiveLock, try_lock)
+{
+    AdaptiveLock lock{test_lock_stats};
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+TEST(AdaptiveLock, mutual_exclusion)
+{
+    constexpr unsigned threads = 8;
+    constexpr uint64_t iterations = 100'000;
+
+    AdaptiveLock lock{test_lock_stats};
+    uint64_t counter = 0;
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([&] {
+                for (uint64_t j = 0; j < iterations; ++j) {
+                    std::unique_lock const guard{lock};
+                    ++counter;
+                }
+            });
+        }
+    }
+    EXPECT_EQ(counter, threads * iterations);
+}
+
+TEST(AdaptiveLock, parks_while_held)
+{
+    AdaptiveLock lock{test_lock_stats};
+    LockStats::print_stats();
+
+    lock.lock();
+    std::jthread waiter{[&] {
+        lock.lock();
+        lock.unlock();
+    }};
+    while (test_lock_stats.parked.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    lock.unlock();
+    waiter.join();
+
+    EXPECT_EQ(test_lock_stats.contended.load(), 1);
+    EXPECT_EQ(test_lock_stats.parked.load(), 1);
+    EXPECT_EQ(LockStats::print_stats(), ",lk_adaptive_lock_test=1/1");
+    EXPECT_EQ(LockStats::print_stats(), "");
+}
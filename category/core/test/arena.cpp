@@ -0,0 +1,83 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/mem/arena.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+using namespace monad;
+
+TEST(Arena, bump_and_reset)
+{
+    Arena arena;
+    auto *const a = static_cast<std::byte *>(arena.allocate(24, 8));
+    auto *const b = static_cast<std::byte *>(arena.allocate(8, 8));
+    EXPECT_EQ(b, a + 24);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(1, 64)) % 64, 0);
+    EXPECT_EQ(arena.num_chunks(), 1);
+
+    // large allocations do not consume chunks
+    EXPECT_NE(arena.allocate(1 << 20, 8), nullptr);
+    EXPECT_EQ(arena.num_chunks(), 1);
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(24, 8), a);
+    EXPECT_EQ(arena.num_chunks(), 1);
+}
+
+TEST(Arena, allocator_outside_scope_uses_heap)
+{
+    EXPECT_EQ(Arena::current(), nullptr);
+    std::vector<int, ArenaAllocator<int>> v;
+    EXPECT_EQ(v.get_allocator().arena(), nullptr);
+    v.resize(1000, 1);
+    EXPECT_EQ(v.back(), 1);
+}
+
+TEST(Arena, scope)
+{
+    Arena *arena = nullptr;
+    {
+        ArenaScope const scope;
+        arena = Arena::current();
+        ASSERT_NE(arena, nullptr);
+        {
+            ArenaScope const nested;
+            EXPECT_EQ(Arena::current(), arena);
+        }
+        EXPECT_EQ(Arena::current(), arena);
+
+        std::deque<uint64_t, ArenaAllocator<uint64_t>> d;
+        EXPECT_EQ(d.get_allocator().arena(), arena);
+        for (uint64_t i = 0; i < 100'000; ++i) {
+            d.push_back(i);
+        }
+        EXPECT_EQ(d[99'999], 99'999);
+        EXPECT_GT(arena->num_chunks(), 1);
+    }
+    EXPECT_EQ(Arena::current(), nullptr);
+
+    // the fiber keeps its arena, and its chunks, for the next scope
+    ArenaScope const scope;
+    EXPECT_EQ(Arena::current(), arena);
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/blocked_bloom_filter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+using monad::BlockedBloomFilter;
+
+TEST(blocked_bloom_filter, size_in_whole_blocks)
+{
+    EXPECT_EQ(BlockedBloomFilter{0}.size_bytes(), 64);
+    EXPECT_EQ(BlockedBloomFilter{100}.size_bytes(), 64);
+    EXPECT_EQ(BlockedBloomFilter{1 << 20}.size_bytes(), 1 << 20);
+}
+
+TEST(blocked_bloom_filter, no_false_negatives)
+{
+    constexpr size_t N = 1 << 16;
+    BlockedBloomFilter filter{N * 2};
+    std::mt19937_64 rng{1};
+    for (size_t i = 0; i < N; ++i) {
+        filter.insert(rng());
+    }
+    rng.seed(1);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_TRUE(filter.may_contain(rng()));
+    }
+}
+
+TEST(blocked_bloom_filter, false_positive_rate)
+{
+    // 16 bits per key
+    constexpr size_t N = 1 << 16;
+    BlockedBloomFilter filter{N * 2};
+    std::mt19937_64 rng{1};
+    for (size_t i = 0; i < N; ++i) {
+        filter.insert(rng());
+    }
+    size_t false_positives = 0;
+    for (size_t i = 0; i < N * 4; ++i) {
+        false_positives += filter.may_contain(rng());
+    }
+    EXPECT_LT(false_positives, N * 4 / 200);
+}
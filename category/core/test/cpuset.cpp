@@ -68,3 +68,12 @@ TEST(Cpuset, parse_empty)
     auto set = monad_parse_cpuset(evens);
     EXPECT_TRUE(CPU_EQUAL(&empty, &set));
 }
+
+TEST(Cpuset, numa_node_missing)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(0, &set);
+    EXPECT_FALSE(monad_numa_node_cpuset(1u << 20, &set));
+    EXPECT_EQ(CPU_COUNT(&set), 0);
+}
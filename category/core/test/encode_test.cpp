@@ -21,6 +21,8 @@
 #include <gtest/gtest.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <span>
 
 using monad::byte_string;
@@ -201,3 +203,52 @@ TEST(rlp, encode_list)
         byte_string_view(buf, result.data()) ==
         byte_string({248, 56}) + byte_string(56, 1));
 }
+
+TEST(rlp, encode_headers_match_copying_encoders)
+{
+    for (size_t const size : {size_t{2}, size_t{55}, size_t{56}, size_t{300}}) {
+        byte_string const payload(size, 0xAB);
+        unsigned char expected[512];
+        unsigned char buf[512];
+
+        auto end = monad::rlp::encode_string(expected, payload);
+        auto d = monad::rlp::encode_string_header(buf, size);
+        EXPECT_EQ(
+            static_cast<size_t>(d.data() - buf),
+            monad::rlp::string_header_length(size));
+        std::memcpy(d.data(), payload.data(), size);
+        EXPECT_TRUE(
+            byte_string_view(buf, d.data() + size) ==
+            byte_string_view(expected, end.data()));
+
+        end = monad::rlp::encode_list(expected, payload);
+        d = monad::rlp::encode_list_header(buf, size);
+        EXPECT_EQ(
+            static_cast<size_t>(d.data() - buf),
+            monad::rlp::list_header_length(size));
+        std::memcpy(d.data(), payload.data(), size);
+        EXPECT_TRUE(
+            byte_string_view(buf, d.data() + size) ==
+            byte_string_view(expected, end.data()));
+    }
+}
+
+TEST(rlp, encode_unsigned)
+{
+    unsigned char buf[16];
+    auto const encode = [&buf](uint64_t const n) {
+        auto const end = monad::rlp::encode_unsigned(buf, n);
+        EXPECT_EQ(
+            static_cast<size_t>(end.data() - buf),
+            monad::rlp::unsigned_length(n));
+        return byte_string(buf, end.data());
+    };
+    EXPECT_EQ(encode(0), byte_string({0x80}));
+    EXPECT_EQ(encode(1), byte_string({0x01}));
+    EXPECT_EQ(encode(0x7F), byte_string({0x7F}));
+    EXPECT_EQ(encode(0x80), byte_string({0x81, 0x80}));
+    EXPECT_EQ(encode(0x0400), byte_string({0x82, 0x04, 0x00}));
+    EXPECT_EQ(
+        encode(~uint64_t{0}),
+        byte_string({0x88, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}));
+}
@@ -0,0 +1,105 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/synchronization/epoch_domain.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace MONAD_NAMESPACE;
+
+TEST(EpochDomain, frees_without_readers)
+{
+    EpochDomain domain;
+    bool freed = false;
+    domain.retire([&] { freed = true; });
+    EXPECT_TRUE(freed);
+    EXPECT_EQ(domain.num_retired(), 0);
+}
+
+TEST(EpochDomain, defers_while_pinned)
+{
+    EpochDomain domain;
+    bool first = false;
+    bool second = false;
+    std::optional<EpochDomain::Guard> guard{domain.pin()};
+    domain.retire([&] { first = true; });
+    EXPECT_FALSE(first);
+    EXPECT_EQ(domain.num_retired(), 1);
+
+    guard.reset();
+    domain.retire([&] { second = true; });
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(second);
+    EXPECT_EQ(domain.num_retired(), 0);
+}
+
+TEST(EpochDomain, readers_never_see_freed)
+{
+    struct Object
+    {
+        std::atomic<bool> alive{true};
+    };
+
+    constexpr unsigned readers = 4;
+    constexpr unsigned publishes = 20'000;
+
+    EpochDomain domain;
+    // freed objects stay allocated, so a late reader sees them dead rather
+    // than reading freed memory
+    std::vector<std::unique_ptr<Object>> objects;
+    objects.reserve(publishes + 1);
+    std::atomic<Object *> current{objects.emplace_back(new Object).get()};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> dead_reads{0};
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned i = 0; i < readers; ++i) {
+            threads.emplace_back([&] {
+                while (!done.load(std::memory_order_acquire)) {
+                    auto const g = domain.pin();
+                    Object const *const object =
+                        current.load(std::memory_order_acquire);
+                    if (!object->alive.load(std::memory_order_acquire)) {
+                        dead_reads.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (unsigned i = 0; i < publishes; ++i) {
+            Object *const old = current.exchange(
+                objects.emplace_back(new Object).get(),
+                std::memory_order_acq_rel);
+            domain.retire([old] {
+                old->alive.store(false, std::memory_order_release);
+            });
+        }
+        done.store(true, std::memory_order_release);
+    }
+    EXPECT_EQ(dead_reads.load(), 0);
+
+    // with the readers gone, the next retire frees everything
+    domain.retire([] {});
+    EXPECT_EQ(domain.num_retired(), 0);
+}
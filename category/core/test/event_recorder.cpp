@@ -482,3 +482,85 @@ TEST_F(EventRecorderDefaultFixture, LargePayloads)
             data(big_buffer_bytes),
             size(big_buffer_bytes)));
 }
+
+static void record_counters(
+    monad_event_recorder *recorder, uint64_t first, uint64_t count)
+{
+    for (uint64_t counter = first; counter < first + count; ++counter) {
+        uint64_t seqno;
+        uint8_t *payload_buf;
+        monad_event_descriptor *const event = monad_event_recorder_reserve(
+            recorder, sizeof(monad_test_event_counter), &seqno, &payload_buf);
+        ASSERT_NE(event, nullptr);
+        event->event_type = MONAD_TEST_EVENT_COUNTER;
+        monad_test_event_counter const payload = {
+            .writer_id = 0, .counter = counter};
+        memcpy(payload_buf, &payload, sizeof payload);
+        monad_event_recorder_commit(event, seqno);
+    }
+}
+
+// Batches are contiguous runs of ready events that are validated once, after
+// they are consumed; check that they stop at the end of the available events
+// and at the end of the descriptor array, and that lapping is detected
+TEST_F(EventRecorderDefaultFixture, BatchIteration)
+{
+    constexpr uint64_t CAPACITY = 1UL << DEFAULT_DESCRIPTORS_SHIFT;
+    alignas(64) monad_event_recorder recorder;
+    alignas(64) monad_event_iterator iter;
+    monad_event_batch batch;
+
+    ASSERT_EQ(0, monad_event_ring_init_recorder(&event_ring_, &recorder));
+    ASSERT_EQ(0, monad_event_ring_init_iterator(&event_ring_, &iter));
+    ASSERT_EQ(
+        MONAD_EVENT_NOT_READY,
+        monad_event_iterator_try_next_batch(&iter, 64, &batch));
+    ASSERT_EQ(0UL, batch.count);
+
+    record_counters(&recorder, 0, 100);
+    uint64_t expected = 0;
+    for (size_t const expected_count : {64UL, 36UL}) {
+        ASSERT_EQ(
+            MONAD_EVENT_SUCCESS,
+            monad_event_iterator_try_next_batch(&iter, 64, &batch));
+        ASSERT_EQ(expected_count, batch.count);
+        ASSERT_EQ(expected + 1, batch.first_seqno);
+        for (monad_event_descriptor const &event :
+             std::span{batch.events, batch.count}) {
+            auto const *const payload =
+                static_cast<monad_test_event_counter const *>(
+                    monad_event_ring_payload_peek(&event_ring_, &event));
+            EXPECT_EQ(expected + 1, event.seqno);
+            EXPECT_EQ(expected++, payload->counter);
+        }
+        EXPECT_TRUE(monad_event_iterator_check_batch(&iter, &batch));
+    }
+    ASSERT_EQ(
+        MONAD_EVENT_NOT_READY,
+        monad_event_iterator_try_next_batch(&iter, 64, &batch));
+
+    // Fill the rest of the descriptor array and a few slots past its end; a
+    // batch starting near the end stops there, and the next one wraps around
+    record_counters(&recorder, 100, CAPACITY - 100 + 10);
+    monad_event_iterator_set_seqno(&iter, CAPACITY - 1);
+    ASSERT_EQ(
+        MONAD_EVENT_SUCCESS,
+        monad_event_iterator_try_next_batch(&iter, 64, &batch));
+    ASSERT_EQ(2UL, batch.count);
+    EXPECT_TRUE(monad_event_iterator_check_batch(&iter, &batch));
+    ASSERT_EQ(
+        MONAD_EVENT_SUCCESS,
+        monad_event_iterator_try_next_batch(&iter, 64, &batch));
+    ASSERT_EQ(10UL, batch.count);
+    ASSERT_EQ(CAPACITY + 1, batch.first_seqno);
+    ASSERT_EQ(batch.events, iter.descriptors);
+    EXPECT_TRUE(monad_event_iterator_check_batch(&iter, &batch));
+
+    // A batch that has been lapped by the writer fails validation, even
+    // though the iterator already moved past it
+    record_counters(&recorder, CAPACITY + 10, CAPACITY + 1);
+    EXPECT_FALSE(monad_event_iterator_check_batch(&iter, &batch));
+    ASSERT_EQ(
+        MONAD_EVENT_GAP,
+        monad_event_iterator_try_next_batch(&iter, 64, &batch));
+}
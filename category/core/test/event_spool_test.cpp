@@ -0,0 +1,204 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/cleanup.h>
+#include <category/core/event/event_iterator.h>
+#include <category/core/event/event_recorder.h>
+#include <category/core/event/event_ring.h>
+#include <category/core/event/event_ring_util.h>
+#include <category/core/event/event_spool.hpp>
+#include <category/core/event/test_event_ctypes.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <utility>
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace monad;
+
+namespace
+{
+    constexpr uint64_t EVENTS_PER_BLOCK = 100;
+
+    class EventSpoolTest : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            constexpr char MEMFD_NAME[] = "event_spool_test";
+            int ring_fd [[gnu::cleanup(cleanup_close)]] =
+                memfd_create(MEMFD_NAME, 0);
+            ASSERT_NE(ring_fd, -1);
+            monad_event_ring_simple_config const simple_cfg = {
+                .descriptors_shift = 16,
+                .payload_buf_shift = 28,
+                .context_large_pages = 0,
+                .content_type = MONAD_EVENT_CONTENT_TYPE_TEST,
+                .schema_hash = g_monad_test_event_schema_hash};
+            ASSERT_EQ(
+                0,
+                monad_event_ring_init_simple(
+                    &simple_cfg, ring_fd, 0, MEMFD_NAME));
+            ASSERT_EQ(
+                0,
+                monad_event_ring_mmap(
+                    &event_ring_,
+                    PROT_READ | PROT_WRITE,
+                    0,
+                    ring_fd,
+                    0,
+                    MEMFD_NAME));
+            ASSERT_EQ(
+                0, monad_event_ring_init_recorder(&event_ring_, &recorder_));
+            dir_ = std::filesystem::temp_directory_path() /
+                   std::format("event_spool_test_{}", getpid());
+        }
+
+        void TearDown() override
+        {
+            monad_event_ring_unmap(&event_ring_);
+            std::filesystem::remove_all(dir_);
+        }
+
+        void record(uint64_t const first, uint64_t const count)
+        {
+            for (uint64_t counter = first; counter < first + count;
+                 ++counter) {
+                uint64_t seqno;
+                uint8_t *payload_buf;
+                monad_event_descriptor *const event =
+                    monad_event_recorder_reserve(
+                        &recorder_,
+                        sizeof(monad_test_event_counter),
+                        &seqno,
+                        &payload_buf);
+                ASSERT_NE(event, nullptr);
+                event->event_type = MONAD_TEST_EVENT_COUNTER;
+                monad_test_event_counter const payload = {
+                    .writer_id = 0, .counter = counter};
+                memcpy(payload_buf, &payload, sizeof payload);
+                monad_event_recorder_commit(event, seqno);
+            }
+        }
+
+        // Every EVENTS_PER_BLOCK-th counter plays the part of a block start
+        static bool block_number(
+            monad_event_ring const *event_ring,
+            monad_event_descriptor const *event, uint64_t *block_number)
+        {
+            auto const *const payload =
+                static_cast<monad_test_event_counter const *>(
+                    monad_event_ring_payload_peek(event_ring, event));
+            if (payload->counter % EVENTS_PER_BLOCK != 0) {
+                return false;
+            }
+            *block_number = payload->counter / EVENTS_PER_BLOCK + 1;
+            return true;
+        }
+
+        alignas(64) monad_event_ring event_ring_;
+        alignas(64) monad_event_recorder recorder_;
+        std::filesystem::path dir_;
+    };
+}
+
+TEST_F(EventSpoolTest, replay)
+{
+    constexpr uint64_t N_EVENTS = 1000;
+    {
+        EventSpoolWriter const writer{
+            event_ring_,
+            {.dir = dir_,
+             .segment_bytes = 8192,
+             .block_number = &EventSpoolTest::block_number}};
+        record(0, N_EVENTS);
+    }
+
+    EventSpoolReader reader{dir_};
+    auto const segments = reader.segments();
+    ASSERT_GT(segments.size(), 1UL);
+    uint64_t next_seqno = 1;
+    for (auto const &segment : segments) {
+        EXPECT_EQ(next_seqno, segment.first_seqno);
+        EXPECT_EQ(
+            std::to_underlying(MONAD_EVENT_CONTENT_TYPE_TEST),
+            segment.content_type);
+        // Segments only start at block boundaries
+        EXPECT_EQ(0UL, (segment.first_seqno - 1) % EVENTS_PER_BLOCK);
+        next_seqno = segment.last_seqno + 1;
+    }
+    EXPECT_EQ(N_EVENTS + 1, next_seqno);
+
+    // Read everything back through the iterator API, across segments
+    ASSERT_TRUE(reader.seek_seqno(1));
+    monad_event_descriptor event;
+    uint64_t counter = 0;
+    for (;;) {
+        auto const r = monad_event_iterator_try_next(reader.iterator(), &event);
+        if (r == MONAD_EVENT_NOT_READY) {
+            if (!reader.next_segment()) {
+                break;
+            }
+            continue;
+        }
+        ASSERT_EQ(MONAD_EVENT_SUCCESS, r);
+        ASSERT_EQ(counter + 1, event.seqno);
+        ASSERT_EQ(MONAD_TEST_EVENT_COUNTER, event.event_type);
+        ASSERT_TRUE(
+            monad_event_ring_payload_check(reader.event_ring(), &event));
+        auto const *const payload =
+            static_cast<monad_test_event_counter const *>(
+                monad_event_ring_payload_peek(reader.event_ring(), &event));
+        ASSERT_EQ(counter++, payload->counter);
+    }
+    EXPECT_EQ(N_EVENTS, counter);
+
+    // Seek into the middle of a segment, by sequence number and by block
+    ASSERT_TRUE(reader.seek_seqno(457));
+    ASSERT_EQ(
+        MONAD_EVENT_SUCCESS,
+        monad_event_iterator_try_next(reader.iterator(), &event));
+    EXPECT_EQ(457UL, event.seqno);
+
+    ASSERT_TRUE(reader.seek_block(6));
+    ASSERT_TRUE(reader.segment().has_value());
+    EXPECT_LE(reader.segment()->first_block, 6UL);
+    EXPECT_GE(reader.segment()->last_block, 6UL);
+
+    EXPECT_FALSE(reader.seek_seqno(N_EVENTS + 1));
+    EXPECT_FALSE(reader.seek_block(N_EVENTS));
+}
+
+TEST_F(EventSpoolTest, retention)
+{
+    {
+        EventSpoolWriter const writer{
+            event_ring_,
+            {.dir = dir_, .segment_bytes = 4096, .max_segments = 2}};
+        record(0, 1000);
+    }
+    EventSpoolReader const reader{dir_};
+    auto const segments = reader.segments();
+    ASSERT_EQ(2UL, segments.size());
+    EXPECT_EQ(1000UL, segments.back().last_seqno);
+    EXPECT_EQ(segments.front().last_seqno + 1, segments.back().first_seqno);
+}
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/mem/huge_slab.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace MONAD_NAMESPACE;
+
+TEST(HugeSlabAllocator, size_classes)
+{
+    for (size_t size = 1; size <= HugeSlabAllocator::max_block_size; ++size) {
+        auto const c = HugeSlabAllocator::size_class(size);
+        ASSERT_LT(c, HugeSlabAllocator::size_classes);
+        EXPECT_GE(HugeSlabAllocator::block_size(c), size);
+        EXPECT_EQ(HugeSlabAllocator::block_size(c) % 16, 0);
+        if (c > 0) {
+            EXPECT_LT(
+                HugeSlabAllocator::block_size(static_cast<uint8_t>(c - 1)),
+                size);
+        }
+    }
+}
+
+TEST(HugeSlabAllocator, falls_back_until_enabled)
+{
+    HugeSlabAllocator allocator;
+    EXPECT_EQ(allocator.allocate(64), nullptr);
+    int x;
+    EXPECT_FALSE(allocator.deallocate(&x));
+    EXPECT_FALSE(allocator.enable(HugeSlabAllocator::slab_size - 1));
+}
+
+TEST(HugeSlabAllocator, reuses_blocks_per_size_class)
+{
+    HugeSlabAllocator allocator;
+    ASSERT_TRUE(allocator.enable(4 * HugeSlabAllocator::slab_size));
+    EXPECT_FALSE(allocator.enable(4 * HugeSlabAllocator::slab_size));
+    EXPECT_EQ(
+        allocator.allocate(HugeSlabAllocator::max_block_size + 1), nullptr);
+
+    void *const a = allocator.allocate(100);
+    void *const b = allocator.allocate(100);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_TRUE(allocator.owns(a));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 16, 0);
+    EXPECT_EQ(
+        static_cast<unsigned char *>(b) - static_cast<unsigned char *>(a),
+        112);
+    std::memset(a, 0xff, 100);
+
+    void *const c = allocator.allocate(1000);
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(allocator.stats().slabs, 2);
+
+    EXPECT_EQ(allocator.stats().used_bytes, 2 * 112 + 1024);
+    EXPECT_TRUE(allocator.deallocate(a));
+    EXPECT_EQ(allocator.stats().used_bytes, 112 + 1024);
+    EXPECT_EQ(allocator.allocate(97), a);
+    EXPECT_TRUE(allocator.deallocate(c));
+    EXPECT_NE(allocator.allocate(100), c);
+}
+
+TEST(HugeSlabAllocator, exhausts_reservation)
+{
+    HugeSlabAllocator allocator;
+    ASSERT_TRUE(allocator.enable(HugeSlabAllocator::slab_size));
+    std::set<void *> blocks;
+    auto const n =
+        HugeSlabAllocator::slab_size / HugeSlabAllocator::max_block_size;
+    for (size_t i = 0; i < n; ++i) {
+        void *const p = allocator.allocate(HugeSlabAllocator::max_block_size);
+        ASSERT_NE(p, nullptr);
+        blocks.insert(p);
+    }
+    EXPECT_EQ(blocks.size(), n);
+    EXPECT_EQ(allocator.allocate(HugeSlabAllocator::max_block_size), nullptr);
+    EXPECT_EQ(allocator.allocate(16), nullptr);
+    EXPECT_EQ(allocator.stats().slabs, 1);
+    EXPECT_EQ(allocator.stats().reserved_slabs, 1);
+}
+
+TEST(HugeSlabAllocator, thread_caches_return_blocks_on_exit)
+{
+    HugeSlabAllocator allocator{/*thread_caches=*/true};
+    ASSERT_TRUE(allocator.enable(4 * HugeSlabAllocator::slab_size));
+    auto const batch = HugeSlabAllocator::thread_cache_blocks / 2;
+
+    void *kept = nullptr;
+    std::thread{[&] {
+        void *const a = allocator.allocate(100);
+        ASSERT_NE(a, nullptr);
+        // The other blocks of the refilled batch are cached by this thread
+        EXPECT_EQ(allocator.stats().used_bytes, batch * 112);
+        EXPECT_TRUE(allocator.deallocate(a));
+        EXPECT_EQ(allocator.allocate(100), a);
+
+        // Freeing more than a cache holds moves a batch to the central list
+        std::vector<void *> blocks;
+        for (size_t i = 0; i < 2 * HugeSlabAllocator::thread_cache_blocks;
+             ++i) {
+            blocks.push_back(allocator.allocate(100));
+            ASSERT_NE(blocks.back(), nullptr);
+        }
+        for (void *const p : blocks) {
+            EXPECT_TRUE(allocator.deallocate(p));
+        }
+        EXPECT_LE(
+            allocator.stats().used_bytes,
+            (HugeSlabAllocator::thread_cache_blocks + 1) * 112);
+        kept = a;
+    }}.join();
+
+    // Only the block still allocated is in use once the thread exits. This
+    // thread outlives the allocator, so it must not use it.
+    EXPECT_EQ(allocator.stats().used_bytes, 112);
+    std::thread{[&] { EXPECT_TRUE(allocator.deallocate(kept)); }}.join();
+    EXPECT_EQ(allocator.stats().used_bytes, 0);
+    EXPECT_GT(allocator.stats().fragmentation(), 0.99);
+}
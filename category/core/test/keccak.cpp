@@ -0,0 +1,85 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/keccak.h>
+#include <category/core/keccak.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace monad;
+
+namespace
+{
+    byte_string make_input(size_t const len, unsigned char const seed)
+    {
+        byte_string input(len, 0);
+        for (size_t i = 0; i < len; ++i) {
+            input[i] = static_cast<unsigned char>(seed + i * 7);
+        }
+        return input;
+    }
+}
+
+TEST(Keccak, x4_matches_scalar)
+{
+    // lengths straddling the 136 byte rate, mixed within one call
+    std::vector<size_t> const lens{0, 1, 31, 32, 33, 135, 136, 137, 271, 272,
+                                   500, 1000};
+    for (size_t a = 0; a < lens.size(); ++a) {
+        for (size_t b = 0; b < lens.size(); ++b) {
+            byte_string const inputs[4] = {
+                make_input(lens[a], 1),
+                make_input(lens[b], 2),
+                make_input(lens[(a + b) % lens.size()], 3),
+                make_input(lens[(a * b) % lens.size()], 4)};
+            unsigned char const *data[4];
+            unsigned long len[4];
+            for (size_t i = 0; i < 4; ++i) {
+                data[i] = inputs[i].data();
+                len[i] = inputs[i].size();
+            }
+            unsigned char out[4][KECCAK256_SIZE];
+            keccak256_x4(data, len, out);
+            for (size_t i = 0; i < 4; ++i) {
+                auto const expected = keccak256(byte_string_view{inputs[i]});
+                EXPECT_EQ(
+                    std::memcmp(out[i], expected.bytes, KECCAK256_SIZE), 0)
+                    << "lengths " << lens[a] << " " << lens[b];
+            }
+        }
+    }
+}
+
+TEST(Keccak, batch_matches_scalar)
+{
+    std::vector<byte_string> inputs;
+    std::vector<byte_string_view> views;
+    for (unsigned char i = 0; i < 11; ++i) {
+        inputs.push_back(make_input(32, i));
+    }
+    for (auto const &input : inputs) {
+        views.emplace_back(input);
+    }
+    std::vector<hash256> hashes(views.size());
+    keccak256(views, hashes);
+    for (size_t i = 0; i < views.size(); ++i) {
+        EXPECT_EQ(hashes[i], keccak256(views[i]));
+    }
+}
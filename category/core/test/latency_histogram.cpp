@@ -0,0 +1,103 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <category/core/util/latency_histogram.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace monad;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogram, bucket_error_is_bounded)
+{
+    for (uint64_t ns = 1; ns < (uint64_t{1} << 40); ns = ns * 3 + 1) {
+        auto const upper = latency_detail::bucket_upper_bound(
+            latency_detail::bucket_index(ns));
+        EXPECT_GE(upper, ns);
+        EXPECT_LE(upper - ns, ns / latency_detail::SUB_BUCKETS);
+    }
+}
+
+TEST(LatencyHistogram, quantiles)
+{
+    auto &metric = latency_metric("test_quantiles_seconds", "test");
+    for (unsigned i = 1; i <= 1000; ++i) {
+        metric.record(std::chrono::microseconds{i});
+    }
+    auto const snapshot = metric.snapshot();
+    EXPECT_EQ(snapshot.count, 1000);
+    EXPECT_EQ(snapshot.sum_ns, 500'500'000);
+    EXPECT_EQ(snapshot.max_ns, 1'000'000);
+    EXPECT_EQ(snapshot.quantile_ns(1.0), 1'000'000);
+    for (double const q : {0.5, 0.9, 0.99}) {
+        auto const expected = static_cast<double>(q * 1e6);
+        auto const actual = static_cast<double>(snapshot.quantile_ns(q));
+        EXPECT_GE(actual, expected);
+        EXPECT_LE(actual, expected * 17 / 16);
+    }
+    EXPECT_EQ(LatencySnapshot{}.quantile_ns(0.5), 0);
+}
+
+TEST(LatencyHistogram, threads_record_into_own_shards)
+{
+    constexpr size_t THREADS = 8;
+    constexpr size_t RECORDS = 10'000;
+    auto &metric = latency_metric("test_threads_seconds", "test");
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&metric] {
+                for (size_t i = 0; i < RECORDS; ++i) {
+                    metric.record(100ns);
+                }
+            });
+        }
+    }
+    auto const snapshot = metric.snapshot();
+    EXPECT_EQ(snapshot.count, THREADS * RECORDS);
+    EXPECT_EQ(snapshot.sum_ns, THREADS * RECORDS * 100);
+    EXPECT_EQ(snapshot.quantile_ns(0.999), 100);
+}
+
+TEST(LatencyHistogram, prometheus_text)
+{
+    auto &metric = latency_metric("test_prometheus_seconds", "help text");
+    EXPECT_EQ(&metric, &latency_metric("test_prometheus_seconds", "ignored"));
+    {
+        ScopedLatency const timer{metric};
+    }
+    std::ostringstream os;
+    write_latency_metrics(os);
+    std::string const text = os.str();
+    EXPECT_NE(
+        text.find("# HELP test_prometheus_seconds help text\n"),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("# TYPE test_prometheus_seconds summary\n"),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("test_prometheus_seconds{quantile=\"0.99\"} "),
+        std::string::npos);
+    EXPECT_NE(
+        text.find("test_prometheus_seconds_count 1\n"), std::string::npos);
+}
@@ -0,0 +1,64 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <category/core/util/log_rate_limit.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace monad;
+using namespace std::chrono_literals;
+
+TEST(LogRateLimit, admits_once_per_interval)
+{
+    LogRateLimit limit{1s};
+    std::chrono::steady_clock::time_point const t0{100s};
+
+    EXPECT_EQ(limit.admit(t0), std::optional<uint64_t>{0});
+    EXPECT_FALSE(limit.admit(t0).has_value());
+    EXPECT_FALSE(limit.admit(t0 + 999ms).has_value());
+    EXPECT_EQ(limit.admit(t0 + 1s), std::optional<uint64_t>{2});
+    EXPECT_FALSE(limit.admit(t0 + 1500ms).has_value());
+    EXPECT_EQ(limit.admit(t0 + 5s), std::optional<uint64_t>{1});
+    EXPECT_EQ(limit.admit(t0 + 10s), std::optional<uint64_t>{0});
+}
+
+TEST(LogRateLimit, concurrent_callers_admit_one)
+{
+    LogRateLimit limit{1h};
+    std::chrono::steady_clock::time_point const t0{100s};
+    std::atomic<unsigned> admitted{0};
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            for (unsigned j = 0; j < 1000; ++j) {
+                if (limit.admit(t0).has_value()) {
+                    ++admitted;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(admitted.load(), 1);
+    EXPECT_EQ(limit.admit(t0 + 1h), std::optional<uint64_t>{7999});
+}
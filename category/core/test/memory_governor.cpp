@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/mem/memory_governor.hpp>
+
+#include <category/core/config.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace MONAD_NAMESPACE;
+
+namespace
+{
+    constexpr size_t MB = 1UL << 20;
+
+    struct FakeCache
+    {
+        uint64_t misses{0};
+        size_t budget{0};
+        unsigned set_budget_calls{0};
+
+        MemoryGovernor::Consumer consumer(
+            std::string name, size_t const min_bytes, size_t const max_bytes,
+            unsigned const priority = 1)
+        {
+            budget = max_bytes;
+            return {
+                .name = std::move(name),
+                .priority = priority,
+                .min_bytes = min_bytes,
+                .max_bytes = max_bytes,
+                .misses = [this] { return misses; },
+                .set_budget =
+                    [this](size_t const bytes) {
+                        budget = bytes;
+                        ++set_budget_calls;
+                    }};
+        }
+    };
+}
+
+TEST(MemoryGovernor, shrinks_least_valuable_cache_above_cap)
+{
+    size_t rss = 1024 * MB;
+    MemoryGovernor governor{640 * MB, [&] { return rss; }};
+    FakeCache a;
+    FakeCache b;
+    governor.add(a.consumer("a", 64 * MB, 512 * MB));
+    governor.add(b.consumer("b", 128 * MB, 512 * MB));
+
+    // a misses more per byte, so b gives up memory first, down to its
+    // minimum, and a covers the rest
+    a.misses = 1000;
+    b.misses = 10;
+    governor.rebalance();
+    EXPECT_EQ(b.budget, 128 * MB);
+    EXPECT_EQ(a.budget, 512 * MB);
+    EXPECT_EQ(governor.budget("a") + governor.budget("b"), 640 * MB);
+    EXPECT_EQ(a.set_budget_calls, 0);
+    EXPECT_EQ(b.set_budget_calls, 1);
+
+    rss = 2048 * MB;
+    governor.rebalance();
+    EXPECT_EQ(a.budget, 64 * MB);
+    EXPECT_EQ(b.budget, 128 * MB);
+    EXPECT_EQ(governor.budget("missing"), 0);
+}
+
+TEST(MemoryGovernor, grows_most_valuable_cache_below_cap)
+{
+    size_t rss = 1024 * MB;
+    MemoryGovernor governor{1024 * MB, [&] { return rss; }};
+    FakeCache a;
+    FakeCache b;
+    governor.add(a.consumer("a", 0, 512 * MB));
+    governor.add(b.consumer("b", 0, 512 * MB));
+
+    // Shrink to make room to grow
+    rss = 1280 * MB;
+    governor.rebalance();
+    EXPECT_EQ(a.budget, 256 * MB);
+    EXPECT_EQ(b.budget, 512 * MB);
+
+    // With headroom, the cache that missed grows by a step
+    rss = 512 * MB;
+    a.misses += 100;
+    governor.rebalance();
+    EXPECT_EQ(a.budget, 272 * MB);
+    EXPECT_EQ(b.budget, 512 * MB);
+
+    // Without headroom, budget moves from a cache worth less than half
+    rss = 1020 * MB;
+    a.misses += 100;
+    b.misses += 1;
+    governor.rebalance();
+    EXPECT_EQ(a.budget, 288 * MB);
+    EXPECT_EQ(b.budget, 496 * MB);
+
+    // Without misses nothing moves
+    governor.rebalance();
+    EXPECT_EQ(a.budget, 288 * MB);
+    EXPECT_EQ(b.budget, 496 * MB);
+    EXPECT_EQ(
+        governor.print_stats(),
+        ",rss=1020MB,rss_cap=1024MB,a=288MB,b=496MB");
+}
+
+TEST(MemoryGovernor, priority_scales_value)
+{
+    size_t rss = 512 * MB;
+    MemoryGovernor governor{1024 * MB, [&] { return rss; }};
+    FakeCache a;
+    FakeCache b;
+    governor.add(a.consumer("a", 0, 256 * MB, 1));
+    governor.add(b.consumer("b", 0, 256 * MB, 4));
+
+    rss = 1280 * MB;
+    a.misses = 100;
+    b.misses = 50;
+    governor.rebalance();
+    // b misses less but has four times the priority, so a shrinks
+    EXPECT_EQ(a.budget, 0);
+    EXPECT_EQ(b.budget, 256 * MB);
+}
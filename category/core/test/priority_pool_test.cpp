@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 #include <category/core/fiber/priority_pool.hpp>
+#include <category/core/fiber/priority_task.hpp>
 
 #include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
 
@@ -24,7 +25,11 @@
 #include <cstddef>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
+#include <utility>
 #include <vector>
 
 /* On Niall's machine, for reference:
@@ -38,6 +43,75 @@ This makes PriorityPool 0.000235691 times faster than a single CPU core.
 Hardware concurrency is 64
 */
 
+TEST(PriorityPool, inplace_task)
+{
+    auto const counter = std::make_shared<int>(0);
+    {
+        monad::fiber::InplaceTask task{[counter] { ++*counter; }};
+        EXPECT_EQ(counter.use_count(), 2);
+
+        monad::fiber::InplaceTask moved{std::move(task)};
+        EXPECT_FALSE(task);
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(counter.use_count(), 2);
+
+        moved();
+        moved();
+        EXPECT_EQ(*counter, 2);
+
+        task = std::move(moved);
+        EXPECT_FALSE(moved);
+        task();
+        EXPECT_EQ(*counter, 3);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(PriorityPool, submit_batch)
+{
+    std::atomic<unsigned> done{0};
+    {
+        monad::fiber::PriorityPool ppool(2, 4);
+        std::vector<monad::fiber::PriorityTask> tasks;
+        for (unsigned i = 0; i < 100; ++i) {
+            tasks.push_back({i, [&done] {
+                                 done.fetch_add(1, std::memory_order_acq_rel);
+                             }});
+        }
+        ppool.submit_batch(tasks);
+        while (done.load(std::memory_order_acquire) < 100) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(done.load(), 100);
+}
+
+TEST(PriorityPool, steals_work)
+{
+    // all fibers are created on the first worker, so every other worker only
+    // runs tasks if it steals fibers from that worker's queue
+    std::set<std::thread::id> ids;
+    std::mutex mutex;
+    std::atomic<unsigned> done{0};
+    {
+        monad::fiber::PriorityPool ppool(4, 16);
+        for (unsigned i = 0; i < 64; ++i) {
+            ppool.submit(i, [&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                {
+                    std::lock_guard const lock{mutex};
+                    ids.insert(std::this_thread::get_id());
+                }
+                done.fetch_add(1, std::memory_order_acq_rel);
+            });
+        }
+        while (done.load(std::memory_order_acquire) < 64) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_GT(ids.size(), 1);
+}
+
 TEST(PriorityPool, benchmark)
 {
     monad::fiber::PriorityPool ppool(
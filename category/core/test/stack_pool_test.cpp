@@ -0,0 +1,74 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <category/core/fiber/stack_pool.hpp>
+
+#include <boost/context/stack_context.hpp>
+
+#include <cstddef>
+#include <cstring>
+
+using monad::fiber::StackPool;
+
+TEST(StackPool, recycles_stacks)
+{
+    StackPool pool{2, 64 * 1024};
+
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    EXPECT_NE(a.sp, b.sp);
+    EXPECT_GE(a.size, 64 * 1024);
+    EXPECT_EQ(pool.stats().in_use, 2);
+
+    void *const sp = a.sp;
+    pool.deallocate(a);
+    EXPECT_EQ(pool.stats().in_use, 1);
+
+    auto c = pool.allocate();
+    EXPECT_EQ(c.sp, sp);
+
+    pool.deallocate(b);
+    pool.deallocate(c);
+    EXPECT_EQ(pool.stats().in_use, 0);
+}
+
+TEST(StackPool, commits_on_demand)
+{
+    StackPool pool{4, 1 << 20};
+    EXPECT_EQ(pool.stats().resident_bytes, 0);
+
+    auto sctx = pool.allocate();
+    // touch the top 16KB, as a shallow fiber would
+    auto *const top = static_cast<unsigned char *>(sctx.sp);
+    std::memset(top - 16 * 1024, 0xab, 16 * 1024);
+
+    auto const stats = pool.stats();
+    EXPECT_GE(stats.resident_bytes, 16 * 1024);
+    EXPECT_LT(stats.resident_bytes, stats.stack_size);
+    EXPECT_EQ(stats.max_stack_resident_bytes, stats.resident_bytes);
+
+    pool.deallocate(sctx);
+}
+
+TEST(StackPool, guard_page)
+{
+    StackPool pool{1, 64 * 1024};
+    auto sctx = pool.allocate();
+    auto *const bottom = static_cast<unsigned char *>(sctx.sp) - sctx.size;
+    EXPECT_DEATH({ *(bottom - 1) = 0; }, "");
+    pool.deallocate(sctx);
+}
@@ -0,0 +1,310 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+/**
+ * @file
+ *
+ * In-process latency histograms for hot paths. Each metric keeps one shard
+ * per recording thread, so recording is a handful of relaxed loads and
+ * stores with no read-modify-write and no sharing between threads. Readers
+ * sum the shards into a LatencySnapshot, which can be rendered in the
+ * Prometheus text exposition format.
+ *
+ * Buckets are log-linear in nanoseconds: values below 16 get exact buckets,
+ * every power of two above that is split into 16 equal sub-buckets, which
+ * bounds the relative error of a reported quantile by 1/16.
+ *
+ * This file is header-only so that libraries which do not link monad_core
+ * (e.g. the VM) can record into the same registry.
+ */
+
+#include <category/core/config.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace latency_detail
+{
+    inline constexpr unsigned SUB_BUCKET_BITS = 4;
+    inline constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+    inline constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    constexpr size_t bucket_index(uint64_t const ns) noexcept
+    {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<size_t>(ns);
+        }
+        unsigned const exp = static_cast<unsigned>(std::bit_width(ns)) - 1;
+        unsigned const shift = exp - SUB_BUCKET_BITS;
+        uint64_t const sub = (ns >> shift) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + sub);
+    }
+
+    // Largest value which maps to bucket `index`
+    constexpr uint64_t bucket_upper_bound(size_t const index) noexcept
+    {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        unsigned const shift =
+            static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+        uint64_t const sub = index % SUB_BUCKETS;
+        uint64_t const lower = (SUB_BUCKETS + sub) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+    static_assert(bucket_index(15) == 15);
+    static_assert(bucket_index(16) == 16);
+    static_assert(bucket_index(31) == 31);
+    static_assert(bucket_index(32) == 32);
+    static_assert(bucket_index(33) == 32);
+    static_assert(bucket_upper_bound(bucket_index(1'000'000)) >= 1'000'000);
+    static_assert(bucket_index(~uint64_t{0}) == BUCKETS - 1);
+    static_assert(bucket_upper_bound(BUCKETS - 1) == ~uint64_t{0});
+}
+
+/// Summed view of all shards of a metric at some point in time
+struct LatencySnapshot
+{
+    std::array<uint64_t, latency_detail::BUCKETS> buckets{};
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+    uint64_t max_ns{0};
+
+    /// Upper bound of the bucket holding the q-th quantile, q in [0, 1]
+    uint64_t quantile_ns(double const q) const noexcept
+    {
+        if (count == 0) {
+            return 0;
+        }
+        double const clamped = std::clamp(q, 0.0, 1.0);
+        uint64_t const rank = std::max(
+            uint64_t{1},
+            static_cast<uint64_t>(clamped * static_cast<double>(count) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(latency_detail::bucket_upper_bound(i), max_ns);
+            }
+        }
+        return max_ns;
+    }
+};
+
+/// One thread's counters for a metric; only the owning thread writes them
+class LatencyShard
+{
+    std::array<std::atomic<uint64_t>, latency_detail::BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+
+    static void bump(std::atomic<uint64_t> &v, uint64_t const n) noexcept
+    {
+        v.store(
+            v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+public:
+    void record(uint64_t const ns) noexcept
+    {
+        bump(buckets_[latency_detail::bucket_index(ns)], 1);
+        bump(count_, 1);
+        bump(sum_ns_, ns);
+        if (ns > max_ns_.load(std::memory_order_relaxed)) {
+            max_ns_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void add_to(LatencySnapshot &snapshot) const noexcept
+    {
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            snapshot.buckets[i] += buckets_[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += count_.load(std::memory_order_relaxed);
+        snapshot.sum_ns += sum_ns_.load(std::memory_order_relaxed);
+        snapshot.max_ns = std::max(
+            snapshot.max_ns, max_ns_.load(std::memory_order_relaxed));
+    }
+};
+
+class LatencyMetric
+{
+    std::string const name_;
+    std::string const help_;
+    size_t const id_;
+    mutable std::mutex mutex_;
+    // Shards outlive their threads so that totals never go backwards
+    std::vector<std::unique_ptr<LatencyShard>> shards_;
+
+    LatencyShard &new_shard()
+    {
+        std::lock_guard const lock{mutex_};
+        return *shards_.emplace_back(std::make_unique<LatencyShard>());
+    }
+
+    LatencyShard &shard()
+    {
+        static thread_local std::vector<LatencyShard *> cache;
+        if (cache.size() <= id_) [[unlikely]] {
+            cache.resize(id_ + 1, nullptr);
+        }
+        LatencyShard *&shard = cache[id_];
+        if (shard == nullptr) [[unlikely]] {
+            shard = &new_shard();
+        }
+        return *shard;
+    }
+
+public:
+    LatencyMetric(
+        std::string_view const name, std::string_view const help,
+        size_t const id)
+        : name_{name}
+        , help_{help}
+        , id_{id}
+    {
+    }
+
+    LatencyMetric(LatencyMetric const &) = delete;
+    LatencyMetric &operator=(LatencyMetric const &) = delete;
+
+    std::string const &name() const noexcept
+    {
+        return name_;
+    }
+
+    std::string const &help() const noexcept
+    {
+        return help_;
+    }
+
+    void record(std::chrono::nanoseconds const d)
+    {
+        shard().record(static_cast<uint64_t>(std::max(d.count(), int64_t{0})));
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> const d)
+    {
+        record(std::chrono::duration_cast<std::chrono::nanoseconds>(d));
+    }
+
+    LatencySnapshot snapshot() const
+    {
+        LatencySnapshot snapshot;
+        std::lock_guard const lock{mutex_};
+        for (auto const &shard : shards_) {
+            shard->add_to(snapshot);
+        }
+        return snapshot;
+    }
+};
+
+namespace latency_detail
+{
+    struct Registry
+    {
+        std::mutex mutex;
+        std::deque<LatencyMetric> metrics;
+    };
+
+    inline Registry &registry()
+    {
+        static Registry r;
+        return r;
+    }
+}
+
+/// Returns the metric called `name`, creating it on first use. Call sites
+/// are expected to cache the reference, e.g. in a function-local static.
+inline LatencyMetric &
+latency_metric(std::string_view const name, std::string_view const help)
+{
+    auto &r = latency_detail::registry();
+    std::lock_guard const lock{r.mutex};
+    for (auto &metric : r.metrics) {
+        if (metric.name() == name) {
+            return metric;
+        }
+    }
+    return r.metrics.emplace_back(name, help, r.metrics.size());
+}
+
+/// Writes every registered metric as a Prometheus summary, in seconds
+inline void write_latency_metrics(std::ostream &os)
+{
+    static constexpr std::array QUANTILES{0.5, 0.9, 0.99, 0.999};
+    auto const seconds = [](uint64_t const ns) {
+        return static_cast<double>(ns) * 1e-9;
+    };
+    auto &r = latency_detail::registry();
+    std::lock_guard const lock{r.mutex};
+    auto const precision = os.precision(9);
+    for (auto const &metric : r.metrics) {
+        auto const snapshot = metric.snapshot();
+        auto const &name = metric.name();
+        os << "# HELP " << name << ' ' << metric.help() << '\n';
+        os << "# TYPE " << name << " summary\n";
+        for (double const q : QUANTILES) {
+            os << name << "{quantile=\"" << q << "\"} "
+               << seconds(snapshot.quantile_ns(q)) << '\n';
+        }
+        os << name << "_sum " << seconds(snapshot.sum_ns) << '\n';
+        os << name << "_count " << snapshot.count << '\n';
+    }
+    os.precision(precision);
+}
+
+/// Records the lifetime of the object into a metric
+class ScopedLatency
+{
+    LatencyMetric &metric_;
+    std::chrono::steady_clock::time_point const begin_;
+
+public:
+    explicit ScopedLatency(LatencyMetric &metric)
+        : metric_{metric}
+        , begin_{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ScopedLatency(ScopedLatency const &) = delete;
+    ScopedLatency &operator=(ScopedLatency const &) = delete;
+
+    ~ScopedLatency()
+    {
+        metric_.record(std::chrono::steady_clock::now() - begin_);
+    }
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,80 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <quill/Quill.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+MONAD_NAMESPACE_BEGIN
+
+// Admits at most one message per interval from a single call site. It never
+// blocks, so execution threads racing on the same site only pay for a couple
+// of relaxed atomic operations when the message is dropped. An admitted
+// message is told how many were dropped since the previous one.
+class LogRateLimit final
+{
+    int64_t const interval_;
+    std::atomic<int64_t> next_{std::numeric_limits<int64_t>::min()};
+    std::atomic<uint64_t> suppressed_{0};
+
+public:
+    explicit constexpr LogRateLimit(std::chrono::nanoseconds const interval)
+        : interval_{interval.count()}
+    {
+    }
+
+    std::optional<uint64_t>
+    admit(std::chrono::steady_clock::time_point const now =
+              std::chrono::steady_clock::now()) noexcept
+    {
+        int64_t const t =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now.time_since_epoch())
+                .count();
+        int64_t next = next_.load(std::memory_order_relaxed);
+        if (t < next || !next_.compare_exchange_strong(
+                            next, t + interval_, std::memory_order_relaxed)) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        return suppressed_.exchange(0, std::memory_order_relaxed);
+    }
+};
+
+MONAD_NAMESPACE_END
+
+// Logs through one of the quill LOG_* macros at most once per interval from
+// this call site, appending the number of messages dropped in between. Use
+// it for messages that a burst of transactions can trigger, so that the
+// execution threads don't flood the logging queue.
+#define LOG_RATE_LIMITED(LOG_MACRO, interval, fmt, ...)                        \
+    do {                                                                       \
+        static ::monad::LogRateLimit monad_log_rate_limit_{interval};          \
+        if (auto const monad_log_suppressed_ =                                 \
+                monad_log_rate_limit_.admit()) {                               \
+            LOG_MACRO(                                                         \
+                fmt " ({} suppressed)" __VA_OPT__(, ) __VA_ARGS__,             \
+                *monad_log_suppressed_);                                       \
+        }                                                                      \
+    }                                                                          \
+    while (0)
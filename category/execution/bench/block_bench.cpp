@@ -0,0 +1,186 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/execution/bench/workload.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/execute_block.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/* Google Benchmark suite for whole blocks of a synthetic workload.
+
+BM_block executes and commits one block of a Workload per iteration,
+through execute_block and TrieDb::commit on an in-memory trie, with
+range(0) pool threads and range(1) percent of the transactions aimed at a
+hot spot. Each mix of transactions is a separate benchmark, so that the
+scaling of parallel execution with cores and contention can be read per
+mix, and the workload is deterministic, so that runs are comparable.
+
+Reports:
+  txs            transactions executed and committed per second
+  retries        transactions re-executed after a merge conflict, per block
+  commit_ms      milliseconds per block spent in the commit
+*/
+
+using namespace monad;
+
+namespace
+{
+    using traits = EvmTraits<EVMC_SHANGHAI>;
+
+    constexpr unsigned FIBERS_PER_THREAD = 16;
+
+    struct BlockFixture
+    {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        TrieDb tdb{db};
+        vm::VM vm;
+        BlockHashBufferFinalized block_hash_buffer;
+        Workload workload;
+
+        explicit BlockFixture(WorkloadConfig const &config)
+            : workload{config}
+        {
+            tdb.commit(
+                workload.genesis_state(),
+                workload.genesis_code(),
+                NULL_HASH_BLAKE3,
+                BlockHeader{});
+            tdb.finalize(0, NULL_HASH_BLAKE3);
+            tdb.set_block_and_prefix(0);
+        }
+    };
+
+    void BM_block(benchmark::State &state, WorkloadConfig config)
+    {
+        auto const n_threads = static_cast<unsigned>(state.range(0));
+        config.conflict_rate = static_cast<double>(state.range(1)) / 100.0;
+        BlockFixture f{config};
+        fiber::PriorityPool pool{n_threads, n_threads * FIBERS_PER_THREAD};
+
+        uint64_t txs = 0;
+        uint64_t retries = 0;
+        std::chrono::nanoseconds commit_time{0};
+        for (auto _ : state) {
+            state.PauseTiming();
+            auto [block, senders] = f.workload.next_block();
+            uint64_t const number = block.header.number;
+            size_t const n = block.transactions.size();
+            f.block_hash_buffer.set(number - 1, bytes32_t{number - 1});
+            std::vector<std::vector<std::optional<Address>>> const
+                authorities(n);
+            std::vector<std::unique_ptr<CallTracerBase>> call_tracers;
+            for (size_t i = 0; i < n; ++i) {
+                call_tracers.emplace_back(std::make_unique<NoopCallTracer>());
+            }
+            std::vector<std::vector<CallFrame>> const call_frames(n);
+            BlockState block_state{f.tdb, f.vm};
+            BlockMetrics metrics;
+            state.ResumeTiming();
+
+            auto const receipts = execute_block<traits>(
+                EthereumMainnet{},
+                block,
+                senders,
+                authorities,
+                block_state,
+                f.block_hash_buffer,
+                pool,
+                metrics,
+                call_tracers);
+            MONAD_ASSERT(!receipts.has_error());
+
+            auto const commit_begin = std::chrono::steady_clock::now();
+            bytes32_t const block_id{number};
+            block_state.commit(
+                block_id,
+                block.header,
+                receipts.value(),
+                call_frames,
+                senders,
+                block.transactions);
+            f.tdb.finalize(number, block_id);
+            f.tdb.set_block_and_prefix(number);
+            commit_time += std::chrono::steady_clock::now() - commit_begin;
+
+            txs += n;
+            retries += metrics.num_retries();
+        }
+        state.counters["txs"] = benchmark::Counter(
+            static_cast<double>(txs), benchmark::Counter::kIsRate);
+        state.counters["retries"] = benchmark::Counter(
+            static_cast<double>(retries), benchmark::Counter::kAvgIterations);
+        state.counters["commit_ms"] = benchmark::Counter(
+            std::chrono::duration<double, std::milli>(commit_time).count(),
+            benchmark::Counter::kAvgIterations);
+    }
+
+    void scaling(benchmark::internal::Benchmark *const b)
+    {
+        b->ArgsProduct({{1, 2, 4, 8, 16}, {0, 10, 50}})
+            ->ArgNames({"threads", "hot%"})
+            ->UseRealTime()
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_block, transfers, WorkloadConfig{.transfer_weight = 1})
+    ->Apply(scaling);
+
+BENCHMARK_CAPTURE(
+    BM_block, erc20, WorkloadConfig{.transfer_weight = 0, .erc20_weight = 1})
+    ->Apply(scaling);
+
+BENCHMARK_CAPTURE(
+    BM_block, amm, WorkloadConfig{.transfer_weight = 0, .amm_weight = 1})
+    ->Apply(scaling);
+
+BENCHMARK_CAPTURE(
+    BM_block, churn, WorkloadConfig{.transfer_weight = 0, .churn_weight = 1})
+    ->Apply(scaling);
+
+BENCHMARK_CAPTURE(
+    BM_block, mixed,
+    WorkloadConfig{
+        .transfer_weight = 4,
+        .erc20_weight = 3,
+        .amm_weight = 2,
+        .churn_weight = 1})
+    ->Apply(scaling);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,385 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/likely.h>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/contract/abi_encode.hpp>
+#include <category/execution/ethereum/core/contract/big_endian.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/precompiles.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/monad/monad_precompiles.hpp>
+#include <category/execution/monad/staking/util/constants.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/evm/monad/revision.h>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+#include <evmc/hex.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "test_resource_data.h"
+
+/* Google Benchmark suite for precompiles.
+
+Every precompile of precompiles.hpp and monad_precompiles.hpp gets one
+benchmark per input, named <precompile>/<input>. Inputs come from the geth
+precompile vectors where there are any, so the sizes they cover (multi-scalar
+multiplication and pairing point counts, modexp operand lengths, blake2f
+rounds) are what is swept. The hash and identity precompiles are swept over
+synthetic inputs of 0 bytes to 64 KiB.
+
+Besides timings, every benchmark reports:
+  gas            gas charged for one call, priced as of the latest monad
+                 revision
+  time_per_gas   time spent per unit of gas charged, in seconds with an SI
+                 prefix (e.g. 12.5n is 12.5 ns per gas)
+
+Ethereum precompiles are timed by calling their execute functions directly, so
+the memoized results of check_call_precompile() are never what is measured.
+The staking precompile has no such cache and is called through
+check_call_precompile() on an otherwise empty state; only its getters are
+covered, since its other methods need a populated validator set.
+*/
+
+using namespace monad;
+
+namespace
+{
+    using traits = MonadTraits<MONAD_FIVE>;
+
+    struct Input
+    {
+        std::string name;
+        byte_string data;
+    };
+
+    void set_gas_counters(benchmark::State &state, uint64_t const gas)
+    {
+        auto const gas_per_op = static_cast<double>(gas);
+        state.counters["gas"] = gas_per_op;
+        state.counters["time_per_gas"] = benchmark::Counter(
+            gas_per_op * static_cast<double>(state.iterations()),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+    void bench_precompile(
+        benchmark::State &state, precompiled_gas_cost_fn *const gas_cost,
+        precompiled_execute_fn *const execute, byte_string_view const input)
+    {
+        for (auto _ : state) {
+            PrecompileResult const result = execute(input);
+            benchmark::DoNotOptimize(result.obuf);
+            std::free(result.obuf);
+            if (MONAD_UNLIKELY(result.status_code != EVMC_SUCCESS)) {
+                state.SkipWithError("precompile failed");
+                break;
+            }
+        }
+        set_gas_counters(state, gas_cost(input));
+    }
+
+    void register_precompile(
+        std::string_view const name, precompiled_gas_cost_fn *const gas_cost,
+        precompiled_execute_fn *const execute,
+        std::vector<Input> const &inputs)
+    {
+        for (auto const &input : inputs) {
+            std::string const bench_name =
+                std::string{name} + "/" + input.name;
+            benchmark::RegisterBenchmark(
+                bench_name.c_str(),
+                [=, data = input.data](benchmark::State &state) {
+                    bench_precompile(state, gas_cost, execute, data);
+                });
+        }
+    }
+
+    std::vector<Input> geth_inputs(std::initializer_list<char const *> files)
+    {
+        std::vector<Input> inputs;
+        for (auto const *const file : files) {
+            std::ifstream in(test_resource::geth_vectors_dir / file);
+            MONAD_ASSERT(in.is_open());
+            for (auto const &j : nlohmann::json::parse(in)) {
+                auto const hex = j.at("Input").get<std::string>();
+                inputs.push_back(
+                    {j.at("Name").get<std::string>(),
+                     evmc::from_hex(std::string_view{hex}).value()});
+            }
+        }
+        return inputs;
+    }
+
+    std::vector<Input> sized_inputs()
+    {
+        std::vector<Input> inputs;
+        for (size_t const size : {0ul, 32ul, 1ul << 10, 1ul << 16}) {
+            byte_string data(size, uint8_t{0});
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = static_cast<uint8_t>(i * 31);
+            }
+            inputs.push_back({std::to_string(size), std::move(data)});
+        }
+        return inputs;
+    }
+
+    std::vector<Input> ecrecover_inputs()
+    {
+        return {
+            {"valid_key",
+             evmc::from_hex(
+                 std::string_view{
+                     "18c547e4f7b0f325ad1e56f57e26c745b09a3e503d86e00e5255ff7f"
+                     "715d3d1c000000000000000000000000000000000000000000000000"
+                     "000000000000001c73b1693892219d736caba55bdb67216e485557ea"
+                     "6b6af75f37096c9aa6a5a75feeb940b1d03b21e36b0e47e79769f095"
+                     "fe2ab855bd91e3a38756b7d75a9c4549"})
+                 .value()}};
+    }
+
+    // The opening at z = 1 of the zero polynomial, whose commitment and
+    // proof are both the point at infinity
+    std::vector<Input> point_evaluation_inputs()
+    {
+        byte_string infinity(48, uint8_t{0});
+        infinity[0] = 0xc0;
+
+        PrecompileResult const hash = sha256_execute(infinity);
+        MONAD_ASSERT(hash.status_code == EVMC_SUCCESS);
+        byte_string input{hash.obuf, hash.output_size};
+        std::free(hash.obuf);
+        input[0] = 0x01; // VERSIONED_HASH_VERSION_KZG
+
+        bytes32_t z{};
+        z.bytes[31] = 1;
+        input.append(z.bytes, sizeof(z.bytes));
+        input.append(sizeof(bytes32_t), uint8_t{0}); // y
+        input += infinity; // commitment
+        input += infinity; // proof
+        return {{"zero_polynomial", std::move(input)}};
+    }
+
+    struct StakingState
+    {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        TrieDb tdb{db};
+        vm::VM vm;
+        BlockState bs{tdb, vm};
+        State state{bs, Incarnation{0, 0}};
+
+        StakingState()
+        {
+            commit_sequential(
+                tdb,
+                StateDeltas{
+                    {staking::STAKING_CA,
+                     StateDelta{
+                         .account =
+                             {std::nullopt,
+                              Account{.balance = 0, .nonce = 1}}}}},
+                Code{},
+                BlockHeader{});
+            state.add_to_balance(staking::STAKING_CA, 0);
+        }
+    };
+
+    byte_string
+    staking_call(uint32_t const selector, std::initializer_list<bytes32_t> args)
+    {
+        u32_be const selector_be{selector};
+        byte_string input{selector_be.bytes, sizeof(selector_be.bytes)};
+        for (auto const &arg : args) {
+            input.append(arg.bytes, sizeof(arg.bytes));
+        }
+        return input;
+    }
+
+    void bench_staking(benchmark::State &state, byte_string_view const input)
+    {
+        static StakingState staking_state;
+
+        evmc_message const msg{
+            .gas = 1'000'000,
+            .input_data = input.data(),
+            .input_size = input.size(),
+            .code_address = staking::STAKING_CA};
+        int64_t gas_left = msg.gas;
+        for (auto _ : state) {
+            auto const result =
+                check_call_precompile<traits>(staking_state.state, msg);
+            MONAD_ASSERT(result.has_value());
+            if (MONAD_UNLIKELY(result->status_code != EVMC_SUCCESS)) {
+                state.SkipWithError("precompile failed");
+                break;
+            }
+            gas_left = result->gas_left;
+        }
+        set_gas_counters(state, static_cast<uint64_t>(msg.gas - gas_left));
+    }
+
+    void register_staking()
+    {
+        bytes32_t const val_id = abi_encode_uint(u64_be{1});
+        bytes32_t const start_index = abi_encode_uint(u32_be{0});
+        bytes32_t const delegator = abi_encode_address(Address{});
+        std::pair<char const *, byte_string> const calls[] = {
+            {"getEpoch", staking_call(0x757991a8, {})},
+            {"getValidator", staking_call(0x2b6d639a, {val_id})},
+            {"getDelegator", staking_call(0x573c1ce0, {val_id, delegator})},
+            {"getConsensusValidatorSet",
+             staking_call(0xfb29b729, {start_index})},
+            {"getSnapshotValidatorSet",
+             staking_call(0xde66a368, {start_index})},
+            {"getExecutionValidatorSet",
+             staking_call(0x7cb074df, {start_index})},
+        };
+        for (auto const &[name, input] : calls) {
+            std::string const bench_name = std::string{"staking/"} + name;
+            benchmark::RegisterBenchmark(
+                bench_name.c_str(),
+                [data = input](benchmark::State &state) {
+                    bench_staking(state, data);
+                });
+        }
+    }
+
+    void register_all()
+    {
+        register_precompile(
+            "ecrecover",
+            ecrecover_gas_cost<traits>,
+            ecrecover_execute,
+            ecrecover_inputs());
+        register_precompile(
+            "sha256", sha256_gas_cost<traits>, sha256_execute, sized_inputs());
+        register_precompile(
+            "ripemd160",
+            ripemd160_gas_cost<traits>,
+            ripemd160_execute,
+            sized_inputs());
+        register_precompile(
+            "identity", identity_gas_cost, identity_execute, sized_inputs());
+        register_precompile(
+            "expmod",
+            expmod_gas_cost<traits>,
+            expmod_execute,
+            geth_inputs({"modexp_eip2565.json"}));
+        register_precompile(
+            "ecadd",
+            ecadd_gas_cost<traits>,
+            ecadd_execute,
+            geth_inputs({"bn256Add.json"}));
+        register_precompile(
+            "ecmul",
+            ecmul_gas_cost<traits>,
+            ecmul_execute,
+            geth_inputs({"bn256ScalarMul.json"}));
+        register_precompile(
+            "snarkv",
+            snarkv_gas_cost<traits>,
+            snarkv_execute,
+            geth_inputs({"bn256Pairing.json"}));
+        register_precompile(
+            "blake2bf",
+            blake2bf_gas_cost<traits>,
+            blake2bf_execute,
+            geth_inputs({"blake2F.json"}));
+        register_precompile(
+            "point_evaluation",
+            point_evaluation_gas_cost<traits>,
+            point_evaluation_execute,
+            point_evaluation_inputs());
+        register_precompile(
+            "bls12_g1_add",
+            bls12_g1_add_gas_cost,
+            bls12_g1_add_execute,
+            geth_inputs({"blsG1Add.json"}));
+        register_precompile(
+            "bls12_g1_msm",
+            bls12_g1_msm_gas_cost,
+            bls12_g1_msm_execute,
+            geth_inputs({"blsG1Mul.json", "blsG1MultiExp.json"}));
+        register_precompile(
+            "bls12_g2_add",
+            bls12_g2_add_gas_cost,
+            bls12_g2_add_execute,
+            geth_inputs({"blsG2Add.json"}));
+        register_precompile(
+            "bls12_g2_msm",
+            bls12_g2_msm_gas_cost,
+            bls12_g2_msm_execute,
+            geth_inputs({"blsG2Mul.json", "blsG2MultiExp.json"}));
+        register_precompile(
+            "bls12_pairing_check",
+            bls12_pairing_check_gas_cost,
+            bls12_pairing_check_execute,
+            geth_inputs({"blsPairing.json"}));
+        register_precompile(
+            "bls12_map_fp_to_g1",
+            bls12_map_fp_to_g1_gas_cost,
+            bls12_map_fp_to_g1_execute,
+            geth_inputs({"blsMapG1.json"}));
+        register_precompile(
+            "bls12_map_fp2_to_g2",
+            bls12_map_fp2_to_g2_gas_cost,
+            bls12_map_fp2_to_g2_execute,
+            geth_inputs({"blsMapG2.json"}));
+        register_precompile(
+            "p256_verify",
+            p256_verify_gas_cost,
+            p256_verify_execute,
+            geth_inputs({"p256Verify.json"}));
+        register_staking();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    MONAD_ASSERT(init_trusted_setup());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    register_all();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/vm.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* Google Benchmark suite for the call frames of State.
+
+BM_nested_calls runs a chain of CALL_DEPTH nested frames, each writing one
+slot of its own account, in a transaction which has already touched
+range(0) other accounts. Half the frames are accepted and half rejected.
+The time per iteration should not depend on range(0): a pop visits only
+the accounts its frame touched.
+
+BM_deep_frame_writes writes range(0) slots of one account and then makes
+CALL_DEPTH nested calls, each writing one more slot of the same account.
+The time per iteration should not depend on range(0): a nested frame holds
+only its own writes.
+
+Reports:
+  frames         call frames entered per second
+*/
+
+using namespace monad;
+
+namespace
+{
+    constexpr size_t CALL_DEPTH = 16;
+
+    Address address_of(uint64_t const i)
+    {
+        Address address{};
+        for (size_t j = 0; j < sizeof(i); ++j) {
+            address.bytes[sizeof(Address) - 1 - j] =
+                static_cast<uint8_t>(i >> (8 * j));
+        }
+        address.bytes[0] = 0xca;
+        return address;
+    }
+
+    bytes32_t slot_of(uint64_t const i)
+    {
+        return bytes32_t{i + 1};
+    }
+
+    struct StateFixture
+    {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        TrieDb tdb{db};
+        vm::VM vm;
+        BlockState bs{tdb, vm};
+        State state{bs, Incarnation{1, 1}};
+    };
+
+    void run_nested_calls(State &state, uint64_t const first_account)
+    {
+        for (size_t depth = 0; depth < CALL_DEPTH; ++depth) {
+            state.push();
+            Address const callee = address_of(first_account + depth);
+            state.add_to_balance(callee, 1);
+            state.set_storage(callee, slot_of(depth), bytes32_t{depth + 1});
+        }
+        for (size_t depth = CALL_DEPTH; depth-- > 0;) {
+            if (depth % 2) {
+                state.pop_reject();
+            }
+            else {
+                state.pop_accept();
+            }
+        }
+    }
+
+    void set_frames_counter(benchmark::State &state)
+    {
+        state.counters["frames"] = benchmark::Counter(
+            static_cast<double>(state.iterations()) *
+                static_cast<double>(CALL_DEPTH),
+            benchmark::Counter::kIsRate);
+    }
+}
+
+static void BM_nested_calls(benchmark::State &state)
+{
+    auto const touched = static_cast<uint64_t>(state.range(0));
+    StateFixture f;
+    for (uint64_t i = 0; i < touched; ++i) {
+        f.state.add_to_balance(address_of(CALL_DEPTH + i), 1);
+    }
+    for (auto _ : state) {
+        run_nested_calls(f.state, 0);
+    }
+    set_frames_counter(state);
+}
+
+BENCHMARK(BM_nested_calls)->RangeMultiplier(8)->Range(8, 8 << 9);
+
+static void BM_deep_frame_writes(benchmark::State &state)
+{
+    auto const slots = static_cast<uint64_t>(state.range(0));
+    StateFixture f;
+    Address const account = address_of(0);
+    f.state.add_to_balance(account, 1);
+    for (uint64_t i = 0; i < slots; ++i) {
+        f.state.set_storage(account, slot_of(CALL_DEPTH + i), bytes32_t{1});
+    }
+    for (auto _ : state) {
+        for (size_t depth = 0; depth < CALL_DEPTH; ++depth) {
+            f.state.push();
+            f.state.set_storage(account, slot_of(depth), bytes32_t{depth + 1});
+        }
+        for (size_t depth = 0; depth < CALL_DEPTH; ++depth) {
+            f.state.pop_reject();
+        }
+    }
+    set_frames_counter(state);
+}
+
+BENCHMARK(BM_deep_frame_writes)->RangeMultiplier(8)->Range(8, 8 << 9);
+
+BENCHMARK_MAIN();
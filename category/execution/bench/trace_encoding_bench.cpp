@@ -0,0 +1,157 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state3/account_state.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/trace/prestate_tracer.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/vm.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "test_resource_data.h"
+
+/* Google Benchmark suite for the encodings of the prestate and state diff
+traces.
+
+Every benchmark encodes the trace of a transaction that touched
+state.range(0) accounts, with NUM_SLOTS storage slots each, to CBOR. The
+*_json benchmarks build the nlohmann::json of the trace and encode that, the
+*_cbor ones write the CBOR directly. Both produce the same bytes.
+
+Reports:
+  bytes          size of one encoded trace
+*/
+
+using namespace monad;
+using namespace monad::trace;
+
+namespace
+{
+    constexpr unsigned NUM_SLOTS = 64;
+
+    struct TraceFixture
+    {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        TrieDb tdb{db};
+        vm::VM vm;
+        Map<Address, OriginalAccountState> prestate;
+        StateDeltas state_deltas;
+
+        explicit TraceFixture(unsigned const num_accounts)
+        {
+            for (unsigned i = 0; i < num_accounts; ++i) {
+                Address address{};
+                std::memcpy(address.bytes, &i, sizeof(i));
+                Account const a{.balance = 1000 + i, .nonce = i};
+                Account b = a;
+                b.balance += 1;
+                OriginalAccountState as{a};
+                StorageDeltas storage{};
+                for (unsigned j = 0; j < NUM_SLOTS; ++j) {
+                    bytes32_t key{};
+                    bytes32_t value{};
+                    std::memcpy(key.bytes, &j, sizeof(j));
+                    std::memcpy(value.bytes + 16, &i, sizeof(i));
+                    as.storage_.emplace(key, value);
+                    storage.emplace(key, StorageDelta{value, bytes32_t{}});
+                }
+                prestate.emplace(address, std::move(as));
+                state_deltas.emplace(
+                    address,
+                    StateDelta{
+                        .account = {a, b}, .storage = std::move(storage)});
+            }
+            commit_sequential(tdb, {}, Code{}, BlockHeader{.number = 0});
+        }
+    };
+
+    template <typename Encode>
+    void run(benchmark::State &state, Encode &&encode)
+    {
+        TraceFixture f{static_cast<unsigned>(state.range(0))};
+        BlockState bs{f.tdb, f.vm};
+        State s{bs, Incarnation{0, 0}};
+        size_t bytes = 0;
+        for (auto _ : state) {
+            auto const out = encode(f, s);
+            bytes = out.size();
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.counters["bytes"] = static_cast<double>(bytes);
+    }
+
+    byte_string to_cbor(nlohmann::json const &json)
+    {
+        auto const cbor = nlohmann::json::to_cbor(json);
+        return byte_string{cbor.begin(), cbor.end()};
+    }
+}
+
+static void BM_prestate_json(benchmark::State &state)
+{
+    run(state, [](TraceFixture &f, State &s) {
+        return to_cbor(state_to_json(f.prestate, s));
+    });
+}
+
+BENCHMARK(BM_prestate_json)->RangeMultiplier(8)->Range(8, 512);
+
+static void BM_prestate_cbor(benchmark::State &state)
+{
+    run(state, [](TraceFixture &f, State &s) {
+        return state_to_cbor(f.prestate, s);
+    });
+}
+
+BENCHMARK(BM_prestate_cbor)->RangeMultiplier(8)->Range(8, 512);
+
+static void BM_statediff_json(benchmark::State &state)
+{
+    run(state, [](TraceFixture &f, State &s) {
+        return to_cbor(state_deltas_to_json(f.state_deltas, s));
+    });
+}
+
+BENCHMARK(BM_statediff_json)->RangeMultiplier(8)->Range(8, 512);
+
+static void BM_statediff_cbor(benchmark::State &state)
+{
+    run(state, [](TraceFixture &f, State &s) {
+        return state_deltas_to_cbor(f.state_deltas, s);
+    });
+}
+
+BENCHMARK(BM_statediff_cbor)->RangeMultiplier(8)->Range(8, 512);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,434 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/int.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/bench/workload.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/utils/evm-as.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+using namespace monad::vm::utils;
+
+constexpr uint64_t TOKEN_BALANCE = uint64_t{1} << 62;
+constexpr uint64_t POOL_RESERVE = uint64_t{1} << 40;
+constexpr uint64_t MAX_AMOUNT = 1'000;
+
+Address address_of(uint8_t const prefix, uint64_t const i)
+{
+    Address address{};
+    for (size_t j = 0; j < sizeof(i); ++j) {
+        address.bytes[sizeof(Address) - 1 - j] =
+            static_cast<uint8_t>(i >> (8 * j));
+    }
+    address.bytes[0] = prefix;
+    return address;
+}
+
+bytes32_t word_of(Address const &address)
+{
+    bytes32_t word{};
+    std::memcpy(
+        word.bytes + sizeof(bytes32_t) - sizeof(Address),
+        address.bytes,
+        sizeof(Address));
+    return word;
+}
+
+byte_string calldata(std::initializer_list<bytes32_t> const words)
+{
+    byte_string data;
+    for (auto const &word : words) {
+        data.append(word.bytes, sizeof(word.bytes));
+    }
+    return data;
+}
+
+// slot of `balances[holder]` for a mapping at slot 0, as solidity lays out
+bytes32_t balance_slot(Address const &holder)
+{
+    byte_string const preimage = calldata({word_of(holder), bytes32_t{}});
+    return to_bytes(keccak256(preimage));
+}
+
+// transfer(to, amount): balances[caller] -= amount; balances[to] += amount
+std::vector<uint8_t> token_code()
+{
+    auto eb = evm_as::shanghai();
+    eb.push(0x20)
+        .calldataload()
+        .caller()
+        .push0()
+        .mstore()
+        .push(0x40)
+        .push0()
+        .sha3()
+        .dup1()
+        .sload()
+        .dup3()
+        .swap1()
+        .sub()
+        .swap1()
+        .sstore()
+        .push0()
+        .calldataload()
+        .push0()
+        .mstore()
+        .push(0x40)
+        .push0()
+        .sha3()
+        .dup1()
+        .sload()
+        .dup3()
+        .add()
+        .swap1()
+        .sstore()
+        .pop()
+        .stop();
+    MONAD_ASSERT(evm_as::validate(eb));
+    std::vector<uint8_t> code;
+    evm_as::compile(eb, code);
+    return code;
+}
+
+// swap(in): x += in; y -= y * in / x, with the reserves x and y in slots 0
+// and 1
+std::vector<uint8_t> pool_code()
+{
+    auto eb = evm_as::shanghai();
+    eb.push0()
+        .calldataload()
+        .push0()
+        .sload()
+        .dup2()
+        .add()
+        .dup1()
+        .push0()
+        .sstore()
+        .push(1)
+        .sload()
+        .dup1()
+        .dup4()
+        .mul()
+        .dup3()
+        .swap1()
+        .div()
+        .swap1()
+        .sub()
+        .push(1)
+        .sstore()
+        .pop()
+        .pop()
+        .stop();
+    MONAD_ASSERT(evm_as::validate(eb));
+    std::vector<uint8_t> code;
+    evm_as::compile(eb, code);
+    return code;
+}
+
+// churn(base, count): writes the block number to `count` slots from `base`
+std::vector<uint8_t> churn_code()
+{
+    auto eb = evm_as::shanghai();
+    eb.push0()
+        .calldataload()
+        .push(0x20)
+        .calldataload()
+        .jumpdest("loop")
+        .dup1()
+        .iszero()
+        .jumpi("done")
+        .dup1()
+        .dup3()
+        .add()
+        .number()
+        .swap1()
+        .sstore()
+        .push(1)
+        .swap1()
+        .sub()
+        .jump("loop")
+        .jumpdest("done")
+        .stop();
+    MONAD_ASSERT(evm_as::validate(eb));
+    std::vector<uint8_t> code;
+    evm_as::compile(eb, code);
+    return code;
+}
+
+struct Contract
+{
+    std::vector<uint8_t> code;
+    bytes32_t code_hash;
+};
+
+Contract make_contract(std::vector<uint8_t> code)
+{
+    bytes32_t const code_hash =
+        to_bytes(keccak256(byte_string_view{code.data(), code.size()}));
+    return Contract{.code = std::move(code), .code_hash = code_hash};
+}
+
+Contract const &token_contract()
+{
+    static Contract const contract = make_contract(token_code());
+    return contract;
+}
+
+Contract const &pool_contract()
+{
+    static Contract const contract = make_contract(pool_code());
+    return contract;
+}
+
+Contract const &churn_contract()
+{
+    static Contract const contract = make_contract(churn_code());
+    return contract;
+}
+
+Transaction call(Address const &to, uint64_t const gas_limit, byte_string data)
+{
+    return Transaction{
+        .sc = {.chain_id = Workload::CHAIN_ID},
+        .max_fee_per_gas = 1,
+        .gas_limit = gas_limit,
+        .to = to,
+        .type = TransactionType::eip1559,
+        .data = std::move(data)};
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+Workload::Workload(WorkloadConfig const &config)
+    : config_{config}
+    , rng_{config.seed}
+    , nonces_(config.num_accounts, 0)
+{
+    MONAD_ASSERT(config_.num_accounts > 0);
+    MONAD_ASSERT(config_.hot_accounts > 0);
+    MONAD_ASSERT(config_.num_pools > 0);
+    MONAD_ASSERT(config_.churn_range >= config_.churn_slots);
+    MONAD_ASSERT(
+        config_.transfer_weight + config_.erc20_weight + config_.amm_weight +
+            config_.churn_weight >
+        0);
+}
+
+Address Workload::account(size_t const i)
+{
+    return address_of(0xee, i);
+}
+
+Address Workload::token()
+{
+    return address_of(0xc0, 0);
+}
+
+Address Workload::pool(size_t const i)
+{
+    return address_of(0xa0, i);
+}
+
+Address Workload::churner()
+{
+    return address_of(0xd0, 0);
+}
+
+StateDeltas Workload::genesis_state() const
+{
+    StateDeltas deltas;
+    uint256_t const balance = uint256_t{1} << 100;
+    StorageDeltas balances;
+    for (size_t i = 0; i < config_.num_accounts; ++i) {
+        deltas.emplace(
+            account(i),
+            StateDelta{
+                .account = {std::nullopt, Account{.balance = balance}},
+                .storage = {}});
+        balances.emplace(
+            balance_slot(account(i)),
+            StorageDelta{bytes32_t{}, bytes32_t{TOKEN_BALANCE}});
+    }
+    deltas.emplace(
+        token(),
+        StateDelta{
+            .account =
+                {std::nullopt,
+                 Account{
+                     .code_hash = token_contract().code_hash, .nonce = 1}},
+            .storage = std::move(balances)});
+    for (size_t i = 0; i < config_.num_pools; ++i) {
+        StorageDeltas reserves;
+        reserves.emplace(
+            bytes32_t{0}, StorageDelta{bytes32_t{}, bytes32_t{POOL_RESERVE}});
+        reserves.emplace(
+            bytes32_t{1}, StorageDelta{bytes32_t{}, bytes32_t{POOL_RESERVE}});
+        deltas.emplace(
+            pool(i),
+            StateDelta{
+                .account =
+                    {std::nullopt,
+                     Account{
+                         .code_hash = pool_contract().code_hash, .nonce = 1}},
+                .storage = std::move(reserves)});
+    }
+    deltas.emplace(
+        churner(),
+        StateDelta{
+            .account =
+                {std::nullopt,
+                 Account{.code_hash = churn_contract().code_hash, .nonce = 1}},
+            .storage = {}});
+    return deltas;
+}
+
+Code Workload::genesis_code() const
+{
+    Code code;
+    for (auto const *const contract :
+         {&token_contract(), &pool_contract(), &churn_contract()}) {
+        code.emplace(
+            contract->code_hash, vm::make_shared_intercode(contract->code));
+    }
+    return code;
+}
+
+size_t Workload::pick_account(bool const hot)
+{
+    size_t const n =
+        hot ? std::min(config_.hot_accounts, config_.num_accounts)
+            : config_.num_accounts;
+    return std::uniform_int_distribution<size_t>{0, n - 1}(rng_);
+}
+
+Transaction Workload::transfer(bool const hot)
+{
+    return Transaction{
+        .sc = {.chain_id = CHAIN_ID},
+        .max_fee_per_gas = 1,
+        .gas_limit = 21'000,
+        .value = 1,
+        .to = account(pick_account(hot)),
+        .type = TransactionType::eip1559};
+}
+
+Transaction Workload::erc20(size_t const sender, bool const hot)
+{
+    size_t to = pick_account(hot);
+    if (to == sender) {
+        to = (to + 1) % config_.num_accounts;
+    }
+    uint64_t const amount =
+        std::uniform_int_distribution<uint64_t>{1, MAX_AMOUNT}(rng_);
+    return call(
+        token(),
+        100'000,
+        calldata({word_of(account(to)), bytes32_t{amount}}));
+}
+
+Transaction Workload::amm(bool const hot)
+{
+    size_t const i =
+        hot ? 0
+            : std::uniform_int_distribution<size_t>{
+                  0, config_.num_pools - 1}(rng_);
+    uint64_t const amount =
+        std::uniform_int_distribution<uint64_t>{1, MAX_AMOUNT}(rng_);
+    return call(pool(i), 100'000, calldata({bytes32_t{amount}}));
+}
+
+Transaction Workload::churn(bool const hot)
+{
+    uint64_t const base =
+        hot ? 0
+            : std::uniform_int_distribution<uint64_t>{
+                  0, config_.churn_range - config_.churn_slots}(rng_);
+    uint64_t const count = config_.churn_slots;
+    return call(
+        churner(),
+        30'000 + 25'000 * count,
+        calldata({bytes32_t{base}, bytes32_t{count}}));
+}
+
+WorkloadBlock Workload::next_block()
+{
+    ++block_number_;
+    WorkloadBlock out{
+        .block =
+            {.header =
+                 {.number = block_number_,
+                  .gas_limit = uint64_t{1} << 40,
+                  .timestamp = block_number_ * 12,
+                  .beneficiary = address_of(0xbe, 0),
+                  .base_fee_per_gas = 1}},
+        .senders = {}};
+    out.block.transactions.reserve(config_.txs_per_block);
+    out.senders.reserve(config_.txs_per_block);
+
+    std::array<double, 4> const weights{
+        static_cast<double>(config_.transfer_weight),
+        static_cast<double>(config_.erc20_weight),
+        static_cast<double>(config_.amm_weight),
+        static_cast<double>(config_.churn_weight)};
+    std::discrete_distribution<unsigned> kind{weights.begin(), weights.end()};
+    std::bernoulli_distribution hot{config_.conflict_rate};
+    for (size_t i = 0; i < config_.txs_per_block; ++i) {
+        size_t const sender = next_sender_;
+        next_sender_ = (next_sender_ + 1) % config_.num_accounts;
+        bool const is_hot = hot(rng_);
+        Transaction tx = [&] {
+            switch (kind(rng_)) {
+            case 0:
+                return transfer(is_hot);
+            case 1:
+                return erc20(sender, is_hot);
+            case 2:
+                return amm(is_hot);
+            default:
+                return churn(is_hot);
+            }
+        }();
+        tx.nonce = nonces_[sender]++;
+        out.block.transactions.push_back(std::move(tx));
+        out.senders.push_back(account(sender));
+    }
+    return out;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,104 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+// The shape of a synthetic workload. The weights give the relative share of
+// each kind of transaction in a block:
+//   transfer  a value transfer between two accounts
+//   erc20     a token transfer, which updates the balance slots of its
+//             sender and recipient in one token contract
+//   amm       a swap against one of `num_pools` constant product pools, which
+//             updates both reserves of the pool
+//   churn     a write of `churn_slots` consecutive slots of one contract
+// A `conflict_rate` share of the transactions aims at a hot spot instead of
+// a uniformly drawn target: one of the first `hot_accounts` accounts, the
+// first pool or the first slots of the churn contract.
+struct WorkloadConfig
+{
+    uint64_t seed{0};
+    size_t num_accounts{10'000};
+    size_t txs_per_block{1'000};
+    unsigned transfer_weight{1};
+    unsigned erc20_weight{0};
+    unsigned amm_weight{0};
+    unsigned churn_weight{0};
+    double conflict_rate{0.0};
+    size_t hot_accounts{1};
+    size_t num_pools{16};
+    size_t churn_slots{16};
+    // the churn contract writes slots drawn from this many
+    size_t churn_range{1 << 20};
+};
+
+// A block of the workload with the senders of its transactions, which are
+// not signed
+struct WorkloadBlock
+{
+    Block block;
+    std::vector<Address> senders;
+};
+
+// Generates the blocks of a workload deterministically from its seed, for
+// the chain with id 1 starting from `genesis`. Every account sends at most
+// one transaction per block while `txs_per_block` does not exceed
+// `num_accounts`, so the conflicts between transactions are only those of
+// the configured mix.
+class Workload
+{
+    WorkloadConfig config_;
+    std::mt19937_64 rng_;
+    std::vector<uint64_t> nonces_;
+    size_t next_sender_{0};
+    uint64_t block_number_{0};
+
+    size_t pick_account(bool hot);
+    Transaction transfer(bool hot);
+    Transaction erc20(size_t sender, bool hot);
+    Transaction amm(bool hot);
+    Transaction churn(bool hot);
+
+public:
+    static constexpr uint64_t CHAIN_ID = 1;
+
+    explicit Workload(WorkloadConfig const &);
+
+    static Address account(size_t);
+    static Address token();
+    static Address pool(size_t);
+    static Address churner();
+
+    // The funded accounts and the deployed contracts, to be committed as
+    // block 0
+    StateDeltas genesis_state() const;
+    Code genesis_code() const;
+
+    WorkloadBlock next_block();
+};
+
+MONAD_NAMESPACE_END
@@ -42,15 +42,13 @@ BlockHashBufferFinalized::BlockHashBufferFinalized()
     }
 }
 
-uint64_t BlockHashBufferFinalized::n() const
+BlockHashBufferFinalized::BlockHashBufferFinalized(BlockHashBuffer const &buf)
+    : BlockHashBufferFinalized{}
 {
-    return n_;
-};
-
-bytes32_t const &BlockHashBufferFinalized::get(uint64_t const n) const
-{
-    MONAD_ASSERT(n < n_ && n + N >= n_);
-    return b_[n % N];
+    n_ = buf.n();
+    for (uint64_t n = n_ < N ? 0 : n_ - N; n < n_; ++n) {
+        b_[n % N] = buf.get(n);
+    }
 }
 
 void BlockHashBufferFinalized::set(uint64_t const n, bytes32_t const &h)
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <category/core/assert.h>
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 
@@ -41,16 +42,29 @@ public:
     virtual ~BlockHashBuffer() = default;
 };
 
-class BlockHashBufferFinalized : public BlockHashBuffer
+// A flat ring of the last N hashes. Besides holding the finalized chain, it is
+// used to flatten any buffer once per block, so that BLOCKHASH is an inlined
+// load through a final class rather than a virtual call that may walk a
+// proposal's deltas down to the finalized buffer
+class BlockHashBufferFinalized final : public BlockHashBuffer
 {
     bytes32_t b_[N];
     uint64_t n_;
 
 public:
     BlockHashBufferFinalized();
+    explicit BlockHashBufferFinalized(BlockHashBuffer const &);
 
-    uint64_t n() const override;
-    bytes32_t const &get(uint64_t) const override;
+    uint64_t n() const override
+    {
+        return n_;
+    }
+
+    bytes32_t const &get(uint64_t const n) const override
+    {
+        MONAD_ASSERT(n < n_ && n + N >= n_);
+        return b_[n % N];
+    }
 
     void set(uint64_t, bytes32_t const &);
 };
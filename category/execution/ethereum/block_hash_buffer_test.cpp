@@ -144,6 +144,31 @@ TEST(BlockHashBuffer, fork)
     EXPECT_EQ(buf.get(3), bytes32_t{5});
 }
 
+TEST(BlockHashBuffer, flatten_proposal)
+{
+    constexpr uint64_t N = BlockHashBuffer::N;
+
+    BlockHashBufferFinalized buf;
+    for (uint64_t i = 0; i < N + 10; ++i) {
+        buf.set(i, bytes32_t{i});
+    }
+
+    BlockHashChain chain(buf);
+    chain.propose(
+        bytes32_t{1000}, N + 10, dummy_block_id(1), dummy_block_id(0));
+    chain.propose(
+        bytes32_t{1001}, N + 11, dummy_block_id(2), dummy_block_id(1));
+
+    auto const &proposal = chain.find_chain(dummy_block_id(2));
+    BlockHashBufferFinalized const flat{proposal};
+    EXPECT_EQ(flat.n(), proposal.n());
+    for (uint64_t i = flat.n() - N; i < flat.n(); ++i) {
+        EXPECT_EQ(flat.get(i), proposal.get(i));
+    }
+    EXPECT_EQ(flat.get(N + 10), bytes32_t{1000});
+    EXPECT_EQ(flat.get(N + 11), bytes32_t{1001});
+}
+
 TEST(BlockHashBuffer, duplicate_proposals)
 {
     BlockHashBufferFinalized buf;
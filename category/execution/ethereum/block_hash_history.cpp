@@ -21,10 +21,15 @@
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/evm/explicit_traits.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
 
 #include <evmc/evmc.h>
 
 #include <cstdint>
+#include <span>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -65,6 +70,23 @@ void set_block_hash_history(State &state, BlockHeader const &header)
     }
 }
 
+template <Traits traits>
+void precompile_block_hash_history_contract(vm::VM &vm)
+{
+    if constexpr (traits::evm_rev() >= EVMC_PRAGUE) {
+        static bytes32_t const code_hash =
+            to_bytes(keccak256(BLOCK_HISTORY_CODE));
+        static vm::SharedIntercode const icode =
+            vm::make_shared_intercode(std::span{BLOCK_HISTORY_CODE});
+        (void)vm.precompile<traits>(code_hash, icode);
+    }
+    else {
+        (void)vm;
+    }
+}
+
+EXPLICIT_TRAITS(precompile_block_hash_history_contract);
+
 // Note: EIP-2935 says the get on the block hash history contract should revert
 // if the block number is outside of the block history. However, current usage
 // of this function guarantees that it is always valid.
@@ -17,6 +17,7 @@
 
 #include <category/core/config.hpp>
 #include <category/execution/ethereum/core/address.hpp>
+#include <category/vm/evm/traits.hpp>
 
 #include <cstdint>
 
@@ -25,6 +26,11 @@ MONAD_NAMESPACE_BEGIN
 struct BlockHeader;
 class State;
 
+namespace vm
+{
+    class VM;
+}
+
 constexpr Address BLOCK_HISTORY_ADDRESS{
     0x0000F90827F1C53a10cb7A02335B175320002935_address};
 
@@ -32,6 +38,11 @@ constexpr uint64_t BLOCK_HISTORY_LENGTH{8191};
 
 void deploy_block_hash_history_contract(State &);
 
+/// Compile the EIP-2935 contract and pin it in the code cache of `vm`, so
+/// that it never runs in the interpreter. Does nothing before Prague.
+template <Traits traits>
+void precompile_block_hash_history_contract(vm::VM &);
+
 void set_block_hash_history(State &, BlockHeader const &);
 
 bytes32_t get_block_hash_history(State &, uint64_t block_number);
@@ -275,6 +275,22 @@ TEST_F(BlockHistoryFixture, read_from_block_hash_history_contract)
     get(false, 1234567890);
 }
 
+TEST_F(BlockHistoryFixture, precompile_block_hash_history_contract)
+{
+    precompile_block_hash_history_contract<EvmTraits<EVMC_CANCUN>>(vm);
+    deploy_history_contract();
+    auto const hash = state.get_code_hash(BLOCK_HISTORY_ADDRESS);
+    EXPECT_EQ(state.read_code(hash)->nativecode(), nullptr);
+
+    precompile_block_hash_history_contract<Prague>(vm);
+    auto const vcode = vm.find_varcode(hash);
+    ASSERT_TRUE(vcode.has_value());
+    auto const &ncode = (*vcode)->nativecode();
+    ASSERT_NE(ncode, nullptr);
+    EXPECT_NE(ncode->entrypoint(), nullptr);
+    EXPECT_EQ(ncode->chain_id(), Prague::id());
+}
+
 TEST_F(BlockHistoryFixture, read_write_block_hash_history_contract)
 {
     static constexpr uint64_t window_size = BLOCK_HISTORY_LENGTH;
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/conflict_scheduler.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/fmt/address_fmt.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+
+#include <ankerl/unordered_dense.h>
+
+#include <quill/Quill.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+bool ConflictScheduler::is_hot(Address const &address) const
+{
+    return hot_.contains(address);
+}
+
+size_t ConflictScheduler::num_hot() const
+{
+    return hot_.size();
+}
+
+std::vector<std::optional<uint64_t>> ConflictScheduler::schedule(
+    std::vector<Transaction> const &transactions,
+    std::vector<Address> const &senders,
+    std::vector<std::vector<std::optional<Address>>> const &authorities) const
+{
+    MONAD_ASSERT(senders.size() == transactions.size());
+    MONAD_ASSERT(authorities.size() == transactions.size());
+
+    std::vector<std::optional<uint64_t>> dependencies(transactions.size());
+    if (hot_.empty()) {
+        return dependencies;
+    }
+
+    // last transaction that declared each hot account
+    ankerl::unordered_dense::segmented_map<Address, uint64_t> last;
+
+    for (uint64_t i = 0; i < transactions.size(); ++i) {
+        auto &dependency = dependencies[i];
+        auto const visit = [&](Address const &address) {
+            if (!is_hot(address)) {
+                return;
+            }
+            auto const [it, inserted] = last.try_emplace(address, i);
+            if (!inserted) {
+                if (it->second != i) {
+                    dependency = std::max(dependency.value_or(0), it->second);
+                }
+                it->second = i;
+            }
+        };
+
+        auto const &tx = transactions[i];
+        visit(senders[i]);
+        if (tx.to.has_value()) {
+            visit(tx.to.value());
+        }
+        for (auto const &entry : tx.access_list) {
+            visit(entry.a);
+        }
+        for (auto const &authority : authorities[i]) {
+            if (authority.has_value()) {
+                visit(authority.value());
+            }
+        }
+    }
+
+    return dependencies;
+}
+
+void ConflictScheduler::update(
+    std::vector<Transaction> const &transactions, BlockMetrics const &metrics)
+{
+    for (auto &entry : hot_) {
+        --entry.second;
+    }
+    std::erase_if(hot_, [](std::pair<Address, uint8_t> const &entry) {
+        return entry.second == 0;
+    });
+
+    for (auto const &[txn, conflict] : metrics.conflicts()) {
+        LOG_DEBUG(
+            "conflict: txn {} on {} after txn {}",
+            txn,
+            conflict.address,
+            conflict.writer.has_value() ? static_cast<int64_t>(*conflict.writer)
+                                        : -1);
+        hot_[conflict.address] = HOT_BLOCKS;
+        // the account that conflicted is usually reached through the
+        // transaction's entry point, e.g. a token behind a router
+        MONAD_ASSERT(txn < transactions.size());
+        if (auto const &to = transactions[txn].to; to.has_value()) {
+            hot_[to.value()] = HOT_BLOCKS;
+        }
+    }
+}
+
+MONAD_NAMESPACE_END
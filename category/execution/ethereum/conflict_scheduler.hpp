@@ -0,0 +1,68 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <ankerl/unordered_dense.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockMetrics;
+struct Transaction;
+
+/**
+ * Orders transactions that are predicted to conflict so that a dependent
+ * transaction only starts its optimistic execution once the transaction it
+ * depends on has merged, instead of executing twice.
+ *
+ * The prediction is made from the accounts each transaction declares before
+ * it executes (sender, recipient, access list and authorities), filtered by
+ * the set of "hot" accounts that caused merge conflicts in recent blocks. The
+ * hot set is learnt from the conflict graph recorded in `BlockMetrics` and
+ * decays when an account stops conflicting.
+ */
+class ConflictScheduler
+{
+public:
+    // number of blocks an account stays hot after its last conflict
+    static constexpr uint8_t HOT_BLOCKS = 8;
+
+private:
+    ankerl::unordered_dense::segmented_map<Address, uint8_t> hot_{};
+
+public:
+    bool is_hot(Address const &) const;
+
+    size_t num_hot() const;
+
+    // For each transaction, the index of the latest earlier transaction that
+    // must be merged before it starts executing, if any
+    std::vector<std::optional<uint64_t>> schedule(
+        std::vector<Transaction> const &, std::vector<Address> const &senders,
+        std::vector<std::vector<std::optional<Address>>> const &authorities)
+        const;
+
+    // Learn from the conflicts recorded while executing a block
+    void update(std::vector<Transaction> const &, BlockMetrics const &);
+};
+
+MONAD_NAMESPACE_END
@@ -82,6 +82,16 @@ public:
     {
     }
 
+    // The storage keys the variable occupies
+    Slots slot_keys() const noexcept
+    {
+        Slots keys;
+        for (size_t i = 0; i < N; ++i) {
+            keys[i] = intx::be::store<bytes32_t>(offset_ + i);
+        }
+        return keys;
+    }
+
     T load() const noexcept
     {
         Slots slots;
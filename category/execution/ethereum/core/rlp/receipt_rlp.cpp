@@ -13,11 +13,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/assert.h>
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
 #include <category/core/likely.h>
 #include <category/core/result.hpp>
 #include <category/core/rlp/config.hpp>
+#include <category/core/rlp/encode.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
 #include <category/execution/ethereum/core/rlp/address_rlp.hpp>
 #include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
@@ -32,27 +34,128 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <span>
 #include <utility>
 #include <vector>
 
 MONAD_RLP_NAMESPACE_BEGIN
 
 // Encode
+namespace
+{
+    constexpr size_t ADDRESS_RLP_LENGTH = 1 + sizeof(Address);
+    constexpr size_t TOPIC_RLP_LENGTH = 1 + sizeof(bytes32_t);
+    constexpr size_t BLOOM_RLP_LENGTH =
+        string_header_length(sizeof(Receipt::Bloom)) + sizeof(Receipt::Bloom);
+
+    size_t topics_payload_length(std::vector<bytes32_t> const &topics)
+    {
+        return topics.size() * TOPIC_RLP_LENGTH;
+    }
+
+    size_t log_payload_length(Receipt::Log const &log)
+    {
+        return ADDRESS_RLP_LENGTH +
+               list_length(topics_payload_length(log.topics)) +
+               string_length(log.data);
+    }
+
+    size_t logs_payload_length(std::vector<Receipt::Log> const &logs)
+    {
+        size_t length = 0;
+        for (auto const &log : logs) {
+            length += log_length(log);
+        }
+        return length;
+    }
+
+    size_t receipt_payload_length(Receipt const &receipt, size_t const logs)
+    {
+        return unsigned_length(receipt.status) +
+               unsigned_length(receipt.gas_used) + BLOOM_RLP_LENGTH +
+               list_length(logs);
+    }
+
+    bool is_typed(Receipt const &receipt)
+    {
+        return receipt.type == TransactionType::eip1559 ||
+               receipt.type == TransactionType::eip2930 ||
+               receipt.type == TransactionType::eip4844 ||
+               receipt.type == TransactionType::eip7702;
+    }
+
+    template <size_t N>
+    std::span<unsigned char>
+    encode_fixed(std::span<unsigned char> d, unsigned char const (&bytes)[N])
+    {
+        static_assert(N > 1);
+        d = encode_string_header(d, N);
+        std::memcpy(d.data(), bytes, N);
+        return d.subspan(N);
+    }
+}
+
+size_t log_length(Receipt::Log const &log)
+{
+    return list_length(log_payload_length(log));
+}
+
+std::span<unsigned char>
+encode_log(std::span<unsigned char> d, Receipt::Log const &log)
+{
+    d = encode_list_header(d, log_payload_length(log));
+    d = encode_fixed(d, log.address.bytes);
+    d = encode_list_header(d, topics_payload_length(log.topics));
+    for (auto const &topic : log.topics) {
+        d = encode_fixed(d, topic.bytes);
+    }
+    return encode_string(d, log.data);
+}
+
+size_t receipt_length(Receipt const &receipt)
+{
+    return (is_typed(receipt) ? 1 : 0) +
+           list_length(receipt_payload_length(
+               receipt, logs_payload_length(receipt.logs)));
+}
+
+std::span<unsigned char>
+encode_receipt(std::span<unsigned char> d, Receipt const &receipt)
+{
+    if (is_typed(receipt)) {
+        d[0] = static_cast<unsigned char>(receipt.type);
+        d = d.subspan(1);
+    }
+    size_t const logs = logs_payload_length(receipt.logs);
+    d = encode_list_header(d, receipt_payload_length(receipt, logs));
+    d = encode_unsigned(d, receipt.status);
+    d = encode_unsigned(d, receipt.gas_used);
+    d = encode_string(d, to_byte_string_view(receipt.bloom));
+    d = encode_list_header(d, logs);
+    for (auto const &log : receipt.logs) {
+        d = encode_log(d, log);
+    }
+    return d;
+}
+
 byte_string encode_topics(std::vector<bytes32_t> const &topics)
 {
-    byte_string result{};
-    for (auto const &i : topics) {
-        result += encode_bytes32(i);
+    byte_string result(list_length(topics_payload_length(topics)), 0);
+    std::span<unsigned char> d{result};
+    d = encode_list_header(d, topics_payload_length(topics));
+    for (auto const &topic : topics) {
+        d = encode_fixed(d, topic.bytes);
     }
-    return encode_list2(result);
+    MONAD_ASSERT(d.empty());
+    return result;
 }
 
 byte_string encode_log(Receipt::Log const &log)
 {
-    return encode_list2(
-        encode_address(log.address),
-        encode_topics(log.topics),
-        encode_string2(log.data));
+    byte_string result(log_length(log), 0);
+    MONAD_ASSERT(encode_log(result, log).empty());
+    return result;
 }
 
 byte_string encode_bloom(Receipt::Bloom const &bloom)
@@ -62,25 +165,9 @@ byte_string encode_bloom(Receipt::Bloom const &bloom)
 
 byte_string encode_receipt(Receipt const &receipt)
 {
-    byte_string log_result{};
-
-    for (auto const &i : receipt.logs) {
-        log_result += encode_log(i);
-    }
-
-    auto const receipt_bytes = encode_list2(
-        encode_unsigned(receipt.status),
-        encode_unsigned(receipt.gas_used),
-        encode_bloom(receipt.bloom),
-        encode_list2(log_result));
-
-    if (receipt.type == TransactionType::eip1559 ||
-        receipt.type == TransactionType::eip2930 ||
-        receipt.type == TransactionType::eip4844 ||
-        receipt.type == TransactionType::eip7702) {
-        return static_cast<unsigned char>(receipt.type) + receipt_bytes;
-    }
-    return receipt_bytes;
+    byte_string result(receipt_length(receipt), 0);
+    MONAD_ASSERT(encode_receipt(result, receipt).empty());
+    return result;
 }
 
 // Decode
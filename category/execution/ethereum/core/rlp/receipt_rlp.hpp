@@ -21,6 +21,8 @@
 #include <category/core/rlp/config.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
 
+#include <cstddef>
+#include <span>
 #include <vector>
 
 MONAD_RLP_NAMESPACE_BEGIN
@@ -30,6 +32,15 @@ byte_string encode_log(Receipt::Log const &);
 byte_string encode_bloom(Receipt::Bloom const &);
 byte_string encode_receipt(Receipt const &);
 
+// Two-pass encoding: `d` must have at least `*_length` bytes left, and the
+// remainder after the encoding is returned
+size_t log_length(Receipt::Log const &);
+std::span<unsigned char>
+encode_log(std::span<unsigned char> d, Receipt::Log const &);
+size_t receipt_length(Receipt const &);
+std::span<unsigned char>
+encode_receipt(std::span<unsigned char> d, Receipt const &);
+
 Result<Receipt::Bloom> decode_bloom(byte_string_view &);
 Result<std::vector<bytes32_t>> decode_topics(byte_string_view &);
 Result<Receipt::Log> decode_log(byte_string_view &);
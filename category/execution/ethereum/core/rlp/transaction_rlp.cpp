@@ -383,8 +383,9 @@ Result<std::vector<Transaction>> decode_transaction_list(byte_string_view &enc)
 {
     std::vector<Transaction> transactions;
     BOOST_OUTCOME_TRY(auto ls, parse_list_metadata(enc));
+    BOOST_OUTCOME_TRY(auto const count, count_list_items(ls));
+    transactions.reserve(count);
 
-    // TODO: Reserve txn vector size for better perf
     while (!ls.empty()) {
         if (ls[0] >= 0xc0) {
             BOOST_OUTCOME_TRY(auto tx, decode_transaction_legacy(ls));
@@ -29,6 +29,7 @@
 #include <filesystem>
 #include <string>
 #include <string_view>
+#include <utility>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -49,20 +50,38 @@ bool BlockDb::get(uint64_t const num, Block &block) const
     if (!result.has_value()) {
         return false;
     }
+    // Reused across blocks and never zero filled; it only grows while a
+    // block decompresses to more than the buffer holds
+    static thread_local byte_string brotli_buffer(size_t{1} << 20, 0);
     auto const view = to_byte_string_view(result.value());
-    size_t brotli_size = std::max(result->size() * 100, 1ul << 20); // TODO
-    byte_string brotli_buffer;
-    brotli_buffer.resize(brotli_size);
-    auto const brotli_result = BrotliDecoderDecompress(
-        view.size(), view.data(), &brotli_size, brotli_buffer.data());
-    brotli_buffer.resize(brotli_size);
+    BrotliDecoderState *const state =
+        BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    MONAD_ASSERT(state != nullptr);
+    size_t available_in = view.size();
+    uint8_t const *next_in = view.data();
+    size_t total_out = 0;
+    BrotliDecoderResult brotli_result;
+    do {
+        if (total_out == brotli_buffer.size()) {
+            brotli_buffer.resize_and_overwrite(
+                2 * brotli_buffer.size(),
+                [](unsigned char *, size_t const size) { return size; });
+        }
+        size_t available_out = brotli_buffer.size() - total_out;
+        uint8_t *next_out = brotli_buffer.data() + total_out;
+        brotli_result = BrotliDecoderDecompressStream(
+            state, &available_in, &next_in, &available_out, &next_out, nullptr);
+        total_out = static_cast<size_t>(next_out - brotli_buffer.data());
+    }
+    while (brotli_result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT);
+    BrotliDecoderDestroyInstance(state);
     MONAD_ASSERT(brotli_result == BROTLI_DECODER_RESULT_SUCCESS);
-    byte_string_view view2{brotli_buffer};
+    byte_string_view view2{brotli_buffer.data(), total_out};
 
-    auto const decoded_block = rlp::decode_block(view2);
+    auto decoded_block = rlp::decode_block(view2);
     MONAD_ASSERT(!decoded_block.has_error());
     MONAD_ASSERT(view2.size() == 0);
-    block = decoded_block.value();
+    block = std::move(decoded_block.value());
     return true;
 }
 
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/db/block_db.hpp>
+#include <category/execution/ethereum/db/block_readahead.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+#include <pthread.h>
+
+MONAD_NAMESPACE_BEGIN
+
+BlockReadahead::BlockReadahead(
+    BlockDb const &block_db, uint64_t const first, uint64_t const last,
+    size_t const depth)
+    : block_db_{block_db}
+    , last_{last}
+    , depth_{depth}
+{
+    MONAD_ASSERT(depth > 0);
+    thread_ = std::jthread{[this, first](std::stop_token const token) {
+        run(token, first);
+    }};
+}
+
+void BlockReadahead::run(std::stop_token const token, uint64_t const first)
+{
+    pthread_setname_np(pthread_self(), "block readahead");
+    auto const has_room = [this] { return ready_.size() < depth_; };
+    for (uint64_t n = first; n <= last_; ++n) {
+        {
+            std::unique_lock lock{mutex_};
+            if (!cv_.wait(lock, token, has_room)) {
+                break;
+            }
+        }
+        std::optional<Block> block{std::in_place};
+        if (!block_db_.get(n, *block)) {
+            block.reset();
+        }
+        bool const found = block.has_value();
+        {
+            std::lock_guard const lock{mutex_};
+            ready_.push_back(std::move(block));
+        }
+        cv_.notify_all();
+        if (!found || n == last_) {
+            break;
+        }
+    }
+    {
+        std::lock_guard const lock{mutex_};
+        done_ = true;
+    }
+    cv_.notify_all();
+}
+
+bool BlockReadahead::next(Block &block)
+{
+    std::optional<Block> front;
+    {
+        std::unique_lock lock{mutex_};
+        cv_.wait(lock, [this] { return !ready_.empty() || done_; });
+        if (ready_.empty()) {
+            return false;
+        }
+        front = std::move(ready_.front());
+        ready_.pop_front();
+    }
+    cv_.notify_all();
+    if (!front.has_value()) {
+        return false;
+    }
+    block = std::move(*front);
+    return true;
+}
+
+MONAD_NAMESPACE_END
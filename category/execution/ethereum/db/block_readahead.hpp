@@ -0,0 +1,63 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockDb;
+
+/// Reads consecutive blocks from a BlockDb on a background thread, keeping
+/// up to `depth` decoded blocks ready, so the consumer does not wait on file
+/// I/O and decompression. The thread stops at the first missing block.
+class BlockReadahead
+{
+    BlockDb const &block_db_;
+    uint64_t const last_;
+    size_t const depth_;
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    // a nullopt entry marks a block which is not in the database
+    std::deque<std::optional<Block>> ready_;
+    bool done_{false};
+    std::jthread thread_;
+
+    void run(std::stop_token, uint64_t first);
+
+public:
+    BlockReadahead(
+        BlockDb const &, uint64_t first, uint64_t last, size_t depth);
+    BlockReadahead(BlockReadahead const &) = delete;
+    BlockReadahead &operator=(BlockReadahead const &) = delete;
+    ~BlockReadahead() = default;
+
+    /// Moves the next block into `block`; returns false when that block is
+    /// missing or past `last`
+    bool next(Block &block);
+};
+
+MONAD_NAMESPACE_END
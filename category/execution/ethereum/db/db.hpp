@@ -28,12 +28,52 @@
 #include <category/execution/ethereum/trace/call_frame.hpp>
 #include <category/vm/vm.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
 
 MONAD_NAMESPACE_BEGIN
 
+/// Counters of a db since its construction; the share of a block is the
+/// difference of the counters before and after it
+struct DbStats
+{
+    uint64_t account_reads{0}; ///< account lookups which reached the trie
+    uint64_t storage_reads{0}; ///< storage lookups which reached the trie
+    uint64_t cache_hits{0}; ///< lookups served by the account/storage caches
+    uint64_t cache_misses{0};
+    /// Commit time hashing and encoding the state deltas
+    std::chrono::nanoseconds commit_state_time{0};
+    /// Commit time encoding the receipts, transactions and call frames,
+    /// which with commit threads overlaps the upsert of the state
+    std::chrono::nanoseconds commit_block_data_time{0};
+    /// Commit time updating the tries and writing their new nodes
+    std::chrono::nanoseconds commit_upsert_time{0};
+
+    DbStats operator-(DbStats const &other) const
+    {
+        return {
+            .account_reads = account_reads - other.account_reads,
+            .storage_reads = storage_reads - other.storage_reads,
+            .cache_hits = cache_hits - other.cache_hits,
+            .cache_misses = cache_misses - other.cache_misses,
+            .commit_state_time = commit_state_time - other.commit_state_time,
+            .commit_block_data_time =
+                commit_block_data_time - other.commit_block_data_time,
+            .commit_upsert_time =
+                commit_upsert_time - other.commit_upsert_time};
+    }
+};
+
+/// One block of a Db::finalize_batch()
+struct BlockFinalization
+{
+    uint64_t block_number;
+    bytes32_t block_id;
+};
+
 struct Db
 {
     virtual std::optional<Account> read_account(Address const &) = 0;
@@ -43,6 +83,12 @@ struct Db
 
     virtual vm::SharedIntercode read_code(bytes32_t const &) = 0;
 
+    // size of the code without building its intercode, for EXTCODESIZE
+    virtual size_t read_code_size(bytes32_t const &code_hash)
+    {
+        return read_code(code_hash)->size();
+    }
+
     virtual BlockHeader read_eth_header() = 0;
     virtual bytes32_t state_root() = 0;
     virtual bytes32_t receipts_root() = 0;
@@ -54,6 +100,22 @@ struct Db
         uint64_t block_number, bytes32_t const &block_id = bytes32_t{}) = 0;
     virtual void finalize(uint64_t block_number, bytes32_t const &block_id) = 0;
     virtual void update_verified_block(uint64_t block_number) = 0;
+
+    // finalize() of each of the consecutive `blocks` in order, then
+    // update_verified_block() of `verified_block` if set. Implementations
+    // may persist the whole batch at once.
+    virtual void finalize_batch(
+        std::span<BlockFinalization const> const blocks,
+        std::optional<uint64_t> const verified_block)
+    {
+        for (auto const &[block_number, block_id] : blocks) {
+            finalize(block_number, block_id);
+        }
+        if (verified_block.has_value()) {
+            update_verified_block(*verified_block);
+        }
+    }
+
     virtual void
     update_voted_metadata(uint64_t block_number, bytes32_t const &block_id) = 0;
 
@@ -64,7 +126,8 @@ struct Db
         std::vector<Address> const & = {},
         std::vector<Transaction> const & = {},
         std::vector<BlockHeader> const &ommers = {},
-        std::optional<std::vector<Withdrawal>> const & = std::nullopt) = 0;
+        std::optional<std::vector<Withdrawal>> const & = std::nullopt,
+        std::vector<bytes32_t> const &tx_hashes = {}) = 0;
 
     virtual void commit(
         std::unique_ptr<StateDeltas> state_deltas, Code const &code,
@@ -74,7 +137,8 @@ struct Db
         std::vector<Address> const &senders = {},
         std::vector<Transaction> const &transactions = {},
         std::vector<BlockHeader> const &ommers = {},
-        std::optional<std::vector<Withdrawal>> const &withdrawals = {})
+        std::optional<std::vector<Withdrawal>> const &withdrawals = {},
+        std::vector<bytes32_t> const &tx_hashes = {})
     {
         commit(
             *state_deltas,
@@ -86,13 +150,19 @@ struct Db
             senders,
             transactions,
             ommers,
-            withdrawals);
+            withdrawals,
+            tx_hashes);
     }
 
     virtual std::string print_stats()
     {
         return {};
     }
+
+    virtual DbStats stats()
+    {
+        return {};
+    }
 };
 
 MONAD_NAMESPACE_END
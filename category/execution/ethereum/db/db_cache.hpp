@@ -18,7 +18,7 @@
 #include <category/core/bytes.hpp>
 #include <category/core/bytes_hash_compare.hpp>
 #include <category/core/config.hpp>
-#include <category/core/lru/lru_cache.hpp>
+#include <category/core/lru/clock_cache.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/db/db.hpp>
@@ -29,8 +29,14 @@
 
 #include <evmc/evmc.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <optional>
+#include <span>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -62,17 +68,74 @@ class DbCache final : public Db
     using AddressHashCompare = BytesHashCompare<Address>;
     using StorageKeyHashCompare = BytesHashCompare<StorageKey>;
     using AccountsCache =
-        LruCache<Address, std::optional<Account>, AddressHashCompare>;
-    using StorageCache = LruCache<StorageKey, bytes32_t, StorageKeyHashCompare>;
+        ClockCache<Address, std::optional<Account>, AddressHashCompare>;
+    using StorageCache =
+        ClockCache<StorageKey, bytes32_t, StorageKeyHashCompare>;
+    using CodeSizeCache =
+        ClockCache<bytes32_t, size_t, BytesHashCompare<bytes32_t>>;
 
-    AccountsCache accounts_{10'000'000};
-    StorageCache storage_{10'000'000};
+    // one budget covers both caches; the accounts cache gets
+    // `accounts_bytes_` of it and the storage cache the rest
+    size_t budget_bytes_;
+    size_t accounts_bytes_;
+    std::atomic<size_t> target_budget_bytes_;
+    uint64_t rebalance_account_misses_{0};
+    uint64_t rebalance_storage_misses_{0};
+    AccountsCache accounts_;
+    StorageCache storage_;
+    // code is keyed by its hash and never changes, so the sizes are valid
+    // in every proposal and survive truncation
+    CodeSizeCache code_sizes_;
     Proposals proposals_;
+    // The deltas of the last finalized blocks, newest first, adopted from
+    // their proposals as they are. Reads consult them before the LRU caches,
+    // which take a block's deltas only once it ages out of here, leaving out
+    // the keys that a newer block wrote again. Like the proposals, they only
+    // change when finalizing, which never overlaps with reads.
+    static constexpr size_t FINALIZED_DEPTH = 4;
+    std::deque<std::unique_ptr<ProposalState>> finalized_;
 
 public:
-    DbCache(Db &db)
+    // room for 10M accounts and 10M storage slots
+    static constexpr size_t default_budget_bytes =
+        10'000'000 *
+        (AccountsCache::entry_bytes + StorageCache::entry_bytes);
+
+    // room for 1M code sizes
+    static constexpr size_t code_size_bytes =
+        1'000'000 * CodeSizeCache::entry_bytes;
+
+    DbCache(Db &db, size_t const budget_bytes = default_budget_bytes)
         : db_{db}
+        , budget_bytes_{budget_bytes}
+        , accounts_bytes_{
+              budget_bytes /
+              (AccountsCache::entry_bytes + StorageCache::entry_bytes) *
+              AccountsCache::entry_bytes}
+        , target_budget_bytes_{budget_bytes}
+        , accounts_{accounts_bytes_}
+        , storage_{budget_bytes_ - accounts_bytes_}
+        , code_sizes_{code_size_bytes}
+    {
+    }
+
+    // Thread-safe. The new budget takes effect at the next finalized block,
+    // keeping the current split between the account and storage caches.
+    void set_budget_bytes(size_t const budget_bytes) noexcept
     {
+        target_budget_bytes_.store(budget_bytes, std::memory_order_relaxed);
+    }
+
+    // the budget in effect, shared by the account and storage caches
+    size_t budget_bytes() const noexcept
+    {
+        return budget_bytes_;
+    }
+
+    // account and storage lookups which missed since construction
+    uint64_t misses() const
+    {
+        return accounts_.misses() + storage_.misses();
     }
 
     virtual std::optional<Account> read_account(Address const &address) override
@@ -83,6 +146,11 @@ public:
             return result;
         }
         if (!truncated) {
+            for (auto const &ps : finalized_) {
+                if (ps->try_read_account(address, result)) {
+                    return result;
+                }
+            }
             AccountsCache::ConstAccessor acc{};
             if (accounts_.find(acc, address)) {
                 return acc->second.value_;
@@ -102,6 +170,11 @@ public:
             return result;
         }
         if (!truncated) {
+            for (auto const &ps : finalized_) {
+                if (ps->try_read_storage(address, incarnation, key, result)) {
+                    return result;
+                }
+            }
             StorageKey const skey{address, incarnation, key};
             StorageCache::ConstAccessor acc{};
             if (storage_.find(acc, skey)) {
@@ -116,6 +189,23 @@ public:
         return db_.read_code(code_hash);
     }
 
+    virtual size_t read_code_size(bytes32_t const &code_hash) override
+    {
+        {
+            CodeSizeCache::ConstAccessor acc{};
+            if (code_sizes_.find(acc, code_hash)) {
+                return acc->second.value_;
+            }
+        }
+        size_t const size = db_.read_code_size(code_hash);
+        // missing code reads as empty; leave it out so that it is found
+        // once a block with that code is committed
+        if (size != 0) {
+            code_sizes_.insert(code_hash, size);
+        }
+        return size;
+    }
+
     virtual void set_block_and_prefix(
         uint64_t const block_number,
         bytes32_t const &block_id = bytes32_t{}) override
@@ -127,19 +217,20 @@ public:
     virtual void
     finalize(uint64_t const block_number, bytes32_t const &block_id) override
     {
-        std::unique_ptr<ProposalState> const ps =
-            proposals_.finalize(block_number, block_id);
-        if (ps) {
-            insert_in_lru_caches(ps->state());
-        }
-        else {
-            // Finalizing a truncated proposal. Clear LRU caches.
-            accounts_.clear();
-            storage_.clear();
-        }
+        finalize_caches(block_number, block_id);
         db_.finalize(block_number, block_id);
     }
 
+    virtual void finalize_batch(
+        std::span<BlockFinalization const> const blocks,
+        std::optional<uint64_t> const verified_block) override
+    {
+        for (auto const &[block_number, block_id] : blocks) {
+            finalize_caches(block_number, block_id);
+        }
+        db_.finalize_batch(blocks, verified_block);
+    }
+
     virtual void update_verified_block(uint64_t const block_number) override
     {
         db_.update_verified_block(block_number);
@@ -157,7 +248,8 @@ public:
         std::vector<std::vector<CallFrame>> const &,
         std::vector<Address> const &, std::vector<Transaction> const &,
         std::vector<BlockHeader> const &,
-        std::optional<std::vector<Withdrawal>> const &) override
+        std::optional<std::vector<Withdrawal>> const &,
+        std::vector<bytes32_t> const &) override
     {
         MONAD_ABORT("Use DbCache commit with unique_ptr arg.");
     }
@@ -170,7 +262,8 @@ public:
         std::vector<Address> const &senders = {},
         std::vector<Transaction> const &transactions = {},
         std::vector<BlockHeader> const &ommers = {},
-        std::optional<std::vector<Withdrawal>> const &withdrawals = {}) override
+        std::optional<std::vector<Withdrawal>> const &withdrawals = {},
+        std::vector<bytes32_t> const &tx_hashes = {}) override
     {
         db_.commit(
             *state_deltas,
@@ -182,7 +275,8 @@ public:
             senders,
             transactions,
             ommers,
-            withdrawals);
+            withdrawals,
+            tx_hashes);
 
         proposals_.commit(std::move(state_deltas), header.number, block_id);
     }
@@ -215,29 +309,142 @@ public:
     virtual std::string print_stats() override
     {
         return db_.print_stats() + ",ac=" + accounts_.print_stats() +
-               ",sc=" + storage_.print_stats();
+               ",sc=" + storage_.print_stats() +
+               ",csc=" + code_sizes_.print_stats();
+    }
+
+    virtual DbStats stats() override
+    {
+        DbStats stats = db_.stats();
+        stats.cache_hits += accounts_.hits() + storage_.hits();
+        stats.cache_misses += misses();
+        return stats;
     }
 
 private:
-    void insert_in_lru_caches(StateDeltas const &state_deltas)
-    {
-        for (auto it = state_deltas.cbegin(); it != state_deltas.cend(); ++it) {
-            auto const &address = it->first;
-            auto const &account_delta = it->second.account;
-            accounts_.insert(address, account_delta.second);
-            auto const &storage = it->second.storage;
-            auto const &account = account_delta.second;
-            if (account.has_value()) {
-                for (auto it2 = storage.cbegin(); it2 != storage.cend();
-                     ++it2) {
-                    auto const &key = it2->first;
-                    auto const &storage_delta = it2->second;
-                    auto const incarnation = account->incarnation;
-                    storage_.insert(
-                        StorageKey(address, incarnation, key),
-                        storage_delta.second);
+    // The cache side of finalizing a block
+    void finalize_caches(uint64_t const block_number, bytes32_t const &block_id)
+    {
+        std::optional<ProposalWrites> truncated_writes;
+        std::unique_ptr<ProposalState> ps =
+            proposals_.finalize(block_number, block_id, truncated_writes);
+        if (ps) {
+            if (finalized_.size() == FINALIZED_DEPTH) {
+                fold_oldest_finalized();
+            }
+            finalized_.push_front(std::move(ps));
+            rebalance();
+            return;
+        }
+        // Finalizing a truncated proposal. The finalized blocks before it
+        // still go to the LRU caches, then what it wrote is invalidated.
+        while (!finalized_.empty()) {
+            fold_oldest_finalized();
+        }
+        if (truncated_writes.has_value()) {
+            for (auto const &address : truncated_writes->accounts) {
+                accounts_.erase(address);
+            }
+            for (auto const &[address, incarnation, key] :
+                 truncated_writes->storage) {
+                storage_.erase(StorageKey{address, incarnation, key});
+            }
+        }
+        else {
+            accounts_.clear();
+            storage_.clear();
+        }
+    }
+
+    // Called once per finalized block. Moves a slice of the budget to the
+    // cache that missed clearly more often since the last call, as long as
+    // it is full and the other cache keeps a tenth of the budget.
+    void rebalance()
+    {
+        if (size_t const target =
+                target_budget_bytes_.load(std::memory_order_relaxed);
+            target != budget_bytes_) {
+            accounts_bytes_ = static_cast<size_t>(
+                static_cast<double>(target) *
+                static_cast<double>(accounts_bytes_) /
+                static_cast<double>(std::max<size_t>(budget_bytes_, 1)));
+            budget_bytes_ = target;
+            accounts_.set_capacity_bytes(accounts_bytes_);
+            storage_.set_capacity_bytes(budget_bytes_ - accounts_bytes_);
+        }
+
+        uint64_t const account_misses =
+            accounts_.misses() - rebalance_account_misses_;
+        uint64_t const storage_misses =
+            storage_.misses() - rebalance_storage_misses_;
+        rebalance_account_misses_ += account_misses;
+        rebalance_storage_misses_ += storage_misses;
+
+        size_t const step = budget_bytes_ / 64;
+        size_t const min_bytes = budget_bytes_ / 10;
+        auto const is_full = [](auto const &cache) {
+            return cache.size() >= cache.capacity() - cache.capacity() / 16;
+        };
+        size_t accounts_bytes = accounts_bytes_;
+        if (account_misses * 4 > storage_misses * 5 && is_full(accounts_) &&
+            budget_bytes_ - accounts_bytes >= min_bytes + step) {
+            accounts_bytes += step;
+        }
+        else if (
+            storage_misses * 4 > account_misses * 5 && is_full(storage_) &&
+            accounts_bytes >= min_bytes + step) {
+            accounts_bytes -= step;
+        }
+        if (accounts_bytes != accounts_bytes_) {
+            accounts_bytes_ = accounts_bytes;
+            accounts_.set_capacity_bytes(accounts_bytes_);
+            storage_.set_capacity_bytes(budget_bytes_ - accounts_bytes_);
+        }
+    }
+
+    // Moves the deltas of the oldest finalized block to the LRU caches,
+    // except for the keys a newer finalized block wrote again, which move
+    // with that block
+    void fold_oldest_finalized()
+    {
+        std::unique_ptr<ProposalState> const ps = std::move(finalized_.back());
+        finalized_.pop_back();
+        std::array<StateDeltas::const_accessor, FINALIZED_DEPTH - 1> newer;
+        for (auto const &[address, delta] : ps->state()) {
+            size_t n = 0;
+            for (auto const &segment : finalized_) {
+                if (segment->state().find(newer[n], address)) {
+                    ++n;
                 }
             }
+            insert_in_lru_caches(address, delta, std::span{newer.data(), n});
+            for (size_t i = 0; i < n; ++i) {
+                newer[i].release();
+            }
+        }
+    }
+
+    void insert_in_lru_caches(
+        Address const &address, StateDelta const &delta,
+        std::span<StateDeltas::const_accessor const> const newer)
+    {
+        if (newer.empty()) {
+            accounts_.insert(address, delta.account.second);
+        }
+        auto const &account = delta.account.second;
+        if (!account.has_value()) {
+            return;
+        }
+        for (auto const &[key, storage_delta] : delta.storage) {
+            bool const rewritten =
+                std::ranges::any_of(newer, [&key](auto const &acc) {
+                    return acc->second.storage.contains(key);
+                });
+            if (!rewritten) {
+                storage_.insert(
+                    StorageKey(address, account->incarnation, key),
+                    storage_delta.second);
+            }
         }
     }
 };
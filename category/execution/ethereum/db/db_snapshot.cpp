@@ -27,29 +27,36 @@
 #include <ankerl/unordered_dense.h>
 #include <quill/Quill.h>
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 inline constexpr unsigned MONAD_SNAPSHOT_SHARD_NIBBLES = 2;
-inline constexpr unsigned MONAD_SNAPSHOT_SHARDS =
-    1 << (MONAD_SNAPSHOT_SHARD_NIBBLES * 4);
-static_assert(MONAD_SNAPSHOT_SHARDS == 256);
+static_assert(MONAD_SNAPSHOT_SHARDS == 1 << (MONAD_SNAPSHOT_SHARD_NIBBLES * 4));
 
-struct monad_db_snapshot_loader
+// Updates decoded from one shard, owned by the thread loading it
+struct monad_db_snapshot_shard_updates
 {
-    uint64_t block;
-    monad::OnDiskMachine machine;
-    monad::mpt::Db db;
-    std::array<monad::byte_string, 256> eth_headers;
     std::deque<monad::hash256> hash_alloc;
     std::deque<monad::mpt::Update> update_alloc;
-    std::array<
-        ankerl::unordered_dense::segmented_map<uint64_t, monad::mpt::Update>,
-        MONAD_SNAPSHOT_SHARDS>
+    ankerl::unordered_dense::segmented_map<uint64_t, monad::mpt::Update>
         account_offset_to_update;
     monad::mpt::UpdateList state_updates;
     monad::mpt::UpdateList code_updates;
-    uint64_t bytes_read;
+    uint64_t bytes_read{0};
+};
+
+struct monad_db_snapshot_loader
+{
+    uint64_t block;
+    monad::OnDiskMachine machine;
+    monad::mpt::Db db;
+    std::mutex upsert_mutex;
+    std::array<monad::byte_string, MONAD_SNAPSHOT_SHARDS> eth_headers;
 
     monad_db_snapshot_loader(
         uint64_t const block, char const *const *const dbname_paths,
@@ -67,7 +74,6 @@ struct monad_db_snapshot_loader
                          ? std::nullopt
                          : std::make_optional(sq_thread_cpu),
                  .dbname_paths = {dbname_paths, dbname_paths + len}}}
-        , bytes_read{0}
     {
     }
 };
@@ -85,7 +91,27 @@ uint64_t get_shard(monad::mpt::NibblesView const path)
     return ret;
 }
 
-void monad_db_snapshot_loader_flush(monad_db_snapshot_loader *const loader)
+// Whether any key under `prefix` falls in a shard of [begin, end)
+bool prefix_overlaps_shards(
+    monad::mpt::NibblesView const prefix, uint64_t const begin,
+    uint64_t const end)
+{
+    unsigned const n =
+        std::min<unsigned>(prefix.nibble_size(), MONAD_SNAPSHOT_SHARD_NIBBLES);
+    uint64_t first = 0;
+    for (unsigned i = 0; i < n; ++i) {
+        first <<= 4;
+        first |= prefix.get(i);
+    }
+    uint64_t const span = uint64_t{1}
+                          << ((MONAD_SNAPSHOT_SHARD_NIBBLES - n) * 4);
+    first *= span;
+    return first < end && begin < first + span;
+}
+
+void monad_db_snapshot_loader_flush(
+    monad_db_snapshot_loader *const loader,
+    monad_db_snapshot_shard_updates &shard_updates)
 {
     using namespace monad;
     using namespace monad::mpt;
@@ -94,13 +120,13 @@ void monad_db_snapshot_loader_flush(monad_db_snapshot_loader *const loader)
         .key = state_nibbles,
         .value = byte_string_view{},
         .incarnation = false,
-        .next = std::move(loader->state_updates),
+        .next = std::move(shard_updates.state_updates),
         .version = static_cast<int64_t>(loader->block)};
     Update code_update{
         .key = code_nibbles,
         .value = byte_string_view{},
         .incarnation = false,
-        .next = std::move(loader->code_updates),
+        .next = std::move(shard_updates.code_updates),
         .version = static_cast<int64_t>(loader->block)};
 
     UpdateList updates;
@@ -116,20 +142,22 @@ void monad_db_snapshot_loader_flush(monad_db_snapshot_loader *const loader)
         .version = static_cast<int64_t>(loader->block)};
     finalized_updates.push_front(finalized);
 
-    loader->db.upsert(
-        std::move(finalized_updates), loader->block, false, false);
-    loader->hash_alloc.clear();
-    loader->update_alloc.clear();
-    for (auto &map : loader->account_offset_to_update) {
-        map.clear();
+    {
+        std::lock_guard const lock{loader->upsert_mutex};
+        loader->db.upsert(
+            std::move(finalized_updates), loader->block, false, false);
     }
-    loader->state_updates.clear();
-    loader->code_updates.clear();
-    loader->bytes_read = 0;
+    shard_updates.hash_alloc.clear();
+    shard_updates.update_alloc.clear();
+    shard_updates.account_offset_to_update.clear();
+    shard_updates.state_updates.clear();
+    shard_updates.code_updates.clear();
+    shard_updates.bytes_read = 0;
 }
 
 uint64_t monad_db_snapshot_loader_read_account(
-    monad_db_snapshot_loader *const loader, uint64_t const shard,
+    monad_db_snapshot_loader *const loader,
+    monad_db_snapshot_shard_updates &shard_updates,
     uint64_t const account_offset, monad::byte_string_view const accounts)
 {
     using namespace monad;
@@ -142,17 +170,18 @@ uint64_t monad_db_snapshot_loader_read_account(
     MONAD_ASSERT(address.size() == sizeof(Address));
     uint64_t const bytes_consumed = before.size() - bytes.size();
     auto const [it, success] =
-        loader->account_offset_to_update.at(shard).emplace(
+        shard_updates.account_offset_to_update.emplace(
             account_offset,
             Update{
-                .key = loader->hash_alloc.emplace_back(keccak256(address)),
+                .key =
+                    shard_updates.hash_alloc.emplace_back(keccak256(address)),
                 .value = before.substr(0, bytes_consumed),
                 .incarnation = false,
                 .next = UpdateList{},
                 .version = static_cast<int64_t>(loader->block)});
     MONAD_ASSERT(success);
-    loader->state_updates.push_front(it->second);
-    loader->bytes_read += bytes_consumed;
+    shard_updates.state_updates.push_front(it->second);
+    shard_updates.bytes_read += bytes_consumed;
     return bytes_consumed;
 }
 
@@ -160,6 +189,9 @@ struct MonadSnapshotTraverseMachine : public monad::mpt::TraverseMachine
 {
     unsigned char nibble;
     monad::mpt::Nibbles path;
+    // only the shards in [shard_begin, shard_end) are visited
+    uint64_t shard_begin;
+    uint64_t shard_end;
     std::array<uint64_t, MONAD_SNAPSHOT_SHARDS> &account_bytes_written;
     uint64_t account_offset;
     uint64_t (*write)(
@@ -168,6 +200,7 @@ struct MonadSnapshotTraverseMachine : public monad::mpt::TraverseMachine
     void *user;
 
     MonadSnapshotTraverseMachine(
+        uint64_t const shard_begin, uint64_t const shard_end,
         std::array<uint64_t, MONAD_SNAPSHOT_SHARDS> &account_bytes_written,
         uint64_t (*write)(
             uint64_t shard, monad_snapshot_type, unsigned char const *bytes,
@@ -175,6 +208,8 @@ struct MonadSnapshotTraverseMachine : public monad::mpt::TraverseMachine
         void *user)
         : nibble{monad::mpt::INVALID_BRANCH}
         , path{}
+        , shard_begin{shard_begin}
+        , shard_end{shard_end}
         , account_bytes_written{account_bytes_written}
         , account_offset{std::numeric_limits<uint64_t>::max()}
         , write(write)
@@ -199,7 +234,12 @@ struct MonadSnapshotTraverseMachine : public monad::mpt::TraverseMachine
         }
         MONAD_ASSERT(nibble == STATE_NIBBLE || nibble == CODE_NIBBLE);
 
-        path = concat(NibblesView{path}, branch, node.path_nibble_view());
+        Nibbles next =
+            concat(NibblesView{path}, branch, node.path_nibble_view());
+        if (!prefix_overlaps_shards(next, shard_begin, shard_end)) {
+            return false;
+        }
+        path = std::move(next);
 
         if (!node.has_value()) {
             return true;
@@ -272,7 +312,13 @@ struct MonadSnapshotTraverseMachine : public monad::mpt::TraverseMachine
             MONAD_ASSERT(branch != INVALID_BRANCH);
             return branch == STATE_NIBBLE || branch == CODE_NIBBLE;
         }
-        return true;
+        if (path.nibble_size() >= MONAD_SNAPSHOT_SHARD_NIBBLES) {
+            return true;
+        }
+        return prefix_overlaps_shards(
+            concat(NibblesView{path}, branch),
+            shard_begin,
+            shard_end);
     }
 };
 
@@ -288,6 +334,7 @@ MONAD_ANONYMOUS_NAMESPACE_END
 bool monad_db_dump_snapshot(
     char const *const *const dbname_paths, size_t const len,
     unsigned const sq_thread_cpu, uint64_t const block,
+    unsigned const num_threads,
     uint64_t (*write)(
         uint64_t shard, monad_snapshot_type, unsigned char const *bytes,
         size_t len, void *user),
@@ -340,13 +387,39 @@ bool monad_db_dump_snapshot(
         return false;
     }
 
+    // Threads take one shard at a time and walk only the subtries under
+    // it, so every shard is written in trie order by a single thread. The
+    // top of the trie is read once per shard, which is cheap next to the
+    // shard itself.
+    MONAD_ASSERT(num_threads != 0);
     std::array<uint64_t, MONAD_SNAPSHOT_SHARDS> account_bytes_written{};
-    MonadSnapshotTraverseMachine machine{account_bytes_written, write, user};
-    bool const success = db.traverse(finalized_root, machine, block);
-    if (!success) {
-        LOG_INFO("db traverse for block {} unsuccessful", block);
+    std::atomic<uint64_t> next_shard{0};
+    std::atomic<bool> success{true};
+    auto const run = [&] {
+        for (uint64_t shard =
+                 next_shard.fetch_add(1, std::memory_order_relaxed);
+             shard < MONAD_SNAPSHOT_SHARDS &&
+             success.load(std::memory_order_relaxed);
+             shard = next_shard.fetch_add(1, std::memory_order_relaxed)) {
+            MonadSnapshotTraverseMachine machine{
+                shard, shard + 1, account_bytes_written, write, user};
+            if (!db.traverse_blocking(finalized_root, machine, block)) {
+                LOG_INFO(
+                    "db traverse of shard {} for block {} unsuccessful",
+                    shard,
+                    block);
+                success.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned i = 1; i < num_threads; ++i) {
+            threads.emplace_back(run);
+        }
+        run();
     }
-    return success;
+    return success.load(std::memory_order_relaxed);
 }
 
 monad_db_snapshot_loader *monad_db_snapshot_loader_create(
@@ -372,12 +445,14 @@ void monad_db_snapshot_loader_load(
     using namespace monad::mpt;
     constexpr size_t BYTES_READ_BEFORE_FLUSH = 10ull * 1024 * 1024 * 1024;
     MONAD_ASSERT(loader);
+    MONAD_ASSERT(shard < MONAD_SNAPSHOT_SHARDS);
+    monad_db_snapshot_shard_updates shard_updates;
     if (account) {
         for (uint64_t account_offset = 0; account_offset != account_len;) {
             account_offset += monad_db_snapshot_loader_read_account(
-                loader, shard, account_offset, {account, account_len});
-            if (loader->bytes_read >= BYTES_READ_BEFORE_FLUSH) {
-                monad_db_snapshot_loader_flush(loader);
+                loader, shard_updates, account_offset, {account, account_len});
+            if (shard_updates.bytes_read >= BYTES_READ_BEFORE_FLUSH) {
+                monad_db_snapshot_loader_flush(loader, shard_updates);
             }
             MONAD_ASSERT(account_offset <= account_len);
         }
@@ -386,14 +461,16 @@ void monad_db_snapshot_loader_load(
     if (storage) {
         MONAD_ASSERT(account);
         byte_string_view storage_view{storage, storage_len};
-        auto &account_offset_to_update =
-            loader->account_offset_to_update.at(shard);
+        auto &account_offset_to_update = shard_updates.account_offset_to_update;
         while (!storage_view.empty()) {
             uint64_t const account_offset =
                 unaligned_load<uint64_t>(storage_view.data());
             if (!account_offset_to_update.contains(account_offset)) {
                 monad_db_snapshot_loader_read_account(
-                    loader, shard, account_offset, {account, account_len});
+                    loader,
+                    shard_updates,
+                    account_offset,
+                    {account, account_len});
             }
             storage_view.remove_prefix(sizeof(account_offset));
             byte_string_view const before{storage_view};
@@ -401,15 +478,16 @@ void monad_db_snapshot_loader_load(
             MONAD_ASSERT(res.has_value());
             auto &update = account_offset_to_update.at(account_offset);
             uint64_t const consumed = before.size() - storage_view.size();
-            update.next.push_front(loader->update_alloc.emplace_back(Update{
-                .key = loader->hash_alloc.emplace_back(
-                    keccak256(to_bytes(res.value().first))),
-                .value = before.substr(0, consumed),
-                .next = UpdateList{},
-                .version = static_cast<int64_t>(loader->block)}));
-            loader->bytes_read += consumed;
-            if (loader->bytes_read >= BYTES_READ_BEFORE_FLUSH) {
-                monad_db_snapshot_loader_flush(loader);
+            update.next.push_front(
+                shard_updates.update_alloc.emplace_back(Update{
+                    .key = shard_updates.hash_alloc.emplace_back(
+                        keccak256(to_bytes(res.value().first))),
+                    .value = before.substr(0, consumed),
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(loader->block)}));
+            shard_updates.bytes_read += consumed;
+            if (shard_updates.bytes_read >= BYTES_READ_BEFORE_FLUSH) {
+                monad_db_snapshot_loader_flush(loader, shard_updates);
             }
         }
     }
@@ -422,17 +500,18 @@ void monad_db_snapshot_loader_load(
             code_view.remove_prefix(sizeof(uint64_t));
             MONAD_ASSERT(code_view.size() >= size);
             byte_string_view const val = code_view.substr(0, size);
-            loader->code_updates.push_front(
-                loader->update_alloc.emplace_back(Update{
-                    .key = loader->hash_alloc.emplace_back(keccak256(val)),
+            shard_updates.code_updates.push_front(
+                shard_updates.update_alloc.emplace_back(Update{
+                    .key = shard_updates.hash_alloc.emplace_back(
+                        keccak256(val)),
                     .value = val,
                     .incarnation = false,
                     .next = UpdateList{},
                     .version = static_cast<int64_t>(loader->block)}));
             code_view.remove_prefix(size);
-            loader->bytes_read += sizeof(uint64_t) + size;
-            if (loader->bytes_read >= BYTES_READ_BEFORE_FLUSH) {
-                monad_db_snapshot_loader_flush(loader);
+            shard_updates.bytes_read += sizeof(uint64_t) + size;
+            if (shard_updates.bytes_read >= BYTES_READ_BEFORE_FLUSH) {
+                monad_db_snapshot_loader_flush(loader, shard_updates);
             }
         }
     }
@@ -445,7 +524,7 @@ void monad_db_snapshot_loader_load(
         // stash to upsert versions last
         loader->eth_headers.at(shard).assign(eth_header, eth_header_len);
     }
-    monad_db_snapshot_loader_flush(loader);
+    monad_db_snapshot_loader_flush(loader, shard_updates);
 }
 
 void monad_db_snapshot_loader_destroy(monad_db_snapshot_loader *loader)
@@ -26,6 +26,10 @@ extern "C"
 
 struct monad_db_snapshot_loader;
 
+// Trie data is sharded by the first two nibbles of the hashed key, and eth
+// headers by their distance from the snapshot block
+#define MONAD_SNAPSHOT_SHARDS 256
+
 enum monad_snapshot_type
 {
     MONAD_SNAPSHOT_ETH_HEADER = 0,
@@ -34,9 +38,12 @@ enum monad_snapshot_type
     MONAD_SNAPSHOT_CODE
 };
 
+// Each of `num_threads` threads dumps whole shards, so `write` is called
+// concurrently for different shards but the bytes of any one shard arrive
+// in order from a single thread.
 bool monad_db_dump_snapshot(
     char const *const *dbname_paths, size_t len, unsigned sq_thread_cpu,
-    uint64_t block,
+    uint64_t block, unsigned num_threads,
     uint64_t (*write)(
         uint64_t shard, enum monad_snapshot_type, unsigned char const *bytes,
         size_t len, void *user),
@@ -46,6 +53,8 @@ struct monad_db_snapshot_loader *monad_db_snapshot_loader_create(
     uint64_t block, char const *const *dbname_paths, size_t len,
     unsigned sq_thread_cpu);
 
+// Safe to call concurrently for different shards. Decoding and hashing run
+// on the calling thread; only the upsert into the db is serialized.
 void monad_db_snapshot_loader_load(
     struct monad_db_snapshot_loader *loader, uint64_t shard,
     unsigned char const *eth_header, size_t, unsigned char const *account,
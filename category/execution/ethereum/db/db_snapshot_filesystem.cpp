@@ -21,15 +21,19 @@
 #include <category/execution/ethereum/core/fmt/bytes_fmt.hpp>
 #include <category/execution/ethereum/db/db_snapshot_filesystem.h>
 
-#include <ankerl/unordered_dense.h>
 #include <blake3.h>
 
+#include <array>
+#include <atomic>
 #include <fcntl.h>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <linux/mman.h>
+#include <memory>
 #include <sys/mman.h>
+#include <thread>
+#include <vector>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
@@ -47,7 +51,10 @@ MONAD_ANONYMOUS_NAMESPACE_END
 struct monad_db_snapshot_filesystem_write_user_context
 {
     std::filesystem::path root;
-    ankerl::unordered_dense::map<uint64_t, monad::SnapshotShard> shard;
+    // A fixed slot per shard, so that threads writing different shards
+    // never touch shared state
+    std::array<std::unique_ptr<monad::SnapshotShard>, MONAD_SNAPSHOT_SHARDS>
+        shard;
 
     explicit monad_db_snapshot_filesystem_write_user_context(
         std::filesystem::path const root)
@@ -72,8 +79,11 @@ monad_db_snapshot_filesystem_write_user_context_create(
 void monad_db_snapshot_filesystem_write_user_context_destroy(
     monad_db_snapshot_filesystem_write_user_context *context)
 {
-    for (auto &[_, stream] : context->shard) {
-        for (auto &shard : stream) {
+    for (auto &stream : context->shard) {
+        if (!stream) {
+            continue;
+        }
+        for (auto &shard : *stream) {
             monad::bytes32_t hash;
             blake3_hasher_finalize(&shard.hasher, hash.bytes, BLAKE3_OUT_LEN);
             shard.fchecksum << fmt::format("{}", hash);
@@ -89,16 +99,15 @@ uint64_t monad_db_snapshot_write_filesystem(
     auto *const context =
         reinterpret_cast<monad_db_snapshot_filesystem_write_user_context *>(
             user);
-    if (MONAD_UNLIKELY(!context->shard.contains(shard))) {
+    auto &slot = context->shard.at(shard);
+    if (MONAD_UNLIKELY(!slot)) {
         auto const shard_dir = context->root / std::to_string(shard);
         MONAD_ASSERT(std::filesystem::create_directory(shard_dir));
-        auto const [it, success] =
-            context->shard.emplace(shard, monad::SnapshotShard{});
-        MONAD_ASSERT(success);
+        slot = std::make_unique<monad::SnapshotShard>();
         constexpr std::array files = {
             "eth_header", "account", "storage", "code"};
-        for (size_t i = 0; i < it->second.size(); ++i) {
-            auto &[foutput, fchecksum, hasher] = it->second.at(i);
+        for (size_t i = 0; i < slot->size(); ++i) {
+            auto &[foutput, fchecksum, hasher] = slot->at(i);
             std::filesystem::path const output = shard_dir / files[i];
             foutput.open(output, std::ios::binary | std::ios::out);
             std::filesystem::path const checksum{
@@ -112,7 +121,7 @@ uint64_t monad_db_snapshot_write_filesystem(
         }
     }
 
-    auto &stream = context->shard.at(shard).at(type);
+    auto &stream = slot->at(type);
     auto const before = stream.foutput.tellp();
     stream.foutput.write(
         reinterpret_cast<char const *>(bytes),
@@ -125,7 +134,7 @@ uint64_t monad_db_snapshot_write_filesystem(
 void monad_db_snapshot_load_filesystem(
     char const *const *const dbname_paths, size_t const len,
     unsigned const sq_thread_cpu, char const *const snapshot_dir,
-    uint64_t const block)
+    uint64_t const block, unsigned const num_threads)
 {
     std::filesystem::path const root{std::format("{}/{}", snapshot_dir, block)};
     MONAD_ASSERT(std::filesystem::is_directory(root));
@@ -168,42 +177,63 @@ void monad_db_snapshot_load_filesystem(
             fd, reinterpret_cast<unsigned char const *>(data), size);
     };
 
+    std::vector<std::filesystem::path> shard_dirs;
     for (auto const &dir : std::filesystem::directory_iterator{root}) {
-        uint64_t const shard = std::stoull(dir.path().stem());
-        auto const [eth_header_fd, eth_header, eth_header_len] =
-            do_mmap(dir.path() / "eth_header");
-        auto const [account_fd, account, account_len] =
-            do_mmap(dir.path() / "account");
-        auto const [storage_fd, storage, storage_len] =
-            do_mmap(dir.path() / "storage");
-        auto const [code_fd, code, code_len] = do_mmap(dir.path() / "code");
-        monad_db_snapshot_loader_load(
-            loader,
-            shard,
-            eth_header,
-            eth_header_len,
-            account,
-            account_len,
-            storage,
-            storage_len,
-            code,
-            code_len);
-        if (eth_header) {
-            munmap((void *)eth_header, eth_header_len);
-        }
-        if (account) {
-            munmap((void *)account, account_len);
-        }
-        if (storage) {
-            munmap((void *)storage, storage_len);
+        shard_dirs.push_back(dir.path());
+    }
+
+    // Each thread verifies, decodes and hashes whole shards; the loader
+    // serializes their upserts
+    MONAD_ASSERT(num_threads != 0);
+    std::atomic<size_t> next_dir{0};
+    auto const run = [&] {
+        for (size_t i = next_dir.fetch_add(1, std::memory_order_relaxed);
+             i < shard_dirs.size();
+             i = next_dir.fetch_add(1, std::memory_order_relaxed)) {
+            auto const &dir = shard_dirs[i];
+            uint64_t const shard = std::stoull(dir.stem());
+            auto const [eth_header_fd, eth_header, eth_header_len] =
+                do_mmap(dir / "eth_header");
+            auto const [account_fd, account, account_len] =
+                do_mmap(dir / "account");
+            auto const [storage_fd, storage, storage_len] =
+                do_mmap(dir / "storage");
+            auto const [code_fd, code, code_len] = do_mmap(dir / "code");
+            monad_db_snapshot_loader_load(
+                loader,
+                shard,
+                eth_header,
+                eth_header_len,
+                account,
+                account_len,
+                storage,
+                storage_len,
+                code,
+                code_len);
+            if (eth_header) {
+                munmap((void *)eth_header, eth_header_len);
+            }
+            if (account) {
+                munmap((void *)account, account_len);
+            }
+            if (storage) {
+                munmap((void *)storage, storage_len);
+            }
+            if (code) {
+                munmap((void *)code, code_len);
+            }
+            close(eth_header_fd);
+            close(account_fd);
+            close(storage_fd);
+            close(code_fd);
         }
-        if (code) {
-            munmap((void *)code, code_len);
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned i = 1; i < num_threads && i < shard_dirs.size(); ++i) {
+            threads.emplace_back(run);
         }
-        close(eth_header_fd);
-        close(account_fd);
-        close(storage_fd);
-        close(code_fd);
+        run();
     }
 
     monad_db_snapshot_loader_destroy(loader);
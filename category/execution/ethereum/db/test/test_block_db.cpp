@@ -15,6 +15,7 @@
 
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/db/block_db.hpp>
+#include <category/execution/ethereum/db/block_readahead.hpp>
 
 #include <gtest/gtest.h>
 
@@ -106,3 +107,29 @@ TEST(BlockDb, DecompressBlock2397315)
     BlockDb const block_db_read(test_resource::correct_block_data_dir);
     EXPECT_TRUE(block_db_read.get(block_number, block));
 }
+
+TEST(BlockDb, ReadaheadMatchesGet)
+{
+    BlockDb const block_db(test_resource::correct_block_data_dir);
+    BlockReadahead readahead{block_db, 2'730'000, 2'730'002, 2};
+    for (uint64_t n = 2'730'000; n <= 2'730'002; ++n) {
+        Block expected;
+        ASSERT_TRUE(block_db.get(n, expected));
+        Block block;
+        ASSERT_TRUE(readahead.next(block));
+        EXPECT_EQ(block.header.number, n);
+        EXPECT_EQ(block.transactions.size(), expected.transactions.size());
+    }
+    // past the last block
+    Block block;
+    EXPECT_FALSE(readahead.next(block));
+}
+
+TEST(BlockDb, ReadaheadStopsAtMissingBlock)
+{
+    BlockDb const block_db(test_resource::correct_block_data_dir);
+    BlockReadahead readahead{block_db, 3, 100, 4};
+    Block block;
+    EXPECT_FALSE(readahead.next(block));
+    EXPECT_FALSE(readahead.next(block));
+}
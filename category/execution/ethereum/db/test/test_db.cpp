@@ -66,6 +66,7 @@
 #include <memory>
 #include <optional>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -315,6 +316,82 @@ TYPED_TEST(DBTest, read_storage)
         bytes32_t{});
 }
 
+TYPED_TEST(DBTest, stats)
+{
+    TrieDb tdb{this->db};
+    DbStats const begin = tdb.stats();
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{
+                 .account = {std::nullopt, Account{.nonce = 1}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+    EXPECT_TRUE(tdb.read_account(ADDR_A).has_value());
+    EXPECT_FALSE(tdb.read_account(ADDR_B).has_value());
+    EXPECT_EQ(tdb.read_storage(ADDR_A, Incarnation{0, 0}, key1), value1);
+
+    // printing the stats does not reset them
+    (void)tdb.print_stats();
+    DbStats const stats = tdb.stats() - begin;
+    EXPECT_EQ(stats.account_reads, 2u);
+    EXPECT_EQ(stats.storage_reads, 1u);
+    EXPECT_GT(stats.commit_upsert_time.count(), 0);
+    EXPECT_GE(stats.commit_state_time.count(), 0);
+    EXPECT_GE(stats.commit_block_data_time.count(), 0);
+}
+
+TYPED_TEST(DBTest, negative_lookups)
+{
+    constexpr auto ADDR_C = 0x0000000000000000000000000000000000000102_address;
+    {
+        TrieDb tdb{this->db};
+        commit_sequential(
+            tdb,
+            StateDeltas{
+                {ADDR_A,
+                 StateDelta{
+                     .account = {std::nullopt, Account{.nonce = 1}},
+                     .storage = {{key1, {bytes32_t{}, value1}}}}}},
+            Code{},
+            BlockHeader{});
+    }
+
+    // the filters of a new object are populated from the committed state
+    TrieDb tdb{this->db};
+    ASSERT_TRUE(tdb.enable_negative_lookups(1 << 12, 1 << 12));
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{
+                 .account = {Account{.nonce = 1}, Account{.nonce = 2}},
+                 .storage = {{key2, {bytes32_t{}, value2}}}}},
+            {ADDR_B,
+             StateDelta{.account = {std::nullopt, Account{.nonce = 1}}}}},
+        Code{},
+        BlockHeader{.number = 1});
+
+    DbStats const begin = tdb.stats();
+    EXPECT_EQ(tdb.read_account(ADDR_A).value().nonce, 2);
+    EXPECT_EQ(tdb.read_account(ADDR_B).value().nonce, 1);
+    EXPECT_EQ(tdb.read_storage(ADDR_A, Incarnation{0, 0}, key1), value1);
+    EXPECT_EQ(tdb.read_storage(ADDR_A, Incarnation{0, 0}, key2), value2);
+    DbStats const present = tdb.stats() - begin;
+    EXPECT_EQ(present.account_reads, 2u);
+    EXPECT_EQ(present.storage_reads, 2u);
+
+    // absent keys are answered without reaching the trie
+    EXPECT_FALSE(tdb.read_account(ADDR_C).has_value());
+    EXPECT_EQ(tdb.read_storage(ADDR_B, Incarnation{0, 0}, key1), bytes32_t{});
+    EXPECT_EQ(tdb.read_storage(ADDR_C, Incarnation{0, 0}, key2), bytes32_t{});
+    DbStats const absent = tdb.stats() - begin;
+    EXPECT_EQ(absent.account_reads, 2u);
+    EXPECT_EQ(absent.storage_reads, 2u);
+}
+
 TYPED_TEST(DBTest, read_code)
 {
     Account acct_a{.balance = 1, .code_hash = A_CODE_HASH, .nonce = 1};
@@ -337,6 +414,41 @@ TYPED_TEST(DBTest, read_code)
 
     auto const b_icode = tdb.read_code(B_CODE_HASH);
     EXPECT_EQ(byte_string_view(b_icode->code(), b_icode->size()), B_CODE);
+
+    EXPECT_EQ(tdb.read_code_size(A_CODE_HASH), A_CODE.size());
+    EXPECT_EQ(tdb.read_code_size(B_CODE_HASH), B_CODE.size());
+    EXPECT_EQ(tdb.read_code_size(C_CODE_HASH), 0u);
+}
+
+TEST(DBTest, machine_down_path)
+{
+    bytes32_t const block_id{0x1234};
+    bytes32_t const key{0x5678};
+    for (auto const &prefix :
+         {finalized_nibbles, proposal_prefix(block_id)}) {
+        auto const nibbles = mpt::concat(
+            mpt::NibblesView{prefix},
+            STATE_NIBBLE,
+            mpt::NibblesView{to_byte_string_view(key.bytes)});
+        mpt::NibblesView const path{nibbles};
+        OnDiskMachine stepped;
+        for (unsigned i = 0; i < path.nibble_size(); ++i) {
+            stepped.down(path.get(i));
+        }
+        OnDiskMachine jumped;
+        jumped.down_path(path);
+        EXPECT_EQ(jumped.depth, stepped.depth);
+        EXPECT_EQ(jumped.trie_section, stepped.trie_section);
+        EXPECT_EQ(jumped.table, stepped.table);
+        EXPECT_EQ(jumped.table, MachineBase::TableType::State);
+
+        // the rest of a path continues from where the last one stopped
+        OnDiskMachine split;
+        split.down_path(path.substr(0, 1));
+        split.down_path(path.substr(1));
+        EXPECT_EQ(split.depth, stepped.depth);
+        EXPECT_EQ(split.table, stepped.table);
+    }
 }
 
 TEST_F(OnDiskTrieDbFixture, get_proposal_block_ids)
@@ -389,6 +501,127 @@ TEST_F(OnDiskTrieDbFixture, get_proposal_block_ids)
     }
 }
 
+TEST_F(OnDiskTrieDbFixture, finalize_batch)
+{
+    TrieDb tdb{db};
+    load_header(db, BlockHeader{.number = 9});
+    tdb.set_block_and_prefix(9);
+
+    // a chain of proposals 10..12, each raising the balance of ADDR_A
+    std::vector<BlockFinalization> blocks;
+    std::optional<Account> prev;
+    for (uint64_t n = 10; n <= 12; ++n) {
+        Account const acct{.balance = n, .nonce = 1};
+        BlockHeader const header{.number = n};
+        bytes32_t const block_id{n};
+        tdb.commit(
+            StateDeltas{
+                {ADDR_A, StateDelta{.account = {prev, acct}, .storage = {}}}},
+            Code{},
+            block_id,
+            header);
+        tdb.set_block_and_prefix(n, block_id);
+        blocks.push_back({.block_number = n, .block_id = block_id});
+        prev = acct;
+    }
+
+    tdb.finalize_batch(blocks, 11);
+    EXPECT_EQ(db.get_latest_finalized_version(), 12);
+    EXPECT_EQ(db.get_latest_verified_version(), 11);
+    for (auto const &[n, block_id] : blocks) {
+        tdb.set_block_and_prefix(n);
+        auto const acct = tdb.read_account(ADDR_A);
+        ASSERT_TRUE(acct.has_value());
+        EXPECT_EQ(acct->balance, uint256_t{n});
+    }
+
+    // an empty batch still moves verification forward
+    tdb.finalize_batch({}, 12);
+    EXPECT_EQ(db.get_latest_finalized_version(), 12);
+    EXPECT_EQ(db.get_latest_verified_version(), 12);
+}
+
+TEST_F(OnDiskTrieDbFixture, log_index)
+{
+    using namespace evmc::literals;
+
+    constexpr auto topic1 =
+        0xf341246adaac6f497bc2a656f546ab9e182111d630394f0c57c710a59a2cb567_bytes32;
+    constexpr auto topic2 =
+        0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32;
+
+    uint64_t nonce = 0;
+    auto const commit_block = [&](TrieDb &tdb,
+                                  uint64_t const number,
+                                  std::vector<Receipt> const &receipts) {
+        std::vector<Transaction> transactions(receipts.size());
+        for (auto &tx : transactions) {
+            tx.nonce = nonce++;
+        }
+        commit_sequential(
+            tdb,
+            StateDeltas{},
+            Code{},
+            BlockHeader{.number = number},
+            receipts,
+            std::vector<std::vector<CallFrame>>(receipts.size()),
+            std::vector<Address>(receipts.size()),
+            transactions);
+    };
+
+    TrieDb tdb{db};
+    commit_block(tdb, 0, {});
+    commit_block(
+        tdb, 1, {Receipt{.logs = {{.topics = {topic1}, .address = ADDR_A}}}});
+    tdb.set_log_index(true);
+    commit_block(
+        tdb,
+        2,
+        {Receipt{.logs = {{.topics = {topic1}, .address = ADDR_A}}},
+         Receipt{},
+         Receipt{
+             .logs = {
+                 {.address = ADDR_A},
+                 {.address = ADDR_A},
+                 {.topics = {topic1, topic2}, .address = ADDR_B}}}});
+    commit_block(tdb, 3, {Receipt{.logs = {{.address = ADDR_B}}}});
+
+    auto const find = [&](uint64_t const first,
+                          uint64_t const last,
+                          byte_string const &key) {
+        return find_indexed_receipts(db, finalized_nibbles, first, last, key);
+    };
+    using Matches = std::vector<std::pair<uint64_t, uint32_t>>;
+    EXPECT_EQ(find(2, 3, log_index_key(ADDR_A)), (Matches{{2, 0}, {2, 2}}));
+    EXPECT_EQ(find(2, 3, log_index_key(ADDR_B)), (Matches{{2, 2}, {3, 0}}));
+    EXPECT_EQ(find(2, 3, log_index_key(topic1)), (Matches{{2, 0}, {2, 2}}));
+    EXPECT_EQ(find(3, 3, log_index_key(topic2)), Matches{});
+    EXPECT_EQ(find(2, 3, log_index_key(Address{})), Matches{});
+    // block 1 was committed without the index
+    EXPECT_FALSE(find(1, 3, log_index_key(ADDR_A)).has_value());
+
+    // block 4 inherits the section of block 3, which must not be mistaken
+    // for its own index
+    tdb.set_log_index(false);
+    commit_block(tdb, 4, {Receipt{.logs = {{.address = ADDR_A}}}});
+    EXPECT_FALSE(find(4, 4, log_index_key(ADDR_B)).has_value());
+    EXPECT_FALSE(find(2, 4, log_index_key(ADDR_A)).has_value());
+    EXPECT_EQ(find(2, 3, log_index_key(ADDR_B)), (Matches{{2, 2}, {3, 0}}));
+    tdb.set_log_index(true);
+    commit_block(tdb, 5, {Receipt{.logs = {{.address = ADDR_A}}}});
+    EXPECT_EQ(find(5, 5, log_index_key(ADDR_A)), (Matches{{5, 0}}));
+    EXPECT_EQ(find(5, 5, log_index_key(ADDR_B)), Matches{});
+
+    std::vector<uint32_t> const receipts{9, 17, 23, 1000};
+    auto const encoded = encode_log_index_db(receipts);
+    EXPECT_EQ(encoded.size(), size_t{1 + 1000 / 8 - 9 / 8 + 1});
+    byte_string_view view{encoded};
+    auto const decoded = decode_log_index_db(view);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded.value(), receipts);
+    EXPECT_TRUE(view.empty());
+}
+
 TYPED_TEST(DBTest, ModifyStorageOfAccount)
 {
     Account acct{.balance = 1'000'000, .code_hash = {}, .nonce = 1337};
@@ -421,6 +654,90 @@ TYPED_TEST(DBTest, ModifyStorageOfAccount)
         0x6303ffa4281cd596bc9fbfc21c28c1721ee64ec8e0f5753209eb8a13a739dae8_bytes32);
 }
 
+TEST(DBTest, parallel_commit_same_root)
+{
+    Account const acct{.balance = 1'000'000, .code_hash = {}, .nonce = 1337};
+    StateDeltas const deltas{
+        {ADDR_A,
+         StateDelta{
+             .account = {std::nullopt, acct},
+             .storage =
+                 {{key1, {bytes32_t{}, value1}},
+                  {key2, {bytes32_t{}, value2}}}}},
+        {ADDR_B,
+         StateDelta{
+             .account = {std::nullopt, acct},
+             .storage = {{key1, {bytes32_t{}, value2}}}}}};
+
+    InMemoryMachine machine;
+    mpt::Db db1{machine};
+    mpt::Db db2{machine};
+    TrieDb serial{db1};
+    TrieDb parallel{db2, 4};
+    commit_sequential(serial, deltas, Code{}, BlockHeader{.number = 0});
+    commit_sequential(parallel, deltas, Code{}, BlockHeader{.number = 0});
+
+    EXPECT_NE(parallel.state_root(), NULL_ROOT);
+    EXPECT_EQ(parallel.state_root(), serial.state_root());
+    EXPECT_EQ(parallel.read_storage(ADDR_B, Incarnation{0, 0}, key1), value2);
+}
+
+TEST(DBTest, parallel_commit_same_block_data)
+{
+    Account const acct{.balance = 1'000'000, .code_hash = {}, .nonce = 1337};
+    StateDeltas const deltas{
+        {ADDR_A,
+         StateDelta{
+             .account = {std::nullopt, acct},
+             .storage = {{key1, {bytes32_t{}, value1}}}}}};
+    std::vector<Receipt> const receipts{
+        Receipt{
+            .status = 1, .gas_used = 21'000, .type = TransactionType::legacy},
+        Receipt{
+            .status = 1, .gas_used = 42'000, .type = TransactionType::legacy}};
+    static constexpr auto r{
+        0x28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276_u256};
+    static constexpr auto s{
+        0x67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83_u256};
+    Transaction const t1{
+        .sc = {.r = r, .s = s},
+        .nonce = 9,
+        .max_fee_per_gas = 20'000'000'000,
+        .gas_limit = 21'000,
+        .value = 0xde0b6b3a7640000_u256};
+    Transaction t2 = t1;
+    t2.nonce = 10;
+    std::vector<Transaction> const transactions{t1, t2};
+    std::vector<Address> const senders = recover_senders(transactions);
+    std::vector<std::vector<CallFrame>> const call_frames(receipts.size());
+
+    InMemoryMachine machine;
+    mpt::Db db1{machine};
+    mpt::Db db2{machine};
+    TrieDb serial{db1};
+    TrieDb parallel{db2, 4};
+    for (TrieDb *const tdb : {&serial, &parallel}) {
+        commit_sequential(
+            *tdb,
+            deltas,
+            Code{},
+            BlockHeader{.number = 0},
+            receipts,
+            call_frames,
+            senders,
+            transactions);
+    }
+
+    // the block subtries are upserted after the state, at the same version
+    EXPECT_EQ(parallel.state_root(), serial.state_root());
+    EXPECT_NE(parallel.receipts_root(), NULL_ROOT);
+    EXPECT_EQ(parallel.receipts_root(), serial.receipts_root());
+    EXPECT_EQ(parallel.transactions_root(), serial.transactions_root());
+    EXPECT_EQ(
+        parallel.read_eth_header().transactions_root,
+        serial.transactions_root());
+}
+
 TYPED_TEST(DBTest, touch_without_modify_regression)
 {
     TrieDb tdb{this->db};
@@ -770,6 +1087,18 @@ TYPED_TEST(DBTest, to_json)
 
     // RWDb or in memory Db
     EXPECT_EQ(expected_payload, tdb.to_json());
+    {
+        // the streamed object lists accounts in key order
+        std::stringstream ss;
+        tdb.to_json(ss);
+        auto const streamed = nlohmann::ordered_json::parse(ss);
+        std::vector<std::string> keys;
+        for (auto const &[key, _] : streamed.items()) {
+            keys.push_back(key);
+        }
+        EXPECT_EQ(keys.size(), expected_payload.size());
+        EXPECT_TRUE(std::ranges::is_sorted(keys));
+    }
     if (this->on_disk) {
         // also test to_json from a read only db
         mpt::AsyncIOContext io_ctx{
@@ -1201,3 +1530,82 @@ TYPED_TEST(DBTest, call_frames_refund)
 
     EXPECT_EQ(actual_call_frames[0], expected);
 }
+
+TYPED_TEST(DBTest, parallel_reads_of_storage_written_back)
+{
+    // Every transaction increments the count in slot 0 of the contract and
+    // writes the new count to the slot of that number, so each one reads
+    // the slot that the one before it may still be writing back
+    auto const code = evmc::from_hex("0x60005460010180600055805500").value();
+    auto const code_hash = to_bytes(keccak256(code));
+    auto const counter = 0xc0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0_address;
+    constexpr uint64_t num_txns = 64;
+
+    TrieDb tdb{this->db};
+    StateDeltas deltas{
+        {counter,
+         StateDelta{
+             .account = {std::nullopt, Account{.code_hash = code_hash}}}}};
+    Block block{
+        .header = {
+            .number = 1,
+            .gas_limit = 30'000'000,
+            .beneficiary = 0xbebebebebebebebebebebebebebebebebebebebe_address,
+            .base_fee_per_gas = 1}};
+    std::vector<Address> senders;
+    for (uint64_t i = 0; i < num_txns; ++i) {
+        senders.emplace_back(0x1000 + i);
+        MONAD_ASSERT(deltas.emplace(
+            senders.back(),
+            StateDelta{
+                .account = {std::nullopt, Account{.balance = 1'000'000'000}}}));
+        block.transactions.push_back(Transaction{
+            .sc = {.r = 1, .s = 1, .chain_id = 1},
+            .max_fee_per_gas = 1,
+            .gas_limit = 100'000,
+            .to = counter});
+    }
+    commit_sequential(
+        tdb,
+        deltas,
+        Code{{code_hash, vm::make_shared_intercode(code)}},
+        BlockHeader{.number = 0});
+
+    std::vector<std::vector<std::optional<Address>>> const authorities(
+        num_txns);
+    BlockHashBufferFinalized block_hash_buffer;
+    block_hash_buffer.set(0, bytes32_t{});
+    fiber::PriorityPool pool{4, 16};
+
+    // the interleaving differs from run to run
+    for (unsigned run = 0; run < 50; ++run) {
+        BlockState bs{tdb, this->vm};
+        BlockMetrics metrics;
+        std::vector<std::unique_ptr<CallTracerBase>> call_tracers;
+        for (uint64_t i = 0; i < num_txns; ++i) {
+            call_tracers.emplace_back(std::make_unique<NoopCallTracer>());
+        }
+        auto const receipts = execute_block<EvmTraits<EVMC_SHANGHAI>>(
+            ShanghaiEthereumMainnet{},
+            block,
+            senders,
+            authorities,
+            bs,
+            block_hash_buffer,
+            pool,
+            metrics,
+            call_tracers);
+        ASSERT_FALSE(receipts.has_error());
+        for (auto const &receipt : receipts.value()) {
+            ASSERT_EQ(receipt.status, 1u);
+        }
+        EXPECT_EQ(
+            bs.read_storage(counter, Incarnation{0, 0}, bytes32_t{}),
+            bytes32_t{num_txns});
+        for (uint64_t i = 1; i <= num_txns; ++i) {
+            EXPECT_EQ(
+                bs.read_storage(counter, Incarnation{0, 0}, bytes32_t{i}),
+                bytes32_t{i});
+        }
+    }
+}
@@ -19,6 +19,10 @@
 #include <category/core/config.hpp>
 #include <category/core/keccak.h>
 #include <category/core/keccak.hpp>
+#include <category/core/mem/huge_slab.hpp>
+#include <category/core/rlp/encode.hpp>
+#include <category/core/synchronization/adaptive_lock.hpp>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/fmt/address_fmt.hpp> // NOLINT
@@ -57,16 +61,25 @@
 #include <quill/bundled/fmt/core.h>
 #include <quill/bundled/fmt/format.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <format>
 #include <limits>
+#include <map>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <span>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -77,12 +90,27 @@ using namespace monad::mpt;
 
 namespace
 {
-    byte_string
-    encode_receipt_db(Receipt const &receipt, size_t const log_index_begin)
+    // A receipt is stored as a string, followed by the index of its first
+    // log in the block
+    size_t receipt_db_length(
+        size_t const receipt_length, size_t const log_index_begin)
     {
-        return rlp::encode_list2(
-            rlp::encode_string2(rlp::encode_receipt(receipt)),
-            rlp::encode_unsigned(log_index_begin));
+        return rlp::list_length(
+            rlp::string_header_length(receipt_length) + receipt_length +
+            rlp::unsigned_length(log_index_begin));
+    }
+
+    std::span<unsigned char> encode_receipt_db(
+        std::span<unsigned char> d, Receipt const &receipt,
+        size_t const receipt_length, size_t const log_index_begin)
+    {
+        d = rlp::encode_list_header(
+            d,
+            rlp::string_header_length(receipt_length) + receipt_length +
+                rlp::unsigned_length(log_index_begin));
+        d = rlp::encode_string_header(d, receipt_length);
+        d = rlp::encode_receipt(d, receipt);
+        return rlp::encode_unsigned(d, log_index_begin);
     }
 
     byte_string encode_transaction_db(
@@ -91,13 +119,56 @@ namespace
         return rlp::encode_list2(
             rlp::encode_string2(encoded_tx), rlp::encode_address(sender));
     }
+
+    // per cache; about half a million entries each
+    constexpr size_t HASHED_KEY_CACHE_BYTES = size_t{64} << 20;
+
+    // Keys of the negative lookup filters. The hashes are keccak256, so any
+    // of their words is uniform; the storage key mixes in the address so
+    // that the same slot of different accounts are distinct keys.
+    uint64_t account_filter_key(hash256 const &address)
+    {
+        return address.word64s[0];
+    }
+
+    uint64_t storage_filter_key(hash256 const &address, hash256 const &slot)
+    {
+        return address.word64s[1] ^ slot.word64s[0];
+    }
+
+    // The update subtree of one account. The updates point into the keys and
+    // values held here, so it must stay in place until the upsert is done.
+    struct PreparedAccount
+    {
+        hash256 key{};
+        std::optional<byte_string> value{};
+        std::vector<hash256> storage_keys{};
+        std::vector<std::optional<byte_string>> storage_values{};
+        std::vector<Update> storage_updates{};
+        std::optional<Update> update{};
+    };
+
+    // The encoded receipt, transaction and call frames of one transaction
+    struct PreparedTransaction
+    {
+        byte_string_view receipt{};
+        hash256 hash{};
+        byte_string transaction{};
+        byte_string call_frames{};
+    };
 }
 
-TrieDb::TrieDb(mpt::Db &db)
+TrieDb::TrieDb(mpt::Db &db, unsigned const commit_concurrency)
     : db_{db}
     , block_number_{db.get_latest_finalized_version() == INVALID_BLOCK_NUM ? 0 : db.get_latest_finalized_version()}
     , proposal_block_id_{bytes32_t{}}
     , prefix_{finalized_nibbles}
+    , commit_arena_{
+          commit_concurrency > 1 ? std::make_unique<tbb::task_arena>(
+                                       static_cast<int>(commit_concurrency))
+                                 : nullptr}
+    , address_hashes_{HASHED_KEY_CACHE_BYTES}
+    , slot_hashes_{HASHED_KEY_CACHE_BYTES}
 {
 }
 
@@ -105,12 +176,14 @@ TrieDb::~TrieDb() = default;
 
 std::optional<Account> TrieDb::read_account(Address const &addr)
 {
+    auto const hash = hashed_address(addr);
+    if (filters_apply() &&
+        !account_filter_->may_contain(account_filter_key(hash))) {
+        stats_account_filtered();
+        return std::nullopt;
+    }
     auto const value = db_.get(
-        concat(
-            prefix_,
-            STATE_NIBBLE,
-            NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})}),
-        block_number_);
+        concat(prefix_, STATE_NIBBLE, NibblesView{hash}), block_number_);
     if (!value.has_value()) {
         stats_account_no_value();
         return std::nullopt;
@@ -126,12 +199,19 @@ std::optional<Account> TrieDb::read_account(Address const &addr)
 bytes32_t
 TrieDb::read_storage(Address const &addr, Incarnation, bytes32_t const &key)
 {
+    auto const address_hash = hashed_address(addr);
+    auto const slot_hash = hashed_slot(key);
+    if (filters_apply() && !storage_filter_->may_contain(
+                               storage_filter_key(address_hash, slot_hash))) {
+        stats_storage_filtered();
+        return {};
+    }
     auto const value = db_.get(
         concat(
             prefix_,
             STATE_NIBBLE,
-            NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})},
-            NibblesView{keccak256({key.bytes, sizeof(key.bytes)})}),
+            NibblesView{address_hash},
+            NibblesView{slot_hash}),
         block_number_);
     if (!value.has_value()) {
         stats_storage_no_value();
@@ -146,6 +226,11 @@ TrieDb::read_storage(Address const &addr, Incarnation, bytes32_t const &key)
 
 vm::SharedIntercode TrieDb::read_code(bytes32_t const &code_hash)
 {
+    if (code_store_ != nullptr) {
+        if (auto icode = code_store_->find(code_hash)) {
+            return icode;
+        }
+    }
     // TODO read intercode object
     auto const value = db_.get(
         concat(
@@ -156,7 +241,25 @@ vm::SharedIntercode TrieDb::read_code(bytes32_t const &code_hash)
     if (!value.has_value()) {
         return vm::make_shared_intercode({});
     }
-    return vm::make_shared_intercode(value.assume_value());
+    auto icode = vm::make_shared_intercode(value.assume_value());
+    if (code_store_ != nullptr) {
+        code_store_->insert(code_hash, *icode);
+    }
+    return icode;
+}
+
+size_t TrieDb::read_code_size(bytes32_t const &code_hash)
+{
+    auto const value = db_.get(
+        concat(
+            prefix_,
+            CODE_NIBBLE,
+            NibblesView{to_byte_string_view(code_hash.bytes)}),
+        block_number_);
+    if (!value.has_value()) {
+        return 0;
+    }
+    return value.assume_value().size();
 }
 
 void TrieDb::commit(
@@ -167,8 +270,15 @@ void TrieDb::commit(
     std::vector<Address> const &senders,
     std::vector<Transaction> const &transactions,
     std::vector<BlockHeader> const &ommers,
-    std::optional<std::vector<Withdrawal>> const &withdrawals)
+    std::optional<std::vector<Withdrawal>> const &withdrawals,
+    std::vector<bytes32_t> const &tx_hashes)
 {
+    static LatencyMetric &latency = latency_metric(
+        "monad_trie_db_commit_seconds",
+        "time to commit the state deltas and block data of a block");
+    ScopedLatency const timer{latency};
+    auto const commit_begin = std::chrono::steady_clock::now();
+
     MONAD_ASSERT(header.number <= std::numeric_limits<int64_t>::max());
 
     auto const parent_hash = [&]() {
@@ -197,44 +307,88 @@ void TrieDb::commit(
         prefix_ = dest_prefix;
     }
 
-    UpdateList account_updates;
-    for (auto const &[addr, delta] : state_deltas) {
-        UpdateList storage_updates;
-        std::optional<byte_string_view> value;
+    // The update subtree of each account, i.e. key hashing, value encoding
+    // and the updates themselves, is independent of the other accounts, so
+    // the subtrees are built ahead of the upsert, possibly in parallel. They
+    // are then linked in delta order, so the upsert sees the same input
+    // either way and only the linking is serial.
+    std::vector<StateDeltas::value_type const *> deltas;
+    deltas.reserve(state_deltas.size());
+    for (auto const &kv : state_deltas) {
+        deltas.push_back(&kv);
+    }
+    auto const version = static_cast<int64_t>(block_number_);
+    std::vector<PreparedAccount> prepared(deltas.size());
+    auto const prepare = [this, &deltas, &prepared, version](size_t const i) {
+        auto const &[addr, delta] = *deltas[i];
+        auto &out = prepared[i];
         auto const &account = delta.account.second;
         if (account.has_value()) {
+            std::vector<bytes32_t const *> slots;
             for (auto const &[key, delta] : delta.storage) {
                 if (delta.first != delta.second) {
-                    storage_updates.push_front(
-                        update_alloc_.emplace_back(Update{
-                            .key = hash_alloc_.emplace_back(
-                                keccak256({key.bytes, sizeof(key.bytes)})),
-                            .value = delta.second == bytes32_t{}
-                                         ? std::nullopt
-                                         : std::make_optional<byte_string_view>(
-                                               bytes_alloc_.emplace_back(
-                                                   encode_storage_db(
-                                                       key, delta.second))),
-                            .incarnation = false,
-                            .next = UpdateList{},
-                            .version = static_cast<int64_t>(block_number_)}));
+                    slots.push_back(&key);
+                    out.storage_values.emplace_back(
+                        delta.second == bytes32_t{}
+                            ? std::nullopt
+                            : std::make_optional(
+                                  encode_storage_db(key, delta.second)));
                 }
             }
-            value = bytes_alloc_.emplace_back(
-                encode_account_db(addr, account.value()));
+            out.storage_keys.resize(slots.size());
+            hash_slots(slots, out.storage_keys);
+            out.value = encode_account_db(addr, account.value());
         }
-
-        if (!storage_updates.empty() || delta.account.first != account) {
-            bool const incarnation =
+        if (out.storage_values.empty() && delta.account.first == account) {
+            return;
+        }
+        auto const view = [](byte_string const &v) {
+            return byte_string_view{v};
+        };
+        UpdateList storage_updates;
+        out.storage_updates.reserve(out.storage_values.size());
+        for (size_t j = 0; j < out.storage_values.size(); ++j) {
+            storage_updates.push_front(out.storage_updates.emplace_back(Update{
+                .key = out.storage_keys[j],
+                .value = out.storage_values[j].transform(view),
+                .incarnation = false,
+                .next = UpdateList{},
+                .version = version}));
+        }
+        out.key = hashed_address(addr);
+        if (account_filter_ != nullptr && account.has_value()) {
+            account_filter_->insert(account_filter_key(out.key));
+            for (size_t j = 0; j < out.storage_values.size(); ++j) {
+                if (out.storage_values[j].has_value()) {
+                    storage_filter_->insert(
+                        storage_filter_key(out.key, out.storage_keys[j]));
+                }
+            }
+        }
+        out.update.emplace(Update{
+            .key = out.key,
+            .value = out.value.transform(view),
+            .incarnation =
                 account.has_value() && delta.account.first.has_value() &&
-                delta.account.first->incarnation != account->incarnation;
-            account_updates.push_front(update_alloc_.emplace_back(Update{
-                .key = hash_alloc_.emplace_back(
-                    keccak256({addr.bytes, sizeof(addr.bytes)})),
-                .value = value,
-                .incarnation = incarnation,
-                .next = std::move(storage_updates),
-                .version = static_cast<int64_t>(block_number_)}));
+                delta.account.first->incarnation != account->incarnation,
+            .next = std::move(storage_updates),
+            .version = version});
+    };
+    if (commit_arena_ && deltas.size() > 1) {
+        commit_arena_->execute([&] {
+            tbb::parallel_for(size_t{0}, deltas.size(), prepare);
+        });
+    }
+    else {
+        for (size_t i = 0; i < deltas.size(); ++i) {
+            prepare(i);
+        }
+    }
+
+    UpdateList account_updates;
+    for (auto &account : prepared) {
+        if (account.update.has_value()) {
+            account_updates.push_front(account.update.value());
         }
     }
 
@@ -248,78 +402,242 @@ void TrieDb::commit(
             .incarnation = false,
             .next = UpdateList{},
             .version = static_cast<int64_t>(block_number_)}));
+        if (code_store_ != nullptr) {
+            code_store_->insert(hash, *icode);
+        }
     }
+    auto const state_end = std::chrono::steady_clock::now();
+    commit_state_time_ += state_end - commit_begin;
 
-    UpdateList receipt_updates;
-    UpdateList transaction_updates;
-    UpdateList tx_hash_updates;
-    UpdateList call_frame_updates;
     MONAD_ASSERT(receipts.size() == transactions.size());
     MONAD_ASSERT(transactions.size() == senders.size());
     MONAD_ASSERT(receipts.size() == call_frames.size());
+    MONAD_ASSERT(tx_hashes.empty() || tx_hashes.size() == transactions.size());
     MONAD_ASSERT(receipts.size() <= std::numeric_limits<uint32_t>::max());
     auto const &encoded_block_number =
         bytes_alloc_.emplace_back(rlp::encode_unsigned(header.number));
+    // The receipt, transaction, tx hash, call frame, log index, ommer and
+    // withdrawal subtries do not depend on the state. With commit threads,
+    // they are built on the commit arena while the state and code subtries
+    // are upserted, and are then upserted on their own at the same version.
+    // The build keeps its own allocations for that.
+    std::deque<Update> block_update_alloc;
+    std::deque<byte_string> block_bytes_alloc;
     std::vector<byte_string> index_alloc;
-    index_alloc.reserve(std::max(
-        receipts.size(),
-        withdrawals.transform(&std::vector<Withdrawal>::size).value_or(0)));
-    size_t log_index_begin = 0;
-    for (uint32_t i = 0; i < static_cast<uint32_t>(receipts.size()); ++i) {
-        auto const &rlp_index =
-            index_alloc.emplace_back(rlp::encode_unsigned(i));
-        auto const &receipt = receipts[i];
-        auto const &encoded_receipt = bytes_alloc_.emplace_back(
-            encode_receipt_db(receipt, log_index_begin));
-        log_index_begin += receipt.logs.size();
-        receipt_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{rlp_index},
-            .value = encoded_receipt,
-            .incarnation = false,
-            .next = UpdateList{},
-            .version = static_cast<int64_t>(block_number_)}));
+    std::vector<PreparedTransaction> prepared_txns(receipts.size());
+    auto const build_block_data = [&](UpdateList &updates) {
+        auto const build_begin = std::chrono::steady_clock::now();
+        UpdateList receipt_updates;
+        UpdateList transaction_updates;
+        UpdateList tx_hash_updates;
+        UpdateList call_frame_updates;
+        index_alloc.reserve(std::max(
+            receipts.size(),
+            withdrawals.transform(&std::vector<Withdrawal>::size)
+                .value_or(0)));
+        // The receipts of the block are sized first, so that each is encoded
+        // into its own place in a single buffer. Like the accounts above, the
+        // receipts, transactions and call frames are then encoded
+        // independently of each other, possibly in parallel, and only linked
+        // serially.
+        std::vector<size_t> receipt_lengths;
+        receipt_lengths.reserve(receipts.size());
+        std::vector<size_t> log_index_begins;
+        log_index_begins.reserve(receipts.size());
+        std::vector<size_t> receipt_offsets;
+        receipt_offsets.reserve(receipts.size() + 1);
+        size_t receipts_db_length = 0;
+        size_t log_index_begin = 0;
+        for (auto const &receipt : receipts) {
+            size_t const length = rlp::receipt_length(receipt);
+            receipt_lengths.push_back(length);
+            log_index_begins.push_back(log_index_begin);
+            receipt_offsets.push_back(receipts_db_length);
+            receipts_db_length += receipt_db_length(length, log_index_begin);
+            log_index_begin += receipt.logs.size();
+        }
+        receipt_offsets.push_back(receipts_db_length);
+        std::span<unsigned char> const receipts_buf{
+            block_bytes_alloc.emplace_back(receipts_db_length, 0)};
+        auto const prepare_txn = [&](size_t const i) {
+            auto &out = prepared_txns[i];
+            auto const buf = receipts_buf.subspan(
+                receipt_offsets[i],
+                receipt_offsets[i + 1] - receipt_offsets[i]);
+            auto const rest = encode_receipt_db(
+                buf, receipts[i], receipt_lengths[i], log_index_begins[i]);
+            MONAD_ASSERT(rest.empty());
+            out.receipt = byte_string_view{buf.data(), buf.size()};
+            auto const encoded_tx = rlp::encode_transaction(transactions[i]);
+            out.hash = tx_hashes.empty()
+                           ? keccak256(encoded_tx)
+                           : std::bit_cast<hash256>(tx_hashes[i]);
+            out.transaction = encode_transaction_db(encoded_tx, senders[i]);
+            out.call_frames = rlp::encode_call_frames(call_frames[i]);
+        };
+        if (commit_arena_ && receipts.size() > 1) {
+            commit_arena_->execute([&] {
+                tbb::parallel_for(size_t{0}, receipts.size(), prepare_txn);
+            });
+        }
+        else {
+            for (size_t i = 0; i < receipts.size(); ++i) {
+                prepare_txn(i);
+            }
+        }
+        for (uint32_t i = 0; i < static_cast<uint32_t>(receipts.size()); ++i) {
+            auto const &rlp_index =
+                index_alloc.emplace_back(rlp::encode_unsigned(i));
+            auto const &txn = prepared_txns[i];
+            receipt_updates.push_front(block_update_alloc.emplace_back(Update{
+                .key = NibblesView{rlp_index},
+                .value = txn.receipt,
+                .incarnation = false,
+                .next = UpdateList{},
+                .version = static_cast<int64_t>(block_number_)}));
+            transaction_updates.push_front(
+                block_update_alloc.emplace_back(Update{
+                    .key = NibblesView{rlp_index},
+                    .value = txn.transaction,
+                    .incarnation = false,
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(block_number_)}));
+            tx_hash_updates.push_front(block_update_alloc.emplace_back(Update{
+                .key = NibblesView{txn.hash},
+                .value = block_bytes_alloc.emplace_back(
+                    rlp::encode_list2(encoded_block_number, rlp_index)),
+                .incarnation = false,
+                .next = UpdateList{},
+                .version = static_cast<int64_t>(block_number_)}));
 
-        auto const encoded_tx = rlp::encode_transaction(transactions[i]);
-        transaction_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{rlp_index},
-            .value = bytes_alloc_.emplace_back(
-                encode_transaction_db(encoded_tx, senders[i])),
-            .incarnation = false,
+            // Call frames
+            byte_string_view frame_view{txn.call_frames};
+            uint8_t chunk_index = 0;
+            auto const call_frame_prefix =
+                serialize_as_big_endian<sizeof(uint32_t)>(i);
+            while (!frame_view.empty()) {
+                byte_string_view chunk =
+                    frame_view.substr(0, mpt::MAX_VALUE_LEN_OF_LEAF);
+                frame_view.remove_prefix(chunk.size());
+                byte_string const chunk_key =
+                    byte_string{&chunk_index, sizeof(uint8_t)};
+                call_frame_updates.push_front(
+                    block_update_alloc.emplace_back(Update{
+                        .key = block_bytes_alloc.emplace_back(
+                            call_frame_prefix + chunk_key),
+                        .value = chunk,
+                        .incarnation = false,
+                        .next = UpdateList{},
+                        .version = static_cast<int64_t>(block_number_)}));
+                ++chunk_index;
+            }
+        }
+
+        // Log index: the receipts of the block holding a log of each address
+        // and topic, so that log queries only read the receipts which match
+        UpdateList log_index_updates;
+        if (log_index_) {
+            std::map<byte_string, std::vector<uint32_t>> log_receipts;
+            for (uint32_t i = 0; i < static_cast<uint32_t>(receipts.size());
+                 ++i) {
+                auto const add = [&](byte_string key) {
+                    auto &matches = log_receipts[std::move(key)];
+                    if (matches.empty() || matches.back() != i) {
+                        matches.push_back(i);
+                    }
+                };
+                for (auto const &log : receipts[i].logs) {
+                    add(log_index_key(log.address));
+                    for (auto const &topic : log.topics) {
+                        add(log_index_key(topic));
+                    }
+                }
+            }
+            for (auto &[key, matches] : log_receipts) {
+                auto const &value = block_bytes_alloc.emplace_back(
+                    encode_log_index_db(matches));
+                MONAD_ASSERT(value.size() <= mpt::MAX_VALUE_LEN_OF_LEAF);
+                log_index_updates.push_front(
+                    block_update_alloc.emplace_back(Update{
+                        .key = block_bytes_alloc.emplace_back(std::move(key)),
+                        .value = value,
+                        .incarnation = false,
+                        .next = UpdateList{},
+                        .version = static_cast<int64_t>(block_number_)}));
+            }
+        }
+
+        updates.push_front(block_update_alloc.emplace_back(Update{
+            .key = receipt_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(receipt_updates),
+            .version = static_cast<int64_t>(block_number_)}));
+        updates.push_front(block_update_alloc.emplace_back(Update{
+            .key = call_frame_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(call_frame_updates),
+            .version = static_cast<int64_t>(block_number_)}));
+        updates.push_front(block_update_alloc.emplace_back(Update{
+            .key = transaction_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(transaction_updates),
+            .version = static_cast<int64_t>(block_number_)}));
+        updates.push_front(block_update_alloc.emplace_back(Update{
+            .key = ommer_nibbles,
+            .value =
+                block_bytes_alloc.emplace_back(rlp::encode_ommers(ommers)),
+            .incarnation = true,
             .next = UpdateList{},
             .version = static_cast<int64_t>(block_number_)}));
-        tx_hash_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{hash_alloc_.emplace_back(keccak256(encoded_tx))},
-            .value = bytes_alloc_.emplace_back(
-                rlp::encode_list2(encoded_block_number, rlp_index)),
+        updates.push_front(block_update_alloc.emplace_back(Update{
+            .key = tx_hash_nibbles,
+            .value = byte_string_view{},
             .incarnation = false,
-            .next = UpdateList{},
+            .next = std::move(tx_hash_updates),
             .version = static_cast<int64_t>(block_number_)}));
-
-        // Call frames
-        std::span<CallFrame const> frames{call_frames[i]};
-        byte_string_view frame_view =
-            bytes_alloc_.emplace_back(rlp::encode_call_frames(frames));
-        uint8_t chunk_index = 0;
-        auto const call_frame_prefix =
-            serialize_as_big_endian<sizeof(uint32_t)>(i);
-        while (!frame_view.empty()) {
-            byte_string_view chunk =
-                frame_view.substr(0, mpt::MAX_VALUE_LEN_OF_LEAF);
-            frame_view.remove_prefix(chunk.size());
-            byte_string const chunk_key =
-                byte_string{&chunk_index, sizeof(uint8_t)};
-            call_frame_updates.push_front(update_alloc_.emplace_back(Update{
-                .key = bytes_alloc_.emplace_back(call_frame_prefix + chunk_key),
-                .value = chunk,
-                .incarnation = false,
-                .next = UpdateList{},
+        if (log_index_) {
+            // The section is stamped with its block number. Once the index is
+            // turned off, later blocks inherit the last section written, and
+            // the stamp tells find_indexed_receipts that it is stale.
+            updates.push_front(block_update_alloc.emplace_back(Update{
+                .key = log_index_nibbles,
+                .value = block_bytes_alloc.emplace_back(
+                    rlp::encode_unsigned(block_number_)),
+                .incarnation = true,
+                .next = std::move(log_index_updates),
                 .version = static_cast<int64_t>(block_number_)}));
-            ++chunk_index;
         }
-    }
+        UpdateList withdrawal_updates;
+        if (withdrawals.has_value()) {
+            // only commit withdrawals when the optional has value
+            for (size_t i = 0; i < withdrawals.value().size(); ++i) {
+                if (i >= index_alloc.size()) {
+                    index_alloc.emplace_back(rlp::encode_unsigned(i));
+                }
+                withdrawal_updates.push_front(
+                    block_update_alloc.emplace_back(Update{
+                        .key = NibblesView{index_alloc[i]},
+                        .value = block_bytes_alloc.emplace_back(
+                            rlp::encode_withdrawal(withdrawals.value()[i])),
+                        .incarnation = false,
+                        .next = UpdateList{},
+                        .version = static_cast<int64_t>(block_number_)}));
+            }
+            updates.push_front(block_update_alloc.emplace_back(Update{
+                .key = withdrawal_nibbles,
+                .value = byte_string_view{},
+                .incarnation = true,
+                .next = std::move(withdrawal_updates),
+                .version = static_cast<int64_t>(block_number_)}));
+        }
+        commit_block_data_time_ +=
+            std::chrono::steady_clock::now() - build_begin;
+    };
 
     UpdateList updates;
-
     auto state_update = Update{
         .key = state_nibbles,
         .value = byte_string_view{},
@@ -332,75 +650,37 @@ void TrieDb::commit(
         .incarnation = false,
         .next = std::move(code_updates),
         .version = static_cast<int64_t>(block_number_)};
-    auto receipt_update = Update{
-        .key = receipt_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(receipt_updates),
-        .version = static_cast<int64_t>(block_number_)};
-    auto call_frame_update = Update{
-        .key = call_frame_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(call_frame_updates),
-        .version = static_cast<int64_t>(block_number_)};
-    auto transaction_update = Update{
-        .key = transaction_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(transaction_updates),
-        .version = static_cast<int64_t>(block_number_)};
-    auto ommer_update = Update{
-        .key = ommer_nibbles,
-        .value = bytes_alloc_.emplace_back(rlp::encode_ommers(ommers)),
-        .incarnation = true,
-        .next = UpdateList{},
-        .version = static_cast<int64_t>(block_number_)};
-    auto tx_hash_update = Update{
-        .key = tx_hash_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(tx_hash_updates),
-        .version = static_cast<int64_t>(block_number_)};
     updates.push_front(state_update);
     updates.push_front(code_update);
-    updates.push_front(receipt_update);
-    updates.push_front(call_frame_update);
-    updates.push_front(transaction_update);
-    updates.push_front(ommer_update);
-    updates.push_front(tx_hash_update);
-    UpdateList withdrawal_updates;
-    if (withdrawals.has_value()) {
-        // only commit withdrawals when the optional has value
-        for (size_t i = 0; i < withdrawals.value().size(); ++i) {
-            if (i >= index_alloc.size()) {
-                index_alloc.emplace_back(rlp::encode_unsigned(i));
-            }
-            withdrawal_updates.push_front(update_alloc_.emplace_back(Update{
-                .key = NibblesView{index_alloc[i]},
-                .value = bytes_alloc_.emplace_back(
-                    rlp::encode_withdrawal(withdrawals.value()[i])),
-                .incarnation = false,
-                .next = UpdateList{},
-                .version = static_cast<int64_t>(block_number_)}));
-        }
-        updates.push_front(update_alloc_.emplace_back(Update{
-            .key = withdrawal_nibbles,
+
+    auto const upsert = [this](UpdateList next, bool const enable_compaction) {
+        UpdateList ls;
+        auto prefix_update = Update{
+            .key = prefix_,
             .value = byte_string_view{},
-            .incarnation = true,
-            .next = std::move(withdrawal_updates),
-            .version = static_cast<int64_t>(block_number_)}));
+            .incarnation = false,
+            .next = std::move(next),
+            .version = static_cast<int64_t>(block_number_)};
+        ls.push_front(prefix_update);
+        db_.upsert(
+            std::move(ls), block_number_, enable_compaction, true, false);
+    };
+    UpdateList block_updates;
+    tbb::task_group block_data;
+    if (commit_arena_) {
+        commit_arena_->execute([&] {
+            block_data.run([&] { build_block_data(block_updates); });
+        });
+    }
+    else {
+        build_block_data(updates);
+    }
+    auto const upsert_begin = std::chrono::steady_clock::now();
+    upsert(std::move(updates), true);
+    if (commit_arena_) {
+        commit_arena_->execute([&] { block_data.wait(); });
+        upsert(std::move(block_updates), false);
     }
-
-    UpdateList ls;
-    ls.push_front(update_alloc_.emplace_back(Update{
-        .key = prefix_,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(updates),
-        .version = static_cast<int64_t>(block_number_)}));
-
-    db_.upsert(std::move(ls), block_number_, true, true, false);
 
     BlockHeader complete_header = header;
     if (MONAD_LIKELY(header.receipts_root == NULL_ROOT)) {
@@ -463,6 +743,7 @@ void TrieDb::commit(
     update_alloc_.clear();
     bytes_alloc_.clear();
     hash_alloc_.clear();
+    commit_upsert_time_ += std::chrono::steady_clock::now() - upsert_begin;
 }
 
 void TrieDb::set_block_and_prefix(
@@ -505,6 +786,60 @@ void TrieDb::finalize(uint64_t const block_number, bytes32_t const &block_id)
     db_.update_finalized_version(block_number);
 }
 
+void TrieDb::finalize_batch(
+    std::span<BlockFinalization const> const blocks,
+    std::optional<uint64_t> const verified_block)
+{
+    if (blocks.empty()) {
+        if (verified_block.has_value()) {
+            update_verified_block(*verified_block);
+        }
+        return;
+    }
+    auto const latest_finalized = db_.get_latest_finalized_version();
+    std::vector<mpt::Nibbles> src_prefixes;
+    src_prefixes.reserve(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto const &[block_number, block_id] = blocks[i];
+        auto const prev =
+            i == 0 ? latest_finalized : blocks[i - 1].block_number;
+        MONAD_ASSERT_PRINTF(
+            prev == INVALID_BLOCK_NUM || block_number == prev + 1,
+            "block_number %lu is not the next finalized block after %lu",
+            block_number,
+            prev);
+        MONAD_ASSERT(block_id != bytes32_t{});
+        src_prefixes.emplace_back(proposal_prefix(block_id));
+        if (db_.is_on_disk()) {
+            MONAD_ASSERT(
+                db_.find(src_prefixes.back(), block_number).has_value());
+        }
+    }
+    std::vector<mpt::Db::VersionTrieCopy> copies;
+    copies.reserve(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        copies.push_back(
+            {.version = blocks[i].block_number,
+             .src = src_prefixes[i],
+             .dest = finalized_nibbles});
+    }
+    db_.copy_tries(copies);
+
+    auto const last_finalized = blocks.back().block_number;
+    if (!verified_block.has_value()) {
+        db_.update_finalized_version(last_finalized);
+        return;
+    }
+    auto const latest_verified = db_.get_latest_verified_version();
+    MONAD_ASSERT_PRINTF(
+        latest_verified == INVALID_BLOCK_NUM ||
+            *verified_block > latest_verified,
+        "block_number %lu must be greater than last_verified %lu",
+        *verified_block,
+        latest_verified);
+    db_.update_finalized_and_verified_version(last_finalized, *verified_block);
+}
+
 void TrieDb::update_verified_block(uint64_t const block_number)
 {
     // no re-verification
@@ -552,6 +887,19 @@ std::optional<bytes32_t> TrieDb::withdrawals_root()
     return to_bytes(value.value());
 }
 
+bytes32_t TrieDb::storage_root(Address const &addr)
+{
+    // the data of an account node is the root of its storage subtrie
+    auto const value = db_.get_data(
+        concat(prefix_, STATE_NIBBLE, NibblesView{hashed_address(addr)}),
+        block_number_);
+    if (!value.has_value() || value.value().empty()) {
+        return NULL_ROOT;
+    }
+    MONAD_ASSERT(value.value().size() == sizeof(bytes32_t));
+    return to_bytes(value.value());
+}
+
 bytes32_t TrieDb::merkle_root(mpt::Nibbles const &nibbles)
 {
     auto const value =
@@ -577,43 +925,153 @@ BlockHeader TrieDb::read_eth_header()
     return std::move(decode_res.value());
 }
 
+hash256 TrieDb::hashed_address(Address const &addr)
+{
+    AddressHashCache::ConstAccessor acc{};
+    if (address_hashes_.find(acc, addr)) {
+        return acc->second.value_;
+    }
+    auto const hash = keccak256({addr.bytes, sizeof(addr.bytes)});
+    address_hashes_.insert(addr, hash);
+    return hash;
+}
+
+hash256 TrieDb::hashed_slot(bytes32_t const &key)
+{
+    SlotHashCache::ConstAccessor acc{};
+    if (slot_hashes_.find(acc, key)) {
+        return acc->second.value_;
+    }
+    auto const hash = keccak256({key.bytes, sizeof(key.bytes)});
+    slot_hashes_.insert(key, hash);
+    return hash;
+}
+
+// Cache misses are hashed as one batch, so they still take the multi-way
+// keccak path
+void TrieDb::hash_slots(
+    std::span<bytes32_t const *const> const keys, std::span<hash256> const out)
+{
+    MONAD_ASSERT(keys.size() == out.size());
+    std::vector<size_t> missing;
+    std::vector<byte_string_view> inputs;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        SlotHashCache::ConstAccessor acc{};
+        if (slot_hashes_.find(acc, *keys[i])) {
+            out[i] = acc->second.value_;
+            continue;
+        }
+        missing.push_back(i);
+        inputs.emplace_back(keys[i]->bytes, sizeof(keys[i]->bytes));
+    }
+    std::vector<hash256> hashes(inputs.size());
+    keccak256(inputs, hashes);
+    for (size_t j = 0; j < missing.size(); ++j) {
+        out[missing[j]] = hashes[j];
+        slot_hashes_.insert(*keys[missing[j]], hashes[j]);
+    }
+}
+
+// The lookups since the previous call
 std::string TrieDb::print_stats()
 {
+    uint64_t const account_no_value =
+        n_account_no_value_.load(std::memory_order_acquire);
+    uint64_t const account_value =
+        n_account_value_.load(std::memory_order_acquire);
+    uint64_t const storage_no_value =
+        n_storage_no_value_.load(std::memory_order_acquire);
+    uint64_t const storage_value =
+        n_storage_value_.load(std::memory_order_acquire);
+    uint64_t const account_filtered =
+        n_account_filtered_.load(std::memory_order_acquire);
+    uint64_t const storage_filtered =
+        n_storage_filtered_.load(std::memory_order_acquire);
     std::string ret;
     ret += std::format(
-        ",ae={:4},ane={:4},sz={:4},snz={:4}",
-        n_account_no_value_.load(std::memory_order_acquire),
-        n_account_value_.load(std::memory_order_acquire),
-        n_storage_no_value_.load(std::memory_order_acquire),
-        n_storage_value_.load(std::memory_order_acquire));
-    n_account_no_value_.store(0, std::memory_order_release);
-    n_account_value_.store(0, std::memory_order_release);
-    n_storage_no_value_.store(0, std::memory_order_release);
-    n_storage_value_.store(0, std::memory_order_release);
+        ",ae={:4},ane={:4},sz={:4},snz={:4},af={:4},sf={:4},ah={},sh={}",
+        account_no_value - printed_account_no_value_,
+        account_value - printed_account_value_,
+        storage_no_value - printed_storage_no_value_,
+        storage_value - printed_storage_value_,
+        account_filtered - printed_account_filtered_,
+        storage_filtered - printed_storage_filtered_,
+        address_hashes_.print_stats(),
+        slot_hashes_.print_stats());
+    ret += HugeSlabAllocator::instance().print_stats();
+    ret += LockStats::print_stats();
+    printed_account_no_value_ = account_no_value;
+    printed_account_value_ = account_value;
+    printed_storage_no_value_ = storage_no_value;
+    printed_storage_value_ = storage_value;
+    printed_account_filtered_ = account_filtered;
+    printed_storage_filtered_ = storage_filtered;
     return ret;
 }
 
-nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
+DbStats TrieDb::stats()
+{
+    return {
+        .account_reads = n_account_no_value_.load(std::memory_order_acquire) +
+                         n_account_value_.load(std::memory_order_acquire),
+        .storage_reads = n_storage_no_value_.load(std::memory_order_acquire) +
+                         n_storage_value_.load(std::memory_order_acquire),
+        .commit_state_time = commit_state_time_,
+        .commit_block_data_time = commit_block_data_time_,
+        .commit_upsert_time = commit_upsert_time_};
+}
+
+// Accounts are streamed one shard of the hashed address space at a time.
+// A shard is traversed (in parallel where the db allows it) into a sorted
+// map, written out and dropped, so memory is bounded by the largest shard
+// rather than the whole state, and accounts still come out in key order.
+void TrieDb::to_json(std::ostream &out, size_t const concurrency_limit)
 {
+    // one shard per leading byte of the hashed address
+    static constexpr unsigned SHARD_NIBBLES = 2;
+    static constexpr unsigned NUM_SHARDS = 1u << (SHARD_NIBBLES * 4);
+
+    using Accounts = std::map<std::string, nlohmann::json>;
+
     struct Traverse : public TraverseMachine
     {
         TrieDb &db;
-        nlohmann::json &json;
+        Accounts &accounts;
+        unsigned shard;
         Nibbles path{};
 
-        explicit Traverse(TrieDb &db, nlohmann::json &json)
+        explicit Traverse(TrieDb &db, Accounts &accounts, unsigned shard)
             : db(db)
-            , json(json)
+            , accounts(accounts)
+            , shard(shard)
         {
         }
 
+        bool in_shard(NibblesView const prefix) const
+        {
+            unsigned const n =
+                std::min<unsigned>(prefix.nibble_size(), SHARD_NIBBLES);
+            for (unsigned i = 0; i < n; ++i) {
+                unsigned const shift = (SHARD_NIBBLES - 1 - i) * 4;
+                if (prefix.get(i) != ((shard >> shift) & 0xf)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         virtual bool down(unsigned char const branch, Node const &node) override
         {
             if (branch == INVALID_BRANCH) {
                 MONAD_ASSERT(node.path_nibble_view().nibble_size() == 0);
                 return true;
             }
-            path = concat(NibblesView{path}, branch, node.path_nibble_view());
+            auto next =
+                concat(NibblesView{path}, branch, node.path_nibble_view());
+            if (!in_shard(next)) {
+                return false;
+            }
+            path = std::move(next);
 
             if (path.nibble_size() == (KECCAK256_SIZE * 2)) {
                 handle_account(node);
@@ -624,7 +1082,6 @@ nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
             }
             return true;
         }
-
         virtual void up(unsigned char const branch, Node const &node) override
         {
             auto const path_view = NibblesView{path};
@@ -654,20 +1111,18 @@ nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
             MONAD_DEBUG_ASSERT(!acct.has_error());
 
             auto const key = fmt::format("{}", NibblesView{path});
+            auto &json = accounts[key];
 
-            json[key]["address"] = fmt::format("{}", acct.value().first);
-            json[key]["balance"] =
-                fmt::format("{}", acct.value().second.balance);
-            json[key]["nonce"] =
-                fmt::format("0x{:x}", acct.value().second.nonce);
+            json["address"] = fmt::format("{}", acct.value().first);
+            json["balance"] = fmt::format("{}", acct.value().second.balance);
+            json["nonce"] = fmt::format("0x{:x}", acct.value().second.nonce);
 
             auto const icode = db.read_code(acct.value().second.code_hash);
             MONAD_ASSERT(icode);
-            json[key]["code"] =
-                "0x" + evmc::hex({icode->code(), icode->size()});
+            json["code"] = "0x" + evmc::hex({icode->code(), icode->size()});
 
-            if (!json[key].contains("storage")) {
-                json[key]["storage"] = nlohmann::json::object();
+            if (!json.contains("storage")) {
+                json["storage"] = nlohmann::json::object();
             }
         }
 
@@ -698,7 +1153,16 @@ nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
                 fmt::join(
                     std::as_bytes(std::span(storage.value().second.bytes)),
                     ""));
-            json[acct_key]["storage"][key] = storage_data_json;
+            accounts[acct_key]["storage"][key] = storage_data_json;
+        }
+
+        virtual bool
+        should_visit(Node const &, unsigned char const branch) override
+        {
+            if (path.nibble_size() >= SHARD_NIBBLES) {
+                return true;
+            }
+            return in_shard(concat(NibblesView{path}, branch));
         }
 
         virtual std::unique_ptr<TraverseMachine> clone() const override
@@ -707,26 +1171,47 @@ nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
         }
     };
 
-    auto json = nlohmann::json::object();
-    Traverse traverse(*this, json);
-
     auto res_cursor = db_.find(concat(prefix_, STATE_NIBBLE), block_number_);
     MONAD_ASSERT(res_cursor.has_value());
     MONAD_ASSERT(res_cursor.value().is_valid());
-    // RWOndisk Db prevents any parallel traversal that does blocking i/o
-    // from running on the triedb thread, which include to_json. Thus, we can
-    // only use blocking traversal for RWOnDisk Db, but can still do parallel
-    // traverse in other cases.
-    if (db_.is_on_disk() && !db_.is_read_only()) {
-        MONAD_ASSERT(
-            db_.traverse_blocking(res_cursor.value(), traverse, block_number_));
-    }
-    else {
-        MONAD_ASSERT(db_.traverse(
-            res_cursor.value(), traverse, block_number_, concurrency_limit));
+
+    Accounts accounts;
+    bool first = true;
+    out << '{';
+    for (unsigned shard = 0; shard < NUM_SHARDS; ++shard) {
+        Traverse traverse(*this, accounts, shard);
+        // RWOndisk Db prevents any parallel traversal that does blocking i/o
+        // from running on the triedb thread, which include to_json. Thus, we
+        // can only use blocking traversal for RWOnDisk Db, but can still do
+        // parallel traverse in other cases.
+        if (db_.is_on_disk() && !db_.is_read_only()) {
+            MONAD_ASSERT(db_.traverse_blocking(
+                res_cursor.value(), traverse, block_number_));
+        }
+        else {
+            MONAD_ASSERT(db_.traverse(
+                res_cursor.value(),
+                traverse,
+                block_number_,
+                concurrency_limit));
+        }
+        for (auto const &[key, account] : accounts) {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            out << nlohmann::json(key).dump() << ':' << account.dump();
+        }
+        accounts.clear();
     }
+    out << '}';
+}
 
-    return json;
+nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
+{
+    std::stringstream ss;
+    to_json(ss, concurrency_limit);
+    return nlohmann::json::parse(ss);
 }
 
 size_t TrieDb::prefetch_current_root()
@@ -734,6 +1219,114 @@ size_t TrieDb::prefetch_current_root()
     return db_.prefetch();
 }
 
+// The filters only lose keys that have been deleted, so from the state they
+// are populated from on, they hold every key of any version committed
+// through here. Populating from a proposal is refused, as a sibling of it
+// may be finalized instead, and so is a db with newer versions, which were
+// committed elsewhere. Reads of the populated version itself are left to
+// the trie, which keeps the condition on the version alone.
+bool TrieDb::enable_negative_lookups(
+    size_t const account_filter_bytes, size_t const storage_filter_bytes,
+    size_t const concurrency_limit)
+{
+    struct Traverse : public TraverseMachine
+    {
+        BlockedBloomFilter &accounts;
+        BlockedBloomFilter &storage;
+        Nibbles path{};
+
+        Traverse(BlockedBloomFilter &accounts, BlockedBloomFilter &storage)
+            : accounts(accounts)
+            , storage(storage)
+        {
+        }
+
+        hash256 key_at(unsigned const begin) const
+        {
+            NibblesView const view{path};
+            hash256 key;
+            for (unsigned i = 0; i < KECCAK256_SIZE; ++i) {
+                key.bytes[i] = static_cast<uint8_t>(
+                    (view.get(begin + 2 * i) << 4) |
+                    view.get(begin + 2 * i + 1));
+            }
+            return key;
+        }
+
+        virtual bool down(unsigned char const branch, Node const &node) override
+        {
+            if (branch == INVALID_BRANCH) {
+                MONAD_ASSERT(node.path_nibble_view().nibble_size() == 0);
+                return true;
+            }
+            path = concat(NibblesView{path}, branch, node.path_nibble_view());
+
+            if (path.nibble_size() == (KECCAK256_SIZE * 2)) {
+                accounts.insert(account_filter_key(key_at(0)));
+            }
+            else if (
+                path.nibble_size() == ((KECCAK256_SIZE + KECCAK256_SIZE) * 2)) {
+                storage.insert(storage_filter_key(
+                    key_at(0), key_at(KECCAK256_SIZE * 2)));
+            }
+            return true;
+        }
+
+        virtual void up(unsigned char const branch, Node const &node) override
+        {
+            auto const path_view = NibblesView{path};
+            auto const rem_size = [&] {
+                if (branch == INVALID_BRANCH) {
+                    MONAD_ASSERT(path_view.nibble_size() == 0);
+                    return 0;
+                }
+                int const rem_size = path_view.nibble_size() - 1 -
+                                     node.path_nibble_view().nibble_size();
+                MONAD_ASSERT(rem_size >= 0);
+                return rem_size;
+            }();
+            path = path_view.substr(0, static_cast<unsigned>(rem_size));
+        }
+
+        virtual std::unique_ptr<TraverseMachine> clone() const override
+        {
+            return std::make_unique<Traverse>(*this);
+        }
+    };
+
+    if (db_.is_read_only() || proposal_block_id_ != bytes32_t{}) {
+        return false;
+    }
+    // the in memory db has a single version, and an empty db none yet
+    uint64_t const latest = db_.get_latest_version();
+    bool const all_versions = !db_.is_on_disk() || latest == INVALID_BLOCK_NUM;
+    if (!all_versions && latest != block_number_) {
+        return false;
+    }
+
+    account_filter_ =
+        std::make_unique<BlockedBloomFilter>(account_filter_bytes);
+    storage_filter_ =
+        std::make_unique<BlockedBloomFilter>(storage_filter_bytes);
+    filter_begin_ = all_versions ? 0 : block_number_ + 1;
+
+    auto res_cursor = db_.find(concat(prefix_, STATE_NIBBLE), block_number_);
+    if (!res_cursor.has_value() || !res_cursor.value().is_valid()) {
+        return true;
+    }
+    Traverse traverse(*account_filter_, *storage_filter_);
+    // see to_json
+    if (db_.is_on_disk()) {
+        MONAD_ASSERT(db_.traverse_blocking(
+            res_cursor.value(), traverse, block_number_));
+    }
+    else {
+        MONAD_ASSERT(db_.traverse(
+            res_cursor.value(), traverse, block_number_, concurrency_limit));
+    }
+    return true;
+}
+
 uint64_t TrieDb::get_block_number() const
 {
     return block_number_;
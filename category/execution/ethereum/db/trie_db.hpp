@@ -15,9 +15,12 @@
 
 #pragma once
 
+#include <category/core/blocked_bloom_filter.hpp>
 #include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
 #include <category/core/config.hpp>
 #include <category/core/keccak.hpp>
+#include <category/core/lru/clock_cache.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
@@ -28,14 +31,21 @@
 #include <category/mpt/db.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
 #include <category/mpt/state_machine.hpp>
+#include <category/vm/shared_code_store.hpp>
 #include <category/vm/vm.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <istream>
 #include <memory>
 #include <optional>
+#include <ostream>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -51,15 +61,38 @@ class TrieDb final : public ::monad::Db
     // bytes32_t{} represent finalized
     bytes32_t proposal_block_id_;
     ::monad::mpt::Nibbles prefix_;
+    // hashes and encodes the updates in parallel when set, and builds the
+    // block subtries while the state subtries are upserted
+    std::unique_ptr<tbb::task_arena> commit_arena_;
+    // keccak256 of hot addresses and storage slots, which are read and
+    // committed again in most blocks
+    using AddressHashCache =
+        ClockCache<Address, hash256, BytesHashCompare<Address>>;
+    using SlotHashCache =
+        ClockCache<bytes32_t, hash256, BytesHashCompare<bytes32_t>>;
+    AddressHashCache address_hashes_;
+    SlotHashCache slot_hashes_;
+    vm::SharedCodeStore *code_store_{nullptr};
+    // hold every account and storage key which may be in the state from
+    // version `filter_begin_` on, when negative lookups are enabled
+    std::unique_ptr<BlockedBloomFilter> account_filter_;
+    std::unique_ptr<BlockedBloomFilter> storage_filter_;
+    uint64_t filter_begin_{0};
+    bool log_index_{false};
 
 public:
-    TrieDb(mpt::Db &);
+    // With a commit concurrency above one, commit hashes the keys and
+    // encodes the values of the updates on that many threads, and builds
+    // the block data subtries while the state upserts. The merkle hashing
+    // stays in the single threaded upserts of the mpt db.
+    TrieDb(mpt::Db &, unsigned commit_concurrency = 1);
     ~TrieDb();
 
     virtual std::optional<Account> read_account(Address const &) override;
     virtual bytes32_t
     read_storage(Address const &, Incarnation, bytes32_t const &key) override;
     virtual vm::SharedIntercode read_code(bytes32_t const &) override;
+    virtual size_t read_code_size(bytes32_t const &) override;
     virtual void set_block_and_prefix(
         uint64_t block_number,
         bytes32_t const &block_id = bytes32_t{}) override;
@@ -70,10 +103,15 @@ public:
         std::vector<Address> const & = {},
         std::vector<Transaction> const & = {},
         std::vector<BlockHeader> const &ommers = {},
-        std::optional<std::vector<Withdrawal>> const & = std::nullopt) override;
+        std::optional<std::vector<Withdrawal>> const & = std::nullopt,
+        std::vector<bytes32_t> const &tx_hashes = {}) override;
     virtual void
     finalize(uint64_t block_number, bytes32_t const &block_id) override;
     virtual void update_verified_block(uint64_t block_number) override;
+    // One trie copy request and one metadata write for the whole batch
+    virtual void finalize_batch(
+        std::span<BlockFinalization const>,
+        std::optional<uint64_t> verified_block) override;
     virtual void update_voted_metadata(
         uint64_t block_number, bytes32_t const &block_id) override;
 
@@ -82,19 +120,59 @@ public:
     virtual bytes32_t receipts_root() override;
     virtual bytes32_t transactions_root() override;
     virtual std::optional<bytes32_t> withdrawals_root() override;
+    // The root of the storage trie of the account, from the account's node
+    // alone, without reading any slot
+    bytes32_t storage_root(Address const &);
     virtual std::string print_stats() override;
+    virtual DbStats stats() override;
 
+    // Writes the state as one json object keyed by hashed address, in key
+    // order, holding only one shard of accounts in memory at a time
+    void to_json(std::ostream &, size_t concurrency_limit = 4096);
     nlohmann::json to_json(size_t concurrency_limit = 4096);
     size_t prefetch_current_root();
+    // Serve code reads from `store` first, and publish to it the code
+    // read from or committed to the trie, for other processes to share
+    void set_code_store(vm::SharedCodeStore *store)
+    {
+        code_store_ = store;
+    }
+    // Write with every block committed from now on the log index section,
+    // which maps each log address and topic to the receipts of the block
+    // holding it, for find_indexed_receipts()
+    void set_log_index(bool const enable)
+    {
+        log_index_ = enable;
+    }
+    // Answer reads of accounts and slots absent from the state without
+    // walking the trie, by filters of the keys in the current state kept up
+    // to date by commit. Fails unless every version newer than the current
+    // one will be committed through this object.
+    bool enable_negative_lookups(
+        size_t account_filter_bytes, size_t storage_filter_bytes,
+        size_t concurrency_limit = 4096);
     uint64_t get_block_number() const;
     uint64_t get_history_length() const;
 
 private:
-    /// STATS
+    /// STATS, since construction
     std::atomic<uint64_t> n_account_no_value_{0};
     std::atomic<uint64_t> n_account_value_{0};
     std::atomic<uint64_t> n_storage_no_value_{0};
     std::atomic<uint64_t> n_storage_value_{0};
+    std::atomic<uint64_t> n_account_filtered_{0};
+    std::atomic<uint64_t> n_storage_filtered_{0};
+    // only touched by the committing thread
+    std::chrono::nanoseconds commit_state_time_{0};
+    std::chrono::nanoseconds commit_block_data_time_{0};
+    std::chrono::nanoseconds commit_upsert_time_{0};
+    // the counters at the previous print_stats()
+    uint64_t printed_account_no_value_{0};
+    uint64_t printed_account_value_{0};
+    uint64_t printed_storage_no_value_{0};
+    uint64_t printed_storage_value_{0};
+    uint64_t printed_account_filtered_{0};
+    uint64_t printed_storage_filtered_{0};
 
     void stats_account_no_value()
     {
@@ -116,6 +194,25 @@ private:
         n_storage_value_.fetch_add(1, std::memory_order_release);
     }
 
+    void stats_account_filtered()
+    {
+        n_account_filtered_.fetch_add(1, std::memory_order_release);
+    }
+
+    void stats_storage_filtered()
+    {
+        n_storage_filtered_.fetch_add(1, std::memory_order_release);
+    }
+
+    bool filters_apply() const
+    {
+        return account_filter_ != nullptr && block_number_ >= filter_begin_;
+    }
+
+    hash256 hashed_address(Address const &);
+    hash256 hashed_slot(bytes32_t const &);
+    void hash_slots(std::span<bytes32_t const *const>, std::span<hash256>);
+
     bytes32_t merkle_root(mpt::Nibbles const &);
 };
 
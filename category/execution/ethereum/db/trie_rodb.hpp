@@ -15,31 +15,268 @@
 
 #pragma once
 
+#include <category/core/assert.h>
+#include <category/core/bytes_hash_compare.hpp>
 #include <category/core/config.hpp>
 #include <category/core/keccak.hpp>
+#include <category/core/lru/lru_cache.hpp>
+#include <category/core/monad_exception.hpp>
 #include <category/execution/ethereum/db/db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/mpt/db.hpp>
 #include <category/mpt/db_error.hpp>
+#include <category/vm/shared_code_store.hpp>
 #include <category/vm/vm.hpp>
 
 #include <evmc/hex.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
+// Account and storage reads shared by every TrieRODb that points at it. The
+// state of a block never changes once it is in the db, so entries are keyed
+// by the block they were read at and are never invalidated.
+//
+// Calls at the latest finalized block mostly read what the previous calls
+// read one block earlier. Given the delta of a finalized block, a miss at
+// that block is served from the entry of its parent when the block did not
+// change the account or slot, instead of going back to the db.
+class TrieRODbCache
+{
+public:
+    // What a finalized block changed relative to its parent. `accounts` holds
+    // every account whose balance, nonce, code or incarnation changed, the
+    // storage of those accounts is never carried over. `storage` holds every
+    // other slot whose value changed.
+    struct Delta
+    {
+        std::vector<Address> accounts;
+        std::vector<std::pair<Address, bytes32_t>> storage;
+
+        // From the packed arguments of
+        // monad_eth_call_executor_apply_finalized_delta(). Throws if a
+        // length is not a multiple of its entry size.
+        static Delta unpack(
+            uint8_t const *const addresses, size_t const addresses_len,
+            uint8_t const *const storage_keys, size_t const storage_keys_len)
+        {
+            constexpr size_t storage_key_size =
+                sizeof(Address) + sizeof(bytes32_t);
+            MONAD_ASSERT_THROW(
+                addresses_len % sizeof(Address) == 0,
+                "Finalized delta addresses are not whole addresses");
+            MONAD_ASSERT_THROW(
+                storage_keys_len % storage_key_size == 0,
+                "Finalized delta storage keys are not whole keys");
+
+            Delta delta;
+            delta.accounts.resize(addresses_len / sizeof(Address));
+            for (size_t i = 0; i < delta.accounts.size(); ++i) {
+                std::memcpy(
+                    delta.accounts[i].bytes,
+                    addresses + i * sizeof(Address),
+                    sizeof(Address));
+            }
+            delta.storage.resize(storage_keys_len / storage_key_size);
+            for (size_t i = 0; i < delta.storage.size(); ++i) {
+                auto &[addr, slot] = delta.storage[i];
+                uint8_t const *const entry =
+                    storage_keys + i * storage_key_size;
+                std::memcpy(addr.bytes, entry, sizeof(Address));
+                std::memcpy(
+                    slot.bytes, entry + sizeof(Address), sizeof(bytes32_t));
+            }
+            return delta;
+        }
+    };
+
+    // deltas of the most recent finalized blocks kept for carrying reads
+    static constexpr size_t MAX_DELTAS = 16;
+
+    struct Key
+    {
+        unsigned char bytes[sizeof(uint64_t) + sizeof(bytes32_t) +
+                            sizeof(Address) + sizeof(bytes32_t)];
+    };
+
+    using AccountCache =
+        LruCache<Key, std::optional<Account>, BytesHashCompare<Key>>;
+    using StorageCache = LruCache<Key, bytes32_t, BytesHashCompare<Key>>;
+
+    // rough footprint of an entry including hash map and lru bookkeeping
+    static constexpr size_t ACCOUNT_ENTRY_SIZE =
+        sizeof(Key) + sizeof(std::optional<Account>) + 96;
+    static constexpr size_t STORAGE_ENTRY_SIZE =
+        sizeof(Key) + sizeof(bytes32_t) + 96;
+
+    AccountCache accounts;
+    StorageCache storage;
+
+    // `max_bytes` is split evenly between accounts and storage
+    explicit TrieRODbCache(size_t const max_bytes)
+        : accounts{std::max<size_t>(1, max_bytes / 2 / ACCOUNT_ENTRY_SIZE)}
+        , storage{std::max<size_t>(1, max_bytes / 2 / STORAGE_ENTRY_SIZE)}
+    {
+    }
+
+    void apply_finalized_delta(uint64_t const block_number, Delta delta)
+    {
+        std::ranges::sort(delta.accounts);
+        std::ranges::sort(delta.storage);
+        auto ptr = std::make_shared<Delta const>(std::move(delta));
+        std::unique_lock const g{deltas_mutex_};
+        deltas_.emplace_back(block_number, std::move(ptr));
+        if (deltas_.size() > MAX_DELTAS) {
+            deltas_.pop_front();
+        }
+    }
+
+    // The account read at the parent of `block_number`, if the block is
+    // finalized and did not change it
+    std::optional<std::optional<Account>> find_unchanged_account(
+        uint64_t const block_number, bytes32_t const &block_id,
+        Address const &addr)
+    {
+        auto const delta = finalized_delta(block_number, block_id);
+        if (!delta || std::ranges::binary_search(delta->accounts, addr)) {
+            return std::nullopt;
+        }
+        AccountCache::ConstAccessor acc;
+        if (!accounts.find(acc, make_key(block_number - 1, block_id, addr))) {
+            return std::nullopt;
+        }
+        return acc->second.value_;
+    }
+
+    // The slot read at the parent of `block_number`, if the block is
+    // finalized and did not change it
+    std::optional<bytes32_t> find_unchanged_storage(
+        uint64_t const block_number, bytes32_t const &block_id,
+        Address const &addr, bytes32_t const &slot)
+    {
+        auto const delta = finalized_delta(block_number, block_id);
+        if (!delta || std::ranges::binary_search(delta->accounts, addr) ||
+            std::ranges::binary_search(
+                delta->storage, std::make_pair(addr, slot))) {
+            return std::nullopt;
+        }
+        StorageCache::ConstAccessor acc;
+        if (!storage.find(
+                acc, make_key(block_number - 1, block_id, addr, slot))) {
+            return std::nullopt;
+        }
+        return acc->second.value_;
+    }
+
+    static Key make_key(
+        uint64_t const block_number, bytes32_t const &block_id,
+        Address const &addr, bytes32_t const &slot = {})
+    {
+        Key key;
+        unsigned char *p = key.bytes;
+        std::memcpy(p, &block_number, sizeof(block_number));
+        p += sizeof(block_number);
+        std::memcpy(p, block_id.bytes, sizeof(block_id.bytes));
+        p += sizeof(block_id.bytes);
+        std::memcpy(p, addr.bytes, sizeof(addr.bytes));
+        p += sizeof(addr.bytes);
+        std::memcpy(p, slot.bytes, sizeof(slot.bytes));
+        return key;
+    }
+
+private:
+    std::mutex deltas_mutex_;
+    std::deque<std::pair<uint64_t, std::shared_ptr<Delta const>>> deltas_;
+
+    std::shared_ptr<Delta const>
+    finalized_delta(uint64_t const block_number, bytes32_t const &block_id)
+    {
+        if (block_id != bytes32_t{} || block_number == 0) {
+            return nullptr;
+        }
+        std::unique_lock const g{deltas_mutex_};
+        for (auto it = deltas_.rbegin(); it != deltas_.rend(); ++it) {
+            if (it->first == block_number) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+};
+
 class TrieRODb final : public ::monad::Db
 {
     ::monad::mpt::RODb &db_;
+    TrieRODbCache *cache_;
+    // code published by the execution process, checked before the trie
+    vm::SharedCodeStore const *code_store_;
     uint64_t block_number_;
+    bytes32_t block_id_;
     ::monad::mpt::OwningNodeCursor prefix_cursor_;
 
+    std::optional<Account> read_account_from_db(Address const &addr)
+    {
+        auto acc_leaf_res = db_.find(
+            prefix_cursor_,
+            mpt::concat(
+                STATE_NIBBLE,
+                mpt::NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})}),
+            block_number_);
+        if (!acc_leaf_res.has_value()) {
+            MONAD_ASSERT_THROW(
+                acc_leaf_res.assume_error() !=
+                    ::monad::mpt::DbError::version_no_longer_exist,
+                "Block was invalidated in db while execution was in progress");
+            return std::nullopt;
+        }
+        auto encoded_account = acc_leaf_res.value().node->value();
+        auto const acct = decode_account_db_ignore_address(encoded_account);
+        MONAD_DEBUG_ASSERT(!acct.has_error());
+        return acct.value();
+    }
+
+    bytes32_t read_storage_from_db(Address const &addr, bytes32_t const &key)
+    {
+        auto storage_leaf_res = db_.find(
+            prefix_cursor_,
+            mpt::concat(
+                STATE_NIBBLE,
+                mpt::NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})},
+                mpt::NibblesView{keccak256({key.bytes, sizeof(key.bytes)})}),
+            block_number_);
+        if (!storage_leaf_res.has_value()) {
+            MONAD_ASSERT_THROW(
+                storage_leaf_res.assume_error() !=
+                    ::monad::mpt::DbError::version_no_longer_exist,
+                "Block was invalidated in db while execution was in progress");
+            return {};
+        }
+        auto encoded_storage = storage_leaf_res.value().node->value();
+        auto const storage = decode_storage_db_ignore_slot(encoded_storage);
+        MONAD_ASSERT(!storage.has_error());
+        return to_bytes(storage.value());
+    }
+
 public:
-    TrieRODb(mpt::RODb &db)
+    TrieRODb(
+        mpt::RODb &db, TrieRODbCache *const cache = nullptr,
+        vm::SharedCodeStore const *const code_store = nullptr)
         : db_(db)
+        , cache_(cache)
+        , code_store_(code_store)
         , block_number_(mpt::INVALID_BLOCK_NUM)
+        , block_id_()
         , prefix_cursor_()
     {
     }
@@ -50,6 +287,10 @@ public:
         uint64_t const block_number,
         bytes32_t const &block_id = bytes32_t{}) override
     {
+        if (block_number == block_number_ && block_id == block_id_ &&
+            prefix_cursor_.is_valid()) {
+            return;
+        }
         auto const prefix = block_id == bytes32_t{} ? finalized_nibbles
                                                     : proposal_prefix(block_id);
         auto res = db_.find(prefix, block_number);
@@ -67,54 +308,118 @@ public:
         }
         prefix_cursor_ = res.value();
         block_number_ = block_number;
+        block_id_ = block_id;
+    }
+
+    // Takes over the block and prefix `other` already resolved, so readers
+    // of the same block look the prefix up once
+    void set_block_and_prefix(TrieRODb &other)
+    {
+        prefix_cursor_ = other.prefix_cursor_;
+        block_number_ = other.block_number_;
+        block_id_ = other.block_id_;
     }
 
     virtual std::optional<Account> read_account(Address const &addr) override
     {
-        auto acc_leaf_res = db_.find(
+        if (cache_ == nullptr) {
+            return read_account_from_db(addr);
+        }
+        auto const key =
+            TrieRODbCache::make_key(block_number_, block_id_, addr);
+        {
+            TrieRODbCache::AccountCache::ConstAccessor acc;
+            if (cache_->accounts.find(acc, key)) {
+                return acc->second.value_;
+            }
+        }
+        auto const carried =
+            cache_->find_unchanged_account(block_number_, block_id_, addr);
+        auto const account =
+            carried.has_value() ? *carried : read_account_from_db(addr);
+        cache_->accounts.insert(key, account);
+        return account;
+    }
+
+    // Reads the account into the shared cache without waiting on the db,
+    // then calls `done`, either from this thread or from the triedb thread,
+    // so a later read_account() finds it there. A block invalidated in the
+    // meantime is left to read_account() to report.
+    void prefetch_account(
+        Address const &addr, std::function<void()> done) const
+    {
+        if (cache_ == nullptr || !prefix_cursor_.is_valid()) {
+            done();
+            return;
+        }
+        auto const key =
+            TrieRODbCache::make_key(block_number_, block_id_, addr);
+        {
+            TrieRODbCache::AccountCache::ConstAccessor acc;
+            if (cache_->accounts.find(acc, key)) {
+                done();
+                return;
+            }
+        }
+        if (auto const carried = cache_->find_unchanged_account(
+                block_number_, block_id_, addr)) {
+            cache_->accounts.insert(key, *carried);
+            done();
+            return;
+        }
+        db_.find_async(
             prefix_cursor_,
             mpt::concat(
                 STATE_NIBBLE,
                 mpt::NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})}),
-            block_number_);
-        if (!acc_leaf_res.has_value()) {
-            MONAD_ASSERT_THROW(
-                acc_leaf_res.assume_error() !=
-                    ::monad::mpt::DbError::version_no_longer_exist,
-                "Block was invalidated in db while execution was in progress");
-            return std::nullopt;
-        }
-        auto encoded_account = acc_leaf_res.value().node->value();
-        auto const acct = decode_account_db_ignore_address(encoded_account);
-        MONAD_DEBUG_ASSERT(!acct.has_error());
-        return acct.value();
+            block_number_,
+            [cache = cache_, key, done = std::move(done)](
+                Result<mpt::OwningNodeCursor> res) {
+                if (res.has_value()) {
+                    auto encoded_account = res.value().node->value();
+                    auto const acct =
+                        decode_account_db_ignore_address(encoded_account);
+                    MONAD_DEBUG_ASSERT(!acct.has_error());
+                    cache->accounts.insert(key, acct.value());
+                }
+                else if (
+                    res.assume_error() !=
+                    ::monad::mpt::DbError::version_no_longer_exist) {
+                    cache->accounts.insert(key, std::nullopt);
+                }
+                done();
+            });
     }
 
     virtual bytes32_t read_storage(
         Address const &addr, Incarnation, bytes32_t const &key) override
     {
-        auto storage_leaf_res = db_.find(
-            prefix_cursor_,
-            mpt::concat(
-                STATE_NIBBLE,
-                mpt::NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})},
-                mpt::NibblesView{keccak256({key.bytes, sizeof(key.bytes)})}),
-            block_number_);
-        if (!storage_leaf_res.has_value()) {
-            MONAD_ASSERT_THROW(
-                storage_leaf_res.assume_error() !=
-                    ::monad::mpt::DbError::version_no_longer_exist,
-                "Block was invalidated in db while execution was in progress");
-            return {};
+        if (cache_ == nullptr) {
+            return read_storage_from_db(addr, key);
         }
-        auto encoded_storage = storage_leaf_res.value().node->value();
-        auto const storage = decode_storage_db_ignore_slot(encoded_storage);
-        MONAD_ASSERT(!storage.has_error());
-        return to_bytes(storage.value());
+        auto const cache_key =
+            TrieRODbCache::make_key(block_number_, block_id_, addr, key);
+        {
+            TrieRODbCache::StorageCache::ConstAccessor acc;
+            if (cache_->storage.find(acc, cache_key)) {
+                return acc->second.value_;
+            }
+        }
+        auto const carried = cache_->find_unchanged_storage(
+            block_number_, block_id_, addr, key);
+        auto const value =
+            carried.has_value() ? *carried : read_storage_from_db(addr, key);
+        cache_->storage.insert(cache_key, value);
+        return value;
     }
 
     virtual vm::SharedIntercode read_code(bytes32_t const &code_hash) override
     {
+        if (code_store_ != nullptr) {
+            if (auto icode = code_store_->find(code_hash)) {
+                return icode;
+            }
+        }
         // TODO read intercode object
         auto code_leaf_res = db_.find(
             prefix_cursor_,
@@ -139,7 +444,8 @@ public:
         std::vector<Address> const & = {},
         std::vector<Transaction> const & = {},
         std::vector<BlockHeader> const & = {},
-        std::optional<std::vector<Withdrawal>> const & = std::nullopt) override
+        std::optional<std::vector<Withdrawal>> const & = std::nullopt,
+        std::vector<bytes32_t> const & = {}) override
     {
         MONAD_ABORT();
     }
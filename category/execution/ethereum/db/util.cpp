@@ -43,13 +43,12 @@
 #include <category/mpt/ondisk_db_config.hpp>
 #include <category/mpt/state_machine.hpp>
 #include <category/mpt/traverse.hpp>
+#include <category/mpt/trie.hpp>
 #include <category/mpt/update.hpp>
 #include <category/mpt/util.hpp>
 
 #include <boost/outcome/try.hpp>
 
-#include <nlohmann/json_fwd.hpp>
-
 #include <quill/Quill.h> // NOLINT
 #include <quill/detail/LogMacros.h>
 
@@ -58,13 +57,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <istream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -96,11 +96,11 @@ namespace
         static constexpr uint64_t CHUNK_SIZE = 1ul << 13; // 8 kb
 
         ::monad::mpt::Db &db_;
-        std::deque<mpt::Update> update_alloc_;
-        std::deque<byte_string> bytes_alloc_;
         size_t buf_size_;
         std::unique_ptr<unsigned char[]> buf_;
         uint64_t block_id_;
+        Nibbles const state_prefix_{concat(FINALIZED_NIBBLE, STATE_NIBBLE)};
+        Nibbles const code_prefix_{concat(FINALIZED_NIBBLE, CODE_NIBBLE)};
 
     public:
         BinaryDbLoader(
@@ -113,69 +113,45 @@ namespace
             MONAD_ASSERT(buf_size >= CHUNK_SIZE);
         };
 
+        // Checkpoints list accounts and their storage sorted by hashed key,
+        // so the whole trie is built bottom up in a single pass instead of
+        // being upserted one buffer at a time. Code is listed in no
+        // particular order, so it is gathered and sorted by hash first.
         void load(std::istream &accounts, std::istream &code)
         {
-            load(
-                accounts,
-                [&](byte_string_view in, UpdateList &updates) {
-                    return parse_accounts(in, updates);
-                },
-                [&](UpdateList account_updates) {
-                    UpdateList updates;
-                    auto state_update = Update{
-                        .key = state_nibbles,
-                        .value = byte_string_view{},
-                        .incarnation = false,
-                        .next = std::move(account_updates),
-                        .version = static_cast<int64_t>(block_id_)};
-                    updates.push_front(state_update);
-
-                    UpdateList finalized_updates;
-                    Update finalized{
-                        .key = finalized_nibbles,
-                        .value = byte_string_view{},
-                        .incarnation = false,
-                        .next = std::move(updates),
-                        .version = static_cast<int64_t>(block_id_),
-                    };
-                    finalized_updates.push_front(finalized);
-                    db_.upsert(
-                        std::move(finalized_updates), block_id_, false, false);
-                    db_.update_finalized_version(block_id_);
-
-                    update_alloc_.clear();
-                    bytes_alloc_.clear();
-                });
-            load(
-                code,
-                [&](byte_string_view in, UpdateList &updates) {
-                    return parse_code(in, updates);
+            static_assert(STATE_NIBBLE < CODE_NIBBLE);
+            std::vector<std::pair<bytes32_t, byte_string>> code_entries;
+            load(code, [&](byte_string_view const in) {
+                return parse_code(in, code_entries);
+            });
+            // the same code may be listed more than once
+            auto const by_hash = &std::pair<bytes32_t, byte_string>::first;
+            std::ranges::sort(code_entries, {}, by_hash);
+            auto const duplicates =
+                std::ranges::unique(code_entries, {}, by_hash);
+            code_entries.erase(duplicates.begin(), duplicates.end());
+            db_.build_sorted(
+                block_id_,
+                [&](SortedTrieBuilder &builder) {
+                    auto const version = static_cast<int64_t>(block_id_);
+                    builder.add(finalized_nibbles, byte_string_view{}, version);
+                    builder.add(state_prefix_, byte_string_view{}, version);
+                    load(accounts, [&](byte_string_view const in) {
+                        return parse_accounts(in, builder);
+                    });
+                    builder.add(code_prefix_, byte_string_view{}, version);
+                    for (auto const &[code_hash, icode] : code_entries) {
+                        builder.add(
+                            concat(
+                                NibblesView{code_prefix_},
+                                NibblesView{
+                                    to_byte_string_view(code_hash.bytes)}),
+                            icode,
+                            version);
+                    }
                 },
-                [&](UpdateList code_updates) {
-                    UpdateList updates;
-                    auto code_update = Update{
-                        .key = code_nibbles,
-                        .value = byte_string_view{},
-                        .incarnation = false,
-                        .next = std::move(code_updates),
-                        .version = static_cast<int64_t>(block_id_)};
-                    updates.push_front(code_update);
-
-                    UpdateList finalized_updates;
-                    Update finalized{
-                        .key = finalized_nibbles,
-                        .value = byte_string_view{},
-                        .incarnation = false,
-                        .next = std::move(updates),
-                        .version = static_cast<int64_t>(block_id_),
-                    };
-                    finalized_updates.push_front(finalized);
-                    db_.upsert(
-                        std::move(finalized_updates), block_id_, false, false);
-
-                    update_alloc_.clear();
-                    bytes_alloc_.clear();
-                });
+                false /* can_write_to_fast */);
+            db_.update_finalized_version(block_id_);
         }
 
     private:
@@ -184,52 +160,44 @@ namespace
 
         void load(
             std::istream &input,
-            std::function<size_t(byte_string_view, UpdateList &)> fparse,
-            std::function<void(UpdateList)> fwrite)
+            std::function<size_t(byte_string_view)> const &fparse)
         {
-            UpdateList updates;
             size_t total_processed = 0;
             size_t total_read = 0;
             while (input.read((char *)buf_.get() + total_read, CHUNK_SIZE)) {
                 auto const count = static_cast<size_t>(input.gcount());
                 MONAD_ASSERT(count <= CHUNK_SIZE);
                 total_read += count;
-                total_processed += fparse(
-                    byte_string_view{
-                        buf_.get() + total_processed,
-                        total_read - total_processed},
-                    updates);
+                total_processed += fparse(byte_string_view{
+                    buf_.get() + total_processed,
+                    total_read - total_processed});
                 if (MONAD_UNLIKELY((total_read + CHUNK_SIZE) > buf_size_)) {
-                    fwrite(std::move(updates));
                     std::memmove(
                         buf_.get(),
                         buf_.get() + total_processed,
                         total_read - total_processed);
                     total_read -= total_processed;
                     total_processed = 0;
-                    updates.clear();
                 }
             }
 
             auto const count = static_cast<size_t>(input.gcount());
             MONAD_ASSERT(count <= CHUNK_SIZE);
             total_read += count;
-            total_processed += fparse(
-                byte_string_view{
-                    buf_.get() + total_processed, total_read - total_processed},
-                updates);
+            total_processed += fparse(byte_string_view{
+                buf_.get() + total_processed, total_read - total_processed});
             MONAD_ASSERT(total_processed == total_read);
             MONAD_ASSERT(input.eof());
-
-            fwrite(std::move(updates));
         }
 
-        size_t parse_accounts(byte_string_view in, UpdateList &account_updates)
+        size_t
+        parse_accounts(byte_string_view in, SortedTrieBuilder &builder) const
         {
             constexpr auto account_fixed_size =
                 sizeof(bytes32_t) + sizeof(uint256_t) + sizeof(uint64_t) +
                 sizeof(bytes32_t) + sizeof(uint64_t);
             static_assert(account_fixed_size == 112);
+            auto const version = static_cast<int64_t>(block_id_);
             size_t total_processed = 0;
             while (in.size() >= account_fixed_size) {
                 constexpr auto num_storage_offset =
@@ -242,19 +210,39 @@ namespace
                 if (in.size() < entry_size) {
                     return total_processed;
                 }
-                auto &update = update_alloc_.emplace_back(handle_account(in));
-                if (num_storage) {
-                    update.next = handle_storage(
-                        in.substr(account_fixed_size, storage_size));
+                NibblesView const key{in.substr(0, sizeof(bytes32_t))};
+                builder.add(
+                    concat(NibblesView{state_prefix_}, key),
+                    encode_account(in),
+                    version);
+                for (auto storage = in.substr(account_fixed_size, storage_size);
+                     !storage.empty();
+                     storage = storage.substr(storage_entry_size)) {
+                    builder.add(
+                        concat(
+                            NibblesView{state_prefix_},
+                            key,
+                            NibblesView{storage.substr(0, sizeof(bytes32_t))}),
+                        encode_storage_db(
+                            bytes32_t{}, // TODO: update this when binary
+                                         // checkpoint includes unhashed
+                                         // storage slot
+                            unaligned_load<bytes32_t>(
+                                storage
+                                    .substr(
+                                        sizeof(bytes32_t), sizeof(bytes32_t))
+                                    .data())),
+                        version);
                 }
-                account_updates.push_front(update);
                 total_processed += entry_size;
                 in = in.substr(entry_size);
             }
             return total_processed;
         }
 
-        size_t parse_code(byte_string_view in, UpdateList &code_updates)
+        size_t parse_code(
+            byte_string_view in,
+            std::vector<std::pair<bytes32_t, byte_string>> &entries) const
         {
             constexpr auto hash_and_len_size =
                 sizeof(bytes32_t) + sizeof(uint64_t);
@@ -268,12 +256,9 @@ namespace
                 if (in.size() < entry_size) {
                     return total_processed;
                 }
-                code_updates.push_front(update_alloc_.emplace_back(Update{
-                    .key = in.substr(0, sizeof(bytes32_t)),
-                    .value = in.substr(hash_and_len_size, code_len),
-                    .incarnation = false,
-                    .next = UpdateList{},
-                    .version = static_cast<int64_t>(block_id_)}));
+                entries.emplace_back(
+                    to_bytes(in.substr(0, sizeof(bytes32_t))),
+                    in.substr(hash_and_len_size, code_len));
 
                 total_processed += entry_size;
                 in = in.substr(entry_size);
@@ -281,50 +266,23 @@ namespace
             return total_processed;
         }
 
-        Update handle_account(byte_string_view curr)
+        static byte_string encode_account(byte_string_view curr)
         {
             constexpr auto balance_offset = sizeof(bytes32_t);
             constexpr auto nonce_offset = balance_offset + sizeof(uint256_t);
             constexpr auto code_hash_offset = nonce_offset + sizeof(uint64_t);
 
-            return Update{
-                .key = curr.substr(0, sizeof(bytes32_t)),
-                .value = bytes_alloc_.emplace_back(encode_account_db(
-                    Address{}, // TODO: Update this when binary checkpoint
-                               // includes unhashed address
-                    Account{
-                        .balance = unaligned_load<uint256_t>(
-                            curr.substr(balance_offset, sizeof(uint256_t))
-                                .data()),
-                        .code_hash = unaligned_load<bytes32_t>(
-                            curr.substr(code_hash_offset, sizeof(bytes32_t))
-                                .data()),
-                        .nonce = unaligned_load<uint64_t>(
-                            curr.substr(nonce_offset, sizeof(uint64_t))
-                                .data())})),
-                .incarnation = false,
-                .next = UpdateList{},
-                .version = static_cast<int64_t>(block_id_)};
-        }
-
-        UpdateList handle_storage(byte_string_view in)
-        {
-            UpdateList storage_updates;
-            while (!in.empty()) {
-                storage_updates.push_front(update_alloc_.emplace_back(Update{
-                    .key = in.substr(0, sizeof(bytes32_t)),
-                    .value = bytes_alloc_.emplace_back(encode_storage_db(
-                        bytes32_t{}, // TODO: update this when binary checkpoint
-                                     // includes unhashed storage slot
-                        unaligned_load<bytes32_t>(
-                            in.substr(sizeof(bytes32_t), sizeof(bytes32_t))
-                                .data()))),
-                    .incarnation = false,
-                    .next = UpdateList{},
-                    .version = static_cast<int64_t>(block_id_)}));
-                in = in.substr(storage_entry_size);
-            }
-            return storage_updates;
+            return encode_account_db(
+                Address{}, // TODO: Update this when binary checkpoint
+                           // includes unhashed address
+                Account{
+                    .balance = unaligned_load<uint256_t>(
+                        curr.substr(balance_offset, sizeof(uint256_t)).data()),
+                    .code_hash = unaligned_load<bytes32_t>(
+                        curr.substr(code_hash_offset, sizeof(bytes32_t))
+                            .data()),
+                    .nonce = unaligned_load<uint64_t>(
+                        curr.substr(nonce_offset, sizeof(uint64_t)).data())});
         }
     };
 
@@ -406,12 +364,10 @@ namespace
 
     struct StorageRootMerkleCompute : public StorageMerkleCompute
     {
-        virtual unsigned
-        compute(unsigned char *const buffer, Node *const node) override
+        virtual byte_string node_rlp(Node *const node) override
         {
             MONAD_ASSERT(node->has_value());
-            return encode_two_pieces(
-                buffer,
+            return encode_two_pieces_rlp(
                 node->path_nibble_view(),
                 ComputeAccountLeaf::compute(*node),
                 true);
@@ -420,9 +376,9 @@ namespace
 
     struct AccountRootMerkleCompute : public AccountMerkleCompute
     {
-        virtual unsigned compute(unsigned char *const, Node *const) override
+        virtual byte_string node_rlp(Node *const) override
         {
-            return 0;
+            return {};
         }
     };
 
@@ -525,7 +481,8 @@ bool MachineBase::is_variable_length() const
 {
     return depth > prefix_len() &&
            (table == TableType::Transaction || table == TableType::Receipt ||
-            table == TableType::Withdrawal || table == TableType::CallFrame);
+            table == TableType::Withdrawal || table == TableType::CallFrame ||
+            table == TableType::LogIndex);
 }
 
 void MachineBase::down(unsigned char const nibble)
@@ -551,7 +508,8 @@ void MachineBase::down(unsigned char const nibble)
          nibble == RECEIPT_NIBBLE || nibble == CALL_FRAME_NIBBLE ||
          nibble == TRANSACTION_NIBBLE || nibble == BLOCKHEADER_NIBBLE ||
          nibble == WITHDRAWAL_NIBBLE || nibble == OMMER_NIBBLE ||
-         nibble == TX_HASH_NIBBLE || nibble == BLOCK_HASH_NIBBLE) ||
+         nibble == TX_HASH_NIBBLE || nibble == BLOCK_HASH_NIBBLE ||
+         nibble == LOG_INDEX_NIBBLE) ||
         depth != prefix_length);
     if (MONAD_UNLIKELY(depth == prefix_length)) {
         MONAD_ASSERT(table == TableType::Prefix);
@@ -585,12 +543,29 @@ void MachineBase::down(unsigned char const nibble)
         else if (nibble == CALL_FRAME_NIBBLE) {
             table = TableType::CallFrame;
         }
+        else if (nibble == LOG_INDEX_NIBBLE) {
+            table = TableType::LogIndex;
+        }
         else {
             MONAD_ABORT_PRINTF("Invalid nibble %u", (unsigned)nibble);
         }
     }
 }
 
+void MachineBase::down_path(mpt::NibblesView const path)
+{
+    unsigned i = 0;
+    // only the nibbles up to the table pick the section and the table
+    for (; i < path.nibble_size() &&
+           (trie_section == TrieType::Undefined || depth < prefix_len());
+         ++i) {
+        MachineBase::down(path.get(i));
+    }
+    unsigned const rest = path.nibble_size() - i;
+    MONAD_ASSERT(depth + rest <= max_depth(prefix_len()));
+    depth = static_cast<uint8_t>(depth + rest);
+}
+
 void MachineBase::up(size_t const n)
 {
     MONAD_ASSERT(n <= depth);
@@ -669,6 +644,61 @@ decode_transaction_db(byte_string_view &enc)
     return {transaction, sender};
 }
 
+byte_string log_index_key(Address const &address)
+{
+    byte_string key{LOG_INDEX_ADDRESS};
+    key.append(address.bytes, sizeof(address.bytes));
+    return key;
+}
+
+byte_string log_index_key(bytes32_t const &topic)
+{
+    byte_string key{LOG_INDEX_TOPIC};
+    key.append(topic.bytes, sizeof(topic.bytes));
+    return key;
+}
+
+byte_string encode_log_index_db(std::span<uint32_t const> const receipts)
+{
+    MONAD_ASSERT(!receipts.empty());
+    MONAD_ASSERT(std::ranges::is_sorted(receipts));
+    uint32_t const first_byte = receipts.front() / 8;
+    size_t const bitmap_length = receipts.back() / 8 - first_byte + 1;
+    byte_string encoded = rlp::encode_unsigned(first_byte);
+    size_t const bitmap_begin = encoded.size();
+    encoded.resize(bitmap_begin + bitmap_length, 0);
+    for (uint32_t const i : receipts) {
+        encoded[bitmap_begin + i / 8 - first_byte] |=
+            static_cast<unsigned char>(1u << (i % 8));
+    }
+    return encoded;
+}
+
+Result<std::vector<uint32_t>> decode_log_index_db(byte_string_view &enc)
+{
+    BOOST_OUTCOME_TRY(
+        auto const first_byte, rlp::decode_unsigned<uint32_t>(enc));
+    if (MONAD_UNLIKELY(enc.empty())) {
+        return rlp::DecodeError::InputTooShort;
+    }
+    if (MONAD_UNLIKELY(
+            first_byte + enc.size() >
+            (size_t{std::numeric_limits<uint32_t>::max()} >> 3) + 1)) {
+        return rlp::DecodeError::Overflow;
+    }
+    std::vector<uint32_t> receipts;
+    for (size_t i = 0; i < enc.size(); ++i) {
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            if (enc[i] & (1u << bit)) {
+                receipts.push_back(
+                    static_cast<uint32_t>((first_byte + i) * 8 + bit));
+            }
+        }
+    }
+    enc = {};
+    return receipts;
+}
+
 byte_string encode_account_db(Address const &address, Account const &account)
 {
     byte_string encoded_account;
@@ -743,8 +773,8 @@ Result<byte_string_view> decode_storage_db_ignore_slot(byte_string_view &enc)
 };
 
 void write_to_file(
-    nlohmann::json const &j, std::filesystem::path const &root_path,
-    uint64_t const block_number)
+    std::function<void(std::ostream &)> const &write,
+    std::filesystem::path const &root_path, uint64_t const block_number)
 {
     [[maybe_unused]] auto const start_time = std::chrono::steady_clock::now();
 
@@ -755,7 +785,8 @@ void write_to_file(
     auto const file = dir / "state.json";
     MONAD_ASSERT(!std::filesystem::exists(file));
     std::ofstream ofile(file);
-    ofile << j.dump(4);
+    write(ofile);
+    MONAD_ASSERT(ofile.flush());
 
     LOG_INFO(
         "Finished dumping to json file at block = {}, time elapsed = {}",
@@ -899,6 +930,45 @@ std::optional<BlockHeader> read_eth_header(
     return decoded.value();
 }
 
+std::optional<std::vector<std::pair<uint64_t, uint32_t>>>
+find_indexed_receipts(
+    mpt::Db const &db, mpt::NibblesView const prefix, uint64_t const first,
+    uint64_t const last, byte_string_view const key)
+{
+    MONAD_ASSERT(last < std::numeric_limits<uint64_t>::max());
+    Nibbles const section = mpt::concat(prefix, LOG_INDEX_NIBBLE);
+    std::vector<std::pair<uint64_t, uint32_t>> matches;
+    for (uint64_t block = first; block <= last; ++block) {
+        auto const index = db.find(section, block);
+        if (MONAD_UNLIKELY(
+                !index.has_value() || !index.value().node->has_value())) {
+            return std::nullopt;
+        }
+        // a section inherited from an older block was not written with this
+        // one, as the index has since been turned off
+        byte_string_view stamp{index.value().node->value()};
+        auto const written = rlp::decode_unsigned<uint64_t>(stamp);
+        if (MONAD_UNLIKELY(!written.has_value() || written.value() != block)) {
+            return std::nullopt;
+        }
+        auto const receipts = db.find(index.value(), NibblesView{key}, block);
+        if (!receipts.has_value()) {
+            if (MONAD_UNLIKELY(
+                    receipts.error() == DbError::version_no_longer_exist)) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        byte_string_view view{receipts.value().node->value()};
+        auto const decoded = decode_log_index_db(view);
+        MONAD_ASSERT(!decoded.has_error());
+        for (uint32_t const i : decoded.value()) {
+            matches.emplace_back(block, i);
+        }
+    }
+    return matches;
+}
+
 bool for_each_code(
     mpt::Db &db, uint64_t const block,
     std::function<void(bytes32_t const &, byte_string_view)> const fn)
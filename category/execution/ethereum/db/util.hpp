@@ -29,6 +29,11 @@
 #include <filesystem>
 #include <functional>
 #include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <utility>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -65,6 +70,7 @@ struct MachineBase : public mpt::StateMachine
         BlockHeader,
         Ommer,
         CallFrame,
+        LogIndex,
     };
 
     uint8_t depth{0};
@@ -74,6 +80,7 @@ struct MachineBase : public mpt::StateMachine
     virtual mpt::Compute &get_compute() const override;
     virtual void down(unsigned char const nibble) override;
     virtual void up(size_t const n) override;
+    virtual void down_path(mpt::NibblesView const path) override;
     virtual bool is_variable_length() const override;
     constexpr uint8_t prefix_len() const;
 
@@ -93,7 +100,7 @@ struct InMemoryMachine final : public MachineBase
     virtual std::unique_ptr<StateMachine> clone() const override;
 };
 
-struct OnDiskMachine : public MachineBase
+struct OnDiskMachine final : public MachineBase
 {
     virtual bool cache() const override;
     virtual bool compact() const override;
@@ -114,6 +121,7 @@ inline constexpr unsigned char OMMER_NIBBLE = 6;
 inline constexpr unsigned char TX_HASH_NIBBLE = 7;
 inline constexpr unsigned char BLOCK_HASH_NIBBLE = 8;
 inline constexpr unsigned char CALL_FRAME_NIBBLE = 9;
+inline constexpr unsigned char LOG_INDEX_NIBBLE = 10;
 inline constexpr unsigned char INVALID_NIBBLE = 255;
 inline mpt::Nibbles const state_nibbles = mpt::concat(STATE_NIBBLE);
 inline mpt::Nibbles const code_nibbles = mpt::concat(CODE_NIBBLE);
@@ -126,6 +134,14 @@ inline mpt::Nibbles const ommer_nibbles = mpt::concat(OMMER_NIBBLE);
 inline mpt::Nibbles const withdrawal_nibbles = mpt::concat(WITHDRAWAL_NIBBLE);
 inline mpt::Nibbles const tx_hash_nibbles = mpt::concat(TX_HASH_NIBBLE);
 inline mpt::Nibbles const block_hash_nibbles = mpt::concat(BLOCK_HASH_NIBBLE);
+inline mpt::Nibbles const log_index_nibbles = mpt::concat(LOG_INDEX_NIBBLE);
+
+//////////////////////////////////////////////////////////
+// Keys of the log index, which maps every log address and topic of a block
+// to the receipts of the block holding a log with it
+//////////////////////////////////////////////////////////
+inline constexpr unsigned char LOG_INDEX_ADDRESS = 0;
+inline constexpr unsigned char LOG_INDEX_TOPIC = 1;
 
 //////////////////////////////////////////////////////////
 // Proposed and finalized subtries. Active on all tables.
@@ -152,9 +168,16 @@ Result<std::pair<Receipt, size_t>> decode_receipt_db(byte_string_view &);
 Result<std::pair<Transaction, Address>>
 decode_transaction_db(byte_string_view &);
 
+byte_string log_index_key(Address const &);
+byte_string log_index_key(bytes32_t const &topic);
+// The receipts are a bitmap, without its zero bytes at either end
+byte_string encode_log_index_db(std::span<uint32_t const> sorted_receipts);
+Result<std::vector<uint32_t>> decode_log_index_db(byte_string_view &);
+
+// `write` streams the content of `<root_path>/<block_number>/state.json`
 void write_to_file(
-    nlohmann::json const &, std::filesystem::path const &,
-    uint64_t block_number);
+    std::function<void(std::ostream &)> const &write,
+    std::filesystem::path const &root_path, uint64_t block_number);
 
 void load_from_binary(
     mpt::Db &, std::istream &accounts, std::istream &code,
@@ -170,6 +193,14 @@ std::vector<bytes32_t> get_proposal_block_ids(mpt::Db &, uint64_t block_number);
 std::optional<BlockHeader>
 read_eth_header(mpt::Db const &db, uint64_t block, mpt::NibblesView prefix);
 
+// The (block, receipt index) of every receipt in blocks [first, last] with a
+// log of the address or topic of `key`, in order. Fails unless every block
+// of the range was committed with the log index.
+std::optional<std::vector<std::pair<uint64_t, uint32_t>>>
+find_indexed_receipts(
+    mpt::Db const &, mpt::NibblesView prefix, uint64_t first, uint64_t last,
+    byte_string_view key);
+
 bool for_each_code(
     mpt::Db &, uint64_t block,
     std::function<void(bytes32_t const &, byte_string_view)>);
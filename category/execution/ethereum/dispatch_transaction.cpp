@@ -24,10 +24,12 @@ Result<Receipt> dispatch_transaction(
     Chain const &chain, uint64_t const i, Transaction const &transaction,
     Address const &sender,
     std::vector<std::optional<Address>> const &authorities,
-    BlockHeader const &header, BlockHashBuffer const &block_hash_buffer,
-    BlockState &block_state, BlockMetrics &block_metrics,
-    boost::fibers::promise<void> &prev, CallTracerBase &call_tracer,
-    RevertTransactionFn const &revert_transaction)
+    BlockHeader const &header,
+    BlockHashBufferFinalized const &block_hash_buffer, BlockState &block_state,
+    BlockMetrics &block_metrics, boost::fibers::promise<void> &prev,
+    CallTracerBase &call_tracer, RevertTransactionFn const &revert_transaction,
+    Result<void> *const static_validation,
+    std::function<void()> const &release_next)
 {
     return ExecuteTransaction<traits>{
         chain,
@@ -41,7 +43,9 @@ Result<Receipt> dispatch_transaction(
         block_metrics,
         prev,
         call_tracer,
-        revert_transaction}();
+        revert_transaction,
+        static_validation,
+        release_next}();
 }
 
 EXPLICIT_EVM_TRAITS(dispatch_transaction)
@@ -31,7 +31,7 @@
 
 MONAD_NAMESPACE_BEGIN
 
-class BlockHashBuffer;
+class BlockHashBufferFinalized;
 class BlockMetrics;
 class BlockState;
 class State;
@@ -49,9 +49,11 @@ Result<Receipt> dispatch_transaction(
     Chain const &chain, uint64_t const i, Transaction const &transaction,
     Address const &sender,
     std::vector<std::optional<Address>> const &authorities,
-    BlockHeader const &header, BlockHashBuffer const &block_hash_buffer,
-    BlockState &block_state, BlockMetrics &block_metrics,
-    boost::fibers::promise<void> &prev, CallTracerBase &call_tracer,
-    RevertTransactionFn const &revert_transaction);
+    BlockHeader const &header,
+    BlockHashBufferFinalized const &block_hash_buffer, BlockState &block_state,
+    BlockMetrics &block_metrics, boost::fibers::promise<void> &prev,
+    CallTracerBase &call_tracer, RevertTransactionFn const &revert_transaction,
+    Result<void> *static_validation,
+    std::function<void()> const &release_next);
 
 MONAD_NAMESPACE_END
@@ -67,6 +67,10 @@ enum monad_exec_event_type : uint16_t
     MONAD_EXEC_ACCOUNT_ACCESS,
     MONAD_EXEC_STORAGE_ACCESS,
     MONAD_EXEC_EVM_ERROR,
+    MONAD_EXEC_TXN_PERF_STATS,
+    MONAD_EXEC_BLOCK_PERF_STATS,
+    MONAD_EXEC_STATE_DIFF_HEADER,
+    MONAD_EXEC_ACCOUNT_DIFF,
 };
 
 /// Reserved event type used for recording errors
@@ -290,9 +294,81 @@ struct monad_exec_evm_error
     int64_t status_code; ///< Boost.Outcome status code of error
 };
 
+/// Performance breakdown of a transaction, recorded once it has merged
+struct monad_exec_txn_perf_stats
+{
+    uint64_t exec_nanos;                   ///< Optimistic execution time
+    uint64_t stall_nanos;                  ///< Time waiting on earlier txns to merge
+    uint64_t retry_nanos;                  ///< Re-execution time after a conflict
+    uint64_t gas_used;                     ///< Gas used by this transaction
+    bool has_conflict;                     ///< True -> optimistic result not merged
+    bool is_storage_conflict;              ///< True -> conflict_key meaningful
+    bool has_conflict_writer;              ///< True -> conflict_writer meaningful
+    uint32_t conflict_writer;              ///< Txn index which wrote the stale value
+    monad_c_address conflict_address;      ///< Account whose read went stale
+    monad_c_bytes32 conflict_key;          ///< Storage key whose read went stale
+};
+
+/// Performance breakdown of a block, recorded before its BLOCK_END
+struct monad_exec_block_perf_stats
+{
+    uint64_t sender_recovery_nanos;        ///< Sender and authority recovery
+    uint64_t exec_nanos;                   ///< Execution of all transactions
+    uint64_t stall_nanos;                  ///< Sum of the txn stalls
+    uint64_t retry_nanos;                  ///< Sum of the txn re-executions
+    uint32_t retries;                      ///< Number of re-executed txns
+    uint64_t commit_nanos;                 ///< Commit of the block state
+    uint64_t commit_state_nanos;           ///< Of commit: encoding state deltas
+    uint64_t commit_block_data_nanos;      ///< Of commit: encoding receipts, txns
+    uint64_t commit_upsert_nanos;          ///< Of commit: trie updates and writes
+    uint64_t account_reads;                ///< Account lookups reaching the trie
+    uint64_t storage_reads;                ///< Storage lookups reaching the trie
+    uint64_t read_bytes;                   ///< Bytes read from storage
+    uint64_t write_bytes;                  ///< Bytes written to storage
+    uint64_t cache_hits;                   ///< Account/storage cache hits
+    uint64_t cache_misses;                 ///< Account/storage cache misses
+    uint64_t native_calls;                 ///< VM calls run as native code
+    uint64_t interpreted_calls;            ///< VM calls run by the interpreter
+    uint64_t gas_used;                     ///< Gas used by the block
+};
+
+/// Header event that precedes the final state changes of a block; recorded
+/// when the block state is committed, if state diff recording is enabled
+struct monad_exec_state_diff_header
+{
+    uint32_t account_count;                ///< Number of account_diff events
+    uint64_t storage_count;                ///< Total of their storage diffs
+};
+
+/// Net change of an account over the whole block, which is followed by a
+/// trailing array of `storage_count` storage_diff entries, one for each slot
+/// whose value the block changed. If `is_storage_cleared` is set, the storage
+/// before the block was dropped, and every slot not in the array is zero.
+struct monad_exec_account_diff
+{
+    uint32_t index;                        ///< Index in the block's diff list
+    monad_c_address address;               ///< Address of account
+    bool prestate_exists;                  ///< False -> account was created
+    bool poststate_exists;                 ///< False -> account was deleted
+    bool is_storage_cleared;               ///< True -> old storage dropped
+    struct monad_c_eth_account_state
+        prestate;                          ///< State before the block
+    struct monad_c_eth_account_state
+        poststate;                         ///< State after the block
+    uint32_t storage_count;                ///< Number of trailing storage diffs
+};
+
+/// Trailing entry of an ACCOUNT_DIFF event, for a slot changed by the block
+struct monad_exec_storage_diff
+{
+    monad_c_bytes32 key;                   ///< Storage key modified
+    monad_c_bytes32 start_value;           ///< Value before the block
+    monad_c_bytes32 end_value;             ///< Value after the block
+};
+
 // clang-format on
 
-extern struct monad_event_metadata const g_monad_exec_event_metadata[25];
+extern struct monad_event_metadata const g_monad_exec_event_metadata[29];
 extern uint8_t const g_monad_exec_event_schema_hash[32];
 
 constexpr char MONAD_EVENT_DEFAULT_EXEC_FILE_NAME[] = "monad-exec-events";
@@ -30,7 +30,7 @@ extern "C"
 {
 #endif
 
-struct monad_event_metadata const g_monad_exec_event_metadata[25] = {
+struct monad_event_metadata const g_monad_exec_event_metadata[29] = {
 
     [MONAD_EXEC_NONE] =
         {.event_type = MONAD_EXEC_NONE,
@@ -171,12 +171,44 @@ struct monad_event_metadata const g_monad_exec_event_metadata[25] = {
          .c_name = "EVM_ERROR",
          .description =
              "Error occurred in execution process (not a validation error)"},
+
+    [MONAD_EXEC_TXN_PERF_STATS] =
+        {.event_type = MONAD_EXEC_TXN_PERF_STATS,
+         .c_name = "TXN_PERF_STATS",
+         .description =
+             "Performance breakdown of a transaction, recorded once it has "
+             "merged"},
+
+    [MONAD_EXEC_BLOCK_PERF_STATS] =
+        {.event_type = MONAD_EXEC_BLOCK_PERF_STATS,
+         .c_name = "BLOCK_PERF_STATS",
+         .description =
+             "Performance breakdown of a block, recorded before its "
+             "BLOCK_END"},
+
+    [MONAD_EXEC_STATE_DIFF_HEADER] =
+        {.event_type = MONAD_EXEC_STATE_DIFF_HEADER,
+         .c_name = "STATE_DIFF_HEADER",
+         .description =
+             "Header event that precedes the final state changes of a block; "
+             "recorded when the block state is committed, if state diff "
+             "recording is enabled"},
+
+    [MONAD_EXEC_ACCOUNT_DIFF] =
+        {.event_type = MONAD_EXEC_ACCOUNT_DIFF,
+         .c_name = "ACCOUNT_DIFF",
+         .description =
+             "Net change of an account over the whole block, which is "
+             "followed by a trailing array of `storage_count` storage_diff "
+             "entries, one for each slot whose value the block changed. If "
+             "`is_storage_cleared` is set, the storage before the block was "
+             "dropped, and every slot not in the array is zero."},
 };
 
 uint8_t const g_monad_exec_event_schema_hash[32] = {
-    0x89, 0x33, 0xf9, 0x07, 0xc4, 0x32, 0xc9, 0x8a, 0xc0, 0xc8, 0xdb,
-    0x62, 0xf9, 0xaa, 0x16, 0x4c, 0x0c, 0x3f, 0x16, 0x72, 0xf4, 0x12,
-    0x90, 0xe4, 0xea, 0x34, 0x08, 0xdf, 0x6c, 0x67, 0x23, 0xf3,
+    0x75, 0x37, 0x97, 0xc9, 0x96, 0xeb, 0xac, 0x2c, 0x39, 0x6d, 0x0a,
+    0x4c, 0x0c, 0x31, 0x66, 0x87, 0x0f, 0x78, 0x91, 0x00, 0x73, 0x74,
+    0x8e, 0x64, 0xf2, 0x82, 0x32, 0xbe, 0xc3, 0xbe, 0x6d, 0x88,
 };
 
 #ifdef __cplusplus
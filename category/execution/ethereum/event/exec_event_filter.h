@@ -0,0 +1,119 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+/**
+ * @file
+ *
+ * This file defines execution event filters, which let a consumer read only
+ * the events it is interested in (e.g., the logs emitted by a few contracts)
+ * without decoding every event in the ring itself. A filter has three
+ * predicates, all of which must pass:
+ *
+ *   1. The event type must be in the filter's event type set (an empty set
+ *      allows all types)
+ *
+ *   2. For event types that carry an address (TXN_LOG, TXN_CALL_FRAME,
+ *      ACCOUNT_ACCESS, STORAGE_ACCESS, ACCOUNT_DIFF), one of those addresses
+ *      must be in the filter's address set (an empty set allows any address)
+ *
+ *   3. For TXN_LOG, one of the log's topics must be in the filter's topic set
+ *      (an empty set allows any topics)
+ *
+ * Event types that do not carry an address or topics are selected by type
+ * alone, so that a filter for some contracts' logs can still ask for the
+ * BLOCK_START and BLOCK_END events that delimit them. Set membership is first
+ * tested on 4-byte prefixes, several at once with SIMD compares, and the full
+ * value is compared only for matching prefixes.
+ */
+
+#include <stdint.h>
+
+#include <category/core/event/event_iterator.h>
+#include <category/execution/ethereum/core/base_ctypes.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum monad_exec_event_type : uint16_t;
+
+struct monad_event_descriptor;
+struct monad_event_iterator;
+struct monad_event_ring;
+
+/// Capacity of a filter's address and topic sets
+#define MONAD_EXEC_FILTER_MAX_ADDRESSES 64
+#define MONAD_EXEC_FILTER_MAX_TOPICS 64
+
+// clang-format off
+
+/// Holds the predicates of an execution event filter; treat it as opaque and
+/// use the functions below to build it. Prefixes are kept apart from the full
+/// values so that the SIMD compares can load them contiguously.
+struct monad_exec_event_filter
+{
+    uint64_t event_types;                  ///< Bit set of monad_exec_event_type
+    uint32_t address_count;                ///< Size of the address set
+    uint32_t topic_count;                  ///< Size of the topic set
+    uint32_t address_prefixes[MONAD_EXEC_FILTER_MAX_ADDRESSES];
+    uint32_t topic_prefixes[MONAD_EXEC_FILTER_MAX_TOPICS];
+    monad_c_address addresses[MONAD_EXEC_FILTER_MAX_ADDRESSES];
+    monad_c_bytes32 topics[MONAD_EXEC_FILTER_MAX_TOPICS];
+};
+
+// clang-format on
+
+/// Initialize a filter that selects every event
+static void monad_exec_filter_init(struct monad_exec_event_filter *);
+
+/// Add an event type to the filter's event type set
+static void monad_exec_filter_add_event_type(
+    struct monad_exec_event_filter *, enum monad_exec_event_type);
+
+/// Add an address to the filter's address set; returns false if the set is
+/// already full
+static bool monad_exec_filter_add_address(
+    struct monad_exec_event_filter *, monad_c_address const *);
+
+/// Add a topic to the filter's topic set; returns false if the set is already
+/// full
+static bool monad_exec_filter_add_topic(
+    struct monad_exec_event_filter *, monad_c_bytes32 const *);
+
+/// Return true if the event passes the filter. The predicates read the payload
+/// in place; if it expires during the test, this returns true so that the
+/// consumer's own payload check reports the loss rather than the event
+/// silently disappearing
+static bool monad_exec_filter_match(
+    struct monad_exec_event_filter const *, struct monad_event_ring const *,
+    struct monad_event_descriptor const *);
+
+/// Behaves like `monad_event_iterator_try_next`, but skips over events that
+/// do not pass the filter; MONAD_EVENT_NOT_READY is returned once every
+/// available event has been skipped
+static enum monad_event_iter_result monad_exec_iter_try_next_filtered(
+    struct monad_event_iterator *, struct monad_event_ring const *,
+    struct monad_exec_event_filter const *, struct monad_event_descriptor *);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#define MONAD_EXEC_EVENT_FILTER_INTERNAL
+#include "exec_event_filter_inline.h"
+#undef MONAD_EXEC_EVENT_FILTER_INTERNAL
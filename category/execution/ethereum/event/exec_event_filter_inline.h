@@ -0,0 +1,271 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/**
+ * @file
+ *
+ * This file contains the implementation of the execution event filter API,
+ * which is entirely inlined so that filtering runs in the consumer's read
+ * loop without a call per event
+ */
+
+#ifndef MONAD_EXEC_EVENT_FILTER_INTERNAL
+    #error This file should only be included directly by exec_event_filter.h
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+#include <category/core/event/event_iterator.h>
+#include <category/core/event/event_ring.h>
+#include <category/core/likely.h>
+#include <category/execution/ethereum/core/base_ctypes.h>
+#include <category/execution/ethereum/core/eth_ctypes.h>
+#include <category/execution/ethereum/event/exec_event_ctypes.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Set membership is tested on a block of prefixes at a time: each lane holds
+// the first 4 bytes of one set element, and lanes equal to the key's prefix
+// are returned as a bit mask. The prefix arrays are sized to a multiple of
+// the widest block, so a block starting below `count` never reads past them.
+#if defined(__AVX2__)
+    #define MONAD_EXEC_FILTER_LANES 8
+
+static inline uint32_t
+_monad_exec_filter_prefix_bits(uint32_t const *prefixes, uint32_t prefix)
+{
+    __m256i const lanes = _mm256_loadu_si256((__m256i const *)prefixes);
+    __m256i const eq =
+        _mm256_cmpeq_epi32(lanes, _mm256_set1_epi32((int)prefix));
+    return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+}
+#elif defined(__SSE2__)
+    #define MONAD_EXEC_FILTER_LANES 4
+
+static inline uint32_t
+_monad_exec_filter_prefix_bits(uint32_t const *prefixes, uint32_t prefix)
+{
+    __m128i const lanes = _mm_loadu_si128((__m128i const *)prefixes);
+    __m128i const eq = _mm_cmpeq_epi32(lanes, _mm_set1_epi32((int)prefix));
+    return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(eq));
+}
+#else
+    #define MONAD_EXEC_FILTER_LANES 1
+
+static inline uint32_t
+_monad_exec_filter_prefix_bits(uint32_t const *prefixes, uint32_t prefix)
+{
+    return *prefixes == prefix ? 1U : 0U;
+}
+#endif
+
+static_assert(MONAD_EXEC_FILTER_MAX_ADDRESSES % 8 == 0);
+static_assert(MONAD_EXEC_FILTER_MAX_TOPICS % 8 == 0);
+static_assert(MONAD_EXEC_ACCOUNT_DIFF < 64, "event types must fit bit set");
+
+// Return true if `key` (of `size` bytes) is one of the first `count` elements
+// of `values`, whose prefixes are in `prefixes`
+static inline bool _monad_exec_filter_find(
+    uint32_t const *prefixes, uint32_t count, void const *values, size_t size,
+    void const *key)
+{
+    uint32_t prefix;
+    memcpy(&prefix, key, sizeof prefix);
+    for (uint32_t i = 0; i < count; i += MONAD_EXEC_FILTER_LANES) {
+        uint32_t bits = _monad_exec_filter_prefix_bits(prefixes + i, prefix);
+        if (count - i < MONAD_EXEC_FILTER_LANES) {
+            bits &= (1U << (count - i)) - 1; // Lanes past the end of the set
+        }
+        while (MONAD_UNLIKELY(bits != 0)) {
+            uint32_t const j = i + (uint32_t)__builtin_ctz(bits);
+            if (memcmp((uint8_t const *)values + j * size, key, size) == 0) {
+                return true;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return false;
+}
+
+static inline bool _monad_exec_filter_address_match(
+    struct monad_exec_event_filter const *filter,
+    monad_c_address const *address)
+{
+    return filter->address_count == 0 ||
+           _monad_exec_filter_find(
+               filter->address_prefixes,
+               filter->address_count,
+               filter->addresses,
+               sizeof *address,
+               address);
+}
+
+static inline bool _monad_exec_filter_log_topics_match(
+    struct monad_exec_event_filter const *filter,
+    struct monad_event_descriptor const *event,
+    struct monad_c_eth_txn_log const *log)
+{
+    if (filter->topic_count == 0) {
+        return true;
+    }
+    // The topic count is checked against the payload size, since an expired
+    // payload may hold anything
+    uint8_t const topic_count = log->topic_count;
+    if (sizeof *log + topic_count * sizeof(monad_c_bytes32) >
+        event->payload_size) {
+        return false;
+    }
+    uint8_t const *const topics = (uint8_t const *)(log + 1);
+    for (uint8_t t = 0; t < topic_count; ++t) {
+        if (_monad_exec_filter_find(
+                filter->topic_prefixes,
+                filter->topic_count,
+                filter->topics,
+                sizeof(monad_c_bytes32),
+                topics + t * sizeof(monad_c_bytes32))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void monad_exec_filter_init(struct monad_exec_event_filter *filter)
+{
+    memset(filter, 0, sizeof *filter);
+}
+
+inline void monad_exec_filter_add_event_type(
+    struct monad_exec_event_filter *filter, enum monad_exec_event_type type)
+{
+    filter->event_types |= 1ULL << type;
+}
+
+inline bool monad_exec_filter_add_address(
+    struct monad_exec_event_filter *filter, monad_c_address const *address)
+{
+    if (filter->address_count == MONAD_EXEC_FILTER_MAX_ADDRESSES) {
+        return false;
+    }
+    uint32_t const i = filter->address_count++;
+    memcpy(&filter->addresses[i], address, sizeof *address);
+    memcpy(
+        &filter->address_prefixes[i],
+        address,
+        sizeof filter->address_prefixes[i]);
+    return true;
+}
+
+inline bool monad_exec_filter_add_topic(
+    struct monad_exec_event_filter *filter, monad_c_bytes32 const *topic)
+{
+    if (filter->topic_count == MONAD_EXEC_FILTER_MAX_TOPICS) {
+        return false;
+    }
+    uint32_t const i = filter->topic_count++;
+    memcpy(&filter->topics[i], topic, sizeof *topic);
+    memcpy(&filter->topic_prefixes[i], topic, sizeof filter->topic_prefixes[i]);
+    return true;
+}
+
+inline bool monad_exec_filter_match(
+    struct monad_exec_event_filter const *filter,
+    struct monad_event_ring const *event_ring,
+    struct monad_event_descriptor const *event)
+{
+    bool pass;
+
+    if (filter->event_types != 0 &&
+        (event->event_type >= 64 ||
+         (filter->event_types & (1ULL << event->event_type)) == 0)) {
+        return false;
+    }
+    if (filter->address_count == 0 && filter->topic_count == 0) {
+        return true;
+    }
+
+    void const *const payload =
+        monad_event_ring_payload_peek(event_ring, event);
+    switch (event->event_type) {
+    case MONAD_EXEC_TXN_LOG: {
+        struct monad_c_eth_txn_log const *const log =
+            (struct monad_c_eth_txn_log const *)payload;
+        pass = _monad_exec_filter_address_match(filter, &log->address) &&
+               _monad_exec_filter_log_topics_match(filter, event, log);
+        break;
+    }
+
+    case MONAD_EXEC_TXN_CALL_FRAME: {
+        struct monad_exec_txn_call_frame const *const frame =
+            (struct monad_exec_txn_call_frame const *)payload;
+        pass = _monad_exec_filter_address_match(filter, &frame->caller) ||
+               _monad_exec_filter_address_match(filter, &frame->call_target);
+        break;
+    }
+
+    case MONAD_EXEC_ACCOUNT_ACCESS:
+        pass = _monad_exec_filter_address_match(
+            filter,
+            &((struct monad_exec_account_access const *)payload)->address);
+        break;
+
+    case MONAD_EXEC_STORAGE_ACCESS:
+        pass = _monad_exec_filter_address_match(
+            filter,
+            &((struct monad_exec_storage_access const *)payload)->address);
+        break;
+
+    case MONAD_EXEC_ACCOUNT_DIFF:
+        pass = _monad_exec_filter_address_match(
+            filter,
+            &((struct monad_exec_account_diff const *)payload)->address);
+        break;
+
+    default:
+        return true; // Selected by type alone
+    }
+
+    return pass || !monad_event_ring_payload_check(event_ring, event);
+}
+
+inline enum monad_event_iter_result monad_exec_iter_try_next_filtered(
+    struct monad_event_iterator *iter,
+    struct monad_event_ring const *event_ring,
+    struct monad_exec_event_filter const *filter,
+    struct monad_event_descriptor *event)
+{
+    enum monad_event_iter_result r;
+    while ((r = monad_event_iterator_try_next(iter, event)) ==
+           MONAD_EVENT_SUCCESS) {
+        if (monad_exec_filter_match(filter, event_ring, event)) {
+            break;
+        }
+    }
+    return r;
+}
+
+#undef MONAD_EXEC_FILTER_LANES
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
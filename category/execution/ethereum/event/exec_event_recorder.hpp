@@ -47,6 +47,11 @@
 
 MONAD_NAMESPACE_BEGIN
 
+// The generated metadata table is sized by its own literal, so an event type
+// added without regenerating it would be left without metadata
+static_assert(
+    std::size(g_monad_exec_event_metadata) == MONAD_EXEC_ACCOUNT_DIFF + 1);
+
 /// Event recording works in three steps: (1) reserving descriptor and payload
 /// buffer space in the event ring, then (2) the user performs zero-copy
 /// initialization of the payload directly in ring memory, then (3) the result
@@ -116,6 +121,18 @@ public:
         return &exec_ring_;
     }
 
+    /// Also record the net state changes of each block (the STATE_DIFF_HEADER
+    /// and ACCOUNT_DIFF events) when its state is committed
+    void enable_state_diffs()
+    {
+        record_state_diffs_ = true;
+    }
+
+    bool state_diffs_enabled() const
+    {
+        return record_state_diffs_;
+    }
+
     static constexpr size_t RECORD_ERROR_TRUNCATED_SIZE = 1UL << 13;
 
 private:
@@ -133,6 +150,7 @@ private:
     uint64_t cur_block_start_seqno_;
     std::string ring_path_;
     int ring_fd_;
+    bool record_state_diffs_{false};
 };
 
 inline ReservedExecEvent<monad_exec_block_start>
@@ -17,14 +17,22 @@
 #include <category/core/config.hpp>
 #include <category/core/event/event_recorder.h>
 #include <category/core/event/event_ring.h>
+#include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
 #include <category/execution/ethereum/event/exec_event_recorder.hpp>
 #include <category/execution/ethereum/event/record_block_events.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
 
+#include <algorithm>
 #include <bit>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <optional>
+#include <span>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -78,6 +86,114 @@ void record_block_start(
     exec_recorder->commit(block_start);
 }
 
+void record_block_perf(BlockPerf const &perf)
+{
+    ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
+    if (!exec_recorder) {
+        return;
+    }
+
+    auto const nanos = [](std::chrono::nanoseconds const d) {
+        return static_cast<uint64_t>(std::max(d.count(), int64_t{0}));
+    };
+    ReservedExecEvent const perf_stats =
+        exec_recorder->reserve_block_event<monad_exec_block_perf_stats>(
+            MONAD_EXEC_BLOCK_PERF_STATS);
+    *perf_stats.payload = monad_exec_block_perf_stats{
+        .sender_recovery_nanos = nanos(perf.sender_recovery_time),
+        .exec_nanos = nanos(perf.exec_time),
+        .stall_nanos = nanos(perf.stall_time),
+        .retry_nanos = nanos(perf.retry_time),
+        .retries = perf.retries,
+        .commit_nanos = nanos(perf.commit_time),
+        .commit_state_nanos = nanos(perf.commit_state_time),
+        .commit_block_data_nanos = nanos(perf.commit_block_data_time),
+        .commit_upsert_nanos = nanos(perf.commit_upsert_time),
+        .account_reads = perf.account_reads,
+        .storage_reads = perf.storage_reads,
+        .read_bytes = perf.read_bytes,
+        .write_bytes = perf.write_bytes,
+        .cache_hits = perf.cache_hits,
+        .cache_misses = perf.cache_misses,
+        .native_calls = perf.native_calls,
+        .interpreted_calls = perf.interpreted_calls,
+        .gas_used = perf.gas_used};
+    exec_recorder->commit(perf_stats);
+}
+
+void record_state_diff_events(StateDeltas const &state_deltas)
+{
+    ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
+    if (!exec_recorder || !exec_recorder->state_diffs_enabled()) {
+        return;
+    }
+
+    auto const to_c_state = [](std::optional<Account> const &account) {
+        if (!account.has_value()) {
+            return monad_c_eth_account_state{};
+        }
+        return monad_c_eth_account_state{
+            .nonce = account->nonce,
+            .balance = account->balance,
+            .code_hash = account->code_hash};
+    };
+
+    // The deltas also hold the accounts and slots that were only read; those
+    // are left out, by the same rules TrieDb::commit uses to skip them. The
+    // slots of a deleted account are not written, so they are left out too.
+    std::vector<monad_exec_account_diff> accounts;
+    std::vector<monad_exec_storage_diff> storage;
+    for (auto const &[address, delta] : state_deltas) {
+        auto const &[before, after] = delta.account;
+        size_t const storage_begin = size(storage);
+        if (after.has_value()) {
+            for (auto const &[key, value] : delta.storage) {
+                if (value.first != value.second) {
+                    storage.push_back(monad_exec_storage_diff{
+                        .key = key,
+                        .start_value = value.first,
+                        .end_value = value.second});
+                }
+            }
+        }
+        size_t const storage_count = size(storage) - storage_begin;
+        if (storage_count == 0 && before == after) {
+            continue;
+        }
+        accounts.push_back(monad_exec_account_diff{
+            .index = static_cast<uint32_t>(size(accounts)),
+            .address = address,
+            .prestate_exists = before.has_value(),
+            .poststate_exists = after.has_value(),
+            .is_storage_cleared =
+                before.has_value() &&
+                (!after.has_value() ||
+                 before->incarnation != after->incarnation),
+            .prestate = to_c_state(before),
+            .poststate = to_c_state(after),
+            .storage_count = static_cast<uint32_t>(storage_count)});
+    }
+
+    ReservedExecEvent const header =
+        exec_recorder->reserve_block_event<monad_exec_state_diff_header>(
+            MONAD_EXEC_STATE_DIFF_HEADER);
+    *header.payload = monad_exec_state_diff_header{
+        .account_count = static_cast<uint32_t>(size(accounts)),
+        .storage_count = size(storage)};
+    exec_recorder->commit(header);
+
+    std::span<monad_exec_storage_diff const> remaining{storage};
+    for (monad_exec_account_diff const &account : accounts) {
+        ReservedExecEvent const account_diff =
+            exec_recorder->reserve_block_event<monad_exec_account_diff>(
+                MONAD_EXEC_ACCOUNT_DIFF,
+                as_bytes(remaining.first(account.storage_count)));
+        *account_diff.payload = account;
+        exec_recorder->commit(account_diff);
+        remaining = remaining.subspan(account.storage_count);
+    }
+}
+
 Result<BlockExecOutput> record_block_result(Result<BlockExecOutput> result)
 {
     ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
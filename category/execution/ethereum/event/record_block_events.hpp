@@ -20,6 +20,7 @@
 #include <category/core/int.hpp>
 #include <category/core/result.hpp>
 #include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
 
 #include <cstddef>
 #include <cstdint>
@@ -29,6 +30,8 @@ struct monad_c_native_block_input;
 
 MONAD_NAMESPACE_BEGIN
 
+struct BlockPerf;
+
 /// Named pair holding the Ethereum block execution outputs
 struct BlockExecOutput
 {
@@ -45,6 +48,15 @@ void record_block_start(
     std::optional<monad_c_secp256k1_pubkey> const &,
     std::optional<monad_c_native_block_input> const &);
 
+/// Record the BLOCK_PERF_STATS event of the current block; must come before
+/// record_block_result, which ends the block
+void record_block_perf(BlockPerf const &);
+
+/// Record a STATE_DIFF_HEADER event, followed by an ACCOUNT_DIFF event for
+/// each account whose state the block changed; does nothing unless state
+/// diff recording is enabled on the recorder
+void record_state_diff_events(StateDeltas const &);
+
 /// Record block execution output events (or an execution error event, if
 /// Result::has_error() is true); also clears the active block flow ID
 Result<BlockExecOutput> record_block_result(Result<BlockExecOutput>);
@@ -30,9 +30,12 @@
 #include <category/execution/ethereum/event/exec_event_recorder.hpp>
 #include <category/execution/ethereum/event/record_txn_events.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
 #include <category/execution/ethereum/validate_transaction.hpp>
 
 #include <bit>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -48,9 +51,11 @@ MONAD_ANONYMOUS_NAMESPACE_BEGIN
 // Initializes the TXN_HEADER_START event payload
 void init_txn_header_start(
     Transaction const &txn, Address const &sender,
-    monad_exec_txn_header_start *event)
+    bytes32_t const *const txn_hash, monad_exec_txn_header_start *event)
 {
-    event->txn_hash = to_bytes(keccak256(rlp::encode_transaction(txn)));
+    event->txn_hash = txn_hash != nullptr
+                          ? *txn_hash
+                          : to_bytes(keccak256(rlp::encode_transaction(txn)));
     event->sender = sender;
     auto &header = event->txn_header;
     header.nonce = txn.nonce;
@@ -80,7 +85,7 @@ MONAD_NAMESPACE_BEGIN
 void record_txn_events(
     uint32_t txn_num, Transaction const &transaction, Address const &sender,
     std::span<std::optional<Address> const> authorities,
-    Result<Receipt> const &receipt_result)
+    Result<Receipt> const &receipt_result, bytes32_t const *const txn_hash)
 {
     ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
     if (exec_recorder == nullptr) {
@@ -94,7 +99,8 @@ void record_txn_events(
             txn_num,
             as_bytes(std::span{transaction.data}),
             as_bytes(std::span{transaction.blob_versioned_hashes}));
-    init_txn_header_start(transaction, sender, txn_header_start.payload);
+    init_txn_header_start(
+        transaction, sender, txn_hash, txn_header_start.payload);
     exec_recorder->commit(txn_header_start);
 
     // TXN_ACCESS_LIST_ENTRY
@@ -201,4 +207,29 @@ void record_txn_events(
     exec_recorder->record_txn_marker_event(MONAD_EXEC_TXN_END, txn_num);
 }
 
+void record_txn_perf_event(uint32_t txn_num, TxnPerf const &perf)
+{
+    ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
+    if (exec_recorder == nullptr) {
+        return;
+    }
+
+    MergeConflict const conflict = perf.conflict.value_or(MergeConflict{});
+    ReservedExecEvent const perf_stats =
+        exec_recorder->reserve_txn_event<monad_exec_txn_perf_stats>(
+            MONAD_EXEC_TXN_PERF_STATS, txn_num);
+    *perf_stats.payload = monad_exec_txn_perf_stats{
+        .exec_nanos = static_cast<uint64_t>(perf.exec_time.count()),
+        .stall_nanos = static_cast<uint64_t>(perf.stall_time.count()),
+        .retry_nanos = static_cast<uint64_t>(perf.retry_time.count()),
+        .gas_used = perf.gas_used,
+        .has_conflict = perf.conflict.has_value(),
+        .is_storage_conflict = conflict.key.has_value(),
+        .has_conflict_writer = conflict.writer.has_value(),
+        .conflict_writer = static_cast<uint32_t>(conflict.writer.value_or(0)),
+        .conflict_address = conflict.address,
+        .conflict_key = conflict.key.value_or(bytes32_t{})};
+    exec_recorder->commit(perf_stats);
+}
+
 MONAD_NAMESPACE_END
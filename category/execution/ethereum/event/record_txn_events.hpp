@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 #include <category/core/result.hpp>
 #include <category/execution/ethereum/core/address.hpp>
@@ -27,15 +28,21 @@ MONAD_NAMESPACE_BEGIN
 
 struct Receipt;
 struct Transaction;
+struct TxnPerf;
 
 /// Record the transaction header events (TXN_HEADER_START, the EIP-2930
 /// and EIP-7702 events, and TXN_HEADER_END), followed by the TXN_EVM_OUTPUT,
 /// TXN_REJECT, or EVM_ERROR events, depending on what happened during
 /// transaction execution; in the TXN_EVM_OUTPUT case, also record other
-/// execution output events (TXN_LOG, etc.)
+/// execution output events (TXN_LOG, etc.). Without a precomputed hash,
+/// the transaction is encoded and hashed again.
 void record_txn_events(
     uint32_t txn_num, Transaction const &, Address const &sender,
     std::span<std::optional<Address> const> authorities,
-    Result<Receipt> const &);
+    Result<Receipt> const &, bytes32_t const *txn_hash = nullptr);
+
+/// Record the TXN_PERF_STATS event, which breaks down where the time of the
+/// transaction went and which account or slot forced its re-execution
+void record_txn_perf_event(uint32_t txn_num, TxnPerf const &);
 
 MONAD_NAMESPACE_END
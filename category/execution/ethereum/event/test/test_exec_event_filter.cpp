@@ -0,0 +1,215 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/event/event_iterator.h>
+#include <category/core/event/event_recorder.h>
+#include <category/core/event/event_ring.h>
+#include <category/core/event/event_ring_util.h>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/event/exec_event_ctypes.h>
+#include <category/execution/ethereum/event/exec_event_filter.h>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace monad;
+using namespace evmc::literals;
+
+namespace
+{
+    constexpr auto token = 0x00000000000000000000000000000000000000a1_address;
+    constexpr auto other = 0x00000000000000000000000000000000000000a2_address;
+    constexpr auto transfer =
+        0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef_bytes32;
+    constexpr auto approval =
+        0x8c5be1e5ebec7d5bd14f71427d1e84f3dd0314c0f7b2291e5b200ac8c7c3b925_bytes32;
+
+    class ExecEventFilterTest : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            constexpr char MEMFD_NAME[] = "exec_event_filter_test";
+            int const ring_fd = memfd_create(MEMFD_NAME, 0);
+            ASSERT_NE(ring_fd, -1);
+            monad_event_ring_simple_config const simple_cfg = {
+                .descriptors_shift = 16,
+                .payload_buf_shift = 27,
+                .context_large_pages = 0,
+                .content_type = MONAD_EVENT_CONTENT_TYPE_EXEC,
+                .schema_hash = g_monad_exec_event_schema_hash};
+            ASSERT_EQ(
+                0,
+                monad_event_ring_init_simple(
+                    &simple_cfg, ring_fd, 0, MEMFD_NAME));
+            ASSERT_EQ(
+                0,
+                monad_event_ring_mmap(
+                    &event_ring_,
+                    PROT_READ | PROT_WRITE,
+                    0,
+                    ring_fd,
+                    0,
+                    MEMFD_NAME));
+            (void)close(ring_fd);
+            ASSERT_EQ(
+                0, monad_event_ring_init_recorder(&event_ring_, &recorder_));
+            ASSERT_EQ(
+                0, monad_event_ring_init_iterator(&event_ring_, &iter_));
+        }
+
+        void TearDown() override
+        {
+            monad_event_ring_unmap(&event_ring_);
+        }
+
+        uint64_t
+        record(monad_exec_event_type const type, std::span<uint8_t const> p)
+        {
+            uint64_t seqno;
+            uint8_t *payload_buf;
+            monad_event_descriptor *const event = monad_event_recorder_reserve(
+                &recorder_, p.size(), &seqno, &payload_buf);
+            event->event_type = type;
+            std::memcpy(payload_buf, p.data(), p.size());
+            monad_event_recorder_commit(event, seqno);
+            return seqno;
+        }
+
+        template <typename T>
+        uint64_t record(monad_exec_event_type const type, T const &payload)
+        {
+            return record(
+                type,
+                std::span{
+                    reinterpret_cast<uint8_t const *>(&payload),
+                    sizeof payload});
+        }
+
+        uint64_t record_log(
+            Address const &address, std::vector<bytes32_t> const &topics)
+        {
+            monad_exec_txn_log const log = {
+                .index = 0,
+                .address = address,
+                .topic_count = static_cast<uint8_t>(topics.size()),
+                .data_length = 0};
+            std::vector<uint8_t> payload(
+                sizeof log + topics.size() * sizeof(bytes32_t));
+            std::memcpy(payload.data(), &log, sizeof log);
+            std::memcpy(
+                payload.data() + sizeof log,
+                topics.data(),
+                topics.size() * sizeof(bytes32_t));
+            return record(MONAD_EXEC_TXN_LOG, payload);
+        }
+
+        // Sequence numbers of the events that pass the filter
+        std::vector<uint64_t> filtered(monad_exec_event_filter const &filter)
+        {
+            std::vector<uint64_t> seqnos;
+            monad_event_descriptor event;
+            while (monad_exec_iter_try_next_filtered(
+                       &iter_, &event_ring_, &filter, &event) ==
+                   MONAD_EVENT_SUCCESS) {
+                seqnos.push_back(event.seqno);
+            }
+            return seqnos;
+        }
+
+        alignas(64) monad_event_ring event_ring_;
+        alignas(64) monad_event_recorder recorder_;
+        alignas(64) monad_event_iterator iter_;
+    };
+}
+
+TEST_F(ExecEventFilterTest, logs_by_address_and_topic)
+{
+    uint64_t const block_start =
+        record(MONAD_EXEC_BLOCK_START, monad_exec_block_start{});
+    uint64_t const token_transfer = record_log(token, {transfer, NULL_HASH});
+    record_log(token, {approval});
+    record_log(other, {transfer});
+    uint64_t const token_no_topics = record_log(token, {});
+    monad_exec_account_access access{};
+    access.address = token;
+    uint64_t const token_access = record(MONAD_EXEC_ACCOUNT_ACCESS, access);
+    uint64_t const block_end = record(MONAD_EXEC_BLOCK_END, uint64_t{0});
+
+    monad_exec_event_filter filter;
+    monad_exec_filter_init(&filter);
+    EXPECT_EQ(7UL, filtered(filter).size());
+
+    // Only the address predicate: any event type naming `token`, plus the
+    // events which carry no address
+    monad_event_iterator_set_seqno(&iter_, block_start);
+    ASSERT_TRUE(monad_exec_filter_add_address(&filter, &token));
+    EXPECT_EQ(
+        (std::vector{
+            block_start,
+            token_transfer,
+            token_transfer + 1,
+            token_no_topics,
+            token_access,
+            block_end}),
+        filtered(filter));
+
+    // Transfer logs of `token`, and the block delimiters
+    monad_event_iterator_set_seqno(&iter_, block_start);
+    monad_exec_filter_add_event_type(&filter, MONAD_EXEC_BLOCK_START);
+    monad_exec_filter_add_event_type(&filter, MONAD_EXEC_TXN_LOG);
+    monad_exec_filter_add_event_type(&filter, MONAD_EXEC_BLOCK_END);
+    ASSERT_TRUE(monad_exec_filter_add_topic(&filter, &transfer));
+    EXPECT_EQ(
+        (std::vector{block_start, token_transfer, block_end}),
+        filtered(filter));
+}
+
+TEST_F(ExecEventFilterTest, many_addresses)
+{
+    // Fill the set so that every SIMD block is used, with addresses sharing
+    // their 4-byte prefix so that full compares are needed
+    monad_exec_event_filter filter;
+    monad_exec_filter_init(&filter);
+    std::vector<Address> addresses;
+    for (uint8_t i = 0; i < MONAD_EXEC_FILTER_MAX_ADDRESSES; ++i) {
+        Address a{};
+        a.bytes[19] = static_cast<uint8_t>(2 * i + 1);
+        addresses.push_back(a);
+        ASSERT_TRUE(monad_exec_filter_add_address(&filter, &a));
+    }
+    EXPECT_FALSE(monad_exec_filter_add_address(&filter, &token));
+
+    std::vector<uint64_t> expected;
+    for (uint8_t i = 0; i < 2 * MONAD_EXEC_FILTER_MAX_ADDRESSES; ++i) {
+        monad_exec_storage_access access{};
+        access.address.bytes[19] = i;
+        uint64_t const seqno = record(MONAD_EXEC_STORAGE_ACCESS, access);
+        if (i % 2 == 1) {
+            expected.push_back(seqno);
+        }
+    }
+    EXPECT_EQ(expected, filtered(filter));
+}
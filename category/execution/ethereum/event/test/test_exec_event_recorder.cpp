@@ -17,18 +17,26 @@
 #include <category/core/bytes.hpp>
 #include <category/core/cleanup.h>
 #include <category/core/config.hpp>
+#include <category/core/event/event_iterator.h>
 #include <category/core/event/event_ring.h>
 #include <category/core/event/event_ring_util.h>
+#include <category/core/int.hpp>
+#include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
 #include <category/execution/ethereum/event/exec_event_recorder.hpp>
+#include <category/execution/ethereum/event/record_block_events.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
 
 #include <gtest/gtest.h>
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <span>
 #include <vector>
 
@@ -223,3 +231,115 @@ TEST(ExecEventRecorder, Overflow)
             written_error->truncated_payload_size - sizeof(*log_event.payload)),
         0);
 }
+
+TEST(ExecEventRecorder, StateDiffs)
+{
+    Address const unchanged = static_cast<Address>(0x1UL);
+    Address const modified = static_cast<Address>(0x2UL);
+    Address const created = static_cast<Address>(0x3UL);
+    Address const deleted = static_cast<Address>(0x4UL);
+    bytes32_t const key1{0x10};
+    bytes32_t const key2{0x20};
+    Account const account{.balance = 100, .nonce = 1};
+
+    StateDeltas deltas;
+    deltas.emplace(
+        unchanged,
+        StateDelta{
+            .account = {account, account},
+            .storage = {{key1, {bytes32_t{1}, bytes32_t{1}}}}});
+    deltas.emplace(
+        modified,
+        StateDelta{
+            .account = {account, Account{.balance = 50, .nonce = 2}},
+            .storage =
+                {{key1, {bytes32_t{1}, bytes32_t{2}}},
+                 {key2, {bytes32_t{3}, bytes32_t{3}}}}});
+    deltas.emplace(
+        created,
+        StateDelta{
+            .account =
+                {std::nullopt,
+                 Account{.balance = 7, .incarnation = Incarnation{1, 1}}},
+            .storage = {{key2, {bytes32_t{}, bytes32_t{4}}}}});
+    deltas.emplace(
+        deleted,
+        StateDelta{
+            .account = {account, std::nullopt},
+            .storage = {{key1, {bytes32_t{1}, bytes32_t{}}}}});
+
+    std::call_once(recorder_initialized, ensure_recorder_initialized);
+    ExecutionEventRecorder *const exec_recorder = g_exec_event_recorder.get();
+    auto const *const ring = exec_recorder->get_event_ring();
+    monad_event_iterator iter;
+    ASSERT_EQ(monad_event_ring_init_iterator(ring, &iter), 0);
+    monad_event_descriptor event;
+    while (monad_event_iterator_try_next(&iter, &event) ==
+           MONAD_EVENT_SUCCESS) {
+        // Skip the events of earlier tests
+    }
+
+    // Nothing is recorded until state diffs are enabled
+    record_state_diff_events(deltas);
+    ASSERT_EQ(
+        monad_event_iterator_try_next(&iter, &event), MONAD_EVENT_NOT_READY);
+
+    exec_recorder->enable_state_diffs();
+    record_state_diff_events(deltas);
+
+    ASSERT_EQ(
+        monad_event_iterator_try_next(&iter, &event), MONAD_EVENT_SUCCESS);
+    ASSERT_EQ(event.event_type, MONAD_EXEC_STATE_DIFF_HEADER);
+    auto const *const header =
+        static_cast<monad_exec_state_diff_header const *>(
+            monad_event_ring_payload_peek(ring, &event));
+    EXPECT_EQ(header->account_count, 3);
+    EXPECT_EQ(header->storage_count, 2);
+
+    std::map<Address, std::vector<monad_exec_storage_diff>> storage;
+    std::map<Address, monad_exec_account_diff> accounts;
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(
+            monad_event_iterator_try_next(&iter, &event), MONAD_EVENT_SUCCESS);
+        ASSERT_EQ(event.event_type, MONAD_EXEC_ACCOUNT_DIFF);
+        auto const *const diff = static_cast<monad_exec_account_diff const *>(
+            monad_event_ring_payload_peek(ring, &event));
+        EXPECT_EQ(diff->index, i);
+        ASSERT_EQ(
+            event.payload_size,
+            sizeof *diff +
+                diff->storage_count * sizeof(monad_exec_storage_diff));
+        auto const *const slots =
+            reinterpret_cast<monad_exec_storage_diff const *>(diff + 1);
+        accounts[diff->address] = *diff;
+        storage[diff->address].assign(slots, slots + diff->storage_count);
+    }
+    ASSERT_EQ(
+        monad_event_iterator_try_next(&iter, &event), MONAD_EVENT_NOT_READY);
+    EXPECT_FALSE(accounts.contains(unchanged));
+
+    auto const &m = accounts.at(modified);
+    EXPECT_TRUE(m.prestate_exists && m.poststate_exists);
+    EXPECT_FALSE(m.is_storage_cleared);
+    EXPECT_EQ(m.prestate.nonce, 1);
+    EXPECT_EQ(m.poststate.nonce, 2);
+    EXPECT_EQ(m.poststate.balance, uint256_t{50});
+    ASSERT_EQ(storage.at(modified).size(), 1);
+    EXPECT_EQ(storage.at(modified)[0].key, key1);
+    EXPECT_EQ(storage.at(modified)[0].start_value, bytes32_t{1});
+    EXPECT_EQ(storage.at(modified)[0].end_value, bytes32_t{2});
+
+    auto const &c = accounts.at(created);
+    EXPECT_FALSE(c.prestate_exists);
+    EXPECT_TRUE(c.poststate_exists);
+    EXPECT_EQ(c.poststate.balance, uint256_t{7});
+    ASSERT_EQ(storage.at(created).size(), 1);
+    EXPECT_EQ(storage.at(created)[0].end_value, bytes32_t{4});
+
+    // The slots of a deleted account are dropped along with it
+    auto const &d = accounts.at(deleted);
+    EXPECT_TRUE(d.prestate_exists);
+    EXPECT_FALSE(d.poststate_exists);
+    EXPECT_TRUE(d.is_storage_cleared);
+    EXPECT_TRUE(storage.at(deleted).empty());
+}
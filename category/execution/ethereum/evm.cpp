@@ -263,6 +263,12 @@ evmc::Result create(
     if (result.status_code == EVMC_SUCCESS) {
         result = deploy_contract_code<traits>(
             state, contract_address, std::move(result));
+        if (result.status_code == EVMC_SUCCESS &&
+            state.vm().deploy_policy() != nullptr) {
+            auto const code_hash = state.get_code_hash(contract_address);
+            state.vm().on_deploy<traits>(
+                msg.sender, code_hash, state.read_code(code_hash));
+        }
     }
 
     if (msg.depth == 0 && revert_transaction()) {
@@ -35,8 +35,9 @@ MONAD_NAMESPACE_BEGIN
 
 EvmcHostBase::EvmcHostBase(
     Chain const &chain, CallTracerBase &call_tracer,
-    evmc_tx_context const &tx_context, BlockHashBuffer const &block_hash_buffer,
-    State &state, std::function<bool()> const &revert_transaction) noexcept
+    evmc_tx_context const &tx_context,
+    BlockHashBufferFinalized const &block_hash_buffer, State &state,
+    std::function<bool()> const &revert_transaction) noexcept
     : block_hash_buffer_{block_hash_buffer}
     , tx_context_{tx_context}
     , chain_{chain}
@@ -179,6 +180,19 @@ evmc_access_status EvmcHostBase::access_storage(
     stack_unwind();
 }
 
+evmc_access_status EvmcHostBase::access_and_load_storage(
+    Address const &address, bytes32_t const &key, bytes32_t &value,
+    bool const load_cold) noexcept
+{
+    try {
+        return state_.access_and_get_storage(address, key, value, load_cold);
+    }
+    catch (...) {
+        capture_current_exception();
+    }
+    stack_unwind();
+}
+
 bytes32_t EvmcHostBase::get_transient_storage(
     Address const &address, bytes32_t const &key) const noexcept
 {
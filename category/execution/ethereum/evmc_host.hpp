@@ -42,11 +42,11 @@ MONAD_NAMESPACE_BEGIN
 static_assert(sizeof(vm::Host) == 24);
 static_assert(alignof(vm::Host) == 8);
 
-class BlockHashBuffer;
+class BlockHashBufferFinalized;
 
 class EvmcHostBase : public vm::Host
 {
-    BlockHashBuffer const &block_hash_buffer_;
+    BlockHashBufferFinalized const &block_hash_buffer_;
 
 protected:
     evmc_tx_context const &tx_context_;
@@ -58,7 +58,7 @@ protected:
 public:
     EvmcHostBase(
         Chain const &, CallTracerBase &, evmc_tx_context const &,
-        BlockHashBuffer const &, State &,
+        BlockHashBufferFinalized const &, State &,
         std::function<bool()> const &revert_transaction = [] {
             return false;
         }) noexcept;
@@ -94,6 +94,10 @@ public:
     virtual evmc_access_status
     access_storage(Address const &, bytes32_t const &key) noexcept override;
 
+    virtual evmc_access_status access_and_load_storage(
+        Address const &, bytes32_t const &key, bytes32_t &value,
+        bool load_cold) noexcept override;
+
     virtual bytes32_t get_transient_storage(
         Address const &, bytes32_t const &key) const noexcept override;
 
@@ -19,15 +19,19 @@
 #include <category/core/event/event_recorder.h>
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/int.hpp>
+#include <category/core/keccak.hpp>
 #include <category/core/likely.h>
 #include <category/core/result.hpp>
+#include <category/core/util/log_rate_limit.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/block_hash_history.hpp>
 #include <category/execution/ethereum/block_reward.hpp>
 #include <category/execution/ethereum/chain/chain.hpp>
+#include <category/execution/ethereum/conflict_scheduler.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/fmt/transaction_fmt.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
+#include <category/execution/ethereum/core/rlp/transaction_rlp.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/core/withdrawal.hpp>
 #include <category/execution/ethereum/dao.hpp>
@@ -38,20 +42,24 @@
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/signer_cache.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/event_trace.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
+#include <category/execution/ethereum/validate_transaction.hpp>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/switch_traits.hpp>
 #include <category/vm/evm/traits.hpp>
 
+#include <boost/fiber/future/future.hpp>
 #include <boost/fiber/future/promise.hpp>
 #include <boost/outcome/try.hpp>
 #include <evmc/evmc.h>
 #include <intx/intx.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -115,6 +123,53 @@ void set_beacon_root(BlockState &block_state, BlockHeader const &header)
     }
 }
 
+void recover_tx_authorities(
+    Transaction const &transaction,
+    std::vector<std::optional<Address>> &authorities)
+{
+    authorities.resize(transaction.authorization_list.size());
+    for (size_t j = 0; j < authorities.size(); ++j) {
+        authorities[j] = recover_authority(transaction.authorization_list[j]);
+    }
+}
+
+// Splits [0, n) into at most one contiguous chunk per pool thread and runs
+// f(begin, end) for each chunk on the pool. Per-item tasks cost a promise
+// and a channel round trip each, which for large blocks rivals the
+// signature recovery itself.
+template <typename F>
+boost::fibers::future<void> submit_chunked(
+    size_t const n, fiber::PriorityPool &priority_pool, F const f)
+{
+    struct Done
+    {
+        std::atomic<size_t> remaining;
+        boost::fibers::promise<void> promise{};
+    };
+
+    size_t const chunks = std::min(n, size_t{priority_pool.n_threads()});
+    auto const done = std::make_shared<Done>(chunks);
+    auto future = done->promise.get_future();
+    if (chunks == 0) {
+        done->promise.set_value();
+        return future;
+    }
+    std::vector<fiber::PriorityTask> tasks;
+    tasks.reserve(chunks);
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t const begin = n * c / chunks;
+        size_t const end = n * (c + 1) / chunks;
+        tasks.push_back({begin, [f, begin, end, done] {
+                             f(begin, end);
+                             if (done->remaining.fetch_sub(1) == 1) {
+                                 done->promise.set_value();
+                             }
+                         }});
+    }
+    priority_pool.submit_batch(tasks);
+    return future;
+}
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
@@ -124,26 +179,15 @@ std::vector<std::optional<Address>> recover_senders(
     fiber::PriorityPool &priority_pool)
 {
     std::vector<std::optional<Address>> senders{transactions.size()};
-
-    std::shared_ptr<boost::fibers::promise<void>[]> promises{
-        new boost::fibers::promise<void>[transactions.size()]};
-
-    for (unsigned i = 0; i < transactions.size(); ++i) {
-        priority_pool.submit(
-            i,
-            [i = i,
-             promises = promises,
-             &sender = senders[i],
-             &transaction = transactions[i]] {
-                sender = recover_sender(transaction);
-                promises[i].set_value();
-            });
-    }
-
-    for (unsigned i = 0; i < transactions.size(); ++i) {
-        promises[i].get_future().wait();
-    }
-
+    submit_chunked(
+        transactions.size(),
+        priority_pool,
+        [&senders, &transactions](size_t const begin, size_t const end) {
+            for (size_t i = begin; i < end; ++i) {
+                senders[i] = recover_sender(transactions[i]);
+            }
+        })
+        .wait();
     return senders;
 }
 
@@ -153,37 +197,124 @@ std::vector<std::vector<std::optional<Address>>> recover_authorities(
 {
     std::vector<std::vector<std::optional<Address>>> authorities{
         transactions.size()};
-    std::vector<std::shared_ptr<boost::fibers::promise<void>[]>> promises{
-        transactions.size()};
+    submit_chunked(
+        transactions.size(),
+        priority_pool,
+        [&authorities, &transactions](size_t const begin, size_t const end) {
+            for (size_t i = begin; i < end; ++i) {
+                recover_tx_authorities(transactions[i], authorities[i]);
+            }
+        })
+        .wait();
+    return authorities;
+}
 
-    for (auto i = 0u; i < transactions.size(); ++i) {
-        authorities[i] = std::vector<std::optional<Address>>{
-            transactions[i].authorization_list.size()};
-        promises[i] = std::shared_ptr<boost::fibers::promise<void>[]>{
-            new boost::fibers::promise<void>[authorities[i].size()]};
+SignerRecovery::SignerRecovery(
+    std::vector<Transaction> const &transactions,
+    fiber::PriorityPool &priority_pool, SignerCache *const cache)
+    : signers_{std::make_unique<RecoveredSigners>()}
+{
+    signers_->senders.resize(transactions.size());
+    signers_->authorities.resize(transactions.size());
+    signers_->tx_hashes.resize(transactions.size());
+    done_ = submit_chunked(
+        transactions.size(),
+        priority_pool,
+        [&signers = *signers_, &transactions, cache](
+            size_t const begin, size_t const end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto const &tx = transactions[i];
+                auto &sender = signers.senders[i];
+                auto &authorities = signers.authorities[i];
+                auto const &tx_hash = signers.tx_hashes[i] =
+                    to_bytes(keccak256(rlp::encode_transaction(tx)));
+                if (cache == nullptr) {
+                    sender = recover_sender(tx);
+                    recover_tx_authorities(tx, authorities);
+                    continue;
+                }
+                SignerCache::Entry entry;
+                if (!cache->find(tx_hash, entry)) {
+                    entry.sender = recover_sender(tx);
+                    recover_tx_authorities(tx, entry.authorities);
+                    cache->insert(tx_hash, entry);
+                }
+                sender = entry.sender;
+                authorities = std::move(entry.authorities);
+            }
+        });
+}
 
-        for (auto j = 0u; j < authorities[i].size(); ++j) {
-            priority_pool.submit(
-                i,
-                [j = j,
-                 auth_promises = promises[i],
-                 &auth = authorities[i][j],
-                 &auth_entry = transactions[i].authorization_list[j]]() {
-                    auth = recover_authority(auth_entry);
-                    auth_promises[j].set_value();
-                });
-        }
+SignerRecovery::~SignerRecovery()
+{
+    if (done_.valid()) {
+        done_.wait();
     }
+}
 
-    for (auto i = 0u; i < transactions.size(); ++i) {
-        for (auto j = 0u; j < transactions[i].authorization_list.size(); ++j) {
-            promises[i][j].get_future().wait();
-        }
+RecoveredSigners SignerRecovery::get()
+{
+    MONAD_ASSERT(done_.valid());
+    done_.get();
+    return std::move(*signers_);
+}
+
+template <Traits traits>
+StatelessValidation<traits>::StatelessValidation(
+    Chain const &chain, Block const &block, fiber::PriorityPool &priority_pool)
+    : results_{std::make_unique<Results>()}
+{
+    size_t const n = block.transactions.size();
+    results_->transactions.resize(n);
+    // The header and body checks are the item past the last transaction
+    done_ = submit_chunked(
+        n + 1,
+        priority_pool,
+        [&results = *results_, &chain, &block, n](
+            size_t const begin, size_t const end) {
+            auto const &header = block.header;
+            uint256_t const chain_id = chain.get_chain_id();
+            for (size_t i = begin; i < end; ++i) {
+                if (i == n) {
+                    results.block = [&]() -> Result<void> {
+                        BOOST_OUTCOME_TRY(chain.static_validate_header(header));
+                        return static_validate_block<traits>(block);
+                    }();
+                    continue;
+                }
+                results.transactions[i] = static_validate_transaction<traits>(
+                    block.transactions[i],
+                    header.base_fee_per_gas,
+                    header.excess_blob_gas,
+                    chain_id);
+            }
+        });
+}
+
+template <Traits traits>
+StatelessValidation<traits>::~StatelessValidation()
+{
+    if (done_.valid()) {
+        done_.wait();
     }
+}
 
-    return authorities;
+template <Traits traits>
+Result<std::vector<Result<void>>> StatelessValidation<traits>::get()
+{
+    MONAD_ASSERT(done_.valid());
+    done_.get();
+    BOOST_OUTCOME_TRY(std::move(results_->block).value());
+    std::vector<Result<void>> transactions;
+    transactions.reserve(results_->transactions.size());
+    for (auto &result : results_->transactions) {
+        transactions.emplace_back(std::move(result).value());
+    }
+    return transactions;
 }
 
+EXPLICIT_TRAITS_CLASS(StatelessValidation);
+
 template <Traits traits>
 Result<std::vector<Receipt>> execute_block(
     Chain const &chain, Block &block, std::vector<Address> const &senders,
@@ -191,12 +322,23 @@ Result<std::vector<Receipt>> execute_block(
     BlockState &block_state, BlockHashBuffer const &block_hash_buffer,
     fiber::PriorityPool &priority_pool, BlockMetrics &block_metrics,
     std::vector<std::unique_ptr<CallTracerBase>> &call_tracers,
-    RevertTransactionFn const &revert_transaction)
+    RevertTransactionFn const &revert_transaction,
+    ConflictScheduler *const conflict_scheduler,
+    std::vector<Result<void>> *const static_validation,
+    std::vector<bytes32_t> const *const tx_hashes)
 {
     TRACE_BLOCK_EVENT(StartBlock);
 
     MONAD_ASSERT(senders.size() == block.transactions.size());
     MONAD_ASSERT(senders.size() == call_tracers.size());
+    MONAD_ASSERT(
+        static_validation == nullptr ||
+        static_validation->size() == senders.size());
+    MONAD_ASSERT(tx_hashes == nullptr || tx_hashes->size() == senders.size());
+
+    if (conflict_scheduler) {
+        block_state.enable_conflict_tracking();
+    }
 
     {
         State state{block_state, Incarnation{block.header.number, 0}};
@@ -231,56 +373,132 @@ Result<std::vector<Receipt>> execute_block(
     std::atomic<size_t> txn_exec_finished = 0;
     size_t const txn_count = block.transactions.size();
 
-    auto const tx_exec_begin = std::chrono::steady_clock::now();
+    // A transaction predicted to conflict with an earlier one waits for it to
+    // merge before executing, rather than executing twice
+    std::shared_ptr<boost::fibers::promise<void>[]> merged;
+    std::vector<boost::fibers::shared_future<void>> dependencies{txn_count};
+    if (conflict_scheduler) {
+        merged.reset(new boost::fibers::promise<void>[txn_count]);
+        auto const schedule = conflict_scheduler->schedule(
+            block.transactions, senders, authorities);
+        std::vector<boost::fibers::shared_future<void>> merged_futures{
+            txn_count};
+        uint32_t n_delayed = 0;
+        for (unsigned i = 0; i < txn_count; ++i) {
+            if (!schedule[i].has_value()) {
+                continue;
+            }
+            auto &future = merged_futures[schedule[i].value()];
+            if (!future.valid()) {
+                future = merged[schedule[i].value()].get_future().share();
+            }
+            dependencies[i] = future;
+            ++n_delayed;
+        }
+        block_metrics.set_num_delayed(n_delayed);
+    }
+
+    block_metrics.init_txn_perf(txn_count);
+
+    // Flatten the hashes visible to this block once, so that BLOCKHASH in
+    // every transaction is a direct ring lookup
+    BlockHashBufferFinalized const flat_block_hash_buffer{block_hash_buffer};
+
+    // The per-transaction tasks share one copy of the captured state, so that
+    // each task is small enough to be queued without allocating
+    auto execute_txn = [&chain = chain,
+                        results = results,
+                        promises = promises,
+                        merged = merged,
+                        dependencies = std::move(dependencies),
+                        &block = block,
+                        &senders = senders,
+                        &all_authorities = authorities,
+                        &block_hash_buffer = flat_block_hash_buffer,
+                        &block_state,
+                        &block_metrics,
+                        &call_tracers = call_tracers,
+                        &txn_exec_finished,
+                        static_validation,
+                        tx_hashes,
+                        &revert_transaction =
+                            revert_transaction](unsigned const i) {
+        auto const &dependency = dependencies[i];
+        auto const &transaction = block.transactions[i];
+        auto const &sender = senders[i];
+        auto const &authorities = all_authorities[i];
+        auto const &header = block.header;
+        auto &call_tracer = *call_tracers[i];
+        if (dependency.valid()) {
+            dependency.wait();
+        }
+        record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_ENTER, i);
+        // A transaction may release the next one itself, as soon as its
+        // writes are ordered in the block state
+        auto &next = promises[i + 1];
+        bool released = false;
+        auto const release_next = [&next, &released] {
+            next.set_value();
+            released = true;
+        };
+        try {
+            results[i] = dispatch_transaction<traits>(
+                chain,
+                i,
+                transaction,
+                sender,
+                authorities,
+                header,
+                block_hash_buffer,
+                block_state,
+                block_metrics,
+                promises[i],
+                call_tracer,
+                revert_transaction,
+                static_validation ? &(*static_validation)[i] : nullptr,
+                release_next);
+            if (!released) {
+                next.set_value();
+            }
+            record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_EXIT, i);
+            record_txn_perf_event(i, block_metrics.txn_perf()[i]);
+            record_txn_events(
+                i,
+                transaction,
+                sender,
+                authorities,
+                *results[i],
+                tx_hashes ? &(*tx_hashes)[i] : nullptr);
+        }
+        catch (...) {
+            // the next transaction may already have merged
+            MONAD_ASSERT(!released);
+            next.set_exception(std::current_exception());
+        }
+        if (merged) {
+            merged[i].set_value();
+        }
+        txn_exec_finished.fetch_add(1, std::memory_order::relaxed);
+    };
+    auto const shared_execute_txn =
+        std::make_shared<decltype(execute_txn)>(std::move(execute_txn));
+
+    std::vector<fiber::PriorityTask> tasks;
+    tasks.reserve(txn_count);
     for (unsigned i = 0; i < txn_count; ++i) {
-        priority_pool.submit(
-            i,
-            [&chain = chain,
-             i = i,
-             results = results,
-             promises = promises,
-             &transaction = block.transactions[i],
-             &sender = senders[i],
-             &authorities = authorities[i],
-             &header = block.header,
-             &block_hash_buffer = block_hash_buffer,
-             &block_state,
-             &block_metrics,
-             &call_tracer = *call_tracers[i],
-             &txn_exec_finished,
-             &revert_transaction = revert_transaction] {
-                record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_ENTER, i);
-                try {
-                    results[i] = dispatch_transaction<traits>(
-                        chain,
-                        i,
-                        transaction,
-                        sender,
-                        authorities,
-                        header,
-                        block_hash_buffer,
-                        block_state,
-                        block_metrics,
-                        promises[i],
-                        call_tracer,
-                        revert_transaction);
-                    promises[i + 1].set_value();
-                    record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_EXIT, i);
-                    record_txn_events(
-                        i, transaction, sender, authorities, *results[i]);
-                }
-                catch (...) {
-                    promises[i + 1].set_exception(std::current_exception());
-                }
-                txn_exec_finished.fetch_add(1, std::memory_order::relaxed);
-            });
+        tasks.push_back(
+            {i, [shared_execute_txn, i] { (*shared_execute_txn)(i); }});
     }
 
+    auto const tx_exec_begin = std::chrono::steady_clock::now();
+    priority_pool.submit_batch(tasks);
+
     auto const last = static_cast<std::ptrdiff_t>(block.transactions.size());
     promises[last].get_future().get();
     block_metrics.set_tx_exec_time(
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - tx_exec_begin));
+    block_metrics.set_num_versioned_reads(block_state.num_versioned_reads());
 
     // All transactions have released their merge-order synchronization
     // primitive (promises[i + 1]) but some stragglers could still be running
@@ -291,11 +509,17 @@ Result<std::vector<Receipt>> execute_block(
         cpu_relax();
     }
 
+    if (conflict_scheduler) {
+        conflict_scheduler->update(block.transactions, block_metrics);
+    }
+
     std::vector<Receipt> retvals;
     for (unsigned i = 0; i < block.transactions.size(); ++i) {
         MONAD_ASSERT(results[i].has_value());
         if (MONAD_UNLIKELY(results[i].value().has_error())) {
-            LOG_ERROR(
+            LOG_RATE_LIMITED(
+                LOG_ERROR,
+                std::chrono::seconds{1},
                 "tx {} {} validation failed: {}",
                 i,
                 block.transactions[i],
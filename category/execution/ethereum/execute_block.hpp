@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/result.hpp>
@@ -27,6 +28,8 @@
 
 #include <evmc/evmc.h>
 
+#include <boost/fiber/future/future.hpp>
+
 #include <memory>
 #include <optional>
 #include <vector>
@@ -35,6 +38,8 @@ MONAD_NAMESPACE_BEGIN
 
 class BlockHashBuffer;
 class BlockState;
+class ConflictScheduler;
+class SignerCache;
 class State;
 struct Block;
 struct Chain;
@@ -46,7 +51,10 @@ Result<std::vector<Receipt>> execute_block(
     BlockState &, BlockHashBuffer const &, fiber::PriorityPool &,
     BlockMetrics &, std::vector<std::unique_ptr<CallTracerBase>> &,
     RevertTransactionFn const & = [](Address const &, Transaction const &,
-                                     uint64_t, State &) { return false; });
+                                     uint64_t, State &) { return false; },
+    ConflictScheduler * = nullptr,
+    std::vector<Result<void>> *static_validation = nullptr,
+    std::vector<bytes32_t> const *tx_hashes = nullptr);
 
 std::vector<std::optional<Address>>
 recover_senders(std::vector<Transaction> const &, fiber::PriorityPool &);
@@ -54,4 +62,73 @@ recover_senders(std::vector<Transaction> const &, fiber::PriorityPool &);
 std::vector<std::vector<std::optional<Address>>>
 recover_authorities(std::vector<Transaction> const &, fiber::PriorityPool &);
 
+struct RecoveredSigners
+{
+    std::vector<std::optional<Address>> senders{};
+    std::vector<std::vector<std::optional<Address>>> authorities{};
+    std::vector<bytes32_t> tx_hashes{};
+};
+
+/**
+ * Recovers the senders and EIP-7702 authorities of a block on the priority
+ * pool without blocking the caller, so that the recovery of a block can run
+ * while the previous one commits. The transactions must stay at the same
+ * address until the recovery finishes; the destructor waits for it. With a
+ * cache, transactions recovered before are looked up by hash instead. The
+ * hash of every transaction is kept, so that the rest of the block does not
+ * encode and hash the transactions again.
+ */
+class SignerRecovery
+{
+    std::unique_ptr<RecoveredSigners> signers_;
+    boost::fibers::future<void> done_;
+
+public:
+    SignerRecovery(
+        std::vector<Transaction> const &, fiber::PriorityPool &,
+        SignerCache * = nullptr);
+
+    SignerRecovery(SignerRecovery &&) = default;
+    SignerRecovery &operator=(SignerRecovery &&) = delete;
+
+    ~SignerRecovery();
+
+    RecoveredSigners get();
+};
+
+/**
+ * Runs the checks of a block which do not read state on the priority pool
+ * without blocking the caller, so that they overlap sender recovery: the
+ * static checks of the header and the body, and the static checks of every
+ * transaction. Passing the transaction results to `execute_block` leaves
+ * execution with the state-dependent checks only; transactions with their
+ * own executor, such as Monad system transactions, ignore them. The block
+ * must stay at the same address until the checks finish; the destructor
+ * waits for them.
+ */
+template <Traits traits>
+class StatelessValidation
+{
+    struct Results
+    {
+        std::optional<Result<void>> block{};
+        std::vector<std::optional<Result<void>>> transactions{};
+    };
+
+    std::unique_ptr<Results> results_;
+    boost::fibers::future<void> done_;
+
+public:
+    StatelessValidation(Chain const &, Block const &, fiber::PriorityPool &);
+
+    StatelessValidation(StatelessValidation &&) = default;
+    StatelessValidation &operator=(StatelessValidation &&) = delete;
+
+    ~StatelessValidation();
+
+    /// The error of the header and body checks, otherwise the result of
+    /// each transaction
+    Result<std::vector<Result<void>>> get();
+};
+
 MONAD_NAMESPACE_END
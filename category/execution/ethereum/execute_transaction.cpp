@@ -16,8 +16,11 @@
 #include <category/core/assert.h>
 #include <category/core/int.hpp>
 #include <category/core/likely.h>
+#include <category/core/mem/arena.hpp>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/chain/chain.hpp>
+#include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/evm.hpp>
@@ -25,6 +28,7 @@
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/event_trace.hpp>
@@ -41,9 +45,13 @@
 #include <intx/intx.hpp>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
@@ -69,6 +77,20 @@ constexpr void irrevocable_change(
     state.subtract_from_balance(sender, upfront_cost + blob_gas);
 }
 
+void record_txn_latency(TxnPerf const &perf)
+{
+    static LatencyMetric &exec = latency_metric(
+        "monad_txn_exec_seconds",
+        "optimistic execution time of a transaction, excluding the stall");
+    static LatencyMetric &retry = latency_metric(
+        "monad_txn_retry_seconds",
+        "re-execution time of a transaction whose first result conflicted");
+    exec.record(perf.exec_time);
+    if (perf.conflict.has_value()) {
+        retry.record(perf.retry_time);
+    }
+}
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
@@ -294,10 +316,11 @@ ExecuteTransaction<traits>::ExecuteTransaction(
     Chain const &chain, uint64_t const i, Transaction const &tx,
     Address const &sender,
     std::vector<std::optional<Address>> const &authorities,
-    BlockHeader const &header, BlockHashBuffer const &block_hash_buffer,
-    BlockState &block_state, BlockMetrics &block_metrics,
-    boost::fibers::promise<void> &prev, CallTracerBase &call_tracer,
-    RevertTransactionFn const &revert_transaction)
+    BlockHeader const &header,
+    BlockHashBufferFinalized const &block_hash_buffer, BlockState &block_state,
+    BlockMetrics &block_metrics, boost::fibers::promise<void> &prev,
+    CallTracerBase &call_tracer, RevertTransactionFn const &revert_transaction,
+    Result<void> *const static_validation, std::function<void()> release_next)
     : ExecuteTransactionNoValidation<
           traits>{chain, tx, sender, authorities, header, i, revert_transaction}
     , block_hash_buffer_{block_hash_buffer}
@@ -305,6 +328,8 @@ ExecuteTransaction<traits>::ExecuteTransaction(
     , block_metrics_{block_metrics}
     , prev_{prev}
     , call_tracer_{call_tracer}
+    , static_validation_{static_validation}
+    , release_next_{std::move(release_next)}
 {
 }
 
@@ -407,65 +432,152 @@ Receipt ExecuteTransaction<traits>::execute_final(
 }
 
 template <Traits traits>
-Result<Receipt> ExecuteTransaction<traits>::operator()()
+void ExecuteTransaction<traits>::record_slot_reads(State const &state)
+{
+    if (!block_metrics_.records_slot_reads() || !tx_.to.has_value()) {
+        return;
+    }
+    auto const it = state.original().find(tx_.to.value());
+    if (it == state.original().end()) {
+        return;
+    }
+    std::vector<bytes32_t> slots;
+    slots.reserve(it->second.storage_.size());
+    for (auto const &[key, value] : it->second.storage_) {
+        slots.push_back(key);
+    }
+    block_metrics_.set_txn_slot_reads(i_, std::move(slots));
+}
+
+template <Traits traits>
+void ExecuteTransaction<traits>::merge(State const &state)
 {
+    if (!release_next_) {
+        block_state_.merge(state);
+        return;
+    }
+    // The next transaction only has to wait for the writes to be ordered;
+    // the write-back of the storage overlaps with it
+    block_state_.merge_accounts(state);
+    release_next_();
+    block_state_.merge_storage(state);
+}
+
+template <Traits traits>
+Result<Receipt> ExecuteTransaction<traits>::execute_and_merge(TxnPerf &perf)
+{
+    using clock = std::chrono::steady_clock;
+
     TRACE_TXN_EVENT(StartTxn);
 
-    BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
-        tx_,
-        header_.base_fee_per_gas,
-        header_.excess_blob_gas,
-        chain_.get_chain_id()));
+    // The stateless checks ran while the senders were being recovered, unless
+    // the caller skipped that stage
+    if (static_validation_ != nullptr) {
+        BOOST_OUTCOME_TRY(std::move(*static_validation_));
+    }
+    else {
+        BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
+            tx_,
+            header_.base_fee_per_gas,
+            header_.excess_blob_gas,
+            chain_.get_chain_id()));
+    }
 
+    std::optional<State> first;
     {
         TRACE_TXN_EVENT(StartExecution);
 
-        State state{
+        auto &state = first.emplace(
             block_state_,
             Incarnation{header_.number, i_ + 1},
-            /*relaxed_validation=*/true};
+            /*relaxed_validation=*/true);
         state.set_original_nonce(sender_, tx_.nonce);
 
         call_tracer_.reset();
 
+        auto const exec_begin = clock::now();
         auto result = execute_impl2(state);
+        auto const stall_begin = clock::now();
+        perf.exec_time = stall_begin - exec_begin;
+
+        // Later transactions may read these writes while this one waits to
+        // merge; the gas settlement still changes the sender and beneficiary
+        if (result.has_value()) {
+            std::array<Address, 2> const pending{sender_, header_.beneficiary};
+            block_state_.publish(state, pending);
+        }
 
         {
             TRACE_TXN_EVENT(StartStall);
             prev_.get_future().wait();
         }
+        perf.stall_time = clock::now() - stall_begin;
 
-        if (block_state_.can_merge(state)) {
+        MergeConflict conflict;
+        if (block_state_.can_merge(state, &conflict)) {
             if (result.has_error()) {
                 return std::move(result.error());
             }
             auto const receipt = execute_final(state, result.value());
+            merge(state);
             call_tracer_.on_finish(receipt.gas_used);
-            block_state_.merge(state);
+            record_slot_reads(state);
             return receipt;
         }
+        block_metrics_.add_conflict(i_, conflict);
+        perf.conflict = conflict;
+        // The published writes were made from stale reads. The retry may
+        // end in an error and never merge, so they are withdrawn now.
+        block_state_.retract(state);
     }
     block_metrics_.inc_retries();
     {
         TRACE_TXN_EVENT(StartRetry);
 
+        auto const retry_begin = clock::now();
         State state{block_state_, Incarnation{header_.number, i_ + 1}};
 
+        // All earlier transactions have merged, so only the reads that went
+        // stale need to be read again from the block state
+        block_state_.carry_over_reads(*first, state);
+        first.reset();
+
         call_tracer_.reset();
 
         auto result = execute_impl2(state);
 
         MONAD_ASSERT(block_state_.can_merge(state));
         if (result.has_error()) {
+            perf.retry_time = clock::now() - retry_begin;
             return std::move(result.error());
         }
         auto const receipt = execute_final(state, result.value());
+        merge(state);
         call_tracer_.on_finish(receipt.gas_used);
-        block_state_.merge(state);
+        record_slot_reads(state);
+        perf.retry_time = clock::now() - retry_begin;
         return receipt;
     }
 }
 
+template <Traits traits>
+Result<Receipt> ExecuteTransaction<traits>::operator()()
+{
+    TxnPerf perf{};
+    Result<Receipt> result = [this, &perf] {
+        // Every State of this transaction, including the one of a retry, is
+        // destroyed before the scope resets the arena
+        ArenaScope const arena_scope;
+        return execute_and_merge(perf);
+    }();
+    if (result.has_value()) {
+        perf.gas_used = result.value().gas_used;
+    }
+    record_txn_latency(perf);
+    block_metrics_.set_txn_perf(i_, perf);
+    return result;
+}
+
 EXPLICIT_TRAITS_CLASS(ExecuteTransaction);
 
 uint64_t g_star(
@@ -25,11 +25,12 @@
 #include <evmc/evmc.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
-class BlockHashBuffer;
+class BlockHashBufferFinalized;
 class BlockMetrics;
 struct BlockHeader;
 class BlockState;
@@ -39,6 +40,7 @@ template <Traits traits>
 struct EvmcHost;
 class State;
 struct Transaction;
+struct TxnPerf;
 
 using RevertTransactionFn = std::function<bool(
     Address const & /* sender */, Transaction const &, uint64_t /* i */,
@@ -86,23 +88,30 @@ class ExecuteTransaction : public ExecuteTransactionNoValidation<traits>
     using ExecuteTransactionNoValidation<traits>::i_;
     using ExecuteTransactionNoValidation<traits>::revert_transaction_;
 
-    BlockHashBuffer const &block_hash_buffer_;
+    BlockHashBufferFinalized const &block_hash_buffer_;
     BlockState &block_state_;
     BlockMetrics &block_metrics_;
     boost::fibers::promise<void> &prev_;
     CallTracerBase &call_tracer_;
+    Result<void> *static_validation_;
+    std::function<void()> release_next_;
 
     Result<evmc::Result> execute_impl2(State &);
     Receipt execute_final(State &, evmc::Result const &);
+    void record_slot_reads(State const &);
+    void merge(State const &);
+    Result<Receipt> execute_and_merge(TxnPerf &);
 
 public:
     ExecuteTransaction(
         Chain const &, uint64_t i, Transaction const &, Address const &,
         std::vector<std::optional<Address>> const &, BlockHeader const &,
-        BlockHashBuffer const &, BlockState &, BlockMetrics &,
+        BlockHashBufferFinalized const &, BlockState &, BlockMetrics &,
         boost::fibers::promise<void> &prev, CallTracerBase &,
         RevertTransactionFn const & = [](Address const &, Transaction const &,
-                                         uint64_t, State &) { return false; });
+                                         uint64_t, State &) { return false; },
+        Result<void> *static_validation = nullptr,
+        std::function<void()> release_next = {});
     ~ExecuteTransaction() = default;
 
     Result<Receipt> operator()();
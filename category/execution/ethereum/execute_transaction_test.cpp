@@ -327,3 +327,69 @@ TEST(TransactionProcessor, monad_five_refunds_delete_then_set)
         }
     }
 }
+
+TEST(TransactionProcessor, records_txn_perf)
+{
+    using intx::operator""_u256;
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto bene{
+        0x5353535353535353535353535353535353535353_address};
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    db_t tdb{db};
+    vm::VM vm;
+    BlockState bs{tdb, vm};
+    BlockMetrics metrics;
+    metrics.init_txn_perf(1);
+
+    {
+        State state{bs, Incarnation{0, 0}};
+        state.add_to_balance(from, 56'000'000'000'000'000);
+        state.set_nonce(from, 25);
+        bs.merge(state);
+    }
+
+    Transaction const tx{
+        .sc =
+            {.r =
+                 0x5fd883bb01a10915ebc06621b925bd6d624cb6768976b73c0d468b31f657d15b_u256,
+             .s =
+                 0x121d855c539a23aadf6f06ac21165db1ad5efd261842e82a719c9863ca4ac04c_u256},
+        .nonce = 25,
+        .max_fee_per_gas = 10,
+        .gas_limit = 55'000,
+    };
+
+    BlockHeader const header{.beneficiary = bene};
+    BlockHashBufferFinalized const block_hash_buffer;
+
+    boost::fibers::promise<void> prev{};
+    prev.set_value();
+
+    NoopCallTracer noop_call_tracer;
+
+    auto const receipt = ExecuteTransaction<EvmTraits<EVMC_SHANGHAI>>(
+        EthereumMainnet{},
+        0,
+        tx,
+        from,
+        {},
+        header,
+        block_hash_buffer,
+        bs,
+        metrics,
+        prev,
+        noop_call_tracer)();
+
+    ASSERT_TRUE(!receipt.has_error());
+    ASSERT_EQ(metrics.txn_perf().size(), 1);
+
+    auto const &perf = metrics.txn_perf()[0];
+    EXPECT_EQ(perf.gas_used, receipt.value().gas_used);
+    EXPECT_FALSE(perf.conflict.has_value());
+    EXPECT_EQ(perf.retry_time.count(), 0);
+    EXPECT_EQ(metrics.num_retries(), 0);
+}
@@ -15,16 +15,76 @@
 
 #pragma once
 
+#include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
+// An edge of the per-block conflict graph: transaction `txn` had to be
+// re-executed because of `conflict`
+struct TxnConflict
+{
+    uint64_t txn;
+    MergeConflict conflict;
+};
+
+// Where the time of a single transaction went: the optimistic execution, the
+// stall waiting for all earlier transactions to merge, and the re-execution
+// if the optimistic result could not be merged
+struct TxnPerf
+{
+    std::chrono::nanoseconds exec_time{0};
+    std::chrono::nanoseconds stall_time{0};
+    std::chrono::nanoseconds retry_time{0};
+    std::optional<MergeConflict> conflict{};
+    uint64_t gas_used{0};
+};
+
+// One record of where the time of a block went and of the work behind it,
+// for consumers which would otherwise parse the block log line. The read,
+// cache and VM figures are counts, so that ratios can be taken over any
+// number of blocks.
+struct BlockPerf
+{
+    std::chrono::nanoseconds sender_recovery_time{0};
+    std::chrono::nanoseconds exec_time{0};
+    // summed over the transactions of the block
+    std::chrono::nanoseconds stall_time{0};
+    std::chrono::nanoseconds retry_time{0};
+    uint32_t retries{0};
+    std::chrono::nanoseconds commit_time{0};
+    std::chrono::nanoseconds commit_state_time{0};
+    std::chrono::nanoseconds commit_block_data_time{0};
+    std::chrono::nanoseconds commit_upsert_time{0};
+    uint64_t account_reads{0};
+    uint64_t storage_reads{0};
+    uint64_t read_bytes{0};
+    uint64_t write_bytes{0};
+    uint64_t cache_hits{0};
+    uint64_t cache_misses{0};
+    uint64_t native_calls{0};
+    uint64_t interpreted_calls{0};
+    uint64_t gas_used{0};
+};
+
 class BlockMetrics
 {
     uint32_t n_retries_{0};
+    uint32_t n_delayed_{0};
+    uint64_t n_versioned_reads_{0};
     std::chrono::microseconds tx_exec_time_{1};
+    std::vector<TxnConflict> conflicts_{};
+    std::vector<TxnPerf> txn_perf_{};
+    std::vector<std::vector<bytes32_t>> txn_slot_reads_{};
 
 public:
     void inc_retries()
@@ -37,6 +97,82 @@ public:
         return n_retries_;
     }
 
+    void set_num_delayed(uint32_t const n)
+    {
+        n_delayed_ = n;
+    }
+
+    uint32_t num_delayed() const
+    {
+        return n_delayed_;
+    }
+
+    void set_num_versioned_reads(uint64_t const n)
+    {
+        n_versioned_reads_ = n;
+    }
+
+    // Reads answered by the writes of a transaction that had not merged, with
+    // multi-version reads enabled
+    uint64_t num_versioned_reads() const
+    {
+        return n_versioned_reads_;
+    }
+
+    void add_conflict(uint64_t const txn, MergeConflict const &conflict)
+    {
+        conflicts_.push_back(TxnConflict{.txn = txn, .conflict = conflict});
+    }
+
+    std::vector<TxnConflict> const &conflicts() const
+    {
+        return conflicts_;
+    }
+
+    // Must be called before any transaction of the block executes; each
+    // transaction then only writes its own record
+    void init_txn_perf(size_t const n)
+    {
+        txn_perf_.assign(n, TxnPerf{});
+    }
+
+    // No-op for transactions executed outside of a block, e.g. in tests
+    void set_txn_perf(uint64_t const txn, TxnPerf const &perf)
+    {
+        if (txn < txn_perf_.size()) {
+            txn_perf_[txn] = perf;
+        }
+    }
+
+    std::span<TxnPerf const> txn_perf() const
+    {
+        return txn_perf_;
+    }
+
+    // Opt-in, before any transaction of the block executes: each transaction
+    // then records the storage slots of its recipient that it read
+    void init_txn_slot_reads(size_t const n)
+    {
+        txn_slot_reads_.assign(n, {});
+    }
+
+    bool records_slot_reads() const
+    {
+        return !txn_slot_reads_.empty();
+    }
+
+    void set_txn_slot_reads(uint64_t const txn, std::vector<bytes32_t> slots)
+    {
+        if (txn < txn_slot_reads_.size()) {
+            txn_slot_reads_[txn] = std::move(slots);
+        }
+    }
+
+    std::span<std::vector<bytes32_t> const> txn_slot_reads() const
+    {
+        return txn_slot_reads_;
+    }
+
     void set_tx_exec_time(std::chrono::microseconds const exec_time)
     {
         tx_exec_time_ = exec_time;
@@ -0,0 +1,89 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+#include <category/core/lru/lru_cache.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <evmc/evmc.h>
+
+#include <cstddef>
+
+MONAD_NAMESPACE_BEGIN
+
+/**
+ * Bounded cache of the results of expensive pure precompiles, keyed by the
+ * hash of the precompile address and its input. Transactions retried after a
+ * merge conflict and repeated eth_calls then skip recomputing the same
+ * pairing checks and signature recoveries. Safe for concurrent use.
+ */
+class PrecompileCache
+{
+public:
+    struct Entry
+    {
+        evmc_status_code status_code{EVMC_SUCCESS};
+        byte_string output{};
+    };
+
+private:
+    using Cache = LruCache<bytes32_t, Entry, BytesHashCompare<bytes32_t>>;
+
+    Cache cache_;
+
+public:
+    explicit PrecompileCache(size_t const max_size)
+        : cache_{max_size}
+    {
+    }
+
+    static bytes32_t key(Address const &address, byte_string_view const input)
+    {
+        byte_string preimage{address.bytes, sizeof(address.bytes)};
+        preimage += input;
+        return to_bytes(keccak256(preimage));
+    }
+
+    bool find(bytes32_t const &key, Entry &entry)
+    {
+        Cache::ConstAccessor acc{};
+        if (!cache_.find(acc, key)) {
+            return false;
+        }
+        entry = acc->second.value_;
+        return true;
+    }
+
+    void insert(bytes32_t const &key, Entry const &entry)
+    {
+        cache_.insert(key, entry);
+    }
+
+    size_t size() const
+    {
+        return cache_.size();
+    }
+};
+
+// Shared by every call of a memoized precompile in the process
+PrecompileCache &precompile_cache();
+
+MONAD_NAMESPACE_END
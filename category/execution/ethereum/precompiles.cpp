@@ -18,6 +18,7 @@
 #include <category/core/config.hpp>
 #include <category/core/likely.h>
 #include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/precompile_cache.hpp>
 #include <category/execution/ethereum/precompiles.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/vm/evm/explicit_traits.hpp>
@@ -28,16 +29,25 @@
 #include <evmc/helpers.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <optional>
 #include <utility>
 
 MONAD_NAMESPACE_BEGIN
 
+// Results of the most recent distinct calls to memoized precompiles
+constexpr size_t PRECOMPILE_CACHE_SIZE = 8192;
+
 struct PrecompiledContract
 {
     precompiled_gas_cost_fn *gas_cost_func;
     precompiled_execute_fn *execute_func;
+    // whether the result is worth caching: the precompile is expensive
+    // relative to hashing its input
+    bool memoize{false};
 };
 
 // TODO(Bruce): when we enable feature flags in traits rather than raw use of
@@ -65,8 +75,16 @@ std::optional<PrecompiledContract> resolve_precompile(Address const &address)
     }                                                                          \
     while (false)
 
+#define MEMOIZED_CASE(addr, gas_cost, execute)                                 \
+    do {                                                                       \
+        if (MONAD_UNLIKELY(Address{(addr)} == address)) {                      \
+            return PrecompiledContract{(gas_cost), (execute), true};           \
+        }                                                                      \
+    }                                                                          \
+    while (false)
+
     // Ethereum precompiles
-    CASE(0x01, ecrecover_gas_cost<traits>, ecrecover_execute);
+    MEMOIZED_CASE(0x01, ecrecover_gas_cost<traits>, ecrecover_execute);
     CASE(0x02, sha256_gas_cost<traits>, sha256_execute);
     CASE(0x03, ripemd160_gas_cost<traits>, ripemd160_execute);
     CASE(0x04, identity_gas_cost, identity_execute);
@@ -74,8 +92,8 @@ std::optional<PrecompiledContract> resolve_precompile(Address const &address)
     if constexpr (traits::evm_rev() >= EVMC_BYZANTIUM) {
         CASE(0x05, expmod_gas_cost<traits>, expmod_execute);
         CASE(0x06, ecadd_gas_cost<traits>, ecadd_execute);
-        CASE(0x07, ecmul_gas_cost<traits>, ecmul_execute);
-        CASE(0x08, snarkv_gas_cost<traits>, snarkv_execute);
+        MEMOIZED_CASE(0x07, ecmul_gas_cost<traits>, ecmul_execute);
+        MEMOIZED_CASE(0x08, snarkv_gas_cost<traits>, snarkv_execute);
     }
 
     if constexpr (traits::evm_rev() >= EVMC_ISTANBUL) {
@@ -83,24 +101,29 @@ std::optional<PrecompiledContract> resolve_precompile(Address const &address)
     }
 
     if constexpr (traits::evm_rev() >= EVMC_CANCUN) {
-        CASE(0x0A, point_evaluation_gas_cost<traits>, point_evaluation_execute);
+        MEMOIZED_CASE(
+            0x0A, point_evaluation_gas_cost<traits>, point_evaluation_execute);
     }
 
     if constexpr (traits::evm_rev() >= EVMC_PRAGUE) {
         CASE(0x0B, bls12_g1_add_gas_cost, bls12_g1_add_execute);
-        CASE(0x0C, bls12_g1_msm_gas_cost, bls12_g1_msm_execute);
+        MEMOIZED_CASE(0x0C, bls12_g1_msm_gas_cost, bls12_g1_msm_execute);
         CASE(0x0D, bls12_g2_add_gas_cost, bls12_g2_add_execute);
-        CASE(0x0E, bls12_g2_msm_gas_cost, bls12_g2_msm_execute);
-        CASE(0x0F, bls12_pairing_check_gas_cost, bls12_pairing_check_execute);
-        CASE(0x10, bls12_map_fp_to_g1_gas_cost, bls12_map_fp_to_g1_execute);
-        CASE(0x11, bls12_map_fp2_to_g2_gas_cost, bls12_map_fp2_to_g2_execute);
+        MEMOIZED_CASE(0x0E, bls12_g2_msm_gas_cost, bls12_g2_msm_execute);
+        MEMOIZED_CASE(
+            0x0F, bls12_pairing_check_gas_cost, bls12_pairing_check_execute);
+        MEMOIZED_CASE(
+            0x10, bls12_map_fp_to_g1_gas_cost, bls12_map_fp_to_g1_execute);
+        MEMOIZED_CASE(
+            0x11, bls12_map_fp2_to_g2_gas_cost, bls12_map_fp2_to_g2_execute);
     }
 
     // Rollup precompiles
     if constexpr (traits::eip_7951_active()) {
-        CASE(0x0100, p256_verify_gas_cost, p256_verify_execute);
+        MEMOIZED_CASE(0x0100, p256_verify_gas_cost, p256_verify_execute);
     }
 
+#undef MEMOIZED_CASE
 #undef CASE
 
     return std::nullopt;
@@ -108,6 +131,12 @@ std::optional<PrecompiledContract> resolve_precompile(Address const &address)
 
 EXPLICIT_TRAITS(resolve_precompile);
 
+PrecompileCache &precompile_cache()
+{
+    static PrecompileCache cache{PRECOMPILE_CACHE_SIZE};
+    return cache;
+}
+
 template <Traits traits>
 bool is_eth_precompile(Address const &address)
 {
@@ -124,6 +153,36 @@ bool is_precompile(Address const &address)
 
 EXPLICIT_EVM_TRAITS(is_precompile);
 
+// The output buffer is allocated with malloc, like that of the precompiles,
+// so that evmc_free_result_memory releases either
+static PrecompileResult execute_memoized(
+    Address const &address, precompiled_execute_fn *const execute_func,
+    byte_string_view const input)
+{
+    auto &cache = precompile_cache();
+    bytes32_t const key = PrecompileCache::key(address, input);
+    PrecompileCache::Entry entry;
+    if (cache.find(key, entry)) {
+        if (entry.output.empty()) {
+            return {entry.status_code, nullptr, 0};
+        }
+        auto *const obuf =
+            static_cast<uint8_t *>(std::malloc(entry.output.size()));
+        MONAD_ASSERT(obuf != nullptr);
+        std::memcpy(obuf, entry.output.data(), entry.output.size());
+        return {entry.status_code, obuf, entry.output.size()};
+    }
+    PrecompileResult const result = execute_func(input);
+    cache.insert(
+        key,
+        PrecompileCache::Entry{
+            .status_code = result.status_code,
+            .output = result.output_size == 0
+                          ? byte_string{}
+                          : byte_string{result.obuf, result.output_size}});
+    return result;
+}
+
 template <Traits traits>
 std::optional<evmc::Result> check_call_eth_precompile(evmc_message const &msg)
 {
@@ -143,7 +202,7 @@ std::optional<evmc::Result> check_call_eth_precompile(evmc_message const &msg)
         }
     }
 
-    auto const [gas_cost_func, execute_func] = *maybe_precompile;
+    auto const [gas_cost_func, execute_func, memoize] = *maybe_precompile;
 
     byte_string_view const input{msg.input_data, msg.input_size};
     uint64_t const cost = gas_cost_func(input);
@@ -152,7 +211,9 @@ std::optional<evmc::Result> check_call_eth_precompile(evmc_message const &msg)
         return evmc::Result{evmc_status_code::EVMC_OUT_OF_GAS};
     }
 
-    auto const [status_code, output_buffer, output_size] = execute_func(input);
+    auto const [status_code, output_buffer, output_size] =
+        memoize ? execute_memoized(address, execute_func, input)
+                : execute_func(input);
     return evmc::Result{evmc_result{
         .status_code = status_code,
         .gas_left = (status_code == EVMC_SUCCESS)
@@ -17,8 +17,16 @@
 #include <category/core/config.hpp>
 #include <category/execution/ethereum/precompiles_bls12.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <optional>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -280,57 +288,67 @@ namespace bls12
     template PrecompileResult mul<G1>(byte_string_view);
     template PrecompileResult mul<G2>(byte_string_view);
 
-    template <typename Group>
-    PrecompileResult
-    msm_pippenger(byte_string_view const input, uint64_t const k)
+    namespace
     {
-        auto affine_points = std::vector<typename Group::AffinePoint>{};
-        affine_points.reserve(k);
-
-        auto affine_point_ptrs =
-            std::vector<typename Group::AffinePoint const *>{};
-        affine_point_ptrs.reserve(k);
-
-        auto scalars = std::vector<blst_scalar>{};
-        scalars.reserve(k);
-
-        auto scalar_ptrs = std::vector<uint8_t const *>{};
-        scalar_ptrs.reserve(k);
-
-        static constexpr auto pair_size = Group::encoded_size + 32;
-        auto const *const end_ptr = input.data() + (k * pair_size);
-
-        for (auto const *ptr = input.data(); ptr != end_ptr; ptr += pair_size) {
-            auto const affine_point = Group::read(ptr);
-            if (MONAD_UNLIKELY(!affine_point.has_value())) {
-                return PrecompileResult::failure();
-            }
-
-            if (MONAD_UNLIKELY(!Group::affine_point_in_group(&*affine_point))) {
-                return PrecompileResult::failure();
+        // Inputs with at least this many points are split into chunks that
+        // are validated and multiplied on separate threads. Smaller chunks
+        // would lose more to Pippenger's per-call overhead than they gain.
+        constexpr size_t PARALLEL_MSM_MIN_POINTS = 128;
+        constexpr size_t PARALLEL_MSM_MIN_CHUNK_POINTS = 64;
+
+        // Validates the k pairs at `input` and multiplies the points that are
+        // not at infinity. Returns nothing if every point is at infinity.
+        template <typename Group>
+        std::optional<typename Group::Point>
+        msm_chunk(uint8_t const *const input, size_t const k, bool &valid)
+        {
+            auto affine_points = std::vector<typename Group::AffinePoint>{};
+            affine_points.reserve(k);
+
+            auto affine_point_ptrs =
+                std::vector<typename Group::AffinePoint const *>{};
+            affine_point_ptrs.reserve(k);
+
+            auto scalars = std::vector<blst_scalar>{};
+            scalars.reserve(k);
+
+            auto scalar_ptrs = std::vector<uint8_t const *>{};
+            scalar_ptrs.reserve(k);
+
+            static constexpr auto pair_size = Group::encoded_size + 32;
+            auto const *const end_ptr = input + (k * pair_size);
+
+            for (auto const *ptr = input; ptr != end_ptr; ptr += pair_size) {
+                auto const affine_point = Group::read(ptr);
+                if (MONAD_UNLIKELY(!affine_point.has_value())) {
+                    valid = false;
+                    return std::nullopt;
+                }
+
+                if (MONAD_UNLIKELY(
+                        !Group::affine_point_in_group(&*affine_point))) {
+                    valid = false;
+                    return std::nullopt;
+                }
+
+                if (Group::affine_point_is_inf(&*affine_point)) {
+                    continue;
+                }
+
+                auto const &p = affine_points.emplace_back(*affine_point);
+                affine_point_ptrs.emplace_back(&p);
+
+                auto const scalar = read_scalar(ptr + Group::encoded_size);
+
+                auto const &s = scalars.emplace_back(scalar);
+                scalar_ptrs.emplace_back(s.b);
             }
 
-            if (Group::affine_point_is_inf(&*affine_point)) {
-                continue;
+            valid = true;
+            if (affine_point_ptrs.empty()) {
+                return std::nullopt;
             }
 
-            auto const &p = affine_points.emplace_back(*affine_point);
-            affine_point_ptrs.emplace_back(&p);
-
-            auto const scalar = read_scalar(ptr + Group::encoded_size);
-
-            auto const &s = scalars.emplace_back(scalar);
-            scalar_ptrs.emplace_back(s.b);
-        }
-
-        auto *const output_buf =
-            static_cast<uint8_t *>(std::malloc(Group::encoded_size));
-        MONAD_ASSERT(output_buf != nullptr);
-
-        if (affine_point_ptrs.empty()) {
-            std::memset(output_buf, 0, Group::encoded_size);
-        }
-        else {
             auto const n_points = affine_point_ptrs.size();
 
             auto const scratch_size = Group::msm_scratch_size(n_points);
@@ -345,9 +363,69 @@ namespace bls12
                 scalar_ptrs.data(),
                 256u,
                 reinterpret_cast<limb_t *>(scratch.get()));
+            return result;
+        }
+    }
+
+    template <typename Group>
+    PrecompileResult
+    msm_pippenger(byte_string_view const input, uint64_t const k)
+    {
+        static constexpr auto pair_size = Group::encoded_size + 32;
+
+        // The chunks' sums are added in chunk order, and the group law is
+        // exact, so the result does not depend on how the input was split
+        size_t const num_chunks =
+            k < PARALLEL_MSM_MIN_POINTS
+                ? 1
+                : std::min(
+                      static_cast<size_t>(
+                          tbb::this_task_arena::max_concurrency()),
+                      k / PARALLEL_MSM_MIN_CHUNK_POINTS);
+        std::vector<std::optional<typename Group::Point>> sums(num_chunks);
+        std::vector<char> valid(num_chunks, false);
+        auto const run_chunk = [&](size_t const i) {
+            size_t const begin = k * i / num_chunks;
+            size_t const end = k * (i + 1) / num_chunks;
+            bool chunk_valid = false;
+            sums[i] = msm_chunk<Group>(
+                input.data() + begin * pair_size, end - begin, chunk_valid);
+            valid[i] = chunk_valid;
+        };
+        if (num_chunks == 1) {
+            run_chunk(0);
+        }
+        else {
+            tbb::parallel_for(size_t{0}, num_chunks, run_chunk);
+        }
+        if (MONAD_UNLIKELY(!std::ranges::all_of(
+                valid, [](char const v) { return v != 0; }))) {
+            return PrecompileResult::failure();
+        }
 
+        std::optional<typename Group::Point> result;
+        for (auto const &sum : sums) {
+            if (!sum.has_value()) {
+                continue;
+            }
+            if (result.has_value()) {
+                Group::add_points(&*result, &*result, &*sum);
+            }
+            else {
+                result = sum;
+            }
+        }
+
+        auto *const output_buf =
+            static_cast<uint8_t *>(std::malloc(Group::encoded_size));
+        MONAD_ASSERT(output_buf != nullptr);
+
+        if (!result.has_value()) {
+            std::memset(output_buf, 0, Group::encoded_size);
+        }
+        else {
             typename Group::AffinePoint affine_result;
-            Group::to_affine(&affine_result, &result);
+            Group::to_affine(&affine_result, &*result);
 
             Group::write(affine_result, output_buf);
         }
@@ -102,6 +102,7 @@ namespace bls12
         DECLARE_GROUP_FN(read_element, read_fp);
         DECLARE_GROUP_FN(write, write_g1);
         DECLARE_GROUP_FN(add, blst_p1_add_or_double_affine);
+        DECLARE_GROUP_FN(add_points, blst_p1_add_or_double);
         DECLARE_GROUP_FN(map_to_group, blst_map_to_g1);
         DECLARE_GROUP_FN(point_in_group, blst_p1_in_g1);
         DECLARE_GROUP_FN(affine_point_in_group, blst_p1_affine_in_g1);
@@ -128,6 +129,7 @@ namespace bls12
         DECLARE_GROUP_FN(read_element, read_fp2);
         DECLARE_GROUP_FN(write, write_g2);
         DECLARE_GROUP_FN(add, blst_p2_add_or_double_affine);
+        DECLARE_GROUP_FN(add_points, blst_p2_add_or_double);
         DECLARE_GROUP_FN(map_to_group, blst_map_to_g2);
         DECLARE_GROUP_FN(point_in_group, blst_p2_in_g2);
         DECLARE_GROUP_FN(affine_point_in_group, blst_p2_affine_in_g2);
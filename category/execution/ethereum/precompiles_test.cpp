@@ -14,7 +14,9 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/precompile_cache.hpp>
 #include <category/execution/ethereum/precompiles.hpp>
+#include <category/execution/ethereum/precompiles_bls12.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/vm/evm/traits.hpp>
 
@@ -28,10 +30,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "test_resource_data.h"
@@ -748,3 +752,121 @@ TEST(MonadFour, blake2f_valid)
     do_geth_tests<MonadTraits<MONAD_FIVE>>(
         "blake_2f_valid", tests, 0x09_address);
 }
+
+TEST(PrecompileCache, memoizes_expensive_precompiles)
+{
+    auto const tests =
+        load_test_cases(test_resource::geth_vectors_dir / "bn256Pairing.json");
+    ASSERT_FALSE(tests.empty());
+    auto const input =
+        evmc::from_hex(std::string_view{tests.front().input}).value();
+    auto const expected =
+        evmc::from_hex(std::string_view{tests.front().expected}).value();
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+    BlockState bs{tdb, vm};
+    State s{bs, Incarnation{0, 0}};
+
+    auto const call = [&](Address const &code_address, int64_t const gas) {
+        evmc_message const msg = {
+            .gas = gas,
+            .input_data = input.data(),
+            .input_size = input.size(),
+            .code_address = code_address};
+        return check_call_precompile<EvmTraits<EVMC_ISTANBUL>>(s, msg)
+            .value();
+    };
+
+    auto const key = PrecompileCache::key(0x08_address, input);
+    PrecompileCache::Entry entry;
+    for (int i = 0; i < 2; ++i) {
+        auto const result = call(0x08_address, tests.front().gas);
+        ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+        EXPECT_EQ(
+            byte_string_view(result.output_data, result.output_size),
+            byte_string_view(expected.data(), expected.size()));
+        ASSERT_TRUE(precompile_cache().find(key, entry));
+        EXPECT_EQ(entry.output, byte_string(expected.data(), expected.size()));
+    }
+
+    // a cached result still charges for the call
+    EXPECT_EQ(
+        call(0x08_address, tests.front().gas - 1).status_code,
+        EVMC_OUT_OF_GAS);
+
+    // cheap precompiles are not cached
+    EXPECT_EQ(call(0x02_address, 100'000).status_code, EVMC_SUCCESS);
+    EXPECT_FALSE(precompile_cache().find(
+        PrecompileCache::key(0x02_address, input), entry));
+}
+
+template <typename Group>
+void check_msm_matches_sequential_sum(size_t const k)
+{
+    using namespace bls12;
+    constexpr auto pair_size = Group::encoded_size + 32;
+
+    byte_string input(k * pair_size, 0);
+    for (size_t i = 0; i < k; ++i) {
+        uint8_t *const pair = input.data() + i * pair_size;
+        uint64_t const factor = 3 * i + 1;
+        typename Group::Point point;
+        if constexpr (std::is_same_v<Group, G1>) {
+            Group::mul(
+                &point,
+                blst_p1_generator(),
+                reinterpret_cast<uint8_t const *>(&factor),
+                64u);
+        }
+        else {
+            Group::mul(
+                &point,
+                blst_p2_generator(),
+                reinterpret_cast<uint8_t const *>(&factor),
+                64u);
+        }
+        typename Group::AffinePoint affine;
+        Group::to_affine(&affine, &point);
+        Group::write(affine, pair);
+        // big endian scalar, leaving every tenth point with a zero scalar
+        pair[pair_size - 1] = static_cast<uint8_t>(i % 10 == 0 ? 0 : i);
+        pair[pair_size - 2] = static_cast<uint8_t>(i >> 3);
+    }
+
+    auto const free_output = [](PrecompileResult const &result) {
+        std::free(result.obuf);
+    };
+
+    // fold the products with the add precompile
+    byte_string sum(Group::encoded_size, 0);
+    for (size_t i = 0; i < k; ++i) {
+        auto const product = mul<Group>(
+            byte_string_view{input}.substr(i * pair_size, pair_size));
+        ASSERT_EQ(product.status_code, EVMC_SUCCESS);
+        byte_string operands = sum;
+        operands.append(product.obuf, product.output_size);
+        free_output(product);
+        auto const added = add<Group>(operands);
+        ASSERT_EQ(added.status_code, EVMC_SUCCESS);
+        sum.assign(added.obuf, added.output_size);
+        free_output(added);
+    }
+
+    auto const result = msm<Group>(input);
+    ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(byte_string(result.obuf, result.output_size), sum);
+    free_output(result);
+
+    // a point off the curve fails however the input is split
+    input[(k - 1) * pair_size + Group::encoded_size - 1] ^= 1;
+    EXPECT_EQ(msm<Group>(input).status_code, EVMC_PRECOMPILE_FAILURE);
+}
+
+TEST(Bls12Msm, parallel_matches_sequential_sum)
+{
+    check_msm_matches_sequential_sum<bls12::G1>(300);
+    check_msm_matches_sequential_sum<bls12::G2>(140);
+}
@@ -142,6 +142,23 @@ constexpr Result<byte_string_view> parse_list_metadata(byte_string_view &enc)
     return payload;
 }
 
+// Number of items in the payload of a list, found by skipping over the
+// headers only; used to size containers before decoding the items
+constexpr Result<size_t> count_list_items(byte_string_view payload)
+{
+    size_t count = 0;
+    while (!payload.empty()) {
+        if (payload[0] >= 0xc0) {
+            BOOST_OUTCOME_TRYV(parse_list_metadata(payload));
+        }
+        else {
+            BOOST_OUTCOME_TRYV(parse_string_metadata(payload));
+        }
+        ++count;
+    }
+    return count;
+}
+
 constexpr Result<byte_string_view> decode_string(byte_string_view &enc)
 {
     return parse_string_metadata(enc);
@@ -0,0 +1,76 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
+#include <category/core/config.hpp>
+#include <category/core/lru/lru_cache.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/**
+ * Bounded cache of recovered transaction signers, keyed by transaction hash.
+ * A transaction proposed again after a failed round, or already seen by the
+ * mempool, then skips ecrecover. Safe for concurrent use.
+ */
+class SignerCache
+{
+public:
+    struct Entry
+    {
+        std::optional<Address> sender{};
+        std::vector<std::optional<Address>> authorities{};
+    };
+
+private:
+    using Cache = LruCache<bytes32_t, Entry, BytesHashCompare<bytes32_t>>;
+
+    Cache cache_;
+
+public:
+    explicit SignerCache(size_t const max_size)
+        : cache_{max_size}
+    {
+    }
+
+    bool find(bytes32_t const &tx_hash, Entry &entry)
+    {
+        Cache::ConstAccessor acc{};
+        if (!cache_.find(acc, tx_hash)) {
+            return false;
+        }
+        entry = acc->second.value_;
+        return true;
+    }
+
+    void insert(bytes32_t const &tx_hash, Entry const &entry)
+    {
+        cache_.insert(tx_hash, entry);
+    }
+
+    size_t size() const
+    {
+        return cache_.size();
+    }
+};
+
+MONAD_NAMESPACE_END
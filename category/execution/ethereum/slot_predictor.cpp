@@ -0,0 +1,285 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/slot_predictor.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+using KeySource = SlotPredictor::KeySource;
+using Slot = SlotPredictor::Slot;
+
+// key . base, hashed into the slot of a mapping entry
+using Preimage = std::array<uint8_t, 2 * sizeof(bytes32_t)>;
+
+std::optional<uint32_t> selector_of(Transaction const &tx)
+{
+    if (!tx.to.has_value() || tx.data.size() < 4) {
+        return std::nullopt;
+    }
+    return uint32_t{tx.data[0]} << 24 | uint32_t{tx.data[1]} << 16 |
+           uint32_t{tx.data[2]} << 8 | uint32_t{tx.data[3]};
+}
+
+// The mapping key a call passes through `source`, as the word it is hashed
+// from, or nullopt if the call data is too short for it
+std::optional<bytes32_t> key_of(
+    KeySource const source, uint8_t const word, Transaction const &tx,
+    Address const &sender)
+{
+    bytes32_t key{};
+    switch (source) {
+    case KeySource::Sender:
+        std::memcpy(
+            key.bytes + sizeof(bytes32_t) - sizeof(Address),
+            sender.bytes,
+            sizeof(Address));
+        return key;
+    case KeySource::CallData: {
+        size_t const offset = 4 + size_t{word} * sizeof(bytes32_t);
+        if (tx.data.size() < offset + sizeof(bytes32_t)) {
+            return std::nullopt;
+        }
+        std::memcpy(key.bytes, tx.data.data() + offset, sizeof(bytes32_t));
+        return key;
+    }
+    case KeySource::None:
+        break;
+    }
+    return std::nullopt;
+}
+
+Preimage preimage_of(bytes32_t const &key, bytes32_t const &base)
+{
+    Preimage preimage;
+    std::memcpy(preimage.data(), key.bytes, sizeof(bytes32_t));
+    std::memcpy(
+        preimage.data() + sizeof(bytes32_t), base.bytes, sizeof(bytes32_t));
+    return preimage;
+}
+
+std::vector<hash256> hash_all(std::vector<Preimage> const &preimages)
+{
+    std::vector<byte_string_view> in;
+    in.reserve(preimages.size());
+    for (auto const &preimage : preimages) {
+        in.emplace_back(preimage.data(), preimage.size());
+    }
+    std::vector<hash256> out(in.size());
+    keccak256(in, out);
+    return out;
+}
+
+// The slot each learnt slot names for a call, or nullopt where the call has
+// no key for it
+std::vector<std::optional<bytes32_t>> resolve(
+    std::vector<Slot> const &slots, Transaction const &tx,
+    Address const &sender)
+{
+    std::vector<std::optional<bytes32_t>> resolved(slots.size());
+    std::vector<Preimage> preimages;
+    std::vector<size_t> entries;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        auto const &slot = slots[i];
+        if (slot.source == KeySource::None) {
+            resolved[i] = slot.slot;
+            continue;
+        }
+        if (auto const key = key_of(slot.source, slot.word, tx, sender);
+            key.has_value()) {
+            preimages.push_back(preimage_of(key.value(), slot.slot));
+            entries.push_back(i);
+        }
+    }
+    auto const hashes = hash_all(preimages);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        resolved[entries[i]] = to_bytes(hashes[i]);
+    }
+    return resolved;
+}
+
+// Upper bound of the hashes `discover` computes
+constexpr size_t DISCOVERY_HASHES =
+    (1 + SlotPredictor::MAX_KEY_WORDS) * SlotPredictor::MAX_BASE;
+
+// How a slot read by a call is learnt: as the entry for one of the call's
+// keys of a mapping at one of the first bases, otherwise as the slot itself
+Slot discover(
+    bytes32_t const &read, Transaction const &tx, Address const &sender)
+{
+    struct Candidate
+    {
+        KeySource source;
+        uint8_t word;
+        bytes32_t base;
+    };
+
+    std::vector<Candidate> candidates;
+    std::vector<Preimage> preimages;
+    auto const add_key = [&](KeySource const source, uint8_t const word) {
+        auto const key = key_of(source, word, tx, sender);
+        if (!key.has_value()) {
+            return;
+        }
+        for (uint64_t base = 0; base < SlotPredictor::MAX_BASE; ++base) {
+            candidates.push_back(
+                {.source = source, .word = word, .base = bytes32_t{base}});
+            preimages.push_back(preimage_of(key.value(), bytes32_t{base}));
+        }
+    };
+    add_key(KeySource::Sender, 0);
+    for (uint8_t word = 0; word < SlotPredictor::MAX_KEY_WORDS; ++word) {
+        add_key(KeySource::CallData, word);
+    }
+
+    auto const hashes = hash_all(preimages);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (to_bytes(hashes[i]) == read) {
+            auto const &[source, word, base] = candidates[i];
+            return Slot{.slot = base, .source = source, .word = word};
+        }
+    }
+    return Slot{.slot = read};
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+size_t SlotPredictor::num_contracts() const
+{
+    return contracts_.size();
+}
+
+std::vector<bytes32_t> SlotPredictor::predict(
+    Transaction const &tx, Address const &sender) const
+{
+    std::vector<bytes32_t> predicted;
+    auto const selector = selector_of(tx);
+    if (!selector.has_value()) {
+        return predicted;
+    }
+    auto const it = contracts_.find(tx.to.value());
+    if (it == contracts_.end()) {
+        return predicted;
+    }
+    auto const function =
+        std::ranges::find(it->second, selector.value(), &Function::selector);
+    if (function == it->second.end()) {
+        return predicted;
+    }
+    for (auto const &slot : resolve(function->slots, tx, sender)) {
+        if (slot.has_value()) {
+            predicted.push_back(slot.value());
+        }
+    }
+    return predicted;
+}
+
+void SlotPredictor::update(
+    std::vector<Transaction> const &transactions,
+    std::vector<Address> const &senders, BlockMetrics const &metrics)
+{
+    MONAD_ASSERT(senders.size() == transactions.size());
+    auto const slot_reads = metrics.txn_slot_reads();
+    size_t const n = std::min(transactions.size(), slot_reads.size());
+    size_t hashes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto const &tx = transactions[i];
+        auto const selector = selector_of(tx);
+        if (!selector.has_value()) {
+            continue;
+        }
+        auto const &reads = slot_reads[i];
+        auto contract = contracts_.find(tx.to.value());
+        if (contract == contracts_.end()) {
+            if (reads.empty() || contracts_.size() >= MAX_CONTRACTS) {
+                continue;
+            }
+            contract = contracts_.try_emplace(tx.to.value()).first;
+        }
+        auto &functions = contract->second;
+        auto function =
+            std::ranges::find(functions, selector.value(), &Function::selector);
+        if (function == functions.end()) {
+            if (reads.empty()) {
+                continue;
+            }
+            functions.push_back(Function{.selector = selector.value()});
+            function = std::prev(functions.end());
+        }
+
+        // Every call ages the learnt slots of its function, and refreshes
+        // the ones it read
+        auto &slots = function->slots;
+        for (auto const &slot : slots) {
+            hashes += slot.source != KeySource::None;
+        }
+        if (hashes > MAX_UPDATE_HASHES) {
+            break;
+        }
+        for (auto &slot : slots) {
+            --slot.score;
+        }
+        auto const resolved = resolve(slots, tx, senders[i]);
+        size_t discoveries = 0;
+        for (auto const &read : reads) {
+            bool predicted = false;
+            for (size_t j = 0; j < resolved.size(); ++j) {
+                if (resolved[j] == read) {
+                    slots[j].score = MAX_SCORE;
+                    predicted = true;
+                }
+            }
+            if (predicted || slots.size() >= MAX_SLOTS) {
+                continue;
+            }
+            if (discoveries < MAX_DISCOVERIES &&
+                hashes + DISCOVERY_HASHES <= MAX_UPDATE_HASHES) {
+                slots.push_back(discover(read, tx, senders[i]));
+                hashes += DISCOVERY_HASHES;
+                ++discoveries;
+            }
+            else {
+                slots.push_back(Slot{.slot = read});
+            }
+        }
+        std::erase_if(slots, [](Slot const &slot) { return slot.score == 0; });
+        if (slots.empty()) {
+            functions.erase(function);
+        }
+        if (functions.empty()) {
+            contracts_.erase(contract);
+        }
+    }
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,108 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <ankerl/unordered_dense.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockMetrics;
+struct Transaction;
+
+/**
+ * Predicts the storage slots of its recipient that a call will read, from
+ * the slots that recent calls of the same function read. Functions are
+ * keyed by the called contract and the 4-byte selector of the call data.
+ *
+ * A slot is learnt either as a fixed slot or as a Solidity mapping entry,
+ * keccak256(key . base), whose key is the sender or a word of the call
+ * data, as with the `balances[from]` and `balances[to]` of a token
+ * transfer. The prediction for a new call computes the entries for its own
+ * keys. A learnt slot decays when calls of its function stop reading it.
+ *
+ * The slots each transaction read are recorded in `BlockMetrics`, when
+ * `init_txn_slot_reads` was called before the block executed.
+ */
+class SlotPredictor
+{
+public:
+    // calls of a function a learnt slot stays predicted after its last read
+    static constexpr uint8_t MAX_SCORE = 8;
+    // learnt slots per function
+    static constexpr size_t MAX_SLOTS = 16;
+    // slots of a call looked up as mapping entries, which costs a hash per
+    // candidate key and base; the others are learnt as fixed slots
+    static constexpr size_t MAX_DISCOVERIES = 2;
+    // call data words tried as mapping keys
+    static constexpr size_t MAX_KEY_WORDS = 3;
+    // mapping bases tried, the state variables declared first
+    static constexpr uint64_t MAX_BASE = 16;
+    // hashes computed by one update, which runs between blocks; later calls
+    // of the block are not learnt from
+    static constexpr size_t MAX_UPDATE_HASHES = 4096;
+    // contracts learnt; calls of other contracts are not learnt until some
+    // of these decay
+    static constexpr size_t MAX_CONTRACTS = size_t{1} << 16;
+
+    enum class KeySource : uint8_t
+    {
+        None,
+        Sender,
+        CallData,
+    };
+
+    struct Slot
+    {
+        // the slot itself, or the base of the mapping
+        bytes32_t slot{};
+        KeySource source{KeySource::None};
+        // the call data word of the key
+        uint8_t word{0};
+        uint8_t score{MAX_SCORE};
+    };
+
+private:
+    struct Function
+    {
+        uint32_t selector;
+        std::vector<Slot> slots{};
+    };
+
+    ankerl::unordered_dense::segmented_map<Address, std::vector<Function>>
+        contracts_{};
+
+public:
+    size_t num_contracts() const;
+
+    // The slots of the recipient of a transaction it is predicted to read
+    std::vector<bytes32_t>
+    predict(Transaction const &, Address const &sender) const;
+
+    // Learn from the slots recorded while executing a block
+    void update(
+        std::vector<Transaction> const &, std::vector<Address> const &senders,
+        BlockMetrics const &);
+};
+
+MONAD_NAMESPACE_END
@@ -17,6 +17,7 @@
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 #include <category/core/likely.h>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/block.hpp>
@@ -24,8 +25,10 @@
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/core/withdrawal.hpp>
 #include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/event/record_block_events.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/state2/fmt/state_deltas_fmt.hpp> // NOLINT
+#include <category/execution/ethereum/state2/multi_version_state.hpp>
 #include <category/execution/ethereum/state2/state_deltas.hpp>
 #include <category/execution/ethereum/state3/account_state.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
@@ -36,10 +39,15 @@
 
 #include <ankerl/unordered_dense.h>
 
+#include <boost/fiber/operations.hpp>
+
 #include <quill/Quill.h>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -52,6 +60,13 @@ BlockState::BlockState(Db &db, vm::VM &monad_vm)
 {
 }
 
+BlockState::BlockState(Db &db, vm::VM &monad_vm, StateDeltas const &reads)
+    : db_{db}
+    , vm_{monad_vm}
+    , state_(std::make_unique<StateDeltas>(reads))
+{
+}
+
 std::optional<Account> BlockState::read_account(Address const &address)
 {
     // block state
@@ -63,6 +78,10 @@ std::optional<Account> BlockState::read_account(Address const &address)
         }
     }
     // database
+    if (MONAD_UNLIKELY(!begin_db_read())) {
+        return std::nullopt;
+    }
+    std::optional<Account> account;
     {
         auto const result = db_.read_account(address);
         StateDeltas::const_accessor it{};
@@ -70,29 +89,34 @@ std::optional<Account> BlockState::read_account(Address const &address)
             it,
             address,
             StateDelta{.account = {result, result}, .storage = {}});
-        return it->second.account.second;
+        account = it->second.account.second;
     }
+    end_db_read();
+    return account;
 }
 
 bytes32_t BlockState::read_storage(
     Address const &address, Incarnation const incarnation, bytes32_t const &key)
 {
+    wait_for_write_back(address);
     bool read_storage = false;
     // block state
     {
         StateDeltas::const_accessor it{};
         MONAD_ASSERT(state_);
-        MONAD_ASSERT(state_->find(it, address));
+        if (MONAD_UNLIKELY(!state_->find(it, address))) {
+            // the account was read after the block state was detached
+            MONAD_ASSERT(detached_.load(std::memory_order_acquire));
+            return {};
+        }
         auto const &account = it->second.account.second;
         if (!account || incarnation != account->incarnation) {
             return {};
         }
         auto const &storage = it->second.storage;
-        {
-            StorageDeltas::const_accessor it2{};
-            if (MONAD_LIKELY(storage.find(it2, key))) {
-                return it2->second.second;
-            }
+        if (auto const it2 = storage.find(key);
+            MONAD_LIKELY(it2 != storage.end())) {
+            return it2->second.second;
         }
         auto const &orig_account = it->second.account.first;
         if (orig_account && incarnation == orig_account->incarnation) {
@@ -100,6 +124,10 @@ bytes32_t BlockState::read_storage(
         }
     }
     // database
+    if (MONAD_UNLIKELY(!begin_db_read())) {
+        return {};
+    }
+    bytes32_t value;
     {
         auto const result = read_storage
                                 ? db_.read_storage(address, incarnation, key)
@@ -108,15 +136,44 @@ bytes32_t BlockState::read_storage(
         MONAD_ASSERT(state_->find(it, address));
         auto const &account = it->second.account.second;
         if (!account || incarnation != account->incarnation) {
-            return result;
+            value = result;
         }
-        auto &storage = it->second.storage;
-        {
-            StorageDeltas::const_accessor it2{};
-            storage.emplace(it2, key, std::make_pair(result, result));
-            return it2->second.second;
+        else {
+            auto &storage = it->second.storage;
+            auto const it2 = storage.try_emplace(key, result, result).first;
+            value = it2->second.second;
         }
     }
+    end_db_read();
+    return value;
+}
+
+std::optional<Account>
+BlockState::read_account(Address const &address, Incarnation const reader)
+{
+    // the block state must hold every account that is read, as the merge
+    // validates against it
+    auto account = read_account(address);
+    if (MONAD_UNLIKELY(versions_ != nullptr)) {
+        if (auto version = versions_->read_account(address, reader.get_tx())) {
+            return std::move(version).value();
+        }
+    }
+    return account;
+}
+
+bytes32_t BlockState::read_storage(
+    Address const &address, Incarnation const incarnation, bytes32_t const &key,
+    Incarnation const reader)
+{
+    auto const value = read_storage(address, incarnation, key);
+    if (MONAD_UNLIKELY(versions_ != nullptr)) {
+        if (auto const version = versions_->read_storage(
+                address, incarnation, key, reader.get_tx())) {
+            return version.value();
+        }
+    }
+    return value;
 }
 
 vm::SharedVarcode BlockState::read_code(bytes32_t const &code_hash)
@@ -132,24 +189,142 @@ vm::SharedVarcode BlockState::read_code(bytes32_t const &code_hash)
             return vm_.try_insert_varcode(code_hash, it->second);
         }
     }
+    // unmerged transactions, whose code the vm may not have admitted
+    if (MONAD_UNLIKELY(versions_ != nullptr)) {
+        if (auto const icode = versions_->read_code(code_hash)) {
+            return vm_.try_insert_varcode(code_hash, icode);
+        }
+    }
     // database
+    if (MONAD_UNLIKELY(!begin_db_read())) {
+        // kept out of the vm, where it would stand for the code of the hash
+        return std::make_shared<vm::Varcode>(vm::make_shared_intercode({}));
+    }
+    auto const result = db_.read_code(code_hash);
+    end_db_read();
+    MONAD_ASSERT(result);
+    MONAD_ASSERT(code_hash == NULL_HASH || result->size() != 0);
+    return vm_.try_insert_varcode(code_hash, result);
+}
+
+size_t BlockState::read_code_size(bytes32_t const &code_hash)
+{
+    // vm
+    if (auto vcode = vm_.find_varcode(code_hash)) {
+        return (*vcode)->intercode()->size();
+    }
+    // block state
     {
-        auto const result = db_.read_code(code_hash);
-        MONAD_ASSERT(result);
-        MONAD_ASSERT(code_hash == NULL_HASH || result->size() != 0);
-        return vm_.try_insert_varcode(code_hash, result);
+        Code::const_accessor it{};
+        if (code_.find(it, code_hash)) {
+            return it->second->size();
+        }
+    }
+    // unmerged transactions
+    if (MONAD_UNLIKELY(versions_ != nullptr)) {
+        if (auto const icode = versions_->read_code(code_hash)) {
+            return icode->size();
+        }
+    }
+    // database
+    if (MONAD_UNLIKELY(!begin_db_read())) {
+        return 0;
+    }
+    size_t const size = db_.read_code_size(code_hash);
+    end_db_read();
+    MONAD_ASSERT(code_hash == NULL_HASH || size != 0);
+    return size;
+}
+
+void BlockState::enable_conflict_tracking()
+{
+    track_conflicts_ = true;
+}
+
+void BlockState::enable_multi_version_reads()
+{
+    versions_ = std::make_unique<MultiVersionState>();
+}
+
+void BlockState::enable_detach()
+{
+    detachable_ = true;
+}
+
+bool BlockState::begin_db_read()
+{
+    if (MONAD_LIKELY(!detachable_)) {
+        return true;
+    }
+    // Counted in before looking at the flag, so that `detach` either waits
+    // for this read or the read sees the flag
+    n_db_reads_.fetch_add(1, std::memory_order_seq_cst);
+    if (detached_.load(std::memory_order_seq_cst)) {
+        n_db_reads_.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void BlockState::end_db_read()
+{
+    if (MONAD_UNLIKELY(detachable_)) {
+        n_db_reads_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void BlockState::detach()
+{
+    MONAD_ASSERT(detachable_);
+    detached_.store(true, std::memory_order_seq_cst);
+    while (n_db_reads_.load(std::memory_order_acquire) != 0) {
+        boost::this_fiber::yield();
+    }
+}
+
+void BlockState::publish(
+    State const &state, std::span<Address const> const pending)
+{
+    if (versions_ != nullptr) {
+        versions_->publish(state, pending);
+    }
+}
+
+void BlockState::retract(State const &state)
+{
+    if (versions_ != nullptr) {
+        versions_->retract(state.incarnation().get_tx());
     }
 }
 
-bool BlockState::can_merge(State &state) const
+uint64_t BlockState::num_versioned_reads() const
+{
+    return versions_ != nullptr ? versions_->num_reads() : 0;
+}
+
+bool BlockState::can_merge(State &state, MergeConflict *const conflict) const
 {
     MONAD_ASSERT(state_);
+    auto const on_conflict = [this, conflict](
+                                 Address const &address,
+                                 std::optional<bytes32_t> const &key) {
+        if (conflict) {
+            conflict->address = address;
+            conflict->key = key;
+            conflict->writer.reset();
+            if (auto const it = writers_.find(address); it != writers_.end()) {
+                conflict->writer = it->second;
+            }
+        }
+        return false;
+    };
     auto &original = state.original();
     for (auto &kv : original) {
         Address const &address = kv.first;
         OriginalAccountState &account_state = kv.second;
         auto const &account = account_state.account_;
         auto const &storage = account_state.storage_;
+        wait_for_write_back(address);
         StateDeltas::const_accessor it{};
         MONAD_ASSERT(state_->find(it, address));
         if (account != it->second.account.second) {
@@ -158,20 +333,21 @@ bool BlockState::can_merge(State &state) const
             // state up until this transaction
             if (!state.try_fix_account_mismatch(
                     address, account_state, it->second.account.second)) {
-                return false;
+                return on_conflict(address, std::nullopt);
             }
         }
         // TODO account.has_value()???
+        auto const &block_storage = it->second.storage;
         for (auto const &[key, value] : storage) {
-            StorageDeltas::const_accessor it2{};
-            if (it->second.storage.find(it2, key)) {
+            auto const it2 = block_storage.find(key);
+            if (it2 != block_storage.end()) {
                 if (value != it2->second.second) {
-                    return false;
+                    return on_conflict(address, key);
                 }
             }
             else {
                 if (value) {
-                    return false;
+                    return on_conflict(address, key);
                 }
             }
         }
@@ -179,8 +355,43 @@ bool BlockState::can_merge(State &state) const
     return true;
 }
 
+void BlockState::carry_over_reads(State const &from, State &to) const
+{
+    MONAD_ASSERT(state_);
+    auto &original = to.original();
+    for (auto const &[address, account_state] : from.original()) {
+        wait_for_write_back(address);
+        StateDeltas::const_accessor it{};
+        MONAD_ASSERT(state_->find(it, address));
+        auto const &account = it->second.account.second;
+        if (account_state.account_ != account) {
+            continue;
+        }
+        auto &fresh = original.try_emplace(address, account).first->second;
+        auto const &block_storage = it->second.storage;
+        for (auto const &[key, value] : account_state.storage_) {
+            auto const it2 = block_storage.find(key);
+            if (it2 != block_storage.end() && value == it2->second.second) {
+                fresh.storage_.try_emplace(key, value);
+            }
+        }
+    }
+}
+
 void BlockState::merge(State const &state)
 {
+    merge_accounts(state);
+    merge_storage(state);
+}
+
+void BlockState::merge_accounts(State const &state)
+{
+    static LatencyMetric &latency = latency_metric(
+        "monad_block_state_merge_seconds",
+        "time to merge the state of a transaction into the block state, in "
+        "transaction order");
+    ScopedLatency const timer{latency};
+
     ankerl::unordered_dense::segmented_set<bytes32_t> code_hashes;
 
     auto const &current = state.current();
@@ -203,30 +414,98 @@ void BlockState::merge(State const &state)
         code_.emplace(code_hash, it->second->intercode()); // TODO try_emplace
     }
 
+    uint64_t const tx = state.incarnation().get_tx();
+    if (MONAD_UNLIKELY(track_conflicts_)) {
+        if (tx != 0 && tx != Incarnation::LAST_TX) {
+            auto const &original = state.original();
+            for (auto const &[address, stack] : current) {
+                auto const &account_state = stack.recent();
+                auto const it = original.find(address);
+                if (!account_state.storage_.empty() || it == original.end() ||
+                    account_state.account_ != it->second.account_) {
+                    writers_[address] = tx - 1;
+                }
+            }
+        }
+    }
+
     MONAD_ASSERT(state_);
     for (auto const &[address, stack] : current) {
         auto const &account_state = stack.recent();
         auto const &account = account_state.account_;
-        auto const &storage = account_state.storage_;
+        // the storage of an earlier transaction must be written back first,
+        // or it would land after this one clears or overwrites it
+        wait_for_write_back(address);
         StateDeltas::accessor it{};
         MONAD_ASSERT(state_->find(it, address));
         it->second.account.second = account;
-        if (account.has_value()) {
+        if (!account.has_value()) {
+            it->second.storage.clear();
+        }
+        else if (!account_state.storage_.empty()) {
+            MONAD_ASSERT(write_backs_.emplace(address, tx));
+            n_write_backs_.fetch_add(1, std::memory_order::release);
+        }
+    }
+}
+
+void BlockState::merge_storage(State const &state)
+{
+    MONAD_ASSERT(state_);
+    for (auto const &[address, stack] : state.current()) {
+        auto const &account_state = stack.recent();
+        auto const &storage = account_state.storage_;
+        if (!account_state.account_.has_value() || storage.empty()) {
+            continue;
+        }
+        {
+            StateDeltas::accessor it{};
+            MONAD_ASSERT(state_->find(it, address));
             for (auto const &[key, value] : storage) {
-                StorageDeltas::accessor it2{};
-                if (it->second.storage.find(it2, key)) {
+                auto const [it2, inserted] =
+                    it->second.storage.try_emplace(key, bytes32_t{}, value);
+                if (!inserted) {
                     it2->second.second = value;
                 }
-                else {
-                    it->second.storage.emplace(
-                        key, std::make_pair(bytes32_t{}, value));
-                }
             }
         }
-        else {
-            it->second.storage.clear();
+        MONAD_ASSERT(write_backs_.erase(address));
+        n_write_backs_.fetch_sub(1, std::memory_order::release);
+    }
+
+    if (MONAD_UNLIKELY(versions_ != nullptr)) {
+        versions_->retract(state.incarnation().get_tx());
+    }
+}
+
+void BlockState::wait_for_write_back(Address const &address) const
+{
+    if (MONAD_LIKELY(n_write_backs_.load(std::memory_order::acquire) == 0)) {
+        return;
+    }
+    while (write_backs_.count(address) != 0) {
+        boost::this_fiber::yield();
+    }
+}
+
+std::unique_ptr<StateDeltas> BlockState::read_set() const
+{
+    MONAD_ASSERT(state_);
+    auto reads = std::make_unique<StateDeltas>();
+    for (auto const &[address, delta] : *state_) {
+        auto const &[original, current] = delta.account;
+        StateDelta read{.account = {original, original}, .storage = {}};
+        // Slots are read at the incarnation of the current account, so
+        // their originals are only database values while it is unchanged
+        if (original.has_value() && current.has_value() &&
+            original->incarnation == current->incarnation) {
+            for (auto const &[key, value] : delta.storage) {
+                read.storage.try_emplace(key, value.first, value.first);
+            }
         }
+        reads->emplace(address, std::move(read));
     }
+    return reads;
 }
 
 void BlockState::commit(
@@ -236,8 +515,11 @@ void BlockState::commit(
     std::vector<Address> const &senders,
     std::vector<Transaction> const &transactions,
     std::vector<BlockHeader> const &ommers,
-    std::optional<std::vector<Withdrawal>> const &withdrawals)
+    std::optional<std::vector<Withdrawal>> const &withdrawals,
+    std::vector<bytes32_t> const &tx_hashes)
 {
+    MONAD_ASSERT(state_);
+    record_state_diff_events(*state_);
     db_.commit(
         std::move(state_),
         code_,
@@ -248,7 +530,8 @@ void BlockState::commit(
         senders,
         transactions,
         ommers,
-        withdrawals);
+        withdrawals,
+        tx_hashes);
 }
 
 void BlockState::log_debug()
@@ -15,18 +15,26 @@
 
 #pragma once
 
+#include <category/core/assert.h>
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
+#include <category/execution/ethereum/state2/multi_version_state.hpp>
 #include <category/execution/ethereum/state2/state_deltas.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/types/incarnation.hpp>
 #include <category/vm/vm.hpp>
 
+#include <ankerl/unordered_dense.h>
+
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 MONAD_NAMESPACE_BEGIN
@@ -39,10 +47,31 @@ class BlockState final
     vm::VM &vm_;
     std::unique_ptr<StateDeltas> state_;
     Code code_;
+    bool track_conflicts_{false};
+    ankerl::unordered_dense::segmented_map<Address, uint64_t> writers_{};
+    std::unique_ptr<MultiVersionState> versions_{};
+    // The accounts whose storage a transaction that has released the next
+    // one still has to write back, with that transaction
+    oneapi::tbb::concurrent_hash_map<Address, uint64_t> write_backs_{};
+    std::atomic<uint64_t> n_write_backs_{0};
+    bool detachable_{false};
+    std::atomic<bool> detached_{false};
+    // The database reads issued and not yet in the block state, counted
+    // only when detachable
+    std::atomic<uint64_t> n_db_reads_{0};
+
+    void wait_for_write_back(Address const &) const;
+    bool begin_db_read();
+    void end_db_read();
 
 public:
     BlockState(Db &, vm::VM &);
 
+    // Start from the reads of an earlier block on the same parent, taken
+    // with `read_set`, so that the reads it shares with this block are not
+    // issued to the database again
+    BlockState(Db &, vm::VM &, StateDeltas const &reads);
+
     vm::VM &vm()
     {
         return vm_;
@@ -52,12 +81,75 @@ public:
 
     bytes32_t read_storage(Address const &, Incarnation, bytes32_t const &key);
 
+    // Read as the transaction of incarnation `reader`: with multi-version
+    // reads enabled, the writes published by a lower transaction that has not
+    // merged yet take precedence over the block state
+    std::optional<Account> read_account(Address const &, Incarnation reader);
+
+    bytes32_t read_storage(
+        Address const &, Incarnation, bytes32_t const &key, Incarnation reader);
+
     vm::SharedVarcode read_code(bytes32_t const &);
 
-    bool can_merge(State &) const;
+    // does not build or cache the intercode of code that is not loaded yet
+    size_t read_code_size(bytes32_t const &);
+
+    // Record the last transaction to write each account so that merge
+    // conflicts can be attributed to the transaction that caused them
+    void enable_conflict_tracking();
+
+    // Let transactions read the writes of lower transactions that have
+    // executed but not merged, see `MultiVersionState`
+    void enable_multi_version_reads();
+
+    // Let `detach` cut the block state off from the database
+    void enable_detach();
+
+    // Stop reading the database, once the reads already issued are in the
+    // block state: later reads it cannot answer find nothing and are not
+    // kept. The transactions still running on it then finish on their own
+    // without touching the database or the block state, which `read_set`
+    // can therefore take right away.
+    void detach();
+
+    // With multi-version reads enabled, publish the writes of a transaction
+    // that has executed, except to the accounts in `pending`, until it merges
+    void publish(State const &, std::span<Address const> pending);
+
+    // Withdraw what was published for the transaction of `state` without
+    // merging it, e.g. because it failed validation and runs again
+    void retract(State const &);
+
+    // The number of reads answered by a published write
+    uint64_t num_versioned_reads() const;
+
+    bool can_merge(State &, MergeConflict * = nullptr) const;
+
+    // Seed the original state of `to` with the reads of `from` that are still
+    // current, so that re-executing a transaction after a merge conflict only
+    // has to read the accounts and slots that went stale
+    void carry_over_reads(State const &from, State &to) const;
 
     void merge(State const &);
 
+    // The two phases of `merge`. Only the first has to run in transaction
+    // order, so the next transaction can be released in between: it writes
+    // the accounts and marks those whose storage the second phase still has
+    // to write. Every later access to the storage of a marked account waits
+    // for its write-back.
+    void merge_accounts(State const &);
+    void merge_storage(State const &);
+
+    // The database values read by the block, as deltas that change nothing
+    std::unique_ptr<StateDeltas> read_set() const;
+
+    // The merged changes of the block, until commit consumes them
+    StateDeltas const &state_deltas() const
+    {
+        MONAD_ASSERT(state_);
+        return *state_;
+    }
+
     void commit(
         bytes32_t const &block_id, BlockHeader const &,
         std::vector<Receipt> const & = {},
@@ -65,7 +157,8 @@ public:
         std::vector<Address> const & = {},
         std::vector<Transaction> const & = {},
         std::vector<BlockHeader> const &ommers = {},
-        std::optional<std::vector<Withdrawal>> const & = {});
+        std::optional<std::vector<Withdrawal>> const & = {},
+        std::vector<bytes32_t> const &tx_hashes = {});
 
     void log_debug();
 };
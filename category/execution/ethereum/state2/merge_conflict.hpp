@@ -0,0 +1,36 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <cstdint>
+#include <optional>
+
+MONAD_NAMESPACE_BEGIN
+
+// Describes why `BlockState::can_merge` rejected a transaction's state
+struct MergeConflict
+{
+    Address address{};
+    std::optional<bytes32_t> key{}; // set if the conflict is on a storage slot
+    std::optional<uint64_t> writer{}; // last merged transaction to write to
+                                      // `address`, if conflict tracking is on
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,181 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/state2/multi_version_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/vm/code.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+// The version of the highest transaction lower than `reader`
+template <class V>
+V const *
+find_version(std::map<uint64_t, V> const &versions, uint64_t const reader)
+{
+    auto it = versions.lower_bound(reader);
+    if (it == versions.begin()) {
+        return nullptr;
+    }
+    return &(--it)->second;
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+void MultiVersionState::publish(
+    State const &state, std::span<Address const> const pending)
+{
+    uint64_t const txn = state.incarnation().get_tx();
+    auto const &original = state.original();
+    Written written;
+    for (auto const &[address, stack] : state.current()) {
+        if (std::ranges::find(pending, address) != pending.end()) {
+            continue;
+        }
+        auto const &account_state = stack.recent();
+        auto const &account = account_state.account_;
+        auto const it = original.find(address);
+        bool const account_written =
+            it == original.end() || account != it->second.account_;
+        if (!account_written &&
+            (!account.has_value() || account_state.storage_.empty())) {
+            continue;
+        }
+        std::vector<bytes32_t> keys;
+        decltype(versions_)::accessor acc;
+        versions_.insert(acc, address);
+        auto &versions = acc->second;
+        if (account_written) {
+            versions.account.insert_or_assign(txn, account);
+            if (account.has_value()) {
+                auto const code = state.code().find(account->code_hash);
+                if (code != state.code().end()) {
+                    code_.emplace(code->first, code->second->intercode());
+                }
+            }
+        }
+        if (account.has_value()) {
+            for (auto const &[key, value] : account_state.storage_) {
+                versions.storage[key].insert_or_assign(
+                    txn,
+                    StorageVersion{
+                        .incarnation = account->incarnation, .value = value});
+                keys.push_back(key);
+            }
+        }
+        written.emplace_back(address, std::move(keys));
+    }
+    if (!written.empty()) {
+        decltype(written_)::accessor acc;
+        written_.insert(acc, txn);
+        acc->second = std::move(written);
+    }
+}
+
+void MultiVersionState::retract(uint64_t const txn)
+{
+    Written written;
+    {
+        decltype(written_)::accessor acc;
+        if (!written_.find(acc, txn)) {
+            return;
+        }
+        written = std::move(acc->second);
+        written_.erase(acc);
+    }
+    for (auto const &[address, keys] : written) {
+        decltype(versions_)::accessor acc;
+        MONAD_ASSERT(versions_.find(acc, address));
+        auto &versions = acc->second;
+        versions.account.erase(txn);
+        for (auto const &key : keys) {
+            auto const it = versions.storage.find(key);
+            MONAD_ASSERT(it != versions.storage.end());
+            it->second.erase(txn);
+            if (it->second.empty()) {
+                versions.storage.erase(it);
+            }
+        }
+        if (versions.account.empty() && versions.storage.empty()) {
+            versions_.erase(acc);
+        }
+    }
+}
+
+std::optional<std::optional<Account>>
+MultiVersionState::read_account(Address const &address, uint64_t const reader)
+{
+    decltype(versions_)::const_accessor acc;
+    if (!versions_.find(acc, address)) {
+        return std::nullopt;
+    }
+    auto const *const account = find_version(acc->second.account, reader);
+    if (account == nullptr) {
+        return std::nullopt;
+    }
+    n_reads_.fetch_add(1, std::memory_order::relaxed);
+    return std::optional<std::optional<Account>>{std::in_place, *account};
+}
+
+std::optional<bytes32_t> MultiVersionState::read_storage(
+    Address const &address, Incarnation const incarnation,
+    bytes32_t const &key, uint64_t const reader)
+{
+    decltype(versions_)::const_accessor acc;
+    if (!versions_.find(acc, address)) {
+        return std::nullopt;
+    }
+    auto const &storage = acc->second.storage;
+    auto const it = storage.find(key);
+    if (it == storage.end()) {
+        return std::nullopt;
+    }
+    // A version of an earlier incarnation of the account says nothing about
+    // the slot of this one
+    auto const *const slot = find_version(it->second, reader);
+    if (slot == nullptr || slot->incarnation != incarnation) {
+        return std::nullopt;
+    }
+    n_reads_.fetch_add(1, std::memory_order::relaxed);
+    return slot->value;
+}
+
+vm::SharedIntercode
+MultiVersionState::read_code(bytes32_t const &code_hash) const
+{
+    decltype(code_)::const_accessor acc;
+    if (!code_.find(acc, code_hash)) {
+        return nullptr;
+    }
+    return acc->second;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,106 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/vm/code.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <oneapi/tbb/concurrent_hash_map.h>
+#pragma GCC diagnostic pop
+
+#include <ankerl/unordered_dense.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+class State;
+
+// The writes of the transactions of a block that have executed but not yet
+// merged, as versions keyed by the transaction that wrote them, as in
+// Block-STM. A transaction reads the latest version written by a lower
+// transaction, so it sees the writes it depends on without waiting for the
+// merge of every transaction in between. The versions are only a prediction:
+// the merge still validates every read against the block state, so a stale
+// version costs a re-execution, never a wrong result.
+class MultiVersionState
+{
+    struct StorageVersion
+    {
+        Incarnation incarnation;
+        bytes32_t value;
+    };
+
+    struct Versions
+    {
+        std::map<uint64_t, std::optional<Account>> account{};
+        ankerl::unordered_dense::segmented_map<
+            bytes32_t, std::map<uint64_t, StorageVersion>>
+            storage{};
+    };
+
+    using Written = std::vector<std::pair<Address, std::vector<bytes32_t>>>;
+
+    oneapi::tbb::concurrent_hash_map<Address, Versions> versions_{};
+    oneapi::tbb::concurrent_hash_map<uint64_t, Written> written_{};
+    // The code of the published account versions. Code is keyed by its
+    // hash, so it is the same whichever transaction deployed it, and it is
+    // kept when the versions are retracted.
+    Code code_{};
+    std::atomic<uint64_t> n_reads_{0};
+
+public:
+    // Publish the writes of `state` as the versions of its transaction,
+    // except to the accounts in `pending`, which the transaction still has
+    // to change once it is known to merge
+    void publish(State const &, std::span<Address const> pending);
+
+    // Drop the versions of `txn` once its writes are in the block state, or
+    // once they are known to be stale
+    void retract(uint64_t txn);
+
+    // The latest version written by a transaction lower than `reader`, if
+    // any
+    std::optional<std::optional<Account>>
+    read_account(Address const &, uint64_t reader);
+
+    std::optional<bytes32_t> read_storage(
+        Address const &, Incarnation, bytes32_t const &key, uint64_t reader);
+
+    // The code of a published account version, or null
+    vm::SharedIntercode read_code(bytes32_t const &code_hash) const;
+
+    // The number of reads answered by a version rather than the block state
+    uint64_t num_reads() const
+    {
+        return n_reads_.load(std::memory_order::relaxed);
+    }
+};
+
+MONAD_NAMESPACE_END
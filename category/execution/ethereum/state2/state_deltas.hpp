@@ -28,6 +28,8 @@
 #include <oneapi/tbb/concurrent_hash_map.h>
 #pragma GCC diagnostic pop
 
+#include <ankerl/unordered_dense.h>
+
 #include <memory>
 #include <optional>
 #include <utility>
@@ -47,9 +49,14 @@ using StorageDelta = Delta<bytes32_t>;
 static_assert(sizeof(StorageDelta) == 64);
 static_assert(alignof(StorageDelta) == 1);
 
-using StorageDeltas = oneapi::tbb::concurrent_hash_map<bytes32_t, StorageDelta>;
+// The storage of an account is only ever accessed through an accessor on its
+// StateDeltas entry, which already serializes writers against readers, so it
+// does not need a concurrent map of its own. A plain map costs no allocation
+// for accounts whose storage is untouched and keeps the deltas contiguous for
+// iteration on commit.
+using StorageDeltas =
+    ankerl::unordered_dense::segmented_map<bytes32_t, StorageDelta>;
 
-static_assert(sizeof(StorageDeltas) == 576);
 static_assert(alignof(StorageDeltas) == 8);
 
 struct StateDelta
@@ -58,7 +65,7 @@ struct StateDelta
     StorageDeltas storage{};
 };
 
-static_assert(sizeof(StateDelta) == 752);
+static_assert(sizeof(StateDelta) <= 256);
 static_assert(alignof(StateDelta) == 8);
 
 using StateDeltas = oneapi::tbb::concurrent_hash_map<Address, StateDelta>;
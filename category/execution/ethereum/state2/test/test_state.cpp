@@ -28,6 +28,7 @@
 #include <category/execution/ethereum/db/trie_db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
 #include <category/execution/ethereum/state2/state_deltas.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/mpt/db.hpp>
@@ -36,8 +37,12 @@
 #include <category/mpt/util.hpp>
 #include <category/vm/code.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/varcode_cache.hpp>
 #include <category/vm/vm.hpp>
 
+#include <boost/fiber/fiber.hpp>
+#include <boost/fiber/operations.hpp>
+
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
@@ -45,6 +50,7 @@
 
 #include <quill/Quill.h>
 
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -55,6 +61,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 using namespace monad;
 using namespace monad::test;
@@ -762,6 +769,53 @@ TYPED_TEST(StateTest, get_storage)
     EXPECT_EQ(s.get_storage(b, key3), null);
 }
 
+TYPED_TEST(StateTest, access_and_get_storage)
+{
+    BlockState bs{this->tdb, this->vm};
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {a,
+             StateDelta{
+                 .account = {std::nullopt, Account{}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State s{bs, Incarnation{1, 1}};
+    EXPECT_TRUE(s.account_exists(a));
+    bytes32_t value;
+    EXPECT_EQ(s.access_and_get_storage(a, key1, value), EVMC_ACCESS_COLD);
+    EXPECT_EQ(value, value1);
+    EXPECT_EQ(s.access_and_get_storage(a, key1, value), EVMC_ACCESS_WARM);
+    EXPECT_EQ(value, value1);
+    EXPECT_EQ(s.access_and_get_storage(a, key2, value), EVMC_ACCESS_COLD);
+    EXPECT_EQ(value, null);
+
+    // a slot written in a nested frame is read back, and its access status
+    // is rejected along with the frame
+    s.push();
+    EXPECT_EQ(s.set_storage(a, key2, value2), EVMC_STORAGE_ADDED);
+    EXPECT_EQ(s.access_and_get_storage(a, key2, value), EVMC_ACCESS_WARM);
+    EXPECT_EQ(value, value2);
+    EXPECT_EQ(s.access_and_get_storage(a, key3, value), EVMC_ACCESS_COLD);
+    s.pop_reject();
+    EXPECT_EQ(s.access_and_get_storage(a, key2, value), EVMC_ACCESS_WARM);
+    EXPECT_EQ(value, null);
+    EXPECT_EQ(s.access_and_get_storage(a, key3, value), EVMC_ACCESS_COLD);
+
+    // a cold slot that is not loaded is left unread, but still marked as
+    // accessed
+    State s2{bs, Incarnation{1, 2}};
+    value = value3;
+    EXPECT_EQ(
+        s2.access_and_get_storage(a, key1, value, false), EVMC_ACCESS_COLD);
+    EXPECT_EQ(value, value3);
+    EXPECT_EQ(
+        s2.access_and_get_storage(a, key1, value, false), EVMC_ACCESS_WARM);
+    EXPECT_EQ(value, value1);
+}
+
 TYPED_TEST(StateTest, set_storage_modified)
 {
     BlockState bs{this->tdb, this->vm};
@@ -977,6 +1031,9 @@ TYPED_TEST(StateTest, get_code_size)
 
     State s{bs, Incarnation{1, 1}};
     EXPECT_EQ(s.get_code_size(a), code1.size());
+    // the size is read without loading the code into the vm
+    EXPECT_FALSE(this->vm.find_varcode(code_hash1).has_value());
+    EXPECT_EQ(s.get_code_size(b), 0u);
 }
 
 TYPED_TEST(StateTest, copy_code)
@@ -1147,6 +1204,497 @@ TYPED_TEST(StateTest, cant_merge_colliding_storage)
     }
 }
 
+TYPED_TEST(StateTest, merge_conflict_reports_slot_and_writer)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_conflict_tracking();
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value2), EVMC_STORAGE_MODIFIED);
+
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_TRUE(cs.account_exists(b));
+    EXPECT_EQ(cs.get_storage(b, key1), value1);
+
+    MergeConflict conflict;
+    EXPECT_TRUE(bs.can_merge(as, &conflict));
+    bs.merge(as);
+    EXPECT_FALSE(bs.can_merge(cs, &conflict));
+    EXPECT_EQ(conflict.address, b);
+    EXPECT_EQ(conflict.key, key1);
+    EXPECT_EQ(conflict.writer, 0);
+}
+
+TYPED_TEST(StateTest, carry_over_reads_drops_stale_entries)
+{
+    BlockState bs{this->tdb, this->vm};
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage =
+                     {{key1, {bytes32_t{}, value1}},
+                      {key2, {bytes32_t{}, value2}}}}},
+            {c,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 50'000}},
+                 .storage = {}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value3), EVMC_STORAGE_MODIFIED);
+    as.add_to_balance(c, 1);
+
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_TRUE(cs.account_exists(b));
+    EXPECT_EQ(cs.get_storage(b, key1), value1);
+    EXPECT_EQ(cs.get_storage(b, key2), value2);
+    EXPECT_TRUE(cs.account_exists(c));
+
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge(as);
+    EXPECT_FALSE(bs.can_merge(cs));
+
+    State retry{bs, Incarnation{1, 2}};
+    bs.carry_over_reads(cs, retry);
+    auto const &original = retry.original();
+    ASSERT_TRUE(original.contains(b));
+    EXPECT_FALSE(original.contains(c));
+    auto const &storage = original.at(b).storage_;
+    EXPECT_FALSE(storage.contains(key1));
+    ASSERT_TRUE(storage.contains(key2));
+    EXPECT_EQ(storage.at(key2), value2);
+
+    EXPECT_EQ(retry.get_storage(b, key1), value3);
+    EXPECT_EQ(retry.get_balance(c), bytes32_t{50'001});
+    EXPECT_TRUE(bs.can_merge(retry));
+}
+
+TYPED_TEST(StateTest, multi_version_reads_see_unmerged_writes)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_multi_version_reads();
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}},
+            {c,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 50'000}},
+                 .storage = {}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value2), EVMC_STORAGE_MODIFIED);
+    as.add_to_balance(c, 1);
+    bs.publish(as, {});
+
+    // only higher transactions see the versions
+    State own{bs, Incarnation{1, 1}};
+    EXPECT_TRUE(own.account_exists(b));
+    EXPECT_EQ(own.get_storage(b, key1), value1);
+    EXPECT_EQ(bs.num_versioned_reads(), 0);
+
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_TRUE(cs.account_exists(b));
+    EXPECT_EQ(cs.get_storage(b, key1), value2);
+    EXPECT_EQ(cs.get_balance(c), bytes32_t{50'001});
+    EXPECT_EQ(bs.num_versioned_reads(), 2);
+
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge(as);
+    EXPECT_TRUE(bs.can_merge(cs));
+
+    // the merge retracts the versions
+    State ds{bs, Incarnation{1, 3}};
+    EXPECT_EQ(ds.get_balance(c), bytes32_t{50'001});
+    EXPECT_EQ(bs.num_versioned_reads(), 2);
+}
+
+TYPED_TEST(StateTest, multi_version_reads_skip_pending_accounts)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_multi_version_reads();
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value2), EVMC_STORAGE_MODIFIED);
+    std::array<Address, 1> const pending{b};
+    bs.publish(as, pending);
+
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_TRUE(cs.account_exists(b));
+    EXPECT_EQ(cs.get_storage(b, key1), value1);
+    EXPECT_EQ(bs.num_versioned_reads(), 0);
+
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge(as);
+    EXPECT_FALSE(bs.can_merge(cs));
+}
+
+TYPED_TEST(StateTest, multi_version_reads_retracted_without_merge)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_multi_version_reads();
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value2), EVMC_STORAGE_MODIFIED);
+    bs.publish(as, {});
+    bs.retract(as);
+
+    // a transaction that never merges leaves no versions behind
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_EQ(cs.get_storage(b, key1), value1);
+    EXPECT_EQ(bs.num_versioned_reads(), 0);
+    EXPECT_TRUE(bs.can_merge(cs));
+}
+
+TYPED_TEST(StateTest, multi_version_reads_see_unmerged_code)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_multi_version_reads();
+
+    // a full varcode cache of code looked up more often than the deployed
+    // code, which the admission filter then keeps out
+    auto &cache = this->vm.compiler().varcode_cache();
+    cache.set_max_cache_kb(static_cast<uint32_t>(
+        cache.shard_count() * vm::VarcodeCache::code_size_to_cache_weight(1)));
+    for (uint8_t i = 1; i != 0; ++i) {
+        evmc::bytes32 const hash{i};
+        (void)this->vm.try_insert_varcode(hash, icode1);
+        for (int j = 0; j < 8; ++j) {
+            (void)this->vm.find_varcode(hash);
+        }
+    }
+    ASSERT_EQ(cache.size(), cache.shard_count());
+
+    State as{bs, Incarnation{1, 1}};
+    as.create_contract(a);
+    as.set_code(a, code2);
+    bs.publish(as, {});
+    auto const code_hash = as.get_code_hash(a);
+    EXPECT_FALSE(this->vm.find_varcode(code_hash).has_value());
+
+    // a call to the contract in the same block
+    State cs{bs, Incarnation{1, 2}};
+    EXPECT_EQ(cs.get_code_size(a), code2.size());
+    auto const icode = cs.get_code(a)->intercode();
+    EXPECT_EQ(byte_string_view(icode->code(), icode->size()), code2);
+    EXPECT_FALSE(this->vm.find_varcode(code_hash).has_value());
+
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge(as);
+    EXPECT_TRUE(bs.can_merge(cs));
+}
+
+TYPED_TEST(StateTest, storage_reads_wait_for_write_back)
+{
+    BlockState bs{this->tdb, this->vm};
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value2), EVMC_STORAGE_MODIFIED);
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge_accounts(as);
+
+    std::optional<bytes32_t> seen;
+    boost::fibers::fiber reader{[&] {
+        State cs{bs, Incarnation{1, 2}};
+        EXPECT_TRUE(cs.account_exists(b));
+        seen = cs.get_storage(b, key1);
+        EXPECT_TRUE(bs.can_merge(cs));
+    }};
+    boost::this_fiber::yield();
+    EXPECT_FALSE(seen.has_value());
+
+    bs.merge_storage(as);
+    reader.join();
+    EXPECT_EQ(seen, value2);
+}
+
+TYPED_TEST(StateTest, read_set_replays_reads)
+{
+    BlockState bs{this->tdb, this->vm};
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}},
+            {c,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 50'000}},
+                 .storage = {}}}},
+        Code{},
+        BlockHeader{});
+
+    State as{bs, Incarnation{1, 1}};
+    EXPECT_EQ(as.set_storage(b, key1, value3), EVMC_STORAGE_MODIFIED);
+    as.add_to_balance(c, 1);
+    EXPECT_TRUE(bs.can_merge(as));
+    bs.merge(as);
+
+    // the read set holds the database values, not the changes of the block
+    auto const reads = bs.read_set();
+    BlockState replay{this->tdb, this->vm, *reads};
+    EXPECT_EQ(replay.read_storage(b, Incarnation{0, 0}, key1), value1);
+    auto const account = replay.read_account(c);
+    ASSERT_TRUE(account.has_value());
+    EXPECT_EQ(account->balance, 50'000);
+
+    State retry{replay, Incarnation{1, 1}};
+    EXPECT_EQ(retry.set_storage(b, key1, value3), EVMC_STORAGE_MODIFIED);
+    retry.add_to_balance(c, 1);
+    EXPECT_TRUE(replay.can_merge(retry));
+}
+
+TYPED_TEST(StateTest, detached_reads_find_nothing)
+{
+    BlockState bs{this->tdb, this->vm};
+    bs.enable_detach();
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage =
+                     {{key1, {bytes32_t{}, value1}},
+                      {key2, {bytes32_t{}, value2}}}}},
+            {c,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 50'000}},
+                 .storage = {}}}},
+        Code{},
+        BlockHeader{});
+
+    EXPECT_TRUE(bs.read_account(b).has_value());
+    EXPECT_EQ(bs.read_storage(b, Incarnation{0, 0}, key1), value1);
+    bs.detach();
+
+    // what was read before is still answered, the rest is not read at all
+    EXPECT_EQ(bs.read_storage(b, Incarnation{0, 0}, key1), value1);
+    EXPECT_EQ(bs.read_storage(b, Incarnation{0, 0}, key2), bytes32_t{});
+    EXPECT_FALSE(bs.read_account(c).has_value());
+    EXPECT_EQ(bs.read_storage(c, Incarnation{0, 0}, key1), bytes32_t{});
+    EXPECT_EQ(bs.read_code(code_hash1)->intercode()->size(), 0);
+    EXPECT_FALSE(this->vm.find_varcode(code_hash1).has_value());
+
+    auto const reads = bs.read_set();
+    EXPECT_EQ(reads->size(), 1);
+    StateDeltas::const_accessor it;
+    ASSERT_TRUE(reads->find(it, b));
+    EXPECT_EQ(it->second.storage.size(), 1);
+}
+
+TYPED_TEST(StateTest, prefetch_storage)
+{
+    BlockState bs{this->tdb, this->vm};
+
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 40'000}},
+                 .storage =
+                     {{key1, {bytes32_t{}, value1}},
+                      {key2, {bytes32_t{}, value2}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State s{bs, Incarnation{1, 1}};
+    EXPECT_TRUE(s.account_exists(b));
+    std::vector<bytes32_t> const keys{key1, key2, key3};
+    s.prefetch_storage(b, keys);
+
+    // read into the block state only
+    EXPECT_TRUE(s.original().at(b).storage_.empty());
+    {
+        StateDeltas::const_accessor it{};
+        ASSERT_TRUE(bs.state_deltas().find(it, b));
+        auto const &storage = it->second.storage;
+        EXPECT_EQ(storage.size(), 3);
+        EXPECT_EQ(storage.at(key1).second, value1);
+        EXPECT_EQ(storage.at(key2).second, value2);
+        EXPECT_EQ(storage.at(key3).second, null);
+    }
+
+    EXPECT_EQ(s.get_storage(b, key1), value1);
+    EXPECT_EQ(s.get_storage(b, key2), value2);
+    EXPECT_EQ(s.get_storage(b, key3), null);
+    EXPECT_TRUE(bs.can_merge(s));
+}
+
+TYPED_TEST(StateTest, nested_frames_only_hold_their_writes)
+{
+    BlockState bs{this->tdb, this->vm};
+    commit_sequential(
+        this->tdb,
+        StateDeltas{
+            {a,
+             StateDelta{
+                 .account = {std::nullopt, Account{}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{});
+
+    State s{bs, Incarnation{1, 1}};
+    EXPECT_EQ(s.access_storage(a, key2), EVMC_ACCESS_COLD);
+    EXPECT_EQ(s.set_storage(a, key1, value2), EVMC_STORAGE_MODIFIED);
+    s.set_transient_storage(a, key1, value1);
+
+    s.push();
+    EXPECT_EQ(s.set_storage(a, key2, value3), EVMC_STORAGE_ADDED);
+    auto const &frame = s.current().at(a).recent();
+    EXPECT_EQ(frame.storage_.size(), 1);
+    EXPECT_EQ(s.get_storage(a, key1), value2);
+    EXPECT_EQ(s.get_transient_storage(a, key1), value1);
+    EXPECT_EQ(s.access_storage(a, key2), EVMC_ACCESS_WARM);
+    EXPECT_EQ(s.set_storage(a, key1, value3), EVMC_STORAGE_ASSIGNED);
+    s.pop_reject();
+
+    EXPECT_EQ(s.get_storage(a, key1), value2);
+    EXPECT_EQ(s.get_storage(a, key2), null);
+
+    s.push();
+    EXPECT_EQ(s.set_storage(a, key2, value3), EVMC_STORAGE_ADDED);
+    s.push();
+    s.set_transient_storage(a, key2, value2);
+    s.pop_accept();
+    s.pop_accept();
+
+    EXPECT_EQ(s.current().at(a).size(), 1);
+    EXPECT_EQ(s.get_storage(a, key1), value2);
+    EXPECT_EQ(s.get_storage(a, key2), value3);
+    EXPECT_EQ(s.get_transient_storage(a, key1), value1);
+    EXPECT_EQ(s.get_transient_storage(a, key2), value2);
+    EXPECT_EQ(s.access_storage(a, key2), EVMC_ACCESS_WARM);
+    EXPECT_TRUE(bs.can_merge(s));
+}
+
+TYPED_TEST(StateTest, transient_storage_undone_by_rejected_frames)
+{
+    BlockState bs{this->tdb, this->vm};
+    State s{bs, Incarnation{1, 1}};
+    s.set_transient_storage(a, key1, value1);
+
+    s.push();
+    s.set_transient_storage(a, key1, value2);
+    s.set_transient_storage(a, key2, value2);
+    s.set_transient_storage(b, key1, value3);
+    s.push();
+    s.set_transient_storage(a, key1, value3);
+    EXPECT_EQ(s.get_transient_storage(a, key1), value3);
+    s.pop_reject();
+
+    EXPECT_EQ(s.get_transient_storage(a, key1), value2);
+    EXPECT_EQ(s.get_transient_storage(a, key2), value2);
+    EXPECT_EQ(s.get_transient_storage(b, key1), value3);
+    s.pop_reject();
+
+    EXPECT_EQ(s.get_transient_storage(a, key1), value1);
+    EXPECT_EQ(s.get_transient_storage(a, key2), null);
+    EXPECT_EQ(s.get_transient_storage(b, key1), null);
+
+    s.push();
+    s.set_transient_storage(b, key2, value1);
+    s.pop_accept();
+    EXPECT_EQ(s.get_transient_storage(b, key2), value1);
+    // transient storage is not account state
+    EXPECT_FALSE(s.current().contains(b));
+}
+
+TYPED_TEST(StateTest, journal_undoes_frames)
+{
+    BlockState bs{this->tdb, this->vm};
+    State s{bs, Incarnation{1, 1}};
+    s.add_to_balance(a, 1);
+    s.store_log(Receipt::Log{.address = a});
+
+    s.push();
+    s.add_to_balance(b, 2);
+    s.store_log(Receipt::Log{.address = b});
+    s.push();
+    s.add_to_balance(a, 3);
+    s.add_to_balance(c, 4);
+    s.store_log(Receipt::Log{.address = c});
+    s.pop_reject();
+
+    EXPECT_EQ(s.logs().size(), 2);
+    EXPECT_EQ(s.get_balance(a), bytes32_t{1});
+    EXPECT_FALSE(s.current().contains(c));
+
+    s.push();
+    s.add_to_balance(a, 5);
+    s.pop_accept();
+    s.pop_accept();
+
+    ASSERT_EQ(s.logs().size(), 2);
+    EXPECT_EQ(s.logs()[1].address, b);
+    EXPECT_EQ(s.get_balance(a), bytes32_t{6});
+    EXPECT_EQ(s.get_balance(b), bytes32_t{2});
+    for (auto const &[address, stack] : s.current()) {
+        EXPECT_EQ(stack.size(), 1);
+        EXPECT_EQ(stack.version(), 0u);
+    }
+
+    s.push();
+    s.store_log(Receipt::Log{.address = c});
+    s.pop_reject();
+    EXPECT_EQ(s.logs().size(), 2);
+}
+
 TYPED_TEST(StateTest, merge_txn0_and_txn1)
 {
     BlockState bs{this->tdb, this->vm};
@@ -1461,6 +2009,104 @@ TEST_F(OnDiskTrieDbFixture, proposal_basics)
     EXPECT_EQ(db_cache.read_account(a).value().balance, 40'000);
 }
 
+TEST_F(OnDiskTrieDbFixture, finalize_truncated_proposal)
+{
+    load_header(this->db, BlockHeader{.number = 9});
+    DbCache db_cache(this->tdb);
+    auto const write_balance = [](Address const &address,
+                                  uint64_t const balance) {
+        return std::make_unique<StateDeltas>(StateDeltas{
+            {address,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = balance}}}}});
+    };
+
+    db_cache.set_block_and_prefix(9);
+    db_cache.commit(
+        std::make_unique<StateDeltas>(StateDeltas{
+            {a,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 10'000}}}},
+            {b,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 20'000}}}}}),
+        Code{},
+        bytes32_t{10},
+        BlockHeader{.number = 10});
+    db_cache.finalize(10, bytes32_t{10});
+    // served from the finalized deltas, without looking in the LRU caches
+    EXPECT_EQ(db_cache.read_account(a).value().balance, uint256_t{10'000});
+    EXPECT_EQ(db_cache.misses(), 0);
+
+    // enough proposals of block 11 that the first, which writes `a`, is
+    // truncated
+    for (uint64_t n = 0; n <= 100; ++n) {
+        db_cache.set_block_and_prefix(10, bytes32_t{10});
+        db_cache.commit(
+            n == 0 ? write_balance(a, 11'000) : write_balance(c, n),
+            Code{},
+            bytes32_t{1100 + n},
+            BlockHeader{.number = 11});
+    }
+    db_cache.finalize(11, bytes32_t{1100});
+    db_cache.set_block_and_prefix(11, bytes32_t{1100});
+
+    // only what the truncated proposal wrote was dropped from the caches
+    EXPECT_EQ(db_cache.read_account(b).value().balance, uint256_t{20'000});
+    EXPECT_EQ(db_cache.misses(), 0);
+    EXPECT_EQ(db_cache.read_account(a).value().balance, uint256_t{11'000});
+    EXPECT_EQ(db_cache.misses(), 1);
+}
+
+TEST_F(OnDiskTrieDbFixture, set_budget_bytes)
+{
+    load_header(this->db, BlockHeader{.number = 9});
+    DbCache db_cache(this->tdb);
+    auto const commit_and_finalize = [&](uint64_t const block,
+                                         Address const &address) {
+        db_cache.set_block_and_prefix(block - 1, bytes32_t{block - 1});
+        db_cache.commit(
+            std::make_unique<StateDeltas>(StateDeltas{
+                {address,
+                 StateDelta{
+                     .account = {std::nullopt, Account{.balance = block}}}}}),
+            Code{},
+            bytes32_t{block},
+            BlockHeader{.number = block});
+        db_cache.finalize(block, bytes32_t{block});
+    };
+
+    db_cache.set_block_and_prefix(9);
+    db_cache.commit(
+        std::make_unique<StateDeltas>(),
+        Code{},
+        bytes32_t{10},
+        BlockHeader{.number = 10});
+    db_cache.finalize(10, bytes32_t{10});
+    EXPECT_EQ(db_cache.budget_bytes(), DbCache::default_budget_bytes);
+
+    // the new budget only takes effect at the next finalized block
+    db_cache.set_budget_bytes(DbCache::default_budget_bytes / 2);
+    EXPECT_EQ(db_cache.budget_bytes(), DbCache::default_budget_bytes);
+    commit_and_finalize(11, b);
+    EXPECT_EQ(db_cache.budget_bytes(), DbCache::default_budget_bytes / 2);
+
+    // `b` ages out of the finalized deltas into the shrunk LRU caches
+    for (uint64_t block = 12; block < 20; ++block) {
+        commit_and_finalize(block, a);
+    }
+    EXPECT_EQ(db_cache.read_account(b).value().balance, uint256_t{11});
+    EXPECT_EQ(db_cache.misses(), 0);
+
+    // growing keeps what the caches hold
+    db_cache.set_budget_bytes(DbCache::default_budget_bytes * 2);
+    commit_and_finalize(20, a);
+    EXPECT_EQ(db_cache.budget_bytes(), DbCache::default_budget_bytes * 2);
+    EXPECT_EQ(db_cache.read_account(b).value().balance, uint256_t{11});
+    EXPECT_EQ(db_cache.read_account(a).value().balance, uint256_t{20});
+    EXPECT_EQ(db_cache.misses(), 0);
+}
+
 TEST_F(OnDiskTrieDbFixture, undecided_proposals)
 {
     load_header(this->db, BlockHeader{.number = 9});
@@ -20,6 +20,8 @@
 
 #include <evmc/evmc.h>
 
+#include <utility>
+
 MONAD_NAMESPACE_BEGIN
 
 evmc_storage_status AccountState::zero_out_key(
@@ -72,4 +74,20 @@ evmc_storage_status AccountState::set_current_value(
     return status;
 }
 
+AccountState AccountState::fork() const
+{
+    AccountState state{account_};
+    static_cast<AccountSubstate &>(state) = AccountSubstate::fork();
+    return state;
+}
+
+void AccountState::merge(AccountState &&frame)
+{
+    account_ = std::move(frame.account_);
+    for (auto const &[key, value] : frame.storage_) {
+        storage_[key] = value;
+    }
+    AccountSubstate::merge(std::move(frame));
+}
+
 MONAD_NAMESPACE_END
@@ -19,7 +19,7 @@
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
 #include <category/core/int.hpp>
-#include <category/core/likely.h>
+#include <category/core/mem/arena.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/state3/account_substate.hpp>
 
@@ -30,20 +30,27 @@
 #include <ankerl/unordered_dense.h>
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <utility>
 
 MONAD_NAMESPACE_BEGIN
 
+// The state of an account in one call frame. A frame created by fork() only
+// holds the storage written in it, over the frames below it in its
+// VersionStack, so entering a call costs nothing per slot.
 class AccountState : public AccountSubstate
 {
 public: // TODO
+    // Transaction state is allocated from the executing fiber's arena, see
+    // `ArenaScope`
     template <class Key, class T>
-    using Map = ankerl::unordered_dense::segmented_map<Key, T>;
+    using Map = ankerl::unordered_dense::segmented_map<
+        Key, T, ankerl::unordered_dense::hash<Key>, std::equal_to<Key>,
+        ArenaAllocator<std::pair<Key, T>>>;
 
     std::optional<Account> account_{};
     Map<bytes32_t, bytes32_t> storage_{};
-    Map<bytes32_t, bytes32_t> transient_storage_{};
 
     evmc_storage_status zero_out_key(
         bytes32_t const &key, bytes32_t const &original_value,
@@ -69,36 +76,38 @@ public:
     AccountState &operator=(AccountState &&) = default;
     AccountState &operator=(AccountState const &) = default;
 
-    bytes32_t get_transient_storage(bytes32_t const &key) const
+    bytes32_t const *find_storage(bytes32_t const &key) const
     {
-        auto const it = transient_storage_.find(key);
-        if (MONAD_LIKELY(it != transient_storage_.end())) {
-            return it->second;
-        }
-        return {};
+        auto const it = storage_.find(key);
+        return it == storage_.end() ? nullptr : &it->second;
     }
 
     evmc_storage_status set_storage(
         bytes32_t const &key, bytes32_t const &value,
         bytes32_t const &original_value)
     {
-        bytes32_t current_value = original_value;
-        {
-            auto const it = storage_.find(key);
-            if (it != storage_.end()) {
-                current_value = it->second;
-            }
-        }
+        auto const *const current = find_storage(key);
+        return set_storage(
+            key, value, original_value, current ? *current : original_value);
+    }
+
+    evmc_storage_status set_storage(
+        bytes32_t const &key, bytes32_t const &value,
+        bytes32_t const &original_value, bytes32_t const &current_value)
+    {
         if (value == bytes32_t{}) {
             return zero_out_key(key, original_value, current_value);
         }
         return set_current_value(key, value, original_value, current_value);
     }
 
-    void set_transient_storage(bytes32_t const &key, bytes32_t const &value)
-    {
-        transient_storage_[key] = value;
-    }
+    // A nested frame: the account and substate flags of this one, and none
+    // of its storage or accessed storage
+    AccountState fork() const;
+
+    // Folds in an accepted nested frame forked from this one, at a cost
+    // proportional to what was written in it
+    void merge(AccountState &&);
 };
 
 // RELAXED MERGE
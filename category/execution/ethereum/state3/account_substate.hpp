@@ -22,6 +22,8 @@
 
 #include <ankerl/unordered_dense.h>
 
+#include <utility>
+
 MONAD_NAMESPACE_BEGIN
 
 // YP 6.1
@@ -94,6 +96,38 @@ public:
         }
         return EVMC_ACCESS_WARM;
     }
+
+    // A_K, of this frame only
+    bool is_storage_accessed(bytes32_t const &key) const
+    {
+        return accessed_storage_.contains(key);
+    }
+
+    // The substate of a nested frame, which records only the storage it
+    // accesses itself
+    AccountSubstate fork() const
+    {
+        AccountSubstate substate;
+        substate.destructed_ = destructed_;
+        substate.touched_ = touched_;
+        substate.accessed_ = accessed_;
+        return substate;
+    }
+
+    // Folds in an accepted nested frame forked from this one
+    void merge(AccountSubstate &&frame)
+    {
+        destructed_ = frame.destructed_;
+        touched_ = frame.touched_;
+        accessed_ = frame.accessed_;
+        if (accessed_storage_.empty()) {
+            accessed_storage_ = std::move(frame.accessed_storage_);
+        }
+        else {
+            accessed_storage_.insert(
+                frame.accessed_storage_.begin(), frame.accessed_storage_.end());
+        }
+    }
 };
 
 MONAD_NAMESPACE_END
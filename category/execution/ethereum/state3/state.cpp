@@ -41,15 +41,29 @@
 
 #include <ankerl/unordered_dense.h>
 
+#include <boost/fiber/fiber.hpp>
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+bytes32_t const *
+find_storage(VersionStack<AccountState> const &stack, bytes32_t const &key)
+{
+    return stack.find_recent(
+        [&key](AccountState const &frame) { return frame.find_storage(key); });
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
 MONAD_NAMESPACE_BEGIN
 
 OriginalAccountState &State::original_account_state(Address const &address)
@@ -57,7 +71,7 @@ OriginalAccountState &State::original_account_state(Address const &address)
     auto it = original_.find(address);
     if (it == original_.end()) {
         // block state
-        auto const account = block_state_.read_account(address);
+        auto const account = block_state_.read_account(address, incarnation_);
         it = original_.try_emplace(address, account).first;
     }
     return it->second;
@@ -74,7 +88,8 @@ AccountState const &State::recent_account_state(Address const &address)
     return original_account_state(address);
 }
 
-AccountState &State::current_account_state(Address const &address)
+VersionStack<AccountState> &
+State::current_account_stack(Address const &address)
 {
     // current
     auto it = current_.find(address);
@@ -83,7 +98,19 @@ AccountState &State::current_account_state(Address const &address)
         auto const &account_state = original_account_state(address);
         it = current_.try_emplace(address, account_state, version_).first;
     }
-    return it->second.current(version_);
+    else if (it->second.version() == version_) {
+        return it->second;
+    }
+    if (version_) {
+        journal_.push_back(address);
+    }
+    it->second.current(version_);
+    return it->second;
+}
+
+AccountState &State::current_account_state(Address const &address)
+{
+    return current_account_stack(address).recent();
 }
 
 std::optional<Account> &State::current_account(Address const &address)
@@ -100,6 +127,11 @@ State::State(
 {
 }
 
+Incarnation State::incarnation() const
+{
+    return incarnation_;
+}
+
 State::Map<Address, OriginalAccountState> const &State::original() const
 {
     return original_;
@@ -122,6 +154,10 @@ State::Map<bytes32_t, vm::SharedVarcode> const &State::code() const
 
 void State::push()
 {
+    marks_.push_back(
+        {.journal = journal_.size(),
+         .logs = logs_.size(),
+         .transient = transient_journal_.size()});
     ++version_;
 }
 
@@ -129,33 +165,43 @@ void State::pop_accept()
 {
     MONAD_ASSERT(version_);
 
-    for (auto &it : current_) {
-        it.second.pop_accept(version_);
+    // Frames which are not merged down move to the parent version, and so
+    // do their journal entries. An address may then be journaled more than
+    // once, which is harmless: its later pops find no frame at the version.
+    for (size_t i = marks_.back().journal; i < journal_.size(); ++i) {
+        auto const it = current_.find(journal_[i]);
+        MONAD_ASSERT(it != current_.end());
+        it->second.pop_accept(version_);
     }
-
-    logs_.pop_accept(version_);
+    marks_.pop_back();
 
     --version_;
+    if (!version_) {
+        journal_.clear();
+        transient_journal_.clear();
+    }
 }
 
 void State::pop_reject()
 {
     MONAD_ASSERT(version_);
 
-    std::vector<Address> removals;
-
-    for (auto &it : current_) {
-        if (it.second.pop_reject(version_)) {
-            removals.push_back(it.first);
+    auto const mark = marks_.back();
+    for (size_t i = mark.journal; i < journal_.size(); ++i) {
+        auto const it = current_.find(journal_[i]);
+        if (it != current_.end() && it->second.pop_reject(version_)) {
+            current_.erase(it);
         }
     }
-
-    logs_.pop_reject(version_);
-
-    while (removals.size()) {
-        current_.erase(removals.back());
-        removals.pop_back();
+    journal_.resize(mark.journal);
+    for (size_t i = transient_journal_.size(); i > mark.transient; --i) {
+        auto const &write = transient_journal_[i - 1];
+        transient_[write.slot] = write.previous;
     }
+    transient_journal_.resize(mark.transient);
+    logs_.erase(
+        logs_.begin() + static_cast<std::ptrdiff_t>(mark.logs), logs_.end());
+    marks_.pop_back();
 
     --version_;
 }
@@ -218,6 +264,33 @@ bytes32_t State::get_code_hash(Address const &address)
     return NULL_HASH;
 }
 
+bytes32_t State::get_storage(
+    VersionStack<AccountState> const &stack, Address const &address,
+    bytes32_t const &key)
+{
+    auto const &account = stack.recent().account_;
+    MONAD_ASSERT(account.has_value());
+    if (auto const *const value = find_storage(stack, key)) {
+        return *value;
+    }
+    auto const it = original_.find(address);
+    MONAD_ASSERT(it != original_.end());
+    auto &original_account_state = it->second;
+    auto const &original_account = original_account_state.account_;
+    if (!original_account.has_value() ||
+        account.value().incarnation != original_account.value().incarnation) {
+        return {};
+    }
+    auto &original_storage = original_account_state.storage_;
+    auto it2 = original_storage.find(key);
+    if (it2 == original_storage.end()) {
+        bytes32_t const value = block_state_.read_storage(
+            address, account.value().incarnation, key, incarnation_);
+        it2 = original_storage.try_emplace(key, value).first;
+    }
+    return it2->second;
+}
+
 bytes32_t State::get_storage(Address const &address, bytes32_t const &key)
 {
     auto const it = current_.find(address);
@@ -231,43 +304,57 @@ bytes32_t State::get_storage(Address const &address, bytes32_t const &key)
         auto it3 = storage.find(key);
         if (it3 == storage.end()) {
             bytes32_t const value = block_state_.read_storage(
-                address, account.value().incarnation, key);
+                address, account.value().incarnation, key, incarnation_);
             it3 = storage.try_emplace(key, value).first;
         }
         return it3->second;
     }
     else {
-        auto const &account_state = it->second.recent();
-        auto const &account = account_state.account_;
-        MONAD_ASSERT(account.has_value());
-        auto const &storage = account_state.storage_;
-        if (auto const it2 = storage.find(key); it2 != storage.end()) {
-            return it2->second;
-        }
-        auto const it2 = original_.find(address);
-        MONAD_ASSERT(it2 != original_.end());
-        auto &original_account_state = it2->second;
-        auto const &original_account = original_account_state.account_;
-        if (!original_account.has_value() ||
-            account.value().incarnation !=
-                original_account.value().incarnation) {
-            return {};
-        }
-        auto &original_storage = original_account_state.storage_;
-        auto it3 = original_storage.find(key);
-        if (it3 == original_storage.end()) {
-            bytes32_t const value = block_state_.read_storage(
-                address, account.value().incarnation, key);
-            it3 = original_storage.try_emplace(key, value).first;
+        return get_storage(it->second, address, key);
+    }
+}
+
+void State::prefetch_storage(
+    Address const &address, std::span<bytes32_t const> const keys)
+{
+    auto const it = original_.find(address);
+    if (it == original_.end() || !it->second.account_.has_value()) {
+        return;
+    }
+    auto const incarnation = it->second.account_->incarnation;
+    auto const &storage = it->second.storage_;
+    std::vector<bytes32_t> missing;
+    for (auto const &key : keys) {
+        if (!storage.contains(key)) {
+            missing.push_back(key);
         }
-        return it3->second;
+    }
+    if (missing.size() < 2) {
+        return;
+    }
+    // a read suspends only its own fiber, so the reads overlap
+    constexpr size_t MAX_PREFETCH_FIBERS = 32;
+    size_t const num_fibers = std::min(missing.size(), MAX_PREFETCH_FIBERS);
+    std::vector<boost::fibers::fiber> fibers;
+    fibers.reserve(num_fibers);
+    for (size_t i = 0; i < num_fibers; ++i) {
+        fibers.emplace_back([&, i] {
+            for (size_t j = i; j < missing.size(); j += num_fibers) {
+                block_state_.read_storage(address, incarnation, missing[j]);
+            }
+        });
+    }
+    for (auto &fiber : fibers) {
+        fiber.join();
     }
 }
 
 bytes32_t
 State::get_transient_storage(Address const &address, bytes32_t const &key)
 {
-    return recent_account_state(address).get_transient_storage(key);
+    auto const it =
+        transient_.find(TransientSlot{.address = address, .key = key});
+    return it == transient_.end() ? bytes32_t{} : it->second;
 }
 
 bool State::is_touched(Address const &address)
@@ -328,7 +415,8 @@ evmc_storage_status State::set_storage(
     Address const &address, bytes32_t const &key, bytes32_t const &value)
 {
     bytes32_t original_value;
-    auto &account_state = current_account_state(address);
+    auto &stack = current_account_stack(address);
+    auto &account_state = stack.recent();
     MONAD_ASSERT(account_state.account_);
     // original
     {
@@ -337,24 +425,36 @@ evmc_storage_status State::set_storage(
         auto it = storage.find(key);
         if (it == storage.end()) {
             Incarnation const incarnation = account_state.account_->incarnation;
-            bytes32_t const value =
-                block_state_.read_storage(address, incarnation, key);
+            bytes32_t const value = block_state_.read_storage(
+                address, incarnation, key, incarnation_);
             it = storage.try_emplace(key, value).first;
         }
         original_value = it->second;
     }
     // state
     {
-        auto const result =
-            account_state.set_storage(key, value, original_value);
-        return result;
+        auto const *const current = find_storage(stack, key);
+        bytes32_t const current_value = current ? *current : original_value;
+        return account_state.set_storage(
+            key, value, original_value, current_value);
     }
 }
 
 void State::set_transient_storage(
     Address const &address, bytes32_t const &key, bytes32_t const &value)
 {
-    current_account_state(address).set_transient_storage(key, value);
+    TransientSlot const slot{.address = address, .key = key};
+    auto const [it, inserted] = transient_.try_emplace(slot, value);
+    if (!inserted) {
+        if (version_) {
+            transient_journal_.push_back(
+                {.slot = slot, .previous = it->second});
+        }
+        it->second = value;
+    }
+    else if (version_) {
+        transient_journal_.push_back({.slot = slot, .previous = bytes32_t{}});
+    }
 }
 
 void State::touch(Address const &address)
@@ -372,10 +472,37 @@ evmc_access_status State::access_account(Address const &address)
 evmc_access_status
 State::access_storage(Address const &address, bytes32_t const &key)
 {
-    auto &account_state = current_account_state(address);
+    auto &stack = current_account_stack(address);
+    auto &account_state = stack.recent();
+    auto const *const accessed =
+        stack.find_recent([&key](AccountState const &frame) {
+            return frame.is_storage_accessed(key) ? &frame : nullptr;
+        });
+    if (accessed != nullptr) {
+        return EVMC_ACCESS_WARM;
+    }
     return account_state.access_storage(key);
 }
 
+evmc_access_status State::access_and_get_storage(
+    Address const &address, bytes32_t const &key, bytes32_t &value,
+    bool const load_cold)
+{
+    auto &stack = current_account_stack(address);
+    auto &account_state = stack.recent();
+    auto const *const accessed =
+        stack.find_recent([&key](AccountState const &frame) {
+            return frame.is_storage_accessed(key) ? &frame : nullptr;
+        });
+    auto const status = accessed != nullptr
+                            ? EVMC_ACCESS_WARM
+                            : account_state.access_storage(key);
+    if (load_cold || status == EVMC_ACCESS_WARM) {
+        value = get_storage(stack, address, key);
+    }
+    return status;
+}
+
 template <Traits traits>
 bool State::selfdestruct(Address const &address, Address const &beneficiary)
 {
@@ -483,9 +610,7 @@ size_t State::get_code_size(Address const &address)
             return vcode->intercode()->size();
         }
     }
-    auto const vcode = block_state_.read_code(code_hash);
-    MONAD_ASSERT(vcode);
-    return vcode->intercode()->size();
+    return block_state_.read_code_size(code_hash);
 }
 
 size_t State::copy_code(
@@ -571,13 +696,12 @@ void State::create_account_no_rollback(Address const &address)
 
 std::vector<Receipt::Log> const &State::logs()
 {
-    return logs_.recent();
+    return logs_;
 }
 
 void State::store_log(Receipt::Log const &log)
 {
-    auto &logs = logs_.current(version_);
-    logs.push_back(log);
+    logs_.push_back(log);
 }
 
 void State::set_to_state_incarnation(Address const &address)
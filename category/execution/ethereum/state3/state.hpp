@@ -18,6 +18,7 @@
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
+#include <category/core/mem/arena.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
@@ -31,9 +32,12 @@
 
 #include <ankerl/unordered_dense.h>
 
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 
 MONAD_NAMESPACE_BEGIN
@@ -43,7 +47,7 @@ class BlockState;
 class State
 {
     template <typename K, typename V>
-    using Map = ankerl::unordered_dense::segmented_map<K, V>;
+    using Map = AccountState::Map<K, V>;
 
     BlockState &block_state_;
 
@@ -53,7 +57,58 @@ class State
 
     Map<Address, VersionStack<AccountState>> current_{};
 
-    VersionStack<std::vector<Receipt::Log>> logs_{{}};
+    // Undo journal of the call frames. Every address whose stack gains a
+    // frame at a version above 0 is appended to journal_, so a pop only
+    // visits the accounts the frame touched, and logs_ is truncated on
+    // reject rather than versioned
+    struct Mark
+    {
+        size_t journal;
+        size_t logs;
+        size_t transient;
+    };
+
+    std::vector<Address> journal_{};
+
+    std::vector<Mark> marks_{};
+
+    // Transient storage of every account in one table for the transaction,
+    // so a TLOAD or TSTORE is a single probe. A write in a call frame
+    // records the value it replaced in transient_journal_, which a rejected
+    // frame replays backwards, and frames neither copy nor merge it.
+    struct TransientSlot
+    {
+        Address address;
+        bytes32_t key;
+
+        friend bool
+        operator==(TransientSlot const &, TransientSlot const &) = default;
+    };
+
+    struct TransientSlotHash
+    {
+        size_t operator()(TransientSlot const &slot) const noexcept
+        {
+            return std::hash<Address>{}(slot.address) ^
+                   std::rotl(std::hash<bytes32_t>{}(slot.key), 1);
+        }
+    };
+
+    struct TransientWrite
+    {
+        TransientSlot slot;
+        bytes32_t previous;
+    };
+
+    ankerl::unordered_dense::segmented_map<
+        TransientSlot, bytes32_t, TransientSlotHash,
+        std::equal_to<TransientSlot>,
+        ArenaAllocator<std::pair<TransientSlot, bytes32_t>>>
+        transient_{};
+
+    std::vector<TransientWrite> transient_journal_{};
+
+    std::vector<Receipt::Log> logs_{};
 
     Map<bytes32_t, vm::SharedVarcode> code_{};
 
@@ -67,10 +122,18 @@ public:
 private:
     AccountState const &recent_account_state(Address const &);
 
+    // The stack of the account, with a frame at the current version
+    VersionStack<AccountState> &current_account_stack(Address const &);
+
     AccountState &current_account_state(Address const &);
 
     std::optional<Account> &current_account(Address const &);
 
+    // The current value of a slot of an account that has a stack
+    bytes32_t get_storage(
+        VersionStack<AccountState> const &, Address const &,
+        bytes32_t const &key);
+
 public:
     State(BlockState &, Incarnation, bool relaxed_validation = false);
 
@@ -79,6 +142,8 @@ public:
     State &operator=(State &&) = delete;
     State &operator=(State const &) = delete;
 
+    Incarnation incarnation() const;
+
     Map<Address, OriginalAccountState> const &original() const;
 
     Map<Address, OriginalAccountState> &original();
@@ -117,6 +182,11 @@ public:
 
     bytes32_t get_transient_storage(Address const &, bytes32_t const &key);
 
+    // Reads the slots into the block state concurrently, ahead of a sequence
+    // of get_storage calls that would otherwise read them one at a time. The
+    // slots are not recorded as read by this state until it reads them.
+    void prefetch_storage(Address const &, std::span<bytes32_t const> keys);
+
     bool is_touched(Address const &);
 
     ////////////////////////////////////////
@@ -141,6 +211,12 @@ public:
 
     evmc_access_status access_storage(Address const &, bytes32_t const &key);
 
+    // access_storage followed by get_storage, resolving the account once.
+    // A cold slot is only read if load_cold is set.
+    evmc_access_status access_and_get_storage(
+        Address const &, bytes32_t const &key, bytes32_t &value,
+        bool load_cold = true);
+
     ////////////////////////////////////////
 
     template <Traits traits>
@@ -17,21 +17,91 @@
 
 #include <category/core/assert.h>
 #include <category/core/config.hpp>
+#include <category/core/likely.h>
+#include <category/core/mem/arena.hpp>
 
+#include <array>
+#include <concepts>
+#include <cstddef>
 #include <deque>
+#include <optional>
 #include <utility>
 
 MONAD_NAMESPACE_BEGIN
 
+// A T whose frames above the first only record what changed in them. fork()
+// starts such a frame and merge() folds an accepted one into the frame below,
+// so neither costs more than the changes made in the frame. Readers look
+// through the frames with VersionStack::find_recent().
+template <class T>
+concept Layered = requires(T &t, T const &ct) {
+    { ct.fork() } -> std::same_as<T>;
+    t.merge(std::move(t));
+};
+
 template <class T>
 class VersionStack
 {
-    std::deque<std::pair<unsigned, T>> stack_{};
+    using Frame = std::pair<unsigned, T>;
+
+    // Almost every account stays within the first couple of call frames, so
+    // those frames live inline and a shallow stack never touches the heap.
+    // Deeper frames spill into a deque that is only created when needed.
+    // Neither storage moves existing frames, so references obtained from the
+    // stack stay valid across pushes.
+    static constexpr size_t INLINE_FRAMES = 2;
+
+    std::array<std::optional<Frame>, INLINE_FRAMES> inline_{};
+    std::optional<std::deque<Frame, ArenaAllocator<Frame>>> spill_{};
+    size_t size_{0};
+
+    Frame &frame(size_t const i)
+    {
+        if (MONAD_LIKELY(i < INLINE_FRAMES)) {
+            return *inline_[i];
+        }
+        return (*spill_)[i - INLINE_FRAMES];
+    }
+
+    Frame const &frame(size_t const i) const
+    {
+        if (MONAD_LIKELY(i < INLINE_FRAMES)) {
+            return *inline_[i];
+        }
+        return (*spill_)[i - INLINE_FRAMES];
+    }
+
+    void push_back(unsigned const version, T &&value)
+    {
+        if (MONAD_LIKELY(size_ < INLINE_FRAMES)) {
+            inline_[size_].emplace(version, std::move(value));
+        }
+        else {
+            if (!spill_) {
+                spill_.emplace();
+            }
+            spill_->emplace_back(version, std::move(value));
+        }
+        ++size_;
+    }
+
+    void pop_back()
+    {
+        MONAD_ASSERT(size_);
+
+        --size_;
+        if (MONAD_LIKELY(size_ < INLINE_FRAMES)) {
+            inline_[size_].reset();
+        }
+        else {
+            spill_->pop_back();
+        }
+    }
 
 public:
     VersionStack(T value, unsigned version = 0)
     {
-        stack_.emplace_back(version, std::move(value));
+        push_back(version, std::move(value));
     }
 
     VersionStack(VersionStack &&) = default;
@@ -41,57 +111,80 @@ public:
 
     size_t size() const
     {
-        return stack_.size();
+        return size_;
     }
 
     unsigned version() const
     {
-        MONAD_ASSERT(stack_.size());
+        MONAD_ASSERT(size_);
 
-        return stack_.back().first;
+        return frame(size_ - 1).first;
     }
 
     T const &recent() const
     {
-        MONAD_ASSERT(stack_.size());
+        MONAD_ASSERT(size_);
 
-        return stack_.back().second;
+        return frame(size_ - 1).second;
     }
 
     T &recent()
     {
-        MONAD_ASSERT(stack_.size());
+        MONAD_ASSERT(size_);
 
-        return stack_.back().second;
+        return frame(size_ - 1).second;
     }
 
     T &current(unsigned const version)
     {
-        MONAD_ASSERT(stack_.size());
+        MONAD_ASSERT(size_);
 
-        if (version > stack_.back().first) {
-            T value = stack_.back().second;
-            stack_.emplace_back(version, std::move(value));
+        if (version > frame(size_ - 1).first) {
+            if constexpr (Layered<T>) {
+                push_back(version, frame(size_ - 1).second.fork());
+            }
+            else {
+                T value = frame(size_ - 1).second;
+                push_back(version, std::move(value));
+            }
         }
 
-        return stack_.back().second;
+        return frame(size_ - 1).second;
+    }
+
+    // Returns the first non-null pointer returned by `fn` for the frames,
+    // from the most recent to the oldest
+    template <class Fn>
+    auto find_recent(Fn &&fn) const -> decltype(fn(std::declval<T const &>()))
+    {
+        for (size_t i = size_; i-- > 0;) {
+            if (auto *const found = fn(frame(i).second)) {
+                return found;
+            }
+        }
+        return nullptr;
     }
 
     void pop_accept(unsigned const version)
     {
         MONAD_ASSERT(version);
 
-        auto const size = stack_.size();
+        auto const size = size_;
         MONAD_ASSERT(size);
 
-        if (version == stack_.back().first) {
-            if (size > 1 &&
-                stack_[size - 2].first + 1 == stack_[size - 1].first) {
-                stack_[size - 2].second = std::move(stack_[size - 1].second);
-                stack_.pop_back();
+        auto &back = frame(size - 1);
+        if (version == back.first) {
+            if (size > 1 && frame(size - 2).first + 1 == back.first) {
+                if constexpr (Layered<T>) {
+                    frame(size - 2).second.merge(std::move(back.second));
+                }
+                else {
+                    frame(size - 2).second = std::move(back.second);
+                }
+                pop_back();
             }
             else {
-                stack_.back().first = version - 1;
+                back.first = version - 1;
             }
         }
     }
@@ -100,14 +193,14 @@ public:
     {
         MONAD_ASSERT(version);
 
-        auto const size = stack_.size();
+        auto const size = size_;
         MONAD_ASSERT(size);
 
-        if (version == stack_.back().first) {
-            stack_.pop_back();
+        if (version == frame(size - 1).first) {
+            pop_back();
         }
 
-        return stack_.empty();
+        return size_ == 0;
     }
 };
 
@@ -0,0 +1,196 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/slot_predictor.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state_prefetcher.hpp>
+
+#include <ankerl/unordered_dense.h>
+
+#include <boost/fiber/future/future.hpp>
+#include <boost/fiber/future/promise.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+struct PrefetchTask
+{
+    std::vector<Address> accounts{};
+    std::vector<std::pair<Address, bytes32_t>> slots{};
+};
+
+struct PrefetchDone
+{
+    std::atomic<size_t> remaining;
+    boost::fibers::promise<void> promise{};
+
+    void finish()
+    {
+        if (remaining.fetch_sub(1) == 1) {
+            promise.set_value();
+        }
+    }
+};
+
+// Slots read one after another on a fiber. The slots of a longer access list
+// are split across fibers, whose reads then wait on the disk concurrently.
+constexpr size_t slots_per_fiber = 8;
+
+void read_slots(
+    BlockState &block_state,
+    std::span<std::pair<Address, bytes32_t> const> const slots)
+{
+    for (auto const &[address, key] : slots) {
+        // The account was read by this or an earlier task, which may
+        // still be in flight, in which case this reads it again
+        auto const account = block_state.read_account(address);
+        if (account.has_value()) {
+            block_state.read_storage(address, account->incarnation, key);
+        }
+    }
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+StatePrefetcher::StatePrefetcher(
+    std::vector<Transaction> const &transactions,
+    std::vector<Address> const &senders,
+    std::vector<std::vector<std::optional<Address>>> const &authorities,
+    BlockState &block_state, fiber::PriorityPool &priority_pool,
+    SlotPredictor const *const slot_predictor)
+{
+    MONAD_ASSERT(senders.size() == transactions.size());
+    MONAD_ASSERT(authorities.size() == transactions.size());
+
+    // Each account is prefetched once, by the first transaction declaring it
+    ankerl::unordered_dense::segmented_set<Address> seen;
+    std::vector<std::pair<uint64_t, PrefetchTask>> tasks;
+    for (unsigned i = 0; i < transactions.size(); ++i) {
+        auto const &tx = transactions[i];
+        PrefetchTask task;
+        auto const add_account = [&](Address const &address) {
+            if (seen.insert(address).second) {
+                task.accounts.push_back(address);
+            }
+        };
+        add_account(senders[i]);
+        if (tx.to.has_value()) {
+            add_account(tx.to.value());
+        }
+        for (auto const &authority : authorities[i]) {
+            if (authority.has_value()) {
+                add_account(authority.value());
+            }
+        }
+        for (auto const &entry : tx.access_list) {
+            add_account(entry.a);
+            for (auto const &key : entry.keys) {
+                task.slots.emplace_back(entry.a, key);
+            }
+        }
+        if (slot_predictor != nullptr && tx.to.has_value()) {
+            for (auto const &key : slot_predictor->predict(tx, senders[i])) {
+                task.slots.emplace_back(tx.to.value(), key);
+            }
+        }
+        if (!task.accounts.empty() || !task.slots.empty()) {
+            tasks.emplace_back(i, std::move(task));
+        }
+    }
+
+    auto const done = std::make_shared<PrefetchDone>(tasks.size());
+    done_ = done->promise.get_future();
+    if (tasks.empty()) {
+        done->promise.set_value();
+        return;
+    }
+
+    for (auto &[i, task] : tasks) {
+        priority_pool.submit(
+            i,
+            [i = i,
+             &block_state,
+             &priority_pool,
+             done = done,
+             task = std::move(task)] {
+                std::vector<bytes32_t> code_hashes;
+                for (auto const &address : task.accounts) {
+                    auto const account = block_state.read_account(address);
+                    if (account.has_value() &&
+                        account->code_hash != NULL_HASH) {
+                        code_hashes.push_back(account->code_hash);
+                    }
+                }
+                // The accounts of this task are in the block state now, so
+                // the fibers reading the rest of the slots find them there
+                std::span<std::pair<Address, bytes32_t> const> slots{
+                    task.slots};
+                std::vector<fiber::PriorityTask> chunks;
+                while (slots.size() > slots_per_fiber) {
+                    auto const chunk = slots.last(slots_per_fiber);
+                    slots = slots.first(slots.size() - slots_per_fiber);
+                    chunks.push_back(
+                        {i,
+                         [&block_state,
+                          done = done,
+                          chunk = std::vector(chunk.begin(), chunk.end())] {
+                             read_slots(block_state, chunk);
+                             done->finish();
+                         }});
+                }
+                if (!chunks.empty()) {
+                    done->remaining.fetch_add(chunks.size());
+                    priority_pool.submit_batch(chunks);
+                }
+                read_slots(block_state, slots);
+                for (auto const &code_hash : code_hashes) {
+                    // Analyse the code into the varcode cache, where
+                    // execution finds it ready to run
+                    (void)block_state.read_code(code_hash);
+                }
+                done->finish();
+            });
+    }
+}
+
+StatePrefetcher::~StatePrefetcher()
+{
+    wait();
+}
+
+void StatePrefetcher::wait()
+{
+    if (done_.valid()) {
+        done_.get();
+    }
+}
+
+MONAD_NAMESPACE_END
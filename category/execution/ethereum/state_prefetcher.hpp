@@ -0,0 +1,76 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#include <boost/fiber/future/future.hpp>
+
+#include <optional>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockState;
+class SlotPredictor;
+struct Transaction;
+
+namespace fiber
+{
+    class PriorityPool;
+}
+
+/**
+ * Reads into the block state the accounts and storage slots that the
+ * transactions of a block declare before they execute: senders, recipients,
+ * EIP-2930 access lists and EIP-7702 authorities. The reads are submitted to
+ * the priority pool ahead of the transactions, at the priority of the first
+ * transaction that declares them, so cold database reads overlap with
+ * execution instead of stalling it. The slots of a long access list are
+ * read on several fibers, so that their reads wait on the disk together and
+ * the first SLOAD of a declared slot finds it in the block state. The code
+ * of prefetched accounts is read and analysed into the VM's varcode cache as
+ * well, after the slots, so that large contracts are not analysed on the
+ * critical path of their first transaction. With a slot predictor, the slots
+ * of its recipient that a call is predicted to read are prefetched along
+ * with its access list.
+ *
+ * Every entry the prefetch adds to the block state is a database value that
+ * the first transaction to read it would have added anyway, so the result of
+ * the block does not change. Outstanding reads must finish before the block
+ * state is committed; the destructor waits for them.
+ */
+class StatePrefetcher
+{
+    boost::fibers::future<void> done_{};
+
+public:
+    StatePrefetcher(
+        std::vector<Transaction> const &, std::vector<Address> const &senders,
+        std::vector<std::vector<std::optional<Address>>> const &authorities,
+        BlockState &, fiber::PriorityPool &,
+        SlotPredictor const * = nullptr);
+
+    StatePrefetcher(StatePrefetcher const &) = delete;
+    StatePrefetcher &operator=(StatePrefetcher const &) = delete;
+
+    ~StatePrefetcher();
+
+    void wait();
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/execution/ethereum/conflict_scheduler.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using namespace monad;
+
+namespace
+{
+    constexpr auto sender1 = 0x00000000000000000000000000000000000000a1_address;
+    constexpr auto sender2 = 0x00000000000000000000000000000000000000a2_address;
+    constexpr auto sender3 = 0x00000000000000000000000000000000000000a3_address;
+    constexpr auto router = 0x00000000000000000000000000000000000000b1_address;
+    constexpr auto token = 0x00000000000000000000000000000000000000b2_address;
+    constexpr auto other = 0x00000000000000000000000000000000000000b3_address;
+
+    std::vector<std::vector<std::optional<Address>>>
+    no_authorities(size_t const n)
+    {
+        return std::vector<std::vector<std::optional<Address>>>(n);
+    }
+}
+
+TEST(ConflictScheduler, no_dependencies_when_cold)
+{
+    ConflictScheduler const scheduler;
+    std::vector<Transaction> const txs{{.to = router}, {.to = router}};
+    auto const deps =
+        scheduler.schedule(txs, {sender1, sender2}, no_authorities(2));
+    ASSERT_EQ(deps.size(), 2);
+    EXPECT_FALSE(deps[0].has_value());
+    EXPECT_FALSE(deps[1].has_value());
+}
+
+TEST(ConflictScheduler, learns_from_conflicts)
+{
+    ConflictScheduler scheduler;
+    std::vector<Transaction> const txs{
+        {.to = router}, {.to = other}, {.to = router}};
+    std::vector<Address> const senders{sender1, sender2, sender3};
+
+    BlockMetrics metrics;
+    metrics.add_conflict(
+        2, MergeConflict{.address = token, .key = std::nullopt, .writer = 0});
+    scheduler.update(txs, metrics);
+
+    EXPECT_TRUE(scheduler.is_hot(token));
+    EXPECT_TRUE(scheduler.is_hot(router));
+    EXPECT_FALSE(scheduler.is_hot(other));
+
+    auto const deps = scheduler.schedule(txs, senders, no_authorities(3));
+    ASSERT_EQ(deps.size(), 3);
+    EXPECT_FALSE(deps[0].has_value());
+    EXPECT_FALSE(deps[1].has_value());
+    EXPECT_EQ(deps[2], 0);
+}
+
+TEST(ConflictScheduler, access_list_and_authorities)
+{
+    ConflictScheduler scheduler;
+    {
+        std::vector<Transaction> const txs{{.to = token}};
+        BlockMetrics metrics;
+        metrics.add_conflict(0, MergeConflict{.address = token});
+        scheduler.update(txs, metrics);
+    }
+
+    std::vector<Transaction> const txs{
+        {.to = other, .access_list = {AccessEntry{.a = token}}},
+        {.to = other},
+        {.to = other}};
+    std::vector<std::vector<std::optional<Address>>> const authorities{
+        {}, {std::nullopt}, {token}};
+    auto const deps =
+        scheduler.schedule(txs, {sender1, sender2, sender3}, authorities);
+    EXPECT_FALSE(deps[0].has_value());
+    EXPECT_FALSE(deps[1].has_value());
+    EXPECT_EQ(deps[2], 0);
+}
+
+TEST(ConflictScheduler, hot_accounts_decay)
+{
+    ConflictScheduler scheduler;
+    std::vector<Transaction> const txs{{.to = router}};
+    {
+        BlockMetrics metrics;
+        metrics.add_conflict(0, MergeConflict{.address = token});
+        scheduler.update(txs, metrics);
+    }
+    EXPECT_EQ(scheduler.num_hot(), 2);
+    for (unsigned i = 0; i < ConflictScheduler::HOT_BLOCKS - 1; ++i) {
+        scheduler.update(txs, BlockMetrics{});
+        EXPECT_TRUE(scheduler.is_hot(token));
+    }
+    scheduler.update(txs, BlockMetrics{});
+    EXPECT_FALSE(scheduler.is_hot(token));
+    EXPECT_EQ(scheduler.num_hot(), 0);
+}
@@ -29,6 +29,9 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
 
 namespace
 {
@@ -51,21 +54,16 @@ namespace
                 .append = false, .dbname_paths = {path}}};
         return dbname;
     }
-}
 
-TEST(DbBinarySnapshot, Basic)
-{
-    using namespace monad;
-    using namespace monad::mpt;
-
-    auto const src_db = tmp_dbname();
-
-    bytes32_t root;
-    Code code_delta;
-    BlockHeader last_header;
+    void populate_db(
+        std::filesystem::path const &dbname, monad::bytes32_t &root,
+        monad::Code &code_delta, monad::BlockHeader &last_header)
     {
+        using namespace monad;
+        using namespace monad::mpt;
+
         OnDiskMachine machine;
-        mpt::Db db{machine, OnDiskDbConfig{.dbname_paths = {src_db}}};
+        mpt::Db db{machine, OnDiskDbConfig{.dbname_paths = {dbname}}};
         for (uint64_t i = 0; i < 100; ++i) {
             load_header(db, BlockHeader{.number = i});
         }
@@ -103,26 +101,59 @@ TEST(DbBinarySnapshot, Basic)
         root = tdb.state_root();
     }
 
-    auto const dest_db = tmp_dbname();
+    bool dump_snapshot(
+        std::filesystem::path const &dbname,
+        std::filesystem::path const &snapshot, unsigned const num_threads)
     {
-        auto const root = std::filesystem::temp_directory_path() / "snapshot";
         auto *const context =
             monad_db_snapshot_filesystem_write_user_context_create(
-                root.c_str(), 100);
-        char const *dbname_paths[] = {src_db.c_str()};
-        EXPECT_TRUE(monad_db_dump_snapshot(
+                snapshot.c_str(), 100);
+        char const *dbname_paths[] = {dbname.c_str()};
+        bool const success = monad_db_dump_snapshot(
             dbname_paths,
             1,
             static_cast<unsigned>(-1),
             100,
+            num_threads,
             monad_db_snapshot_write_filesystem,
-            context));
-
+            context);
         monad_db_snapshot_filesystem_write_user_context_destroy(context);
+        return success;
+    }
+
+    std::string read_file(std::filesystem::path const &path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        return {
+            std::istreambuf_iterator<char>{in},
+            std::istreambuf_iterator<char>{}};
+    }
+}
+
+TEST(DbBinarySnapshot, Basic)
+{
+    using namespace monad;
+    using namespace monad::mpt;
+
+    auto const src_db = tmp_dbname();
+    bytes32_t root;
+    Code code_delta;
+    BlockHeader last_header;
+    populate_db(src_db, root, code_delta, last_header);
+
+    auto const dest_db = tmp_dbname();
+    {
+        auto const root = std::filesystem::temp_directory_path() / "snapshot";
+        EXPECT_TRUE(dump_snapshot(src_db, root, 4));
 
         char const *dbname_paths_new[] = {dest_db.c_str()};
         monad_db_snapshot_load_filesystem(
-            dbname_paths_new, 1, static_cast<unsigned>(-1), root.c_str(), 100);
+            dbname_paths_new,
+            1,
+            static_cast<unsigned>(-1),
+            root.c_str(),
+            100,
+            4);
 
         std::filesystem::remove_all(root);
     }
@@ -151,3 +182,38 @@ TEST(DbBinarySnapshot, Basic)
     std::filesystem::remove(src_db);
     std::filesystem::remove(dest_db);
 }
+
+TEST(DbBinarySnapshot, ParallelDumpMatchesSerial)
+{
+    using namespace monad;
+
+    auto const src_db = tmp_dbname();
+    bytes32_t root;
+    Code code_delta;
+    BlockHeader last_header;
+    populate_db(src_db, root, code_delta, last_header);
+
+    auto const tmp = std::filesystem::temp_directory_path();
+    auto const serial = tmp / "snapshot_serial";
+    auto const parallel = tmp / "snapshot_parallel";
+    ASSERT_TRUE(dump_snapshot(src_db, serial, 1));
+    ASSERT_TRUE(dump_snapshot(src_db, parallel, 8));
+
+    size_t files = 0;
+    for (auto const &entry :
+         std::filesystem::recursive_directory_iterator{serial}) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        auto const other =
+            parallel / std::filesystem::relative(entry.path(), serial);
+        ASSERT_TRUE(std::filesystem::is_regular_file(other)) << other;
+        EXPECT_EQ(read_file(entry.path()), read_file(other)) << other;
+        ++files;
+    }
+    EXPECT_GT(files, 0);
+
+    std::filesystem::remove_all(serial);
+    std::filesystem::remove_all(parallel);
+    std::filesystem::remove(src_db);
+}
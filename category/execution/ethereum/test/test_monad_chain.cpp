@@ -407,6 +407,59 @@ TEST(MonadChain, can_sender_dip_into_reserve)
     }
 }
 
+TEST(MonadChain, classify_reserve_balance)
+{
+    std::vector<Address> const senders = {
+        Address{1}, Address{2}, Address{1}, Address{3}, Address{4}, Address{5}};
+    std::vector<std::vector<std::optional<Address>>> const authorities = {
+        {}, {Address{3}}, {}, {}, {Address{4}}, {}};
+    ankerl::unordered_dense::segmented_set<Address> const
+        senders_and_authorities{
+            Address{1}, Address{2}, Address{3}, Address{4}, Address{5}};
+    ankerl::unordered_dense::segmented_set<Address> const
+        parent_senders_and_authorities{Address{5}};
+    std::vector<Transaction> transactions(senders.size());
+    for (auto &tx : transactions) {
+        tx.to = Address{0xbeef};
+    }
+    transactions[1].data = byte_string{0x01};
+    transactions[2].to = std::nullopt;
+
+    MonadChainContext context{
+        .grandparent_senders_and_authorities = nullptr,
+        .parent_senders_and_authorities = &parent_senders_and_authorities,
+        .senders_and_authorities = senders_and_authorities,
+        .senders = senders,
+        .authorities = authorities,
+    };
+    auto const classes = classify_reserve_balance(transactions, context);
+    ASSERT_EQ(classes.size(), transactions.size());
+
+    // agrees with scanning the block for every transaction
+    std::vector<bool> expected;
+    for (size_t i = 0; i < senders.size(); ++i) {
+        expected.push_back(
+            can_sender_dip_into_reserve(senders[i], i, NULL_HASH, context));
+    }
+    EXPECT_EQ(
+        expected,
+        (std::vector<bool>{true, true, false, false, false, false}));
+
+    context.reserve_balance_classes = &classes;
+    for (size_t i = 0; i < senders.size(); ++i) {
+        EXPECT_EQ(
+            can_sender_dip_into_reserve(senders[i], i, NULL_HASH, context),
+            expected[i]);
+    }
+    EXPECT_FALSE(
+        can_sender_dip_into_reserve(senders[0], 0, bytes32_t{1}, context));
+
+    EXPECT_TRUE(classes[0].plain_transfer);
+    EXPECT_FALSE(classes[1].plain_transfer);
+    EXPECT_FALSE(classes[2].plain_transfer);
+    EXPECT_TRUE(classes[3].plain_transfer);
+}
+
 TEST(MonadChain, system_transaction_sender_is_authority)
 {
     InMemoryMachine machine;
@@ -0,0 +1,96 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/rlp/transaction_rlp.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/execute_block.hpp>
+#include <category/execution/ethereum/signer_cache.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+using namespace monad;
+
+TEST(SignerRecovery, matches_blocking_recovery)
+{
+    fiber::PriorityPool pool{1, 1};
+    std::vector<Transaction> const txs{
+        Transaction{},
+        Transaction{.authorization_list = {AuthorizationEntry{}}},
+        Transaction{}};
+
+    SignerRecovery recovery{txs, pool};
+    auto const signers = recovery.get();
+    EXPECT_EQ(signers.senders, recover_senders(txs, pool));
+    EXPECT_EQ(signers.authorities, recover_authorities(txs, pool));
+    ASSERT_EQ(signers.authorities.size(), 3);
+    EXPECT_EQ(signers.authorities[1].size(), 1);
+}
+
+TEST(SignerRecovery, empty_block)
+{
+    fiber::PriorityPool pool{1, 1};
+    std::vector<Transaction> const txs;
+
+    SignerRecovery recovery{txs, pool};
+    auto const signers = recovery.get();
+    EXPECT_TRUE(signers.senders.empty());
+    EXPECT_TRUE(signers.authorities.empty());
+}
+
+TEST(SignerRecovery, uses_cache)
+{
+    constexpr auto sender = 0x00000000000000000000000000000000000000a1_address;
+
+    fiber::PriorityPool pool{1, 1};
+    std::vector<Transaction> const txs{
+        Transaction{.nonce = 1}, Transaction{.nonce = 2}};
+    SignerCache cache{16};
+    cache.insert(
+        to_bytes(keccak256(rlp::encode_transaction(txs[0]))),
+        SignerCache::Entry{.sender = sender});
+
+    auto const signers = SignerRecovery{txs, pool, &cache}.get();
+    ASSERT_EQ(signers.senders.size(), 2);
+    EXPECT_EQ(signers.senders[0], sender);
+    EXPECT_EQ(signers.senders[1], recover_sender(txs[1]));
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(SignerRecovery, keeps_transaction_hashes)
+{
+    fiber::PriorityPool pool{1, 1};
+    std::vector<Transaction> const txs{
+        Transaction{.nonce = 1}, Transaction{.nonce = 2}};
+    SignerCache cache{16};
+
+    for (SignerCache *const c : {static_cast<SignerCache *>(nullptr), &cache}) {
+        auto const signers = SignerRecovery{txs, pool, c}.get();
+        ASSERT_EQ(signers.tx_hashes.size(), 2);
+        for (size_t i = 0; i < txs.size(); ++i) {
+            EXPECT_EQ(
+                signers.tx_hashes[i],
+                to_bytes(keccak256(rlp::encode_transaction(txs[i]))));
+        }
+    }
+}
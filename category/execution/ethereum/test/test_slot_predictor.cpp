@@ -0,0 +1,180 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/slot_predictor.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace monad;
+
+namespace
+{
+    constexpr auto token = 0x00000000000000000000000000000000000000b1_address;
+    constexpr auto alice = 0x00000000000000000000000000000000000000a1_address;
+    constexpr auto bob = 0x00000000000000000000000000000000000000a2_address;
+    constexpr auto carol = 0x00000000000000000000000000000000000000a3_address;
+    constexpr auto dave = 0x00000000000000000000000000000000000000a4_address;
+
+    // transfer(address,uint256)
+    constexpr uint8_t transfer[] = {0xa9, 0x05, 0x9c, 0xbb};
+    // approve(address,uint256)
+    constexpr uint8_t approve[] = {0x09, 0x5e, 0xa7, 0xb3};
+
+    bytes32_t word_of(Address const &address)
+    {
+        bytes32_t word{};
+        std::copy_n(address.bytes, sizeof(Address), word.bytes + 12);
+        return word;
+    }
+
+    // Slot of `mapping(address => ...)` declared at `base`
+    bytes32_t entry_of(Address const &key, uint64_t const base)
+    {
+        byte_string preimage{word_of(key).bytes, sizeof(bytes32_t)};
+        preimage += byte_string{bytes32_t{base}.bytes, sizeof(bytes32_t)};
+        return to_bytes(keccak256(preimage));
+    }
+
+    Transaction call(uint8_t const (&selector)[4], Address const &to)
+    {
+        byte_string data{selector, sizeof(selector)};
+        data += byte_string{word_of(to).bytes, sizeof(bytes32_t)};
+        data += byte_string{bytes32_t{100}.bytes, sizeof(bytes32_t)};
+        return Transaction{.to = token, .data = std::move(data)};
+    }
+
+    void learn(
+        SlotPredictor &predictor, Transaction const &tx, Address const &sender,
+        std::vector<bytes32_t> const &reads)
+    {
+        BlockMetrics metrics;
+        metrics.init_txn_slot_reads(1);
+        metrics.set_txn_slot_reads(0, reads);
+        predictor.update({tx}, {sender}, metrics);
+    }
+
+    std::vector<bytes32_t> sorted(std::vector<bytes32_t> slots)
+    {
+        std::ranges::sort(slots);
+        return slots;
+    }
+
+    constexpr auto total_supply =
+        0x0000000000000000000000000000000000000000000000000000000000000002_bytes32;
+}
+
+TEST(SlotPredictor, learns_mapping_entries)
+{
+    SlotPredictor predictor;
+    learn(
+        predictor,
+        call(transfer, bob),
+        alice,
+        {entry_of(alice, 0), entry_of(bob, 0), total_supply});
+    EXPECT_EQ(predictor.num_contracts(), 1);
+
+    // The balances of another transfer are its own sender and recipient
+    EXPECT_EQ(
+        sorted(predictor.predict(call(transfer, dave), carol)),
+        sorted({entry_of(carol, 0), entry_of(dave, 0), total_supply}));
+}
+
+TEST(SlotPredictor, keyed_by_selector)
+{
+    SlotPredictor predictor;
+    learn(predictor, call(transfer, bob), alice, {entry_of(alice, 0)});
+
+    EXPECT_TRUE(predictor.predict(call(approve, bob), alice).empty());
+    auto other = call(transfer, bob);
+    other.to = bob;
+    EXPECT_TRUE(predictor.predict(other, alice).empty());
+    // Without a selector there is no function to predict for
+    EXPECT_TRUE(
+        predictor.predict(Transaction{.to = token}, alice).empty());
+}
+
+TEST(SlotPredictor, slots_decay)
+{
+    SlotPredictor predictor;
+    learn(
+        predictor,
+        call(transfer, bob),
+        alice,
+        {entry_of(alice, 0), total_supply});
+
+    // Calls that keep reading the balance of their sender only
+    for (uint8_t i = 1; i < SlotPredictor::MAX_SCORE; ++i) {
+        learn(predictor, call(transfer, bob), carol, {entry_of(carol, 0)});
+        EXPECT_EQ(predictor.predict(call(transfer, bob), dave).size(), 2);
+    }
+    learn(predictor, call(transfer, bob), carol, {entry_of(carol, 0)});
+    EXPECT_EQ(
+        predictor.predict(call(transfer, bob), dave),
+        std::vector<bytes32_t>{entry_of(dave, 0)});
+
+    // Once no slot is read any more, the contract is forgotten
+    for (uint8_t i = 0; i < SlotPredictor::MAX_SCORE; ++i) {
+        learn(predictor, call(transfer, bob), carol, {});
+    }
+    EXPECT_EQ(predictor.num_contracts(), 0);
+}
+
+TEST(SlotPredictor, learns_only_recorded_reads)
+{
+    SlotPredictor predictor;
+    BlockMetrics metrics;
+    predictor.update({call(transfer, bob)}, {alice}, metrics);
+    EXPECT_EQ(predictor.num_contracts(), 0);
+}
+
+TEST(SlotPredictor, update_hashes_are_bounded)
+{
+    // Calls of distinct functions, each reading the balance of its sender
+    constexpr size_t count = SlotPredictor::MAX_UPDATE_HASHES;
+    std::vector<Transaction> transactions;
+    BlockMetrics metrics;
+    metrics.init_txn_slot_reads(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto tx = call(transfer, bob);
+        tx.data[0] = static_cast<uint8_t>(i >> 8);
+        tx.data[1] = static_cast<uint8_t>(i);
+        transactions.push_back(std::move(tx));
+        metrics.set_txn_slot_reads(i, {entry_of(alice, 0)});
+    }
+    SlotPredictor predictor;
+    predictor.update(
+        transactions, std::vector<Address>(count, alice), metrics);
+
+    // The first calls are learnt as mapping entries, the last ones only
+    // as the fixed slot they read
+    EXPECT_EQ(
+        predictor.predict(transactions.front(), carol),
+        std::vector<bytes32_t>{entry_of(carol, 0)});
+    EXPECT_EQ(
+        predictor.predict(transactions.back(), carol),
+        std::vector<bytes32_t>{entry_of(alice, 0)});
+}
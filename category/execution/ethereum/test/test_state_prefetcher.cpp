@@ -0,0 +1,177 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state_prefetcher.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/vm.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <test_resource_data.h>
+
+#include <optional>
+#include <vector>
+
+using namespace monad;
+using namespace monad::test;
+
+namespace
+{
+    constexpr auto sender = 0x00000000000000000000000000000000000000a1_address;
+    constexpr auto token = 0x00000000000000000000000000000000000000b1_address;
+    constexpr auto other = 0x00000000000000000000000000000000000000b2_address;
+    constexpr auto key =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+    constexpr auto value1 =
+        0x0000000000000000000000000000000000000000000000000000000000000003_bytes32;
+    constexpr auto value2 =
+        0x0000000000000000000000000000000000000000000000000000000000000007_bytes32;
+}
+
+TEST(StatePrefetcher, reads_declared_state)
+{
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {sender,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 100}}}},
+            {token,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 1}},
+                 .storage = {{key, {bytes32_t{}, value1}}}}},
+            {other,
+             StateDelta{.account = {std::nullopt, Account{.balance = 2}}}}},
+        Code{},
+        BlockHeader{.number = 0});
+
+    BlockState bs{tdb, vm};
+    fiber::PriorityPool pool{1, 1};
+    std::vector<Transaction> const txs{
+        {.to = token,
+         .access_list = {AccessEntry{.a = token, .keys = {key}}}}};
+    {
+        StatePrefetcher prefetcher{
+            txs,
+            {sender},
+            std::vector<std::vector<std::optional<Address>>>(1),
+            bs,
+            pool};
+        prefetcher.wait();
+    }
+
+    // Change the database underneath the block state: prefetched entries
+    // keep the values read before the change, the rest see the new ones
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {token,
+             StateDelta{
+                 .account = {Account{.balance = 1}, Account{.balance = 10}},
+                 .storage = {{key, {value1, value2}}}}},
+            {other,
+             StateDelta{
+                 .account = {Account{.balance = 2}, Account{.balance = 20}}}}},
+        Code{},
+        BlockHeader{.number = 1});
+
+    auto const token_account = bs.read_account(token);
+    ASSERT_TRUE(token_account.has_value());
+    EXPECT_EQ(token_account->balance, 1);
+    EXPECT_EQ(bs.read_storage(token, token_account->incarnation, key), value1);
+    ASSERT_TRUE(bs.read_account(sender).has_value());
+    EXPECT_EQ(bs.read_account(sender)->balance, 100);
+    auto const other_account = bs.read_account(other);
+    ASSERT_TRUE(other_account.has_value());
+    EXPECT_EQ(other_account->balance, 20);
+}
+
+TEST(StatePrefetcher, empty_block)
+{
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+
+    BlockState bs{tdb, vm};
+    fiber::PriorityPool pool{1, 1};
+    StatePrefetcher prefetcher{{}, {}, {}, bs, pool};
+    prefetcher.wait();
+}
+
+TEST(StatePrefetcher, analyses_code)
+{
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+
+    byte_string const code{0x60, 0x01, 0x5b, 0x00};
+    bytes32_t const code_hash = to_bytes(keccak256(code));
+    Code code_delta;
+    code_delta.emplace(code_hash, vm::make_shared_intercode(code));
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {sender,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 100}}}},
+            {token,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{.balance = 1, .code_hash = code_hash}}}}},
+        code_delta,
+        BlockHeader{.number = 0});
+
+    BlockState bs{tdb, vm};
+    fiber::PriorityPool pool{1, 1};
+    ASSERT_FALSE(vm.find_varcode(code_hash).has_value());
+    std::vector<Transaction> const txs{{.to = token}};
+    {
+        StatePrefetcher prefetcher{
+            txs,
+            {sender},
+            std::vector<std::vector<std::optional<Address>>>(1),
+            bs,
+            pool};
+        prefetcher.wait();
+    }
+
+    auto const vcode = vm.find_varcode(code_hash);
+    ASSERT_TRUE(vcode.has_value());
+    EXPECT_EQ((*vcode)->intercode()->size(), code.size());
+    EXPECT_FALSE((*vcode)->intercode()->is_jumpdest(1));
+    EXPECT_TRUE((*vcode)->intercode()->is_jumpdest(2));
+}
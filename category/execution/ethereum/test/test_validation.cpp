@@ -15,12 +15,14 @@
 
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
 #include <category/core/int.hpp>
 #include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
 #include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/dao.hpp>
+#include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
 #include <category/execution/ethereum/validate_transaction.hpp>
 #include <category/vm/evm/traits.hpp>
@@ -333,3 +335,50 @@ TEST(Validation, invalid_nonce)
     auto const result = static_validate_header<EvmTraits<EVMC_PARIS>>(header);
     EXPECT_EQ(result.error(), BlockError::InvalidNonce);
 }
+
+TEST(Validation, stateless_validation_of_block)
+{
+    EthereumMainnet const chain;
+    fiber::PriorityPool pool{2, 2};
+
+    Transaction valid{.gas_limit = 21'000};
+    valid.sc.r = 1;
+    valid.sc.s = 1;
+    Transaction low_gas = valid;
+    low_gas.gas_limit = 20'000;
+
+    Block const block{
+        .header =
+            {.ommers_hash = NULL_LIST_HASH,
+             .number = 1,
+             .gas_limit = 10'000,
+             .gas_used = 5'000},
+        .transactions = {valid, low_gas, valid}};
+
+    StatelessValidation<EvmTraits<EVMC_FRONTIER>> validation{
+        chain, block, pool};
+    auto result = validation.get();
+    ASSERT_TRUE(result.has_value());
+    auto const &transactions = result.value();
+    ASSERT_EQ(transactions.size(), 3);
+    EXPECT_FALSE(transactions[0].has_error());
+    EXPECT_EQ(
+        transactions[1].error(),
+        TransactionError::IntrinsicGasGreaterThanLimit);
+    EXPECT_FALSE(transactions[2].has_error());
+}
+
+TEST(Validation, stateless_validation_of_header)
+{
+    EthereumMainnet const chain;
+    fiber::PriorityPool pool{1, 1};
+
+    Block const block{
+        .header = {.ommers_hash = NULL_LIST_HASH, .gas_limit = 1000},
+        .transactions = {Transaction{}}};
+
+    auto const result =
+        StatelessValidation<EvmTraits<EVMC_FRONTIER>>{chain, block, pool}
+            .get();
+    EXPECT_EQ(result.error(), BlockError::InvalidGasLimit);
+}
@@ -0,0 +1,528 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/int.hpp>
+#include <category/core/likely.h>
+#include <category/core/result.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/rlp/decode_error.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+
+#include <ankerl/unordered_dense.h>
+#include <boost/outcome/try.hpp>
+#include <evmc/evmc.h>
+#include <intx/intx.hpp>
+#include <quill/Quill.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+void put_varint(byte_string &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(v));
+}
+
+void put_uint256(byte_string &out, uint256_t const &v)
+{
+    uint8_t be[32];
+    intx::be::store(be, v);
+    size_t skip = 0;
+    while (skip < sizeof(be) && be[skip] == 0) {
+        ++skip;
+    }
+    out.push_back(static_cast<unsigned char>(sizeof(be) - skip));
+    out.append(be + skip, sizeof(be) - skip);
+}
+
+class Reader
+{
+    byte_string_view in_;
+
+public:
+    explicit Reader(byte_string_view const in)
+        : in_{in}
+    {
+    }
+
+    size_t size() const
+    {
+        return in_.size();
+    }
+
+    Result<uint8_t> byte()
+    {
+        if (MONAD_UNLIKELY(in_.empty())) {
+            return rlp::DecodeError::InputTooShort;
+        }
+        uint8_t const b = in_.front();
+        in_.remove_prefix(1);
+        return b;
+    }
+
+    Result<uint64_t> varint()
+    {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            BOOST_OUTCOME_TRY(uint8_t const b, byte());
+            v |= uint64_t{b & 0x7fu} << shift;
+            if (!(b & 0x80)) {
+                return v;
+            }
+        }
+        return rlp::DecodeError::Overflow;
+    }
+
+    Result<byte_string_view> bytes(uint64_t const n)
+    {
+        if (MONAD_UNLIKELY(n > in_.size())) {
+            return rlp::DecodeError::InputTooShort;
+        }
+        auto const out = in_.substr(0, n);
+        in_.remove_prefix(n);
+        return out;
+    }
+
+    Result<uint256_t> uint256()
+    {
+        BOOST_OUTCOME_TRY(uint8_t const n, byte());
+        if (MONAD_UNLIKELY(n > 32)) {
+            return rlp::DecodeError::Overflow;
+        }
+        BOOST_OUTCOME_TRY(auto const digits, bytes(n));
+        uint8_t be[32]{};
+        std::memcpy(be + 32 - n, digits.data(), n);
+        return intx::be::load<uint256_t>(be);
+    }
+};
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+byte_string encode_compact_call_frames(
+    std::span<std::vector<CallFrame> const> const txns,
+    int const compression_level)
+{
+    ankerl::unordered_dense::map<Address, uint64_t> address_index;
+    byte_string addresses;
+    auto const index_of = [&](Address const &address) {
+        auto const [it, inserted] =
+            address_index.try_emplace(address, address_index.size());
+        if (inserted) {
+            addresses.append(address.bytes, sizeof(address.bytes));
+        }
+        return it->second;
+    };
+
+    byte_string counts;
+    byte_string types;
+    byte_string flags;
+    byte_string froms;
+    byte_string tos;
+    byte_string values;
+    byte_string gas;
+    byte_string gas_used;
+    byte_string statuses;
+    byte_string depths;
+    byte_string input_sizes;
+    byte_string output_sizes;
+    byte_string inputs;
+    byte_string outputs;
+    for (auto const &frames : txns) {
+        put_varint(counts, frames.size());
+        for (CallFrame const &frame : frames) {
+            types.push_back(static_cast<unsigned char>(frame.type));
+            put_varint(flags, frame.flags);
+            put_varint(froms, index_of(frame.from));
+            put_varint(tos, frame.to ? index_of(*frame.to) + 1 : 0);
+            put_uint256(values, frame.value);
+            put_varint(gas, frame.gas);
+            put_varint(gas_used, frame.gas_used);
+            statuses.push_back(static_cast<unsigned char>(
+                static_cast<int8_t>(frame.status)));
+            put_varint(depths, frame.depth);
+            put_varint(input_sizes, frame.input.size());
+            put_varint(output_sizes, frame.output.size());
+            inputs += frame.input;
+            outputs += frame.output;
+        }
+    }
+
+    byte_string body;
+    put_varint(body, txns.size());
+    put_varint(body, address_index.size());
+    for (auto const *const column :
+         {&addresses,
+          &counts,
+          &types,
+          &flags,
+          &froms,
+          &tos,
+          &values,
+          &gas,
+          &gas_used,
+          &statuses,
+          &depths,
+          &input_sizes,
+          &output_sizes,
+          &inputs,
+          &outputs}) {
+        body += *column;
+    }
+
+    byte_string out;
+    out.push_back(COMPACT_CALL_FRAMES_VERSION);
+    put_varint(out, body.size());
+    size_t const header_size = out.size();
+    out.resize(header_size + ZSTD_compressBound(body.size()));
+    size_t const compressed = ZSTD_compress(
+        out.data() + header_size,
+        out.size() - header_size,
+        body.data(),
+        body.size(),
+        compression_level);
+    MONAD_ASSERT(!ZSTD_isError(compressed));
+    out.resize(header_size + compressed);
+    return out;
+}
+
+Result<std::vector<std::vector<CallFrame>>>
+decode_compact_call_frames(byte_string_view const enc)
+{
+    Reader header{enc};
+    BOOST_OUTCOME_TRY(uint8_t const version, header.byte());
+    if (MONAD_UNLIKELY(version != COMPACT_CALL_FRAMES_VERSION)) {
+        return rlp::DecodeError::TypeUnexpected;
+    }
+    BOOST_OUTCOME_TRY(uint64_t const body_size, header.varint());
+    auto const compressed = enc.substr(enc.size() - header.size());
+    if (MONAD_UNLIKELY(
+            ZSTD_getFrameContentSize(compressed.data(), compressed.size()) !=
+            body_size)) {
+        return rlp::DecodeError::InputTooShort;
+    }
+    byte_string body(body_size, 0);
+    if (MONAD_UNLIKELY(
+            ZSTD_decompress(
+                body.data(),
+                body.size(),
+                compressed.data(),
+                compressed.size()) != body_size)) {
+        return rlp::DecodeError::InputTooShort;
+    }
+
+    Reader r{body};
+    BOOST_OUTCOME_TRY(uint64_t const ntxns, r.varint());
+    BOOST_OUTCOME_TRY(uint64_t const naddresses, r.varint());
+    if (MONAD_UNLIKELY(
+            ntxns > r.size() || naddresses > r.size() / sizeof(Address))) {
+        return rlp::DecodeError::InputTooShort;
+    }
+    BOOST_OUTCOME_TRY(
+        auto const address_bytes, r.bytes(naddresses * sizeof(Address)));
+    auto const address = [&](uint64_t const i) -> Result<Address> {
+        if (MONAD_UNLIKELY(i >= naddresses)) {
+            return rlp::DecodeError::ArrayLengthUnexpected;
+        }
+        Address a;
+        std::memcpy(
+            a.bytes, address_bytes.data() + i * sizeof(Address), sizeof(a));
+        return a;
+    };
+
+    std::vector<std::vector<CallFrame>> txns(ntxns);
+    // every frame takes at least a byte in each column, which bounds the
+    // number of frames by the size of what is left
+    std::vector<CallFrame *> frames;
+    for (auto &txn : txns) {
+        BOOST_OUTCOME_TRY(uint64_t const n, r.varint());
+        if (MONAD_UNLIKELY(n > r.size() || frames.size() + n > r.size())) {
+            return rlp::DecodeError::InputTooShort;
+        }
+        txn.resize(n);
+        for (auto &frame : txn) {
+            frames.push_back(&frame);
+        }
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(uint8_t const type, r.byte());
+        frame->type = static_cast<CallType>(type);
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(uint64_t const flags, r.varint());
+        frame->flags = static_cast<uint32_t>(flags);
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(uint64_t const i, r.varint());
+        BOOST_OUTCOME_TRY(frame->from, address(i));
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(uint64_t const i, r.varint());
+        if (i != 0) {
+            BOOST_OUTCOME_TRY(frame->to, address(i - 1));
+        }
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(frame->value, r.uint256());
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(frame->gas, r.varint());
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(frame->gas_used, r.varint());
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(uint8_t const status, r.byte());
+        frame->status =
+            static_cast<evmc_status_code>(static_cast<int8_t>(status));
+    }
+    for (auto *const frame : frames) {
+        BOOST_OUTCOME_TRY(frame->depth, r.varint());
+    }
+    std::vector<uint64_t> input_sizes(frames.size());
+    for (auto &size : input_sizes) {
+        BOOST_OUTCOME_TRY(size, r.varint());
+    }
+    std::vector<uint64_t> output_sizes(frames.size());
+    for (auto &size : output_sizes) {
+        BOOST_OUTCOME_TRY(size, r.varint());
+    }
+    for (size_t i = 0; i < frames.size(); ++i) {
+        BOOST_OUTCOME_TRY(auto const input, r.bytes(input_sizes[i]));
+        frames[i]->input = byte_string{input};
+    }
+    for (size_t i = 0; i < frames.size(); ++i) {
+        BOOST_OUTCOME_TRY(auto const output, r.bytes(output_sizes[i]));
+        frames[i]->output = byte_string{output};
+    }
+    if (MONAD_UNLIKELY(r.size() != 0)) {
+        return rlp::DecodeError::InputTooLong;
+    }
+    return txns;
+}
+
+void CallFrameStore::FileCloser::operator()(std::FILE *const f) const
+{
+    (void)std::fclose(f);
+}
+
+CallFrameStore::CallFrameStore(
+    std::filesystem::path const &path, bool const read_only,
+    int const compression_level, std::optional<uint64_t> const history_length)
+    : read_only_{read_only}
+    , compression_level_{compression_level}
+    , history_length_{history_length}
+{
+    int const fd = ::open(
+        path.c_str(),
+        read_only ? (O_RDONLY | O_CLOEXEC) : (O_RDWR | O_CREAT | O_CLOEXEC),
+        0644);
+    MONAD_ASSERT_PRINTF(
+        fd != -1, "could not open call frame store %s", path.c_str());
+    file_.reset(::fdopen(fd, read_only ? "rb" : "r+b"));
+    MONAD_ASSERT(file_);
+    if (!read_only_ && std::filesystem::file_size(path) < sizeof(FileHeader)) {
+        FileHeader const header{.version = VERSION, .begin = sizeof(header)};
+        MONAD_ASSERT(
+            ::pwrite(fd, &header, sizeof(header), 0) == sizeof(header));
+    }
+    index_new_records();
+    if (!read_only_) {
+        auto const size = static_cast<off_t>(indexed_size_);
+        MONAD_ASSERT(::ftruncate(fd, size) == 0);
+    }
+}
+
+void CallFrameStore::index(Key const &key, uint64_t const offset)
+{
+    auto const [it, inserted] = offsets_.try_emplace(key, offset);
+    if (!inserted) {
+        keys_.erase(it->second);
+        it->second = offset;
+    }
+    keys_.emplace(offset, key);
+}
+
+bool CallFrameStore::forget_pruned()
+{
+    FileHeader file_header;
+    if (::pread(::fileno(file_.get()), &file_header, sizeof(file_header), 0) !=
+        sizeof(file_header)) {
+        // a writer has not created the file yet
+        return false;
+    }
+    MONAD_ASSERT_PRINTF(
+        file_header.version == VERSION,
+        "unsupported call frame store version %lu",
+        file_header.version);
+    if (file_header.begin > begin_) {
+        // forget the records a writer pruned
+        auto const pruned = keys_.lower_bound(file_header.begin);
+        for (auto it = keys_.begin(); it != pruned; ++it) {
+            offsets_.erase(it->second);
+        }
+        keys_.erase(keys_.begin(), pruned);
+        begin_ = file_header.begin;
+        indexed_size_ = std::max(indexed_size_, begin_);
+    }
+    return true;
+}
+
+void CallFrameStore::index_new_records()
+{
+    if (!forget_pruned()) {
+        return;
+    }
+    std::FILE *const f = file_.get();
+    MONAD_ASSERT(std::fseek(f, 0, SEEK_END) == 0);
+    auto const end = static_cast<uint64_t>(::ftello(f));
+    while (indexed_size_ + sizeof(RecordHeader) <= end) {
+        RecordHeader header;
+        MONAD_ASSERT(
+            ::fseeko(f, static_cast<off_t>(indexed_size_), SEEK_SET) == 0);
+        if (std::fread(&header, sizeof(header), 1, f) != 1 ||
+            header.size > end - indexed_size_ - sizeof(header)) {
+            break;
+        }
+        index({header.block_number, header.block_id}, indexed_size_);
+        indexed_size_ += sizeof(header) + header.size;
+    }
+}
+
+void CallFrameStore::prune(uint64_t const block_number)
+{
+    if (!history_length_.has_value() || block_number < *history_length_) {
+        return;
+    }
+    auto const expired =
+        offsets_.lower_bound({block_number - *history_length_ + 1, {}});
+    for (auto it = offsets_.begin(); it != expired; ++it) {
+        keys_.erase(it->second);
+    }
+    offsets_.erase(offsets_.begin(), expired);
+    // frees the space up to the oldest record still indexed, which also
+    // takes the records a block appended again left behind
+    uint64_t const begin = keys_.empty() ? indexed_size_ : keys_.begin()->first;
+    if (begin == begin_) {
+        return;
+    }
+    int const fd = ::fileno(file_.get());
+    FileHeader const header{.version = VERSION, .begin = begin};
+    MONAD_ASSERT(::pwrite(fd, &header, sizeof(header), 0) == sizeof(header));
+    // readers check the file header before a lookup and the record header
+    // after it, so they never decode a record whose space was freed under
+    // them. Without hole punching in the file system, the space is only
+    // freed from the index.
+    (void)::fallocate(
+        fd,
+        FALLOC_FL_KEEP_SIZE | FALLOC_FL_PUNCH_HOLE,
+        static_cast<off_t>(begin_),
+        static_cast<off_t>(begin - begin_));
+    begin_ = begin;
+}
+
+void CallFrameStore::append(
+    uint64_t const block_number, bytes32_t const &block_id,
+    std::span<std::vector<CallFrame> const> const txns)
+{
+    MONAD_ASSERT(!read_only_);
+    auto const encoded = encode_compact_call_frames(txns, compression_level_);
+    RecordHeader const header{
+        .block_number = block_number,
+        .block_id = block_id,
+        .size = encoded.size()};
+    std::FILE *const f = file_.get();
+    MONAD_ASSERT(
+        ::fseeko(f, static_cast<off_t>(indexed_size_), SEEK_SET) == 0 &&
+        std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+        std::fwrite(encoded.data(), encoded.size(), 1, f) == 1 &&
+        std::fflush(f) == 0);
+    index({block_number, block_id}, indexed_size_);
+    indexed_size_ += sizeof(header) + encoded.size();
+    prune(block_number);
+}
+
+std::optional<std::vector<std::vector<CallFrame>>>
+CallFrameStore::read(uint64_t const block_number, bytes32_t const &block_id)
+{
+    if (read_only_) {
+        forget_pruned();
+    }
+    auto it = offsets_.find({block_number, block_id});
+    if (it == offsets_.end()) {
+        index_new_records();
+        it = offsets_.find({block_number, block_id});
+        if (it == offsets_.end()) {
+            return std::nullopt;
+        }
+    }
+    std::FILE *const f = file_.get();
+    RecordHeader header;
+    MONAD_ASSERT(::fseeko(f, static_cast<off_t>(it->second), SEEK_SET) == 0);
+    if (MONAD_UNLIKELY(
+            std::fread(&header, sizeof(header), 1, f) != 1 ||
+            header.block_number != block_number ||
+            header.block_id != block_id)) {
+        // pruned by a writer since it was indexed
+        return std::nullopt;
+    }
+    byte_string encoded(header.size, 0);
+    MONAD_ASSERT(std::fread(encoded.data(), encoded.size(), 1, f) == 1);
+    auto decoded = decode_compact_call_frames(encoded);
+    if (MONAD_UNLIKELY(decoded.has_error())) {
+        LOG_ERROR(
+            "corrupt call frames for block {}: {}",
+            block_number,
+            decoded.assume_error().message().c_str());
+        return std::nullopt;
+    }
+    return std::move(decoded).value();
+}
+
+std::optional<std::vector<CallFrame>> CallFrameStore::read(
+    uint64_t const block_number, bytes32_t const &block_id, size_t const txn)
+{
+    auto txns = read(block_number, block_id);
+    if (!txns.has_value() || txn >= txns->size()) {
+        return std::nullopt;
+    }
+    return std::move((*txns)[txn]);
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,144 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+/**
+ * @file
+ *
+ * Compact storage for call traces. A block's call frames are encoded as
+ * columns (one per field, over all frames of the block), with addresses
+ * replaced by indices into a per-block address table and integers written
+ * as varints; the columns and the concatenated inputs and outputs are then
+ * compressed as a single zstd frame.
+ *
+ * Encoded blocks are kept in an append-only file, since call traces are
+ * never part of a Merkle root. The file starts with a header holding the
+ * offset of its oldest record kept; each record is a fixed header followed
+ * by the encoded block. The index of records is rebuilt by scanning the
+ * record headers when the file is opened.
+ */
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/result.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+inline constexpr uint8_t COMPACT_CALL_FRAMES_VERSION = 1;
+
+/// Encode the call frames of every transaction of a block
+byte_string encode_compact_call_frames(
+    std::span<std::vector<CallFrame> const>, int compression_level = 3);
+
+Result<std::vector<std::vector<CallFrame>>>
+    decode_compact_call_frames(byte_string_view);
+
+/// Append-only file of encoded blocks, indexed by block number and id. A
+/// block that is executed again (another proposal at the same height, or a
+/// replay) appends a new record, and lookups return the most recent one.
+/// A truncated record left at the end of the file by a crash is dropped
+/// when the file is opened. Not thread safe.
+class CallFrameStore
+{
+public:
+    static constexpr uint64_t VERSION = 1;
+
+    struct FileHeader
+    {
+        uint64_t version;
+        // offset of the oldest record kept, the space before it is freed
+        uint64_t begin;
+    };
+
+    static_assert(sizeof(FileHeader) == 16);
+
+    struct RecordHeader
+    {
+        uint64_t block_number;
+        bytes32_t block_id;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(RecordHeader) == 48);
+
+    /// A read-only store indexes records appended by a writer in another
+    /// process as it looks them up, and leaves a partial record at the end
+    /// alone, since the writer may still be appending it. A writer given a
+    /// `history_length` keeps, like the trie, only the blocks of the last
+    /// `history_length` block numbers: appending a block drops the older
+    /// ones from the index and frees their space in the file.
+    explicit CallFrameStore(
+        std::filesystem::path const &, bool read_only = false,
+        int compression_level = 3,
+        std::optional<uint64_t> history_length = std::nullopt);
+
+    CallFrameStore(CallFrameStore const &) = delete;
+    CallFrameStore &operator=(CallFrameStore const &) = delete;
+
+    void append(
+        uint64_t block_number, bytes32_t const &block_id,
+        std::span<std::vector<CallFrame> const>);
+
+    /// Call frames of every transaction of the block, or std::nullopt if it
+    /// was never appended or was pruned. Records appended through another
+    /// instance since the last lookup are indexed first.
+    std::optional<std::vector<std::vector<CallFrame>>>
+    read(uint64_t block_number, bytes32_t const &block_id);
+
+    /// Call frames of one transaction of the block
+    std::optional<std::vector<CallFrame>>
+    read(uint64_t block_number, bytes32_t const &block_id, size_t txn);
+
+private:
+    struct FileCloser
+    {
+        void operator()(std::FILE *) const;
+    };
+
+    using Key = std::pair<uint64_t, bytes32_t>;
+
+    void index(Key const &, uint64_t offset);
+    // drops from the index what a writer pruned, false until the file has
+    // a header
+    bool forget_pruned();
+    void index_new_records();
+    void prune(uint64_t block_number);
+
+    std::unique_ptr<std::FILE, FileCloser> file_;
+    bool read_only_;
+    int compression_level_;
+    std::optional<uint64_t> history_length_;
+    uint64_t begin_{0};
+    uint64_t indexed_size_{0};
+    std::map<Key, uint64_t> offsets_;
+    // the key of the record at each offset of offsets_
+    std::map<uint64_t, Key> keys_;
+};
+
+MONAD_NAMESPACE_END
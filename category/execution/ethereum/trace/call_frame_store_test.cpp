@@ -0,0 +1,185 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace monad;
+using namespace evmc::literals;
+
+namespace
+{
+    constexpr auto a = 0x5353535353535353535353535353535353535353_address;
+    constexpr auto b = 0xbebebebebebebebebebebebebebebebebebebebe_address;
+
+    std::vector<std::vector<CallFrame>> sample_block()
+    {
+        return {
+            {CallFrame{
+                 .type = CallType::CALL,
+                 .flags = 0,
+                 .from = a,
+                 .to = b,
+                 .value = 11'111,
+                 .gas = 100'000,
+                 .gas_used = 21'000,
+                 .input = byte_string{0xde, 0xad, 0xbe, 0xef},
+                 .output = byte_string(1000, 0x42),
+                 .status = EVMC_SUCCESS,
+                 .depth = 0},
+             CallFrame{
+                 .type = CallType::CREATE,
+                 .flags = 1,
+                 .from = b,
+                 .to = std::nullopt,
+                 .value = 0,
+                 .gas = 50'000,
+                 .gas_used = 50'000,
+                 .status = EVMC_REVERT,
+                 .depth = 1}},
+            {},
+            {CallFrame{
+                .type = CallType::DELEGATECALL,
+                .from = b,
+                .to = a,
+                .value = ~uint256_t{0},
+                .status = EVMC_INTERNAL_ERROR,
+                .depth = 1024}}};
+    }
+
+    class CallFrameStoreTest : public ::testing::Test
+    {
+    protected:
+        std::filesystem::path path_ =
+            std::filesystem::temp_directory_path() /
+            std::format("call_frame_store_test_{}", getpid());
+
+        void TearDown() override
+        {
+            std::filesystem::remove(path_);
+        }
+    };
+}
+
+TEST(CompactCallFrames, round_trip)
+{
+    auto const block = sample_block();
+    auto const encoded = encode_compact_call_frames(block);
+    auto const decoded = decode_compact_call_frames(encoded);
+    ASSERT_FALSE(decoded.has_error());
+    EXPECT_EQ(decoded.value(), block);
+
+    auto const empty = decode_compact_call_frames(
+        encode_compact_call_frames(std::vector<std::vector<CallFrame>>{}));
+    ASSERT_FALSE(empty.has_error());
+    EXPECT_TRUE(empty.value().empty());
+}
+
+TEST(CompactCallFrames, malformed)
+{
+    auto const encoded = encode_compact_call_frames(sample_block());
+    EXPECT_TRUE(decode_compact_call_frames({}).has_error());
+    EXPECT_TRUE(
+        decode_compact_call_frames(
+            byte_string_view{encoded}.substr(0, encoded.size() - 1))
+            .has_error());
+    auto wrong_version = encoded;
+    wrong_version[0] = 0xff;
+    EXPECT_TRUE(decode_compact_call_frames(wrong_version).has_error());
+}
+
+TEST_F(CallFrameStoreTest, append_and_read)
+{
+    auto const block = sample_block();
+    auto const id1 = bytes32_t{1};
+    auto const id2 = bytes32_t{2};
+    {
+        CallFrameStore store{path_};
+        store.append(10, id1, block);
+        store.append(10, id2, std::vector<std::vector<CallFrame>>{{}});
+        EXPECT_EQ(store.read(10, id1), block);
+        EXPECT_EQ(store.read(10, id1, 2), block[2]);
+        EXPECT_EQ(store.read(10, id1, 3), std::nullopt);
+        EXPECT_EQ(store.read(11, id1), std::nullopt);
+
+        // a reader sees records appended after it was opened
+        CallFrameStore reader{path_, true};
+        store.append(11, id1, block);
+        EXPECT_EQ(reader.read(11, id1), block);
+    }
+
+    // the index is rebuilt on open, and the latest record of a block wins
+    CallFrameStore store{path_};
+    EXPECT_EQ(store.read(10, id2)->size(), 1);
+    store.append(10, id2, block);
+    EXPECT_EQ(store.read(10, id2), block);
+}
+
+TEST_F(CallFrameStoreTest, drops_partial_record)
+{
+    {
+        CallFrameStore store{path_};
+        store.append(1, bytes32_t{1}, sample_block());
+    }
+    auto const size = std::filesystem::file_size(path_);
+    {
+        CallFrameStore store{path_};
+        store.append(2, bytes32_t{2}, sample_block());
+    }
+    std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 1);
+
+    CallFrameStore store{path_};
+    EXPECT_EQ(std::filesystem::file_size(path_), size);
+    EXPECT_EQ(store.read(2, bytes32_t{2}), std::nullopt);
+    store.append(2, bytes32_t{2}, sample_block());
+    EXPECT_EQ(store.read(1, bytes32_t{1}), sample_block());
+    EXPECT_EQ(store.read(2, bytes32_t{2}), sample_block());
+}
+
+TEST_F(CallFrameStoreTest, prunes_with_history)
+{
+    auto const block = sample_block();
+    CallFrameStore store{path_, false, 3, 2};
+    CallFrameStore reader{path_, true};
+    store.append(1, bytes32_t{1}, block);
+    EXPECT_EQ(reader.read(1, bytes32_t{1}), block);
+    store.append(2, bytes32_t{2}, block);
+    store.append(3, bytes32_t{3}, block);
+    EXPECT_EQ(store.read(1, bytes32_t{1}), std::nullopt);
+    EXPECT_EQ(store.read(2, bytes32_t{2}), block);
+
+    // a reader forgets what a writer pruned, even if it was indexed before
+    EXPECT_EQ(reader.read(1, bytes32_t{1}), std::nullopt);
+    EXPECT_EQ(reader.read(3, bytes32_t{3}), block);
+
+    // the index rebuilt on open starts at the oldest record kept
+    CallFrameStore reopened{path_, true};
+    EXPECT_EQ(reopened.read(1, bytes32_t{1}), std::nullopt);
+    EXPECT_EQ(reopened.read(2, bytes32_t{2}), block);
+    EXPECT_EQ(reopened.read(3, bytes32_t{3}), block);
+}
@@ -16,6 +16,11 @@
 #pragma once
 
 #include <category/core/config.hpp>
+#include <category/core/fiber/priority_properties.hpp>
+#include <category/core/likely.h>
+#include <category/execution/ethereum/trace/span_trace.hpp>
+
+#include <boost/fiber/operations.hpp>
 
 #include <quill/Quill.h>
 
@@ -25,11 +30,6 @@
 #include <utility>
 
 #ifdef ENABLE_EVENT_TRACING
-    #include <category/core/fiber/priority_properties.hpp>
-    #include <category/core/likely.h>
-
-    #include <boost/fiber/operations.hpp>
-
     #define TRACE_BLOCK_EVENT(enum)                                            \
         auto const timer_##enum =                                              \
             TraceTimer{TraceEvent{TraceType::enum, block.header.number}};
@@ -51,30 +51,30 @@
                 }                                                              \
             }()}};
 #else
-    #define TRACE_BLOCK_EVENT(enum)
-    #define TRACE_TXN_EVENT(enum)
+    // Without ENABLE_EVENT_TRACING, events are spans recorded only once
+    // enable_span_tracing() is called. The fibers running transactions all
+    // carry PriorityProperties, so no dynamic_cast is needed.
+    #define TRACE_BLOCK_EVENT(enum)                                            \
+        auto const span_##enum = TraceSpan{                                    \
+            TraceType::enum, [&] { return block.header.number; }};
+
+    #define TRACE_TXN_EVENT(enum)                                              \
+        auto const span_##enum = TraceSpan{                                    \
+            TraceType::enum, [] {                                              \
+                auto const *const props =                                      \
+                    boost::fibers::context::active()->get_properties();        \
+                return props ? static_cast<                                    \
+                                   monad::fiber::PriorityProperties const *>(  \
+                                   props)                                      \
+                                   ->get_priority()                            \
+                             : 0ul;                                            \
+            }};
 #endif
 
 MONAD_NAMESPACE_BEGIN
 
 extern quill::Logger *event_tracer;
 
-enum class TraceType : uint8_t
-{
-    StartBlock = 0,
-    StartTxn = 1,
-    StartSenderRecovery = 2,
-    StartExecution = 3,
-    StartStall = 4,
-    StartRetry = 5,
-    EndBlock = 6,
-    EndTxn = 7,
-    EndSenderRecovery = 8,
-    EndExecution = 9,
-    EndStall = 10,
-    EndRetry = 11,
-};
-
 struct TraceEvent
 {
     TraceType type;
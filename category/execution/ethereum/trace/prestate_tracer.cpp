@@ -27,8 +27,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <format>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -47,10 +51,30 @@ namespace trace
         return std::format("0x{}", evmc::hex(view));
     }
 
+    namespace
+    {
+        bool is_traced(Address const &address)
+        {
+            // TODO: Because this address is "touched". Should we keep this for
+            // monad?
+            return address != monad::ripemd_address;
+        }
+    }
+
     void PrestateTracer::encode(
         Map<Address, OriginalAccountState> const &prestate, State &state)
     {
-        state_to_json(prestate, state, storage_);
+        if (json_ != nullptr) {
+            state_to_json(prestate, state, *json_);
+            return;
+        }
+        // like the json, which stays null, nothing is written without an
+        // account to report
+        if (std::ranges::any_of(prestate, [](auto const &entry) {
+                return is_traced(entry.first);
+            })) {
+            state_to_cbor(prestate, state, *cbor_);
+        }
     }
 
     StorageDeltas StateDiffTracer::generate_storage_deltas(
@@ -104,7 +128,11 @@ namespace trace
 
     void StateDiffTracer::encode(StateDeltas const &state_deltas, State &state)
     {
-        state_deltas_to_json(state_deltas, state, storage_);
+        if (json_ != nullptr) {
+            state_deltas_to_json(state_deltas, state, *json_);
+            return;
+        }
+        state_deltas_to_cbor(state_deltas, state, *cbor_);
     }
 
     void run_tracer(StateTracer const &tracer, State &state)
@@ -175,9 +203,7 @@ namespace trace
         json &result)
     {
         for (auto const &[address, account_state] : trace) {
-            // TODO: Because this address is "touched". Should we keep this for
-            // monad?
-            if (MONAD_UNLIKELY(address == monad::ripemd_address)) {
+            if (MONAD_UNLIKELY(!is_traced(address))) {
                 continue;
             }
             auto const key = bytes_to_hex(address.bytes);
@@ -307,6 +333,315 @@ namespace trace
         state_deltas_to_json(state_deltas, state, result);
         return result;
     }
+
+    // CBOR serialization, byte for byte what nlohmann::json::to_cbor makes of
+    // the json serialization, written straight from the state. Objects are
+    // maps with their keys in sorted order, as the json objects keep them.
+    namespace
+    {
+        constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        enum class CborMajor : uint8_t
+        {
+            Unsigned = 0,
+            Text = 3,
+            Map = 5,
+        };
+
+        void
+        cbor_head(byte_string &out, CborMajor const major, uint64_t const v)
+        {
+            uint64_t const type = static_cast<uint64_t>(major) << 5;
+            if (v < 24) {
+                out.push_back(static_cast<unsigned char>(type | v));
+                return;
+            }
+            // the additional info 24 + n is followed by 2^n bytes of `v`
+            unsigned n = 0;
+            while (n < 3 && (v >> (8u << n)) != 0) {
+                ++n;
+            }
+            out.push_back(static_cast<unsigned char>(type | (24 + n)));
+            unsigned const width = 1u << n;
+            for (unsigned i = width; i-- > 0;) {
+                out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+            }
+        }
+
+        void cbor_text(byte_string &out, std::string_view const text)
+        {
+            cbor_head(out, CborMajor::Text, text.size());
+            out.append(
+                reinterpret_cast<unsigned char const *>(text.data()),
+                text.size());
+        }
+
+        void cbor_hex(byte_string &out, byte_string_view const bytes)
+        {
+            cbor_head(out, CborMajor::Text, 2 + 2 * bytes.size());
+            out.push_back('0');
+            out.push_back('x');
+            for (auto const b : bytes) {
+                out.push_back(static_cast<unsigned char>(HEX_DIGITS[b >> 4]));
+                out.push_back(static_cast<unsigned char>(HEX_DIGITS[b & 0xf]));
+            }
+        }
+
+        // hex without leading zeros, as intx::to_string(v, 16)
+        void cbor_quantity(byte_string &out, uint256_t v)
+        {
+            unsigned char digits[64];
+            size_t n = 0;
+            do {
+                digits[sizeof(digits) - ++n] = static_cast<unsigned char>(
+                    HEX_DIGITS[static_cast<uint64_t>(v) & 0xf]);
+                v >>= 4;
+            }
+            while (v != 0);
+            cbor_head(out, CborMajor::Text, 2 + n);
+            out.push_back('0');
+            out.push_back('x');
+            out.append(digits + sizeof(digits) - n, n);
+        }
+
+        void
+        cbor_code(byte_string &out, bytes32_t const &code_hash, State &state)
+        {
+            auto const icode = state.read_code(code_hash)->intercode();
+            cbor_hex(out, byte_string_view(icode->code(), *icode->code_size()));
+        }
+
+        size_t account_field_count(std::optional<Account> const &account)
+        {
+            if (MONAD_UNLIKELY(!account.has_value())) {
+                return 1;
+            }
+            return 1 + (account->code_hash != NULL_HASH) +
+                   (account->nonce != 0);
+        }
+
+        // the fields of `account_to_json`, without the map head
+        void cbor_account_fields(
+            byte_string &out, std::optional<Account> const &account,
+            State &state)
+        {
+            cbor_text(out, "balance");
+            if (MONAD_UNLIKELY(!account.has_value())) {
+                cbor_quantity(out, 0);
+                return;
+            }
+            cbor_quantity(out, account->balance);
+            if (account->code_hash != NULL_HASH) {
+                cbor_text(out, "code");
+                cbor_code(out, account->code_hash, state);
+            }
+            if (account->nonce != 0) {
+                cbor_text(out, "nonce");
+                cbor_head(out, CborMajor::Unsigned, account->nonce);
+            }
+        }
+
+        using Slots = std::vector<std::pair<bytes32_t, bytes32_t>>;
+
+        void sort_slots(Slots &slots)
+        {
+            std::ranges::sort(slots, [](auto const &a, auto const &b) {
+                return std::memcmp(
+                           a.first.bytes, b.first.bytes, sizeof(bytes32_t)) <
+                       0;
+            });
+        }
+
+        void cbor_storage(byte_string &out, Slots const &slots)
+        {
+            cbor_text(out, "storage");
+            cbor_head(out, CborMajor::Map, slots.size());
+            for (auto const &[key, value] : slots) {
+                cbor_hex(out, to_byte_string_view(key.bytes));
+                cbor_hex(out, to_byte_string_view(value.bytes));
+            }
+        }
+
+        template <typename T>
+        void sort_by_address(std::vector<T const *> &entries)
+        {
+            std::ranges::sort(entries, [](T const *const a, T const *const b) {
+                return std::memcmp(
+                           a->first.bytes, b->first.bytes, sizeof(Address)) <
+                       0;
+            });
+        }
+    }
+
+    void state_to_cbor(
+        Map<Address, OriginalAccountState> const &trace, State &state,
+        byte_string &result)
+    {
+        using Entry = std::pair<Address const, OriginalAccountState>;
+        std::vector<Entry const *> entries;
+        entries.reserve(trace.size());
+        for (auto const &entry : trace) {
+            if (MONAD_LIKELY(is_traced(entry.first))) {
+                entries.push_back(&entry);
+            }
+        }
+        sort_by_address(entries);
+
+        Slots slots;
+        cbor_head(result, CborMajor::Map, entries.size());
+        for (Entry const *const entry : entries) {
+            auto const &account = entry->second.account_;
+            auto const &storage = entry->second.storage_;
+            bool const with_storage = !storage.empty() && account.has_value();
+
+            cbor_hex(result, to_byte_string_view(entry->first.bytes));
+            cbor_head(
+                result,
+                CborMajor::Map,
+                account_field_count(account) + with_storage);
+            cbor_account_fields(result, account, state);
+            if (with_storage) {
+                slots.assign(storage.begin(), storage.end());
+                sort_slots(slots);
+                cbor_storage(result, slots);
+            }
+        }
+    }
+
+    byte_string
+    state_to_cbor(Map<Address, OriginalAccountState> const &trace, State &state)
+    {
+        byte_string result;
+        state_to_cbor(trace, state, result);
+        return result;
+    }
+
+    void state_deltas_to_cbor(
+        StateDeltas const &state_deltas, State &state, byte_string &result)
+    {
+        // follows the cases of `state_deltas_to_json`
+        using Entry = std::pair<Address const, StateDelta>;
+        struct Diff
+        {
+            Entry const *entry;
+            Slots pre_storage;
+            Slots post_storage;
+            size_t pre_fields{0};
+            size_t post_fields{0};
+            bool balance_changed{false};
+            bool code_changed{false};
+            bool nonce_changed{false};
+        };
+
+        std::vector<Entry const *> entries;
+        for (auto const &entry : state_deltas) {
+            entries.push_back(&entry);
+        }
+        sort_by_address(entries);
+
+        std::vector<Diff> diffs;
+        diffs.reserve(entries.size());
+        size_t num_pre = 0;
+        size_t num_post = 0;
+        for (Entry const *const entry : entries) {
+            auto &diff = diffs.emplace_back(Diff{.entry = entry});
+            auto const &original = entry->second.account.first;
+            auto const &current = entry->second.account.second;
+            if (!original.has_value() && current.has_value()) {
+                diff.post_fields = account_field_count(current);
+            }
+            else if (original.has_value() && !current.has_value()) {
+                diff.pre_fields = account_field_count(original);
+            }
+            else {
+                MONAD_ASSERT(original.has_value());
+                MONAD_ASSERT(current.has_value());
+                diff.pre_fields = account_field_count(original);
+                diff.balance_changed = original->balance != current->balance;
+                diff.code_changed = original->code_hash != current->code_hash;
+                diff.nonce_changed = original->nonce != current->nonce;
+                diff.post_fields = diff.balance_changed + diff.code_changed +
+                                   diff.nonce_changed;
+            }
+            for (auto const &[key, storage_delta] : entry->second.storage) {
+                if (MONAD_LIKELY(storage_delta.first != bytes32_t{})) {
+                    diff.pre_storage.emplace_back(key, storage_delta.first);
+                }
+                if (MONAD_LIKELY(storage_delta.second != bytes32_t{})) {
+                    diff.post_storage.emplace_back(key, storage_delta.second);
+                }
+            }
+            sort_slots(diff.pre_storage);
+            sort_slots(diff.post_storage);
+            num_pre += (diff.pre_fields + diff.pre_storage.size()) != 0;
+            num_post += (diff.post_fields + diff.post_storage.size()) != 0;
+        }
+
+        cbor_head(result, CborMajor::Map, 2);
+
+        cbor_text(result, "post");
+        cbor_head(result, CborMajor::Map, num_post);
+        for (auto const &diff : diffs) {
+            if (diff.post_fields + diff.post_storage.size() == 0) {
+                continue;
+            }
+            auto const &original = diff.entry->second.account.first;
+            auto const &current = diff.entry->second.account.second;
+            cbor_hex(result, to_byte_string_view(diff.entry->first.bytes));
+            cbor_head(
+                result,
+                CborMajor::Map,
+                diff.post_fields + !diff.post_storage.empty());
+            if (!original.has_value()) {
+                cbor_account_fields(result, current, state);
+            }
+            else if (current.has_value()) {
+                if (diff.balance_changed) {
+                    cbor_text(result, "balance");
+                    cbor_quantity(result, current->balance);
+                }
+                if (diff.code_changed) {
+                    cbor_text(result, "code");
+                    cbor_code(result, current->code_hash, state);
+                }
+                if (diff.nonce_changed) {
+                    cbor_text(result, "nonce");
+                    cbor_head(result, CborMajor::Unsigned, current->nonce);
+                }
+            }
+            if (!diff.post_storage.empty()) {
+                cbor_storage(result, diff.post_storage);
+            }
+        }
+
+        cbor_text(result, "pre");
+        cbor_head(result, CborMajor::Map, num_pre);
+        for (auto const &diff : diffs) {
+            if (diff.pre_fields + diff.pre_storage.size() == 0) {
+                continue;
+            }
+            cbor_hex(result, to_byte_string_view(diff.entry->first.bytes));
+            cbor_head(
+                result,
+                CborMajor::Map,
+                diff.pre_fields + !diff.pre_storage.empty());
+            if (diff.pre_fields != 0) {
+                cbor_account_fields(
+                    result, diff.entry->second.account.first, state);
+            }
+            if (!diff.pre_storage.empty()) {
+                cbor_storage(result, diff.pre_storage);
+            }
+        }
+    }
+
+    byte_string
+    state_deltas_to_cbor(StateDeltas const &state_deltas, State &state)
+    {
+        byte_string result;
+        state_deltas_to_cbor(state_deltas, state, result);
+        return result;
+    }
 }
 
 MONAD_NAMESPACE_END
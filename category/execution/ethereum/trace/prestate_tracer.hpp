@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <category/core/byte_string.hpp>
 #include <category/core/config.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/state2/state_deltas.hpp>
@@ -35,25 +36,38 @@ namespace trace
 {
 
     template <typename Key, typename Elem>
-    using Map = ankerl::unordered_dense::segmented_map<Key, Elem>;
+    using Map = AccountState::Map<Key, Elem>;
 
+    // The tracers write either json or, without building the json, its
+    // CBOR encoding
     struct PrestateTracer
     {
         PrestateTracer(nlohmann::json &storage)
-            : storage_(storage)
+            : json_(&storage)
+        {
+        }
+
+        PrestateTracer(byte_string &cbor)
+            : cbor_(&cbor)
         {
         }
 
         void encode(Map<Address, OriginalAccountState> const &, State &);
 
     private:
-        nlohmann::json &storage_;
+        nlohmann::json *json_{nullptr};
+        byte_string *cbor_{nullptr};
     };
 
     struct StateDiffTracer
     {
         StateDiffTracer(nlohmann::json &storage)
-            : storage_(storage)
+            : json_(&storage)
+        {
+        }
+
+        StateDiffTracer(byte_string &cbor)
+            : cbor_(&cbor)
         {
         }
 
@@ -64,7 +78,8 @@ namespace trace
         StorageDeltas generate_storage_deltas(
             Map<bytes32_t, bytes32_t> const &,
             Map<bytes32_t, bytes32_t> const &);
-        nlohmann::json &storage_;
+        nlohmann::json *json_{nullptr};
+        byte_string *cbor_{nullptr};
     };
 
     using StateTracer =
@@ -77,6 +92,14 @@ namespace trace
         Map<Address, OriginalAccountState> const &, State &, nlohmann::json &);
     nlohmann::json state_deltas_to_json(StateDeltas const &, State &);
     void state_deltas_to_json(StateDeltas const &, State &, nlohmann::json &);
+
+    // Same as nlohmann::json::to_cbor of the json above
+    byte_string
+    state_to_cbor(Map<Address, OriginalAccountState> const &, State &);
+    void state_to_cbor(
+        Map<Address, OriginalAccountState> const &, State &, byte_string &);
+    byte_string state_deltas_to_cbor(StateDeltas const &, State &);
+    void state_deltas_to_cbor(StateDeltas const &, State &, byte_string &);
 }
 
 MONAD_NAMESPACE_END
@@ -25,6 +25,7 @@
 #include <test_resource_data.h>
 
 #include <bit>
+#include <cstring>
 
 using namespace monad;
 using namespace monad::test;
@@ -65,6 +66,12 @@ namespace
     constexpr auto addr2 = 0x008b3b2f992c0e14edaa6e2c662bec549caa8df1_address;
     constexpr auto addr3 = 0x35a9f94af726f07b5162df7e828cc9dc8439e7d0_address;
     constexpr auto addr4 = 0xc8ba32cab1757528daf49033e3673fae77dcf05d_address;
+
+    byte_string to_cbor(nlohmann::json const &json)
+    {
+        auto const cbor = nlohmann::json::to_cbor(json);
+        return byte_string{cbor.begin(), cbor.end()};
+    }
 }
 
 TEST(PrestateTracer, pre_state_to_json)
@@ -109,6 +116,7 @@ TEST(PrestateTracer, pre_state_to_json)
     })";
 
     EXPECT_EQ(state_to_json(prestate, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(state_to_cbor(prestate, s), to_cbor(state_to_json(prestate, s)));
 }
 
 TEST(PrestateTracer, zero_nonce)
@@ -139,6 +147,7 @@ TEST(PrestateTracer, zero_nonce)
     })";
 
     EXPECT_EQ(state_to_json(prestate, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(state_to_cbor(prestate, s), to_cbor(state_to_json(prestate, s)));
 }
 
 TEST(PrestateTracer, state_deltas_to_json)
@@ -186,6 +195,9 @@ TEST(PrestateTracer, state_deltas_to_json)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
 
 TEST(PrestateTracer, statediff_account_creation)
@@ -223,6 +235,9 @@ TEST(PrestateTracer, statediff_account_creation)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
 
 TEST(PrestateTracer, statediff_balance_nonce_update)
@@ -268,6 +283,9 @@ TEST(PrestateTracer, statediff_balance_nonce_update)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
 
 TEST(PrestateTracer, statediff_delete_storage)
@@ -326,6 +344,9 @@ TEST(PrestateTracer, statediff_delete_storage)
     EXPECT_EQ(
         state_deltas_to_json(state_deltas2, s),
         nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas2, s),
+        to_cbor(state_deltas_to_json(state_deltas2, s)));
 }
 
 TEST(PrestateTracer, statediff_multiple_fields_update)
@@ -386,6 +407,9 @@ TEST(PrestateTracer, statediff_multiple_fields_update)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
 
 TEST(PrestateTracer, statediff_account_deletion)
@@ -427,6 +451,9 @@ TEST(PrestateTracer, statediff_account_deletion)
     EXPECT_EQ(
         state_deltas_to_json(state_deltas2, s),
         nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas2, s),
+        to_cbor(state_deltas_to_json(state_deltas2, s)));
 }
 
 TEST(PrestateTracer, geth_example_prestate)
@@ -501,6 +528,7 @@ TEST(PrestateTracer, geth_example_prestate)
     })";
 
     EXPECT_EQ(state_to_json(prestate, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(state_to_cbor(prestate, s), to_cbor(state_to_json(prestate, s)));
 }
 
 TEST(PrestateTracer, geth_example_statediff)
@@ -542,6 +570,9 @@ TEST(PrestateTracer, geth_example_statediff)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
 
 TEST(PrestateTracer, prestate_empty)
@@ -562,6 +593,7 @@ TEST(PrestateTracer, prestate_empty)
     auto const json_str = R"({})";
 
     EXPECT_EQ(state_to_json(prestate, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(state_to_cbor(prestate, s), to_cbor(state_to_json(prestate, s)));
 }
 
 TEST(PrestateTracer, statediff_empty)
@@ -589,4 +621,54 @@ TEST(PrestateTracer, statediff_empty)
 
     EXPECT_EQ(
         state_deltas_to_json(state_deltas, s), nlohmann::json::parse(json_str));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
+}
+
+// The direct CBOR encoding matches encoding the json on a trace the size of
+// a big transaction. Timings are in the trace_encoding_bench benchmark.
+TEST(PrestateTracer, cbor_encoding_of_large_trace)
+{
+    constexpr unsigned NUM_ACCOUNTS = 512;
+    constexpr unsigned NUM_SLOTS = 64;
+
+    trace::Map<Address, OriginalAccountState> prestate{};
+    StateDeltas state_deltas{};
+    for (unsigned i = 0; i < NUM_ACCOUNTS; ++i) {
+        Address address{};
+        std::memcpy(address.bytes, &i, sizeof(i));
+        Account const a{.balance = 1000 + i, .nonce = i};
+        Account b = a;
+        b.balance += 1;
+        OriginalAccountState as{a};
+        StorageDeltas storage{};
+        for (unsigned j = 0; j < NUM_SLOTS; ++j) {
+            bytes32_t key{};
+            bytes32_t value{};
+            std::memcpy(key.bytes, &j, sizeof(j));
+            std::memcpy(value.bytes + 16, &i, sizeof(i));
+            as.storage_.emplace(key, value);
+            storage.emplace(key, StorageDelta{value, bytes32_t{}});
+        }
+        prestate.emplace(address, std::move(as));
+        state_deltas.emplace(
+            address,
+            StateDelta{.account = {a, b}, .storage = std::move(storage)});
+    }
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+
+    commit_sequential(tdb, {}, Code{}, BlockHeader{.number = 0});
+
+    BlockState bs(tdb, vm);
+    State s(bs, Incarnation{0, 0});
+
+    EXPECT_EQ(state_to_cbor(prestate, s), to_cbor(state_to_json(prestate, s)));
+    EXPECT_EQ(
+        state_deltas_to_cbor(state_deltas, s),
+        to_cbor(state_deltas_to_json(state_deltas, s)));
 }
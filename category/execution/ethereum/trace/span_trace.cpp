@@ -0,0 +1,192 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/core/tl_tid.h>
+#include <category/execution/ethereum/trace/span_trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace detail
+{
+    std::atomic<bool> span_tracing_enabled{false};
+}
+
+namespace
+{
+    struct SpanRing
+    {
+        std::unique_ptr<SpanRecord[]> records;
+        size_t capacity;
+        std::atomic<uint64_t> next{0};
+
+        explicit SpanRing(size_t const capacity)
+            : records{std::make_unique<SpanRecord[]>(capacity)}
+            , capacity{capacity}
+        {
+        }
+    };
+
+    struct SpanRegistry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<SpanRing>> rings;
+        size_t records_per_thread{0};
+        uint64_t start_tsc{0};
+        std::chrono::steady_clock::time_point start_time{};
+    };
+
+    SpanRegistry &registry()
+    {
+        static SpanRegistry r;
+        return r;
+    }
+
+    // Registered on the first span a thread records, and kept by the
+    // registry after the thread exits so that its spans are exported.
+    thread_local std::shared_ptr<SpanRing> thread_ring;
+
+    SpanRing &get_thread_ring()
+    {
+        if (MONAD_UNLIKELY(!thread_ring)) {
+            auto &r = registry();
+            std::lock_guard const lock{r.mutex};
+            thread_ring = std::make_shared<SpanRing>(r.records_per_thread);
+            r.rings.push_back(thread_ring);
+        }
+        return *thread_ring;
+    }
+
+    std::string_view span_name(TraceType const type)
+    {
+        switch (type) {
+        case TraceType::StartBlock:
+            return "block";
+        case TraceType::StartTxn:
+            return "txn";
+        case TraceType::StartSenderRecovery:
+            return "sender_recovery";
+        case TraceType::StartExecution:
+            return "execution";
+        case TraceType::StartStall:
+            return "stall";
+        case TraceType::StartRetry:
+            return "retry";
+        default:
+            MONAD_ASSERT(false);
+        }
+    }
+}
+
+void enable_span_tracing(size_t const records_per_thread)
+{
+    MONAD_ASSERT(records_per_thread > 0);
+    auto &r = registry();
+    std::lock_guard const lock{r.mutex};
+    if (detail::span_tracing_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    r.records_per_thread = records_per_thread;
+    r.start_tsc = read_tsc();
+    r.start_time = std::chrono::steady_clock::now();
+    detail::span_tracing_enabled.store(true, std::memory_order_release);
+}
+
+void record_span(SpanRecord const &record)
+{
+    auto &ring = get_thread_ring();
+    auto const next = ring.next.load(std::memory_order_relaxed);
+    auto &slot = ring.records[next % ring.capacity];
+    slot = record;
+    slot.thread = static_cast<uint32_t>(get_tl_tid());
+    ring.next.store(next + 1, std::memory_order_release);
+}
+
+std::vector<SpanRecord> collect_spans()
+{
+    auto &r = registry();
+    std::lock_guard const lock{r.mutex};
+    std::vector<SpanRecord> spans;
+    for (auto const &ring : r.rings) {
+        auto const next = ring->next.load(std::memory_order_acquire);
+        auto const n = std::min<uint64_t>(next, ring->capacity);
+        for (auto i = next - n; i < next; ++i) {
+            spans.push_back(ring->records[i % ring->capacity]);
+        }
+    }
+    std::ranges::sort(spans, {}, &SpanRecord::start);
+    return spans;
+}
+
+void write_chrome_trace(
+    std::ostream &os, std::vector<SpanRecord> const &spans)
+{
+    auto &r = registry();
+    uint64_t start_tsc;
+    double us_per_tick;
+    {
+        std::lock_guard const lock{r.mutex};
+        start_tsc = r.start_tsc;
+        auto const ticks = read_tsc() - start_tsc;
+        auto const elapsed = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - r.start_time);
+        us_per_tick =
+            ticks ? elapsed.count() / static_cast<double>(ticks) : 0.0;
+    }
+    auto const to_us = [&](uint64_t const tsc) {
+        return static_cast<double>(tsc - std::min(tsc, start_tsc)) *
+               us_per_tick;
+    };
+    auto const write_event = [&](SpanRecord const &span,
+                                 char const phase,
+                                 uint64_t const tsc) {
+        auto const is_block = span.type == TraceType::StartBlock;
+        os << "{\"name\":\"" << span_name(span.type) << "\",\"cat\":\""
+           << (is_block ? "block" : "txn") << "\",\"ph\":\"" << phase
+           << "\",\"id\":" << span.value << ",\"ts\":" << to_us(tsc)
+           << ",\"pid\":1,\"tid\":" << span.thread << ",\"args\":{\""
+           << (is_block ? "block" : "txn") << "\":" << span.value << "}}";
+    };
+
+    auto const flags = os.flags();
+    os << std::fixed;
+    os.precision(3);
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (auto const &span : spans) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        write_event(span, 'b', span.start);
+        os << ",\n";
+        write_event(span, 'e', span.end);
+    }
+    os << "\n]}\n";
+    os.flags(flags);
+}
+
+MONAD_NAMESPACE_END
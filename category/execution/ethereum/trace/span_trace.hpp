@@ -0,0 +1,127 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/core/likely.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+enum class TraceType : uint8_t
+{
+    StartBlock = 0,
+    StartTxn = 1,
+    StartSenderRecovery = 2,
+    StartExecution = 3,
+    StartStall = 4,
+    StartRetry = 5,
+    EndBlock = 6,
+    EndTxn = 7,
+    EndSenderRecovery = 8,
+    EndExecution = 9,
+    EndStall = 10,
+    EndRetry = 11,
+};
+
+/// A finished span, as kept in the ring buffer of the thread it ended on.
+/// Times are in TSC ticks; `value` is the block number of a block span and
+/// the transaction index of any other span.
+struct SpanRecord
+{
+    uint64_t start;
+    uint64_t end;
+    uint64_t value;
+    uint32_t thread;
+    TraceType type;
+};
+
+static_assert(sizeof(SpanRecord) == 32);
+static_assert(alignof(SpanRecord) == 8);
+
+namespace detail
+{
+    extern std::atomic<bool> span_tracing_enabled;
+}
+
+[[gnu::always_inline]] inline bool span_tracing_enabled() noexcept
+{
+    return detail::span_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+[[gnu::always_inline]] inline uint64_t read_tsc() noexcept
+{
+    return __builtin_ia32_rdtsc();
+}
+
+/// Start keeping the last `records_per_thread` spans of every thread. Only
+/// the first call has an effect.
+void enable_span_tracing(size_t records_per_thread);
+
+void record_span(SpanRecord const &);
+
+/// The spans kept by all threads, in order of their start. Spans recorded
+/// while collecting may be missed or, once a ring buffer wraps, torn.
+std::vector<SpanRecord> collect_spans();
+
+/// Write `spans` as a trace in the Chrome JSON trace event format, which
+/// Perfetto and chrome://tracing open. Spans are async events keyed by
+/// block number or transaction index, as fibers move between threads and
+/// interleave on one thread.
+void write_chrome_trace(std::ostream &, std::vector<SpanRecord> const &);
+
+/// Records a span from construction to destruction if span tracing is
+/// enabled, which costs a relaxed load otherwise. `value` is only invoked
+/// when recording.
+class TraceSpan
+{
+    uint64_t start_{0};
+    uint64_t value_{0};
+    TraceType type_;
+
+public:
+    template <typename Value>
+    TraceSpan(TraceType const type, Value &&value)
+        : type_{type}
+    {
+        if (MONAD_UNLIKELY(span_tracing_enabled())) {
+            value_ = value();
+            start_ = read_tsc();
+        }
+    }
+
+    TraceSpan(TraceSpan const &) = delete;
+    TraceSpan &operator=(TraceSpan const &) = delete;
+
+    ~TraceSpan()
+    {
+        if (MONAD_UNLIKELY(start_ != 0)) {
+            record_span(SpanRecord{
+                .start = start_,
+                .end = read_tsc(),
+                .value = value_,
+                .thread = 0,
+                .type = type_});
+        }
+    }
+};
+
+MONAD_NAMESPACE_END
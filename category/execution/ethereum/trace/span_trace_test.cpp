@@ -0,0 +1,94 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/execution/ethereum/trace/span_trace.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace monad;
+
+TEST(SpanTrace, records_nested_spans_per_thread)
+{
+    {
+        TraceSpan const disabled{TraceType::StartBlock, [] { return 1ul; }};
+    }
+    EXPECT_TRUE(collect_spans().empty());
+
+    enable_span_tracing(4);
+    ASSERT_TRUE(span_tracing_enabled());
+
+    auto const run_txn = [](uint64_t const i) {
+        TraceSpan const txn{TraceType::StartTxn, [=] { return i; }};
+        TraceSpan const execution{TraceType::StartExecution, [=] {
+                                      return i;
+                                  }};
+    };
+    {
+        TraceSpan const block{TraceType::StartBlock, [] { return 42ul; }};
+        std::thread{run_txn, 0}.join();
+        std::thread{run_txn, 1}.join();
+    }
+
+    auto const spans = collect_spans();
+    ASSERT_EQ(spans.size(), 5);
+    EXPECT_EQ(spans[0].type, TraceType::StartBlock);
+    EXPECT_EQ(spans[0].value, 42);
+    std::set<uint32_t> threads;
+    for (auto const &span : spans) {
+        EXPECT_LE(span.start, span.end);
+        EXPECT_LE(spans[0].start, span.start);
+        EXPECT_GE(spans[0].end, span.end);
+        threads.insert(span.thread);
+    }
+    EXPECT_EQ(threads.size(), 3);
+    EXPECT_EQ(spans[1].type, TraceType::StartTxn);
+    EXPECT_EQ(spans[2].type, TraceType::StartExecution);
+    EXPECT_EQ(spans[1].thread, spans[2].thread);
+
+    std::ostringstream os;
+    write_chrome_trace(os, spans);
+    auto const trace = os.str();
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ns\""));
+    EXPECT_NE(trace.find("\"name\":\"block\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"execution\""), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"txn\":1}"), std::string::npos);
+    EXPECT_TRUE(trace.ends_with("]}\n"));
+}
+
+TEST(SpanTrace, ring_keeps_latest_spans)
+{
+    enable_span_tracing(4);
+    std::thread{[] {
+        for (uint64_t i = 0; i < 10; ++i) {
+            TraceSpan const span{TraceType::StartStall, [=] { return i; }};
+        }
+    }}.join();
+
+    std::vector<uint64_t> stalls;
+    for (auto const &span : collect_spans()) {
+        if (span.type == TraceType::StartStall) {
+            stalls.push_back(span.value);
+        }
+    }
+    EXPECT_EQ(stalls, (std::vector<uint64_t>{6, 7, 8, 9}));
+}
@@ -70,28 +70,34 @@ Result<void> MonadChain::validate_output_header(
 }
 
 Result<void> MonadChain::validate_transaction(
-    uint64_t const block_number, uint64_t const timestamp,
+    uint64_t /*block_number*/, uint64_t const timestamp,
     Transaction const &tx, Address const &sender, State &state,
     uint256_t const &base_fee_per_gas,
     std::vector<std::optional<Address>> const &authorities) const
 {
-
-    monad_revision const monad_rev = get_monad_revision(timestamp);
-    evmc_revision const rev = get_revision(block_number, timestamp);
     return validate_monad_transaction(
-        monad_rev, rev, tx, sender, state, base_fee_per_gas, authorities);
+        get_monad_revision(timestamp),
+        tx,
+        sender,
+        state,
+        base_fee_per_gas,
+        authorities);
 }
 
 bool MonadChain::revert_transaction(
-    uint64_t const block_number, uint64_t const timestamp,
+    uint64_t /*block_number*/, uint64_t const timestamp,
     Address const &sender, Transaction const &tx,
     uint256_t const &base_fee_per_gas, uint64_t const i, State &state,
     MonadChainContext const &ctx) const
 {
-    monad_revision const monad_rev = get_monad_revision(timestamp);
-    evmc_revision const rev = get_revision(block_number, timestamp);
     return revert_monad_transaction(
-        monad_rev, rev, sender, tx, base_fee_per_gas, i, state, ctx);
+        get_monad_revision(timestamp),
+        sender,
+        tx,
+        base_fee_per_gas,
+        i,
+        state,
+        ctx);
 }
 
 MONAD_NAMESPACE_END
@@ -36,6 +36,7 @@ inline constexpr size_t MAX_INITCODE_SIZE_MONAD_FOUR =
 struct BlockHeader;
 struct Transaction;
 class AccountState;
+struct ReserveBalanceClass;
 
 struct MonadChainContext
 {
@@ -47,6 +48,8 @@ struct MonadChainContext
         &senders_and_authorities;
     std::vector<Address> const &senders;
     std::vector<std::vector<std::optional<Address>>> const &authorities;
+    // indexed by transaction, see classify_reserve_balance
+    std::vector<ReserveBalanceClass> const *reserve_balance_classes{nullptr};
 };
 
 struct MonadChain : Chain
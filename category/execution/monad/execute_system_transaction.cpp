@@ -16,11 +16,13 @@
 #include <boost/fiber/future/promise.hpp>
 #include <boost/outcome/try.hpp>
 #include <category/core/assert.h>
+#include <category/core/mem/arena.hpp>
 #include <category/execution/ethereum/chain/chain.hpp>
 #include <category/execution/ethereum/core/contract/abi_signatures.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/merge_conflict.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/event_trace.hpp>
@@ -33,6 +35,7 @@
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
 
+#include <chrono>
 #include <optional>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
@@ -76,8 +79,11 @@ ExecuteSystemTransaction<traits>::ExecuteSystemTransaction(
 }
 
 template <Traits traits>
-Result<Receipt> ExecuteSystemTransaction<traits>::operator()()
+Result<Receipt>
+ExecuteSystemTransaction<traits>::execute_and_merge(TxnPerf &perf)
 {
+    using clock = std::chrono::steady_clock;
+
     TRACE_TXN_EVENT(StartTxn);
 
     BOOST_OUTCOME_TRY(static_validate_system_transaction<traits>(tx_, sender_));
@@ -100,14 +106,19 @@ Result<Receipt> ExecuteSystemTransaction<traits>::operator()()
 
         call_tracer_.reset();
 
+        auto const exec_begin = clock::now();
         auto result = execute(state);
+        auto const stall_begin = clock::now();
+        perf.exec_time = stall_begin - exec_begin;
 
         {
             TRACE_TXN_EVENT(StartStall);
             prev_.get_future().wait();
         }
+        perf.stall_time = clock::now() - stall_begin;
 
-        if (block_state_.can_merge(state)) {
+        MergeConflict conflict;
+        if (block_state_.can_merge(state, &conflict)) {
             if (result.has_error()) {
                 return std::move(result.error());
             }
@@ -115,11 +126,14 @@ Result<Receipt> ExecuteSystemTransaction<traits>::operator()()
             block_state_.merge(state);
             return receipt;
         }
+        block_metrics_.add_conflict(i_, conflict);
+        perf.conflict = conflict;
     }
     block_metrics_.inc_retries();
     {
         TRACE_TXN_EVENT(StartRetry);
 
+        auto const retry_begin = clock::now();
         State state{block_state_, Incarnation{header_.number, i_ + 1}};
 
         call_tracer_.reset();
@@ -128,14 +142,33 @@ Result<Receipt> ExecuteSystemTransaction<traits>::operator()()
 
         MONAD_ASSERT(block_state_.can_merge(state));
         if (result.has_error()) {
+            perf.retry_time = clock::now() - retry_begin;
             return std::move(result.error());
         }
         auto const receipt = execute_final(state);
         block_state_.merge(state);
+        perf.retry_time = clock::now() - retry_begin;
         return receipt;
     }
 }
 
+template <Traits traits>
+Result<Receipt> ExecuteSystemTransaction<traits>::operator()()
+{
+    TxnPerf perf{};
+    Result<Receipt> result = [this, &perf] {
+        // Every State of this transaction, including the one of a retry, is
+        // destroyed before the scope resets the arena
+        ArenaScope const arena_scope;
+        return execute_and_merge(perf);
+    }();
+    if (result.has_value()) {
+        perf.gas_used = result.value().gas_used;
+    }
+    block_metrics_.set_txn_perf(i_, perf);
+    return result;
+}
+
 template <Traits traits>
 evmc_message ExecuteSystemTransaction<traits>::to_message() const
 {
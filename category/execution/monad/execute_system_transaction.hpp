@@ -37,6 +37,8 @@ class ExecuteSystemTransaction
     boost::fibers::promise<void> &prev_;
     CallTracerBase &call_tracer_;
 
+    Result<Receipt> execute_and_merge(TxnPerf &);
+
 public:
     ExecuteSystemTransaction(
         Chain const &, uint64_t i, Transaction const &, Address const &,
@@ -22,6 +22,9 @@
 #include <category/execution/monad/reserve_balance.h>
 #include <category/execution/monad/reserve_balance.hpp>
 #include <category/vm/evm/delegation.hpp>
+#include <category/vm/evm/explicit_traits.hpp>
+#include <category/vm/evm/switch_traits.hpp>
+#include <category/vm/evm/traits.hpp>
 #include <category/vm/interpreter/intercode.hpp>
 
 #include <ankerl/unordered_dense.h>
@@ -30,6 +33,7 @@
 #include <cstddef>
 #include <optional>
 #include <ranges>
+#include <vector>
 
 unsigned monad_default_max_reserve_balance_mon(enum monad_revision)
 {
@@ -38,8 +42,8 @@ unsigned monad_default_max_reserve_balance_mon(enum monad_revision)
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
+template <Traits traits>
 bool dipped_into_reserve(
-    monad_revision const monad_rev, evmc_revision const rev,
     Address const &sender, Transaction const &tx,
     uint256_t const &base_fee_per_gas, uint64_t const i,
     MonadChainContext const &ctx, State &state)
@@ -48,9 +52,29 @@ bool dipped_into_reserve(
     MONAD_ASSERT(i < ctx.authorities.size());
     MONAD_ASSERT(ctx.senders.size() == ctx.authorities.size());
 
-    uint256_t const gas_fees =
-        uint256_t{tx.gas_limit} * gas_price(rev, tx, base_fee_per_gas);
     auto const &orig = state.original();
+    if (ctx.reserve_balance_classes) {
+        MONAD_ASSERT(i < ctx.reserve_balance_classes->size());
+        auto const &[sender_may_dip, plain_transfer] =
+            (*ctx.reserve_balance_classes)[i];
+        // an account that was never read ran no code either
+        auto const has_code = [&orig](Address const &addr) {
+            auto const it = orig.find(addr);
+            if (it == orig.end()) {
+                return false;
+            }
+            auto const &account = it->second.account_;
+            return account.has_value() && account->code_hash != NULL_HASH;
+        };
+        // only the sender can lose balance and it is allowed to
+        if (sender_may_dip && plain_transfer && state.current().size() <= 2 &&
+            !has_code(sender) && !has_code(tx.to.value())) {
+            return false;
+        }
+    }
+
+    uint256_t const gas_fees =
+        uint256_t{tx.gas_limit} * gas_price<traits>(tx, base_fee_per_gas);
     for (auto const &[addr, stack] : state.current()) {
         MONAD_ASSERT(orig.contains(addr));
         std::optional<Account> const &orig_account = orig.at(addr).account_;
@@ -73,8 +97,8 @@ bool dipped_into_reserve(
             [&] -> std::optional<uint256_t> {
             uint256_t const orig_balance =
                 orig_account.has_value() ? orig_account.value().balance : 0;
-            uint256_t const reserve =
-                std::min(get_max_reserve(monad_rev, addr), orig_balance);
+            uint256_t const reserve = std::min(
+                get_max_reserve(traits::monad_rev(), addr), orig_balance);
             if (addr == sender) {
                 if (gas_fees > reserve) { // must be dipping
                     return std::nullopt;
@@ -112,24 +136,75 @@ MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
 
+std::vector<ReserveBalanceClass> classify_reserve_balance(
+    std::vector<Transaction> const &transactions, MonadChainContext const &ctx)
+{
+    MONAD_ASSERT(transactions.size() == ctx.senders.size());
+    MONAD_ASSERT(transactions.size() == ctx.authorities.size());
+
+    auto const in_pending_block = [&ctx](Address const &sender) {
+        for (auto const *const senders_and_authorities :
+             {ctx.grandparent_senders_and_authorities,
+              ctx.parent_senders_and_authorities}) {
+            if (senders_and_authorities &&
+                senders_and_authorities->contains(sender)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // senders and authorities of the transactions classified so far
+    ankerl::unordered_dense::set<Address> seen;
+    std::vector<ReserveBalanceClass> classes;
+    classes.reserve(transactions.size());
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        Transaction const &tx = transactions[i];
+        Address const &sender = ctx.senders[i];
+        auto const &authorities = ctx.authorities[i];
+        classes.push_back(ReserveBalanceClass{
+            .sender_may_dip = !in_pending_block(sender) &&
+                              !seen.contains(sender) &&
+                              !std::ranges::contains(authorities, sender),
+            .plain_transfer = tx.to.has_value() && tx.data.empty() &&
+                              tx.authorization_list.empty()});
+        seen.insert(sender);
+        for (auto const &authority : authorities) {
+            if (authority.has_value()) {
+                seen.insert(authority.value());
+            }
+        }
+    }
+    return classes;
+}
+
+template <Traits traits>
 bool revert_monad_transaction(
-    monad_revision const monad_rev, evmc_revision const rev,
     Address const &sender, Transaction const &tx,
     uint256_t const &base_fee_per_gas, uint64_t const i, State &state,
     MonadChainContext const &ctx)
 {
-    if (MONAD_LIKELY(monad_rev >= MONAD_FOUR)) {
-        return dipped_into_reserve(
-            monad_rev, rev, sender, tx, base_fee_per_gas, i, ctx, state);
-    }
-    else if (monad_rev >= MONAD_ZERO) {
-        return false;
+    if constexpr (traits::monad_rev() >= MONAD_FOUR) {
+        return dipped_into_reserve<traits>(
+            sender, tx, base_fee_per_gas, i, ctx, state);
     }
     else {
-        MONAD_ABORT("invalid revision for revert");
+        return false;
     }
 }
 
+EXPLICIT_MONAD_TRAITS(revert_monad_transaction);
+
+bool revert_monad_transaction(
+    monad_revision const rev, Address const &sender, Transaction const &tx,
+    uint256_t const &base_fee_per_gas, uint64_t const i, State &state,
+    MonadChainContext const &ctx)
+{
+    SWITCH_MONAD_TRAITS(
+        revert_monad_transaction, sender, tx, base_fee_per_gas, i, state, ctx);
+    MONAD_ABORT("invalid revision for revert");
+}
+
 bool can_sender_dip_into_reserve(
     Address const &sender, uint64_t const i, bytes32_t const &orig_code_hash,
     MonadChainContext const &ctx)
@@ -138,6 +213,11 @@ bool can_sender_dip_into_reserve(
         return false;
     }
 
+    if (ctx.reserve_balance_classes) {
+        MONAD_ASSERT(i < ctx.reserve_balance_classes->size());
+        return (*ctx.reserve_balance_classes)[i].sender_may_dip;
+    }
+
     // check pending blocks
     for (ankerl::unordered_dense::segmented_set<Address> const
              *const senders_and_authorities :
@@ -20,10 +20,10 @@
 #include <category/core/int.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/vm/evm/monad/revision.h>
-
-#include <evmc/evmc.h>
+#include <category/vm/evm/traits.hpp>
 
 #include <cstdint>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -31,8 +31,32 @@ struct MonadChainContext;
 class State;
 struct Transaction;
 
+// What the reserve balance check of a transaction can know before the block
+// executes. Computed for all transactions of a block in one pass.
+struct ReserveBalanceClass
+{
+    // The sender sends no earlier transaction of the block or its pending
+    // ancestors and is no authority of this or an earlier transaction. It may
+    // then dip into its reserve, unless its account is delegated.
+    bool sender_may_dip;
+
+    // A value transfer without call data or authorizations. If it goes to an
+    // account without code and the sender may dip, no account can end up
+    // below its reserve and the check after execution is skipped.
+    bool plain_transfer;
+};
+
+std::vector<ReserveBalanceClass> classify_reserve_balance(
+    std::vector<Transaction> const &, MonadChainContext const &);
+
+template <Traits traits>
+bool revert_monad_transaction(
+    Address const &sender, Transaction const &,
+    uint256_t const &base_fee_per_gas, uint64_t i, State &,
+    MonadChainContext const &);
+
 bool revert_monad_transaction(
-    monad_revision, evmc_revision, Address const &sender, Transaction const &,
+    monad_revision, Address const &sender, Transaction const &,
     uint256_t const &base_fee_per_gas, uint64_t i, State &,
     MonadChainContext const &);
 
@@ -0,0 +1,273 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
+#include <category/core/mem/arena.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/chain/chain.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/rlp/transaction_rlp.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/evmc_host.hpp>
+#include <category/execution/ethereum/execute_transaction.hpp>
+#include <category/execution/ethereum/signer_cache.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
+#include <category/execution/ethereum/tx_context.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/execution/ethereum/validate_transaction.hpp>
+#include <category/execution/monad/speculative_execution.hpp>
+#include <category/execution/monad/system_sender.hpp>
+#include <category/vm/evm/explicit_traits.hpp>
+#include <category/vm/evm/traits.hpp>
+
+#include <boost/fiber/operations.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+// The pool runs lower values first, and block transactions run at the value
+// of their index. Speculation, past any index, only gets a thread that no
+// block transaction is waiting for; once running it is not preempted, which
+// is why stopping it does not wait for it.
+constexpr uint64_t SPECULATION_PRIORITY = uint64_t{1} << 32;
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+template <Traits traits>
+struct SpeculativeExecution<traits>::Shared
+{
+    // Tasks still running once stopped outlive the proposal they speculate
+    BlockHeader header;
+    std::vector<Transaction> transactions;
+    BlockState block_state;
+    BlockHashBufferFinalized block_hash_buffer;
+    std::atomic<bool> stopped{false};
+    // The tasks using the signer cache, which does not outlive the runloop
+    std::atomic<size_t> signer_cache_users{0};
+
+    Shared(
+        BlockHeader const &header, std::vector<Transaction> const &transactions,
+        Db &db, vm::VM &vm, BlockHashBuffer const &buffer)
+        : header{header}
+        , transactions{transactions}
+        , block_state{db, vm}
+        , block_hash_buffer{buffer}
+    {
+        block_state.enable_detach();
+    }
+
+    bool enter_signer_cache()
+    {
+        signer_cache_users.fetch_add(1, std::memory_order_seq_cst);
+        if (stopped.load(std::memory_order_seq_cst)) {
+            signer_cache_users.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        return true;
+    }
+
+    void leave_signer_cache()
+    {
+        signer_cache_users.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Waits for the database reads and signer cache uses in flight, not for
+    // the transactions
+    void stop()
+    {
+        stopped.store(true, std::memory_order_seq_cst);
+        block_state.detach();
+        while (signer_cache_users.load(std::memory_order_acquire) != 0) {
+            boost::this_fiber::yield();
+        }
+    }
+
+    SignerCache::Entry
+    recover_signers(Transaction const &tx, SignerCache *const cache)
+    {
+        SignerCache::Entry entry;
+        bytes32_t tx_hash{};
+        if (cache != nullptr) {
+            // Keyed like the signer recovery of the block, which then finds
+            // the signers of the speculated transactions here
+            tx_hash = to_bytes(keccak256(rlp::encode_transaction(tx)));
+            if (enter_signer_cache()) {
+                bool const found = cache->find(tx_hash, entry);
+                leave_signer_cache();
+                if (found) {
+                    return entry;
+                }
+            }
+        }
+        entry.sender = recover_sender(tx);
+        entry.authorities.reserve(tx.authorization_list.size());
+        for (auto const &authorization : tx.authorization_list) {
+            entry.authorities.push_back(recover_authority(authorization));
+        }
+        if (cache != nullptr && enter_signer_cache()) {
+            cache->insert(tx_hash, entry);
+            leave_signer_cache();
+        }
+        return entry;
+    }
+};
+
+template <Traits traits>
+SpeculativeExecution<traits>::SpeculativeExecution(
+    Chain const &chain, BlockHeader const &header,
+    std::vector<Transaction> const &transactions,
+    BlockHashBuffer const &block_hash_buffer, Db &db, vm::VM &vm,
+    fiber::PriorityPool &priority_pool, SignerCache *const signer_cache)
+    : shared_{std::make_shared<Shared>(
+          header, transactions, db, vm, block_hash_buffer)}
+{
+    MONAD_ASSERT(block_hash_buffer.n() + 1 == header.number);
+    // The hash of the executing block is not known until it commits. A
+    // speculated BLOCKHASH of it reads a placeholder, which at worst changes
+    // what the speculation reads.
+    shared_->block_hash_buffer.set(block_hash_buffer.n(), bytes32_t{0x01});
+
+    for (uint64_t i = 0; i < transactions.size(); ++i) {
+        priority_pool.submit(
+            SPECULATION_PRIORITY + i,
+            [i, &chain, signer_cache, shared = shared_] {
+                if (shared->stopped.load(std::memory_order_acquire)) {
+                    return;
+                }
+                BlockHeader const &header = shared->header;
+                Transaction const &tx = shared->transactions[i];
+                auto const [sender, authorities] =
+                    shared->recover_signers(tx, signer_cache);
+                // System transactions have their own executor and only
+                // touch the staking state, which the block reads anyway
+                bool const speculate =
+                    sender.has_value() &&
+                    !(traits::monad_rev() >= MONAD_FOUR &&
+                      sender.value() == SYSTEM_SENDER) &&
+                    !static_validate_transaction<traits>(
+                         tx,
+                         header.base_fee_per_gas,
+                         header.excess_blob_gas,
+                         chain.get_chain_id())
+                         .has_error();
+                if (speculate) {
+                    try {
+                        ArenaScope const arena_scope;
+                        State state{
+                            shared->block_state,
+                            Incarnation{header.number, i}};
+                        if (!chain
+                                 .validate_transaction(
+                                     header.number,
+                                     header.timestamp,
+                                     tx,
+                                     sender.value(),
+                                     state,
+                                     header.base_fee_per_gas.value_or(0),
+                                     authorities)
+                                 .has_error()) {
+                            auto const tx_context = get_tx_context<traits>(
+                                tx,
+                                sender.value(),
+                                header,
+                                chain.get_chain_id());
+                            NoopCallTracer call_tracer;
+                            EvmcHost<traits> host{
+                                chain,
+                                call_tracer,
+                                tx_context,
+                                shared->block_hash_buffer,
+                                state};
+                            (void)ExecuteTransactionNoValidation<traits>{
+                                chain,
+                                tx,
+                                sender.value(),
+                                authorities,
+                                header,
+                                i}(state, host);
+                        }
+                    }
+                    catch (...) {
+                        // A failed speculation only loses its reads
+                    }
+                }
+            });
+    }
+}
+
+template <Traits traits>
+SpeculativeExecution<traits>::~SpeculativeExecution()
+{
+    shared_->stop();
+}
+
+template <Traits traits>
+std::unique_ptr<StateDeltas>
+SpeculativeExecution<traits>::reads_after(StateDeltas const &executed)
+{
+    shared_->stop();
+
+    // The speculation read the parent state of the executing block, which
+    // the block only changed where it has deltas
+    auto const reads = shared_->block_state.read_set();
+    auto after = std::make_unique<StateDeltas>();
+    for (auto const &[address, read] : *reads) {
+        StateDeltas::const_accessor it;
+        if (!executed.find(it, address)) {
+            after->emplace(address, read);
+            continue;
+        }
+        auto const &[original, current] = it->second.account;
+        bool const same_incarnation =
+            original.has_value()
+                ? current.has_value() &&
+                      current->incarnation == original->incarnation
+                : !current.has_value();
+        if (!same_incarnation) {
+            // Created or destroyed, the slots read before are stale
+            continue;
+        }
+        StateDelta read_after{.account = {current, current}, .storage = {}};
+        for (auto const &[key, value] : read.storage) {
+            auto const slot = it->second.storage.find(key);
+            bytes32_t const &after_value = slot != it->second.storage.end()
+                                               ? slot->second.second
+                                               : value.first;
+            read_after.storage.try_emplace(key, after_value, after_value);
+        }
+        after->emplace(address, std::move(read_after));
+    }
+    return after;
+}
+
+EXPLICIT_MONAD_TRAITS_CLASS(SpeculativeExecution);
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,91 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/vm/evm/traits.hpp>
+
+#include <memory>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockHashBuffer;
+class SignerCache;
+struct BlockHeader;
+struct Chain;
+struct Db;
+struct Transaction;
+
+namespace fiber
+{
+    class PriorityPool;
+}
+
+namespace vm
+{
+    class VM;
+}
+
+/**
+ * Executes the transactions of the next proposal, already queued behind the
+ * block being executed, on the priority pool while that block runs. Each
+ * transaction runs on its own against the parent state of the executing
+ * block and is discarded; what is kept is what it read: the database reads,
+ * in a block state that is never merged into, and the code it ran, analysed
+ * into the VM's varcode cache. Its signers are recovered into the signer
+ * cache along the way. The tasks are submitted after every block
+ * transaction in priority order, so they only use the threads the executing
+ * block leaves idle.
+ *
+ * `reads_after` stops the speculation and brings its reads forward to the
+ * state after the executing block, so that the next block can start from
+ * them with `BlockState(Db &, vm::VM &, StateDeltas const &)`; whatever the
+ * next block actually executes, it only ever sees database values. Stopping
+ * does not wait for the speculated transactions that are still running: it
+ * detaches their block state from the database and they finish on their
+ * own, their later reads finding nothing. Monad system transactions are not
+ * speculated. The chain must outlive the tasks of the pool and the signer
+ * cache the speculation object; the destructor stops it.
+ */
+template <Traits traits>
+class SpeculativeExecution
+{
+    struct Shared;
+
+    std::shared_ptr<Shared> shared_;
+
+public:
+    /// `block_hash_buffer` is the chain of the executing block, which is the
+    /// parent of `header`
+    SpeculativeExecution(
+        Chain const &, BlockHeader const &,
+        std::vector<Transaction> const &, BlockHashBuffer const &, Db &,
+        vm::VM &, fiber::PriorityPool &, SignerCache *);
+
+    SpeculativeExecution(SpeculativeExecution const &) = delete;
+    SpeculativeExecution &operator=(SpeculativeExecution const &) = delete;
+
+    ~SpeculativeExecution();
+
+    /// Stops the speculation and returns its reads as of after `executed`,
+    /// the state deltas of the executing block: accounts the block left at
+    /// the same incarnation take its values, the others are dropped
+    std::unique_ptr<StateDeltas> reads_after(StateDeltas const &executed);
+};
+
+MONAD_NAMESPACE_END
@@ -21,6 +21,7 @@
 #include <category/execution/ethereum/types/incarnation.hpp>
 #include <category/execution/monad/staking/read_valset.hpp>
 #include <category/execution/monad/staking/staking_contract.hpp>
+#include <category/execution/monad/staking/staking_state_cache.hpp>
 #include <category/execution/monad/staking/util/constants.hpp>
 #include <category/mpt/db.hpp>
 #include <category/vm/vm.hpp>
@@ -29,6 +30,12 @@ MONAD_STAKING_NAMESPACE_BEGIN
 
 std::optional<std::vector<Validator>>
 read_valset(mpt::Db &db, size_t const block_num, uint64_t const requested_epoch)
+{
+    return staking_state_cache().read_valset(db, block_num, requested_epoch);
+}
+
+std::optional<std::vector<Validator>> decode_valset(
+    mpt::Db &db, size_t const block_num, uint64_t const requested_epoch)
 {
     vm::VM vm;
     TrieDb tdb{db};
@@ -44,4 +44,8 @@ struct Validator
 std::optional<std::vector<Validator>>
 read_valset(mpt::Db &db, size_t block_num, uint64_t requested_epoch);
 
+// Same as read_valset, but always decodes the set from the trie
+std::optional<std::vector<Validator>>
+decode_valset(mpt::Db &db, size_t block_num, uint64_t requested_epoch);
+
 MONAD_STAKING_NAMESPACE_END
@@ -18,6 +18,7 @@
 #include <category/core/likely.h>
 #include <category/core/monad_exception.hpp>
 #include <category/core/unaligned.hpp>
+#include <category/core/util/log_rate_limit.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/contract/abi_decode.hpp>
 #include <category/execution/ethereum/core/contract/abi_encode.hpp>
@@ -26,6 +27,7 @@
 #include <category/execution/ethereum/core/contract/events.hpp>
 #include <category/execution/ethereum/core/contract/storage_array.hpp>
 #include <category/execution/ethereum/core/contract/storage_variable.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/evmc_host.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/monad/staking/staking_contract.hpp>
@@ -39,8 +41,11 @@
 #include <quill/Quill.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <memory>
+#include <span>
+#include <vector>
 
 MONAD_STAKING_ANONYMOUS_NAMESPACE_BEGIN
 
@@ -330,6 +335,12 @@ Result<uint256_t> calculate_rewards(
     return checked_mul_div(delta, stake, UNIT_BIAS);
 }
 
+template <typename Slots>
+void append_keys(std::vector<bytes32_t> &keys, Slots const &slot_keys)
+{
+    keys.insert(keys.end(), slot_keys.begin(), slot_keys.end());
+}
+
 Result<void> function_not_payable(evmc_uint256be const &value)
 {
     bool const all_zero = std::all_of(
@@ -343,6 +354,52 @@ Result<void> function_not_payable(evmc_uint256be const &value)
     return outcome::success();
 }
 
+constexpr size_t ADD_VALIDATOR_MESSAGE_SIZE =
+    33 /* compressed secp pubkey */ + 48 /* compressed bls pubkey */ +
+    sizeof(Address) /* auth address */ + sizeof(u256_be) /* signed stake */ +
+    sizeof(u256_be) /* commission rate */;
+
+struct AddValidatorInput
+{
+    byte_string_fixed<ADD_VALIDATOR_MESSAGE_SIZE> message;
+    byte_string_fixed<64> secp_signature;
+    byte_string_fixed<96> bls_signature;
+};
+
+Result<AddValidatorInput> decode_add_validator_input(byte_string_view input)
+{
+    // decode the head
+    BOOST_OUTCOME_TRY(
+        abi_decode_fixed<u256_be>(input)); // skip message tail offset
+    BOOST_OUTCOME_TRY(
+        abi_decode_fixed<u256_be>(input)); // skip secp sig tail offset
+    BOOST_OUTCOME_TRY(
+        abi_decode_fixed<u256_be>(input)); // sip bls sig tail offset
+
+    // decode bytes with known lengths from the tail
+    BOOST_OUTCOME_TRY(
+        auto const message,
+        abi_decode_bytes_tail<ADD_VALIDATOR_MESSAGE_SIZE>(input));
+    BOOST_OUTCOME_TRY(
+        auto const secp_signature, abi_decode_bytes_tail<64>(input));
+    BOOST_OUTCOME_TRY(
+        auto const bls_signature, abi_decode_bytes_tail<96>(input));
+
+    if (MONAD_UNLIKELY(!input.empty())) {
+        return StakingError::InvalidInput;
+    }
+    return AddValidatorInput{
+        .message = message,
+        .secp_signature = secp_signature,
+        .bls_signature = bls_signature};
+}
+
+byte_string_fixed<48> bls_pubkey_of(
+    byte_string_fixed<ADD_VALIDATOR_MESSAGE_SIZE> const &message)
+{
+    return unaligned_load<byte_string_fixed<48>>(message.data() + 33);
+}
+
 MONAD_STAKING_ANONYMOUS_NAMESPACE_END
 
 MONAD_STAKING_NAMESPACE_BEGIN
@@ -533,7 +590,9 @@ u256_be StakingContract::decrement_accumulator_refcount(
     auto const value = acc.value;
     auto const refcount = acc.refcount.native();
     if (MONAD_UNLIKELY(refcount == 0)) {
-        LOG_INFO(
+        LOG_RATE_LIMITED(
+            LOG_INFO,
+            std::chrono::seconds{1},
             "StakingContract: refcount for epoch {} and val_id {} is 0",
             epoch.native(),
             val_id.native());
@@ -568,6 +627,23 @@ void StakingContract::remove_from_valset(u64_be const val_id)
     vars.val_bitset_bucket(val_id).store(set);
 }
 
+template <typename KeysOf>
+void StakingContract::prefetch_valset(
+    StorageArray<u64_be> const &valset, KeysOf const &keys_of)
+{
+    uint64_t const length = valset.length();
+    std::vector<bytes32_t> keys;
+    for (uint64_t i = 0; i < length; ++i) {
+        append_keys(keys, valset.get(i).slot_keys());
+    }
+    state_.prefetch_storage(STAKING_CA, keys);
+    keys.clear();
+    for (uint64_t i = 0; i < length; ++i) {
+        keys_of(valset.get(i).load(), keys);
+    }
+    state_.prefetch_storage(STAKING_CA, keys);
+}
+
 bool can_promote_delta(Delegator const &del, u64_be const &epoch)
 {
     return del.get_delta_epoch().native() == 0 &&
@@ -1036,30 +1112,9 @@ Result<byte_string> StakingContract::precompile_add_validator(
     byte_string_view input, evmc_address const &,
     evmc_uint256be const &msg_value)
 {
-    constexpr size_t MESSAGE_SIZE = 33 /* compressed secp pubkey */ +
-                                    48 /* compressed bls pubkey */ +
-                                    sizeof(Address) /* auth address */ +
-                                    sizeof(u256_be) /* signed stake */ +
-                                    sizeof(u256_be) /* commission rate */;
-    // decode the head
-    BOOST_OUTCOME_TRY(
-        abi_decode_fixed<u256_be>(input)); // skip message tail offset
-    BOOST_OUTCOME_TRY(
-        abi_decode_fixed<u256_be>(input)); // skip secp sig tail offset
-    BOOST_OUTCOME_TRY(
-        abi_decode_fixed<u256_be>(input)); // sip bls sig tail offset
-
-    // decode bytes with known lengths from the tail
-    BOOST_OUTCOME_TRY(
-        auto const message, abi_decode_bytes_tail<MESSAGE_SIZE>(input));
-    BOOST_OUTCOME_TRY(
-        auto const secp_signature_compressed, abi_decode_bytes_tail<64>(input));
-    BOOST_OUTCOME_TRY(
-        auto const bls_signature_compressed, abi_decode_bytes_tail<96>(input));
-
-    if (MONAD_UNLIKELY(!input.empty())) {
-        return StakingError::InvalidInput;
-    }
+    BOOST_OUTCOME_TRY(auto const decoded, decode_add_validator_input(input));
+    auto const &[message, secp_signature_compressed, bls_signature_compressed] =
+        decoded;
 
     // extract individual inputs from the message
     byte_string_view reader = to_byte_string_view(message);
@@ -1110,6 +1165,10 @@ Result<byte_string> StakingContract::precompile_add_validator(
         return StakingError::InvalidBlsSignature;
     }
     if (MONAD_UNLIKELY(
+            !bls_verified_cache().contains(bls_verified_key(
+                bls_pubkey_compressed,
+                bls_signature_compressed,
+                to_byte_string_view(message))) &&
             !bls_sig.verify(bls_pubkey, to_byte_string_view(message)))) {
         return StakingError::BlsSignatureVerificationFailed;
     }
@@ -1531,6 +1590,22 @@ Result<void> StakingContract::syscall_on_epoch_change(byte_string_view input)
     }
 
     auto const valset = vars.valset_snapshot;
+    prefetch_valset(
+        valset, [&](u64_be const val_id, std::vector<bytes32_t> &keys) {
+            append_keys(
+                keys,
+                vars.val_execution(val_id)
+                    .accumulated_reward_per_token()
+                    .slot_keys());
+            append_keys(
+                keys,
+                vars.accumulated_reward_per_token(next_epoch, val_id)
+                    .slot_keys());
+            append_keys(
+                keys,
+                vars.accumulated_reward_per_token(next_next_epoch, val_id)
+                    .slot_keys());
+        });
     uint64_t const num_active_vals = valset.length();
     for (uint64_t i = 0; i < num_active_vals; ++i) {
         auto const val_id = valset.get(i).load();
@@ -1635,6 +1710,13 @@ Result<void> StakingContract::syscall_snapshot(byte_string_view const input)
 
     // 2. Copy the consensus view to the snapshot view
     auto valset_consensus = vars.valset_consensus;
+    prefetch_valset(
+        valset_consensus,
+        [&](u64_be const val_id, std::vector<bytes32_t> &keys) {
+            auto consensus_view = vars.consensus_view(val_id);
+            append_keys(keys, consensus_view.stake().slot_keys());
+            append_keys(keys, consensus_view.commission().slot_keys());
+        });
     uint64_t const consensus_valset_length = vars.valset_consensus.length();
     for (uint64_t i = 0; i < consensus_valset_length; ++i) {
         u64_be const val_id = valset_consensus.get(i).load();
@@ -1661,6 +1743,13 @@ Result<void> StakingContract::syscall_snapshot(byte_string_view const input)
     std::vector<Candidate> candidates;
     std::vector<uint64_t> removals;
 
+    prefetch_valset(
+        vars.valset_execution,
+        [&](u64_be const val_id, std::vector<bytes32_t> &keys) {
+            auto val_execution = vars.val_execution(val_id);
+            append_keys(keys, val_execution.address_flags().slot_keys());
+            append_keys(keys, val_execution.stake().slot_keys());
+        });
     uint64_t const execution_valset_length = vars.valset_execution.length();
     for (uint64_t i = 0; i < execution_valset_length; ++i) {
         auto const val_id = vars.valset_execution.get(i).load();
@@ -1944,4 +2033,65 @@ std::tuple<bool, Ptr, std::vector<Ptr>> StakingContract::linked_list_traverse(
     return {done, ptr, std::move(results)};
 }
 
+void StakingContract::prevalidate_bls_signatures(
+    std::span<Transaction const> const transactions)
+{
+    struct Candidate
+    {
+        BlsPubkey pubkey;
+        BlsSignature signature;
+        byte_string_fixed<ADD_VALIDATOR_MESSAGE_SIZE> message;
+        bytes32_t key;
+    };
+
+    auto &cache = bls_verified_cache();
+    std::vector<Candidate> candidates;
+    for (auto const &tx : transactions) {
+        if (tx.to != STAKING_CA) {
+            continue;
+        }
+        byte_string_view input{tx.data};
+        if (precompile_dispatch(input).first !=
+            &StakingContract::precompile_add_validator) {
+            continue;
+        }
+        // malformed calls fail the same way when they execute
+        auto const decoded = decode_add_validator_input(input);
+        if (decoded.has_error()) {
+            continue;
+        }
+        auto const &[message, _, bls_signature] = decoded.value();
+        auto const bls_pubkey = bls_pubkey_of(message);
+        Candidate candidate{
+            .pubkey = BlsPubkey{bls_pubkey},
+            .signature = BlsSignature{bls_signature},
+            .message = message,
+            .key = bls_verified_key(
+                bls_pubkey, bls_signature, to_byte_string_view(message))};
+        if (!candidate.pubkey.is_valid() || !candidate.signature.is_valid() ||
+            cache.contains(candidate.key)) {
+            continue;
+        }
+        candidates.push_back(candidate);
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    std::vector<BlsVerifyInput> inputs;
+    inputs.reserve(candidates.size());
+    for (auto const &candidate : candidates) {
+        inputs.push_back(BlsVerifyInput{
+            .pubkey = &candidate.pubkey,
+            .signature = &candidate.signature,
+            .message = to_byte_string_view(candidate.message)});
+    }
+    auto const verified = bls_verify_batch(inputs);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (verified[i]) {
+            cache.insert(candidates[i].key);
+        }
+    }
+}
+
 MONAD_STAKING_NAMESPACE_END
@@ -22,6 +22,7 @@
 #include <category/execution/ethereum/core/contract/big_endian.hpp>
 #include <category/execution/ethereum/core/contract/storage_array.hpp>
 #include <category/execution/ethereum/core/contract/storage_variable.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/monad/staking/config.hpp>
 #include <category/execution/monad/staking/util/consensus_view.hpp>
 #include <category/execution/monad/staking/util/constants.hpp>
@@ -33,6 +34,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string_view>
 
 MONAD_NAMESPACE_BEGIN
@@ -509,6 +511,11 @@ private:
     //  1. compound
     Result<void> delegate(u64_be, uint256_t const &, Address const &);
 
+    // Reads the ids of a validator set, then the slots `keys_of` collects for
+    // every id, concurrently. Used ahead of the syscalls' loops over a set.
+    template <typename KeysOf>
+    void prefetch_valset(StorageArray<u64_be> const &, KeysOf const &keys_of);
+
     // Helper function for getting a valset. used by the three valset getters.
     Result<byte_string>
     get_valset(byte_string_view, StorageArray<u64_be> const &);
@@ -532,6 +539,11 @@ public:
     static std::pair<PrecompileFunc, uint64_t>
     precompile_dispatch(byte_string_view &);
 
+    // Verifies the BLS signatures of the addValidator calls made directly by
+    // `transactions` as one batch, ahead of their execution, and records the
+    // ones that passed in bls_verified_cache()
+    static void prevalidate_bls_signatures(std::span<Transaction const>);
+
     Result<byte_string> precompile_get_validator(
         byte_string_view, evmc_address const &, evmc_uint256be const &);
     Result<byte_string> precompile_get_delegator(
@@ -0,0 +1,65 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/monad/staking/config.hpp>
+#include <category/execution/monad/staking/read_valset.hpp>
+#include <category/execution/monad/staking/staking_state_cache.hpp>
+#include <category/execution/monad/staking/util/constants.hpp>
+#include <category/mpt/db.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+MONAD_STAKING_NAMESPACE_BEGIN
+
+StakingStateCache::Valset StakingStateCache::read_valset(
+    mpt::Db &db, uint64_t const block_number, uint64_t const requested_epoch)
+{
+    TrieDb tdb{db};
+    tdb.set_block_and_prefix(block_number);
+    std::pair const key{tdb.storage_root(STAKING_CA), requested_epoch};
+    {
+        std::lock_guard const lock{mutex_};
+        auto const it = valsets_.find(key);
+        if (it != valsets_.end()) {
+            return it->second;
+        }
+    }
+    auto valset = decode_valset(db, block_number, requested_epoch);
+    std::lock_guard const lock{mutex_};
+    if (valsets_.size() >= MAX_VALSETS) {
+        valsets_.clear();
+    }
+    valsets_.emplace(key, valset);
+    return valset;
+}
+
+size_t StakingStateCache::size()
+{
+    std::lock_guard const lock{mutex_};
+    return valsets_.size();
+}
+
+StakingStateCache &staking_state_cache()
+{
+    static StakingStateCache cache;
+    return cache;
+}
+
+MONAD_STAKING_NAMESPACE_END
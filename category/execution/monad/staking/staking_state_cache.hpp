@@ -0,0 +1,61 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/execution/monad/staking/config.hpp>
+#include <category/execution/monad/staking/read_valset.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+MONAD_STAKING_NAMESPACE_BEGIN
+
+/**
+ * Decoded validator sets, keyed by the storage root of the staking contract
+ * they were decoded from and the epoch asked for. A validator set only
+ * follows from that storage, so the set decoded at one block serves every
+ * block with the same root, for the cost of looking up the contract instead
+ * of every slot of the set. The root is read through the db of each query,
+ * so the cache holds in any process that reads validator sets, whatever
+ * that db has seen. Safe for concurrent use.
+ */
+class StakingStateCache
+{
+    static constexpr size_t MAX_VALSETS = 64;
+
+    using Valset = std::optional<std::vector<Validator>>;
+
+    std::mutex mutex_;
+    std::map<std::pair<bytes32_t, uint64_t>, Valset> valsets_;
+
+public:
+    Valset
+    read_valset(mpt::Db &, uint64_t block_number, uint64_t requested_epoch);
+
+    // The number of cached validator sets
+    size_t size();
+};
+
+// Shared by the read_valset callers of the process
+StakingStateCache &staking_state_cache();
+
+MONAD_STAKING_NAMESPACE_END
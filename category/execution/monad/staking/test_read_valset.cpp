@@ -20,6 +20,7 @@
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/monad/staking/read_valset.hpp>
 #include <category/execution/monad/staking/staking_contract.hpp>
+#include <category/execution/monad/staking/staking_state_cache.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
 
 #include <test_resource_data.h>
@@ -198,3 +199,55 @@ TEST_F(ReadValsetAfterBoundary, asking_for_future_epoch)
     auto const set = read_valset(ro, TEST_BLOCK_NUM, TEST_EPOCH + 3);
     EXPECT_FALSE(set.has_value());
 }
+
+TEST_F(ReadValsetBeforeBoundary, cache_follows_staking_storage)
+{
+    StakingStateCache cache;
+    OnDiskMachine machine;
+    vm::VM vm;
+    mpt::Db db{machine, mpt::OnDiskDbConfig{.dbname_paths = {dbname}}};
+    TrieDb tdb{db};
+
+    auto const commit = [&](uint64_t const block_number, bool const grow) {
+        bytes32_t const block_id{block_number};
+        tdb.set_block_and_prefix(block_number - 1);
+        BlockState bs{tdb, vm};
+        if (grow) {
+            State state{bs, Incarnation{block_number, 0}};
+            StakingContract contract{state};
+            state.add_to_balance(STAKING_CA, 0);
+            contract.vars.valset_consensus.push(u64_be{1000 + block_number});
+            MONAD_ASSERT(bs.can_merge(state));
+            bs.merge(state);
+        }
+        bs.commit(
+            block_id,
+            BlockHeader{.number = block_number},
+            {},
+            {},
+            {},
+            {},
+            {},
+            {});
+        tdb.finalize(block_number, block_id);
+    };
+
+    EXPECT_EQ(
+        cache.read_valset(ro, TEST_BLOCK_NUM, TEST_EPOCH)->size(),
+        CONSENSUS_VALSET_LENGTH);
+    commit(TEST_BLOCK_NUM + 1, true);
+    commit(TEST_BLOCK_NUM + 2, false);
+    EXPECT_EQ(
+        cache.read_valset(ro, TEST_BLOCK_NUM + 1, TEST_EPOCH)->size(),
+        CONSENSUS_VALSET_LENGTH + 1);
+    EXPECT_EQ(cache.size(), 2);
+    // same staking storage, served from the set decoded at the previous
+    // block
+    EXPECT_EQ(
+        cache.read_valset(ro, TEST_BLOCK_NUM + 2, TEST_EPOCH)->size(),
+        CONSENSUS_VALSET_LENGTH + 1);
+    EXPECT_EQ(
+        cache.read_valset(ro, TEST_BLOCK_NUM, TEST_EPOCH)->size(),
+        CONSENSUS_VALSET_LENGTH);
+    EXPECT_EQ(cache.size(), 2);
+}
@@ -18,12 +18,14 @@
 #include <category/core/bytes.hpp>
 #include <category/core/monad_exception.hpp>
 #include <category/core/result.hpp>
+#include <category/core/unaligned.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/contract/abi_decode_error.hpp>
 #include <category/execution/ethereum/core/contract/abi_encode.hpp>
 #include <category/execution/ethereum/core/contract/big_endian.hpp>
 #include <category/execution/ethereum/core/fmt/address_fmt.hpp> // NOLINT
 #include <category/execution/ethereum/core/fmt/int_fmt.hpp> // NOLINT
+#include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/db/trie_db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
@@ -761,6 +763,83 @@ TEST_F(Stake, add_validator_revert_bad_signature)
     }
 }
 
+TEST(BlsSignatureBatch, finds_invalid_signatures)
+{
+    std::vector<byte_string> messages;
+    std::vector<BlsPubkey> pubkeys;
+    std::vector<BlsSignature> signatures;
+    for (uint64_t i = 0; i < 5; ++i) {
+        auto const [message, secp_sig, bls_sig, address] =
+            craft_add_validator_input_raw(
+                0xababab_address, MIN_VALIDATE_STAKE, 0, bytes32_t{0x1000 + i});
+        messages.push_back(message);
+        pubkeys.emplace_back(
+            unaligned_load<byte_string_fixed<48>>(message.data() + 33));
+        signatures.emplace_back(
+            unaligned_load<byte_string_fixed<96>>(bls_sig.data()));
+    }
+    auto const inputs = [&] {
+        std::vector<BlsVerifyInput> inputs;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            inputs.push_back(BlsVerifyInput{
+                .pubkey = &pubkeys[i],
+                .signature = &signatures[i],
+                .message = messages[i]});
+        }
+        return inputs;
+    };
+    EXPECT_EQ(bls_verify_batch(inputs()), std::vector<bool>(5, true));
+
+    // signed by another key
+    signatures[2] =
+        BlsSignature{sign_bls(messages[2], gen_bls_keypair().second)};
+    ASSERT_TRUE(signatures[2].is_valid());
+    EXPECT_EQ(
+        bls_verify_batch(inputs()),
+        (std::vector<bool>{true, true, false, true, true}));
+}
+
+TEST_F(Stake, add_validator_uses_prevalidated_bls_signature)
+{
+    u32_be const selector{0xf145204c}; // addValidator(bytes,bytes,bytes)
+
+    std::vector<Transaction> transactions;
+    std::vector<bytes32_t> keys;
+    for (uint64_t i = 0; i < 3; ++i) {
+        auto const [message, secp_sig, bls_sig, _] =
+            craft_add_validator_input_raw(
+                0xababab_address,
+                MIN_VALIDATE_STAKE,
+                0,
+                bytes32_t{0x3000 + i});
+        // the last registration carries another key's signature
+        byte_string const signature =
+            i == 2 ? byte_string{to_byte_string_view(
+                         sign_bls(message, gen_bls_keypair().second))}
+                   : bls_sig;
+        AbiEncoder encoder;
+        encoder.add_bytes(message);
+        encoder.add_bytes(secp_sig);
+        encoder.add_bytes(signature);
+        byte_string data{selector.bytes, sizeof(selector.bytes)};
+        data += encoder.encode_final();
+        transactions.push_back(Transaction{.to = STAKING_CA, .data = data});
+        keys.push_back(bls_verified_key(
+            unaligned_load<byte_string_fixed<48>>(message.data() + 33),
+            unaligned_load<byte_string_fixed<96>>(signature.data()),
+            message));
+    }
+
+    StakingContract::prevalidate_bls_signatures(transactions);
+    EXPECT_TRUE(bls_verified_cache().contains(keys[0]));
+    EXPECT_TRUE(bls_verified_cache().contains(keys[1]));
+    EXPECT_FALSE(bls_verified_cache().contains(keys[2]));
+
+    EXPECT_FALSE(add_validator(
+                     0xababab_address, MIN_VALIDATE_STAKE, 0, bytes32_t{0x3000})
+                     .has_error());
+}
+
 TEST_F(Stake, add_validator_revert_msg_value_not_signed)
 {
     auto const value = intx::be::store<evmc_uint256be>(MIN_VALIDATE_STAKE);
@@ -20,10 +20,18 @@
 #include <category/execution/monad/staking/util/bls.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <random>
 
 MONAD_STAKING_NAMESPACE_BEGIN
 
+namespace
+{
+    constexpr size_t BLS_VERIFIED_CACHE_SIZE = 4096;
+}
+
 Address address_from_bls_key(byte_string_fixed<96> const &serialized_pubkey)
 {
     Address eth_address{};
@@ -34,4 +42,76 @@ Address address_from_bls_key(byte_string_fixed<96> const &serialized_pubkey)
     return eth_address;
 }
 
+std::vector<bool> bls_verify_batch(std::span<BlsVerifyInput const> const inputs)
+{
+    auto const verify_each = [inputs] {
+        std::vector<bool> verified(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto const &[pubkey, signature, message] = inputs[i];
+            verified[i] = signature->verify(*pubkey, message);
+        }
+        return verified;
+    };
+    if (inputs.size() < 2) {
+        return verify_each();
+    }
+
+    size_t const words =
+        (blst_pairing_sizeof() + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    auto const buffer = std::make_unique<uint64_t[]>(words);
+    auto *const ctx = reinterpret_cast<blst_pairing *>(buffer.get());
+    blst_pairing_init(
+        ctx,
+        true, // hash-to-curve
+        reinterpret_cast<uint8_t const *>(BLS_SIGNATURE_DST),
+        sizeof(BLS_SIGNATURE_DST) - 1);
+
+    std::random_device random;
+    for (auto const &[pubkey, signature, message] : inputs) {
+        uint64_t scalar = 0;
+        while (scalar == 0) {
+            scalar = (uint64_t{random()} << 32) | random();
+        }
+        uint8_t scalar_bytes[sizeof(scalar)];
+        std::memcpy(scalar_bytes, &scalar, sizeof(scalar));
+        BLST_ERROR const err = blst_pairing_chk_n_mul_n_aggr_pk_in_g1(
+            ctx,
+            &pubkey->get(),
+            false, // key already checked to be in G1
+            &signature->get(),
+            false, // signature already checked to be in G2
+            scalar_bytes,
+            8 * sizeof(scalar),
+            message.data(),
+            message.size(),
+            nullptr, // No augmentation
+            0 // Aug length
+        );
+        if (err != BLST_SUCCESS) {
+            return verify_each();
+        }
+    }
+    blst_pairing_commit(ctx);
+    if (blst_pairing_finalverify(ctx, nullptr)) {
+        return std::vector<bool>(inputs.size(), true);
+    }
+    return verify_each();
+}
+
+bytes32_t bls_verified_key(
+    byte_string_fixed<48> const &pubkey, byte_string_fixed<96> const &signature,
+    byte_string_view const message)
+{
+    byte_string preimage{to_byte_string_view(pubkey)};
+    preimage += to_byte_string_view(signature);
+    preimage += message;
+    return to_bytes(keccak256(preimage));
+}
+
+BlsVerifiedCache &bls_verified_cache()
+{
+    static BlsVerifiedCache cache{BLS_VERIFIED_CACHE_SIZE};
+    return cache;
+}
+
 MONAD_STAKING_NAMESPACE_END
@@ -16,13 +16,23 @@
 #pragma once
 
 #include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
+#include <category/core/lru/lru_cache.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/monad/staking/config.hpp>
 
 #include <blst.h>
 
+#include <cstddef>
+#include <span>
+#include <vector>
+
 MONAD_STAKING_NAMESPACE_BEGIN
 
+inline constexpr char BLS_SIGNATURE_DST[] =
+    "BLS_SIG_BLS12381G2_XMD:SHA-256_SSWU_RO_POP_";
+
 Address address_from_bls_key(byte_string_fixed<96> const &);
 
 class BlsPubkey
@@ -59,8 +69,6 @@ public:
 
 class BlsSignature
 {
-    static constexpr char BLS_SIGNATURE_DST[] =
-        "BLS_SIG_BLS12381G2_XMD:SHA-256_SSWU_RO_POP_";
     blst_p2_affine sig_;
     BLST_ERROR parse_result_;
 
@@ -77,7 +85,13 @@ public:
                !blst_p2_affine_is_inf(&sig_);
     }
 
-    bool verify(BlsPubkey const &pubkey, byte_string_view const message)
+    blst_p2_affine const &get() const noexcept
+    {
+        return sig_;
+    }
+
+    bool
+    verify(BlsPubkey const &pubkey, byte_string_view const message) const
     {
         BLST_ERROR valid_signature = blst_core_verify_pk_in_g1(
             &pubkey.get(), // Public key in G1
@@ -94,4 +108,52 @@ public:
     }
 };
 
+struct BlsVerifyInput
+{
+    BlsPubkey const *pubkey;
+    BlsSignature const *signature;
+    byte_string_view message;
+};
+
+// Verifies all signatures with one multi-pairing, each weighted by a random
+// 64 bit scalar so that invalid signatures cannot cancel each other out. Only
+// if that fails is every signature verified on its own to find the invalid
+// ones. Keys and signatures must be valid. Returns whether each verified.
+std::vector<bool> bls_verify_batch(std::span<BlsVerifyInput const>);
+
+/**
+ * Signatures a block's batch verification already accepted, keyed by
+ * bls_verified_key, so the staking precompile skips verifying them one by
+ * one while the block executes. Safe for concurrent use.
+ */
+class BlsVerifiedCache
+{
+    using Cache = LruCache<bytes32_t, bool, BytesHashCompare<bytes32_t>>;
+
+    Cache cache_;
+
+public:
+    explicit BlsVerifiedCache(size_t const max_size)
+        : cache_{max_size}
+    {
+    }
+
+    bool contains(bytes32_t const &key)
+    {
+        Cache::ConstAccessor acc{};
+        return cache_.find(acc, key);
+    }
+
+    void insert(bytes32_t const &key)
+    {
+        cache_.insert(key, true);
+    }
+};
+
+bytes32_t bls_verified_key(
+    byte_string_fixed<48> const &pubkey, byte_string_fixed<96> const &signature,
+    byte_string_view message);
+
+BlsVerifiedCache &bls_verified_cache();
+
 MONAD_STAKING_NAMESPACE_END
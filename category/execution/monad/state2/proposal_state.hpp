@@ -23,8 +23,19 @@
 
 #include <quill/Quill.h>
 
+#include <ankerl/unordered_dense.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -79,8 +90,7 @@ public:
             return true;
         }
         auto const &storage = it->second.storage;
-        StorageDeltas::const_accessor it2{};
-        if (storage.find(it2, key)) {
+        if (auto const it2 = storage.find(key); it2 != storage.end()) {
             result = it2->second.second;
             return true;
         }
@@ -88,6 +98,14 @@ public:
     }
 };
 
+// The keys a proposal wrote, kept once its deltas are dropped, so that
+// finalizing it can invalidate just those in the caches of finalized state
+struct ProposalWrites
+{
+    std::vector<Address> accounts{};
+    std::vector<std::tuple<Address, Incarnation, bytes32_t>> storage{};
+};
+
 class Proposals
 {
     using Key = std::pair<uint64_t, bytes32_t>; // <block_number, block_id>
@@ -105,15 +123,34 @@ class Proposals
     };
 
     using ProposalMap = std::map<Key, Value, ProposalMapComparator>;
+    using WritesMap = std::map<Key, ProposalWrites, ProposalMapComparator>;
 
     static constexpr size_t MAX_PROPOSAL_MAP_SIZE = 100;
+    static constexpr unsigned DEPTH_LIMIT = 5;
 
     ProposalMap proposal_map_{};
+    // the writes of the unfinalized proposals dropped from the map
+    WritesMap truncated_writes_{};
     uint64_t block_{0};
     bytes32_t block_id_{};
     uint64_t finalized_block_{0};
     bytes32_t finalized_block_id_{};
 
+    // Index over the unfinalized ancestors of the current block, newest
+    // first, so that a read costs one lookup instead of one per ancestor.
+    // Each address maps to the set of ancestors that wrote it, as a bit mask
+    // into `branch_`. It is built by the first read after the current block
+    // or the proposals change; those changes never overlap with reads.
+    mutable std::mutex branch_mutex_{};
+    mutable std::atomic<bool> branch_valid_{false};
+    mutable std::array<ProposalState const *, DEPTH_LIMIT> branch_{};
+    mutable unsigned branch_size_{0};
+    mutable bool branch_truncated_{false};
+    mutable ankerl::unordered_dense::segmented_map<Address, uint8_t>
+        branch_writers_{};
+
+    static_assert(DEPTH_LIMIT <= 8);
+
 public:
     bool try_read_account(
         Address const &address, std::optional<Account> &result,
@@ -122,7 +159,7 @@ public:
         auto const fn = [&address, &result](ProposalState const &ps) {
             return ps.try_read_account(address, result);
         };
-        return try_read(fn, truncated);
+        return try_read(address, fn, truncated);
     }
 
     bool try_read_storage(
@@ -133,7 +170,7 @@ public:
             [&address, incarnation, &key, &result](ProposalState const &ps) {
                 return ps.try_read_storage(address, incarnation, key, result);
             };
-        return try_read(fn, truncated);
+        return try_read(address, fn, truncated);
     }
 
     void
@@ -141,6 +178,7 @@ public:
     {
         block_ = block_number;
         block_id_ = block_id;
+        branch_valid_.store(false, std::memory_order_release);
     }
 
     void commit(
@@ -160,19 +198,41 @@ public:
                 .second == true);
         block_ = block_number;
         block_id_ = block_id;
+        branch_valid_.store(false, std::memory_order_release);
     }
 
     std::unique_ptr<ProposalState>
     finalize(uint64_t const block_num, bytes32_t const &block_id)
+    {
+        std::optional<ProposalWrites> truncated_writes;
+        return finalize(block_num, block_id, truncated_writes);
+    }
+
+    // Returns null when the proposal was truncated, setting
+    // `truncated_writes` if its writes are still known
+    std::unique_ptr<ProposalState> finalize(
+        uint64_t const block_num, bytes32_t const &block_id,
+        std::optional<ProposalWrites> &truncated_writes)
     {
         finalized_block_ = block_num;
         finalized_block_id_ = block_id;
-        auto const it = proposal_map_.find(std::make_pair(block_num, block_id));
+        branch_valid_.store(false, std::memory_order_release);
+        auto const key = std::make_pair(block_num, block_id);
+        if (auto const it = truncated_writes_.find(key);
+            it != truncated_writes_.end()) {
+            truncated_writes = std::move(it->second);
+        }
+        std::erase_if(truncated_writes_, [block_num](auto const &entry) {
+            return entry.first.first <= block_num;
+        });
+        auto const it = proposal_map_.find(key);
         if (it == proposal_map_.end()) {
             LOG_INFO(
-                "Finalizing truncated proposal of block_id {}. Clear LRU "
+                "Finalizing truncated proposal of block_id {}. {} LRU "
                 "caches.",
-                block_id);
+                block_id,
+                truncated_writes.has_value() ? "Invalidate its writes in"
+                                             : "Clear");
             return {};
         }
         std::unique_ptr<ProposalState> ps = std::move(it->second);
@@ -187,21 +247,49 @@ public:
 
 private:
     template <class Func>
-    bool try_read(Func const try_read_fn, bool &truncated) const
+    bool try_read(
+        Address const &address, Func const try_read_fn, bool &truncated) const
     {
-        constexpr int DEPTH_LIMIT = 5;
-        int depth = 1;
+        if (!branch_valid_.load(std::memory_order_acquire)) [[unlikely]] {
+            std::lock_guard const lock{branch_mutex_};
+            if (!branch_valid_.load(std::memory_order_relaxed)) {
+                build_branch_index();
+                branch_valid_.store(true, std::memory_order_release);
+            }
+        }
+        auto const it = branch_writers_.find(address);
+        if (it != branch_writers_.end()) {
+            // only the ancestors which wrote the address can answer, in the
+            // order the walk up the parent links would have visited them
+            for (unsigned mask = it->second; mask != 0; mask &= mask - 1) {
+                auto const depth =
+                    static_cast<unsigned>(std::countr_zero(mask));
+                if (try_read_fn(*branch_[depth])) {
+                    return true;
+                }
+            }
+        }
+        truncated = truncated || branch_truncated_;
+        return false;
+    }
+
+    void build_branch_index() const
+    {
+        branch_size_ = 0;
+        branch_truncated_ = false;
+        branch_writers_.clear();
         bytes32_t block_id = block_id_;
         uint64_t block_number = block_;
-        while (true) {
-            if (block_id == finalized_block_id_) {
+        while (block_id != finalized_block_id_) {
+            if (branch_size_ == DEPTH_LIMIT) {
+                branch_truncated_ = true;
                 break;
             }
             MONAD_ASSERT_PRINTF(
                 block_number > finalized_block_,
                 "block_number %lu is not greater than last finalized block "
                 "%lu. block_id = %s, block_ %lu, block_id_ %s, "
-                "finalized_block_id_ = %s, depth = %d",
+                "finalized_block_id_ = %s, depth = %u",
                 block_number,
                 finalized_block_,
                 evmc::hex(to_byte_string_view(block_id.bytes)).c_str(),
@@ -209,25 +297,24 @@ private:
                 evmc::hex(to_byte_string_view(block_id_.bytes)).c_str(),
                 evmc::hex(to_byte_string_view(finalized_block_id_.bytes))
                     .c_str(),
-                depth);
+                branch_size_ + 1);
             auto const it =
                 proposal_map_.find(std::make_pair(block_number, block_id));
             if (it == proposal_map_.end()) {
-                truncated = true;
+                branch_truncated_ = true;
                 break;
             }
-            ProposalState const *ps = it->second.get();
+            ProposalState const *const ps = it->second.get();
             MONAD_ASSERT(ps);
-            if (try_read_fn(*ps)) {
-                return true;
-            }
-            if (++depth > DEPTH_LIMIT) {
-                truncated = true;
-                break;
-            }
+            branch_[branch_size_++] = ps;
             std::tie(block_number, block_id) = ps->parent_info();
         }
-        return false;
+        for (unsigned depth = 0; depth < branch_size_; ++depth) {
+            auto const bit = static_cast<uint8_t>(1u << depth);
+            for (auto const &[address, _] : branch_[depth]->state()) {
+                branch_writers_[address] |= bit;
+            }
+        }
     }
 
     void truncate_proposal_map()
@@ -241,8 +328,28 @@ private:
             "Round map size reached limit {}, truncating round {}",
             MAX_PROPOSAL_MAP_SIZE,
             it->first);
+        if (truncated_writes_.size() >= MAX_PROPOSAL_MAP_SIZE) {
+            truncated_writes_.erase(truncated_writes_.begin());
+        }
+        truncated_writes_.emplace(it->first, writes_of(it->second->state()));
         proposal_map_.erase(it);
     }
+
+    static ProposalWrites writes_of(StateDeltas const &state)
+    {
+        ProposalWrites writes;
+        for (auto const &[address, delta] : state) {
+            writes.accounts.push_back(address);
+            auto const &account = delta.account.second;
+            if (!account.has_value()) {
+                continue;
+            }
+            for (auto const &[key, _] : delta.storage) {
+                writes.storage.emplace_back(address, account->incarnation, key);
+            }
+        }
+        return writes;
+    }
 };
 
 MONAD_NAMESPACE_END
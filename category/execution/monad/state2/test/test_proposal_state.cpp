@@ -0,0 +1,117 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/execution/monad/state2/proposal_state.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+using namespace monad;
+
+namespace
+{
+    constexpr auto a = 0x5353535353535353535353535353535353535353_address;
+    constexpr auto b = 0xbebebebebebebebebebebebebebebebebebebebe_address;
+    constexpr auto c = 0xa5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5_address;
+    constexpr auto key1 =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+    constexpr auto value1 =
+        0x0000000000000000000000000000000000000000000000000000000000000003_bytes32;
+
+    std::unique_ptr<StateDeltas> write_balance(
+        Address const &address, uint64_t const balance,
+        StorageDeltas storage = {})
+    {
+        return std::make_unique<StateDeltas>(StateDeltas{
+            {address,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = balance}},
+                 .storage = std::move(storage)}}});
+    }
+
+    std::optional<uint64_t>
+    read_balance(Proposals const &proposals, Address const &address)
+    {
+        std::optional<Account> result;
+        bool truncated = false;
+        if (!proposals.try_read_account(address, result, truncated)) {
+            return std::nullopt;
+        }
+        return result.transform([](Account const &acct) {
+            return static_cast<uint64_t>(acct.balance);
+        });
+    }
+}
+
+TEST(Proposals, read_newest_writer_on_branch)
+{
+    Proposals proposals;
+    proposals.commit(
+        write_balance(a, 1, {{key1, {bytes32_t{}, value1}}}),
+        1,
+        bytes32_t{1});
+    proposals.commit(write_balance(a, 2), 2, bytes32_t{2});
+    proposals.commit(write_balance(b, 3), 3, bytes32_t{3});
+
+    EXPECT_EQ(read_balance(proposals, a), 2);
+    EXPECT_EQ(read_balance(proposals, b), 3);
+
+    // the slot is only in the oldest writer of the account
+    bytes32_t value{};
+    bool truncated = false;
+    EXPECT_TRUE(proposals.try_read_storage(
+        a, Incarnation{0, 0}, key1, value, truncated));
+    EXPECT_EQ(value, value1);
+
+    std::optional<Account> account;
+    EXPECT_FALSE(proposals.try_read_account(c, account, truncated));
+    EXPECT_FALSE(truncated);
+
+    // moving the head to an ancestor must not see its descendants
+    proposals.set_block_and_prefix(1, bytes32_t{1});
+    EXPECT_EQ(read_balance(proposals, a), 1);
+    EXPECT_EQ(read_balance(proposals, b), std::nullopt);
+}
+
+TEST(Proposals, read_beyond_depth_limit_is_truncated)
+{
+    Proposals proposals;
+    proposals.commit(write_balance(b, 1), 1, bytes32_t{1});
+    for (uint64_t n = 2; n <= 7; ++n) {
+        proposals.commit(write_balance(a, n), n, bytes32_t{n});
+    }
+    EXPECT_EQ(read_balance(proposals, a), 7);
+
+    std::optional<Account> account;
+    bool truncated = false;
+    EXPECT_FALSE(proposals.try_read_account(b, account, truncated));
+    EXPECT_TRUE(truncated);
+
+    // finalizing shortens the branch back within the limit
+    EXPECT_NE(proposals.finalize(2, bytes32_t{2}), nullptr);
+    truncated = false;
+    EXPECT_FALSE(proposals.try_read_account(b, account, truncated));
+    EXPECT_FALSE(truncated);
+}
@@ -0,0 +1,256 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/rlp/transaction_rlp.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/signer_cache.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/monad/chain/monad_devnet.hpp>
+#include <category/execution/monad/speculative_execution.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <boost/fiber/future/promise.hpp>
+
+#include <gtest/gtest.h>
+
+#include <test_resource_data.h>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+using namespace monad;
+using namespace monad::test;
+
+namespace
+{
+    using traits = MonadTraits<MONAD_FIVE>;
+
+    constexpr auto sender = 0x00000000000000000000000000000000000000a1_address;
+    constexpr auto token = 0x00000000000000000000000000000000000000b1_address;
+    constexpr auto other = 0x00000000000000000000000000000000000000b2_address;
+    constexpr auto key =
+        0x0000000000000000000000000000000000000000000000000000000000000001_bytes32;
+    constexpr auto value1 =
+        0x0000000000000000000000000000000000000000000000000000000000000003_bytes32;
+    constexpr auto value2 =
+        0x0000000000000000000000000000000000000000000000000000000000000007_bytes32;
+
+    // PUSH1 1 SLOAD STOP
+    byte_string const token_code{0x60, 0x01, 0x54, 0x00};
+
+    struct SpeculativeExecutionTest : public ::testing::Test
+    {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        TrieDb tdb{db};
+        vm::VM vm;
+        MonadDevnet const chain;
+        BlockHashBufferFinalized const block_hash_buffer;
+        fiber::PriorityPool pool{1, 1};
+        SignerCache signer_cache{16};
+        bytes32_t const code_hash = to_bytes(keccak256(token_code));
+
+        void SetUp() override
+        {
+            Code code;
+            code.emplace(code_hash, vm::make_shared_intercode(token_code));
+            commit_sequential(
+                tdb,
+                StateDeltas{
+                    {sender,
+                     StateDelta{
+                         .account =
+                             {std::nullopt,
+                              Account{.balance = 1'000'000'000}}}},
+                    {token,
+                     StateDelta{
+                         .account =
+                             {std::nullopt,
+                              Account{.balance = 1, .code_hash = code_hash}},
+                         .storage = {{key, {bytes32_t{}, value1}}}}},
+                    {other,
+                     StateDelta{
+                         .account = {std::nullopt, Account{.balance = 2}}}}},
+                code,
+                BlockHeader{.number = 0});
+        }
+
+        Transaction call_token(uint64_t const nonce)
+        {
+            Transaction const tx{
+                .sc = {.r = 1, .s = 1},
+                .nonce = nonce,
+                .max_fee_per_gas = 1,
+                .gas_limit = 100'000,
+                .to = token};
+            // Known signer, as the signature is not a real one
+            signer_cache.insert(
+                to_bytes(keccak256(rlp::encode_transaction(tx))),
+                SignerCache::Entry{.sender = sender});
+            return tx;
+        }
+
+        // Stopping does not wait for the speculation, which the only fiber
+        // of the pool has run once it runs a task queued after it
+        void run_speculation()
+        {
+            boost::fibers::promise<void> ran;
+            auto future = ran.get_future();
+            pool.submit(
+                std::numeric_limits<uint64_t>::max(),
+                [&ran] { ran.set_value(); });
+            future.get();
+        }
+    };
+}
+
+TEST_F(SpeculativeExecutionTest, reads_brought_forward)
+{
+    BlockHeader const header{
+        .number = 1, .gas_limit = 30'000'000, .base_fee_per_gas = 0};
+    std::vector<Transaction> const txs{call_token(0)};
+    ASSERT_FALSE(vm.find_varcode(code_hash).has_value());
+
+    SpeculativeExecution<traits> speculation{
+        chain, header, txs, block_hash_buffer, tdb, vm, pool, &signer_cache};
+    run_speculation();
+
+    // The executing block changed the slot and the other account, and
+    // recreated nothing
+    StateDeltas const executed{
+        {token,
+         StateDelta{
+             .account =
+                 {Account{.balance = 1, .code_hash = code_hash},
+                  Account{.balance = 5, .code_hash = code_hash}},
+             .storage = {{key, {value1, value2}}}}},
+        {other,
+         StateDelta{
+             .account = {Account{.balance = 2}, Account{.balance = 20}}}}};
+    auto const reads = speculation.reads_after(executed);
+
+    {
+        StateDeltas::const_accessor it;
+        ASSERT_TRUE(reads->find(it, sender));
+        ASSERT_TRUE(it->second.account.first.has_value());
+        EXPECT_EQ(it->second.account.first->balance, 1'000'000'000);
+    }
+    {
+        StateDeltas::const_accessor it;
+        ASSERT_TRUE(reads->find(it, token));
+        ASSERT_TRUE(it->second.account.first.has_value());
+        EXPECT_EQ(it->second.account.first->balance, 5);
+        EXPECT_EQ(it->second.account.first, it->second.account.second);
+        auto const slot = it->second.storage.find(key);
+        ASSERT_NE(slot, it->second.storage.end());
+        EXPECT_EQ(slot->second.first, value2);
+        EXPECT_EQ(slot->second.second, value2);
+    }
+    // Read by the executing block only
+    EXPECT_EQ(reads->count(other), 0);
+    EXPECT_TRUE(vm.find_varcode(code_hash).has_value());
+}
+
+TEST_F(SpeculativeExecutionTest, recreated_account_dropped)
+{
+    BlockHeader const header{
+        .number = 1, .gas_limit = 30'000'000, .base_fee_per_gas = 0};
+    std::vector<Transaction> const txs{call_token(0)};
+
+    SpeculativeExecution<traits> speculation{
+        chain, header, txs, block_hash_buffer, tdb, vm, pool, &signer_cache};
+    run_speculation();
+
+    StateDeltas const executed{
+        {token,
+         StateDelta{
+             .account = {
+                 Account{.balance = 1, .code_hash = code_hash},
+                 Account{.balance = 1, .incarnation = Incarnation{1, 0}}}}}};
+    auto const reads = speculation.reads_after(executed);
+    EXPECT_EQ(reads->count(token), 0);
+    EXPECT_EQ(reads->count(sender), 1);
+}
+
+TEST_F(SpeculativeExecutionTest, invalid_transaction_skipped)
+{
+    BlockHeader const header{
+        .number = 1, .gas_limit = 30'000'000, .base_fee_per_gas = 0};
+    // The sender is at nonce 0
+    std::vector<Transaction> const txs{call_token(5)};
+
+    SpeculativeExecution<traits> speculation{
+        chain, header, txs, block_hash_buffer, tdb, vm, pool, &signer_cache};
+    run_speculation();
+    auto const reads = speculation.reads_after(StateDeltas{});
+    EXPECT_EQ(reads->count(token), 0);
+    EXPECT_FALSE(vm.find_varcode(code_hash).has_value());
+}
+
+TEST_F(SpeculativeExecutionTest, empty_block)
+{
+    BlockHeader const header{.number = 1};
+    std::vector<Transaction> const txs;
+
+    SpeculativeExecution<traits> speculation{
+        chain, header, txs, block_hash_buffer, tdb, vm, pool, &signer_cache};
+    EXPECT_EQ(speculation.reads_after(StateDeltas{})->size(), 0);
+}
+
+TEST_F(SpeculativeExecutionTest, stopped_before_running)
+{
+    BlockHeader const header{
+        .number = 1, .gas_limit = 30'000'000, .base_fee_per_gas = 0};
+    std::optional<SpeculativeExecution<traits>> speculation;
+    {
+        // The transactions only have to live until the speculation is
+        // submitted
+        std::vector<Transaction> const txs{call_token(0)};
+        // Keeps the only fiber of the pool busy until the speculation stops
+        boost::fibers::promise<void> stopped;
+        auto future = stopped.get_future();
+        pool.submit(0, [&future] { future.wait(); });
+        speculation.emplace(
+            chain,
+            header,
+            txs,
+            block_hash_buffer,
+            tdb,
+            vm,
+            pool,
+            &signer_cache);
+        EXPECT_EQ(speculation->reads_after(StateDeltas{})->size(), 0);
+        stopped.set_value();
+        run_speculation();
+    }
+    speculation.reset();
+    EXPECT_FALSE(vm.find_varcode(code_hash).has_value());
+}
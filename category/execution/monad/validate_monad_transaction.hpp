@@ -20,8 +20,7 @@
 #include <category/core/result.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/vm/evm/monad/revision.h>
-
-#include <evmc/evmc.h>
+#include <category/vm/evm/traits.hpp>
 
 // TODO unstable paths between versions
 #if __has_include(<boost/outcome/experimental/status-code/status-code/config.hpp>)
@@ -49,9 +48,15 @@ enum class MonadTransactionError
     SystemTransactionSenderIsAuthority,
 };
 
+template <Traits traits>
+Result<void> validate_monad_transaction(
+    Transaction const &, Address const &sender, State &,
+    uint256_t const &base_fee_per_gas,
+    std::vector<std::optional<Address>> const &authorities);
+
 Result<void> validate_monad_transaction(
-    monad_revision, evmc_revision, Transaction const &, Address const &sender,
-    State &, uint256_t const &base_fee_per_gas,
+    monad_revision, Transaction const &, Address const &sender, State &,
+    uint256_t const &base_fee_per_gas,
     std::vector<std::optional<Address>> const &authorities);
 
 MONAD_NAMESPACE_END
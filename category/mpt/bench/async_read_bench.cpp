@@ -100,6 +100,7 @@ int main(int argc, char *const argv[])
     uint32_t runtime_seconds = std::numeric_limits<uint32_t>::max();
     unsigned update_delay_ms = 500;
     uint64_t cache_size = 1 * 1024 * 1024;
+    bool nvme_passthrough = false;
 
     Stats total_stats;
 
@@ -141,6 +142,11 @@ int main(int argc, char *const argv[])
             "--cache-size",
             cache_size,
             "Size of the node cache (in number of nodes)");
+        cli.add_flag(
+            "--nvme-passthrough",
+            nvme_passthrough,
+            "Read NVMe namespaces through io_uring passthrough commands, "
+            "bypassing the block layer");
         cli.add_option(
                "--db",
                dbname_paths,
@@ -164,6 +170,7 @@ int main(int argc, char *const argv[])
                   << std::endl;
         std::cout << "  update_delay: " << update_delay_ms << " ms"
                   << std::endl;
+        std::cout << "  nvme_passthrough: " << nvme_passthrough << std::endl;
 
         quill::start(true);
 
@@ -217,7 +224,9 @@ int main(int argc, char *const argv[])
             << std::endl;
 
         CollectKeys collect_keys(keys);
-        ReadOnlyOnDiskDbConfig const ro_config{.dbname_paths = {dbname_paths}};
+        ReadOnlyOnDiskDbConfig const ro_config{
+            .dbname_paths = {dbname_paths},
+            .nvme_passthrough = nvme_passthrough};
         AsyncIOContext io_ctx{ro_config};
         Db ro_db{io_ctx};
 
@@ -277,7 +286,8 @@ int main(int argc, char *const argv[])
 
         auto random_async_read = [&]() {
             ReadOnlyOnDiskDbConfig const ro_config{
-                .dbname_paths = {dbname_paths}};
+                .dbname_paths = {dbname_paths},
+                .nvme_passthrough = nvme_passthrough};
             AsyncIOContext io_ctx{ro_config};
             Db ro_db{io_ctx};
             auto async_ctx = async_context_create(ro_db, cache_size);
@@ -379,7 +389,8 @@ int main(int argc, char *const argv[])
 
         auto random_traverse = [&]() {
             ReadOnlyOnDiskDbConfig const ro_config{
-                .dbname_paths = {dbname_paths}};
+                .dbname_paths = {dbname_paths},
+                .nvme_passthrough = nvme_passthrough};
             AsyncIOContext io_ctx{ro_config};
             Db ro_db{io_ctx};
 
@@ -0,0 +1,554 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/keccak.hpp>
+#include <category/mpt/db.hpp>
+#include <category/mpt/nibbles_view.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/ondisk_db_config.hpp>
+#include <category/mpt/test/test_fixtures_base.hpp>
+#include <category/mpt/traverse.hpp>
+#include <category/mpt/update.hpp>
+#include <category/mpt/util.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <quill/Quill.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+#include <unistd.h>
+
+/* Google Benchmark suite for triedb i/o.
+
+Every benchmark reports, besides timings:
+  ops            operations per second (reads, leaves visited, or keys
+                 upserted)
+  disk_reads     reads submitted to storage per second
+  p50_us, p99_us, p999_us
+                 latency percentiles of one operation
+  cpu_us_per_op  process cpu time per operation, including db worker threads
+
+By default a database of MONAD_TRIEDB_BENCH_KEYS keys (default 1M) is built in
+a temporary file in the working directory and removed on exit. Set
+MONAD_TRIEDB_BENCH_DB to use a storage device or file instead. Its contents
+are replaced.
+*/
+
+using namespace monad::mpt;
+using namespace monad::test;
+
+namespace
+{
+    constexpr size_t node_cache_bytes = 64ul << 20;
+    // Small enough to stay in the node cache once read
+    constexpr uint64_t hot_keys = 4096;
+    constexpr size_t point_read_batch = 64;
+
+    uint64_t env_or(char const *const name, uint64_t const otherwise)
+    {
+        char const *const v = std::getenv(name);
+        return (v != nullptr) ? std::strtoull(v, nullptr, 10) : otherwise;
+    }
+
+    monad::byte_string to_key(uint64_t const key)
+    {
+        auto const as_bytes = serialize_as_big_endian<sizeof(key)>(key);
+        auto const hash = monad::keccak256(as_bytes);
+        return monad::byte_string{hash.bytes, sizeof(hash.bytes)};
+    }
+
+    void upsert_keys(
+        Db &db, std::span<uint64_t const> const keys, uint64_t const version)
+    {
+        std::vector<monad::byte_string> bytes;
+        bytes.reserve(keys.size() * 2);
+        for (auto const key : keys) {
+            bytes.push_back(to_key(key));
+            bytes.push_back(
+                serialize_as_big_endian<sizeof(key)>(key) +
+                serialize_as_big_endian<sizeof(version)>(version));
+        }
+        std::vector<Update> updates;
+        updates.reserve(keys.size());
+        UpdateList ul;
+        for (size_t i = 0; i < keys.size(); i++) {
+            ul.push_front(updates.emplace_back(make_update(
+                NibblesView{bytes[i * 2]},
+                bytes[i * 2 + 1],
+                false,
+                UpdateList{},
+                version)));
+        }
+        db.upsert(std::move(ul), version);
+    }
+
+    // Distinct keys, which one upsert requires
+    std::vector<uint64_t> random_keys(
+        std::mt19937_64 &rng, size_t const count, uint64_t const key_count)
+    {
+        std::vector<uint64_t> keys(count);
+        for (auto &key : keys) {
+            key = rng() % key_count;
+        }
+        std::ranges::sort(keys);
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    class bench_db
+    {
+        std::filesystem::path path_;
+        bool owned_{false};
+        uint64_t keys_;
+
+        bench_db()
+            : keys_{env_or("MONAD_TRIEDB_BENCH_KEYS", 1ul << 20)}
+        {
+            if (char const *const p = std::getenv("MONAD_TRIEDB_BENCH_DB")) {
+                path_ = p;
+            }
+            else {
+                path_ = std::filesystem::current_path() /
+                        ("triedb_io_bench_" + std::to_string(::getpid()));
+                owned_ = true;
+            }
+            StateMachineAlwaysMerkle machine{};
+            Db db{
+                machine,
+                OnDiskDbConfig{.dbname_paths = {path_}, .file_size_db = 8}};
+            constexpr uint64_t keys_per_version = 1ul << 16;
+            std::vector<uint64_t> batch;
+            uint64_t version = 0;
+            for (uint64_t first = 0; first < keys_;
+                 first += keys_per_version) {
+                batch.clear();
+                for (uint64_t k = first;
+                     k < std::min(first + keys_per_version, keys_);
+                     k++) {
+                    batch.push_back(k);
+                }
+                upsert_keys(db, batch, version++);
+            }
+        }
+
+    public:
+        bench_db(bench_db const &) = delete;
+
+        ~bench_db()
+        {
+            if (owned_) {
+                std::filesystem::remove(path_);
+            }
+        }
+
+        static bench_db &instance()
+        {
+            static bench_db db;
+            return db;
+        }
+
+        std::filesystem::path const &path() const noexcept
+        {
+            return path_;
+        }
+
+        uint64_t keys() const noexcept
+        {
+            return keys_;
+        }
+    };
+
+    struct ro_reader
+    {
+        AsyncIOContext io_ctx;
+        Db db;
+        AsyncContextUniquePtr ctx;
+
+        explicit ro_reader(size_t const cache_bytes)
+            : io_ctx{ReadOnlyOnDiskDbConfig{
+                  .dbname_paths = {bench_db::instance().path()}}}
+            , db{io_ctx}
+            , ctx{async_context_create(db, cache_bytes)}
+        {
+        }
+
+        unsigned reads_submitted() const noexcept
+        {
+            return io_ctx.io.reads_submitted();
+        }
+    };
+
+    struct op_stats
+    {
+        std::vector<std::chrono::nanoseconds> latencies;
+        uint64_t ops{0};
+        uint64_t failed{0};
+    };
+
+    struct get_receiver
+    {
+        op_stats *stats;
+        size_t *completions;
+        std::chrono::steady_clock::time_point start;
+
+        void set_value(
+            monad::async::erased_connected_operation *const state,
+            monad::async::result<monad::byte_string> res)
+        {
+            stats->latencies.push_back(
+                std::chrono::steady_clock::now() - start);
+            if (!res) {
+                stats->failed++;
+            }
+            ++*completions;
+            delete state;
+        }
+    };
+
+    // Issues an async get for every key, then pumps the db until all have
+    // completed
+    void read_keys(
+        ro_reader &reader, std::span<monad::byte_string const> const keys,
+        uint64_t const version, op_stats &stats)
+    {
+        size_t completions = 0;
+        for (auto const &key : keys) {
+            auto *const state = new auto(monad::async::connect(
+                make_get_sender(reader.ctx.get(), NibblesView{key}, version),
+                get_receiver{
+                    &stats, &completions, std::chrono::steady_clock::now()}));
+            state->initiate();
+        }
+        while (completions < keys.size()) {
+            reader.db.poll(true, std::numeric_limits<size_t>::max());
+        }
+        stats.ops += keys.size();
+    }
+
+    // `hot_pct` percent of the keys come from the hot set
+    void pick_keys(
+        std::vector<monad::byte_string> &out, size_t const count,
+        unsigned const hot_pct, std::mt19937_64 &rng)
+    {
+        auto const key_count = bench_db::instance().keys();
+        out.clear();
+        for (size_t i = 0; i < count; i++) {
+            bool const hot = (rng() % 100) < hot_pct;
+            out.push_back(to_key(rng() % (hot ? hot_keys : key_count)));
+        }
+    }
+
+    // Includes the db worker threads, but not kernel poll threads
+    std::chrono::nanoseconds process_cpu_time()
+    {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return std::chrono::seconds(ts.tv_sec) +
+               std::chrono::nanoseconds(ts.tv_nsec);
+    }
+
+    void report(
+        benchmark::State &state, op_stats &stats,
+        std::chrono::nanoseconds const cpu, uint64_t const disk_reads)
+    {
+        using us = std::chrono::duration<double, std::micro>;
+        auto &latencies = stats.latencies;
+        std::ranges::sort(latencies);
+        auto const percentile = [&](double const p) {
+            if (latencies.empty()) {
+                return 0.0;
+            }
+            auto const i = std::min(
+                latencies.size() - 1, size_t(p * double(latencies.size())));
+            return us(latencies[i]).count();
+        };
+        state.counters["ops"] =
+            benchmark::Counter(double(stats.ops), benchmark::Counter::kIsRate);
+        state.counters["disk_reads"] =
+            benchmark::Counter(double(disk_reads), benchmark::Counter::kIsRate);
+        state.counters["p50_us"] = percentile(0.5);
+        state.counters["p99_us"] = percentile(0.99);
+        state.counters["p999_us"] = percentile(0.999);
+        state.counters["cpu_us_per_op"] =
+            stats.ops ? us(cpu).count() / double(stats.ops) : 0.0;
+        state.counters["failed"] = double(stats.failed);
+    }
+
+    struct count_leaves final : TraverseMachine
+    {
+        uint64_t *leaves;
+
+        explicit count_leaves(uint64_t *const leaves_)
+            : leaves(leaves_)
+        {
+        }
+
+        bool down(unsigned char, Node const &node) override
+        {
+            if (node.has_value()) {
+                ++*leaves;
+            }
+            return true;
+        }
+
+        void up(unsigned char, Node const &) override {}
+
+        std::unique_ptr<TraverseMachine> clone() const override
+        {
+            return std::make_unique<count_leaves>(*this);
+        }
+    };
+}
+
+// Random point reads, `hot_pct` percent of which hit keys kept in the node
+// cache
+static void BM_point_reads(benchmark::State &state)
+{
+    auto const hot_pct = unsigned(state.range(0));
+    ro_reader reader{node_cache_bytes};
+    auto const version = reader.db.get_latest_version();
+    std::vector<monad::byte_string> keys;
+    {
+        op_stats warmup;
+        for (uint64_t k = 0; k < hot_keys; k++) {
+            keys.push_back(to_key(k));
+        }
+        read_keys(reader, keys, version, warmup);
+    }
+    std::mt19937_64 rng{42};
+    op_stats stats;
+    auto const reads_before = reader.reads_submitted();
+    auto const cpu_before = process_cpu_time();
+    for (auto _ : state) {
+        pick_keys(keys, point_read_batch, hot_pct, rng);
+        read_keys(reader, keys, version, stats);
+    }
+    report(
+        state,
+        stats,
+        process_cpu_time() - cpu_before,
+        reader.reads_submitted() - reads_before);
+}
+
+BENCHMARK(BM_point_reads)
+    ->ArgName("hot_pct")
+    ->Arg(0)
+    ->Arg(50)
+    ->Arg(90)
+    ->Arg(99)
+    ->UseRealTime();
+
+// A batch of cold reads issued at once, in key order or not. Latencies
+// include queueing behind the rest of the batch.
+static void BM_batch_reads(benchmark::State &state)
+{
+    auto const batch = size_t(state.range(0));
+    bool const sorted = state.range(1) != 0;
+    ro_reader reader{1ul << 20};
+    auto const version = reader.db.get_latest_version();
+    std::mt19937_64 rng{42};
+    std::vector<monad::byte_string> keys;
+    op_stats stats;
+    auto const reads_before = reader.reads_submitted();
+    auto const cpu_before = process_cpu_time();
+    for (auto _ : state) {
+        pick_keys(keys, batch, 0, rng);
+        if (sorted) {
+            std::ranges::sort(keys);
+        }
+        read_keys(reader, keys, version, stats);
+    }
+    report(
+        state,
+        stats,
+        process_cpu_time() - cpu_before,
+        reader.reads_submitted() - reads_before);
+}
+
+BENCHMARK(BM_batch_reads)
+    ->ArgNames({"batch", "sorted"})
+    ->ArgsProduct({{64, 1024}, {0, 1}})
+    ->UseRealTime();
+
+// Full traverse of the latest version. An op is one leaf visited, latency is
+// that of the whole traverse.
+static void BM_traverse(benchmark::State &state)
+{
+    ro_reader reader{node_cache_bytes};
+    auto const version = reader.db.get_latest_version();
+    op_stats stats;
+    auto const reads_before = reader.reads_submitted();
+    auto const cpu_before = process_cpu_time();
+    for (auto _ : state) {
+        uint64_t leaves = 0;
+        count_leaves machine{&leaves};
+        auto const begin = std::chrono::steady_clock::now();
+        auto const root = reader.db.load_root_for_version(version);
+        MONAD_ASSERT(reader.db.traverse(root, machine, version));
+        stats.latencies.push_back(std::chrono::steady_clock::now() - begin);
+        stats.ops += leaves;
+    }
+    report(
+        state,
+        stats,
+        process_cpu_time() - cpu_before,
+        reader.reads_submitted() - reads_before);
+}
+
+BENCHMARK(BM_traverse)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Cold point reads from an RODb while an RWDb upserts `keys_per_upsert`
+// random keys per version in another thread
+static void BM_reads_during_upserts(benchmark::State &state)
+{
+    auto const keys_per_upsert = size_t(state.range(0));
+    std::atomic<bool> ready{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> upserts{0};
+    std::thread writer([&] {
+        StateMachineAlwaysMerkle machine{};
+        Db rw{
+            machine,
+            OnDiskDbConfig{
+                .append = true,
+                .compaction = true,
+                .dbname_paths = {bench_db::instance().path()}}};
+        ready = true;
+        std::mt19937_64 rng{7};
+        auto version = rw.get_latest_version() + 1;
+        while (!stop) {
+            auto const keys = random_keys(
+                rng, keys_per_upsert, bench_db::instance().keys());
+            upsert_keys(rw, keys, version++);
+            upserts++;
+        }
+    });
+    while (!ready) {
+        std::this_thread::yield();
+    }
+    {
+        ro_reader reader{node_cache_bytes};
+        std::mt19937_64 rng{42};
+        std::vector<monad::byte_string> keys;
+        op_stats stats;
+        auto const reads_before = reader.reads_submitted();
+        auto const cpu_before = process_cpu_time();
+        for (auto _ : state) {
+            pick_keys(keys, point_read_batch, 0, rng);
+            read_keys(reader, keys, reader.db.get_latest_version(), stats);
+        }
+        report(
+            state,
+            stats,
+            process_cpu_time() - cpu_before,
+            reader.reads_submitted() - reads_before);
+    }
+    stop = true;
+    writer.join();
+    state.counters["upserts"] =
+        benchmark::Counter(double(upserts), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_reads_during_upserts)
+    ->ArgName("keys_per_upsert")
+    ->Arg(1000)
+    ->Arg(10000)
+    ->UseRealTime();
+
+// Upserts of `keys_per_upsert` random keys with a short fixed history, so
+// compaction is continually rewriting the rings, while another thread keeps
+// cold point reads going. An op is one key upserted, latency is that of the
+// whole upsert.
+static void BM_upserts_under_compaction(benchmark::State &state)
+{
+    auto const keys_per_upsert = size_t(state.range(0));
+    StateMachineAlwaysMerkle machine{};
+    Db rw{
+        machine,
+        OnDiskDbConfig{
+            .append = true,
+            .compaction = true,
+            .dbname_paths = {bench_db::instance().path()},
+            .fixed_history_length = 16}};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::thread reader_thread([&] {
+        ro_reader reader{node_cache_bytes};
+        std::mt19937_64 rng{42};
+        std::vector<monad::byte_string> keys;
+        while (!stop) {
+            op_stats stats;
+            pick_keys(keys, point_read_batch, 0, rng);
+            read_keys(reader, keys, reader.db.get_latest_version(), stats);
+            reads += stats.ops;
+        }
+    });
+    std::mt19937_64 rng{7};
+    auto version = rw.get_latest_version() + 1;
+    op_stats stats;
+    auto const cpu_before = process_cpu_time();
+    for (auto _ : state) {
+        auto const keys =
+            random_keys(rng, keys_per_upsert, bench_db::instance().keys());
+        auto const begin = std::chrono::steady_clock::now();
+        upsert_keys(rw, keys, version++);
+        stats.latencies.push_back(std::chrono::steady_clock::now() - begin);
+        stats.ops += keys.size();
+    }
+    auto const cpu = process_cpu_time() - cpu_before;
+    stop = true;
+    reader_thread.join();
+    report(state, stats, cpu, 0);
+    state.counters["background_reads"] =
+        benchmark::Counter(double(reads), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_upserts_under_compaction)
+    ->ArgName("keys_per_upsert")
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+int main(int argc, char **argv)
+{
+    quill::start(true);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    // Build the database before anything is timed
+    (void)bench_db::instance();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -52,6 +52,7 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <new>
 #include <optional>
 #include <span>
 #include <sstream>
@@ -132,6 +133,13 @@ static size_t const total_physical_memory_bytes = [] {
     return size_t(v) * size_t(getpagesize());
 }();
 
+// Decompression output is staged through windows of at most this size, so a
+// restore worker's memory use doesn't grow with chunk capacity
+static constexpr size_t MAX_RESTORE_WINDOW_BYTES = 64ULL << 20;
+static constexpr size_t MIN_RESTORE_WINDOW_BYTES = 1ULL << 20;
+// O_DIRECT writes are aligned to the largest common logical block size
+static constexpr unsigned DIRECT_IO_ALIGNMENT_BITS = 12;
+
 struct chunk_info_restore_t
 {
     monad::async::storage_pool::chunk_type const type;
@@ -143,7 +151,9 @@ struct chunk_info_restore_t
     std::vector<std::byte> nonchunkstorage;
     std::future<size_t> decompression_thread;
     bool const is_uncompressed;
-    bool use_faster_memory_mode{false};
+    // if not -1, an O_DIRECT descriptor onto the chunk's storage
+    int direct_fd{-1};
+    size_t window_bytes{MAX_RESTORE_WINDOW_BYTES};
     bool done{false};
 
     chunk_info_restore_t(
@@ -180,102 +190,101 @@ struct chunk_info_restore_t
 
     void reset() {}
 
+    // Writes `len` bytes of `window` to the chunk at `offset`. O_DIRECT
+    // needs whole blocks, so the tail is zero padded up to the next block,
+    // which stays within the chunk's capacity and past its used size.
+    void write_window(
+        int const fd, std::byte *const window, size_t len,
+        monad::async::file_offset_t const offset)
+    {
+        if (fd == direct_fd) {
+            auto const padded =
+                monad::async::round_up_align<DIRECT_IO_ALIGNMENT_BITS>(len);
+            memset(window + len, 0, padded - len);
+            len = padded;
+        }
+        if (::pwrite(fd, window, len, off_t(offset)) < 0) {
+            throw std::system_error(errno, std::system_category());
+        }
+    }
+
     // Runs in a separate kernel thread
     size_t run()
     {
-        if (!is_uncompressed) {
-            std::span<std::byte> decompressed;
-            auto undecompressed = monad::make_scope_exit([&]() noexcept {
-                if (decompressed.data() != nullptr) {
-                    ::munmap(decompressed.data(), decompressed.size());
-                }
-            });
-            if (nonchunkstorage.empty()) {
-                auto const decompressed_len = ZSTD_getFrameContentSize(
-                    compressed.data(), compressed.size());
-                if (use_faster_memory_mode) {
-                    decompressed = {
-                        (std::byte *)::mmap(
-                            nullptr,
-                            decompressed_len,
-                            PROT_READ | PROT_WRITE,
-                            MAP_PRIVATE | MAP_ANONYMOUS,
-                            -1,
-                            0),
-                        size_t(decompressed_len)};
-                    if (decompressed.data() == MAP_FAILED) {
-                        throw std::system_error(errno, std::system_category());
-                    }
-                }
-                else {
-                    // We don't have enough physical RAM, so use
-                    // files as temporary backing storage
-                    int const fd = monad::async::make_temporary_inode();
-                    if (fd == -1) {
-                        throw std::system_error(errno, std::system_category());
-                    }
-                    if (-1 == ftruncate(fd, off_t(decompressed_len))) {
-                        throw std::system_error(errno, std::system_category());
-                    }
-                    decompressed = {
-                        (std::byte *)::mmap(
-                            nullptr,
-                            decompressed_len,
-                            PROT_READ | PROT_WRITE,
-                            MAP_SHARED,
-                            fd,
-                            0),
-                        size_t(decompressed_len)};
-                    if (decompressed.data() == MAP_FAILED) {
-                        throw std::system_error(errno, std::system_category());
-                    }
-                    ::close(fd);
-                }
-            }
-            else {
-                undecompressed.release();
-                decompressed = {nonchunkstorage};
+        if (!nonchunkstorage.empty()) {
+            // The triedb metadata is small, decompress it in one go
+            if (is_uncompressed) {
+                memcpy(
+                    nonchunkstorage.data(),
+                    compressed.data(),
+                    compressed.size());
+                return compressed.size();
             }
-
             auto const written = ZSTD_decompress(
-                decompressed.data(),
-                decompressed.size(),
+                nonchunkstorage.data(),
+                nonchunkstorage.size(),
                 compressed.data(),
                 compressed.size());
             if (ZSTD_isError(written)) {
-                throw std::runtime_error("ZSTD compression failed");
+                throw std::runtime_error("ZSTD decompression failed");
             }
-            if (nonchunkstorage.empty()) {
-                auto [wfd, offset] = chunk_ptr->write_fd(written);
-                if (::pwrite(
-                        wfd,
-                        decompressed.data(),
-                        decompressed.size(),
-                        off_t(offset)) < 0) {
-                    throw std::system_error(errno, std::system_category());
-                }
+            return written;
+        }
+        auto const decompressed_len =
+            is_uncompressed ? compressed.size()
+                            : size_t(ZSTD_getFrameContentSize(
+                                  compressed.data(), compressed.size()));
+        auto [wfd, offset] = chunk_ptr->write_fd(decompressed_len);
+        if (direct_fd != -1 &&
+            (offset & ((1ULL << DIRECT_IO_ALIGNMENT_BITS) - 1)) == 0) {
+            wfd = direct_fd;
+        }
+        auto *const window = (std::byte *)aligned_alloc(
+            1ULL << DIRECT_IO_ALIGNMENT_BITS, window_bytes);
+        if (window == nullptr) {
+            throw std::bad_alloc();
+        }
+        auto const unwindow =
+            monad::make_scope_exit([&]() noexcept { ::free(window); });
+        size_t written = 0;
+        if (is_uncompressed) {
+            while (written < compressed.size()) {
+                auto const len =
+                    std::min(window_bytes, compressed.size() - written);
+                memcpy(window, compressed.data() + written, len);
+                write_window(wfd, window, len, offset + written);
+                written += len;
             }
             return written;
         }
-        else {
-            if (nonchunkstorage.empty()) {
-                auto [wfd, offset] = chunk_ptr->write_fd(compressed.size());
-                if (::pwrite(
-                        wfd,
-                        compressed.data(),
-                        compressed.size(),
-                        off_t(offset)) < 0) {
-                    throw std::system_error(errno, std::system_category());
-                }
+        ZSTD_DCtx *const dctx = ZSTD_createDCtx();
+        if (dctx == nullptr) {
+            throw std::bad_alloc();
+        }
+        auto const undctx =
+            monad::make_scope_exit([&]() noexcept { ZSTD_freeDCtx(dctx); });
+        ZSTD_inBuffer in{compressed.data(), compressed.size(), 0};
+        for (;;) {
+            ZSTD_outBuffer out{window, window_bytes, 0};
+            auto const remaining = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(remaining)) {
+                throw std::runtime_error("ZSTD decompression failed");
             }
-            else {
-                memcpy(
-                    nonchunkstorage.data(),
-                    compressed.data(),
-                    compressed.size());
+            if (out.pos > 0) {
+                write_window(wfd, window, out.pos, offset + written);
+                written += out.pos;
+            }
+            if (remaining == 0) {
+                break;
             }
-            return compressed.size();
+            if (out.pos == 0 && in.pos == in.size) {
+                throw std::runtime_error("ZSTD frame is truncated");
+            }
+        }
+        if (written != decompressed_len) {
+            throw std::runtime_error("ZSTD frame content size mismatch");
         }
+        return written;
     }
 };
 
@@ -330,7 +339,7 @@ struct chunk_info_archive_t
     }
 
     // Runs in a separate kernel thread
-    void run(int const compression_level)
+    void run(int const compression_level, int const compression_workers)
     {
         int const fd = monad::async::make_temporary_inode();
         if (fd == -1) {
@@ -370,12 +379,27 @@ struct chunk_info_archive_t
             179.56 input.
 
             */
-            auto const written = ZSTD_compress(
+            ZSTD_CCtx *const cctx = ZSTD_createCCtx();
+            if (cctx == nullptr) {
+                throw std::bad_alloc();
+            }
+            auto const uncctx = monad::make_scope_exit(
+                [&]() noexcept { ZSTD_freeCCtx(cctx); });
+            if (ZSTD_isError(ZSTD_CCtx_setParameter(
+                    cctx, ZSTD_c_compressionLevel, compression_level)) ||
+                ZSTD_isError(ZSTD_CCtx_setParameter(
+                    cctx, ZSTD_c_nbWorkers, compression_workers))) {
+                throw std::runtime_error("ZSTD parameters rejected");
+            }
+            // Workers split the chunk into jobs and compress them in
+            // parallel, still producing a single frame with its content
+            // size recorded
+            auto const written = ZSTD_compress2(
+                cctx,
                 compressed.data(),
                 compressed.size(),
                 uncompressed.data(),
-                uncompressed.size(),
-                compression_level);
+                uncompressed.size());
             if (ZSTD_isError(written)) {
                 throw std::runtime_error("ZSTD compression failed");
             }
@@ -406,6 +430,8 @@ struct impl_t
     std::filesystem::path restore_database;
     std::vector<std::filesystem::path> storage_paths;
     int compression_level = 3;
+    int compression_workers = 0;
+    size_t memory_limit_mb = 0;
 
     std::optional<MONAD_ASYNC_NAMESPACE::storage_pool> pool;
 
@@ -419,6 +445,13 @@ public:
     {
     }
 
+    // Peak memory archive and restore may use, by default half of RAM
+    size_t memory_limit_bytes() const noexcept
+    {
+        return (memory_limit_mb != 0) ? (memory_limit_mb << 20)
+                                      : (total_physical_memory_bytes / 2);
+    }
+
     void cli_ask_question(char const *msg)
     {
         if (!no_prompt) {
@@ -480,6 +513,43 @@ public:
         return total_used;
     }
 
+    // With several storages, show how each list's chunks are spread across
+    // them, which is what chunk placement balances
+    void print_device_placement(MONAD_MPT_NAMESPACE::UpdateAuxImpl &aux)
+    {
+        auto const devices = pool->devices();
+        if (devices.size() < 2) {
+            return;
+        }
+        struct counts_t
+        {
+            uint32_t fast{0}, slow{0}, free{0};
+        };
+
+        std::vector<counts_t> counts(devices.size());
+        for (uint32_t id = 0; id < aux.io->chunk_count(); id++) {
+            auto &c = counts[pool->device_index(pool->seq, id)];
+            auto const *ci = aux.db_metadata()->at(id);
+            if (ci->in_fast_list) {
+                c.fast++;
+            }
+            else if (ci->in_slow_list) {
+                c.slow++;
+            }
+            else {
+                c.free++;
+            }
+        }
+        cout << "MPT database chunks per storage:\n"
+                "      Fast      Slow      Free  Path";
+        for (size_t n = 0; n < devices.size(); n++) {
+            cout << "\n" << std::setw(10) << counts[n].fast << std::setw(10)
+                 << counts[n].slow << std::setw(10) << counts[n].free << "  "
+                 << devices[n].current_path();
+        }
+        cout << std::endl;
+    }
+
     void print_db_history_summary(MONAD_MPT_NAMESPACE::UpdateAuxImpl &aux)
     {
         cout << "MPT database has "
@@ -497,6 +567,10 @@ public:
              << aux.get_latest_finalized_version() << ", latest verified is "
              << aux.get_latest_verified_version() << ", auto expire version is "
              << aux.get_auto_expire_version_metadata() << "\n";
+        auto const backlog = aux.compaction_backlog();
+        cout << "     Compaction backlog is "
+             << print_bytes(backlog.fast_bytes) << " in fast ring, "
+             << print_bytes(backlog.slow_bytes) << " in slow ring.\n";
     }
 
     void do_restore_database()
@@ -684,29 +758,50 @@ public:
                 }
             }
         }
-        if (max_decompressed_len * true_hardware_concurrency <=
-            total_physical_memory_bytes / 2) {
-            cout << "\nAs maximum RAM consumption used by "
-                    "decompression ("
-                 << print_bytes(
-                        max_decompressed_len * true_hardware_concurrency)
-                 << ") is less than half the physical memory of the "
-                    "machine ("
-                 << print_bytes(total_physical_memory_bytes)
-                 << "), enabling fast decompression mode." << std::endl;
-            for (auto &i : todecompress) {
-                i.use_faster_memory_mode = true;
+        // Each decompression worker holds one window of decompressed output,
+        // so the operator's memory limit bounds workers times window size
+        size_t const memory_limit = memory_limit_bytes();
+        size_t restore_concurrency = true_hardware_concurrency;
+        size_t window_bytes = std::min(
+            MAX_RESTORE_WINDOW_BYTES,
+            std::bit_ceil(std::max(max_decompressed_len, size_t(1))));
+        while (restore_concurrency * window_bytes > memory_limit &&
+               window_bytes > MIN_RESTORE_WINDOW_BYTES) {
+            window_bytes /= 2;
+        }
+        window_bytes = std::max(window_bytes, MIN_RESTORE_WINDOW_BYTES);
+        restore_concurrency = std::clamp(
+            memory_limit / window_bytes, size_t(1), restore_concurrency);
+        cout << "\nDecompressing with " << restore_concurrency
+             << " workers each staging output through "
+             << print_bytes(window_bytes) << ", at most "
+             << print_bytes(restore_concurrency * window_bytes)
+             << " of memory." << std::endl;
+
+        // Write decompressed chunks with O_DIRECT where the storage allows
+        // it, so restoring doesn't evict everything else from the page cache
+        std::vector<int> direct_fds;
+        auto const undirect_fds = monad::make_scope_exit([&]() noexcept {
+            for (int const dfd : direct_fds) {
+                if (dfd != -1) {
+                    ::close(dfd);
+                }
             }
+        });
+        for (auto const &device : pool->devices()) {
+            direct_fds.push_back(
+                (device.is_file() || device.is_block_device())
+                    ? ::open(
+                          device.current_path().c_str(),
+                          O_WRONLY | O_DIRECT | O_CLOEXEC)
+                    : -1);
         }
-        else {
-            cout << "\nAs maximum RAM consumption used by "
-                    "decompression ("
-                 << print_bytes(
-                        max_decompressed_len * true_hardware_concurrency)
-                 << ") is more than than half the physical memory of the "
-                    "machine ("
-                 << print_bytes(total_physical_memory_bytes)
-                 << "), using slow decompression mode." << std::endl;
+        for (auto &i : todecompress) {
+            i.window_bytes = window_bytes;
+            if (i.chunk_ptr) {
+                i.direct_fd =
+                    direct_fds[pool->device_index(i.type, i.chunk_id)];
+            }
         }
 
         // Set up an empty triedb into the pool
@@ -767,7 +862,7 @@ public:
                     done++;
                 }
                 else {
-                    if (max_concurrency < true_hardware_concurrency) {
+                    if (max_concurrency < restore_concurrency) {
                         if (!i.decompression_thread.valid()) {
                             i.decompression_thread =
                                 std::async(std::launch::async, [i = &i] {
@@ -1091,6 +1186,40 @@ public:
             [&]() noexcept { ::unlink(archive_database.c_str()); });
         auto unfd2 = monad::make_scope_exit([&]() noexcept { ::close(fd); });
 
+        if (compression_level != 0 && compression_workers > 0) {
+            ZSTD_CCtx *const cctx = ZSTD_createCCtx();
+            if (cctx == nullptr) {
+                throw std::bad_alloc();
+            }
+            if (ZSTD_isError(ZSTD_CCtx_setParameter(
+                    cctx, ZSTD_c_nbWorkers, compression_workers))) {
+                cerr << "WARNING: zstd was built without multithreading, "
+                        "ignoring --compression-workers"
+                     << std::endl;
+                compression_workers = 0;
+            }
+            ZSTD_freeCCtx(cctx);
+        }
+        // Half the hardware threads compress, split between chunks in
+        // flight and zstd workers within each chunk. Each chunk in flight
+        // holds a compressed copy of up to a chunk's capacity.
+        size_t const chunk_bytes =
+            pool->activate_chunk(monad::async::storage_pool::seq, 0)
+                ->capacity();
+        size_t const archive_concurrency = std::clamp(
+            std::min(
+                std::thread::hardware_concurrency() /
+                    2 /* deliberately not true_hardware_concurrency */ /
+                    size_t(std::max(compression_workers, 1)),
+                memory_limit_bytes() / chunk_bytes),
+            size_t(1),
+            size_t(std::max(std::thread::hardware_concurrency(), 1u)));
+        cout << "Compressing " << archive_concurrency << " chunks at a time";
+        if (compression_workers > 0) {
+            cout << " with " << compression_workers << " zstd workers each";
+        }
+        cout << "." << std::endl;
+
         {
             struct statfs statfs;
             if (-1 == ::fstatfs(fd, &statfs)) {
@@ -1111,12 +1240,7 @@ public:
                 cli_ask_question(ss.str().c_str());
             }
 
-            auto const total_used2 =
-                std::thread::hardware_concurrency() /
-                2 /* deliberately not
-                     true_hardware_concurrency */
-                * pool->activate_chunk(monad::async::storage_pool::seq, 0)
-                      ->capacity();
+            auto const total_used2 = archive_concurrency * chunk_bytes;
             int const tempfd = monad::async::make_temporary_inode();
             if (tempfd == -1) {
                 throw std::system_error(errno, std::system_category());
@@ -1209,7 +1333,7 @@ public:
                 }
                 i.compression_thread =
                     std::async(std::launch::async, [i = &i, this] {
-                        i->run(compression_level);
+                        i->run(compression_level, compression_workers);
                     });
             };
 
@@ -1262,10 +1386,7 @@ public:
                 size_t max_concurrency = 0;
                 for (auto it2 = it;
                      it2 != tocompress.end() &&
-                     max_concurrency < std::thread::hardware_concurrency() /
-                                           2 /* deliberately not
-                                                true_hardware_concurrency */
-                     ;
+                     max_concurrency < archive_concurrency;
                      ++it2, max_concurrency++) {
                     chunk_info_archive_t &i = **it2;
                     if (i.uncompressed_storage == nullptr) {
@@ -1451,6 +1572,17 @@ opened.
                 "zstd compression to use during archival (default is 3, 0 "
                 "disables, negative values are ultra fast, positive values "
                 "past about 10 get real slow).");
+            cli.add_option(
+                "--compression-workers",
+                impl.compression_workers,
+                "zstd worker threads compressing each chunk during archival "
+                "(default is 0, which compresses each chunk on one thread and "
+                "instead compresses more chunks at a time).");
+            cli.add_option(
+                "--memory-limit",
+                impl.memory_limit_mb,
+                "peak memory in Mb that archival and restoration may use for "
+                "chunks in flight (default is half of physical memory).");
             cli.add_flag(
                 "--debug",
                 impl.debug_printing,
@@ -1580,6 +1712,7 @@ opened.
                 aux, aux.db_metadata()->slow_list_begin(), "Slow", &impl.slow);
             impl.print_list_info(
                 aux, aux.db_metadata()->free_list_begin(), "Free");
+            impl.print_device_placement(aux);
             impl.print_db_history_summary(aux);
 
             if (impl.reset_history_length) {
@@ -34,6 +34,14 @@ MONAD_MPT_NAMESPACE_BEGIN
 unsigned encode_two_pieces(
     unsigned char *const dest, NibblesView const path,
     byte_string_view const second, bool const has_value)
+{
+    auto const rlp = encode_two_pieces_rlp(path, second, has_value);
+    return to_node_reference({rlp.data(), rlp.size()}, dest);
+}
+
+byte_string encode_two_pieces_rlp(
+    NibblesView const path, byte_string_view const second,
+    bool const has_value)
 {
     constexpr size_t max_compact_encode_size = KECCAK256_SIZE + 1;
 
@@ -60,9 +68,7 @@ unsigned encode_two_pieces(
 
     byte_string rlp(rlp::list_length(concat_len), 0);
     rlp::encode_list(rlp, {concat_rlp.data(), concat_rlp.size()});
-    auto ret = to_node_reference({rlp.data(), rlp.size()}, dest);
-    // free any long array allocated on heap
-    return ret;
+    return rlp;
 }
 
 std::span<unsigned char> encode_empty_string(std::span<unsigned char> result)
@@ -17,6 +17,7 @@
 
 #include <category/core/assert.h>
 #include <category/core/byte_string.hpp>
+#include <category/core/keccak.hpp>
 #include <category/core/rlp/encode.hpp>
 
 #include <category/core/mem/allocators.hpp>
@@ -27,6 +28,8 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <span>
 
 MONAD_MPT_NAMESPACE_BEGIN
@@ -61,6 +64,10 @@ unsigned encode_two_pieces(
     unsigned char *const dest, NibblesView const path,
     byte_string_view const second, bool const has_value = false);
 
+// The rlp that encode_two_pieces() takes the node reference of
+byte_string encode_two_pieces_rlp(
+    NibblesView path, byte_string_view second, bool has_value = false);
+
 struct Compute
 {
     virtual ~Compute() = default;
@@ -75,6 +82,18 @@ struct Compute
     //! compute data of a trie rooted at node, put data to first argument and
     //! return data length
     virtual unsigned compute(unsigned char *buffer, Node *node) = 0;
+
+    //! compute the data of finalized sibling children as `compute` does;
+    //! overridden by computes that hash several node references at once
+    virtual void compute_siblings(std::span<ChildData *const> children)
+    {
+        for (ChildData *const child : children) {
+            auto const length = compute(child->data, child->ptr.get());
+            MONAD_DEBUG_ASSERT(length <= std::numeric_limits<uint8_t>::max());
+            child->len = static_cast<uint8_t>(length);
+            child->pending_compute = nullptr;
+        }
+    }
 };
 
 template <typename T>
@@ -156,29 +175,55 @@ struct MerkleComputeBase : Compute
             state.len = 0;
             return len;
         }
-        unsigned char branch_str_rlp[max_branch_rlp_size];
-        auto result = encode_16_children(node, {branch_str_rlp});
-        // encode empty value string
-        result = encode_empty_string(result);
-
-        auto const concat_len =
-            static_cast<size_t>(result.data() - branch_str_rlp);
-        MONAD_ASSERT(concat_len <= max_branch_rlp_size);
-        auto const branch_rlp_len = rlp::list_length(concat_len);
-        MONAD_DEBUG_ASSERT(branch_rlp_len <= max_branch_rlp_size);
-
         unsigned char branch_rlp[max_branch_rlp_size];
-        rlp::encode_list(
-            branch_rlp, byte_string_view{branch_str_rlp, concat_len});
-        return to_node_reference({branch_rlp, branch_rlp_len}, buffer);
+        return to_node_reference(
+            {branch_rlp, encode_branch_rlp_(branch_rlp, node)}, buffer);
     }
 
     virtual unsigned
-    compute(unsigned char *const buffer, Node *const node) override
+    compute(unsigned char *const buffer, Node *const node) override final
+    {
+        return to_node_reference(node_rlp(node), buffer);
+    }
+
+    // Hashes the references of the siblings together, four at a time
+    virtual void
+    compute_siblings(std::span<ChildData *const> const children) override
+    {
+        MONAD_DEBUG_ASSERT(children.size() <= 16);
+        byte_string rlps[16];
+        byte_string_view in[16];
+        hash256 out[16];
+        ChildData *hashed[16];
+        size_t n = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            ChildData &child = *children[i];
+            rlps[i] = node_rlp(child.ptr.get());
+            child.pending_compute = nullptr;
+            if (rlps[i].size() >= KECCAK256_SIZE) {
+                in[n] = rlps[i];
+                hashed[n++] = &child;
+            }
+            else {
+                std::memcpy(child.data, rlps[i].data(), rlps[i].size());
+                child.len = static_cast<uint8_t>(rlps[i].size());
+            }
+        }
+        keccak256(std::span{in, n}, std::span{out, n});
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(hashed[i]->data, out[i].bytes, KECCAK256_SIZE);
+            hashed[i]->len = KECCAK256_SIZE;
+        }
+    }
+
+protected:
+    detail::InternalMerkleState state{};
+
+    //! the rlp of the node whose reference is the node's data in its parent
+    virtual byte_string node_rlp(Node *const node)
     {
         if (node->has_value()) {
-            return encode_two_pieces(
-                buffer,
+            return encode_two_pieces_rlp(
                 node->path_nibble_view(),
                 TComputeLeafData::compute(*node),
                 true);
@@ -187,14 +232,32 @@ struct MerkleComputeBase : Compute
         if (node->has_path()) {
             unsigned char reference[KECCAK256_SIZE];
             unsigned len = compute_branch(reference, node);
-            return encode_two_pieces(
-                buffer, node->path_nibble_view(), {reference, len}, false);
+            return encode_two_pieces_rlp(
+                node->path_nibble_view(), {reference, len}, false);
         }
-        return compute_branch(buffer, node);
+        MONAD_DEBUG_ASSERT(!state.len);
+        unsigned char branch_rlp[max_branch_rlp_size];
+        return {branch_rlp, encode_branch_rlp_(branch_rlp, node)};
     }
 
-protected:
-    detail::InternalMerkleState state{};
+    unsigned encode_branch_rlp_(unsigned char *const dest, Node *const node)
+    {
+        unsigned char branch_str_rlp[max_branch_rlp_size];
+        auto result = encode_16_children(node, {branch_str_rlp});
+        // encode empty value string
+        result = encode_empty_string(result);
+
+        auto const concat_len =
+            static_cast<size_t>(result.data() - branch_str_rlp);
+        MONAD_ASSERT(concat_len <= max_branch_rlp_size);
+        auto const branch_rlp_len = rlp::list_length(concat_len);
+        MONAD_DEBUG_ASSERT(branch_rlp_len <= max_branch_rlp_size);
+
+        rlp::encode_list(
+            {dest, max_branch_rlp_size},
+            byte_string_view{branch_str_rlp, concat_len});
+        return static_cast<unsigned>(branch_rlp_len);
+    }
 
     unsigned compute_hash_with_extra_nibble_to_state_(ChildData &single_child)
     {
@@ -281,6 +281,37 @@ Node::UniquePtr copy_trie_impl(
     return root;
 }
 
+void load_copy_path_blocking(
+    UpdateAuxImpl const &aux, Node &root, NibblesView const path,
+    uint64_t const version)
+{
+    Node *node = &root;
+    unsigned prefix_index = 0;
+    while (true) {
+        auto const node_path = node->path_nibble_view();
+        auto const rest = path.substr(prefix_index);
+        if (rest.nibble_size() <= node_path.nibble_size() ||
+            !rest.starts_with(node_path)) {
+            return;
+        }
+        prefix_index += node_path.nibble_size();
+        auto const nibble = path.get(prefix_index++);
+        if (!(node->mask & (1u << nibble))) {
+            return;
+        }
+        auto const index = node->to_child_index(nibble);
+        if (node->next(index) == nullptr) {
+            auto next = read_node_blocking(aux, node->fnext(index), version);
+            if (!next) {
+                // leave it to the copy, which asserts on it
+                return;
+            }
+            node->set_next(index, std::move(next));
+        }
+        node = node->next(index);
+    }
+}
+
 Node::UniquePtr copy_trie_to_dest(
     UpdateAuxImpl &aux, Node &src_root, NibblesView const src_prefix,
     uint64_t const src_version, Node::UniquePtr root,
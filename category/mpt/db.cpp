@@ -29,6 +29,8 @@
 #include <category/core/io/buffers.hpp>
 #include <category/core/io/ring.hpp>
 #include <category/core/result.hpp>
+#include <category/core/synchronization/epoch_domain.hpp>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/mpt/config.hpp>
 #include <category/mpt/db_error.hpp>
 #include <category/mpt/detail/boost_fiber_workarounds.hpp>
@@ -37,8 +39,10 @@
 #include <category/mpt/node.hpp>
 #include <category/mpt/node_cache.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
+#include <category/mpt/range_cursor.hpp>
 #include <category/mpt/traverse.hpp>
 #include <category/mpt/trie.hpp>
+#include <category/mpt/trie_diff.hpp>
 #include <category/mpt/update.hpp>
 #include <category/mpt/util.hpp>
 
@@ -47,6 +51,8 @@
 
 #include <quill/Quill.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cerrno>
 #include <chrono>
@@ -54,12 +60,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <span>
 #include <system_error>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -82,6 +93,19 @@ namespace detail
         {
         }
     };
+
+    struct loaded_nodes_header
+    {
+        static constexpr uint64_t MAGIC = 0x314e4c44414e4f4d; // "MONADLN1"
+
+        uint64_t magic;
+        uint64_t version;
+        chunk_offset_t root_offset;
+        uint64_t count;
+    };
+
+    static_assert(sizeof(loaded_nodes_header) == 32);
+    static_assert(std::is_trivially_copyable_v<loaded_nodes_header>);
 }
 
 struct Db::Impl
@@ -93,12 +117,38 @@ struct Db::Impl
     virtual void upsert_fiber_blocking(
         UpdateList &&, uint64_t, bool enable_compaction, bool can_write_to_fast,
         bool write_root) = 0;
+    virtual void build_sorted_fiber_blocking(
+        std::function<void(SortedTrieBuilder &)> const &fill, uint64_t version,
+        bool can_write_to_fast, bool write_root) = 0;
     virtual void copy_trie_fiber_blocking(
         uint64_t src_version, NibblesView src, uint64_t dest_version,
         NibblesView dest, bool blocked_by_write = true) = 0;
+
+    virtual void
+    copy_tries_fiber_blocking(std::span<VersionTrieCopy const> const copies)
+    {
+        for (auto const &copy : copies) {
+            copy_trie_fiber_blocking(
+                copy.version, copy.src, copy.version, copy.dest);
+        }
+    }
+
     virtual find_cursor_result_type find_fiber_blocking(
         NodeCursor const &root, NibblesView const &key, uint64_t version) = 0;
-    virtual size_t prefetch_fiber_blocking() = 0;
+
+    virtual void find_many_fiber_blocking(
+        NodeCursor const &root, std::span<NibblesView const> const keys,
+        uint64_t const version,
+        std::span<find_cursor_result_type> const results)
+    {
+        MONAD_ASSERT(keys.size() == results.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            results[i] = find_fiber_blocking(root, keys[i], version);
+        }
+    }
+
+    virtual size_t
+    prefetch_fiber_blocking(std::span<chunk_offset_t const> hint) = 0;
     virtual NodeCursor load_root_for_version(uint64_t version) = 0;
     virtual size_t poll(bool blocking, size_t count) = 0;
     virtual bool traverse_fiber_blocking(
@@ -108,24 +158,51 @@ struct Db::Impl
     move_trie_version_fiber_blocking(uint64_t src, uint64_t dest) = 0;
     virtual void update_finalized_version(uint64_t) = 0;
     virtual void update_verified_version(uint64_t) = 0;
+    virtual void
+    update_finalized_and_verified_version(uint64_t, uint64_t) = 0;
     virtual uint64_t get_latest_finalized_version() const = 0;
     virtual uint64_t get_latest_verified_version() const = 0;
 };
 
+namespace
+{
+    void enable_adaptive_read_io_limit(async::AsyncIO &io, auto const &options)
+    {
+        if (options.read_io_target_p99.has_value() &&
+            options.concurrent_read_io_limit > 0) {
+            async::ReadIOLimitController::Config config;
+            config.target_p99 = *options.read_io_target_p99;
+            config.max_limit = options.concurrent_read_io_limit;
+            config.min_limit = std::min(config.min_limit, config.max_limit);
+            io.enable_adaptive_read_io_limit(config);
+        }
+    }
+
+    monad::io::RingConfig
+    read_only_ring_config(ReadOnlyOnDiskDbConfig const &options)
+    {
+        monad::io::RingConfig config{
+            options.uring_entries, false, options.sq_thread_cpu};
+        config.enable_big_entries = options.nvme_passthrough;
+        return config;
+    }
+}
+
 AsyncIOContext::AsyncIOContext(ReadOnlyOnDiskDbConfig const &options)
-    : pool{[&] -> async::storage_pool {
+    : pool_owner{[&] {
         async::storage_pool::creation_flags pool_options;
         pool_options.open_read_only = true;
         pool_options.disable_mismatching_storage_pool_check =
             options.disable_mismatching_storage_pool_check;
+        pool_options.nvme_passthrough = options.nvme_passthrough;
         MONAD_ASSERT(!options.dbname_paths.empty());
-        return async::storage_pool{
+        return std::make_unique<async::storage_pool>(
             options.dbname_paths,
             async::storage_pool::mode::open_existing,
-            pool_options};
+            pool_options);
     }()}
-    , read_ring{monad::io::RingConfig{
-          options.uring_entries, false, options.sq_thread_cpu}}
+    , pool{*pool_owner}
+    , read_ring{read_only_ring_config(options)}
     , buffers{io::make_buffers_for_read_only(
           read_ring, options.rd_buffers,
           async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE)}
@@ -134,14 +211,15 @@ AsyncIOContext::AsyncIOContext(ReadOnlyOnDiskDbConfig const &options)
     io.set_capture_io_latencies(options.capture_io_latencies);
     io.set_concurrent_read_io_limit(options.concurrent_read_io_limit);
     io.set_eager_completions(options.eager_completions);
+    enable_adaptive_read_io_limit(io, options);
 }
 
 AsyncIOContext::AsyncIOContext(OnDiskDbConfig const &options)
-    : pool{[&] -> async::storage_pool {
+    : pool_owner{[&] {
         auto len = options.file_size_db * 1024 * 1024 * 1024 + 24576;
         if (options.dbname_paths.empty()) {
-            return async::storage_pool{
-                async::use_anonymous_sized_inode_tag{}, len};
+            return std::make_unique<async::storage_pool>(
+                async::use_anonymous_sized_inode_tag{}, len);
         }
         // initialize db file on disk
         for (auto const &dbname_path : options.dbname_paths) {
@@ -158,22 +236,41 @@ AsyncIOContext::AsyncIOContext(OnDiskDbConfig const &options)
                     strerror(errno));
             }
         }
-        return async::storage_pool{
+        return std::make_unique<async::storage_pool>(
             options.dbname_paths,
             options.append ? async::storage_pool::mode::open_existing
-                           : async::storage_pool::mode::truncate};
+                           : async::storage_pool::mode::truncate);
     }()}
+    , pool{*pool_owner}
     , read_ring{{options.uring_entries, options.enable_io_polling, options.sq_thread_cpu}}
     , write_ring{io::RingConfig{options.wr_buffers}}
     , buffers{io::make_buffers_for_segregated_read_write(
           read_ring, *write_ring, options.rd_buffers, options.wr_buffers,
-          async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE,
-          async::AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE)}
+          async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE, options.wr_buffer_size)}
+    , io{pool, buffers}
+{
+    io.set_capture_io_latencies(options.capture_io_latencies);
+    io.set_concurrent_read_io_limit(options.concurrent_read_io_limit);
+    io.set_eager_completions(options.eager_completions);
+    enable_adaptive_read_io_limit(io, options);
+}
+
+AsyncIOContext::AsyncIOContext(
+    AsyncIOContext &shared, ReadOnlyOnDiskDbConfig const &options)
+    : pool{shared.pool}
+    , read_ring{read_only_ring_config(options)}
+    , buffers{io::make_buffers_for_read_only(
+          read_ring, options.rd_buffers,
+          async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE)}
     , io{pool, buffers}
 {
+    // `shared` keeps every chunk activated, so this only takes references
+    // and registers their fds with the new ring
+    MONAD_ASSERT(pool.is_read_only());
     io.set_capture_io_latencies(options.capture_io_latencies);
     io.set_concurrent_read_io_limit(options.concurrent_read_io_limit);
     io.set_eager_completions(options.eager_completions);
+    enable_adaptive_read_io_limit(io, options);
 }
 
 class Db::ROOnDiskBlocking final : public Db::Impl
@@ -219,6 +316,13 @@ public:
         MONAD_ABORT()
     }
 
+    virtual void build_sorted_fiber_blocking(
+        std::function<void(SortedTrieBuilder &)> const &, uint64_t, bool,
+        bool) override
+    {
+        MONAD_ABORT()
+    }
+
     virtual find_cursor_result_type find_fiber_blocking(
         NodeCursor const &root, NibblesView const &key,
         uint64_t const version) override
@@ -243,7 +347,8 @@ public:
         MONAD_ABORT()
     }
 
-    virtual size_t prefetch_fiber_blocking() override
+    virtual size_t
+    prefetch_fiber_blocking(std::span<chunk_offset_t const>) override
     {
         MONAD_ABORT()
     }
@@ -293,6 +398,12 @@ public:
         MONAD_ABORT()
     }
 
+    virtual void
+    update_finalized_and_verified_version(uint64_t, uint64_t) override
+    {
+        MONAD_ABORT()
+    }
+
     virtual uint64_t get_latest_finalized_version() const override
     {
         return aux_.get_latest_finalized_version();
@@ -334,6 +445,14 @@ public:
             std::move(root_), machine_, std::move(list), version, false);
     }
 
+    virtual void build_sorted_fiber_blocking(
+        std::function<void(SortedTrieBuilder &)> const &fill,
+        uint64_t const version, bool, bool) override
+    {
+        MONAD_ASSERT(!root_);
+        root_ = aux_.do_build(machine_, fill, version);
+    }
+
     virtual void copy_trie_fiber_blocking(
         uint64_t, NibblesView, uint64_t, NibblesView, bool) override
     {
@@ -346,7 +465,8 @@ public:
         return find_blocking(aux(), root, key, version);
     }
 
-    virtual size_t prefetch_fiber_blocking() override
+    virtual size_t
+    prefetch_fiber_blocking(std::span<chunk_offset_t const>) override
     {
         return 0;
     }
@@ -377,6 +497,11 @@ public:
 
     virtual void update_finalized_version(uint64_t) override {}
 
+    virtual void
+    update_finalized_and_verified_version(uint64_t, uint64_t) override
+    {
+    }
+
     virtual uint64_t get_latest_finalized_version() const override
     {
         return INVALID_BLOCK_NUM;
@@ -402,6 +527,17 @@ struct OnDiskWithWorkerThreadImpl
         bool write_root;
     };
 
+    struct FiberBuildSortedRequest
+    {
+        threadsafe_boost_fibers_promise<Node::UniquePtr> *promise;
+        std::reference_wrapper<StateMachine> sm;
+        std::reference_wrapper<std::function<void(SortedTrieBuilder &)> const>
+            fill;
+        uint64_t version;
+        bool can_write_to_fast;
+        bool write_root;
+    };
+
     struct FiberCopyTrieRequest
     {
         threadsafe_boost_fibers_promise<Node::UniquePtr> *promise;
@@ -414,11 +550,18 @@ struct OnDiskWithWorkerThreadImpl
         bool blocked_by_write;
     };
 
+    struct FiberCopyTriesRequest
+    {
+        threadsafe_boost_fibers_promise<Node::UniquePtr> *promise;
+        std::span<FiberCopyTrieRequest> copies;
+    };
+
     struct FiberLoadAllFromBlockRequest
     {
         threadsafe_boost_fibers_promise<size_t> *promise;
         NodeCursor root;
         std::reference_wrapper<StateMachine> sm;
+        std::span<chunk_offset_t const> hint;
     };
 
     struct FiberTraverseRequest
@@ -452,11 +595,19 @@ struct OnDiskWithWorkerThreadImpl
         uint64_t version;
     };
 
+    struct RODbFindCallbackRequest
+    {
+        find_owning_callback_t *find;
+        OwningNodeCursor start;
+        uint64_t version;
+    };
+
     using Comms = std::variant<
         std::monostate, fiber_find_request_t, FiberUpsertRequest,
         FiberLoadAllFromBlockRequest, FiberTraverseRequest, MoveSubtrieRequest,
         FiberLoadRootVersionRequest, FiberCopyTrieRequest,
-        RODbFiberFindOwningNodeRequest>;
+        RODbFiberFindOwningNodeRequest, FiberBuildSortedRequest,
+        FiberCopyTriesRequest, RODbFindCallbackRequest>;
 
     ::moodycamel::ConcurrentQueue<Comms> comms_;
     std::mutex lock_;
@@ -485,6 +636,22 @@ struct OnDiskWithWorkerThreadImpl
             , async_io(options)
             , aux{&async_io.io, options.fixed_history_length}
         {
+            aux.set_slow_node_compression_level(
+                options.slow_node_compression_level);
+            aux.set_compaction_io_budget(options.compaction_io_budget);
+            if (!options.slow_tier_paths.empty()) {
+                std::vector<bool> slow_tier(options.dbname_paths.size());
+                for (auto const &path : options.slow_tier_paths) {
+                    auto const it =
+                        std::ranges::find(options.dbname_paths, path);
+                    MONAD_ASSERT_PRINTF(
+                        it != options.dbname_paths.end(),
+                        "slow tier path %s is not a db path",
+                        path.c_str());
+                    slow_tier[size_t(it - options.dbname_paths.begin())] = true;
+                }
+                aux.set_slow_tier_devices(std::move(slow_tier));
+            }
             if (options.rewind_to_latest_finalized) {
                 auto const latest_block_id = aux.get_latest_finalized_version();
                 if (latest_block_id == INVALID_BLOCK_NUM) {
@@ -496,15 +663,26 @@ struct OnDiskWithWorkerThreadImpl
             }
         }
 
-        void rodb_run(size_t const node_lru_max_mem)
+        void rodb_run(
+            ShardedNodeCache &node_cache,
+            ShardedNodeCache *const historical_node_cache,
+            uint64_t const historical_version_distance)
         {
             inflight_map_owning_t inflight;
-            NodeCache node_cache{node_lru_max_mem};
 
             ::boost::container::deque<
                 threadsafe_boost_fibers_promise<find_owning_cursor_result_type>>
                 find_owning_cursor_promises;
 
+            auto const cache_for = [&](uint64_t const version)
+                -> ShardedNodeCache & {
+                bool const historical =
+                    historical_node_cache != nullptr &&
+                    version + historical_version_distance <
+                        aux.db_history_max_version();
+                return historical ? *historical_node_cache : node_cache;
+            };
+
             Comms request;
             unsigned did_nothing_count = 0;
             while (!done.load(std::memory_order_acquire)) {
@@ -514,10 +692,11 @@ struct OnDiskWithWorkerThreadImpl
                         find_owning_cursor_promises.emplace_back(
                             std::move(*req->promise));
                         req->promise = &find_owning_cursor_promises.back();
+                        auto &cache = cache_for(req->version);
                         if (req->start.is_valid()) {
                             find_owning_notify_fiber_future(
                                 aux,
-                                node_cache,
+                                cache,
                                 inflight,
                                 *req->promise,
                                 req->start,
@@ -528,12 +707,22 @@ struct OnDiskWithWorkerThreadImpl
                             MONAD_ASSERT(req->key.empty());
                             load_root_notify_fiber_future(
                                 aux,
-                                node_cache,
+                                cache,
                                 inflight,
                                 *req->promise,
                                 req->version);
                         }
                     }
+                    else if (auto *req = std::get_if<11>(&request);
+                             req != nullptr) {
+                        find_owning_notify_callback(
+                            aux,
+                            cache_for(req->version),
+                            inflight,
+                            std::unique_ptr<find_owning_callback_t>{req->find},
+                            req->start,
+                            req->version);
+                    }
                     did_nothing = false;
                 }
                 async_io.io.poll_nonblocking(1);
@@ -541,7 +730,12 @@ struct OnDiskWithWorkerThreadImpl
                 if (boost::fibers::has_ready_fibers()) {
                     did_nothing = false;
                 }
-                if (did_nothing && async_io.io.io_in_flight() > 0) {
+                // When the read ring can be woken, in flight reads and
+                // outstanding requests no longer need spinning on: their
+                // completions wake the blocking poll below
+                bool const ring_wakeable = async_io.io.wake_supported();
+                if (!ring_wakeable && did_nothing &&
+                    async_io.io.io_in_flight() > 0) {
                     did_nothing = false;
                 }
                 while (!find_owning_cursor_promises.empty() &&
@@ -549,7 +743,7 @@ struct OnDiskWithWorkerThreadImpl
                            .future_has_been_destroyed()) {
                     find_owning_cursor_promises.pop_front();
                 }
-                if (!find_owning_cursor_promises.empty()) {
+                if (!ring_wakeable && !find_owning_cursor_promises.empty()) {
                     did_nothing = false;
                 }
                 if (did_nothing) {
@@ -558,7 +752,20 @@ struct OnDiskWithWorkerThreadImpl
                 else {
                     did_nothing_count = 0;
                 }
-                if (did_nothing_count > 1000000) {
+                if (ring_wakeable && did_nothing_count > 1000) {
+                    sleeping.store(true, std::memory_order_seq_cst);
+                    /* Sleep in io_uring until a read completes or a
+                     requester calls wake(). Pulse Boost.Fiber every second at
+                     most for the same reason as below.
+                     */
+                    if (!done.load(std::memory_order_acquire) &&
+                        parent->comms_.size_approx() == 0) {
+                        async_io.io.poll_blocking_for(std::chrono::seconds(1));
+                    }
+                    sleeping.store(false, std::memory_order_release);
+                    did_nothing_count = 0;
+                }
+                else if (did_nothing_count > 1000000) {
                     std::unique_lock g(parent->lock_);
                     sleeping.store(true, std::memory_order_release);
                     /* Very irritatingly, Boost.Fiber may have fibers scheduled
@@ -576,6 +783,16 @@ struct OnDiskWithWorkerThreadImpl
             }
         }
 
+        // Threadsafe. Wakes the worker if it is sleeping, either in io_uring
+        // or on the condition variable
+        void wake()
+        {
+            if (!async_io.io.wake()) {
+                std::unique_lock const g(parent->lock_);
+                parent->cond_.notify_one();
+            }
+        }
+
         // Runs in the triedb worker thread
         void rwdb_run()
         {
@@ -634,7 +851,8 @@ struct OnDiskWithWorkerThreadImpl
                             std::move(*req->promise));
                         req->promise = &prefetch_promises.back();
                         req->promise->set_value(
-                            mpt::load_all(aux, req->sm, req->root));
+                            mpt::load_all(
+                                aux, req->sm, req->root, req->hint));
                     }
                     else if (auto *req = std::get_if<4>(&request);
                              req != nullptr) {
@@ -691,6 +909,37 @@ struct OnDiskWithWorkerThreadImpl
                             req->blocked_by_write);
                         req->promise->set_value(std::move(root));
                     }
+                    else if (auto *req = std::get_if<9>(&request);
+                             req != nullptr) {
+                        // share the same promise type as upsert
+                        upsert_promises.emplace_back(std::move(*req->promise));
+                        req->promise = &upsert_promises.back();
+                        req->promise->set_value(aux.do_build(
+                            req->sm,
+                            req->fill,
+                            req->version,
+                            req->can_write_to_fast,
+                            req->write_root));
+                    }
+                    else if (auto *req = std::get_if<10>(&request);
+                             req != nullptr) {
+                        // share the same promise type as upsert
+                        upsert_promises.emplace_back(std::move(*req->promise));
+                        req->promise = &upsert_promises.back();
+                        Node::UniquePtr root;
+                        for (auto &copy : req->copies) {
+                            root = copy_trie_to_dest(
+                                aux,
+                                copy.src_root,
+                                copy.src,
+                                copy.src_version,
+                                std::move(copy.dest_root),
+                                copy.dest,
+                                copy.dest_version,
+                                copy.blocked_by_write);
+                        }
+                        req->promise->set_value(std::move(root));
+                    }
                     did_nothing = false;
                 }
                 async_io.io.poll_nonblocking(1);
@@ -782,7 +1031,22 @@ struct OnDiskWithWorkerThreadImpl
                 worker_ = std::make_unique<DbAsyncWorker>(this, options);
                 cond_.notify_one();
             }
-            worker_->rodb_run(options.node_lru_max_mem);
+            auto const node_cache =
+                options.node_cache
+                    ? options.node_cache
+                    : std::make_shared<ShardedNodeCache>(
+                          ShardedNodeCache::single_threaded,
+                          options.node_lru_max_mem);
+            std::unique_ptr<ShardedNodeCache> const historical_node_cache =
+                options.historical_node_lru_max_mem != 0
+                    ? std::make_unique<ShardedNodeCache>(
+                          ShardedNodeCache::single_threaded,
+                          options.historical_node_lru_max_mem)
+                    : nullptr;
+            worker_->rodb_run(
+                *node_cache,
+                historical_node_cache.get(),
+                options.historical_version_distance);
             std::unique_lock const g(lock_);
             worker_.reset();
         })
@@ -800,6 +1064,7 @@ struct OnDiskWithWorkerThreadImpl
             std::unique_lock const g(lock_);
             worker_->done.store(true, std::memory_order_release);
             cond_.notify_one();
+            worker_->async_io.io.wake();
         }
         worker_thread_.join();
         aux_ = nullptr;
@@ -870,6 +1135,36 @@ public:
         return fut.get();
     }
 
+    // threadsafe
+    virtual void find_many_fiber_blocking(
+        NodeCursor const &start, std::span<NibblesView const> const keys,
+        uint64_t, std::span<find_cursor_result_type> const results) override
+    {
+        MONAD_ASSERT(keys.size() == results.size());
+        // Enqueue every request before waiting on any, so the worker issues
+        // all missing node reads together and its inflight map coalesces
+        // reads of nodes shared between keys
+        std::vector<threadsafe_boost_fibers_promise<find_cursor_result_type>>
+            promises(keys.size());
+        std::vector<monad::detail::threadsafe_boost_fibers_future<
+            find_cursor_result_type>>
+            futs;
+        futs.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            futs.emplace_back(promises[i].get_future());
+            comms_.enqueue(fiber_find_request_t{
+                .promise = &promises[i], .start = start, .key = keys[i]});
+        }
+        // promises are racily emptied after this point
+        if (worker_->sleeping.load(std::memory_order_acquire)) {
+            std::unique_lock const g(lock_);
+            cond_.notify_one();
+        }
+        for (size_t i = 0; i < futs.size(); ++i) {
+            results[i] = futs[i].get();
+        }
+    }
+
     // threadsafe
     virtual void upsert_fiber_blocking(
         UpdateList &&updates, uint64_t const version,
@@ -919,6 +1214,34 @@ public:
         }
     }
 
+    // threadsafe
+    virtual void build_sorted_fiber_blocking(
+        std::function<void(SortedTrieBuilder &)> const &fill,
+        uint64_t const version, bool const can_write_to_fast,
+        bool const write_root) override
+    {
+        MONAD_ASSERT(!root_);
+        threadsafe_boost_fibers_promise<Node::UniquePtr> promise;
+        auto fut = promise.get_future();
+        comms_.enqueue(FiberBuildSortedRequest{
+            .promise = &promise,
+            .sm = machine_,
+            .fill = fill,
+            .version = version,
+            .can_write_to_fast = can_write_to_fast,
+            .write_root = write_root});
+        // promise is racily emptied after this point
+        if (worker_->sleeping.load(std::memory_order_acquire)) {
+            std::unique_lock const g(lock_);
+            cond_.notify_one();
+        }
+        root_ = fut.get();
+        root_version_ = version;
+        if (!write_root) {
+            unflushed_version_ = version;
+        }
+    }
+
     virtual void move_trie_version_fiber_blocking(
         uint64_t const src, uint64_t const dest) override
     {
@@ -936,13 +1259,17 @@ public:
     }
 
     // threadsafe
-    virtual size_t prefetch_fiber_blocking() override
+    virtual size_t
+    prefetch_fiber_blocking(std::span<chunk_offset_t const> const hint) override
     {
         MONAD_ASSERT(root());
         threadsafe_boost_fibers_promise<size_t> promise;
         auto fut = promise.get_future();
         comms_.enqueue(FiberLoadAllFromBlockRequest{
-            .promise = &promise, .root = *root(), .sm = machine_});
+            .promise = &promise,
+            .root = *root(),
+            .sm = machine_,
+            .hint = hint});
         // promise is racily emptied after this point
         if (worker_->sleeping.load(std::memory_order_acquire)) {
             std::unique_lock const g(lock_);
@@ -1022,6 +1349,11 @@ public:
                      aux().get_root_offset_at_version(dest_version);
                  root_offset != INVALID_OFFSET) {
             dest_root = read_node_blocking(aux(), root_offset, dest_version);
+            // the root is ours alone, so its spine is read here rather
+            // than on the write thread
+            if (dest_root) {
+                load_copy_path_blocking(aux(), *dest_root, dest, dest_version);
+            }
         }
 
         threadsafe_boost_fibers_promise<Node::UniquePtr> promise;
@@ -1044,11 +1376,68 @@ public:
         root_version_ = dest_version;
     }
 
+    virtual void copy_tries_fiber_blocking(
+        std::span<VersionTrieCopy const> const copies) override
+    {
+        if (copies.empty()) {
+            return;
+        }
+        // every copy is within its own version, so all the roots are read
+        // up front and the write thread is woken once for the lot
+        std::vector<FiberCopyTrieRequest> requests;
+        requests.reserve(copies.size());
+        for (auto const &copy : copies) {
+            MONAD_ASSERT(
+                requests.empty() ||
+                copy.version > requests.back().dest_version);
+            Node::UniquePtr root{};
+            if (copy.version == root_version_ && root_) {
+                root = std::move(root_);
+            }
+            else {
+                root = read_node_blocking(
+                    aux(),
+                    aux().get_root_offset_at_version(copy.version),
+                    copy.version);
+            }
+            MONAD_ASSERT(root);
+            Node &src_root = *root;
+            requests.push_back(FiberCopyTrieRequest{
+                .promise = nullptr,
+                .src_root = src_root,
+                .src = copy.src,
+                .src_version = copy.version,
+                .dest_root = std::move(root),
+                .dest = copy.dest,
+                .dest_version = copy.version,
+                .blocked_by_write = true});
+        }
+
+        threadsafe_boost_fibers_promise<Node::UniquePtr> promise;
+        auto fut = promise.get_future();
+        comms_.enqueue(
+            FiberCopyTriesRequest{.promise = &promise, .copies = requests});
+        // promise is racily emptied after this point
+        if (worker_->sleeping.load(std::memory_order_acquire)) {
+            std::unique_lock const g(lock_);
+            cond_.notify_one();
+        }
+        root_ = fut.get();
+        root_version_ = copies.back().version;
+    }
+
     virtual void update_finalized_version(uint64_t const version) override
     {
         aux().set_latest_finalized_version(version);
     }
 
+    virtual void update_finalized_and_verified_version(
+        uint64_t const finalized, uint64_t const verified) override
+    {
+        MONAD_ASSERT(verified <= aux().db_history_max_version());
+        aux().set_latest_finalized_and_verified_version(finalized, verified);
+    }
+
     virtual void update_verified_version(uint64_t const version) override
     {
         MONAD_ASSERT(version <= aux().db_history_max_version());
@@ -1066,11 +1455,187 @@ public:
     }
 };
 
+namespace
+{
+    // Reads into `cache` the nodes of `version` within `levels` of its root
+    // that it does not hold. See warm_node_cache_blocking()
+    size_t warm_nodes_blocking(
+        UpdateAux<> &aux, ShardedNodeCache &cache, uint64_t const version,
+        unsigned const levels)
+    {
+        MONAD_ASSERT(aux.is_on_disk());
+        auto const root_offset = aux.get_root_offset_at_version(version);
+        if (root_offset == INVALID_OFFSET) {
+            return 0;
+        }
+        size_t nodes_read = 0;
+        std::vector<chunk_offset_t> level{root_offset};
+        for (unsigned depth = 0; depth <= levels && !level.empty(); ++depth) {
+            // read in disk order to keep the device streaming
+            std::ranges::sort(level, [](auto const &a, auto const &b) {
+                return a.raw() < b.raw();
+            });
+            std::vector<chunk_offset_t> next_level;
+            for (auto const offset : level) {
+                auto const virt_offset = aux.physical_to_virtual(offset);
+                // the root may have been cached by the find that loaded it,
+                // before anything below it
+                auto node = depth == 0 ? cache.find(virt_offset) : nullptr;
+                if (!node) {
+                    if (cache.contains(virt_offset)) {
+                        continue;
+                    }
+                    auto const read =
+                        read_node_blocking(aux, offset, version);
+                    if (!read) {
+                        // the version expired
+                        return nodes_read;
+                    }
+                    node = std::shared_ptr<CacheNode>{
+                        copy_node<CacheNode>(read.get())};
+                    cache.insert(virt_offset, node);
+                    ++nodes_read;
+                }
+                if (depth < levels) {
+                    for (unsigned i = 0; i < node->number_of_children(); ++i) {
+                        next_level.push_back(node->fnext(i));
+                    }
+                }
+            }
+            level = std::move(next_level);
+        }
+        return nodes_read;
+    }
+}
+
 struct RODb::Impl final : public OnDiskWithWorkerThreadImpl
 {
-    Impl(ReadOnlyOnDiskDbConfig const &options)
+    // Decides whether a cache miss is read inline, with a blocking read on
+    // the calling thread, or handed to the worker's async reads. Inline reads
+    // win while they are served from the page cache and few finds run at
+    // once. Under load, or once reads reach the device, batching them on the
+    // worker's ring gives more throughput.
+    class InlineReadPolicy
+    {
+        // an inline read is still made every `probe_interval` misses while
+        // reads are slow, to notice when they are fast again
+        static constexpr uint32_t probe_interval = 64;
+
+        int64_t const max_latency_ns_;
+        unsigned const max_concurrency_;
+        std::atomic<unsigned> active_{0};
+        // moving average of inline read latency. Updates may race, which
+        // only loses a sample
+        std::atomic<int64_t> latency_ns_{0};
+        std::atomic<uint32_t> slow_misses_{0};
+
+    public:
+        InlineReadPolicy(
+            std::chrono::microseconds const max_latency,
+            unsigned const max_concurrency)
+            : max_latency_ns_{std::chrono::nanoseconds{max_latency}.count()}
+            , max_concurrency_{max_concurrency}
+        {
+        }
+
+        bool read_inline()
+        {
+            if (active_.load(std::memory_order_relaxed) > max_concurrency_) {
+                return false;
+            }
+            if (latency_ns_.load(std::memory_order_relaxed) <=
+                max_latency_ns_) {
+                return true;
+            }
+            return slow_misses_.fetch_add(1, std::memory_order_relaxed) %
+                       probe_interval ==
+                   0;
+        }
+
+        void record(std::chrono::nanoseconds const elapsed)
+        {
+            auto const old = latency_ns_.load(std::memory_order_relaxed);
+            latency_ns_.store(
+                old - old / 8 + elapsed.count() / 8,
+                std::memory_order_relaxed);
+        }
+
+        void begin_find()
+        {
+            active_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void end_find()
+        {
+            active_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    // The last root loaded for a version, with the offset it was loaded
+    // from, installed as a whole so readers see the two together. Readers
+    // take a reference to the root under an epoch pin rather than looking
+    // it up in the node cache, where every find would take the lock of the
+    // one shard holding it. A replaced record is freed after a grace
+    // period, and its root once the last cursor on it is gone.
+    struct PublishedRoot
+    {
+        uint64_t version;
+        virtual_chunk_offset_t virt_offset;
+        std::shared_ptr<CacheNode> node;
+    };
+
+    static constexpr size_t PUBLISHED_ROOTS = 16;
+
+    std::shared_ptr<ShardedNodeCache> const node_cache_;
+    bool const has_historical_cache_;
+    uint64_t const historical_version_distance_;
+    std::unique_ptr<InlineReadPolicy> const inline_policy_;
+    unsigned const warm_node_cache_levels_;
+    // versions below this one were warmed, or are not warmed any more
+    std::atomic<uint64_t> next_warm_version_{0};
+    EpochDomain root_epochs_;
+    std::array<std::atomic<PublishedRoot *>, PUBLISHED_ROOTS>
+        published_roots_{};
+
+    static ReadOnlyOnDiskDbConfig
+    with_node_cache(ReadOnlyOnDiskDbConfig options)
+    {
+        // the worker and inline finds on the calling threads share the
+        // cache, so even a single shard has to be locked
+        if (!options.node_cache) {
+            options.node_cache = std::make_shared<ShardedNodeCache>(
+                options.node_lru_max_mem, 1);
+        }
+        return options;
+    }
+
+    // `options` has its node cache set, so the worker and inline finds on
+    // the calling threads share it
+    Impl(ReadOnlyOnDiskDbConfig const &options, std::nullptr_t)
         : OnDiskWithWorkerThreadImpl{options}
+        , node_cache_{options.node_cache}
+        , has_historical_cache_{options.historical_node_lru_max_mem != 0}
+        , historical_version_distance_{options.historical_version_distance}
+        , inline_policy_{
+              options.inline_read_max_latency.has_value()
+                  ? std::make_unique<InlineReadPolicy>(
+                        *options.inline_read_max_latency,
+                        options.inline_read_concurrency)
+                  : nullptr}
+        , warm_node_cache_levels_{options.warm_node_cache_levels}
+    {
+    }
+
+    explicit Impl(ReadOnlyOnDiskDbConfig const &options)
+        : Impl{with_node_cache(options), nullptr}
+    {
+    }
+
+    ~Impl()
     {
+        for (auto &root : published_roots_) {
+            delete root.load(std::memory_order_acquire);
+        }
     }
 
     UpdateAux<> &aux()
@@ -1091,22 +1656,226 @@ struct RODb::Impl final : public OnDiskWithWorkerThreadImpl
         auto fut = promise.get_future();
         comms_.enqueue(req);
         // promise is racily emptied after this point
-        if (worker_->sleeping.load(std::memory_order_acquire)) {
-            std::unique_lock const g(lock_);
-            cond_.notify_one();
+        if (worker_->sleeping.load(std::memory_order_seq_cst)) {
+            worker_->wake();
         }
         return fut.get();
     }
 
+    // whether finds at `version` may run on the calling thread. Versions
+    // the worker reads through the historical cache always go to it
+    bool may_find_inline(uint64_t const version)
+    {
+        return inline_policy_ != nullptr &&
+               !(has_historical_cache_ &&
+                 version + historical_version_distance_ <
+                     aux().db_history_max_version());
+    }
+
+    // the node at `offset` from the cache, or read inline if the policy
+    // allows. Null with `expired` unset if the read is left to the worker
+    std::shared_ptr<CacheNode> load_node_inline(
+        chunk_offset_t const offset, virtual_chunk_offset_t const virt_offset,
+        uint64_t const version, bool &expired)
+    {
+        expired = false;
+        if (auto node = node_cache_->find(virt_offset)) {
+            return node;
+        }
+        if (!inline_policy_->read_inline()) {
+            return nullptr;
+        }
+        auto const begin = std::chrono::steady_clock::now();
+        auto const node = read_node_blocking(aux(), offset, version);
+        inline_policy_->record(std::chrono::steady_clock::now() - begin);
+        // the offset may have been reused while it was read
+        if (!node || aux().physical_to_virtual(offset) != virt_offset) {
+            expired = true;
+            return nullptr;
+        }
+        std::shared_ptr<CacheNode> cached{copy_node<CacheNode>(node.get())};
+        node_cache_->insert(virt_offset, cached);
+        return cached;
+    }
+
+    // Walks `key` from `start` as find_owning_notify_fiber_future() does,
+    // on the calling thread. Returns nullopt at the first miss the policy
+    // leaves to the worker, with `start` and `key` moved to where it stopped.
+    std::optional<find_owning_cursor_result_type> find_inline(
+        OwningNodeCursor &start, NibblesView &key, uint64_t const version)
+    {
+        auto &aux = this->aux();
+        while (true) {
+            if (!aux.version_is_valid_ondisk(version)) {
+                return find_owning_cursor_result_type{
+                    start, find_result::version_no_longer_exist};
+            }
+            auto const node = start.node;
+            unsigned prefix_index = 0;
+            unsigned node_prefix_index = start.prefix_index;
+            if (node_prefix_index < node->path_nibbles_len()) {
+                auto const matched = key.common_prefix_size(
+                    node->path_nibble_view().substr(node_prefix_index));
+                node_prefix_index += matched;
+                prefix_index += matched;
+            }
+            if (node_prefix_index < node->path_nibbles_len()) {
+                return find_owning_cursor_result_type{
+                    OwningNodeCursor{node, node_prefix_index},
+                    prefix_index >= key.nibble_size()
+                        ? find_result::key_ends_earlier_than_node_failure
+                        : find_result::key_mismatch_failure};
+            }
+            if (prefix_index == key.nibble_size()) {
+                return find_owning_cursor_result_type{
+                    OwningNodeCursor{node, node_prefix_index},
+                    find_result::success};
+            }
+            unsigned char const branch = key.get(prefix_index);
+            if (!(node->mask & (1u << branch))) {
+                return find_owning_cursor_result_type{
+                    OwningNodeCursor{node, node_prefix_index},
+                    find_result::branch_not_exist_failure};
+            }
+            auto const offset = node->fnext(node->to_child_index(branch));
+            auto const virt_offset = aux.physical_to_virtual(offset);
+            // version validity check must be after the virtual offset
+            // translation
+            if (!aux.version_is_valid_ondisk(version) ||
+                virt_offset == INVALID_VIRTUAL_OFFSET) {
+                return find_owning_cursor_result_type{
+                    start, find_result::version_no_longer_exist};
+            }
+            bool expired;
+            auto next =
+                load_node_inline(offset, virt_offset, version, expired);
+            if (expired) {
+                return find_owning_cursor_result_type{
+                    OwningNodeCursor{}, find_result::version_no_longer_exist};
+            }
+            if (!next) {
+                start = OwningNodeCursor{node, node_prefix_index};
+                key = key.substr(prefix_index);
+                return std::nullopt;
+            }
+            start = OwningNodeCursor{std::move(next)};
+            key = key.substr(prefix_index + 1);
+        }
+    }
+
+    find_owning_cursor_result_type
+    find(OwningNodeCursor start, NibblesView key, uint64_t const version)
+    {
+        if (may_find_inline(version)) {
+            inline_policy_->begin_find();
+            auto const end = monad::make_scope_exit(
+                [this]() noexcept { inline_policy_->end_find(); });
+            if (auto res = find_inline(start, key, version)) {
+                return std::move(*res);
+            }
+            // still counted as running while the worker finishes it
+            return find_fiber_blocking(start, key, version);
+        }
+        return find_fiber_blocking(start, key, version);
+    }
+
+    // Hands the find to the worker, which calls `done` once it completes
+    // rather than waking a waiting fiber
+    void find_async(
+        OwningNodeCursor start, NibblesView const key, uint64_t const version,
+        std::function<void(find_owning_cursor_result_type)> done)
+    {
+        comms_.enqueue(RODbFindCallbackRequest{
+            .find = new find_owning_callback_t{
+                .key = Nibbles{key}, .done = std::move(done)},
+            .start = std::move(start),
+            .version = version});
+        if (worker_->sleeping.load(std::memory_order_seq_cst)) {
+            worker_->wake();
+        }
+    }
+
+    std::shared_ptr<CacheNode> find_published_root(
+        uint64_t const version, virtual_chunk_offset_t const virt_offset)
+    {
+        auto const g = root_epochs_.pin();
+        PublishedRoot const *const root =
+            published_roots_[version % PUBLISHED_ROOTS].load(
+                std::memory_order_acquire);
+        if (root != nullptr && root->version == version &&
+            root->virt_offset == virt_offset) {
+            return root->node;
+        }
+        return nullptr;
+    }
+
+    void publish_root(
+        uint64_t const version, virtual_chunk_offset_t const virt_offset,
+        std::shared_ptr<CacheNode> node)
+    {
+        PublishedRoot *const old =
+            published_roots_[version % PUBLISHED_ROOTS].exchange(
+                new PublishedRoot{
+                    .version = version,
+                    .virt_offset = virt_offset,
+                    .node = std::move(node)},
+                std::memory_order_acq_rel);
+        if (old != nullptr) {
+            root_epochs_.retire([old] { delete old; });
+        }
+    }
+
+    // Warms the node cache for `version` if it is the latest version and
+    // no other find warmed it first
+    void maybe_warm_node_cache(uint64_t const version)
+    {
+        if (warm_node_cache_levels_ == 0 ||
+            version != aux().db_history_max_version()) {
+            return;
+        }
+        auto next = next_warm_version_.load(std::memory_order_relaxed);
+        do {
+            if (version < next) {
+                return;
+            }
+        }
+        while (!next_warm_version_.compare_exchange_weak(
+            next, version + 1, std::memory_order_relaxed));
+        warm_nodes_blocking(
+            aux(), *node_cache_, version, warm_node_cache_levels_);
+    }
+
     OwningNodeCursor load_root_fiber_blocking(uint64_t version)
     {
         auto const root_offset = aux().get_root_offset_at_version(version);
         if (root_offset == INVALID_OFFSET) {
             return {};
         }
+        auto const virt_offset = aux().physical_to_virtual(root_offset);
+        if (!aux().version_is_valid_ondisk(version) ||
+            virt_offset == INVALID_VIRTUAL_OFFSET) {
+            return {};
+        }
+        if (auto root = find_published_root(version, virt_offset)) {
+            return OwningNodeCursor{std::move(root)};
+        }
+        if (may_find_inline(version)) {
+            bool expired;
+            if (auto root = load_node_inline(
+                    root_offset, virt_offset, version, expired)) {
+                publish_root(version, virt_offset, root);
+                maybe_warm_node_cache(version);
+                return OwningNodeCursor{std::move(root)};
+            }
+            if (expired) {
+                return {};
+            }
+        }
         auto [cursor, result] = find_fiber_blocking({}, {}, version);
         if (result == find_result::success) {
             MONAD_ASSERT(cursor.is_valid());
+            publish_root(version, virt_offset, cursor.node);
+            maybe_warm_node_cache(version);
             return cursor;
         }
         return {};
@@ -1162,8 +1931,7 @@ Result<OwningNodeCursor> RODb::find(
     if (key.empty()) {
         return node_cursor;
     }
-    auto [cursor, result] =
-        impl_->find_fiber_blocking(node_cursor, key, block_id);
+    auto [cursor, result] = impl_->find(node_cursor, key, block_id);
     if (result != find_result::success) {
         return find_result_to_db_error(result);
     }
@@ -1180,6 +1948,38 @@ RODb::find(NibblesView const key, uint64_t const block_id) const
     return find(cursor, key, block_id);
 }
 
+void RODb::find_async(
+    OwningNodeCursor const &node_cursor, NibblesView const key,
+    uint64_t const block_id,
+    std::function<void(Result<OwningNodeCursor>)> done) const
+{
+    MONAD_ASSERT(impl_);
+    if (!node_cursor.is_valid()) {
+        done(DbError::version_no_longer_exist);
+        return;
+    }
+    // the cursor is only copyable from a mutable reference
+    OwningNodeCursor start{node_cursor.node, node_cursor.prefix_index};
+    if (key.empty()) {
+        done(std::move(start));
+        return;
+    }
+    impl_->find_async(
+        std::move(start),
+        key,
+        block_id,
+        [done = std::move(done)](find_owning_cursor_result_type res) {
+            auto &[cursor, result] = res;
+            if (result != find_result::success) {
+                done(find_result_to_db_error(result));
+                return;
+            }
+            MONAD_DEBUG_ASSERT(cursor.is_valid());
+            MONAD_DEBUG_ASSERT(cursor.node->has_value());
+            done(std::move(cursor));
+        });
+}
+
 Db::Db(StateMachine &machine)
     : impl_{std::make_unique<InMemory>(machine)}
 {
@@ -1201,6 +2001,11 @@ Db::~Db() = default;
 Result<NodeCursor>
 Db::find(NodeCursor root, NibblesView const key, uint64_t const block_id) const
 {
+    static LatencyMetric &latency = latency_metric(
+        "monad_mpt_db_find_seconds",
+        "time of a blocking point lookup in the trie, including any reads");
+    ScopedLatency const timer{latency};
+
     MONAD_ASSERT(impl_);
     auto const [it, result] = impl_->find_fiber_blocking(root, key, block_id);
     if (result != find_result::success) {
@@ -1211,6 +2016,52 @@ Db::find(NodeCursor root, NibblesView const key, uint64_t const block_id) const
     return it;
 }
 
+std::vector<Result<NodeCursor>> Db::find_many(
+    NodeCursor root, std::span<NibblesView const> const keys,
+    uint64_t const block_id) const
+{
+    MONAD_ASSERT(impl_);
+    std::vector<find_cursor_result_type> found(keys.size());
+    impl_->find_many_fiber_blocking(root, keys, block_id, found);
+    std::vector<Result<NodeCursor>> results;
+    results.reserve(found.size());
+    for (auto const &[it, result] : found) {
+        if (result != find_result::success) {
+            results.emplace_back(find_result_to_db_error(result));
+            continue;
+        }
+        MONAD_DEBUG_ASSERT(it.node != nullptr);
+        MONAD_DEBUG_ASSERT(it.node->has_value());
+        results.emplace_back(it);
+    }
+    return results;
+}
+
+std::vector<Result<NodeCursor>> Db::find_many(
+    std::span<NibblesView const> const keys, uint64_t const block_id) const
+{
+    MONAD_ASSERT(impl_);
+    auto cursor = impl_->load_root_for_version(block_id);
+    return find_many(cursor, keys, block_id);
+}
+
+RangeCursor Db::range(
+    NodeCursor const root, NibblesView const min, NibblesView const max,
+    uint64_t const block_id) const
+{
+    MONAD_ASSERT(impl_);
+    return RangeCursor{impl_->aux(), root, min, max, block_id};
+}
+
+bool Db::diff(
+    NibblesView const prefix, uint64_t const version_a,
+    uint64_t const version_b, TrieDiffCallback const &callback) const
+{
+    MONAD_ASSERT(impl_);
+    return diff_blocking(
+        impl_->aux(), prefix, version_a, version_b, callback);
+}
+
 NodeCursor Db::load_root_for_version(uint64_t const block_id) const
 {
     MONAD_ASSERT(impl_);
@@ -1273,6 +2124,16 @@ void Db::upsert(
         write_root);
 }
 
+void Db::build_sorted(
+    uint64_t const block_id,
+    std::function<void(SortedTrieBuilder &)> const &fill,
+    bool const can_write_to_fast, bool const write_root)
+{
+    MONAD_ASSERT(impl_);
+    impl_->build_sorted_fiber_blocking(
+        fill, block_id, can_write_to_fast, write_root);
+}
+
 void Db::copy_trie(
     uint64_t const src_version, NibblesView const src,
     uint64_t const dest_version, NibblesView const dest,
@@ -1283,6 +2144,12 @@ void Db::copy_trie(
         src_version, src, dest_version, dest, blocked_by_write);
 }
 
+void Db::copy_tries(std::span<VersionTrieCopy const> const copies)
+{
+    MONAD_ASSERT(impl_);
+    impl_->copy_tries_fiber_blocking(copies);
+}
+
 void Db::move_trie_version_forward(uint64_t const src, uint64_t const dest)
 {
     MONAD_ASSERT(impl_);
@@ -1309,6 +2176,17 @@ bool Db::traverse_blocking(
         impl_->aux(), *cursor.node, machine, block_id);
 }
 
+bool Db::traverse_blocking_parallel(
+    NodeCursor const cursor, TraverseMachine &machine, uint64_t const block_id,
+    unsigned const num_threads,
+    std::function<void(TraverseMachine &)> const &merge)
+{
+    MONAD_ASSERT(impl_);
+    MONAD_ASSERT(cursor.is_valid());
+    return preorder_traverse_blocking_parallel(
+        impl_->aux(), *cursor.node, machine, block_id, num_threads, merge);
+}
+
 NodeCursor Db::root() const noexcept
 {
     MONAD_ASSERT(impl_);
@@ -1327,6 +2205,14 @@ void Db::update_verified_version(uint64_t const version)
     impl_->update_verified_version(version);
 }
 
+void Db::update_finalized_and_verified_version(
+    uint64_t const finalized_version, uint64_t const verified_version)
+{
+    MONAD_ASSERT(impl_);
+    impl_->update_finalized_and_verified_version(
+        finalized_version, verified_version);
+}
+
 void Db::update_voted_metadata(
     uint64_t const version, bytes32_t const &block_id)
 {
@@ -1386,7 +2272,68 @@ size_t Db::prefetch()
     if (get_latest_version() == INVALID_BLOCK_NUM) {
         return 0;
     }
-    return impl_->prefetch_fiber_blocking();
+    return impl_->prefetch_fiber_blocking({});
+}
+
+size_t Db::prefetch(std::filesystem::path const &loaded_nodes)
+{
+    MONAD_ASSERT(impl_);
+    if (get_latest_version() == INVALID_BLOCK_NUM) {
+        return 0;
+    }
+    std::vector<chunk_offset_t> hint;
+    std::ifstream in(loaded_nodes, std::ios::binary);
+    std::error_code ec;
+    auto const file_size = std::filesystem::file_size(loaded_nodes, ec);
+    detail::loaded_nodes_header header{
+        .magic = 0,
+        .version = INVALID_BLOCK_NUM,
+        .root_offset = INVALID_OFFSET,
+        .count = 0};
+    if (!ec && in.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+        header.magic == detail::loaded_nodes_header::MAGIC &&
+        file_size ==
+            sizeof(header) + header.count * sizeof(chunk_offset_t) &&
+        header.version == impl_->aux().db_history_max_version() &&
+        header.root_offset.raw() ==
+            impl_->aux().get_latest_root_offset().raw()) {
+        hint.resize(header.count, chunk_offset_t::invalid_value());
+        if (!in.read(
+                reinterpret_cast<char *>(hint.data()),
+                static_cast<std::streamsize>(
+                    hint.size() * sizeof(chunk_offset_t)))) {
+            LOG_WARNING(
+                "Ignoring truncated loaded node list {}",
+                loaded_nodes.string());
+            hint.clear();
+        }
+    }
+    else {
+        LOG_INFO(
+            "Ignoring missing or stale loaded node list {}",
+            loaded_nodes.string());
+    }
+    return impl_->prefetch_fiber_blocking(hint);
+}
+
+size_t Db::save_loaded_nodes(std::filesystem::path const &path) const
+{
+    MONAD_ASSERT(impl_);
+    MONAD_ASSERT(is_on_disk() && !is_read_only());
+    auto const offsets = collect_loaded_offsets(root());
+    detail::loaded_nodes_header const header{
+        .magic = detail::loaded_nodes_header::MAGIC,
+        .version = impl_->aux().db_history_max_version(),
+        .root_offset = impl_->aux().get_latest_root_offset(),
+        .count = offsets.size()};
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    out.write(
+        reinterpret_cast<char const *>(offsets.data()),
+        static_cast<std::streamsize>(offsets.size() * sizeof(chunk_offset_t)));
+    MONAD_ASSERT_PRINTF(
+        out.good(), "failed to write %s", path.string().c_str());
+    return offsets.size();
 }
 
 size_t Db::poll(bool const blocking, size_t const count)
@@ -1413,8 +2360,18 @@ uint64_t Db::get_history_length() const
 }
 
 AsyncContext::AsyncContext(Db &db, size_t node_lru_max_mem)
+    : AsyncContext(
+          db,
+          std::make_shared<ShardedNodeCache>(
+              ShardedNodeCache::single_threaded, node_lru_max_mem))
+{
+}
+
+AsyncContext::AsyncContext(
+    Db &db, std::shared_ptr<ShardedNodeCache> shared_node_cache)
     : aux(db.impl_->aux())
-    , node_cache(node_lru_max_mem)
+    , node_cache_owner(std::move(shared_node_cache))
+    , node_cache(*node_cache_owner)
 {
 }
 
@@ -1423,6 +2380,19 @@ AsyncContextUniquePtr async_context_create(Db &db, size_t node_lru_max_mem)
     return std::make_unique<AsyncContext>(db, node_lru_max_mem);
 }
 
+AsyncContextUniquePtr async_context_create(
+    Db &db, std::shared_ptr<ShardedNodeCache> shared_node_cache)
+{
+    return std::make_unique<AsyncContext>(db, std::move(shared_node_cache));
+}
+
+size_t warm_node_cache_blocking(
+    AsyncContext &context, uint64_t const version, unsigned const levels)
+{
+    return warm_nodes_blocking(
+        context.aux, context.node_cache, version, levels);
+}
+
 namespace detail
 {
 
@@ -1540,10 +2510,9 @@ namespace detail
             chunk_offset_t const offset =
                 context.aux.get_root_offset_at_version(block_id);
             auto virt_offset = context.aux.physical_to_virtual(offset);
-            NodeCache::ConstAccessor acc;
-            if (context.node_cache.find(acc, virt_offset)) {
+            if (auto node = context.node_cache.find(virt_offset)) {
                 // found in LRU - no IO necessary
-                root = acc->second->val.first;
+                root = std::move(node);
                 res_root = {{root}, find_result::success};
                 io_state->completed(async::success());
                 return async::success();
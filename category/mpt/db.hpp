@@ -15,7 +15,11 @@
 
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <category/async/concepts.hpp>
 #include <category/async/config.hpp>
@@ -30,8 +34,10 @@
 #include <category/mpt/find_request_sender.hpp>
 #include <category/mpt/nibbles_view.hpp>
 #include <category/mpt/node.hpp>
+#include <category/mpt/range_cursor.hpp>
 #include <category/mpt/traverse.hpp>
 #include <category/mpt/trie.hpp>
+#include <category/mpt/trie_diff.hpp>
 #include <category/mpt/update.hpp>
 
 MONAD_MPT_NAMESPACE_BEGIN
@@ -44,7 +50,9 @@ struct AsyncContext;
 
 struct AsyncIOContext
 {
-    async::storage_pool pool;
+    // null when the storage pool is borrowed from another context
+    std::unique_ptr<async::storage_pool> pool_owner;
+    async::storage_pool &pool;
     io::Ring read_ring;
     std::optional<io::Ring> write_ring;
     io::Buffers buffers;
@@ -52,6 +60,14 @@ struct AsyncIOContext
 
     explicit AsyncIOContext(ReadOnlyOnDiskDbConfig const &options);
     explicit AsyncIOContext(OnDiskDbConfig const &options);
+    // Another read only ring and buffer set over `shared`'s storage pool, for
+    // a reader thread to submit and reap its own i/o without funnelling
+    // through `shared`'s thread. `options.sq_thread_cpu` binds this ring's
+    // kernel poll thread; `options.dbname_paths` is ignored. Must be
+    // constructed on the thread that will use it, and `shared` must outlive
+    // it.
+    AsyncIOContext(
+        AsyncIOContext &shared, ReadOnlyOnDiskDbConfig const &options);
 };
 
 class RODb
@@ -74,6 +90,13 @@ public:
     Result<OwningNodeCursor>
     find(OwningNodeCursor &, NibblesView, uint64_t block_id) const;
     Result<OwningNodeCursor> find(NibblesView prefix, uint64_t block_id) const;
+    // Like find() from a cursor, but returns at once and calls `done` with
+    // the result once the reads it needs completed, so the caller holds
+    // neither a thread nor a fiber while they are in flight. `done` may run
+    // on the calling thread or on the triedb thread, and must not block.
+    void find_async(
+        OwningNodeCursor const &, NibblesView, uint64_t block_id,
+        std::function<void(Result<OwningNodeCursor>)> done) const;
 
     uint64_t get_latest_version() const;
     uint64_t get_earliest_version() const;
@@ -117,6 +140,26 @@ public:
     Result<byte_string_view> get_data(NibblesView, uint64_t block_id) const;
     Result<byte_string_view>
     get_data(NodeCursor, NibblesView, uint64_t block_id) const;
+    // Batched find: results are returned in key order. In RW mode every
+    // lookup is handed to the triedb thread before waiting on any of them, so
+    // missing nodes are read together and a node shared by several keys is
+    // read once.
+    std::vector<Result<NodeCursor>> find_many(
+        NodeCursor, std::span<NibblesView const>, uint64_t block_id) const;
+    std::vector<Result<NodeCursor>>
+    find_many(std::span<NibblesView const>, uint64_t block_id) const;
+    // Ordered scan of the keys in [min, max) below the cursor, with keys
+    // relative to it. Reads missing nodes with blocking reads, so it never
+    // waits on a fiber future.
+    RangeCursor range(
+        NodeCursor, NibblesView min, NibblesView max, uint64_t block_id) const;
+    // Calls `callback` in key order for each key below `prefix` whose value
+    // differs between the two versions, skipping subtries the versions
+    // share. On-disk dbs only. Returns false if either version is missing or
+    // expires during the walk.
+    bool diff(
+        NibblesView prefix, uint64_t version_a, uint64_t version_b,
+        TrieDiffCallback const &callback) const;
 
     NodeCursor load_root_for_version(uint64_t block_id) const;
 
@@ -124,12 +167,33 @@ public:
         uint64_t src_version, NibblesView src, uint64_t dest_version,
         NibblesView dest, bool blocked_by_write = true);
 
+    // One copy_trie(version, src, version, dest) of copy_tries()
+    struct VersionTrieCopy
+    {
+        uint64_t version;
+        NibblesView src;
+        NibblesView dest;
+    };
+
+    // Performs the copies in order, as if by copy_trie(), in a single
+    // request to the write thread. Versions must be strictly increasing.
+    void copy_tries(std::span<VersionTrieCopy const> copies);
+
     void upsert(
         UpdateList, uint64_t block_id, bool enable_compaction = true,
         bool can_write_to_fast = true, bool write_root = true);
+    // Builds version `block_id` of an empty db bottom up from the leaves that
+    // `fill` adds in strictly increasing key order, writing every node once.
+    // `fill` runs on the thread doing the db writes and must not throw.
+    void build_sorted(
+        uint64_t block_id, std::function<void(SortedTrieBuilder &)> const &fill,
+        bool can_write_to_fast = true, bool write_root = true);
 
     void update_finalized_version(uint64_t version);
     void update_verified_version(uint64_t version);
+    // Same as the two calls above, with a single metadata write
+    void update_finalized_and_verified_version(
+        uint64_t finalized_version, uint64_t verified_version);
     void update_voted_metadata(uint64_t version, bytes32_t const &block_id);
     uint64_t get_latest_finalized_version() const;
     uint64_t get_latest_verified_version() const;
@@ -148,6 +212,12 @@ public:
         size_t concurrency_limit = 4096);
     // Blocking traverse never wait on a fiber future.
     bool traverse_blocking(NodeCursor, TraverseMachine &, uint64_t block_id);
+    // Blocking traverse split across `num_threads` threads, each running a
+    // clone of the machine; `merge` is then called with every clone on the
+    // calling thread. Never waits on a fiber future.
+    bool traverse_blocking_parallel(
+        NodeCursor, TraverseMachine &, uint64_t block_id, unsigned num_threads,
+        std::function<void(TraverseMachine &)> const &merge);
     NodeCursor root() const noexcept;
     uint64_t get_latest_version() const;
     uint64_t get_earliest_version() const;
@@ -159,6 +229,13 @@ public:
     // Load the tree of nodes in the current DB root as far as the caching
     // policy allows. RW only.
     size_t prefetch();
+    // As above, first reading the nodes listed by `save_loaded_nodes` in one
+    // batch ordered by disk offset. The list is ignored if the db has moved
+    // on since it was saved. RW only.
+    size_t prefetch(std::filesystem::path const &loaded_nodes);
+    // Saves the on disk offsets of every node held in memory, returning how
+    // many were saved. RW only, must not run concurrently with an upsert.
+    size_t save_loaded_nodes(std::filesystem::path const &) const;
     // Pump any async DB operations. RO only.
     size_t poll(bool blocking, size_t count = 1);
 
@@ -175,17 +252,31 @@ struct AsyncContext
         uint64_t, std::vector<std::function<void(std::shared_ptr<CacheNode>)>>>;
 
     UpdateAux<> &aux;
-    NodeCache node_cache;
+    std::shared_ptr<ShardedNodeCache> node_cache_owner;
+    ShardedNodeCache &node_cache;
     inflight_root_t inflight_roots;
     AsyncInflightNodes inflight_nodes;
 
     AsyncContext(Db &db, size_t node_lru_max_mem = 16ul << 20);
+    // the node cache may be shared with other contexts on the same database
+    AsyncContext(Db &db, std::shared_ptr<ShardedNodeCache>);
     ~AsyncContext() noexcept = default;
 };
 
 using AsyncContextUniquePtr = std::unique_ptr<AsyncContext>;
 AsyncContextUniquePtr
 async_context_create(Db &db, size_t node_lru_max_mem = 16ul << 20);
+AsyncContextUniquePtr
+async_context_create(Db &db, std::shared_ptr<ShardedNodeCache>);
+
+// Reads into the context's node cache the nodes of `version` within `levels`
+// of its root that the cache does not hold, so that the first gets on a new
+// version do not each start with cold reads. A cached node is unchanged since
+// it was read and so is everything below it, so only the nodes the writer
+// wrote for the version are read. Uses blocking reads on the calling thread.
+// Returns the number of nodes read.
+size_t warm_node_cache_blocking(
+    AsyncContext &, uint64_t version, unsigned levels = 2);
 
 namespace detail
 {
@@ -38,8 +38,8 @@ find_cursor_result_type find_blocking(
     unsigned node_prefix_index = root.prefix_index;
     unsigned prefix_index = 0;
     while (prefix_index < key.nibble_size()) {
-        unsigned char const nibble = key.get(prefix_index);
         if (node->path_nibbles_len() == node_prefix_index) {
+            unsigned char const nibble = key.get(prefix_index);
             if (!(node->mask & (1u << nibble))) {
                 return {
                     NodeCursor{*node, node_prefix_index},
@@ -66,15 +66,20 @@ find_cursor_result_type find_blocking(
             ++prefix_index;
             continue;
         }
-        if (nibble != node->path_nibble_view().get(node_prefix_index)) {
+        // match as much of the node's path as the key covers at once
+        auto const matched = key.substr(prefix_index)
+                                 .common_prefix_size(
+                                     node->path_nibble_view().substr(
+                                         node_prefix_index));
+        prefix_index += matched;
+        node_prefix_index += matched;
+        if (node_prefix_index < node->path_nibbles_len() &&
+            prefix_index < key.nibble_size()) {
             // return the last matched node and first mismatch prefix index
             return {
                 NodeCursor{*node, node_prefix_index},
                 find_result::key_mismatch_failure};
         }
-        // nibble is matched
-        ++prefix_index;
-        ++node_prefix_index;
     }
     if (node_prefix_index != node->path_nibbles_len()) {
         // prefix key exists but no leaf ends at `key`
@@ -115,7 +115,7 @@ namespace
         static constexpr bool lifetime_managed_internally = true;
 
         UpdateAuxImpl *aux;
-        NodeCache &node_cache;
+        ShardedNodeCache &node_cache;
         inflight_map_owning_t &inflights;
         chunk_offset_t offset;
         virtual_chunk_offset_t virtual_offset;
@@ -124,7 +124,7 @@ namespace
         uint16_t buffer_off;
 
         find_owning_receiver(
-            UpdateAuxImpl &aux, NodeCache &node_cache,
+            UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
             inflight_map_owning_t &inflights, chunk_offset_t const offset,
             virtual_chunk_offset_t const virtual_offset)
             : aux(&aux)
@@ -158,10 +158,6 @@ namespace
             // to write new data.
             auto const virtual_offset_after = aux->physical_to_virtual(offset);
             if (virtual_offset_after == virtual_offset) {
-                {
-                    NodeCache::ConstAccessor acc;
-                    MONAD_ASSERT(node_cache.find(acc, virtual_offset) == false);
-                }
                 std::shared_ptr<CacheNode> node =
                     detail::deserialize_node_from_receiver_result<CacheNode>(
                         std::move(buffer_), buffer_off, io_state);
@@ -178,16 +174,31 @@ namespace
         }
     };
 
-    void async_read_with_continuation(
-        UpdateAuxImpl &aux, NodeCache &node_cache,
-        inflight_map_owning_t &inflights,
+    void set_find_result(
         threadsafe_boost_fibers_promise<find_owning_cursor_result_type>
             &promise,
-        auto &&cont, chunk_offset_t const read_offset,
+        find_owning_cursor_result_type result)
+    {
+        promise.set_value(std::move(result));
+    }
+
+    // completing a callback find frees it
+    void set_find_result(
+        find_owning_callback_t &find, find_owning_cursor_result_type result)
+    {
+        std::unique_ptr<find_owning_callback_t> const owner{&find};
+        owner->done(std::move(result));
+    }
+
+    void async_read_with_continuation(
+        UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
+        inflight_map_owning_t &inflights, auto &promise, auto &&cont,
+        chunk_offset_t const read_offset,
         virtual_chunk_offset_t const virtual_offset)
     {
         if (aux.io->owning_thread_id() != get_tl_tid()) {
-            promise.set_value(
+            set_find_result(
+                promise,
                 {OwningNodeCursor{},
                  find_result::need_to_continue_in_io_thread});
             return;
@@ -221,21 +232,19 @@ void find_notify_fiber_future(
     unsigned prefix_index = 0;
     unsigned node_prefix_index = root.prefix_index;
     Node *node = root.node;
-    for (; node_prefix_index < node->path_nibbles_len();
-         ++node_prefix_index, ++prefix_index) {
-        if (prefix_index >= key.nibble_size()) {
-            promise.set_value(
-                {NodeCursor{*node, node_prefix_index},
-                 find_result::key_ends_earlier_than_node_failure});
-            return;
-        }
-        if (key.get(prefix_index) !=
-            node->path_nibble_view().get(node_prefix_index)) {
-            promise.set_value(
-                {NodeCursor{*node, node_prefix_index},
-                 find_result::key_mismatch_failure});
-            return;
-        }
+    if (node_prefix_index < node->path_nibbles_len()) {
+        auto const matched = key.common_prefix_size(
+            node->path_nibble_view().substr(node_prefix_index));
+        node_prefix_index += matched;
+        prefix_index += matched;
+    }
+    if (node_prefix_index < node->path_nibbles_len()) {
+        promise.set_value(
+            {NodeCursor{*node, node_prefix_index},
+             prefix_index >= key.nibble_size()
+                 ? find_result::key_ends_earlier_than_node_failure
+                 : find_result::key_mismatch_failure});
+        return;
     }
     if (prefix_index == key.nibble_size()) {
         promise.set_value(
@@ -286,41 +295,43 @@ void find_notify_fiber_future(
 
 // Look up from node_cache first, issue read if miss and not in inflight
 // Upon read completion, deserialize node and add to node_cache
-void find_owning_notify_fiber_future(
-    UpdateAuxImpl &aux, NodeCache &node_cache, inflight_map_owning_t &inflights,
-    threadsafe_boost_fibers_promise<find_owning_cursor_result_type> &promise,
+template <class Promise>
+void find_owning_notify(
+    UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
+    inflight_map_owning_t &inflights, Promise &promise,
     OwningNodeCursor &start, NibblesView const key, uint64_t const version)
 {
     if (!aux.version_is_valid_ondisk(version)) {
-        promise.set_value({start, find_result::version_no_longer_exist});
+        set_find_result(promise, {start, find_result::version_no_longer_exist});
         return;
     }
     if (!start.is_valid()) {
-        promise.set_value(
+        set_find_result(
+            promise,
             {OwningNodeCursor{}, find_result::root_node_is_null_failure});
         return;
     }
     unsigned prefix_index = 0;
     unsigned node_prefix_index = start.prefix_index;
     auto node = start.node;
-    for (; node_prefix_index < node->path_nibbles_len();
-         ++node_prefix_index, ++prefix_index) {
-        if (prefix_index >= key.nibble_size()) {
-            promise.set_value(
-                {OwningNodeCursor{node, node_prefix_index},
-                 find_result::key_ends_earlier_than_node_failure});
-            return;
-        }
-        if (key.get(prefix_index) !=
-            node->path_nibble_view().get(node_prefix_index)) {
-            promise.set_value(
-                {OwningNodeCursor{node, node_prefix_index},
-                 find_result::key_mismatch_failure});
-            return;
-        }
+    if (node_prefix_index < node->path_nibbles_len()) {
+        auto const matched = key.common_prefix_size(
+            node->path_nibble_view().substr(node_prefix_index));
+        node_prefix_index += matched;
+        prefix_index += matched;
+    }
+    if (node_prefix_index < node->path_nibbles_len()) {
+        set_find_result(
+            promise,
+            {OwningNodeCursor{node, node_prefix_index},
+             prefix_index >= key.nibble_size()
+                 ? find_result::key_ends_earlier_than_node_failure
+                 : find_result::key_mismatch_failure});
+        return;
     }
     if (prefix_index == key.nibble_size()) {
-        promise.set_value(
+        set_find_result(
+            promise,
             {OwningNodeCursor{node, node_prefix_index}, find_result::success});
         return;
     }
@@ -338,14 +349,14 @@ void find_owning_notify_fiber_future(
         // version validity check must be after the virtual offset translation
         if (!aux.version_is_valid_ondisk(version) ||
             next_virtual_offset == INVALID_VIRTUAL_OFFSET) {
-            promise.set_value({start, find_result::version_no_longer_exist});
+            set_find_result(
+                promise, {start, find_result::version_no_longer_exist});
             return;
         }
         // find in cache
-        NodeCache::ConstAccessor acc;
-        if (node_cache.find(acc, next_virtual_offset)) {
-            OwningNodeCursor next_cursor{acc->second->val.first};
-            find_owning_notify_fiber_future(
+        if (auto node = node_cache.find(next_virtual_offset)) {
+            OwningNodeCursor next_cursor{std::move(node)};
+            find_owning_notify(
                 aux,
                 node_cache,
                 inflights,
@@ -359,11 +370,12 @@ void find_owning_notify_fiber_future(
             [&aux, &node_cache, &inflights, &promise, next_key, version](
                 OwningNodeCursor &node_cursor) -> result<void> {
             if (!node_cursor.is_valid()) {
-                promise.set_value(
+                set_find_result(
+                    promise,
                     {OwningNodeCursor{}, find_result::version_no_longer_exist});
                 return success();
             }
-            find_owning_notify_fiber_future(
+            find_owning_notify(
                 aux,
                 node_cache,
                 inflights,
@@ -383,14 +395,37 @@ void find_owning_notify_fiber_future(
             next_virtual_offset);
     }
     else {
-        promise.set_value(
+        set_find_result(
+            promise,
             {OwningNodeCursor{node, node_prefix_index},
              find_result::branch_not_exist_failure});
     }
 }
 
+void find_owning_notify_fiber_future(
+    UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
+    inflight_map_owning_t &inflights,
+    threadsafe_boost_fibers_promise<find_owning_cursor_result_type> &promise,
+    OwningNodeCursor &start, NibblesView const key, uint64_t const version)
+{
+    find_owning_notify(
+        aux, node_cache, inflights, promise, start, key, version);
+}
+
+void find_owning_notify_callback(
+    UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
+    inflight_map_owning_t &inflights,
+    std::unique_ptr<find_owning_callback_t> find, OwningNodeCursor &start,
+    uint64_t const version)
+{
+    auto &f = *find.release();
+    find_owning_notify(
+        aux, node_cache, inflights, f, start, NibblesView{f.key}, version);
+}
+
 void load_root_notify_fiber_future(
-    UpdateAuxImpl &aux, NodeCache &node_cache, inflight_map_owning_t &inflights,
+    UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
+    inflight_map_owning_t &inflights,
     threadsafe_boost_fibers_promise<find_owning_cursor_result_type> &promise,
     uint64_t const version)
 {
@@ -403,11 +438,9 @@ void load_root_notify_fiber_future(
             {OwningNodeCursor{}, find_result::version_no_longer_exist});
         return;
     }
-    NodeCache::ConstAccessor acc;
-    if (node_cache.find(acc, root_virtual_offset)) {
-        auto &root = acc->second->val.first;
-        MONAD_ASSERT(root != nullptr);
-        promise.set_value({OwningNodeCursor{root}, find_result::success});
+    if (auto root = node_cache.find(root_virtual_offset)) {
+        promise.set_value(
+            {OwningNodeCursor{std::move(root)}, find_result::success});
         return;
     }
     auto cont = [&promise](OwningNodeCursor &node_cursor) -> result<void> {
@@ -66,7 +66,7 @@ private:
     friend struct find_receiver;
 
     UpdateAuxImpl &aux_;
-    NodeCache &node_cache_;
+    ShardedNodeCache &node_cache_;
     OwningNodeCursor root_;
     uint64_t version_;
     NibblesView key_;
@@ -94,7 +94,7 @@ public:
     using result_type = MONAD_ASYNC_NAMESPACE::result<find_result_type<T>>;
 
     constexpr find_request_sender(
-        UpdateAuxImpl &aux, NodeCache &node_cache,
+        UpdateAuxImpl &aux, ShardedNodeCache &node_cache,
         AsyncInflightNodes &inflights, OwningNodeCursor root, uint64_t version,
         NibblesView const key, bool const return_value)
         : aux_(aux)
@@ -189,9 +189,7 @@ struct find_request_sender<T>::find_receiver
         if (this->virt_offset == virt_offset) {
             sp = detail::deserialize_node_from_receiver_result<CacheNode>(
                 std::move(buffer_), buffer_off, io_state);
-            auto cache_it = sender->node_cache_.insert(virt_offset, sp);
-            auto *const list_node = &*cache_it->second;
-            sender->root_.node->set_next(branch_index, list_node);
+            sender->node_cache_.insert(virt_offset, sp);
         }
         auto key = std::pair(this->virt_offset, sender->root_.node.get());
         auto it = sender->inflights_.find(key);
@@ -220,19 +218,20 @@ inline MONAD_ASYNC_NAMESPACE::result<void> find_request_sender<T>::operator()(
         unsigned node_prefix_index = root_.prefix_index;
         MONAD_ASSERT(root_.is_valid());
         auto node = root_.node.get();
-        for (; node_prefix_index < node->path_nibbles_len();
-             ++node_prefix_index, ++prefix_index) {
-            if (prefix_index >= key_.nibble_size()) {
-                res_ = {T{}, find_result::key_ends_earlier_than_node_failure};
-                io_state->completed(success());
-                return success();
-            }
-            if (key_.get(prefix_index) !=
-                node->path_nibble_view().get(node_prefix_index)) {
-                res_ = {T{}, find_result::key_mismatch_failure};
-                io_state->completed(success());
-                return success();
-            }
+        if (node_prefix_index < node->path_nibbles_len()) {
+            auto const matched = key_.common_prefix_size(
+                node->path_nibble_view().substr(node_prefix_index));
+            node_prefix_index += matched;
+            prefix_index += matched;
+        }
+        if (node_prefix_index < node->path_nibbles_len()) {
+            res_ = {
+                T{},
+                prefix_index >= key_.nibble_size()
+                    ? find_result::key_ends_earlier_than_node_failure
+                    : find_result::key_mismatch_failure};
+            io_state->completed(success());
+            return success();
         }
         if (prefix_index == key_.nibble_size()) {
             if constexpr (std::is_same_v<T, byte_string>) {
@@ -253,9 +252,6 @@ inline MONAD_ASYNC_NAMESPACE::result<void> find_request_sender<T>::operator()(
                 prefix_index < std::numeric_limits<unsigned char>::max());
             key_ = key_.substr(static_cast<unsigned char>(prefix_index) + 1u);
             auto const child_index = node->to_child_index(branch);
-            NodeCache::ConstAccessor acc;
-            auto *p = reinterpret_cast<NodeCache::list_node *>(
-                node->next(child_index));
             auto const offset = node->fnext(child_index);
             virtual_chunk_offset_t const virt_offset =
                 aux_.physical_to_virtual(offset);
@@ -265,17 +261,12 @@ inline MONAD_ASYNC_NAMESPACE::result<void> find_request_sender<T>::operator()(
                 io_state->completed(success());
                 return success();
             }
-            if (p != nullptr && p->key == virt_offset) {
-                // found cache entry with the desired key
-                root_ = {p->val.first};
-                MONAD_ASSERT(root_.is_valid());
-                continue;
-            }
-            if (node_cache_.find(acc, virt_offset)) {
-                auto *const list_node = &*acc->second;
-                node->set_next(child_index, list_node);
+            // The cache may be shared with other readers, so its entries
+            // are looked up under the shard lock each time rather than
+            // remembered in the parent node
+            if (auto cached = node_cache_.find(virt_offset)) {
                 // found in LRU - no IO necessary
-                root_ = {list_node->val.first};
+                root_ = {std::move(cached)};
                 MONAD_ASSERT(root_.is_valid());
                 continue;
             }
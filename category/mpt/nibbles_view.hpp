@@ -21,6 +21,7 @@
 #include <category/core/nibble.h>
 #include <category/mpt/config.hpp>
 
+#include <bit>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -253,33 +254,61 @@ public:
             return false;
         }
 
-        if (nibble_size()) {
-            MONAD_DEBUG_ASSERT(data_ && other.data_);
-            for (auto i = 0u; i < nibble_size(); ++i) {
-                if (get(i) != other.get(i)) {
-                    return false;
-                }
-            }
-        }
-        return true;
+        return common_prefix_size(other) == nibble_size();
     }
 
     constexpr auto operator<=>(NibblesView const &other) const
     {
         unsigned const min_size = std::min(nibble_size(), other.nibble_size());
-        for (unsigned i = 0; i < min_size; ++i) {
-            if (get(i) != other.get(i)) {
-                return get(i) <=> other.get(i);
-            }
+        if (unsigned const i = common_prefix_size(other); i < min_size) {
+            return get(i) <=> other.get(i);
         }
         return nibble_size() <=> other.nibble_size();
     }
 
+    // Number of leading nibbles the two views share. Keys are compared 16
+    // nibbles at a time, whatever the nibble alignment of either view.
+    constexpr unsigned common_prefix_size(NibblesView const other) const
+    {
+        unsigned const size = std::min(nibble_size(), other.nibble_size());
+        unsigned i = 0;
+        for (; i + 16 <= size; i += 16) {
+            if (uint64_t const diff = get_word(i) ^ other.get_word(i)) {
+                return i + static_cast<unsigned>(std::countl_zero(diff)) / 4;
+            }
+        }
+        for (; i < size; ++i) {
+            if (get_nibble(data_, begin_nibble_ + i) !=
+                get_nibble(other.data_, other.begin_nibble_ + i)) {
+                break;
+            }
+        }
+        return i;
+    }
+
     [[nodiscard]] unsigned char get(unsigned const i) const
     {
         MONAD_ASSERT(i < nibble_size());
         return get_nibble(data_, begin_nibble_ + i);
     }
+
+private:
+    // The 16 nibbles from nibble `i` on, the first in the top bits. Only the
+    // bytes holding them are read.
+    constexpr uint64_t get_word(unsigned const i) const
+    {
+        MONAD_DEBUG_ASSERT(i + 16 <= nibble_size());
+        unsigned const nibble = begin_nibble_ + i;
+        unsigned char const *const p = data_ + nibble / 2;
+        uint64_t word = 0;
+        for (unsigned j = 0; j < 8; ++j) {
+            word = (word << 8) | static_cast<uint64_t>(p[j]);
+        }
+        if (nibble & 1) {
+            word = (word << 4) | static_cast<uint64_t>(p[8] >> 4);
+        }
+        return word;
+    }
 };
 
 static_assert(sizeof(NibblesView) == 16);
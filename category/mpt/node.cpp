@@ -44,8 +44,23 @@
 #include <utility>
 #include <vector>
 
+#include <zstd.h>
+
 MONAD_MPT_NAMESPACE_BEGIN
 
+namespace
+{
+    // Bytes per child of the fixed-size arrays ahead of the child data
+    // offsets: fnext, the fast and slow min offsets and the subtrie min
+    // version
+    constexpr size_t child_arrays_bytes =
+        sizeof(chunk_offset_t) + 2 * sizeof(compact_virtual_chunk_offset_t) +
+        sizeof(int64_t);
+
+    // fnext is strided by both
+    static_assert(sizeof(chunk_offset_t) == sizeof(file_offset_t));
+}
+
 Node::Node(prevent_public_construction_tag) {}
 
 NodeBase::NodeBase(
@@ -201,12 +216,12 @@ void NodeBase::set_subtrie_min_version(
 
 unsigned char *NodeBase::child_off_data() noexcept
 {
-    return child_min_version_data() + number_of_children() * sizeof(int64_t);
+    return fnext_data + number_of_children() * child_arrays_bytes;
 }
 
 unsigned char const *NodeBase::child_off_data() const noexcept
 {
-    return child_min_version_data() + number_of_children() * sizeof(int64_t);
+    return fnext_data + number_of_children() * child_arrays_bytes;
 }
 
 uint16_t NodeBase::child_data_offset(unsigned const index) const noexcept
@@ -342,14 +357,35 @@ void NodeBase::set_child_data(
     std::memcpy(child_data(index), data.data(), data.size());
 }
 
+// Every walk to an in-memory child lands here, so the offset is computed
+// from the header in one go rather than through each region in turn: one
+// popcount and one load of the last child data offset
 unsigned char *NodeBase::next_data() noexcept
 {
-    return child_data() + child_data_offset(number_of_children());
+    unsigned const n = number_of_children();
+    unsigned char *const child_off = fnext_data + n * child_arrays_bytes;
+    unsigned char *const child_data = child_off + n * sizeof(uint16_t) +
+                                      path_bytes() + value_len +
+                                      bitpacked.data_len;
+    if (n == 0) {
+        return child_data;
+    }
+    return child_data +
+           unaligned_load<uint16_t>(child_off + (n - 1) * sizeof(uint16_t));
 }
 
 unsigned char const *NodeBase::next_data() const noexcept
 {
-    return child_data() + child_data_offset(number_of_children());
+    unsigned const n = number_of_children();
+    unsigned char const *const child_off = fnext_data + n * child_arrays_bytes;
+    unsigned char const *const child_data = child_off + n * sizeof(uint16_t) +
+                                            path_bytes() + value_len +
+                                            bitpacked.data_len;
+    if (n == 0) {
+        return child_data;
+    }
+    return child_data +
+           unaligned_load<uint16_t>(child_off + (n - 1) * sizeof(uint16_t));
 }
 
 void *NodeBase::next(size_t const index) const noexcept
@@ -405,13 +441,20 @@ void ChildData::finalize(
 {
     MONAD_DEBUG_ASSERT(is_valid());
     ptr = std::move(node);
-    auto const length = compute.compute(data, ptr.get());
-    MONAD_DEBUG_ASSERT(length <= std::numeric_limits<uint8_t>::max());
-    len = static_cast<uint8_t>(length);
+    pending_compute = &compute;
+    len = 0;
     cache_node = cache;
     subtrie_min_version = calc_min_version(*ptr);
 }
 
+void ChildData::compute_data()
+{
+    if (pending_compute) {
+        ChildData *const self = this;
+        pending_compute->compute_siblings({&self, 1});
+    }
+}
+
 void ChildData::copy_old_child(Node *const old, unsigned const i)
 {
     auto const index = old->to_child_index(i);
@@ -545,6 +588,27 @@ Node::UniquePtr make_node(
     return node;
 }
 
+void compute_children_data(std::span<ChildData> const children)
+{
+    MONAD_ASSERT(children.size() <= 16);
+    for (size_t i = 0; i < children.size(); ++i) {
+        Compute *const compute = children[i].pending_compute;
+        if (!compute || !children[i].is_valid()) {
+            continue;
+        }
+        // nearly always all the children share one compute
+        ChildData *group[16];
+        size_t n = 0;
+        for (size_t j = i; j < children.size(); ++j) {
+            if (children[j].pending_compute == compute &&
+                children[j].is_valid()) {
+                group[n++] = &children[j];
+            }
+        }
+        compute->compute_siblings({group, n});
+    }
+}
+
 // all children's offset are set before creating parent
 // create node with at least one child
 Node::UniquePtr create_node_with_children(
@@ -587,6 +651,58 @@ void serialize_node_to_buffer(
     }
 }
 
+byte_string serialize_node_compressed(Node const &node, int const level)
+{
+    uint32_t const disk_size = node.get_disk_size();
+    if (disk_size < Node::min_compressible_disk_size) {
+        return {};
+    }
+    byte_string image(disk_size, 0);
+    serialize_node_to_buffer(image.data(), disk_size, node, disk_size);
+    size_t const bound = ZSTD_compressBound(disk_size);
+    byte_string out(Node::disk_size_bytes + bound, 0);
+    size_t const compressed = ZSTD_compress(
+        out.data() + Node::disk_size_bytes,
+        bound,
+        image.data(),
+        image.size(),
+        level);
+    MONAD_ASSERT_PRINTF(
+        !ZSTD_isError(compressed),
+        "zstd compression failed: %s",
+        ZSTD_getErrorName(compressed));
+    size_t const encoded_size = Node::disk_size_bytes + compressed;
+    if (encoded_size >= disk_size) {
+        return {};
+    }
+    out.resize(encoded_size);
+    uint32_t const size_word =
+        static_cast<uint32_t>(encoded_size) | Node::disk_size_compressed_bit;
+    memcpy(out.data(), &size_word, Node::disk_size_bytes);
+    return out;
+}
+
+byte_string decompress_node_image(
+    unsigned char const *const read_pos, uint32_t const encoded_size)
+{
+    MONAD_ASSERT(encoded_size > Node::disk_size_bytes);
+    unsigned char const *const frame = read_pos + Node::disk_size_bytes;
+    size_t const frame_size = encoded_size - Node::disk_size_bytes;
+    auto const disk_size = ZSTD_getFrameContentSize(frame, frame_size);
+    MONAD_ASSERT(
+        disk_size != ZSTD_CONTENTSIZE_ERROR &&
+        disk_size != ZSTD_CONTENTSIZE_UNKNOWN);
+    MONAD_ASSERT(disk_size > 0 && disk_size <= Node::max_disk_size);
+    byte_string image(static_cast<size_t>(disk_size), 0);
+    size_t const decompressed =
+        ZSTD_decompress(image.data(), image.size(), frame, frame_size);
+    MONAD_ASSERT_PRINTF(
+        !ZSTD_isError(decompressed) && decompressed == image.size(),
+        "zstd decompression failed: %s",
+        ZSTD_getErrorName(decompressed));
+    return image;
+}
+
 int64_t calc_min_version(Node const &node)
 {
     int64_t min_version = node.version;
@@ -150,6 +150,11 @@ public:
     static constexpr size_t max_disk_size =
         256 * 1024 * 1024; // 256mb, same as storage chunk size
     static constexpr unsigned disk_size_bytes = sizeof(uint32_t);
+    // Set in the on-disk size word when the bytes following it are a zstd
+    // frame holding the uncompressed on-disk node image
+    static constexpr uint32_t disk_size_compressed_bit = 1U << 31;
+    // Nodes smaller than this are never worth a zstd frame header
+    static constexpr uint32_t min_compressible_disk_size = 256;
     static constexpr size_t max_size =
         max_disk_size + max_number_of_children * KECCAK256_SIZE;
 
@@ -287,7 +292,7 @@ class Node final : public NodeBase
 {
 public:
     using Deleter = allocators::unique_ptr_aliasing_allocator_deleter<
-        &allocators::aliasing_allocator_pair<Node>>;
+        &allocators::huge_slab_aliasing_allocator_pair<Node>>;
     using UniquePtr = std::unique_ptr<Node, Deleter>;
 
     Node(prevent_public_construction_tag);
@@ -309,7 +314,7 @@ public:
     {
         MONAD_DEBUG_ASSERT(bytes <= Node::max_size);
         return allocators::allocate_aliasing_unique<
-            &allocators::aliasing_allocator_pair<Node>>(
+            &allocators::huge_slab_aliasing_allocator_pair<Node>>(
             bytes,
             prevent_public_construction_tag{},
             std::forward<Args>(args)...);
@@ -340,7 +345,7 @@ class CacheNode final : public NodeBase
 {
 public:
     using Deleter = allocators::unique_ptr_aliasing_allocator_deleter<
-        &allocators::aliasing_allocator_pair<CacheNode>>;
+        &allocators::huge_slab_aliasing_allocator_pair<CacheNode>>;
     using UniquePtr = std::unique_ptr<CacheNode, Deleter>;
 
     CacheNode(prevent_public_construction_tag)
@@ -353,7 +358,7 @@ public:
     {
         MONAD_DEBUG_ASSERT(bytes <= Node::max_size);
         return allocators::allocate_aliasing_unique<
-            &allocators::aliasing_allocator_pair<CacheNode>>(
+            &allocators::huge_slab_aliasing_allocator_pair<CacheNode>>(
             bytes,
             prevent_public_construction_tag{},
             std::forward<Args>(args)...);
@@ -384,14 +389,19 @@ struct ChildData
     uint8_t branch{INVALID_BRANCH};
     uint8_t len{0};
     bool cache_node{true}; // attach ptr to parent if cache, free otherwise
+    // computes `data` once the parent gathers its children, if not yet done
+    Compute *pending_compute{nullptr};
 
     bool is_valid() const;
     void erase();
+    // `data` is left to compute_children_data(), which hashes siblings
+    // together
     void finalize(Node::UniquePtr, Compute &, bool cache);
+    void compute_data();
     void copy_old_child(Node *old, unsigned i);
 };
 
-static_assert(sizeof(ChildData) == 72);
+static_assert(sizeof(ChildData) == 80);
 static_assert(alignof(ChildData) == 8);
 
 constexpr size_t calculate_node_size(
@@ -431,6 +441,10 @@ Node::UniquePtr make_node(
     std::optional<byte_string_view> value, byte_string_view data,
     int64_t version);
 
+// Compute the data of the finalized children, each compute hashing the
+// children it computes together
+void compute_children_data(std::span<ChildData>);
+
 // create node: either branch/extension, with or without leaf
 Node::UniquePtr create_node_with_children(
     Compute &, uint16_t mask, std::span<ChildData> children, NibblesView path,
@@ -440,6 +454,16 @@ void serialize_node_to_buffer(
     unsigned char *write_pos, unsigned bytes_to_write, Node const &,
     uint32_t disk_size, unsigned offset = 0);
 
+// Returns the complete zstd compressed on-disk image of `node`, including the
+// size word with `disk_size_compressed_bit` set, or an empty byte string if
+// compression would not make the node smaller.
+byte_string serialize_node_compressed(Node const &, int level);
+
+// Inflates a compressed on-disk image of `encoded_size` bytes back into the
+// uncompressed on-disk image.
+byte_string
+decompress_node_image(unsigned char const *read_pos, uint32_t encoded_size);
+
 template <class NodeType>
 inline NodeType::UniquePtr
 deserialize_node_from_buffer(unsigned char const *read_pos, size_t max_bytes)
@@ -449,6 +473,17 @@ deserialize_node_from_buffer(unsigned char const *read_pos, size_t max_bytes)
     }
     // Load 32-bit node on-disk size
     auto const disk_size = unaligned_load<uint32_t>(read_pos);
+    if (disk_size & NodeBase::disk_size_compressed_bit) {
+        auto const encoded_size =
+            disk_size & ~NodeBase::disk_size_compressed_bit;
+        MONAD_ASSERT_PRINTF(
+            encoded_size <= max_bytes,
+            "deserialized compressed node disk size is %u",
+            encoded_size);
+        auto const image = decompress_node_image(read_pos, encoded_size);
+        return deserialize_node_from_buffer<NodeType>(
+            image.data(), image.size());
+    }
     MONAD_ASSERT_PRINTF(
         disk_size <= max_bytes, "deserialized node disk size is %u", disk_size);
     MONAD_ASSERT(disk_size > 0 && disk_size <= NodeBase::max_disk_size);
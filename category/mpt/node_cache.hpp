@@ -20,77 +20,339 @@
 #include <category/mpt/node.hpp>
 #include <category/mpt/util.hpp>
 
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 MONAD_MPT_NAMESPACE_BEGIN
 
-// Memory bounded node cache
+struct NodeCacheEntryInfo
+{
+    unsigned size;
+    bool is_protected;
+};
+
+// Memory bounded node cache with segmented LRU eviction. New nodes enter a
+// probationary segment and are promoted to a protected segment on their next
+// hit, so a one-off scan only cycles through probation and cannot flush nodes
+// that are repeatedly visited, such as the top of the trie.
 class NodeCache final
     : private static_lru_cache<
           virtual_chunk_offset_t,
-          std::pair<std::shared_ptr<CacheNode>, unsigned>,
+          std::pair<std::shared_ptr<CacheNode>, NodeCacheEntryInfo>,
           virtual_chunk_offset_t_hasher>
 {
-    // second in value is node size
     using Base = static_lru_cache<
-        virtual_chunk_offset_t, std::pair<std::shared_ptr<CacheNode>, unsigned>,
+        virtual_chunk_offset_t,
+        std::pair<std::shared_ptr<CacheNode>, NodeCacheEntryInfo>,
         virtual_chunk_offset_t_hasher>;
 
+public:
+    struct Stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+    };
+
+private:
+    // `active_list_` of the base class holds the probationary segment
+    List protected_list_;
     size_t max_bytes_;
+    size_t max_protected_bytes_;
     size_t used_bytes_{0};
+    size_t protected_bytes_{0};
+    Stats stats_{};
 
-    void evict_until_under_limit()
-    {
-        while (used_bytes_ > max_bytes_ && !active_list_.empty()) {
-            auto list_it = std::prev(active_list_.end());
-            auto &node_to_erase = *list_it;
-            map_.erase(list_it->key);
-            used_bytes_ -= list_it->val.second;
-            // move to empty list
-            active_list_.erase(list_it);
-            node_to_erase.key = virtual_chunk_offset_t::invalid_value();
-            node_to_erase.val = {nullptr, 0};
-            free_list_.push_front(node_to_erase);
+    void evict_one()
+    {
+        auto &list = active_list_.empty() ? protected_list_ : active_list_;
+        MONAD_ASSERT(!list.empty());
+        auto list_it = std::prev(list.end());
+        auto &node_to_erase = *list_it;
+        map_.erase(list_it->key);
+        used_bytes_ -= list_it->val.second.size;
+        if (list_it->val.second.is_protected) {
+            protected_bytes_ -= list_it->val.second.size;
+        }
+        // move to empty list
+        list.erase(list_it);
+        node_to_erase.key = virtual_chunk_offset_t::invalid_value();
+        node_to_erase.val = {nullptr, {0, false}};
+        free_list_.push_front(node_to_erase);
+        ++stats_.evictions;
+    }
+
+    void evict_until_under_limit(size_t const keep)
+    {
+        while (used_bytes_ > max_bytes_ && map_.size() > keep) {
+            evict_one();
+        }
+    }
+
+    void touch(ListIter const it)
+    {
+        auto &info = it->val.second;
+        if (info.is_protected) {
+            protected_list_.splice(
+                protected_list_.begin(), protected_list_, it);
+            return;
+        }
+        // promote, demoting the protected tail back to probation on overflow
+        info.is_protected = true;
+        protected_bytes_ += info.size;
+        protected_list_.splice(protected_list_.begin(), active_list_, it);
+        while (protected_bytes_ > max_protected_bytes_ &&
+               protected_list_.size() > 1) {
+            auto const tail = std::prev(protected_list_.end());
+            tail->val.second.is_protected = false;
+            protected_bytes_ -= tail->val.second.size;
+            active_list_.splice(active_list_.begin(), protected_list_, tail);
         }
     }
 
 public:
     static constexpr size_t AVERAGE_NODE_SIZE = 100;
+    // percentage of the byte budget the protected segment may hold
+    static constexpr size_t PROTECTED_PERCENT = 80;
 
     using Base::ConstAccessor;
     using Base::list_node;
 
-    using Base::clear;
-    using Base::find;
     using Base::size;
 
     explicit NodeCache(size_t const max_bytes)
         : Base(
               max_bytes / AVERAGE_NODE_SIZE,
-              virtual_chunk_offset_t::invalid_value(), {nullptr, 0})
+              virtual_chunk_offset_t::invalid_value(), {nullptr, {0, false}})
         , max_bytes_(max_bytes)
+        , max_protected_bytes_(max_bytes / 100 * PROTECTED_PERCENT)
         , used_bytes_{0}
     {
     }
 
     ~NodeCache() = default;
 
+    bool find(ConstAccessor &acc, virtual_chunk_offset_t const &key) noexcept
+    {
+        acc = map_.find(key);
+        if (acc == map_.end()) {
+            ++stats_.misses;
+            return false;
+        }
+        ++stats_.hits;
+        touch(acc->second);
+        return true;
+    }
+
+    // lookup without updating recency or stats
+    bool contains(virtual_chunk_offset_t const &key) const noexcept
+    {
+        return map_.contains(key);
+    }
+
     Map::iterator insert(
         virtual_chunk_offset_t const &virt_offset,
         std::shared_ptr<CacheNode> const &sp) noexcept
     {
         MONAD_ASSERT(virt_offset != virtual_chunk_offset_t::invalid_value());
 
-        used_bytes_ += sp->get_mem_size();
-        evict_until_under_limit();
+        unsigned const size = sp->get_mem_size();
+        if (auto it = map_.find(virt_offset); it != map_.end()) {
+            // replacing a cached node counts as an access
+            auto &[node, info] = it->second->val;
+            used_bytes_ -= info.size;
+            if (info.is_protected) {
+                protected_bytes_ -= info.size;
+                protected_bytes_ += size;
+            }
+            used_bytes_ += size;
+            node = sp;
+            info.size = size;
+            touch(it->second);
+            evict_until_under_limit(1);
+            return it;
+        }
+
+        used_bytes_ += size;
+        evict_until_under_limit(0);
+        if (free_list_.empty()) {
+            evict_one();
+        }
+        auto list_it = free_list_.begin();
+        auto &node = *list_it;
+        free_list_.erase(list_it);
+        node.key = virt_offset;
+        node.val = {sp, {size, false}};
+        active_list_.push_front(node);
+        return map_.emplace(virt_offset, active_list_.iterator_to(node)).first;
+    }
+
+    void clear() noexcept
+    {
+        for (List *const list : {&active_list_, &protected_list_}) {
+            while (!list->empty()) {
+                auto &node = list->front();
+                list->pop_front();
+                node.key = virtual_chunk_offset_t::invalid_value();
+                node.val = {nullptr, {0, false}};
+                free_list_.push_front(node);
+            }
+        }
+        map_.clear();
+        used_bytes_ = 0;
+        protected_bytes_ = 0;
+    }
+
+    // Change the byte budget, evicting until the cache fits it. The number
+    // of entries stays as constructed, which bounds growth past the initial
+    // budget.
+    void set_max_bytes(size_t const max_bytes) noexcept
+    {
+        max_bytes_ = max_bytes;
+        max_protected_bytes_ = max_bytes / 100 * PROTECTED_PERCENT;
+        evict_until_under_limit(0);
+        while (protected_bytes_ > max_protected_bytes_ &&
+               !protected_list_.empty()) {
+            auto const tail = std::prev(protected_list_.end());
+            tail->val.second.is_protected = false;
+            protected_bytes_ -= tail->val.second.size;
+            active_list_.splice(active_list_.begin(), protected_list_, tail);
+        }
+    }
+
+    size_t used_bytes() const noexcept
+    {
+        return used_bytes_;
+    }
+
+    Stats const &stats() const noexcept
+    {
+        return stats_;
+    }
+};
+
+// Thread safe node cache that several RODb instances or AsyncContexts reading
+// the same database can share. Keys are split over shards by hash, each shard
+// being a NodeCache with its own lock and an equal part of the byte budget,
+// so concurrent readers rarely contend. A cache that is only ever used by one
+// thread can be made single threaded, which has one shard and takes no lock.
+class ShardedNodeCache final
+{
+    struct Shard
+    {
+        std::mutex mutex;
+        NodeCache cache;
+
+        explicit Shard(size_t const max_bytes)
+            : cache(max_bytes)
+        {
+        }
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool locked_{true};
+
+    Shard &shard(virtual_chunk_offset_t const &key) const noexcept
+    {
+        // the low bits of the hash also index the shard maps
+        size_t const hash = virtual_chunk_offset_t_hasher{}(key);
+        return *shards_[(hash >> 32) % shards_.size()];
+    }
+
+    std::unique_lock<std::mutex> lock(Shard &s) const
+    {
+        return locked_ ? std::unique_lock{s.mutex}
+                       : std::unique_lock{s.mutex, std::defer_lock};
+    }
+
+public:
+    static constexpr unsigned DEFAULT_SHARDS = 16;
+
+    static constexpr struct single_threaded_t
+    {
+    } single_threaded{};
+
+    explicit ShardedNodeCache(
+        size_t const max_bytes, unsigned const shards = DEFAULT_SHARDS)
+    {
+        MONAD_ASSERT(shards != 0);
+        MONAD_ASSERT(max_bytes / shards >= NodeCache::AVERAGE_NODE_SIZE);
+        shards_.reserve(shards);
+        for (unsigned i = 0; i < shards; ++i) {
+            shards_.emplace_back(std::make_unique<Shard>(max_bytes / shards));
+        }
+    }
+
+    ShardedNodeCache(single_threaded_t, size_t const max_bytes)
+        : ShardedNodeCache(max_bytes, 1)
+    {
+        locked_ = false;
+    }
+
+    // returns nullptr on miss
+    std::shared_ptr<CacheNode> find(virtual_chunk_offset_t const &key) const
+    {
+        auto &s = shard(key);
+        NodeCache::ConstAccessor acc;
+        auto const g = lock(s);
+        if (!s.cache.find(acc, key)) {
+            return nullptr;
+        }
+        return acc->second->val.first;
+    }
 
-        auto const [it, erased_value] =
-            Base::insert(virt_offset, {sp, sp->get_mem_size()});
-        if (erased_value.has_value()) {
-            used_bytes_ -= erased_value->second;
+    // lookup without updating recency or stats
+    bool contains(virtual_chunk_offset_t const &key) const
+    {
+        auto &s = shard(key);
+        auto const g = lock(s);
+        return s.cache.contains(key);
+    }
+
+    void insert(
+        virtual_chunk_offset_t const &key,
+        std::shared_ptr<CacheNode> const &node)
+    {
+        auto &s = shard(key);
+        auto const g = lock(s);
+        s.cache.insert(key, node);
+    }
+
+    size_t size() const
+    {
+        size_t total = 0;
+        for (auto const &s : shards_) {
+            auto const g = lock(*s);
+            total += s->cache.size();
+        }
+        return total;
+    }
+
+    void set_max_bytes(size_t const max_bytes)
+    {
+        for (auto const &s : shards_) {
+            auto const g = lock(*s);
+            s->cache.set_max_bytes(max_bytes / shards_.size());
+        }
+    }
+
+    NodeCache::Stats stats() const
+    {
+        NodeCache::Stats total{};
+        for (auto const &s : shards_) {
+            auto const g = lock(*s);
+            auto const &stats = s->cache.stats();
+            total.hits += stats.hits;
+            total.misses += stats.misses;
+            total.evictions += stats.evictions;
         }
-        return it;
+        return total;
     }
 };
 
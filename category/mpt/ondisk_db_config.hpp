@@ -17,12 +17,16 @@
 
 #include <category/mpt/config.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <vector>
 
 MONAD_MPT_NAMESPACE_BEGIN
 
+class ShardedNodeCache;
 struct StateMachine;
 
 struct OnDiskDbConfig
@@ -35,15 +39,32 @@ struct OnDiskDbConfig
     bool rewind_to_latest_finalized{false};
     unsigned rd_buffers{1024};
     unsigned wr_buffers{4};
+    // bytes per write buffer, and so per write i/o. Must be a power of two of
+    // at least 8Mb which divides the chunk capacity.
+    size_t wr_buffer_size{8 * 1024 * 1024};
     unsigned uring_entries{512};
     std::optional<unsigned> sq_thread_cpu{0};
     std::optional<uint64_t> start_block_id{std::nullopt};
     std::vector<std::filesystem::path> dbname_paths{};
+    // bytes per second compaction may advance through the rings, 0 paces
+    // compaction by disk growth alone
+    uint64_t compaction_io_budget{0};
     int64_t file_size_db{512}; // truncate files to this size
     unsigned concurrent_read_io_limit{1024};
+    // if set, the concurrent read limit adapts to hold read p99 latency at
+    // this target, with concurrent_read_io_limit as its ceiling
+    std::optional<std::chrono::microseconds> read_io_target_p99{std::nullopt};
     // fixed history length if contains value, otherwise rely on db to adjust
     // history length upon disk usage
     std::optional<uint64_t> fixed_history_length{std::nullopt};
+    // zstd level for nodes written to the slow list, 0 stores them
+    // uncompressed. Readers decode either form regardless of this setting.
+    int slow_node_compression_level{0};
+    // the entries of `dbname_paths` on slower, larger storage. The slow list,
+    // which compaction fills with the nodes of older versions, is kept on
+    // them and the fast list on the rest, while each has free chunks. Reads
+    // go to either transparently
+    std::vector<std::filesystem::path> slow_tier_paths{};
 };
 
 struct ReadOnlyOnDiskDbConfig
@@ -59,7 +80,32 @@ struct ReadOnlyOnDiskDbConfig
     std::optional<unsigned> sq_thread_cpu{std::nullopt};
     std::vector<std::filesystem::path> dbname_paths;
     unsigned concurrent_read_io_limit{600};
+    // see OnDiskDbConfig::read_io_target_p99
+    std::optional<std::chrono::microseconds> read_io_target_p99{std::nullopt};
+    // read NVMe namespace sources through their generic character device,
+    // bypassing the block layer. Other sources use ordinary reads
+    bool nvme_passthrough{false};
     uint64_t node_lru_max_mem{100ul << 20}; // 100MB
+    // cache shared with other readers of the same database. When set,
+    // `node_lru_max_mem` is ignored
+    std::shared_ptr<ShardedNodeCache> node_cache{};
+    // when not 0, reads of versions more than `historical_version_distance`
+    // behind the latest go through a cache of their own of this size, so
+    // archive reads cannot evict the working set of recent versions
+    uint64_t historical_node_lru_max_mem{0};
+    uint64_t historical_version_distance{256};
+    // when set, finds walk cached nodes on the calling thread and read cache
+    // misses there with blocking reads, for as long as those reads take at
+    // most this long on average and no more than `inline_read_concurrency`
+    // finds are running. Otherwise misses go to the worker's async reads
+    std::optional<std::chrono::microseconds> inline_read_max_latency{
+        std::nullopt};
+    unsigned inline_read_concurrency{4};
+    // when not 0, the first find on a new latest version first reads into
+    // the node cache the nodes within this many levels of its root that the
+    // cache does not hold, with blocking reads on the calling thread. See
+    // warm_node_cache_blocking()
+    unsigned warm_node_cache_levels{0};
 };
 
 MONAD_MPT_NAMESPACE_END
@@ -0,0 +1,155 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/mpt/range_cursor.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/mpt/config.hpp>
+#include <category/mpt/nibbles_view.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/node_cursor.hpp>
+#include <category/mpt/trie.hpp>
+#include <category/mpt/util.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+RangeCursor::RangeCursor(
+    UpdateAuxImpl const &aux, NodeCursor const root, NibblesView const min,
+    NibblesView const max, uint64_t const version)
+    : aux_{aux}
+    , min_{min}
+    , max_{max}
+    , version_{version}
+    , root_{root}
+{
+}
+
+// whether any key starting with `prefix` can be in [min, max)
+bool RangeCursor::may_contain_range(NibblesView const prefix) const
+{
+    bool const below_min =
+        prefix < NibblesView{min_} && !NibblesView{min_}.starts_with(prefix);
+    return !below_min && prefix < NibblesView{max_};
+}
+
+// enters `node`, collecting its children that may hold keys in range and
+// reading the ones not in memory. Returns false if the version expired.
+bool RangeCursor::push(Node const *const node, Nibbles path)
+{
+    Frame frame{
+        .node = node,
+        .path = std::move(path),
+        .children = {},
+        .owned_children = {},
+        .next_child = 0};
+    // (child index, position in `children`) of the children to read
+    std::vector<std::pair<unsigned, size_t>> to_read;
+    for (auto const [idx, branch] : NodeChildrenRange(node->mask)) {
+        auto const prefix = concat(NibblesView{frame.path}, branch);
+        if (!may_contain_range(prefix)) {
+            continue;
+        }
+        frame.children.emplace_back(branch, node->next(idx));
+        if (frame.children.back().second == nullptr) {
+            to_read.emplace_back(idx, frame.children.size() - 1);
+        }
+    }
+    if (!to_read.empty()) {
+        MONAD_ASSERT(aux_.is_on_disk());
+        // read in disk order to keep the device streaming
+        std::ranges::sort(to_read, [node](auto const &a, auto const &b) {
+            return node->fnext(a.first).raw() < node->fnext(b.first).raw();
+        });
+        for (auto const &[idx, pos] : to_read) {
+            auto child = read_node_blocking(aux_, node->fnext(idx), version_);
+            if (!child) {
+                version_expired_ = true;
+                return false;
+            }
+            frame.children[pos].second = child.get();
+            frame.owned_children.emplace_back(std::move(child));
+        }
+    }
+    stack_.emplace_back(std::move(frame));
+    return true;
+}
+
+bool RangeCursor::next()
+{
+    if (version_expired_) {
+        return false;
+    }
+    if (!started_) {
+        started_ = true;
+        if (!root_.is_valid()) {
+            return false;
+        }
+        Nibbles path{
+            root_.node->path_nibble_view().substr(root_.prefix_index)};
+        if (!may_contain_range(path) ||
+            !push(root_.node, std::move(path))) {
+            return false;
+        }
+        auto const &top = stack_.back();
+        if (top.node->has_value() &&
+            NibblesView{top.path} >= NibblesView{min_}) {
+            return true;
+        }
+    }
+    while (!stack_.empty()) {
+        auto &top = stack_.back();
+        if (top.next_child == top.children.size()) {
+            stack_.pop_back();
+            continue;
+        }
+        auto const [branch, child] = top.children[top.next_child++];
+        auto path =
+            concat(NibblesView{top.path}, branch, child->path_nibble_view());
+        if (!may_contain_range(path)) {
+            continue;
+        }
+        if (!push(child, std::move(path))) {
+            stack_.clear();
+            return false;
+        }
+        auto const &entered = stack_.back();
+        if (entered.node->has_value() &&
+            NibblesView{entered.path} >= NibblesView{min_}) {
+            return true;
+        }
+    }
+    return false;
+}
+
+NibblesView RangeCursor::key() const
+{
+    MONAD_ASSERT(!stack_.empty());
+    return stack_.back().path;
+}
+
+byte_string_view RangeCursor::value() const
+{
+    MONAD_ASSERT(!stack_.empty());
+    return stack_.back().node->value();
+}
+
+MONAD_MPT_NAMESPACE_END
@@ -0,0 +1,80 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/mpt/config.hpp>
+#include <category/mpt/nibbles_view.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/node_cursor.hpp>
+#include <category/mpt/trie.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+// Forward cursor over the (key, value) pairs below a root whose key falls in
+// [min, max), in nibble order. Keys are relative to the root. Nodes that are
+// not in memory are read with blocking reads on the calling thread, all the
+// missing in range children of a node being read together when the node is
+// entered. The current key and value stay valid until the next call to
+// `next()`.
+class RangeCursor
+{
+    struct Frame
+    {
+        Node const *node;
+        Nibbles path;
+        // children still to visit, in range and in branch order
+        std::vector<std::pair<unsigned char, Node const *>> children;
+        std::vector<Node::UniquePtr> owned_children;
+        size_t next_child{0};
+    };
+
+    UpdateAuxImpl const &aux_;
+    Nibbles const min_;
+    Nibbles const max_;
+    uint64_t const version_;
+    NodeCursor root_;
+    std::vector<Frame> stack_;
+    bool started_{false};
+    bool version_expired_{false};
+
+    bool may_contain_range(NibblesView prefix) const;
+    bool push(Node const *, Nibbles path);
+
+public:
+    RangeCursor(
+        UpdateAuxImpl const &, NodeCursor root, NibblesView min,
+        NibblesView max, uint64_t version);
+
+    // advances to the next key in range, returns false once the range is
+    // exhausted or the version being read has expired
+    bool next();
+
+    NibblesView key() const;
+    byte_string_view value() const;
+
+    bool version_expired() const noexcept
+    {
+        return version_expired_;
+    }
+};
+
+MONAD_MPT_NAMESPACE_END
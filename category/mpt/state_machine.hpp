@@ -16,6 +16,7 @@
 #pragma once
 
 #include <category/mpt/config.hpp>
+#include <category/mpt/nibbles_view.hpp>
 
 #include <memory>
 #include <stddef.h>
@@ -30,6 +31,16 @@ struct StateMachine
     virtual std::unique_ptr<StateMachine> clone() const = 0;
     virtual void down(unsigned char nibble) = 0;
     virtual void up(size_t) = 0;
+
+    // Descend along a whole path. Machines that only track the depth past
+    // some prefix override this to step over the path in one call.
+    virtual void down_path(NibblesView const path)
+    {
+        for (unsigned i = 0; i < path.nibble_size(); ++i) {
+            down(path.get(i));
+        }
+    }
+
     virtual Compute &get_compute() const = 0;
     virtual bool cache() const = 0;
     virtual bool compact() const = 0;
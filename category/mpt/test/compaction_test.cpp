@@ -17,6 +17,8 @@
 #include "test_fixtures_gtest.hpp"
 
 #include <category/async/config.hpp>
+#include <category/core/byte_string.hpp>
+#include <category/core/hex_literal.hpp>
 #include <category/mpt/config.hpp>
 #include <category/mpt/node.hpp>
 #include <category/mpt/trie.hpp>
@@ -70,3 +72,30 @@ TEST_F(CompactionTest, first_chunk_is_compacted)
     // TODO DO COMPACTION
     // TODO CHECK POOL'S FIRST CHUNK WAS DEFINITELY RELEASED
 }
+
+TEST_F(CompactionTest, io_budget_defers_compaction)
+{
+    auto &aux = state()->aux;
+    // One byte per second never affords a whole 64Kb compaction unit
+    aux.set_compaction_io_budget(1);
+    auto const fast_head = aux.compact_offset_fast;
+    auto const slow_head = aux.compact_offset_slow;
+
+    UpdateList update_ls;
+    monad::byte_string const key(
+        0xabcdef01abcdef01abcdef01abcdef01abcdef01abcdef01abcdef01abcdef01_hex);
+    auto update = make_update(key, key, 0);
+    update_ls.push_front(update);
+    state()->root = aux.do_update(
+        std::move(state()->root),
+        state()->sm,
+        std::move(update_ls),
+        state()->version++,
+        true);
+
+    EXPECT_EQ(aux.compact_offset_fast, fast_head);
+    EXPECT_EQ(aux.compact_offset_slow, slow_head);
+    auto const backlog = aux.compaction_backlog();
+    EXPECT_GT(backlog.fast_bytes, 0);
+    aux.set_compaction_io_budget(0);
+}
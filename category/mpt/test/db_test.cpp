@@ -46,6 +46,7 @@
 #include <boost/fiber/future/promise.hpp>
 #include <boost/fiber/operations.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -55,6 +56,7 @@
 #include <deque>
 #include <filesystem>
 #include <functional>
+#include <future>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
@@ -403,6 +405,44 @@ TEST_F(OnDiskDbWithFileFixture, multiple_read_only_db_share_one_asyncio)
     verify_read(rodb2);
 }
 
+TEST_F(OnDiskDbWithFileFixture, read_only_db_ring_per_thread)
+{
+    auto const &kv = fixed_updates::kv;
+
+    auto const prefix = 0x00_hex;
+    uint64_t const block_id = 0x0;
+
+    upsert_updates_flat_list(
+        db,
+        prefix,
+        block_id,
+        make_update(kv[0].first, kv[0].second),
+        make_update(kv[1].first, kv[1].second));
+
+    AsyncIOContext shared_ctx{
+        ReadOnlyOnDiskDbConfig{.dbname_paths = {dbname}}};
+    std::vector<std::thread> readers;
+    std::atomic<unsigned> matched{0};
+    for (unsigned i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            AsyncIOContext io_ctx{
+                shared_ctx, ReadOnlyOnDiskDbConfig{.rd_buffers = 64}};
+            EXPECT_EQ(&io_ctx.pool, &shared_ctx.pool);
+            Db rodb{io_ctx};
+            if (rodb.get(prefix + kv[0].first, block_id).value() ==
+                    kv[0].second &&
+                rodb.get(prefix + kv[1].first, block_id).value() ==
+                    kv[1].second) {
+                ++matched;
+            }
+        });
+    }
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(matched, 4);
+}
+
 TEST_F(OnDiskDbWithFileFixture, read_only_db_single_thread)
 {
     auto const &kv = fixed_updates::kv;
@@ -526,6 +566,162 @@ TEST_F(ROOnDiskWithFileFixture, nonblocking_rodb)
     }
 }
 
+TEST_F(OnDiskDbWithFileFixture, rodb_inline_reads)
+{
+    constexpr unsigned keys_per_block = 10;
+    constexpr uint64_t num_blocks = 20;
+    for (unsigned b = 0; b < num_blocks; ++b) {
+        auto [kv_alloc, updates_alloc] =
+            prepare_random_updates(keys_per_block, b * keys_per_block);
+        UpdateList ls;
+        for (auto &u : updates_alloc) {
+            ls.push_front(u);
+        }
+        db.upsert(std::move(ls), b);
+    }
+
+    // every miss read inline, and only the probes read inline
+    for (auto const max_latency :
+         {std::chrono::microseconds{1000000}, std::chrono::microseconds{0}}) {
+        RODb ro_db{ReadOnlyOnDiskDbConfig{
+            .dbname_paths = this->config.dbname_paths,
+            .inline_read_max_latency = max_latency,
+            .inline_read_concurrency = 1}};
+        for (unsigned b = 0; b < num_blocks; ++b) {
+            for (unsigned i = 0; i < (b + 1) * keys_per_block; ++i) {
+                auto const kv_bytes = keccak_int_to_string(i);
+                auto const res = ro_db.find(kv_bytes, b);
+                ASSERT_TRUE(res.has_value());
+                EXPECT_EQ(res.value().node->value(), kv_bytes);
+            }
+            auto const missing =
+                keccak_int_to_string((b + 1) * keys_per_block);
+            EXPECT_EQ(ro_db.find(missing, b).error(), DbError::key_not_found);
+        }
+        EXPECT_TRUE(ro_db.find({}, num_blocks + 1).has_error());
+    }
+}
+
+TEST_F(OnDiskDbWithFileFixture, rodb_warms_latest_version)
+{
+    auto [kv_alloc, updates_alloc] = prepare_random_updates(1000);
+    UpdateList ls;
+    for (auto &u : updates_alloc) {
+        ls.push_front(u);
+    }
+    db.upsert(std::move(ls), 0);
+
+    auto const node_cache = std::make_shared<ShardedNodeCache>(10ul << 20);
+    RODb ro_db{ReadOnlyOnDiskDbConfig{
+        .dbname_paths = this->config.dbname_paths,
+        .node_cache = node_cache,
+        .warm_node_cache_levels = 2}};
+
+    // loading the root also read the two levels below it
+    ASSERT_TRUE(ro_db.find({}, 0).has_value());
+    auto const warmed = node_cache->size();
+    EXPECT_GT(warmed, 1u + 16u);
+    EXPECT_LE(warmed, 1u + 16u + 256u);
+
+    // a version is warmed once
+    ASSERT_TRUE(ro_db.find({}, 0).has_value());
+    EXPECT_EQ(node_cache->size(), warmed);
+}
+
+TEST_F(OnDiskDbWithFileFixture, read_only_db_find_async)
+{
+    constexpr unsigned keys_per_block = 10;
+    constexpr uint64_t num_blocks = 4;
+    for (unsigned b = 0; b < num_blocks; ++b) {
+        auto [kv_alloc, updates_alloc] =
+            prepare_random_updates(keys_per_block, b * keys_per_block);
+        UpdateList ls;
+        for (auto &u : updates_alloc) {
+            ls.push_front(u);
+        }
+        db.upsert(std::move(ls), b);
+    }
+
+    RODb ro_db{ReadOnlyOnDiskDbConfig{
+        .dbname_paths = this->config.dbname_paths,
+        .node_lru_max_mem = 100 * NodeCache::AVERAGE_NODE_SIZE}};
+    uint64_t const version = num_blocks - 1;
+    auto const root = ro_db.find({}, version);
+    ASSERT_TRUE(root.has_value());
+
+    // every key written so far and one that never was, none of them waited
+    // on by this thread until all are issued
+    unsigned const nkeys = num_blocks * keys_per_block;
+    std::atomic<unsigned> found{0};
+    std::atomic<unsigned> missing{0};
+    std::atomic<unsigned> remaining{nkeys + 1};
+    std::promise<void> all_done;
+    for (unsigned i = 0; i <= nkeys; ++i) {
+        auto const key = keccak_int_to_string(i);
+        ro_db.find_async(
+            root.value(),
+            key,
+            version,
+            [&, key](monad::Result<OwningNodeCursor> res) {
+                if (res.has_value() && res.value().node->value() == key) {
+                    found.fetch_add(1);
+                }
+                else if (
+                    res.has_error() && res.error() == DbError::key_not_found) {
+                    missing.fetch_add(1);
+                }
+                if (remaining.fetch_sub(1) == 1) {
+                    all_done.set_value();
+                }
+            });
+    }
+    all_done.get_future().wait();
+    EXPECT_EQ(found.load(), nkeys);
+    EXPECT_EQ(missing.load(), 1);
+
+    // an invalid cursor completes on the calling thread
+    bool invalid = false;
+    ro_db.find_async(
+        OwningNodeCursor{},
+        keccak_int_to_string(0),
+        version,
+        [&](monad::Result<OwningNodeCursor> res) {
+            invalid = res.has_error() &&
+                      res.error() == DbError::version_no_longer_exist;
+        });
+    EXPECT_TRUE(invalid);
+}
+
+TEST_F(OnDiskDbWithFileAsyncFixture, warm_node_cache)
+{
+    auto [kv_alloc, updates_alloc] = prepare_random_updates(1000);
+    UpdateList ls;
+    for (auto &u : updates_alloc) {
+        ls.push_front(u);
+    }
+    this->db.upsert(std::move(ls), 0);
+
+    // the root and the two levels below it, nearly full
+    auto const first = warm_node_cache_blocking(*ctx, 0);
+    EXPECT_GT(first, 1u + 16u);
+    EXPECT_LE(first, 1u + 16u + 256u);
+    EXPECT_EQ(ctx->node_cache.size(), first);
+    EXPECT_EQ(warm_node_cache_blocking(*ctx, 0), 0u);
+
+    // a single update writes a new spine and shares everything else
+    auto const value = 0xcafebabe_hex;
+    auto u = make_update(kv_alloc.front(), value);
+    UpdateList ul;
+    ul.push_front(u);
+    this->db.upsert(std::move(ul), 1);
+    auto const second = warm_node_cache_blocking(*ctx, 1);
+    EXPECT_GE(second, 1u);
+    EXPECT_LE(second, 3u);
+
+    // no such version
+    EXPECT_EQ(warm_node_cache_blocking(*ctx, 2), 0u);
+}
+
 TEST_F(OnDiskDbWithFileAsyncFixture, read_only_db_single_thread_async)
 {
     auto const &kv = fixed_updates::kv;
@@ -1344,6 +1540,78 @@ TYPED_TEST(DbTest, simple_with_same_prefix)
     EXPECT_FALSE(this->db.get(0x01_hex, block_id).has_value());
 }
 
+TYPED_TEST(DbTest, build_sorted_matches_upsert)
+{
+    auto const &kv = fixed_updates::kv;
+    auto const prefix0 = 0x00_hex;
+    auto const prefix1 = 0x01_hex;
+    uint64_t const block_id = 0x123;
+    auto [bytes_alloc, updates_alloc] = prepare_random_updates(1000);
+
+    // the same leaves upserted into an empty in memory db
+    StateMachineAlwaysMerkle machine;
+    Db expected{machine};
+    {
+        UpdateList ul0;
+        for (size_t i = 0; i < 4; ++i) {
+            ul0.push_front(updates_alloc.emplace_back(
+                make_update(kv[i].first, kv[i].second)));
+        }
+        UpdateList ul1;
+        for (size_t i = 0; i < 1000; ++i) {
+            ul1.push_front(updates_alloc[i]);
+        }
+        auto u0 = Update{
+            .key = prefix0,
+            .value = monad::byte_string_view{},
+            .incarnation = false,
+            .next = std::move(ul0)};
+        auto u1 = Update{
+            .key = prefix1,
+            .value = monad::byte_string_view{},
+            .incarnation = false,
+            .next = std::move(ul1)};
+        UpdateList ul;
+        ul.push_front(u0);
+        ul.push_front(u1);
+        expected.upsert(std::move(ul), block_id);
+    }
+
+    auto sorted_kv = kv;
+    std::ranges::sort(sorted_kv);
+    std::vector<monad::byte_string> sorted_keys{
+        bytes_alloc.begin(), bytes_alloc.end()};
+    std::ranges::sort(sorted_keys);
+    this->db.build_sorted(block_id, [&](SortedTrieBuilder &builder) {
+        auto const version = static_cast<int64_t>(block_id);
+        builder.add(prefix0, {}, version);
+        for (auto const &[k, v] : sorted_kv) {
+            builder.add(prefix0 + k, v, version);
+        }
+        builder.add(prefix1, {}, version);
+        for (auto const &k : sorted_keys) {
+            builder.add(prefix1 + k, k, version);
+        }
+    });
+
+    if (this->db.is_on_disk()) {
+        EXPECT_EQ(this->db.get_latest_version(), block_id);
+    }
+    EXPECT_EQ(
+        this->db.get_data(prefix0, block_id).value(),
+        0x22f3b7fc4b987d8327ec4525baf4cb35087a75d9250a8a3be45881dd889027ad_hex);
+    EXPECT_EQ(
+        this->db.get_data(prefix1, block_id).value(),
+        expected.get_data(prefix1, block_id).value());
+    for (auto const &[k, v] : kv) {
+        EXPECT_EQ(this->db.get(prefix0 + k, block_id).value(), v);
+    }
+    for (auto const &k : bytes_alloc) {
+        EXPECT_EQ(this->db.get(prefix1 + k, block_id).value(), k);
+    }
+    EXPECT_FALSE(this->db.get(0x02_hex, block_id).has_value());
+}
+
 TYPED_TEST(DbTest, simple_with_increasing_block_id_prefix)
 {
     auto const &kv = fixed_updates::kv;
@@ -1406,6 +1674,151 @@ TYPED_TEST(DbTest, simple_with_increasing_block_id_prefix)
     EXPECT_FALSE(this->db.get(0x01_hex, block_id).has_value());
 }
 
+TYPED_TEST(DbTest, find_many)
+{
+    auto const &kv = fixed_updates::kv;
+
+    auto const prefix = 0x00_hex;
+    uint64_t const block_id = 0x123;
+
+    upsert_updates_flat_list(
+        this->db,
+        prefix,
+        block_id,
+        make_update(kv[0].first, kv[0].second),
+        make_update(kv[1].first, kv[1].second),
+        make_update(kv[2].first, kv[2].second),
+        make_update(kv[3].first, kv[3].second));
+
+    std::vector<monad::byte_string> const keys{
+        prefix + kv[0].first,
+        prefix + kv[1].first,
+        0x01_hex,
+        prefix + kv[2].first,
+        prefix + kv[3].first};
+    std::vector<NibblesView> const views(keys.begin(), keys.end());
+    auto const results = this->db.find_many(views, block_id);
+    ASSERT_EQ(results.size(), keys.size());
+    EXPECT_EQ(results[0].value().node->value(), kv[0].second);
+    EXPECT_EQ(results[1].value().node->value(), kv[1].second);
+    EXPECT_FALSE(results[2].has_value());
+    EXPECT_EQ(results[3].value().node->value(), kv[2].second);
+    EXPECT_EQ(results[4].value().node->value(), kv[3].second);
+
+    auto const res = this->db.find(NibblesView{prefix}, block_id);
+    ASSERT_TRUE(res.has_value());
+    std::vector<NibblesView> const suffixes{kv[3].first, kv[2].first};
+    auto const under_prefix =
+        this->db.find_many(res.value(), suffixes, block_id);
+    ASSERT_EQ(under_prefix.size(), 2u);
+    EXPECT_EQ(under_prefix[0].value().node->value(), kv[3].second);
+    EXPECT_EQ(under_prefix[1].value().node->value(), kv[2].second);
+
+    EXPECT_TRUE(this->db.find_many({}, block_id).empty());
+}
+
+TYPED_TEST(DbTest, traverse_blocking_parallel)
+{
+    struct CollectValues : public TraverseMachine
+    {
+        std::vector<monad::byte_string> values;
+        size_t downs{0};
+        size_t ups{0};
+
+        virtual bool down(unsigned char const branch, Node const &node) override
+        {
+            ++downs;
+            if (node.has_value() && branch != INVALID_BRANCH) {
+                values.emplace_back(node.value());
+            }
+            return true;
+        }
+
+        virtual void up(unsigned char, Node const &) override
+        {
+            ++ups;
+        }
+
+        // clones start with no results of their own
+        virtual std::unique_ptr<TraverseMachine> clone() const override
+        {
+            auto machine = std::make_unique<CollectValues>();
+            machine->level = level;
+            return machine;
+        }
+    };
+
+    auto [kv_alloc, updates_alloc] = prepare_random_updates(2000);
+    UpdateList ls;
+    for (auto &u : updates_alloc) {
+        ls.push_front(u);
+    }
+    uint64_t const block_id = 0;
+    this->db.upsert(std::move(ls), block_id);
+
+    CollectValues serial;
+    ASSERT_TRUE(this->db.traverse_blocking(this->db.root(), serial, block_id));
+    EXPECT_EQ(serial.values.size(), kv_alloc.size());
+    EXPECT_EQ(serial.downs, serial.ups);
+
+    CollectValues parallel;
+    ASSERT_TRUE(this->db.traverse_blocking_parallel(
+        this->db.root(), parallel, block_id, 4, [&](TraverseMachine &m) {
+            auto &clone = static_cast<CollectValues &>(m);
+            parallel.values.insert(
+                parallel.values.end(),
+                clone.values.begin(),
+                clone.values.end());
+            parallel.downs += clone.downs;
+            parallel.ups += clone.ups;
+        }));
+    EXPECT_EQ(parallel.downs, serial.downs);
+    EXPECT_EQ(parallel.ups, serial.ups);
+    std::ranges::sort(serial.values);
+    std::ranges::sort(parallel.values);
+    EXPECT_EQ(parallel.values, serial.values);
+}
+
+TYPED_TEST(DbTest, range_cursor)
+{
+    auto [kv_alloc, updates_alloc] = prepare_random_updates(2000);
+    UpdateList ls;
+    for (auto &u : updates_alloc) {
+        ls.push_front(u);
+    }
+    uint64_t const block_id = 0;
+    this->db.upsert(std::move(ls), block_id);
+
+    std::vector<monad::byte_string> keys(kv_alloc.begin(), kv_alloc.end());
+    std::ranges::sort(keys);
+
+    auto const scan = [&](NibblesView const min, NibblesView const max) {
+        std::vector<monad::byte_string> values;
+        auto cursor = this->db.range(this->db.root(), min, max, block_id);
+        while (cursor.next()) {
+            values.emplace_back(cursor.value());
+        }
+        EXPECT_FALSE(cursor.version_expired());
+        return values;
+    };
+
+    // every key, in key order. The range starts after the empty key, as
+    // the fixtures store a value at the root
+    monad::byte_string const below_all(1, 0x00);
+    monad::byte_string const above_all(33, 0xff);
+    EXPECT_EQ(scan(below_all, above_all), keys);
+
+    // [keys[500], keys[1500])
+    auto const sub = scan(keys[500], keys[1500]);
+    EXPECT_EQ(
+        sub,
+        std::vector<monad::byte_string>(
+            keys.begin() + 500, keys.begin() + 1500));
+
+    // empty range
+    EXPECT_TRUE(scan(keys[10], keys[10]).empty());
+}
+
 template <typename TFixture>
 struct DbTraverseTest : public TFixture
 {
@@ -1786,6 +2199,101 @@ TEST(DbTest, auto_expire)
     }
 }
 
+TEST_F(OnDiskDbFixture, diff)
+{
+    auto const prefix = 0x00_hex;
+    auto const k1 = 0x12345678_hex;
+    auto const k2 = 0x12346678_hex;
+    auto const k3 = 0x12445678_hex;
+    auto const k4 = 0x22445678_hex;
+    auto const k5 = 0x12345679_hex;
+    auto const v1 = 0xcafebabe_hex;
+    auto const v2 = 0xdeadbeef_hex;
+
+    auto const write = [&](UpdateList ul, uint64_t const v) {
+        auto u_prefix = Update{
+            .key = prefix,
+            .value = monad::byte_string_view{},
+            .incarnation = false,
+            .next = std::move(ul)};
+        UpdateList ul_prefix;
+        ul_prefix.push_front(u_prefix);
+        this->db.upsert(std::move(ul_prefix), v);
+    };
+    {
+        Update u[] = {
+            make_update(k1, v1),
+            make_update(k2, v1),
+            make_update(k3, v1),
+            make_update(k4, v1)};
+        UpdateList ul;
+        for (auto &x : u) {
+            ul.push_front(x);
+        }
+        write(std::move(ul), 0);
+    }
+    {
+        // modify k1, delete k2 and add k5
+        Update u[] = {
+            make_update(k1, v2), make_erase(k2), make_update(k5, v2)};
+        UpdateList ul;
+        for (auto &x : u) {
+            ul.push_front(x);
+        }
+        write(std::move(ul), 1);
+    }
+
+    struct Change
+    {
+        Nibbles key;
+        std::optional<monad::byte_string> before;
+        std::optional<monad::byte_string> after;
+    };
+
+    auto const diff = [&](uint64_t const a, uint64_t const b) {
+        std::vector<Change> changes;
+        EXPECT_TRUE(this->db.diff(
+            prefix,
+            a,
+            b,
+            [&](NibblesView const key,
+                std::optional<monad::byte_string_view> const before,
+                std::optional<monad::byte_string_view> const after) {
+                auto &change =
+                    changes.emplace_back(Change{Nibbles{key}, {}, {}});
+                if (before.has_value()) {
+                    change.before.emplace(*before);
+                }
+                if (after.has_value()) {
+                    change.after.emplace(*after);
+                }
+            }));
+        return changes;
+    };
+
+    auto const forward = diff(0, 1);
+    ASSERT_EQ(forward.size(), 3u);
+    EXPECT_EQ(NibblesView{forward[0].key}, NibblesView{k1});
+    EXPECT_EQ(forward[0].before, v1);
+    EXPECT_EQ(forward[0].after, v2);
+    EXPECT_EQ(NibblesView{forward[1].key}, NibblesView{k5});
+    EXPECT_FALSE(forward[1].before.has_value());
+    EXPECT_EQ(forward[1].after, v2);
+    EXPECT_EQ(NibblesView{forward[2].key}, NibblesView{k2});
+    EXPECT_EQ(forward[2].before, v1);
+    EXPECT_FALSE(forward[2].after.has_value());
+
+    // the other way round, additions and deletions swap
+    auto const backward = diff(1, 0);
+    ASSERT_EQ(backward.size(), 3u);
+    EXPECT_EQ(NibblesView{backward[1].key}, NibblesView{k5});
+    EXPECT_EQ(backward[1].before, v2);
+    EXPECT_FALSE(backward[1].after.has_value());
+
+    EXPECT_TRUE(diff(1, 1).empty());
+    EXPECT_FALSE(this->db.diff(prefix, 0, 2, [](NibblesView, auto, auto) {}));
+}
+
 TEST_F(OnDiskDbFixture, copy_trie_from_to_same_version)
 {
     // insert random updates under a src prefix
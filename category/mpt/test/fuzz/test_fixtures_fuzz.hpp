@@ -31,7 +31,7 @@ namespace monad::test
     // Used to force Node's pool to be instanced now, not after the test fixture
     // exits
     static auto force_node_pool_instance_now =
-        allocators::aliasing_allocator_pair<Node>();
+        allocators::huge_slab_aliasing_allocator_pair<Node>();
 
     namespace detail
     {
@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <ostream>
+#include <vector>
 
 struct LoadAllTest
     : public monad::test::FillDBWithChunksGTest<
@@ -44,3 +45,29 @@ TEST_F(LoadAllTest, works)
     EXPECT_EQ(nodes_loaded, 0);
     std::cout << "   nodes_loaded = " << nodes_loaded << std::endl;
 }
+
+TEST_F(LoadAllTest, hinted)
+{
+    monad::test::UpdateAux<void> aux{&state()->io};
+    monad::test::StateMachineAlwaysMerkle sm;
+    std::vector<monad::mpt::chunk_offset_t> hint;
+    size_t expected = 0;
+    {
+        monad::mpt::Node::UniquePtr root{monad::mpt::read_node_blocking(
+            state()->aux,
+            aux.get_latest_root_offset(),
+            aux.db_history_max_version())};
+        expected = monad::mpt::load_all(aux, sm, *root);
+        hint = monad::mpt::collect_loaded_offsets(*root);
+        EXPECT_EQ(hint.size(), expected);
+    }
+    // reload a fresh root and warm it from the hint
+    monad::mpt::Node::UniquePtr root{monad::mpt::read_node_blocking(
+        state()->aux,
+        aux.get_latest_root_offset(),
+        aux.db_history_max_version())};
+    EXPECT_TRUE(monad::mpt::collect_loaded_offsets(*root).empty());
+    EXPECT_EQ(monad::mpt::load_all(aux, sm, *root, hint), expected);
+    EXPECT_EQ(monad::mpt::collect_loaded_offsets(*root).size(), expected);
+    EXPECT_EQ(monad::mpt::load_all(aux, sm, *root, hint), 0);
+}
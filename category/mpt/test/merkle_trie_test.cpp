@@ -569,6 +569,32 @@ TYPED_TEST(TrieTest, root_data_always_hashed)
         0xfb68c0ed148bf387cff736c64cc6acff3e89a6e6d722fba9b2eaf68f24ad5761_hex);
 }
 
+TEST(MerkleCompute, siblings_match_compute)
+{
+    // leaves whose references are inlined and hashed, more than four so
+    // that the batches are padded too
+    MerkleCompute compute;
+    auto const path = 0x1234_hex;
+    ChildData children[7];
+    for (unsigned char i = 0; i < 7; ++i) {
+        monad::byte_string const value(i % 2 ? 40u : 1u, i);
+        children[i].branch = i;
+        children[i].finalize(
+            make_node(0, {}, NibblesView{path}, value, {}, 0), compute, true);
+    }
+    compute_children_data(children);
+    for (auto &child : children) {
+        EXPECT_EQ(child.pending_compute, nullptr);
+        unsigned char expected[KECCAK256_SIZE];
+        auto const len = compute.compute(expected, child.ptr.get());
+        EXPECT_EQ(
+            (monad::byte_string_view{child.data, child.len}),
+            (monad::byte_string_view{expected, len}));
+    }
+    EXPECT_LT(children[0].len, KECCAK256_SIZE);
+    EXPECT_EQ(children[1].len, KECCAK256_SIZE);
+}
+
 TYPED_TEST(TrieTest, aux_do_update_fixed_history_len)
 {
     auto const prefix = 0x00_hex;
@@ -40,70 +40,8 @@
 using namespace ::monad::test;
 using namespace ::monad::mpt;
 
-TEST_F(OnDiskMerkleTrieGTest, min_truncated_offsets)
+namespace
 {
-    this->sm = std::make_unique<StateMachineAlways<MerkleCompute>>();
-
-    this->aux.alternate_slow_fast_node_writer_unit_testing_only(true);
-    constexpr size_t const eightMB = 8 * 1024 * 1024;
-
-    uint64_t const block_id = 0;
-    // ensure total bytes written on both fast and slow lists
-    auto ensure_total_bytes_written = [&](size_t fast_chunks,
-                                          size_t chunk_inner_offset_fast,
-                                          size_t slow_chunks,
-                                          size_t chunk_inner_offset_slow) {
-        monad::small_prng rand;
-        std::vector<std::pair<monad::byte_string, size_t>> keys;
-
-        std::vector<Update> updates;
-        updates.reserve(1000);
-        for (;;) {
-            UpdateList update_ls;
-            updates.clear();
-            for (size_t n = 0; n < 1000; n++) {
-                {
-                    monad::byte_string key(
-                        0x1234567812345678123456781234567812345678123456781234567812345678_hex);
-                    for (size_t n = 0; n < key.size(); n += 4) {
-                        *(uint32_t *)(key.data() + n) = rand();
-                    }
-                    keys.emplace_back(
-                        std::move(key), aux.get_latest_root_offset().id);
-                }
-                updates.push_back(
-                    make_update(keys.back().first, keys.back().first));
-                update_ls.push_front(updates.back());
-            }
-            root = upsert(
-                aux, block_id, *sm, std::move(root), std::move(update_ls));
-            size_t count_fast = 0;
-            for (auto const *ci = aux.db_metadata()->fast_list_begin();
-                 ci != nullptr;
-                 count_fast++, ci = ci->next(aux.db_metadata())) {
-            }
-            size_t count_slow = 0;
-            for (auto const *ci = aux.db_metadata()->slow_list_begin();
-                 ci != nullptr;
-                 count_slow++, ci = ci->next(aux.db_metadata())) {
-            }
-            if (count_fast >= fast_chunks &&
-                aux.node_writer_fast->sender().offset().offset >=
-                    chunk_inner_offset_fast &&
-                count_slow >= slow_chunks &&
-                aux.node_writer_slow->sender().offset().offset >=
-                    chunk_inner_offset_slow) {
-                break;
-            }
-        }
-    };
-    ensure_total_bytes_written(0, eightMB, 0, eightMB);
-
-    auto [trie_min_offset_fast, trie_min_offset_slow] =
-        calc_min_offsets(*this->root);
-    EXPECT_EQ(trie_min_offset_fast, 0);
-    EXPECT_EQ(trie_min_offset_slow, 0);
-
     struct TraverseCalculateAndVerifyMinTruncatedOffsets
         : public TraverseMachine
     {
@@ -207,8 +145,74 @@ TEST_F(OnDiskMerkleTrieGTest, min_truncated_offsets)
             return std::make_unique<
                 TraverseCalculateAndVerifyMinTruncatedOffsets>(*this);
         }
+    };
+}
 
-    } traverse{this->aux};
+TEST_F(OnDiskMerkleTrieGTest, min_truncated_offsets)
+{
+    this->sm = std::make_unique<StateMachineAlways<MerkleCompute>>();
+
+    this->aux.alternate_slow_fast_node_writer_unit_testing_only(true);
+    constexpr size_t const eightMB = 8 * 1024 * 1024;
+
+    uint64_t const block_id = 0;
+    // ensure total bytes written on both fast and slow lists
+    auto ensure_total_bytes_written = [&](size_t fast_chunks,
+                                          size_t chunk_inner_offset_fast,
+                                          size_t slow_chunks,
+                                          size_t chunk_inner_offset_slow) {
+        monad::small_prng rand;
+        std::vector<std::pair<monad::byte_string, size_t>> keys;
+
+        std::vector<Update> updates;
+        updates.reserve(1000);
+        for (;;) {
+            UpdateList update_ls;
+            updates.clear();
+            for (size_t n = 0; n < 1000; n++) {
+                {
+                    monad::byte_string key(
+                        0x1234567812345678123456781234567812345678123456781234567812345678_hex);
+                    for (size_t n = 0; n < key.size(); n += 4) {
+                        *(uint32_t *)(key.data() + n) = rand();
+                    }
+                    keys.emplace_back(
+                        std::move(key), aux.get_latest_root_offset().id);
+                }
+                updates.push_back(
+                    make_update(keys.back().first, keys.back().first));
+                update_ls.push_front(updates.back());
+            }
+            root = upsert(
+                aux, block_id, *sm, std::move(root), std::move(update_ls));
+            size_t count_fast = 0;
+            for (auto const *ci = aux.db_metadata()->fast_list_begin();
+                 ci != nullptr;
+                 count_fast++, ci = ci->next(aux.db_metadata())) {
+            }
+            size_t count_slow = 0;
+            for (auto const *ci = aux.db_metadata()->slow_list_begin();
+                 ci != nullptr;
+                 count_slow++, ci = ci->next(aux.db_metadata())) {
+            }
+            if (count_fast >= fast_chunks &&
+                aux.node_writer_fast->sender().offset().offset >=
+                    chunk_inner_offset_fast &&
+                count_slow >= slow_chunks &&
+                aux.node_writer_slow->sender().offset().offset >=
+                    chunk_inner_offset_slow) {
+                break;
+            }
+        }
+    };
+    ensure_total_bytes_written(0, eightMB, 0, eightMB);
+
+    auto [trie_min_offset_fast, trie_min_offset_slow] =
+        calc_min_offsets(*this->root);
+    EXPECT_EQ(trie_min_offset_fast, 0);
+    EXPECT_EQ(trie_min_offset_slow, 0);
+
+    TraverseCalculateAndVerifyMinTruncatedOffsets traverse{this->aux};
 
     // WARNING: test will fail and there are memory leak using parallel traverse
     ASSERT_TRUE(
@@ -216,3 +220,98 @@ TEST_F(OnDiskMerkleTrieGTest, min_truncated_offsets)
     EXPECT_EQ(traverse.level, 0);
     EXPECT_EQ(traverse.root_to_node_records.empty(), true);
 }
+
+TEST_F(OnDiskMerkleTrieGTest, compaction_writes_account_after_its_storage)
+{
+    this->sm = std::make_unique<StateMachineAlways<MerkleCompute>>();
+
+    uint64_t const block_id = 0;
+    auto const account =
+        0x1111111111111111111111111111111111111111111111111111111111111111_hex;
+    auto const other =
+        0x2222222222222222222222222222222222222222222222222222222222222222_hex;
+    monad::small_prng rand;
+    std::vector<monad::byte_string> slots;
+    for (size_t n = 0; n < 64; ++n) {
+        monad::byte_string slot(32, 0);
+        for (size_t i = 0; i < slot.size(); i += 4) {
+            *(uint32_t *)(slot.data() + i) = rand();
+        }
+        slots.emplace_back(std::move(slot));
+    }
+    std::vector<Update> slot_updates;
+    slot_updates.reserve(slots.size());
+    UpdateList storage;
+    for (auto const &slot : slots) {
+        slot_updates.push_back(make_update(slot, slot));
+        storage.push_front(slot_updates.back());
+    }
+    this->root = upsert_updates(
+        this->aux,
+        *this->sm,
+        std::move(this->root),
+        make_update(account, account, false, std::move(storage)),
+        make_update(other, other));
+
+    // Write well past the compaction unit holding the account, then move the
+    // fast list compaction head up to the writer, so that the next update
+    // compacts the untouched account and its storage
+    std::vector<monad::byte_string> fillers;
+    for (size_t n = 0; n < 2000; ++n) {
+        monad::byte_string filler(account);
+        for (size_t i = 4; i < filler.size(); i += 4) {
+            *(uint32_t *)(filler.data() + i) = rand();
+        }
+        filler[0] = 0x33;
+        fillers.emplace_back(std::move(filler));
+    }
+    std::vector<Update> filler_updates;
+    filler_updates.reserve(fillers.size());
+    UpdateList filler_ls;
+    for (auto const &filler : fillers) {
+        filler_updates.push_back(make_update(filler, filler));
+        filler_ls.push_front(filler_updates.back());
+    }
+    this->root = upsert(
+        this->aux,
+        block_id,
+        *this->sm,
+        std::move(this->root),
+        std::move(filler_ls));
+    auto const &sender = this->aux.node_writer_fast->sender();
+    this->aux.compact_offset_fast = compact_virtual_chunk_offset_t{
+        this->aux.physical_to_virtual(sender.offset().add_to_offset(
+            sender.written_buffer_bytes()))};
+    this->root = upsert_updates(
+        this->aux,
+        *this->sm,
+        std::move(this->root),
+        make_update(other, account));
+
+    auto const account_offset = this->root->fnext(
+        this->root->to_child_index(NibblesView{account}.get(0)));
+    EXPECT_FALSE(this->aux.physical_to_virtual(account_offset).in_fast_list());
+    auto const account_node =
+        read_node_blocking(this->aux, account_offset, block_id);
+    ASSERT_TRUE(account_node);
+    ASSERT_TRUE(account_node->has_value());
+    ASSERT_GT(account_node->number_of_children(), 1);
+    // The top of the storage trie is written back to back, in child order,
+    // and the account node follows directly
+    chunk_offset_t expected = account_node->fnext(0);
+    for (unsigned j = 0; j < account_node->number_of_children(); ++j) {
+        auto const offset = account_node->fnext(j);
+        EXPECT_EQ(offset.id, expected.id);
+        EXPECT_EQ(offset.offset, expected.offset);
+        auto const child = read_node_blocking(this->aux, offset, block_id);
+        ASSERT_TRUE(child);
+        expected = offset.add_to_offset(child->get_disk_size());
+    }
+    EXPECT_EQ(account_offset.id, expected.id);
+    EXPECT_EQ(account_offset.offset, expected.offset);
+
+    TraverseCalculateAndVerifyMinTruncatedOffsets traverse{this->aux};
+    ASSERT_TRUE(
+        preorder_traverse_blocking(this->aux, *this->root, traverse, block_id));
+    EXPECT_EQ(traverse.level, 0);
+}
@@ -755,7 +755,8 @@ int main(int argc, char *argv[])
                 uint64_t ops{0};
                 bool signal_done{false};
                 AsyncInflightNodes inflights;
-                NodeCache node_cache{1000 * NodeCache::AVERAGE_NODE_SIZE};
+                ShardedNodeCache node_cache{
+                    1000 * NodeCache::AVERAGE_NODE_SIZE};
                 std::vector<std::unique_ptr<connected_state_type>> states;
                 states.reserve(random_read_benchmark_threads);
                 std::shared_ptr<CacheNode> start_node =
@@ -20,6 +20,8 @@
 #include <category/core/nibble.h>
 #include <category/mpt/nibbles_view.hpp>
 
+#include <algorithm>
+
 #include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
 
 using namespace monad::mpt;
@@ -44,6 +46,41 @@ TEST(NibblesViewTest, nibbles_view)
     EXPECT_EQ(d, expected);
 }
 
+TEST(NibblesViewTest, common_prefix_size)
+{
+    constexpr unsigned size = 40;
+    for (unsigned const start_a : {0u, 1u}) {
+        for (unsigned const start_b : {0u, 1u}) {
+            for (unsigned mismatch = 0; mismatch <= size; ++mismatch) {
+                monad::byte_string a(size / 2 + 1, 0);
+                monad::byte_string b(size / 2 + 1, 0);
+                for (unsigned i = 0; i < size; ++i) {
+                    auto const nibble = static_cast<unsigned char>(i % 16);
+                    set_nibble(a.data(), start_a + i, nibble);
+                    set_nibble(b.data(), start_b + i, nibble);
+                }
+                if (mismatch < size) {
+                    set_nibble(
+                        b.data(),
+                        start_b + mismatch,
+                        static_cast<unsigned char>((mismatch + 1) % 16));
+                }
+                NibblesView const va{start_a, start_a + size, a.data()};
+                NibblesView const vb{start_b, start_b + size, b.data()};
+                EXPECT_EQ(va.common_prefix_size(vb), mismatch);
+                EXPECT_EQ(vb.common_prefix_size(va), mismatch);
+                EXPECT_EQ(va == vb, mismatch == size);
+                EXPECT_EQ(
+                    va.common_prefix_size(vb.substr(0, 20)),
+                    std::min(mismatch, 20u));
+                if (mismatch < size) {
+                    EXPECT_EQ(va < vb, mismatch % 16 != 15);
+                }
+            }
+        }
+    }
+}
+
 TEST(NibblesTest, concat_nibbles)
 {
     auto path =
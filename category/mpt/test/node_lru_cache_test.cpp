@@ -21,6 +21,8 @@
 #include <gtest/gtest.h>
 
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 using namespace monad::mpt;
 using namespace monad::literals;
@@ -98,3 +100,149 @@ TEST(NodeCache, works)
     ASSERT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(1, 0, 0)));
     EXPECT_EQ(get_acc_value(), 0xdead);
 }
+
+TEST(NodeCache, scan_resistant)
+{
+    NodeCache node_cache(10 * NodeCache::AVERAGE_NODE_SIZE);
+    NodeCache::ConstAccessor acc;
+
+    auto make_node = [] {
+        monad::byte_string value(84, 0);
+        return std::shared_ptr<CacheNode>{copy_node<CacheNode>(
+            monad::mpt::make_node(0, {}, {}, std::move(value), 0, 0).get())};
+    };
+
+    // hot nodes are hit once more after insertion and become protected
+    for (uint32_t i = 0; i < 4; ++i) {
+        node_cache.insert(virtual_chunk_offset_t(i, 0, 1), make_node());
+        ASSERT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(i, 0, 1)));
+    }
+    // a long scan of nodes that are never revisited
+    for (uint32_t i = 100; i < 200; ++i) {
+        ASSERT_FALSE(node_cache.find(acc, virtual_chunk_offset_t(i, 0, 1)));
+        node_cache.insert(virtual_chunk_offset_t(i, 0, 1), make_node());
+    }
+    EXPECT_EQ(node_cache.size(), 10);
+    EXPECT_EQ(node_cache.used_bytes(), 10 * NodeCache::AVERAGE_NODE_SIZE);
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(i, 0, 1)));
+    }
+    EXPECT_FALSE(node_cache.find(acc, virtual_chunk_offset_t(100, 0, 1)));
+
+    auto const &stats = node_cache.stats();
+    EXPECT_EQ(stats.hits, 8);
+    EXPECT_EQ(stats.misses, 101);
+    EXPECT_EQ(stats.evictions, 94);
+
+    node_cache.clear();
+    EXPECT_EQ(node_cache.size(), 0);
+    EXPECT_EQ(node_cache.used_bytes(), 0);
+    EXPECT_FALSE(node_cache.find(acc, virtual_chunk_offset_t(0, 0, 1)));
+}
+
+TEST(NodeCache, set_max_bytes)
+{
+    NodeCache node_cache(10 * NodeCache::AVERAGE_NODE_SIZE);
+    NodeCache::ConstAccessor acc;
+
+    auto make_node = [] {
+        monad::byte_string value(84, 0);
+        return std::shared_ptr<CacheNode>{copy_node<CacheNode>(
+            monad::mpt::make_node(0, {}, {}, std::move(value), 0, 0).get())};
+    };
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        node_cache.insert(virtual_chunk_offset_t(i, 0, 1), make_node());
+        if (i < 4) {
+            ASSERT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(i, 0, 1)));
+        }
+    }
+    ASSERT_EQ(node_cache.size(), 10);
+
+    // shrinking evicts the probationary nodes first
+    node_cache.set_max_bytes(5 * NodeCache::AVERAGE_NODE_SIZE);
+    EXPECT_EQ(node_cache.size(), 5);
+    EXPECT_EQ(node_cache.used_bytes(), 5 * NodeCache::AVERAGE_NODE_SIZE);
+    EXPECT_TRUE(node_cache.contains(virtual_chunk_offset_t(9, 0, 1)));
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(i, 0, 1)));
+    }
+
+    node_cache.set_max_bytes(2 * NodeCache::AVERAGE_NODE_SIZE);
+    EXPECT_EQ(node_cache.size(), 2);
+    EXPECT_TRUE(node_cache.find(acc, virtual_chunk_offset_t(3, 0, 1)));
+
+    // growing again admits new nodes up to the new budget
+    node_cache.set_max_bytes(10 * NodeCache::AVERAGE_NODE_SIZE);
+    for (uint32_t i = 20; i < 25; ++i) {
+        node_cache.insert(virtual_chunk_offset_t(i, 0, 1), make_node());
+    }
+    EXPECT_EQ(node_cache.size(), 7);
+}
+
+TEST(ShardedNodeCache, concurrent_readers)
+{
+    constexpr unsigned THREADS = 4;
+    constexpr uint32_t NODES_PER_THREAD = 1000;
+    // leave headroom so uneven sharding does not evict anything
+    ShardedNodeCache node_cache(
+        4 * THREADS * NODES_PER_THREAD * NodeCache::AVERAGE_NODE_SIZE, 8);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&node_cache, t] {
+            for (uint32_t i = 0; i < NODES_PER_THREAD; ++i) {
+                virtual_chunk_offset_t const key(t, i, 1);
+                EXPECT_EQ(node_cache.find(key), nullptr);
+                monad::byte_string value(84, 0);
+                memcpy(value.data(), &i, 4);
+                std::shared_ptr<CacheNode> node = copy_node<CacheNode>(
+                    monad::mpt::make_node(0, {}, {}, std::move(value), 0, 0)
+                        .get());
+                node_cache.insert(key, node);
+            }
+            // every thread sees the nodes inserted by the others
+            for (unsigned other = 0; other < THREADS; ++other) {
+                for (uint32_t i = 0; i < NODES_PER_THREAD; i += 100) {
+                    virtual_chunk_offset_t const key(other, i, 1);
+                    while (node_cache.find(key) == nullptr) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto const node = node_cache.find(virtual_chunk_offset_t(2, 42, 1));
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(*(uint32_t const *)node->value().data(), 42);
+    auto const stats = node_cache.stats();
+    EXPECT_GE(stats.misses, THREADS * NODES_PER_THREAD);
+    EXPECT_GE(stats.hits, THREADS * THREADS * 10);
+}
+
+TEST(ShardedNodeCache, single_threaded)
+{
+    ShardedNodeCache node_cache(
+        ShardedNodeCache::single_threaded, 2 * NodeCache::AVERAGE_NODE_SIZE);
+    auto const make = [](uint32_t const i) {
+        monad::byte_string value(84, 0);
+        memcpy(value.data(), &i, 4);
+        return std::shared_ptr<CacheNode>{copy_node<CacheNode>(
+            monad::mpt::make_node(0, {}, {}, std::move(value), 0, 0).get())};
+    };
+    for (uint32_t i = 0; i < 3; ++i) {
+        virtual_chunk_offset_t const key(i, 0, 1);
+        EXPECT_EQ(node_cache.find(key), nullptr);
+        node_cache.insert(key, make(i));
+    }
+    // one shard holds the whole budget
+    EXPECT_EQ(node_cache.size(), 2);
+    auto const node = node_cache.find(virtual_chunk_offset_t(2, 0, 1));
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(*(uint32_t const *)node->value().data(), 2);
+    EXPECT_EQ(node_cache.stats().hits, 1);
+}
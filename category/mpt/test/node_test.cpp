@@ -15,6 +15,7 @@
 
 #include <category/core/byte_string.hpp>
 #include <category/core/hex_literal.hpp>
+#include <category/core/unaligned.hpp>
 #include <category/mpt/compute.hpp>
 #include <category/mpt/nibbles_view.hpp>
 #include <category/mpt/node.hpp>
@@ -147,6 +148,39 @@ TEST(NodeTest, branch_node)
     EXPECT_EQ(node->get_disk_size(), 74);
 }
 
+TEST(NodeTest, next_pointers)
+{
+    DummyCompute comp{};
+    NibblesView const path1{12, 16, path.data()};
+
+    ChildData children[2] = {ChildData{.len = 1}, ChildData{.len = 2}};
+    children[0].data[0] = 0xa;
+    children[1].data[0] = 0xb;
+    children[1].data[1] = 0xc;
+    children[0].branch = 0x3;
+    children[1].branch = 0xe;
+    children[0].ptr = make_node(0, {}, path1, value, {}, 0);
+    children[1].ptr = make_node(0, {}, path1, value, {}, 0);
+    Node const *const child0 = children[0].ptr.get();
+    Node const *const child1 = children[1].ptr.get();
+
+    NibblesView const path2{1, 10, path.data()};
+    uint16_t const mask = (1u << 0x3) | (1u << 0xe);
+    Node::UniquePtr node{
+        create_node_with_children(comp, mask, children, path2, value, 0)};
+
+    // the next array follows the child data
+    auto const child_data_end =
+        node->child_data() + node->child_data_offset(2);
+    EXPECT_EQ(node->next_data(), child_data_end);
+    EXPECT_EQ(node->next(node->to_child_index(0x3)), child0);
+    EXPECT_EQ(node->next(node->to_child_index(0xe)), child1);
+    EXPECT_EQ(
+        node->get_disk_size(),
+        static_cast<uint32_t>(child_data_end - (unsigned char *)node.get()) +
+            Node::disk_size_bytes);
+}
+
 TEST(NodeTest, extension_node)
 {
     DummyCompute comp{};
@@ -185,3 +219,28 @@ TEST(NodeTest, super_large_node)
         node->get_disk_size(),
         value_len + sizeof(Node) + Node::disk_size_bytes);
 }
+
+TEST(NodeTest, compressed_round_trip)
+{
+    NibblesView const path1{1, 10, path.data()};
+    monad::byte_string const large_value(4096, 0x5a);
+    Node::UniquePtr node{make_node(0, {}, path1, large_value, {}, 0)};
+
+    auto const image = serialize_node_compressed(*node, 3);
+    ASSERT_FALSE(image.empty());
+    EXPECT_LT(image.size(), node->get_disk_size());
+    auto const size_word = monad::unaligned_load<uint32_t>(image.data());
+    EXPECT_TRUE(size_word & Node::disk_size_compressed_bit);
+    EXPECT_EQ(size_word & ~Node::disk_size_compressed_bit, image.size());
+
+    auto const read_back =
+        deserialize_node_from_buffer<Node>(image.data(), image.size());
+    EXPECT_EQ(read_back->mask, 0);
+    EXPECT_EQ(read_back->value(), large_value);
+    EXPECT_EQ(read_back->path_nibble_view(), path1);
+    EXPECT_EQ(read_back->get_disk_size(), node->get_disk_size());
+
+    // Small nodes are left uncompressed
+    Node::UniquePtr small{make_node(0, {}, path1, value, {}, 0)};
+    EXPECT_TRUE(serialize_node_compressed(*small, 3).empty());
+}
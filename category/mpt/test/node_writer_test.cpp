@@ -21,8 +21,13 @@
 #include <category/mpt/node.hpp>
 #include <category/mpt/trie.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
 
 using namespace MONAD_MPT_NAMESPACE;
 using namespace MONAD_ASYNC_NAMESPACE;
@@ -42,7 +47,8 @@ namespace
 
 template <
     size_t storage_pool_chunk_size = 1 << 28,
-    size_t storage_pool_num_chunks = 64, bool use_anonoymous_inode = true>
+    size_t storage_pool_num_chunks = 64, bool use_anonoymous_inode = true,
+    size_t write_buffer_size = AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE>
 struct NodeWriterTestBase : public ::testing::Test
 {
     static constexpr size_t chunk_size = storage_pool_chunk_size;
@@ -82,7 +88,7 @@ struct NodeWriterTestBase : public ::testing::Test
         , ring2{monad::io::RingConfig{4}}
         , rwbuf{monad::io::make_buffers_for_segregated_read_write(
               ring1, ring2, 2, 4, AsyncIO::MONAD_IO_BUFFERS_READ_SIZE,
-              AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE)}
+              write_buffer_size)}
         , io{pool, rwbuf}
         , aux{&io}
     {
@@ -231,3 +237,153 @@ TEST_F(NodeWriterTest, write_node_at_new_chunk)
     EXPECT_EQ(
         node_offset_chunk_count, get_writer_chunk_count(aux.node_writer_fast));
 }
+
+using NodeWriterLargeBufferTest =
+    NodeWriterTestBase<1 << 28, 64, true, 32 * 1024 * 1024>;
+
+TEST_F(NodeWriterLargeBufferTest, write_buffers_take_configured_size)
+{
+    auto const write_buffer_size = io.write_buffer_size();
+    EXPECT_EQ(write_buffer_size, 32 * 1024 * 1024);
+    EXPECT_EQ(
+        aux.node_writer_fast->sender().remaining_buffer_bytes(),
+        write_buffer_size);
+
+    // Nodes keep filling the one buffer well past the default buffer size
+    unsigned const node_disk_size = 1024 * 1024;
+    auto node = make_node_of_size(node_disk_size);
+    unsigned const num_nodes = unsigned(write_buffer_size / node_disk_size);
+    auto const chunk_id = get_writer_chunk_id(aux.node_writer_fast);
+    for (unsigned i = 0; i < num_nodes; ++i) {
+        auto const node_offset = async_write_node_set_spare(aux, *node, true);
+        EXPECT_EQ(node_offset.id, chunk_id);
+        EXPECT_EQ(node_offset.offset, node_disk_size * i);
+    }
+    EXPECT_EQ(aux.node_writer_fast->sender().remaining_buffer_bytes(), 0);
+
+    // and the next write buffer also takes the configured size
+    auto const node_offset = async_write_node_set_spare(aux, *node, true);
+    EXPECT_EQ(node_offset.offset, write_buffer_size);
+    EXPECT_EQ(
+        aux.node_writer_fast->sender().written_buffer_bytes(), node_disk_size);
+    EXPECT_EQ(
+        aux.node_writer_fast->sender().remaining_buffer_bytes(),
+        write_buffer_size - node_disk_size);
+}
+
+struct NodeWriterMultiDeviceTest : public ::testing::Test
+{
+    static constexpr size_t chunk_size = 1 << 24;
+    // a device of twice the capacity of the other
+    static constexpr size_t device_chunks[] = {16, 8};
+
+    std::vector<std::filesystem::path> paths;
+    storage_pool pool;
+    monad::io::Ring ring1;
+    monad::io::Ring ring2;
+    monad::io::Buffers rwbuf;
+    AsyncIO io;
+    UpdateAux<> aux;
+
+    NodeWriterMultiDeviceTest()
+        : pool{[this] {
+            for (size_t const chunks : device_chunks) {
+                char temppath[] = "monad_test_fixture_XXXXXX";
+                int const fd = mkstemp(temppath);
+                if (-1 == fd) {
+                    abort();
+                }
+                if (-1 == ftruncate(fd, (3 + chunks) * chunk_size + 24576)) {
+                    abort();
+                }
+                ::close(fd);
+                paths.emplace_back(temppath);
+            }
+            storage_pool::creation_flags flags;
+            flags.chunk_capacity = std::countr_zero(chunk_size);
+            return storage_pool(
+                paths, storage_pool::mode::create_if_needed, flags);
+        }()}
+        , ring1{monad::io::RingConfig{2}}
+        , ring2{monad::io::RingConfig{4}}
+        , rwbuf{monad::io::make_buffers_for_segregated_read_write(
+              ring1, ring2, 2, 4, AsyncIO::MONAD_IO_BUFFERS_READ_SIZE,
+              AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE)}
+        , io{pool, rwbuf}
+        , aux{&io}
+    {
+    }
+
+    ~NodeWriterMultiDeviceTest()
+    {
+        for (auto const &path : paths) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    size_t device_of(node_writer_unique_ptr_type const &node_writer) const
+    {
+        return pool.device_index(
+            storage_pool::seq, node_writer->sender().offset().id);
+    }
+
+    // Fills the rest of the writer's chunk so it moves onto a new one
+    void move_to_next_chunk(node_writer_unique_ptr_type &node_writer)
+    {
+        auto const id = node_writer->sender().offset().id;
+        while (node_writer->sender().offset().id == id) {
+            auto &sender = node_writer->sender();
+            sender.advance_buffer_append(sender.remaining_buffer_bytes());
+            auto new_node_writer = replace_node_writer(aux, node_writer);
+            MONAD_ASSERT(new_node_writer);
+            node_writer->initiate();
+            // shall be recycled by the i/o receiver
+            node_writer.release();
+            node_writer = std::move(new_node_writer);
+        }
+    }
+};
+
+TEST_F(NodeWriterMultiDeviceTest, fast_chunks_stripe_across_devices)
+{
+    auto previous = device_of(aux.node_writer_fast);
+    for (int i = 0; i < 6; ++i) {
+        move_to_next_chunk(aux.node_writer_fast);
+        auto const current = device_of(aux.node_writer_fast);
+        EXPECT_NE(current, previous);
+        previous = current;
+    }
+}
+
+TEST_F(NodeWriterMultiDeviceTest, slow_chunks_follow_device_capacity)
+{
+    for (int i = 0; i < 9; ++i) {
+        move_to_next_chunk(aux.node_writer_slow);
+    }
+    // Each device should have used about the same fraction of its chunks, so
+    // the larger device holds about twice as many
+    uint64_t used[2] = {0, 0};
+    uint64_t total[2] = {0, 0};
+    for (uint32_t id = 0; id < io.chunk_count(); ++id) {
+        auto const device = pool.device_index(storage_pool::seq, id);
+        auto const *ci = aux.db_metadata()->at(id);
+        total[device]++;
+        if (ci->in_fast_list || ci->in_slow_list) {
+            used[device]++;
+        }
+    }
+    EXPECT_EQ(used[0] + used[1], 11);
+    auto const skew = int64_t(used[0] * total[1]) - int64_t(used[1] * total[0]);
+    EXPECT_LE(std::abs(skew), int64_t(std::max(total[0], total[1])));
+}
+
+TEST_F(NodeWriterMultiDeviceTest, storage_tiers_keep_lists_apart)
+{
+    aux.set_slow_tier_devices({false, true});
+    for (int i = 0; i < 6; ++i) {
+        move_to_next_chunk(aux.node_writer_fast);
+        EXPECT_EQ(device_of(aux.node_writer_fast), 0);
+        move_to_next_chunk(aux.node_writer_slow);
+        EXPECT_EQ(device_of(aux.node_writer_slow), 1);
+    }
+}
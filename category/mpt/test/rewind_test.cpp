@@ -82,6 +82,9 @@ TEST_F(RewindTest, works)
     std::cout << "Setting max history to 9000 and reopening ..." << std::endl;
     aux.set_io(&io, 9000);
     EXPECT_EQ(991, aux.db_history_min_valid_version());
+    EXPECT_EQ(991, aux.db_metadata()->root_offsets.version_lower_bound_);
+    EXPECT_FALSE(aux.version_is_valid_ondisk(990));
+    EXPECT_TRUE(aux.version_is_valid_ondisk(991));
     EXPECT_EQ(9990, aux.db_history_max_version());
     EXPECT_EQ(aux.get_latest_voted_version(), monad::mpt::INVALID_BLOCK_NUM);
     EXPECT_EQ(aux.get_latest_voted_block_id(), monad::bytes32_t{});
@@ -65,9 +65,9 @@ namespace monad::test
 
     struct RootMerkleCompute : public MerkleCompute
     {
-        virtual unsigned compute(unsigned char *const, Node *const) override
+        virtual byte_string node_rlp(Node *const) override
         {
-            return 0;
+            return {};
         }
     };
 
@@ -0,0 +1,157 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/mpt/config.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/traverse.hpp>
+#include <category/mpt/trie.hpp>
+#include <category/mpt/util.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+namespace
+{
+    struct TraverseTask
+    {
+        unsigned char branch;
+        Node const *node;
+        Node::UniquePtr owned;
+        // state of the machine at the parent of `node`
+        std::unique_ptr<TraverseMachine> machine;
+        TraverseMachine *parent_machine;
+        bool expanded{false};
+        bool completed{true};
+
+        TraverseMachine &get_machine() const noexcept
+        {
+            return machine ? *machine : *parent_machine;
+        }
+    };
+}
+
+bool preorder_traverse_blocking_parallel(
+    UpdateAuxImpl &aux, Node const &root, TraverseMachine &machine,
+    uint64_t const version, unsigned const num_threads,
+    std::function<void(TraverseMachine &)> const &merge)
+{
+    MONAD_ASSERT(num_threads != 0);
+    size_t const target_tasks = size_t{num_threads} * 8;
+
+    // Expand the top of the trie breadth first on this thread until there
+    // are enough independent subtries to keep every thread busy.  Each
+    // expanded node is visited by the machine of its task, and each child
+    // gets a clone of that machine taken after the visit.  The list stays in
+    // preorder, which is the order machines are merged in.
+    std::list<TraverseTask> tasks;
+    tasks.push_back(TraverseTask{
+        .branch = INVALID_BRANCH,
+        .node = &root,
+        .owned = {},
+        .machine = {},
+        .parent_machine = &machine});
+    std::deque<std::list<TraverseTask>::iterator> frontier{tasks.begin()};
+    size_t pending = 1;
+    while (!frontier.empty() && pending < target_tasks) {
+        auto const it = frontier.front();
+        frontier.pop_front();
+        Node const &node = *it->node;
+        if (node.mask == 0) {
+            continue;
+        }
+        auto &m = it->get_machine();
+        it->expanded = true;
+        --pending;
+        ++m.level;
+        if (!m.down(it->branch, node)) {
+            --m.level;
+            continue;
+        }
+        auto pos = std::next(it);
+        for (auto const [idx, branch] : NodeChildrenRange(node.mask)) {
+            if (!m.should_visit(node, branch)) {
+                continue;
+            }
+            Node const *next = node.next(idx);
+            Node::UniquePtr owned;
+            if (next == nullptr) {
+                MONAD_ASSERT(aux.is_on_disk());
+                owned = read_node_blocking(aux, node.fnext(idx), version);
+                if (!owned) {
+                    return false;
+                }
+                next = owned.get();
+            }
+            auto const child = tasks.insert(
+                pos,
+                TraverseTask{
+                    .branch = branch,
+                    .node = next,
+                    .owned = std::move(owned),
+                    .machine = m.clone(),
+                    .parent_machine = nullptr});
+            frontier.push_back(child);
+            ++pending;
+        }
+        --m.level;
+        m.up(it->branch, node);
+    }
+
+    std::vector<TraverseTask *> leaves;
+    for (auto &task : tasks) {
+        if (!task.expanded) {
+            leaves.push_back(&task);
+        }
+    }
+    std::atomic<size_t> next_leaf{0};
+    auto const run = [&] {
+        for (size_t i = next_leaf.fetch_add(1, std::memory_order_relaxed);
+             i < leaves.size();
+             i = next_leaf.fetch_add(1, std::memory_order_relaxed)) {
+            auto &task = *leaves[i];
+            task.completed = detail::preorder_traverse_blocking_impl(
+                aux, task.branch, *task.node, task.get_machine(), version);
+            task.owned.reset();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned i = 1; i < num_threads && i < leaves.size(); ++i) {
+            threads.emplace_back(run);
+        }
+        run();
+    }
+
+    bool completed = true;
+    for (auto &task : tasks) {
+        completed &= task.completed;
+        if (task.machine) {
+            merge(*task.machine);
+        }
+    }
+    return completed;
+}
+
+MONAD_MPT_NAMESPACE_END
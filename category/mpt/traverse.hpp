@@ -24,8 +24,14 @@
 #include <category/mpt/trie.hpp>
 #include <category/mpt/util.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 #include <boost/container/deque.hpp>
 
@@ -53,6 +59,11 @@ struct TraverseMachine
 // TODO: move definitions out of header file
 namespace detail
 {
+    // Traversals back statesync serving and RPC scans, so their reads queue
+    // behind execution reads
+    inline constexpr auto traverse_io_priority =
+        async::erased_connected_operation::io_priority::idle;
+
     struct TraverseSender;
 
     void async_parallel_preorder_traverse_init(
@@ -154,43 +165,123 @@ namespace detail
             {
                 MONAD_ASSERT(buffer_);
                 --sender->outstanding_reads;
-                if (sender->version_expired_before_complete ||
-                    !sender->aux.version_is_valid_ondisk(sender->version)) {
-                    // async read failure or stopping initiated
-                    sender->version_expired_before_complete = true;
-                    sender->reads_to_initiate.clear();
-                    sender->reads_to_initiate_sidx = 0;
-                    sender->reads_to_initiate_eidx = 0;
-                    sender->reads_to_initiate_count = 0;
-                }
-                else { // version is valid after reading the buffer
-                    auto next_node_on_disk =
-                        deserialize_node_from_receiver_result<Node>(
-                            std::move(buffer_), buffer_off, io_state);
-                    sender->within_recursion_count++;
-                    async_parallel_preorder_traverse_impl(
-                        *sender,
-                        traverse_state,
-                        *next_node_on_disk,
-                        *machine,
-                        branch);
-                    sender->within_recursion_count--;
-                }
-                // complete async traverse if no outstanding io AND there is no
-                // recursive traverse call
-                // `async_parallel_preorder_traverse_impl()` in current stack,
-                // which means traverse is still in progress
-                if (sender->within_recursion_count == 0 &&
-                    sender->reads_to_initiate_count == 0 &&
-                    sender->outstanding_reads == 0) {
-                    traverse_state->completed(async::success());
+                if (sender->version_is_valid_after_read()) {
+                    descend(deserialize_node_from_receiver_result<Node>(
+                        std::move(buffer_), buffer_off, io_state));
                 }
+                sender->complete_if_done(traverse_state);
+            }
+
+            void descend(Node::UniquePtr next_node_on_disk)
+            {
+                sender->within_recursion_count++;
+                async_parallel_preorder_traverse_impl(
+                    *sender,
+                    traverse_state,
+                    *next_node_on_disk,
+                    *machine,
+                    branch);
+                sender->within_recursion_count--;
             }
         };
 
         static_assert(sizeof(receiver_t) == 40);
         static_assert(alignof(receiver_t) == 8);
 
+        /* Siblings are written next to each other, so a cold traversal
+        usually wants several nodes sharing one or two disk pages. This
+        receiver issues a single read spanning adjacent or overlapping node
+        reads in the same chunk, up to `READ_BUFFER_SIZE`, and fans the
+        buffer out to each of them on completion.
+        */
+        struct coalesced_receiver_t
+        {
+            static constexpr bool lifetime_managed_internally = true;
+
+            TraverseSender *sender;
+            async::erased_connected_operation *traverse_state;
+            chunk_offset_t rd_offset;
+            unsigned bytes_to_read;
+            std::vector<receiver_t> receivers;
+
+            explicit coalesced_receiver_t(receiver_t &&first)
+                : sender(first.sender)
+                , traverse_state(first.traverse_state)
+                , rd_offset(first.rd_offset)
+                , bytes_to_read(first.bytes_to_read)
+            {
+                receivers.emplace_back(std::move(first));
+            }
+
+            bool can_append(receiver_t const &next) const noexcept
+            {
+                if (next.rd_offset.id != rd_offset.id ||
+                    next.rd_offset.offset < rd_offset.offset) {
+                    return false;
+                }
+                size_t const begin = next.rd_offset.offset - rd_offset.offset;
+                return begin <= bytes_to_read &&
+                       std::max<size_t>(
+                           bytes_to_read, begin + next.bytes_to_read) <=
+                           async::AsyncIO::READ_BUFFER_SIZE;
+            }
+
+            void append(receiver_t &&next)
+            {
+                MONAD_DEBUG_ASSERT(can_append(next));
+                auto const begin =
+                    unsigned(next.rd_offset.offset - rd_offset.offset);
+                bytes_to_read =
+                    std::max(bytes_to_read, begin + next.bytes_to_read);
+                receivers.emplace_back(std::move(next));
+            }
+
+            template <class ResultType>
+            void set_value(
+                monad::async::erased_connected_operation *, ResultType buffer_)
+            {
+                MONAD_ASSERT(buffer_);
+                --sender->outstanding_reads;
+                if (sender->version_is_valid_after_read()) {
+                    std::vector<Node::UniquePtr> nodes;
+                    nodes.reserve(receivers.size());
+                    auto const deserialize = [&](auto const &buffer) {
+                        for (auto const &receiver : receivers) {
+                            size_t const off = receiver.rd_offset.offset -
+                                               rd_offset.offset +
+                                               receiver.buffer_off;
+                            MONAD_ASSERT(buffer.size() > off);
+                            nodes.emplace_back(
+                                deserialize_node_from_buffer<Node>(
+                                    (unsigned char const *)buffer.data() + off,
+                                    buffer.size() - off));
+                        }
+                    };
+                    using single_buffer_result_type =
+                        async::read_single_buffer_sender::result_type;
+                    if constexpr (std::is_same_v<
+                                      std::decay_t<ResultType>,
+                                      single_buffer_result_type>) {
+                        auto &buffer = std::move(buffer_).assume_value().get();
+                        deserialize(buffer);
+                        // Release the read buffer before issuing child reads
+                        buffer.reset();
+                    }
+                    else {
+                        MONAD_ASSERT(buffer_.assume_value().size() == 1);
+                        deserialize(buffer_.assume_value().front());
+                    }
+                    for (size_t i = 0; i < receivers.size(); ++i) {
+                        receivers[i].descend(std::move(nodes[i]));
+                        if (sender->version_expired_before_complete) {
+                            break;
+                        }
+                    }
+                }
+                sender->complete_if_done(traverse_state);
+            }
+        };
+
         using result_type = async::result<bool>;
 
         UpdateAuxImpl &aux;
@@ -237,20 +328,68 @@ namespace detail
             return async::success(!version_expired_before_complete);
         }
 
+        // Returns false and drops pending reads if the traversed version has
+        // expired while a read was in flight
+        bool version_is_valid_after_read()
+        {
+            if (version_expired_before_complete ||
+                !aux.version_is_valid_ondisk(version)) {
+                // async read failure or stopping initiated
+                version_expired_before_complete = true;
+                reads_to_initiate.clear();
+                reads_to_initiate_sidx = 0;
+                reads_to_initiate_eidx = 0;
+                reads_to_initiate_count = 0;
+                return false;
+            }
+            return true;
+        }
+
+        // complete async traverse if no outstanding io AND there is no
+        // recursive traverse call `async_parallel_preorder_traverse_impl()` in
+        // current stack, which means traverse is still in progress
+        void complete_if_done(async::erased_connected_operation *traverse_state)
+        {
+            if (within_recursion_count == 0 && reads_to_initiate_count == 0 &&
+                outstanding_reads == 0) {
+                traverse_state->completed(async::success());
+            }
+        }
+
+        // The caller accounts for the read in `outstanding_reads`
+        void initiate_read(coalesced_receiver_t &&group)
+        {
+            if (group.receivers.size() == 1) {
+                async_read(
+                    aux,
+                    std::move(group.receivers.front()),
+                    traverse_io_priority);
+            }
+            else {
+                async_read(aux, std::move(group), traverse_io_priority);
+            }
+        }
+
         void initiate_pending_reads()
         {
             auto idx = reads_to_initiate_eidx;
             while (outstanding_reads < max_outstanding_reads &&
                    idx > reads_to_initiate_sidx) {
+                auto &reads = reads_to_initiate[idx];
                 while (outstanding_reads < max_outstanding_reads &&
-                       !reads_to_initiate[idx].empty()) {
-                    async_read(aux, std::move(reads_to_initiate[idx].front()));
-                    ++outstanding_reads;
-                    reads_to_initiate[idx].pop_front();
+                       !reads.empty()) {
+                    coalesced_receiver_t group(std::move(reads.front()));
+                    reads.pop_front();
                     --reads_to_initiate_count;
+                    while (!reads.empty() && group.can_append(reads.front())) {
+                        group.append(std::move(reads.front()));
+                        reads.pop_front();
+                        --reads_to_initiate_count;
+                    }
+                    initiate_read(std::move(group));
+                    ++outstanding_reads;
                 }
-                if (reads_to_initiate[idx].empty() &&
-                    idx == reads_to_initiate_eidx) {
+                if (reads.empty() && idx == reads_to_initiate_eidx) {
                     --reads_to_initiate_eidx;
                 }
                 --idx;
@@ -299,6 +438,14 @@ namespace detail
             return;
         }
         unsigned children_read = 0;
+        // Reads of adjacent on-disk siblings are merged into one i/o
+        std::optional<TraverseSender::coalesced_receiver_t> group;
+        auto const flush_group = [&] {
+            if (group) {
+                sender.initiate_read(std::move(*group));
+                group.reset();
+            }
+        };
         for (auto const [idx, branch] : NodeChildrenRange(node.mask)) {
             if (machine.should_visit(node, branch)) {
                 auto const *const next = node.next(idx);
@@ -311,6 +458,9 @@ namespace detail
                         sender.reads_to_initiate_sidx = 0;
                         sender.reads_to_initiate_eidx = 0;
                         sender.reads_to_initiate_count = 0;
+                        if (group) {
+                            --sender.outstanding_reads;
+                        }
                         return;
                     }
                     TraverseSender::receiver_t receiver(
@@ -320,6 +470,10 @@ namespace detail
                         node.fnext(idx),
                         machine.clone());
                     unsigned const this_child_read = children_read++;
+                    if (group && group->can_append(receiver)) {
+                        group->append(std::move(receiver));
+                        continue;
+                    }
                     if (sender.outstanding_reads >=
                         sender.max_outstanding_reads) {
                         // The deepest reads get highest priority
@@ -346,10 +500,12 @@ namespace detail
                         ++sender.reads_to_initiate_count;
                         continue;
                     }
-                    async_read(sender.aux, std::move(receiver));
+                    flush_group();
+                    group.emplace(std::move(receiver));
                     ++sender.outstanding_reads;
                 }
                 else {
+                    flush_group();
                     async_parallel_preorder_traverse_impl(
                         sender, traverse_state, *next, machine, branch);
                     if (sender.version_expired_before_complete) {
@@ -358,6 +514,7 @@ namespace detail
                 }
             }
         }
+        flush_group();
     }
 }
 
@@ -416,4 +573,13 @@ inline bool preorder_traverse_ondisk(
     return !version_expired_before_traverse_complete;
 }
 
+// Multi threaded blocking traverse. The top of the trie is split into
+// independent subtries, each walked by one of `num_threads` threads with its
+// own clone of `machine`. Afterwards `merge` is called on the calling thread
+// with every clone, in preorder of the subtries they visited. Return value
+// indicates if we have done the full traversal or not.
+bool preorder_traverse_blocking_parallel(
+    UpdateAuxImpl &, Node const &, TraverseMachine &, uint64_t version,
+    unsigned num_threads, std::function<void(TraverseMachine &)> const &merge);
+
 MONAD_MPT_NAMESPACE_END
@@ -123,9 +123,7 @@ Node::UniquePtr upsert(
             if (updates.empty()) {
                 auto const old_path = old->path_nibble_view();
                 auto const old_path_nibbles_len = old_path.nibble_size();
-                for (unsigned n = 0; n < old_path_nibbles_len; ++n) {
-                    sm.down(old_path.get(n));
-                }
+                sm.down_path(old_path);
                 // simply dispatch empty update and potentially do compaction
                 Requests requests;
                 Node const &old_node = *old;
@@ -188,6 +186,47 @@ struct load_all_impl_
 
     size_t nodes_loaded{0};
 
+    // nodes read ahead of the walk, keyed by their on disk offset
+    unordered_dense_map<file_offset_t, Node::UniquePtr> preloaded;
+
+    struct preload_receiver_t
+    {
+        static constexpr bool lifetime_managed_internally = true;
+
+        load_all_impl_ *impl;
+        chunk_offset_t offset;
+
+        chunk_offset_t rd_offset{0, 0};
+        unsigned bytes_to_read;
+        uint16_t buffer_off;
+
+        preload_receiver_t(load_all_impl_ *impl, chunk_offset_t const offset)
+            : impl(impl)
+            , offset(offset)
+        {
+            auto const num_pages_to_load_node =
+                node_disk_pages_spare_15{offset}.to_pages();
+            bytes_to_read =
+                static_cast<unsigned>(num_pages_to_load_node << DISK_PAGE_BITS);
+            rd_offset = offset;
+            auto const new_offset =
+                round_down_align<DISK_PAGE_BITS>(offset.offset);
+            MONAD_DEBUG_ASSERT(new_offset <= chunk_offset_t::max_offset);
+            rd_offset.offset = new_offset & chunk_offset_t::max_offset;
+            buffer_off = uint16_t(offset.offset - rd_offset.offset);
+        }
+
+        template <class ResultType>
+        void set_value(erased_connected_operation *io_state, ResultType buffer_)
+        {
+            MONAD_ASSERT(buffer_);
+            impl->preloaded.emplace(
+                offset.raw(),
+                detail::deserialize_node_from_receiver_result<Node>(
+                    std::move(buffer_), buffer_off, io_state));
+        }
+    };
+
     struct receiver_t
     {
         static constexpr bool lifetime_managed_internally = true;
@@ -256,7 +295,17 @@ struct load_all_impl_
             }
             sm.down(i);
             if (sm.cache()) {
-                auto *const next = node->next(idx);
+                auto *next = node->next(idx);
+                if (next == nullptr) {
+                    if (auto it = preloaded.find(node->fnext(idx).raw());
+                        it != preloaded.end()) {
+                        auto g(aux.unique_lock());
+                        node->set_next(idx, std::move(it->second));
+                        preloaded.erase(it);
+                        next = node->next(idx);
+                        nodes_loaded++;
+                    }
+                }
                 if (next == nullptr) {
                     receiver_t receiver(this, *node, uint8_t(idx), sm.clone());
                     async_read(aux, std::move(receiver));
@@ -270,14 +319,59 @@ struct load_all_impl_
     }
 };
 
-size_t load_all(UpdateAuxImpl &aux, StateMachine &sm, NodeCursor const root)
+size_t load_all(
+    UpdateAuxImpl &aux, StateMachine &sm, NodeCursor const root,
+    std::span<chunk_offset_t const> const hint)
 {
     load_all_impl_ impl(aux);
+    if (!hint.empty()) {
+        // read every hinted node up front in disk order, so the walk below
+        // does not wait on one read per trie level
+        std::vector<chunk_offset_t> offsets(hint.begin(), hint.end());
+        std::ranges::sort(offsets, [](auto const &a, auto const &b) {
+            return a.raw() < b.raw();
+        });
+        offsets.erase(
+            std::unique(
+                offsets.begin(),
+                offsets.end(),
+                [](auto const &a, auto const &b) {
+                    return a.raw() == b.raw();
+                }),
+            offsets.end());
+        for (auto const &offset : offsets) {
+            if (offset.id < aux.io->chunk_count()) {
+                async_read(
+                    aux, load_all_impl_::preload_receiver_t{&impl, offset});
+            }
+        }
+        aux.io->wait_until_done();
+    }
     impl.process(root, sm);
     aux.io->wait_until_done();
     return impl.nodes_loaded;
 }
 
+std::vector<chunk_offset_t> collect_loaded_offsets(NodeCursor const root)
+{
+    std::vector<chunk_offset_t> offsets;
+    if (!root.is_valid()) {
+        return offsets;
+    }
+    std::vector<Node *> stack{root.node};
+    while (!stack.empty()) {
+        Node *const node = stack.back();
+        stack.pop_back();
+        for (auto const [idx, i] : NodeChildrenRange(node->mask)) {
+            if (auto *const next = node->next(idx); next != nullptr) {
+                offsets.push_back(node->fnext(idx));
+                stack.push_back(next);
+            }
+        }
+    }
+    return offsets;
+}
+
 /////////////////////////////////////////////////////
 // Async read and update
 /////////////////////////////////////////////////////
@@ -772,6 +866,7 @@ Node::UniquePtr create_node_from_children_if_any(
     MONAD_DEBUG_ASSERT(
         number_of_children > 1 ||
         (number_of_children == 1 && leaf_data.has_value()));
+    compute_children_data(children);
     // write children to disk, free any if exceeds the cache level limit
     if (aux.is_on_disk()) {
         for (auto &child : children) {
@@ -911,9 +1006,7 @@ void create_new_trie_(
         Update &update = updates.front();
         MONAD_DEBUG_ASSERT(update.value.has_value());
         auto const path = update.key.substr(prefix_index);
-        for (auto i = 0u; i < path.nibble_size(); ++i) {
-            sm.down(path.get(i));
-        }
+        sm.down_path(path);
         MONAD_DEBUG_ASSERT(update.value.has_value());
         MONAD_ASSERT(
             !sm.is_variable_length() || update.next.empty(),
@@ -1009,6 +1102,161 @@ void create_new_trie_from_requests_(
     }
 }
 
+/////////////////////////////////////////////////////
+// Build a new trie from sorted leaves
+/////////////////////////////////////////////////////
+
+SortedTrieBuilder::SortedTrieBuilder(UpdateAuxImpl &aux, StateMachine &sm)
+    : aux_{aux}
+    , sm_{sm}
+{
+}
+
+// `sm_` always sits at a prefix of `key_`, so moving it only needs the
+// nibbles of `key_`
+void SortedTrieBuilder::move_sm(unsigned const depth)
+{
+    if (depth < sm_depth_) {
+        sm_.up(sm_depth_ - depth);
+    }
+    for (unsigned i = sm_depth_; i < depth; ++i) {
+        sm_.down(key_.get(i));
+    }
+    sm_depth_ = depth;
+}
+
+// Create the node of `level`, whose path starts at nibble `start` of `key_`.
+// Writes its children out unless they are cached.
+Node::UniquePtr SortedTrieBuilder::make(Level &level, unsigned const start)
+{
+    MONAD_ASSERT(start <= level.depth);
+    move_sm(level.depth);
+    auto node = create_node_from_children_if_any(
+        aux_,
+        sm_,
+        level.mask,
+        level.mask,
+        level.children,
+        NibblesView{key_}.substr(start, level.depth - start),
+        level.value.transform(
+            [](byte_string const &v) { return byte_string_view{v}; }),
+        level.version);
+    MONAD_ASSERT(node);
+    return node;
+}
+
+void SortedTrieBuilder::attach(Level &parent, Level child)
+{
+    MONAD_ASSERT(parent.depth < child.depth);
+    auto node = make(child, parent.depth + 1);
+    // `sm_` is now at the end of the child, where its hash is computed
+    ChildData &entry = parent.children.emplace_back();
+    entry.branch = key_.get(parent.depth);
+    MONAD_ASSERT((parent.mask >> entry.branch) == 0);
+    parent.mask |= static_cast<uint16_t>(1u << entry.branch);
+    parent.version = std::max(parent.version, node->version);
+    entry.finalize(std::move(node), sm_.get_compute(), sm_.cache());
+}
+
+// Finish every node of `key_` below `depth` and hang the result at the open
+// node at `depth`, which is created if no open node sits there yet
+void SortedTrieBuilder::close_to(unsigned const depth)
+{
+    Level cur = std::move(leaf_);
+    while (!levels_.empty() && levels_.back().depth > depth) {
+        attach(levels_.back(), std::move(cur));
+        cur = std::move(levels_.back());
+        levels_.pop_back();
+    }
+    if (levels_.empty() || levels_.back().depth < depth) {
+        levels_.push_back(Level{.depth = depth});
+    }
+    attach(levels_.back(), std::move(cur));
+}
+
+void SortedTrieBuilder::add(
+    NibblesView const key, byte_string_view const value,
+    int64_t const version)
+{
+    if (!empty_) {
+        unsigned common = 0;
+        unsigned const max_common =
+            std::min(key_.nibble_size(), key.nibble_size());
+        while (common < max_common && key_.get(common) == key.get(common)) {
+            ++common;
+        }
+        MONAD_ASSERT(
+            common < key.nibble_size() &&
+                (common == key_.nibble_size() ||
+                 key_.get(common) < key.get(common)),
+            "SortedTrieBuilder keys must be strictly increasing");
+        if (common == key_.nibble_size()) {
+            // the last key is a prefix of this one, its leaf becomes an
+            // open node
+            levels_.push_back(std::move(leaf_));
+        }
+        else {
+            close_to(common);
+        }
+        if (sm_depth_ > common) {
+            move_sm(common);
+        }
+    }
+    empty_ = false;
+    key_ = Nibbles{key};
+    leaf_ = Level{
+        .depth = key.nibble_size(),
+        .value = byte_string{value},
+        .version = version};
+}
+
+Node::UniquePtr SortedTrieBuilder::finish()
+{
+    if (empty_) {
+        return {};
+    }
+    Level cur = std::move(leaf_);
+    while (!levels_.empty()) {
+        attach(levels_.back(), std::move(cur));
+        cur = std::move(levels_.back());
+        levels_.pop_back();
+    }
+    auto root = make(cur, 0);
+    move_sm(0);
+    empty_ = true;
+    return root;
+}
+
+Node::UniquePtr build_sorted(
+    UpdateAuxImpl &aux, uint64_t const version, StateMachine &sm,
+    std::function<void(SortedTrieBuilder &)> const &fill,
+    bool const write_root)
+{
+    auto impl = [&] {
+        aux.reset_stats();
+        SortedTrieBuilder builder{aux, sm};
+        fill(builder);
+        auto root = builder.finish();
+        if (aux.is_on_disk() && root) {
+            if (write_root) {
+                write_new_root_node(aux, *root, version);
+            }
+            else {
+                flush_buffered_writes(aux);
+            }
+        }
+        return root;
+    };
+    if (aux.is_current_thread_upserting()) {
+        return impl();
+    }
+    else {
+        auto g(aux.unique_lock());
+        auto g2(aux.set_current_upsert_tid());
+        return impl();
+    }
+}
+
 /////////////////////////////////////////////////////
 // Update existing subtrie
 /////////////////////////////////////////////////////
@@ -1274,6 +1522,8 @@ void mismatch_handler_(
                 make_node(old, path_suffix, old.opt_value(), old.version),
                 sm.get_compute(),
                 sm.cache());
+            // the node may be moved out below to be expired or compacted
+            child.compute_data();
             MONAD_DEBUG_ASSERT(child.offset == INVALID_OFFSET);
             // Note that it is possible that we recreate this node later after
             // done expiring all subtries under it
@@ -1458,6 +1708,8 @@ void compact_(
             std::move(tnode),
             node_offset,
             copy_node_for_fast_or_slow);
+        // Not at idle priority: upsert waits for every compaction read it
+        // issues, so throttling them would only hold up the commit
         async_read(aux, std::move(receiver));
         return;
     }
@@ -1480,6 +1732,7 @@ void compact_(
 
     Node &node = *tnode->node;
     tnode->rewrite_to_fast = rewrite_to_fast;
+    tnode->cluster = node.has_value() && node.number_of_children() > 0;
     aux.collect_compacted_nodes_stats(
         copy_node_for_fast_or_slow,
         rewrite_to_fast,
@@ -1507,27 +1760,32 @@ void compact_(
     try_fillin_parent_with_rewritten_node(aux, std::move(tnode));
 }
 
-void try_fillin_parent_with_rewritten_node(
-    UpdateAuxImpl &aux, CompactTNode::unique_ptr_type tnode)
+struct rewritten_node_result
+{
+    chunk_offset_t offset;
+    compact_virtual_chunk_offset_t min_offset_fast;
+    compact_virtual_chunk_offset_t min_offset_slow;
+};
+
+// Writes a compacted node whose subtrie is all on disk, to the fast list when
+// asked to or when its subtrie has nodes there
+rewritten_node_result
+write_rewritten_node(UpdateAuxImpl &aux, Node &node, bool rewrite_to_fast)
 {
-    if (tnode->npending) { // there are unfinished async below node
-        tnode.release();
-        return;
-    }
     auto [min_offset_fast, min_offset_slow] =
-        calc_min_offsets(*tnode->node, INVALID_VIRTUAL_OFFSET);
+        calc_min_offsets(node, INVALID_VIRTUAL_OFFSET);
     // If subtrie contains nodes from fast list, write itself to fast list too
     if (min_offset_fast != INVALID_COMPACT_VIRTUAL_OFFSET) {
-        tnode->rewrite_to_fast = true; // override that
+        rewrite_to_fast = true; // override that
     }
     auto const new_offset =
-        async_write_node_set_spare(aux, *tnode->node, tnode->rewrite_to_fast);
+        async_write_node_set_spare(aux, node, rewrite_to_fast);
     auto const new_node_virtual_offset = aux.physical_to_virtual(new_offset);
     MONAD_DEBUG_ASSERT(new_node_virtual_offset != INVALID_VIRTUAL_OFFSET);
     compact_virtual_chunk_offset_t const truncated_new_virtual_offset{
         new_node_virtual_offset};
     // update min offsets in subtrie
-    if (tnode->rewrite_to_fast) {
+    if (rewrite_to_fast) {
         min_offset_fast =
             std::min(min_offset_fast, truncated_new_virtual_offset);
     }
@@ -1537,8 +1795,63 @@ void try_fillin_parent_with_rewritten_node(
     }
     MONAD_DEBUG_ASSERT(min_offset_fast >= aux.compact_offset_fast);
     MONAD_DEBUG_ASSERT(min_offset_slow >= aux.compact_offset_slow);
+    return {new_offset, min_offset_fast, min_offset_slow};
+}
+
+// Writes the children held back by a cluster node back to back, so the node
+// lands right after. They all go to the fast list if any of them or the node
+// needs it, which moves a child that would have gone to the slow list on its
+// own to the fast list.
+void write_held_children(UpdateAuxImpl &aux, CompactTNode &tnode)
+{
+    Node &node = *tnode.node;
+    for (unsigned mask = tnode.held_mask; mask != 0; mask &= mask - 1) {
+        auto const index = static_cast<unsigned>(std::countr_zero(mask));
+        Node::UniquePtr child = node.move_next(index);
+        MONAD_ASSERT(child);
+        auto const [offset, min_offset_fast, min_offset_slow] =
+            write_rewritten_node(aux, *child, tnode.rewrite_to_fast);
+        node.set_fnext(index, offset);
+        node.set_min_offset_fast(index, min_offset_fast);
+        node.set_min_offset_slow(index, min_offset_slow);
+        if (tnode.held_cache_mask & (1u << index)) {
+            node.set_next(index, std::move(child));
+        }
+    }
+    tnode.held_mask = 0;
+    tnode.held_cache_mask = 0;
+}
+
+void try_fillin_parent_with_rewritten_node(
+    UpdateAuxImpl &aux, CompactTNode::unique_ptr_type tnode)
+{
+    if (tnode->npending) { // there are unfinished async below node
+        tnode.release();
+        return;
+    }
+    write_held_children(aux, *tnode);
     auto *parent = tnode->parent;
     auto const index = tnode->index;
+    if (parent->type == tnode_type::compact && parent->cluster) {
+        // hold the node back for its parent to write, in the list wanted by
+        // any of the nodes written together, so a node headed for the slow
+        // list may end up in the fast list
+        auto const min_offset_fast =
+            calc_min_offsets(*tnode->node, INVALID_VIRTUAL_OFFSET).first;
+        parent->rewrite_to_fast |= tnode->rewrite_to_fast ||
+                                   min_offset_fast !=
+                                       INVALID_COMPACT_VIRTUAL_OFFSET;
+        auto const bit = static_cast<uint16_t>(1u << index);
+        parent->held_mask |= bit;
+        if (tnode->cache_node) {
+            parent->held_cache_mask |= bit;
+        }
+        parent->node->set_next(index, std::move(tnode->node));
+        --parent->npending;
+        return;
+    }
+    auto const [new_offset, min_offset_fast, min_offset_slow] =
+        write_rewritten_node(aux, *tnode->node, tnode->rewrite_to_fast);
     if (parent->type == tnode_type::update) {
         auto *const p = reinterpret_cast<UpdateTNode *>(parent);
         MONAD_DEBUG_ASSERT(tnode->cache_node);
@@ -1581,9 +1894,9 @@ node_writer_unique_ptr_type replace_node_writer_to_start_at_new_chunk(
     auto *sender = &node_writer->sender();
     bool const in_fast_list =
         aux.db_metadata()->at(sender->offset().id)->in_fast_list;
-    auto const *ci_ = aux.db_metadata()->free_list_end();
-    MONAD_ASSERT(ci_ != nullptr); // we are out of free blocks!
-    auto idx = ci_->index(aux.db_metadata());
+    auto idx = aux.next_free_chunk(
+        in_fast_list ? UpdateAuxImpl::chunk_list::fast
+                     : UpdateAuxImpl::chunk_list::slow);
     chunk_offset_t const offset_of_new_writer{idx, 0};
     // Pad buffer of existing node write that is about to get initiated so it's
     // O_DIRECT i/o aligned
@@ -1625,10 +1938,10 @@ node_writer_unique_ptr_type replace_node_writer_to_start_at_new_chunk(
             reentrancy_detection.max_count);
         reentrancy_detection.max_count = my_reentrancy_count;
     }
+    auto const write_buffer_size = aux.io->write_buffer_size();
     auto ret = aux.io->make_connected(
-        write_single_buffer_sender{
-            offset_of_new_writer, AsyncIO::WRITE_BUFFER_SIZE},
-        write_operation_io_receiver{AsyncIO::WRITE_BUFFER_SIZE});
+        write_single_buffer_sender{offset_of_new_writer, write_buffer_size},
+        write_operation_io_receiver{write_buffer_size});
     reentrancy_detection.count--;
     MONAD_ASSERT(reentrancy_detection.count >= 0);
     // The deepest-most reentrancy must succeed, and all less deep reentrancies
@@ -1670,16 +1983,17 @@ node_writer_unique_ptr_type replace_node_writer(
     if (offset == chunk_capacity) {
         // If after the current write buffer we're hitting chunk capacity, we
         // replace writer to the start of next chunk.
-        ci_ = aux.db_metadata()->free_list_end();
-        MONAD_ASSERT(ci_ != nullptr); // we are out of free blocks!
-        idx = ci_->index(aux.db_metadata());
+        idx = aux.next_free_chunk(
+            in_fast_list ? UpdateAuxImpl::chunk_list::fast
+                         : UpdateAuxImpl::chunk_list::slow);
+        ci_ = aux.db_metadata()->at(idx);
         offset_of_next_writer.id = idx & 0xfffffU;
         offset_of_next_writer.offset = 0;
     }
     // See above about handling potential reentrancy correctly
     auto *const node_writer_ptr = node_writer.get();
     size_t const bytes_to_write = std::min(
-        AsyncIO::WRITE_BUFFER_SIZE,
+        aux.io->write_buffer_size(),
         (size_t)(chunk_capacity - offset_of_next_writer.offset));
     auto ret = aux.io->make_connected(
         write_single_buffer_sender{offset_of_next_writer, bytes_to_write},
@@ -1689,7 +2003,7 @@ node_writer_unique_ptr_type replace_node_writer(
         return {};
     }
     if (ci_ != nullptr) {
-        MONAD_DEBUG_ASSERT(ci_ == aux.db_metadata()->free_list_end());
+        MONAD_DEBUG_ASSERT(!ci_->in_fast_list && !ci_->in_slow_list);
         aux.remove(idx);
         aux.append(
             in_fast_list ? UpdateAuxImpl::chunk_list::fast
@@ -1702,12 +2016,31 @@ node_writer_unique_ptr_type replace_node_writer(
 // return physical offset the node is written at
 async_write_node_result async_write_node(
     UpdateAuxImpl &aux, node_writer_unique_ptr_type &node_writer,
-    Node const &node)
+    Node const &node, int const compression_level)
 {
+    // A compressed node is written as an opaque byte image, everything else
+    // serializes straight from the node
+    byte_string const compressed =
+        compression_level ? serialize_node_compressed(node, compression_level)
+                          : byte_string{};
+    auto const size = compressed.empty()
+                          ? node.get_disk_size()
+                          : static_cast<uint32_t>(compressed.size());
+    auto const serialize = [&](unsigned char *const write_pos,
+                               unsigned const bytes_to_append,
+                               unsigned const offset = 0) {
+        if (compressed.empty()) {
+            serialize_node_to_buffer(
+                write_pos, bytes_to_append, node, size, offset);
+        }
+        else {
+            MONAD_ASSERT(offset + bytes_to_append <= size);
+            memcpy(write_pos, compressed.data() + offset, bytes_to_append);
+        }
+    };
 retry:
     aux.io->poll_nonblocking_if_not_within_completions(1);
     auto *sender = &node_writer->sender();
-    auto const size = node.get_disk_size();
     auto const remaining_bytes = sender->remaining_buffer_bytes();
     async_write_node_result ret{
         .offset_written_to = INVALID_OFFSET,
@@ -1719,8 +2052,7 @@ retry:
             sender->offset().add_to_offset(sender->written_buffer_bytes());
         auto *where_to_serialize = sender->advance_buffer_append(size);
         MONAD_DEBUG_ASSERT(where_to_serialize != nullptr);
-        serialize_node_to_buffer(
-            (unsigned char *)where_to_serialize, size, node, size);
+        serialize((unsigned char *)where_to_serialize, size);
     }
     else {
         auto const chunk_remaining_bytes =
@@ -1748,12 +2080,8 @@ retry:
                 (unsigned char *)node_writer->sender().advance_buffer_append(
                     bytes_to_append);
             MONAD_DEBUG_ASSERT(where_to_serialize != nullptr);
-            serialize_node_to_buffer(
-                where_to_serialize,
-                bytes_to_append,
-                node,
-                size,
-                offset_in_on_disk_node);
+            serialize(
+                where_to_serialize, bytes_to_append, offset_in_on_disk_node);
             offset_in_on_disk_node += bytes_to_append;
             new_node_writer = replace_node_writer(aux, node_writer);
             if (!new_node_writer) {
@@ -1785,12 +2113,8 @@ retry:
             auto bytes_to_append = std::min(
                 (unsigned)node_writer->sender().remaining_buffer_bytes(),
                 size - offset_in_on_disk_node);
-            serialize_node_to_buffer(
-                where_to_serialize,
-                bytes_to_append,
-                node,
-                size,
-                offset_in_on_disk_node);
+            serialize(
+                where_to_serialize, bytes_to_append, offset_in_on_disk_node);
             offset_in_on_disk_node += bytes_to_append;
             MONAD_ASSERT(offset_in_on_disk_node <= size);
             MONAD_ASSERT(
@@ -1827,15 +2151,17 @@ async_write_node_set_spare(UpdateAuxImpl &aux, Node &node, bool write_to_fast)
         aux.set_can_write_to_fast(!aux.can_write_to_fast());
     }
 
-    auto off = async_write_node(
-                   aux,
-                   write_to_fast ? aux.node_writer_fast : aux.node_writer_slow,
-                   node)
-                   .offset_written_to;
+    auto const written = async_write_node(
+        aux,
+        write_to_fast ? aux.node_writer_fast : aux.node_writer_slow,
+        node,
+        write_to_fast ? 0 : aux.slow_node_compression_level());
+    auto off = written.offset_written_to;
     MONAD_ASSERT(
         (write_to_fast && aux.db_metadata()->at(off.id)->in_fast_list) ||
         (!write_to_fast && aux.db_metadata()->at(off.id)->in_slow_list));
-    unsigned const pages = num_pages(off.offset, node.get_disk_size());
+    // Compressed nodes occupy fewer pages than their uncompressed size
+    unsigned const pages = num_pages(off.offset, written.bytes_appended);
     off.set_spare(static_cast<uint16_t>(node_disk_pages_spare_15{pages}));
     return off;
 }
@@ -22,6 +22,7 @@
 #include <category/mpt/config.hpp>
 #include <category/mpt/detail/collected_stats.hpp>
 #include <category/mpt/detail/db_metadata.hpp>
+#include <category/mpt/nibbles_view.hpp>
 #include <category/mpt/node.hpp>
 #include <category/mpt/node_cursor.hpp>
 #include <category/mpt/state_machine.hpp>
@@ -46,9 +47,12 @@
 
 #include <atomic>
 #include <bit>
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
 // temporary
@@ -176,6 +180,8 @@ node_writer_unique_ptr_type
 replace_node_writer(UpdateAuxImpl &, node_writer_unique_ptr_type const &);
 
 // \class Auxiliaries for triedb update
+class SortedTrieBuilder;
+
 class UpdateAuxImpl
 {
     uint32_t initial_insertion_count_on_pool_creation_{0};
@@ -189,6 +195,14 @@ class UpdateAuxImpl
     } db_metadata_[2]; // two copies, to prevent sudden process
                        // exits making the DB irretrievable
 
+    // For pools spanning several devices, the device of each sequential chunk
+    // and how many sequential chunks each device has. Empty otherwise.
+    std::vector<uint32_t> chunk_device_;
+    std::vector<uint32_t> device_chunk_count_;
+    // Per device, whether it is in the slow tier. Empty when all devices are
+    // one tier.
+    std::vector<bool> slow_tier_device_;
+
     void reset_node_writers();
 
     void advance_compact_offsets();
@@ -234,11 +248,26 @@ class UpdateAuxImpl
         MIN_COMPACT_VIRTUAL_OFFSET};
     compact_virtual_chunk_offset_t compact_offset_range_slow_{
         MIN_COMPACT_VIRTUAL_OFFSET};
+    // compaction I/O budget: bytes of compaction range granted per second,
+    // zero leaves compaction paced by disk growth alone
+    uint64_t compaction_bytes_per_sec_{0};
+    // unspent budget carried between upserts, so idle gaps between blocks
+    // bank credit for the next one
+    double compaction_credit_bytes_{0};
+    std::chrono::steady_clock::time_point compaction_credit_refilled_at_{};
+    // range wanted in the last block but held back by the budget, in
+    // compact units
+    uint32_t compaction_deferred_fast_{0};
+    uint32_t compaction_deferred_slow_{0};
+
+    uint32_t grant_compaction_budget(uint32_t wanted) noexcept;
 
     std::optional<pid_t> current_upsert_tid_; // used to detect what thread is
                                               // currently upserting
     bool alternate_slow_fast_writer_{false};
     bool can_write_to_fast_{true};
+    // zstd level used for nodes written to the slow list, 0 disables
+    int slow_node_compression_level_{0};
 
     virtual void lock_unique_() const = 0;
 
@@ -556,6 +585,13 @@ public:
         uint64_t version, bool compaction = false,
         bool can_write_to_fast = true, bool write_root = true);
 
+    // Builds the first version of an empty db from sorted leaves, see
+    // `SortedTrieBuilder`
+    Node::UniquePtr do_build(
+        StateMachine &, std::function<void(SortedTrieBuilder &)> const &fill,
+        uint64_t version, bool can_write_to_fast = true,
+        bool write_root = true);
+
     void adjust_history_length_based_on_disk_usage();
     void move_trie_version_forward(uint64_t src, uint64_t dest);
 
@@ -571,6 +607,22 @@ public:
 
     void print_update_stats(uint64_t version);
 
+    // Limit how fast compaction ranges may advance. Work held back is carried
+    // to later blocks; 0 removes the limit.
+    void set_compaction_io_budget(uint64_t bytes_per_sec) noexcept;
+
+    struct compaction_backlog_t
+    {
+        // bytes between each ring's compaction head and its write head, as of
+        // the latest version on disk
+        uint64_t fast_bytes{0};
+        uint64_t slow_bytes{0};
+        // compaction range held back by the I/O budget in the last upsert
+        uint64_t deferred_bytes{0};
+    };
+
+    compaction_backlog_t compaction_backlog() const;
+
     enum class chunk_list : uint8_t
     {
         free = 0,
@@ -657,6 +709,31 @@ public:
                     (o != INVALID_OFFSET) ? i : uint64_t(-1));
             }
 
+            // Invalidate every version from the lower bound up to and
+            // including `version` in one pass, then move the lower bound
+            // once, instead of rescanning after each slot as `assign()` does.
+            void clear_up_to_and_including(uint64_t const version) noexcept
+            {
+                auto const lower_bound =
+                    version_lower_bound_.load(std::memory_order_acquire);
+                auto const end = std::min(version, max_version()) + 1;
+                if (end <= lower_bound) {
+                    return;
+                }
+                // slots older than one ring's worth alias newer versions
+                auto const begin = std::max(
+                    lower_bound,
+                    end - std::min<uint64_t>(end, root_offsets_chunks_.size()));
+                for (uint64_t i = begin; i < end; i++) {
+                    start_lifetime_as<std::atomic<chunk_offset_t>>(
+                        &root_offsets_chunks_
+                            [i & (root_offsets_chunks_.size() - 1)])
+                        ->store(INVALID_OFFSET, std::memory_order_release);
+                }
+                version_lower_bound_.store(end, std::memory_order_release);
+                update_version_lower_bound_();
+            }
+
             chunk_offset_t operator[](size_t const i) const noexcept
             {
                 return start_lifetime_as<std::atomic<chunk_offset_t> const>(
@@ -714,6 +791,16 @@ public:
     void append(chunk_list list, uint32_t idx) noexcept;
     void remove(uint32_t idx) noexcept;
 
+    /* Returns the free chunk the fast or slow list should grow into next.
+    With one device this is the end of the free list. With several, the fast
+    list stripes round robin across devices so consecutive fast chunks land on
+    different devices, and the slow list goes to whichever device has the
+    largest fraction of its chunks free, so slow data fills devices in
+    proportion to their capacity. With storage tiers set, each list only
+    considers the devices of its own tier while any of those has a free chunk.
+    */
+    uint32_t next_free_chunk(chunk_list list) const noexcept;
+
     template <typename Func, typename... Args>
         requires std::invocable<
             std::function<void(detail::db_metadata *, Args...)>,
@@ -735,6 +822,9 @@ public:
     void update_history_length_metadata(uint64_t history_len) noexcept;
     void set_latest_finalized_version(uint64_t version) noexcept;
     void set_latest_verified_version(uint64_t version) noexcept;
+    // Both versions in one pass over each metadata copy
+    void set_latest_finalized_and_verified_version(
+        uint64_t finalized, uint64_t verified) noexcept;
     void set_latest_voted(uint64_t version, bytes32_t const &block_id) noexcept;
     uint64_t get_latest_finalized_version() const noexcept;
     uint64_t get_latest_verified_version() const noexcept;
@@ -776,6 +866,27 @@ public:
         can_write_to_fast_ = v;
     }
 
+    int slow_node_compression_level() const noexcept
+    {
+        return slow_node_compression_level_;
+    }
+
+    void set_slow_node_compression_level(int level) noexcept
+    {
+        slow_node_compression_level_ = level;
+    }
+
+    // Puts the slow list on the devices flagged, and the fast list on the
+    // others, while each tier has free chunks. Compaction then moves nodes
+    // that outlive the fast ring onto the slow tier.
+    void set_slow_tier_devices(std::vector<bool> slow_tier_device)
+    {
+        MONAD_ASSERT(
+            slow_tier_device.empty() ||
+            slow_tier_device.size() == device_chunk_count_.size());
+        slow_tier_device_ = std::move(slow_tier_device);
+    }
+
     constexpr bool is_in_memory() const noexcept
     {
         return io == nullptr;
@@ -852,7 +963,7 @@ public:
 };
 
 static_assert(
-    sizeof(UpdateAuxImpl) == 160 + sizeof(detail::TrieUpdateCollectedStats));
+    sizeof(UpdateAuxImpl) == 280 + sizeof(detail::TrieUpdateCollectedStats));
 static_assert(alignof(UpdateAuxImpl) == 8);
 
 template <lockable_or_void LockType = void>
@@ -997,7 +1108,10 @@ template <receiver Receiver>
         MONAD_ASYNC_NAMESPACE::compatible_sender_receiver<
             read_long_update_sender, Receiver> &&
         Receiver::lifetime_managed_internally)
-void async_read(UpdateAuxImpl &aux, Receiver &&receiver)
+void async_read(
+    UpdateAuxImpl &aux, Receiver &&receiver,
+    enum async::erased_connected_operation::io_priority const prio =
+        async::erased_connected_operation::io_priority::normal)
 {
     [[likely]] if (
         receiver.bytes_to_read <=
@@ -1005,6 +1119,7 @@ void async_read(UpdateAuxImpl &aux, Receiver &&receiver)
         read_short_update_sender sender(receiver);
         auto iostate =
             aux.io->make_connected(std::move(sender), std::move(receiver));
+        iostate->set_io_priority(prio);
         iostate->initiate();
         // TEMPORARY UNTIL ALL THIS GETS BROKEN OUT: Release
         // management until i/o completes
@@ -1016,6 +1131,7 @@ void async_read(UpdateAuxImpl &aux, Receiver &&receiver)
             decltype(connect(*aux.io, std::move(sender), std::move(receiver)));
         auto *iostate = new connected_type(
             connect(*aux.io, std::move(sender), std::move(receiver)));
+        iostate->set_io_priority(prio);
         iostate->initiate();
         // drop iostate
     }
@@ -1026,6 +1142,53 @@ Node::UniquePtr upsert(
     UpdateAuxImpl &, uint64_t, StateMachine &, Node::UniquePtr old,
     UpdateList &&, bool write_root = true);
 
+// Builds a new trie bottom up from leaves added in strictly increasing key
+// order, where a key may also be a prefix of the keys added after it. A node
+// is created, hashed and written out exactly once, as soon as no later key
+// can fall under it, so nothing is read back or rewritten and memory is
+// bounded by the trie depth plus whatever the state machine caches.
+class SortedTrieBuilder
+{
+    struct Level
+    {
+        unsigned depth{0}; // nibbles of the key down to this node's children
+        std::optional<byte_string> value{};
+        int64_t version{0};
+        uint16_t mask{0};
+        std::vector<ChildData> children{};
+    };
+
+    UpdateAuxImpl &aux_;
+    StateMachine &sm_;
+    // open nodes on the path of `key_`, by increasing depth
+    std::vector<Level> levels_;
+    // the last key added, whose leaf is not yet in `levels_`
+    Nibbles key_;
+    Level leaf_;
+    bool empty_{true};
+    // `sm_` is positioned at this many nibbles of `key_`
+    unsigned sm_depth_{0};
+
+    void move_sm(unsigned depth);
+    Node::UniquePtr make(Level &, unsigned start);
+    void attach(Level &parent, Level child);
+    void close_to(unsigned depth);
+
+public:
+    SortedTrieBuilder(UpdateAuxImpl &, StateMachine &);
+
+    void add(NibblesView key, byte_string_view value, int64_t version);
+    // returns the root, or nullptr if no leaf was added
+    Node::UniquePtr finish();
+};
+
+// build a trie from sorted leaves, the sorted counterpart of `upsert` on an
+// empty trie
+Node::UniquePtr build_sorted(
+    UpdateAuxImpl &, uint64_t, StateMachine &,
+    std::function<void(SortedTrieBuilder &)> const &fill,
+    bool write_root = true);
+
 // Performs a deep copy of a subtrie from `src_root` trie at
 // `src_prefix` to the `dest_root` trie at `dest_prefix`.
 // Note that `src_root` may be of a different version than `dest_root`.
@@ -1036,8 +1199,25 @@ Node::UniquePtr copy_trie_to_dest(
     uint64_t src_version, Node::UniquePtr dest_root, NibblesView dest_prefx,
     uint64_t const dest_version, bool must_write_to_disk);
 
-// load all nodes as far as caching policy would allow
-size_t load_all(UpdateAuxImpl &, StateMachine &, NodeCursor);
+// Reads the nodes on the path to `dest_prefix` below `dest_root` that are not
+// in memory, so that a later copy_trie_to_dest() into a root no one else
+// uses does no reads on the thread doing the db writes. Stops where the path
+// leaves the trie. Only the spine is read: the copy shares every subtrie
+// below it by offset.
+void load_copy_path_blocking(
+    UpdateAuxImpl const &, Node &dest_root, NibblesView dest_prefix,
+    uint64_t dest_version);
+
+// load all nodes as far as caching policy would allow. Nodes at the `hint`
+// offsets are read together first in disk order, and attached wherever the
+// walk meets them, instead of being read one trie level at a time
+size_t load_all(
+    UpdateAuxImpl &, StateMachine &, NodeCursor,
+    std::span<chunk_offset_t const> hint = {});
+
+// on disk offsets of all nodes below `root` that are currently in memory,
+// suitable as a `load_all` hint after a restart
+std::vector<chunk_offset_t> collect_loaded_offsets(NodeCursor root);
 
 //////////////////////////////////////////////////////////////////////////////
 // find
@@ -1083,7 +1263,7 @@ static_assert(sizeof(fiber_find_request_t) == 40);
 static_assert(alignof(fiber_find_request_t) == 8);
 static_assert(std::is_trivially_copyable_v<fiber_find_request_t> == true);
 
-class NodeCache;
+class ShardedNodeCache;
 
 //! \warning this is not threadsafe, should only be called from triedb thread
 // during execution, DO NOT invoke it directly from a transaction fiber, as is
@@ -1095,13 +1275,28 @@ void find_notify_fiber_future(
 
 // rodb
 void find_owning_notify_fiber_future(
-    UpdateAuxImpl &, NodeCache &, inflight_map_owning_t &,
+    UpdateAuxImpl &, ShardedNodeCache &, inflight_map_owning_t &,
     threadsafe_boost_fibers_promise<find_owning_cursor_result_type> &promise,
     OwningNodeCursor &start, NibblesView, uint64_t version);
 
+// A rodb find that hands its result to `done` on the triedb thread instead of
+// to a waiting fiber, so that nothing but this request is held while its
+// reads are in flight. `done` must not block.
+struct find_owning_callback_t
+{
+    Nibbles key;
+    std::function<void(find_owning_cursor_result_type)> done;
+};
+
+// rodb, frees `find` once `done` has been called
+void find_owning_notify_callback(
+    UpdateAuxImpl &, ShardedNodeCache &, inflight_map_owning_t &,
+    std::unique_ptr<find_owning_callback_t> find, OwningNodeCursor &start,
+    uint64_t version);
+
 // rodb load root
 void load_root_notify_fiber_future(
-    UpdateAuxImpl &, NodeCache &, inflight_map_owning_t &,
+    UpdateAuxImpl &, ShardedNodeCache &, inflight_map_owning_t &,
     threadsafe_boost_fibers_promise<find_owning_cursor_result_type> &promise,
     uint64_t version);
 
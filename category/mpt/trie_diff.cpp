@@ -0,0 +1,283 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/mpt/trie_diff.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/mpt/config.hpp>
+#include <category/mpt/nibbles_view.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/trie.hpp>
+#include <category/mpt/util.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+namespace
+{
+    // Side 0 is `version_a` and side 1 `version_b`. Every node is read from
+    // disk, so a subtrie in both versions is recognised by its offset.
+    class TrieDiff
+    {
+        UpdateAuxImpl const &aux_;
+        uint64_t const versions_[2];
+        TrieDiffCallback const &callback_;
+
+        // a value only `side` has
+        void emit(Nibbles const &path, Node const &node, unsigned const side)
+        {
+            if (side == 0) {
+                callback_(NibblesView{path}, node.value(), std::nullopt);
+            }
+            else {
+                callback_(NibblesView{path}, std::nullopt, node.value());
+            }
+        }
+
+        Node::UniquePtr
+        child(Node const &node, unsigned const idx, unsigned const side) const
+        {
+            return read_node_blocking(aux_, node.fnext(idx), versions_[side]);
+        }
+
+        // `end` ends its path at `path`, where `through`, from `side`'s other
+        // version, goes on from nibble `offset` of its path
+        bool walk_split(
+            Node const &end, Node const &through, unsigned const offset,
+            Nibbles const &path, unsigned const side)
+        {
+            if (end.has_value()) {
+                emit(path, end, side);
+            }
+            unsigned char const nibble = through.path_nibble_view().get(offset);
+            for (unsigned branch = 0; branch < 16; ++branch) {
+                bool const in_end = end.mask & (1u << branch);
+                if (!in_end && branch != nibble) {
+                    continue;
+                }
+                auto const child_path = concat(
+                    NibblesView{path}, static_cast<unsigned char>(branch));
+                if (!in_end) {
+                    if (!report(through, offset + 1, child_path, 1 - side)) {
+                        return false;
+                    }
+                    continue;
+                }
+                auto const next = child(end, end.to_child_index(branch), side);
+                if (!next) {
+                    return false;
+                }
+                if (branch != nibble) {
+                    if (!report(*next, 0, child_path, side)) {
+                        return false;
+                    }
+                    continue;
+                }
+                bool const ok =
+                    side == 0
+                        ? walk(*next, 0, through, offset + 1, child_path)
+                        : walk(through, offset + 1, *next, 0, child_path);
+                if (!ok) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // both nodes end their paths at `path`
+        bool walk_children(Node const &a, Node const &b, Nibbles const &path)
+        {
+            if (a.has_value() && b.has_value()) {
+                if (a.value() != b.value()) {
+                    callback_(NibblesView{path}, a.value(), b.value());
+                }
+            }
+            else if (a.has_value()) {
+                emit(path, a, 0);
+            }
+            else if (b.has_value()) {
+                emit(path, b, 1);
+            }
+            for (unsigned branch = 0; branch < 16; ++branch) {
+                bool const in_a = a.mask & (1u << branch);
+                bool const in_b = b.mask & (1u << branch);
+                if (!in_a && !in_b) {
+                    continue;
+                }
+                auto const child_path = concat(
+                    NibblesView{path}, static_cast<unsigned char>(branch));
+                if (in_a && in_b) {
+                    unsigned const ia = a.to_child_index(branch);
+                    unsigned const ib = b.to_child_index(branch);
+                    if (a.fnext(ia) == b.fnext(ib)) {
+                        continue;
+                    }
+                    auto const next_a = child(a, ia, 0);
+                    if (!next_a) {
+                        return false;
+                    }
+                    auto const next_b = child(b, ib, 1);
+                    if (!next_b || !walk(*next_a, 0, *next_b, 0, child_path)) {
+                        return false;
+                    }
+                    continue;
+                }
+                unsigned const side = in_a ? 0 : 1;
+                Node const &node = in_a ? a : b;
+                auto const next =
+                    child(node, node.to_child_index(branch), side);
+                if (!next || !report(*next, 0, child_path, side)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        TrieDiff(
+            UpdateAuxImpl const &aux, uint64_t const version_a,
+            uint64_t const version_b, TrieDiffCallback const &callback)
+            : aux_{aux}
+            , versions_{version_a, version_b}
+            , callback_{callback}
+        {
+        }
+
+        // every key below `node` from nibble `offset` of its path on, as
+        // added or deleted by `side`
+        bool report(
+            Node const &node, unsigned const offset, Nibbles const &prefix,
+            unsigned const side)
+        {
+            auto const path = concat(
+                NibblesView{prefix}, node.path_nibble_view().substr(offset));
+            if (node.has_value()) {
+                emit(path, node, side);
+            }
+            for (auto const [idx, branch] : NodeChildrenRange(node.mask)) {
+                auto const next = child(node, idx, side);
+                if (!next || !report(
+                                 *next,
+                                 0,
+                                 concat(NibblesView{path}, branch),
+                                 side)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool walk(
+            Node const &a, unsigned const a_offset, Node const &b,
+            unsigned const b_offset, Nibbles const &prefix)
+        {
+            auto const path_a = a.path_nibble_view().substr(a_offset);
+            auto const path_b = b.path_nibble_view().substr(b_offset);
+            unsigned const common = path_a.common_prefix_size(path_b);
+            if (common < path_a.nibble_size() &&
+                common < path_b.nibble_size()) {
+                // the paths part, so no key is below both
+                if (path_a.get(common) < path_b.get(common)) {
+                    return report(a, a_offset, prefix, 0) &&
+                           report(b, b_offset, prefix, 1);
+                }
+                return report(b, b_offset, prefix, 1) &&
+                       report(a, a_offset, prefix, 0);
+            }
+            auto const path =
+                concat(NibblesView{prefix}, path_a.substr(0, common));
+            if (common == path_a.nibble_size()) {
+                if (common == path_b.nibble_size()) {
+                    return walk_children(a, b, path);
+                }
+                return walk_split(a, b, b_offset + common, path, 0);
+            }
+            return walk_split(b, a, a_offset + common, path, 1);
+        }
+    };
+
+    struct PrefixRoot
+    {
+        Node::UniquePtr node;
+        unsigned offset;
+    };
+
+    // the node holding the keys below `prefix` at `version`, with `offset`
+    // where `prefix` ends in its path; an empty node if there are none.
+    // nullopt if the version is not on disk.
+    std::optional<PrefixRoot> find_prefix(
+        UpdateAuxImpl const &aux, NibblesView const prefix,
+        uint64_t const version)
+    {
+        auto const root_offset = aux.get_root_offset_at_version(version);
+        if (root_offset == INVALID_OFFSET) {
+            return std::nullopt;
+        }
+        auto node = read_node_blocking(aux, root_offset, version);
+        unsigned prefix_index = 0;
+        while (node) {
+            auto const path = node->path_nibble_view();
+            auto const rest = prefix.substr(prefix_index);
+            if (rest.nibble_size() <= path.nibble_size()) {
+                if (!path.starts_with(rest)) {
+                    return PrefixRoot{nullptr, 0};
+                }
+                return PrefixRoot{std::move(node), rest.nibble_size()};
+            }
+            if (!rest.starts_with(path)) {
+                return PrefixRoot{nullptr, 0};
+            }
+            prefix_index += path.nibble_size();
+            unsigned const branch = prefix.get(prefix_index++);
+            if (!(node->mask & (1u << branch))) {
+                return PrefixRoot{nullptr, 0};
+            }
+            node = read_node_blocking(
+                aux, node->fnext(node->to_child_index(branch)), version);
+        }
+        return std::nullopt;
+    }
+}
+
+bool diff_blocking(
+    UpdateAuxImpl const &aux, NibblesView const prefix,
+    uint64_t const version_a, uint64_t const version_b,
+    TrieDiffCallback const &callback)
+{
+    MONAD_ASSERT(aux.is_on_disk());
+    auto const a = find_prefix(aux, prefix, version_a);
+    if (!a.has_value()) {
+        return false;
+    }
+    auto const b = find_prefix(aux, prefix, version_b);
+    if (!b.has_value()) {
+        return false;
+    }
+    TrieDiff diff{aux, version_a, version_b, callback};
+    Nibbles const empty{};
+    if (!a->node) {
+        return !b->node || diff.report(*b->node, b->offset, empty, 1);
+    }
+    if (!b->node) {
+        return diff.report(*a->node, a->offset, empty, 0);
+    }
+    return diff.walk(*a->node, a->offset, *b->node, b->offset, empty);
+}
+
+MONAD_MPT_NAMESPACE_END
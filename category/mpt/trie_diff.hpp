@@ -0,0 +1,47 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/mpt/config.hpp>
+#include <category/mpt/nibbles_view.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+class UpdateAuxImpl;
+
+// A key whose value differs between two versions, with the value in each.
+// `before` is empty for a key that was added and `after` for one that was
+// deleted.
+using TrieDiffCallback = std::function<void(
+    NibblesView key, std::optional<byte_string_view> before,
+    std::optional<byte_string_view> after)>;
+
+// Reports, in key order, the keys below `prefix` whose values differ between
+// `version_a` and `version_b`, with keys relative to `prefix`. The two tries
+// are walked together and a child both versions point at on disk is skipped
+// without being read, so the cost follows the size of the change rather than
+// of the trie. Nodes are read with blocking reads on the calling thread.
+// Returns false if either version is not on disk or expires during the walk.
+bool diff_blocking(
+    UpdateAuxImpl const &, NibblesView prefix, uint64_t version_a,
+    uint64_t version_b, TrieDiffCallback const &);
+
+MONAD_MPT_NAMESPACE_END
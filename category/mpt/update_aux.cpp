@@ -172,11 +172,102 @@ void UpdateAuxImpl::remove(uint32_t const idx) noexcept
         auto chunk = io->storage_pool().chunk(storage_pool::seq, idx);
         auto capacity = chunk->capacity();
         MONAD_DEBUG_ASSERT(chunk->size() == 0);
+        io->storage_pool().reclaim_pending_reset(*chunk);
         db_metadata_[0].main->free_capacity_sub_(capacity);
         db_metadata_[1].main->free_capacity_sub_(capacity);
     }
 }
 
+uint32_t UpdateAuxImpl::next_free_chunk(chunk_list const list) const noexcept
+{
+    MONAD_ASSERT(is_on_disk());
+    MONAD_ASSERT(list != chunk_list::free);
+    auto const *const metadata = db_metadata();
+    auto const *const end = metadata->free_list_end();
+    MONAD_ASSERT(end != nullptr); // we are out of free blocks!
+    // Free chunks whose discard is under way are passed over where possible,
+    // as remove() would wait for the discard to complete
+    auto const discarding =
+        io->storage_pool().discarding_chunks(storage_pool::seq);
+    auto const is_discarding = [&discarding](uint32_t const idx) {
+        return std::find(discarding.begin(), discarding.end(), idx) !=
+               discarding.end();
+    };
+    size_t const devices = device_chunk_count_.size();
+    if (devices < 2) {
+        for (auto const *ci = end; ci != nullptr; ci = ci->prev(metadata)) {
+            if (!is_discarding(ci->index(metadata))) {
+                return ci->index(metadata);
+            }
+        }
+        return end->index(metadata);
+    }
+    // Per device, the free chunk nearest the end of the free list that is
+    // not being discarded, if any, and how many free chunks there are
+    std::vector<uint32_t> candidate(devices, 0);
+    std::vector<uint32_t> free_count(devices, 0);
+    for (auto const *ci = end; ci != nullptr; ci = ci->prev(metadata)) {
+        auto const idx = ci->index(metadata);
+        auto const device = chunk_device_[idx];
+        if (free_count[device]++ == 0 ||
+            (is_discarding(candidate[device]) && !is_discarding(idx))) {
+            candidate[device] = idx;
+        }
+    }
+    // the devices the list may grow into: those of its own tier while any
+    // has a free chunk, all of them otherwise
+    std::vector<bool> eligible(devices, true);
+    if (!slow_tier_device_.empty()) {
+        bool const slow = list == chunk_list::slow;
+        bool tier_has_free = false;
+        for (size_t device = 0; device < devices; device++) {
+            if (slow_tier_device_[device] == slow && free_count[device] != 0) {
+                tier_has_free = true;
+            }
+        }
+        if (tier_has_free) {
+            for (size_t device = 0; device < devices; device++) {
+                eligible[device] = slow_tier_device_[device] == slow;
+            }
+        }
+    }
+    size_t chosen = chunk_device_[end->index(metadata)];
+    if (!eligible[chosen]) {
+        for (size_t device = 0; device < devices; device++) {
+            if (eligible[device] && free_count[device] != 0) {
+                chosen = device;
+                break;
+            }
+        }
+    }
+    if (list == chunk_list::fast) {
+        auto const *const tail = metadata->fast_list_end();
+        if (tail != nullptr) {
+            size_t const after = chunk_device_[tail->index(metadata)] + 1;
+            for (size_t i = 0; i < devices; i++) {
+                size_t const device = (after + i) % devices;
+                if (eligible[device] && free_count[device] != 0) {
+                    chosen = device;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        // Largest free_count / device_chunk_count_, compared without division
+        for (size_t device = 0; device < devices; device++) {
+            if (eligible[device] &&
+                uint64_t(free_count[device]) * device_chunk_count_[chosen] >
+                    uint64_t(free_count[chosen]) *
+                        device_chunk_count_[device]) {
+                chosen = device;
+            }
+        }
+    }
+    MONAD_DEBUG_ASSERT(free_count[chosen] != 0);
+    return candidate[chosen];
+}
+
 void UpdateAuxImpl::advance_db_offsets_to(
     chunk_offset_t const fast_offset, chunk_offset_t const slow_offset) noexcept
 {
@@ -313,6 +404,20 @@ void UpdateAuxImpl::set_latest_verified_version(uint64_t const version) noexcept
     do_(db_metadata_[1].main);
 }
 
+void UpdateAuxImpl::set_latest_finalized_and_verified_version(
+    uint64_t const finalized, uint64_t const verified) noexcept
+{
+    MONAD_ASSERT(is_on_disk());
+    for (auto const i : {0, 1}) {
+        auto *const m = db_metadata_[i].main;
+        auto g = m->hold_dirty();
+        reinterpret_cast<std::atomic_uint64_t *>(&m->latest_finalized_version)
+            ->store(finalized, std::memory_order_release);
+        reinterpret_cast<std::atomic_uint64_t *>(&m->latest_verified_version)
+            ->store(verified, std::memory_order_release);
+    }
+}
+
 void UpdateAuxImpl::set_latest_voted(
     uint64_t const version, bytes32_t const &block_id) noexcept
 {
@@ -527,6 +632,19 @@ void UpdateAuxImpl::set_io(
     io = io_;
     auto const chunk_count = io->chunk_count();
     MONAD_ASSERT(chunk_count >= 3);
+    chunk_device_.clear();
+    device_chunk_count_.clear();
+    if (auto const devices = io->storage_pool().devices().size();
+        devices > 1) {
+        chunk_device_.reserve(chunk_count);
+        device_chunk_count_.assign(devices, 0);
+        for (uint32_t id = 0; id < chunk_count; id++) {
+            auto const device = uint32_t(
+                io->storage_pool().device_index(storage_pool::seq, id));
+            chunk_device_.push_back(device);
+            device_chunk_count_[device]++;
+        }
+    }
     auto const map_size =
         sizeof(detail::db_metadata) +
         chunk_count * sizeof(detail::db_metadata::chunk_info_t);
@@ -1013,6 +1131,8 @@ void UpdateAuxImpl::unset_io()
     db_metadata_[0].main = nullptr;
     (void)::munmap(db_metadata_[1].main, map_size);
     db_metadata_[1].main = nullptr;
+    chunk_device_.clear();
+    device_chunk_count_.clear();
     io = nullptr;
 }
 
@@ -1024,7 +1144,7 @@ void UpdateAuxImpl::reset_node_writers()
             io->storage_pool().chunk(storage_pool::seq, node_writer_offset.id);
         MONAD_ASSERT(chunk->size() >= node_writer_offset.offset);
         size_t const bytes_to_write = std::min(
-            AsyncIO::WRITE_BUFFER_SIZE,
+            io->write_buffer_size(),
             size_t(chunk->capacity() - node_writer_offset.offset));
         return io ? io->make_connected(
                         write_single_buffer_sender{
@@ -1143,7 +1263,7 @@ Node::UniquePtr UpdateAuxImpl::do_update(
         "Finish upserting version %lu. Min valid version %lu. Time elapsed: "
         "%ld us. Disk usage: %.4f. Chunks: %u fast, %u slow, %u free. Writer "
         "offsets: fast={%u,%u}, slow={%u,%u}. Compaction head offset fast=%u, "
-        "slow=%u",
+        "slow=%u. Compaction deferred by budget: %lu KB",
         version,
         db_history_min_valid_version(),
         duration.count(),
@@ -1156,7 +1276,8 @@ Node::UniquePtr UpdateAuxImpl::do_update(
         curr_slow_writer_offset.count,
         curr_slow_writer_offset.offset,
         (uint32_t)compact_offset_fast,
-        (uint32_t)compact_offset_slow);
+        (uint32_t)compact_offset_slow,
+        uint64_t(compaction_deferred_fast_ + compaction_deferred_slow_) << 6);
     if (duration > std::chrono::microseconds(500'000)) {
         LOG_WARNING_CFORMAT(
             "Upsert version %lu takes longer than 0.5 s, time elapsed: %ld us.",
@@ -1166,6 +1287,51 @@ Node::UniquePtr UpdateAuxImpl::do_update(
     return root;
 }
 
+Node::UniquePtr UpdateAuxImpl::do_build(
+    StateMachine &sm, std::function<void(SortedTrieBuilder &)> const &fill,
+    uint64_t const version, bool const can_write_to_fast,
+    bool const write_root)
+{
+    auto g(unique_lock());
+    auto g2(set_current_upsert_tid());
+
+    if (is_in_memory()) {
+        return build_sorted(*this, version, sm, fill, write_root);
+    }
+    MONAD_ASSERT(is_on_disk());
+    MONAD_ASSERT(
+        db_history_max_version() == INVALID_BLOCK_NUM,
+        "a sorted build can only create the first version of an empty db");
+    set_can_write_to_fast(can_write_to_fast);
+    curr_upsert_auto_expire_version = calc_auto_expire_version();
+    byte_string const compact_offsets_bytes =
+        serialize((uint32_t)compact_offset_fast) +
+        serialize((uint32_t)compact_offset_slow);
+
+    auto const build_begin = std::chrono::steady_clock::now();
+    auto root = build_sorted(
+        *this,
+        version,
+        sm,
+        [&](SortedTrieBuilder &builder) {
+            // the root leaf, as the root update of `do_update` carries
+            builder.add(
+                {}, compact_offsets_bytes, static_cast<int64_t>(version));
+            fill(builder);
+        },
+        write_root);
+    set_auto_expire_version_metadata(curr_upsert_auto_expire_version);
+    [[maybe_unused]] auto const duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - build_begin);
+    LOG_INFO_CFORMAT(
+        "Finish building version %lu. Time elapsed: %ld us. Disk usage: %.4f",
+        version,
+        duration.count(),
+        disk_usage());
+    return root;
+}
+
 void UpdateAuxImpl::release_unreferenced_chunks()
 {
     auto const min_valid_version = db_history_min_valid_version();
@@ -1215,16 +1381,52 @@ void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
     auto const current_disk_usage = disk_usage();
     if (current_disk_usage > upper_bound &&
         history_length_before > MIN_HISTORY_LENGTH) {
-        while (disk_usage() > upper_bound &&
-               version_history_length() > MIN_HISTORY_LENGTH) {
-            auto const version_to_erase = db_history_min_valid_version();
-            MONAD_ASSERT(
-                version_to_erase != INVALID_BLOCK_NUM &&
-                version_to_erase < max_version);
-            erase_versions_up_to_and_including(version_to_erase);
-            update_history_length_metadata(
-                std::max(max_version - version_to_erase, MIN_HISTORY_LENGTH));
+        // Erasing up to and including `v` frees every chunk compacted before
+        // the next valid root's compaction offsets, so disk usage after the
+        // erase is known without erasing. It never increases with `v`, which
+        // lets a binary search find the smallest erase that brings usage
+        // under the bound, and erase it all at once.
+        auto const offsets = root_offsets();
+        auto const chunk_count = (double)io->chunk_count();
+        auto const free_chunks = (double)num_chunks(chunk_list::free);
+        auto const disk_usage_after_erasing = [&](uint64_t const v) {
+            auto next_valid = v + 1;
+            while (offsets[next_valid] == INVALID_OFFSET) {
+                MONAD_ASSERT(next_valid < max_version);
+                ++next_valid;
+            }
+            Node::UniquePtr const root = read_node_blocking(
+                *this, offsets[next_valid], next_valid);
+            MONAD_ASSERT(root);
+            auto const [offset_fast, offset_slow] =
+                deserialize_compaction_offsets(root->value());
+            auto const freed = [](detail::db_metadata::chunk_info_t const *ci,
+                                  uint32_t const count_before) {
+                auto const count = (uint32_t)ci->insertion_count();
+                return count_before > count ? count_before - count : 0u;
+            };
+            auto const freed_chunks =
+                freed(
+                    db_metadata()->fast_list_begin(), offset_fast.get_count()) +
+                freed(
+                    db_metadata()->slow_list_begin(), offset_slow.get_count());
+            return 1.0 - (free_chunks + (double)freed_chunks) / chunk_count;
+        };
+        auto lo = db_history_min_valid_version();
+        auto hi = max_version - MIN_HISTORY_LENGTH;
+        MONAD_ASSERT(lo != INVALID_BLOCK_NUM && lo <= hi);
+        while (lo < hi) {
+            auto const mid = lo + (hi - lo) / 2;
+            if (disk_usage_after_erasing(mid) <= upper_bound) {
+                hi = mid;
+            }
+            else {
+                lo = mid + 1;
+            }
         }
+        erase_versions_up_to_and_including(lo);
+        update_history_length_metadata(
+            std::max(max_version - lo, MIN_HISTORY_LENGTH));
         MONAD_ASSERT(
             disk_usage() <= upper_bound ||
             version_history_length() == MIN_HISTORY_LENGTH);
@@ -1248,10 +1450,14 @@ void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
 void UpdateAuxImpl::clear_root_offsets_up_to_and_including(
     uint64_t const version)
 {
-    uint64_t v = db_metadata()->root_offsets.version_lower_bound_;
-    for (; v <= version; ++v) {
-        update_root_offset(v, INVALID_OFFSET);
-    }
+    MONAD_ASSERT(is_on_disk());
+    auto do_ = [&](detail::db_metadata *m) {
+        auto g = m->hold_dirty();
+        root_offsets(m == db_metadata_[1].main)
+            .clear_up_to_and_including(version);
+    };
+    do_(db_metadata_[0].main);
+    do_(db_metadata_[1].main);
     MONAD_ASSERT(db_metadata()->root_offsets.version_lower_bound_ > version);
 }
 
@@ -1330,9 +1536,13 @@ void UpdateAuxImpl::advance_compact_offsets()
     if (compact_offset_fast < last_block_end_offset_fast_) {
         auto const valid_history_length =
             db_history_max_version() - db_history_min_valid_version() + 1;
-        compact_offset_range_fast_.set_value(divide_and_round(
+        auto const wanted = divide_and_round(
             last_block_end_offset_fast_ - compact_offset_fast,
-            valid_history_length));
+            valid_history_length);
+        // Whatever the budget holds back stays between the compaction head
+        // and the write head, so the next block asks for it again
+        compact_offset_range_fast_.set_value(grant_compaction_budget(wanted));
+        compaction_deferred_fast_ = wanted - compact_offset_range_fast_;
         compact_offset_fast += compact_offset_range_fast_;
     }
     constexpr double usage_limit_start_compact_slow = 0.6;
@@ -1345,7 +1555,7 @@ void UpdateAuxImpl::advance_compact_offsets()
         slow_list_usage > slow_usage_limit_start_compact_slow) {
         // Compact slow ring: the offset is based on slow list garbage
         // collection ratio of last block
-        compact_offset_range_slow_.set_value(
+        uint32_t wanted =
             (stats.compacted_bytes_in_slow != 0 &&
              compact_offset_range_slow_ != 0)
                 ? std::min(
@@ -1353,12 +1563,94 @@ void UpdateAuxImpl::advance_compact_offsets()
                       (uint32_t)std::round(
                           double(compact_offset_range_slow_ << 16) /
                           stats.compacted_bytes_in_slow))
-                : 1);
+                : 1;
+        // The slow range is sized from last block's garbage ratio rather than
+        // the distance to the write head, so carry what the budget withheld
+        wanted += compaction_deferred_slow_;
+        if (compact_offset_slow < last_block_end_offset_slow_) {
+            wanted = std::min(
+                wanted,
+                (uint32_t)(last_block_end_offset_slow_ - compact_offset_slow));
+        }
+        compact_offset_range_slow_.set_value(grant_compaction_budget(wanted));
+        compaction_deferred_slow_ = wanted - compact_offset_range_slow_;
         compact_offset_slow += compact_offset_range_slow_;
     }
     else {
         compact_offset_range_slow_ = MIN_COMPACT_VIRTUAL_OFFSET;
+        compaction_deferred_slow_ = 0;
+    }
+}
+
+uint32_t UpdateAuxImpl::grant_compaction_budget(uint32_t const wanted) noexcept
+{
+    if (compaction_bytes_per_sec_ == 0) {
+        return wanted;
+    }
+    // Credit banked during idle gaps is capped so a long pause cannot turn
+    // into one oversized compaction burst
+    constexpr double max_banked_seconds = 2.0;
+    auto const now = std::chrono::steady_clock::now();
+    if (compaction_credit_refilled_at_ !=
+        std::chrono::steady_clock::time_point{}) {
+        double const elapsed = std::chrono::duration<double>(
+                                   now - compaction_credit_refilled_at_)
+                                   .count();
+        compaction_credit_bytes_ = std::min(
+            compaction_credit_bytes_ +
+                elapsed * (double)compaction_bytes_per_sec_,
+            max_banked_seconds * (double)compaction_bytes_per_sec_);
     }
+    compaction_credit_refilled_at_ = now;
+    constexpr double bytes_per_unit = 1U << 16;
+    auto const granted = static_cast<uint32_t>(std::min(
+        (double)wanted, std::floor(compaction_credit_bytes_ / bytes_per_unit)));
+    compaction_credit_bytes_ -= granted * bytes_per_unit;
+    return granted;
+}
+
+void UpdateAuxImpl::set_compaction_io_budget(
+    uint64_t const bytes_per_sec) noexcept
+{
+    compaction_bytes_per_sec_ = bytes_per_sec;
+    // start with one second's worth so the first block is not starved
+    compaction_credit_bytes_ = (double)bytes_per_sec;
+    compaction_credit_refilled_at_ = {};
+    compaction_deferred_fast_ = 0;
+    compaction_deferred_slow_ = 0;
+}
+
+UpdateAuxImpl::compaction_backlog_t UpdateAuxImpl::compaction_backlog() const
+{
+    MONAD_ASSERT(is_on_disk());
+    compaction_backlog_t ret{
+        .deferred_bytes =
+            uint64_t(compaction_deferred_fast_ + compaction_deferred_slow_)
+            << 16};
+    auto const root_offset = get_latest_root_offset();
+    if (root_offset == INVALID_OFFSET) {
+        return ret;
+    }
+    auto const root =
+        read_node_blocking(*this, root_offset, db_history_max_version());
+    if (!root || root->value_len != 2 * sizeof(uint32_t)) {
+        return ret;
+    }
+    auto const [fast_head, slow_head] =
+        deserialize_compaction_offsets(root->value());
+    auto const distance = [](compact_virtual_chunk_offset_t const head,
+                             compact_virtual_chunk_offset_t const end) {
+        return head < end ? uint64_t(end - head) << 16 : 0;
+    };
+    ret.fast_bytes = distance(
+        fast_head,
+        compact_virtual_chunk_offset_t{physical_to_virtual(
+            db_metadata()->db_offsets.start_of_wip_offset_fast)});
+    ret.slow_bytes = distance(
+        slow_head,
+        compact_virtual_chunk_offset_t{physical_to_virtual(
+            db_metadata()->db_offsets.start_of_wip_offset_slow)});
+    return ret;
 }
 
 uint64_t UpdateAuxImpl::version_history_max_possible() const noexcept
@@ -1424,9 +1716,11 @@ void UpdateAuxImpl::free_compacted_chunks()
                  count = (uint32_t)db_metadata()->at(idx)->insertion_count()) {
                 ci = ci->next(db_metadata()); // must be in this order
                 remove(idx);
-                io->storage_pool()
-                    .chunk(monad::async::storage_pool::seq, idx)
-                    ->destroy_contents();
+                // Discarding is left to the pool, as a large history shrink
+                // would otherwise stall this thread for seconds
+                io->storage_pool().destroy_contents_deferred(
+                    io->storage_pool().chunk(
+                        monad::async::storage_pool::seq, idx));
                 append(
                     UpdateAuxImpl::chunk_list::free,
                     idx); // append not prepend
@@ -175,6 +175,15 @@ struct CompactTNode : public UpwardTreeNodeBase<CompactTNode>
     value is either the node is currently cached in memory or its node is child
     of an update tnode. */
     bool const cache_node{false};
+    /* Set when the node has a value and children. That is an account with
+    its storage trie, but also any other node where one trie nests another,
+    such as a section or prefix node. Its rewritten children are then held
+    in memory, recorded in `held_mask`, and written just before it, so that
+    one read brings in the node together with the top of its nested trie. */
+    bool cluster{false};
+    uint16_t held_mask{0};
+    // the held children to keep cached once written
+    uint16_t held_cache_mask{0};
     Node::UniquePtr node{nullptr};
 
     template <any_tnode Parent>
@@ -224,7 +233,7 @@ struct CompactTNode : public UpwardTreeNodeBase<CompactTNode>
     }
 };
 
-static_assert(sizeof(CompactTNode) == 24);
+static_assert(sizeof(CompactTNode) == 32);
 static_assert(alignof(CompactTNode) == 8);
 
 struct ExpireTNode : public UpdateExpireCommonStorage<ExpireTNode>
@@ -0,0 +1,87 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
+#include <category/execution/ethereum/trace/rlp/call_frame_rlp.hpp>
+#include <category/rpc/call_frame_store.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+using namespace monad;
+
+struct monad_call_frame_store
+{
+    std::mutex mutex;
+    CallFrameStore store;
+
+    explicit monad_call_frame_store(char const *const path)
+        : store{path, true}
+    {
+    }
+};
+
+monad_call_frame_store *monad_call_frame_store_open(char const *const path)
+{
+    MONAD_ASSERT(path);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return nullptr;
+    }
+    return new monad_call_frame_store{path};
+}
+
+void monad_call_frame_store_close(monad_call_frame_store *const store)
+{
+    MONAD_ASSERT(store);
+
+    delete store;
+}
+
+bool monad_call_frame_store_read(
+    monad_call_frame_store *const store, uint64_t const block_number,
+    uint8_t const *const block_id, size_t const block_id_len,
+    uint64_t const txn_index, uint8_t **const rlp_call_frames,
+    size_t *const rlp_call_frames_len)
+{
+    MONAD_ASSERT(store);
+    MONAD_ASSERT(block_id && block_id_len == sizeof(bytes32_t));
+    MONAD_ASSERT(rlp_call_frames && rlp_call_frames_len);
+    bytes32_t id;
+    std::memcpy(id.bytes, block_id, sizeof(id));
+    auto const frames = [&] {
+        std::lock_guard const lock{store->mutex};
+        return store->store.read(block_number, id, txn_index);
+    }();
+    if (!frames.has_value()) {
+        return false;
+    }
+    byte_string const encoded = rlp::encode_call_frames(*frames);
+    *rlp_call_frames = new uint8_t[encoded.size()];
+    *rlp_call_frames_len = encoded.size();
+    std::memcpy(*rlp_call_frames, encoded.data(), encoded.size());
+    return true;
+}
+
+void monad_call_frame_store_release(uint8_t *const rlp_call_frames)
+{
+    delete[] rlp_call_frames;
+}
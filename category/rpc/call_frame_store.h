@@ -0,0 +1,50 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct monad_call_frame_store;
+
+// Opens for reading the call frame store the execution daemon appends to at
+// `path` (its --trace_calls_file). Returns NULL if there is no file at
+// `path`. Lookups may come from any thread.
+struct monad_call_frame_store *monad_call_frame_store_open(char const *path);
+
+void monad_call_frame_store_close(struct monad_call_frame_store *);
+
+// Looks up the call frames of transaction `txn_index` of the block, encoded
+// as RLP like in the call frame table of the db. Returns false if the store
+// has no such transaction, for instance because it was executed before the
+// store was enabled or is older than the db history. Otherwise
+// `*rlp_call_frames` is released with monad_call_frame_store_release.
+bool monad_call_frame_store_read(
+    struct monad_call_frame_store *, uint64_t block_number,
+    uint8_t const *block_id, size_t block_id_len, uint64_t txn_index,
+    uint8_t **rlp_call_frames, size_t *rlp_call_frames_len);
+
+void monad_call_frame_store_release(uint8_t *rlp_call_frames);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
+#include <category/execution/ethereum/trace/rlp/call_frame_rlp.hpp>
+#include <category/rpc/call_frame_store.h>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace monad;
+using namespace evmc::literals;
+
+TEST(CallFrameStoreApi, read)
+{
+    auto const path = std::filesystem::temp_directory_path() /
+                      std::format("call_frame_store_api_test_{}", getpid());
+    std::vector<std::vector<CallFrame>> const block{
+        {CallFrame{
+            .type = CallType::CALL,
+            .from = 0x5353535353535353535353535353535353535353_address,
+            .to = 0xbebebebebebebebebebebebebebebebebebebebe_address,
+            .gas = 100'000,
+            .gas_used = 21'000,
+            .input = byte_string{0xde, 0xad, 0xbe, 0xef},
+            .status = EVMC_SUCCESS}}};
+    auto const id = bytes32_t{5};
+    CallFrameStore{path}.append(5, id, block);
+
+    EXPECT_EQ(
+        monad_call_frame_store_open((path.string() + ".missing").c_str()),
+        nullptr);
+    monad_call_frame_store *const store =
+        monad_call_frame_store_open(path.c_str());
+    ASSERT_NE(store, nullptr);
+
+    uint8_t *rlp_call_frames = nullptr;
+    size_t rlp_call_frames_len = 0;
+    ASSERT_TRUE(monad_call_frame_store_read(
+        store,
+        5,
+        id.bytes,
+        sizeof(id),
+        0,
+        &rlp_call_frames,
+        &rlp_call_frames_len));
+    byte_string_view view{rlp_call_frames, rlp_call_frames_len};
+    auto const frames = rlp::decode_call_frames(view);
+    monad_call_frame_store_release(rlp_call_frames);
+    ASSERT_FALSE(frames.has_error());
+    EXPECT_EQ(frames.value(), block[0]);
+
+    EXPECT_FALSE(monad_call_frame_store_read(
+        store,
+        5,
+        id.bytes,
+        sizeof(id),
+        1,
+        &rlp_call_frames,
+        &rlp_call_frames_len));
+    EXPECT_FALSE(monad_call_frame_store_read(
+        store,
+        6,
+        id.bytes,
+        sizeof(id),
+        0,
+        &rlp_call_frames,
+        &rlp_call_frames_len));
+
+    monad_call_frame_store_close(store);
+    std::filesystem::remove(path);
+}
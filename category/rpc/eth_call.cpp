@@ -13,10 +13,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/async/detail/scope_polyfill.hpp>
 #include <category/core/assert.h>
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
 #include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
 #include <category/core/lru/lru_cache.hpp>
 #include <category/core/monad_exception.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
@@ -49,18 +52,27 @@
 #include <category/rpc/eth_call.h>
 #include <category/vm/evm/switch_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/shared_code_store.hpp>
 
 #include <boost/fiber/future/promise.hpp>
 #include <boost/outcome/try.hpp>
 
-#include <nlohmann/json.hpp>
 
 #include <quill/Quill.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -90,6 +102,9 @@ namespace
         "failure to submit eth_call to thread pool: queue size exceeded";
     char const *const TIMEOUT_ERR_MSG =
         "failure to execute eth_call: queuing time exceeded timeout threshold";
+    char const *const OVERLOADED_ERR_MSG =
+        "failure to submit eth_call to thread pool: expected to exceed "
+        "timeout threshold";
     using StateOverrideObj = monad_state_override::monad_state_override_object;
 
     template <Traits traits>
@@ -100,7 +115,8 @@ namespace
         std::vector<std::optional<Address>> const &authorities, TrieRODb &tdb,
         vm::VM &vm, BlockHashBufferFinalized const buffer,
         monad_state_override const &state_overrides,
-        CallTracerBase &call_tracer, trace::StateTracer state_tracer)
+        CallTracerBase &call_tracer, trace::StateTracer state_tracer,
+        BlockState *const shared_block_state)
     {
         Transaction enriched_txn{txn};
 
@@ -118,8 +134,15 @@ namespace
             header.excess_blob_gas,
             chain.get_chain_id()));
 
-        tdb.set_block_and_prefix(block_number, block_id);
-        BlockState block_state{tdb, vm};
+        // a shared block state is never merged into, so it only caches the
+        // reads of the block
+        std::optional<BlockState> own_block_state;
+        if (shared_block_state == nullptr) {
+            tdb.set_block_and_prefix(block_number, block_id);
+            own_block_state.emplace(tdb, vm);
+        }
+        BlockState &block_state =
+            shared_block_state ? *shared_block_state : *own_block_state;
         // avoid conflict with block reward txn
         Incarnation const incarnation{block_number, Incarnation::LAST_TX - 1u};
         State state{block_state, incarnation};
@@ -238,6 +261,154 @@ namespace
 
         return execution_result;
     }
+
+    void append_sized(byte_string &out, byte_string_view const bytes)
+    {
+        uint64_t const size = bytes.size();
+        out.append(
+            reinterpret_cast<unsigned char const *>(&size), sizeof(size));
+        out.append(bytes);
+    }
+
+    // Hash of everything the outcome of a call depends on, identical calls
+    // share it
+    bytes32_t eth_call_key(
+        monad_chain_config const chain_config, byte_string_view const rlp_txn,
+        byte_string_view const rlp_header, byte_string_view const rlp_sender,
+        uint64_t const block_number, byte_string_view const rlp_block_id,
+        monad_state_override const &overrides,
+        monad_tracer_config const tracer_config, bool const gas_specified)
+    {
+        byte_string in;
+        auto const append_int = [&in](uint64_t const v) {
+            in.append(reinterpret_cast<unsigned char const *>(&v), sizeof(v));
+        };
+        auto const append_optional =
+            [&](std::optional<byte_string> const &v) {
+                append_int(v.has_value());
+                if (v.has_value()) {
+                    append_sized(in, *v);
+                }
+            };
+        auto const append_map =
+            [&](std::map<byte_string, byte_string> const &m) {
+                append_int(m.size());
+                for (auto const &[k, v] : m) {
+                    append_sized(in, k);
+                    append_sized(in, v);
+                }
+            };
+        append_int(chain_config);
+        append_sized(in, rlp_txn);
+        append_sized(in, rlp_header);
+        append_sized(in, rlp_sender);
+        append_int(block_number);
+        append_sized(in, rlp_block_id);
+        append_int(tracer_config);
+        append_int(gas_specified);
+        append_int(overrides.override_sets.size());
+        for (auto const &[addr, obj] : overrides.override_sets) {
+            append_sized(in, addr);
+            append_optional(obj.balance);
+            append_int(obj.nonce.has_value());
+            append_int(obj.nonce.value_or(0));
+            append_optional(obj.code);
+            append_map(obj.state);
+            append_map(obj.state_diff);
+        }
+        return to_bytes(keccak256(in));
+    }
+
+    monad_eth_call_result *copy_result(monad_eth_call_result const &src)
+    {
+        auto *const dst = new monad_eth_call_result(src);
+        if (src.output_data) {
+            dst->output_data = new uint8_t[src.output_data_len];
+            std::memcpy(
+                dst->output_data, src.output_data, src.output_data_len);
+        }
+        if (src.message) {
+            dst->message = strdup(src.message);
+            MONAD_ASSERT(dst->message);
+        }
+        if (src.encoded_trace) {
+            dst->encoded_trace = new uint8_t[src.encoded_trace_len];
+            std::memcpy(
+                dst->encoded_trace, src.encoded_trace, src.encoded_trace_len);
+        }
+        return dst;
+    }
+
+    std::unique_ptr<Chain> make_chain(monad_chain_config const chain_config)
+    {
+        switch (chain_config) {
+        case CHAIN_CONFIG_ETHEREUM_MAINNET:
+            return std::make_unique<EthereumMainnet>();
+        case CHAIN_CONFIG_MONAD_DEVNET:
+            return std::make_unique<MonadDevnet>();
+        case CHAIN_CONFIG_MONAD_TESTNET:
+            return std::make_unique<MonadTestnet>();
+        case CHAIN_CONFIG_MONAD_MAINNET:
+            return std::make_unique<MonadMainnet>();
+        case CHAIN_CONFIG_MONAD_TESTNET2:
+            return std::make_unique<MonadTestnet2>();
+        }
+        MONAD_ASSERT(false);
+    }
+
+    // Runs `eth_call_impl` with the traits of the chain revision at `header`
+    Result<evmc::Result> dispatch_eth_call(
+        monad_chain_config const chain_config, Chain const &chain,
+        Transaction const &txn, BlockHeader const &header,
+        uint64_t const block_number, bytes32_t const &block_id,
+        Address const &sender,
+        std::vector<std::optional<Address>> const &authorities, TrieRODb &tdb,
+        vm::VM &vm, BlockHashBufferFinalized const &buffer,
+        monad_state_override const &state_overrides,
+        CallTracerBase &call_tracer, trace::StateTracer state_tracer,
+        BlockState *const shared_block_state = nullptr)
+    {
+        if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
+            evmc_revision const rev =
+                chain.get_revision(header.number, header.timestamp);
+            SWITCH_EVM_TRAITS(
+                eth_call_impl,
+                chain,
+                txn,
+                header,
+                block_number,
+                block_id,
+                sender,
+                authorities,
+                tdb,
+                vm,
+                buffer,
+                state_overrides,
+                call_tracer,
+                std::move(state_tracer),
+                shared_block_state);
+            MONAD_ASSERT(false);
+        }
+        auto const rev = dynamic_cast<MonadChain const &>(chain)
+                             .get_monad_revision(header.timestamp);
+        SWITCH_MONAD_TRAITS(
+            eth_call_impl,
+            chain,
+            txn,
+            header,
+            block_number,
+            block_id,
+            sender,
+            authorities,
+            tdb,
+            vm,
+            buffer,
+            state_overrides,
+            call_tracer,
+            std::move(state_tracer),
+            shared_block_state);
+        MONAD_ASSERT(false);
+    }
 }
 
 namespace monad
@@ -388,6 +559,155 @@ void monad_eth_call_result_release(monad_eth_call_result *const result)
 struct monad_eth_call_executor
 {
     using BlockHashCache = LruCache<uint64_t, bytes32_t>;
+    using CompletedCallCache = LruCache<
+        bytes32_t, std::shared_ptr<monad_eth_call_result>,
+        BytesHashCompare<bytes32_t>>;
+
+    // What every call at one block needs, resolved once for a whole batch
+    struct PreparedBlock
+    {
+        std::shared_ptr<BlockHashBufferFinalized const> block_hash_buffer;
+        TrieRODb tdb;
+
+        PreparedBlock(
+            std::shared_ptr<BlockHashBufferFinalized const> buffer,
+            mpt::RODb &db, TrieRODbCache *const cache,
+            vm::SharedCodeStore const *const code_store)
+            : block_hash_buffer{std::move(buffer)}
+            , tdb{db, cache, code_store}
+        {
+        }
+    };
+
+    struct PinnedBlockKey
+    {
+        uint64_t block_number;
+        bytes32_t block_id;
+    };
+
+    struct PinnedBlockHashCompare
+    {
+        size_t hash(PinnedBlockKey const &key) const
+        {
+            return komihash(
+                key.block_id.bytes, sizeof(bytes32_t), key.block_number);
+        }
+
+        bool equal(PinnedBlockKey const &a, PinnedBlockKey const &b) const
+        {
+            return a.block_number == b.block_number &&
+                   a.block_id == b.block_id;
+        }
+    };
+
+    using PinnedBlockCache = LruCache<
+        PinnedBlockKey, std::shared_ptr<PreparedBlock>,
+        PinnedBlockHashCompare>;
+
+    struct BatchCall
+    {
+        Transaction txn;
+        Address sender;
+        bool gas_specified;
+        bytes32_t key;
+    };
+
+    // Results of a batch, handed over together once every call is done
+    struct Batch
+    {
+        std::vector<monad_eth_call_result *> results;
+        std::atomic<size_t> remaining;
+        void (*complete)(monad_eth_call_result **, size_t, void *user);
+        void *user;
+    };
+
+    struct BatchSlot
+    {
+        std::shared_ptr<Batch> batch;
+        size_t index;
+    };
+
+    // An execution together with every identical call that arrived while it
+    // was running
+    struct CoalescedCall
+    {
+        monad_eth_call_executor *executor;
+        bytes32_t key;
+        std::vector<
+            std::pair<void (*)(monad_eth_call_result *, void *), void *>>
+            waiters;
+    };
+
+    // Measured load of one pool. The averages weigh the last samples by
+    // 1 / 2^LOAD_AVERAGE_SHIFT; racing updates may drop a sample, which only
+    // makes them slower to follow
+    struct PoolLoad
+    {
+        static constexpr unsigned LOAD_AVERAGE_SHIFT = 4;
+
+        unsigned const threads;
+        unsigned const fibers;
+        std::atomic<unsigned> queued{0};
+        std::atomic<unsigned> running{0};
+        std::atomic<uint64_t> avg_queue_wait_us{0};
+        std::atomic<uint64_t> avg_execution_us{0};
+        // execution time per million gas used
+        std::atomic<uint64_t> avg_us_per_mgas{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> shed{0};
+
+        PoolLoad(unsigned const threads, unsigned const fibers)
+            : threads{threads}
+            , fibers{fibers}
+        {
+        }
+
+        static void
+        update_average(std::atomic<uint64_t> &avg, uint64_t const sample)
+        {
+            uint64_t const old = avg.load(std::memory_order_relaxed);
+            avg.store(
+                old == 0 ? sample
+                         : old - (old >> LOAD_AVERAGE_SHIFT) +
+                               (sample >> LOAD_AVERAGE_SHIFT),
+                std::memory_order_relaxed);
+        }
+
+        // How long a call queued now waits for a fiber: not at all while
+        // one is free, otherwise until the calls ahead of it ran on the
+        // threads of the pool
+        std::chrono::microseconds expected_wait() const
+        {
+            unsigned const ahead = queued.load(std::memory_order_acquire) +
+                                   running.load(std::memory_order_acquire);
+            if (ahead < fibers) {
+                return std::chrono::microseconds{0};
+            }
+            return std::chrono::microseconds{
+                (ahead - fibers + 1) *
+                avg_execution_us.load(std::memory_order_relaxed) / threads};
+        }
+
+        // Moves a queued call onto a fiber, until the returned guard is
+        // destroyed
+        [[nodiscard]] auto start()
+        {
+            queued.fetch_sub(1, std::memory_order_acq_rel);
+            running.fetch_add(1, std::memory_order_acq_rel);
+            return make_scope_exit([this]() noexcept {
+                running.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+    };
+
+    struct ContractCost
+    {
+        uint64_t avg_us;
+        std::chrono::steady_clock::time_point updated;
+    };
+
+    using ContractCostCache =
+        LruCache<Address, ContractCost, BytesHashCompare<Address>>;
 
     fiber::PriorityPool low_gas_pool_;
     fiber::PriorityPool high_gas_pool_;
@@ -397,10 +717,29 @@ struct monad_eth_call_executor
     std::chrono::seconds high_pool_timeout_{30};
 
     // counters
-    uint64_t call_count_{0};
-    std::atomic<unsigned> high_pool_queued_count_{0};
+    std::atomic<uint64_t> call_count_{0};
+    PoolLoad low_pool_load_;
+    PoolLoad high_pool_load_{1, 2};
+
+    // Average execution time of calls to a contract. What it exceeds the
+    // pool average by halves every CONTRACT_COST_HALF_LIFE without a call,
+    // so that a contract shed for its history is tried again
+    static constexpr size_t CONTRACT_COST_CACHE_SIZE = 8192;
+    static constexpr std::chrono::seconds CONTRACT_COST_HALF_LIFE{10};
+    ContractCostCache contract_costs_{CONTRACT_COST_CACHE_SIZE};
+
+    // Share of the read budget that caches decoded accounts and storage
+    // across both pools, the rest goes to the node lru of `db_`
+    static constexpr uint64_t READ_CACHE_DIVISOR = 4;
+    // Share of the node lru reserved for versions more than
+    // HISTORICAL_VERSION_DISTANCE behind the latest, so that archive calls
+    // cannot evict the nodes of recent blocks
+    static constexpr uint64_t HISTORICAL_NODE_CACHE_DIVISOR = 4;
+    static constexpr uint64_t HISTORICAL_VERSION_DISTANCE = 256;
 
     mpt::RODb db_;
+    TrieRODbCache read_cache_;
+    std::unique_ptr<vm::SharedCodeStore const> code_store_;
 
     // The VM for executing eth calls needs to unconditionally use the
     // interpreter rather than the compiler. If it uses the compiler, then
@@ -409,6 +748,24 @@ struct monad_eth_call_executor
 
     BlockHashCache blockhash_cache_{7200};
 
+    // Recently called blocks stay resolved, so calls at them neither look
+    // their prefix up again nor rebuild their block hash buffer
+    static constexpr size_t PINNED_BLOCK_CACHE_SIZE = 64;
+    PinnedBlockCache pinned_blocks_{PINNED_BLOCK_CACHE_SIZE};
+
+    // Results of calls are a function of their inputs, so identical calls
+    // share one execution while it runs and its result once it is done
+    static constexpr size_t COMPLETED_CALL_CACHE_SIZE = 1024;
+
+    // An estimate stops once it is within 1 / ESTIMATE_PRECISION_DIVISOR of
+    // the lowest gas limit that succeeds
+    static constexpr uint64_t ESTIMATE_PRECISION_DIVISOR = 64;
+    // A value transfer from a call adds this much gas for the callee
+    static constexpr uint64_t STIPEND_GAS = 2300;
+    std::mutex inflight_calls_mutex_;
+    std::unordered_map<bytes32_t, CoalescedCall *> inflight_calls_;
+    CompletedCallCache completed_calls_{COMPLETED_CALL_CACHE_SIZE};
+
     monad_eth_call_executor(
         unsigned const num_threads, unsigned const num_fibers,
         uint64_t const node_lru_max_mem, unsigned const low_pool_timeout_sec,
@@ -417,6 +774,7 @@ struct monad_eth_call_executor
         , high_gas_pool_{1, 2, true}
         , low_pool_timeout_{low_pool_timeout_sec}
         , high_pool_timeout_{high_pool_timeout_sec}
+        , low_pool_load_{num_threads, num_fibers}
         , db_{[&] {
             std::vector<std::filesystem::path> paths;
             if (std::filesystem::is_directory(triedb_path)) {
@@ -432,10 +790,19 @@ struct monad_eth_call_executor
             // create the db instances on the PriorityPool thread so all the
             // thread local storage gets instantiated on the one thread its
             // used
+            uint64_t const node_mem =
+                node_lru_max_mem - node_lru_max_mem / READ_CACHE_DIVISOR;
             auto const config = mpt::ReadOnlyOnDiskDbConfig{
-                .dbname_paths = paths, .node_lru_max_mem = node_lru_max_mem};
+                .dbname_paths = paths,
+                .node_lru_max_mem =
+                    node_mem - node_mem / HISTORICAL_NODE_CACHE_DIVISOR,
+                .historical_node_lru_max_mem =
+                    node_mem / HISTORICAL_NODE_CACHE_DIVISOR,
+                .historical_version_distance = HISTORICAL_VERSION_DISTANCE,
+                .warm_node_cache_levels = 2};
             return mpt::RODb{config};
         }()}
+        , read_cache_{node_lru_max_mem / READ_CACHE_DIVISOR}
     {
     }
 
@@ -443,6 +810,225 @@ struct monad_eth_call_executor
     monad_eth_call_executor &
     operator=(monad_eth_call_executor const &) = delete;
 
+    // Returns the context to execute the call under, or nullptr when an
+    // identical call already answered or will answer it
+    CoalescedCall *coalesce(
+        bytes32_t const &key,
+        void (*complete)(monad_eth_call_result *, void *user), void *const user)
+    {
+        {
+            CompletedCallCache::ConstAccessor acc;
+            if (completed_calls_.find(acc, key)) {
+                auto *const result = copy_result(*acc->second.value_);
+                acc.release();
+                complete(result, user);
+                return nullptr;
+            }
+        }
+        std::unique_lock const g{inflight_calls_mutex_};
+        auto [it, inserted] = inflight_calls_.try_emplace(key, nullptr);
+        if (!inserted) {
+            it->second->waiters.emplace_back(complete, user);
+            return nullptr;
+        }
+        it->second = new CoalescedCall{
+            .executor = this, .key = key, .waiters = {{complete, user}}};
+        return it->second;
+    }
+
+    static void
+    coalesced_complete(monad_eth_call_result *const result, void *const user)
+    {
+        std::unique_ptr<CoalescedCall> const call{
+            static_cast<CoalescedCall *>(user)};
+        auto &executor = *call->executor;
+        // rejections depend on load and timing rather than on the call
+        if (result->status_code != EVMC_REJECTED &&
+            result->status_code != EVMC_INTERNAL_ERROR) {
+            executor.completed_calls_.insert(
+                call->key,
+                std::shared_ptr<monad_eth_call_result>{
+                    copy_result(*result), monad_eth_call_result_release});
+        }
+        {
+            // no waiter can attach once the call is out of the table
+            std::unique_lock const g{executor.inflight_calls_mutex_};
+            executor.inflight_calls_.erase(call->key);
+        }
+        auto const &waiters = call->waiters;
+        for (size_t i = 1; i < waiters.size(); ++i) {
+            waiters[i].first(copy_result(*result), waiters[i].second);
+        }
+        waiters[0].first(result, waiters[0].second);
+    }
+
+    static void
+    batch_call_complete(monad_eth_call_result *const result, void *const user)
+    {
+        std::unique_ptr<BatchSlot> const slot{static_cast<BatchSlot *>(user)};
+        auto &batch = *slot->batch;
+        batch.results[slot->index] = result;
+        if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            batch.complete(
+                batch.results.data(), batch.results.size(), batch.user);
+        }
+    }
+
+    // Returns nullptr when the block cannot be resolved, the calls then try
+    // on their own and report why
+    std::shared_ptr<PreparedBlock>
+    prepare_block(uint64_t const block_number, bytes32_t const &block_id)
+    {
+        std::shared_ptr<BlockHashBufferFinalized const> buffer =
+            create_blockhash_buffer(block_number);
+        if (buffer == nullptr) {
+            return nullptr;
+        }
+        auto prepared = std::make_shared<PreparedBlock>(
+            std::move(buffer), db_, &read_cache_, code_store_.get());
+        try {
+            prepared->tdb.set_block_and_prefix(block_number, block_id);
+        }
+        catch (MonadException const &) {
+            return nullptr;
+        }
+        return prepared;
+    }
+
+    // The block if it is among the recently called ones, without reading the
+    // db, so any thread may ask
+    std::shared_ptr<PreparedBlock>
+    find_pinned_block(uint64_t const block_number, bytes32_t const &block_id)
+    {
+        PinnedBlockCache::ConstAccessor acc;
+        if (pinned_blocks_.find(
+                acc,
+                PinnedBlockKey{
+                    .block_number = block_number, .block_id = block_id}) &&
+            block_number >= db_.get_earliest_version()) {
+            return acc->second.value_;
+        }
+        return nullptr;
+    }
+
+    // Like `prepare_block`, but shares the resolution with every other call
+    // at the block while it stays among the recently called ones
+    std::shared_ptr<PreparedBlock>
+    pinned_block(uint64_t const block_number, bytes32_t const &block_id)
+    {
+        if (auto pinned = find_pinned_block(block_number, block_id)) {
+            return pinned;
+        }
+        auto prepared = prepare_block(block_number, block_id);
+        if (prepared != nullptr) {
+            pinned_blocks_.insert(
+                PinnedBlockKey{
+                    .block_number = block_number, .block_id = block_id},
+                prepared);
+        }
+        return prepared;
+    }
+
+    // Queues `task` on `pool` once the accounts of the sender and of the
+    // target of `txn` are in the read cache. Those reads are issued from
+    // this thread and complete on the triedb thread, so a call waiting on
+    // them holds no fiber and no fiber stack, and its fiber then finds them
+    // cached. Without a resolved `block` there is nothing to read from yet
+    // and `task` is queued at once.
+    template <typename Task>
+    static void submit_after_prefetch(
+        fiber::PriorityPool &pool, uint64_t const priority,
+        PreparedBlock const *const block, Transaction const &txn,
+        Address const &sender, Task &&task)
+    {
+        if (block == nullptr) {
+            pool.submit(priority, std::forward<Task>(task));
+            return;
+        }
+        struct Pending
+        {
+            std::atomic<unsigned> remaining;
+            fiber::PriorityPool &pool;
+            uint64_t priority;
+            std::decay_t<Task> task;
+        };
+
+        std::shared_ptr<Pending> const pending{new Pending{
+            .remaining{txn.to.has_value() ? 3u : 2u},
+            .pool = pool,
+            .priority = priority,
+            .task = std::forward<Task>(task)}};
+        auto const arrive = [pending] {
+            if (pending->remaining.fetch_sub(1, std::memory_order_acq_rel) ==
+                1) {
+                pending->pool.submit(
+                    pending->priority, std::move(pending->task));
+            }
+        };
+        block->tdb.prefetch_account(sender, arrive);
+        if (txn.to.has_value()) {
+            block->tdb.prefetch_account(*txn.to, arrive);
+        }
+        arrive();
+    }
+
+    void execute_eth_call_batch(
+        monad_chain_config const chain_config, std::vector<BatchCall> calls,
+        BlockHeader const &block_header, uint64_t const block_number,
+        bytes32_t const &block_id, monad_state_override const *const overrides,
+        void (*complete)(monad_eth_call_result **, size_t, void *user),
+        void *const user, monad_tracer_config const tracer_config)
+    {
+        if (calls.empty()) {
+            complete(nullptr, 0, user);
+            return;
+        }
+        auto batch = std::make_shared<Batch>();
+        batch->results.resize(calls.size(), nullptr);
+        batch->remaining.store(calls.size(), std::memory_order_release);
+        batch->complete = complete;
+        batch->user = user;
+
+        // the block is resolved on a pool thread, which is where db reads
+        // have to happen
+        low_gas_pool_.submit(
+            call_count_.fetch_add(1, std::memory_order_relaxed),
+            [this,
+             chain_config = chain_config,
+             calls = std::move(calls),
+             block_header = block_header,
+             block_number = block_number,
+             block_id = block_id,
+             overrides = overrides,
+             tracer_config = tracer_config,
+             batch = std::move(batch)] {
+                auto const prepared = pinned_block(block_number, block_id);
+                for (size_t i = 0; i < calls.size(); ++i) {
+                    auto const &call = calls[i];
+                    auto *const coalesced = coalesce(
+                        call.key,
+                        &batch_call_complete,
+                        new BatchSlot{.batch = batch, .index = i});
+                    if (coalesced == nullptr) {
+                        continue;
+                    }
+                    execute_eth_call(
+                        chain_config,
+                        call.txn,
+                        block_header,
+                        call.sender,
+                        block_number,
+                        block_id,
+                        overrides,
+                        &coalesced_complete,
+                        coalesced,
+                        tracer_config,
+                        call.gas_specified,
+                        prepared);
+                }
+            });
+    }
+
     std::unique_ptr<BlockHashBufferFinalized>
     create_blockhash_buffer(uint64_t const block_number)
     {
@@ -487,29 +1073,139 @@ struct monad_eth_call_executor
         return buffer;
     }
 
+    // Expected execution time of `txn` run with `gas_limit`: what calls to
+    // its target took so far, decayed towards the pool average, or the pool
+    // average for a target not seen yet, bounded by what `gas_limit` buys at
+    // the measured rate
+    std::chrono::microseconds estimate_cost(
+        PoolLoad const &load, Transaction const &txn, uint64_t const gas_limit)
+    {
+        uint64_t cost_us =
+            load.avg_execution_us.load(std::memory_order_relaxed);
+        if (txn.to.has_value()) {
+            ContractCostCache::ConstAccessor acc;
+            if (contract_costs_.find(acc, *txn.to)) {
+                auto const &[avg_us, updated] = acc->second.value_;
+                auto const half_lives = static_cast<uint64_t>(
+                    (std::chrono::steady_clock::now() - updated) /
+                    CONTRACT_COST_HALF_LIFE);
+                if (avg_us <= cost_us) {
+                    cost_us = avg_us;
+                }
+                else if (half_lives < 64) {
+                    cost_us += (avg_us - cost_us) >> half_lives;
+                }
+            }
+        }
+        uint64_t const us_per_mgas =
+            load.avg_us_per_mgas.load(std::memory_order_relaxed);
+        if (us_per_mgas != 0) {
+            cost_us = std::min(
+                cost_us,
+                static_cast<uint64_t>(
+                    static_cast<double>(gas_limit) * 1e-6 *
+                    static_cast<double>(us_per_mgas)) +
+                    1);
+        }
+        return std::chrono::microseconds{cost_us};
+    }
+
+    // Queues a call of `cost` on the pool of `load` unless it has to wait
+    // for a fiber and is expected to run past `timeout`, so that load is
+    // shed up front rather than after the call waited out its timeout in
+    // the queue. A call that starts right away is always admitted, as the
+    // timeout only bounds its time in the queue.
+    bool admit(
+        PoolLoad &load, std::chrono::microseconds const cost,
+        std::chrono::seconds const timeout)
+    {
+        auto const wait = load.expected_wait();
+        if (wait.count() != 0 && wait + cost > timeout) {
+            load.shed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        load.queued.fetch_add(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    void record_execution(
+        PoolLoad &load, Transaction const &txn,
+        std::chrono::steady_clock::time_point const begin,
+        Result<evmc::Result> const &res)
+    {
+        uint64_t const us = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin)
+                .count());
+        load.executed.fetch_add(1, std::memory_order_relaxed);
+        PoolLoad::update_average(load.avg_execution_us, us);
+        if (!res.has_value()) {
+            return;
+        }
+        uint64_t const gas_used =
+            txn.gas_limit - static_cast<uint64_t>(res.value().gas_left);
+        if (gas_used != 0) {
+            PoolLoad::update_average(
+                load.avg_us_per_mgas, us * 1'000'000 / gas_used);
+        }
+        if (txn.to.has_value()) {
+            ContractCostCache::ConstAccessor acc;
+            uint64_t const avg = contract_costs_.find(acc, *txn.to)
+                                     ? acc->second.value_.avg_us -
+                                           (acc->second.value_.avg_us >> 2) +
+                                           (us >> 2)
+                                     : us;
+            acc.release();
+            contract_costs_.insert(
+                *txn.to,
+                ContractCost{
+                    .avg_us = avg,
+                    .updated = std::chrono::steady_clock::now()});
+        }
+    }
+
+    static void reject(
+        monad_eth_call_result *const result, char const *const message,
+        void (*complete)(monad_eth_call_result *, void *user), void *const user)
+    {
+        result->status_code = EVMC_REJECTED;
+        result->message = strdup(message);
+        MONAD_ASSERT(result->message);
+        complete(result, user);
+    }
+
     void execute_eth_call(
         monad_chain_config const chain_config, Transaction const &txn,
         BlockHeader const &block_header, Address const &sender,
         uint64_t const block_number, bytes32_t const &block_id,
         monad_state_override const *const overrides,
         void (*complete)(monad_eth_call_result *, void *user), void *const user,
-        monad_tracer_config const tracer_config, bool const gas_specified)
+        monad_tracer_config const tracer_config, bool const gas_specified,
+        std::shared_ptr<PreparedBlock> prepared = nullptr)
     {
         monad_eth_call_result *const result = new monad_eth_call_result();
 
         bool const use_high_gas_pool =
             (gas_specified && txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT);
 
-        if (use_high_gas_pool) {
-            if (high_pool_queued_count_.load(std::memory_order_acquire) >=
+        if (use_high_gas_pool &&
+            high_pool_load_.queued.load(std::memory_order_acquire) >=
                 high_pool_queue_limit_) {
-                result->status_code = EVMC_REJECTED;
-                result->message = strdup(EXCEED_QUEUE_SIZE_ERR_MSG);
-                MONAD_ASSERT(result->message);
-                complete(result, user);
-                return;
-            }
-            ++high_pool_queued_count_;
+            reject(result, EXCEED_QUEUE_SIZE_ERR_MSG, complete, user);
+            return;
+        }
+        auto &load = use_high_gas_pool ? high_pool_load_ : low_pool_load_;
+        // without a gas limit, the call runs with the low pool's first
+        uint64_t const gas_limit =
+            gas_specified
+                ? txn.gas_limit
+                : std::min(txn.gas_limit, MONAD_ETH_CALL_LOW_GAS_LIMIT);
+        if (!admit(
+                load,
+                estimate_cost(load, txn, gas_limit),
+                use_high_gas_pool ? high_pool_timeout_ : low_pool_timeout_)) {
+            reject(result, OVERLOADED_ERR_MSG, complete, user);
+            return;
         }
         submit_eth_call_to_pool(
             chain_config,
@@ -524,9 +1220,10 @@ struct monad_eth_call_executor
             tracer_config,
             gas_specified,
             std::chrono::steady_clock::now(),
-            call_count_++,
+            call_count_.fetch_add(1, std::memory_order_relaxed),
             result,
-            use_high_gas_pool);
+            use_high_gas_pool,
+            std::move(prepared));
     }
 
     void submit_eth_call_to_pool(
@@ -538,17 +1235,27 @@ struct monad_eth_call_executor
         monad_tracer_config const tracer_config, bool const gas_specified,
         std::chrono::steady_clock::time_point const call_begin,
         uint64_t const eth_call_seq_no, monad_eth_call_result *const result,
-        bool const use_high_gas_pool)
+        bool const use_high_gas_pool,
+        std::shared_ptr<PreparedBlock> prepared = nullptr)
     {
         auto &active_pool = use_high_gas_pool ? high_gas_pool_ : low_gas_pool_;
 
         auto const authorities = recover_authorities({txn}, active_pool);
         MONAD_ASSERT(authorities.size() == 1);
 
-        active_pool.submit(
+        if (prepared == nullptr) {
+            prepared = find_pinned_block(block_number, block_id);
+        }
+        PreparedBlock const *const resolved = prepared.get();
+        submit_after_prefetch(
+            active_pool,
             eth_call_seq_no,
+            resolved,
+            txn,
+            sender,
             [this,
              call_begin = call_begin,
+             enqueued = std::chrono::steady_clock::now(),
              eth_call_seq_no = eth_call_seq_no,
              chain_config = chain_config,
              orig_txn = txn,
@@ -565,12 +1272,20 @@ struct monad_eth_call_executor
              tracer_config = tracer_config,
              gas_specified = gas_specified,
              use_high_gas_pool = use_high_gas_pool,
+             prepared = std::move(prepared),
              timeout =
                  use_high_gas_pool ? high_pool_timeout_ : low_pool_timeout_] {
                 try {
-                    if (use_high_gas_pool) {
-                        --high_pool_queued_count_;
-                    }
+                    auto &load =
+                        use_high_gas_pool ? high_pool_load_ : low_pool_load_;
+                    auto const started = std::chrono::steady_clock::now();
+                    auto const running = load.start();
+                    PoolLoad::update_average(
+                        load.avg_queue_wait_us,
+                        static_cast<uint64_t>(
+                            std::chrono::duration_cast<
+                                std::chrono::microseconds>(started - enqueued)
+                                .count()));
                     // check for timeout
                     if (std::chrono::steady_clock::now() - call_begin >
                         timeout) {
@@ -592,25 +1307,16 @@ struct monad_eth_call_executor
                         transaction.gas_limit = MONAD_ETH_CALL_LOW_GAS_LIMIT;
                     }
 
-                    auto const chain =
-                        [chain_config] -> std::unique_ptr<Chain> {
-                        switch (chain_config) {
-                        case CHAIN_CONFIG_ETHEREUM_MAINNET:
-                            return std::make_unique<EthereumMainnet>();
-                        case CHAIN_CONFIG_MONAD_DEVNET:
-                            return std::make_unique<MonadDevnet>();
-                        case CHAIN_CONFIG_MONAD_TESTNET:
-                            return std::make_unique<MonadTestnet>();
-                        case CHAIN_CONFIG_MONAD_MAINNET:
-                            return std::make_unique<MonadMainnet>();
-                        case CHAIN_CONFIG_MONAD_TESTNET2:
-                            return std::make_unique<MonadTestnet2>();
-                        }
-                        MONAD_ASSERT(false);
-                    }();
+                    auto const chain = make_chain(chain_config);
 
-                    auto const block_hash_buffer =
-                        create_blockhash_buffer(block_number);
+                    auto const block =
+                        prepared != nullptr
+                            ? prepared
+                            : pinned_block(block_number, block_id);
+                    std::shared_ptr<BlockHashBufferFinalized const> const
+                        block_hash_buffer =
+                            block ? block->block_hash_buffer
+                                  : create_blockhash_buffer(block_number);
                     if (block_hash_buffer == nullptr) {
                         result->status_code = EVMC_REJECTED;
                         result->message = strdup(BLOCKHASH_ERR_MSG);
@@ -619,9 +1325,13 @@ struct monad_eth_call_executor
                         return;
                     }
 
-                    TrieRODb tdb{db};
+                    TrieRODb tdb{db, &read_cache_, code_store_.get()};
+                    if (block) {
+                        tdb.set_block_and_prefix(block->tdb);
+                    }
                     std::vector<CallFrame> call_frames;
-                    nlohmann::json state_trace;
+                    // the state tracers encode straight to CBOR
+                    byte_string state_trace;
                     std::unique_ptr<CallTracerBase> call_tracer =
                         tracer_config == CALL_TRACER
                             ? std::unique_ptr<CallTracerBase>{std::make_unique<
@@ -641,50 +1351,22 @@ struct monad_eth_call_executor
                         MONAD_ASSERT(false);
                     }();
 
-                    auto const res = [&]() -> Result<evmc::Result> {
-                        if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
-                            evmc_revision const rev = chain->get_revision(
-                                block_header.number, block_header.timestamp);
-                            SWITCH_EVM_TRAITS(
-                                eth_call_impl,
-                                *chain,
-                                transaction,
-                                block_header,
-                                block_number,
-                                block_id,
-                                sender,
-                                authorities,
-                                tdb,
-                                vm_,
-                                *block_hash_buffer,
-                                *state_overrides,
-                                *call_tracer,
-                                state_tracer);
-                            MONAD_ASSERT(false);
-                        }
-                        else {
-                            auto const rev =
-                                dynamic_cast<MonadChain *>(chain.get())
-                                    ->get_monad_revision(
-                                        block_header.timestamp);
-                            SWITCH_MONAD_TRAITS(
-                                eth_call_impl,
-                                *chain,
-                                transaction,
-                                block_header,
-                                block_number,
-                                block_id,
-                                sender,
-                                authorities,
-                                tdb,
-                                vm_,
-                                *block_hash_buffer,
-                                *state_overrides,
-                                *call_tracer,
-                                state_tracer);
-                            MONAD_ASSERT(false);
-                        }
-                    }();
+                    auto const res = dispatch_eth_call(
+                        chain_config,
+                        *chain,
+                        transaction,
+                        block_header,
+                        block_number,
+                        block_id,
+                        sender,
+                        authorities,
+                        tdb,
+                        vm_,
+                        *block_hash_buffer,
+                        *state_overrides,
+                        *call_tracer,
+                        state_tracer);
+                    record_execution(load, transaction, started, res);
 
                     if (override_with_low_gas_retry_if_oog &&
                         ((res.has_value() &&
@@ -706,7 +1388,8 @@ struct monad_eth_call_executor
                             tracer_config,
                             call_begin,
                             eth_call_seq_no,
-                            result);
+                            result,
+                            block);
                         return;
                     }
                     if (MONAD_UNLIKELY(res.has_error())) {
@@ -740,12 +1423,224 @@ struct monad_eth_call_executor
             });
     }
 
+    // Searches for the lowest gas limit, up to the one of `txn`, the call
+    // succeeds with. Every probe runs in the same task on the same block
+    // state, so sender recovery, block setup and the reads of the block are
+    // paid for once.
+    void execute_estimate_gas(
+        monad_chain_config const chain_config, Transaction const &txn,
+        BlockHeader const &block_header, Address const &sender,
+        uint64_t const block_number, bytes32_t const &block_id,
+        monad_state_override const *const overrides,
+        void (*complete)(monad_eth_call_result *, void *user), void *const user)
+    {
+        monad_eth_call_result *const result = new monad_eth_call_result();
+
+        if (high_pool_load_.queued.load(std::memory_order_acquire) >=
+            high_pool_queue_limit_) {
+            reject(result, EXCEED_QUEUE_SIZE_ERR_MSG, complete, user);
+            return;
+        }
+        if (!admit(
+                high_pool_load_,
+                estimate_cost(high_pool_load_, txn, txn.gas_limit),
+                high_pool_timeout_)) {
+            reject(result, OVERLOADED_ERR_MSG, complete, user);
+            return;
+        }
+
+        auto const authorities = recover_authorities({txn}, high_gas_pool_);
+        MONAD_ASSERT(authorities.size() == 1);
+
+        high_gas_pool_.submit(
+            call_count_.fetch_add(1, std::memory_order_relaxed),
+            [this,
+             call_begin = std::chrono::steady_clock::now(),
+             chain_config = chain_config,
+             orig_txn = txn,
+             block_header = block_header,
+             block_number = block_number,
+             block_id = block_id,
+             sender = sender,
+             authorities = authorities[0],
+             result = result,
+             complete = complete,
+             user = user,
+             state_overrides = overrides] {
+                try {
+                    auto const started = std::chrono::steady_clock::now();
+                    auto const running = high_pool_load_.start();
+                    PoolLoad::update_average(
+                        high_pool_load_.avg_queue_wait_us,
+                        static_cast<uint64_t>(
+                            std::chrono::duration_cast<
+                                std::chrono::microseconds>(started - call_begin)
+                                .count()));
+                    if (started - call_begin > high_pool_timeout_) {
+                        result->status_code = EVMC_REJECTED;
+                        result->message = strdup(TIMEOUT_ERR_MSG);
+                        MONAD_ASSERT(result->message);
+                        complete(result, user);
+                        return;
+                    }
+
+                    auto const chain = make_chain(chain_config);
+                    auto const block = pinned_block(block_number, block_id);
+                    std::shared_ptr<BlockHashBufferFinalized const> const
+                        block_hash_buffer =
+                            block ? block->block_hash_buffer
+                                  : create_blockhash_buffer(block_number);
+                    if (block_hash_buffer == nullptr) {
+                        result->status_code = EVMC_REJECTED;
+                        result->message = strdup(BLOCKHASH_ERR_MSG);
+                        MONAD_ASSERT(result->message);
+                        complete(result, user);
+                        return;
+                    }
+
+                    TrieRODb tdb{db_, &read_cache_, code_store_.get()};
+                    if (block) {
+                        tdb.set_block_and_prefix(block->tdb);
+                    }
+                    else {
+                        tdb.set_block_and_prefix(block_number, block_id);
+                    }
+                    BlockState block_state{tdb, vm_};
+
+                    auto transaction = orig_txn;
+                    auto const probe = [&](uint64_t const gas_limit) {
+                        transaction.gas_limit = gas_limit;
+                        NoopCallTracer call_tracer;
+                        return dispatch_eth_call(
+                            chain_config,
+                            *chain,
+                            transaction,
+                            block_header,
+                            block_number,
+                            block_id,
+                            sender,
+                            authorities,
+                            tdb,
+                            vm_,
+                            *block_hash_buffer,
+                            *state_overrides,
+                            call_tracer,
+                            std::monostate{},
+                            &block_state);
+                    };
+                    auto const succeeds = [](Result<evmc::Result> const &res) {
+                        return res.has_value() &&
+                               res.value().status_code == EVMC_SUCCESS;
+                    };
+
+                    // the unbounded run reports why the call fails, if it
+                    // does
+                    auto const run_begin = std::chrono::steady_clock::now();
+                    auto const res = probe(orig_txn.gas_limit);
+                    record_execution(
+                        high_pool_load_, transaction, run_begin, res);
+                    if (MONAD_UNLIKELY(res.has_error())) {
+                        result->status_code = EVMC_REJECTED;
+                        result->message = strdup(res.error().message().c_str());
+                        MONAD_ASSERT(result->message);
+                        complete(result, user);
+                        return;
+                    }
+                    if (res.value().status_code != EVMC_SUCCESS) {
+                        call_complete(
+                            transaction,
+                            res.value(),
+                            result,
+                            complete,
+                            user,
+                            {},
+                            {});
+                        return;
+                    }
+
+                    // the call spent `used` before refunds, so any lower
+                    // limit fails, but it may need more than that up front as
+                    // a call forwards at most 63/64 of what is left
+                    uint64_t const used =
+                        orig_txn.gas_limit -
+                        static_cast<uint64_t>(res.value().gas_left);
+                    uint64_t lo = used - 1;
+                    uint64_t hi = orig_txn.gas_limit;
+                    if (used < hi) {
+                        if (succeeds(probe(used))) {
+                            hi = used;
+                        }
+                        else {
+                            lo = used;
+                        }
+                    }
+                    uint64_t const optimistic =
+                        (used + STIPEND_GAS) * 64 / 63;
+                    if (lo + 1 < hi && optimistic < hi) {
+                        if (succeeds(probe(optimistic))) {
+                            hi = optimistic;
+                        }
+                        else {
+                            lo = optimistic;
+                        }
+                    }
+                    // a limit within the precision of the lowest one is as
+                    // good an estimate, clients pad it anyway
+                    while (lo + 1 < hi &&
+                           (hi - lo) * ESTIMATE_PRECISION_DIVISOR > hi) {
+                        if (std::chrono::steady_clock::now() - call_begin >
+                            high_pool_timeout_) {
+                            break;
+                        }
+                        // most calls need little more than they spent, so
+                        // probe close to the lower bound first
+                        uint64_t const mid =
+                            std::min(lo + (hi - lo) / 2, lo * 2);
+                        if (succeeds(probe(mid))) {
+                            hi = mid;
+                        }
+                        else {
+                            lo = mid;
+                        }
+                    }
+
+                    transaction.gas_limit = orig_txn.gas_limit;
+                    fill_result(transaction, res.value(), result, {}, {});
+                    result->gas_used = static_cast<int64_t>(hi);
+                    complete(result, user);
+                }
+                catch (MonadException const &e) {
+                    result->status_code = EVMC_INTERNAL_ERROR;
+                    result->message = strdup(e.message());
+                    MONAD_ASSERT(result->message);
+                    complete(result, user);
+                }
+                catch (...) {
+                    result->status_code = EVMC_INTERNAL_ERROR;
+                    result->message = strdup(UNEXPECTED_EXCEPTION_ERR_MSG);
+                    MONAD_ASSERT(result->message);
+                    complete(result, user);
+                }
+            });
+    }
+
     void call_complete(
         Transaction const &transaction, evmc::Result const &evmc_result,
         monad_eth_call_result *const result,
         void (*complete)(monad_eth_call_result *, void *user), void *const user,
         std::vector<CallFrame> const &call_frames,
-        nlohmann::json const &state_trace)
+        byte_string const &state_trace)
+    {
+        fill_result(
+            transaction, evmc_result, result, call_frames, state_trace);
+        complete(result, user);
+    }
+
+    static void fill_result(
+        Transaction const &transaction, evmc::Result const &evmc_result,
+        monad_eth_call_result *const result,
+        std::vector<CallFrame> const &call_frames,
+        byte_string const &state_trace)
     {
         result->status_code = evmc_result.status_code;
         result->gas_used =
@@ -775,20 +1670,17 @@ struct monad_eth_call_executor
                 rlp_call_frames.size());
         }
         else if (!state_trace.empty()) {
-            std::vector<uint8_t> cbor_state_trace =
-                nlohmann::json::to_cbor(state_trace);
-            result->encoded_trace = new uint8_t[cbor_state_trace.size()];
-            result->encoded_trace_len = cbor_state_trace.size();
+            result->encoded_trace = new uint8_t[state_trace.size()];
+            result->encoded_trace_len = state_trace.size();
             memcpy(
                 (uint8_t *)result->encoded_trace,
-                cbor_state_trace.data(),
-                cbor_state_trace.size());
+                state_trace.data(),
+                state_trace.size());
         }
         else {
             result->encoded_trace = nullptr;
             result->encoded_trace_len = 0;
         }
-        complete(result, user);
     }
 
     void retry_in_high_pool(
@@ -799,21 +1691,27 @@ struct monad_eth_call_executor
         void (*complete)(monad_eth_call_result *, void *user), void *const user,
         monad_tracer_config const tracer_config,
         std::chrono::steady_clock::time_point const call_begin,
-        auto const eth_call_seq_no, monad_eth_call_result *const result)
+        auto const eth_call_seq_no, monad_eth_call_result *const result,
+        std::shared_ptr<PreparedBlock> prepared)
     {
         // retry in high gas limit pool
         MONAD_ASSERT(orig_txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT);
 
-        if (high_pool_queued_count_.load(std::memory_order_acquire) >=
+        if (high_pool_load_.queued.load(std::memory_order_acquire) >=
             high_pool_queue_limit_) {
-            result->status_code = EVMC_REJECTED;
-            result->message = strdup(EXCEED_QUEUE_SIZE_ERR_MSG);
-            MONAD_ASSERT(result->message);
-            complete(result, user);
+            reject(result, EXCEED_QUEUE_SIZE_ERR_MSG, complete, user);
+            return;
+        }
+        // the time already spent counts against the timeout of the retry
+        auto const spent = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - call_begin);
+        if (!admit(
+                high_pool_load_,
+                estimate_cost(high_pool_load_, orig_txn, orig_txn.gas_limit),
+                high_pool_timeout_ - spent)) {
+            reject(result, OVERLOADED_ERR_MSG, complete, user);
             return;
         }
-
-        ++high_pool_queued_count_;
         submit_eth_call_to_pool(
             chain_config,
             orig_txn,
@@ -829,7 +1727,8 @@ struct monad_eth_call_executor
             call_begin,
             eth_call_seq_no,
             result,
-            true /* use_high_gas_pool */);
+            true /* use_high_gas_pool */,
+            std::move(prepared));
     }
 };
 
@@ -859,6 +1758,19 @@ void monad_eth_call_executor_destroy(monad_eth_call_executor *const e)
     delete e;
 }
 
+bool monad_eth_call_executor_open_code_store(
+    monad_eth_call_executor *const executor, char const *const path)
+{
+    MONAD_ASSERT(executor);
+    MONAD_ASSERT(path);
+    executor->code_store_ = vm::SharedCodeStore::open(path);
+    if (executor->code_store_ == nullptr) {
+        LOG_WARNING("no shared code store at {}", path);
+        return false;
+    }
+    return true;
+}
+
 void monad_eth_call_executor_submit(
     monad_eth_call_executor *const executor,
     monad_chain_config const chain_config, uint8_t const *const rlp_txn,
@@ -900,6 +1812,23 @@ void monad_eth_call_executor_submit(
 
     MONAD_ASSERT(overrides);
 
+    auto *const call = executor->coalesce(
+        eth_call_key(
+            chain_config,
+            {rlp_txn, rlp_txn_len},
+            {rlp_header, rlp_header_len},
+            {rlp_sender, rlp_sender_len},
+            block_number,
+            {rlp_block_id, rlp_block_id_len},
+            *overrides,
+            tracer_config,
+            gas_specified),
+        complete,
+        user);
+    if (call == nullptr) {
+        return;
+    }
+
     executor->execute_eth_call(
         chain_config,
         tx,
@@ -908,8 +1837,177 @@ void monad_eth_call_executor_submit(
         block_number,
         block_id,
         overrides,
-        complete,
-        user,
+        &monad_eth_call_executor::coalesced_complete,
+        call,
         tracer_config,
         gas_specified);
 }
+
+void monad_eth_call_executor_estimate_gas(
+    monad_eth_call_executor *const executor,
+    monad_chain_config const chain_config, uint8_t const *const rlp_txn,
+    size_t const rlp_txn_len, uint8_t const *const rlp_header,
+    size_t const rlp_header_len, uint8_t const *const rlp_sender,
+    size_t const rlp_sender_len, uint64_t const block_number,
+    uint8_t const *const rlp_block_id, size_t const rlp_block_id_len,
+    monad_state_override const *const overrides,
+    void (*complete)(monad_eth_call_result *result, void *user),
+    void *const user)
+{
+    MONAD_ASSERT(executor);
+
+    byte_string_view rlp_tx_view({rlp_txn, rlp_txn_len});
+    byte_string_view rlp_header_view({rlp_header, rlp_header_len});
+    byte_string_view rlp_sender_view({rlp_sender, rlp_sender_len});
+    byte_string_view block_id_view({rlp_block_id, rlp_block_id_len});
+
+    auto const tx_result = rlp::decode_transaction(rlp_tx_view);
+    MONAD_ASSERT(!tx_result.has_error());
+    MONAD_ASSERT(rlp_tx_view.empty());
+    auto const tx = tx_result.value();
+
+    auto const block_header_result = rlp::decode_block_header(rlp_header_view);
+    MONAD_ASSERT(!block_header_result.has_error());
+    MONAD_ASSERT(rlp_header_view.empty());
+    auto const block_header = block_header_result.value();
+
+    auto const sender_result = rlp::decode_address(rlp_sender_view);
+    MONAD_ASSERT(!sender_result.has_error());
+    MONAD_ASSERT(rlp_sender_view.empty());
+    auto const sender = sender_result.value();
+
+    auto const block_id_result = rlp::decode_bytes32(block_id_view);
+    MONAD_ASSERT(!block_id_result.has_error());
+    MONAD_ASSERT(block_id_view.empty());
+    auto const block_id = block_id_result.value();
+
+    MONAD_ASSERT(overrides);
+
+    executor->execute_estimate_gas(
+        chain_config,
+        tx,
+        block_header,
+        sender,
+        block_number,
+        block_id,
+        overrides,
+        complete,
+        user);
+}
+
+void monad_eth_call_executor_get_pool_metrics(
+    monad_eth_call_executor const *const executor,
+    monad_eth_call_pool_metrics *const low_pool,
+    monad_eth_call_pool_metrics *const high_pool)
+{
+    MONAD_ASSERT(executor);
+    MONAD_ASSERT(low_pool);
+    MONAD_ASSERT(high_pool);
+
+    auto const get = [](monad_eth_call_executor::PoolLoad const &load,
+                        monad_eth_call_pool_metrics &metrics) {
+        metrics.queued = load.queued.load(std::memory_order_acquire);
+        metrics.running = load.running.load(std::memory_order_acquire);
+        metrics.expected_queue_wait_us =
+            static_cast<uint64_t>(load.expected_wait().count());
+        metrics.avg_queue_wait_us =
+            load.avg_queue_wait_us.load(std::memory_order_relaxed);
+        metrics.avg_execution_us =
+            load.avg_execution_us.load(std::memory_order_relaxed);
+        metrics.executed = load.executed.load(std::memory_order_relaxed);
+        metrics.shed = load.shed.load(std::memory_order_relaxed);
+    };
+    get(executor->low_pool_load_, *low_pool);
+    get(executor->high_pool_load_, *high_pool);
+}
+
+bool monad_eth_call_executor_apply_finalized_delta(
+    monad_eth_call_executor *const executor, uint64_t const block_number,
+    uint8_t const *const addresses, size_t const addresses_len,
+    uint8_t const *const storage_keys, size_t const storage_keys_len)
+{
+    MONAD_ASSERT(executor);
+    std::optional<TrieRODbCache::Delta> delta;
+    try {
+        delta = TrieRODbCache::Delta::unpack(
+            addresses, addresses_len, storage_keys, storage_keys_len);
+    }
+    catch (MonadException const &) {
+        return false;
+    }
+    executor->read_cache_.apply_finalized_delta(
+        block_number, std::move(delta).value());
+    return true;
+}
+
+void monad_eth_call_executor_submit_batch(
+    monad_eth_call_executor *const executor,
+    monad_chain_config const chain_config,
+    monad_eth_call_batch_entry const *const calls, size_t const num_calls,
+    uint8_t const *const rlp_header, size_t const rlp_header_len,
+    uint64_t const block_number, uint8_t const *const rlp_block_id,
+    size_t const rlp_block_id_len, monad_state_override const *const overrides,
+    void (*complete)(
+        monad_eth_call_result **results, size_t num_results, void *user),
+    void *const user, monad_tracer_config const tracer_config)
+{
+    MONAD_ASSERT(executor);
+    MONAD_ASSERT(calls || num_calls == 0);
+    MONAD_ASSERT(overrides);
+
+    byte_string_view rlp_header_view({rlp_header, rlp_header_len});
+    byte_string_view block_id_view({rlp_block_id, rlp_block_id_len});
+
+    auto const block_header_result = rlp::decode_block_header(rlp_header_view);
+    MONAD_ASSERT(!block_header_result.has_error());
+    MONAD_ASSERT(rlp_header_view.empty());
+    auto const &block_header = block_header_result.value();
+
+    auto const block_id_result = rlp::decode_bytes32(block_id_view);
+    MONAD_ASSERT(!block_id_result.has_error());
+    MONAD_ASSERT(block_id_view.empty());
+    auto const &block_id = block_id_result.value();
+
+    std::vector<monad_eth_call_executor::BatchCall> batch;
+    batch.reserve(num_calls);
+    for (size_t i = 0; i < num_calls; ++i) {
+        auto const &call = calls[i];
+        byte_string_view rlp_tx_view({call.rlp_txn, call.rlp_txn_len});
+        byte_string_view rlp_sender_view(
+            {call.rlp_sender, call.rlp_sender_len});
+
+        auto tx_result = rlp::decode_transaction(rlp_tx_view);
+        MONAD_ASSERT(!tx_result.has_error());
+        MONAD_ASSERT(rlp_tx_view.empty());
+
+        auto const sender_result = rlp::decode_address(rlp_sender_view);
+        MONAD_ASSERT(!sender_result.has_error());
+        MONAD_ASSERT(rlp_sender_view.empty());
+
+        batch.push_back(monad_eth_call_executor::BatchCall{
+            .txn = std::move(tx_result.value()),
+            .sender = sender_result.value(),
+            .gas_specified = call.gas_specified,
+            .key = eth_call_key(
+                chain_config,
+                {call.rlp_txn, call.rlp_txn_len},
+                {rlp_header, rlp_header_len},
+                {call.rlp_sender, call.rlp_sender_len},
+                block_number,
+                {rlp_block_id, rlp_block_id_len},
+                *overrides,
+                tracer_config,
+                call.gas_specified)});
+    }
+
+    executor->execute_eth_call_batch(
+        chain_config,
+        std::move(batch),
+        block_header,
+        block_number,
+        block_id,
+        overrides,
+        complete,
+        user,
+        tracer_config);
+}
@@ -78,6 +78,8 @@ typedef struct monad_eth_call_result
 
 void monad_eth_call_result_release(monad_eth_call_result *);
 
+// `node_lru_max_mem` is the byte budget of the read caches shared by the low
+// and high gas pools: triedb nodes plus decoded accounts and storage
 struct monad_eth_call_executor *monad_eth_call_executor_create(
     unsigned num_threads, unsigned num_fibers, uint64_t node_lru_max_mem,
     unsigned low_pool_timeout_sec, unsigned high_pool_timeout_sec,
@@ -85,6 +87,94 @@ struct monad_eth_call_executor *monad_eth_call_executor_create(
 
 void monad_eth_call_executor_destroy(struct monad_eth_call_executor *);
 
+// Serves contract code from the shared code store the execution daemon writes
+// at `path` (its --shared_code_store) before reading it from the db, skipping
+// both the db read and the analysis of the code. Must be called before any
+// call is submitted. Returns false if there is no valid store at `path`.
+bool monad_eth_call_executor_open_code_store(
+    struct monad_eth_call_executor *, char const *path);
+
+typedef struct monad_eth_call_batch_entry
+{
+    uint8_t const *rlp_txn;
+    size_t rlp_txn_len;
+    uint8_t const *rlp_sender;
+    size_t rlp_sender_len;
+    bool gas_specified;
+} monad_eth_call_batch_entry;
+
+// Runs `num_calls` independent calls against one block. The block header,
+// block hash buffer and state root are resolved once for the whole batch and
+// the calls run in parallel on the pools, each as if submitted on its own.
+// `complete` is called once with a result per call, in the order of `calls`;
+// the array is only valid during the callback but every result is owned by
+// the caller. `calls` may be released on return, the state override must
+// outlive the callback.
+void monad_eth_call_executor_submit_batch(
+    struct monad_eth_call_executor *, enum monad_chain_config,
+    monad_eth_call_batch_entry const *calls, size_t num_calls,
+    uint8_t const *rlp_header, size_t rlp_header_len, uint64_t block_number,
+    uint8_t const *rlp_block_id, size_t rlp_block_id_len,
+    struct monad_state_override const *,
+    void (*complete)(
+        monad_eth_call_result **results, size_t num_results, void *user),
+    void *user, enum monad_tracer_config);
+
+typedef struct monad_eth_call_pool_metrics
+{
+    unsigned queued;
+    // calls on a fiber of the pool
+    unsigned running;
+    // time a call submitted now is expected to wait for a fiber
+    uint64_t expected_queue_wait_us;
+    // exponentially weighted averages over recent calls
+    uint64_t avg_queue_wait_us;
+    uint64_t avg_execution_us;
+    uint64_t executed;
+    // calls rejected up front because they were expected to time out
+    uint64_t shed;
+} monad_eth_call_pool_metrics;
+
+// Calls that have to wait for a fiber are admitted to a pool only if their
+// expected queue wait plus their expected execution time, from the recent
+// history of their target contract and their gas limit, fits in the pool
+// timeout. Those that do not are rejected with EVMC_REJECTED right away
+// instead of timing out in the queue.
+void monad_eth_call_executor_get_pool_metrics(
+    struct monad_eth_call_executor const *,
+    monad_eth_call_pool_metrics *low_pool,
+    monad_eth_call_pool_metrics *high_pool);
+
+// Reports what finalized block `block_number` changed relative to its parent,
+// so reads cached at the parent carry over to calls at this block instead of
+// going back to the db. `addresses` packs the 20 byte addresses of accounts
+// whose balance, nonce, code or incarnation changed. `storage_keys` packs the
+// 52 byte (address, slot key) pairs of every other slot whose value changed.
+// Both lengths are in bytes. Anything left out is served stale, so callers
+// that cannot produce a complete delta must not call this. Meant for the RPC
+// server as it follows finalized blocks on the execution event ring, packing
+// the accounts and slots that their account and storage access events report
+// as modified. Without it, every read at a new block goes to the db. Returns
+// false, and applies nothing, if a length is not a whole number of entries.
+bool monad_eth_call_executor_apply_finalized_delta(
+    struct monad_eth_call_executor *, uint64_t block_number,
+    uint8_t const *addresses, size_t addresses_len,
+    uint8_t const *storage_keys, size_t storage_keys_len);
+
+// Estimates the gas limit the transaction needs, searching up to its own gas
+// limit. On success `gas_used` of the result holds the estimate, which is at
+// most 1/64 above the lowest limit that succeeds, and `output_data` and
+// `gas_refund` are those of the run at the full limit. If the call fails at its
+// own gas limit the result is the one `monad_eth_call_executor_submit` would
+// report. Runs on the high gas pool and counts against its queue limit.
+void monad_eth_call_executor_estimate_gas(
+    struct monad_eth_call_executor *, enum monad_chain_config,
+    uint8_t const *rlp_txn, size_t rlp_txn_len, uint8_t const *rlp_header,
+    size_t rlp_header_len, uint8_t const *rlp_sender, size_t rlp_sender_len,
+    uint64_t block_number, uint8_t const *rlp_block_id, size_t rlp_block_id_len,
+    struct monad_state_override const *,
+    void (*complete)(monad_eth_call_result *, void *user), void *user);
+
 void monad_eth_call_executor_submit(
     struct monad_eth_call_executor *, enum monad_chain_config,
     uint8_t const *rlp_txn, size_t rlp_txn_len, uint8_t const *rlp_header,
@@ -23,6 +23,7 @@
 #include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
 #include <category/execution/ethereum/core/rlp/transaction_rlp.hpp>
 #include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/trie_rodb.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
@@ -37,9 +38,14 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <deque>
 #include <memory>
+#include <optional>
 #include <ranges>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace monad;
@@ -1524,3 +1530,489 @@ TEST_F(EthCallFixture, contract_deployment_success_with_state_trace)
     monad_state_override_destroy(state_override);
     monad_eth_call_executor_destroy(executor);
 }
+
+TEST_F(EthCallFixture, read_cache_carries_unchanged_reads_forward)
+{
+    bytes32_t const key{1};
+    bytes32_t const value{2};
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{.account = {std::nullopt, Account{.balance = 1}}}},
+            {ADDR_B,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 2}},
+                 .storage = {{key, {bytes32_t{}, value}}}}}},
+        Code{},
+        BlockHeader{.number = 0});
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{
+                 .account = {Account{.balance = 1}, Account{.balance = 3}}}}},
+        Code{},
+        BlockHeader{.number = 1});
+
+    mpt::RODb rodb{mpt::ReadOnlyOnDiskDbConfig{.dbname_paths = {dbname}}};
+
+    // Values planted at block 0 that differ from the db show whether a read
+    // at block 1 was carried over or went to the db
+    bytes32_t const planted{42};
+    auto const read_at_block_1 =
+        [&](std::optional<TrieRODbCache::Delta> delta) {
+            TrieRODbCache cache{1 << 20};
+            cache.accounts.insert(
+                TrieRODbCache::make_key(0, {}, ADDR_A),
+                Account{.balance = 42});
+            cache.accounts.insert(
+                TrieRODbCache::make_key(0, {}, ADDR_B),
+                Account{.balance = 42});
+            cache.storage.insert(
+                TrieRODbCache::make_key(0, {}, ADDR_B, key), planted);
+            if (delta.has_value()) {
+                cache.apply_finalized_delta(1, std::move(delta).value());
+            }
+            TrieRODb ro{rodb, &cache};
+            ro.set_block_and_prefix(1);
+            return std::make_tuple(
+                ro.read_account(ADDR_A).value().balance,
+                ro.read_account(ADDR_B).value().balance,
+                ro.read_storage(ADDR_B, Incarnation{0, 0}, key));
+        };
+
+    // without a delta for the block every read goes to the db
+    EXPECT_EQ(
+        read_at_block_1(std::nullopt),
+        std::make_tuple(uint256_t{3}, uint256_t{2}, value));
+    // unchanged entries carry over, changed ones are read again
+    EXPECT_EQ(
+        read_at_block_1(TrieRODbCache::Delta{.accounts = {ADDR_A}}),
+        std::make_tuple(uint256_t{3}, uint256_t{42}, planted));
+    // as packed for monad_eth_call_executor_apply_finalized_delta()
+    byte_string storage_keys{ADDR_B.bytes, sizeof(Address)};
+    storage_keys.append(key.bytes, sizeof(bytes32_t));
+    EXPECT_EQ(
+        read_at_block_1(TrieRODbCache::Delta::unpack(
+            ADDR_A.bytes,
+            sizeof(Address),
+            storage_keys.data(),
+            storage_keys.size())),
+        std::make_tuple(uint256_t{3}, uint256_t{42}, value));
+    // malformed packed input throws rather than aborting
+    EXPECT_THROW(
+        TrieRODbCache::Delta::unpack(
+            ADDR_A.bytes,
+            sizeof(Address) - 1,
+            storage_keys.data(),
+            storage_keys.size()),
+        MonadException);
+    EXPECT_THROW(
+        TrieRODbCache::Delta::unpack(
+            ADDR_A.bytes,
+            sizeof(Address),
+            storage_keys.data(),
+            storage_keys.size() - 1),
+        MonadException);
+}
+
+TEST_F(EthCallFixture, identical_calls_share_result)
+{
+    for (uint64_t i = 0; i < 256; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    Transaction tx{
+        .gas_limit = 100000u, .to = to, .type = TransactionType::eip1559};
+    BlockHeader header{.number = 256};
+
+    commit_sequential(tdb, {}, {}, header);
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto executor = monad_eth_call_executor_create(
+        1,
+        1,
+        node_lru_max_mem,
+        max_timeout,
+        max_timeout,
+        dbname.string().c_str());
+    auto state_override = monad_state_override_create();
+
+    auto const submit = [&](callback_context &ctx,
+                            monad_tracer_config const tracer_config) {
+        monad_eth_call_executor_submit(
+            executor,
+            CHAIN_CONFIG_MONAD_DEVNET,
+            rlp_tx.data(),
+            rlp_tx.size(),
+            rlp_header.data(),
+            rlp_header.size(),
+            rlp_sender.data(),
+            rlp_sender.size(),
+            header.number,
+            rlp_block_id.data(),
+            rlp_block_id.size(),
+            state_override,
+            complete_callback,
+            (void *)&ctx,
+            tracer_config,
+            true);
+    };
+
+    // submitted back to back, the second attaches to the first or is served
+    // from its cached result; either way each caller owns its result
+    struct callback_context ctx1;
+    struct callback_context ctx2;
+    auto f1 = ctx1.promise.get_future();
+    auto f2 = ctx2.promise.get_future();
+    submit(ctx1, CALL_TRACER);
+    submit(ctx2, CALL_TRACER);
+    f1.get();
+    f2.get();
+
+    ASSERT_NE(ctx1.result, ctx2.result);
+    EXPECT_EQ(ctx1.result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx2.result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx1.result->gas_used, ctx2.result->gas_used);
+    ASSERT_NE(ctx1.result->encoded_trace_len, 0);
+    EXPECT_NE(ctx1.result->encoded_trace, ctx2.result->encoded_trace);
+    EXPECT_EQ(
+        byte_string_view(
+            ctx1.result->encoded_trace, ctx1.result->encoded_trace_len),
+        byte_string_view(
+            ctx2.result->encoded_trace, ctx2.result->encoded_trace_len));
+
+    // a different tracer is a different call
+    struct callback_context ctx3;
+    auto f3 = ctx3.promise.get_future();
+    submit(ctx3, NOOP_TRACER);
+    f3.get();
+    EXPECT_EQ(ctx3.result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx3.result->encoded_trace_len, 0);
+
+    monad_state_override_destroy(state_override);
+    monad_eth_call_executor_destroy(executor);
+}
+
+TEST_F(EthCallFixture, submit_batch)
+{
+    for (uint64_t i = 0; i < 256; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    BlockHeader header{.number = 256};
+    commit_sequential(tdb, {}, {}, header);
+
+    // the second call cannot pay its intrinsic gas
+    std::array<Transaction, 3> const txns{
+        Transaction{
+            .gas_limit = 100000u, .to = to, .type = TransactionType::eip1559},
+        Transaction{
+            .gas_limit = 100u, .to = to, .type = TransactionType::eip1559},
+        Transaction{
+            .gas_limit = 50000u, .to = to, .type = TransactionType::eip1559}};
+    std::vector<std::vector<uint8_t>> rlp_txns;
+    for (auto const &tx : txns) {
+        rlp_txns.push_back(to_vec(rlp::encode_transaction(tx)));
+    }
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    std::vector<monad_eth_call_batch_entry> entries;
+    for (auto const &rlp_tx : rlp_txns) {
+        entries.push_back(monad_eth_call_batch_entry{
+            .rlp_txn = rlp_tx.data(),
+            .rlp_txn_len = rlp_tx.size(),
+            .rlp_sender = rlp_sender.data(),
+            .rlp_sender_len = rlp_sender.size(),
+            .gas_specified = true});
+    }
+
+    auto executor = monad_eth_call_executor_create(
+        2,
+        4,
+        node_lru_max_mem,
+        max_timeout,
+        max_timeout,
+        dbname.string().c_str());
+    auto state_override = monad_state_override_create();
+
+    struct batch_context
+    {
+        std::vector<monad_eth_call_result *> results;
+        boost::fibers::promise<void> promise;
+
+        ~batch_context()
+        {
+            for (auto *const result : results) {
+                monad_eth_call_result_release(result);
+            }
+        }
+    } ctx;
+    auto f = ctx.promise.get_future();
+
+    monad_eth_call_executor_submit_batch(
+        executor,
+        CHAIN_CONFIG_MONAD_DEVNET,
+        entries.data(),
+        entries.size(),
+        rlp_header.data(),
+        rlp_header.size(),
+        header.number,
+        rlp_block_id.data(),
+        rlp_block_id.size(),
+        state_override,
+        [](monad_eth_call_result **const results,
+           size_t const num_results,
+           void *const user) {
+            auto *const c = static_cast<batch_context *>(user);
+            c->results.assign(results, results + num_results);
+            c->promise.set_value();
+        },
+        &ctx,
+        NOOP_TRACER);
+    f.get();
+
+    ASSERT_EQ(ctx.results.size(), 3);
+    EXPECT_EQ(ctx.results[0]->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx.results[0]->gas_used, 21000);
+    EXPECT_EQ(ctx.results[1]->status_code, EVMC_REJECTED);
+    EXPECT_EQ(ctx.results[2]->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx.results[2]->gas_used, 21000);
+
+    monad_state_override_destroy(state_override);
+    monad_eth_call_executor_destroy(executor);
+}
+
+TEST_F(EthCallFixture, estimate_gas)
+{
+    for (uint64_t i = 0; i < 256; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    BlockHeader header{.number = 256};
+
+    commit_sequential(tdb, {}, {}, header);
+
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto executor = monad_eth_call_executor_create(
+        1,
+        1,
+        node_lru_max_mem,
+        max_timeout,
+        max_timeout,
+        dbname.string().c_str());
+    auto state_override = monad_state_override_create();
+
+    auto const estimate = [&](callback_context &ctx, uint64_t const gas_limit) {
+        Transaction const tx{
+            .gas_limit = gas_limit, .to = to, .type = TransactionType::eip1559};
+        auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+        auto f = ctx.promise.get_future();
+        monad_eth_call_executor_estimate_gas(
+            executor,
+            CHAIN_CONFIG_MONAD_DEVNET,
+            rlp_tx.data(),
+            rlp_tx.size(),
+            rlp_header.data(),
+            rlp_header.size(),
+            rlp_sender.data(),
+            rlp_sender.size(),
+            header.number,
+            rlp_block_id.data(),
+            rlp_block_id.size(),
+            state_override,
+            complete_callback,
+            (void *)&ctx);
+        f.get();
+    };
+
+    // a plain transfer needs exactly the intrinsic gas
+    struct callback_context ctx1;
+    estimate(ctx1, 1'000'000);
+    EXPECT_EQ(ctx1.result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx1.result->gas_used, 21'000);
+
+    // below the intrinsic gas nothing is searched
+    struct callback_context ctx2;
+    estimate(ctx2, 20'000);
+    EXPECT_EQ(ctx2.result->status_code, EVMC_REJECTED);
+    EXPECT_NE(ctx2.result->message, nullptr);
+
+    monad_state_override_destroy(state_override);
+    monad_eth_call_executor_destroy(executor);
+}
+
+TEST_F(EthCallFixture, pool_metrics)
+{
+    for (uint64_t i = 0; i < 256; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    Transaction tx{
+        .gas_limit = 100000u, .to = to, .type = TransactionType::eip1559};
+    BlockHeader header{.number = 256};
+
+    commit_sequential(tdb, {}, {}, header);
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto executor = monad_eth_call_executor_create(
+        1,
+        1,
+        node_lru_max_mem,
+        max_timeout,
+        max_timeout,
+        dbname.string().c_str());
+    auto state_override = monad_state_override_create();
+
+    monad_eth_call_pool_metrics low;
+    monad_eth_call_pool_metrics high;
+    monad_eth_call_executor_get_pool_metrics(executor, &low, &high);
+    EXPECT_EQ(low.queued, 0);
+    EXPECT_EQ(low.executed, 0);
+    EXPECT_EQ(low.shed, 0);
+    EXPECT_EQ(high.executed, 0);
+
+    struct callback_context ctx;
+    auto f = ctx.promise.get_future();
+    monad_eth_call_executor_submit(
+        executor,
+        CHAIN_CONFIG_MONAD_DEVNET,
+        rlp_tx.data(),
+        rlp_tx.size(),
+        rlp_header.data(),
+        rlp_header.size(),
+        rlp_sender.data(),
+        rlp_sender.size(),
+        header.number,
+        rlp_block_id.data(),
+        rlp_block_id.size(),
+        state_override,
+        complete_callback,
+        (void *)&ctx,
+        NOOP_TRACER,
+        true);
+    f.get();
+    EXPECT_EQ(ctx.result->status_code, EVMC_SUCCESS);
+
+    // a call within the low gas limit only ever runs on the low pool. Its
+    // fiber is released just after it completes.
+    do {
+        std::this_thread::yield();
+        monad_eth_call_executor_get_pool_metrics(executor, &low, &high);
+    }
+    while (low.running != 0);
+    EXPECT_EQ(low.queued, 0);
+    EXPECT_EQ(low.executed, 1);
+    EXPECT_EQ(low.shed, 0);
+    EXPECT_EQ(low.expected_queue_wait_us, 0);
+    EXPECT_EQ(high.executed, 0);
+
+    monad_state_override_destroy(state_override);
+    monad_eth_call_executor_destroy(executor);
+}
+
+TEST_F(EthCallFixture, calls_at_pinned_historical_block)
+{
+    for (uint64_t i = 0; i < 600; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    Transaction tx{
+        .gas_limit = 100000u, .to = to, .type = TransactionType::eip1559};
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto executor = monad_eth_call_executor_create(
+        1,
+        1,
+        node_lru_max_mem,
+        max_timeout,
+        max_timeout,
+        dbname.string().c_str());
+    auto state_override = monad_state_override_create();
+
+    auto const call = [&](uint64_t const block_number,
+                          monad_tracer_config const tracer_config) {
+        BlockHeader const header{.number = block_number};
+        auto const rlp_header = to_vec(rlp::encode_block_header(header));
+        struct callback_context ctx;
+        auto f = ctx.promise.get_future();
+        monad_eth_call_executor_submit(
+            executor,
+            CHAIN_CONFIG_MONAD_DEVNET,
+            rlp_tx.data(),
+            rlp_tx.size(),
+            rlp_header.data(),
+            rlp_header.size(),
+            rlp_sender.data(),
+            rlp_sender.size(),
+            block_number,
+            rlp_block_id.data(),
+            rlp_block_id.size(),
+            state_override,
+            complete_callback,
+            (void *)&ctx,
+            tracer_config,
+            true);
+        f.get();
+        EXPECT_EQ(ctx.result->status_code, EVMC_SUCCESS);
+        return ctx.result->gas_used;
+    };
+
+    // block 300 is far enough behind the latest to read through the
+    // historical node cache; the second call at each block runs on the
+    // pinned resolution of the first
+    for (uint64_t const block_number : {uint64_t{300}, uint64_t{599}}) {
+        auto const gas_used = call(block_number, NOOP_TRACER);
+        EXPECT_EQ(call(block_number, CALL_TRACER), gas_used);
+    }
+
+    monad_state_override_destroy(state_override);
+    monad_eth_call_executor_destroy(executor);
+}
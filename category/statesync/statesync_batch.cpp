@@ -0,0 +1,189 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/config.hpp>
+#include <category/core/unaligned.hpp>
+#include <category/statesync/statesync_batch.hpp>
+#include <category/statesync/statesync_messages.h>
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+constexpr int UPSERT_BATCH_ZSTD_LEVEL = 1;
+
+bool is_upsert(unsigned char const type)
+{
+    return type >= SYNC_TYPE_UPSERT_CODE && type <= SYNC_TYPE_UPSERT_HEADER;
+}
+
+void append_varint(monad::byte_string &out, uint64_t n)
+{
+    while (n >= 0x80) {
+        out.push_back(static_cast<unsigned char>(n | 0x80));
+        n >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(n));
+}
+
+std::optional<uint64_t> read_varint(monad::byte_string_view &in)
+{
+    uint64_t n = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (in.empty()) {
+            return std::nullopt;
+        }
+        auto const byte = in.front();
+        in.remove_prefix(1);
+        n |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return n;
+        }
+    }
+    return std::nullopt;
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+UpsertBatchWriter::UpsertBatchWriter(bool const compress)
+    : cctx_{compress ? ZSTD_createCCtx() : nullptr, &ZSTD_freeCCtx}
+{
+}
+
+void UpsertBatchWriter::add(
+    monad_sync_type const type, byte_string_view const v1,
+    byte_string_view const v2)
+{
+    MONAD_ASSERT(is_upsert(type));
+    current_.assign(v1);
+    current_.append(v2);
+    auto &previous = previous_[type];
+    auto const shared = static_cast<size_t>(
+        std::ranges::mismatch(previous, current_).in2 - current_.begin());
+    body_.push_back(type);
+    append_varint(body_, shared);
+    append_varint(body_, current_.size() - shared);
+    body_.append(current_, shared);
+    previous.swap(current_);
+    ++count_;
+}
+
+byte_string UpsertBatchWriter::finish()
+{
+    byte_string out;
+    if (cctx_ && !body_.empty()) {
+        constexpr size_t HEADER_SIZE = 1 + sizeof(uint64_t);
+        out.resize(HEADER_SIZE + ZSTD_compressBound(body_.size()));
+        auto const rc = ZSTD_compressCCtx(
+            cctx_.get(),
+            out.data() + HEADER_SIZE,
+            out.size() - HEADER_SIZE,
+            body_.data(),
+            body_.size(),
+            UPSERT_BATCH_ZSTD_LEVEL);
+        if (!ZSTD_isError(rc) && HEADER_SIZE + rc < 1 + body_.size()) {
+            uint64_t const raw_size = body_.size();
+            out[0] = UPSERT_BATCH_ZSTD;
+            std::memcpy(&out[1], &raw_size, sizeof(raw_size));
+            out.resize(HEADER_SIZE + rc);
+        }
+        else {
+            out.clear();
+        }
+    }
+    if (out.empty()) {
+        out.push_back(UPSERT_BATCH_RAW);
+        out.append(body_);
+    }
+    body_.clear();
+    for (auto &previous : previous_) {
+        previous.clear();
+    }
+    count_ = 0;
+    return out;
+}
+
+bool for_each_batched_upsert(
+    byte_string_view payload,
+    std::function<bool(monad_sync_type, byte_string_view)> const &fn)
+{
+    if (payload.empty()) {
+        return false;
+    }
+    auto const encoding = payload.front();
+    payload.remove_prefix(1);
+
+    byte_string decompressed;
+    byte_string_view body;
+    if (encoding == UPSERT_BATCH_ZSTD) {
+        if (payload.size() < sizeof(uint64_t)) {
+            return false;
+        }
+        auto const raw_size = unaligned_load<uint64_t>(payload.data());
+        payload.remove_prefix(sizeof(uint64_t));
+        if (raw_size > MAX_UPSERT_BATCH_BYTES) {
+            return false;
+        }
+        decompressed.resize(raw_size);
+        auto const rc = ZSTD_decompress(
+            decompressed.data(), raw_size, payload.data(), payload.size());
+        if (ZSTD_isError(rc) || rc != raw_size) {
+            return false;
+        }
+        body = decompressed;
+    }
+    else if (encoding == UPSERT_BATCH_RAW) {
+        body = payload;
+    }
+    else {
+        return false;
+    }
+
+    std::array<byte_string, NUM_UPSERT_TYPES> previous;
+    byte_string current;
+    while (!body.empty()) {
+        auto const type = body.front();
+        body.remove_prefix(1);
+        if (!is_upsert(type)) {
+            return false;
+        }
+        auto const shared = read_varint(body);
+        auto const size = shared.has_value() ? read_varint(body) : shared;
+        if (!size.has_value() || shared.value() > previous[type].size() ||
+            size.value() > body.size()) {
+            return false;
+        }
+        current.assign(previous[type], 0, shared.value());
+        current.append(body.substr(0, size.value()));
+        body.remove_prefix(size.value());
+        if (!fn(static_cast<monad_sync_type>(type), current)) {
+            return false;
+        }
+        previous[type].swap(current);
+    }
+    return true;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/core/config.hpp>
+#include <category/statesync/statesync_messages.h>
+
+#include <zstd.h>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+MONAD_NAMESPACE_BEGIN
+
+// Payload of a SYNC_TYPE_UPSERT_BATCH message, sent from protocol version 2:
+//
+//   u8 encoding      UPSERT_BATCH_RAW or UPSERT_BATCH_ZSTD
+//   u64 raw size     only when zstd
+//   body             raw, or a single zstd frame of it
+//
+// The body is a run of upserts, each
+//
+//   u8 type          one of the SYNC_TYPE_UPSERT_* types
+//   varint shared    leading bytes shared with the previous upsert of the
+//                    same type in this batch
+//   varint size      size of the rest
+//   bytes            the rest of the upsert
+//
+// Consecutive storage upserts of one account share its address, so the
+// prefix compression alone removes most of their size.
+inline constexpr unsigned char UPSERT_BATCH_RAW = 0;
+inline constexpr unsigned char UPSERT_BATCH_ZSTD = 1;
+// bound on the decompressed body a client accepts
+inline constexpr size_t MAX_UPSERT_BATCH_BYTES = 64ul << 20;
+inline constexpr size_t NUM_UPSERT_TYPES = SYNC_TYPE_UPSERT_HEADER + 1;
+
+class UpsertBatchWriter
+{
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+    byte_string body_{};
+    std::array<byte_string, NUM_UPSERT_TYPES> previous_{};
+    byte_string current_{};
+    size_t count_{0};
+
+public:
+    // `compress` enables zstd for batches it actually shrinks
+    explicit UpsertBatchWriter(bool compress);
+
+    void add(monad_sync_type, byte_string_view v1, byte_string_view v2);
+
+    bool empty() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    // raw body size of the batch being built
+    size_t size() const noexcept
+    {
+        return body_.size();
+    }
+
+    // Returns the payload of the batch and starts the next one
+    byte_string finish();
+};
+
+// Calls `fn` with each upsert of a batch payload in order, stopping at the
+// first false. Returns false if the payload is malformed or `fn` failed.
+bool for_each_batched_upsert(
+    byte_string_view payload,
+    std::function<bool(monad_sync_type, byte_string_view)> const &fn);
+
+MONAD_NAMESPACE_END
@@ -92,6 +92,9 @@ void monad_statesync_client_handle_new_peer(
     case 1:
         ptr = std::make_unique<StatesyncProtocolV1>();
         break;
+    case 2:
+        ptr = std::make_unique<StatesyncProtocolV2>();
+        break;
     default:
         MONAD_ASSERT(false);
     };
@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/keccak.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
 #include <category/execution/ethereum/db/util.hpp>
@@ -22,12 +23,30 @@
 #include <category/statesync/statesync_client_context.hpp>
 #include <category/statesync/statesync_protocol.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <deque>
 #include <sys/sysinfo.h>
 
 using namespace monad;
 using namespace monad::mpt;
 
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+// The update subtree of one account. The updates point into the keys and
+// values held here, so it must stay in place until the upsert is done.
+struct PreparedAccount
+{
+    hash256 key{};
+    std::optional<byte_string> value{};
+    std::vector<hash256> storage_keys{};
+    std::vector<std::optional<byte_string>> storage_values{};
+    std::vector<Update> storage_updates{};
+    std::optional<Update> update{};
+};
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
 monad_statesync_client_context::monad_statesync_client_context(
     std::vector<std::filesystem::path> const dbname_paths,
     std::optional<unsigned> const sq_thread_cpu,
@@ -60,45 +79,100 @@ monad_statesync_client_context::monad_statesync_client_context(
 
 void monad_statesync_client_context::commit()
 {
-    std::deque<mpt::Update> alloc;
-    std::deque<byte_string> bytes_alloc;
-    std::deque<hash256> hash_alloc;
-    UpdateList accounts;
-    for (auto const &[addr, delta] : deltas) {
-        UpdateList storage;
-        std::optional<byte_string_view> value;
+    using Delta = decltype(deltas)::value_type;
+
+    auto const version = static_cast<int64_t>(current);
+
+    // Grouping the upserts into accounts reads the committed trie, so it
+    // stays on the receiving thread. Hashing and encoding each account's
+    // update subtree, and hashing the code, is independent per item and runs
+    // on the commit arena, leaving only the linking and the upsert serial.
+    std::vector<Delta const *> items;
+    items.reserve(deltas.size());
+    for (auto const &kv : deltas) {
+        items.push_back(&kv);
+    }
+    std::vector<PreparedAccount> prepared(items.size());
+    auto const prepare = [&items, &prepared, version](size_t const i) {
+        auto const &[addr, delta] = *items[i];
+        auto &out = prepared[i];
         if (delta.has_value()) {
-            auto const &[acct, deltas] = delta.value();
-            value = bytes_alloc.emplace_back(encode_account_db(addr, acct));
-            for (auto const &[key, val] : deltas) {
-                storage.push_front(alloc.emplace_back(Update{
-                    .key = hash_alloc.emplace_back(keccak256(key.bytes)),
-                    .value = val == bytes32_t{}
-                                 ? std::nullopt
-                                 : std::make_optional<byte_string_view>(
-                                       bytes_alloc.emplace_back(
-                                           encode_storage_db(key, val))),
-                    .incarnation = false,
-                    .next = UpdateList{},
-                    .version = static_cast<int64_t>(current)}));
+            auto const &[acct, storage] = delta.value();
+            std::vector<byte_string_view> keys;
+            keys.reserve(storage.size());
+            out.storage_values.reserve(storage.size());
+            for (auto const &[key, val] : storage) {
+                keys.emplace_back(key.bytes, sizeof(key.bytes));
+                out.storage_values.emplace_back(
+                    val == bytes32_t{}
+                        ? std::nullopt
+                        : std::make_optional(encode_storage_db(key, val)));
             }
+            out.storage_keys.resize(keys.size());
+            keccak256(keys, out.storage_keys);
+            out.value = encode_account_db(addr, acct);
+        }
+        auto const view = [](byte_string const &v) {
+            return byte_string_view{v};
+        };
+        UpdateList storage_updates;
+        out.storage_updates.reserve(out.storage_values.size());
+        for (size_t j = 0; j < out.storage_values.size(); ++j) {
+            storage_updates.push_front(out.storage_updates.emplace_back(Update{
+                .key = out.storage_keys[j],
+                .value = out.storage_values[j].transform(view),
+                .incarnation = false,
+                .next = UpdateList{},
+                .version = version}));
         }
-        accounts.push_front(alloc.emplace_back(Update{
-            .key = hash_alloc.emplace_back(keccak256(addr.bytes)),
-            .value = value,
+        out.key = keccak256({addr.bytes, sizeof(addr.bytes)});
+        out.update.emplace(Update{
+            .key = out.key,
+            .value = out.value.transform(view),
             .incarnation = false,
-            .next = std::move(storage),
-            .version = static_cast<int64_t>(current)}));
+            .next = std::move(storage_updates),
+            .version = version});
+    };
+    std::vector<bytes32_t> code_hashes(code.size());
+    auto const hash_code = [this, &code_hashes](size_t const i) {
+        code_hashes[i] = to_bytes(keccak256(code[i]));
+    };
+    if (items.size() + code.size() > 1) {
+        commit_arena.execute([&] {
+            tbb::parallel_for(size_t{0}, items.size(), prepare);
+            tbb::parallel_for(size_t{0}, code.size(), hash_code);
+        });
+    }
+    else {
+        for (size_t i = 0; i < items.size(); ++i) {
+            prepare(i);
+        }
+        for (size_t i = 0; i < code.size(); ++i) {
+            hash_code(i);
+        }
     }
-    UpdateList code_updates;
 
-    for (auto const &[hash, bytes] : code) {
-        code_updates.push_front(alloc.emplace_back(Update{
+    UpdateList accounts;
+    for (auto &account : prepared) {
+        accounts.push_front(account.update.value());
+    }
+
+    // code is immutable once inserted, so a repeat of the same code is
+    // dropped rather than upserted twice
+    std::deque<Update> code_alloc;
+    ankerl::unordered_dense::set<bytes32_t> code_seen;
+    UpdateList code_updates;
+    for (size_t i = 0; i < code.size(); ++i) {
+        auto const &hash = code_hashes[i];
+        if (!code_seen.emplace(hash).second) {
+            continue;
+        }
+        code_updates.push_front(code_alloc.emplace_back(Update{
             .key = NibblesView{hash},
-            .value = bytes,
+            .value = code[i],
             .incarnation = false,
             .next = UpdateList{},
-            .version = static_cast<int64_t>(current)}));
+            .version = version}));
     }
 
     auto state_update = Update{
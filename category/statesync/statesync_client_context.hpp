@@ -26,6 +26,8 @@
 
 #include <ankerl/unordered_dense.h>
 
+#include <tbb/task_arena.h>
+
 #include <array>
 #include <filesystem>
 #include <memory>
@@ -55,9 +57,11 @@ struct monad_statesync_client_context
     uint64_t current;
     Map<monad::Address, StorageDeltas> buffered;
     ankerl::unordered_dense::segmented_set<monad::bytes32_t> seen_code;
-    Map<monad::bytes32_t, monad::byte_string> code;
+    // code received since the last commit, possibly repeated
+    std::vector<monad::byte_string> code;
     Map<monad::Address, std::optional<StateDelta>> deltas;
     uint64_t n_upserts;
+    tbb::task_arena commit_arena;
     monad_statesync_client *sync;
     void (*statesync_send_request)(
         struct monad_statesync_client *, struct monad_sync_request);
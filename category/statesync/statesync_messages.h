@@ -36,6 +36,8 @@ enum monad_sync_type : uint8_t
     SYNC_TYPE_UPSERT_ACCOUNT_DELETE = 6,
     SYNC_TYPE_UPSERT_STORAGE_DELETE = 7,
     SYNC_TYPE_UPSERT_HEADER = 8,
+    // many upserts in one message, see statesync_batch.hpp
+    SYNC_TYPE_UPSERT_BATCH = 9,
 };
 
 static_assert(sizeof(enum monad_sync_type) == 1);
@@ -45,6 +47,8 @@ struct monad_sync_request
 {
     uint64_t prefix;
     uint8_t prefix_bytes;
+    // protocol version of the requesting client, 0 before version 2
+    uint8_t version;
     uint64_t target;
     uint64_t from;
     uint64_t until;
@@ -20,6 +20,7 @@
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
 #include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
 #include <category/execution/ethereum/db/util.hpp>
+#include <category/statesync/statesync_batch.hpp>
 #include <category/statesync/statesync_client.h>
 #include <category/statesync/statesync_client_context.hpp>
 #include <category/statesync/statesync_protocol.hpp>
@@ -157,6 +158,25 @@ void storage_update(
     }
 }
 
+monad_sync_request make_request(
+    monad_statesync_client_context const &ctx, uint64_t const prefix,
+    uint8_t const version)
+{
+    auto const tgrt = ctx.tgrt.number;
+    auto const &[progress, old_target] = ctx.progress[prefix];
+    MONAD_ASSERT(progress == INVALID_BLOCK_NUM || progress < tgrt);
+    MONAD_ASSERT(old_target == INVALID_BLOCK_NUM || old_target <= tgrt);
+    auto const from = progress == INVALID_BLOCK_NUM ? 0 : progress + 1;
+    return monad_sync_request{
+        .prefix = prefix,
+        .prefix_bytes = monad_statesync_client_prefix_bytes(),
+        .version = version,
+        .target = tgrt,
+        .from = from,
+        .until = from >= (tgrt * 99 / 100) ? tgrt : tgrt * 99 / 100,
+        .old_target = old_target};
+}
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
@@ -164,20 +184,7 @@ MONAD_NAMESPACE_BEGIN
 void StatesyncProtocolV1::send_request(
     monad_statesync_client_context *const ctx, uint64_t const prefix) const
 {
-    auto const tgrt = ctx->tgrt.number;
-    auto const &[progress, old_target] = ctx->progress[prefix];
-    MONAD_ASSERT(progress == INVALID_BLOCK_NUM || progress < tgrt);
-    MONAD_ASSERT(old_target == INVALID_BLOCK_NUM || old_target <= tgrt);
-    auto const from = progress == INVALID_BLOCK_NUM ? 0 : progress + 1;
-    ctx->statesync_send_request(
-        ctx->sync,
-        monad_sync_request{
-            .prefix = prefix,
-            .prefix_bytes = monad_statesync_client_prefix_bytes(),
-            .target = tgrt,
-            .from = from,
-            .until = from >= (tgrt * 99 / 100) ? tgrt : tgrt * 99 / 100,
-            .old_target = old_target});
+    ctx->statesync_send_request(ctx->sync, make_request(*ctx, prefix, 0));
 }
 
 bool StatesyncProtocolV1::handle_upsert(
@@ -186,8 +193,9 @@ bool StatesyncProtocolV1::handle_upsert(
 {
     byte_string_view raw{val, size};
     if (type == SYNC_TYPE_UPSERT_CODE) {
-        // code is immutable once inserted - no deletions
-        ctx->code.emplace(std::bit_cast<bytes32_t>(keccak256(raw)), raw);
+        // code is immutable once inserted - no deletions. It is hashed on
+        // commit, off the receiving thread
+        ctx->code.emplace_back(raw);
     }
     else if (type == SYNC_TYPE_UPSERT_ACCOUNT) {
         auto const res = decode_account_db(raw);
@@ -243,4 +251,26 @@ bool StatesyncProtocolV1::handle_upsert(
     return true;
 }
 
+void StatesyncProtocolV2::send_request(
+    monad_statesync_client_context *const ctx, uint64_t const prefix) const
+{
+    ctx->statesync_send_request(ctx->sync, make_request(*ctx, prefix, 2));
+}
+
+bool StatesyncProtocolV2::handle_upsert(
+    monad_statesync_client_context *const ctx, monad_sync_type const type,
+    unsigned char const *const val, uint64_t const size) const
+{
+    if (type != SYNC_TYPE_UPSERT_BATCH) {
+        return StatesyncProtocolV1::handle_upsert(ctx, type, val, size);
+    }
+    return for_each_batched_upsert(
+        byte_string_view{val, size},
+        [this, ctx](
+            monad_sync_type const inner_type, byte_string_view const raw) {
+            return StatesyncProtocolV1::handle_upsert(
+                ctx, inner_type, raw.data(), raw.size());
+        });
+}
+
 MONAD_NAMESPACE_END
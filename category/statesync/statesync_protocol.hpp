@@ -44,4 +44,15 @@ struct StatesyncProtocolV1 : StatesyncProtocol
         unsigned char const *, uint64_t) const override;
 };
 
+// Asks the server to batch and compress its upserts
+struct StatesyncProtocolV2 : StatesyncProtocolV1
+{
+    virtual void send_request(
+        monad_statesync_client_context *, uint64_t prefix) const override;
+
+    virtual bool handle_upsert(
+        monad_statesync_client_context *, monad_sync_type,
+        unsigned char const *, uint64_t) const override;
+};
+
 MONAD_NAMESPACE_END
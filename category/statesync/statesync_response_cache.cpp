@@ -0,0 +1,114 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/config.hpp>
+#include <category/statesync/statesync_response_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+MONAD_NAMESPACE_BEGIN
+
+StatesyncResponseCache::StatesyncResponseCache(size_t const max_bytes)
+    : max_bytes_{max_bytes}
+{
+}
+
+void StatesyncResponseCache::erase(Map::iterator const it)
+{
+    used_bytes_ -= it->second.stream->size();
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+    ++stats_.evictions;
+}
+
+std::shared_ptr<byte_string const>
+StatesyncResponseCache::find(Key const &key)
+{
+    std::lock_guard const g(mutex_);
+    auto const it = entries_.find(key);
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.stream;
+}
+
+void StatesyncResponseCache::insert(Key const &key, byte_string stream)
+{
+    if (stream.size() > max_entry_bytes()) {
+        return;
+    }
+    std::lock_guard const g(mutex_);
+    // another worker may have served the same request meanwhile
+    if (auto const it = entries_.find(key); it != entries_.end()) {
+        erase(it);
+    }
+    while (!lru_.empty() && used_bytes_ + stream.size() > max_bytes_) {
+        erase(entries_.find(lru_.back()));
+    }
+    used_bytes_ += stream.size();
+    lru_.push_front(key);
+    entries_.emplace(
+        key,
+        Entry{
+            .stream = std::make_shared<byte_string const>(std::move(stream)),
+            .lru = lru_.begin()});
+}
+
+void StatesyncResponseCache::evict_before(uint64_t const earliest)
+{
+    std::lock_guard const g(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto const next = std::next(it);
+        if (it->first.target < earliest) {
+            erase(it);
+        }
+        it = next;
+    }
+}
+
+void StatesyncResponseCache::evict_from(uint64_t const target)
+{
+    std::lock_guard const g(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto const next = std::next(it);
+        if (it->first.target >= target) {
+            erase(it);
+        }
+        it = next;
+    }
+}
+
+size_t StatesyncResponseCache::used_bytes() const
+{
+    std::lock_guard const g(mutex_);
+    return used_bytes_;
+}
+
+StatesyncResponseCache::Stats StatesyncResponseCache::stats() const
+{
+    std::lock_guard const g(mutex_);
+    return stats_;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,103 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/core/config.hpp>
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Bounded cache of the upserts the server traversed for a request, so that
+/// peers syncing the same target from one server have each prefix range
+/// traversed once. A stream is encoded as the server's workers buffer it:
+/// the type, then each of the two values prefixed by its 8 byte size.
+///
+/// Entries are evicted least recently used first, once their target falls
+/// out of the db's history, or when their target is finalized again.
+class StatesyncResponseCache
+{
+public:
+    struct Key
+    {
+        uint64_t prefix;
+        uint8_t prefix_bytes;
+        uint64_t from;
+        uint64_t until;
+        uint64_t target;
+
+        friend auto operator<=>(Key const &, Key const &) = default;
+    };
+
+    struct Stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+    };
+
+    static constexpr size_t DEFAULT_MAX_BYTES = 256ul << 20;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<byte_string const> stream;
+        std::list<Key>::iterator lru;
+    };
+
+    using Map = std::map<Key, Entry>;
+
+    mutable std::mutex mutex_;
+    Map entries_;
+    // most recently used first
+    std::list<Key> lru_;
+    size_t const max_bytes_;
+    size_t used_bytes_{0};
+    Stats stats_{};
+
+    void erase(Map::iterator);
+
+public:
+    explicit StatesyncResponseCache(size_t max_bytes = DEFAULT_MAX_BYTES);
+
+    std::shared_ptr<byte_string const> find(Key const &);
+
+    /// Streams larger than `max_entry_bytes()` are not kept
+    void insert(Key const &, byte_string stream);
+
+    /// Evicts the entries of targets before `earliest`
+    void evict_before(uint64_t earliest);
+
+    /// Evicts the entries of `target` and later
+    void evict_from(uint64_t target);
+
+    size_t max_entry_bytes() const noexcept
+    {
+        return max_bytes_ / 8;
+    }
+
+    size_t used_bytes() const;
+    Stats stats() const;
+};
+
+MONAD_NAMESPACE_END
@@ -23,6 +23,8 @@
 #include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/mpt/traverse.hpp>
+#include <category/statesync/statesync_batch.hpp>
+#include <category/statesync/statesync_response_cache.hpp>
 #include <category/statesync/statesync_server.h>
 #include <category/statesync/statesync_server_context.hpp>
 
@@ -30,17 +32,26 @@
 #include <quill/bundled/fmt/format.h>
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fcntl.h>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <stop_token>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
 #include <thread>
 #include <unistd.h>
+#include <utility>
+#include <vector>
 
 struct monad_statesync_server
 {
+    struct Workers;
+
     monad_statesync_server_context *context;
     monad_statesync_server_network *net;
     ssize_t (*statesync_server_recv)(
@@ -51,6 +62,7 @@ struct monad_statesync_server
         uint64_t size2);
     void (*statesync_server_send_done)(
         monad_statesync_server_network *, monad_sync_done);
+    std::unique_ptr<Workers> workers{};
 };
 
 using namespace monad;
@@ -58,6 +70,54 @@ using namespace monad::mpt;
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
+using UpsertSink = std::function<void(
+    monad_sync_type, unsigned char const *v1, uint64_t size1,
+    unsigned char const *v2, uint64_t size2)>;
+
+void append_value(
+    byte_string &out, unsigned char const *const v, uint64_t const size)
+{
+    out.append(reinterpret_cast<unsigned char const *>(&size), sizeof(size));
+    if (v != nullptr) {
+        out.append(v, size);
+    }
+}
+
+// Upserts are buffered as their type, then each of the two values prefixed
+// by its 8 byte size
+void append_upsert(
+    byte_string &out, monad_sync_type const type,
+    unsigned char const *const v1, uint64_t const size1,
+    unsigned char const *const v2, uint64_t const size2)
+{
+    out.push_back(static_cast<unsigned char>(type));
+    append_value(out, v1, size1);
+    append_value(out, v2, size2);
+}
+
+void replay(UpsertSink const &send_upsert, byte_string_view buffered)
+{
+    auto const take_value = [&buffered] {
+        uint64_t const size = unaligned_load<uint64_t>(buffered.data());
+        buffered.remove_prefix(sizeof(size));
+        auto const v = buffered.substr(0, size);
+        buffered.remove_prefix(size);
+        return v;
+    };
+    while (!buffered.empty()) {
+        auto const type = static_cast<monad_sync_type>(buffered.front());
+        buffered.remove_prefix(1);
+        auto const v1 = take_value();
+        auto const v2 = take_value();
+        send_upsert(
+            type,
+            v1.empty() ? nullptr : v1.data(),
+            v1.size(),
+            v2.empty() ? nullptr : v2.data(),
+            v2.size());
+    }
+}
+
 byte_string from_prefix(uint64_t const prefix, size_t const n_bytes)
 {
     byte_string bytes;
@@ -68,7 +128,7 @@ byte_string from_prefix(uint64_t const prefix, size_t const n_bytes)
 }
 
 bool send_deletion(
-    monad_statesync_server *const sync, monad_sync_request const &rq,
+    UpsertSink const &send_upsert, monad_sync_request const &rq,
     monad_statesync_server_context &ctx)
 {
     MONAD_ASSERT(
@@ -78,17 +138,10 @@ bool send_deletion(
         return true;
     }
 
-    auto const fn = [sync, prefix = from_prefix(rq.prefix, rq.prefix_bytes)](
-                        Deletion const &deletion) {
+    auto const fn = [&send_upsert](Deletion const &deletion) {
         auto const &[addr, key] = deletion;
-        auto const hash = keccak256(addr.bytes);
-        byte_string_view const view{hash.bytes, sizeof(hash.bytes)};
-        if (!view.starts_with(prefix)) {
-            return;
-        }
         if (!key.has_value()) {
-            sync->statesync_server_send_upsert(
-                sync->net,
+            send_upsert(
                 SYNC_TYPE_UPSERT_ACCOUNT_DELETE,
                 reinterpret_cast<unsigned char const *>(&addr),
                 sizeof(addr),
@@ -97,8 +150,7 @@ bool send_deletion(
         }
         else {
             auto const skey = rlp::encode_bytes32_compact(key.value());
-            sync->statesync_server_send_upsert(
-                sync->net,
+            send_upsert(
                 SYNC_TYPE_UPSERT_STORAGE_DELETE,
                 reinterpret_cast<unsigned char const *>(&addr),
                 sizeof(addr),
@@ -107,33 +159,38 @@ bool send_deletion(
         }
     };
 
+    auto const prefix = from_prefix(rq.prefix, rq.prefix_bytes);
     for (uint64_t i = rq.old_target + 1; i <= rq.target; ++i) {
-        if (!ctx.deletions.for_each(i, fn)) {
+        if (!ctx.deletions.for_each(i, prefix, fn)) {
             return false;
         }
     }
     return true;
 }
 
-bool statesync_server_handle_request(
-    monad_statesync_server *const sync, monad_sync_request const rq)
+// raw bytes of upserts collected before a batch is sent
+constexpr size_t UPSERT_BATCH_FLUSH_BYTES = 128ul << 10;
+
+bool serve_request(
+    Db &db, monad_statesync_server_context &ctx,
+    UpsertSink const &send_upsert_fn, monad_sync_request const rq)
 {
     struct Traverse final : public TraverseMachine
     {
         unsigned char nibble;
         unsigned depth;
         Address addr;
-        monad_statesync_server *sync;
+        UpsertSink const *send_upsert_fn;
         NibblesView prefix;
         uint64_t from;
         uint64_t until;
 
         Traverse(
-            monad_statesync_server *const sync, NibblesView const prefix,
+            UpsertSink const &send_upsert_fn, NibblesView const prefix,
             uint64_t const from, uint64_t const until)
             : nibble{INVALID_BRANCH}
             , depth{0}
-            , sync{sync}
+            , send_upsert_fn{&send_upsert_fn}
             , prefix{prefix}
             , from{from}
             , until{until}
@@ -188,8 +245,7 @@ bool statesync_server_handle_request(
                                              unsigned char const *const v1 =
                                                  nullptr,
                                              uint64_t const size1 = 0) {
-                    sync->statesync_server_send_upsert(
-                        sync->net,
+                    (*send_upsert_fn)(
                         type,
                         v1,
                         size1,
@@ -253,8 +309,6 @@ bool statesync_server_handle_request(
     };
 
     [[maybe_unused]] auto const start = std::chrono::steady_clock::now();
-    auto *const ctx = sync->context;
-    auto &db = *ctx->ro;
     if (rq.prefix < 256 && rq.target > rq.prefix) {
         auto const version = rq.target - rq.prefix - 1;
         auto const root = db.load_root_for_version(version);
@@ -268,8 +322,7 @@ bool statesync_server_handle_request(
         }
         auto const &val = res.value().node->value();
         MONAD_ASSERT(!val.empty());
-        sync->statesync_server_send_upsert(
-            sync->net,
+        send_upsert_fn(
             SYNC_TYPE_UPSERT_HEADER,
             val.data(),
             val.size(),
@@ -277,7 +330,7 @@ bool statesync_server_handle_request(
             0);
     }
 
-    if (!send_deletion(sync, rq, *ctx)) {
+    if (!send_deletion(send_upsert_fn, rq, ctx)) {
         return false;
     }
 
@@ -296,33 +349,103 @@ bool statesync_server_handle_request(
         return false;
     }
 
+    // peers syncing the same target ask for the same ranges, which are
+    // traversed once and replayed after
+    ctx.responses.evict_before(db.get_earliest_version());
+    StatesyncResponseCache::Key const key{
+        .prefix = rq.prefix,
+        .prefix_bytes = rq.prefix_bytes,
+        .from = rq.from,
+        .until = rq.until,
+        .target = rq.target};
     [[maybe_unused]] auto const begin = std::chrono::steady_clock::now();
-    Traverse traverse(sync, NibblesView{bytes}, rq.from, rq.until);
-    if (!db.traverse(finalized_root, traverse, rq.target)) {
-        return false;
+    auto const cached = ctx.responses.find(key);
+    if (cached != nullptr) {
+        replay(send_upsert_fn, *cached);
+    }
+    else {
+        byte_string stream;
+        bool keep = true;
+        UpsertSink const send_and_keep = [&](monad_sync_type const type,
+                                             unsigned char const *const v1,
+                                             uint64_t const size1,
+                                             unsigned char const *const v2,
+                                             uint64_t const size2) {
+            send_upsert_fn(type, v1, size1, v2, size2);
+            if (!keep) {
+                return;
+            }
+            append_upsert(stream, type, v1, size1, v2, size2);
+            if (stream.size() > ctx.responses.max_entry_bytes()) {
+                keep = false;
+                stream = byte_string{};
+            }
+        };
+        Traverse traverse(send_and_keep, NibblesView{bytes}, rq.from, rq.until);
+        if (!db.traverse(finalized_root, traverse, rq.target)) {
+            return false;
+        }
+        if (keep) {
+            ctx.responses.insert(key, std::move(stream));
+        }
     }
     [[maybe_unused]] auto const end = std::chrono::steady_clock::now();
 
     LOG_INFO(
         "processed request prefix={} prefix_bytes={} target={} from={} "
         "until={} "
-        "old_target={} overall={} traverse={}",
+        "old_target={} cached={} overall={} traverse={}",
         rq.prefix,
         rq.prefix_bytes,
         rq.target,
         rq.from,
         rq.until,
         rq.old_target,
+        cached != nullptr,
         std::chrono::duration_cast<std::chrono::microseconds>(end - start),
         std::chrono::duration_cast<std::chrono::microseconds>(end - begin));
 
     return true;
 }
 
-void monad_statesync_server_handle_request(
-    monad_statesync_server *const sync, monad_sync_request const rq)
+bool statesync_server_handle_request(
+    Db &db, monad_statesync_server_context &ctx,
+    UpsertSink const &send_upsert_fn, monad_sync_request const rq)
+{
+    if (rq.version < 2) {
+        return serve_request(db, ctx, send_upsert_fn, rq);
+    }
+
+    // clients from version 2 get their upserts in compressed batches
+    UpsertBatchWriter batch{true};
+    auto const flush = [&batch, &send_upsert_fn] {
+        if (batch.empty()) {
+            return;
+        }
+        auto const payload = batch.finish();
+        send_upsert_fn(
+            SYNC_TYPE_UPSERT_BATCH, payload.data(), payload.size(), nullptr, 0);
+    };
+    UpsertSink const send_batched = [&batch, &flush](
+                                        monad_sync_type const type,
+                                        unsigned char const *const v1,
+                                        uint64_t const size1,
+                                        unsigned char const *const v2,
+                                        uint64_t const size2) {
+        batch.add(type, {v1, size1}, {v2, size2});
+        if (batch.size() >= UPSERT_BATCH_FLUSH_BYTES) {
+            flush();
+        }
+    };
+    bool const success = serve_request(db, ctx, send_batched, rq);
+    flush();
+    return success;
+}
+
+void send_done(
+    monad_statesync_server *const sync, monad_sync_request const &rq,
+    bool const success)
 {
-    auto const success = statesync_server_handle_request(sync, rq);
     if (!success) {
         LOG_INFO(
             "could not handle request prefix={} from={} until={} "
@@ -339,8 +462,177 @@ void monad_statesync_server_handle_request(
             .success = success, .prefix = rq.prefix, .n = rq.until});
 }
 
+void monad_statesync_server_handle_request(
+    monad_statesync_server *const sync, monad_sync_request const rq)
+{
+    UpsertSink const send_upsert = [sync](
+                                       monad_sync_type const type,
+                                       unsigned char const *const v1,
+                                       uint64_t const size1,
+                                       unsigned char const *const v2,
+                                       uint64_t const size2) {
+        sync->statesync_server_send_upsert(
+            sync->net, type, v1, size1, v2, size2);
+    };
+    auto const success = statesync_server_handle_request(
+        *sync->context->ro, *sync->context, send_upsert, rq);
+    send_done(sync, rq, success);
+}
+
+// The upserts of a request as a worker produced them, in the order the
+// network has to see them
+struct Response
+{
+    monad_sync_request rq;
+    std::mutex mutex{};
+    std::condition_variable_any cv{};
+    // type, then each of the two values prefixed by its 8 byte size
+    byte_string buffered{};
+    bool finished{false};
+    bool success{false};
+};
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
+// Requests are spread over worker threads by prefix, so those for different
+// prefixes traverse concurrently while those for one prefix keep their order.
+// Each worker reads through its own ring and Db over the shared storage pool.
+// The dispatcher forwards responses strictly in the order requests arrived,
+// which keeps every client's requests in order on the shared connection.
+struct monad_statesync_server::Workers
+{
+    // bound on what a request buffers ahead of the network
+    static constexpr size_t MAX_BUFFERED_BYTES = 64ul << 20;
+    // what a worker collects before handing it over
+    static constexpr size_t FLUSH_BYTES = 64ul << 10;
+
+    struct Worker
+    {
+        std::mutex mutex{};
+        std::condition_variable_any cv{};
+        std::deque<std::shared_ptr<Response>> queue{};
+        std::jthread thread{};
+    };
+
+    std::deque<std::shared_ptr<Response>> responses{};
+    std::vector<std::unique_ptr<Worker>> workers{};
+
+    Workers(monad_statesync_server_context &ctx, unsigned const num_workers)
+    {
+        MONAD_ASSERT(num_workers > 0);
+        MONAD_ASSERT(ctx.ro_io != nullptr);
+        for (unsigned i = 0; i < num_workers; ++i) {
+            auto &worker = *workers.emplace_back(std::make_unique<Worker>());
+            worker.thread = std::jthread([&ctx, &worker](
+                                             std::stop_token const token) {
+                pthread_setname_np(pthread_self(), "statesync worker");
+                AsyncIOContext io_ctx{*ctx.ro_io, ReadOnlyOnDiskDbConfig{}};
+                Db ro{io_ctx};
+                while (true) {
+                    std::shared_ptr<Response> response;
+                    {
+                        std::unique_lock lock{worker.mutex};
+                        if (!worker.cv.wait(lock, token, [&worker] {
+                                return !worker.queue.empty();
+                            })) {
+                            return;
+                        }
+                        response = std::move(worker.queue.front());
+                        worker.queue.pop_front();
+                    }
+                    run(ro, ctx, *response, token);
+                }
+            });
+        }
+    }
+
+    static void flush(
+        Response &response, byte_string &local, std::stop_token const &token)
+    {
+        std::unique_lock lock{response.mutex};
+        // a stopping server drops what the network will never see
+        if (!response.cv.wait(lock, token, [&response] {
+                return response.buffered.size() < MAX_BUFFERED_BYTES;
+            })) {
+            local.clear();
+            return;
+        }
+        response.buffered.append(local);
+        local.clear();
+    }
+
+    static void run(
+        Db &ro, monad_statesync_server_context &ctx, Response &response,
+        std::stop_token const &token)
+    {
+        byte_string local;
+        UpsertSink const send_upsert = [&](monad_sync_type const type,
+                                           unsigned char const *const v1,
+                                           uint64_t const size1,
+                                           unsigned char const *const v2,
+                                           uint64_t const size2) {
+            if (token.stop_requested()) {
+                return;
+            }
+            append_upsert(local, type, v1, size1, v2, size2);
+            if (local.size() >= FLUSH_BYTES) {
+                flush(response, local, token);
+            }
+        };
+        bool const success =
+            statesync_server_handle_request(ro, ctx, send_upsert, response.rq);
+        flush(response, local, token);
+        std::unique_lock const lock{response.mutex};
+        response.success = success;
+        response.finished = true;
+    }
+
+    void submit(monad_sync_request const &rq)
+    {
+        auto response = std::make_shared<Response>();
+        response->rq = rq;
+        responses.push_back(response);
+        auto &worker = *workers[rq.prefix % workers.size()];
+        {
+            std::unique_lock const lock{worker.mutex};
+            worker.queue.push_back(std::move(response));
+        }
+        worker.cv.notify_one();
+    }
+
+    // Forwards what is ready without waiting on the workers
+    void forward(monad_statesync_server *const sync)
+    {
+        while (!responses.empty()) {
+            auto &response = *responses.front();
+            byte_string buffered;
+            bool finished;
+            {
+                std::unique_lock const lock{response.mutex};
+                buffered.swap(response.buffered);
+                finished = response.finished;
+            }
+            response.cv.notify_all();
+            replay(
+                [sync](
+                    monad_sync_type const type,
+                    unsigned char const *const v1,
+                    uint64_t const size1,
+                    unsigned char const *const v2,
+                    uint64_t const size2) {
+                    sync->statesync_server_send_upsert(
+                        sync->net, type, v1, size1, v2, size2);
+                },
+                buffered);
+            if (!finished) {
+                return;
+            }
+            send_done(sync, response.rq, response.success);
+            responses.pop_front();
+        }
+    }
+};
+
 struct monad_statesync_server *monad_statesync_server_create(
     monad_statesync_server_context *const ctx,
     monad_statesync_server_network *const net,
@@ -363,6 +655,16 @@ struct monad_statesync_server *monad_statesync_server_create(
 
 void monad_statesync_server_run_once(struct monad_statesync_server *const sync)
 {
+    auto &ctx = *sync->context;
+    if (sync->workers == nullptr && ctx.num_workers > 0 &&
+        ctx.ro_io != nullptr) {
+        sync->workers = std::make_unique<monad_statesync_server::Workers>(
+            ctx, ctx.num_workers);
+    }
+    if (sync->workers != nullptr) {
+        sync->workers->forward(sync);
+    }
+
     unsigned char buf[sizeof(monad_sync_request)];
     if (sync->statesync_server_recv(sync->net, buf, 1) != 1) {
         return;
@@ -379,9 +681,19 @@ void monad_statesync_server_run_once(struct monad_statesync_server *const sync)
         n -= static_cast<size_t>(res);
     }
     auto const &rq = unaligned_load<monad_sync_request>(buf);
+    if (sync->workers != nullptr) {
+        sync->workers->submit(rq);
+        return;
+    }
     monad_statesync_server_handle_request(sync, rq);
 }
 
+void monad_statesync_server_stop_workers(
+    monad_statesync_server *const sync)
+{
+    sync->workers.reset();
+}
+
 void monad_statesync_server_destroy(monad_statesync_server *const sync)
 {
     delete sync;
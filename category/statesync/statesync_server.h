@@ -35,4 +35,9 @@ struct monad_statesync_server *monad_statesync_server_create(
 
 void monad_statesync_server_run_once(struct monad_statesync_server *);
 
+// Joins the worker threads serving requests in parallel, dropping what they
+// have not yet forwarded. Call on the thread running the server before the
+// context's ro_io goes away.
+void monad_statesync_server_stop_workers(struct monad_statesync_server *);
+
 void monad_statesync_server_destroy(struct monad_statesync_server *);
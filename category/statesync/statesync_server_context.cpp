@@ -17,6 +17,7 @@
 #include <category/core/basic_formatter.hpp>
 #include <category/core/byte_string.hpp>
 #include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
 #include <category/execution/ethereum/core/fmt/address_fmt.hpp>
 #include <category/execution/ethereum/core/fmt/bytes_fmt.hpp>
 #include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
@@ -28,7 +29,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <mutex>
+#include <optional>
+#include <span>
 
 using namespace monad;
 using namespace monad::mpt;
@@ -78,6 +82,9 @@ void on_finalize(
     monad_statesync_server_context &ctx, uint64_t const block_number,
     bytes32_t const &block_id)
 {
+    // a version finalized again invalidates what was traversed at it
+    ctx.responses.evict_from(block_number);
+
     auto &proposals = ctx.proposals;
 
     auto const it = std::find_if(
@@ -112,14 +119,29 @@ void FinalizedDeletions::set_entry(
     uint64_t const i, uint64_t const block_number,
     std::vector<Deletion> const &deletions)
 {
+    // hashed once here rather than by every prefix request that reads them
+    std::vector<byte_string_view> addresses;
+    addresses.reserve(deletions.size());
+    for (auto const &deletion : deletions) {
+        addresses.emplace_back(
+            deletion.address.bytes, sizeof(deletion.address.bytes));
+    }
+    std::vector<hash256> hashes(deletions.size());
+    keccak256(addresses, hashes);
+
     auto &entry = entries_[i];
     std::lock_guard const lock{entry.mutex};
     MONAD_ASSERT(entry.block_number == INVALID_BLOCK_NUM);
     entry.block_number = block_number;
     entry.idx = free_start_;
     entry.size = deletions.size();
-    for (auto const &deletion : deletions) {
-        deletions_[free_start_++ % MAX_DELETIONS] = deletion;
+    for (size_t j = 0; j < deletions.size(); ++j) {
+        auto const idx = free_start_++ % MAX_DELETIONS;
+        deletions_[idx] = deletions[j];
+        std::memcpy(
+            hash_prefixes_[idx].data(),
+            hashes[j].bytes,
+            DELETION_HASH_PREFIX_BYTES);
     }
     LOG_INFO(
         "deletions buffer write i={} "
@@ -169,6 +191,28 @@ bool FinalizedDeletions::for_each(
     return true;
 }
 
+bool FinalizedDeletions::for_each(
+    uint64_t const block_number, byte_string_view const hash_prefix,
+    std::function<void(Deletion const &)> const fn)
+{
+    MONAD_ASSERT(hash_prefix.size() <= DELETION_HASH_PREFIX_BYTES);
+    auto &entry = entries_[block_number % MAX_ENTRIES];
+    std::lock_guard const lock{entry.mutex};
+    if (entry.block_number != block_number) {
+        return false;
+    }
+    for (size_t i = 0; i < entry.size; ++i) {
+        auto const idx = (entry.idx + i) % MAX_DELETIONS;
+        if (std::memcmp(
+                hash_prefixes_[idx].data(),
+                hash_prefix.data(),
+                hash_prefix.size()) == 0) {
+            fn(deletions_[idx]);
+        }
+    }
+    return true;
+}
+
 void FinalizedDeletions::write(
     uint64_t const block_number, std::vector<Deletion> const &deletions)
 {
@@ -238,6 +282,11 @@ monad_statesync_server_context::read_code(bytes32_t const &hash)
     return rw.read_code(hash);
 }
 
+size_t monad_statesync_server_context::read_code_size(bytes32_t const &hash)
+{
+    return rw.read_code_size(hash);
+}
+
 monad::BlockHeader monad_statesync_server_context::read_eth_header()
 {
     return rw.read_eth_header();
@@ -263,6 +312,11 @@ std::optional<bytes32_t> monad_statesync_server_context::withdrawals_root()
     return rw.withdrawals_root();
 }
 
+DbStats monad_statesync_server_context::stats()
+{
+    return rw.stats();
+}
+
 void monad_statesync_server_context::set_block_and_prefix(
     uint64_t const block_number, bytes32_t const &block_id)
 {
@@ -276,6 +330,16 @@ void monad_statesync_server_context::finalize(
     rw.finalize(block_number, block_id);
 }
 
+void monad_statesync_server_context::finalize_batch(
+    std::span<BlockFinalization const> const blocks,
+    std::optional<uint64_t> const verified_block)
+{
+    for (auto const &[block_number, block_id] : blocks) {
+        on_finalize(*this, block_number, block_id);
+    }
+    rw.finalize_batch(blocks, verified_block);
+}
+
 void monad_statesync_server_context::update_verified_block(
     uint64_t const block_number)
 {
@@ -296,7 +360,8 @@ void monad_statesync_server_context::commit(
     std::vector<Address> const &senders,
     std::vector<Transaction> const &transactions,
     std::vector<BlockHeader> const &ommers,
-    std::optional<std::vector<Withdrawal>> const &withdrawals)
+    std::optional<std::vector<Withdrawal>> const &withdrawals,
+    std::vector<bytes32_t> const &tx_hashes)
 {
     on_commit(*this, state_deltas, header.number, block_id);
     rw.commit(
@@ -309,5 +374,6 @@ void monad_statesync_server_context::commit(
         senders,
         transactions,
         ommers,
-        withdrawals);
+        withdrawals,
+        tx_hashes);
 }
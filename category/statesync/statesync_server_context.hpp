@@ -19,17 +19,22 @@
 #include <category/core/config.hpp>
 #include <category/execution/ethereum/db/db.hpp>
 #include <category/mpt/db.hpp>
+#include <category/statesync/statesync_response_cache.hpp>
 
 #include <array>
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
 inline constexpr size_t MAX_ENTRIES = 43'200;
 inline constexpr size_t MAX_DELETIONS = 2'000'000;
+// leading bytes of each deleted address's hash kept to filter by prefix
+inline constexpr size_t DELETION_HASH_PREFIX_BYTES = 8;
 
 struct Deletion
 {
@@ -59,6 +64,9 @@ class FinalizedDeletions
     uint64_t end_block_number_{mpt::INVALID_BLOCK_NUM};
     std::array<FinalizedDeletionsEntry, MAX_ENTRIES> entries_{};
     std::array<Deletion, MAX_DELETIONS> deletions_{};
+    std::array<std::array<unsigned char, DELETION_HASH_PREFIX_BYTES>,
+               MAX_DELETIONS>
+        hash_prefixes_{};
     size_t free_start_{0};
     size_t free_end_{MAX_DELETIONS};
 
@@ -68,10 +76,16 @@ class FinalizedDeletions
 
 public:
     bool for_each(uint64_t block_number, std::function<void(Deletion const &)>);
+    // Visits only the deletions whose hashed address starts with
+    // `hash_prefix`, which is at most DELETION_HASH_PREFIX_BYTES long,
+    // without hashing the addresses again
+    bool for_each(
+        uint64_t block_number, byte_string_view hash_prefix,
+        std::function<void(Deletion const &)>);
     void write(uint64_t block_number, std::vector<Deletion> const &);
 };
 
-static_assert(sizeof(FinalizedDeletions) == 108764832);
+static_assert(sizeof(FinalizedDeletions) == 124764832);
 static_assert(alignof(FinalizedDeletions) == 8);
 
 struct ProposedDeletions
@@ -93,8 +107,13 @@ struct monad_statesync_server_context final : public monad::Db
 {
     monad::TrieDb &rw;
     monad::mpt::Db *ro;
+    // When set together with num_workers, requests are served on that many
+    // worker threads, each reading through its own ring over ro_io's storage
+    monad::mpt::AsyncIOContext *ro_io{nullptr};
+    unsigned num_workers{0};
     std::deque<monad::ProposedDeletions> proposals;
     monad::FinalizedDeletions deletions;
+    monad::StatesyncResponseCache responses;
 
     explicit monad_statesync_server_context(monad::TrieDb &rw);
 
@@ -108,6 +127,8 @@ struct monad_statesync_server_context final : public monad::Db
     virtual monad::vm::SharedIntercode
     read_code(monad::bytes32_t const &hash) override;
 
+    virtual size_t read_code_size(monad::bytes32_t const &hash) override;
+
     virtual monad::BlockHeader read_eth_header() override;
 
     virtual monad::bytes32_t state_root() override;
@@ -124,6 +145,9 @@ struct monad_statesync_server_context final : public monad::Db
     virtual void
     finalize(uint64_t block_number, monad::bytes32_t const &block_id) override;
     virtual void update_verified_block(uint64_t block_number) override;
+    virtual void finalize_batch(
+        std::span<monad::BlockFinalization const>,
+        std::optional<uint64_t> verified_block) override;
     virtual void update_voted_metadata(
         uint64_t block_number, monad::bytes32_t const &block_id) override;
 
@@ -135,6 +159,8 @@ struct monad_statesync_server_context final : public monad::Db
         std::vector<monad::Address> const & = {},
         std::vector<monad::Transaction> const &transactions = {},
         std::vector<monad::BlockHeader> const &ommers = {},
-        std::optional<std::vector<monad::Withdrawal>> const & =
-            std::nullopt) override;
+        std::optional<std::vector<monad::Withdrawal>> const & = std::nullopt,
+        std::vector<monad::bytes32_t> const &tx_hashes = {}) override;
+
+    virtual monad::DbStats stats() override;
 };
@@ -18,6 +18,7 @@
 #include <category/core/basic_formatter.hpp>
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
+#include <category/core/keccak.hpp>
 #include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
 #include <category/execution/ethereum/chain/genesis_state.hpp>
 #include <category/execution/ethereum/core/fmt/bytes_fmt.hpp>
@@ -25,7 +26,9 @@
 #include <category/execution/ethereum/db/trie_db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
+#include <category/statesync/statesync_batch.hpp>
 #include <category/statesync/statesync_client.h>
+#include <category/statesync/statesync_response_cache.hpp>
 #include <category/statesync/statesync_server.h>
 #include <category/statesync/statesync_server_context.hpp>
 #include <category/statesync/statesync_version.h>
@@ -46,6 +49,8 @@ using namespace monad::test;
 struct monad_statesync_client
 {
     std::deque<monad_sync_request> rqs{};
+    // requests the server received and has not yet answered
+    size_t in_flight{0};
     bool success{true};
 };
 
@@ -97,6 +102,9 @@ namespace
         size_t const len)
     {
         if (len == 1) {
+            if (net->client->rqs.empty()) {
+                return 0;
+            }
             constexpr auto MSG_TYPE = SYNC_TYPE_REQUEST;
             std::memcpy(buf, &MSG_TYPE, 1);
         }
@@ -105,6 +113,7 @@ namespace
             std::memcpy(
                 buf, &net->client->rqs.front(), sizeof(monad_sync_request));
             net->client->rqs.pop_front();
+            ++net->client->in_flight;
         }
         return static_cast<ssize_t>(len);
     }
@@ -129,6 +138,7 @@ namespace
     void statesync_server_send_done(
         monad_statesync_server_network *const net, monad_sync_done const done)
     {
+        --net->client->in_flight;
         net->client->success &= done.success;
         if (done.success) {
             monad_statesync_client_handle_done(net->cctx, done);
@@ -188,7 +198,7 @@ namespace
 
         void run()
         {
-            while (!client.rqs.empty()) {
+            while (!client.rqs.empty() || client.in_flight != 0) {
                 monad_statesync_server_run_once(server);
             }
         }
@@ -293,6 +303,50 @@ TEST_F(StateSyncFixture, sync_from_empty)
     EXPECT_EQ(hdr.value(), tgrt);
 }
 
+TEST_F(StateSyncFixture, sync_from_empty_parallel)
+{
+    constexpr auto N = 1'000'000;
+    bytes32_t parent_hash{NULL_HASH};
+    {
+        load_header(sdb, BlockHeader{.number = N - 257});
+        for (size_t i = N - 256; i < N; ++i) {
+            stdb.set_block_and_prefix(i - 1);
+            commit_sequential(
+                stdb,
+                {},
+                {},
+                BlockHeader{.parent_hash = parent_hash, .number = i});
+            parent_hash = to_bytes(
+                keccak256(rlp::encode_block_header(stdb.read_eth_header())));
+        }
+        load_db(stdb, N);
+        sctx.ro_io = &io_ctx;
+        sctx.num_workers = 4;
+        init();
+    }
+    handle_target(
+        cctx,
+        BlockHeader{
+            .parent_hash = parent_hash,
+            .state_root =
+                0xb9eda41f4a719d9f2ae332e3954de18bceeeba2248a44110878949384b184888_bytes32,
+            .number = N});
+    run();
+    EXPECT_TRUE(client.success);
+    EXPECT_TRUE(monad_statesync_client_has_reached_target(cctx));
+    EXPECT_TRUE(monad_statesync_client_finalize(cctx));
+
+    OnDiskMachine machine;
+    mpt::Db cdb{
+        machine,
+        mpt::OnDiskDbConfig{.append = true, .dbname_paths = {cdbname}}};
+    TrieDb ctdb{cdb};
+    EXPECT_EQ(ctdb.get_block_number(), N);
+    EXPECT_TRUE(ctdb.read_account(ADDR_A).has_value());
+    auto const h_icode = ctdb.read_code(H_CODE_HASH);
+    EXPECT_EQ(byte_string_view(h_icode->code(), h_icode->size()), H_CODE);
+}
+
 TEST_F(StateSyncFixture, sync_from_some)
 {
     {
@@ -1021,6 +1075,98 @@ TEST_F(StateSyncFixture, benchmark)
     EXPECT_TRUE(monad_statesync_client_finalize(cctx));
 }
 
+TEST(UpsertBatch, round_trip)
+{
+    std::vector<std::pair<monad_sync_type, byte_string>> upserts;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        Address const addr{i / 100};
+        bytes32_t const key{i};
+        byte_string value{addr.bytes, sizeof(addr.bytes)};
+        value.append(key.bytes, sizeof(key.bytes));
+        upserts.emplace_back(SYNC_TYPE_UPSERT_STORAGE, std::move(value));
+        if (i % 100 == 0) {
+            upserts.emplace_back(
+                SYNC_TYPE_UPSERT_ACCOUNT_DELETE,
+                byte_string{addr.bytes, sizeof(addr.bytes)});
+        }
+    }
+    upserts.emplace_back(SYNC_TYPE_UPSERT_CODE, byte_string{});
+
+    for (bool const compress : {false, true}) {
+        UpsertBatchWriter batch{compress};
+        size_t raw_size = 0;
+        for (auto const &[type, value] : upserts) {
+            batch.add(type, value, {});
+            raw_size += 1 + sizeof(uint64_t) + value.size();
+        }
+        auto const payload = batch.finish();
+        EXPECT_TRUE(batch.empty());
+        EXPECT_LT(payload.size() * 4, raw_size);
+        EXPECT_EQ(
+            payload.front(), compress ? UPSERT_BATCH_ZSTD : UPSERT_BATCH_RAW);
+
+        size_t i = 0;
+        EXPECT_TRUE(for_each_batched_upsert(
+            payload, [&](monad_sync_type const type, byte_string_view raw) {
+                EXPECT_EQ(type, upserts.at(i).first);
+                EXPECT_EQ(raw, upserts.at(i).second);
+                ++i;
+                return true;
+            }));
+        EXPECT_EQ(i, upserts.size());
+
+        auto truncated = payload;
+        truncated.pop_back();
+        EXPECT_FALSE(for_each_batched_upsert(
+            truncated, [](monad_sync_type, byte_string_view) { return true; }));
+    }
+}
+
+TEST(ResponseCache, replay_and_evict)
+{
+    StatesyncResponseCache cache{8 << 10};
+    auto const key = [](uint64_t const prefix, uint64_t const target) {
+        return StatesyncResponseCache::Key{
+            .prefix = prefix,
+            .prefix_bytes = 1,
+            .from = 0,
+            .until = target,
+            .target = target};
+    };
+
+    EXPECT_EQ(cache.find(key(0, 10)), nullptr);
+    cache.insert(key(0, 10), byte_string(100, 0xaa));
+    cache.insert(key(1, 10), byte_string(100, 0xbb));
+    cache.insert(key(0, 20), byte_string(100, 0xcc));
+    // larger than an eighth of the budget
+    cache.insert(key(2, 20), byte_string(2 << 10, 0xdd));
+    EXPECT_EQ(cache.used_bytes(), 300);
+
+    auto const stream = cache.find(key(1, 10));
+    ASSERT_NE(stream, nullptr);
+    EXPECT_EQ(*stream, byte_string(100, 0xbb));
+    EXPECT_EQ(cache.find(key(2, 20)), nullptr);
+
+    // targets out of history, then a target finalized again
+    cache.evict_before(11);
+    EXPECT_EQ(cache.find(key(0, 10)), nullptr);
+    EXPECT_EQ(cache.find(key(1, 10)), nullptr);
+    EXPECT_NE(cache.find(key(0, 20)), nullptr);
+    cache.evict_from(20);
+    EXPECT_EQ(cache.find(key(0, 20)), nullptr);
+    EXPECT_EQ(cache.used_bytes(), 0);
+
+    // the least recently used entry makes room
+    for (uint64_t i = 0; i < 8; ++i) {
+        cache.insert(key(i, 30), byte_string(1 << 10, 0));
+    }
+    EXPECT_NE(cache.find(key(0, 30)), nullptr);
+    cache.insert(key(8, 30), byte_string(1 << 10, 0));
+    EXPECT_NE(cache.find(key(0, 30)), nullptr);
+    EXPECT_EQ(cache.find(key(1, 30)), nullptr);
+    EXPECT_EQ(cache.used_bytes(), 8 << 10);
+}
+
 TEST(Deletions, history_length)
 {
     auto const deletions = std::make_unique<FinalizedDeletions>();
@@ -1040,6 +1186,36 @@ TEST(Deletions, history_length)
     EXPECT_FALSE(success);
 }
 
+TEST(Deletions, for_each_in_prefix)
+{
+    auto const deletions = std::make_unique<FinalizedDeletions>();
+    std::vector<Deletion> written;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        written.push_back(Deletion{.address = Address{i}});
+    }
+    deletions->write(1, written);
+
+    size_t total = 0;
+    for (unsigned p = 0; p < 256; ++p) {
+        byte_string const prefix{static_cast<unsigned char>(p)};
+        std::vector<Deletion> expected;
+        for (auto const &deletion : written) {
+            if (keccak256(deletion.address.bytes).bytes[0] == p) {
+                expected.push_back(deletion);
+            }
+        }
+        std::vector<Deletion> result;
+        EXPECT_TRUE(deletions->for_each(
+            1, prefix, [&result](Deletion const &deletion) {
+                result.push_back(deletion);
+            }));
+        EXPECT_EQ(result, expected);
+        total += result.size();
+    }
+    EXPECT_EQ(total, written.size());
+    EXPECT_FALSE(deletions->for_each(2, byte_string{}, [](auto const &) {}));
+}
+
 TEST(Deletions, max_deletions)
 {
     auto const deletions = std::make_unique<FinalizedDeletions>();
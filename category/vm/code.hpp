@@ -46,12 +46,14 @@ namespace monad::vm
     public:
         explicit Varcode(SharedIntercode icode)
             : intercode_gas_used_{0}
+            , native_gas_used_{0}
             , intercode_{std::move(icode)}
         {
         }
 
         Varcode(SharedIntercode icode, SharedNativecode ncode)
             : intercode_gas_used_{0}
+            , native_gas_used_{0}
             , intercode_{std::move(icode)}
             , nativecode_{std::move(ncode)}
         {
@@ -71,6 +73,13 @@ namespace monad::vm
             return intercode_gas_used_.load(std::memory_order_acquire);
         }
 
+        /// Accumulate gas spent in the native code, returning the total.
+        std::uint64_t native_gas_used(std::uint64_t gas_used)
+        {
+            return gas_used + native_gas_used_.fetch_add(
+                                  gas_used, std::memory_order_acq_rel);
+        }
+
         /// Get corresponding intercode.
         /// Can be assumed to always return a non-null result.
         SharedIntercode const &intercode() const
@@ -86,6 +95,7 @@ namespace monad::vm
 
     private:
         std::atomic<std::uint64_t> intercode_gas_used_;
+        std::atomic<std::uint64_t> native_gas_used_;
         SharedIntercode intercode_;
         SharedNativecode nativecode_;
     };
@@ -13,49 +13,113 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/util/latency_histogram.hpp>
 #include <category/vm/code.hpp>
 #include <category/vm/compiler.hpp>
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/core/assert.h>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/execute.hpp>
+#include <category/vm/interpreter/intercode.hpp>
+#include <category/vm/nativecode_store.hpp>
+#include <category/vm/perf_map.hpp>
+#include <category/vm/utils/scope_exit.hpp>
 
 #include <evmc/evmc.hpp>
 
+#include <quill/Quill.h>
+
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <tuple>
+#include <utility>
 #include <variant>
 
 namespace monad::vm
 {
-    Compiler::Compiler(bool enable_async, size_t compile_job_soft_limit)
+    Compiler::Compiler(
+        bool enable_async, size_t compile_job_soft_limit,
+        unsigned compile_threads)
         : asmjit_rt_{&asmjit_create_params_}
-        , compile_job_lock_{compile_job_mutex_}
         , compile_job_soft_limit_{compile_job_soft_limit}
         , enable_async_compilation_{enable_async}
     {
-        start_compile_thread();
+        start_compile_threads(std::max(compile_threads, 1u));
     }
 
     Compiler::~Compiler()
     {
-        stop_compile_thread();
+        stop_compile_threads();
+    }
+
+    size_t Compiler::enable_persistent_cache(std::filesystem::path const &dir)
+    {
+        MONAD_VM_ASSERT(compile_job_map_.empty());
+        nativecode_store_ = std::make_unique<NativecodeStore>(dir);
+        if (!nativecode_store_->enabled()) {
+            LOG_WARNING(
+                "Persistent code cache disabled: binary has no build id");
+            nativecode_store_.reset();
+            return 0;
+        }
+        size_t const n = nativecode_store_->load_all(
+            asmjit_rt_,
+            [this](
+                evmc::bytes32 const &code_hash,
+                SharedIntercode const &icode,
+                SharedNativecode const &ncode) {
+                varcode_cache_.set(code_hash, icode, ncode);
+            });
+        LOG_INFO("Loaded {} contracts from code cache {}", n, dir.string());
+        return n;
+    }
+
+    bool Compiler::enable_perf_map(std::filesystem::path const &path)
+    {
+        MONAD_VM_ASSERT(compile_job_map_.empty());
+        perf_map_ = std::make_unique<PerfMap>(path);
+        if (!perf_map_->enabled()) {
+            LOG_WARNING("Cannot open perf map {}", path.string());
+            perf_map_.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void Compiler::enable_optimizing_tier(std::unique_ptr<OptimizingTier> tier)
+    {
+        MONAD_VM_ASSERT(compile_job_map_.empty());
+        optimizing_tier_ = std::move(tier);
     }
 
-    void Compiler::start_compile_thread()
+    void Compiler::start_compile_threads(unsigned const n)
     {
         stop_flag_.clear(std::memory_order_release);
-        compiler_thread_ = std::thread{[this] { compile_loop(); }};
+        compile_thread_stats_ = std::make_unique<CompileThreadStats[]>(n);
+        compile_threads_.reserve(n);
+        for (unsigned i = 0; i < n; ++i) {
+            compile_threads_.emplace_back(
+                [this, &stats = compile_thread_stats_[i]] {
+                    compile_loop(stats);
+                });
+        }
     }
 
-    void Compiler::stop_compile_thread()
+    void Compiler::stop_compile_threads()
     {
         stop_flag_.test_and_set(std::memory_order_release);
         compile_job_cv_.notify_all();
-        compiler_thread_.join();
+        for (auto &t : compile_threads_) {
+            t.join();
+        }
+        compile_threads_.clear();
     }
 
     template <Traits traits>
@@ -69,9 +133,38 @@ namespace monad::vm
     EXPLICIT_TRAITS_MEMBER(Compiler::compile);
 
     template <Traits traits>
-    SharedNativecode Compiler::cached_compile(
+    SharedNativecode Compiler::compile_with_fallback(
+        SharedIntercode const &icode, CompilerConfig const &config)
+    {
+        auto ncode = compile<traits>(icode, config);
+        if (config.interpreter_fallback) {
+            return ncode;
+        }
+        // Compile only the blocks nearest to the entry, within half and
+        // then a quarter of the bytecode, and let the other blocks resume
+        // in the interpreter. Two retries bound the compile time.
+        CompilerConfig partial_config = config;
+        uint32_t budget = *icode->code_size();
+        for (int retry = 0; retry < 2; ++retry) {
+            if (ncode->error_code() != Nativecode::SizeOutOfBound) {
+                break;
+            }
+            budget /= 2;
+            partial_config.interpreter_fallback =
+                compiler::native::InterpreterFallback{
+                    .intercode = icode,
+                    .resume = &interpreter::resume<traits>,
+                    .compiled_bytecode_budget =
+                        interpreter::code_size_t::unsafe_from(budget)};
+            ncode = compile<traits>(icode, partial_config);
+        }
+        return ncode;
+    }
+
+    template <Traits traits>
+    SharedNativecode Compiler::cached_compile_impl(
         evmc::bytes32 const &code_hash, SharedIntercode const &icode,
-        CompilerConfig const &config)
+        CompilerConfig const &config, CompileThreadStats *const thread_stats)
     {
         if (auto vcode = varcode_cache_.get(code_hash)) {
             auto const &ncode = (*vcode)->nativecode();
@@ -79,32 +172,175 @@ namespace monad::vm
                 return ncode;
             }
         }
+        if (nativecode_store_) {
+            if (auto ncode = nativecode_store_->load(
+                    asmjit_rt_, code_hash, traits::id())) {
+                varcode_cache_.set(code_hash, icode, ncode);
+                return ncode;
+            }
+        }
         auto const start = std::chrono::steady_clock::now();
-        auto ncode = compile<traits>(icode, config);
+        auto ncode = [&] {
+            if (!nativecode_store_ && !perf_map_) {
+                return compile_with_fallback<traits>(icode, config);
+            }
+            CompilerConfig image_config = config;
+            image_config.code_image_hook =
+                [&](compiler::native::CodeImage const &image) {
+                    if (nativecode_store_) {
+                        nativecode_store_->save(
+                            code_hash, traits::id(), icode, image);
+                    }
+                    if (perf_map_) {
+                        perf_map_->add(image, code_hash);
+                    }
+                };
+            return compile_with_fallback<traits>(icode, image_config);
+        }();
         auto const end = std::chrono::steady_clock::now();
+        static LatencyMetric &latency = latency_metric(
+            "monad_vm_compile_seconds",
+            "time to compile a contract with the baseline compiler");
+        latency.record(end - start);
         varcode_cache_.set(code_hash, icode, ncode);
-        stats_.event_new_compiled_code_cached(icode, ncode, start, end);
+        if constexpr (utils::collect_monad_compiler_stats) {
+            std::lock_guard const lock{stats_mutex_};
+            stats_.event_new_compiled_code_cached(icode, ncode, start, end);
+        }
+        if (thread_stats) {
+            thread_stats->event_compile(start, end);
+        }
         return ncode;
     }
 
+    template <Traits traits>
+    SharedNativecode Compiler::cached_compile(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode,
+        CompilerConfig const &config)
+    {
+        return cached_compile_impl<traits>(code_hash, icode, config, nullptr);
+    }
+
     EXPLICIT_TRAITS_MEMBER(Compiler::cached_compile);
 
+    template <Traits traits>
+    SharedNativecode Compiler::cached_optimize(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode)
+    {
+        MONAD_VM_DEBUG_ASSERT(optimizing_tier_);
+        return optimize_impl<traits>(code_hash, icode, nullptr);
+    }
+
+    EXPLICIT_TRAITS_MEMBER(Compiler::cached_optimize);
+
+    template <Traits traits>
+    SharedNativecode Compiler::optimize_impl(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode,
+        CompileThreadStats *const thread_stats)
+    {
+        if (auto vcode = varcode_cache_.get(code_hash)) {
+            auto const &ncode = (*vcode)->nativecode();
+            if (ncode != nullptr && ncode->optimized() &&
+                ncode->chain_id() == traits::id()) {
+                return ncode;
+            }
+        }
+        auto const start = std::chrono::steady_clock::now();
+        auto ncode = optimizing_tier_->compile(
+            asmjit_rt_, traits::evm_rev(), traits::id(), code_hash, icode);
+        auto const end = std::chrono::steady_clock::now();
+        static LatencyMetric &latency = latency_metric(
+            "monad_vm_optimize_seconds",
+            "time to compile a contract with the optimizing tier");
+        latency.record(end - start);
+        MONAD_VM_ASSERT(ncode->chain_id() == traits::id());
+        if (ncode->entrypoint() != nullptr) {
+            // Threads still running the baseline code hold on to it through
+            // their varcode, so replacing the cached varcode is safe.
+            varcode_cache_.set(code_hash, icode, ncode);
+        }
+        else {
+            LOG_WARNING(
+                "Optimizing tier failed to compile contract of size {}",
+                *icode->code_size());
+            // Without code of its own for this revision to keep, cache the
+            // failure, so callers using the optimizing tier as their only
+            // tier interpret the contract instead of submitting it again.
+            auto const vcode = varcode_cache_.get(code_hash);
+            if (!vcode || (*vcode)->nativecode() == nullptr ||
+                (*vcode)->nativecode()->chain_id() != traits::id()) {
+                varcode_cache_.set(code_hash, icode, ncode);
+            }
+        }
+        if (thread_stats) {
+            thread_stats->event_compile(start, end);
+        }
+        return ncode;
+    }
+
     template <Traits traits>
     bool Compiler::async_compile(
         evmc::bytes32 const &code_hash, SharedIntercode const &icode,
-        CompilerConfig const &config)
+        CompilerConfig const &config, uint64_t const priority)
     {
         if (compile_job_map_.size() >= compile_job_soft_limit_) {
             return false;
         }
         auto const cached_compile_lambda = [this](auto &&...args) {
             // Clang complains about `this` being unused if we don't explicitly
-            // call `cached_compile` through it.
-            return this->cached_compile<traits>(
+            // call `cached_compile_impl` through it.
+            return this->cached_compile_impl<traits>(
                 std::forward<decltype(args)>(args)...);
         };
+        return submit_compile_job(
+            code_hash,
+            CompileJob{
+                .compile_fn = cached_compile_lambda,
+                .chain_id = traits::id(),
+                .icode = icode,
+                .config = config,
+                .priority = priority,
+                .running = false,
+                .optimize = false});
+    }
+
+    EXPLICIT_TRAITS_MEMBER(Compiler::async_compile);
+
+    template <Traits traits>
+    bool Compiler::async_optimize(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode,
+        uint64_t const priority)
+    {
+        MONAD_VM_DEBUG_ASSERT(optimizing_tier_);
+        if (compile_job_map_.size() >= compile_job_soft_limit_) {
+            return false;
+        }
+        auto const optimize_lambda = [this](
+                                         evmc::bytes32 const &hash,
+                                         SharedIntercode const &code,
+                                         CompilerConfig const &,
+                                         CompileThreadStats *thread_stats) {
+            return this->optimize_impl<traits>(hash, code, thread_stats);
+        };
+        return submit_compile_job(
+            code_hash,
+            CompileJob{
+                .compile_fn = optimize_lambda,
+                .chain_id = traits::id(),
+                .icode = icode,
+                .config = {},
+                .priority = priority,
+                .running = false,
+                .optimize = true});
+    }
+
+    EXPLICIT_TRAITS_MEMBER(Compiler::async_optimize);
 
-        // Multiple threads can get through the above limit check, so we might
+    bool Compiler::submit_compile_job(
+        evmc::bytes32 const &code_hash, CompileJob job)
+    {
+        uint64_t const priority = job.priority;
+        // Multiple threads can get through the soft limit check, so we might
         // insert more compile jobs than `compile_job_soft_limit_`. We accept
         // multiple threads getting through at approximately the same time and
         // hence go beyond the limit. This is acceptable, because we already
@@ -112,22 +348,34 @@ namespace monad::vm
         // implying that the peak memory usage of the queued compile jobs will
         // be asymptotically the same as the peak memory usage of concurrently
         // executed bytecode.
-        if (!compile_job_map_.insert(
-                {code_hash,
-                 {cached_compile_lambda, traits::id(), icode, config}})) {
-            // The compile job was already submitted.
-            return false;
+        if (!compile_job_map_.insert({code_hash, std::move(job)})) {
+            // The compile job was already submitted. Queue it again if it
+            // got much hotter in the meantime. Doubling bounds how often
+            // a job is queued, and the stale entry is skipped when popped.
+            {
+                CompileJobConstAccessor acc;
+                if (!compile_job_map_.find(acc, code_hash) ||
+                    acc->second.running ||
+                    priority / 2 <= acc->second.priority) {
+                    return false;
+                }
+            }
+            CompileJobAccessor acc;
+            if (!compile_job_map_.find(acc, code_hash) ||
+                acc->second.running || priority <= acc->second.priority) {
+                return false;
+            }
+            acc->second.priority = priority;
         }
-        // Update the queue and notify the compile loop thread.
+        // Update the queue and notify a compile thread.
         compile_job_queue_.push(code_hash);
-        compile_job_cv_.notify_all();
+        compile_job_cv_.notify_one();
         return true;
     }
 
-    EXPLICIT_TRAITS_MEMBER(Compiler::async_compile);
-
-    void Compiler::compile_loop()
+    void Compiler::compile_loop(CompileThreadStats &thread_stats)
     {
+        std::unique_lock lock{compile_job_mutex_};
         while (!stop_flag_.test(std::memory_order_acquire)) {
             // It is possible that a new compile job has arrived or the stop
             // flag has been set, so wait for at most 1 ms. The time 1 ms seems
@@ -136,40 +384,65 @@ namespace monad::vm
             // Another approach is to use a lock to fix these "data races".
             // However that seems to require a lock in `async_compile`, which
             // is undesirable because it is part of the fast path.
-            compile_job_cv_.wait_for(
-                compile_job_lock_, std::chrono::milliseconds{1});
-            dispense_compile_jobs();
+            compile_job_cv_.wait_for(lock, std::chrono::milliseconds{1});
+            dispense_compile_jobs(lock, thread_stats);
         }
     }
 
-    void Compiler::dispense_compile_jobs()
+    void Compiler::dispense_compile_jobs(
+        std::unique_lock<std::mutex> &lock, CompileThreadStats &thread_stats)
     {
-        evmc::bytes32 code_hash;
-        while (compile_job_queue_.try_pop(code_hash) &&
-               !stop_flag_.test(std::memory_order_acquire)) {
-            CompileJobAccessor acc;
-            bool const find_ok = compile_job_map_.find(acc, code_hash);
-            MONAD_VM_ASSERT(find_ok);
-            auto const &[compile_fn, chain_id, icode, config] = acc->second;
+        while (!stop_flag_.test(std::memory_order_acquire)) {
+            evmc::bytes32 code_hash;
+            while (compile_job_queue_.try_pop(code_hash)) {
+                CompileJobConstAccessor acc;
+                if (compile_job_map_.find(acc, code_hash)) {
+                    compile_job_heap_.emplace(acc->second.priority, code_hash);
+                }
+            }
+            if (compile_job_heap_.empty()) {
+                return;
+            }
+            uint64_t priority;
+            std::tie(priority, code_hash) = compile_job_heap_.top();
+            compile_job_heap_.pop();
 
+            // Claim the job, skipping it if it was queued again with a
+            // higher priority, or another thread is already compiling it.
+            CompileJob job;
+            {
+                CompileJobAccessor acc;
+                if (!compile_job_map_.find(acc, code_hash) ||
+                    acc->second.running || acc->second.priority != priority) {
+                    continue;
+                }
+                acc->second.running = true;
+                job = acc->second;
+            }
+
+            lock.unlock();
+            // Erase the job even if compiling it throws, so that it is not
+            // left marked as running and the code can be submitted again.
+            auto const finish_job = utils::scope_exit([&] {
+                bool const erase_ok = compile_job_map_.erase(code_hash);
+                MONAD_VM_ASSERT(erase_ok);
+                lock.lock();
+            });
             if (MONAD_VM_LIKELY(enable_async_compilation_)) {
                 // It is possible that a new async compile request with the same
                 // intercode arrives right after we erase from
                 // `compile_job_map_` below. Therefore we use `cached_compile`,
                 // because it first checks whether the intercode is already
                 // compiled.
-                compile_fn(code_hash, icode, config);
+                job.compile_fn(code_hash, job.icode, job.config, &thread_stats);
             }
-            else {
+            else if (!job.optimize) {
                 varcode_cache_.set(
                     code_hash,
-                    icode,
+                    job.icode,
                     std::make_shared<Nativecode>(
-                        asmjit_rt_, chain_id, nullptr, std::monostate{}));
+                        asmjit_rt_, job.chain_id, nullptr, std::monostate{}));
             }
-
-            bool const erase_ok = compile_job_map_.erase(acc);
-            MONAD_VM_ASSERT(erase_ok);
         }
     }
 
@@ -18,6 +18,9 @@
 #include <category/vm/code.hpp>
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/nativecode_store.hpp>
+#include <category/vm/optimizing_tier.hpp>
+#include <category/vm/perf_map.hpp>
 #include <category/vm/utils/debug.hpp>
 #include <category/vm/utils/log_utils.hpp>
 #include <category/vm/varcode_cache.hpp>
@@ -30,10 +33,20 @@
 
 #include <asmjit/x86.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace monad::vm
 {
@@ -136,25 +149,73 @@ namespace monad::vm
         }
     };
 
+    struct CompileThreadStats
+    {
+        utils::EuclidMean<int64_t> avg_compile_time_;
+        std::atomic<int64_t> max_compile_time_{0};
+
+        // must be called non-concurrently
+        void event_compile(auto compile_start, auto compile_end) noexcept
+        {
+            if constexpr (utils::collect_monad_compiler_stats) {
+                auto compile_time =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        compile_end - compile_start)
+                        .count();
+                avg_compile_time_.update(compile_time);
+                max_compile_time_ = std::max(
+                    max_compile_time_.load(std::memory_order_acquire),
+                    compile_time);
+            }
+        }
+    };
+
     class Compiler
     {
+        using CompileFn = std::function<SharedNativecode(
+            evmc::bytes32 const &, SharedIntercode const &,
+            CompilerConfig const &, CompileThreadStats *)>;
+
+        struct CompileJob
+        {
+            CompileFn compile_fn;
+            uint64_t chain_id;
+            SharedIntercode icode;
+            CompilerConfig config;
+            uint64_t priority;
+            bool running;
+            bool optimize;
+        };
+
         using CompileJobMap = tbb::concurrent_hash_map<
-            evmc::bytes32,
-            std::tuple<
-                std::function<SharedNativecode(
-                    evmc::bytes32 const &, SharedIntercode const &,
-                    CompilerConfig const &)>,
-                uint64_t, SharedIntercode, CompilerConfig>,
-            utils::Hash32Compare>;
+            evmc::bytes32, CompileJob, utils::Hash32Compare>;
         using CompileJobAccessor = CompileJobMap::accessor;
+        using CompileJobConstAccessor = CompileJobMap::const_accessor;
         using CompileJobQueue = tbb::concurrent_queue<evmc::bytes32>;
+        using CompileJobHeap =
+            std::priority_queue<std::pair<uint64_t, evmc::bytes32>>;
 
     public:
+        static constexpr size_t default_compile_job_soft_limit = 1000;
+
         explicit Compiler(
-            bool enable_async = true, size_t compile_job_soft_limit = 1000);
+            bool enable_async = true,
+            size_t compile_job_soft_limit = default_compile_job_soft_limit,
+            unsigned compile_threads = 1);
 
         ~Compiler();
 
+        /// Persist compiled code in `dir`, and load the code persisted there
+        /// by previous runs into the varcode cache. Must be called before
+        /// any compile request. Returns the number of contracts loaded.
+        size_t enable_persistent_cache(std::filesystem::path const &dir);
+
+        /// Write the address range of newly compiled code to the `perf`
+        /// symbol map at `path`, see `PerfMap`. Must be called before any
+        /// compile request. Returns false if the map could not be opened.
+        bool enable_perf_map(
+            std::filesystem::path const &path = PerfMap::default_path());
+
         /// Compile `Intercode` for `revision` and return compilation result.
         template <Traits traits>
         SharedNativecode
@@ -170,10 +231,39 @@ namespace monad::vm
         /// `revision`. Returns `true` if compile job was submitted.
         /// Returns `false` if the job was already submitted or there
         /// are too many compile jobs, so unable to submit the new job.
+        /// Queued jobs are compiled in order of descending `priority`,
+        /// which is the gas spent interpreting the code so far. A job
+        /// submitted again with at least twice its priority is moved up.
         template <Traits traits>
         bool async_compile(
             evmc::bytes32 const &code_hash, SharedIntercode const &,
-            CompilerConfig const & = {});
+            CompilerConfig const & = {}, uint64_t priority = 0);
+
+        /// Recompile hot contracts with `tier`, see `async_optimize`. Must be
+        /// called before any compile request.
+        void enable_optimizing_tier(std::unique_ptr<OptimizingTier> tier);
+
+        bool has_optimizing_tier() const noexcept
+        {
+            return optimizing_tier_ != nullptr;
+        }
+
+        /// Asynchronously recompile intercode with given code hash using
+        /// the optimizing tier, and replace the cached varcode once done.
+        /// If the optimizing tier fails, the cached varcode is kept.
+        /// Returns `true` if the compile job was submitted, like
+        /// `async_compile`, which it shares the compile threads with.
+        template <Traits traits>
+        bool async_optimize(
+            evmc::bytes32 const &code_hash, SharedIntercode const &,
+            uint64_t priority = 0);
+
+        /// Find nativecode of the optimizing tier in cache, else compile
+        /// with the optimizing tier on the calling thread and add it to
+        /// cache, see `async_optimize`.
+        template <Traits traits>
+        SharedNativecode cached_optimize(
+            evmc::bytes32 const &code_hash, SharedIntercode const &);
 
         /// Lookup in the cache.
         std::optional<SharedVarcode>
@@ -188,6 +278,12 @@ namespace monad::vm
             return varcode_cache_.try_set(code_hash, icode);
         }
 
+        /// Keep the cached varcode under `code_hash` after LRU eviction.
+        bool pin_varcode(evmc::bytes32 const &code_hash)
+        {
+            return varcode_cache_.pin(code_hash);
+        }
+
         bool is_varcode_cache_warm()
         {
             return varcode_cache_.is_warm();
@@ -198,20 +294,58 @@ namespace monad::vm
             return varcode_cache_.set_warm_cache_kb(warm_kb);
         }
 
+        VarcodeCache &varcode_cache() noexcept
+        {
+            return varcode_cache_;
+        }
+
         std::string print_stats() const
         {
-            return stats_.print_stats(
+            auto str = stats_.print_stats(
                 varcode_cache_.size(), varcode_cache_.approx_weight());
+            if constexpr (utils::collect_monad_compiler_stats) {
+                for (size_t i = 0; i < compile_threads_.size(); ++i) {
+                    auto const &t = compile_thread_stats_[i];
+                    str += std::format(
+                        ",compile_thread_{}_avg_compile_time={}µs"
+                        ",compile_thread_{}_max_compile_time={}µs",
+                        i,
+                        t.avg_compile_time_.get(),
+                        i,
+                        t.max_compile_time_.load(std::memory_order_acquire));
+                }
+            }
+            return str;
         }
 
         // For testing: wait for compile job queue to become empty.
         void debug_wait_for_empty_queue();
 
     private:
-        void start_compile_thread();
-        void stop_compile_thread();
-        void compile_loop();
-        void dispense_compile_jobs();
+        /// Like `compile`, but native code out of bound is compiled again
+        /// partially, with the blocks far from the entry resuming in the
+        /// interpreter, unless `config` already sets the fallback.
+        template <Traits traits>
+        SharedNativecode
+        compile_with_fallback(SharedIntercode const &, CompilerConfig const &);
+
+        template <Traits traits>
+        SharedNativecode cached_compile_impl(
+            evmc::bytes32 const &code_hash, SharedIntercode const &,
+            CompilerConfig const &, CompileThreadStats *);
+
+        template <Traits traits>
+        SharedNativecode optimize_impl(
+            evmc::bytes32 const &code_hash, SharedIntercode const &,
+            CompileThreadStats *);
+
+        bool submit_compile_job(evmc::bytes32 const &code_hash, CompileJob);
+
+        void start_compile_threads(unsigned);
+        void stop_compile_threads();
+        void compile_loop(CompileThreadStats &);
+        void dispense_compile_jobs(
+            std::unique_lock<std::mutex> &, CompileThreadStats &);
 
         static constexpr asmjit::JitAllocator::CreateParams
             asmjit_create_params_{
@@ -220,16 +354,23 @@ namespace monad::vm
 
         asmjit::JitRuntime asmjit_rt_;
         VarcodeCache varcode_cache_;
+        std::unique_ptr<NativecodeStore> nativecode_store_;
+        std::unique_ptr<PerfMap> perf_map_;
+        std::unique_ptr<OptimizingTier> optimizing_tier_;
         CompileJobMap compile_job_map_;
         CompileJobQueue compile_job_queue_;
-        std::condition_variable compile_job_cv_;
+        // Guards `compile_job_heap_`, which the compile threads fill from
+        // `compile_job_queue_`, so that submitting stays lock free.
         std::mutex compile_job_mutex_;
-        std::unique_lock<std::mutex> compile_job_lock_;
-        std::thread compiler_thread_;
+        std::condition_variable compile_job_cv_;
+        CompileJobHeap compile_job_heap_;
+        std::vector<std::thread> compile_threads_;
         std::atomic_flag stop_flag_;
         size_t compile_job_soft_limit_;
         bool enable_async_compilation_;
 
+        std::mutex stats_mutex_;
         CompilerStats stats_;
+        std::unique_ptr<CompileThreadStats[]> compile_thread_stats_;
     };
 }
@@ -57,13 +57,30 @@ namespace monad::vm::compiler::basic_blocks
             basic_blocks::terminator_inputs(terminator));
         min_delta = std::min(delta, min_delta);
 
+        min_delta = std::min(min_delta_bound, min_delta);
+        max_delta = std::max(max_delta_bound, max_delta);
+
         return {min_delta, delta, max_delta};
     }
 
     bool operator==(Block const &a, Block const &b)
     {
-        return std::tie(a.instrs, a.terminator, a.fallthrough_dest, a.offset) ==
-               std::tie(b.instrs, b.terminator, b.fallthrough_dest, b.offset);
+        return std::tie(
+                   a.instrs,
+                   a.terminator,
+                   a.fallthrough_dest,
+                   a.offset,
+                   a.extra_gas,
+                   a.min_delta_bound,
+                   a.max_delta_bound) ==
+               std::tie(
+                   b.instrs,
+                   b.terminator,
+                   b.fallthrough_dest,
+                   b.offset,
+                   b.extra_gas,
+                   b.min_delta_bound,
+                   b.max_delta_bound);
     }
 
     /*
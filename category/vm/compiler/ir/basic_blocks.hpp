@@ -186,6 +186,20 @@ namespace monad::vm::compiler::basic_blocks
          */
         byte_offset offset = 0;
 
+        /**
+         * Static gas of instructions removed from the end of this block by
+         * the IR passes in `passes.hpp`. It is charged with the terminator.
+         */
+        std::uint32_t extra_gas = 0;
+
+        /**
+         * Stack delta bounds of instructions removed by the IR passes, so
+         * that the stack bound checks of the block do not change. They are
+         * included in `stack_deltas`.
+         */
+        std::int32_t min_delta_bound = 0;
+        std::int32_t max_delta_bound = 0;
+
         /**
          * Returns true if this block is well-formed.
          *
@@ -422,7 +436,7 @@ namespace monad::vm::compiler::basic_blocks
     template <Traits traits>
     int64_t block_base_gas(Block const &block)
     {
-        int64_t base_gas = 0;
+        int64_t base_gas = block.extra_gas;
         for (auto const &instr : block.instrs) {
             base_gas += instr.static_gas_cost();
         }
@@ -132,6 +132,9 @@ namespace monad::vm::compiler
         constexpr std::uint8_t stack_increase() const noexcept;
         constexpr bool dynamic_gas() const noexcept;
 
+        /// Charge the static gas of removed instructions with this one.
+        constexpr void add_static_gas_cost(std::uint32_t) noexcept;
+
         friend constexpr bool
         operator==(Instruction const &, Instruction const &) noexcept;
 
@@ -228,6 +231,11 @@ namespace monad::vm::compiler
         return dynamic_gas_;
     }
 
+    constexpr void Instruction::add_static_gas_cost(std::uint32_t gas) noexcept
+    {
+        static_gas_cost_ += gas;
+    }
+
     constexpr auto Instruction::as_tuple() const noexcept
     {
         return std::tie(
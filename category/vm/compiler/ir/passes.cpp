@@ -0,0 +1,528 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/compiler/ir/instruction.hpp>
+#include <category/vm/compiler/ir/passes.hpp>
+#include <category/vm/compiler/types.hpp>
+#include <category/vm/core/assert.h>
+#include <category/vm/runtime/uint256.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace monad::vm::compiler;
+using namespace monad::vm::compiler::basic_blocks;
+
+namespace
+{
+    using monad::vm::runtime::uint256_t;
+
+    Instruction make_push(
+        std::uint32_t pc, uint256_t const &value, std::uint32_t gas,
+        std::uint8_t index = 32)
+    {
+        return Instruction{pc, OpCode::Push, value, gas, 0, index, 1, false};
+    }
+
+    bool is_push(Instruction const &instr)
+    {
+        return instr.opcode() == OpCode::Push;
+    }
+
+    std::size_t trailing_push_count(std::vector<Instruction> const &instrs)
+    {
+        std::size_t n = 0;
+        for (auto it = instrs.rbegin(); it != instrs.rend() && is_push(*it);
+             ++it) {
+            ++n;
+        }
+        return n;
+    }
+
+    /// Evaluate a pure instruction, where `a[0]` is the top of the stack.
+    std::optional<uint256_t>
+    evaluate(OpCode op, std::array<uint256_t, 3> const &a)
+    {
+        using namespace monad::vm::runtime;
+        using enum OpCode;
+        switch (op) {
+        case Add:
+            return a[0] + a[1];
+        case Mul:
+            return a[0] * a[1];
+        case Sub:
+            return a[0] - a[1];
+        case Div:
+            return a[1] == 0 ? uint256_t{0} : a[0] / a[1];
+        case SDiv:
+            return a[1] == 0 ? uint256_t{0} : sdivrem(a[0], a[1]).quot;
+        case Mod:
+            return a[1] == 0 ? uint256_t{0} : a[0] % a[1];
+        case SMod:
+            return a[1] == 0 ? uint256_t{0} : sdivrem(a[0], a[1]).rem;
+        case AddMod:
+            return a[2] == 0 ? uint256_t{0} : addmod(a[0], a[1], a[2]);
+        case MulMod:
+            return a[2] == 0 ? uint256_t{0} : mulmod(a[0], a[1], a[2]);
+        case SignExtend:
+            return signextend(a[0], a[1]);
+        case Lt:
+            return uint256_t{a[0] < a[1]};
+        case Gt:
+            return uint256_t{a[0] > a[1]};
+        case SLt:
+            return uint256_t{slt(a[0], a[1])};
+        case SGt:
+            return uint256_t{slt(a[1], a[0])};
+        case Eq:
+            return uint256_t{a[0] == a[1]};
+        case IsZero:
+            return uint256_t{a[0] == 0};
+        case And:
+            return a[0] & a[1];
+        case Or:
+            return a[0] | a[1];
+        case XOr:
+            return a[0] ^ a[1];
+        case Not:
+            return ~a[0];
+        case Byte:
+            return byte(a[0], a[1]);
+        case Shl:
+            return a[1] << a[0];
+        case Shr:
+            return a[1] >> a[0];
+        case Sar:
+            return sar(a[0], a[1]);
+        default:
+            return std::nullopt;
+        }
+    }
+
+    /// Peephole rewrite of the instruction sequence `out` followed by
+    /// `instr`. Returns false if `instr` is not rewritten. The static gas of
+    /// removed instructions is accumulated in `pending_gas`, to be charged
+    /// with the next instruction, so that the gas remaining before each
+    /// instruction does not change.
+    bool simplify(
+        std::vector<Instruction> &out, Instruction const &instr, bool fold,
+        bool eliminate, std::uint32_t &pending_gas)
+    {
+        std::size_t const pushes = trailing_push_count(out);
+        auto const op = instr.opcode();
+
+        if (fold && !instr.dynamic_gas() && instr.stack_increase() == 1 &&
+            instr.stack_args() <= 3 && instr.stack_args() <= pushes &&
+            instr.stack_args() > 0) {
+            std::array<uint256_t, 3> args{};
+            std::uint32_t gas = pending_gas + instr.static_gas_cost();
+            for (std::size_t i = 0; i < instr.stack_args(); ++i) {
+                auto const &push = out[out.size() - 1 - i];
+                args[i] = push.immediate_value();
+                gas += push.static_gas_cost();
+            }
+            if (auto const value = evaluate(op, args)) {
+                out.erase(out.end() - instr.stack_args(), out.end());
+                out.push_back(make_push(instr.pc(), *value, gas));
+                pending_gas = 0;
+                return true;
+            }
+        }
+
+        if (fold && op == OpCode::Dup && instr.index() <= pushes) {
+            auto const &src = out[out.size() - instr.index()];
+            out.push_back(make_push(
+                instr.pc(),
+                src.immediate_value(),
+                pending_gas + instr.static_gas_cost(),
+                src.index()));
+            pending_gas = 0;
+            return true;
+        }
+
+        if (fold && op == OpCode::Swap && instr.index() < pushes) {
+            std::swap(out.back(), out[out.size() - 1 - instr.index()]);
+            pending_gas += instr.static_gas_cost();
+            return true;
+        }
+
+        if (eliminate && op == OpCode::Pop && !out.empty() &&
+            (is_push(out.back()) || out.back().opcode() == OpCode::Dup)) {
+            pending_gas +=
+                out.back().static_gas_cost() + instr.static_gas_cost();
+            out.pop_back();
+            return true;
+        }
+
+        if (eliminate && op == OpCode::Swap && !out.empty() &&
+            out.back().opcode() == OpCode::Swap &&
+            out.back().index() == instr.index()) {
+            pending_gas +=
+                out.back().static_gas_cost() + instr.static_gas_cost();
+            out.pop_back();
+            return true;
+        }
+
+        return false;
+    }
+
+    /// Replace `block` by `rewritten`, which has the same stack delta,
+    /// keeping the stack bound checks of `block`.
+    void replace_block(Block &block, Block rewritten)
+    {
+        auto const [min_delta, delta, max_delta] = block.stack_deltas();
+        rewritten.min_delta_bound = min_delta;
+        rewritten.max_delta_bound = max_delta;
+        MONAD_VM_DEBUG_ASSERT(std::get<1>(rewritten.stack_deltas()) == delta);
+        block = std::move(rewritten);
+    }
+
+    void simplify_block(Block &block, bool fold, bool eliminate)
+    {
+        std::vector<Instruction> out;
+        out.reserve(block.instrs.size());
+        std::uint32_t pending_gas = 0;
+        bool changed = false;
+        for (auto const &instr : block.instrs) {
+            if (simplify(out, instr, fold, eliminate, pending_gas)) {
+                changed = true;
+            }
+            else {
+                out.push_back(instr);
+                out.back().add_static_gas_cost(pending_gas);
+                pending_gas = 0;
+            }
+        }
+        if (!changed) {
+            return;
+        }
+        Block simplified{block};
+        simplified.instrs = std::move(out);
+        simplified.extra_gas += pending_gas;
+        replace_block(block, std::move(simplified));
+    }
+
+    /// Remove the blocks which are neither the entry block, a jump
+    /// destination nor the fall through destination of a remaining block.
+    /// Fall through destinations always follow their predecessor, so a
+    /// single forward scan suffices.
+    constexpr std::uint16_t max_bits = 256;
+
+    std::uint16_t bit_width(uint256_t const &x)
+    {
+        return static_cast<std::uint16_t>(
+            max_bits - monad::vm::runtime::countl_zero(x));
+    }
+
+    /// Upper bound on the number of significant bits of the result of
+    /// `instr`, given the bounds of its stack inputs, top first.
+    std::uint16_t
+    result_bit_bound(Instruction const &instr, std::uint16_t const *in)
+    {
+        using enum OpCode;
+        switch (instr.opcode()) {
+        case Add:
+            return std::min(
+                max_bits,
+                static_cast<std::uint16_t>(std::max(in[0], in[1]) + 1));
+        case Mul:
+            return std::min(
+                max_bits, static_cast<std::uint16_t>(in[0] + in[1]));
+        case Div:
+            return in[0];
+        case Shr:
+            return in[1];
+        case Mod:
+        case And:
+            return std::min(in[0], in[1]);
+        case Or:
+        case XOr:
+            return std::max(in[0], in[1]);
+        case AddMod:
+        case MulMod:
+            return in[2];
+        case Lt:
+        case Gt:
+        case SLt:
+        case SGt:
+        case Eq:
+        case IsZero:
+            return 1;
+        case Byte:
+            return 8;
+        case Address:
+        case Origin:
+        case Caller:
+        case Coinbase:
+            return 160;
+        case CallDataSize:
+        case CodeSize:
+        case ReturnDataSize:
+        case Timestamp:
+        case Number:
+        case GasLimit:
+        case MSize:
+        case Gas:
+            return 64;
+        case Pc:
+            return bit_width(instr.pc());
+        case Push:
+            return bit_width(instr.immediate_value());
+        default:
+            return max_bits;
+        }
+    }
+
+    void remove_unreachable_blocks(BasicBlocksIR &ir)
+    {
+        auto &blocks = ir.blocks();
+        std::unordered_set<block_id> reachable_ids;
+        reachable_ids.insert(0);
+        for (auto const &[_, id] : ir.jump_dests()) {
+            reachable_ids.insert(id);
+        }
+
+        std::vector<block_id> new_ids(blocks.size(), INVALID_BLOCK_ID);
+        block_id next_id = 0;
+        for (block_id id = 0; id < blocks.size(); ++id) {
+            if (!reachable_ids.contains(id)) {
+                continue;
+            }
+            new_ids[id] = next_id++;
+            if (blocks[id].fallthrough_dest != INVALID_BLOCK_ID) {
+                MONAD_VM_DEBUG_ASSERT(blocks[id].fallthrough_dest > id);
+                reachable_ids.insert(blocks[id].fallthrough_dest);
+            }
+        }
+        if (next_id == blocks.size()) {
+            return;
+        }
+
+        std::vector<Block> kept;
+        kept.reserve(next_id);
+        for (block_id id = 0; id < blocks.size(); ++id) {
+            if (new_ids[id] == INVALID_BLOCK_ID) {
+                continue;
+            }
+            auto &block = kept.emplace_back(std::move(blocks[id]));
+            if (block.fallthrough_dest != INVALID_BLOCK_ID) {
+                block.fallthrough_dest = new_ids[block.fallthrough_dest];
+                MONAD_VM_DEBUG_ASSERT(
+                    block.fallthrough_dest == new_ids[id] + 1);
+            }
+        }
+        blocks = std::move(kept);
+        for (auto &[_, id] : ir.jump_dests()) {
+            id = new_ids[id];
+        }
+    }
+}
+
+namespace monad::vm::compiler::basic_blocks
+{
+    void simplify_blocks(BasicBlocksIR &ir, bool fold, bool eliminate)
+    {
+        for (auto &block : ir.blocks()) {
+            simplify_block(block, fold, eliminate);
+        }
+    }
+
+    void resolve_known_jumps(
+        BasicBlocksIR &ir, std::uint32_t jumpi_gas, std::uint32_t jump_gas)
+    {
+        bool resolved = false;
+        for (auto &block : ir.blocks()) {
+            auto const &instrs = block.instrs;
+            if (block.terminator != Terminator::JumpI || instrs.size() < 2 ||
+                !is_push(instrs.back()) ||
+                !is_push(instrs[instrs.size() - 2])) {
+                continue;
+            }
+            Block jump{block};
+            auto const &cond = jump.instrs[jump.instrs.size() - 2];
+            if (cond.immediate_value() == 0) {
+                // The jump is never taken, and `JUMPI` does not validate the
+                // destination in this case.
+                jump.extra_gas += cond.static_gas_cost() +
+                                  jump.instrs.back().static_gas_cost() +
+                                  jumpi_gas;
+                jump.instrs.erase(jump.instrs.end() - 2, jump.instrs.end());
+                jump.terminator = Terminator::FallThrough;
+            }
+            else {
+                jump.extra_gas += cond.static_gas_cost() + jumpi_gas - jump_gas;
+                jump.instrs.erase(jump.instrs.end() - 2);
+                jump.terminator = Terminator::Jump;
+                jump.fallthrough_dest = INVALID_BLOCK_ID;
+            }
+            replace_block(block, std::move(jump));
+            resolved = true;
+        }
+        if (resolved) {
+            remove_unreachable_blocks(ir);
+        }
+    }
+
+    void merge_jumpdest_gas_checks(BasicBlocksIR &ir)
+    {
+        auto &blocks = ir.blocks();
+
+        // Jump destinations can only be dropped if every jump destination
+        // is known statically.
+        std::unordered_set<byte_offset> targets;
+        for (auto const &block : blocks) {
+            if (block.terminator != Terminator::Jump &&
+                block.terminator != Terminator::JumpI) {
+                continue;
+            }
+            if (block.instrs.empty() || !is_push(block.instrs.back())) {
+                return;
+            }
+            auto const &dest = block.instrs.back().immediate_value();
+            if (dest < *ir.codesize && ir.jump_dests().contains(dest[0])) {
+                targets.insert(static_cast<byte_offset>(dest[0]));
+            }
+        }
+
+        std::vector<block_id> dropped;
+        for (auto const &[offset, id] : ir.jump_dests()) {
+            if (!targets.contains(offset)) {
+                dropped.push_back(id);
+            }
+        }
+        if (dropped.empty()) {
+            return;
+        }
+        std::sort(dropped.begin(), dropped.end());
+        for (block_id const id : dropped) {
+            auto &block = blocks[id];
+            ir.jump_dests().erase(block.offset);
+            // The `JUMPDEST` gas is charged before the first instruction
+            // of the block.
+            if (block.instrs.empty()) {
+                block.extra_gas += 1;
+            }
+            else {
+                block.instrs.front().add_static_gas_cost(1);
+            }
+        }
+
+        // Merge a block into its fall through predecessor if that does not
+        // move the stack bound checks of the block before the instructions
+        // of the predecessor. The predecessor may itself have been merged.
+        std::vector<block_id> merged_into(blocks.size());
+        for (block_id id = 0; id < blocks.size(); ++id) {
+            merged_into[id] = id;
+        }
+        for (block_id const id : dropped) {
+            if (id == 0) {
+                continue;
+            }
+            auto &pred = blocks[merged_into[id - 1]];
+            auto &block = blocks[id];
+            if (pred.terminator != Terminator::FallThrough ||
+                pred.fallthrough_dest != id) {
+                continue;
+            }
+            auto const [pred_min, pred_delta, pred_max] = pred.stack_deltas();
+            auto const [min, delta, max] = block.stack_deltas();
+            if (pred_delta + min < pred_min || pred_delta + max > pred_max) {
+                continue;
+            }
+            // The extra gas of the predecessor is charged after its last
+            // instruction, so it moves to the first instruction of `block`.
+            if (block.instrs.empty()) {
+                block.extra_gas += pred.extra_gas;
+            }
+            else {
+                block.instrs.front().add_static_gas_cost(pred.extra_gas);
+            }
+            pred.instrs.insert(
+                pred.instrs.end(),
+                block.instrs.begin(),
+                block.instrs.end());
+            pred.terminator = block.terminator;
+            pred.extra_gas = block.extra_gas;
+            // The merged block is removed as unreachable below, and the
+            // predecessor now falls through to the successor of `block`.
+            pred.fallthrough_dest = block.fallthrough_dest;
+            block.instrs.clear();
+            block.terminator = Terminator::Stop;
+            block.fallthrough_dest = INVALID_BLOCK_ID;
+            block.extra_gas = 0;
+            merged_into[id] = merged_into[id - 1];
+        }
+        remove_unreachable_blocks(ir);
+    }
+
+    std::vector<std::uint16_t> operand_bit_bounds(Block const &block)
+    {
+        std::vector<std::uint16_t> bounds;
+        bounds.reserve(block.instrs.size());
+        // Bounds of the stack elements computed in the block, top last.
+        // Stack elements below are block parameters, bounded by 256 bits.
+        std::vector<std::uint16_t> stack;
+        auto const at = [&](std::size_t i) {
+            return i < stack.size() ? stack[stack.size() - 1 - i] : max_bits;
+        };
+        for (auto const &instr : block.instrs) {
+            std::size_t const args = instr.stack_args();
+            std::array<std::uint16_t, 7> in;
+            in.fill(max_bits);
+            std::uint16_t bound = 0;
+            for (std::size_t i = 0; i < args; ++i) {
+                auto const b = at(i);
+                if (i < in.size()) {
+                    in[i] = b;
+                }
+                bound = std::max(bound, b);
+            }
+            bounds.push_back(bound);
+            std::size_t const n = instr.index();
+            switch (instr.opcode()) {
+            case OpCode::Dup:
+                stack.push_back(at(n - 1));
+                break;
+            case OpCode::Swap: {
+                auto const top = at(0);
+                auto const other = at(n);
+                if (stack.size() <= n) {
+                    stack.insert(stack.begin(), n + 1 - stack.size(), max_bits);
+                }
+                stack[stack.size() - 1] = other;
+                stack[stack.size() - 1 - n] = top;
+                break;
+            }
+            default: {
+                auto const result = result_bit_bound(instr, in.data());
+                stack.resize(stack.size() - std::min(args, stack.size()));
+                if (instr.increases_stack()) {
+                    stack.push_back(result);
+                }
+                break;
+            }
+            }
+        }
+        return bounds;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/evm/traits.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Optimization passes on the basic blocks IR, run before native code
+ * emission. Every pass preserves the observable behaviour of the program:
+ * the gas charged by each block and the gas remaining before each
+ * instruction are unchanged, and rewritten blocks keep their stack deltas,
+ * so that stack underflow and overflow errors are detected at the same
+ * point.
+ */
+namespace monad::vm::compiler::basic_blocks
+{
+    struct PassConfig
+    {
+        /// Evaluate pure instructions with literal arguments, and `DUP` and
+        /// `SWAP` instructions on literals.
+        bool fold_constants{};
+        /// Remove `PUSH POP`, `DUP POP` and `SWAPn SWAPn` sequences.
+        bool eliminate_dead_stack_ops{};
+        /// Turn `JUMPI` with a literal condition into `JUMP` or fall
+        /// through, and remove blocks which become unreachable.
+        bool resolve_known_jumps{};
+        /// If all jumps have literal destinations, drop the jump
+        /// destinations which are never jumped to, and merge their blocks
+        /// into the fall through predecessor, so that one gas check covers
+        /// both blocks.
+        bool merge_jumpdest_gas_checks{};
+
+        bool any() const
+        {
+            return fold_constants || eliminate_dead_stack_ops ||
+                   resolve_known_jumps || merge_jumpdest_gas_checks;
+        }
+    };
+
+    void simplify_blocks(BasicBlocksIR &, bool fold, bool eliminate);
+
+    void resolve_known_jumps(
+        BasicBlocksIR &, std::uint32_t jumpi_gas, std::uint32_t jump_gas);
+
+    void merge_jumpdest_gas_checks(BasicBlocksIR &);
+
+    /// Upper bounds on the number of significant bits of the stack inputs
+    /// of the instructions of a block. Entry `i` bounds every stack input
+    /// of `block.instrs[i]`. The bounds follow from literals and from
+    /// instructions with small results, like comparisons and sizes, so a
+    /// block parameter is bounded by 256 bits. Unlike the passes above,
+    /// this analysis does not change the block.
+    std::vector<std::uint16_t> operand_bit_bounds(Block const &);
+
+    template <Traits traits>
+    void run_passes(BasicBlocksIR &ir, PassConfig const &config)
+    {
+        if (config.fold_constants || config.eliminate_dead_stack_ops) {
+            simplify_blocks(
+                ir, config.fold_constants, config.eliminate_dead_stack_ops);
+        }
+        if (config.resolve_known_jumps) {
+            resolve_known_jumps(
+                ir,
+                terminator_static_gas<traits>(Terminator::JumpI),
+                terminator_static_gas<traits>(Terminator::Jump));
+        }
+        if (config.merge_jumpdest_gas_checks) {
+            merge_jumpdest_gas_checks(ir);
+        }
+        MONAD_VM_DEBUG_ASSERT(ir.is_valid());
+    }
+}
@@ -15,6 +15,8 @@
 
 #include <category/vm/compiler/ir/basic_blocks.hpp>
 #include <category/vm/compiler/ir/instruction.hpp>
+#include <category/vm/compiler/ir/local_stacks.hpp>
+#include <category/vm/compiler/ir/passes.hpp>
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/compiler/ir/x86/emitter.hpp>
 #include <category/vm/compiler/ir/x86/types.hpp>
@@ -29,10 +31,18 @@
 
 #include <quill/Quill.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 using namespace monad::vm::compiler;
 using namespace monad::vm::compiler::basic_blocks;
@@ -45,12 +55,13 @@ namespace
 
     template <Traits traits>
     void emit_instr(
-        Emitter &emit, Instruction const &instr, int64_t remaining_base_gas)
+        Emitter &emit, Instruction const &instr, int64_t remaining_base_gas,
+        std::uint16_t operand_bits)
     {
         using enum OpCode;
         switch (instr.opcode()) {
         case Add:
-            emit.add();
+            emit.add(operand_bits);
             break;
         case Mul:
             emit.mul(remaining_base_gas);
@@ -101,13 +112,13 @@ namespace
             emit.iszero();
             break;
         case And:
-            emit.and_();
+            emit.and_(operand_bits);
             break;
         case Or:
-            emit.or_();
+            emit.or_(operand_bits);
             break;
         case XOr:
-            emit.xor_();
+            emit.xor_(operand_bits);
             break;
         case Not:
             emit.not_();
@@ -324,11 +335,14 @@ namespace
         native_code_size_t max_native_size, CompilerConfig const &config)
     {
         int64_t remaining_base_gas = instr_gas;
-        for (auto const &instr : block.instrs) {
+        auto const operand_bits = operand_bit_bounds(block);
+        for (size_t i = 0; i < block.instrs.size(); ++i) {
+            auto const &instr = block.instrs[i];
             MONAD_VM_DEBUG_ASSERT(
                 remaining_base_gas >= instr.static_gas_cost());
             remaining_base_gas -= instr.static_gas_cost();
-            emit_instr<traits>(emit, instr, remaining_base_gas);
+            emit_instr<traits>(
+                emit, instr, remaining_base_gas, operand_bits[i]);
             require_code_size_in_bound(emit, max_native_size);
             post_instruction_emit(emit, config);
         }
@@ -371,25 +385,341 @@ namespace
         }
     }
 
+    /// The block a `JUMP` or `JUMPI` terminated block jumps to, if its
+    /// destination is a literal pushed by the block.
+    std::optional<block_id>
+    static_jump_dest(BasicBlocksIR const &ir, Block const &block)
+    {
+        if ((block.terminator != Terminator::Jump &&
+             block.terminator != Terminator::JumpI) ||
+            block.instrs.empty() ||
+            block.instrs.back().opcode() != OpCode::Push) {
+            return std::nullopt;
+        }
+        auto const &dest = block.instrs.back().immediate_value();
+        if (dest >= *ir.codesize) {
+            return std::nullopt;
+        }
+        auto const it = ir.jump_dests().find(dest[0]);
+        if (it == ir.jump_dests().end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// Placement of gas checks. A jump destination needs an unbounded
+    /// work gas check if it can be entered by a dynamic jump or by a
+    /// backward jump, because then it may be a loop header. Every other
+    /// block is only entered from blocks emitted before it, so the static
+    /// work since the last gas check is bounded by the maximum over its
+    /// predecessors, and the check can be hoisted to an earlier block.
+    class GasCheckPlan
+    {
+    public:
+        explicit GasCheckPlan(BasicBlocksIR const &ir)
+            : jump_preds_(ir.blocks().size())
+            , unbounded_check_(ir.blocks().size())
+            , exit_work_(ir.blocks().size())
+        {
+            auto const &blocks = ir.blocks();
+            bool dynamic_jumps = false;
+            for (block_id id = 0; id < blocks.size(); ++id) {
+                auto const &block = blocks[id];
+                if (block.terminator != Terminator::Jump &&
+                    block.terminator != Terminator::JumpI) {
+                    continue;
+                }
+                auto const dest = static_jump_dest(ir, block);
+                if (!dest) {
+                    bool const literal = !block.instrs.empty() &&
+                                         block.instrs.back().opcode() ==
+                                             OpCode::Push;
+                    // A literal invalid destination is a jump to the
+                    // error label.
+                    dynamic_jumps |= !literal;
+                    continue;
+                }
+                if (*dest <= id) {
+                    unbounded_check_[*dest] = true;
+                }
+                else {
+                    jump_preds_[*dest].push_back(id);
+                }
+            }
+            if (dynamic_jumps) {
+                for (auto const &[_, id] : ir.jump_dests()) {
+                    unbounded_check_[id] = true;
+                }
+            }
+            for (block_id id = 1; id < blocks.size(); ++id) {
+                if (blocks[id - 1].fallthrough_dest == id) {
+                    jump_preds_[id].push_back(id - 1);
+                }
+            }
+        }
+
+        bool needs_unbounded_check(block_id id) const
+        {
+            return unbounded_check_[id];
+        }
+
+        int64_t entry_work(block_id id) const
+        {
+            int64_t work = 0;
+            for (block_id const pred : jump_preds_[id]) {
+                work = std::max(work, exit_work_[pred]);
+            }
+            return work;
+        }
+
+        void set_exit_work(block_id id, int64_t work)
+        {
+            exit_work_[id] = work;
+        }
+
+    private:
+        std::vector<std::vector<block_id>> jump_preds_;
+        std::vector<bool> unbounded_check_;
+        std::vector<int64_t> exit_work_;
+    };
+
+    /// Stack elements holding the same literal on every path into a
+    /// block, found by propagating the local stacks of the blocks along
+    /// the control flow edges until a fixed point. A jump to a destination
+    /// computed at runtime is a dynamic jump, which may enter any jump
+    /// destination with arbitrary stack elements. A jump to a block
+    /// parameter holding a literal, like a return address pushed by the
+    /// caller of an internal function, is a static edge.
+    class EntryLiterals
+    {
+    public:
+        /// The number of stack elements tracked on block entry, which
+        /// covers the stack elements reachable by `DUP16` and `SWAP16`.
+        static constexpr std::size_t tracked_count = 17;
+
+        explicit EntryLiterals(BasicBlocksIR const &ir)
+            : ir_{ir}
+            , entries_(ir_.blocks.size())
+        {
+            std::vector<block_id> work;
+            join(0, Entry(tracked_count), work);
+            bool dynamic_jumps = false;
+            while (!work.empty()) {
+                block_id const id = work.back();
+                work.pop_back();
+                auto const &block = ir_.blocks[id];
+                auto const inputs = terminator_inputs(block.terminator);
+                if (block.terminator == Terminator::Jump ||
+                    block.terminator == Terminator::JumpI) {
+                    auto const dest = value(id, 0);
+                    if (!dest) {
+                        if (!dynamic_jumps) {
+                            dynamic_jumps = true;
+                            for (auto const &[_, d] : ir_.jumpdests) {
+                                join(d, Entry(tracked_count), work);
+                            }
+                        }
+                    }
+                    else if (*dest < *ir_.codesize) {
+                        auto const it = ir_.jumpdests.find((*dest)[0]);
+                        if (it != ir_.jumpdests.end()) {
+                            join(it->second, successor_entry(id, inputs), work);
+                        }
+                    }
+                }
+                if (block.fallthrough_dest != INVALID_BLOCK_ID) {
+                    join(
+                        block.fallthrough_dest,
+                        successor_entry(id, inputs),
+                        work);
+                }
+            }
+        }
+
+        /// The literal held by the stack element at entry `index`, top
+        /// first, on every path into the block.
+        std::optional<uint256_t> literal(block_id id, std::size_t index) const
+        {
+            auto const &entry = entries_[id];
+            if (!entry || index >= entry->size()) {
+                return std::nullopt;
+            }
+            return (*entry)[index];
+        }
+
+    private:
+        /// Entry stack elements, top first, with `std::nullopt` for a
+        /// stack element which is not the same literal on every path.
+        using Entry = std::vector<std::optional<uint256_t>>;
+
+        /// The value of the `i`-th stack element, top first, at the end of
+        /// the block, including the inputs of the terminator.
+        std::optional<uint256_t> value(block_id id, std::size_t i) const
+        {
+            auto const &block = ir_.blocks[id];
+            std::size_t param;
+            if (i < block.output.size()) {
+                auto const &v = block.output[i];
+                if (v.is == local_stacks::ValueIs::LITERAL) {
+                    return v.literal;
+                }
+                if (v.is == local_stacks::ValueIs::COMPUTED) {
+                    return std::nullopt;
+                }
+                param = v.param;
+            }
+            else {
+                param = block.min_params + (i - block.output.size());
+            }
+            return literal(id, param);
+        }
+
+        Entry successor_entry(block_id id, std::size_t inputs) const
+        {
+            Entry entry(tracked_count);
+            for (std::size_t i = 0; i < tracked_count; ++i) {
+                entry[i] = value(id, inputs + i);
+            }
+            return entry;
+        }
+
+        void join(block_id id, Entry const &entry, std::vector<block_id> &work)
+        {
+            auto &current = entries_[id];
+            if (!current) {
+                current = entry;
+                work.push_back(id);
+                return;
+            }
+            bool changed = false;
+            for (std::size_t i = 0; i < tracked_count; ++i) {
+                if ((*current)[i] && (*current)[i] != entry[i]) {
+                    (*current)[i] = std::nullopt;
+                    changed = true;
+                }
+            }
+            if (changed) {
+                work.push_back(id);
+            }
+        }
+
+        local_stacks::LocalStacksIR ir_;
+        std::vector<std::optional<Entry>> entries_;
+    };
+
+    /// The blocks to compile under the budget of the interpreter fallback:
+    /// the blocks nearest to the contract entry, in breadth first order
+    /// over the control flow edges, until their bytecode size reaches the
+    /// budget. A dynamic jump may enter any jump destination. The entry
+    /// block is always compiled.
+    std::vector<bool>
+    compiled_blocks(BasicBlocksIR const &ir, code_size_t const budget)
+    {
+        auto const &blocks = ir.blocks();
+        std::vector<bool> compiled(blocks.size());
+        std::vector<bool> seen(blocks.size());
+        std::deque<block_id> work;
+        auto const visit = [&](block_id id) {
+            if (!seen[id]) {
+                seen[id] = true;
+                work.push_back(id);
+            }
+        };
+        visit(0);
+        bool dynamic_jumps = false;
+        std::size_t used = 0;
+        while (!work.empty()) {
+            block_id const id = work.front();
+            work.pop_front();
+            auto const &block = blocks[id];
+            std::size_t const end = id + 1 < blocks.size()
+                                        ? blocks[id + 1].offset
+                                        : std::size_t{*ir.codesize};
+            std::size_t const size = end - block.offset;
+            if (id != 0 && used + size > *budget) {
+                break;
+            }
+            compiled[id] = true;
+            used += size;
+            if (block.fallthrough_dest != INVALID_BLOCK_ID) {
+                visit(block.fallthrough_dest);
+            }
+            if (block.terminator != Terminator::Jump &&
+                block.terminator != Terminator::JumpI) {
+                continue;
+            }
+            if (auto const dest = static_jump_dest(ir, block)) {
+                visit(*dest);
+            }
+            else if (
+                !dynamic_jumps &&
+                (block.instrs.empty() ||
+                 block.instrs.back().opcode() != OpCode::Push)) {
+                dynamic_jumps = true;
+                for (block_id d = 0; d < blocks.size(); ++d) {
+                    if (ir.jump_dests().contains(blocks[d].offset)) {
+                        visit(d);
+                    }
+                }
+            }
+        }
+        return compiled;
+    }
+
     void emit_gas_decrement(
-        Emitter &emit, BasicBlocksIR const &ir, Block const &block,
-        int64_t block_base_gas)
+        Emitter &emit, BasicBlocksIR const &ir, GasCheckPlan const &plan,
+        block_id id, int64_t block_base_gas)
     {
-        if (ir.jump_dests().contains(block.offset)) {
-            emit.gas_decrement_unbounded_work(block_base_gas + 1);
+        Block const &block = ir.block(id);
+        int64_t const gas =
+            block_base_gas + ir.jump_dests().contains(block.offset);
+        if (plan.needs_unbounded_check(id)) {
+            emit.gas_decrement_unbounded_work(gas);
         }
         else {
-            emit.gas_decrement_static_work(block_base_gas);
+            emit.gas_decrement_static_work(gas, plan.entry_work(id));
         }
     }
 
+    // Adds the time since the previous lap to a phase of `times`, if set.
+    class PhaseTimer
+    {
+    public:
+        explicit PhaseTimer(CompilePhaseTimes *const times)
+            : times_{times}
+        {
+            if (times_) {
+                last_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        void lap(std::chrono::nanoseconds CompilePhaseTimes::*const phase)
+        {
+            if (times_) {
+                auto const now = std::chrono::steady_clock::now();
+                times_->*phase += now - last_;
+                last_ = now;
+            }
+        }
+
+    private:
+        CompilePhaseTimes *times_;
+        std::chrono::steady_clock::time_point last_{};
+    };
+
     template <Traits traits>
     std::shared_ptr<Nativecode> compile_contract(
         asmjit::JitRuntime &rt, std::uint8_t const *contract_code,
         code_size_t contract_code_size, CompilerConfig const &config)
     {
+        PhaseTimer timer{config.phase_times};
         auto ir =
             basic_blocks::make_ir<traits>(contract_code, contract_code_size);
+        timer.lap(&CompilePhaseTimes::basic_blocks);
+        if (config.ir_passes.any()) {
+            basic_blocks::run_passes<traits>(ir, config.ir_passes);
+            timer.lap(&CompilePhaseTimes::ir_passes);
+        }
         return compile_basic_blocks<traits>(rt, ir, config);
     }
 }
@@ -426,17 +756,81 @@ namespace monad::vm::compiler::native
         asmjit::JitRuntime &rt, basic_blocks::BasicBlocksIR const &ir,
         CompilerConfig const &config)
     {
+        PhaseTimer timer{config.phase_times};
         Emitter emit{rt, ir.codesize, config};
         for (auto const &[d, _] : ir.jump_dests()) {
             emit.add_jump_dest(d);
         }
+        // Under a budget, the blocks which are not compiled resume in the
+        // interpreter.
+        std::vector<bool> compiled(ir.blocks().size(), true);
+        bool partial = false;
+        if (config.interpreter_fallback) {
+            compiled = compiled_blocks(
+                ir, config.interpreter_fallback->compiled_bytecode_budget);
+            for (block_id id = 0; id < ir.blocks().size(); ++id) {
+                if (!compiled[id]) {
+                    emit.add_fallback_block(ir.block(id).offset);
+                    partial = true;
+                }
+            }
+        }
+        // Loop headers entered by a static back-edge jump receive the
+        // loop-carried stack elements in AVX registers.
+        constexpr std::int32_t max_register_entry_count = 4;
+        for (Block const &block : ir.blocks()) {
+            if (block.terminator != Terminator::Jump) {
+                continue;
+            }
+            auto const dest_id = static_jump_dest(ir, block);
+            if (!dest_id || !compiled[*dest_id]) {
+                continue;
+            }
+            Block const &dest = ir.block(*dest_id);
+            if (dest.offset > block.offset) {
+                continue;
+            }
+            auto const min_delta = std::get<0>(dest.stack_deltas());
+            auto const count = std::min(max_register_entry_count, -min_delta);
+            if (count > 0) {
+                emit.add_register_entry(
+                    dest.offset, static_cast<std::uint8_t>(count));
+            }
+        }
+        // Block parameters holding the same literal on every path into the
+        // block fold into immediates and resolve jumps to return addresses
+        // statically, like literals pushed in the block itself.
+        EntryLiterals const entry_literals{ir};
+        for (block_id id = 0; id < ir.blocks().size(); ++id) {
+            if (!compiled[id]) {
+                continue;
+            }
+            Block const &block = ir.block(id);
+            auto const count = std::min(
+                EntryLiterals::tracked_count,
+                static_cast<std::size_t>(-std::get<0>(block.stack_deltas())));
+            for (std::size_t i = 0; i < count; ++i) {
+                if (auto const lit = entry_literals.literal(id, i)) {
+                    emit.add_literal_entry(
+                        block.offset, -1 - static_cast<std::int32_t>(i), *lit);
+                }
+            }
+        }
         native_code_size_t const max_native_size =
             max_code_size(config.max_code_size_offset, ir.codesize);
-        for (Block const &block : ir.blocks()) {
+        GasCheckPlan gas_checks{ir};
+        for (block_id id = 0; id < ir.blocks().size(); ++id) {
+            Block const &block = ir.block(id);
+            if (!compiled[id]) {
+                emit.fallback_block(block);
+                require_code_size_in_bound(emit, max_native_size);
+                continue;
+            }
             bool const can_enter_block = emit.begin_new_block(block);
             if (can_enter_block) {
                 int64_t const base_gas = block_base_gas<traits>(block);
-                emit_gas_decrement(emit, ir, block, base_gas);
+                emit_gas_decrement(emit, ir, gas_checks, id, base_gas);
+                gas_checks.set_exit_work(id, emit.accumulated_static_work());
                 emit_instrs<traits>(
                     emit, block, base_gas, max_native_size, config);
                 emit_terminator<traits>(emit, ir, block);
@@ -444,14 +838,26 @@ namespace monad::vm::compiler::native
             require_code_size_in_bound(emit, max_native_size);
         }
         size_t const size_estimate = emit.estimate_size();
+        timer.lap(&CompilePhaseTimes::emit);
         auto entry = emit.finish_contract(rt);
+        timer.lap(&CompilePhaseTimes::finalize);
         MONAD_VM_DEBUG_ASSERT(size_estimate <= *max_native_size);
+        auto const code_size_estimate = native_code_size_t::unsafe_from(
+            static_cast<uint32_t>(size_estimate));
+        if (config.code_image_hook) {
+            config.code_image_hook(emit.code_image(entry, code_size_estimate));
+        }
+        std::shared_ptr<void const> fallback_code;
+        if (partial) {
+            fallback_code = config.interpreter_fallback->intercode;
+        }
         return std::make_shared<Nativecode>(
             rt,
             traits::id(),
             entry,
-            native_code_size_t::unsafe_from(
-                static_cast<uint32_t>(size_estimate)));
+            code_size_estimate,
+            nullptr,
+            std::move(fallback_code));
     }
 
     EXPLICIT_TRAITS(compile_basic_blocks);
@@ -314,6 +314,12 @@ namespace monad::vm::compiler::native
         return data_;
     }
 
+    std::vector<int32_t> const &
+    Emitter::RoData::external_function_offsets() const
+    {
+        return external_function_offsets_;
+    }
+
     asmjit::x86::Mem Emitter::RoData::add_literal(Literal const &lit)
     {
         return add32(lit.value);
@@ -324,7 +330,17 @@ namespace monad::vm::compiler::native
     {
         static_assert(sizeof(F) == sizeof(uint64_t));
         static_assert(alignof(F) == alignof(uint64_t));
-        return add8(reinterpret_cast<uint64_t>(f));
+        std::array<uint8_t, 8> x;
+        auto const p = reinterpret_cast<uint64_t>(f);
+        std::memcpy(x.data(), &p, 8);
+        // Function addresses are deduplicated separately from literals, so
+        // that relocating a code image never rewrites a literal.
+        auto const n = external_sub8_.offmap.size();
+        auto m = add<8>(x, external_sub8_);
+        if (external_sub8_.offmap.size() != n) {
+            external_function_offsets_.push_back(m.offsetLo32());
+        }
+        return m;
     }
 
     asmjit::x86::Mem Emitter::RoData::add32(uint256_t const &x)
@@ -373,18 +389,6 @@ namespace monad::vm::compiler::native
     template <size_t N>
     asmjit::x86::Mem Emitter::RoData::add(std::array<uint8_t, N> const &x)
     {
-        // We need `data_` size upper bounded to not overflow `int32_t`
-        // i.e. estimate_size() < std::numeric_limits<int32_t>::max()
-        if (MONAD_VM_UNLIKELY(data_.size() >= (1 << 26))) {
-            throw Nativecode::SizeEstimateOutOfBounds{estimate_size()};
-        }
-
-        static_assert(4 <= N && N <= 16);
-        static_assert(std::popcount(N) == 1);
-        static constexpr int32_t n = static_cast<int32_t>(N);
-        static constexpr int32_t align = std::min(8, n);
-        static constexpr int32_t align_mask = align - 1;
-
         RoSubdata<N> &sub = [this] -> RoSubdata<N> & {
             if constexpr (N == 4) {
                 return sub4_;
@@ -396,6 +400,24 @@ namespace monad::vm::compiler::native
                 return sub16_;
             }
         }();
+        return add(x, sub);
+    }
+
+    template <size_t N>
+    asmjit::x86::Mem Emitter::RoData::add(
+        std::array<uint8_t, N> const &x, RoSubdata<N> &sub)
+    {
+        // We need `data_` size upper bounded to not overflow `int32_t`
+        // i.e. estimate_size() < std::numeric_limits<int32_t>::max()
+        if (MONAD_VM_UNLIKELY(data_.size() >= (1 << 26))) {
+            throw Nativecode::SizeEstimateOutOfBounds{estimate_size()};
+        }
+
+        static_assert(4 <= N && N <= 16);
+        static_assert(std::popcount(N) == 1);
+        static constexpr int32_t n = static_cast<int32_t>(N);
+        static constexpr int32_t align = std::min(8, n);
+        static constexpr int32_t align_mask = align - 1;
 
         int32_t next_partial_index = partial_index_;
         // Align `partial_sub_index_` by `align`:
@@ -588,6 +610,7 @@ namespace monad::vm::compiler::native
         asmjit::JitRuntime const &rt, interpreter::code_size_t codesize,
         CompilerConfig const &config)
         : runtime_debug_trace_{config.runtime_debug_trace}
+        , record_block_offsets_{config.record_block_offsets}
         , as_{init_code_holder(rt, config.asm_log_path)}
         , epilogue_label_{as_.newNamedLabel("ContractEpilogue")}
         , error_label_{as_.newNamedLabel("Error")}
@@ -595,9 +618,11 @@ namespace monad::vm::compiler::native
         , keep_stack_in_next_block_{}
         , gpq256_regs_{Gpq256{x86::r12, x86::r13, x86::r14, x86::r15}, Gpq256{x86::r8, x86::r9, x86::r10, x86::r11}, Gpq256{x86::rcx, x86::rsi, x86::rdx, x86::rdi}}
         , bytecode_size_{codesize}
+        , interpreter_fallback_{config.interpreter_fallback}
         , rodata_{as_.newNamedLabel("ROD")}
         , exponential_constant_fold_counter_{0}
         , accumulated_static_work_{0}
+        , blocks_end_{0}
     {
 #ifdef MONAD_VM_TESTING
         as_.addDiagnosticOptions(kValidateAssembler);
@@ -623,6 +648,7 @@ namespace monad::vm::compiler::native
 
     entrypoint_t Emitter::finish_contract(asmjit::JitRuntime &rt)
     {
+        blocks_end_ = static_cast<uint32_t>(as_.offset());
         contract_epilogue();
 
         for (auto const &[lbl, fn, back] : load_bounded_le_handlers_) {
@@ -706,6 +732,31 @@ namespace monad::vm::compiler::native
         return contract_main;
     }
 
+    CodeImage Emitter::code_image(
+        entrypoint_t const entry, native_code_size_t const size_estimate) const
+    {
+        std::vector<uint32_t> offsets;
+        auto const &ext_offsets = rodata_.external_function_offsets();
+        if (!ext_offsets.empty()) {
+            uint64_t const ro_offset =
+                code_holder_.labelOffsetFromBase(rodata_.label());
+            offsets.reserve(ext_offsets.size());
+            for (int32_t const x : ext_offsets) {
+                uint64_t const offset = ro_offset + static_cast<uint64_t>(x);
+                offsets.push_back(static_cast<uint32_t>(offset));
+            }
+        }
+        return CodeImage{
+            .code =
+                {reinterpret_cast<uint8_t const *>(entry),
+                 code_holder_.codeSize()},
+            .external_function_offsets = std::move(offsets),
+            .code_size_estimate = size_estimate,
+            .block_offsets = block_offsets_,
+            .blocks_end = blocks_end_,
+            .relocatable = fallback_blocks_.empty()};
+    }
+
     asmjit::CodeHolder *Emitter::init_code_holder(
         asmjit::JitRuntime const &rt, char const *log_path)
     {
@@ -995,20 +1046,105 @@ namespace monad::vm::compiler::native
         jump_dests_.emplace(d, as_.newNamedLabel(name, size));
     }
 
+    void
+    Emitter::add_register_entry(byte_offset d, std::uint8_t avx_reg_count)
+    {
+        MONAD_VM_DEBUG_ASSERT(jump_dests_.contains(d));
+        // Passing the registers needs as many temporary registers, which
+        // must not overlap with the source and destination registers.
+        MONAD_VM_ASSERT(
+            avx_reg_count > 0 && 3 * avx_reg_count <= AVX_REG_COUNT);
+        if (runtime_debug_trace_) {
+            // The trace in the block prologue needs the stack elements to
+            // be located before the registers are loaded.
+            return;
+        }
+        register_entries_.emplace(d, std::pair{as_.newLabel(), avx_reg_count});
+    }
+
+    void Emitter::add_literal_entry(
+        byte_offset d, std::int32_t stack_index, uint256_t const &value)
+    {
+        MONAD_VM_DEBUG_ASSERT(stack_index < 0);
+        literal_entries_[d].emplace_back(stack_index, value);
+    }
+
+    void Emitter::add_fallback_block(byte_offset d)
+    {
+        MONAD_VM_ASSERT(interpreter_fallback_.has_value());
+        MONAD_VM_DEBUG_ASSERT(!register_entries_.contains(d));
+        fallback_blocks_.insert(d);
+    }
+
     bool Emitter::begin_new_block(basic_blocks::Block const &b)
     {
         if (debug_logger_.file()) {
             unchecked_debug_comment(std::format("{}", b));
         }
+        if (record_block_offsets_) {
+            block_offsets_.push_back(
+                BlockOffset{
+                    .bytecode_offset = static_cast<uint32_t>(b.offset),
+                    .native_offset = static_cast<uint32_t>(as_.offset())});
+        }
         if (keep_stack_in_next_block_) {
+            MONAD_VM_DEBUG_ASSERT(!register_entries_.contains(b.offset));
             stack_.continue_block(b);
         }
+        else if (auto it = register_entries_.find(b.offset);
+                 it != register_entries_.end()) {
+            stack_.begin_new_block(b, it->second.second);
+        }
         else {
             stack_.begin_new_block(b);
+            if (auto it = literal_entries_.find(b.offset);
+                it != literal_entries_.end()) {
+                for (auto const &[stack_index, value] : it->second) {
+                    stack_.insert_entry_literal(stack_index, value);
+                }
+            }
         }
         return block_prologue(b);
     }
 
+    void Emitter::fallback_block(basic_blocks::Block const &b)
+    {
+        MONAD_VM_DEBUG_ASSERT(fallback_blocks_.contains(b.offset));
+        MONAD_VM_DEBUG_ASSERT(!keep_stack_in_next_block_);
+        if (debug_logger_.file()) {
+            unchecked_debug_comment(std::format("{} (interpreter)", b));
+        }
+        if (record_block_offsets_) {
+            block_offsets_.push_back(
+                BlockOffset{
+                    .bytecode_offset = static_cast<uint32_t>(b.offset),
+                    .native_offset = static_cast<uint32_t>(as_.offset())});
+        }
+        if (auto it = jump_dests_.find(b.offset); it != jump_dests_.end()) {
+            as_.bind(it->second);
+        }
+
+        // The predecessor may have deferred its gas check to this block,
+        // and the interpreter only checks the gas of its own instructions.
+        as_.cmp(
+            x86::qword_ptr(reg_context, runtime::context_offset_gas_remaining),
+            0);
+        as_.jl(error_label_);
+
+        auto const &fallback = *interpreter_fallback_;
+        auto const intercode_mem = rodata_.add8(
+            reinterpret_cast<uint64_t>(fallback.intercode.get()));
+        auto const fn_mem = rodata_.add_external_function(fallback.resume);
+        as_.mov(x86::rdi, reg_context);
+        as_.mov(x86::rsi, reg_stack);
+        as_.mov(x86::rdx, x86::qword_ptr(x86::rsp, sp_offset_stack_size));
+        as_.mov(x86::rcx, intercode_mem);
+        as_.mov(x86::r8, b.offset);
+        as_.vzeroupper();
+        as_.call(fn_mem);
+        as_.int3();
+    }
+
     void Emitter::gas_decrement_static_work(int64_t gas)
     {
         if (gas) {
@@ -1019,6 +1155,14 @@ namespace monad::vm::compiler::native
         }
     }
 
+    void Emitter::gas_decrement_static_work(int64_t gas, int64_t entry_work)
+    {
+        MONAD_VM_DEBUG_ASSERT(
+            entry_work >= 0 && entry_work < STATIC_WORK_GAS_CHECK_THRESHOLD);
+        accumulated_static_work_ = entry_work;
+        gas_decrement_static_work(gas);
+    }
+
     void Emitter::gas_decrement_unbounded_work(int64_t gas)
     {
         accumulated_static_work_ = 0;
@@ -1295,21 +1439,27 @@ namespace monad::vm::compiler::native
                 std::format("Block 0x{:02x}", b.offset));
         }
 
-        auto const min_delta = stack_.min_delta();
-        auto const max_delta = stack_.max_delta();
-        if (min_delta < -1024 || max_delta > 1024) {
+        auto const entry = register_entries_.find(b.offset);
+        if (stack_.min_delta() < -1024 || stack_.max_delta() > 1024) {
+            if (entry != register_entries_.end()) {
+                as_.bind(entry->second.first);
+            }
             as_.jmp(error_label_);
             return false;
         }
-        auto const size_mem = x86::qword_ptr(x86::rsp, sp_offset_stack_size);
-        if (stack_.did_min_delta_decrease()) {
-            as_.cmp(size_mem, -min_delta);
-            as_.jb(error_label_);
-        }
-        if (stack_.did_max_delta_increase()) {
-            as_.cmp(size_mem, 1024 - max_delta);
-            as_.ja(error_label_);
+        if (entry != register_entries_.end()) {
+            // Entering from the jump table or by falling through, so load
+            // the stack elements the register entry passes in AVX
+            // registers. The stack size is checked before loading them.
+            emit_stack_bound_checks();
+            for (std::uint8_t i = 0; i < entry->second.second; ++i) {
+                as_.vmovaps(
+                    avx_reg_to_ymm(AvxReg{i}),
+                    stack_offset_to_mem(StackOffset{-1 - i}));
+            }
+            as_.bind(entry->second.first);
         }
+        emit_stack_bound_checks();
 
         if (it != jump_dests_.end()) {
             runtime_store_input_stack(b.offset);
@@ -1318,6 +1468,19 @@ namespace monad::vm::compiler::native
         return true;
     }
 
+    void Emitter::emit_stack_bound_checks()
+    {
+        auto const size_mem = x86::qword_ptr(x86::rsp, sp_offset_stack_size);
+        if (stack_.did_min_delta_decrease()) {
+            as_.cmp(size_mem, -stack_.min_delta());
+            as_.jb(error_label_);
+        }
+        if (stack_.did_max_delta_increase()) {
+            as_.cmp(size_mem, 1024 - stack_.max_delta());
+            as_.ja(error_label_);
+        }
+    }
+
     template <bool preserve_eflags>
     void Emitter::adjust_by_stack_delta()
     {
@@ -1338,13 +1501,16 @@ namespace monad::vm::compiler::native
     }
 
     // Does not update eflags
-    void Emitter::write_to_final_stack_offsets()
+    void Emitter::write_to_final_stack_offsets(
+        std::int32_t const avx_reg_entry_index)
     {
         // Write stack elements to their final stack offsets before
         // leaving basic block. If stack element `e` is currently at
         // stack indices `0`, `1` and only located in an AVX register,
         // then we need to move the AVX register to both stack offsets
-        // `0` and `1`.
+        // `0` and `1`. Stack indices from `avx_reg_entry_index` are skipped,
+        // because a register entry receives their stack elements in AVX
+        // registers, see `jump_register_entry`.
 
         MONAD_VM_ASSERT(!stack_.has_deferred_comparison());
 
@@ -1429,7 +1595,7 @@ namespace monad::vm::compiler::native
                 continue;
             }
             int32_t const offset = d->stack_offset()->offset;
-            if (offset > top_index) {
+            if (offset > top_index || offset >= avx_reg_entry_index) {
                 continue;
             }
             auto *e = stack_.get(offset).get();
@@ -1495,7 +1661,7 @@ namespace monad::vm::compiler::native
                 }
             }
             // Move to remaining final stack offsets:
-            for (; it != is.end(); ++it) {
+            for (; it != is.end() && *it < avx_reg_entry_index; ++it) {
                 if (!d->stack_offset() || d->stack_offset()->offset != *it) {
                     as_.vmovaps(stack_offset_to_mem(StackOffset{*it}), yx1);
                     MONAD_COMPILER_X86_INC_FINAL_WRITE_COUNT();
@@ -1505,7 +1671,7 @@ namespace monad::vm::compiler::native
             // `d`, if such stack element exists.
             if (!d->avx_reg() && d->stack_offset()) {
                 int32_t const i = d->stack_offset()->offset;
-                if (i > stack_.top_index()) {
+                if (i > stack_.top_index() || i >= avx_reg_entry_index) {
                     continue;
                 }
                 StackElem *e = stack_.get(i).get();
@@ -1597,8 +1763,16 @@ namespace monad::vm::compiler::native
         }
 
 #ifdef MONAD_COMPILER_TESTING
+        size_t skipped_write_count = 0;
+        for (int32_t i = std::max(avx_reg_entry_index, min_delta);
+             i <= top_index;
+             ++i) {
+            auto const e = stack_.get(i);
+            skipped_write_count +=
+                !e->stack_offset() || e->stack_offset()->offset != i;
+        }
         MONAD_VM_ASSERT(
-            MONAD_COMPILER_X86_FINAL_WRITE_COUNT ==
+            MONAD_COMPILER_X86_FINAL_WRITE_COUNT + skipped_write_count ==
             stack_.missing_spill_count());
 #endif
     }
@@ -2378,17 +2552,28 @@ namespace monad::vm::compiler::native
 
     // Discharge through `add` overload
     void Emitter::add()
+    {
+        add(256);
+    }
+
+    // Discharge through `add` overload
+    void Emitter::add(std::uint16_t const operand_bits)
     {
         auto left = stack_.pop();
         auto right = stack_.pop();
-        stack_.push(add(std::move(left), std::move(right), {}));
+        // The carry out of the low limbs is zero if the sum fits in them.
+        stack_.push(add(
+            std::move(left),
+            std::move(right),
+            {},
+            limb_count(size_t{operand_bits} + 1)));
     }
 
     // Discharge
     template <typename... LiveSet>
     StackElemRef Emitter::add(
         StackElemRef pre_dst, StackElemRef pre_src,
-        std::tuple<LiveSet...> const &live)
+        std::tuple<LiveSet...> const &live, size_t const limbs)
     {
         if (pre_dst->literal()) {
             if (pre_src->literal()) {
@@ -2415,9 +2600,13 @@ namespace monad::vm::compiler::native
             true, std::move(pre_dst), std::move(pre_src), live);
 
         GENERAL_BIN_INSTR(add, adc)
-        (dst, dst_loc, src, src_loc, [](size_t i, uint64_t x) {
-            return i == 0 && x == 0;
-        });
+        (
+            dst,
+            dst_loc,
+            src,
+            src_loc,
+            [](size_t i, uint64_t x) { return i == 0 && x == 0; },
+            limbs);
 
         return dst;
     }
@@ -2586,17 +2775,24 @@ namespace monad::vm::compiler::native
 
     // Discharge through `and_` overload
     void Emitter::and_()
+    {
+        and_(256);
+    }
+
+    // Discharge through `and_` overload
+    void Emitter::and_(std::uint16_t const operand_bits)
     {
         auto left = stack_.pop();
         auto right = stack_.pop();
-        stack_.push(and_(std::move(left), std::move(right), {}));
+        stack_.push(and_(
+            std::move(left), std::move(right), {}, limb_count(operand_bits)));
     }
 
     // Discharge
     template <typename... LiveSet>
     StackElemRef Emitter::and_(
         StackElemRef pre_dst, StackElemRef pre_src,
-        std::tuple<LiveSet...> const &live)
+        std::tuple<LiveSet...> const &live, size_t const limbs)
     {
         if (pre_dst->literal()) {
             if (pre_src->literal()) {
@@ -2638,26 +2834,40 @@ namespace monad::vm::compiler::native
                 std::move(pre_dst), std::move(pre_src), live);
 
         AVX_OR_GENERAL_BIN_INSTR(and_, vpand)
-        (dst, left, left_loc, right, right_loc, [](size_t, uint64_t x) {
-            return x == std::numeric_limits<uint64_t>::max();
-        });
+        (
+            dst,
+            left,
+            left_loc,
+            right,
+            right_loc,
+            [](size_t, uint64_t x) {
+                return x == std::numeric_limits<uint64_t>::max();
+            },
+            limbs);
 
         return dst;
     }
 
     // Discharge through `or_` overload
     void Emitter::or_()
+    {
+        or_(256);
+    }
+
+    // Discharge through `or_` overload
+    void Emitter::or_(std::uint16_t const operand_bits)
     {
         auto left = stack_.pop();
         auto right = stack_.pop();
-        stack_.push(or_(std::move(left), std::move(right), {}));
+        stack_.push(or_(
+            std::move(left), std::move(right), {}, limb_count(operand_bits)));
     }
 
     // Discharge
     template <typename... LiveSet>
     StackElemRef Emitter::or_(
         StackElemRef pre_dst, StackElemRef pre_src,
-        std::tuple<LiveSet...> const &live)
+        std::tuple<LiveSet...> const &live, size_t const limbs)
     {
         if (pre_dst->literal()) {
             if (pre_src->literal()) {
@@ -2701,26 +2911,38 @@ namespace monad::vm::compiler::native
                 std::move(pre_dst), std::move(pre_src), live);
 
         AVX_OR_GENERAL_BIN_INSTR(or_, vpor)
-        (dst, left, left_loc, right, right_loc, [](size_t, uint64_t x) {
-            return x == 0;
-        });
+        (
+            dst,
+            left,
+            left_loc,
+            right,
+            right_loc,
+            [](size_t, uint64_t x) { return x == 0; },
+            limbs);
 
         return dst;
     }
 
     // Discharge through `xor_` overload
     void Emitter::xor_()
+    {
+        xor_(256);
+    }
+
+    // Discharge through `xor_` overload
+    void Emitter::xor_(std::uint16_t const operand_bits)
     {
         auto left = stack_.pop();
         auto right = stack_.pop();
-        stack_.push(xor_(std::move(left), std::move(right), {}));
+        stack_.push(xor_(
+            std::move(left), std::move(right), {}, limb_count(operand_bits)));
     }
 
     // Discharge
     template <typename... LiveSet>
     StackElemRef Emitter::xor_(
         StackElemRef pre_dst, StackElemRef pre_src,
-        std::tuple<LiveSet...> const &live)
+        std::tuple<LiveSet...> const &live, size_t const limbs)
     {
         if (pre_dst == pre_src) {
             return stack_.alloc_literal({0});
@@ -2751,9 +2973,14 @@ namespace monad::vm::compiler::native
                 std::move(pre_dst), std::move(pre_src), live);
 
         AVX_OR_GENERAL_BIN_INSTR(xor_, vpxor)
-        (dst, left, left_loc, right, right_loc, [](size_t, uint64_t x) {
-            return x == 0;
-        });
+        (
+            dst,
+            left,
+            left_loc,
+            right,
+            right_loc,
+            [](size_t, uint64_t x) { return x == 0; },
+            limbs);
 
         return dst;
     }
@@ -3267,6 +3494,9 @@ namespace monad::vm::compiler::native
             RegReserv const e_reserv{e};
             discharge_deferred_comparison();
         }
+        if (e->literal() && jump_register_entry(e->literal()->value)) {
+            return;
+        }
         jump_stack_elem_dest(std::move(e), {});
     }
 
@@ -3283,6 +3513,7 @@ namespace monad::vm::compiler::native
         // the predecessor block.
         bool const spill_stack =
             jump_dests_.count(static_cast<byte_offset>(ft.offset)) ||
+            fallback_blocks_.contains(static_cast<byte_offset>(ft.offset)) ||
             (ft.terminator == basic_blocks::Terminator::JumpI &&
              stack_.missing_spill_count() > 3 + ft.instrs.size());
         if (spill_stack) {
@@ -3404,6 +3635,85 @@ namespace monad::vm::compiler::native
         as_.jmp(jump_dest_label(dest));
     }
 
+    bool Emitter::jump_register_entry(uint256_t const &dest)
+    {
+        if (dest >= *bytecode_size_) {
+            return false;
+        }
+        auto const it = register_entries_.find(dest[0]);
+        if (it == register_entries_.end()) {
+            return false;
+        }
+        auto const &[label, count] = it->second;
+        int32_t const n = count;
+        int32_t const entry_index = stack_.top_index() - n + 1;
+        if (entry_index < stack_.min_delta()) {
+            return false;
+        }
+
+        // Stack element at stack index `entry_index + k` is passed in
+        // `AvxReg{n - 1 - k}`, matching the prologue loads of the register
+        // entry.
+        std::vector<AvxRegReserv> reservs;
+        reservs.reserve(static_cast<size_t>(n));
+        for (int32_t j = 0; j < n; ++j) {
+            auto elem = stack_.get(stack_.top_index() - j);
+            mov_stack_elem_to_avx_reg(elem);
+            reservs.emplace_back(std::move(elem));
+        }
+        {
+            // Guarantee two free AVX registers, so that
+            // `write_to_final_stack_offsets` does not need to use the
+            // registers of the reserved stack elements for temporary values.
+            auto const t1 = alloc_avx_reg();
+            auto const t2 = alloc_avx_reg();
+        }
+        std::array<uint8_t, 4> srcs{};
+        MONAD_VM_DEBUG_ASSERT(n <= static_cast<int32_t>(srcs.size()));
+        for (int32_t j = 0; j < n; ++j) {
+            srcs[static_cast<size_t>(j)] =
+                stack_.get(stack_.top_index() - j)->avx_reg()->reg;
+        }
+        write_to_final_stack_offsets(entry_index);
+        adjust_by_stack_delta<false>();
+
+        // Parallel move of the source registers into the entry registers.
+        // The basic block ends here, so registers which are neither sources
+        // nor targets can be clobbered.
+        std::uint32_t used = 0;
+        for (int32_t j = 0; j < n; ++j) {
+            used |= 1u << srcs[static_cast<size_t>(j)];
+            used |= 1u << j;
+        }
+        std::array<uint8_t, 4> tmps{};
+        uint8_t next_tmp = 0;
+        for (int32_t j = 0; j < n; ++j) {
+            auto const k = static_cast<size_t>(j);
+            if (srcs[k] == j) {
+                continue;
+            }
+            while (used & (1u << next_tmp)) {
+                ++next_tmp;
+            }
+            MONAD_VM_DEBUG_ASSERT(next_tmp < AVX_REG_COUNT);
+            tmps[k] = next_tmp++;
+            as_.vmovaps(
+                avx_reg_to_ymm(AvxReg{tmps[k]}),
+                avx_reg_to_ymm(AvxReg{srcs[k]}));
+        }
+        for (int32_t j = 0; j < n; ++j) {
+            auto const k = static_cast<size_t>(j);
+            if (srcs[k] == j) {
+                continue;
+            }
+            as_.vmovaps(
+                avx_reg_to_ymm(AvxReg{static_cast<uint8_t>(j)}),
+                avx_reg_to_ymm(AvxReg{tmps[k]}));
+        }
+        as_.jmp(label);
+        return true;
+    }
+
     template <typename... LiveSet>
     std::pair<Emitter::Operand, std::optional<StackElem *>>
     Emitter::non_literal_jump_dest_operand(
@@ -5196,8 +5506,12 @@ namespace monad::vm::compiler::native
     void Emitter::general_bin_instr(
         StackElemRef dst, LocationType dst_loc, StackElemRef src,
         LocationType src_loc,
-        std::function<bool(size_t, uint64_t)> is_no_operation)
+        std::function<bool(size_t, uint64_t)> is_no_operation,
+        size_t const limbs)
     {
+        // The limbs from `limbs` on are zero in both operands and in the
+        // result.
+        MONAD_VM_DEBUG_ASSERT(limbs >= 1 && limbs <= 4);
         auto dst_op = get_operand(dst, dst_loc);
         auto src_op = get_operand(src, src_loc);
         MONAD_VM_DEBUG_ASSERT(!std::holds_alternative<x86::Ymm>(src_op));
@@ -5219,7 +5533,7 @@ namespace monad::vm::compiler::native
             std::visit(
                 Cases{
                     [&](Gpq256 const &src_gpq) {
-                        for (size_t i = 0; i < 4; ++i) {
+                        for (size_t i = 0; i < limbs; ++i) {
                             if (!isnop(instr_ix, i)) {
                                 (as_.*GG[instr_ix++])(dst_gpq[i], src_gpq[i]);
                             }
@@ -5228,13 +5542,13 @@ namespace monad::vm::compiler::native
                     [&](x86::Mem const &src_mem) {
                         x86::Mem temp{src_mem};
                         if (!src->literal()) {
-                            for (size_t i = 0; i < 4; ++i) {
+                            for (size_t i = 0; i < limbs; ++i) {
                                 (as_.*GM[instr_ix++])(dst_gpq[i], temp);
                                 temp.addOffset(8);
                             }
                             return;
                         }
-                        for (size_t i = 0; i < 4; ++i) {
+                        for (size_t i = 0; i < limbs; ++i) {
                             uint64_t const x = src->literal()->value[i];
                             if (!is_no_operation(instr_ix, x)) {
                                 if (is_uint64_bounded(x)) {
@@ -5248,7 +5562,7 @@ namespace monad::vm::compiler::native
                         }
                     },
                     [&](Imm256 const &src_imm) {
-                        for (size_t i = 0; i < 4; ++i) {
+                        for (size_t i = 0; i < limbs; ++i) {
                             if (!isnop(instr_ix, i)) {
                                 (as_.*GI[instr_ix++])(dst_gpq[i], src_imm[i]);
                             }
@@ -5267,7 +5581,7 @@ namespace monad::vm::compiler::native
                 Cases{
                     [&](Gpq256 const &src_gpq) {
                         x86::Mem temp{dst_mem};
-                        for (size_t i = 0; i < 4; ++i) {
+                        for (size_t i = 0; i < limbs; ++i) {
                             if (!isnop(instr_ix, i)) {
                                 (as_.*MG[instr_ix++])(temp, src_gpq[i]);
                             }
@@ -5276,7 +5590,7 @@ namespace monad::vm::compiler::native
                     },
                     [&](Imm256 const &src_imm) {
                         x86::Mem temp{dst_mem};
-                        for (size_t i = 0; i < 4; ++i) {
+                        for (size_t i = 0; i < limbs; ++i) {
                             if (!isnop(instr_ix, i)) {
                                 (as_.*MI[instr_ix++])(temp, src_imm[i]);
                             }
@@ -5288,8 +5602,9 @@ namespace monad::vm::compiler::native
                 src_op);
         }
 
-        // This is not required to be an invariant, but it currently is:
-        MONAD_VM_DEBUG_ASSERT(instr_ix > 0);
+        // This is not required to be an invariant, but it currently is,
+        // unless the operands are known to be small:
+        MONAD_VM_DEBUG_ASSERT(instr_ix > 0 || limbs < 4);
     }
 
     template <typename... LiveSet>
@@ -5508,7 +5823,8 @@ namespace monad::vm::compiler::native
     void Emitter::avx_or_general_bin_instr(
         StackElemRef dst, StackElemRef left, LocationType left_loc,
         StackElemRef right, LocationType right_loc,
-        std::function<bool(size_t, uint64_t)> is_no_operation)
+        std::function<bool(size_t, uint64_t)> is_no_operation,
+        size_t const limbs)
     {
         if (left_loc == LocationType::GeneralReg) {
             general_bin_instr<GG, GM, GI, MG, MI>(
@@ -5516,7 +5832,8 @@ namespace monad::vm::compiler::native
                 left_loc,
                 std::move(right),
                 right_loc,
-                std::move(is_no_operation));
+                std::move(is_no_operation),
+                limbs);
             return;
         }
         auto left_op = get_operand(left, left_loc);
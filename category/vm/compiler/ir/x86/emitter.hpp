@@ -27,6 +27,15 @@
 #include <asmjit/x86.h>
 #include <asmjit/x86/x86assembler.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace monad::vm::compiler::native
 {
     class Emitter
@@ -91,6 +100,10 @@ namespace monad::vm::compiler::native
 
             std::vector<runtime::uint256_t> const &data() const;
 
+            /// Offsets of the slots holding absolute runtime function
+            /// addresses, relative to `label()`.
+            std::vector<int32_t> const &external_function_offsets() const;
+
             asmjit::x86::Mem add_literal(Literal const &);
 
             template <typename F>
@@ -107,6 +120,10 @@ namespace monad::vm::compiler::native
             template <size_t N>
             asmjit::x86::Mem add(std::array<uint8_t, N> const &);
 
+            template <size_t N>
+            asmjit::x86::Mem
+            add(std::array<uint8_t, N> const &, RoSubdata<N> &);
+
             asmjit::Label label_;
             int32_t partial_index_{};
             int32_t partial_sub_index_{32};
@@ -115,6 +132,8 @@ namespace monad::vm::compiler::native
             RoSubdata<16> sub16_;
             RoSubdata<8> sub8_;
             RoSubdata<4> sub4_;
+            RoSubdata<8> external_sub8_;
+            std::vector<int32_t> external_function_offsets_;
         };
 
         using Gpq256 = std::array<asmjit::x86::Gpq, 4>;
@@ -222,6 +241,9 @@ namespace monad::vm::compiler::native
 
         entrypoint_t finish_contract(asmjit::JitRuntime &);
 
+        // Image of the code at `entry`, as returned by `finish_contract`.
+        CodeImage code_image(entrypoint_t entry, native_code_size_t) const;
+
         ////////// Debug functionality //////////
 
         void runtime_print_gas_remaining(std::string const &msg);
@@ -245,10 +267,40 @@ namespace monad::vm::compiler::native
         Stack &get_stack();
         size_t estimate_size();
         void add_jump_dest(byte_offset);
+        /// Let static jumps to the jump destination pass the top
+        /// `avx_reg_count` stack elements in AVX registers instead of on
+        /// their stack offsets. Other predecessors enter through a prologue
+        /// loading the stack elements into the registers.
+        void add_register_entry(byte_offset, std::uint8_t avx_reg_count);
+        /// Record that the stack element at the negative `stack_index`
+        /// holds `value` on every path into the block at the jump
+        /// destination or fall through offset. Ignored for blocks with a
+        /// register entry and for blocks continuing the stack of a `JUMPI`.
+        void add_literal_entry(
+            byte_offset, std::int32_t stack_index, uint256_t const &value);
+        /// Let the block at the jump destination or fall through offset
+        /// resume in the interpreter of `CompilerConfig::interpreter_fallback`
+        /// instead of compiling it. Such a block needs no register entry.
+        void add_fallback_block(byte_offset);
         [[nodiscard]]
         bool begin_new_block(basic_blocks::Block const &);
+        /// Emit a block added with `add_fallback_block` in place of
+        /// `begin_new_block` and the instructions of the block. The block
+        /// checks the gas and calls into the interpreter, which never
+        /// returns to the native code.
+        void fallback_block(basic_blocks::Block const &);
         void gas_decrement_static_work(int64_t);
+        /// Like `gas_decrement_static_work`, for a block entered with at
+        /// most `entry_work` static work since the last gas check, on every
+        /// path into the block.
+        void gas_decrement_static_work(int64_t, int64_t entry_work);
         void gas_decrement_unbounded_work(int64_t);
+
+        /// The static work since the last gas check.
+        int64_t accumulated_static_work() const
+        {
+            return accumulated_static_work_;
+        }
         void spill_caller_save_regs(bool spill_avx);
         void spill_all_caller_save_general_regs();
         void spill_avx_reg_range(uint8_t start);
@@ -301,6 +353,10 @@ namespace monad::vm::compiler::native
         void sgt();
         void sub();
         void add();
+        /// The overloads taking `operand_bits` skip the 64-bit limbs above
+        /// the significant bits of the result, for stack inputs below
+        /// `2^operand_bits`.
+        void add(std::uint16_t operand_bits);
         void byte();
         void signextend();
         void shl();
@@ -308,8 +364,11 @@ namespace monad::vm::compiler::native
         void sar();
 
         void and_();
+        void and_(std::uint16_t operand_bits);
         void or_();
+        void or_(std::uint16_t operand_bits);
         void xor_();
+        void xor_(std::uint16_t operand_bits);
         void eq();
 
         void iszero();
@@ -664,7 +723,10 @@ namespace monad::vm::compiler::native
         bool block_prologue(basic_blocks::Block const &);
         template <bool preserve_eflags>
         void adjust_by_stack_delta();
-        void write_to_final_stack_offsets();
+        void write_to_final_stack_offsets(
+            std::int32_t avx_reg_entry_index =
+                std::numeric_limits<std::int32_t>::max());
+        void emit_stack_bound_checks();
 
         void discharge_deferred_comparison(StackElem *, Comparison);
 
@@ -752,8 +814,9 @@ namespace monad::vm::compiler::native
         sub(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
 
         template <typename... LiveSet>
-        StackElemRef
-        add(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
+        StackElemRef add(
+            StackElemRef, StackElemRef, std::tuple<LiveSet...> const &,
+            size_t limbs = 4);
 
         template <typename... LiveSet>
         StackElemRef
@@ -768,16 +831,19 @@ namespace monad::vm::compiler::native
         sar(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
 
         template <typename... LiveSet>
-        StackElemRef
-        and_(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
+        StackElemRef and_(
+            StackElemRef, StackElemRef, std::tuple<LiveSet...> const &,
+            size_t limbs = 4);
 
         template <typename... LiveSet>
-        StackElemRef
-        or_(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
+        StackElemRef or_(
+            StackElemRef, StackElemRef, std::tuple<LiveSet...> const &,
+            size_t limbs = 4);
 
         template <typename... LiveSet>
-        StackElemRef
-        xor_(StackElemRef, StackElemRef, std::tuple<LiveSet...> const &);
+        StackElemRef xor_(
+            StackElemRef, StackElemRef, std::tuple<LiveSet...> const &,
+            size_t limbs = 4);
 
         std::variant<Comparison, StackElemRef> iszero(StackElemRef);
         void push_iszero(StackElemRef);
@@ -812,6 +878,13 @@ namespace monad::vm::compiler::native
             return (x >> 6) + ((x & 63) != 0);
         }
 
+        /// The number of low 64-bit limbs holding every significant bit of
+        /// a value with at most `bits` significant bits, at least one.
+        static constexpr size_t limb_count(size_t bits)
+        {
+            return std::clamp<size_t>(div64_ceil(bits), 1, 4);
+        }
+
         class MulEmitter
         {
         public:
@@ -902,6 +975,7 @@ namespace monad::vm::compiler::native
         uint256_t literal_jump_dest_operand(StackElemRef);
         asmjit::Label const &jump_dest_label(uint256_t const &);
         void jump_literal_dest(uint256_t const &);
+        bool jump_register_entry(uint256_t const &);
         template <typename... LiveSet>
         std::pair<Operand, std::optional<StackElem *>>
         non_literal_jump_dest_operand(
@@ -1011,7 +1085,8 @@ namespace monad::vm::compiler::native
         void general_bin_instr(
             StackElemRef dst, LocationType dst_loc, StackElemRef src,
             LocationType src_loc,
-            std::function<bool(size_t, uint64_t)> is_no_operation);
+            std::function<bool(size_t, uint64_t)> is_no_operation,
+            size_t limbs = 4);
 
         template <typename... LiveSet>
         std::tuple<StackElemRef, StackElemRef, LocationType> get_una_arguments(
@@ -1040,7 +1115,8 @@ namespace monad::vm::compiler::native
         void avx_or_general_bin_instr(
             StackElemRef dst, StackElemRef left, LocationType left_loc,
             StackElemRef right, LocationType right_loc,
-            std::function<bool(size_t, uint64_t)> is_no_operation);
+            std::function<bool(size_t, uint64_t)> is_no_operation,
+            size_t limbs = 4);
 
         template <typename... LiveSet>
         std::tuple<
@@ -1083,6 +1159,7 @@ namespace monad::vm::compiler::native
         asmjit::CodeHolder code_holder_;
         asmjit::FileLogger debug_logger_;
         bool runtime_debug_trace_;
+        bool record_block_offsets_;
         asmjit::x86::Assembler as_;
         asmjit::Label epilogue_label_;
         asmjit::Label error_label_;
@@ -1092,11 +1169,20 @@ namespace monad::vm::compiler::native
         std::array<Gpq256, 3> gpq256_regs_;
         interpreter::code_size_t bytecode_size_;
         std::unordered_map<byte_offset, asmjit::Label> jump_dests_;
+        std::unordered_map<byte_offset, std::pair<asmjit::Label, std::uint8_t>>
+            register_entries_;
+        std::unordered_map<
+            byte_offset, std::vector<std::pair<std::int32_t, uint256_t>>>
+            literal_entries_;
+        std::optional<InterpreterFallback> interpreter_fallback_;
+        std::unordered_set<byte_offset> fallback_blocks_;
         RoData rodata_;
         std::vector<std::tuple<asmjit::Label, asmjit::x86::Mem, asmjit::Label>>
             load_bounded_le_handlers_;
         std::vector<std::pair<asmjit::Label, std::string>> debug_messages_;
         uint32_t exponential_constant_fold_counter_;
         int64_t accumulated_static_work_;
+        std::vector<BlockOffset> block_offsets_;
+        uint32_t blocks_end_;
     };
 }
@@ -15,15 +15,22 @@
 
 #pragma once
 
+#include <category/vm/compiler/ir/passes.hpp>
 #include <category/vm/interpreter/intercode.hpp>
 #include <category/vm/runtime/bin.hpp>
 #include <category/vm/runtime/runtime.hpp>
 
 #include <asmjit/x86.h>
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace monad::vm::compiler::native
 {
@@ -50,14 +57,22 @@ namespace monad::vm::compiler::native
         using CodeSizeEstimate =
             std::variant<std::monostate, size_t, native_code_size_t>;
 
-        /// If compilation failed, then `entrypoint` is `nullptr`.
+        /// If compilation failed, then `entrypoint` is `nullptr`. Code from
+        /// the optimizing tier passes the `optimized_code` that `entry`
+        /// jumps into, which is kept alive as long as the entry point.
+        /// Code resuming in the interpreter for some basic blocks passes
+        /// the `fallback_code` it resumes, which is kept alive likewise.
         Nativecode(
             asmjit::JitRuntime &asmjit_rt, uint64_t chain_id,
-            entrypoint_t entry, CodeSizeEstimate code_size_estimate)
+            entrypoint_t entry, CodeSizeEstimate code_size_estimate,
+            std::shared_ptr<void const> optimized_code = nullptr,
+            std::shared_ptr<void const> fallback_code = nullptr)
             : asmjit_rt_{asmjit_rt}
             , chain_id_{chain_id}
             , entrypoint_{entry}
             , code_size_estimate_{code_size_estimate}
+            , optimized_code_{std::move(optimized_code)}
+            , fallback_code_{std::move(fallback_code)}
         {
             MONAD_VM_DEBUG_ASSERT(
                 !!entrypoint_ ==
@@ -78,6 +93,19 @@ namespace monad::vm::compiler::native
             return chain_id_;
         }
 
+        /// Whether this is code from the optimizing tier.
+        bool optimized() const noexcept
+        {
+            return optimized_code_ != nullptr;
+        }
+
+        /// Whether some basic blocks resume in the interpreter instead of
+        /// being compiled.
+        bool partial() const noexcept
+        {
+            return fallback_code_ != nullptr;
+        }
+
         native_code_size_t code_size_estimate() const
         {
             return std::holds_alternative<native_code_size_t>(
@@ -126,12 +154,73 @@ namespace monad::vm::compiler::native
         uint64_t chain_id_;
         entrypoint_t entrypoint_;
         CodeSizeEstimate code_size_estimate_;
+        std::shared_ptr<void const> optimized_code_;
+        std::shared_ptr<void const> fallback_code_;
+    };
+
+    /// Start of the native code of the basic block at `bytecode_offset`.
+    struct BlockOffset
+    {
+        uint32_t bytecode_offset;
+        uint32_t native_offset;
+    };
+
+    /// The machine code of a compiled contract, as placed by the
+    /// `JitRuntime`. The code only refers to itself relative to the
+    /// instruction pointer, except for the absolute addresses of runtime
+    /// functions stored in the 8 byte slots at `external_function_offsets`.
+    /// Patching those slots is enough to run the code at another address.
+    struct CodeImage
+    {
+        std::span<uint8_t const> code;
+        std::vector<uint32_t> external_function_offsets;
+        native_code_size_t code_size_estimate;
+        /// The basic blocks in emission order, if requested with
+        /// `CompilerConfig::record_block_offsets`. The last block ends at
+        /// `blocks_end`, where the contract epilogue starts.
+        std::vector<BlockOffset> block_offsets{};
+        uint32_t blocks_end{};
+        /// False if the code refers to objects of this process other than
+        /// the runtime functions, so that it can not run in another one.
+        bool relocatable{true};
     };
 
     class Emitter;
 
     using EmitterHook = std::function<void(Emitter &)>;
 
+    using CodeImageHook = std::function<void(CodeImage const &)>;
+
+    /// Signature of `interpreter::resume`.
+    using InterpreterResume = void (*)(
+        runtime::Context *, runtime::uint256_t *, std::uint64_t,
+        interpreter::Intercode const *, std::uint64_t);
+
+    /// Time spent in each phase of compilation, see
+    /// `CompilerConfig::phase_times`.
+    struct CompilePhaseTimes
+    {
+        /// Decoding the bytecode into basic blocks.
+        std::chrono::nanoseconds basic_blocks{};
+        /// The IR passes of `CompilerConfig::ir_passes`.
+        std::chrono::nanoseconds ir_passes{};
+        /// Emitting the native code of the basic blocks.
+        std::chrono::nanoseconds emit{};
+        /// Emitting the jump table and read-only data, and relocating and
+        /// copying the code into executable memory.
+        std::chrono::nanoseconds finalize{};
+    };
+
+    /// Partial compilation of a contract. Only the basic blocks nearest to
+    /// the contract entry are compiled, until their bytecode reaches the
+    /// budget, and the other basic blocks resume in the interpreter.
+    struct InterpreterFallback
+    {
+        std::shared_ptr<interpreter::Intercode const> intercode;
+        InterpreterResume resume;
+        interpreter::code_size_t compiled_bytecode_budget;
+    };
+
     struct CompilerConfig
     {
         char const *asm_log_path{};
@@ -139,5 +228,18 @@ namespace monad::vm::compiler::native
         interpreter::code_size_t max_code_size_offset =
             monad::vm::runtime::bin<10 * 1024>;
         EmitterHook post_instruction_emit_hook{};
+        /// Called with the image of successfully compiled code, while the
+        /// image is still valid.
+        CodeImageHook code_image_hook{};
+        /// IR optimization passes run before emitting native code.
+        basic_blocks::PassConfig ir_passes{};
+        /// Record where the native code of each basic block starts in
+        /// the code image, so that the perf map names every block.
+        bool record_block_offsets{};
+        /// Compile the contract partially, see `InterpreterFallback`.
+        std::optional<InterpreterFallback> interpreter_fallback{};
+        /// When set, the time spent in each phase of compilation is added
+        /// to it.
+        CompilePhaseTimes *phase_times{};
     };
 }
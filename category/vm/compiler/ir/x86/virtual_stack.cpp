@@ -278,7 +278,9 @@ namespace monad::vm::compiler::native
         }
     }
 
-    void Stack::begin_new_block(basic_blocks::Block const &block)
+    void Stack::begin_new_block(
+        basic_blocks::Block const &block,
+        std::uint8_t const avx_reg_entry_count)
     {
         positive_elems_.clear();
         negative_elems_.clear();
@@ -287,17 +289,29 @@ namespace monad::vm::compiler::native
         avx_reg_stack_elems_.fill(nullptr);
         free_general_regs_ =
             GeneralRegQueue{ALL_GENERAL_REGS.begin(), ALL_GENERAL_REGS.end()};
-        free_avx_regs_ = AvxRegQueue{ALL_AVX_REGS.begin(), ALL_AVX_REGS.end()};
+        free_avx_regs_ = AvxRegQueue{
+            ALL_AVX_REGS.begin() + avx_reg_entry_count, ALL_AVX_REGS.end()};
         available_stack_offsets_.clear();
         top_index_ = -1;
 
         auto const [new_min_delta, new_delta, new_max_delta] =
             block.stack_deltas();
 
+        MONAD_VM_ASSERT(avx_reg_entry_count <= -new_min_delta);
         negative_elems_.reserve(static_cast<std::size_t>(-new_min_delta));
         for (auto i = -1; i >= new_min_delta; --i) {
             StackElemRef e = new_stack_elem();
-            e->stack_offset_ = StackOffset{i};
+            auto const avx_reg = static_cast<std::uint8_t>(-i - 1);
+            if (avx_reg < avx_reg_entry_count) {
+                // The stack offset is free, because the stack element is
+                // only located in the AVX register.
+                e->avx_reg_ = AvxReg{avx_reg};
+                avx_reg_stack_elems_[avx_reg] = e.get();
+                available_stack_offsets_.insert(i);
+            }
+            else {
+                e->stack_offset_ = StackOffset{i};
+            }
             e->stack_indices_.insert(i);
             negative_elems_.push_back(std::move(e));
         }
@@ -343,6 +357,15 @@ namespace monad::vm::compiler::native
         max_delta_ = new_max_delta;
     }
 
+    void
+    Stack::insert_entry_literal(std::int32_t const index, uint256_t const &x)
+    {
+        MONAD_VM_ASSERT(index < 0 && index >= min_delta_);
+        auto const &e = at(index);
+        MONAD_VM_ASSERT(e->stack_offset_.has_value());
+        e->insert_literal(Literal{x});
+    }
+
     StackElemRef Stack::new_stack_elem()
     {
         return StackElemRef::make(
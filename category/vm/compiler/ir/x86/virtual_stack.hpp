@@ -389,9 +389,14 @@ namespace monad::vm::compiler::native
 
         /**
          * Prepare stack for code generation of the given block
-         * with an initial stack state for the block.
+         * with an initial stack state for the block. The top
+         * `avx_reg_entry_count` stack elements of the initial state are
+         * located in the AVX registers `0, 1, ...` instead of on their
+         * stack offsets, top first.
          */
-        void begin_new_block(basic_blocks::Block const &);
+        void begin_new_block(
+            basic_blocks::Block const &,
+            std::uint8_t avx_reg_entry_count = 0);
 
         /**
          * Prepare stack for code generation of the given block
@@ -399,6 +404,13 @@ namespace monad::vm::compiler::native
          */
         void continue_block(basic_blocks::Block const &);
 
+        /**
+         * Record that the stack element at the given negative index holds
+         * the literal on entry to the current block, in addition to its
+         * stack offset. Must be called right after `begin_new_block`.
+         */
+        void insert_entry_literal(std::int32_t index, uint256_t const &);
+
         /**
          * Obtain a reference to an item on the stack. Negative indices
          * refer to stack elements before the basic block's stack frame
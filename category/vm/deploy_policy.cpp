@@ -0,0 +1,56 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/deploy_policy.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace monad::vm
+{
+    DeployPolicy::DeployPolicy(
+        uint64_t const factory_threshold, size_t const max_factories)
+        : factory_threshold_{factory_threshold}
+        , max_factories_{max_factories}
+    {
+    }
+
+    void DeployPolicy::allow_factory(evmc::address const &factory)
+    {
+        Map::accessor acc;
+        map_.insert(acc, factory);
+        acc->second = allowed;
+    }
+
+    bool DeployPolicy::on_deploy(evmc::address const &factory)
+    {
+        Map::accessor acc;
+        if (!map_.find(acc, factory)) {
+            if (factory_threshold_ == 0 || map_.size() >= max_factories_) {
+                return false;
+            }
+            if (map_.insert(acc, factory)) {
+                acc->second = 0;
+            }
+        }
+        if (acc->second == allowed) {
+            return true;
+        }
+        // Deployments up to the threshold are only counted.
+        return ++acc->second > factory_threshold_;
+    }
+}
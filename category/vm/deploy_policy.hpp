@@ -0,0 +1,70 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <tbb/concurrent_hash_map.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace monad::vm
+{
+    /// Decides which code deployed by CREATE and CREATE2 is compiled
+    /// immediately, instead of once the interpreter has spent enough gas
+    /// on it. Code deployed by an allowed factory qualifies, and so does
+    /// code deployed by a factory that has already deployed
+    /// `factory_threshold` contracts.
+    class DeployPolicy
+    {
+    public:
+        static constexpr uint64_t default_factory_threshold = 16;
+        static constexpr size_t default_max_factories = size_t{1} << 16;
+
+        /// A `factory_threshold` of zero only compiles code deployed by
+        /// allowed factories. Once `max_factories` deployers are tracked,
+        /// deployments by new ones are not counted.
+        explicit DeployPolicy(
+            uint64_t factory_threshold = default_factory_threshold,
+            size_t max_factories = default_max_factories);
+
+        /// Compile all code deployed by `factory` immediately.
+        void allow_factory(evmc::address const &factory);
+
+        /// Record a deployment by `factory`. Returns whether the deployed
+        /// code should be compiled immediately.
+        bool on_deploy(evmc::address const &factory);
+
+        size_t size() const noexcept
+        {
+            return map_.size();
+        }
+
+    private:
+        /// The deployment count of allowed factories.
+        static constexpr uint64_t allowed = ~uint64_t{0};
+
+        using Map = tbb::concurrent_hash_map<
+            evmc::address, uint64_t, utils::AddressCompare>;
+
+        uint64_t factory_threshold_;
+        size_t max_factories_;
+        Map map_;
+    };
+}
@@ -0,0 +1,258 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/core/assert.h>
+#include <category/vm/execution_sampler.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace monad::vm
+{
+    /// The contract a thread is running, published with a sequence lock:
+    /// `seq` is odd while a writer updates the slot, so that the sampler
+    /// thread can detect and drop torn reads without blocking the
+    /// execution thread.
+    struct ExecutionSampler::Slot
+    {
+        struct Live
+        {
+            uint64_t id;
+            evmc::bytes32 code_hash;
+            uint8_t state;
+        };
+
+        std::atomic<uint64_t> seq{0};
+        std::array<std::atomic<uint64_t>, 4> words{};
+        std::atomic<uint8_t> state{idle};
+
+        // Serializes the writers: the owning thread, and a thread that a
+        // fiber moved to before exiting its frame
+        std::mutex mutex;
+        std::vector<Live> live;
+        uint64_t next_frame_id{0};
+
+        void publish_top() noexcept
+        {
+            if (live.empty()) {
+                publish({}, idle);
+            }
+            else {
+                publish(live.back().code_hash, live.back().state);
+            }
+        }
+
+        void publish(evmc::bytes32 const &h, uint8_t const s) noexcept
+        {
+            auto const n = seq.load(std::memory_order_relaxed);
+            seq.store(n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < words.size(); ++i) {
+                uint64_t w;
+                std::memcpy(&w, h.bytes + 8 * i, 8);
+                words[i].store(w, std::memory_order_relaxed);
+            }
+            state.store(s, std::memory_order_relaxed);
+            seq.store(n + 2, std::memory_order_release);
+        }
+
+        bool read(evmc::bytes32 &h, uint8_t &s) const noexcept
+        {
+            auto const n = seq.load(std::memory_order_acquire);
+            if (n & 1) {
+                return false;
+            }
+            for (size_t i = 0; i < words.size(); ++i) {
+                uint64_t const w = words[i].load(std::memory_order_relaxed);
+                std::memcpy(h.bytes + 8 * i, &w, 8);
+            }
+            s = state.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return seq.load(std::memory_order_relaxed) == n;
+        }
+    };
+
+    namespace
+    {
+        std::atomic<uint64_t> next_sampler_id{1};
+
+        struct ThreadSlot
+        {
+            uint64_t sampler_id;
+            void *slot;
+        };
+
+        thread_local ThreadSlot thread_slot_cache{0, nullptr};
+    }
+
+    ExecutionSampler::Frame::Frame(
+        ExecutionSampler &sampler, evmc::bytes32 const &code_hash,
+        bool const native)
+        : slot_{sampler.thread_slot()}
+    {
+        std::lock_guard const lock{slot_.mutex};
+        id_ = ++slot_.next_frame_id;
+        slot_.live.push_back(
+            {.id = id_,
+             .code_hash = code_hash,
+             .state = native ? ExecutionSampler::native
+                             : ExecutionSampler::interpreter});
+        slot_.publish_top();
+    }
+
+    ExecutionSampler::Frame::~Frame()
+    {
+        // Frames mostly exit in order, so search from the top
+        std::lock_guard const lock{slot_.mutex};
+        auto const it = std::ranges::find(
+            slot_.live.rbegin(), slot_.live.rend(), id_, &Slot::Live::id);
+        MONAD_VM_ASSERT(it != slot_.live.rend());
+        slot_.live.erase(std::next(it).base());
+        slot_.publish_top();
+    }
+
+    ExecutionSampler::ExecutionSampler(
+        std::chrono::microseconds const interval)
+        : id_{next_sampler_id.fetch_add(1, std::memory_order_relaxed)}
+        , interval_{std::max(interval, std::chrono::microseconds{1})}
+        , thread_{[this] { sample_loop(); }}
+    {
+    }
+
+    ExecutionSampler::~ExecutionSampler()
+    {
+        {
+            std::lock_guard const lock{stop_mutex_};
+            stop_ = true;
+        }
+        stop_cv_.notify_one();
+        thread_.join();
+    }
+
+    ExecutionSampler::Slot &ExecutionSampler::thread_slot()
+    {
+        auto &cache = thread_slot_cache;
+        if (cache.sampler_id != id_) {
+            // Slots live as long as the sampler, so a sample never reads
+            // the slot of a thread that has exited.
+            std::lock_guard const lock{slots_mutex_};
+            slots_.push_back(std::make_unique<Slot>());
+            cache = ThreadSlot{id_, slots_.back().get()};
+        }
+        return *static_cast<Slot *>(cache.slot);
+    }
+
+    void ExecutionSampler::sample_loop()
+    {
+        std::vector<std::pair<evmc::bytes32, uint8_t>> samples;
+        std::unique_lock lock{stop_mutex_};
+        while (!stop_cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+            samples.clear();
+            {
+                std::lock_guard const slots_lock{slots_mutex_};
+                for (auto const &slot : slots_) {
+                    evmc::bytes32 h;
+                    uint8_t s;
+                    if (slot->read(h, s) && s != idle) {
+                        samples.emplace_back(h, s);
+                    }
+                }
+            }
+            std::lock_guard const samples_lock{samples_mutex_};
+            for (auto const &[h, s] : samples) {
+                for (Map *const map : {&total_, &block_}) {
+                    auto &counts = (*map)[h];
+                    if (s == native) {
+                        ++counts.native_samples;
+                    }
+                    else {
+                        ++counts.interpreter_samples;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<ExecutionSampler::Entry>
+    ExecutionSampler::sorted_entries(Map const &map)
+    {
+        std::vector<Entry> entries;
+        entries.reserve(map.size());
+        for (auto const &[h, c] : map) {
+            entries.push_back(
+                Entry{
+                    .code_hash = h,
+                    .native_samples = c.native_samples,
+                    .interpreter_samples = c.interpreter_samples});
+        }
+        std::ranges::sort(entries, [](Entry const &a, Entry const &b) {
+            return a.native_samples + a.interpreter_samples >
+                   b.native_samples + b.interpreter_samples;
+        });
+        return entries;
+    }
+
+    std::vector<ExecutionSampler::Entry> ExecutionSampler::entries() const
+    {
+        std::lock_guard const lock{samples_mutex_};
+        return sorted_entries(total_);
+    }
+
+    std::vector<ExecutionSampler::Entry> ExecutionSampler::take_block_entries()
+    {
+        Map block;
+        {
+            std::lock_guard const lock{samples_mutex_};
+            block.swap(block_);
+        }
+        return sorted_entries(block);
+    }
+
+    bool
+    ExecutionSampler::write_folded(std::filesystem::path const &path) const
+    {
+        std::ofstream out{path, std::ios::trunc};
+        if (!out) {
+            return false;
+        }
+        for (auto const &e : entries()) {
+            auto const name = utils::hex_string(e.code_hash);
+            if (e.native_samples) {
+                out << "evm;" << name << ";native " << e.native_samples
+                    << '\n';
+            }
+            if (e.interpreter_samples) {
+                out << "evm;" << name << ";interpreter "
+                    << e.interpreter_samples << '\n';
+            }
+        }
+        return static_cast<bool>(out.flush());
+    }
+}
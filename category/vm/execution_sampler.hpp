@@ -0,0 +1,144 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace monad::vm
+{
+    /// Sampling profiler of contract execution. Every execution thread
+    /// publishes the code hash of the contract it is running, and a
+    /// sampler thread reads them every `interval`. Each sample is counted
+    /// for the contract, split by whether it ran native code or the
+    /// interpreter, both in total and for the current block.
+    ///
+    /// Each thread keeps a stack of its live frames and publishes the top
+    /// one, or idle when there is none. Fibers that switch while inside a
+    /// frame, say to wait for a database read in a host call, are sampled
+    /// as the thread: the last live frame entered on the thread is
+    /// counted. A frame that exits out of order, or on another thread
+    /// than the one it was entered on, is removed from the stack it was
+    /// pushed on.
+    class ExecutionSampler
+    {
+        struct Slot;
+
+    public:
+        struct Entry
+        {
+            evmc::bytes32 code_hash;
+            uint64_t native_samples;
+            uint64_t interpreter_samples;
+        };
+
+        /// Marks the calling thread as running the contract with
+        /// `code_hash` until destroyed, when the thread's last live
+        /// frame is published again, or idle if it has none.
+        class Frame
+        {
+        public:
+            Frame(
+                ExecutionSampler &, evmc::bytes32 const &code_hash,
+                bool native);
+
+            ~Frame();
+
+            Frame(Frame const &) = delete;
+            Frame &operator=(Frame const &) = delete;
+
+        private:
+            Slot &slot_;
+            uint64_t id_;
+        };
+
+        static constexpr std::chrono::microseconds default_interval{1000};
+
+        explicit ExecutionSampler(
+            std::chrono::microseconds interval = default_interval);
+
+        ~ExecutionSampler();
+
+        ExecutionSampler(ExecutionSampler const &) = delete;
+        ExecutionSampler &operator=(ExecutionSampler const &) = delete;
+
+        /// The samples of every contract since the sampler started, most
+        /// sampled first.
+        std::vector<Entry> entries() const;
+
+        /// The samples of every contract since the previous call, most
+        /// sampled first. Call at the end of each block.
+        std::vector<Entry> take_block_entries();
+
+        /// Write the samples since the sampler started to `path` as
+        /// folded stacks, the input format of `flamegraph.pl` and
+        /// `inferno`, which `pprof` also converts from. Returns false if
+        /// the file could not be written.
+        bool write_folded(std::filesystem::path const &path) const;
+
+    private:
+        enum : uint8_t
+        {
+            idle = 0,
+            interpreter = 1,
+            native = 2
+        };
+
+        struct Counts
+        {
+            uint64_t native_samples;
+            uint64_t interpreter_samples;
+        };
+
+        using Map = std::unordered_map<
+            evmc::bytes32, Counts, utils::Hash32Hash, utils::Bytes32Equal>;
+
+        Slot &thread_slot();
+
+        void sample_loop();
+
+        static std::vector<Entry> sorted_entries(Map const &);
+
+        uint64_t id_;
+        std::chrono::microseconds interval_;
+
+        std::mutex slots_mutex_;
+        std::vector<std::unique_ptr<Slot>> slots_;
+
+        mutable std::mutex samples_mutex_;
+        Map total_;
+        Map block_;
+
+        std::mutex stop_mutex_;
+        std::condition_variable stop_cv_;
+        bool stop_{false};
+        std::thread thread_;
+    };
+}
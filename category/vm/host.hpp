@@ -30,6 +30,23 @@ namespace monad::vm
         friend class VM;
 
     public:
+        /// Mark the storage slot `key` of `address` as accessed and read its
+        /// current value into `value`, returning the access status from
+        /// before the call. A cold slot is only read if `load_cold` is set,
+        /// so that a frame that cannot pay for the cold access does not do
+        /// the read. This is what SLOAD needs after EIP-2929; hosts that can
+        /// resolve both with a single account lookup override it.
+        virtual evmc_access_status access_and_load_storage(
+            evmc::address const &address, evmc::bytes32 const &key,
+            evmc::bytes32 &value, bool const load_cold) noexcept
+        {
+            auto const status = access_storage(address, key);
+            if (load_cold || status == EVMC_ACCESS_WARM) {
+                value = get_storage(address, key);
+            }
+            return status;
+        }
+
         /// Capture `std::current_exception()`.
         /// IMPORTANT: Make sure to call this from inside a `catch` block.
         void capture_current_exception() const noexcept
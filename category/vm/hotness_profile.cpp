@@ -0,0 +1,211 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/hotness_profile.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    constexpr std::array<char, 8> file_magic{
+        'M', 'O', 'N', 'A', 'D', 'H', 'P', '1'};
+}
+
+namespace monad::vm
+{
+    static_assert(std::is_trivially_copyable_v<HotnessProfile::Entry>);
+
+    HotnessProfile::HotnessProfile(
+        std::chrono::nanoseconds const half_life, size_t const max_entries)
+        : start_{std::chrono::steady_clock::now()}
+        , half_life_{std::max(half_life, std::chrono::nanoseconds{1})}
+        , max_entries_{max_entries}
+    {
+    }
+
+    uint64_t HotnessProfile::current_epoch() const
+    {
+        return static_cast<uint64_t>(
+            (std::chrono::steady_clock::now() - start_) / half_life_);
+    }
+
+    HotnessProfile::Counters
+    HotnessProfile::decayed(Counters c, uint64_t const epoch)
+    {
+        if (epoch > c.epoch) {
+            uint64_t const shift = std::min<uint64_t>(epoch - c.epoch, 63);
+            c.calls >>= shift;
+            c.gas >>= shift;
+            c.interpreted_ns >>= shift;
+            c.epoch = epoch;
+        }
+        return c;
+    }
+
+    void HotnessProfile::record(
+        evmc::bytes32 const &code_hash, uint64_t const gas,
+        uint64_t const interpreted_ns)
+    {
+        uint64_t const epoch = current_epoch();
+        Map::accessor acc;
+        if (!map_.find(acc, code_hash)) {
+            if (map_.size() >= max_entries_) {
+                return;
+            }
+            if (map_.insert(acc, code_hash)) {
+                acc->second = Counters{
+                    .calls = 0, .gas = 0, .interpreted_ns = 0, .epoch = epoch};
+            }
+        }
+        auto &c = acc->second;
+        c = decayed(c, epoch);
+        c.calls += 1;
+        c.gas += gas;
+        c.interpreted_ns += interpreted_ns;
+    }
+
+    std::vector<HotnessProfile::Entry> HotnessProfile::entries() const
+    {
+        uint64_t const epoch = current_epoch();
+        std::vector<Entry> result;
+        result.reserve(map_.size());
+        for (auto const &[code_hash, counters] : map_) {
+            auto const c = decayed(counters, epoch);
+            if (c.calls | c.gas | c.interpreted_ns) {
+                result.push_back(
+                    {.code_hash = code_hash,
+                     .calls = c.calls,
+                     .gas = c.gas,
+                     .interpreted_ns = c.interpreted_ns});
+            }
+        }
+        return result;
+    }
+
+    std::vector<HotnessProfile::Entry> HotnessProfile::top(size_t const k) const
+    {
+        auto result = entries();
+        auto const hotter = [](Entry const &a, Entry const &b) {
+            return a.gas > b.gas;
+        };
+        if (k < result.size()) {
+            std::partial_sort(
+                result.begin(),
+                result.begin() + static_cast<std::ptrdiff_t>(k),
+                result.end(),
+                hotter);
+            result.resize(k);
+        }
+        else {
+            std::sort(result.begin(), result.end(), hotter);
+        }
+        return result;
+    }
+
+    void HotnessProfile::prune()
+    {
+        uint64_t const epoch = current_epoch();
+        std::vector<evmc::bytes32> dead;
+        for (auto const &[code_hash, counters] : map_) {
+            auto const c = decayed(counters, epoch);
+            if (!(c.calls | c.gas | c.interpreted_ns)) {
+                dead.push_back(code_hash);
+            }
+        }
+        for (auto const &code_hash : dead) {
+            map_.erase(code_hash);
+        }
+    }
+
+    bool HotnessProfile::save(std::filesystem::path const &path) const
+    {
+        auto const profile = entries();
+        uint64_t const count = profile.size();
+        auto tmp = path;
+        tmp += ".tmp";
+        std::error_code ec;
+        {
+            std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+            out.write(file_magic.data(), file_magic.size());
+            out.write(reinterpret_cast<char const *>(&count), sizeof(count));
+            out.write(
+                reinterpret_cast<char const *>(profile.data()),
+                static_cast<std::streamsize>(count * sizeof(Entry)));
+            out.close();
+            if (!out) {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool HotnessProfile::load(std::filesystem::path const &path)
+    {
+        std::ifstream in{path, std::ios::binary};
+        std::array<char, 8> magic;
+        uint64_t count;
+        in.read(magic.data(), magic.size());
+        in.read(reinterpret_cast<char *>(&count), sizeof(count));
+        if (!in || magic != file_magic) {
+            return false;
+        }
+        std::error_code ec;
+        auto const size = std::filesystem::file_size(path, ec);
+        if (ec || size != file_magic.size() + sizeof(count) +
+                              count * sizeof(Entry)) {
+            return false;
+        }
+        std::vector<Entry> profile(count);
+        in.read(
+            reinterpret_cast<char *>(profile.data()),
+            static_cast<std::streamsize>(count * sizeof(Entry)));
+        if (!in) {
+            return false;
+        }
+
+        uint64_t const epoch = current_epoch();
+        for (auto const &e : profile) {
+            Map::accessor acc;
+            if (map_.insert(acc, e.code_hash)) {
+                acc->second = Counters{
+                    .calls = 0, .gas = 0, .interpreted_ns = 0, .epoch = epoch};
+            }
+            auto &c = acc->second;
+            c = decayed(c, epoch);
+            c.calls += e.calls;
+            c.gas += e.gas;
+            c.interpreted_ns += e.interpreted_ns;
+        }
+        return true;
+    }
+}
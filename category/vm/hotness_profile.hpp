@@ -0,0 +1,106 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <tbb/concurrent_hash_map.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace monad::vm
+{
+    /// Per code hash execution profile. The counters are halved every
+    /// `half_life`, so that the profile follows what is hot now rather
+    /// than what was hot once. Decay is applied lazily, when an entry is
+    /// updated or read.
+    class HotnessProfile
+    {
+    public:
+        struct Entry
+        {
+            evmc::bytes32 code_hash;
+            uint64_t calls;
+            uint64_t gas;
+            uint64_t interpreted_ns;
+        };
+
+        static constexpr std::chrono::seconds default_half_life{600};
+        static constexpr size_t default_max_entries = size_t{1} << 20;
+
+        explicit HotnessProfile(
+            std::chrono::nanoseconds half_life = default_half_life,
+            size_t max_entries = default_max_entries);
+
+        /// Record one call of `code_hash` using `gas`, of which
+        /// `interpreted_ns` were spent in the interpreter. Once the
+        /// profile holds `max_entries` code hashes, new ones are ignored
+        /// until `prune` makes room.
+        void record(
+            evmc::bytes32 const &code_hash, uint64_t gas,
+            uint64_t interpreted_ns);
+
+        /// The `k` entries with the most decayed gas, hottest first.
+        /// Not safe concurrently with `record`.
+        std::vector<Entry> top(size_t k) const;
+
+        /// Drop the entries decayed to zero. Not safe concurrently with
+        /// `record`.
+        void prune();
+
+        /// Write the decayed profile to `path`. Not safe concurrently with
+        /// `record`. Returns false if the file could not be written.
+        bool save(std::filesystem::path const &path) const;
+
+        /// Add the profile saved at `path` to this one. Returns false if
+        /// there is no valid profile at `path`.
+        bool load(std::filesystem::path const &path);
+
+        size_t size() const noexcept
+        {
+            return map_.size();
+        }
+
+    private:
+        struct Counters
+        {
+            uint64_t calls;
+            uint64_t gas;
+            uint64_t interpreted_ns;
+            uint64_t epoch;
+        };
+
+        using Map = tbb::concurrent_hash_map<
+            evmc::bytes32, Counters, utils::Hash32Compare>;
+
+        uint64_t current_epoch() const;
+
+        static Counters decayed(Counters, uint64_t epoch);
+
+        std::vector<Entry> entries() const;
+
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::nanoseconds half_life_;
+        size_t max_entries_;
+        Map map_;
+    };
+}
@@ -15,13 +15,16 @@
 
 #pragma once
 
+#include <category/vm/core/assert.h>
 #include <category/vm/evm/opcodes.hpp>
 #include <category/vm/evm/traits.hpp>
 #include <category/vm/interpreter/intercode.hpp>
+#include <category/vm/interpreter/opcode_counts.hpp>
 #include <category/vm/runtime/types.hpp>
 
 #include <evmc/evmc.h>
 
+#include <cstdint>
 #include <format>
 #include <iostream>
 
@@ -41,10 +44,27 @@ namespace monad::vm::interpreter
         Intercode const &analysis, std::int64_t gas_remaining,
         std::uint8_t const *instr_ptr)
     {
+        auto const offset = instr_ptr - analysis.instructions();
         std::cerr << std::format(
             "offset: 0x{:02x}  opcode: 0x{:x}  gas_left: {}\n",
-            instr_ptr - analysis.code(),
-            *instr_ptr,
+            offset,
+            analysis.code()[offset],
             gas_remaining);
     }
+
+    /// Called before dispatching to the instruction at `instr_ptr`, with
+    /// the gas of the instructions before it charged.
+    [[gnu::always_inline]]
+    inline void on_dispatch(
+        runtime::Context const &ctx, Intercode const &analysis,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        if constexpr (debug_enabled) {
+            trace(analysis, gas_remaining, instr_ptr);
+        }
+        if (MONAD_VM_UNLIKELY(ctx.opcode_counts != nullptr)) {
+            auto const offset = instr_ptr - analysis.instructions();
+            ctx.opcode_counts->record(analysis.code()[offset], gas_remaining);
+        }
+    }
 }
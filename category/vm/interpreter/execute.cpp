@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/vm/core/assert.h>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
 #include <category/vm/interpreter/debug.hpp>
@@ -23,6 +24,7 @@
 #include <category/vm/utils/traits.hpp>
 
 #include <cstdint>
+#include <utility>
 
 /**
  * Assembly trampoline into the interpreter's core loop (see entry.S). This
@@ -53,12 +55,10 @@ namespace monad::vm::interpreter
 
             auto *const stack_top = stack_ptr - 1;
             auto const *const stack_bottom = stack_top;
-            auto const *const instr_ptr = analysis->code();
+            auto const *const instr_ptr = analysis->instructions();
             auto const gas_remaining = ctx->gas_remaining;
 
-            if constexpr (debug_enabled) {
-                trace(*analysis, gas_remaining, instr_ptr);
-            }
+            on_dispatch(*ctx, *analysis, gas_remaining, instr_ptr);
             instruction_table<traits>[*instr_ptr](
                 *ctx,
                 *analysis,
@@ -83,4 +83,24 @@ namespace monad::vm::interpreter
     }
 
     EXPLICIT_TRAITS(execute);
+
+    template <Traits traits>
+    void resume(
+        runtime::Context *const ctx, runtime::uint256_t *const stack_ptr,
+        std::uint64_t const stack_size, Intercode const *const analysis,
+        std::uint64_t const pc)
+    {
+        MONAD_VM_DEBUG_ASSERT(pc < *analysis->code_size());
+        auto *const stack_top = stack_ptr - 1;
+        auto const *const stack_bottom = stack_top - stack_size;
+        auto const *const instr_ptr = analysis->instructions() + pc;
+        auto const gas_remaining = ctx->gas_remaining;
+
+        on_dispatch(*ctx, *analysis, gas_remaining, instr_ptr);
+        instruction_table<traits>[*instr_ptr](
+            *ctx, *analysis, stack_bottom, stack_top, gas_remaining, instr_ptr);
+        std::unreachable();
+    }
+
+    EXPLICIT_TRAITS(resume);
 }
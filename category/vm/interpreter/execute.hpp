@@ -19,13 +19,29 @@
 #include <category/vm/interpreter/intercode.hpp>
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/runtime/types.hpp>
+#include <category/vm/runtime/uint256.hpp>
 
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
+#include <cstdint>
+
 namespace monad::vm::interpreter
 {
     template <Traits traits>
     void
     execute(runtime::Context &, Intercode const &, std::uint8_t *stack_ptr);
+
+    /**
+     * Continue the execution of native code in the interpreter, from the
+     * instruction at `pc` with the `stack_size` stack elements below
+     * `stack_ptr`. Native code calls this function at the start of a basic
+     * block which was not compiled, with the gas remaining in the context.
+     * The interpreter exits to the caller of the native code, so this
+     * function never returns.
+     */
+    template <Traits traits>
+    [[noreturn]] void resume(
+        runtime::Context *, runtime::uint256_t *stack_ptr,
+        std::uint64_t stack_size, Intercode const *, std::uint64_t pc);
 }
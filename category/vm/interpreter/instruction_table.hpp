@@ -51,9 +51,7 @@
             compiler::opcode_table<traits>[(OP)].min_stack;                    \
                                                                                \
         ++instr_ptr;                                                           \
-        if constexpr (debug_enabled) {                                         \
-            trace(analysis, gas_remaining, instr_ptr);                         \
-        }                                                                      \
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr);                  \
         MONAD_VM_MUST_TAIL return instruction_table<traits>[*instr_ptr](       \
             ctx,                                                               \
             analysis,                                                          \
@@ -71,9 +69,7 @@
             compiler::opcode_table<traits>[(OP)].min_stack;                    \
                                                                                \
         instr_ptr += (((OP) - PUSH0) + 1);                                     \
-        if constexpr (debug_enabled) {                                         \
-            trace(analysis, gas_remaining, instr_ptr);                         \
-        }                                                                      \
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr);                  \
         MONAD_VM_MUST_TAIL return instruction_table<traits>[*instr_ptr](       \
             ctx,                                                               \
             analysis,                                                          \
@@ -84,6 +80,20 @@
     }                                                                          \
     while (false);
 
+#define MONAD_VM_NEXT_FUSED(SIZE, DELTA)                                       \
+    do {                                                                       \
+        instr_ptr += (SIZE);                                                   \
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr);                  \
+        MONAD_VM_MUST_TAIL return instruction_table<traits>[*instr_ptr](       \
+            ctx,                                                               \
+            analysis,                                                          \
+            stack_bottom,                                                      \
+            stack_top + (DELTA),                                               \
+            gas_remaining,                                                     \
+            instr_ptr);                                                        \
+    }                                                                          \
+    while (false);
+
 namespace monad::vm::interpreter
 {
     using enum runtime::StatusCode;
@@ -109,10 +119,10 @@ namespace monad::vm::interpreter
             mulmod<traits>, // 0x09,
             exp<traits>, // 0x0A,
             signextend<traits>, // 0x0B,
-            invalid, //
-            invalid, //
-            invalid, //
-            invalid, //
+            push1_add<traits>, // 0x0C, PUSH1_ADD
+            dup2_dup2_lt<traits>, // 0x0D, DUP2_DUP2_LT
+            push2_jumpi<traits>, // 0x0E, PUSH2_JUMPI
+            push2_jump<traits>, // 0x0F, PUSH2_JUMP
 
             lt<traits>, // 0x10,
             gt<traits>, // 0x11,
@@ -132,7 +142,7 @@ namespace monad::vm::interpreter
             invalid, //
 
             sha3<traits>, // 0x20,
-            invalid, //
+            swap1_pop<traits>, // 0x21, SWAP1_POP
             invalid, //
             invalid, //
             invalid,
@@ -1391,7 +1401,7 @@ namespace monad::vm::interpreter
     {
         check_requirements<PC, traits>(
             ctx, analysis, stack_bottom, stack_top, gas_remaining);
-        push(stack_top, instr_ptr - analysis.code());
+        push(stack_top, instr_ptr - analysis.instructions());
 
         MONAD_VM_NEXT(PC);
     }
@@ -1497,7 +1507,7 @@ namespace monad::vm::interpreter
                 ctx.exit(Error);
             }
 
-            return analysis.code() + jd;
+            return analysis.instructions() + jd;
         }
     }
 
@@ -1512,9 +1522,7 @@ namespace monad::vm::interpreter
         auto const &target = pop(stack_top);
         auto const *const new_ip = jump_impl(ctx, analysis, target);
 
-        if constexpr (debug_enabled) {
-            trace(analysis, gas_remaining, new_ip);
-        }
+        on_dispatch(ctx, analysis, gas_remaining, new_ip);
         MONAD_VM_MUST_TAIL return instruction_table<traits>[*new_ip](
             ctx, analysis, stack_bottom, stack_top, gas_remaining, new_ip);
     }
@@ -1532,17 +1540,13 @@ namespace monad::vm::interpreter
 
         if (cond) {
             auto const *const new_ip = jump_impl(ctx, analysis, target);
-            if constexpr (debug_enabled) {
-                trace(analysis, gas_remaining, new_ip);
-            }
+            on_dispatch(ctx, analysis, gas_remaining, new_ip);
             MONAD_VM_MUST_TAIL return instruction_table<traits>[*new_ip](
                 ctx, analysis, stack_bottom, stack_top, gas_remaining, new_ip);
         }
         else {
             ++instr_ptr;
-            if constexpr (debug_enabled) {
-                trace(analysis, gas_remaining, instr_ptr);
-            }
+            on_dispatch(ctx, analysis, gas_remaining, instr_ptr);
             MONAD_VM_MUST_TAIL return instruction_table<traits>[*instr_ptr](
                 ctx,
                 analysis,
@@ -1563,13 +1567,112 @@ namespace monad::vm::interpreter
             ctx,
             stack_bottom,
             stack_top,
-            static_cast<uint64_t>(instr_ptr - analysis.code()));
+            static_cast<uint64_t>(instr_ptr - analysis.instructions()));
         check_requirements<JUMPDEST, traits>(
             ctx, analysis, stack_bottom, stack_top, gas_remaining);
 
         MONAD_VM_NEXT(JUMPDEST);
     }
 
+    // Fused instruction sequences. Each handler performs the requirement
+    // checks of every instruction in its sequence in order, so gas and error
+    // semantics are identical to dispatching the instructions one by one.
+    template <Traits traits>
+    MONAD_VM_INSTRUCTION_CALL void push1_add(
+        runtime::Context &ctx, Intercode const &analysis,
+        runtime::uint256_t const *stack_bottom, runtime::uint256_t *stack_top,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        check_requirements<PUSH1, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 2);
+        check_requirements<ADD, traits>(
+            ctx, analysis, stack_bottom, stack_top + 1, gas_remaining);
+        *stack_top = *stack_top + runtime::uint256_t{instr_ptr[1]};
+
+        MONAD_VM_NEXT_FUSED(3, 0);
+    }
+
+    template <Traits traits>
+    MONAD_VM_INSTRUCTION_CALL void dup2_dup2_lt(
+        runtime::Context &ctx, Intercode const &analysis,
+        runtime::uint256_t const *stack_bottom, runtime::uint256_t *stack_top,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        check_requirements<DUP2, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 1);
+        check_requirements<DUP2, traits>(
+            ctx, analysis, stack_bottom, stack_top + 1, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 2);
+        check_requirements<LT, traits>(
+            ctx, analysis, stack_bottom, stack_top + 2, gas_remaining);
+        push(stack_top, *stack_top < *(stack_top - 1));
+
+        MONAD_VM_NEXT_FUSED(3, 1);
+    }
+
+    template <Traits traits>
+    MONAD_VM_INSTRUCTION_CALL void push2_jumpi(
+        runtime::Context &ctx, Intercode const &analysis,
+        runtime::uint256_t const *stack_bottom, runtime::uint256_t *stack_top,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        check_requirements<PUSH2, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 3);
+        check_requirements<JUMPI, traits>(
+            ctx, analysis, stack_bottom, stack_top + 1, gas_remaining);
+        auto const &cond = pop(stack_top);
+
+        if (cond) {
+            auto const target = runtime::uint256_t{
+                (std::uint64_t{instr_ptr[1]} << 8) | instr_ptr[2]};
+            auto const *const new_ip = jump_impl(ctx, analysis, target);
+            on_dispatch(ctx, analysis, gas_remaining, new_ip);
+            MONAD_VM_MUST_TAIL return instruction_table<traits>[*new_ip](
+                ctx, analysis, stack_bottom, stack_top, gas_remaining, new_ip);
+        }
+
+        MONAD_VM_NEXT_FUSED(4, 0);
+    }
+
+    template <Traits traits>
+    MONAD_VM_INSTRUCTION_CALL void push2_jump(
+        runtime::Context &ctx, Intercode const &analysis,
+        runtime::uint256_t const *stack_bottom, runtime::uint256_t *stack_top,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        check_requirements<PUSH2, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 3);
+        check_requirements<JUMP, traits>(
+            ctx, analysis, stack_bottom, stack_top + 1, gas_remaining);
+        auto const target = runtime::uint256_t{
+            (std::uint64_t{instr_ptr[1]} << 8) | instr_ptr[2]};
+        auto const *const new_ip = jump_impl(ctx, analysis, target);
+
+        on_dispatch(ctx, analysis, gas_remaining, new_ip);
+        MONAD_VM_MUST_TAIL return instruction_table<traits>[*new_ip](
+            ctx, analysis, stack_bottom, stack_top, gas_remaining, new_ip);
+    }
+
+    template <Traits traits>
+    MONAD_VM_INSTRUCTION_CALL void swap1_pop(
+        runtime::Context &ctx, Intercode const &analysis,
+        runtime::uint256_t const *stack_bottom, runtime::uint256_t *stack_top,
+        std::int64_t gas_remaining, std::uint8_t const *instr_ptr)
+    {
+        check_requirements<SWAP1, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        on_dispatch(ctx, analysis, gas_remaining, instr_ptr + 1);
+        check_requirements<POP, traits>(
+            ctx, analysis, stack_bottom, stack_top, gas_remaining);
+        *(stack_top - 1) = *stack_top;
+
+        MONAD_VM_NEXT_FUSED(2, -1);
+    }
+
     // Logging
     template <std::size_t N, Traits traits>
         requires(N <= 4)
@@ -1790,3 +1893,4 @@ namespace monad::vm::interpreter
 #undef MONAD_VM_MUST_TAIL
 #undef MONAD_VM_NEXT
 #undef MONAD_VM_NEXT_PUSH
+#undef MONAD_VM_NEXT_FUSED
@@ -18,9 +18,13 @@
 #include <category/vm/interpreter/intercode.hpp>
 
 #include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <span>
 
+#include <immintrin.h>
+
 using namespace monad::vm::compiler;
 
 namespace monad::vm::interpreter
@@ -30,11 +34,26 @@ namespace monad::vm::interpreter
         , code_size_(
               code_size_t::unsafe_from(static_cast<uint32_t>(code.size())))
         , jumpdest_map_(find_jumpdests(code))
+        , instructions_(fuse_instructions(padded_code_, code))
+    {
+    }
+
+    Intercode::Intercode(
+        std::span<std::uint8_t const> const code,
+        std::span<std::uint8_t const> const jumpdest_bits)
+        : padded_code_(pad(code))
+        , code_size_(
+              code_size_t::unsafe_from(static_cast<uint32_t>(code.size())))
+        , jumpdest_map_(unpack_jumpdests(code.size(), jumpdest_bits))
+        , instructions_(fuse_instructions(padded_code_, code))
     {
     }
 
     Intercode::~Intercode()
     {
+        if (instructions_ != padded_code_) {
+            delete[] (instructions_ - start_padding_size);
+        }
         delete[] (padded_code_ - start_padding_size);
     }
 
@@ -57,7 +76,44 @@ namespace monad::vm::interpreter
     {
         auto jumpdests = JumpdestMap(code.size(), false);
 
-        for (auto i = 0u; i < code.size(); ++i) {
+        auto i = 0u;
+#ifdef __AVX2__
+        // Classify 32 bytes at a time. The bytes before the first PUSH of
+        // a chunk are all opcodes, so their JUMPDESTs are found at once,
+        // and only the PUSH itself is decoded to skip its immediate.
+        __m256i const push_bits = _mm256_set1_epi8(static_cast<char>(0xE0));
+        __m256i const push_ops = _mm256_set1_epi8(static_cast<char>(PUSH1));
+        __m256i const jumpdest_ops =
+            _mm256_set1_epi8(static_cast<char>(JUMPDEST));
+        while (i + 32 <= code.size()) {
+            __m256i const v = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const *>(code.data() + i));
+            // PUSH1 to PUSH32 are 0x60 to 0x7F.
+            __m256i const masked = _mm256_and_si256(v, push_bits);
+            auto const push_mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(masked, push_ops)));
+            auto jumpdest_mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, jumpdest_ops)));
+            auto const n = push_mask == 0
+                               ? 32u
+                               : static_cast<unsigned>(
+                                     std::countr_zero(push_mask));
+            if (n < 32) {
+                jumpdest_mask &= (std::uint32_t{1} << n) - 1;
+            }
+            while (jumpdest_mask != 0) {
+                jumpdests[i + static_cast<unsigned>(
+                                  std::countr_zero(jumpdest_mask))] = true;
+                jumpdest_mask &= jumpdest_mask - 1;
+            }
+            i += n;
+            if (n < 32) {
+                i += 1 + get_push_opcode_index(code[i]);
+            }
+        }
+#endif
+
+        for (; i < code.size(); ++i) {
             auto const op = code[i];
 
             if (op == EvmOpCode::JUMPDEST) {
@@ -71,4 +127,97 @@ namespace monad::vm::interpreter
 
         return jumpdests;
     }
+
+    auto Intercode::unpack_jumpdests(
+        std::size_t const code_size,
+        std::span<std::uint8_t const> const jumpdest_bits) -> JumpdestMap
+    {
+        MONAD_VM_ASSERT(
+            jumpdest_bits.size() == packed_jumpdests_size(code_size));
+        auto jumpdests = JumpdestMap(code_size, false);
+        for (std::size_t i = 0; i < jumpdest_bits.size(); ++i) {
+            for (unsigned bits = jumpdest_bits[i]; bits != 0;
+                 bits &= bits - 1) {
+                auto const pc =
+                    8 * i + static_cast<unsigned>(std::countr_zero(bits));
+                // bits past the end of the code are ignored
+                if (pc < code_size) {
+                    jumpdests[pc] = true;
+                }
+            }
+        }
+        return jumpdests;
+    }
+
+    void
+    Intercode::pack_jumpdests(std::span<std::uint8_t> const out) const noexcept
+    {
+        MONAD_VM_ASSERT(out.size() == packed_jumpdests_size(size()));
+        std::fill(out.begin(), out.end(), std::uint8_t{0});
+        for (std::size_t pc = 0; pc < size(); ++pc) {
+            if (jumpdest_map_[pc]) {
+                out[pc / 8] |= static_cast<std::uint8_t>(1u << (pc % 8));
+            }
+        }
+    }
+
+    std::uint8_t const *Intercode::fuse_instructions(
+        std::uint8_t const *padded_code,
+        std::span<std::uint8_t const> const code)
+    {
+        auto const at = [code](std::size_t const i) -> std::uint8_t {
+            return i < code.size() ? code[i] : std::uint8_t{STOP};
+        };
+
+        auto const fused_op = [&at](std::size_t const i) -> std::uint8_t {
+            switch (at(i)) {
+            case PUSH1:
+                return at(i + 2) == ADD ? PUSH1_ADD : at(i);
+            case PUSH2:
+                if (at(i + 3) == JUMPI) {
+                    return PUSH2_JUMPI;
+                }
+                return at(i + 3) == JUMP ? PUSH2_JUMP : at(i);
+            case DUP2:
+                return (at(i + 1) == DUP2 && at(i + 2) == LT) ? DUP2_DUP2_LT
+                                                               : at(i);
+            case SWAP1:
+                return at(i + 1) == POP ? SWAP1_POP : at(i);
+            case PUSH1_ADD:
+            case DUP2_DUP2_LT:
+            case PUSH2_JUMPI:
+            case PUSH2_JUMP:
+            case SWAP1_POP:
+                // These are invalid instructions in the original code, so
+                // dispatch them to the designated invalid instruction.
+                return 0xFE;
+            default:
+                return at(i);
+            }
+        };
+
+        std::uint8_t *buffer = nullptr;
+        for (auto i = 0u; i < code.size(); ++i) {
+            auto const op = fused_op(i);
+            if (op != code[i]) {
+                if (buffer == nullptr) {
+                    auto const buffer_size =
+                        start_padding_size + code.size() + end_padding_size;
+                    buffer = new std::uint8_t[buffer_size];
+                    std::copy_n(
+                        padded_code - start_padding_size,
+                        buffer_size,
+                        buffer);
+                    buffer += start_padding_size;
+                }
+                buffer[i] = op;
+            }
+
+            if (is_push_opcode(code[i])) {
+                i += get_push_opcode_index(code[i]);
+            }
+        }
+
+        return buffer == nullptr ? padded_code : buffer;
+    }
 }
@@ -26,6 +26,22 @@ namespace monad::vm::interpreter
 {
     using code_size_t = runtime::Bin<20>;
 
+    /**
+     * Byte values that are unassigned in every EVM revision, used in the
+     * interpreter's instruction stream to dispatch common sequences of
+     * instructions to a single fused handler. Only the first byte of a
+     * sequence is rewritten, so that immediate values can still be read
+     * from the instruction stream.
+     */
+    enum FusedOpCode : std::uint8_t
+    {
+        PUSH1_ADD = 0x0C,
+        DUP2_DUP2_LT = 0x0D,
+        PUSH2_JUMPI = 0x0E,
+        PUSH2_JUMP = 0x0F,
+        SWAP1_POP = 0x21,
+    };
+
     class Intercode
     {
         // 30 bytes of initial padding ensures that we can implement all
@@ -48,6 +64,24 @@ namespace monad::vm::interpreter
         {
         }
 
+        /// Construct from `code` and its jump destinations, as written by
+        /// `pack_jumpdests`, without analysing the code for them.
+        Intercode(
+            std::span<std::uint8_t const> code,
+            std::span<std::uint8_t const> jumpdest_bits);
+
+        /// Size in bytes of the packed jump destinations of `code_size`
+        /// bytes of code.
+        static constexpr std::size_t
+        packed_jumpdests_size(std::size_t const code_size) noexcept
+        {
+            return (code_size + 7) / 8;
+        }
+
+        /// Write the jump destinations into `out`, one bit per byte of
+        /// code from the least significant bit of `out[0]`.
+        void pack_jumpdests(std::span<std::uint8_t> out) const noexcept;
+
         ~Intercode();
 
         std::uint8_t const *code() const noexcept
@@ -55,6 +89,14 @@ namespace monad::vm::interpreter
             return padded_code_;
         }
 
+        /// The instruction stream executed by the interpreter. It has the
+        /// same layout as `code()`, but the first instruction of each
+        /// recognized sequence is replaced by its `FusedOpCode`.
+        std::uint8_t const *instructions() const noexcept
+        {
+            return instructions_;
+        }
+
         code_size_t code_size() const noexcept
         {
             return code_size_;
@@ -79,11 +121,20 @@ namespace monad::vm::interpreter
         std::uint8_t const *padded_code_;
         code_size_t code_size_;
         JumpdestMap jumpdest_map_;
+        std::uint8_t const *instructions_;
 
         static std::uint8_t const *
         pad(std::span<std::uint8_t const> const code);
 
+        static std::uint8_t const *fuse_instructions(
+            std::uint8_t const *padded_code,
+            std::span<std::uint8_t const> const code);
+
         static JumpdestMap
         find_jumpdests(std::span<std::uint8_t const> const code);
+
+        static JumpdestMap unpack_jumpdests(
+            std::size_t code_size,
+            std::span<std::uint8_t const> const jumpdest_bits);
     };
 }
@@ -0,0 +1,44 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/interpreter/opcode_counts.hpp>
+
+#include <cstdint>
+
+namespace monad::vm::interpreter
+{
+    void OpcodeCounts::record(
+        std::uint8_t const opcode, std::int64_t const gas_remaining)
+    {
+        if (started_) {
+            gas[last_opcode_] +=
+                static_cast<std::uint64_t>(last_gas_ - gas_remaining);
+            ++pairs[static_cast<std::uint16_t>((last_opcode_ << 8) | opcode)];
+        }
+        ++count[opcode];
+        last_opcode_ = opcode;
+        last_gas_ = gas_remaining;
+        started_ = true;
+    }
+
+    void OpcodeCounts::finish(std::int64_t const gas_left) noexcept
+    {
+        if (started_ && last_gas_ > gas_left) {
+            gas[last_opcode_] +=
+                static_cast<std::uint64_t>(last_gas_ - gas_left);
+        }
+        last_gas_ = gas_left;
+    }
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace monad::vm::interpreter
+{
+    /// Counts of the instructions executed by the interpreter in one call
+    /// frame, recorded while `runtime::Context::opcode_counts` points to
+    /// them. Each instruction is charged the gas consumed from its dispatch
+    /// to the dispatch of the next instruction, so the gas includes the
+    /// dynamic costs. The instructions of a fused sequence are recorded one
+    /// by one.
+    class OpcodeCounts
+    {
+    public:
+        std::array<std::uint64_t, 256> count{};
+        std::array<std::uint64_t, 256> gas{};
+        /// Executions of each pair of consecutive instructions, keyed by
+        /// the opcode of the first instruction in the high byte.
+        std::unordered_map<std::uint16_t, std::uint64_t> pairs{};
+
+        /// Called by the interpreter before dispatching to `opcode`.
+        void record(std::uint8_t opcode, std::int64_t gas_remaining);
+
+        /// Charge the last instruction, after which the frame returned
+        /// `gas_left`.
+        void finish(std::int64_t gas_left) noexcept;
+
+        bool empty() const noexcept
+        {
+            return !started_;
+        }
+
+    private:
+        std::uint8_t last_opcode_{};
+        std::int64_t last_gas_{};
+        bool started_{};
+    };
+}
@@ -13,63 +13,101 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <category/vm/llvm/execute.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/compiler.hpp>
+#include <category/vm/evm/switch_traits.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/execute.hpp>
 #include <category/vm/llvm/llvm.hpp>
-#include <category/vm/llvm/llvm_state.hpp>
+#include <category/vm/llvm/optimizing_tier.hpp>
 #include <category/vm/runtime/types.hpp>
-#include <category/vm/runtime/uint256.hpp>
+#include <category/vm/utils/debug.hpp>
 
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
 #include <cstddef>
 #include <cstdint>
-#include <memory>
-#include <span>
-#include <unordered_map>
-
-#ifdef MONAD_VM_LLVM_DEBUG
-    #include <category/vm/utils/evmc_utils.hpp>
-
-    #include <cstdlib>
-    #include <format>
-    #include <string>
-#endif
 
 namespace monad::vm::llvm
 {
-    VM::VM(std::size_t max_stack_cache, std::size_t max_memory_cache)
-        : stack_allocator_{max_stack_cache}
+    VM::VM(
+        std::size_t max_stack_cache, std::size_t max_memory_cache,
+        bool enable_async, unsigned compile_threads)
+        : compiler_{
+              enable_async, Compiler::default_compile_job_soft_limit,
+              compile_threads}
+        , stack_allocator_{max_stack_cache}
         , memory_allocator_{max_memory_cache}
-        , cached_llvm_code_(
-              EVMC_MAX_REVISION + 1,
-              std::unordered_map<evmc::bytes32, std::shared_ptr<LLVMState>>())
     {
+        compiler_.enable_optimizing_tier(make_optimizing_tier());
     }
 
-    std::shared_ptr<LLVMState> VM::cache_llvm(
-        evmc_revision rev, evmc::bytes32 const &code_hash, uint8_t const *code,
-        size_t code_size)
+    SharedVarcode VM::get_varcode(
+        evmc::bytes32 const &code_hash, uint8_t const *code, size_t code_size)
     {
-        auto item = cached_llvm_code_[rev].find(code_hash);
-        if (item != cached_llvm_code_[rev].end()) {
-            return item->second;
+        if (auto vcode = compiler_.find_varcode(code_hash)) {
+            return *vcode;
         }
+        return compiler_.try_insert_varcode(
+            code_hash, make_shared_intercode(code, code_size));
+    }
 
-#ifdef MONAD_VM_LLVM_DEBUG
-        auto const *isq = std::getenv("MONAD_VM_LLVM_DEBUG");
-        auto code_hash_str = monad::vm::utils::hex_string(code_hash);
-        std::string const hash_str =
-            std::format("{}_{}", (int)rev, code_hash_str);
-        std::string const dbg_nm = isq ? "t" + hash_str : "";
-        auto ptr = monad::vm::llvm::compile(rev, {code, code_size}, dbg_nm);
-#else
-        auto ptr = monad::vm::llvm::compile(rev, {code, code_size});
-#endif
+    template <Traits traits>
+    SharedNativecode VM::cache_llvm_impl(
+        evmc::bytes32 const &code_hash, uint8_t const *code, size_t code_size)
+    {
+        auto const vcode = get_varcode(code_hash, code, code_size);
+        return compiler_.cached_optimize<traits>(code_hash, vcode->intercode());
+    }
+
+    SharedNativecode VM::cache_llvm(
+        evmc_revision rev, evmc::bytes32 const &code_hash, uint8_t const *code,
+        size_t code_size)
+    {
+        SWITCH_EVM_TRAITS(cache_llvm_impl, code_hash, code, code_size);
+        MONAD_VM_ASSERT(false);
+    }
 
-        cached_llvm_code_[rev].insert({code_hash, ptr});
+    template <Traits traits>
+    evmc::Result VM::execute_llvm_impl(
+        evmc::bytes32 const &code_hash, evmc_host_interface const *host,
+        evmc_host_context *context, evmc_message const *msg,
+        uint8_t const *code, size_t code_size)
+    {
+        auto const vcode = get_varcode(code_hash, code, code_size);
+        auto const &icode = vcode->intercode();
+        auto const &ncode = vcode->nativecode();
+        auto rt_ctx = runtime::Context::from(
+            memory_allocator_, host, context, msg, icode->code_span());
+        auto const stack_ptr = stack_allocator_.allocate();
 
-        return ptr;
+        if (MONAD_VM_LIKELY(
+                ncode != nullptr && ncode->chain_id() == traits::id())) {
+            if (auto const entry = ncode->entrypoint(); entry != nullptr) {
+                entry(&rt_ctx, stack_ptr.get());
+                return rt_ctx.copy_to_evmc_result();
+            }
+            // The LLVM backend failed to compile this contract, so just
+            // execute with interpreter.
+        }
+        else {
+            // Not compiled for this revision yet, which the next
+            // executions will pick up once the compile threads are done.
+            // Execute with interpreter in the meantime.
+            auto const msg_gas = rt_ctx.gas_remaining;
+            interpreter::execute<traits>(rt_ctx, *icode, stack_ptr.get());
+            auto result = rt_ctx.copy_to_evmc_result();
+            MONAD_VM_DEBUG_ASSERT(msg_gas >= result.gas_left);
+            compiler_.async_optimize<traits>(
+                code_hash,
+                icode,
+                vcode->intercode_gas_used(
+                    static_cast<uint64_t>(msg_gas - result.gas_left)));
+            return result;
+        }
+        interpreter::execute<traits>(rt_ctx, *icode, stack_ptr.get());
+        return rt_ctx.copy_to_evmc_result();
     }
 
     evmc::Result VM::execute_llvm(
@@ -77,17 +115,8 @@ namespace monad::vm::llvm
         evmc_host_interface const *host, evmc_host_context *context,
         evmc_message const *msg, uint8_t const *code, size_t code_size)
     {
-        auto ctx = runtime::Context::from(
-            memory_allocator_, host, context, msg, {code, code_size});
-
-        auto const stack_ptr = stack_allocator_.allocate();
-        uint256_t *evm_stack = reinterpret_cast<uint256_t *>(stack_ptr.get());
-
-        auto llvm = cache_llvm(rev, code_hash, code, code_size);
-
-        monad::vm::llvm::execute(*llvm, ctx, evm_stack);
-
-        return ctx.copy_to_evmc_result();
+        SWITCH_EVM_TRAITS(
+            execute_llvm_impl, code_hash, host, context, msg, code, code_size);
+        MONAD_VM_ASSERT(false);
     }
-
 }
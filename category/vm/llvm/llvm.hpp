@@ -15,35 +15,69 @@
 
 #pragma once
 
+#include <category/vm/code.hpp>
+#include <category/vm/compiler.hpp>
+#include <category/vm/evm/traits.hpp>
 #include <category/vm/runtime/allocator.hpp>
 
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
 namespace monad::vm::llvm
 {
-    struct LLVMState; // forward declaration so we don't have to pull in all the
-                      // LLVM includes
-
+    /// Executes contracts compiled by the LLVM backend. Compiled code is
+    /// shared through the varcode cache of a `Compiler` whose optimizing
+    /// tier is the LLVM backend, so a `VM` may execute on several threads
+    /// or fibers at once.
     class VM
     {
+        Compiler compiler_;
         runtime::EvmStackAllocator stack_allocator_;
         runtime::EvmMemoryAllocator memory_allocator_;
-        std::vector<
-            std::unordered_map<evmc::bytes32, std::shared_ptr<LLVMState>>>
-            cached_llvm_code_;
 
     public:
         explicit VM(
             std::size_t max_stack_cache_byte_size =
                 runtime::EvmStackAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
             std::size_t max_memory_cache_byte_size =
-                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE);
+                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
+            bool enable_async = true, unsigned compile_threads = 1);
+
+        Compiler &compiler()
+        {
+            return compiler_;
+        }
 
+        /// Execute with the LLVM compiled code of `code_hash` if cached.
+        /// Otherwise queue it for compilation on the compile threads, and
+        /// execute with the interpreter in the meantime.
         evmc::Result execute_llvm(
             evmc_revision rev, evmc::bytes32 const &code_hash,
             evmc_host_interface const *host, evmc_host_context *context,
             evmc_message const *msg, uint8_t const *code, size_t code_size);
 
-        std::shared_ptr<LLVMState> cache_llvm(
+        /// Find LLVM compiled code in cache, else compile it on the calling
+        /// thread and add it to cache.
+        SharedNativecode cache_llvm(
             evmc_revision rev, evmc::bytes32 const &code_hash,
             uint8_t const *code, size_t code_size);
+
+    private:
+        template <Traits traits>
+        evmc::Result execute_llvm_impl(
+            evmc::bytes32 const &code_hash, evmc_host_interface const *host,
+            evmc_host_context *context, evmc_message const *msg,
+            uint8_t const *code, size_t code_size);
+
+        template <Traits traits>
+        SharedNativecode cache_llvm_impl(
+            evmc::bytes32 const &code_hash, uint8_t const *code,
+            size_t code_size);
+
+        SharedVarcode
+        get_varcode(evmc::bytes32 const &, uint8_t const *, size_t);
     };
 }
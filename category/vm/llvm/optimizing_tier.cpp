@@ -0,0 +1,136 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
+#include <category/vm/llvm/execute.hpp>
+#include <category/vm/llvm/llvm_state.hpp>
+#include <category/vm/llvm/optimizing_tier.hpp>
+#include <category/vm/optimizing_tier.hpp>
+#include <category/vm/runtime/types.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <asmjit/x86.h>
+
+#include <llvm-c/Target.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <variant>
+
+#ifdef MONAD_VM_LLVM_DEBUG
+    #include <category/vm/utils/evmc_utils.hpp>
+
+    #include <cstdlib>
+    #include <format>
+#endif
+
+namespace monad::vm::llvm
+{
+    extern "C" void llvm_runtime_trampoline(
+        uint256_t *, Context *, void (*)(), void **);
+
+    namespace
+    {
+        using compiler::native::entrypoint_t;
+        using compiler::native::native_code_size_t;
+
+        class LLVMOptimizingTier final : public OptimizingTier
+        {
+        public:
+            LLVMOptimizingTier()
+            {
+                static std::once_flag init_flag;
+                std::call_once(init_flag, [] {
+                    LLVMInitializeNativeTarget();
+                    LLVMInitializeNativeAsmPrinter();
+                });
+            }
+
+            SharedNativecode compile(
+                asmjit::JitRuntime &asmjit_rt, evmc_revision const rev,
+                uint64_t const chain_id,
+                [[maybe_unused]] evmc::bytes32 const &code_hash,
+                SharedIntercode const &icode) override
+            {
+#ifdef MONAD_VM_LLVM_DEBUG
+                auto const *isq = std::getenv("MONAD_VM_LLVM_DEBUG");
+                std::string const dbg_nm =
+                    isq ? std::format(
+                              "t{}_{}",
+                              static_cast<int>(rev),
+                              monad::vm::utils::hex_string(code_hash))
+                        : "";
+#else
+                std::string const dbg_nm;
+#endif
+                std::shared_ptr<LLVMState> state;
+                {
+                    // The LLVM backend was written for single threaded
+                    // use, so compile one contract at a time.
+                    std::lock_guard const lock{mutex_};
+                    state = monad::vm::llvm::compile(
+                        rev, icode->code_span(), dbg_nm);
+                }
+
+                // Adapt the calling convention of the baseline native code,
+                // `entry(ctx, stack)`, to the one of the LLVM backend.
+                namespace x86 = asmjit::x86;
+                asmjit::CodeHolder code;
+                code.init(asmjit_rt.environment(), asmjit_rt.cpuFeatures());
+                x86::Assembler as{&code};
+                as.mov(x86::rax, x86::rdi);
+                as.mov(x86::rdi, x86::rsi);
+                as.mov(x86::rsi, x86::rax);
+                as.mov(
+                    x86::rdx, reinterpret_cast<uint64_t>(state->contract_addr));
+                as.lea(
+                    x86::rcx,
+                    x86::qword_ptr(
+                        x86::rax, runtime::context_offset_exit_stack_ptr));
+                as.mov(
+                    x86::rax,
+                    reinterpret_cast<uint64_t>(&llvm_runtime_trampoline));
+                as.jmp(x86::rax);
+
+                entrypoint_t entry = nullptr;
+                if (asmjit_rt.add(&entry, &code) != asmjit::kErrorOk) {
+                    return std::make_shared<Nativecode>(
+                        asmjit_rt, chain_id, nullptr, std::monostate{});
+                }
+                return std::make_shared<Nativecode>(
+                    asmjit_rt,
+                    chain_id,
+                    entry,
+                    native_code_size_t::unsafe_from(
+                        static_cast<uint32_t>(code.codeSize())),
+                    std::move(state));
+            }
+
+        private:
+            std::mutex mutex_;
+        };
+    }
+
+    std::unique_ptr<OptimizingTier> make_optimizing_tier()
+    {
+        return std::make_unique<LLVMOptimizingTier>();
+    }
+}
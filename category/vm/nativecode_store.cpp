@@ -0,0 +1,407 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
+#include <category/vm/core/assert.h>
+#include <category/vm/interpreter/intercode.hpp>
+#include <category/vm/nativecode_store.hpp>
+#include <category/vm/runtime/types.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <asmjit/x86.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace monad::vm::compiler::native;
+
+namespace
+{
+    constexpr std::array<char, 8> file_magic{
+        'M', 'O', 'N', 'A', 'D', 'V', 'M', 'C'};
+    constexpr uint32_t file_version = 1;
+    constexpr size_t max_build_id_size = 64;
+
+    static_assert(std::is_trivially_copyable_v<asmjit::CpuFeatures>);
+
+    struct Header
+    {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t build_id_size;
+        std::array<uint8_t, max_build_id_size> build_id;
+        std::array<uint8_t, sizeof(asmjit::CpuFeatures)> cpu_features;
+        evmc::bytes32 code_hash;
+        uint64_t chain_id;
+        uint32_t bytecode_size;
+        uint32_t code_size;
+        uint32_t code_size_estimate;
+        uint32_t num_relocations;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+
+    /// A slot of the code image holding the address of a runtime
+    /// function, stored relative to the load address of its module.
+    struct Relocation
+    {
+        uint32_t offset;
+        uint32_t reserved;
+        uint64_t module_offset;
+    };
+
+    /// The ELF object the runtime functions called by native code are
+    /// linked into, i.e. the executable or the shared library.
+    struct Module
+    {
+        uintptr_t anchor;
+        uintptr_t base;
+        uintptr_t begin;
+        uintptr_t end;
+        std::vector<uint8_t> build_id;
+    };
+
+    void find_build_id(dl_phdr_info const &info, Module &m)
+    {
+        for (ElfW(Half) i = 0; i < info.dlpi_phnum; ++i) {
+            auto const &ph = info.dlpi_phdr[i];
+            if (ph.p_type != PT_NOTE) {
+                continue;
+            }
+            size_t const align = ph.p_align == 8 ? 8 : 4;
+            auto const round = [align](size_t x) {
+                return (x + align - 1) & ~(align - 1);
+            };
+            auto const *p =
+                reinterpret_cast<uint8_t const *>(info.dlpi_addr + ph.p_vaddr);
+            auto const *const end = p + ph.p_memsz;
+            while (p + sizeof(ElfW(Nhdr)) <= end) {
+                ElfW(Nhdr) note;
+                std::memcpy(&note, p, sizeof(note));
+                auto const *const name = p + sizeof(ElfW(Nhdr));
+                auto const *const desc = name + round(note.n_namesz);
+                auto const *const next = desc + round(note.n_descsz);
+                if (next > end) {
+                    break;
+                }
+                if (note.n_type == NT_GNU_BUILD_ID && note.n_namesz == 4 &&
+                    std::memcmp(name, "GNU", 4) == 0 &&
+                    note.n_descsz <= max_build_id_size) {
+                    m.build_id.assign(desc, desc + note.n_descsz);
+                    return;
+                }
+                p = next;
+            }
+        }
+    }
+
+    int find_module(dl_phdr_info *const info, size_t, void *const data)
+    {
+        auto &m = *static_cast<Module *>(data);
+        uintptr_t begin = UINTPTR_MAX;
+        uintptr_t end = 0;
+        for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+            auto const &ph = info->dlpi_phdr[i];
+            if (ph.p_type == PT_LOAD) {
+                uintptr_t const seg = info->dlpi_addr + ph.p_vaddr;
+                begin = std::min(begin, seg);
+                end = std::max(end, seg + ph.p_memsz);
+            }
+        }
+        if (m.anchor < begin || m.anchor >= end) {
+            return 0;
+        }
+        m.base = info->dlpi_addr;
+        m.begin = begin;
+        m.end = end;
+        find_build_id(*info, m);
+        return 1;
+    }
+
+    std::vector<uint8_t> host_cpu_features()
+    {
+        auto const &features = asmjit::CpuInfo::host().features();
+        auto const *const p = reinterpret_cast<uint8_t const *>(&features);
+        return {p, p + sizeof(features)};
+    }
+}
+
+namespace monad::vm
+{
+    NativecodeStore::NativecodeStore(std::filesystem::path dir)
+        : dir_{std::move(dir)}
+        , cpu_features_{host_cpu_features()}
+    {
+        std::filesystem::create_directories(dir_);
+        Module m{
+            .anchor = reinterpret_cast<uintptr_t>(
+                &monad_vm_runtime_increase_memory_raw),
+            .base = 0,
+            .begin = 0,
+            .end = 0,
+            .build_id = {}};
+        if (dl_iterate_phdr(find_module, &m) != 0) {
+            build_id_ = std::move(m.build_id);
+            module_base_ = m.base;
+            module_begin_ = m.begin;
+            module_end_ = m.end;
+        }
+    }
+
+    std::filesystem::path
+    NativecodeStore::path_of(evmc::bytes32 const &code_hash) const
+    {
+        std::string name;
+        name.reserve(2 * sizeof(code_hash.bytes));
+        for (uint8_t const b : code_hash.bytes) {
+            std::format_to(std::back_inserter(name), "{:02x}", b);
+        }
+        return dir_ / name;
+    }
+
+    bool NativecodeStore::save(
+        evmc::bytes32 const &code_hash, uint64_t const chain_id,
+        SharedIntercode const &icode, CodeImage const &image) const
+    {
+        if (!enabled() || !image.relocatable) {
+            return false;
+        }
+        std::vector<Relocation> relocations;
+        relocations.reserve(image.external_function_offsets.size());
+        for (uint32_t const offset : image.external_function_offsets) {
+            MONAD_VM_ASSERT(offset + sizeof(uint64_t) <= image.code.size());
+            uint64_t addr;
+            std::memcpy(&addr, image.code.data() + offset, sizeof(addr));
+            if (addr < module_begin_ || addr >= module_end_) {
+                // Only the load address of the module holding the runtime
+                // is known, so code calling into any other object cannot
+                // be relocated.
+                return false;
+            }
+            relocations.push_back(
+                {.offset = offset,
+                 .reserved = 0,
+                 .module_offset = addr - module_base_});
+        }
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        h.magic = file_magic;
+        h.version = file_version;
+        h.build_id_size = static_cast<uint32_t>(build_id_.size());
+        std::ranges::copy(build_id_, h.build_id.begin());
+        std::ranges::copy(cpu_features_, h.cpu_features.begin());
+        h.code_hash = code_hash;
+        h.chain_id = chain_id;
+        h.bytecode_size = *icode->code_size();
+        h.code_size = static_cast<uint32_t>(image.code.size());
+        h.code_size_estimate = *image.code_size_estimate;
+        h.num_relocations = static_cast<uint32_t>(relocations.size());
+
+        // Write to a file private to this thread and rename it into
+        // place, so that readers never see a partially written image.
+        auto const path = path_of(code_hash);
+        auto tmp = path;
+        auto const thread_id = std::this_thread::get_id();
+        tmp += std::format(
+            ".{}.tmp", std::hash<std::thread::id>{}(thread_id));
+        std::error_code ec;
+        {
+            std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+            out.write(reinterpret_cast<char const *>(&h), sizeof(h));
+            out.write(
+                reinterpret_cast<char const *>(relocations.data()),
+                static_cast<std::streamsize>(
+                    relocations.size() * sizeof(Relocation)));
+            out.write(
+                reinterpret_cast<char const *>(icode->code()),
+                static_cast<std::streamsize>(h.bytecode_size));
+            out.write(
+                reinterpret_cast<char const *>(image.code.data()),
+                static_cast<std::streamsize>(image.code.size()));
+            out.close();
+            if (!out) {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool NativecodeStore::load_file(
+        std::filesystem::path const &path, asmjit::JitRuntime &rt,
+        evmc::bytes32 const *const code_hash, uint64_t const *const chain_id,
+        LoadCallback const &f) const
+    {
+        int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        auto const size = static_cast<size_t>(st.st_size);
+        void *const map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+
+        auto const parse = [&](std::span<uint8_t const> const bytes) {
+            Header h;
+            std::memcpy(&h, bytes.data(), sizeof(h));
+            if (h.magic != file_magic || h.version != file_version ||
+                h.build_id_size != build_id_.size() ||
+                !std::equal(
+                    build_id_.begin(), build_id_.end(), h.build_id.begin()) ||
+                !std::ranges::equal(cpu_features_, h.cpu_features)) {
+                return false;
+            }
+            if ((code_hash && h.code_hash != *code_hash) ||
+                (chain_id && h.chain_id != *chain_id)) {
+                return false;
+            }
+            if (h.bytecode_size > interpreter::code_size_t::upper ||
+                h.code_size_estimate > native_code_size_t::upper ||
+                h.code_size < sizeof(uint64_t)) {
+                return false;
+            }
+            size_t const relocations_size =
+                size_t{h.num_relocations} * sizeof(Relocation);
+            if (bytes.size() != sizeof(Header) + relocations_size +
+                                    h.bytecode_size + h.code_size) {
+                return false;
+            }
+            auto const relocations = bytes.subspan(sizeof(Header));
+            auto const bytecode = relocations.subspan(relocations_size);
+            auto const code = bytecode.subspan(h.bytecode_size);
+
+            std::vector<uint8_t> patched{code.begin(), code.end()};
+            for (uint32_t i = 0; i < h.num_relocations; ++i) {
+                Relocation r;
+                std::memcpy(
+                    &r, relocations.data() + i * sizeof(Relocation), sizeof(r));
+                uint64_t const addr = module_base_ + r.module_offset;
+                if (r.offset > h.code_size - sizeof(uint64_t) ||
+                    addr < module_begin_ || addr >= module_end_) {
+                    return false;
+                }
+                std::memcpy(patched.data() + r.offset, &addr, sizeof(addr));
+            }
+
+            asmjit::CodeHolder holder;
+            if (holder.init(rt.environment(), rt.cpuFeatures()) !=
+                asmjit::kErrorOk) {
+                return false;
+            }
+            asmjit::x86::Assembler as{&holder};
+            if (as.embed(patched.data(), patched.size()) != asmjit::kErrorOk) {
+                return false;
+            }
+            entrypoint_t entry;
+            if (rt.add(&entry, &holder) != asmjit::kErrorOk) {
+                return false;
+            }
+            f(h.code_hash,
+              make_shared_intercode(bytecode.data(), h.bytecode_size),
+              std::make_shared<Nativecode>(
+                  rt,
+                  h.chain_id,
+                  entry,
+                  native_code_size_t::unsafe_from(h.code_size_estimate)));
+            return true;
+        };
+
+        bool const ok = parse({static_cast<uint8_t const *>(map), size});
+        ::munmap(map, size);
+        return ok;
+    }
+
+    SharedNativecode NativecodeStore::load(
+        asmjit::JitRuntime &rt, evmc::bytes32 const &code_hash,
+        uint64_t const chain_id) const
+    {
+        if (!enabled()) {
+            return nullptr;
+        }
+        SharedNativecode ncode;
+        load_file(
+            path_of(code_hash),
+            rt,
+            &code_hash,
+            &chain_id,
+            [&](auto const &, auto const &, SharedNativecode const &x) {
+                ncode = x;
+            });
+        return ncode;
+    }
+
+    size_t NativecodeStore::load_all(
+        asmjit::JitRuntime &rt, LoadCallback const &f) const
+    {
+        if (!enabled()) {
+            return 0;
+        }
+        size_t n = 0;
+        std::error_code ec;
+        for (auto const &entry :
+             std::filesystem::directory_iterator{dir_, ec}) {
+            if (!entry.is_regular_file(ec) ||
+                entry.path().extension() == ".tmp") {
+                continue;
+            }
+            if (load_file(entry.path(), rt, nullptr, nullptr, f)) {
+                ++n;
+            }
+            else {
+                // Written by another build, for another CPU, or damaged.
+                std::filesystem::remove(entry.path(), ec);
+            }
+        }
+        return n;
+    }
+}
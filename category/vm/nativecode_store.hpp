@@ -0,0 +1,88 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/code.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <asmjit/x86.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace monad::vm
+{
+    /// Directory of compiled contracts which survives restarts. There is
+    /// one file per code hash, holding the bytecode, the chain id it was
+    /// compiled for and the relocatable native code image. A file is only
+    /// accepted by the same build of the binary, identified by its ELF
+    /// build id, on a CPU with the same features.
+    class NativecodeStore
+    {
+    public:
+        using LoadCallback = std::function<void(
+            evmc::bytes32 const &, SharedIntercode const &,
+            SharedNativecode const &)>;
+
+        /// Creates `dir` if it does not exist.
+        explicit NativecodeStore(std::filesystem::path dir);
+
+        /// Whether this build can persist code at all. This is false
+        /// when the binary has no build id to key the images by.
+        bool enabled() const noexcept
+        {
+            return !build_id_.empty();
+        }
+
+        /// Store `image`, compiled from `icode` for `chain_id`, under
+        /// `code_hash`, replacing any previous image. Returns false if
+        /// the image could not be written.
+        bool save(
+            evmc::bytes32 const &code_hash, uint64_t chain_id,
+            SharedIntercode const &icode,
+            compiler::native::CodeImage const &image) const;
+
+        /// Load the code stored under `code_hash` into `rt`. Returns
+        /// `nullptr` if there is no valid image compiled for `chain_id`.
+        SharedNativecode load(
+            asmjit::JitRuntime &rt, evmc::bytes32 const &code_hash,
+            uint64_t chain_id) const;
+
+        /// Load every valid image of the store into `rt`, and pass it
+        /// with its intercode to `f`. Returns the number of images loaded.
+        size_t load_all(asmjit::JitRuntime &rt, LoadCallback const &f) const;
+
+    private:
+        std::filesystem::path path_of(evmc::bytes32 const &) const;
+
+        bool load_file(
+            std::filesystem::path const &, asmjit::JitRuntime &,
+            evmc::bytes32 const *code_hash, uint64_t const *chain_id,
+            LoadCallback const &) const;
+
+        std::filesystem::path dir_;
+        std::vector<uint8_t> build_id_;
+        std::vector<uint8_t> cpu_features_;
+        uintptr_t module_base_{};
+        uintptr_t module_begin_{};
+        uintptr_t module_end_{};
+    };
+}
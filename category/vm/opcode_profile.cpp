@@ -0,0 +1,170 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/core/assert.h>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/opcode_counts.hpp>
+#include <category/vm/opcode_profile.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+namespace
+{
+    std::string opcode_name(uint8_t const opcode)
+    {
+        using Latest = monad::EvmTraits<EVMC_LATEST_STABLE_REVISION>;
+        auto const &info = monad::vm::compiler::opcode_table<Latest>[opcode];
+        if (info == monad::vm::compiler::unknown_opcode_info) {
+            return std::format("0x{:02x}", opcode);
+        }
+        return std::string{info.name};
+    }
+}
+
+namespace monad::vm
+{
+    OpcodeProfile::OpcodeProfile(
+        uint64_t const sample_period, size_t const max_entries)
+        : sample_period_{std::max(sample_period, uint64_t{1})}
+        , max_entries_{max_entries}
+    {
+    }
+
+    OpcodeProfile::~OpcodeProfile()
+    {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard const lock{stop_mutex_};
+                stop_ = true;
+            }
+            stop_cv_.notify_one();
+            thread_.join();
+            save(save_path_);
+        }
+    }
+
+    void OpcodeProfile::record(
+        evmc::bytes32 const &code_hash,
+        interpreter::OpcodeCounts const &counts)
+    {
+        std::lock_guard const lock{mutex_};
+        auto it = map_.find(code_hash);
+        if (it == map_.end()) {
+            if (map_.size() >= max_entries_) {
+                return;
+            }
+            it = map_.emplace(code_hash, Counts{}).first;
+        }
+        auto &c = it->second;
+        ++c.samples;
+        for (size_t i = 0; i < c.count.size(); ++i) {
+            c.count[i] += counts.count[i];
+            c.gas[i] += counts.gas[i];
+        }
+        for (auto const &[pair, n] : counts.pairs) {
+            c.pairs[pair] += n;
+        }
+    }
+
+    bool OpcodeProfile::save(std::filesystem::path const &path) const
+    {
+        // Copied so that recording threads are not held up by the writes
+        Map snapshot;
+        {
+            std::lock_guard const lock{mutex_};
+            snapshot = map_;
+        }
+        auto tmp = path;
+        tmp += ".tmp";
+        std::error_code ec;
+        {
+            std::ofstream out{tmp, std::ios::trunc};
+            out << "code_hash,samples,opcode,next_opcode,count,gas\n";
+            for (auto const &[code_hash, c] : snapshot) {
+                auto const hash = utils::hex_string(code_hash);
+                for (size_t i = 0; i < c.count.size(); ++i) {
+                    if (c.count[i]) {
+                        out << std::format(
+                            "{},{},{},,{},{}\n",
+                            hash,
+                            c.samples,
+                            opcode_name(static_cast<uint8_t>(i)),
+                            c.count[i],
+                            c.gas[i]);
+                    }
+                }
+                for (auto const &[pair, n] : c.pairs) {
+                    out << std::format(
+                        "{},{},{},{},{},\n",
+                        hash,
+                        c.samples,
+                        opcode_name(static_cast<uint8_t>(pair >> 8)),
+                        opcode_name(static_cast<uint8_t>(pair & 0xff)),
+                        n);
+                }
+            }
+            out.close();
+            if (!out) {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    void OpcodeProfile::save_every(
+        std::filesystem::path const &path, std::chrono::seconds const interval)
+    {
+        MONAD_VM_ASSERT(!thread_.joinable());
+        save_path_ = path;
+        save_interval_ = interval;
+        thread_ = std::thread{[this] { save_loop(); }};
+    }
+
+    void OpcodeProfile::save_loop()
+    {
+        std::unique_lock lock{stop_mutex_};
+        while (!stop_cv_.wait_for(
+            lock, save_interval_, [this] { return stop_; })) {
+            save(save_path_);
+        }
+    }
+
+    size_t OpcodeProfile::size() const
+    {
+        std::lock_guard const lock{mutex_};
+        return map_.size();
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/interpreter/opcode_counts.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace monad::vm
+{
+    /// Per code hash opcode statistics of the interpreter, for choosing
+    /// superinstructions, compile priorities and gas prices. One in every
+    /// `sample_period` executions is sampled, and the interpreter records
+    /// every instruction of the sampled frame, see
+    /// `interpreter::OpcodeCounts`. Executions of native code record
+    /// nothing. Safe to use concurrently.
+    class OpcodeProfile
+    {
+    public:
+        static constexpr uint64_t default_sample_period = 1000;
+        static constexpr size_t default_max_entries = size_t{1} << 16;
+
+        explicit OpcodeProfile(
+            uint64_t sample_period = default_sample_period,
+            size_t max_entries = default_max_entries);
+
+        OpcodeProfile(OpcodeProfile const &) = delete;
+        OpcodeProfile &operator=(OpcodeProfile const &) = delete;
+
+        ~OpcodeProfile();
+
+        /// Whether to sample the execution about to start.
+        bool sample() noexcept
+        {
+            return executions_.fetch_add(1, std::memory_order_relaxed) %
+                       sample_period_ ==
+                   0;
+        }
+
+        /// Add the counts of a sampled execution of `code_hash`. Once the
+        /// profile holds `max_entries` code hashes, new ones are ignored.
+        void record(
+            evmc::bytes32 const &code_hash,
+            interpreter::OpcodeCounts const &counts);
+
+        /// Write the profile to `path` as CSV, with one row per opcode and
+        /// one per pair of consecutive opcodes of each code hash. Returns
+        /// false if the file could not be written.
+        bool save(std::filesystem::path const &path) const;
+
+        /// Save the profile to `path` every `interval` from a background
+        /// thread, and once more when the profile is destroyed. Must be
+        /// called at most once.
+        void save_every(
+            std::filesystem::path const &path, std::chrono::seconds interval);
+
+        size_t size() const;
+
+    private:
+        struct Counts
+        {
+            uint64_t samples;
+            std::array<uint64_t, 256> count;
+            std::array<uint64_t, 256> gas;
+            std::unordered_map<uint16_t, uint64_t> pairs;
+        };
+
+        using Map = std::unordered_map<
+            evmc::bytes32, Counts, utils::Hash32Hash, utils::Bytes32Equal>;
+
+        void save_loop();
+
+        uint64_t sample_period_;
+        size_t max_entries_;
+        std::atomic<uint64_t> executions_{0};
+
+        mutable std::mutex mutex_;
+        Map map_;
+
+        std::filesystem::path save_path_;
+        std::chrono::seconds save_interval_{};
+        std::mutex stop_mutex_;
+        std::condition_variable stop_cv_;
+        bool stop_{false};
+        std::thread thread_;
+    };
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/code.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <asmjit/core/jitruntime.h>
+
+#include <cstdint>
+
+namespace monad::vm
+{
+    /// A slower backend producing faster code, which contracts are
+    /// recompiled with once they got hot running baseline native code.
+    class OptimizingTier
+    {
+    public:
+        virtual ~OptimizingTier() = default;
+
+        /// Compile `icode`, whose hash is `code_hash`, for the Ethereum
+        /// revision `rev`. The returned nativecode is tagged with
+        /// `chain_id`, and its entry point is allocated in `asmjit_rt`, or
+        /// `nullptr` if compilation failed. Called from the compile threads
+        /// concurrently.
+        virtual SharedNativecode compile(
+            asmjit::JitRuntime &asmjit_rt, evmc_revision rev,
+            uint64_t chain_id, evmc::bytes32 const &code_hash,
+            SharedIntercode const &icode) = 0;
+    };
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/perf_map.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+namespace monad::vm
+{
+    std::filesystem::path PerfMap::default_path()
+    {
+        return std::format("/tmp/perf-{}.map", getpid());
+    }
+
+    PerfMap::PerfMap(std::filesystem::path const &path)
+        : file_{std::fopen(path.c_str(), "a")}
+    {
+    }
+
+    PerfMap::~PerfMap()
+    {
+        if (file_) {
+            (void)std::fclose(file_);
+        }
+    }
+
+    void PerfMap::add(
+        void const *const code, size_t const size,
+        evmc::bytes32 const &code_hash)
+    {
+        if (!file_ || size == 0) {
+            return;
+        }
+        write(std::format(
+            "{:x} {:x} evm_{}\n",
+            reinterpret_cast<std::uintptr_t>(code),
+            size,
+            utils::hex_string(code_hash)));
+    }
+
+    void PerfMap::add(
+        compiler::native::CodeImage const &image,
+        evmc::bytes32 const &code_hash)
+    {
+        auto const &blocks = image.block_offsets;
+        if (blocks.empty()) {
+            return add(image.code.data(), image.code.size(), code_hash);
+        }
+        if (!file_) {
+            return;
+        }
+        auto const base = reinterpret_cast<std::uintptr_t>(image.code.data());
+        auto const name = "evm_" + utils::hex_string(code_hash);
+        std::string lines;
+        auto const append =
+            [&](uint32_t begin, uint32_t end, std::string_view suffix) {
+                if (begin < end) {
+                    std::format_to(
+                        std::back_inserter(lines),
+                        "{:x} {:x} {}{}\n",
+                        base + begin,
+                        end - begin,
+                        name,
+                        suffix);
+                }
+            };
+        append(0, blocks.front().native_offset, "");
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            uint32_t const end = i + 1 < blocks.size()
+                                     ? blocks[i + 1].native_offset
+                                     : image.blocks_end;
+            append(
+                blocks[i].native_offset,
+                end,
+                std::format("_bb{}", blocks[i].bytecode_offset));
+        }
+        append(
+            image.blocks_end, static_cast<uint32_t>(image.code.size()), "");
+        write(lines);
+    }
+
+    void PerfMap::write(std::string_view const lines)
+    {
+        std::lock_guard const lock{mutex_};
+        // Flush every write, because `perf` may read the map while the
+        // process is still running.
+        (void)std::fwrite(lines.data(), 1, lines.size(), file_);
+        (void)std::fflush(file_);
+    }
+}
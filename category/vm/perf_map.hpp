@@ -0,0 +1,72 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/compiler/ir/x86/types.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+
+namespace monad::vm
+{
+    /// Symbol map of compiled contracts in the format `perf` reads from
+    /// `/tmp/perf-<pid>.map`. Each line names the native code of one
+    /// contract after its code hash, so that samples taken in JIT code are
+    /// attributed to contracts in `perf report` and flame graphs.
+    class PerfMap
+    {
+    public:
+        /// `/tmp/perf-<pid>.map` of the current process.
+        static std::filesystem::path default_path();
+
+        explicit PerfMap(std::filesystem::path const &path = default_path());
+
+        ~PerfMap();
+
+        PerfMap(PerfMap const &) = delete;
+        PerfMap &operator=(PerfMap const &) = delete;
+
+        /// Whether the map file could be opened.
+        bool enabled() const noexcept
+        {
+            return file_ != nullptr;
+        }
+
+        /// Add the `size` bytes of native code at `code` compiled from the
+        /// contract with `code_hash`. Safe to call concurrently.
+        void add(
+            void const *code, size_t size, evmc::bytes32 const &code_hash);
+
+        /// Add the native code of `image`, compiled from the contract with
+        /// `code_hash`. If the image has block offsets, each basic block is
+        /// named `evm_<code hash>_bb<bytecode offset>`, and the rest of the
+        /// code `evm_<code hash>`.
+        void add(
+            compiler::native::CodeImage const &image,
+            evmc::bytes32 const &code_hash);
+
+    private:
+        void write(std::string_view lines);
+
+        std::mutex mutex_;
+        std::FILE *file_;
+    };
+}
@@ -20,4 +20,15 @@ namespace monad::vm::runtime
 {
     thread_local CachedAllocatorList EvmStackAllocatorMeta::cache_list;
     thread_local CachedAllocatorList EvmMemoryAllocatorMeta::cache_list;
+
+    CachedAllocatorPool EvmStackAllocatorMeta::shared_pool{
+        EvmStackAllocatorMeta::pool_max_size};
+    CachedAllocatorPool EvmMemoryAllocatorMeta::shared_pool{
+        EvmMemoryAllocatorMeta::pool_max_size};
+
+    size_t trim_idle_allocator_pools()
+    {
+        return EvmStackAllocatorMeta::shared_pool.trim_idle() +
+               EvmMemoryAllocatorMeta::shared_pool.trim_idle();
+    }
 }
@@ -24,7 +24,9 @@ namespace monad::vm::runtime
         using base_type = uint256_t;
         static constexpr size_t size = 1024;
         static constexpr size_t alignment = 32;
+        static constexpr size_t pool_max_size = 1024;
         static thread_local CachedAllocatorList cache_list;
+        static CachedAllocatorPool shared_pool;
     };
 
     struct EvmMemoryAllocatorMeta
@@ -32,9 +34,16 @@ namespace monad::vm::runtime
         using base_type = uint8_t;
         static constexpr size_t size = 4096;
         static constexpr size_t alignment = 1;
+        static constexpr size_t pool_max_size = 4096;
         static thread_local CachedAllocatorList cache_list;
+        static CachedAllocatorPool shared_pool;
     };
 
     using EvmStackAllocator = CachedAllocator<EvmStackAllocatorMeta>;
     using EvmMemoryAllocator = CachedAllocator<EvmMemoryAllocatorMeta>;
+
+    /// Free the stack and memory blocks that were not needed from the
+    /// shared pools since the previous call. Returns the number of blocks
+    /// freed.
+    size_t trim_idle_allocator_pools();
 }
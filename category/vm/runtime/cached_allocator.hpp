@@ -18,9 +18,11 @@
 #include <category/vm/core/assert.h>
 #include <category/vm/runtime/uint256.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace monad::vm::runtime
@@ -42,13 +44,13 @@ namespace monad::vm::runtime
         }
 
         [[gnu::always_inline]]
-        bool empty()
+        bool empty() const
         {
             return elements == nullptr;
         }
 
         [[gnu::always_inline]]
-        size_t size()
+        size_t size() const
         {
             return empty() ? 0 : elements->idx;
         }
@@ -79,12 +81,137 @@ namespace monad::vm::runtime
         }
     };
 
+    /// Bounded process-wide pool behind the thread-local caches of a cached
+    /// allocator, so that elements freed on one thread can be reused by
+    /// another instead of going back to `malloc`. Threads only exchange
+    /// elements with the pool in batches, once their own cache is empty or
+    /// full, so the lock stays off the common allocation path.
+    class CachedAllocatorPool
+    {
+    public:
+        struct Stats
+        {
+            size_t size;
+            size_t high_water;
+            size_t low_water;
+            size_t hits;
+            size_t misses;
+            size_t freed;
+        };
+
+        static constexpr size_t batch_size = 16;
+
+        explicit CachedAllocatorPool(size_t max_size)
+            : max_size_{max_size}
+        {
+        }
+
+        CachedAllocatorPool(CachedAllocatorPool const &) = delete;
+        CachedAllocatorPool &operator=(CachedAllocatorPool const &) = delete;
+
+        /// Move up to `batch_size` elements from the pool to `list`. Returns
+        /// the number of elements moved.
+        size_t take(CachedAllocatorList &list)
+        {
+            std::lock_guard const lock{mutex_};
+            size_t n = 0;
+            while (n < batch_size && !elements_.empty()) {
+                list.push(elements_.pop());
+                ++n;
+            }
+            if (n > 0) {
+                ++hits_;
+            }
+            else {
+                ++misses_;
+            }
+            low_water_ = std::min(low_water_, elements_.size());
+            return n;
+        }
+
+        /// Move up to `batch_size` elements from `list` to the pool, as long
+        /// as the pool is below its maximum size. Returns the number of
+        /// elements moved.
+        size_t give(CachedAllocatorList &list)
+        {
+            std::lock_guard const lock{mutex_};
+            size_t n = 0;
+            while (n < batch_size && !list.empty() &&
+                   elements_.size() < max_size_) {
+                elements_.push(list.pop());
+                ++n;
+            }
+            high_water_ = std::max(high_water_, elements_.size());
+            return n;
+        }
+
+        /// Free pooled elements until at most `keep` are left, and restart
+        /// the high- and low-water marks from the remaining size.
+        void trim(size_t keep)
+        {
+            std::lock_guard const lock{mutex_};
+            trim_locked(keep);
+        }
+
+        /// Free the elements that stayed in the pool since the previous
+        /// call, i.e. as many as its low-water mark, as no thread needed
+        /// them in that time. Intended to be called periodically. Returns
+        /// the number of elements freed.
+        size_t trim_idle()
+        {
+            std::lock_guard const lock{mutex_};
+            auto const idle = low_water_;
+            trim_locked(elements_.size() - idle);
+            return idle;
+        }
+
+        void set_max_size(size_t max_size)
+        {
+            std::lock_guard const lock{mutex_};
+            max_size_ = max_size;
+        }
+
+        Stats stats() const
+        {
+            std::lock_guard const lock{mutex_};
+            return {
+                .size = elements_.size(),
+                .high_water = high_water_,
+                .low_water = low_water_,
+                .hits = hits_,
+                .misses = misses_,
+                .freed = freed_,
+            };
+        }
+
+    private:
+        void trim_locked(size_t keep)
+        {
+            while (elements_.size() > keep) {
+                std::free(elements_.pop());
+                ++freed_;
+            }
+            high_water_ = elements_.size();
+            low_water_ = elements_.size();
+        }
+
+        mutable std::mutex mutex_;
+        CachedAllocatorList elements_;
+        size_t max_size_;
+        size_t high_water_{0};
+        size_t low_water_{0};
+        size_t hits_{0};
+        size_t misses_{0};
+        size_t freed_{0};
+    };
+
     template <typename T>
     concept CachedAllocable = requires {
         typename T::base_type;
         { T::size } -> std::same_as<size_t const &>;
         { T::alignment } -> std::same_as<size_t const &>;
         { T::cache_list } -> std::same_as<CachedAllocatorList &>;
+        { T::shared_pool } -> std::same_as<CachedAllocatorPool &>;
     };
 
     template <CachedAllocable T>
@@ -109,13 +236,12 @@ namespace monad::vm::runtime
 
         uint8_t *aligned_alloc_cached() const
         {
-            if (T::cache_list.empty()) {
+            if (T::cache_list.empty() &&
+                T::shared_pool.take(T::cache_list) == 0) {
                 return reinterpret_cast<uint8_t *>(
                     std::aligned_alloc(T::alignment, alloc_size));
             }
-            else {
-                return reinterpret_cast<uint8_t *>(T::cache_list.pop());
-            }
+            return reinterpret_cast<uint8_t *>(T::cache_list.pop());
         }
 
         /// Clear cache for testing/debugging purposes
@@ -129,7 +255,8 @@ namespace monad::vm::runtime
         /// Free memory allocated with `aligned_alloc_cached`.
         void free_cached(uint8_t *ptr) const
         {
-            if (T::cache_list.size() >= max_slots_in_cache) {
+            if (T::cache_list.size() >= max_slots_in_cache &&
+                T::shared_pool.give(T::cache_list) == 0) {
                 std::free(ptr);
             }
             else {
@@ -138,6 +265,12 @@ namespace monad::vm::runtime
             }
         };
 
+        /// Statistics of the pool shared by all threads' caches.
+        static CachedAllocatorPool::Stats pool_stats()
+        {
+            return T::shared_pool.stats();
+        }
+
         std::unique_ptr<uint8_t, std::function<void(uint8_t *)>>
         allocate() const
         {
@@ -18,6 +18,7 @@
 #include <category/vm/core/assert.h>
 #include <category/vm/evm/delegation.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/host.hpp>
 #include <category/vm/runtime/transmute.hpp>
 #include <category/vm/runtime/types.hpp>
 
@@ -166,7 +167,15 @@ namespace monad::vm::runtime
             .code_size = 0,
         };
 
-        auto result = ctx->host->call(ctx->context, &message);
+        // A frame entered through a `vm::Host` calls it directly, without
+        // the round trip through the evmc function table
+        auto result = MONAD_VM_LIKELY(ctx->vm_host != nullptr)
+                          ? ctx->vm_host->call(message).release_raw()
+                          : ctx->host->call(ctx->context, &message);
+
+        // The callee may have re-entered this contract and modified its
+        // storage.
+        ctx->storage_cache.clear();
 
         ctx->env.set_return_data(result.output_data, result.output_size);
 
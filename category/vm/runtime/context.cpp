@@ -17,6 +17,7 @@
 #include <category/vm/core/cases.hpp>
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/runtime/bin.hpp>
+#include <category/vm/runtime/memory_reservation.hpp>
 #include <category/vm/runtime/transmute.hpp>
 #include <category/vm/runtime/types.hpp>
 #include <category/vm/runtime/uint256.hpp>
@@ -44,6 +45,17 @@ extern "C" void monad_vm_runtime_increase_capacity(
     MONAD_VM_DEBUG_ASSERT(old_size < *new_size);
     MONAD_VM_DEBUG_ASSERT((*new_size & 31) == 0);
     uint32_t const new_capacity = *shl<1>(new_size);
+    if (new_capacity > memory_reservation_threshold) {
+        if (std::uint8_t *reserved = reserve_memory()) {
+            // The reservation is already zeroed, and covers every size the
+            // memory can grow to, so this is the last capacity increase.
+            std::memcpy(reserved, ctx->memory.data, old_size);
+            ctx->memory.dealloc(ctx->memory.data);
+            ctx->memory.capacity = memory_reservation_size;
+            ctx->memory.data = reserved;
+            return;
+        }
+    }
     std::uint8_t *new_data = static_cast<uint8_t *>(std::malloc(new_capacity));
     std::memcpy(new_data, ctx->memory.data, old_size);
     std::memset(new_data + old_size, 0, new_capacity - old_size);
@@ -95,6 +107,38 @@ namespace monad::vm::runtime
         };
     }
 
+    Context Context::from_parent(
+        Context const &parent, evmc_message const *msg,
+        std::span<std::uint8_t const> code) noexcept
+    {
+        return Context{
+            .host = parent.host,
+            .context = parent.context,
+            .gas_remaining = msg->gas,
+            .gas_refund = 0,
+            .env =
+                {
+                    .evmc_flags = msg->flags,
+                    .depth = msg->depth,
+                    .recipient = msg->recipient,
+                    .sender = msg->sender,
+                    .value = msg->value,
+                    .create2_salt = msg->create2_salt,
+                    .input_data = msg->input_data,
+                    .code = code.data(),
+                    .return_data = {},
+                    .input_data_size =
+                        static_cast<std::uint32_t>(msg->input_size),
+                    .code_size = static_cast<std::uint32_t>(code.size()),
+                    .return_data_size = 0,
+                    .tx_context = parent.env.tx_context,
+                },
+            .result = {},
+            .memory = Memory(parent.memory.allocator_),
+            .vm_host = parent.vm_host,
+        };
+    }
+
     Context Context::empty() noexcept
     {
         return Context{
@@ -183,6 +227,10 @@ namespace monad::vm::runtime
         };
 
         if (*memory_end <= memory.size) {
+            if (auto const *const forwarded =
+                    forward_return_data(*offset, *size)) {
+                return std::span{forwarded, *size};
+            }
             output_buf = allocate_output_buf();
             std::memcpy(output_buf, memory.data + *offset, *size);
         }
@@ -210,6 +258,27 @@ namespace monad::vm::runtime
         return std::span{output_buf, *size};
     }
 
+    // The return data, taken over from the environment, when it is what
+    // memory holds at the result region. Matching the last full
+    // RETURNDATACOPY only picks the candidate; the comparison is what makes
+    // handing the buffer on correct.
+    std::uint8_t const *Context::forward_return_data(
+        std::uint32_t const offset, std::uint32_t const size) noexcept
+    {
+        auto const &fwd = return_data_forward;
+        if (fwd.data == nullptr || fwd.data != env.return_data ||
+            fwd.offset != offset || fwd.size != size ||
+            env.return_data_size != size ||
+            std::memcmp(memory.data + offset, env.return_data, size) != 0) {
+            return nullptr;
+        }
+        auto const *const data = env.return_data;
+        env.return_data = nullptr;
+        env.return_data_size = 0;
+        return_data_forward = {};
+        return data;
+    }
+
     evmc::Result Context::copy_to_evmc_result()
     {
         using enum StatusCode;
@@ -104,6 +104,10 @@ namespace monad::vm::runtime
 
         auto result = ctx->host->call(ctx->context, &message);
 
+        // The callee may have re-entered this contract and modified its
+        // storage.
+        ctx->storage_cache.clear();
+
         ctx->env.set_return_data(result.output_data, result.output_size);
 
         // Unwind the stack after setting return data, so that return data
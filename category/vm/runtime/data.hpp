@@ -186,6 +186,13 @@ namespace monad::vm::runtime
                 ctx->env.return_data + offset,
                 *size,
                 ctx->memory.data + *dest_offset);
+
+            if (offset == 0 && *size == ctx->env.return_data_size) {
+                ctx->return_data_forward = {
+                    .data = ctx->env.return_data,
+                    .offset = *dest_offset,
+                    .size = *size};
+            }
         }
     }
 
@@ -21,10 +21,40 @@
 
 #include <evmc/evmc.hpp>
 
+#include <ethash/keccak.h>
 #include <ethash/keccak.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 namespace monad::vm::runtime
 {
+    /// Keccak-256 of an input that fits in a single rate block together
+    /// with its padding, using one permutation and no absorb loop. This is
+    /// the common case for KECCAK256, e.g. 64 byte mapping slot derivations.
+    inline uint256_t keccak256_single_block(
+        std::uint8_t const *data, std::size_t const size) noexcept
+    {
+        MONAD_VM_DEBUG_ASSERT(size <= KeccakMemo::max_input_size);
+
+        constexpr std::size_t rate = KeccakMemo::max_input_size + 1;
+        alignas(std::uint64_t) std::array<std::uint8_t, rate> block{};
+        std::copy_n(data, size, block.begin());
+        block[size] ^= 0x01;
+        block[rate - 1] ^= 0x80;
+
+        std::uint64_t state[25]{};
+        std::memcpy(state, block.data(), rate);
+        ethash_keccakf1600(state);
+
+        alignas(std::uint64_t) std::uint8_t hash[32];
+        std::memcpy(hash, state, sizeof(hash));
+        return uint256_t::load_be(hash);
+    }
+
     inline void sha3(
         Context *ctx, uint256_t *result_ptr, uint256_t const *offset_ptr,
         uint256_t const *size_ptr)
@@ -41,7 +71,19 @@ namespace monad::vm::runtime
             ctx->deduct_gas(word_size * bin<6>);
         }
 
-        auto hash = ethash::keccak256(ctx->memory.data + *offset, *size);
+        auto const *const data = ctx->memory.data + *offset;
+        if (*size <= KeccakMemo::max_input_size) {
+            auto &memo = ctx->keccak_memo;
+            if (memo.matches(data, *size)) {
+                *result_ptr = memo.hash;
+                return;
+            }
+            *result_ptr = keccak256_single_block(data, *size);
+            memo.store(data, *size, *result_ptr);
+            return;
+        }
+
+        auto hash = ethash::keccak256(data, *size);
         *result_ptr = uint256_t::load_be(hash.bytes);
     }
 }
@@ -96,14 +96,26 @@ namespace monad::vm::runtime
     }
 
     constexpr void mulmod(
-        uint256_t *result_ptr, uint256_t const *a_ptr, uint256_t const *b_ptr,
-        uint256_t const *n_ptr) noexcept
+        Context *ctx, uint256_t *result_ptr, uint256_t const *a_ptr,
+        uint256_t const *b_ptr, uint256_t const *n_ptr) noexcept
     {
         if (*n_ptr == 0) {
             *result_ptr = 0;
             return;
         }
 
+        auto &cache = ctx->mulmod_cache;
+        if (cache.reducer.modulus() == *n_ptr) {
+            *result_ptr = cache.reducer.mulmod(*a_ptr, *b_ptr);
+            return;
+        }
+        if (cache.candidate == *n_ptr && barrett_reducer::supports(*n_ptr)) {
+            cache.reducer = barrett_reducer{*n_ptr};
+            *result_ptr = cache.reducer.mulmod(*a_ptr, *b_ptr);
+            return;
+        }
+        cache.candidate = *n_ptr;
+
         *result_ptr = mulmod(*a_ptr, *b_ptr, *n_ptr);
     }
 
@@ -0,0 +1,121 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#include <category/vm/core/assert.h>
+#include <category/vm/runtime/memory_reservation.hpp>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace monad::vm::runtime
+{
+    namespace
+    {
+        std::atomic<bool> huge_pages_enabled{false};
+
+        class ReservationCache
+        {
+        public:
+            static constexpr std::size_t max_size = 4;
+
+            ReservationCache() = default;
+
+            ReservationCache(ReservationCache const &) = delete;
+            ReservationCache &operator=(ReservationCache const &) = delete;
+
+            ~ReservationCache()
+            {
+                for (std::size_t i = 0; i < size_; ++i) {
+                    munmap(reservations_[i], memory_reservation_size);
+                }
+            }
+
+            std::uint8_t *pop() noexcept
+            {
+                if (size_ == 0) {
+                    return nullptr;
+                }
+                return reservations_[--size_];
+            }
+
+            bool push(std::uint8_t *data) noexcept
+            {
+                if (size_ == max_size) {
+                    return false;
+                }
+                reservations_[size_++] = data;
+                return true;
+            }
+
+        private:
+            std::array<std::uint8_t *, max_size> reservations_{};
+            std::size_t size_{};
+        };
+
+        thread_local ReservationCache reservation_cache;
+    }
+
+    void set_memory_reservation_huge_pages(bool const enabled) noexcept
+    {
+        huge_pages_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    std::uint8_t *reserve_memory() noexcept
+    {
+        if (auto *const data = reservation_cache.pop()) {
+            return data;
+        }
+
+        void *const data = mmap(
+            nullptr,
+            memory_reservation_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1,
+            0);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        if (huge_pages_enabled.load(std::memory_order_relaxed)) {
+            // Only a hint; the reservation is usable either way.
+            (void)madvise(data, memory_reservation_size, MADV_HUGEPAGE);
+        }
+        return static_cast<std::uint8_t *>(data);
+    }
+
+    void release_memory_reservation(
+        std::uint8_t *const data, std::uint32_t const used_size) noexcept
+    {
+        MONAD_VM_DEBUG_ASSERT(data != nullptr);
+        MONAD_VM_DEBUG_ASSERT(used_size <= memory_reservation_size);
+
+        // Discarding the used pages returns them to the kernel, and they
+        // read as zero again when the reservation is reused.
+        auto const page_size = static_cast<std::size_t>(getpagesize());
+        auto const used_pages =
+            (std::size_t{used_size} + page_size - 1) / page_size * page_size;
+        if (used_pages > 0 && madvise(data, used_pages, MADV_DONTNEED) != 0) {
+            munmap(data, memory_reservation_size);
+            return;
+        }
+        if (!reservation_cache.push(data)) {
+            munmap(data, memory_reservation_size);
+        }
+    }
+}
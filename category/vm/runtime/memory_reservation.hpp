@@ -0,0 +1,46 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace monad::vm::runtime
+{
+    /**
+     * EVM memory that grows past `memory_reservation_threshold` bytes is
+     * moved into a reservation of virtual address space large enough for
+     * any valid memory size. Pages of the reservation are committed and
+     * zeroed lazily by the kernel on first access, so memory can then grow
+     * in place without further allocation or copying.
+     */
+    constexpr std::uint32_t memory_reservation_threshold = 1 << 18;
+
+    /// Size of a reservation; no memory expansion can exceed this.
+    constexpr std::uint32_t memory_reservation_size = 1u << 31;
+
+    /// Request transparent huge pages for new memory reservations.
+    void set_memory_reservation_huge_pages(bool enabled) noexcept;
+
+    /// Returns a zeroed reservation of `memory_reservation_size` bytes, or
+    /// `nullptr` if the address space could not be reserved.
+    std::uint8_t *reserve_memory() noexcept;
+
+    /// Releases a reservation of which at most the first `used_size` bytes
+    /// have been accessed. The reservation may be kept in a thread-local
+    /// cache and reused.
+    void release_memory_reservation(
+        std::uint8_t *data, std::uint32_t used_size) noexcept;
+}
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <category/vm/core/assert.h>
+#include <category/vm/host.hpp>
 #include <category/vm/runtime/storage_costs.hpp>
 #include <category/vm/runtime/transmute.hpp>
 #include <category/vm/runtime/types.hpp>
@@ -30,19 +31,45 @@ namespace monad::vm::runtime
     template <Traits traits>
     void sload(Context *ctx, uint256_t *result_ptr, uint256_t const *key_ptr)
     {
+        // Slots in the cache are already warm, so the host does not need to
+        // be consulted about access status either.
+        if (auto const *cached = ctx->storage_cache.find(*key_ptr)) {
+            *result_ptr = uint256_from_bytes32(*cached);
+            return;
+        }
+
         auto key = bytes32_from_uint256(*key_ptr);
 
+        evmc::bytes32 value;
         if constexpr (traits::eip_2929_active()) {
-            auto access_status = ctx->host->access_storage(
-                ctx->context, &ctx->env.recipient, &key);
-            if (access_status == EVMC_ACCESS_COLD) {
-                ctx->deduct_gas(traits::cold_storage_cost());
+            // The cold access is paid for before the slot is read, so that
+            // a frame running out of gas here does not do the read.
+            if (MONAD_VM_LIKELY(ctx->vm_host != nullptr)) {
+                bool const can_pay_cold =
+                    ctx->gas_remaining >= traits::cold_storage_cost();
+                auto const access_status =
+                    ctx->vm_host->access_and_load_storage(
+                        ctx->env.recipient, key, value, can_pay_cold);
+                if (access_status == EVMC_ACCESS_COLD) {
+                    ctx->deduct_gas(traits::cold_storage_cost());
+                }
+            }
+            else {
+                auto const access_status = ctx->host->access_storage(
+                    ctx->context, &ctx->env.recipient, &key);
+                if (access_status == EVMC_ACCESS_COLD) {
+                    ctx->deduct_gas(traits::cold_storage_cost());
+                }
+                value = ctx->host->get_storage(
+                    ctx->context, &ctx->env.recipient, &key);
             }
         }
+        else {
+            value = ctx->host->get_storage(
+                ctx->context, &ctx->env.recipient, &key);
+        }
 
-        auto value =
-            ctx->host->get_storage(ctx->context, &ctx->env.recipient, &key);
-
+        ctx->storage_cache.insert(*key_ptr, value);
         *result_ptr = uint256_from_bytes32(value);
     }
 
@@ -76,6 +103,7 @@ namespace monad::vm::runtime
 
         auto storage_status = ctx->host->set_storage(
             ctx->context, &ctx->env.recipient, &key, &value);
+        ctx->storage_cache.insert(*key_ptr, value);
 
         auto [gas_used, gas_refund] = store_cost<traits>(storage_status);
 
@@ -0,0 +1,79 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+#include <category/vm/runtime/uint256.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace monad::vm::runtime
+{
+    /// A small direct-mapped cache of the current values of storage slots
+    /// accessed by a single call frame. A slot is only inserted after it has
+    /// been accessed through the host, so a cached slot is always warm for
+    /// the remainder of the frame. Any operation that can run other code
+    /// (and with it modify storage or revert access status) must `clear`
+    /// the cache.
+    class StorageCache
+    {
+    public:
+        static constexpr std::size_t size = 16;
+
+        evmc::bytes32 const *find(uint256_t const &key) const noexcept
+        {
+            auto const &entry = entries_[index(key)];
+            if (entry.valid && entry.key == key) {
+                return &entry.value;
+            }
+            return nullptr;
+        }
+
+        void insert(uint256_t const &key, evmc::bytes32 const &value) noexcept
+        {
+            auto &entry = entries_[index(key)];
+            entry.key = key;
+            entry.value = value;
+            entry.valid = true;
+        }
+
+        void clear() noexcept
+        {
+            for (auto &entry : entries_) {
+                entry.valid = false;
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            uint256_t key;
+            evmc::bytes32 value;
+            bool valid = false;
+        };
+
+        static std::size_t index(uint256_t const &key) noexcept
+        {
+            return static_cast<std::size_t>(
+                       key[0] ^ key[1] ^ key[2] ^ key[3]) %
+                   size;
+        }
+
+        std::array<Entry, size> entries_{};
+    };
+}
@@ -18,17 +18,32 @@
 #include <category/vm/core/assert.h>
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/runtime/bin.hpp>
+#include <category/vm/runtime/memory_reservation.hpp>
+#include <category/vm/runtime/storage_cache.hpp>
 #include <category/vm/runtime/transmute.hpp>
 #include <category/vm/runtime/uint256.hpp>
 
 #include <evmc/evmc.hpp>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <span>
 #include <type_traits>
 #include <variant>
 #include <vector>
 
+namespace monad::vm
+{
+    class Host;
+}
+
+namespace monad::vm::interpreter
+{
+    class OpcodeCounts;
+}
+
 namespace monad::vm::runtime
 {
     enum class StatusCode : uint64_t
@@ -161,12 +176,67 @@ namespace monad::vm::runtime
             if (capacity == initial_capacity) {
                 allocator_.free_cached(d);
             }
+            else if (capacity == memory_reservation_size) {
+                release_memory_reservation(d, size);
+            }
             else {
                 std::free(d);
             }
         }
     };
 
+    /// Barrett reducer for the modulus that the MULMODs of a call frame
+    /// use repeatedly. A reducer is only built the second time in a row that
+    /// a modulus is seen, so frames alternating between moduli do not pay
+    /// for building reducers they never reuse.
+    struct MulmodCache
+    {
+        barrett_reducer reducer;
+        uint256_t candidate;
+    };
+
+    /// The input and result of the last single block KECCAK256 in a call
+    /// frame. Comparing the input is much cheaper than a permutation, and
+    /// loops often hash the same mapping slot repeatedly.
+    struct KeccakMemo
+    {
+        static constexpr std::size_t max_input_size = 135;
+
+        std::uint32_t size = 0;
+        bool valid = false;
+        std::array<std::uint8_t, max_input_size> input;
+        uint256_t hash;
+
+        bool matches(std::uint8_t const *data, std::uint32_t n) const noexcept
+        {
+            return valid && size == n &&
+                   std::memcmp(input.data(), data, n) == 0;
+        }
+
+        void store(
+            std::uint8_t const *data, std::uint32_t n,
+            uint256_t const &h) noexcept
+        {
+            MONAD_VM_DEBUG_ASSERT(n <= max_input_size);
+            std::memcpy(input.data(), data, n);
+            size = n;
+            hash = h;
+            valid = true;
+        }
+    };
+
+    /// Where the last RETURNDATACOPY of the whole return data put it in
+    /// memory. A frame returning that region unchanged, as proxies forwarding
+    /// the result of a call do, hands on the return data buffer rather than
+    /// copying the region into a new one. Comparing the region is cheaper
+    /// than allocating and writing the copy.
+    struct ReturnDataForward
+    {
+        std::uint8_t const *data = nullptr;
+        std::uint32_t offset = 0;
+        std::uint32_t size = 0;
+    };
+
     struct Context
     {
         static Context from(
@@ -174,6 +244,14 @@ namespace monad::vm::runtime
             evmc_host_context *context, evmc_message const *msg,
             std::span<std::uint8_t const> code) noexcept;
 
+        /// Like `from`, but with the transaction context of the call
+        /// frame `parent`, so that a nested call does not query the host
+        /// for it again. The host and memory allocator are also shared
+        /// with `parent`.
+        static Context from_parent(
+            Context const &parent, evmc_message const *msg,
+            std::span<std::uint8_t const> code) noexcept;
+
         static Context empty() noexcept;
 
         evmc_host_interface const *host;
@@ -191,6 +269,21 @@ namespace monad::vm::runtime
         void *exit_stack_ptr = nullptr;
         bool is_stack_unwinding_active = false;
 
+        StorageCache storage_cache{};
+        MulmodCache mulmod_cache{};
+        KeccakMemo keccak_memo{};
+        ReturnDataForward return_data_forward{};
+
+        /// The host behind `host` and `context` when the frame was entered
+        /// through a `vm::Host`, so that the runtime can use its typed
+        /// entry points. Null for frames entered through a raw evmc host.
+        Host *vm_host = nullptr;
+
+        /// The counts of the instructions the interpreter executes in this
+        /// frame, when the frame is sampled for the opcode profile. Null
+        /// otherwise, so that nested frames are sampled on their own.
+        interpreter::OpcodeCounts *opcode_counts = nullptr;
+
         [[gnu::always_inline]]
         constexpr void deduct_gas(std::int64_t const gas) noexcept
         {
@@ -263,6 +356,9 @@ namespace monad::vm::runtime
     private:
         std::variant<std::span<std::uint8_t const>, evmc_status_code>
         copy_result_data();
+
+        std::uint8_t const *
+        forward_return_data(std::uint32_t offset, std::uint32_t size) noexcept;
     };
 
     // Update context.S accordingly if these offsets change:
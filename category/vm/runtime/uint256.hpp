@@ -1007,24 +1007,124 @@ namespace monad::vm::runtime
         return uint256_t{udivrem(sum, mod.as_words()).rem};
     }
 
+    template <size_t M, size_t N>
     [[gnu::always_inline]]
-    inline constexpr uint256_t mulmod(
-        uint256_t const &u, uint256_t const &v, uint256_t const &mod) noexcept
+    inline constexpr words_t<M + N>
+    mul_full(words_t<M> const &u, words_t<N> const &v) noexcept
     {
-        words_t<2 * uint256_t::num_words> prod{0};
-        for (size_t j = 0; j < uint256_t::num_words; j++) {
+        words_t<M + N> prod{0};
+        for (size_t j = 0; j < N; j++) {
             uint64_t carry = 0;
-            for (size_t i = 0; i < uint256_t::num_words; i++) {
+            for (size_t i = 0; i < M; i++) {
                 auto p =
                     static_cast<uint128_t>(u[i]) * v[j] + carry + prod[i + j];
                 prod[i + j] = static_cast<uint64_t>(p);
                 carry = static_cast<uint64_t>(p >> 64);
             }
-            prod[j + uint256_t::num_words] = carry;
+            prod[j + M] = carry;
         }
+        return prod;
+    }
+
+    [[gnu::always_inline]]
+    inline constexpr uint256_t mulmod(
+        uint256_t const &u, uint256_t const &v, uint256_t const &mod) noexcept
+    {
+        auto const prod = mul_full(u.as_words(), v.as_words());
         return uint256_t{udivrem(prod, mod.as_words()).rem};
     }
 
+    /**
+     * Barrett reduction modulo a fixed modulus `m > 2^192` (HAC 14.42 with
+     * base 2^64 and k = 4). Constructing a reducer costs one long division;
+     * each reduction of a 512-bit value afterwards only needs
+     * multiplications and at most two subtractions, so it pays off as soon
+     * as the same modulus is used more than once.
+     */
+    class barrett_reducer
+    {
+    public:
+        constexpr barrett_reducer() noexcept = default;
+
+        explicit constexpr barrett_reducer(uint256_t const &mod) noexcept
+            : mod_{mod}
+        {
+            MONAD_VM_DEBUG_ASSERT(supports(mod));
+            // mu = floor(2^512 / m), which is less than 2^320 for m > 2^192.
+            words_t<9> numerator{0};
+            numerator[8] = 1;
+            auto const quot = udivrem(numerator, mod.as_words()).quot;
+            for (size_t i = 0; i < mu_.size(); ++i) {
+                mu_[i] = quot[i];
+            }
+        }
+
+        static constexpr bool supports(uint256_t const &mod) noexcept
+        {
+            return mod[3] > 1 ||
+                   (mod[3] == 1 && (mod[0] | mod[1] | mod[2]) != 0);
+        }
+
+        constexpr uint256_t const &modulus() const noexcept
+        {
+            return mod_;
+        }
+
+        constexpr uint256_t mulmod(
+            uint256_t const &u, uint256_t const &v) const noexcept
+        {
+            return reduce(mul_full(u.as_words(), v.as_words()));
+        }
+
+    private:
+        constexpr uint256_t reduce(words_t<8> const &x) const noexcept
+        {
+            MONAD_VM_DEBUG_ASSERT(mod_ != 0);
+
+            // q = floor(floor(x / 2^192) * mu / 2^320)
+            words_t<5> q1;
+            for (size_t i = 0; i < q1.size(); ++i) {
+                q1[i] = x[i + 3];
+            }
+            auto const q2 = mul_full(q1, mu_);
+            words_t<5> q3;
+            for (size_t i = 0; i < q3.size(); ++i) {
+                q3[i] = q2[i + 5];
+            }
+
+            // r = (x - q * m) mod 2^320, which is less than 3 * m
+            auto const qm = mul_full(q3, mod_.as_words());
+            words_t<5> r;
+            bool borrow = false;
+            for (size_t i = 0; i < r.size(); ++i) {
+                auto const [d, b] = subb(x[i], qm[i], borrow);
+                r[i] = d;
+                borrow = b;
+            }
+
+            for (auto n = 0; n < 2; ++n) {
+                words_t<5> t;
+                borrow = false;
+                for (size_t i = 0; i < t.size(); ++i) {
+                    auto const m = i < 4 ? mod_[i] : uint64_t{0};
+                    auto const [d, b] = subb(r[i], m, borrow);
+                    t[i] = d;
+                    borrow = b;
+                }
+                if (borrow) {
+                    break;
+                }
+                r = t;
+            }
+
+            MONAD_VM_DEBUG_ASSERT(r[4] == 0);
+            return uint256_t{r[0], r[1], r[2], r[3]};
+        }
+
+        uint256_t mod_{0};
+        words_t<5> mu_{0};
+    };
+
     [[gnu::always_inline]] inline constexpr uint256_t
     operator/(uint256_t const &x, uint256_t const &y) noexcept
     {
@@ -0,0 +1,407 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/core/assert.h>
+#include <category/vm/interpreter/intercode.hpp>
+#include <category/vm/shared_code_store.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <ethash/keccak.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::array<char, 8> file_magic{
+        'M', 'O', 'N', 'A', 'D', 'C', 'D', 'S'};
+    constexpr uint32_t file_version = 1;
+
+    // The table has an entry for every this many bytes of code, and twice
+    // as many slots as entries so that probe sequences stay short.
+    constexpr size_t bytes_per_entry = 2048;
+
+    // The file is sized in whole huge pages, which hugetlbfs requires
+    constexpr size_t huge_page_size = size_t{1} << 21;
+
+    constexpr size_t round_up(size_t const x, size_t const align)
+    {
+        return (x + align - 1) / align * align;
+    }
+
+    /// Precedes the bytecode of an entry, which is followed by its packed
+    /// jump destinations and padding to 8 bytes.
+    struct Entry
+    {
+        uint32_t code_size;
+        uint32_t reserved;
+    };
+
+    size_t entry_size(size_t const code_size)
+    {
+        return round_up(
+            sizeof(Entry) + code_size +
+                monad::vm::Intercode::packed_jumpdests_size(code_size),
+            alignof(uint64_t));
+    }
+
+    uint64_t load(uint64_t &x, std::memory_order const order)
+    {
+        return std::atomic_ref<uint64_t>{x}.load(order);
+    }
+
+    void store(uint64_t &x, uint64_t const v, std::memory_order const order)
+    {
+        std::atomic_ref<uint64_t>{x}.store(v, order);
+    }
+}
+
+namespace monad::vm
+{
+    struct SharedCodeStore::Header
+    {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t slot_count;
+        uint64_t max_entries;
+        uint64_t data_offset;
+        uint64_t max_data_bytes;
+        // only ever grow, and only by the writer
+        uint64_t entries;
+        uint64_t data_bytes;
+    };
+
+    /// Empty until `entry_offset`, from the start of the file, is stored
+    /// with release semantics after the entry and `code_hash` are written.
+    struct SharedCodeStore::Slot
+    {
+        evmc::bytes32 code_hash;
+        uint64_t entry_offset;
+        uint64_t reserved;
+    };
+
+    namespace
+    {
+        struct Layout
+        {
+            uint64_t slot_count;
+            uint64_t max_entries;
+            uint64_t data_offset;
+            size_t map_size;
+        };
+
+        template <typename Header, typename Slot>
+        Layout layout_of(size_t const max_data_bytes)
+        {
+            static_assert(std::is_trivially_copyable_v<Header>);
+            static_assert(std::is_trivially_copyable_v<Slot>);
+            uint64_t const max_entries =
+                std::max<size_t>(max_data_bytes / bytes_per_entry, 1);
+            uint64_t const slot_count = std::bit_ceil(2 * max_entries);
+            uint64_t const data_offset = round_up(
+                sizeof(Header) + slot_count * sizeof(Slot), huge_page_size);
+            return {
+                .slot_count = slot_count,
+                .max_entries = max_entries,
+                .data_offset = data_offset,
+                .map_size =
+                    round_up(data_offset + max_data_bytes, huge_page_size)};
+        }
+
+        template <typename Header, typename Slot>
+        bool is_valid(std::byte const *const map, size_t const map_size)
+        {
+            if (map_size < sizeof(Header)) {
+                return false;
+            }
+            Header h;
+            std::memcpy(&h, map, sizeof(h));
+            auto const layout = layout_of<Header, Slot>(h.max_data_bytes);
+            return h.magic == file_magic && h.version == file_version &&
+                   h.slot_count == layout.slot_count &&
+                   h.max_entries == layout.max_entries &&
+                   h.data_offset == layout.data_offset &&
+                   map_size >= layout.map_size;
+        }
+
+        std::byte *
+        map_file(int const fd, int const prot, size_t &map_size) noexcept
+        {
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                return nullptr;
+            }
+            map_size = static_cast<size_t>(st.st_size);
+            void *const map =
+                ::mmap(nullptr, map_size, prot, MAP_SHARED, fd, 0);
+            return map == MAP_FAILED ? nullptr : static_cast<std::byte *>(map);
+        }
+
+        // The writer lock is held on a file next to the store rather than
+        // on the store itself, which is replaced when it is incompatible.
+        int lock_writer(std::filesystem::path const &path) noexcept
+        {
+            auto lock_path = path;
+            lock_path += ".lock";
+            int const fd =
+                ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                return -1;
+            }
+            if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+                ::close(fd);
+                return -1;
+            }
+            return fd;
+        }
+    }
+
+    SharedCodeStore::SharedCodeStore(
+        std::byte *const map, size_t const map_size, int const lock_fd)
+        : map_{map}
+        , map_size_{map_size}
+        , lock_fd_{lock_fd}
+    {
+    }
+
+    SharedCodeStore::~SharedCodeStore()
+    {
+        ::munmap(map_, map_size_);
+        if (lock_fd_ >= 0) {
+            ::close(lock_fd_);
+        }
+    }
+
+    auto SharedCodeStore::header() const noexcept -> Header &
+    {
+        return *reinterpret_cast<Header *>(map_);
+    }
+
+    auto SharedCodeStore::slots() const noexcept -> Slot *
+    {
+        return reinterpret_cast<Slot *>(map_ + sizeof(Header));
+    }
+
+    std::unique_ptr<SharedCodeStore> SharedCodeStore::open_writable(
+        std::filesystem::path const &path, size_t const max_data_bytes)
+    {
+        int const lock_fd = lock_writer(path);
+        if (lock_fd < 0) {
+            return nullptr;
+        }
+
+        // Reuse a compatible store, so that the readers which have it
+        // mapped see the new entries and the old ones stay warm.
+        if (int const fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC); fd >= 0) {
+            size_t map_size = 0;
+            std::byte *const map =
+                map_file(fd, PROT_READ | PROT_WRITE, map_size);
+            ::close(fd);
+            if (map != nullptr) {
+                if (is_valid<Header, Slot>(map, map_size) &&
+                    reinterpret_cast<Header const *>(map)->max_data_bytes ==
+                        max_data_bytes) {
+                    return std::unique_ptr<SharedCodeStore>{
+                        new SharedCodeStore{map, map_size, lock_fd}};
+                }
+                ::munmap(map, map_size);
+            }
+        }
+
+        // Build the new store in a temporary file and rename it into
+        // place, so that readers never open a partially initialized one.
+        auto const layout = layout_of<Header, Slot>(max_data_bytes);
+        auto tmp = path;
+        tmp += ".tmp";
+        int const fd =
+            ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            ::close(lock_fd);
+            return nullptr;
+        }
+        std::byte *map = nullptr;
+        size_t map_size = 0;
+        if (::ftruncate(fd, static_cast<off_t>(layout.map_size)) == 0) {
+            map = map_file(fd, PROT_READ | PROT_WRITE, map_size);
+        }
+        ::close(fd);
+        if (map == nullptr) {
+            ::unlink(tmp.c_str());
+            ::close(lock_fd);
+            return nullptr;
+        }
+        // the file is zero filled, so every slot starts empty
+        Header const h{
+            .magic = file_magic,
+            .version = file_version,
+            .reserved = 0,
+            .slot_count = layout.slot_count,
+            .max_entries = layout.max_entries,
+            .data_offset = layout.data_offset,
+            .max_data_bytes = max_data_bytes,
+            .entries = 0,
+            .data_bytes = 0};
+        std::memcpy(map, &h, sizeof(h));
+        if (::rename(tmp.c_str(), path.c_str()) != 0) {
+            ::munmap(map, map_size);
+            ::unlink(tmp.c_str());
+            ::close(lock_fd);
+            return nullptr;
+        }
+        return std::unique_ptr<SharedCodeStore>{
+            new SharedCodeStore{map, map_size, lock_fd}};
+    }
+
+    std::unique_ptr<SharedCodeStore const>
+    SharedCodeStore::open(std::filesystem::path const &path)
+    {
+        int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        size_t map_size = 0;
+        std::byte *const map = map_file(fd, PROT_READ, map_size);
+        ::close(fd);
+        if (map == nullptr) {
+            return nullptr;
+        }
+        if (!is_valid<Header, Slot>(map, map_size)) {
+            ::munmap(map, map_size);
+            return nullptr;
+        }
+        return std::unique_ptr<SharedCodeStore const>{
+            new SharedCodeStore{map, map_size, -1}};
+    }
+
+    bool SharedCodeStore::insert(
+        evmc::bytes32 const &code_hash, Intercode const &icode)
+    {
+        std::lock_guard const g{insert_mutex_};
+        auto &h = header();
+        uint64_t const mask = h.slot_count - 1;
+        uint64_t i;
+        std::memcpy(&i, code_hash.bytes, sizeof(i));
+        // there are more slots than entries, so this finds an empty one
+        for (i &= mask;; i = (i + 1) & mask) {
+            Slot &slot = slots()[i];
+            if (load(slot.entry_offset, std::memory_order_relaxed) == 0) {
+                break;
+            }
+            if (slot.code_hash == code_hash) {
+                return true;
+            }
+        }
+        uint64_t const entries = load(h.entries, std::memory_order_relaxed);
+        uint64_t const used = load(h.data_bytes, std::memory_order_relaxed);
+        size_t const size = entry_size(icode.size());
+        if (entries == h.max_entries || size > h.max_data_bytes - used) {
+            return false;
+        }
+
+        uint64_t const offset = h.data_offset + used;
+        Entry const e{
+            .code_size = static_cast<uint32_t>(icode.size()), .reserved = 0};
+        std::memcpy(map_ + offset, &e, sizeof(e));
+        auto *const code =
+            reinterpret_cast<uint8_t *>(map_ + offset) + sizeof(e);
+        std::memcpy(code, icode.code(), icode.size());
+        icode.pack_jumpdests(
+            {code + icode.size(),
+             Intercode::packed_jumpdests_size(icode.size())});
+        store(h.data_bytes, used + size, std::memory_order_relaxed);
+
+        Slot &slot = slots()[i];
+        slot.code_hash = code_hash;
+        store(slot.entry_offset, offset, std::memory_order_release);
+        store(h.entries, entries + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    SharedIntercode SharedCodeStore::find(evmc::bytes32 const &code_hash) const
+    {
+        auto &h = header();
+        uint64_t const mask = h.slot_count - 1;
+        uint64_t i;
+        std::memcpy(&i, code_hash.bytes, sizeof(i));
+        i &= mask;
+        for (uint64_t n = 0; n < h.slot_count; ++n, i = (i + 1) & mask) {
+            Slot &slot = slots()[i];
+            uint64_t const offset =
+                load(slot.entry_offset, std::memory_order_acquire);
+            if (offset == 0) {
+                return nullptr;
+            }
+            if (slot.code_hash != code_hash) {
+                continue;
+            }
+            // the file is shared, so a damaged one must not crash readers
+            if (offset < h.data_offset ||
+                offset > map_size_ - sizeof(Entry)) {
+                return nullptr;
+            }
+            Entry e;
+            std::memcpy(&e, map_ + offset, sizeof(e));
+            if (e.code_size > interpreter::code_size_t::upper ||
+                entry_size(e.code_size) > map_size_ - offset) {
+                return nullptr;
+            }
+            auto const *const code =
+                reinterpret_cast<uint8_t const *>(map_ + offset) + sizeof(e);
+            auto icode = make_shared_intercode(
+                std::span{code, e.code_size},
+                std::span{
+                    code + e.code_size,
+                    Intercode::packed_jumpdests_size(e.code_size)});
+            // hash the private copy, which the writer can no longer change
+            if (std::memcmp(
+                    ethash::keccak256(icode->code(), icode->size()).bytes,
+                    code_hash.bytes,
+                    sizeof(code_hash.bytes)) != 0) {
+                return nullptr;
+            }
+            return icode;
+        }
+        return nullptr;
+    }
+
+    auto SharedCodeStore::stats() const noexcept -> Stats
+    {
+        auto &h = header();
+        return {
+            .entries = load(h.entries, std::memory_order_relaxed),
+            .max_entries = h.max_entries,
+            .data_bytes = load(h.data_bytes, std::memory_order_relaxed),
+            .max_data_bytes = h.max_data_bytes};
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/vm/code.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace monad::vm
+{
+    /// Bytecode and its jump destinations keyed by code hash, in a file
+    /// that every process on the host maps shared. The execution daemon
+    /// is the only writer; eth_call executors and other readers build
+    /// intercode from it without reading the code from the trie or
+    /// analysing it again. Code never changes under its hash, so entries
+    /// are never updated or evicted, and inserts fail once it is full.
+    /// Place the file on hugetlbfs to map it with huge pages.
+    class SharedCodeStore
+    {
+    public:
+        struct Stats
+        {
+            size_t entries;
+            size_t max_entries;
+            size_t data_bytes;
+            size_t max_data_bytes;
+        };
+
+        /// Open the store at `path` for writing, keeping its entries if
+        /// it was created with the same `max_data_bytes`, otherwise
+        /// replacing it with an empty one. Returns nullptr on failure, and
+        /// while another store is open for writing at `path`, in this or
+        /// any other process.
+        static std::unique_ptr<SharedCodeStore>
+        open_writable(std::filesystem::path const &, size_t max_data_bytes);
+
+        /// Open the store at `path` read only. Returns nullptr if there is
+        /// no valid store there.
+        static std::unique_ptr<SharedCodeStore const>
+        open(std::filesystem::path const &);
+
+        SharedCodeStore(SharedCodeStore const &) = delete;
+        SharedCodeStore &operator=(SharedCodeStore const &) = delete;
+        ~SharedCodeStore();
+
+        /// Add `icode` under `code_hash`. Returns false if the store is
+        /// full. Thread-safe.
+        bool insert(evmc::bytes32 const &code_hash, Intercode const &icode);
+
+        /// Intercode of the code stored under `code_hash`, or nullptr if
+        /// there is none. Code that does not hash to `code_hash` is not
+        /// returned, as the file can be written by another process.
+        /// Thread-safe and lock free, also while another process inserts.
+        SharedIntercode find(evmc::bytes32 const &code_hash) const;
+
+        Stats stats() const noexcept;
+
+    private:
+        struct Header;
+        struct Slot;
+
+        SharedCodeStore(std::byte *map, size_t map_size, int lock_fd);
+
+        Header &header() const noexcept;
+        Slot *slots() const noexcept;
+
+        std::byte *map_;
+        size_t map_size_;
+        // holds the writer lock of a writable store, -1 for readers
+        int lock_fd_;
+        std::mutex insert_mutex_;
+    };
+}
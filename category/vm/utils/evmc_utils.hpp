@@ -63,6 +63,33 @@ namespace monad::vm::utils
         }
     };
 
+    inline std::size_t address_hash(evmc::address const &address)
+    {
+        static_assert(sizeof(std::size_t) >= sizeof(uint64_t));
+        std::uint64_t result;
+        std::memcpy(&result, address.bytes, 8);
+        std::uint64_t tmp;
+        std::memcpy(&tmp, address.bytes + 8, 8);
+        result ^= tmp;
+        std::uint32_t tail;
+        std::memcpy(&tail, address.bytes + 16, 4);
+        result ^= tail;
+        return result;
+    }
+
+    struct AddressCompare
+    {
+        std::size_t hash(evmc::address const &address) const
+        {
+            return address_hash(address);
+        }
+
+        bool equal(evmc::address const &x, evmc::address const &y) const
+        {
+            return x == y;
+        }
+    };
+
     std::string hex_string(evmc::bytes32 const &);
     std::string hex_string(evmc::address const &);
 }
@@ -0,0 +1,118 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace monad::vm::utils
+{
+    /// Approximate access counts of hashed keys, a count-min sketch of
+    /// small saturating counters. After every `10 * width` counted
+    /// accesses all counters are halved, so that the sketch reflects
+    /// recent rather than lifetime popularity. Increments are lossy under
+    /// contention, which only makes the estimate a little lower, and a
+    /// counter that has saturated is no longer written, so that looking
+    /// up hot keys does not contend on the sketch.
+    class FrequencySketch
+    {
+    public:
+        static constexpr uint8_t max_frequency = 15;
+
+        /// Each of the rows has `width` counters, rounded up to a power
+        /// of two.
+        explicit FrequencySketch(size_t width = size_t{1} << 16)
+            : mask_{std::bit_ceil(std::max(width, size_t{64})) - 1}
+            , sample_size_{10 * (mask_ + 1)}
+            , additions_{0}
+            , counters_{
+                  std::make_unique<std::atomic<uint8_t>[]>(depth * (mask_ + 1))}
+        {
+        }
+
+        /// Count one access of the key with `hash`.
+        void increment(uint64_t const hash) noexcept
+        {
+            bool added = false;
+            for (size_t i = 0; i < depth; ++i) {
+                auto &c = counter(i, hash);
+                auto const n = c.load(std::memory_order_relaxed);
+                if (n < max_frequency) {
+                    c.store(
+                        static_cast<uint8_t>(n + 1), std::memory_order_relaxed);
+                    added = true;
+                }
+            }
+            if (added &&
+                additions_.fetch_add(1, std::memory_order_relaxed) + 1 ==
+                    sample_size_) {
+                halve();
+            }
+        }
+
+        /// The estimated number of recent accesses of the key with `hash`.
+        uint8_t frequency(uint64_t const hash) const noexcept
+        {
+            uint8_t f = max_frequency;
+            for (size_t i = 0; i < depth; ++i) {
+                f = std::min(
+                    f, counter(i, hash).load(std::memory_order_relaxed));
+            }
+            return f;
+        }
+
+    private:
+        static constexpr size_t depth = 4;
+
+        static constexpr std::array<uint64_t, depth> seeds{
+            0x9e3779b97f4a7c15,
+            0xc2b2ae3d27d4eb4f,
+            0x165667b19e3779f9,
+            0xd6e8feb86659fd93};
+
+        std::atomic<uint8_t> &counter(size_t const row, uint64_t const hash)
+            const noexcept
+        {
+            // The finalizer of MurmurHash3, so that every bit of `hash`
+            // affects the index.
+            uint64_t h = hash ^ seeds[row];
+            h = (h ^ (h >> 33)) * 0xff51afd7ed558ccd;
+            h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53;
+            size_t const index = (h ^ (h >> 33)) & mask_;
+            return counters_[row * (mask_ + 1) + index];
+        }
+
+        void halve() noexcept
+        {
+            for (size_t i = 0; i < depth * (mask_ + 1); ++i) {
+                auto const n = counters_[i].load(std::memory_order_relaxed);
+                counters_[i].store(
+                    static_cast<uint8_t>(n >> 1), std::memory_order_relaxed);
+            }
+            additions_.store(0, std::memory_order_relaxed);
+        }
+
+        size_t mask_;
+        size_t sample_size_;
+        std::atomic<size_t> additions_;
+        std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+    };
+}
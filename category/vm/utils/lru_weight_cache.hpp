@@ -22,6 +22,7 @@
 #include <atomic>
 #include <chrono>
 #include <mutex>
+#include <optional>
 #include <string>
 
 #include <unordered_set>
@@ -44,7 +45,7 @@ namespace monad::vm::utils
         using Accessor = HashMap::accessor;
 
         /// DATA
-        uint32_t max_weight_;
+        std::atomic<uint32_t> max_weight_;
         std::atomic<int64_t> weight_;
         LruList lru_;
         HashMap hmap_;
@@ -116,6 +117,32 @@ namespace monad::vm::utils
             return true;
         }
 
+        /// Like `try_insert`, but if adding `weight` would exceed the
+        /// maximum weight, `value` is only inserted if `admit` returns true
+        /// for the key of the least recently used element, which is the
+        /// first to be evicted. Returns false if `value` was not inserted,
+        /// and then `value` is only overwritten if `key` is cached.
+        template <class Admit>
+        bool try_insert_admitted(
+            Key const &key, Value &value, uint32_t weight, Admit &&admit)
+        {
+            {
+                ConstAccessor acc;
+                if (hmap_.find(acc, key)) {
+                    value = acc->second.value_;
+                    try_update_lru(&*acc);
+                    return false;
+                }
+            }
+            if (approx_weight() + weight > max_weight()) {
+                auto const victim = lru_.back_key();
+                if (victim.has_value() && !admit(*victim)) {
+                    return false;
+                }
+            }
+            return try_insert(key, value, weight);
+        }
+
         /// Get approximate total weight of the cached elements.
         uint64_t approx_weight() const
         {
@@ -129,6 +156,25 @@ namespace monad::vm::utils
             return hmap_.size();
         }
 
+        uint32_t max_weight() const noexcept
+        {
+            return max_weight_.load(std::memory_order_relaxed);
+        }
+
+        /// Change the maximum weight, evicting least recently used elements
+        /// until the cache fits it.
+        void set_max_weight(uint32_t const max_weight)
+        {
+            max_weight_.store(max_weight, std::memory_order_relaxed);
+            while (weight_.load(std::memory_order_acquire) > max_weight) {
+                ListNode const *const target = lru_.evict();
+                if (!target) {
+                    break;
+                }
+                weight_.fetch_sub(evict(target), std::memory_order_acq_rel);
+            }
+        }
+
         // For testing: to check internal invariants. Not safe with
         // concurrent `insert` calls.
         bool unsafe_check_consistent()
@@ -141,7 +187,7 @@ namespace monad::vm::utils
         {
             int64_t const pre_weight =
                 weight_.fetch_add(delta_weight, std::memory_order_acq_rel);
-            if (delta_weight + pre_weight > max_weight_) {
+            if (delta_weight + pre_weight > max_weight()) {
                 int64_t evicted_weight = 0;
                 while (evicted_weight < delta_weight) {
                     ListNode const *target = lru_.evict();
@@ -255,6 +301,17 @@ namespace monad::vm::utils
                 node->second.update_lru_time(lru_update_period_);
             }
 
+            /// The key of the element `evict` would return.
+            std::optional<Key> back_key()
+            {
+                std::unique_lock const l(mutex_);
+                ListNode const *const target = base_.second.prev_;
+                if (target == &base_) {
+                    return std::nullopt;
+                }
+                return target->first;
+            }
+
             ListNode const *evict()
             {
                 std::unique_lock const l(mutex_);
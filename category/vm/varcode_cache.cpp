@@ -19,6 +19,10 @@
 
 #include <evmc/evmc.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -32,20 +36,59 @@ namespace monad::vm
         return (code_size >> 10) + 3;
     }
 
-    VarcodeCache::VarcodeCache(std::uint32_t max_kb, std::uint32_t warm_kb)
-        : weight_cache_{max_kb}
-        , warm_cache_kb_{warm_kb}
+    VarcodeCache::VarcodeCache(
+        std::uint32_t const max_kb, std::uint32_t const warm_kb,
+        bool const frequency_admission)
+        : warm_cache_kb_{warm_kb}
+        , frequency_admission_{frequency_admission}
     {
+        size_t const n = std::bit_floor(std::clamp<size_t>(
+            max_kb / min_shard_kb, 1, max_shard_count));
+        shards_.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            shards_.push_back(std::make_unique<WeightCache>(
+                static_cast<std::uint32_t>(max_kb / n)));
+        }
+    }
+
+    VarcodeCache::WeightCache &
+    VarcodeCache::shard(evmc::bytes32 const &code_hash)
+    {
+        // The hash maps of the shards index by the low bits of the same
+        // hash, so select the shard by mixed high bits.
+        uint64_t const h = utils::hash32_hash(code_hash);
+        uint64_t const x = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9;
+        return *shards_[(x >> 32) & (shards_.size() - 1)];
     }
 
     std::optional<SharedVarcode>
     VarcodeCache::get(evmc::bytes32 const &code_hash)
     {
-        WeightCache::ConstAccessor acc;
-        if (!weight_cache_.find(acc, code_hash)) {
-            return std::nullopt;
+        if (frequency_admission_) {
+            sketch_.increment(utils::hash32_hash(code_hash));
+        }
+        {
+            WeightCache::ConstAccessor acc;
+            if (shard(code_hash).find(acc, code_hash)) {
+                return acc->second.value_;
+            }
+        }
+        if (!pinned_.empty()) {
+            PinnedMap::const_accessor acc;
+            if (pinned_.find(acc, code_hash)) {
+                return acc->second;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    void VarcodeCache::set_max_cache_kb(std::uint32_t const max_kb)
+    {
+        auto const n = static_cast<std::uint32_t>(shards_.size());
+        for (auto const &shard : shards_) {
+            shard->set_max_weight(max_kb / n);
         }
-        return acc->second.value_;
     }
 
     void VarcodeCache::set(
@@ -57,7 +100,13 @@ namespace monad::vm
         auto weight = code_size_to_cache_weight(
             *(icode->code_size() + ncode->code_size_estimate()));
         auto vcode = std::make_shared<Varcode>(icode, ncode);
-        weight_cache_.insert(code_hash, vcode, weight);
+        shard(code_hash).insert(code_hash, vcode, weight);
+        if (!pinned_.empty()) {
+            PinnedMap::accessor acc;
+            if (pinned_.find(acc, code_hash)) {
+                acc->second = vcode;
+            }
+        }
     }
 
     SharedVarcode VarcodeCache::try_set(
@@ -66,7 +115,29 @@ namespace monad::vm
         MONAD_VM_ASSERT(icode != nullptr);
         auto weight = code_size_to_cache_weight(*icode->code_size());
         auto vcode = std::make_shared<Varcode>(icode);
-        (void)weight_cache_.try_insert(code_hash, vcode, weight);
+        auto &cache = shard(code_hash);
+        if (!frequency_admission_) {
+            (void)cache.try_insert(code_hash, vcode, weight);
+            return vcode;
+        }
+        auto const frequency = sketch_.frequency(utils::hash32_hash(code_hash));
+        (void)cache.try_insert_admitted(
+            code_hash, vcode, weight, [&](evmc::bytes32 const &victim) {
+                return frequency >
+                       sketch_.frequency(utils::hash32_hash(victim));
+            });
         return vcode;
     }
+
+    bool VarcodeCache::pin(evmc::bytes32 const &code_hash)
+    {
+        WeightCache::ConstAccessor acc;
+        if (!shard(code_hash).find(acc, code_hash)) {
+            return false;
+        }
+        PinnedMap::accessor pinned_acc;
+        pinned_.insert(pinned_acc, code_hash);
+        pinned_acc->second = acc->second.value_;
+        return true;
+    }
 }
@@ -17,8 +17,18 @@
 
 #include <category/vm/code.hpp>
 #include <category/vm/utils/evmc_utils.hpp>
+#include <category/vm/utils/frequency_sketch.hpp>
 #include <category/vm/utils/lru_weight_cache.hpp>
 
+#include <tbb/concurrent_hash_map.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
 namespace monad::vm
 {
     class VarcodeCache
@@ -32,10 +42,23 @@ namespace monad::vm
         using WeightCache = utils::LruWeightCache<
             evmc::bytes32, SharedVarcode, utils::Hash32Compare>;
 
+        using PinnedMap = tbb::concurrent_hash_map<
+            evmc::bytes32, SharedVarcode, utils::Hash32Compare>;
+
     public:
+        /// The cache is split into up to `max_shard_count` independent
+        /// LRU shards by code hash, each holding at least `min_shard_kb`.
+        static constexpr std::uint32_t min_shard_kb = 1u << 16; // 64MB
+        static constexpr size_t max_shard_count = 16;
+
+        /// With `frequency_admission`, bytecode inserted by `try_set` into
+        /// a full shard only evicts the least recently used entry if its
+        /// code hash was looked up more often recently, so that one-off
+        /// contracts cannot flush out code that keeps being called.
         explicit VarcodeCache(
             std::uint32_t max_cache_kb = default_max_cache_kb,
-            std::uint32_t warm_cache_kb = default_warm_cache_kb);
+            std::uint32_t warm_cache_kb = default_warm_cache_kb,
+            bool frequency_admission = true);
 
         /// Get varcode for given code hash.
         std::optional<SharedVarcode> get(evmc::bytes32 const &code_hash);
@@ -46,13 +69,25 @@ namespace monad::vm
             SharedNativecode const &);
 
         /// Find varcode under `code_hash`, otherwise insert into cache.
+        /// Varcode the admission filter rejects is returned uncached.
         SharedVarcode
         try_set(evmc::bytes32 const &code_hash, SharedIntercode const &);
 
+        /// Keep the varcode currently cached under `code_hash` available,
+        /// even after the LRU evicts it. Returns false if there is no such
+        /// varcode. Pinned varcode does not count towards the cache weight.
+        bool pin(evmc::bytes32 const &code_hash);
+
+        /// Return the number of pinned elements.
+        size_t pinned_size() const noexcept
+        {
+            return pinned_.size();
+        }
+
         /// Whether the cache is warmed up.
         bool is_warm()
         {
-            return weight_cache_.approx_weight() >= warm_cache_kb_;
+            return approx_weight() >= warm_cache_kb_;
         }
 
         void set_warm_cache_kb(std::uint32_t warm_kb)
@@ -66,17 +101,56 @@ namespace monad::vm
         /// Get approximate total weight of the cached elements.
         uint64_t approx_weight() const
         {
-            return weight_cache_.approx_weight();
+            uint64_t weight = 0;
+            for (auto const &shard : shards_) {
+                weight += shard->approx_weight();
+            }
+            return weight;
         }
 
         /// Return the number of cached elements.
         size_t size() const noexcept
         {
-            return weight_cache_.size();
+            size_t n = 0;
+            for (auto const &shard : shards_) {
+                n += shard->size();
+            }
+            return n;
+        }
+
+        size_t shard_count() const noexcept
+        {
+            return shards_.size();
+        }
+
+        /// Get the maximum total weight of the shards.
+        std::uint32_t max_cache_kb() const noexcept
+        {
+            std::uint32_t kb = 0;
+            for (auto const &shard : shards_) {
+                kb += shard->max_weight();
+            }
+            return kb;
+        }
+
+        /// Change the maximum weight, split evenly over the shards, which
+        /// evict least recently used varcode until they fit it.
+        void set_max_cache_kb(std::uint32_t max_kb);
+
+        /// Number of `get` calls which found no varcode.
+        uint64_t misses() const noexcept
+        {
+            return misses_.load(std::memory_order_relaxed);
         }
 
     private:
-        WeightCache weight_cache_;
+        WeightCache &shard(evmc::bytes32 const &code_hash);
+
+        std::vector<std::unique_ptr<WeightCache>> shards_;
+        PinnedMap pinned_;
+        utils::FrequencySketch sketch_;
         std::uint32_t warm_cache_kb_;
+        bool frequency_admission_;
+        std::atomic<uint64_t> misses_{0};
     };
 }
@@ -17,9 +17,14 @@
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/compiler/ir/x86/types.hpp>
 #include <category/vm/core/assert.h>
+#include <category/vm/deploy_policy.hpp>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/execution_sampler.hpp>
 #include <category/vm/host.hpp>
+#include <category/vm/hotness_profile.hpp>
+#include <category/vm/interpreter/opcode_counts.hpp>
+#include <category/vm/opcode_profile.hpp>
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/runtime/types.hpp>
 #include <category/vm/vm.hpp>
@@ -27,10 +32,17 @@
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
+#include <quill/Quill.h>
+
+#include <chrono>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <span>
+#include <utility>
 
 namespace monad::vm
 {
@@ -38,23 +50,43 @@ namespace monad::vm
 
     VM::VM(
         bool enable_async, std::size_t max_stack_cache,
-        std::size_t max_memory_cache)
-        : compiler_{enable_async}
+        std::size_t max_memory_cache, unsigned compile_threads)
+        : compiler_{
+              enable_async, Compiler::default_compile_job_soft_limit,
+              compile_threads}
         , stack_allocator_{max_stack_cache}
         , memory_allocator_{max_memory_cache}
     {
     }
 
+    runtime::Context VM::make_runtime_context(
+        Host &host, evmc_message const *msg, std::span<uint8_t const> code)
+    {
+        // A nested call is made while the frame of its caller is still
+        // installed, so the transaction context is copied from there
+        // instead of being fetched through the host interface.
+        if (auto const *const parent = host.runtime_context_) {
+            MONAD_VM_DEBUG_ASSERT(parent->host == &host.get_interface());
+            MONAD_VM_DEBUG_ASSERT(parent->context == host.to_context());
+            return runtime::Context::from_parent(*parent, msg, code);
+        }
+        auto ctx = runtime::Context::from(
+            memory_allocator_,
+            &host.get_interface(),
+            host.to_context(),
+            msg,
+            code);
+        ctx.vm_host = &host;
+        return ctx;
+    }
+
     template <Traits traits>
     evmc::Result VM::execute(
         Host &host, evmc_message const *msg, evmc::bytes32 const &code_hash,
         SharedVarcode const &vcode)
     {
-        auto const *const host_itf = &host.get_interface();
-        auto *const host_ctx = host.to_context();
         auto const &icode = vcode->intercode();
-        auto rt_ctx = runtime::Context::from(
-            memory_allocator_, host_itf, host_ctx, msg, icode->code_span());
+        auto rt_ctx = make_runtime_context(host, msg, icode->code_span());
 
         // Install new runtime context:
         auto *const prev_rt_ctx = host.set_runtime_context(&rt_ctx);
@@ -75,10 +107,7 @@ namespace monad::vm
     evmc::Result VM::execute_bytecode(
         Host &host, evmc_message const *msg, std::span<uint8_t const> code)
     {
-        auto const *const host_itf = &host.get_interface();
-        auto *const host_ctx = host.to_context();
-        auto rt_ctx = runtime::Context::from(
-            memory_allocator_, host_itf, host_ctx, msg, code);
+        auto rt_ctx = make_runtime_context(host, msg, code);
 
         // Install new runtime context:
         auto *const prev_rt_ctx = host.set_runtime_context(&rt_ctx);
@@ -133,10 +162,168 @@ namespace monad::vm
 
     EXPLICIT_TRAITS_MEMBER(VM::execute_intercode_raw);
 
+    HotnessProfile &VM::enable_hotness_profile(size_t const precompile_count)
+    {
+        MONAD_VM_ASSERT(!hotness_profile_);
+        hotness_profile_ = std::make_unique<HotnessProfile>();
+        precompile_count_ = precompile_count;
+        return *hotness_profile_;
+    }
+
+    template <Traits traits>
+    bool VM::precompile(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode)
+    {
+        if (*icode->code_size() == 0) {
+            return false;
+        }
+        (void)compiler_.try_insert_varcode(code_hash, icode);
+        auto const ncode = compiler_.cached_compile<traits>(
+            code_hash, icode, compiler_config_);
+        return ncode->entrypoint() && compiler_.pin_varcode(code_hash);
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::precompile);
+
+    template <Traits traits>
+    void VM::precompile_hottest(
+        std::function<SharedIntercode(evmc::bytes32 const &)> const &read_code)
+    {
+        if (!hotness_profile_ || precompile_count_ == 0) {
+            return;
+        }
+        auto const start = std::chrono::steady_clock::now();
+        size_t n = 0;
+        for (auto const &e : hotness_profile_->top(precompile_count_)) {
+            auto const icode = read_code(e.code_hash);
+            if (icode && precompile<traits>(e.code_hash, icode)) {
+                ++n;
+            }
+        }
+        precompile_count_ = 0;
+        LOG_INFO(
+            "Precompiled {} hot contracts in {}ms",
+            n,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::precompile_hottest);
+
+    void VM::enable_optimizing_tier(
+        std::unique_ptr<OptimizingTier> tier, uint64_t const gas_threshold)
+    {
+        MONAD_VM_ASSERT(tier && gas_threshold > 0);
+        compiler_.enable_optimizing_tier(std::move(tier));
+        optimize_gas_threshold_ = gas_threshold;
+    }
+
+    ExecutionSampler &
+    VM::enable_execution_sampler(std::chrono::microseconds const interval)
+    {
+        MONAD_VM_ASSERT(!execution_sampler_);
+        execution_sampler_ = std::make_unique<ExecutionSampler>(interval);
+        return *execution_sampler_;
+    }
+
+    OpcodeProfile &VM::enable_opcode_profile(uint64_t const sample_period)
+    {
+        MONAD_VM_ASSERT(!opcode_profile_);
+        opcode_profile_ = std::make_unique<OpcodeProfile>(sample_period);
+        return *opcode_profile_;
+    }
+
+    DeployPolicy &VM::enable_deploy_policy(uint64_t const factory_threshold)
+    {
+        MONAD_VM_ASSERT(!deploy_policy_);
+        deploy_policy_ = std::make_unique<DeployPolicy>(factory_threshold);
+        return *deploy_policy_;
+    }
+
+    template <Traits traits>
+    void VM::on_deploy(
+        evmc::address const &deployer, evmc::bytes32 const &code_hash,
+        SharedVarcode const &vcode)
+    {
+        if (!deploy_policy_ || !deploy_policy_->on_deploy(deployer)) {
+            return;
+        }
+        auto const &ncode = vcode->nativecode();
+        if (ncode != nullptr && ncode->chain_id() == traits::id()) {
+            return;
+        }
+        auto const &icode = vcode->intercode();
+        if (*icode->code_size() == 0) {
+            return;
+        }
+        // Queue the job like code that has just become hot enough in the
+        // interpreter.
+        auto const bound = compiler::native::max_code_size(
+            compiler_config_.max_code_size_offset, icode->code_size());
+        compiler_.async_compile<traits>(
+            code_hash, icode, compiler_config_, *bound);
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::on_deploy);
+
     template <Traits traits>
     evmc::Result VM::execute_impl(
         runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
         SharedVarcode const &vcode)
+    {
+        if (MONAD_VM_LIKELY(
+                !hotness_profile_ && !execution_sampler_ &&
+                !opcode_profile_)) {
+            return execute_varcode_impl<traits>(rt_ctx, code_hash, vcode);
+        }
+        auto const &ncode = vcode->nativecode();
+        bool const interpreted = ncode == nullptr ||
+                                 ncode->chain_id() != traits::id() ||
+                                 ncode->entrypoint() == nullptr;
+        std::optional<ExecutionSampler::Frame> sampler_frame;
+        if (execution_sampler_) {
+            sampler_frame.emplace(*execution_sampler_, code_hash, !interpreted);
+        }
+        // Callees are sampled on their own, with a fresh context.
+        std::optional<interpreter::OpcodeCounts> opcode_counts;
+        if (opcode_profile_ && interpreted && opcode_profile_->sample()) {
+            rt_ctx.opcode_counts = &opcode_counts.emplace();
+        }
+        // Time spent in callees is included, like their gas is.
+        auto const msg_gas = rt_ctx.gas_remaining;
+        auto const start = hotness_profile_
+                               ? std::chrono::steady_clock::now()
+                               : std::chrono::steady_clock::time_point{};
+        auto result = execute_varcode_impl<traits>(rt_ctx, code_hash, vcode);
+        if (opcode_counts) {
+            rt_ctx.opcode_counts = nullptr;
+            opcode_counts->finish(result.gas_left);
+            if (!opcode_counts->empty()) {
+                opcode_profile_->record(code_hash, *opcode_counts);
+            }
+        }
+        if (!hotness_profile_) {
+            return result;
+        }
+        auto const interpreted_ns =
+            interpreted ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count()
+                        : 0;
+        hotness_profile_->record(
+            code_hash,
+            static_cast<uint64_t>(msg_gas - result.gas_left),
+            static_cast<uint64_t>(interpreted_ns));
+        return result;
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::execute_impl);
+
+    template <Traits traits>
+    evmc::Result VM::execute_varcode_impl(
+        runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
+        SharedVarcode const &vcode)
     {
         auto const &icode = vcode->intercode();
         auto const &ncode = vcode->nativecode();
@@ -148,7 +335,10 @@ namespace monad::vm
                 // change, so start async compilation immediately for the
                 // new revision. Execute with interpreter in the meantime.
                 compiler_.async_compile<traits>(
-                    code_hash, icode, compiler_config_);
+                    code_hash,
+                    icode,
+                    compiler_config_,
+                    vcode->get_intercode_gas_used());
                 return execute_intercode_impl<traits>(rt_ctx, icode);
             }
             auto const entry = ncode->entrypoint();
@@ -159,13 +349,36 @@ namespace monad::vm
             }
             // Bytecode has been successfully compiled for the right
             // revision.
-            return execute_native_entrypoint_impl(rt_ctx, entry);
+            if (MONAD_VM_LIKELY(
+                    optimize_gas_threshold_ == 0 || ncode->optimized())) {
+                return execute_native_entrypoint_impl(rt_ctx, entry);
+            }
+            auto result = execute_native_entrypoint_impl(rt_ctx, entry);
+            tier_up<traits>(code_hash, vcode, msg_gas, result);
+            return result;
         }
+        auto const accumulate_gas_used = [&](evmc::Result const &result) {
+            MONAD_VM_DEBUG_ASSERT(result.gas_left >= 0);
+            MONAD_VM_DEBUG_ASSERT(msg_gas >= result.gas_left);
+            uint64_t const gas_used =
+                static_cast<uint64_t>(msg_gas - result.gas_left);
+            // Note that execution gas is counted for the second time via the
+            // intercode_gas_used function if this is a re-execution.
+            return vcode->intercode_gas_used(gas_used);
+        };
         if (!compiler_.is_varcode_cache_warm()) {
             // If cache is not warm then start async compilation
             // immediately, and execute with interpreter in the meantime.
-            compiler_.async_compile<traits>(code_hash, icode, compiler_config_);
-            return execute_intercode_impl<traits>(rt_ctx, icode);
+            // The gas is still accumulated, because it orders the compile
+            // jobs when more contracts than compile threads are queued.
+            compiler_.async_compile<traits>(
+                code_hash,
+                icode,
+                compiler_config_,
+                vcode->get_intercode_gas_used());
+            auto result = execute_intercode_impl<traits>(rt_ctx, icode);
+            accumulate_gas_used(result);
+            return result;
         }
         // Execute with interpreter. We will start async compilation when
         // the accumulated execution gas spent by interpreter on the
@@ -173,19 +386,37 @@ namespace monad::vm
         auto result = execute_intercode_impl<traits>(rt_ctx, icode);
         auto const bound = compiler::native::max_code_size(
             compiler_config_.max_code_size_offset, icode->code_size());
-        MONAD_VM_DEBUG_ASSERT(result.gas_left >= 0);
-        MONAD_VM_DEBUG_ASSERT(msg_gas >= result.gas_left);
-        uint64_t const gas_used =
-            static_cast<uint64_t>(msg_gas - result.gas_left);
-        // Note that execution gas is counted for the second time via the
-        // intercode_gas_used function if this is a re-execution.
-        if (vcode->intercode_gas_used(gas_used) >= *bound) {
-            compiler_.async_compile<traits>(code_hash, icode, compiler_config_);
+        if (auto const gas = accumulate_gas_used(result); gas >= *bound) {
+            compiler_.async_compile<traits>(
+                code_hash, icode, compiler_config_, gas);
         }
         return result;
     }
 
-    EXPLICIT_TRAITS_MEMBER(VM::execute_impl);
+    EXPLICIT_TRAITS_MEMBER(VM::execute_varcode_impl);
+
+    template <Traits traits>
+    void VM::tier_up(
+        evmc::bytes32 const &code_hash, SharedVarcode const &vcode,
+        int64_t const msg_gas, evmc::Result const &result)
+    {
+        // The LLVM backend only implements the Ethereum revisions.
+        if constexpr (std::same_as<traits, EvmTraits<traits::evm_rev()>>) {
+            MONAD_VM_DEBUG_ASSERT(msg_gas >= result.gas_left);
+            uint64_t const gas_used =
+                static_cast<uint64_t>(msg_gas - result.gas_left);
+            uint64_t const gas = vcode->native_gas_used(gas_used);
+            // Submit once, when the threshold is crossed, so a contract
+            // the optimizing tier fails to compile is not retried.
+            if (gas >= optimize_gas_threshold_ &&
+                gas - gas_used < optimize_gas_threshold_) {
+                compiler_.async_optimize<traits>(
+                    code_hash, vcode->intercode(), gas);
+            }
+        }
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::tier_up);
 
     template <Traits traits>
     evmc::Result VM::execute_bytecode_impl(
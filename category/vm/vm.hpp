@@ -18,18 +18,48 @@
 #include <category/vm/code.hpp>
 #include <category/vm/compiler.hpp>
 #include <category/vm/compiler/ir/x86.hpp>
+#include <category/vm/deploy_policy.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/execution_sampler.hpp>
 #include <category/vm/host.hpp>
+#include <category/vm/hotness_profile.hpp>
 #include <category/vm/interpreter/execute.hpp>
+#include <category/vm/opcode_profile.hpp>
+#include <category/vm/optimizing_tier.hpp>
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/utils/debug.hpp>
 
+#include <evmc/evmc.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
 namespace monad::vm
 {
     constexpr auto counts_format_string =
         ",execute_intercode_calls={},execute_native_entrypoint_"
         "calls={},execute_raw_calls={}";
 
+    /// Calls of each kind of execution; all zero unless the compiler hot
+    /// path stats are collected
+    struct VmCallCounts
+    {
+        uint64_t intercode{0}; ///< interpreted
+        uint64_t native{0}; ///< compiled to native code
+        uint64_t raw{0}; ///< interpreted from raw bytecode
+
+        VmCallCounts operator-(VmCallCounts const &other) const
+        {
+            return {
+                .intercode = intercode - other.intercode,
+                .native = native - other.native,
+                .raw = raw - other.raw};
+        }
+    };
+
     struct VmStats
     {
         std::atomic<uint64_t> execute_intercode_call_count_per_block_{0};
@@ -101,6 +131,16 @@ namespace monad::vm
             }
         }
 
+        VmCallCounts total_counts() const
+        {
+            return {
+                .intercode = execute_intercode_call_count_.load(
+                    std::memory_order_acquire),
+                .native = execute_native_entrypoint_call_count_.load(
+                    std::memory_order_acquire),
+                .raw = execute_raw_call_count_.load(std::memory_order_acquire)};
+        }
+
         std::string print_total_counts() const
         {
             if constexpr (utils::collect_monad_compiler_hot_path_stats) {
@@ -131,7 +171,8 @@ namespace monad::vm
             std::size_t max_stack_cache_byte_size =
                 runtime::EvmStackAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
             std::size_t max_memory_cache_byte_size =
-                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE);
+                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
+            unsigned compile_threads = 1);
 
         std::optional<SharedVarcode>
         find_varcode(evmc::bytes32 const &code_hash)
@@ -155,6 +196,91 @@ namespace monad::vm
             return compiler_config_;
         }
 
+        /// Start recording a hotness profile of executed code. The
+        /// `precompile_count` hottest contracts of the profile, which can
+        /// be loaded from a previous run before execution starts, are
+        /// compiled and pinned by `precompile_hottest`. Must be called
+        /// before any execution.
+        HotnessProfile &enable_hotness_profile(size_t precompile_count = 0);
+
+        /// The hotness profile, or `nullptr` if not enabled.
+        HotnessProfile *hotness_profile()
+        {
+            return hotness_profile_.get();
+        }
+
+        /// Compile `icode` to native code and pin it in the code cache
+        /// under `code_hash`, so that it is never interpreted. Returns
+        /// false if the code is empty or could not be compiled. Cheap when
+        /// the code is already compiled for `traits`.
+        template <Traits traits>
+        bool precompile(
+            evmc::bytes32 const &code_hash, SharedIntercode const &icode);
+
+        /// Compile and pin the hottest contracts requested by
+        /// `enable_hotness_profile`, fetching their code with `read_code`.
+        /// Only the first call does any work. Must not be called
+        /// concurrently with execution.
+        template <Traits traits>
+        void precompile_hottest(
+            std::function<SharedIntercode(evmc::bytes32 const &)> const
+                &read_code);
+
+        /// Recompile contracts with `tier` once the gas spent running their
+        /// baseline native code reaches `gas_threshold`. Must be called
+        /// before any execution.
+        void enable_optimizing_tier(
+            std::unique_ptr<OptimizingTier> tier, uint64_t gas_threshold);
+
+        /// Start sampling which contracts are executing every
+        /// `interval`, see `ExecutionSampler`. Must be called before any
+        /// execution.
+        ExecutionSampler &enable_execution_sampler(
+            std::chrono::microseconds interval =
+                ExecutionSampler::default_interval);
+
+        /// The execution sampler, or `nullptr` if not enabled.
+        ExecutionSampler *execution_sampler()
+        {
+            return execution_sampler_.get();
+        }
+
+        /// Start recording opcode and opcode pair counts of one in every
+        /// `sample_period` interpreted executions, see `OpcodeProfile`.
+        /// Must be called before any execution.
+        OpcodeProfile &enable_opcode_profile(
+            uint64_t sample_period = OpcodeProfile::default_sample_period);
+
+        /// The opcode profile, or `nullptr` if not enabled.
+        OpcodeProfile *opcode_profile()
+        {
+            return opcode_profile_.get();
+        }
+
+        /// Compile code deployed by CREATE and CREATE2 as soon as it is
+        /// deployed when the returned policy selects it, see
+        /// `on_deploy`. Must be called before any execution.
+        DeployPolicy &enable_deploy_policy(
+            uint64_t factory_threshold =
+                DeployPolicy::default_factory_threshold);
+
+        /// The deploy policy, or `nullptr` if not enabled, in which case
+        /// `on_deploy` does nothing.
+        DeployPolicy *deploy_policy()
+        {
+            return deploy_policy_.get();
+        }
+
+        /// Called after `deployer` deployed `vcode` with hash
+        /// `code_hash`. Code identical to code deployed before has the
+        /// same hash, so it shares the cached varcode, and its
+        /// nativecode, with all earlier copies. Other code is submitted
+        /// for async compilation if the deploy policy selects it.
+        template <Traits traits>
+        void on_deploy(
+            evmc::address const &deployer, evmc::bytes32 const &code_hash,
+            SharedVarcode const &vcode);
+
         /// Execute varcode. The function will execute the nativecode in
         /// the varcode if set. Otherwise execute the intercode with
         /// interpreter and potentially start async compilation.
@@ -204,17 +330,34 @@ namespace monad::vm
             return stats_.print_total_counts();
         }
 
+        /// Calls since construction
+        VmCallCounts total_counts() const
+        {
+            return stats_.total_counts();
+        }
+
         std::string print_compiler_stats() const
         {
             return compiler_.print_stats();
         }
 
     private:
+        /// The runtime context of a call frame executing `code` on
+        /// behalf of `host`.
+        runtime::Context make_runtime_context(
+            Host &host, evmc_message const *msg,
+            std::span<uint8_t const> code);
+
         template <Traits traits>
         evmc::Result execute_impl(
             runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
             SharedVarcode const &vcode);
 
+        template <Traits traits>
+        evmc::Result execute_varcode_impl(
+            runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
+            SharedVarcode const &vcode);
+
         template <Traits traits>
         evmc::Result execute_bytecode_impl(
             runtime::Context &rt_ctx, std::span<uint8_t const> code);
@@ -226,6 +369,17 @@ namespace monad::vm
         evmc::Result execute_native_entrypoint_impl(
             runtime::Context &, compiler::native::entrypoint_t);
 
+        template <Traits traits>
+        void tier_up(
+            evmc::bytes32 const &code_hash, SharedVarcode const &vcode,
+            int64_t msg_gas, evmc::Result const &result);
+
         VmStats stats_;
+        std::unique_ptr<HotnessProfile> hotness_profile_;
+        std::unique_ptr<DeployPolicy> deploy_policy_;
+        std::unique_ptr<ExecutionSampler> execution_sampler_;
+        std::unique_ptr<OpcodeProfile> opcode_profile_;
+        size_t precompile_count_{0};
+        uint64_t optimize_gas_threshold_{0};
     };
 }
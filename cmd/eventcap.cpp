@@ -45,12 +45,16 @@
 
 #include <CLI/CLI.hpp>
 
+#include "eventcap_analysis.hpp"
+
 #include <category/core/assert.h>
 #include <category/core/event/event_iterator.h>
 #include <category/core/event/event_metadata.h>
 #include <category/core/event/event_ring.h>
 #include <category/core/event/event_ring_util.h>
+#include <category/core/event/event_spool.hpp>
 #include <category/core/event/test_event_ctypes.h>
+#include <category/execution/ethereum/event/exec_event_ctypes.h>
 
 static sig_atomic_t g_should_exit = 0;
 
@@ -69,6 +73,11 @@ struct MetadataTableEntry
             &g_monad_test_event_schema_hash,
             std::span{g_monad_test_event_metadata},
         },
+    [MONAD_EVENT_CONTENT_TYPE_EXEC] =
+        {
+            &g_monad_exec_event_schema_hash,
+            std::span{g_monad_exec_event_metadata},
+        },
 };
 
 struct EventRingNameToDefaultPathEntry
@@ -83,7 +92,10 @@ struct EventRingNameToDefaultPathEntry
         },
     [MONAD_EVENT_CONTENT_TYPE_TEST] = {
         .name = g_monad_event_content_type_names[MONAD_EVENT_CONTENT_TYPE_TEST],
-        .default_path = MONAD_EVENT_DEFAULT_TEST_FILE_NAME}};
+        .default_path = MONAD_EVENT_DEFAULT_TEST_FILE_NAME},
+    [MONAD_EVENT_CONTENT_TYPE_EXEC] = {
+        .name = g_monad_event_content_type_names[MONAD_EVENT_CONTENT_TYPE_EXEC],
+        .default_path = MONAD_EVENT_DEFAULT_EXEC_FILE_NAME}};
 
 static char const *get_default_path_for_event_ring_name(std::string_view name)
 {
@@ -246,10 +258,11 @@ static void print_event(
 }
 
 // The "follow thread" behaves like `tail -f`: it pulls events from the ring
-// and writes them to a std::FILE* as fast as possible
+// and writes them to a std::FILE* as fast as possible, or hands them to the
+// analysis if there is one
 static void follow_thread_main(
     std::span<mapped_event_ring const> mapped_event_rings, bool dump_payload,
-    std::FILE *out)
+    monad::ExecEventAnalysis *analysis, std::FILE *out)
 {
     monad_event_descriptor event;
     monad_event_iterator *iter_bufs = static_cast<monad_event_iterator *>(
@@ -293,12 +306,85 @@ static void follow_thread_main(
                 not_ready_count = 0;
                 break; // Handled in the main loop body
             }
+            if (analysis != nullptr) {
+                analysis->on_event(&mr.event_ring, event);
+                continue;
+            }
             print_event(
                 &mr.event_ring, &event, event_metadata, dump_payload, out);
         }
     }
 }
 
+// Print (or analyze) the events in an event spool directory, starting at
+// `start_seqno` or at the oldest spooled event
+static int replay_spool(
+    char const *spool_dir, std::optional<uint64_t> start_seqno,
+    bool dump_payload, monad::ExecEventAnalysis *analysis, std::FILE *out)
+{
+    monad::EventSpoolReader reader{spool_dir};
+    auto const segments = reader.segments();
+    if (segments.empty()) {
+        errx(EX_NOINPUT, "no event spool segments in `%s`", spool_dir);
+    }
+    uint16_t const content_type = segments.front().content_type;
+    if (content_type >= std::size(MetadataTable) ||
+        MetadataTable[content_type].schema_hash == nullptr) {
+        errx(
+            EX_CONFIG,
+            "do not have the metadata mapping for event spool `%s` type %hu",
+            spool_dir,
+            content_type);
+    }
+    if (analysis != nullptr && content_type != MONAD_EVENT_CONTENT_TYPE_EXEC) {
+        errx(
+            EX_USAGE,
+            "event spool `%s` has type %hu, only execution events can be "
+            "analyzed",
+            spool_dir,
+            content_type);
+    }
+    uint64_t const seqno = start_seqno.value_or(segments.front().first_seqno);
+    if (!reader.seek_seqno(seqno)) {
+        errx(
+            EX_DATAERR,
+            "event spool `%s` does not hold seqno %lu",
+            spool_dir,
+            seqno);
+    }
+
+    monad_event_descriptor event;
+    for (;;) {
+        switch (monad_event_iterator_try_next(reader.iterator(), &event)) {
+        case MONAD_EVENT_SUCCESS:
+            if (analysis != nullptr) {
+                analysis->on_event(reader.event_ring(), event);
+                continue;
+            }
+            print_event(
+                reader.event_ring(),
+                &event,
+                MetadataTable[content_type].entries,
+                dump_payload,
+                out);
+            continue;
+
+        case MONAD_EVENT_NOT_READY:
+            if (reader.next_segment()) {
+                continue;
+            }
+            if (analysis != nullptr) {
+                analysis->finish();
+            }
+            std::fflush(out);
+            return 0;
+
+        case MONAD_EVENT_GAP:
+            MONAD_ASSERT(false, "spooled segments are contiguous");
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     std::thread follow_thread;
@@ -307,6 +393,10 @@ int main(int argc, char **argv)
     bool hexdump = false;
     std::vector<std::string> event_ring_paths;
     std::optional<uint64_t> start_seqno;
+    std::string spool_dir;
+    bool analyze = false;
+    size_t top_n = 10;
+    bool json = false;
 
     CLI::App cli{"monad event capture tool"};
     cli.add_flag("--header", print_header, "print event ring file header");
@@ -317,6 +407,25 @@ int main(int argc, char **argv)
         "--start-seqno",
         start_seqno,
         "force the starting sequence number to a particular value (for debug)");
+    cli.add_option(
+        "--spool",
+        spool_dir,
+        "print the events in an event spool directory instead of reading an "
+        "event ring");
+    auto *const analyze_flag = cli.add_flag(
+        "-a,--analyze",
+        analyze,
+        "follow an execution event ring (or read --spool) and summarize "
+        "performance: a row per block, then the busiest contracts and the "
+        "slowest transactions when interrupted or at the end of the spool");
+    cli.add_option(
+           "--top",
+           top_n,
+           "number of contracts and transactions listed by --analyze")
+        ->check(CLI::PositiveNumber)
+        ->needs(analyze_flag);
+    cli.add_flag("--json", json, "write the --analyze output as JSON lines")
+        ->needs(analyze_flag);
     cli.add_option(
            "event-ring-path",
            event_ring_paths,
@@ -334,6 +443,26 @@ int main(int argc, char **argv)
         std::exit(cli.exit(e));
     }
 
+    std::optional<monad::ExecEventAnalysis> analysis;
+    if (analyze) {
+        analysis.emplace(monad::ExecEventAnalysis::Config{
+            .top_n = top_n, .json = json, .out = stdout});
+        follow = true;
+        signal(SIGINT, [](int) { g_should_exit = 1; });
+    }
+
+    if (!spool_dir.empty()) {
+        return replay_spool(
+            spool_dir.c_str(),
+            start_seqno,
+            hexdump,
+            analysis ? &*analysis : nullptr,
+            stdout);
+    }
+    if (analyze && event_ring_paths.size() != 1) {
+        errx(EX_USAGE, "--analyze reads a single event ring");
+    }
+
     std::vector<mapped_event_ring> mapped_event_rings;
     for (auto const &path : event_ring_paths) {
         mapped_event_ring &mr = mapped_event_rings.emplace_back();
@@ -425,6 +554,14 @@ int main(int argc, char **argv)
                 "event library error -- %s",
                 monad_event_ring_get_last_error());
         }
+        if (analyze && content_type != MONAD_EVENT_CONTENT_TYPE_EXEC) {
+            errx(
+                EX_USAGE,
+                "event ring `%s` has type %hu, only execution events can be "
+                "analyzed",
+                mr.origin_path.c_str(),
+                content_type);
+        }
         mr.metadata_entries = MetadataTable[content_type].entries;
         mr.start_seqno = start_seqno;
         if (print_header) {
@@ -435,12 +572,19 @@ int main(int argc, char **argv)
 
     if (follow) {
         follow_thread = std::thread{
-            follow_thread_main, std::span{mapped_event_rings}, hexdump, stdout};
+            follow_thread_main,
+            std::span{mapped_event_rings},
+            hexdump,
+            analysis ? &*analysis : nullptr,
+            stdout};
     }
 
     if (follow_thread.joinable()) {
         follow_thread.join();
     }
+    if (analysis) {
+        analysis->finish();
+    }
 
     for (auto &mr : mapped_event_rings) {
         monad_event_ring_unmap(&mr.event_ring);
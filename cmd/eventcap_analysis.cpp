@@ -0,0 +1,408 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "eventcap_analysis.hpp"
+
+#include <category/core/config.hpp>
+#include <category/core/event/event_ring.h>
+#include <category/execution/ethereum/core/base_ctypes.h>
+#include <category/execution/ethereum/core/eth_ctypes.h>
+#include <category/execution/ethereum/event/exec_event_ctypes.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    // Copy out the fixed-size part of an event payload, so that it can be
+    // read after the payload check even if the ring overwrites it
+    template <typename T>
+    bool copy_payload(
+        monad_event_ring const *const event_ring,
+        monad_event_descriptor const &event, T &payload)
+    {
+        if (event.payload_size < sizeof payload) {
+            return false;
+        }
+        std::memcpy(
+            &payload,
+            monad_event_ring_payload_peek(event_ring, &event),
+            sizeof payload);
+        return monad_event_ring_payload_check(event_ring, &event);
+    }
+
+    std::array<uint8_t, 20> to_key(monad_c_address const &address)
+    {
+        static_assert(sizeof address == 20);
+        std::array<uint8_t, 20> key;
+        std::memcpy(key.data(), &address, sizeof address);
+        return key;
+    }
+
+    std::string to_hex(std::array<uint8_t, 20> const &key)
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string hex{"0x"};
+        for (uint8_t const b : key) {
+            hex += digits[b >> 4];
+            hex += digits[b & 0xf];
+        }
+        return hex;
+    }
+
+    constexpr uint64_t to_micros(uint64_t const nanos)
+    {
+        return nanos / 1'000;
+    }
+
+    constexpr unsigned TABLE_HEADER_PERIOD = 40;
+
+    constexpr auto slower = [](auto const &a, auto const &b) {
+        return a.evm_nanos > b.evm_nanos;
+    };
+}
+
+ExecEventAnalysis::ExecEventAnalysis(Config const &config)
+    : config_{config}
+{
+}
+
+void ExecEventAnalysis::on_event(
+    monad_event_ring const *const event_ring,
+    monad_event_descriptor const &event)
+{
+    if (event.event_type == MONAD_EXEC_BLOCK_START) {
+        monad_exec_block_start start;
+        if (!copy_payload(event_ring, event, start)) {
+            ++lost_payloads_;
+            in_block_ = false;
+            return;
+        }
+        in_block_ = true;
+        block_seqno_ = event.seqno;
+        block_number_ = start.block_tag.block_number;
+        block_start_nanos_ = event.record_epoch_nanos;
+        txns_.assign(start.eth_block_input.txn_count, TxnState{});
+        block_logs_.clear();
+        return;
+    }
+
+    // Events of a block whose start was not seen (e.g., it was before the
+    // iterator's starting point, or its payload was lost) are skipped
+    if (!in_block_ ||
+        event.content_ext[MONAD_FLOW_BLOCK_SEQNO] != block_seqno_) {
+        return;
+    }
+    uint64_t const txn_id = event.content_ext[MONAD_FLOW_TXN_ID];
+    TxnState *const txn =
+        txn_id != 0 && txn_id <= txns_.size() ? &txns_[txn_id - 1] : nullptr;
+
+    switch (event.event_type) {
+    case MONAD_EXEC_TXN_HEADER_START: {
+        monad_exec_txn_header_start header;
+        if (txn == nullptr) {
+            break;
+        }
+        if (!copy_payload(event_ring, event, header)) {
+            ++lost_payloads_;
+            break;
+        }
+        txn->to = to_key(header.txn_header.to);
+        txn->is_contract_creation = header.txn_header.is_contract_creation;
+        break;
+    }
+
+    case MONAD_EXEC_TXN_PERF_EVM_ENTER:
+        if (txn != nullptr) {
+            txn->evm_enter_nanos = event.record_epoch_nanos;
+        }
+        break;
+
+    case MONAD_EXEC_TXN_PERF_EVM_EXIT:
+        if (txn != nullptr && txn->evm_enter_nanos != 0) {
+            txn->evm_nanos = event.record_epoch_nanos - txn->evm_enter_nanos;
+        }
+        break;
+
+    case MONAD_EXEC_TXN_EVM_OUTPUT: {
+        monad_exec_txn_evm_output output;
+        if (txn == nullptr) {
+            break;
+        }
+        if (!copy_payload(event_ring, event, output)) {
+            ++lost_payloads_;
+            break;
+        }
+        txn->executed = true;
+        txn->gas_used = output.receipt.gas_used;
+        txn->log_count = output.receipt.log_count;
+        break;
+    }
+
+    case MONAD_EXEC_TXN_PERF_STATS: {
+        monad_exec_txn_perf_stats stats;
+        if (txn == nullptr) {
+            break;
+        }
+        if (!copy_payload(event_ring, event, stats)) {
+            ++lost_payloads_;
+            break;
+        }
+        txn->retried = stats.has_conflict;
+        txn->retry_nanos = stats.retry_nanos;
+        break;
+    }
+
+    case MONAD_EXEC_TXN_LOG: {
+        monad_c_eth_txn_log log;
+        if (!copy_payload(event_ring, event, log)) {
+            ++lost_payloads_;
+            break;
+        }
+        ++block_logs_[to_key(log.address)];
+        break;
+    }
+
+    case MONAD_EXEC_BLOCK_END:
+        end_block(event.record_epoch_nanos);
+        break;
+
+    case MONAD_EXEC_BLOCK_REJECT:
+        ++rejected_blocks_;
+        in_block_ = false;
+        break;
+
+    case MONAD_EXEC_EVM_ERROR:
+        if (txn == nullptr) {
+            ++rejected_blocks_;
+            in_block_ = false;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void ExecEventAnalysis::end_block(uint64_t const end_nanos)
+{
+    in_block_ = false;
+
+    uint64_t gas_used = 0;
+    uint64_t evm_nanos = 0;
+    uint64_t retries = 0;
+    uint64_t logs = 0;
+    for (uint32_t i = 0; i < txns_.size(); ++i) {
+        TxnState const &txn = txns_[i];
+        if (!txn.executed) {
+            continue;
+        }
+        gas_used += txn.gas_used;
+        evm_nanos += txn.evm_nanos;
+        retries += txn.retried ? 1 : 0;
+        logs += txn.log_count;
+
+        // Contract creations are all counted under the zero address
+        ContractStats &contract =
+            contracts_[txn.is_contract_creation ? AddressKey{} : txn.to];
+        ++contract.txns;
+        contract.gas_used += txn.gas_used;
+        contract.evm_nanos += txn.evm_nanos;
+        contract.retries += txn.retried ? 1 : 0;
+
+        record_slow_txn(SlowTxn{
+            .evm_nanos = txn.evm_nanos,
+            .block_number = block_number_,
+            .txn_index = i,
+            .to = txn.to,
+            .is_contract_creation = txn.is_contract_creation,
+            .gas_used = txn.gas_used,
+            .retried = txn.retried});
+    }
+    for (auto const &[address, count] : block_logs_) {
+        contracts_[address].logs += count;
+    }
+
+    uint64_t const wall_nanos =
+        end_nanos > block_start_nanos_ ? end_nanos - block_start_nanos_ : 0;
+    if (config_.json) {
+        std::fprintf(
+            config_.out,
+            "{\"block\":%lu,\"txns\":%zu,\"gas_used\":%lu,\"wall_us\":%lu,"
+            "\"evm_us\":%lu,\"retries\":%lu,\"logs\":%lu}\n",
+            block_number_,
+            txns_.size(),
+            gas_used,
+            to_micros(wall_nanos),
+            to_micros(evm_nanos),
+            retries,
+            logs);
+    }
+    else {
+        if (blocks_ % TABLE_HEADER_PERIOD == 0) {
+            std::fprintf(
+                config_.out,
+                "%10s %6s %12s %10s %10s %8s %8s\n",
+                "BLOCK",
+                "TXNS",
+                "GAS",
+                "WALL_US",
+                "EVM_US",
+                "RETRIES",
+                "LOGS");
+        }
+        std::fprintf(
+            config_.out,
+            "%10lu %6zu %12lu %10lu %10lu %8lu %8lu\n",
+            block_number_,
+            txns_.size(),
+            gas_used,
+            to_micros(wall_nanos),
+            to_micros(evm_nanos),
+            retries,
+            logs);
+    }
+    ++blocks_;
+}
+
+void ExecEventAnalysis::record_slow_txn(SlowTxn const &txn)
+{
+    // Keep the top_n slowest in a min-heap, whose root is the fastest of them
+    if (slowest_.size() < config_.top_n) {
+        slowest_.push_back(txn);
+        std::ranges::push_heap(slowest_, slower);
+    }
+    else if (!slowest_.empty() && txn.evm_nanos > slowest_.front().evm_nanos) {
+        std::ranges::pop_heap(slowest_, slower);
+        slowest_.back() = txn;
+        std::ranges::push_heap(slowest_, slower);
+    }
+}
+
+void ExecEventAnalysis::finish()
+{
+    std::vector<std::pair<AddressKey, ContractStats>> contracts{
+        contracts_.begin(), contracts_.end()};
+    std::ranges::sort(
+        contracts, slower, &std::pair<AddressKey, ContractStats>::second);
+    if (contracts.size() > config_.top_n) {
+        contracts.resize(config_.top_n);
+    }
+    std::vector<SlowTxn> slowest = slowest_;
+    std::ranges::sort(slowest, slower);
+
+    if (config_.json) {
+        std::fprintf(
+            config_.out,
+            "{\"blocks\":%lu,\"rejected_blocks\":%lu,\"lost_payloads\":%lu,"
+            "\"contracts\":[",
+            blocks_,
+            rejected_blocks_,
+            lost_payloads_);
+        for (size_t i = 0; auto const &[address, stats] : contracts) {
+            std::fprintf(
+                config_.out,
+                "%s{\"address\":\"%s\",\"txns\":%lu,\"gas_used\":%lu,"
+                "\"evm_us\":%lu,\"retries\":%lu,\"logs\":%lu}",
+                i++ == 0 ? "" : ",",
+                to_hex(address).c_str(),
+                stats.txns,
+                stats.gas_used,
+                to_micros(stats.evm_nanos),
+                stats.retries,
+                stats.logs);
+        }
+        std::fprintf(config_.out, "],\"slowest\":[");
+        for (size_t i = 0; SlowTxn const &txn : slowest) {
+            std::string const to = txn.is_contract_creation
+                                       ? std::string{"null"}
+                                       : '"' + to_hex(txn.to) + '"';
+            std::fprintf(
+                config_.out,
+                "%s{\"block\":%lu,\"txn\":%u,\"to\":%s,\"evm_us\":%lu,"
+                "\"gas_used\":%lu,\"retried\":%s}",
+                i++ == 0 ? "" : ",",
+                txn.block_number,
+                txn.txn_index,
+                to.c_str(),
+                to_micros(txn.evm_nanos),
+                txn.gas_used,
+                txn.retried ? "true" : "false");
+        }
+        std::fprintf(config_.out, "]}\n");
+        std::fflush(config_.out);
+        return;
+    }
+
+    std::fprintf(
+        config_.out,
+        "\n%lu blocks, %lu rejected, %lu lost payloads\n",
+        blocks_,
+        rejected_blocks_,
+        lost_payloads_);
+    std::fprintf(config_.out, "\ncontracts by EVM time:\n");
+    std::fprintf(
+        config_.out,
+        "%-42s %8s %14s %12s %8s %8s\n",
+        "ADDRESS",
+        "TXNS",
+        "GAS",
+        "EVM_US",
+        "RETRIES",
+        "LOGS");
+    for (auto const &[address, stats] : contracts) {
+        std::fprintf(
+            config_.out,
+            "%-42s %8lu %14lu %12lu %8lu %8lu\n",
+            address == AddressKey{} ? "(create)" : to_hex(address).c_str(),
+            stats.txns,
+            stats.gas_used,
+            to_micros(stats.evm_nanos),
+            stats.retries,
+            stats.logs);
+    }
+    std::fprintf(config_.out, "\nslowest transactions:\n");
+    std::fprintf(
+        config_.out,
+        "%10s %6s %-42s %10s %12s %7s\n",
+        "BLOCK",
+        "TXN",
+        "TO",
+        "EVM_US",
+        "GAS",
+        "RETRIED");
+    for (SlowTxn const &txn : slowest) {
+        std::fprintf(
+            config_.out,
+            "%10lu %6u %-42s %10lu %12lu %7s\n",
+            txn.block_number,
+            txn.txn_index,
+            txn.is_contract_creation ? "(create)" : to_hex(txn.to).c_str(),
+            to_micros(txn.evm_nanos),
+            txn.gas_used,
+            txn.retried ? "yes" : "no");
+    }
+    std::fflush(config_.out);
+}
+
+MONAD_NAMESPACE_END
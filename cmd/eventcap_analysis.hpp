@@ -0,0 +1,105 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+struct monad_event_descriptor;
+struct monad_event_ring;
+
+MONAD_NAMESPACE_BEGIN
+
+/// Aggregates the events of an execution event ring into performance
+/// summaries. A row (or a JSON line) is written for each block as its
+/// BLOCK_END arrives; `finish` writes the busiest contracts and the slowest
+/// transactions seen over the whole run.
+class ExecEventAnalysis
+{
+public:
+    struct Config
+    {
+        size_t top_n; ///< Length of the contract and transaction lists
+        bool json; ///< Write JSON lines instead of tables
+        std::FILE *out;
+    };
+
+    explicit ExecEventAnalysis(Config const &);
+
+    void on_event(monad_event_ring const *, monad_event_descriptor const &);
+
+    void finish();
+
+private:
+    using AddressKey = std::array<uint8_t, 20>;
+
+    struct TxnState
+    {
+        AddressKey to{};
+        bool is_contract_creation{false};
+        bool executed{false};
+        bool retried{false};
+        uint64_t evm_enter_nanos{0};
+        uint64_t evm_nanos{0};
+        uint64_t retry_nanos{0};
+        uint64_t gas_used{0};
+        uint32_t log_count{0};
+    };
+
+    struct ContractStats
+    {
+        uint64_t txns{0};
+        uint64_t gas_used{0};
+        uint64_t evm_nanos{0};
+        uint64_t retries{0};
+        uint64_t logs{0};
+    };
+
+    struct SlowTxn
+    {
+        uint64_t evm_nanos;
+        uint64_t block_number;
+        uint32_t txn_index;
+        AddressKey to;
+        bool is_contract_creation;
+        uint64_t gas_used;
+        bool retried;
+    };
+
+    void end_block(uint64_t end_nanos);
+    void record_slow_txn(SlowTxn const &);
+
+    Config config_;
+    bool in_block_{false};
+    uint64_t block_seqno_{0};
+    uint64_t block_number_{0};
+    uint64_t block_start_nanos_{0};
+    std::vector<TxnState> txns_;
+    std::map<AddressKey, uint64_t> block_logs_;
+    std::map<AddressKey, ContractStats> contracts_;
+    std::vector<SlowTxn> slowest_; ///< Min-heap on evm_nanos
+    uint64_t blocks_{0};
+    uint64_t rejected_blocks_{0};
+    uint64_t lost_payloads_{0};
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,145 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "bench.hpp"
+
+#include <category/core/config.hpp>
+
+#include <nlohmann/json.hpp>
+#include <quill/Quill.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+struct PassTotals
+{
+    uint64_t blocks{0};
+    uint64_t transactions{0};
+    uint64_t gas_used{0};
+    uint64_t retries{0};
+    std::chrono::microseconds sender_recovery{0};
+    std::chrono::microseconds execution{0};
+    std::chrono::microseconds commit{0};
+    std::chrono::microseconds total{0};
+    monad::IoCounters io{};
+};
+
+uint64_t gas_per_sec(uint64_t const gas, std::chrono::microseconds const time)
+{
+    return gas * 1'000'000 /
+           static_cast<uint64_t>(std::max(int64_t{1}, int64_t{time.count()}));
+}
+
+nlohmann::json to_json(monad::IoCounters const &io)
+{
+    return {
+        {"read_bytes", io.read_bytes},
+        {"write_bytes", io.write_bytes},
+        {"read_syscalls", io.read_syscalls},
+        {"write_syscalls", io.write_syscalls}};
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+void BenchReport::add(BlockSample const &sample)
+{
+    if (!config_.reported(sample.pass)) {
+        return;
+    }
+    samples_.push_back(sample);
+    samples_.back().pass -= config_.warmup;
+}
+
+void BenchReport::write(std::filesystem::path const &path) const
+{
+    nlohmann::json blocks = nlohmann::json::array();
+    std::vector<PassTotals> passes(config_.repeat);
+    for (auto const &sample : samples_) {
+        blocks.push_back(
+            {{"pass", sample.pass},
+             {"block", sample.block_number},
+             {"transactions", sample.transactions},
+             {"gas_used", sample.gas_used},
+             {"retries", sample.retries},
+             {"sender_recovery_us", sample.sender_recovery.count()},
+             {"execution_us", sample.execution.count()},
+             {"commit_us", sample.commit.count()},
+             {"total_us", sample.total.count()},
+             {"gas_per_sec", gas_per_sec(sample.gas_used, sample.execution)},
+             {"io", to_json(sample.io)}});
+
+        auto &pass = passes[sample.pass];
+        ++pass.blocks;
+        pass.transactions += sample.transactions;
+        pass.gas_used += sample.gas_used;
+        pass.retries += sample.retries;
+        pass.sender_recovery += sample.sender_recovery;
+        pass.execution += sample.execution;
+        pass.commit += sample.commit;
+        pass.total += sample.total;
+        pass.io.read_bytes += sample.io.read_bytes;
+        pass.io.write_bytes += sample.io.write_bytes;
+        pass.io.read_syscalls += sample.io.read_syscalls;
+        pass.io.write_syscalls += sample.io.write_syscalls;
+    }
+
+    nlohmann::json totals = nlohmann::json::array();
+    for (unsigned i = 0; i < passes.size(); ++i) {
+        auto const &pass = passes[i];
+        totals.push_back(
+            {{"pass", i},
+             {"blocks", pass.blocks},
+             {"transactions", pass.transactions},
+             {"gas_used", pass.gas_used},
+             {"retries", pass.retries},
+             {"sender_recovery_us", pass.sender_recovery.count()},
+             {"execution_us", pass.execution.count()},
+             {"commit_us", pass.commit.count()},
+             {"total_us", pass.total.count()},
+             {"gas_per_sec", gas_per_sec(pass.gas_used, pass.execution)},
+             {"total_gas_per_sec", gas_per_sec(pass.gas_used, pass.total)},
+             {"io", to_json(pass.io)}});
+    }
+
+    nlohmann::json const report = {
+        {"commit", config_.commit},
+        {"warmup", config_.warmup},
+        {"repeat", config_.repeat},
+        {"blocks", std::move(blocks)},
+        {"passes", std::move(totals)}};
+    std::ofstream os{path, std::ios::trunc};
+    os << report.dump(2) << '\n';
+    if (!os) {
+        LOG_WARNING("cannot write bench report to {}", path.string());
+        return;
+    }
+    LOG_INFO(
+        "Wrote {} block samples of {} passes to {}",
+        samples_.size(),
+        passes.size(),
+        path.string());
+}
+
+MONAD_NAMESPACE_END
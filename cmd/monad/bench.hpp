@@ -0,0 +1,89 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "io_counters.hpp"
+
+#include <category/core/config.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Measurements of one execution of one block
+struct BlockSample
+{
+    unsigned pass{0};
+    uint64_t block_number{0};
+    size_t transactions{0};
+    uint64_t gas_used{0};
+    uint32_t retries{0};
+    std::chrono::microseconds sender_recovery{0};
+    std::chrono::microseconds execution{0};
+    std::chrono::microseconds commit{0};
+    std::chrono::microseconds total{0};
+    IoCounters io{};
+};
+
+/// Deterministic replay of a block range. The range is replayed `warmup`
+/// times without being reported, then `repeat` times. Without commit, the
+/// state changes of every block are dropped and each block reads the state
+/// of its parent from the db history, so every pass sees the same inputs.
+struct BenchConfig
+{
+    bool commit;
+    unsigned warmup;
+    unsigned repeat;
+
+    unsigned passes() const
+    {
+        return warmup + repeat;
+    }
+
+    bool reported(unsigned const pass) const
+    {
+        return pass >= warmup;
+    }
+};
+
+class BenchReport
+{
+    BenchConfig config_;
+    std::vector<BlockSample> samples_{};
+
+public:
+    explicit BenchReport(BenchConfig const &config)
+        : config_{config}
+    {
+    }
+
+    BenchConfig const &config() const
+    {
+        return config_;
+    }
+
+    void add(BlockSample const &);
+
+    /// Writes the samples, followed by the totals of every reported pass,
+    /// as one json object
+    void write(std::filesystem::path const &) const;
+};
+
+MONAD_NAMESPACE_END
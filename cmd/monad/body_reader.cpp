@@ -0,0 +1,116 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "body_reader.hpp"
+#include "file_io.hpp"
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/util/latency_histogram.hpp>
+#include <category/execution/monad/core/monad_block.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include <pthread.h>
+
+MONAD_NAMESPACE_BEGIN
+
+BodyReader::BodyReader(std::filesystem::path const &body_dir)
+    : body_dir_{body_dir}
+    , thread_{[this](std::stop_token const token) { run(token); }}
+{
+}
+
+void BodyReader::run(std::stop_token const token)
+{
+    pthread_setname_np(pthread_self(), "body reader");
+    static LatencyMetric &latency = latency_metric(
+        "monad_block_body_read_seconds",
+        "time to read and decode a block body ahead of its execution");
+
+    std::unique_lock lock{mutex_};
+    while (!token.stop_requested() &&
+           cv_.wait(lock, token, [this] { return !pending_.empty(); })) {
+        bytes32_t const id = pending_.front();
+        pending_.pop_front();
+        in_flight_ = id;
+        uint64_t const generation = generation_;
+        lock.unlock();
+
+        auto const begin = std::chrono::steady_clock::now();
+        MonadConsensusBlockBody body = read_body(id, body_dir_);
+        latency.record(std::chrono::steady_clock::now() - begin);
+
+        lock.lock();
+        in_flight_.reset();
+        if (generation == generation_) {
+            ready_.emplace(id, std::move(body));
+        }
+        cv_.notify_all();
+    }
+}
+
+void BodyReader::prefetch(bytes32_t const &id)
+{
+    {
+        std::lock_guard const lock{mutex_};
+        if (in_flight_ == id || ready_.contains(id) ||
+            std::ranges::find(pending_, id) != pending_.end()) {
+            return;
+        }
+        pending_.push_back(id);
+    }
+    cv_.notify_all();
+}
+
+MonadConsensusBlockBody BodyReader::get(bytes32_t const &id)
+{
+    static LatencyMetric &latency = latency_metric(
+        "monad_block_body_get_seconds",
+        "time the execution thread is blocked obtaining a block body");
+    ScopedLatency const timer{latency};
+
+    {
+        std::unique_lock lock{mutex_};
+        cv_.wait(lock, [&] { return in_flight_ != id; });
+        if (auto it = ready_.find(id); it != ready_.end()) {
+            MonadConsensusBlockBody body = std::move(it->second);
+            ready_.erase(it);
+            return body;
+        }
+        // Not worth waiting for the bodies queued ahead of it
+        if (auto const it = std::ranges::find(pending_, id);
+            it != pending_.end()) {
+            pending_.erase(it);
+        }
+    }
+    return read_body(id, body_dir_);
+}
+
+void BodyReader::clear()
+{
+    std::lock_guard const lock{mutex_};
+    pending_.clear();
+    ready_.clear();
+    ++generation_;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,65 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/execution/monad/core/monad_block.hpp>
+
+#include <ankerl/unordered_dense.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Reads and decodes block bodies on a background thread, ahead of the
+/// execution thread asking for them. Bodies which were never requested are
+/// read synchronously by get().
+class BodyReader
+{
+    std::filesystem::path const body_dir_;
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<bytes32_t> pending_;
+    std::optional<bytes32_t> in_flight_;
+    ankerl::unordered_dense::map<bytes32_t, MonadConsensusBlockBody> ready_;
+    // Bumped by clear(), so that a read in flight at the time is dropped
+    uint64_t generation_{0};
+    std::jthread thread_;
+
+    void run(std::stop_token);
+
+public:
+    explicit BodyReader(std::filesystem::path const &body_dir);
+
+    /// Schedules the body `id` to be read in the background
+    void prefetch(bytes32_t const &id);
+
+    /// Returns the body `id`, waiting for it if it is being prefetched
+    MonadConsensusBlockBody get(bytes32_t const &id);
+
+    /// Drops every scheduled and prefetched body
+    void clear();
+};
+
+MONAD_NAMESPACE_END
@@ -20,13 +20,17 @@
 #include <category/core/config.hpp>
 #include <category/core/event/event_ring.h>
 #include <category/core/event/event_ring_util.h>
+#include <category/core/event/event_spool.hpp>
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
 #include <category/execution/ethereum/event/exec_event_recorder.hpp>
+#include <category/execution/ethereum/event/exec_iter_help.h>
 
 #include <charconv>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <filesystem>
 #include <format>
 #include <memory>
 #include <ranges>
@@ -34,6 +38,7 @@
 #include <string_view>
 #include <system_error>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <errno.h>
@@ -254,4 +259,37 @@ int init_execution_event_recorder(EventRingConfig ring_config)
     return 0;
 }
 
+std::unique_ptr<EventSpoolWriter>
+start_execution_event_spool(std::filesystem::path dir, size_t max_segments)
+{
+    MONAD_ASSERT(g_exec_event_recorder, "spool needs the event recorder");
+    LOG_INFO("spooling execution events to {}", dir.string());
+    return std::make_unique<EventSpoolWriter>(
+        *g_exec_event_recorder->get_event_ring(),
+        EventSpoolWriter::Config{
+            .dir = std::move(dir),
+            .max_segments = max_segments,
+            .block_number =
+                [](monad_event_ring const *event_ring,
+                   monad_event_descriptor const *event,
+                   uint64_t *block_number) {
+                    // Only consensus events, so that segments start between
+                    // blocks; events inside a block would otherwise look up
+                    // their BLOCK_START
+                    if (event->content_ext[MONAD_FLOW_BLOCK_SEQNO] != 0 &&
+                        event->event_type != MONAD_EXEC_BLOCK_START) {
+                        return false;
+                    }
+                    return monad_exec_ring_get_block_number(
+                        event_ring, event, block_number);
+                }});
+}
+
+void enable_execution_state_diff_events()
+{
+    MONAD_ASSERT(g_exec_event_recorder, "state diffs need the event recorder");
+    g_exec_event_recorder->enable_state_diffs();
+    LOG_INFO("recording state diff events");
+}
+
 MONAD_NAMESPACE_END
@@ -27,11 +27,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
 
 MONAD_NAMESPACE_BEGIN
 
+class EventSpoolWriter;
+
 // clang-format off
 
 struct EventRingConfig
@@ -65,4 +69,15 @@ std::expected<EventRingConfig, std::string>
 /// given configuration options
 int init_execution_event_recorder(EventRingConfig);
 
+/// Start spooling the execution event ring to segment files in `dir`, so that
+/// consumers which fall behind the ring can catch up from disk; keeps at most
+/// `max_segments` segments, or all of them if zero. The recorder must already
+/// be initialized; spooling stops when the returned object is destroyed.
+std::unique_ptr<EventSpoolWriter>
+start_execution_event_spool(std::filesystem::path dir, size_t max_segments);
+
+/// Record the net state changes of each block as STATE_DIFF_HEADER and
+/// ACCOUNT_DIFF events; the recorder must already be initialized
+void enable_execution_state_diff_events();
+
 MONAD_NAMESPACE_END
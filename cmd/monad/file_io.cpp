@@ -22,6 +22,7 @@
 
 #include <evmc/evmc.hpp>
 
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 
@@ -34,10 +35,13 @@ byte_string read_file(bytes32_t const &id, std::filesystem::path const &dir)
     MONAD_ASSERT(
         std::filesystem::exists(path) &&
         std::filesystem::is_regular_file(path));
-    std::ifstream is(path);
+    std::ifstream is(path, std::ios::binary);
     MONAD_ASSERT(is);
-    byte_string const data{
-        std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    // One read of the whole file, rather than a character at a time
+    byte_string data(std::filesystem::file_size(path), uint8_t{0});
+    MONAD_ASSERT(is.read(
+        reinterpret_cast<char *>(data.data()),
+        static_cast<std::streamsize>(data.size())));
     auto const checksum = to_bytes(blake3(data));
     MONAD_ASSERT_PRINTF(
         checksum == id, "Checksum failed for bft header: %s", filename.c_str());
@@ -0,0 +1,58 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "io_counters.hpp"
+
+#include <category/core/config.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+MONAD_NAMESPACE_BEGIN
+
+IoCounters IoCounters::now()
+{
+    IoCounters counters;
+    std::ifstream is{"/proc/self/io"};
+    std::string key;
+    uint64_t value;
+    while (is >> key >> value) {
+        if (key == "read_bytes:") {
+            counters.read_bytes = value;
+        }
+        else if (key == "write_bytes:") {
+            counters.write_bytes = value;
+        }
+        else if (key == "syscr:") {
+            counters.read_syscalls = value;
+        }
+        else if (key == "syscw:") {
+            counters.write_syscalls = value;
+        }
+    }
+    return counters;
+}
+
+IoCounters IoCounters::operator-(IoCounters const &other) const
+{
+    return {
+        .read_bytes = read_bytes - other.read_bytes,
+        .write_bytes = write_bytes - other.write_bytes,
+        .read_syscalls = read_syscalls - other.read_syscalls,
+        .write_syscalls = write_syscalls - other.write_syscalls};
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,38 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <cstdint>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Process wide I/O counters from /proc/self/io. They include the io_uring
+/// submission threads, so they cover the trie reads and writes.
+struct IoCounters
+{
+    uint64_t read_bytes{0};
+    uint64_t write_bytes{0};
+    uint64_t read_syscalls{0};
+    uint64_t write_syscalls{0};
+
+    static IoCounters now();
+
+    IoCounters operator-(IoCounters const &) const;
+};
+
+MONAD_NAMESPACE_END
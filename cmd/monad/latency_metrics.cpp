@@ -0,0 +1,79 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "latency_metrics.hpp"
+
+#include <category/core/config.hpp>
+#include <category/core/util/latency_histogram.hpp>
+
+#include <quill/Quill.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+
+#include <pthread.h>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+void write_latency_metrics_file(std::filesystem::path const &path)
+{
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream os{tmp, std::ios::trunc};
+        write_latency_metrics(os);
+        if (!os) {
+            LOG_WARNING("cannot write latency metrics to {}", tmp.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        LOG_WARNING(
+            "cannot rename latency metrics to {}: {}",
+            path.string(),
+            ec.message());
+    }
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+std::jthread start_latency_metrics_writer(
+    std::filesystem::path const &path, std::chrono::seconds const interval)
+{
+    return std::jthread([path, interval](std::stop_token const token) {
+        pthread_setname_np(pthread_self(), "latency metrics");
+        std::mutex mutex;
+        std::condition_variable_any cv;
+        std::unique_lock lock{mutex};
+        // The last iteration runs once the stop is requested, so the final
+        // totals are written on shutdown
+        while (!token.stop_requested()) {
+            cv.wait_for(lock, token, interval, [] { return false; });
+            write_latency_metrics_file(path);
+        }
+    });
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,32 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+MONAD_NAMESPACE_BEGIN
+
+/// Rewrites `path` with the Prometheus text dump of all latency metrics every
+/// `interval` and once more when the returned thread is stopped. The file is
+/// replaced atomically, so a scraper never sees a partial dump.
+std::jthread start_latency_metrics_writer(
+    std::filesystem::path const &path, std::chrono::seconds interval);
+
+MONAD_NAMESPACE_END
@@ -13,15 +13,21 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include "bench.hpp"
 #include "event.hpp"
+#include "latency_metrics.hpp"
 #include "runloop_ethereum.hpp"
 #include "runloop_monad.hpp"
 
 #include <category/core/assert.h>
 #include <category/core/basic_formatter.hpp>
 #include <category/core/config.hpp>
+#include <category/core/cpuset.h>
+#include <category/core/event/event_spool.hpp>
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/likely.h>
+#include <category/core/mem/huge_slab.hpp>
+#include <category/core/mem/memory_governor.hpp>
 #include <category/core/monad_exception.hpp>
 #include <category/core/procfs/statm.h>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
@@ -37,8 +43,10 @@
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
 #include <category/execution/ethereum/precompiles.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/event_trace.hpp>
+#include <category/execution/ethereum/trace/span_trace.hpp>
 #include <category/execution/monad/chain/monad_devnet.hpp>
 #include <category/execution/monad/chain/monad_mainnet.hpp>
 #include <category/execution/monad/chain/monad_testnet.hpp>
@@ -47,8 +55,15 @@
 #include <category/statesync/statesync_server.h>
 #include <category/statesync/statesync_server_context.hpp>
 #include <category/statesync/statesync_server_network.hpp>
+#include <category/vm/execution_sampler.hpp>
+#include <category/vm/opcode_profile.hpp>
+#include <category/vm/shared_code_store.hpp>
 #include <category/vm/vm.hpp>
 
+#ifdef MONAD_COMPILER_LLVM
+    #include <category/vm/llvm/optimizing_tier.hpp>
+#endif
+
 #include <CLI/CLI.hpp>
 
 #include <quill/LogLevel.h>
@@ -63,12 +78,18 @@
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
+#include <fstream>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <ostream>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdexcept>
 #include <string>
 #include <sys/sysinfo.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -126,15 +147,62 @@ try {
     uint64_t nblocks = std::numeric_limits<uint64_t>::max();
     unsigned nthreads = 4;
     unsigned nfibers = 256;
+    unsigned fiber_stack_mb = 8;
+    size_t db_cache_mb = DbCache::default_budget_bytes >> 20;
+    size_t negative_lookup_mb = 0;
+    bool log_index = false;
+    bool fiber_huge_pages = false;
+    size_t node_slab_gb = 0;
+    size_t memory_cap_gb = 0;
+    unsigned commit_threads = 1;
     bool no_compaction = false;
+    uint64_t compaction_io_budget_mb = 0;
+    unsigned wr_buffer_mb = 8;
     bool trace_calls = false;
+    fs::path trace_calls_file;
+    bool conflict_scheduler = false;
+    bool prefetch_state = false;
+    bool predict_slots = false;
+    bool multi_version_reads = false;
+    bool recover_signers_ahead = false;
+    bool speculate_next_block = false;
     std::string exec_event_ring_config;
+    fs::path exec_event_spool;
+    size_t exec_event_spool_segments = 0;
+    bool exec_event_state_diffs = false;
+    fs::path latency_metrics_file;
+    unsigned latency_metrics_interval = 10;
+    fs::path bench;
+    bool bench_no_commit = false;
+    std::optional<uint64_t> bench_start;
+    unsigned bench_warmup = 0;
+    unsigned bench_repeat = 1;
     unsigned sq_thread_cpu = static_cast<unsigned>(get_nprocs() - 1);
     unsigned ro_sq_thread_cpu = static_cast<unsigned>(get_nprocs() - 2);
+    std::optional<unsigned> numa_node;
+    std::optional<unsigned> log_cpu;
     std::vector<fs::path> dbname_paths;
     fs::path snapshot;
     fs::path dump_snapshot;
+    fs::path hot_nodes;
+    fs::path vm_code_cache;
+    unsigned vm_compile_threads = 1;
+    fs::path vm_hotness_profile;
+    size_t vm_precompile = 256;
+    fs::path vm_opcode_profile;
+    uint64_t vm_opcode_sample_period =
+        vm::OpcodeProfile::default_sample_period;
+    uint64_t vm_deploy_factory_threshold = 0;
+    fs::path vm_execution_profile;
+    unsigned vm_execution_sample_us = static_cast<unsigned>(
+        vm::ExecutionSampler::default_interval.count());
+    fs::path shared_code_store;
+    size_t shared_code_store_mb = 1024;
+#ifdef MONAD_COMPILER_LLVM
+    uint64_t vm_optimize_gas = 0;
+#endif
     std::string statesync;
+    unsigned statesync_workers = 0;
     auto log_level = quill::LogLevel::Info;
 
     std::unordered_map<std::string, monad_chain_config> const CHAIN_CONFIG_MAP =
@@ -154,16 +222,81 @@ try {
         ->transform(CLI::CheckedTransformer(log_level_map, CLI::ignore_case));
     cli.add_option("--nthreads", nthreads, "number of threads");
     cli.add_option("--nfibers", nfibers, "number of fibers");
+    cli.add_option(
+        "--fiber_stack_mb",
+        fiber_stack_mb,
+        "MB of address space reserved per fiber stack; pages are committed "
+        "only as a fiber's stack grows into them");
+    cli.add_flag(
+        "--fiber_huge_pages",
+        fiber_huge_pages,
+        "back fiber stacks with transparent huge pages");
+    cli.add_option(
+        "--node_slab_gb",
+        node_slab_gb,
+        "GB of address space for allocating trie nodes from 2MB slabs backed "
+        "by huge pages, 0 (the default) to allocate them with malloc; nodes "
+        "use malloc beyond it");
+    cli.add_option(
+        "--memory_cap_gb",
+        memory_cap_gb,
+        "keep the resident set size under this many GB by moving budget "
+        "between the db and varcode caches; 0 leaves them at fixed sizes");
+    cli.add_option(
+        "--commit_threads",
+        commit_threads,
+        "number of threads hashing keys and encoding values of the updates "
+        "on commit; with more than one, the block data tries are built "
+        "while the state trie updates");
+    cli.add_option(
+        "--db_cache_mb",
+        db_cache_mb,
+        "MB of memory caching finalized accounts and storage slots, split "
+        "between the two by how often each misses");
+    cli.add_option(
+        "--negative_lookup_mb",
+        negative_lookup_mb,
+        "MB of each of the filters of account and storage keys which answer "
+        "reads of absent keys without walking the trie; about 2 bytes per "
+        "key keeps false positives near 0.1%. 0 disables them");
+    cli.add_flag(
+        "--log_index",
+        log_index,
+        "write with each block an index of the receipts holding logs of each "
+        "address and topic, for log queries to read only matching receipts");
     cli.add_flag("--no-compaction", no_compaction, "disable compaction");
     cli.add_option(
+        "--compaction_io_budget",
+        compaction_io_budget_mb,
+        "MB per second compaction may rewrite, spreading the rest over later "
+        "blocks. 0 (the default) paces compaction by disk growth alone");
+    cli.add_option(
+        "--wr_buffer_mb",
+        wr_buffer_mb,
+        "MB per trie write buffer, and so per write i/o. A power of two of at "
+        "least 8");
+    auto *const sq_thread_cpu_option = cli.add_option(
         "--sq_thread_cpu",
         sq_thread_cpu,
         "sq_thread_cpu field in io_uring_params, to specify the cpu set "
         "kernel poll thread is bound to in SQPOLL mode");
-    cli.add_option(
+    auto *const ro_sq_thread_cpu_option = cli.add_option(
         "--ro_sq_thread_cpu",
         ro_sq_thread_cpu,
         "sq_thread_cpu for the read only db");
+    cli.add_option(
+        "--numa_node",
+        numa_node,
+        "NUMA node to run execution on: the execution threads are bound to "
+        "its cpus and allocate from its memory, and unless given explicitly "
+        "the kernel poll threads are bound to its last two cpus");
+    cli.add_option(
+           "--log_cpu",
+           log_cpu,
+           "cpu to bind the logging backend thread to, which formats and "
+           "writes the messages queued by the other threads. Defaults to the "
+           "first cpu outside of --numa_node")
+        ->check(CLI::Range(0, get_nprocs() - 1));
     cli.add_option(
         "--db",
         dbname_paths,
@@ -174,7 +307,111 @@ try {
         "--dump_snapshot",
         dump_snapshot,
         "directory to dump state to at the end of run");
-    cli.add_flag("--trace_calls", trace_calls, "enable call tracing");
+    cli.add_option(
+        "--hot_nodes",
+        hot_nodes,
+        "file recording the trie nodes held in memory at shutdown, read back "
+        "in one batch to warm the trie on the next start");
+    cli.add_option(
+        "--vm_code_cache",
+        vm_code_cache,
+        "directory persisting compiled contracts, loaded at startup so that "
+        "hot contracts run natively right after a restart");
+    cli.add_option(
+        "--vm_compile_threads",
+        vm_compile_threads,
+        "number of threads compiling contracts to native code, hottest "
+        "first");
+    cli.add_option(
+        "--vm_hotness_profile",
+        vm_hotness_profile,
+        "file recording how hot each contract is, saved at shutdown and read "
+        "back at startup to compile the hottest contracts before execution");
+    cli.add_option(
+        "--vm_precompile",
+        vm_precompile,
+        "number of the hottest contracts of --vm_hotness_profile compiled "
+        "and pinned in the code cache at startup");
+    cli.add_option(
+        "--vm_opcode_profile",
+        vm_opcode_profile,
+        "CSV file of the opcode and opcode pair counts and gas of sampled "
+        "interpreter executions per contract, rewritten every minute");
+    cli.add_option(
+        "--vm_opcode_sample_period",
+        vm_opcode_sample_period,
+        "one in how many interpreter executions --vm_opcode_profile records");
+    cli.add_option(
+        "--vm_deploy_factory_threshold",
+        vm_deploy_factory_threshold,
+        "compile the code a factory deploys right away once it has deployed "
+        "this many contracts, instead of once it is hot; 0 disables");
+    cli.add_option(
+        "--vm_execution_profile",
+        vm_execution_profile,
+        "folded stacks file of the contracts sampled executing, saved at "
+        "shutdown for flamegraph.pl or inferno; also writes the perf map of "
+        "the compiled contracts to /tmp/perf-<pid>.map");
+    cli.add_option(
+        "--vm_execution_sample_us",
+        vm_execution_sample_us,
+        "microseconds between the samples of --vm_execution_profile");
+    cli.add_option(
+        "--shared_code_store",
+        shared_code_store,
+        "file, preferably on hugetlbfs, publishing the contract code read and "
+        "committed with its jump destinations for rpc processes to map");
+    cli.add_option(
+        "--shared_code_store_mb",
+        shared_code_store_mb,
+        "capacity of --shared_code_store for contract code");
+#ifdef MONAD_COMPILER_LLVM
+    cli.add_option(
+        "--vm_optimize_gas",
+        vm_optimize_gas,
+        "gas spent running the native code of a contract after which it is "
+        "recompiled with the LLVM backend, or 0 to disable");
+#endif
+    CLI::Option const *const trace_calls_option =
+        cli.add_flag("--trace_calls", trace_calls, "enable call tracing");
+    cli.add_option(
+           "--trace_calls_file",
+           trace_calls_file,
+           "also append compactly encoded call frames to this file, which "
+           "keeps them for as many blocks as the db history")
+        ->needs(trace_calls_option);
+    cli.add_flag(
+        "--conflict_scheduler",
+        conflict_scheduler,
+        "delay transactions predicted to conflict until the transaction they "
+        "depend on has merged");
+    CLI::Option const *const prefetch_state_option = cli.add_flag(
+        "--prefetch_state",
+        prefetch_state,
+        "read the accounts and storage slots declared by each transaction "
+        "into the block state ahead of execution");
+    cli.add_flag(
+           "--predict_slots",
+           predict_slots,
+           "also prefetch the storage slots that recent calls of the same "
+           "contract function read")
+        ->needs(prefetch_state_option);
+    cli.add_flag(
+        "--multi_version_reads",
+        multi_version_reads,
+        "let each transaction read the writes of earlier transactions that "
+        "have executed but not yet merged");
+    cli.add_flag(
+        "--recover_signers_ahead",
+        recover_signers_ahead,
+        "recover the signers of the next block while the current block "
+        "commits; only signer recovery overlaps, the next block still "
+        "executes after the commit");
+    cli.add_flag(
+        "--speculate_next_block",
+        speculate_next_block,
+        "execute the queued proposal on top of the current block on idle "
+        "threads while the current block executes, to warm its reads");
     auto *const group =
         cli.add_option_group("load", "methods to initialize the db");
     group
@@ -193,6 +430,11 @@ try {
     group->add_option(
         "--statesync", statesync, "socket for statesync communication");
     group->require_option(0, 1);
+    cli.add_option(
+        "--statesync_workers",
+        statesync_workers,
+        "threads serving statesync requests for different prefixes in "
+        "parallel, or 0 to serve them on the statesync thread");
     CLI::Option const *const exec_event_ring_option =
         cli.add_option(
                "--exec-event-ring",
@@ -206,9 +448,78 @@ try {
                 }
                 return std::string{};
             });
+    cli.add_option(
+           "--exec-event-spool",
+           exec_event_spool,
+           "also write execution events to compressed segment files in this "
+           "directory, for consumers that fall behind the event ring")
+        ->needs(exec_event_ring_option);
+    cli.add_flag(
+           "--exec-event-state-diffs",
+           exec_event_state_diffs,
+           "also record the final account and storage changes of each block, "
+           "so that consumers can apply them without querying the state")
+        ->needs(exec_event_ring_option);
+    cli.add_option(
+        "--exec-event-spool-segments",
+        exec_event_spool_segments,
+        "number of newest event spool segments to keep; 0 keeps all of them");
+    cli.add_option(
+        "--latency_metrics_file",
+        latency_metrics_file,
+        "periodically write hot path latency histograms to this file in the "
+        "Prometheus text format");
+    cli.add_option(
+        "--latency_metrics_interval",
+        latency_metrics_interval,
+        "seconds between rewrites of the latency metrics file");
+    CLI::Option const *const bench_option = cli.add_option(
+        "--bench",
+        bench,
+        "replay the blocks of the ethereum chain as a benchmark and write the "
+        "execution and commit time, retries, gas per second and i/o of every "
+        "block to this json file");
+    CLI::Option const *const bench_no_commit_option =
+        cli.add_flag(
+               "--bench_no_commit",
+               bench_no_commit,
+               "drop the state changes of every block instead of committing "
+               "them; each block reads its parent state from the db history")
+            ->needs(bench_option);
+    cli.add_option(
+           "--bench_start",
+           bench_start,
+           "first block to replay, whose parent and the parents of the "
+           "following blocks must be in the db history")
+        ->needs(bench_no_commit_option);
+    cli.add_option(
+           "--bench_warmup",
+           bench_warmup,
+           "passes over the blocks before the reported ones, to warm the "
+           "caches")
+        ->needs(bench_no_commit_option);
+    cli.add_option(
+           "--bench_repeat",
+           bench_repeat,
+           "reported passes over the blocks; more than one needs "
+           "--bench_no_commit")
+        ->check(CLI::PositiveNumber)
+        ->needs(bench_option);
 #ifdef ENABLE_EVENT_TRACING
     fs::path trace_log = fs::absolute("trace");
     cli.add_option("--trace_log", trace_log, "path to output trace file");
+#else
+    fs::path trace_spans;
+    size_t trace_spans_per_thread = 1 << 16;
+    cli.add_option(
+        "--trace_spans",
+        trace_spans,
+        "record block and transaction spans, and write the latest of them "
+        "to this file in the Chrome trace format on exit");
+    cli.add_option(
+        "--trace_spans_per_thread",
+        trace_spans_per_thread,
+        "number of latest spans --trace_spans keeps per thread");
 #endif
 
     try {
@@ -229,6 +540,22 @@ try {
         quill::Timezone::GmtTime);
     quill::Config cfg;
     cfg.default_handlers.emplace_back(stdout_handler);
+    if (numa_node.has_value() && !log_cpu.has_value()) {
+        // keep formatting off the cpus that the execution threads are bound to
+        cpu_set_t node_cpus;
+        if (monad_numa_node_cpuset(*numa_node, &node_cpus)) {
+            for (unsigned cpu = 0; cpu < static_cast<unsigned>(get_nprocs());
+                 ++cpu) {
+                if (!CPU_ISSET(cpu, &node_cpus)) {
+                    log_cpu = cpu;
+                    break;
+                }
+            }
+        }
+    }
+    if (log_cpu.has_value()) {
+        cfg.backend_thread_cpu_affinity = static_cast<uint16_t>(*log_cpu);
+    }
     quill::configure(cfg);
     quill::start(true);
     quill::get_root_logger()->set_log_level(log_level);
@@ -251,14 +578,71 @@ try {
             return 1;
         }
     }
+    if (exec_event_state_diffs) {
+        enable_execution_state_diff_events();
+    }
+    std::unique_ptr<EventSpoolWriter> const event_spool =
+        exec_event_spool.empty()
+            ? nullptr
+            : start_execution_event_spool(
+                  exec_event_spool, exec_event_spool_segments);
+
+    std::jthread latency_metrics_writer;
+    if (!latency_metrics_file.empty()) {
+        latency_metrics_writer = start_latency_metrics_writer(
+            latency_metrics_file,
+            std::chrono::seconds{std::max(latency_metrics_interval, 1u)});
+    }
+
+    if (numa_node.has_value()) {
+        cpu_set_t node_cpus;
+        if (!monad_numa_node_cpuset(*numa_node, &node_cpus)) {
+            LOG_ERROR("no cpus found on NUMA node {}", *numa_node);
+            return 1;
+        }
+        // the block-scoped state is allocated by this thread, so it follows
+        // execution onto the node
+        pthread_setaffinity_np(pthread_self(), sizeof(node_cpus), &node_cpus);
+        if (!monad_numa_prefer_node(*numa_node)) {
+            LOG_WARNING("cannot prefer memory of NUMA node {}", *numa_node);
+        }
+        std::vector<unsigned> cpus;
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &node_cpus)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (sq_thread_cpu_option->count() == 0) {
+            sq_thread_cpu = cpus.back();
+        }
+        if (ro_sq_thread_cpu_option->count() == 0 && cpus.size() > 1) {
+            ro_sq_thread_cpu = cpus[cpus.size() - 2];
+        }
+        LOG_INFO(
+            "executing on NUMA node {}, sq_thread_cpu {}, ro_sq_thread_cpu {}, "
+            "log_cpu {}",
+            *numa_node,
+            sq_thread_cpu,
+            ro_sq_thread_cpu,
+            log_cpu.has_value() ? static_cast<int64_t>(*log_cpu) : -1);
+    }
 
 #ifdef ENABLE_EVENT_TRACING
     quill::FileHandlerConfig handler_cfg;
     handler_cfg.set_pattern("%(message)", "");
     event_tracer = quill::create_logger(
         "event_trace", quill::file_handler(trace_log, handler_cfg));
+#else
+    if (!trace_spans.empty()) {
+        enable_span_tracing(trace_spans_per_thread);
+    }
 #endif
 
+    if (node_slab_gb > 0 &&
+        !HugeSlabAllocator::instance().enable(node_slab_gb << 30)) {
+        LOG_WARNING("could not reserve {} GB for node slabs", node_slab_gb);
+    }
+
     MONAD_ASSERT(init_trusted_setup());
 
     auto const db_in_memory = dbname_paths.empty();
@@ -281,9 +665,11 @@ try {
                     .rewind_to_latest_finalized = true,
                     .rd_buffers = 8192,
                     .wr_buffers = 32,
+                    .wr_buffer_size = size_t(wr_buffer_mb) << 20,
                     .uring_entries = 128,
                     .sq_thread_cpu = sq_thread_cpu,
-                    .dbname_paths = dbname_paths}};
+                    .dbname_paths = dbname_paths,
+                    .compaction_io_budget = compaction_io_budget_mb << 20}};
         }
         machine = std::make_unique<InMemoryMachine>();
         return mpt::Db{*machine};
@@ -305,7 +691,24 @@ try {
         MONAD_ASSERT(false);
     }();
 
-    TrieDb triedb{db}; // init block number to latest finalized block
+    std::unique_ptr<vm::SharedCodeStore> code_store;
+    if (!shared_code_store.empty()) {
+        code_store = vm::SharedCodeStore::open_writable(
+            shared_code_store, shared_code_store_mb << 20);
+        if (code_store == nullptr) {
+            LOG_ERROR("cannot open shared code store `{}`", shared_code_store);
+            return EXIT_FAILURE;
+        }
+        LOG_INFO(
+            "shared code store {} holds {} contracts",
+            shared_code_store,
+            code_store->stats().entries);
+    }
+
+    // init block number to latest finalized block
+    TrieDb triedb{db, commit_threads};
+    triedb.set_code_store(code_store.get());
+    triedb.set_log_index(log_index);
     // Note: in memory db block number is always zero
     uint64_t const init_block_num = [&] {
         if (!snapshot.empty()) {
@@ -336,6 +739,24 @@ try {
         return triedb.get_block_number();
     }();
 
+    if (!db_in_memory && !hot_nodes.empty()) {
+        auto const nodes_loaded = db.prefetch(hot_nodes);
+        LOG_INFO("Loaded {} trie nodes into memory", nodes_loaded);
+    }
+
+    if (negative_lookup_mb > 0) {
+        if (triedb.enable_negative_lookups(
+                negative_lookup_mb << 20, negative_lookup_mb << 20)) {
+            LOG_INFO("Populated negative lookup filters");
+        }
+        else {
+            LOG_WARNING(
+                "negative lookups disabled: the db has versions newer than "
+                "block {}",
+                init_block_num);
+        }
+    }
+
     std::unique_ptr<monad_statesync_server_context> ctx;
     std::jthread sync_thread;
     monad_statesync_server *sync = nullptr;
@@ -354,9 +775,13 @@ try {
                 .dbname_paths = dbname_paths}};
             mpt::Db ro{io_ctx};
             ctx->ro = &ro;
+            ctx->ro_io = &io_ctx;
+            ctx->num_workers = statesync_workers;
             while (!token.stop_requested()) {
                 monad_statesync_server_run_once(sync);
             }
+            monad_statesync_server_stop_workers(sync);
+            ctx->ro_io = nullptr;
             ctx->ro = nullptr;
         });
     }
@@ -372,7 +797,31 @@ try {
         std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - load_start_time));
 
-    uint64_t const start_block_num = init_block_num + 1;
+    uint64_t const start_block_num = bench_start.value_or(init_block_num + 1);
+    if (!bench.empty()) {
+        if (chain_config != CHAIN_CONFIG_ETHEREUM_MAINNET) {
+            LOG_ERROR("--bench only replays the ethereum chain");
+            return 1;
+        }
+        if (!bench_no_commit && bench_repeat > 1) {
+            LOG_ERROR(
+                "committed blocks can only be replayed once; pass "
+                "--bench_no_commit to repeat them");
+            return 1;
+        }
+        if (bench_no_commit &&
+            (db_in_memory || start_block_num == 0 ||
+             start_block_num - 1 < db.get_earliest_version() ||
+             start_block_num > init_block_num + 1)) {
+            LOG_ERROR(
+                "the parent of block {} is not in the db history of blocks "
+                "{} to {}",
+                start_block_num,
+                db_in_memory ? 0 : db.get_earliest_version(),
+                init_block_num);
+            return 1;
+        }
+    }
 
     LOG_INFO(
         "Running with block_db = {}, start block number = {}, "
@@ -381,7 +830,13 @@ try {
         start_block_num,
         nblocks);
 
-    fiber::PriorityPool priority_pool{nthreads, nfibers};
+    fiber::PriorityPool priority_pool{
+        nthreads,
+        nfibers,
+        false,
+        numa_node,
+        size_t{fiber_stack_mb} << 20,
+        fiber_huge_pages};
 
     auto const start_time = std::chrono::steady_clock::now();
 
@@ -410,13 +865,98 @@ try {
     stop = 0;
 
     uint64_t block_num = start_block_num;
-    uint64_t const end_block_num =
-        (std::numeric_limits<uint64_t>::max() - block_num + 1) <= nblocks
-            ? std::numeric_limits<uint64_t>::max()
-            : block_num + nblocks - 1;
+    uint64_t const end_block_num = [&] {
+        uint64_t const end =
+            (std::numeric_limits<uint64_t>::max() - block_num + 1) <= nblocks
+                ? std::numeric_limits<uint64_t>::max()
+                : block_num + nblocks - 1;
+        // without a commit, only the blocks whose parent is in the db
+        // history can be replayed
+        return bench_no_commit ? std::min(end, init_block_num + 1) : end;
+    }();
+    std::optional<BenchReport> bench_report;
+    if (!bench.empty()) {
+        bench_report.emplace(BenchConfig{
+            .commit = !bench_no_commit,
+            .warmup = bench_warmup,
+            .repeat = bench_repeat});
+    }
+
+    std::unique_ptr<CallFrameStore> const call_frame_store =
+        trace_calls_file.empty()
+            ? nullptr
+            : std::make_unique<CallFrameStore>(
+                  trace_calls_file, false, 3, triedb.get_history_length());
 
-    vm::VM vm;
-    DbCache db_cache = ctx ? DbCache{*ctx} : DbCache{triedb};
+    vm::VM vm{
+        true,
+        vm::runtime::EvmStackAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
+        vm::runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
+        vm_compile_threads};
+    if (!vm_code_cache.empty()) {
+        vm.compiler().enable_persistent_cache(vm_code_cache);
+    }
+#ifdef MONAD_COMPILER_LLVM
+    if (vm_optimize_gas != 0) {
+        vm.enable_optimizing_tier(
+            vm::llvm::make_optimizing_tier(), vm_optimize_gas);
+    }
+#endif
+    if (!vm_hotness_profile.empty()) {
+        auto &profile = vm.enable_hotness_profile(vm_precompile);
+        if (profile.load(vm_hotness_profile)) {
+            LOG_INFO(
+                "Loaded hotness profile of {} contracts from {}",
+                profile.size(),
+                vm_hotness_profile);
+        }
+    }
+    if (!vm_opcode_profile.empty()) {
+        vm.enable_opcode_profile(vm_opcode_sample_period)
+            .save_every(vm_opcode_profile, std::chrono::minutes{1});
+    }
+    if (vm_deploy_factory_threshold != 0) {
+        vm.enable_deploy_policy(vm_deploy_factory_threshold);
+    }
+    if (!vm_execution_profile.empty()) {
+        vm.compiler().enable_perf_map();
+        vm.enable_execution_sampler(
+            std::chrono::microseconds{vm_execution_sample_us});
+    }
+    DbCache db_cache{
+        ctx ? static_cast<Db &>(*ctx) : static_cast<Db &>(triedb),
+        db_cache_mb << 20};
+    std::optional<MemoryGovernor> memory_governor;
+    std::jthread memory_governor_thread;
+    if (memory_cap_gb > 0) {
+        memory_governor.emplace(memory_cap_gb << 30);
+        memory_governor->add(
+            {.name = "db_cache",
+             .priority = 2,
+             .min_bytes = (db_cache_mb << 20) / 8,
+             .max_bytes = db_cache_mb << 20,
+             .misses = [&db_cache] { return db_cache.misses(); },
+             .set_budget =
+                 [&db_cache](size_t const bytes) {
+                     db_cache.set_budget_bytes(bytes);
+                 }});
+        auto &varcode_cache = vm.compiler().varcode_cache();
+        size_t const varcode_bytes = size_t{varcode_cache.max_cache_kb()}
+                                     << 10;
+        memory_governor->add(
+            {.name = "varcode_cache",
+             .priority = 1,
+             .min_bytes = varcode_bytes / 8,
+             .max_bytes = varcode_bytes,
+             .misses = [&varcode_cache] { return varcode_cache.misses(); },
+             .set_budget =
+                 [&varcode_cache](size_t const bytes) {
+                     varcode_cache.set_max_cache_kb(
+                         static_cast<uint32_t>(bytes >> 10));
+                 }});
+        memory_governor_thread =
+            memory_governor->start(std::chrono::seconds{10});
+    }
     auto const result = [&] {
         switch (chain_config) {
         case CHAIN_CONFIG_ETHEREUM_MAINNET:
@@ -430,7 +970,14 @@ try {
                 block_num,
                 end_block_num,
                 stop,
-                trace_calls);
+                trace_calls,
+                call_frame_store.get(),
+                conflict_scheduler,
+                prefetch_state,
+                predict_slots,
+                multi_version_reads,
+                recover_signers_ahead,
+                bench_report ? &bench_report.value() : nullptr);
         case CHAIN_CONFIG_MONAD_DEVNET:
         case CHAIN_CONFIG_MONAD_TESTNET:
         case CHAIN_CONFIG_MONAD_MAINNET:
@@ -446,7 +993,14 @@ try {
                 block_num,
                 end_block_num,
                 stop,
-                trace_calls);
+                trace_calls,
+                call_frame_store.get(),
+                conflict_scheduler,
+                prefetch_state,
+                predict_slots,
+                multi_version_reads,
+                recover_signers_ahead,
+                speculate_next_block);
         }
         MONAD_ABORT_PRINTF("Unsupported chain");
     }();
@@ -480,12 +1034,62 @@ try {
             vm.print_total_counts());
     }
 
+    if (bench_report) {
+        bench_report->write(bench);
+    }
+
+    if (memory_governor) {
+        memory_governor_thread = {};
+        LOG_INFO("memory governor{}", memory_governor->print_stats());
+    }
+
+#ifndef ENABLE_EVENT_TRACING
+    if (!trace_spans.empty()) {
+        auto const spans = collect_spans();
+        std::ofstream os{trace_spans};
+        write_chrome_trace(os, spans);
+        LOG_INFO("Wrote {} spans to {}", spans.size(), trace_spans);
+    }
+#endif
+
+    {
+        auto const stacks = priority_pool.stack_stats();
+        LOG_INFO(
+            "fiber stacks: {} of {} in use, {} MB committed, deepest stack "
+            "committed {} KB of {} KB",
+            stacks.in_use,
+            stacks.n_stacks,
+            stacks.resident_bytes >> 20,
+            stacks.max_stack_resident_bytes >> 10,
+            stacks.stack_size >> 10);
+    }
+
     if (sync != nullptr) {
         sync_thread.request_stop();
         sync_thread.join();
         monad_statesync_server_destroy(sync);
     }
 
+    if (!db_in_memory && !hot_nodes.empty()) {
+        auto const nodes_saved = db.save_loaded_nodes(hot_nodes);
+        LOG_INFO("Saved {} in memory trie nodes to {}", nodes_saved, hot_nodes);
+    }
+
+    if (!vm_execution_profile.empty() &&
+        !vm.execution_sampler()->write_folded(vm_execution_profile)) {
+        LOG_WARNING(
+            "Could not save execution profile to {}", vm_execution_profile);
+    }
+
+    if (!vm_hotness_profile.empty()) {
+        auto &profile = *vm.hotness_profile();
+        profile.prune();
+        if (!profile.save(vm_hotness_profile)) {
+            LOG_WARNING(
+                "Could not save hotness profile to {}", vm_hotness_profile);
+        }
+    }
+
     if (!dump_snapshot.empty()) {
         LOG_INFO("Dump db of block: {}", block_num);
         mpt::AsyncIOContext io_ctx(mpt::ReadOnlyOnDiskDbConfig{
@@ -494,7 +1098,10 @@ try {
             .concurrent_read_io_limit = 128});
         mpt::Db db{io_ctx};
         TrieDb ro_db{db};
-        write_to_file(ro_db.to_json(), dump_snapshot, block_num);
+        write_to_file(
+            [&](std::ostream &out) { ro_db.to_json(out); },
+            dump_snapshot,
+            block_num);
     }
     return result.has_error() ? EXIT_FAILURE : EXIT_SUCCESS;
 }
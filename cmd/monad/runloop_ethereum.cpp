@@ -14,6 +14,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "runloop_ethereum.hpp"
+#include "bench.hpp"
 
 #include <category/core/assert.h>
 #include <category/core/bytes.hpp>
@@ -21,28 +22,40 @@
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/keccak.hpp>
 #include <category/core/procfs/statm.h>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/block_hash_history.hpp>
 #include <category/execution/ethereum/chain/chain.hpp>
+#include <category/execution/ethereum/conflict_scheduler.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
 #include <category/execution/ethereum/db/block_db.hpp>
+#include <category/execution/ethereum/db/block_readahead.hpp>
 #include <category/execution/ethereum/db/db.hpp>
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/slot_predictor.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state_prefetcher.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
 #include <category/execution/ethereum/validate_transaction.hpp>
 #include <category/vm/evm/switch_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/runtime/allocator.hpp>
 
 #include <boost/outcome/try.hpp>
 #include <quill/Quill.h>
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
@@ -83,24 +96,37 @@ Result<void> process_ethereum_block(
     Chain const &chain, Db &db, vm::VM &vm,
     BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, Block &block, bytes32_t const &block_id,
-    bytes32_t const &parent_block_id, bool const enable_tracing)
+    bytes32_t const &parent_block_id, bool const enable_tracing,
+    CallFrameStore *const call_frame_store,
+    ConflictScheduler *const conflict_scheduler, bool const enable_prefetch,
+    SlotPredictor *const slot_predictor, bool const enable_multi_version_reads,
+    std::optional<RecoveredSigners> signers,
+    std::function<void()> const &before_commit, bool const commit,
+    BlockSample *const sample)
 {
     [[maybe_unused]] auto const block_start = std::chrono::system_clock::now();
     auto const block_begin = std::chrono::steady_clock::now();
+    auto const io_begin = sample ? IoCounters::now() : IoCounters{};
 
-    // Block input validation
-    BOOST_OUTCOME_TRY(chain.static_validate_header(block.header));
-    BOOST_OUTCOME_TRY(static_validate_block<traits>(block));
+    // Block input validation. The checks which do not read state run on the
+    // priority pool while the VM warms up and the senders are recovered.
+    StatelessValidation<traits> stateless_validation{
+        chain, block, priority_pool};
+
+    vm.precompile_hottest<traits>(
+        [&db](bytes32_t const &code_hash) { return db.read_code(code_hash); });
+    precompile_block_hash_history_contract<traits>(vm);
 
     // Sender and authority recovery
     auto const sender_recovery_begin = std::chrono::steady_clock::now();
-    auto const recovered_senders =
-        recover_senders(block.transactions, priority_pool);
-    auto const recovered_authorities =
-        recover_authorities(block.transactions, priority_pool);
+    auto const [recovered_senders, recovered_authorities, tx_hashes] =
+        signers.has_value()
+            ? std::move(signers).value()
+            : SignerRecovery{block.transactions, priority_pool}.get();
     [[maybe_unused]] auto const sender_recovery_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - sender_recovery_begin);
+    BOOST_OUTCOME_TRY(auto static_validation, stateless_validation.get());
     std::vector<Address> senders(block.transactions.size());
     for (unsigned i = 0; i < recovered_senders.size(); ++i) {
         if (recovered_senders[i].has_value()) {
@@ -129,6 +155,22 @@ Result<void> process_ethereum_block(
     db.set_block_and_prefix(block.header.number - 1, parent_block_id);
     BlockMetrics block_metrics;
     BlockState block_state(db, vm);
+    if (enable_multi_version_reads) {
+        block_state.enable_multi_version_reads();
+    }
+    std::optional<StatePrefetcher> prefetcher;
+    if (enable_prefetch) {
+        prefetcher.emplace(
+            block.transactions,
+            senders,
+            recovered_authorities,
+            block_state,
+            priority_pool,
+            slot_predictor);
+    }
+    if (slot_predictor) {
+        block_metrics.init_txn_slot_reads(block.transactions.size());
+    }
     BOOST_OUTCOME_TRY(
         auto const receipts,
         execute_block<traits>(
@@ -140,33 +182,59 @@ Result<void> process_ethereum_block(
             block_hash_buffer,
             priority_pool,
             block_metrics,
-            call_tracers));
+            call_tracers,
+            [](Address const &, Transaction const &, uint64_t, State &) {
+                return false;
+            },
+            conflict_scheduler,
+            &static_validation,
+            &tx_hashes));
+    prefetcher.reset();
+    if (slot_predictor) {
+        slot_predictor->update(block.transactions, senders, block_metrics);
+    }
+
+    // With a call frame store, the call frames are also kept there, in
+    // compact form, for the readers of the store
+    if (call_frame_store) {
+        call_frame_store->append(block.header.number, block_id, call_frames);
+    }
 
     // Database commit of state changes (incl. Merkle root calculations)
     block_state.log_debug();
+    before_commit();
     auto const commit_begin = std::chrono::steady_clock::now();
-    block_state.commit(
-        bytes32_t{block.header.number},
-        block.header,
-        receipts,
-        call_frames,
-        senders,
-        block.transactions,
-        block.ommers,
-        block.withdrawals);
+    if (commit) {
+        block_state.commit(
+            bytes32_t{block.header.number},
+            block.header,
+            receipts,
+            call_frames,
+            senders,
+            block.transactions,
+            block.ommers,
+            block.withdrawals,
+            tx_hashes);
+    }
     [[maybe_unused]] auto const commit_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - commit_begin);
 
-    // Post-commit validation of header, with Merkle root fields filled in
-    auto const output_header = db.read_eth_header();
-    BOOST_OUTCOME_TRY(
-        chain.validate_output_header(block.header, output_header));
+    // Post-commit validation of header, with Merkle root fields filled in.
+    // Without a commit there are no roots to check, and the input header
+    // stands in for the output.
+    auto const output_header = commit ? db.read_eth_header() : block.header;
+    if (commit) {
+        BOOST_OUTCOME_TRY(
+            chain.validate_output_header(block.header, output_header));
+    }
 
     // Commit prologue: database finalization, computation of the Ethereum
     // block hash to append to the circular hash buffer
-    db.finalize(block.header.number, block_id);
-    db.update_verified_block(block.header.number);
+    if (commit) {
+        db.finalize(block.header.number, block_id);
+        db.update_verified_block(block.header.number);
+    }
     auto const eth_block_hash =
         to_bytes(keccak256(rlp::encode_block_header(output_header)));
     block_hash_buffer.set(block.header.number, eth_block_hash);
@@ -177,7 +245,7 @@ Result<void> process_ethereum_block(
             std::chrono::steady_clock::now() - block_begin);
     LOG_INFO(
         "__exec_block,bl={:8},ts={}"
-        ",tx={:5},rt={:4},rtp={:5.2f}%"
+        ",tx={:5},rt={:4},rtp={:5.2f}%,mvr={:5}"
         ",sr={:>7},txe={:>8},cmt={:>8},tot={:>8},tpse={:5},tps={:5}"
         ",gas={:9},gpse={:4},gps={:3}{}{}{}",
         block.header.number,
@@ -188,6 +256,7 @@ Result<void> process_ethereum_block(
         block_metrics.num_retries(),
         100.0 * (double)block_metrics.num_retries() /
             std::max(1.0, (double)block.transactions.size()),
+        block_metrics.num_versioned_reads(),
         sender_recovery_time,
         block_metrics.tx_exec_time(),
         commit_time,
@@ -204,9 +273,25 @@ Result<void> process_ethereum_block(
         vm.print_and_reset_block_counts(),
         vm.print_compiler_stats());
 
+    if (sample) {
+        sample->block_number = block.header.number;
+        sample->transactions = block.transactions.size();
+        sample->gas_used = receipts.empty() ? 0 : receipts.back().gas_used;
+        sample->retries = block_metrics.num_retries();
+        sample->sender_recovery = sender_recovery_time;
+        sample->execution = block_metrics.tx_exec_time();
+        sample->commit = commit_time;
+        sample->total = block_time;
+        sample->io = IoCounters::now() - io_begin;
+    }
+
     return outcome_e::success();
 }
 
+// Decoded blocks kept ahead of execution; enough to cover a few slow reads
+// in a row without holding much memory
+constexpr size_t BLOCK_READAHEAD_DEPTH = 8;
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
@@ -216,7 +301,10 @@ Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
     vm::VM &vm, BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, uint64_t &block_num,
     uint64_t const end_block_num, sig_atomic_t const volatile &stop,
-    bool const enable_tracing)
+    bool const enable_tracing, CallFrameStore *const call_frame_store,
+    bool const enable_conflict_scheduler, bool const enable_prefetch,
+    bool const enable_slot_prediction, bool const enable_multi_version_reads,
+    bool const enable_early_signer_recovery, BenchReport *const bench)
 {
     uint64_t const batch_size =
         end_block_num == std::numeric_limits<uint64_t>::max() ? 1 : 1000;
@@ -227,54 +315,135 @@ Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
     auto batch_begin = std::chrono::steady_clock::now();
     uint64_t ntxs = 0;
 
+    std::optional<ConflictScheduler> conflict_scheduler;
+    if (enable_conflict_scheduler) {
+        conflict_scheduler.emplace();
+    }
+    std::optional<SlotPredictor> slot_predictor;
+    if (enable_prefetch && enable_slot_prediction) {
+        slot_predictor.emplace();
+    }
+
+    static LatencyMetric &read_wait = latency_metric(
+        "monad_block_read_wait_seconds",
+        "time execution waited for the next block to be read and decoded");
+
+    // A benchmark replays the range once per pass, each pass from the same
+    // block hashes
+    bool const commit = bench == nullptr || bench->config().commit;
+    unsigned const passes = bench ? bench->config().passes() : 1;
+    uint64_t const start_block_num = block_num;
+    BlockHashBufferFinalized const start_block_hash_buffer = block_hash_buffer;
+
     BlockDb block_db(ledger_dir);
-    bytes32_t parent_block_id{};
-    while (block_num <= end_block_num && stop == 0) {
-        Block block;
-        MONAD_ASSERT_PRINTF(
-            block_db.get(block_num, block),
-            "Could not query %lu from blockdb",
-            block_num);
-
-        bytes32_t const block_id = bytes32_t{block.header.number};
-        evmc_revision const rev =
-            chain.get_revision(block.header.number, block.header.timestamp);
-
-        BOOST_OUTCOME_TRY([&] {
-            SWITCH_EVM_TRAITS(
-                process_ethereum_block,
-                chain,
-                db,
-                vm,
-                block_hash_buffer,
-                priority_pool,
-                block,
-                block_id,
-                parent_block_id,
-                enable_tracing);
-            MONAD_ABORT_PRINTF("unhandled rev switch case: %d", rev);
-        }());
-
-        ntxs += block.transactions.size();
-        batch_num_txs += block.transactions.size();
-        total_gas += block.header.gas_used;
-        batch_gas += block.header.gas_used;
-        ++batch_num_blocks;
-
-        if (block_num % batch_size == 0) {
-            log_tps(
-                block_num,
-                batch_num_blocks,
-                batch_num_txs,
-                batch_gas,
-                batch_begin);
-            batch_num_blocks = 0;
-            batch_num_txs = 0;
-            batch_gas = 0;
-            batch_begin = std::chrono::steady_clock::now();
+    for (unsigned pass = 0; pass < passes && stop == 0; ++pass) {
+        block_num = start_block_num;
+        block_hash_buffer = start_block_hash_buffer;
+
+        // Stages of the loop: the readahead thread reads and decodes the next
+        // blocks, the signers of block N + 1 are recovered on the priority
+        // pool while block N commits, and block N executes and commits here
+        BlockReadahead readahead{
+            block_db, block_num, end_block_num, BLOCK_READAHEAD_DEPTH};
+        struct Lookahead
+        {
+            Block block;
+            std::optional<SignerRecovery> recovery{};
+        };
+        std::optional<Lookahead> lookahead;
+        bytes32_t parent_block_id{};
+        while (block_num <= end_block_num && stop == 0) {
+            Block block;
+            std::optional<RecoveredSigners> signers;
+            if (lookahead.has_value()) {
+                signers = lookahead->recovery->get();
+                block = std::move(lookahead->block);
+                lookahead.reset();
+            }
+            else {
+                auto const read_begin = std::chrono::steady_clock::now();
+                MONAD_ASSERT_PRINTF(
+                    readahead.next(block),
+                    "Could not query %lu from blockdb",
+                    block_num);
+                read_wait.record(std::chrono::steady_clock::now() - read_begin);
+            }
+            auto const before_commit = [&] {
+                if (!enable_early_signer_recovery ||
+                    block_num == end_block_num || stop != 0) {
+                    return;
+                }
+                auto const read_begin = std::chrono::steady_clock::now();
+                Block next;
+                bool const found = readahead.next(next);
+                read_wait.record(std::chrono::steady_clock::now() - read_begin);
+                if (!found) {
+                    // reported when the loop asks for it again
+                    return;
+                }
+                lookahead.emplace(Lookahead{.block = std::move(next)});
+                lookahead->recovery.emplace(
+                    lookahead->block.transactions, priority_pool);
+            };
+
+            bytes32_t const block_id = bytes32_t{block.header.number};
+            evmc_revision const rev =
+                chain.get_revision(block.header.number, block.header.timestamp);
+            BlockSample sample{.pass = pass};
+
+            BOOST_OUTCOME_TRY([&] {
+                SWITCH_EVM_TRAITS(
+                    process_ethereum_block,
+                    chain,
+                    db,
+                    vm,
+                    block_hash_buffer,
+                    priority_pool,
+                    block,
+                    block_id,
+                    parent_block_id,
+                    enable_tracing,
+                    call_frame_store,
+                    conflict_scheduler ? &conflict_scheduler.value() : nullptr,
+                    enable_prefetch,
+                    slot_predictor ? &slot_predictor.value() : nullptr,
+                    enable_multi_version_reads,
+                    std::move(signers),
+                    before_commit,
+                    commit,
+                    bench ? &sample : nullptr);
+                MONAD_ABORT_PRINTF("unhandled rev switch case: %d", rev);
+            }());
+            if (bench) {
+                bench->add(sample);
+            }
+
+            ntxs += block.transactions.size();
+            batch_num_txs += block.transactions.size();
+            total_gas += block.header.gas_used;
+            batch_gas += block.header.gas_used;
+            ++batch_num_blocks;
+
+            if (block_num % batch_size == 0) {
+                log_tps(
+                    block_num,
+                    batch_num_blocks,
+                    batch_num_txs,
+                    batch_gas,
+                    batch_begin);
+                batch_num_blocks = 0;
+                batch_num_txs = 0;
+                batch_gas = 0;
+                batch_begin = std::chrono::steady_clock::now();
+                vm::runtime::trim_idle_allocator_pools();
+            }
+            // Without a commit, the next block reads the finalized state of
+            // its parent from the db history
+            if (commit) {
+                parent_block_id = block_id;
+            }
+            ++block_num;
         }
-        parent_block_id = block_id;
-        ++block_num;
     }
     if (batch_num_blocks > 0) {
         log_tps(
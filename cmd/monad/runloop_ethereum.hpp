@@ -29,7 +29,9 @@ MONAD_NAMESPACE_BEGIN
 
 struct Chain;
 struct Db;
+class BenchReport;
 class BlockHashBufferFinalized;
+class CallFrameStore;
 
 namespace fiber
 {
@@ -39,6 +41,9 @@ namespace fiber
 Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
     Chain const &, std::filesystem::path const &, Db &, vm::VM &,
     BlockHashBufferFinalized &, fiber::PriorityPool &, uint64_t &, uint64_t,
-    sig_atomic_t const volatile &, bool enable_tracing);
+    sig_atomic_t const volatile &, bool enable_tracing, CallFrameStore *,
+    bool enable_conflict_scheduler, bool enable_prefetch,
+    bool enable_slot_prediction, bool enable_multi_version_reads,
+    bool enable_early_signer_recovery, BenchReport *);
 
 MONAD_NAMESPACE_END
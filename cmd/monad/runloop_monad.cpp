@@ -14,7 +14,9 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "runloop_monad.hpp"
+#include "body_reader.hpp"
 #include "file_io.hpp"
+#include "io_counters.hpp"
 
 #include <category/core/assert.h>
 #include <category/core/blake3.hpp>
@@ -23,7 +25,10 @@
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/keccak.hpp>
 #include <category/core/procfs/statm.h>
+#include <category/core/util/latency_histogram.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/block_hash_history.hpp>
+#include <category/execution/ethereum/conflict_scheduler.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/fmt/bytes_fmt.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
@@ -35,7 +40,12 @@
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/signer_cache.hpp>
+#include <category/execution/ethereum/slot_predictor.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/state_prefetcher.hpp>
+#include <category/execution/ethereum/trace/call_frame_store.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/transaction_gas.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
@@ -44,19 +54,27 @@
 #include <category/execution/monad/core/monad_block.hpp>
 #include <category/execution/monad/core/rlp/monad_block_rlp.hpp>
 #include <category/execution/monad/event/record_consensus_events.hpp>
+#include <category/execution/monad/reserve_balance.hpp>
+#include <category/execution/monad/speculative_execution.hpp>
+#include <category/execution/monad/staking/staking_contract.hpp>
 #include <category/execution/monad/validate_monad_block.hpp>
 #include <category/mpt/db.hpp>
 #include <category/vm/evm/switch_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/runtime/allocator.hpp>
 
 #include <ankerl/unordered_dense.h>
 #include <boost/outcome/try.hpp>
 #include <quill/Quill.h>
 #include <quill/detail/LogMacros.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <deque>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <variant>
@@ -69,11 +87,29 @@ struct BlockCacheEntry
     uint64_t block_number;
     bytes32_t parent_id;
     ankerl::unordered_dense::segmented_set<Address> senders_and_authorities;
+    // database reads of the last block executed or speculated on top of
+    // this one; a re-proposal on the same parent reads mostly the same state
+    std::unique_ptr<StateDeltas const> child_reads{};
 };
 
 using BlockCache =
     ankerl::unordered_dense::segmented_map<bytes32_t, BlockCacheEntry>;
 
+// The proposal queued on top of the block being proposed, which runs
+// speculatively while the block executes
+struct NextProposal
+{
+    BlockHeader const &header;
+    std::vector<Transaction> const &transactions;
+};
+
+// Enough recovered signers to span the proposals of several full blocks
+constexpr size_t SIGNER_CACHE_SIZE = 100'000;
+
+// Finalized blocks between frees of the EVM stack and memory blocks that sat
+// unused in the shared allocator pools
+constexpr uint64_t ALLOCATOR_TRIM_INTERVAL = 1'000;
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -105,6 +141,57 @@ void log_tps(
 
 #pragma GCC diagnostic pop
 
+// Running totals, of which a block's share is the difference over the block
+struct PerfCounters
+{
+    DbStats db;
+    vm::VmCallCounts vm;
+    IoCounters io;
+
+    static PerfCounters now(Db &db, vm::VM const &vm)
+    {
+        return {
+            .db = db.stats(), .vm = vm.total_counts(), .io = IoCounters::now()};
+    }
+};
+
+// Publishes the performance record of a block as a BLOCK_PERF_STATS exec
+// event, and its times in the latency metrics
+void publish_block_perf(BlockPerf const &perf)
+{
+    static LatencyMetric &sender_recovery = latency_metric(
+        "monad_block_sender_recovery_seconds",
+        "time to recover the senders and authorities of a block");
+    static LatencyMetric &exec = latency_metric(
+        "monad_block_exec_seconds",
+        "time to execute the transactions of a block");
+    static LatencyMetric &stall = latency_metric(
+        "monad_block_stall_seconds",
+        "time the transactions of a block waited on earlier ones to merge");
+    static LatencyMetric &retry = latency_metric(
+        "monad_block_retry_seconds",
+        "time re-executing the conflicting transactions of a block");
+    static LatencyMetric &commit_state = latency_metric(
+        "monad_block_commit_state_seconds",
+        "commit time hashing and encoding the state deltas of a block");
+    static LatencyMetric &commit_block_data = latency_metric(
+        "monad_block_commit_block_data_seconds",
+        "commit time encoding the receipts, transactions and call frames of "
+        "a block");
+    static LatencyMetric &commit_upsert = latency_metric(
+        "monad_block_commit_upsert_seconds",
+        "commit time updating the tries and writing the nodes of a block");
+
+    sender_recovery.record(perf.sender_recovery_time);
+    exec.record(perf.exec_time);
+    stall.record(perf.stall_time);
+    retry.record(perf.retry_time);
+    commit_state.record(perf.commit_state_time);
+    commit_block_data.record(perf.commit_block_data_time);
+    commit_upsert.record(perf.commit_upsert_time);
+    record_block_perf(perf);
+}
+
 template <class MonadConsensusBlockHeader>
 bool has_executed(
     mpt::Db const &db, MonadConsensusBlockHeader const &header,
@@ -153,27 +240,42 @@ Result<BlockExecOutput> propose_block(
     MonadConsensusBlockHeader const &consensus_header, Block block,
     BlockHashChain &block_hash_chain, MonadChain const &chain, Db &db,
     vm::VM &vm, fiber::PriorityPool &priority_pool, bool const is_first_block,
-    bool const enable_tracing, BlockCache &block_cache)
+    bool const enable_tracing, CallFrameStore *const call_frame_store,
+    BlockCache &block_cache,
+    SignerCache &signer_cache, ConflictScheduler *const conflict_scheduler,
+    bool const enable_prefetch, SlotPredictor *const slot_predictor,
+    bool const enable_multi_version_reads,
+    std::optional<RecoveredSigners> signers,
+    NextProposal const *const next_proposal,
+    std::function<void()> const &before_commit)
 {
     [[maybe_unused]] auto const block_start = std::chrono::system_clock::now();
     auto const block_begin = std::chrono::steady_clock::now();
+    auto const counters_begin = PerfCounters::now(db, vm);
     auto const &block_hash_buffer =
         block_hash_chain.find_chain(consensus_header.parent_id());
 
-    // Block input validation
+    // Block input validation. The checks which do not read state run on the
+    // priority pool while the VM warms up and the senders are recovered.
     BOOST_OUTCOME_TRY(static_validate_consensus_header(consensus_header));
-    BOOST_OUTCOME_TRY(chain.static_validate_header(block.header));
-    BOOST_OUTCOME_TRY(static_validate_block<traits>(block));
+    StatelessValidation<traits> stateless_validation{
+        chain, block, priority_pool};
+
+    vm.precompile_hottest<traits>(
+        [&db](bytes32_t const &code_hash) { return db.read_code(code_hash); });
+    precompile_block_hash_history_contract<traits>(vm);
 
     // Sender and EIP-7702 authorities recovery
     auto const sender_recovery_begin = std::chrono::steady_clock::now();
-    auto const recovered_senders =
-        recover_senders(block.transactions, priority_pool);
-    auto const recovered_authorities =
-        recover_authorities(block.transactions, priority_pool);
+    auto const [recovered_senders, recovered_authorities, tx_hashes] =
+        signers.has_value()
+            ? std::move(signers).value()
+            : SignerRecovery{block.transactions, priority_pool, &signer_cache}
+                  .get();
     [[maybe_unused]] auto const sender_recovery_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - sender_recovery_begin);
+    BOOST_OUTCOME_TRY(auto static_validation, stateless_validation.get());
     std::vector<Address> senders(block.transactions.size());
     for (unsigned i = 0; i < recovered_senders.size(); ++i) {
         if (recovered_senders[i].has_value()) {
@@ -206,6 +308,10 @@ Result<BlockExecOutput> propose_block(
                      .second);
     BOOST_OUTCOME_TRY(static_validate_monad_senders<traits>(senders));
 
+    // validator registrations verify their BLS signatures in one batch here
+    // instead of one by one in the staking precompile
+    staking::StakingContract::prevalidate_bls_signatures(block.transactions);
+
     // Create call frames vectors for tracers
     std::vector<std::vector<CallFrame>> call_frames{block.transactions.size()};
     std::vector<std::unique_ptr<CallTracerBase>> call_tracers{
@@ -243,6 +349,10 @@ Result<BlockExecOutput> propose_block(
         }
     }
 
+    auto const reserve_balance_classes =
+        classify_reserve_balance(block.transactions, chain_context);
+    chain_context.reserve_balance_classes = &reserve_balance_classes;
+
     // Core execution: transaction-level EVM execution that tracks state
     // changes but does not commit them
     db.set_block_and_prefix(
@@ -251,7 +361,47 @@ Result<BlockExecOutput> propose_block(
 
     BlockExecOutput exec_output;
     BlockMetrics block_metrics;
-    BlockState block_state(db, vm);
+    auto const parent_it = is_first_block
+                               ? block_cache.end()
+                               : block_cache.find(consensus_header.parent_id());
+    StateDeltas const *const replay =
+        parent_it != block_cache.end() ? parent_it->second.child_reads.get()
+                                       : nullptr;
+    BlockState block_state =
+        replay ? BlockState{db, vm, *replay} : BlockState{db, vm};
+    if (enable_multi_version_reads) {
+        block_state.enable_multi_version_reads();
+    }
+    // The next proposal reads the parent state of this block, until this
+    // block is done with it; another revision would run other code
+    std::optional<SpeculativeExecution<traits>> speculation;
+    if (next_proposal != nullptr &&
+        next_proposal->header.number == block.header.number + 1 &&
+        chain.get_monad_revision(next_proposal->header.timestamp) ==
+            traits::monad_rev()) {
+        speculation.emplace(
+            chain,
+            next_proposal->header,
+            next_proposal->transactions,
+            block_hash_buffer,
+            db,
+            vm,
+            priority_pool,
+            &signer_cache);
+    }
+    std::optional<StatePrefetcher> prefetcher;
+    if (enable_prefetch) {
+        prefetcher.emplace(
+            block.transactions,
+            senders,
+            recovered_authorities,
+            block_state,
+            priority_pool,
+            slot_predictor);
+    }
+    if (slot_predictor) {
+        block_metrics.init_txn_slot_reads(block.transactions.size());
+    }
     record_block_marker_event(MONAD_EXEC_BLOCK_PERF_EVM_ENTER);
     BOOST_OUTCOME_TRY(
         auto const results,
@@ -265,23 +415,48 @@ Result<BlockExecOutput> propose_block(
             priority_pool,
             block_metrics,
             call_tracers,
-            [&chain, &block, &chain_context](
+            // bound to the revision of the block, so that no transaction
+            // looks up its revision again
+            [&block, &chain_context](
                 Address const &sender,
                 Transaction const &tx,
                 uint64_t const i,
                 State &state) {
-                return chain.revert_transaction(
-                    block.header.number,
-                    block.header.timestamp,
+                return revert_monad_transaction<traits>(
                     sender,
                     tx,
                     block.header.base_fee_per_gas.value_or(0),
                     i,
                     state,
                     chain_context);
-                return false;
-            }));
+            },
+            conflict_scheduler,
+            &static_validation,
+            &tx_hashes));
     record_block_marker_event(MONAD_EXEC_BLOCK_PERF_EVM_EXIT);
+    prefetcher.reset();
+    if (slot_predictor) {
+        slot_predictor->update(block.transactions, senders, block_metrics);
+    }
+
+    // commit consumes the block state, so the reads are kept before it
+    if (parent_it != block_cache.end()) {
+        parent_it->second.child_reads = block_state.read_set();
+    }
+    // the next block starts from the speculated reads, brought forward past
+    // the changes of this block
+    if (speculation.has_value()) {
+        block_cache.at(block_id).child_reads =
+            speculation->reads_after(block_state.state_deltas());
+        speculation.reset();
+    }
+
+    // With a call frame store, the call frames are also kept there, in
+    // compact form, for the readers of the store
+    if (call_frame_store) {
+        call_frame_store->append(block.header.number, block_id, call_frames);
+    }
+    before_commit();
 
     // Database commit of state changes (incl. Merkle root calculations)
     block_state.log_debug();
@@ -294,7 +469,8 @@ Result<BlockExecOutput> propose_block(
         senders,
         block.transactions,
         block.ommers,
-        block.withdrawals);
+        block.withdrawals,
+        tx_hashes);
     [[maybe_unused]] auto const commit_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - commit_begin);
@@ -320,7 +496,7 @@ Result<BlockExecOutput> propose_block(
             std::chrono::steady_clock::now() - block_begin);
     LOG_INFO(
         "__exec_block,bl={:8},id={},ts={}"
-        ",tx={:5},rt={:4},rtp={:5.2f}%"
+        ",tx={:5},rt={:4},rtp={:5.2f}%,mvr={:5}"
         ",sr={:>7},txe={:>8},cmt={:>8},tot={:>8},tpse={:5},tps={:5}"
         ",gas={:9},gpse={:4},gps={:3}{}{}{}",
         block.header.number,
@@ -332,6 +508,7 @@ Result<BlockExecOutput> propose_block(
         block_metrics.num_retries(),
         100.0 * (double)block_metrics.num_retries() /
             std::max(1.0, (double)block.transactions.size()),
+        block_metrics.num_versioned_reads(),
         sender_recovery_time,
         block_metrics.tx_exec_time(),
         commit_time,
@@ -349,6 +526,33 @@ Result<BlockExecOutput> propose_block(
         vm.print_and_reset_block_counts(),
         vm.print_compiler_stats());
 
+    auto const counters_end = PerfCounters::now(db, vm);
+    DbStats const db_stats = counters_end.db - counters_begin.db;
+    vm::VmCallCounts const vm_counts = counters_end.vm - counters_begin.vm;
+    IoCounters const io = counters_end.io - counters_begin.io;
+    BlockPerf perf{
+        .sender_recovery_time = sender_recovery_time,
+        .exec_time = block_metrics.tx_exec_time(),
+        .retries = block_metrics.num_retries(),
+        .commit_time = commit_time,
+        .commit_state_time = db_stats.commit_state_time,
+        .commit_block_data_time = db_stats.commit_block_data_time,
+        .commit_upsert_time = db_stats.commit_upsert_time,
+        .account_reads = db_stats.account_reads,
+        .storage_reads = db_stats.storage_reads,
+        .read_bytes = io.read_bytes,
+        .write_bytes = io.write_bytes,
+        .cache_hits = db_stats.cache_hits,
+        .cache_misses = db_stats.cache_misses,
+        .native_calls = vm_counts.native,
+        .interpreted_calls = vm_counts.intercode + vm_counts.raw,
+        .gas_used = exec_output.eth_header.gas_used};
+    for (TxnPerf const &txn : block_metrics.txn_perf()) {
+        perf.stall_time += txn.stall_time;
+        perf.retry_time += txn.retry_time;
+    }
+    publish_block_perf(perf);
+
     return exec_output;
 }
 
@@ -437,9 +641,14 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
     BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, uint64_t &finalized_block_num,
     uint64_t const end_block_num, sig_atomic_t const volatile &stop,
-    bool const enable_tracing)
+    bool const enable_tracing, CallFrameStore *const call_frame_store,
+    bool const enable_conflict_scheduler, bool const enable_prefetch,
+    bool const enable_slot_prediction, bool const enable_multi_version_reads,
+    bool const enable_early_signer_recovery, bool const enable_speculation)
 {
     constexpr auto SLEEP_TIME = std::chrono::microseconds(100);
+    // Bodies read in the background ahead of the block being executed
+    constexpr size_t BODY_PREFETCH_DEPTH = 4;
     uint64_t const start_block_num = finalized_block_num;
     uint256_t const chain_id = chain.get_chain_id();
     BlockHashChain block_hash_chain(block_hash_buffer);
@@ -448,12 +657,25 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
     auto const header_dir = ledger_dir / "headers";
     auto const proposed_head = header_dir / "proposed_head";
     auto const finalized_head = header_dir / "finalized_head";
+    BodyReader body_reader{body_dir};
 
     uint64_t last_finalized_block_number =
         raw_db.get_latest_finalized_version();
 
     MONAD_ASSERT(last_finalized_block_number != mpt::INVALID_BLOCK_NUM);
 
+    std::optional<ConflictScheduler> conflict_scheduler;
+    if (enable_conflict_scheduler) {
+        conflict_scheduler.emplace();
+    }
+
+    std::optional<SlotPredictor> slot_predictor;
+    if (enable_prefetch && enable_slot_prediction) {
+        slot_predictor.emplace();
+    }
+
+    SignerCache signer_cache{SIGNER_CACHE_SIZE};
+
     BlockCache block_cache;
     for_each_header(
         finalized_head,
@@ -509,6 +731,12 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
             header;
     };
 
+    auto const body_id_of = [](ToExecute const &entry) {
+        return std::visit(
+            [](auto const &header) { return header.block_body_id; },
+            entry.header);
+    };
+
     struct ToFinalize
     {
         uint64_t block;
@@ -516,12 +744,23 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
         std::vector<uint64_t> verified_blocks;
     };
 
+    // Next block to execute, with its body read while the current block
+    // executes if it is speculated, and its signers being recovered while
+    // the current block commits
+    struct Lookahead
+    {
+        bytes32_t block_id;
+        MonadConsensusBlockBody body;
+        std::optional<SignerRecovery> recovery{};
+    };
+
     std::deque<ToExecute> to_execute;
     std::deque<ToFinalize> to_finalize;
 
     while (finalized_block_num < end_block_num && stop == 0) {
         to_finalize.clear();
         to_execute.clear();
+        body_reader.clear();
 
         last_finalized_block_number = raw_db.get_latest_finalized_version();
 
@@ -580,8 +819,10 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
             continue;
         }
 
+        std::optional<Lookahead> lookahead;
         auto const handle_to_execute =
-            [&body_dir,
+            [&body_reader,
+             &body_id_of,
              &block_hash_chain,
              &db,
              &chain,
@@ -591,15 +832,73 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
              chain_id,
              start_block_num,
              enable_tracing,
-             &block_cache](
+             call_frame_store,
+             &block_cache,
+             &signer_cache,
+             &conflict_scheduler,
+             enable_prefetch,
+             &slot_predictor,
+             enable_multi_version_reads,
+             enable_early_signer_recovery,
+             enable_speculation,
+             &lookahead](
                 bytes32_t const &block_id,
-                auto const &header) -> Result<std::pair<uint64_t, uint64_t>> {
+                auto const &header,
+                ToExecute const *const next)
+            -> Result<std::pair<uint64_t, uint64_t>> {
             auto const block_time_start = std::chrono::steady_clock::now();
 
             uint64_t const block_number = header.execution_inputs.number;
-            auto body = read_body(header.block_body_id, body_dir);
+            bool const looked_ahead =
+                lookahead.has_value() && lookahead->block_id == block_id;
+            std::optional<RecoveredSigners> signers;
+            if (looked_ahead && lookahead->recovery.has_value()) {
+                signers = lookahead->recovery->get();
+            }
+            MonadConsensusBlockBody body =
+                looked_ahead ? std::move(lookahead->body)
+                             : body_reader.get(header.block_body_id);
+            lookahead.reset();
             auto const ntxns = body.transactions.size();
 
+            // A child of this block is speculated while this block executes,
+            // which reads its body now instead of before commit
+            std::optional<NextProposal> next_proposal;
+            if (enable_speculation && next != nullptr) {
+                std::visit(
+                    [&](auto const &next_header) {
+                        if (next_header.parent_id() != block_id) {
+                            return;
+                        }
+                        lookahead.emplace(Lookahead{
+                            .block_id = next->block_id,
+                            .body = body_reader.get(body_id_of(*next))});
+                        next_proposal.emplace(NextProposal{
+                            .header = next_header.execution_inputs,
+                            .transactions = lookahead->body.transactions});
+                    },
+                    next->header);
+            }
+
+            // Only the signers of the next block are recovered during the
+            // commit. The next block cannot execute yet: its reads below
+            // the proposals go to the TrieDb that the commit moves to this
+            // block's prefix, through the db thread busy with the upsert.
+            auto const before_commit = [&] {
+                if (!enable_early_signer_recovery || next == nullptr) {
+                    return;
+                }
+                if (!lookahead.has_value()) {
+                    lookahead.emplace(Lookahead{
+                        .block_id = next->block_id,
+                        .body = body_reader.get(body_id_of(*next))});
+                }
+                lookahead->recovery.emplace(
+                    lookahead->body.transactions,
+                    priority_pool,
+                    &signer_cache);
+            };
+
             auto const &block_hash_buffer =
                 block_hash_chain.find_chain(header.parent_id());
 
@@ -644,7 +943,17 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
                     priority_pool,
                     block_number == start_block_num,
                     enable_tracing,
-                    block_cache);
+                    call_frame_store,
+                    block_cache,
+                    signer_cache,
+                    conflict_scheduler ? &conflict_scheduler.value()
+                                       : nullptr,
+                    enable_prefetch,
+                    slot_predictor ? &slot_predictor.value() : nullptr,
+                    enable_multi_version_reads,
+                    std::move(signers),
+                    next_proposal ? &next_proposal.value() : nullptr,
+                    before_commit);
                 MONAD_ABORT_PRINTF("handled rev value %d", rev);
             };
             BOOST_OUTCOME_TRY(
@@ -663,28 +972,55 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
             return outcome::success();
         };
 
-        for (auto const &[block_id, consensus_header] : to_execute) {
+        size_t const prefetched =
+            std::min(to_execute.size(), BODY_PREFETCH_DEPTH);
+        for (size_t i = 0; i < prefetched; ++i) {
+            body_reader.prefetch(body_id_of(to_execute[i]));
+        }
+        for (size_t i = 0; i < to_execute.size(); ++i) {
+            if (i + BODY_PREFETCH_DEPTH < to_execute.size()) {
+                body_reader.prefetch(
+                    body_id_of(to_execute[i + BODY_PREFETCH_DEPTH]));
+            }
+            auto const &[block_id, consensus_header] = to_execute[i];
+            ToExecute const *const next =
+                i + 1 < to_execute.size() ? &to_execute[i + 1] : nullptr;
             BOOST_OUTCOME_TRY(std::visit(
-                [&block_id, handle_to_execute](auto const &header) {
-                    return handle_to_execute(block_id, header);
+                [&block_id, next, handle_to_execute](auto const &header) {
+                    return handle_to_execute(block_id, header, next);
                 },
                 consensus_header));
         }
 
+        // the db side of the finalizations and verifications of this round
+        // is one batch: a single trie copy request and metadata write
+        std::vector<BlockFinalization> finalizations;
+        finalizations.reserve(to_finalize.size());
+        std::optional<uint64_t> verified_block;
         for (auto const &[block, block_id, verified_blocks] : to_finalize) {
             LOG_INFO(
                 "Processing finalization for block {} with block_id {}",
                 block,
                 block_id);
-            db.finalize(block, block_id);
-            block_hash_chain.finalize(block_id);
-            record_block_finalized(block_id, block);
-            finalized_block_num = block;
-
+            finalizations.push_back(
+                {.block_number = block, .block_id = block_id});
             if (!verified_blocks.empty() &&
                 verified_blocks.back() != mpt::INVALID_BLOCK_NUM) {
-                db.update_verified_block(verified_blocks.back());
+                verified_block = verified_blocks.back();
             }
+        }
+        if (!finalizations.empty()) {
+            db.finalize_batch(finalizations, verified_block);
+        }
+        if (!to_finalize.empty() &&
+            to_finalize.back().block / ALLOCATOR_TRIM_INTERVAL !=
+                finalized_block_num / ALLOCATOR_TRIM_INTERVAL) {
+            vm::runtime::trim_idle_allocator_pools();
+        }
+        for (auto const &[block, block_id, verified_blocks] : to_finalize) {
+            block_hash_chain.finalize(block_id);
+            record_block_finalized(block_id, block);
+            finalized_block_num = block;
             record_block_verified(verified_blocks);
         }
 
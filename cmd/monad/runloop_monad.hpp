@@ -30,6 +30,7 @@ MONAD_NAMESPACE_BEGIN
 struct MonadChain;
 struct Db;
 class BlockHashBufferFinalized;
+class CallFrameStore;
 
 namespace mpt
 {
@@ -44,6 +45,9 @@ namespace fiber
 Result<std::pair<uint64_t, uint64_t>> runloop_monad(
     MonadChain const &, std::filesystem::path const &, mpt::Db &, Db &,
     vm::VM &, BlockHashBufferFinalized &, fiber::PriorityPool &, uint64_t &,
-    uint64_t, sig_atomic_t const volatile &, bool enable_tracing);
+    uint64_t, sig_atomic_t const volatile &, bool enable_tracing,
+    CallFrameStore *, bool enable_conflict_scheduler, bool enable_prefetch,
+    bool enable_slot_prediction, bool enable_multi_version_reads,
+    bool enable_early_signer_recovery, bool enable_speculation);
 
 MONAD_NAMESPACE_END
@@ -796,6 +796,7 @@ int main(int argc, char *argv[])
     bool interactive = false;
     std::optional<std::filesystem::path> dump_binary_snapshot;
     std::optional<std::filesystem::path> load_binary_snapshot;
+    unsigned snapshot_threads = 16;
     uint64_t version;
 
     CLI::App cli{"monad_cli"};
@@ -830,6 +831,12 @@ int main(int argc, char *argv[])
             "Load a binary snapshot to db")
         ->check(CLI::ExistingDirectory)
         ->excludes(dump_binary_snapshot_option);
+    cli_group
+        ->add_option(
+            "--snapshot_threads",
+            snapshot_threads,
+            "number of threads dumping or loading snapshot shards")
+        ->check(CLI::PositiveNumber);
     mode_group->require_option(0, 1);
     try {
         cli.parse(argc, argv);
@@ -888,6 +895,7 @@ int main(int argc, char *argv[])
             c_dbname_paths.size(),
             sq_thread_cpu.value_or(std::numeric_limits<unsigned>::max()),
             version,
+            snapshot_threads,
             monad_db_snapshot_write_filesystem,
             context);
         LOG_INFO(
@@ -910,7 +918,8 @@ int main(int argc, char *argv[])
             c_dbname_paths.size(),
             sq_thread_cpu.value_or(std::numeric_limits<unsigned>::max()),
             load_binary_snapshot.value().c_str(),
-            version);
+            version,
+            snapshot_threads);
         LOG_INFO(
             "snapshot version={} load_binary_snapshot={} elapsed={}",
             version,
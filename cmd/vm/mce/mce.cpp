@@ -18,12 +18,14 @@
 #include <instrumentable_parser.hpp>
 #include <instrumentable_vm.hpp>
 #include <instrumentation_device.hpp>
+#include <perf_counters.hpp>
 #include <stopwatch.hpp>
 
 #include <category/vm/compiler/ir/basic_blocks.hpp>
 #include <category/vm/compiler/ir/x86/types.hpp>
 #include <category/vm/compiler/types.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/intercode.hpp>
 #include <category/vm/runtime/uint256.hpp>
 
 #include <asmjit/core/jitruntime.h>
@@ -40,6 +42,7 @@
 #include <cctype>
 #include <cstdint>
 #include <cstdlib>
+#include <filesystem>
 #include <format>
 #include <ios>
 #include <iostream>
@@ -47,6 +50,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace monad::vm;
@@ -63,6 +67,8 @@ struct arguments
     bool instrument_execute = false;
     std::optional<std::string> asm_log_file;
     bool wall_clock_time = false;
+    bool perf_counters = false;
+    std::optional<std::string> batch_dir;
     bool report_result = false;
 };
 
@@ -112,11 +118,28 @@ static arguments parse_args(int const argc, char **const argv)
         "-u",
         args.timeunit_s,
         std::format("Wall clock time unit (default: {})", args.timeunit_s));
+    app.add_flag(
+        "--perf",
+        args.perf_counters,
+        std::format(
+            "Report hardware performance counters of the instrumented phases, "
+            "and of the interpreter on the same input (default: {})",
+            args.perf_counters));
+    app.add_option(
+        "--batch",
+        args.batch_dir,
+        "Report the performance counters of every contract in the directory");
 
     try {
         app.parse(argc, argv);
         args.timeunit = timeunit_of_short_string(args.timeunit_s);
-        if (args.filename.empty()) {
+        if (args.batch_dir) {
+            args.perf_counters = true;
+        }
+        if (args.perf_counters && args.wall_clock_time) {
+            throw CLI::ParseError{"-w: incompatible with --perf", 105};
+        }
+        if (args.filename.empty() && !args.batch_dir) {
             throw CLI::ParseError{"filename: no input file", 105};
         }
     }
@@ -177,22 +200,70 @@ static void dump_result(arguments const &args, evmc::Result const &result)
     std::cout << object.dump(2) << std::endl;
 }
 
+// Performance counters of one instrumented phase of a contract.
+struct PhaseCounts
+{
+    std::string contract;
+    std::string phase;
+    PerfCounts counts;
+};
+
+static void
+dump_perf_counters(std::vector<PhaseCounts> const &table, std::ostream &os)
+{
+    std::size_t contract_width = std::string_view{"contract"}.size();
+    for (auto const &row : table) {
+        contract_width = std::max(contract_width, row.contract.size());
+    }
+    os << std::format("{:<{}}  {:<11}", "contract", contract_width, "phase");
+    for (std::size_t i = 0; i < perf_counter_count; ++i) {
+        os << std::format(
+            "  {:>14}",
+            short_string_of_perf_counter(static_cast<PerfCounter>(i)));
+    }
+    os << '\n';
+    for (auto const &row : table) {
+        os << std::format(
+            "{:<{}}  {:<11}", row.contract, contract_width, row.phase);
+        for (auto const &count : row.counts) {
+            if (count) {
+                os << std::format("  {:>14}", *count);
+            }
+            else {
+                os << std::format("  {:>14}", "n/a");
+            }
+        }
+        os << '\n';
+    }
+    os << std::flush;
+}
+
+// Compile and execute the contract in `filename`. With performance
+// counters, the counts of every instrumented phase are added to `table`,
+// and the contract is also run by the interpreter, so that the native and
+// interpreter rows compare the execution of the same input.
 template <Traits traits>
-int mce_main(arguments const &args)
+int run_contract(
+    arguments const &args, std::string const &filename,
+    InstrumentationDevice const device, std::vector<PhaseCounts> &table)
 {
-    auto const device = args.wall_clock_time
-                            ? InstrumentationDevice::WallClock
-                            : InstrumentationDevice::Cachegrind;
+    auto const record = [&](bool const instrumented, char const *phase) {
+        if (instrumented && device == InstrumentationDevice::PerfCounters) {
+            table.push_back({filename, phase, perf_counters.take()});
+        }
+    };
+
     std::vector<uint8_t> const bytes = [&]() {
         if (args.instrument_decode) {
             InstrumentableDecoder<true> decoder{};
-            return decoder.decode(args.filename, device);
+            return decoder.decode(filename, device);
         }
         else {
             InstrumentableDecoder<false> decoder{};
-            return decoder.decode(args.filename, device);
+            return decoder.decode(filename, device);
         }
     }();
+    record(args.instrument_decode, "decode");
 
     std::optional<basic_blocks::BasicBlocksIR> const ir = [&]() {
         if (args.instrument_parse) {
@@ -204,8 +275,9 @@ int mce_main(arguments const &args)
             return parser.parse<traits>(bytes, device);
         }
     }();
+    record(args.instrument_parse, "parse");
     if (!ir) {
-        std::cerr << "Parsing failed" << std::endl;
+        std::cerr << std::format("{}: parsing failed", filename) << std::endl;
         return 1;
     }
 
@@ -224,9 +296,11 @@ int mce_main(arguments const &args)
             return compiler.compile<traits>(*ir, device);
         }
     }();
+    record(args.instrument_compile, "compile");
 
     if (!ncode->entrypoint()) {
-        std::cerr << "Compilation failed" << std::endl;
+        std::cerr << std::format("{}: compilation failed", filename)
+                  << std::endl;
         return 1;
     }
 
@@ -240,14 +314,73 @@ int mce_main(arguments const &args)
             return vm.execute<traits>(ncode->entrypoint(), device);
         }
     }();
+    record(args.instrument_execute, "native");
 
-    dump_result(args, result);
+    if (device == InstrumentationDevice::PerfCounters) {
+        interpreter::Intercode const icode{bytes};
+        evmc::Result const interpreter_result = [&]() {
+            if (args.instrument_execute) {
+                InstrumentableVM<true> vm(rt);
+                return vm.interpret<traits>(icode, device);
+            }
+            else {
+                InstrumentableVM<false> vm(rt);
+                return vm.interpret<traits>(icode, device);
+            }
+        }();
+        record(args.instrument_execute, "interpreter");
+        if (interpreter_result.status_code != result.status_code ||
+            interpreter_result.gas_left != result.gas_left) {
+            std::cerr << std::format(
+                             "{}: native and interpreter results differ",
+                             filename)
+                      << std::endl;
+        }
+    }
+
+    if (!args.batch_dir) {
+        dump_result(args, result);
+    }
 
     auto status_code = result.status_code;
 
     return status_code == EVMC_SUCCESS ? 0 : 1;
 }
 
+template <Traits traits>
+int mce_main(arguments const &args)
+{
+    auto const device = [&]() {
+        if (args.perf_counters) {
+            return InstrumentationDevice::PerfCounters;
+        }
+        return args.wall_clock_time ? InstrumentationDevice::WallClock
+                                    : InstrumentationDevice::Cachegrind;
+    }();
+    std::vector<PhaseCounts> table;
+    int status = 0;
+    if (args.batch_dir) {
+        std::vector<std::string> filenames;
+        for (auto const &entry :
+             std::filesystem::directory_iterator{*args.batch_dir}) {
+            if (entry.is_regular_file()) {
+                filenames.push_back(entry.path().string());
+            }
+        }
+        std::sort(filenames.begin(), filenames.end());
+        for (auto const &filename : filenames) {
+            status |= run_contract<traits>(args, filename, device, table);
+        }
+    }
+    else {
+        status = run_contract<traits>(args, args.filename, device, table);
+    }
+    if (device == InstrumentationDevice::PerfCounters) {
+        dump_perf_counters(table, std::cout);
+    }
+    return status;
+}
+
 static std::string uppercase(std::string s)
 {
     std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
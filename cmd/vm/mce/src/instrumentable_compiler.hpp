@@ -16,6 +16,7 @@
 #pragma once
 
 #include <instrumentation_device.hpp>
+#include <perf_counters.hpp>
 #include <stopwatch.hpp>
 
 #include <category/vm/compiler/ir/basic_blocks.hpp>
@@ -53,6 +54,8 @@ public:
             return compile<traits, InstrumentationDevice::Cachegrind>(ir);
         case InstrumentationDevice::WallClock:
             return compile<traits, InstrumentationDevice::WallClock>(ir);
+        case InstrumentationDevice::PerfCounters:
+            return compile<traits, InstrumentationDevice::PerfCounters>(ir);
         }
         std::unreachable();
     }
@@ -70,7 +73,7 @@ public:
                 CACHEGRIND_STOP_INSTRUMENTATION;
                 return ans;
             }
-            else {
+            else if constexpr (device == InstrumentationDevice::WallClock) {
                 timer.start();
                 auto ans =
                     monad::vm::compiler::native::compile_basic_blocks<traits>(
@@ -78,6 +81,14 @@ public:
                 timer.pause();
                 return ans;
             }
+            else {
+                perf_counters.start();
+                auto ans =
+                    monad::vm::compiler::native::compile_basic_blocks<traits>(
+                        rt_, ir, config_);
+                perf_counters.pause();
+                return ans;
+            }
         }
         else {
             return monad::vm::compiler::native::compile_basic_blocks<traits>(
@@ -18,6 +18,7 @@
 #include <category/vm/core/assert.h>
 #include <category/vm/utils/load_program.hpp>
 #include <category/vm/utils/parser.hpp>
+#include <perf_counters.hpp>
 #include <stopwatch.hpp>
 
 #include <valgrind/cachegrind.h>
@@ -43,6 +44,8 @@ public:
             return decode<InstrumentationDevice::Cachegrind>(filename);
         case InstrumentationDevice::WallClock:
             return decode<InstrumentationDevice::WallClock>(filename);
+        case InstrumentationDevice::PerfCounters:
+            return decode<InstrumentationDevice::PerfCounters>(filename);
         }
         std::unreachable();
     }
@@ -62,13 +65,20 @@ public:
                     CACHEGRIND_STOP_INSTRUMENTATION;
                     return code;
                 }
-                else {
+                else if constexpr (device == InstrumentationDevice::WallClock) {
                     timer.start();
                     std::vector<uint8_t> const code =
                         monad::vm::utils::parse_opcodes(config, contents);
                     timer.pause();
                     return code;
                 }
+                else {
+                    perf_counters.start();
+                    std::vector<uint8_t> const code =
+                        monad::vm::utils::parse_opcodes(config, contents);
+                    perf_counters.pause();
+                    return code;
+                }
             }
             else {
                 return monad::vm::utils::parse_opcodes(config, contents);
@@ -85,7 +95,7 @@ public:
 
                 return code;
             }
-            else {
+            else if constexpr (device == InstrumentationDevice::WallClock) {
                 timer.start();
 
                 std::vector<uint8_t> const code =
@@ -94,6 +104,15 @@ public:
                 timer.pause();
                 return code;
             }
+            else {
+                perf_counters.start();
+
+                std::vector<uint8_t> const code =
+                    monad::vm::utils::parse_hex_program(bytes);
+
+                perf_counters.pause();
+                return code;
+            }
         }
         else {
             return monad::vm::utils::parse_hex_program(bytes);
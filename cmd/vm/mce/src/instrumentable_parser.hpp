@@ -16,6 +16,7 @@
 #pragma once
 
 #include <instrumentation_device.hpp>
+#include <perf_counters.hpp>
 #include <stopwatch.hpp>
 
 #include <category/vm/compiler/ir/basic_blocks.hpp>
@@ -41,6 +42,8 @@ public:
             return parse<traits, InstrumentationDevice::Cachegrind>(code);
         case InstrumentationDevice::WallClock:
             return parse<traits, InstrumentationDevice::WallClock>(code);
+        case InstrumentationDevice::PerfCounters:
+            return parse<traits, InstrumentationDevice::PerfCounters>(code);
         }
         std::unreachable();
     }
@@ -58,7 +61,7 @@ public:
                 CACHEGRIND_STOP_INSTRUMENTATION;
                 return ir;
             }
-            else {
+            else if constexpr (device == InstrumentationDevice::WallClock) {
                 timer.start();
                 auto ir = monad::vm::compiler::basic_blocks::BasicBlocksIR(
                     monad::vm::compiler::basic_blocks::unsafe_make_ir<traits>(
@@ -66,6 +69,14 @@ public:
                 timer.pause();
                 return ir;
             }
+            else {
+                perf_counters.start();
+                auto ir = monad::vm::compiler::basic_blocks::BasicBlocksIR(
+                    monad::vm::compiler::basic_blocks::unsafe_make_ir<traits>(
+                        code));
+                perf_counters.pause();
+                return ir;
+            }
         }
         else {
             return monad::vm::compiler::basic_blocks::BasicBlocksIR(
@@ -14,11 +14,14 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <instrumentation_device.hpp>
+#include <perf_counters.hpp>
 #include <stopwatch.hpp>
 
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/core/assert.h>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/execute.hpp>
+#include <category/vm/interpreter/intercode.hpp>
 #include <category/vm/runtime/allocator.hpp>
 
 #include <asmjit/x86.h>
@@ -75,6 +78,8 @@ public:
             return execute<traits, InstrumentationDevice::Cachegrind>(entry);
         case InstrumentationDevice::WallClock:
             return execute<traits, InstrumentationDevice::WallClock>(entry);
+        case InstrumentationDevice::PerfCounters:
+            return execute<traits, InstrumentationDevice::PerfCounters>(entry);
         }
         std::unreachable();
     }
@@ -83,6 +88,47 @@ public:
     evmc::Result execute(native::entrypoint_t entry)
     {
         MONAD_VM_ASSERT(entry != nullptr);
+        return run<traits, device>(
+            [&](vm::runtime::Context &ctx, uint8_t *stack_ptr) {
+                entry(&ctx, stack_ptr);
+            });
+    }
+
+    template <monad::Traits traits>
+    evmc::Result interpret(
+        vm::interpreter::Intercode const &icode,
+        InstrumentationDevice const device)
+    {
+        switch (device) {
+        case InstrumentationDevice::Cachegrind:
+            return interpret<traits, InstrumentationDevice::Cachegrind>(icode);
+        case InstrumentationDevice::WallClock:
+            return interpret<traits, InstrumentationDevice::WallClock>(icode);
+        case InstrumentationDevice::PerfCounters:
+            return interpret<traits, InstrumentationDevice::PerfCounters>(
+                icode);
+        }
+        std::unreachable();
+    }
+
+    template <monad::Traits traits, InstrumentationDevice device>
+    evmc::Result interpret(vm::interpreter::Intercode const &icode)
+    {
+        return run<traits, device>(
+            [&](vm::runtime::Context &ctx, uint8_t *stack_ptr) {
+                vm::interpreter::execute<traits>(ctx, icode, stack_ptr);
+            });
+    }
+
+    evmc_capabilities_flagset get_capabilities() const
+    {
+        return EVMC_CAPABILITY_EVM1;
+    }
+
+private:
+    template <monad::Traits traits, InstrumentationDevice device, typename F>
+    evmc::Result run(F &&f)
+    {
         using namespace evmone::state;
 
         auto msg = new evmc_message{
@@ -125,17 +171,22 @@ public:
         if constexpr (instrument) {
             if constexpr (device == InstrumentationDevice::Cachegrind) {
                 CACHEGRIND_START_INSTRUMENTATION;
-                entry(&ctx, stack_ptr.get());
+                f(ctx, stack_ptr.get());
                 CACHEGRIND_STOP_INSTRUMENTATION;
             }
-            else {
+            else if constexpr (device == InstrumentationDevice::WallClock) {
                 timer.start();
-                entry(&ctx, stack_ptr.get());
+                f(ctx, stack_ptr.get());
                 timer.pause();
             }
+            else {
+                perf_counters.start();
+                f(ctx, stack_ptr.get());
+                perf_counters.pause();
+            }
         }
         else {
-            entry(&ctx, stack_ptr.get());
+            f(ctx, stack_ptr.get());
         }
 
         delete msg;
@@ -143,12 +194,6 @@ public:
         return ctx.copy_to_evmc_result();
     }
 
-    evmc_capabilities_flagset get_capabilities() const
-    {
-        return EVMC_CAPABILITY_EVM1;
-    }
-
-private:
     asmjit::JitRuntime &rt_;
 };
 
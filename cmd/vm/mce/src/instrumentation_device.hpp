@@ -20,5 +20,7 @@ enum class InstrumentationDevice
     // Use cachegrind to collect measurements.
     Cachegrind,
     // Use a simple wall clock timer to collect measurements.
-    WallClock
+    WallClock,
+    // Use hardware performance counters to collect measurements.
+    PerfCounters
 };
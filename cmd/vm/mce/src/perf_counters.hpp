@@ -0,0 +1,176 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+enum class PerfCounter
+{
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1dMisses,
+    LlcMisses,
+};
+
+constexpr std::size_t perf_counter_count = 5;
+
+constexpr std::string_view short_string_of_perf_counter(PerfCounter const c)
+{
+    switch (c) {
+    case PerfCounter::Cycles:
+        return "cycles";
+    case PerfCounter::Instructions:
+        return "instructions";
+    case PerfCounter::BranchMisses:
+        return "branch-misses";
+    case PerfCounter::L1dMisses:
+        return "L1d-misses";
+    case PerfCounter::LlcMisses:
+        return "LLC-misses";
+    }
+
+    throw std::runtime_error("invalid perf counter");
+}
+
+// Counts of the user space events, or `std::nullopt` for the events which
+// the CPU or the kernel does not support.
+using PerfCounts = std::array<std::optional<uint64_t>, perf_counter_count>;
+
+// Hardware performance counters of the calling thread, opened as one
+// `perf_event_open` group so that all counters cover the same instructions.
+// Like the `Stopwatch`, the counts accumulate over the instrumented regions
+// between `start` and `pause`, until they are taken.
+class PerfCountersGroup
+{
+public:
+    PerfCountersGroup()
+    {
+        fds.fill(-1);
+    }
+
+    PerfCountersGroup(PerfCountersGroup const &) = delete;
+    PerfCountersGroup &operator=(PerfCountersGroup const &) = delete;
+
+    ~PerfCountersGroup()
+    {
+        for (int const fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    void start()
+    {
+        if (running) {
+            return;
+        }
+        if (fds[0] < 0) {
+            open_group();
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        running = true;
+    }
+
+    void pause()
+    {
+        if (!running) {
+            return;
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        running = false;
+
+        // With `PERF_FORMAT_GROUP`, the group leader reads the number of
+        // counters followed by their values, in the order of opening.
+        std::array<uint64_t, 1 + perf_counter_count> values{};
+        auto const n = read(fds[0], values.data(), sizeof(values));
+        if (n < static_cast<ssize_t>(sizeof(uint64_t))) {
+            throw std::runtime_error("failed to read perf counters");
+        }
+        std::size_t v = 1;
+        for (std::size_t i = 0; i < perf_counter_count; ++i) {
+            if (fds[i] >= 0 && v <= values[0]) {
+                counts[i] = counts[i].value_or(0) + values[v++];
+            }
+        }
+    }
+
+    // The counts since the last call, which restarts the counts from zero.
+    PerfCounts take()
+    {
+        PerfCounts const result = counts;
+        counts = {};
+        return result;
+    }
+
+private:
+    static constexpr std::array<std::pair<uint32_t, uint64_t>, 5> events{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+    static_assert(events.size() == perf_counter_count);
+
+    void open_group()
+    {
+        for (std::size_t i = 0; i < perf_counter_count; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.read_format = PERF_FORMAT_GROUP;
+            // User space only, which is allowed with the default
+            // `perf_event_paranoid` setting.
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // The other counters follow the enabling of the leader.
+            attr.disabled = i == 0;
+            auto const fd = syscall(
+                SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+            if (fd < 0 && i == 0) {
+                throw std::runtime_error(std::format(
+                    "perf_event_open: {}", std::strerror(errno)));
+            }
+            // Events missing on this CPU are reported as unsupported.
+            fds[i] = static_cast<int>(fd);
+        }
+    }
+
+    bool running = false;
+    std::array<int, perf_counter_count> fds;
+    PerfCounts counts{};
+};
+
+PerfCountersGroup perf_counters{};
@@ -0,0 +1,110 @@
+# Copyright (C) 2025 Category Labs, Inc.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import argparse
+import json
+import pathlib
+import urllib.request
+from typing import Any
+
+# Gas charged before the first instruction of a call frame runs; access list
+# costs are not included, so transactions with access lists are replayed with
+# slightly more gas than they had on chain.
+TX_BASE_GAS = 21000
+TX_ZERO_BYTE_GAS = 4
+TX_NONZERO_BYTE_GAS = 16
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(
+        prog="snapshot-frames",
+        description="Snapshot mainnet call frames for the execution benchmarks",
+    )
+
+    parser.add_argument(
+        "--rpc",
+        type=str,
+        required=True,
+        help="JSON-RPC endpoint of an archive node with the debug namespace",
+    )
+
+    parser.add_argument(
+        "--out",
+        type=pathlib.Path,
+        required=True,
+        help="Corpus file to write",
+    )
+
+    parser.add_argument(
+        "transactions",
+        type=str,
+        nargs="+",
+        help="Hashes of the transactions to snapshot",
+    )
+
+    return parser.parse_args()
+
+
+def rpc_call(url: str, method: str, params: list[Any]) -> Any:
+    body = json.dumps({"jsonrpc": "2.0", "id": 1, "method": method, "params": params})
+    request = urllib.request.Request(url, data=body.encode(), headers={"Content-Type": "application/json"})
+
+    with urllib.request.urlopen(request) as response:
+        reply = json.load(response)
+
+    if "error" in reply:
+        raise RuntimeError(f"{method}: {reply['error']['message']}")
+
+    return reply["result"]
+
+
+def intrinsic_gas(data: str) -> int:
+    payload = bytes.fromhex(data.removeprefix("0x"))
+    zeros = payload.count(0)
+    return TX_BASE_GAS + zeros * TX_ZERO_BYTE_GAS + (len(payload) - zeros) * TX_NONZERO_BYTE_GAS
+
+
+def snapshot(url: str, tx_hash: str) -> dict[str, Any] | None:
+    tx = rpc_call(url, "eth_getTransactionByHash", [tx_hash])
+    if tx["to"] is None:
+        print(f"skipping contract creation {tx_hash}")
+        return None
+
+    receipt = rpc_call(url, "eth_getTransactionReceipt", [tx_hash])
+    pre = rpc_call(url, "debug_traceTransaction", [tx_hash, {"tracer": "prestateTracer"}])
+
+    frame = {
+        "from": tx["from"],
+        "to": tx["to"],
+        "input": tx["input"],
+        "value": tx["value"],
+        "gas": hex(int(tx["gas"], 16) - intrinsic_gas(tx["input"])),
+        "success": int(receipt["status"], 16) == 1,
+    }
+
+    return {"pre": pre, "frames": [frame]}
+
+
+def main() -> None:
+    args = parse_args()
+
+    corpus: dict[str, Any] = {}
+    for tx_hash in args.transactions:
+        test = snapshot(args.rpc, tx_hash)
+        if test is not None:
+            corpus[tx_hash] = test
+
+    with open(args.out, "w") as f:
+        json.dump(corpus, f, indent=2)
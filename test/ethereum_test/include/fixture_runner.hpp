@@ -0,0 +1,59 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <monad/test/config.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+MONAD_TEST_NAMESPACE_BEGIN
+
+/// The shard index of this process if it was started by `run_sharded`
+std::optional<unsigned> shard_index();
+
+/// Runs the registered tests in `jobs` child processes, each one running one
+/// gtest shard of them. Every fixture already runs on its own in-memory
+/// database and VM, but the gtest assertions and the execution event ring are
+/// per process, so processes rather than threads keep the fixtures apart.
+/// Prints the total wall time and the `slowest` slowest fixtures, and returns
+/// the exit code of the run.
+int run_sharded(
+    std::vector<std::string> const &args, unsigned jobs, size_t slowest);
+
+/// Prints the total wall time and the slowest tests once the tests of an
+/// unsharded run finish
+class SlowestTestsReporter final : public testing::EmptyTestEventListener
+{
+    size_t const slowest_;
+    std::chrono::steady_clock::time_point begin_{};
+
+public:
+    explicit SlowestTestsReporter(size_t const slowest)
+        : slowest_{slowest}
+    {
+    }
+
+    void OnTestProgramStart(testing::UnitTest const &) override;
+    void OnTestProgramEnd(testing::UnitTest const &) override;
+};
+
+MONAD_TEST_NAMESPACE_END
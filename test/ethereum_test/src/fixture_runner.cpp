@@ -0,0 +1,209 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <fixture_runner.hpp>
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+
+#include <monad/test/config.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <quill/bundled/fmt/core.h>
+#include <quill/bundled/fmt/format.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+struct TestTime
+{
+    std::string name;
+    double seconds;
+    bool failed;
+};
+
+void print_report(
+    std::vector<TestTime> &times,
+    std::chrono::steady_clock::duration const wall_time, size_t const slowest)
+{
+    double total = 0;
+    size_t failed = 0;
+    for (auto const &t : times) {
+        total += t.seconds;
+        failed += t.failed ? 1 : 0;
+    }
+    std::ranges::sort(times, [](TestTime const &a, TestTime const &b) {
+        return a.seconds > b.seconds;
+    });
+
+    fmt::print(
+        "{} fixtures ({} failed) in {:.3f}s wall time, {:.3f}s in fixtures\n",
+        times.size(),
+        failed,
+        std::chrono::duration<double>(wall_time).count(),
+        total);
+    size_t const n = std::min(slowest, times.size());
+    if (n > 0) {
+        fmt::print("slowest {} fixtures:\n", n);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        fmt::print("  {:9.3f}s {}\n", times[i].seconds, times[i].name);
+    }
+    for (auto const &t : times) {
+        if (t.failed) {
+            fmt::print("FAILED {}\n", t.name);
+        }
+    }
+}
+
+// Appends the tests a shard ran, from its gtest json output
+void read_shard_times(
+    std::filesystem::path const &path, std::vector<TestTime> &times)
+{
+    std::ifstream f{path};
+    if (!f) {
+        return;
+    }
+    auto const json = nlohmann::json::parse(f);
+    for (auto const &suite : json.at("testsuites")) {
+        auto const suite_name = suite.at("name").get<std::string>();
+        for (auto const &test : suite.at("testsuite")) {
+            if (test.at("status").get<std::string>() != "RUN") {
+                continue;
+            }
+            // gtest formats the time as seconds with an "s" suffix
+            auto const time = test.at("time").get<std::string>();
+            times.push_back(TestTime{
+                .name = suite_name + "." + test.at("name").get<std::string>(),
+                .seconds = std::stod(time),
+                .failed = test.contains("failures")});
+        }
+    }
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_TEST_NAMESPACE_BEGIN
+
+std::optional<unsigned> shard_index()
+{
+    char const *const index = std::getenv("GTEST_SHARD_INDEX");
+    if (index == nullptr) {
+        return std::nullopt;
+    }
+    return static_cast<unsigned>(std::stoul(index));
+}
+
+int run_sharded(
+    std::vector<std::string> const &args, unsigned const jobs,
+    size_t const slowest)
+{
+    namespace fs = std::filesystem;
+
+    MONAD_ASSERT(jobs > 0);
+    auto const begin = std::chrono::steady_clock::now();
+    fs::path const dir = fs::temp_directory_path() /
+                         fmt::format("monad-ethereum-test-{}", getpid());
+    fs::create_directories(dir);
+
+    std::vector<pid_t> children;
+    for (unsigned i = 0; i < jobs; ++i) {
+        std::vector<std::string> child_args = args;
+        child_args.push_back(fmt::format(
+            "--gtest_output=json:{}",
+            (dir / fmt::format("shard_{}.json", i)).string()));
+        std::vector<char *> argv;
+        for (auto &arg : child_args) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+
+        pid_t const pid = fork();
+        MONAD_ASSERT(pid != -1);
+        if (pid == 0) {
+            setenv("GTEST_TOTAL_SHARDS", std::to_string(jobs).c_str(), 1);
+            setenv("GTEST_SHARD_INDEX", std::to_string(i).c_str(), 1);
+            execv("/proc/self/exe", argv.data());
+            _exit(127);
+        }
+        children.push_back(pid);
+    }
+
+    bool failed = false;
+    for (pid_t const pid : children) {
+        int status = 0;
+        MONAD_ASSERT(waitpid(pid, &status, 0) == pid);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+        }
+    }
+    auto const wall_time = std::chrono::steady_clock::now() - begin;
+
+    std::vector<TestTime> times;
+    for (unsigned i = 0; i < jobs; ++i) {
+        read_shard_times(dir / fmt::format("shard_{}.json", i), times);
+    }
+    fs::remove_all(dir);
+
+    print_report(times, wall_time, slowest);
+    if (times.empty()) {
+        fmt::print("No tests were run.\n");
+        return -1;
+    }
+    return failed ? 1 : 0;
+}
+
+void SlowestTestsReporter::OnTestProgramStart(testing::UnitTest const &)
+{
+    begin_ = std::chrono::steady_clock::now();
+}
+
+void SlowestTestsReporter::OnTestProgramEnd(testing::UnitTest const &unit_test)
+{
+    std::vector<TestTime> times;
+    for (int i = 0; i < unit_test.total_test_suite_count(); ++i) {
+        auto const &suite = *unit_test.GetTestSuite(i);
+        for (int j = 0; j < suite.total_test_count(); ++j) {
+            auto const &info = *suite.GetTestInfo(j);
+            if (!info.should_run()) {
+                continue;
+            }
+            times.push_back(TestTime{
+                .name = fmt::format("{}.{}", suite.name(), info.name()),
+                .seconds =
+                    static_cast<double>(info.result()->elapsed_time()) / 1000,
+                .failed = info.result()->Failed()});
+        }
+    }
+    print_report(times, std::chrono::steady_clock::now() - begin_, slowest_);
+}
+
+MONAD_TEST_NAMESPACE_END
@@ -21,6 +21,7 @@
 #include <blockchain_test.hpp>
 #include <ethereum_test.hpp>
 #include <event.hpp>
+#include <fixture_runner.hpp>
 #include <monad/test/config.hpp>
 #include <transaction_test.hpp>
 
@@ -40,6 +41,7 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -50,6 +52,8 @@ MONAD_NAMESPACE_END
 int main(int argc, char *argv[])
 {
     using namespace monad;
+    // The shards of a parallel run are started with the original arguments
+    std::vector<std::string> const args{argv, argv + argc};
     testing::InitGoogleTest(&argc, argv); // Process GoogleTest flags.
 
     auto log_level = quill::LogLevel::None;
@@ -58,6 +62,8 @@ int main(int argc, char *argv[])
     std::string record_exec_events_path;
     bool trace_calls = false;
     unsigned sleep_seconds = 0;
+    unsigned jobs = 1;
+    size_t slowest = 10;
 
     CLI::App app{"monad ethereum tests runner"};
     app.add_option("--log_level", log_level, "Logging level")
@@ -76,8 +82,19 @@ int main(int argc, char *argv[])
             ->type_name("<file-path> (leave empty for anonymous memfd)");
     app.add_option(
         "--sleep", sleep_seconds, "Sleep for the specified number of seconds");
+    app.add_option(
+        "--jobs",
+        jobs,
+        "Run the fixtures in this many processes, one gtest shard each");
+    app.add_option(
+        "--slowest", slowest, "Number of slowest fixtures to report");
     CLI11_PARSE(app, argc, argv);
 
+    auto const shard = test::shard_index();
+    if (jobs > 1 && !shard.has_value()) {
+        return test::run_sharded(args, jobs, slowest);
+    }
+
     quill::start(true);
     quill::get_root_logger()->set_log_level(log_level);
 #ifdef ENABLE_EVENT_TRACING
@@ -85,6 +102,11 @@ int main(int argc, char *argv[])
 #endif
 
     if (record_exec_events->count() > 0) {
+        // The event ring file is created exclusively, so each shard has its
+        // own
+        if (shard.has_value() && !record_exec_events_path.empty()) {
+            record_exec_events_path += "." + std::to_string(shard.value());
+        }
         test::init_exec_event_recorder(record_exec_events_path);
     }
 
@@ -92,9 +114,16 @@ int main(int argc, char *argv[])
     test::register_blockchain_tests(revision, trace_calls);
     test::register_transaction_tests(revision);
 
+    if (!shard.has_value()) {
+        ::testing::UnitTest::GetInstance()->listeners().Append(
+            new test::SlowestTestsReporter{slowest});
+    }
+
     int return_code = RUN_ALL_TESTS();
 
-    if (::testing::UnitTest::GetInstance()->test_to_run_count() == 0) {
+    // A shard may get no tests when there are fewer tests than shards
+    if (!shard.has_value() &&
+        ::testing::UnitTest::GetInstance()->test_to_run_count() == 0) {
         LOG_ERROR("No tests were run.");
         return_code = -1;
     }
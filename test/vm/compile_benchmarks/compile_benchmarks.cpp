@@ -26,14 +26,19 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <ios>
 #include <iterator>
 #include <random>
+#include <ratio>
+#include <utility>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -99,12 +104,12 @@ namespace
         ->Range(1, 24 * 1024)
         ->Complexity();
 
-    void run_benchmark(benchmark::State &state, fs::path const &evm_code)
+    std::vector<std::uint8_t> load_hex_program(fs::path const &evm_code)
     {
         std::ifstream file(evm_code, std::ios::ate);
         auto const size = file.tellg();
-        if (size == 0) {
-            return state.SkipWithError("Failed to open file");
+        if (size <= 0) {
+            return {};
         }
         file.seekg(0, std::ios::beg);
 
@@ -114,6 +119,17 @@ namespace
         auto program = monad::vm::utils::parse_hex_program(buffer);
         MONAD_VM_ASSERT(
             program.size() <= *monad::vm::interpreter::code_size_t::max());
+        return program;
+    }
+
+    void run_benchmark(
+        benchmark::State &state, fs::path const &evm_code,
+        monad::vm::compiler::native::CompilerConfig const &config)
+    {
+        auto const program = load_hex_program(evm_code);
+        if (program.empty()) {
+            return state.SkipWithError("Failed to open file");
+        }
 
         auto rt = asmjit::JitRuntime{};
 
@@ -123,7 +139,8 @@ namespace
                 rt,
                 program.data(),
                 monad::vm::interpreter::code_size_t::unsafe_from(
-                    static_cast<uint32_t>(program.size())));
+                    static_cast<uint32_t>(program.size())),
+                config);
 
             if (!ncode->entrypoint()) {
                 return state.SkipWithError("Failed to compile contract");
@@ -133,6 +150,99 @@ namespace
         state.counters["codesize"] = static_cast<double>(program.size());
     }
 
+    // Compiles every contract of a data set in each iteration, and reports
+    // the distribution of compile latency over the data set, which decides
+    // how long hot contracts stay interpreted, rather than the time of one
+    // contract.
+    void run_dataset_benchmark(
+        benchmark::State &state,
+        std::vector<std::vector<std::uint8_t>> const &programs,
+        monad::vm::compiler::native::CompilerConfig config)
+    {
+        using namespace std::chrono;
+
+        auto phases = monad::vm::compiler::native::CompilePhaseTimes{};
+        config.phase_times = &phases;
+
+        auto rt = asmjit::JitRuntime{};
+        auto times_us = std::vector<double>{};
+        auto log_ratio_sum = 0.0;
+        auto ratio_count = std::size_t{0};
+
+        for (auto _ : state) {
+            for (auto const &program : programs) {
+                auto const start = steady_clock::now();
+                auto const ncode = monad::vm::compiler::native::compile<
+                    monad::EvmTraits<EVMC_LATEST_STABLE_REVISION>>(
+                    rt,
+                    program.data(),
+                    monad::vm::interpreter::code_size_t::unsafe_from(
+                        static_cast<uint32_t>(program.size())),
+                    config);
+                auto const end = steady_clock::now();
+                times_us.push_back(
+                    duration<double, std::micro>(end - start).count());
+
+                // Like `avg_native_code_ratio_` of the compiler statistics.
+                if (ncode->entrypoint() && !program.empty()) {
+                    log_ratio_sum += std::log(
+                        static_cast<double>(*ncode->code_size_estimate()) /
+                        static_cast<double>(program.size()));
+                    ++ratio_count;
+                }
+            }
+        }
+        if (times_us.empty()) {
+            return;
+        }
+
+        std::sort(times_us.begin(), times_us.end());
+        auto const percentile = [&](std::size_t const p) {
+            return times_us[std::min(
+                times_us.size() - 1, times_us.size() * p / 100)];
+        };
+        auto const per_contract_us = [&](nanoseconds const total) {
+            return static_cast<double>(total.count()) / 1000.0 /
+                   static_cast<double>(times_us.size());
+        };
+
+        state.counters["contracts"] = static_cast<double>(programs.size());
+        state.counters["p50_us"] = percentile(50);
+        state.counters["p99_us"] = percentile(99);
+        state.counters["native_code_ratio"] =
+            ratio_count ? std::exp(
+                              log_ratio_sum / static_cast<double>(ratio_count))
+                        : 0.0;
+        state.counters["basic_blocks_us"] =
+            per_contract_us(phases.basic_blocks);
+        state.counters["ir_passes_us"] = per_contract_us(phases.ir_passes);
+        state.counters["emit_us"] = per_contract_us(phases.emit);
+        state.counters["finalize_us"] = per_contract_us(phases.finalize);
+    }
+
+    // The directory named by MONAD_COMPILE_BENCHMARK_DATASET, e.g. holding
+    // the contracts using the most gas on mainnet, one hex file each, or
+    // the contracts of the compile benchmarks by default.
+    std::vector<std::vector<std::uint8_t>> dataset_programs()
+    {
+        auto const *const env = std::getenv("MONAD_COMPILE_BENCHMARK_DATASET");
+        auto const dir = env ? fs::path{env}
+                             : monad::test_resource::compile_benchmarks_dir;
+        auto programs = std::vector<std::vector<std::uint8_t>>{};
+        if (!fs::is_directory(dir)) {
+            return programs;
+        }
+        for (auto const &entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                if (auto program = load_hex_program(entry.path());
+                    !program.empty()) {
+                    programs.push_back(std::move(program));
+                }
+            }
+        }
+        return programs;
+    }
+
     auto benchmark_tests()
     {
         return std::array{
@@ -149,8 +259,42 @@ namespace
             auto stem = test.stem();
 
             benchmark::RegisterBenchmark(
-                std::format("compile/{}", stem.string()), run_benchmark, test);
+                std::format("compile/{}", stem.string()),
+                run_benchmark,
+                test,
+                monad::vm::compiler::native::CompilerConfig{});
+
+            benchmark::RegisterBenchmark(
+                std::format("compile_ir_passes/{}", stem.string()),
+                run_benchmark,
+                test,
+                monad::vm::compiler::native::CompilerConfig{
+                    .ir_passes = {
+                        .fold_constants = true,
+                        .eliminate_dead_stack_ops = true,
+                        .resolve_known_jumps = true,
+                        .merge_jumpdest_gas_checks = true}});
+        }
+
+        auto programs = dataset_programs();
+        if (programs.empty()) {
+            return;
         }
+        benchmark::RegisterBenchmark(
+            "compile_dataset",
+            run_dataset_benchmark,
+            programs,
+            monad::vm::compiler::native::CompilerConfig{});
+        benchmark::RegisterBenchmark(
+            "compile_dataset_ir_passes",
+            run_dataset_benchmark,
+            std::move(programs),
+            monad::vm::compiler::native::CompilerConfig{
+                .ir_passes = {
+                    .fold_constants = true,
+                    .eliminate_dead_stack_ops = true,
+                    .resolve_known_jumps = true,
+                    .merge_jumpdest_gas_checks = true}});
     }
 }
 
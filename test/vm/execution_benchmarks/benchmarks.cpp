@@ -21,6 +21,7 @@
 #include <test_vm.hpp>
 
 #include "benchmarktest.hpp"
+#include "hardware_counters.hpp"
 
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
@@ -36,6 +37,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <format>
 #include <fstream>
@@ -138,6 +140,26 @@ namespace
             read_file(calldata_path));
     }
 
+    // Reports throughput in gas per second, and the hardware counters per
+    // iteration when the kernel lets us read them.
+    void report_counters(
+        benchmark::State &state, std::int64_t const gas_used,
+        HardwareCounters const &counters)
+    {
+        state.counters["gas"] = benchmark::Counter(
+            static_cast<double>(gas_used), benchmark::Counter::kIsRate);
+
+        if (counters.available()) {
+            auto const sample = counters.read();
+            state.counters["instructions"] = benchmark::Counter(
+                static_cast<double>(sample.instructions),
+                benchmark::Counter::kAvgIterations);
+            state.counters["cache_misses"] = benchmark::Counter(
+                static_cast<double>(sample.cache_misses),
+                benchmark::Counter::kAvgIterations);
+        }
+    }
+
     // This benchmark runner assumes that no state is modified during execution,
     // as it re-uses the same state between all the runs. For anything other
     // that micro-benchmarks of e.g. specific opcodes, use the JSON format with
@@ -168,12 +190,20 @@ namespace
 
         vm_ptr->precompile_contract(rev, code_hash, code, code_size, impl);
 
+        auto counters = HardwareCounters{};
+        auto gas_used = std::int64_t{0};
+
         for (auto _ : state) {
+            counters.start();
             auto const result = evmc::Result{
                 vm_ptr->execute(interface, ctx, rev, &msg, code, code_size)};
+            counters.stop();
 
             MONAD_VM_ASSERT(result.status_code == EVMC_SUCCESS);
+            gas_used += msg.gas - result.gas_left;
         }
+
+        report_counters(state, gas_used, counters);
     }
 
     void touch_init_state(
@@ -199,6 +229,9 @@ namespace
 
         auto const code = initial_test_state.get_account_code(msg.code_address);
 
+        auto counters = HardwareCounters{};
+        auto gas_used = std::int64_t{0};
+
         for (auto _ : state) {
             state.PauseTiming();
             auto evm_state = State{initial_test_state};
@@ -213,8 +246,10 @@ namespace
             auto *ctx = host.to_context();
             state.ResumeTiming();
 
+            counters.start();
             auto const result = evmc::Result{vm_ptr->execute(
                 interface, ctx, rev, &msg, code.data(), code.size())};
+            counters.stop();
 
             if (assert_success) {
                 MONAD_VM_ASSERT(result.status_code == EVMC_SUCCESS);
@@ -222,7 +257,10 @@ namespace
             else {
                 MONAD_VM_ASSERT(result.status_code != EVMC_SUCCESS);
             }
+            gas_used += msg.gas - result.gas_left;
         }
+
+        report_counters(state, gas_used, counters);
     }
 
     void register_benchmark(std::string_view const name, evmc_message const msg)
@@ -246,6 +284,14 @@ namespace
             ret.emplace_back(load_benchmark(p));
         }
 
+        // Programs saved by monad-performance-fuzzer --corpus
+        auto const fuzzed = execution_benchmarks_dir / "fuzzed";
+        if (fs::is_directory(fuzzed)) {
+            for (auto const &p : fs::directory_iterator(fuzzed)) {
+                ret.emplace_back(load_benchmark(p));
+            }
+        }
+
         return ret;
     }
 
@@ -320,6 +366,78 @@ namespace
             }
         }
     }
+
+    // Snapshots of mainnet call frames live next to the synthetic programs;
+    // the directory can be overridden to replay a locally extracted corpus.
+    auto corpus_dir()
+    {
+        if (auto const *dir = std::getenv("MONAD_BENCHMARK_CORPUS_DIR")) {
+            return fs::path{dir};
+        }
+        return execution_benchmarks_dir / "mainnet";
+    }
+
+    auto benchmarks_corpus()
+    {
+        auto ret = std::vector<CorpusTest>{};
+
+        auto const dir = corpus_dir();
+        if (!fs::is_directory(dir)) {
+            return ret;
+        }
+
+        for (auto const &p : fs::directory_iterator(dir)) {
+            if (p.path().extension() != ".json") {
+                continue;
+            }
+
+            auto f = std::ifstream{p.path()};
+            for (auto &test : load_corpus_tests(f)) {
+                ret.emplace_back(std::move(test));
+            }
+        }
+
+        return ret;
+    }
+
+    void register_benchmark_corpus(std::vector<CorpusTest> const &tests)
+    {
+        for (auto const &test : tests) {
+            for (size_t i = 0; i < test.frames.size(); ++i) {
+                auto const &frame = test.frames[i];
+
+                auto msg = evmc_message{
+                    .kind = EVMC_CALL,
+                    .flags = 0,
+                    .depth = 0,
+                    .gas = frame.gas,
+                    .recipient = frame.recipient,
+                    .sender = frame.sender,
+                    .input_data = frame.input.data(),
+                    .input_size = frame.input.size(),
+                    .value = intx::be::store<evmc::uint256be>(frame.value),
+                    .create2_salt = {},
+                    .code_address = frame.recipient,
+                    .code = nullptr,
+                    .code_size = 0,
+                };
+
+                for (auto const impl : {Interpreter, Compiler, LLVM, Evmone}) {
+                    benchmark::RegisterBenchmark(
+                        std::format(
+                            "mainnet/{}/{}/{}",
+                            test.name,
+                            i,
+                            BlockchainTestVM::impl_name(impl)),
+                        run_benchmark_json,
+                        impl,
+                        test.pre_state,
+                        msg,
+                        frame.success);
+                }
+            }
+        }
+    }
 }
 
 int main(int argc, char **argv)
@@ -338,6 +456,9 @@ int main(int argc, char **argv)
         register_benchmark_json(path);
     }
 
+    auto const all_bms_corpus = benchmarks_corpus();
+    register_benchmark_corpus(all_bms_corpus);
+
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
     benchmark::Shutdown();
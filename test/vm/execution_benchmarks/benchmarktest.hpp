@@ -19,8 +19,14 @@
 #include "statetest.hpp"
 #include "test_state.hpp"
 
+#include <evmc/bytes.hpp>
 #include <evmc/evmc.hpp>
+
+#include <intx/intx.hpp>
+
+#include <cstdint>
 #include <span>
+#include <string>
 #include <vector>
 
 namespace monad::test
@@ -45,4 +51,31 @@ namespace monad::test
     };
 
     std::vector<BenchmarkTest> load_benchmark_tests(std::istream &input);
+
+    // A top-level call replayed from chain history. `success` records whether
+    // the original call succeeded, so that replays that revert on chain are
+    // still checked against the recorded outcome.
+    struct CallFrame
+    {
+        evmc::address sender;
+        evmc::address recipient;
+        evmc::bytes input;
+        intx::uint256 value;
+        std::int64_t gas;
+        bool success;
+    };
+
+    struct CorpusTest
+    {
+        std::string name;
+
+        std::vector<CallFrame> frames;
+        evmone::test::TestState pre_state;
+    };
+
+    // Loads a snapshot of call frames and the pre-state they touch. The
+    // pre-state is the output of the prestate tracer (`debug_traceCall` or
+    // `debug_traceTransaction` with `prestateTracer`), so missing fields and
+    // numeric nonces are accepted.
+    std::vector<CorpusTest> load_corpus_tests(std::istream &input);
 } // namespace monad::test
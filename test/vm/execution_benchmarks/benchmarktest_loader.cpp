@@ -21,6 +21,8 @@
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <cstdint>
+#include <format>
 #include <istream>
 #include <string>
 #include <vector>
@@ -63,6 +65,55 @@ namespace monad::test
             return bt;
         }
 
+        // The prestate tracer omits empty fields and reports nonces as JSON
+        // numbers; the state test loader expects every field as a hex string.
+        json::json normalise_prestate(json::json const &j)
+        {
+            auto ret = json::json::object();
+
+            for (auto const &[addr, acc] : j.items()) {
+                auto &out = ret[addr];
+                out["balance"] = acc.value("balance", "0x0");
+                out["code"] = acc.value("code", "0x");
+                out["storage"] = acc.value("storage", json::json::object());
+
+                auto const nonce = acc.value("nonce", json::json(0));
+                out["nonce"] = nonce.is_number()
+                                   ? std::format(
+                                         "{:#x}", nonce.get<std::uint64_t>())
+                                   : nonce;
+            }
+
+            return ret;
+        }
+
+        CallFrame load_call_frame(json::json const &j)
+        {
+            return CallFrame{
+                .sender = from_json<evmc::address>(j.at("from")),
+                .recipient = from_json<evmc::address>(j.at("to")),
+                .input = from_json<evmc::bytes>(j.at("input")),
+                .value = from_json<intx::uint256>(j.value("value", "0x0")),
+                .gas = from_json<std::int64_t>(j.at("gas")),
+                .success = j.value("success", true),
+            };
+        }
+
+        CorpusTest
+        load_corpus_test_case(std::string const &name, json::json const &j)
+        {
+            CorpusTest ct;
+            ct.name = name;
+            ct.pre_state =
+                from_json<TestState>(normalise_prestate(j.at("pre")));
+
+            for (auto const &el : j.at("frames")) {
+                ct.frames.emplace_back(load_call_frame(el));
+            }
+
+            return ct;
+        }
+
     } // namespace
 
     static void from_json(json::json const &j, std::vector<BenchmarkTest> &o)
@@ -78,4 +129,16 @@ namespace monad::test
         return json::json::parse(input).get<std::vector<BenchmarkTest>>();
     }
 
+    std::vector<CorpusTest> load_corpus_tests(std::istream &input)
+    {
+        auto ret = std::vector<CorpusTest>{};
+
+        for (auto const &elem_it : json::json::parse(input).items()) {
+            ret.emplace_back(
+                load_corpus_test_case(elem_it.key(), elem_it.value()));
+        }
+
+        return ret;
+    }
+
 } // namespace monad::test
@@ -0,0 +1,102 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "hardware_counters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+
+namespace monad::test
+{
+    namespace
+    {
+        int open_counter(std::uint64_t const config, int const group_fd)
+        {
+            auto attr = perf_event_attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = config;
+            attr.disabled = group_fd == -1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            return static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+        }
+    }
+
+    HardwareCounters::HardwareCounters()
+        : leader_fd_{open_counter(PERF_COUNT_HW_INSTRUCTIONS, -1)}
+        , cache_misses_fd_{-1}
+    {
+        if (leader_fd_ == -1) {
+            return;
+        }
+
+        cache_misses_fd_ = open_counter(PERF_COUNT_HW_CACHE_MISSES, leader_fd_);
+        if (cache_misses_fd_ == -1) {
+            close(leader_fd_);
+            leader_fd_ = -1;
+            return;
+        }
+
+        ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    }
+
+    HardwareCounters::~HardwareCounters()
+    {
+        if (available()) {
+            close(cache_misses_fd_);
+            close(leader_fd_);
+        }
+    }
+
+    bool HardwareCounters::available() const noexcept
+    {
+        return leader_fd_ != -1;
+    }
+
+    void HardwareCounters::start() noexcept
+    {
+        if (available()) {
+            ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    void HardwareCounters::stop() noexcept
+    {
+        if (available()) {
+            ioctl(leader_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    HardwareCounters::Sample HardwareCounters::read() const noexcept
+    {
+        // With PERF_FORMAT_GROUP the leader reads as {nr, values[nr]}.
+        auto buf = std::array<std::uint64_t, 3>{};
+        if (!available() ||
+            ::read(leader_fd_, buf.data(), sizeof(buf)) !=
+                static_cast<ssize_t>(sizeof(buf))) {
+            return {0, 0};
+        }
+        return {buf[1], buf[2]};
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace monad::test
+{
+    // Counts retired instructions and last-level cache misses of the calling
+    // thread with `perf_event_open`. Counting is in user space only so that it
+    // works at the default `perf_event_paranoid` level; if the counters still
+    // cannot be opened (e.g. in a container), `available` returns false and
+    // every read returns zero.
+    class HardwareCounters
+    {
+    public:
+        struct Sample
+        {
+            std::uint64_t instructions;
+            std::uint64_t cache_misses;
+        };
+
+        HardwareCounters();
+        ~HardwareCounters();
+
+        HardwareCounters(HardwareCounters const &) = delete;
+        HardwareCounters &operator=(HardwareCounters const &) = delete;
+
+        bool available() const noexcept;
+
+        // Counts accumulate across start/stop pairs, so that the untimed setup
+        // of each benchmark iteration can be excluded.
+        void start() noexcept;
+        void stop() noexcept;
+
+        Sample read() const noexcept;
+
+    private:
+        int leader_fd_;
+        int cache_misses_fd_;
+    };
+}
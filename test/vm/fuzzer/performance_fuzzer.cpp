@@ -0,0 +1,381 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Performance fuzzer: runs generated programs in the interpreter and as
+// native code, and reports the programs on which native code is slower than
+// the interpreter, or which take disproportionately long to compile. The
+// reported programs can be saved in the layout of the execution benchmarks,
+// to keep them as regression benchmarks.
+
+#include <category/vm/code.hpp>
+#include <category/vm/core/assert.h>
+#include <category/vm/evm/switch_traits.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/fuzzing/generator/choice.hpp>
+#include <category/vm/fuzzing/generator/generator.hpp>
+#include <category/vm/interpreter/intercode.hpp>
+#include <category/vm/vm.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace monad;
+using namespace monad::vm;
+using namespace monad::vm::fuzzing;
+
+namespace fs = std::filesystem;
+
+using random_engine_t = std::mt19937_64;
+
+namespace
+{
+    struct arguments
+    {
+        using seed_t = random_engine_t::result_type;
+        static constexpr seed_t default_seed =
+            std::numeric_limits<seed_t>::max();
+
+        std::int64_t iterations_per_run = 100;
+        seed_t seed = default_seed;
+        std::size_t runs = std::numeric_limits<std::size_t>::max();
+        evmc_revision revision = EVMC_PRAGUE;
+        std::int64_t gas = 10'000'000;
+        std::size_t repetitions = 5;
+        double max_slowdown = 1.0;
+        std::int64_t min_interpreter_ns = 20'000;
+        double max_compile_factor = 10.0;
+        std::size_t min_compile_size = 256;
+        fs::path corpus;
+
+        void set_random_seed_if_default()
+        {
+            if (seed == default_seed) {
+                seed = std::random_device()();
+            }
+        }
+    };
+
+    struct measurement
+    {
+        std::size_t size;
+        std::int64_t compile_ns;
+        std::int64_t interpreter_ns;
+        std::int64_t native_ns;
+        evmc_status_code status;
+    };
+}
+
+static arguments parse_args(int const argc, char **const argv)
+{
+    auto app = CLI::App("Monad VM Performance Fuzzer");
+    auto args = arguments{};
+
+    app.add_option(
+        "-i,--iterations-per-run",
+        args.iterations_per_run,
+        "Number of programs generated in each run (default 100)");
+
+    app.add_option(
+        "--seed",
+        args.seed,
+        "Seed to use for reproducible fuzzing (random by default)");
+
+    app.add_option(
+        "-r,--runs", args.runs, "Number of runs (unbounded by default)");
+
+    app.add_option(
+        "--gas", args.gas, "Gas limit of each execution (default 10000000)");
+
+    app.add_option(
+        "--repetitions",
+        args.repetitions,
+        "Executions of each program per implementation, of which the "
+        "fastest is kept (default 5)");
+
+    app.add_option(
+        "--max-slowdown",
+        args.max_slowdown,
+        "Report programs whose native code takes more than this many times "
+        "the interpreter time (default 1.0)");
+
+    app.add_option(
+        "--min-interpreter-ns",
+        args.min_interpreter_ns,
+        "Ignore the slowdown of programs interpreted faster than this, "
+        "whose timings are mostly noise (default 20000)");
+
+    app.add_option(
+        "--max-compile-factor",
+        args.max_compile_factor,
+        "Report programs whose compile time per byte exceeds this many "
+        "times the median of the run (default 10.0)");
+
+    app.add_option(
+        "--min-compile-size",
+        args.min_compile_size,
+        "Ignore the compile time of programs smaller than this many bytes "
+        "(default 256)");
+
+    app.add_option(
+        "--corpus",
+        args.corpus,
+        "Directory to save reported programs to, as execution benchmarks");
+
+    auto const rev_map = std::map<std::string, evmc_revision>{
+        {"FRONTIER", EVMC_FRONTIER},
+        {"HOMESTEAD", EVMC_HOMESTEAD},
+        {"TANGERINE_WHISTLE", EVMC_TANGERINE_WHISTLE},
+        {"TANGERINE WHISTLE", EVMC_TANGERINE_WHISTLE},
+        {"SPURIOUS_DRAGON", EVMC_SPURIOUS_DRAGON},
+        {"SPURIOUS DRAGON", EVMC_SPURIOUS_DRAGON},
+        {"BYZANTIUM", EVMC_BYZANTIUM},
+        {"CONSTANTINOPLE", EVMC_CONSTANTINOPLE},
+        {"PETERSBURG", EVMC_PETERSBURG},
+        {"ISTANBUL", EVMC_ISTANBUL},
+        {"BERLIN", EVMC_BERLIN},
+        {"LONDON", EVMC_LONDON},
+        {"PARIS", EVMC_PARIS},
+        {"SHANGHAI", EVMC_SHANGHAI},
+        {"CANCUN", EVMC_CANCUN},
+        {"PRAGUE", EVMC_PRAGUE},
+        {"OSAKA", EVMC_OSAKA},
+        {"LATEST", EVMC_LATEST_STABLE_REVISION}};
+    app.add_option(
+           "--revision",
+           args.revision,
+           std::format(
+               "Set EVM revision (default: {})",
+               evmc_revision_to_string(args.revision)))
+        ->transform(CLI::CheckedTransformer(rev_map, CLI::ignore_case))
+        ->option_text("TEXT");
+
+    try {
+        app.parse(argc, argv);
+    }
+    catch (CLI::ParseError const &e) {
+        std::exit(app.exit(e));
+    }
+
+    args.set_random_seed_if_default();
+    return args;
+}
+
+template <typename F>
+static std::int64_t fastest_ns(std::size_t const repetitions, F &&f)
+{
+    auto best = std::numeric_limits<std::int64_t>::max();
+    for (auto i = 0u; i < std::max(repetitions, std::size_t{1}); ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        auto const end = std::chrono::steady_clock::now();
+        best = std::min(
+            best,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+    }
+    return best;
+}
+
+// Returns nothing if the program could not be compiled.
+template <Traits traits>
+static std::optional<measurement> measure(
+    VM &vm, std::vector<std::uint8_t> const &program, arguments const &args)
+{
+    auto const icode = make_shared_intercode(program);
+
+    SharedNativecode ncode;
+    auto const compile_ns = fastest_ns(1, [&] {
+        ncode = vm.compiler().compile<traits>(icode);
+    });
+    if (ncode->entrypoint() == nullptr) {
+        return std::nullopt;
+    }
+
+    auto msg = evmc_message{};
+    msg.gas = args.gas;
+    msg.recipient = evmc::address{0xc0de};
+    msg.code_address = msg.recipient;
+
+    // Each execution gets its own host, so that no execution starts with
+    // warm accounts or storage left by the previous one.
+    auto status = EVMC_SUCCESS;
+    auto const interpreter_ns = fastest_ns(args.repetitions, [&] {
+        evmc::MockedHost host;
+        status = vm.execute_intercode_raw<traits>(
+                       &host.get_interface(), host.to_context(), &msg, icode)
+                     .status_code;
+    });
+    auto const native_ns = fastest_ns(args.repetitions, [&] {
+        evmc::MockedHost host;
+        (void)vm.execute_native_entrypoint_raw(
+            &host.get_interface(),
+            host.to_context(),
+            &msg,
+            icode,
+            ncode->entrypoint());
+    });
+
+    return measurement{
+        .size = program.size(),
+        .compile_ns = compile_ns,
+        .interpreter_ns = interpreter_ns,
+        .native_ns = native_ns,
+        .status = status};
+}
+
+static std::optional<measurement> measure(
+    evmc_revision const rev, VM &vm, std::vector<std::uint8_t> const &program,
+    arguments const &args)
+{
+    SWITCH_EVM_TRAITS(measure, vm, program, args);
+    MONAD_VM_ASSERT(false);
+}
+
+static double median(std::vector<double> values)
+{
+    MONAD_VM_ASSERT(!values.empty());
+    auto const mid = values.begin() + static_cast<long>(values.size() / 2);
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+}
+
+static void save_to_corpus(
+    fs::path const &corpus, std::string const &name,
+    std::vector<std::uint8_t> const &program)
+{
+    auto const dir = corpus / name;
+    fs::create_directories(dir);
+    std::ofstream contract{dir / "contract", std::ios::binary};
+    contract.write(
+        reinterpret_cast<char const *>(program.data()),
+        static_cast<std::streamsize>(program.size()));
+    std::ofstream const calldata{dir / "calldata", std::ios::binary};
+}
+
+static void report(
+    std::string_view const reason, arguments const &args, std::int64_t const i,
+    measurement const &m, std::vector<std::uint8_t> const &program)
+{
+    std::cout << std::format(
+        "{},{},{},{},{},{},{}\n",
+        reason,
+        args.seed,
+        i,
+        m.size,
+        m.compile_ns,
+        m.interpreter_ns,
+        m.native_ns);
+    // The execution benchmarks expect their programs to succeed.
+    if (!args.corpus.empty() && m.status == EVMC_SUCCESS) {
+        auto const name = std::format("{}_{}_{}", reason, args.seed, i);
+        save_to_corpus(args.corpus, name, program);
+    }
+}
+
+static void do_run(std::size_t const run_index, arguments const &args)
+{
+    auto const rev = args.revision;
+
+    auto engine = random_engine_t(args.seed);
+    auto vm = VM{};
+
+    auto compile_ns_per_byte = std::vector<double>{};
+    auto ratios = std::vector<double>{};
+    auto reported = std::size_t{0};
+
+    for (auto i = 0; i < args.iterations_per_run; ++i) {
+        auto const focus = discrete_choice<GeneratorFocus>(
+            engine,
+            [](auto &) { return GeneratorFocus::Generic; },
+            Choice(0.60, [](auto &) { return GeneratorFocus::Pow2; }),
+            Choice(0.05, [](auto &) { return GeneratorFocus::DynJump; }));
+
+        auto const program = generate_program(focus, engine, rev, {});
+        if (program.empty() ||
+            program.size() > *interpreter::code_size_t::max()) {
+            continue;
+        }
+
+        auto const m = measure(rev, vm, program, args);
+        if (!m) {
+            continue;
+        }
+
+        auto const per_byte = static_cast<double>(m->compile_ns) /
+                              static_cast<double>(m->size);
+        if (m->size >= args.min_compile_size &&
+            compile_ns_per_byte.size() >= 32 &&
+            per_byte > args.max_compile_factor * median(compile_ns_per_byte)) {
+            report("compile_time", args, i, *m, program);
+            ++reported;
+        }
+        compile_ns_per_byte.push_back(per_byte);
+
+        if (m->interpreter_ns >= args.min_interpreter_ns) {
+            auto const ratio = static_cast<double>(m->native_ns) /
+                               static_cast<double>(m->interpreter_ns);
+            ratios.push_back(ratio);
+            if (ratio > args.max_slowdown) {
+                report("native_slowdown", args, i, *m, program);
+                ++reported;
+            }
+        }
+    }
+
+    std::cerr << std::format(
+        "[{}]: {} programs, median compile time {:.1f}ns / byte, median "
+        "native / interpreter time {:.3f}, {} reported\n",
+        run_index + 1,
+        compile_ns_per_byte.size(),
+        compile_ns_per_byte.empty() ? 0.0 : median(compile_ns_per_byte),
+        ratios.empty() ? 0.0 : median(ratios),
+        reported);
+}
+
+int main(int argc, char **argv)
+{
+    auto args = parse_args(argc, argv);
+    auto const *msg_rev = evmc_revision_to_string(args.revision);
+    std::cout << "reason,seed,iteration,size,compile_ns,interpreter_ns,"
+                 "native_ns\n";
+    for (auto i = 0u; i < args.runs; ++i) {
+        std::cerr << std::format(
+            "Fuzzing performance with seed @ {}: {}\n", msg_rev, args.seed);
+        do_run(i, args);
+        args.seed = random_engine_t(args.seed)();
+    }
+    return 0;
+}
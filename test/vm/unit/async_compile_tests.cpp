@@ -29,7 +29,9 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_set>
 #include <utility>
@@ -151,3 +153,85 @@ TEST(async_compile_test, disable)
         ASSERT_TRUE(entry == nullptr);
     }
 }
+
+TEST(async_compile_test, thread_pool)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    constexpr uint64_t N = 64;
+
+    Compiler compiler{true, N, 4};
+
+    for (uint64_t i = 0; i < N; ++i) {
+        ASSERT_TRUE(compiler.async_compile<traits>(
+            test_hash(i), make_shared_intercode(test_code(i))));
+    }
+
+    compiler.debug_wait_for_empty_queue();
+
+    for (uint64_t i = 0; i < N; ++i) {
+        auto const vcode = compiler.find_varcode(test_hash(i));
+        ASSERT_TRUE(vcode.has_value());
+        auto const &ncode = (*vcode)->nativecode();
+        ASSERT_TRUE(!!ncode);
+        auto const entry = ncode->entrypoint();
+        ASSERT_TRUE(entry != nullptr);
+
+        auto ctx = runtime::Context::empty();
+        ctx.gas_remaining = 100;
+        entry(&ctx, nullptr);
+        ASSERT_EQ(ctx.result.status, runtime::StatusCode::Success);
+        ASSERT_EQ(uint256_t::load_le(ctx.result.offset), i);
+    }
+}
+
+TEST(async_compile_test, priority)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    Compiler compiler{true, 1000, 1};
+
+    std::mutex order_mutex;
+    std::vector<uint64_t> order;
+    std::promise<void> started;
+    std::promise<void> release;
+    auto const released = release.get_future().share();
+
+    auto const config = [&](uint64_t index) {
+        CompilerConfig config;
+        config.code_image_hook = [&, index](auto const &) {
+            {
+                std::lock_guard const lock{order_mutex};
+                order.push_back(index);
+            }
+            if (index == 0) {
+                started.set_value();
+                released.wait();
+            }
+        };
+        return config;
+    };
+    auto const submit = [&](uint64_t index, uint64_t priority) {
+        return compiler.async_compile<traits>(
+            test_hash(index),
+            make_shared_intercode(test_code(index)),
+            config(index),
+            priority);
+    };
+
+    // Keep the only compile thread busy while the other jobs are queued.
+    ASSERT_TRUE(submit(0, 0));
+    started.get_future().wait();
+    ASSERT_TRUE(submit(1, 10));
+    ASSERT_TRUE(submit(2, 40));
+    ASSERT_TRUE(submit(3, 20));
+    ASSERT_TRUE(submit(4, 30));
+    // Not hot enough to be moved up.
+    ASSERT_FALSE(submit(4, 50));
+    // Moved up to the front.
+    ASSERT_TRUE(submit(1, 100));
+    release.set_value();
+
+    compiler.debug_wait_for_empty_queue();
+    EXPECT_EQ(order, (std::vector<uint64_t>{0, 1, 2, 4, 3}));
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/deploy_policy.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace monad::vm;
+
+TEST(DeployPolicy, allowed_factory)
+{
+    DeployPolicy policy{0};
+    evmc::address const factory{1};
+    evmc::address const other{2};
+    policy.allow_factory(factory);
+
+    EXPECT_TRUE(policy.on_deploy(factory));
+    EXPECT_TRUE(policy.on_deploy(factory));
+    EXPECT_FALSE(policy.on_deploy(other));
+    EXPECT_EQ(policy.size(), 1);
+}
+
+TEST(DeployPolicy, factory_threshold)
+{
+    DeployPolicy policy{3};
+    evmc::address const factory{1};
+
+    for (uint64_t i = 0; i < 3; ++i) {
+        EXPECT_FALSE(policy.on_deploy(factory));
+    }
+    EXPECT_TRUE(policy.on_deploy(factory));
+    EXPECT_TRUE(policy.on_deploy(factory));
+    EXPECT_FALSE(policy.on_deploy(evmc::address{2}));
+}
+
+TEST(DeployPolicy, max_factories)
+{
+    DeployPolicy policy{1, 2};
+
+    EXPECT_FALSE(policy.on_deploy(evmc::address{1}));
+    EXPECT_FALSE(policy.on_deploy(evmc::address{2}));
+    EXPECT_FALSE(policy.on_deploy(evmc::address{3}));
+    EXPECT_EQ(policy.size(), 2);
+
+    EXPECT_TRUE(policy.on_deploy(evmc::address{1}));
+    EXPECT_FALSE(policy.on_deploy(evmc::address{3}));
+}
@@ -959,6 +959,44 @@ TEST(Emitter, gas_decrement_static_work_no_check_2)
     ASSERT_EQ(ret.status, runtime::StatusCode::Error);
 }
 
+TEST(Emitter, gas_decrement_static_work_entry_work_check)
+{
+    asmjit::JitRuntime rt;
+    TestEmitter emit{rt, code_size_t{}};
+    emit.gas_decrement_static_work(
+        1, Emitter::STATIC_WORK_GAS_CHECK_THRESHOLD - 1);
+    emit.stop();
+
+    entrypoint_t entry = emit.finish_contract(rt);
+    auto ctx = test_context(0);
+    auto const &ret = ctx.result;
+
+    entry(&ctx, nullptr);
+
+    ASSERT_EQ(ctx.gas_remaining, -1);
+    ASSERT_EQ(ret.status, runtime::StatusCode::Error);
+}
+
+TEST(Emitter, gas_decrement_static_work_entry_work_no_check)
+{
+    asmjit::JitRuntime rt;
+    TestEmitter emit{rt, code_size_t{}};
+    emit.gas_decrement_static_work(
+        Emitter::STATIC_WORK_GAS_CHECK_THRESHOLD - 1);
+    emit.gas_decrement_static_work(1, 0);
+    ASSERT_EQ(emit.accumulated_static_work(), 1);
+    emit.stop();
+
+    entrypoint_t entry = emit.finish_contract(rt);
+    auto ctx = test_context(Emitter::STATIC_WORK_GAS_CHECK_THRESHOLD - 1);
+    auto const &ret = ctx.result;
+
+    entry(&ctx, nullptr);
+
+    ASSERT_EQ(ctx.gas_remaining, -1);
+    ASSERT_EQ(ret.status, runtime::StatusCode::Success);
+}
+
 TEST(Emitter, gas_decrement_static_work_check_non_negative_1)
 {
     asmjit::JitRuntime rt;
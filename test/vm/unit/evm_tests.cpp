@@ -20,6 +20,8 @@
 #include <category/vm/compiler/types.hpp>
 #include <category/vm/evm/opcodes.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/execute.hpp>
+#include <category/vm/interpreter/intercode.hpp>
 #include <category/vm/runtime/bin.hpp>
 
 #include <test_resource_data.h>
@@ -398,6 +400,124 @@ TEST_F(EvmTest, LoopOutOfGas)
     ASSERT_EQ(result_.status_code, EVMC_FAILURE);
 }
 
+TEST_F(EvmTest, LoopRegisterEntry)
+{
+    // Sums the numbers from 10 down to 1. The loop header at offset 4 is
+    // entered by a static back-edge jump, passing the top two stack
+    // elements in AVX registers.
+    std::vector<uint8_t> const code{
+        PUSH1, 0x00, PUSH1, 0x0a, JUMPDEST, SWAP1, DUP2, ADD, SWAP1, DUP1,
+        ISZERO, PUSH1, 0x15, JUMPI, PUSH1, 0x01, SWAP1, SUB, PUSH1, 0x04,
+        JUMP, JUMPDEST, POP, PUSH0, MSTORE, PUSH1, 0x20, PUSH0, RETURN};
+
+    execute_and_compare(100'000, code);
+
+    execute(100'000, code);
+    ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result_.output_size, 32);
+    ASSERT_EQ(result_.output_data[31], 55);
+}
+
+TEST_F(EvmTest, EntryLiteralReturnAddress)
+{
+    // Calls the internal function at offset 8, which increments its argument
+    // and returns to the address at offset 14 pushed by the caller. The
+    // return jump is resolved statically from the entry literal.
+    std::vector<uint8_t> const code{
+        PUSH1, 0x2a, PUSH1, 0x0e, SWAP1, PUSH1, 0x08, JUMP, JUMPDEST,
+        PUSH1, 0x01, ADD, SWAP1, JUMP, JUMPDEST, PUSH0, MSTORE, PUSH1,
+        0x20, PUSH0, RETURN};
+
+    execute_and_compare(100'000, code);
+
+    execute(100'000, code);
+    ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result_.output_size, 32);
+    ASSERT_EQ(result_.output_data[31], 0x2b);
+}
+
+TEST_F(EvmTest, NarrowOperands)
+{
+    std::vector<uint8_t> const calldata{0x01, 0x02, 0x03};
+
+    // The operands below 2^64 only need the low limb.
+    std::vector<uint8_t> const bitwise{
+        CALLDATASIZE, CALLDATASIZE, ADD, CALLDATASIZE, OR, CALLDATASIZE,
+        XOR, PUSH0, MSTORE, PUSH1, 0x20, PUSH0, RETURN};
+
+    execute_and_compare(100'000, bitwise, calldata);
+
+    execute(100'000, bitwise, calldata);
+    ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result_.output_size, 32);
+    ASSERT_EQ(result_.output_data[31], 4);
+
+    // The carry out of the low limb reaches the second limb.
+    std::vector<uint8_t> const carry{
+        PUSH8, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        CALLDATASIZE, ADD, PUSH0, MSTORE, PUSH1, 0x20, PUSH0, RETURN};
+
+    execute_and_compare(100'000, carry, calldata);
+
+    execute(100'000, carry, calldata);
+    ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result_.output_size, 32);
+    ASSERT_EQ(result_.output_data[23], 1);
+    ASSERT_EQ(result_.output_data[31], 2);
+}
+
+TEST_F(EvmTest, InterpreterFallback)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    // The entry block computes 3 and jumps to the block at offset 8, which
+    // multiplies by 3 and returns the result.
+    std::vector<uint8_t> const code{
+        PUSH1, 0x01, PUSH1, 0x02, ADD, PUSH1, 0x08, JUMP, JUMPDEST,
+        PUSH1, 0x03, MUL, PUSH0, MSTORE, PUSH1, 0x20, PUSH0, RETURN};
+    auto const icode = make_shared_intercode(code);
+
+    auto const run = [&](SharedNativecode const &ncode) {
+        pre_execute(10'000, {});
+        result_ = vm_.execute_native_entrypoint_raw(
+            &host_.get_interface(),
+            host_.to_context(),
+            &msg_,
+            icode,
+            ncode->entrypoint());
+        ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+        ASSERT_EQ(result_.output_size, 32);
+        ASSERT_EQ(result_.output_data[31], 9);
+    };
+
+    auto const full = vm_.compiler().compile<traits>(icode);
+    ASSERT_FALSE(full->partial());
+    run(full);
+    auto const gas_left = result_.gas_left;
+
+    // Only the entry block fits in the budget, so the jump destination
+    // resumes in the interpreter.
+    auto const config = [&](uint32_t budget) {
+        return CompilerConfig{
+            .interpreter_fallback = native::InterpreterFallback{
+                .intercode = icode,
+                .resume = &interpreter::resume<traits>,
+                .compiled_bytecode_budget =
+                    interpreter::code_size_t::unsafe_from(budget)}};
+    };
+    auto const partial = vm_.compiler().compile<traits>(icode, config(1));
+    ASSERT_NE(partial->entrypoint(), nullptr);
+    ASSERT_TRUE(partial->partial());
+    run(partial);
+    ASSERT_EQ(result_.gas_left, gas_left);
+
+    auto const whole = vm_.compiler().compile<traits>(
+        icode, config(static_cast<uint32_t>(code.size())));
+    ASSERT_FALSE(whole->partial());
+    run(whole);
+    ASSERT_EQ(result_.gas_left, gas_left);
+}
+
 TEST_F(EvmTest, ShrCeilOffByOneRegression)
 {
     VM vm{};
@@ -529,6 +649,34 @@ TEST_F(EvmTest, Int32BlockGasOverflow)
     EXPECT_EQ(result_.status_code, EVMC_FAILURE);
 }
 
+TEST_F(EvmTest, FusedInstructionSequences)
+{
+    // Offsets 20, 22 and 30 are the three jump destinations.
+    std::vector<uint8_t> const code = {
+        PUSH1, 5,        PUSH1,    3,     ADD,    PUSH1, 9,
+        DUP2,  DUP2,     LT,       PUSH2, 0,      20,    JUMPI,
+        SWAP1, POP,      PUSH2,    0,     22,     JUMP,  JUMPDEST,
+        0x0C,  JUMPDEST, PUSH1,    1,     PUSH2,  0,     30,
+        JUMPI, 0x0D,     JUMPDEST, PUSH0, MSTORE, PUSH1, 32,
+        PUSH0, RETURN};
+
+    for (auto const impl : {Compiler, Interpreter, Evmone}) {
+        execute(1'000'000, code, {}, impl);
+        ASSERT_EQ(result_.status_code, EVMC_SUCCESS);
+        ASSERT_EQ(result_.gas_left, 1'000'000 - 81);
+        ASSERT_EQ(result_.output_size, 32);
+        ASSERT_EQ(result_.output_data[31], 9);
+    }
+}
+
+TEST_F(EvmTest, FusedOpCodeValuesAreInvalid)
+{
+    for (uint8_t const op : {0x0C, 0x0D, 0x0E, 0x0F, 0x21}) {
+        execute({PUSH0, PUSH0, op}, {}, Interpreter);
+        ASSERT_NE(result_.status_code, EVMC_SUCCESS);
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     EvmTest, EvmFile,
     ::testing::ValuesIn(std::vector<fs::directory_entry>{
@@ -0,0 +1,156 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/execution_sampler.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+using namespace monad::vm;
+
+namespace
+{
+    std::filesystem::path temp_file()
+    {
+        std::string tmpl =
+            (std::filesystem::temp_directory_path() / "sampler_XXXXXX")
+                .string();
+        int const fd = mkstemp(tmpl.data());
+        EXPECT_GE(fd, 0);
+        close(fd);
+        return tmpl;
+    }
+
+    void run_for(std::chrono::milliseconds const duration)
+    {
+        auto const end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    }
+}
+
+TEST(ExecutionSampler, samples_nested_frames)
+{
+    ExecutionSampler sampler{std::chrono::microseconds{100}};
+    evmc::bytes32 const caller{1};
+    evmc::bytes32 const callee{2};
+    {
+        ExecutionSampler::Frame const outer{sampler, caller, true};
+        run_for(std::chrono::milliseconds{20});
+        {
+            ExecutionSampler::Frame const inner{sampler, callee, false};
+            run_for(std::chrono::milliseconds{20});
+        }
+        run_for(std::chrono::milliseconds{20});
+    }
+
+    auto const entries = sampler.entries();
+    ASSERT_EQ(entries.size(), 2);
+    for (auto const &e : entries) {
+        if (e.code_hash == caller) {
+            EXPECT_GT(e.native_samples, 0);
+            EXPECT_EQ(e.interpreter_samples, 0);
+        }
+        else {
+            EXPECT_EQ(e.code_hash, callee);
+            EXPECT_EQ(e.native_samples, 0);
+            EXPECT_GT(e.interpreter_samples, 0);
+        }
+    }
+
+    EXPECT_EQ(sampler.take_block_entries().size(), 2);
+    EXPECT_TRUE(sampler.take_block_entries().empty());
+    EXPECT_EQ(sampler.entries().size(), 2);
+}
+
+TEST(ExecutionSampler, frames_of_interleaved_fibers)
+{
+    ExecutionSampler sampler{std::chrono::microseconds{100}};
+    evmc::bytes32 const first{1};
+    evmc::bytes32 const second{2};
+    // Two fibers on the thread, the first exiting its frame while the
+    // second is inside its own
+    std::optional<ExecutionSampler::Frame> frame1;
+    frame1.emplace(sampler, first, true);
+    std::optional<ExecutionSampler::Frame> frame2;
+    frame2.emplace(sampler, second, true);
+    frame1.reset();
+    sampler.take_block_entries();
+    run_for(std::chrono::milliseconds{20});
+    auto const entries = sampler.take_block_entries();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.front().code_hash, second);
+
+    frame2.reset();
+    sampler.take_block_entries();
+    run_for(std::chrono::milliseconds{20});
+    EXPECT_TRUE(sampler.take_block_entries().empty());
+}
+
+TEST(ExecutionSampler, frame_exited_on_another_thread)
+{
+    ExecutionSampler sampler{std::chrono::microseconds{100}};
+    std::optional<ExecutionSampler::Frame> frame;
+    frame.emplace(sampler, evmc::bytes32{1}, true);
+    // A fiber moved to another thread removes its frame from the thread
+    // it entered it on
+    std::thread{[&frame] { frame.reset(); }}.join();
+    sampler.take_block_entries();
+    run_for(std::chrono::milliseconds{20});
+    EXPECT_TRUE(sampler.take_block_entries().empty());
+}
+
+TEST(ExecutionSampler, idle_thread_is_not_sampled)
+{
+    ExecutionSampler sampler{std::chrono::microseconds{100}};
+    {
+        ExecutionSampler::Frame const frame{sampler, evmc::bytes32{1}, true};
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    for (auto const &e : sampler.entries()) {
+        EXPECT_EQ(e.code_hash, evmc::bytes32{1});
+    }
+}
+
+TEST(ExecutionSampler, write_folded)
+{
+    ExecutionSampler sampler{std::chrono::microseconds{100}};
+    {
+        ExecutionSampler::Frame const frame{sampler, evmc::bytes32{1}, true};
+        run_for(std::chrono::milliseconds{20});
+    }
+    auto const path = temp_file();
+    ASSERT_TRUE(sampler.write_folded(path));
+
+    std::ifstream in{path};
+    std::string line;
+    ASSERT_TRUE(std::getline(in, line));
+    EXPECT_TRUE(line.starts_with(
+        "evm;0000000000000000000000000000000000000000000000000000000000000001;"
+        "native "));
+    EXPECT_FALSE(std::getline(in, line));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,141 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/hotness_profile.hpp>
+#include <category/vm/varcode_cache.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace monad::vm;
+
+namespace
+{
+    std::filesystem::path temp_file()
+    {
+        std::string tmpl =
+            (std::filesystem::temp_directory_path() / "hotness_XXXXXX")
+                .string();
+        int const fd = mkstemp(tmpl.data());
+        EXPECT_GE(fd, 0);
+        close(fd);
+        return tmpl;
+    }
+}
+
+TEST(HotnessProfile, top_orders_by_gas)
+{
+    HotnessProfile profile;
+    profile.record(evmc::bytes32{1}, 100, 10);
+    profile.record(evmc::bytes32{2}, 300, 0);
+    profile.record(evmc::bytes32{3}, 200, 5);
+    profile.record(evmc::bytes32{1}, 150, 10);
+
+    auto const top = profile.top(2);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0].code_hash, evmc::bytes32{2});
+    EXPECT_EQ(top[1].code_hash, evmc::bytes32{1});
+    EXPECT_EQ(top[1].calls, 2);
+    EXPECT_EQ(top[1].gas, 250);
+    EXPECT_EQ(top[1].interpreted_ns, 20);
+    EXPECT_EQ(profile.top(10).size(), 3);
+}
+
+TEST(HotnessProfile, decay)
+{
+    HotnessProfile profile{std::chrono::milliseconds{20}};
+    profile.record(evmc::bytes32{1}, 1024, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    profile.record(evmc::bytes32{2}, 600, 0);
+
+    auto const top = profile.top(2);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0].code_hash, evmc::bytes32{2});
+    EXPECT_LE(top[1].gas, 256);
+
+    HotnessProfile short_lived{std::chrono::microseconds{1}};
+    short_lived.record(evmc::bytes32{1}, 1, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    short_lived.prune();
+    EXPECT_EQ(short_lived.size(), 0);
+    EXPECT_TRUE(short_lived.top(1).empty());
+}
+
+TEST(HotnessProfile, max_entries)
+{
+    HotnessProfile profile{HotnessProfile::default_half_life, 2};
+    profile.record(evmc::bytes32{1}, 1, 0);
+    profile.record(evmc::bytes32{2}, 1, 0);
+    profile.record(evmc::bytes32{3}, 1, 0);
+    profile.record(evmc::bytes32{1}, 1, 0);
+    EXPECT_EQ(profile.size(), 2);
+    EXPECT_EQ(profile.top(1)[0].code_hash, evmc::bytes32{1});
+}
+
+TEST(HotnessProfile, save_and_load)
+{
+    auto const path = temp_file();
+
+    HotnessProfile profile;
+    profile.record(evmc::bytes32{1}, 100, 7);
+    profile.record(evmc::bytes32{2}, 300, 0);
+    ASSERT_TRUE(profile.save(path));
+
+    HotnessProfile loaded;
+    loaded.record(evmc::bytes32{1}, 50, 1);
+    ASSERT_TRUE(loaded.load(path));
+    auto const top = loaded.top(2);
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0].code_hash, evmc::bytes32{2});
+    EXPECT_EQ(top[1].code_hash, evmc::bytes32{1});
+    EXPECT_EQ(top[1].calls, 2);
+    EXPECT_EQ(top[1].gas, 150);
+    EXPECT_EQ(top[1].interpreted_ns, 8);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(HotnessProfile{}.load(path));
+    EXPECT_FALSE(HotnessProfile{}.load(path.string() + ".missing"));
+    std::filesystem::remove(path);
+}
+
+TEST(VarcodeCache, pinned_survives_eviction)
+{
+    // Each entry weighs 3kB, so the cache holds two at a time.
+    VarcodeCache cache{7, 7, false};
+    auto const icode = make_shared_intercode({0x00});
+    cache.try_set(evmc::bytes32{1}, icode);
+    ASSERT_TRUE(cache.pin(evmc::bytes32{1}));
+    EXPECT_FALSE(cache.pin(evmc::bytes32{9}));
+    for (uint64_t i = 2; i < 10; ++i) {
+        cache.try_set(evmc::bytes32{i}, icode);
+    }
+    EXPECT_FALSE(cache.get(evmc::bytes32{2}).has_value());
+    auto const vcode = cache.get(evmc::bytes32{1});
+    ASSERT_TRUE(vcode.has_value());
+    EXPECT_EQ((*vcode)->intercode(), icode);
+    EXPECT_EQ(cache.pinned_size(), 1);
+}
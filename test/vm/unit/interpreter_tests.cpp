@@ -82,3 +82,75 @@ TEST(Intercode, Jumpdests)
     ASSERT_FALSE(code.is_jumpdest(8));
     ASSERT_FALSE(code.is_jumpdest(3894));
 }
+
+TEST(Intercode, JumpdestsAcrossChunks)
+{
+    // Bytecode with JUMPDESTs inside and outside PUSH immediates, and
+    // immediates crossing every 32 byte boundary.
+    std::vector<std::uint8_t> ops;
+    std::uint32_t state = 1;
+    while (ops.size() < 1000) {
+        state = state * 1103515245 + 12345;
+        auto const r = (state >> 16) & 0xFF;
+        if (r < 64) {
+            ops.push_back(JUMPDEST);
+        }
+        else if (r < 96) {
+            ops.push_back(static_cast<std::uint8_t>(PUSH1 + (r & 31)));
+        }
+        else {
+            ops.push_back(static_cast<std::uint8_t>(r));
+        }
+    }
+
+    std::vector<bool> expected(ops.size(), false);
+    for (auto i = 0u; i < ops.size(); ++i) {
+        if (ops[i] == JUMPDEST) {
+            expected[i] = true;
+        }
+        if (ops[i] >= PUSH1 && ops[i] <= PUSH32) {
+            i += ops[i] - PUSH1 + 1;
+        }
+    }
+
+    auto const code = Intercode(ops);
+    for (auto i = 0u; i < ops.size(); ++i) {
+        ASSERT_EQ(code.is_jumpdest(i), expected[i]) << "pc " << i;
+    }
+}
+
+TEST(Intercode, InstructionsWithoutFusion)
+{
+    auto const code = make_intercode(PUSH1, 0x01, PUSH0, SUB, JUMPDEST);
+    ASSERT_EQ(code.instructions(), code.code());
+}
+
+TEST(Intercode, InstructionsFused)
+{
+    auto const ops = std::vector<std::uint8_t>{
+        PUSH1, ADD,   ADD,   DUP2, DUP2,  LT,   PUSH2, 0x00,
+        0x00,  JUMPI, SWAP1, POP,  PUSH2, 0x00, 0x00,  JUMP,
+        0x0C,  PUSH1, 0x0D,  ADD,  PUSH2, 0x00};
+    auto const code = Intercode(ops);
+    auto const *const instrs = code.instructions();
+
+    ASSERT_NE(instrs, code.code());
+    for (auto i = 0u; i < ops.size(); ++i) {
+        ASSERT_EQ(ops[i], code.code()[i]);
+    }
+
+    ASSERT_EQ(instrs[0], PUSH1_ADD);
+    ASSERT_EQ(instrs[1], ADD);
+    ASSERT_EQ(instrs[2], ADD);
+    ASSERT_EQ(instrs[3], DUP2_DUP2_LT);
+    ASSERT_EQ(instrs[4], DUP2);
+    ASSERT_EQ(instrs[6], PUSH2_JUMPI);
+    ASSERT_EQ(instrs[10], SWAP1_POP);
+    ASSERT_EQ(instrs[12], PUSH2_JUMP);
+    ASSERT_EQ(instrs[16], 0xFE);
+    // Immediate values are never rewritten.
+    ASSERT_EQ(instrs[17], PUSH1_ADD);
+    ASSERT_EQ(instrs[18], 0x0D);
+    // Truncated push at the end of the code.
+    ASSERT_EQ(instrs[20], PUSH2);
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/compiler/ir/instruction.hpp>
+#include <category/vm/compiler/ir/passes.hpp>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/evm/traits.hpp>
+
+#include <evmc/evmc.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+using namespace monad;
+using namespace monad::vm::compiler;
+using namespace monad::vm::compiler::basic_blocks;
+
+namespace
+{
+    using traits = EvmTraits<EVMC_LATEST_STABLE_REVISION>;
+
+    PassConfig const all_passes{
+        .fold_constants = true,
+        .eliminate_dead_stack_ops = true,
+        .resolve_known_jumps = true,
+        .merge_jumpdest_gas_checks = true};
+
+    int64_t total_base_gas(BasicBlocksIR const &ir)
+    {
+        int64_t gas = 0;
+        for (auto const &block : ir.blocks()) {
+            gas += block_base_gas<traits>(block);
+            if (ir.jump_dests().contains(block.offset)) {
+                gas += 1;
+            }
+        }
+        return gas;
+    }
+
+    BasicBlocksIR
+    optimized(std::initializer_list<std::uint8_t> code, PassConfig config)
+    {
+        auto ir = BasicBlocksIR::unsafe_from<traits>(code);
+        run_passes<traits>(ir, config);
+        EXPECT_TRUE(ir.is_valid());
+        return ir;
+    }
+}
+
+TEST(IrPasses, fold_constants)
+{
+    auto const code = {
+        PUSH1, 2, PUSH1, 3, ADD, PUSH1, 4, SWAP1, SUB, PUSH0, MSTORE, STOP};
+    auto const ir = optimized(code, all_passes);
+    ASSERT_EQ(ir.blocks().size(), 1);
+    auto const &instrs = ir.blocks()[0].instrs;
+    ASSERT_EQ(instrs.size(), 3);
+    ASSERT_EQ(instrs[0].opcode(), OpCode::Push);
+    ASSERT_EQ(instrs[0].immediate_value(), 1);
+    ASSERT_EQ(instrs[1].opcode(), OpCode::Push);
+    ASSERT_EQ(instrs[2].opcode(), OpCode::MStore);
+    ASSERT_EQ(
+        total_base_gas(ir),
+        total_base_gas(BasicBlocksIR::unsafe_from<traits>(code)));
+}
+
+TEST(IrPasses, fold_constants_keeps_stack_deltas)
+{
+    // Folding lowers the maximum stack delta of the instructions, but the
+    // stack overflow check of the block must not change.
+    auto const code = {PUSH1, 2, PUSH1, 3, ADD, STOP};
+    auto const ir = optimized(code, all_passes);
+    ASSERT_EQ(ir.blocks()[0].instrs.size(), 1);
+    ASSERT_EQ(
+        ir.blocks()[0].stack_deltas(),
+        BasicBlocksIR::unsafe_from<traits>(code).blocks()[0].stack_deltas());
+}
+
+TEST(IrPasses, eliminate_dead_stack_ops)
+{
+    auto const code = {
+        CALLER, CALLER, PUSH1, 1, POP, SWAP1, SWAP1, DUP1, POP, SSTORE, STOP};
+    auto const ir = optimized(code, {.eliminate_dead_stack_ops = true});
+    auto const &instrs = ir.blocks()[0].instrs;
+    ASSERT_EQ(instrs.size(), 3);
+    ASSERT_EQ(instrs[0].opcode(), OpCode::Caller);
+    ASSERT_EQ(instrs[1].opcode(), OpCode::Caller);
+    ASSERT_EQ(instrs[2].opcode(), OpCode::SStore);
+    ASSERT_EQ(
+        total_base_gas(ir),
+        total_base_gas(BasicBlocksIR::unsafe_from<traits>(code)));
+}
+
+TEST(IrPasses, resolve_known_jumps)
+{
+    auto const code = {
+        PUSH0, PUSH1, 10, JUMPI, PUSH1, 1, PUSH1, 10, JUMPI,
+        CALLER, JUMPDEST, STOP};
+    auto const ir = optimized(code, {.resolve_known_jumps = true});
+    // The `CALLER` block is unreachable after the second `JUMPI` becomes
+    // a `JUMP`.
+    ASSERT_EQ(ir.blocks().size(), 3);
+    ASSERT_EQ(ir.blocks()[0].terminator, Terminator::FallThrough);
+    ASSERT_EQ(ir.blocks()[1].terminator, Terminator::Jump);
+    ASSERT_EQ(ir.jump_dests().at(10), 2);
+    ASSERT_EQ(
+        total_base_gas(ir),
+        total_base_gas(BasicBlocksIR::unsafe_from<traits>(code)) -
+            block_base_gas<traits>(
+                BasicBlocksIR::unsafe_from<traits>(code).block(2)));
+}
+
+TEST(IrPasses, merge_jumpdest_gas_checks)
+{
+    auto const code = {PUSH1, 1, JUMPDEST, POP, CALLER, JUMPDEST, POP, STOP};
+    auto const ir = optimized(code, {.merge_jumpdest_gas_checks = true});
+    ASSERT_EQ(ir.blocks().size(), 1);
+    ASSERT_TRUE(ir.jump_dests().empty());
+    ASSERT_EQ(ir.blocks()[0].instrs.size(), 4);
+    ASSERT_EQ(ir.blocks()[0].terminator, Terminator::Stop);
+    ASSERT_EQ(
+        total_base_gas(ir),
+        total_base_gas(BasicBlocksIR::unsafe_from<traits>(code)));
+}
+
+TEST(IrPasses, merge_jumpdest_gas_checks_dynamic_jump)
+{
+    auto const code = {CALLVALUE, JUMP, JUMPDEST, STOP};
+    auto const ir = optimized(code, {.merge_jumpdest_gas_checks = true});
+    ASSERT_EQ(ir.jump_dests().size(), 1);
+}
+
+TEST(IrPasses, operand_bit_bounds)
+{
+    auto const ir = BasicBlocksIR::unsafe_from<traits>(
+        {CALLDATASIZE,
+         PUSH1,
+         0x0f,
+         AND,
+         CALLER,
+         ADD,
+         ISZERO,
+         PUSH1,
+         0x02,
+         SWAP1,
+         SHL,
+         CALLVALUE,
+         OR,
+         ADD,
+         STOP});
+    ASSERT_EQ(ir.blocks().size(), 1);
+    auto const bounds = operand_bit_bounds(ir.blocks()[0]);
+    ASSERT_EQ(
+        bounds,
+        (std::vector<std::uint16_t>{0, 0, 64, 0, 160, 161, 0, 2, 2, 0, 256,
+                                    256}));
+}
@@ -266,3 +266,29 @@ TEST_F(LruWeightCacheTest, is_consistent)
         current_weight_ = 0;
     }
 }
+
+TEST(LruWeightCache, set_max_weight_evicts_least_recently_used)
+{
+    WeightCache cache{100, std::chrono::nanoseconds{0}};
+    for (Key k = 1; k <= 10; ++k) {
+        ASSERT_TRUE(cache.insert(k, k, 10));
+    }
+    ASSERT_EQ(cache.approx_weight(), 100);
+
+    cache.set_max_weight(35);
+    EXPECT_EQ(cache.max_weight(), 35);
+    EXPECT_EQ(cache.approx_weight(), 30);
+    EXPECT_EQ(cache.size(), 3);
+    for (Key k = 8; k <= 10; ++k) {
+        WeightCache::ConstAccessor acc;
+        EXPECT_TRUE(cache.find(acc, k));
+    }
+
+    // Inserts are bounded by the new maximum, until it is raised again
+    ASSERT_TRUE(cache.insert(11, 11, 10));
+    EXPECT_EQ(cache.approx_weight(), 30);
+    cache.set_max_weight(100);
+    ASSERT_TRUE(cache.insert(12, 12, 10));
+    EXPECT_EQ(cache.approx_weight(), 40);
+    EXPECT_TRUE(cache.unsafe_check_consistent());
+}
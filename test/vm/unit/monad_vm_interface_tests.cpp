@@ -16,11 +16,13 @@
 #include <category/vm/code.hpp>
 #include <category/vm/evm/opcodes.hpp>
 #include <category/vm/host.hpp>
+#include <category/vm/optimizing_tier.hpp>
 #include <category/vm/runtime/types.hpp>
 #include <category/vm/varcode_cache.hpp>
 #include <category/vm/vm.hpp>
 
 #include <asmjit/core/jitruntime.h>
+#include <asmjit/x86.h>
 
 #include <ethash/keccak.hpp>
 
@@ -29,7 +31,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 using namespace monad;
@@ -72,6 +76,42 @@ namespace
         return {bytecode, hash};
     }
 
+    // Optimizing tier whose code jumps into baseline native code.
+    class TrampolineTier : public OptimizingTier
+    {
+        std::atomic<uint64_t> &compile_count_;
+
+    public:
+        explicit TrampolineTier(std::atomic<uint64_t> &compile_count)
+            : compile_count_{compile_count}
+        {
+        }
+
+        SharedNativecode compile(
+            asmjit::JitRuntime &asmjit_rt, evmc_revision const rev,
+            uint64_t const chain_id, SharedIntercode const &icode) override
+        {
+            compile_count_.fetch_add(1, std::memory_order_acq_rel);
+            EXPECT_EQ(rev, EVMC_CANCUN);
+            auto baseline = native::compile<EvmTraits<EVMC_CANCUN>>(
+                asmjit_rt, icode->code(), icode->code_size());
+            EXPECT_NE(baseline->entrypoint(), nullptr);
+
+            asmjit::CodeHolder code;
+            code.init(asmjit_rt.environment(), asmjit_rt.cpuFeatures());
+            asmjit::x86::Assembler as{&code};
+            as.mov(
+                asmjit::x86::rax,
+                reinterpret_cast<uint64_t>(baseline->entrypoint()));
+            as.jmp(asmjit::x86::rax);
+            native::entrypoint_t entry = nullptr;
+            EXPECT_EQ(asmjit_rt.add(&entry, &code), asmjit::kErrorOk);
+            auto const size = baseline->code_size_estimate();
+            return std::make_shared<Nativecode>(
+                asmjit_rt, chain_id, entry, size, std::move(baseline));
+        }
+    };
+
     class HostMock : public Host
     {
         size_t calls_before_exception_;
@@ -201,7 +241,7 @@ TEST(MonadVmInterface, VarcodeCache)
     static uint32_t const warm_cache_kb = 2 * bytecode_cache_weight;
     static uint32_t const max_cache_kb = warm_cache_kb;
 
-    VarcodeCache cache{max_cache_kb, warm_cache_kb};
+    VarcodeCache cache{max_cache_kb, warm_cache_kb, false};
     auto [bytecode0, hash0] = make_bytecode(0);
     ASSERT_EQ(
         VarcodeCache::code_size_to_cache_weight(
@@ -668,3 +708,80 @@ TEST(MonadVmInterface, execute_bytecode)
         }
     }
 }
+
+TEST(MonadVmInterface, optimizing_tier)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    std::atomic<uint64_t> compile_count{0};
+    VM vm;
+    vm.enable_optimizing_tier(
+        std::make_unique<TrampolineTier>(compile_count), 10);
+    evmc::MockedHost host;
+
+    evmc_message msg{};
+    msg.gas = 100;
+
+    auto execute_raw = [&](evmc::bytes32 const &hash,
+                           SharedVarcode const &vcode) {
+        auto result = vm.execute_raw<traits>(
+            &host.get_interface(), host.to_context(), &msg, hash, vcode);
+        ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+        ASSERT_EQ(result.gas_left, 94);
+    };
+
+    auto [bytecode, hash] = make_bytecode(0);
+    auto icode = make_shared_intercode(bytecode);
+    (void)vm.try_insert_varcode(hash, icode);
+    auto const ncode = vm.compiler().cached_compile<traits>(hash, icode);
+    ASSERT_NE(ncode->entrypoint(), nullptr);
+    ASSERT_FALSE(ncode->optimized());
+
+    auto baseline_vcode = vm.find_varcode(hash);
+    ASSERT_TRUE(baseline_vcode.has_value());
+    ASSERT_EQ((*baseline_vcode)->nativecode(), ncode);
+
+    // Below the gas threshold of 10, each call using 6 gas.
+    execute_raw(hash, *baseline_vcode);
+    vm.compiler().debug_wait_for_empty_queue();
+    ASSERT_EQ(compile_count.load(), 0);
+    ASSERT_EQ((*vm.find_varcode(hash))->nativecode(), ncode);
+
+    // Crossing the threshold swaps in the optimized code.
+    execute_raw(hash, *baseline_vcode);
+    vm.compiler().debug_wait_for_empty_queue();
+    ASSERT_EQ(compile_count.load(), 1);
+    auto optimized_vcode = vm.find_varcode(hash);
+    ASSERT_TRUE(optimized_vcode.has_value());
+    ASSERT_NE(*optimized_vcode, *baseline_vcode);
+    ASSERT_TRUE((*optimized_vcode)->nativecode()->optimized());
+
+    // Both the optimized code and the code swapped out still run, and
+    // neither is submitted again.
+    for (size_t i = 0; i < 4; ++i) {
+        execute_raw(hash, *optimized_vcode);
+        execute_raw(hash, *baseline_vcode);
+    }
+    vm.compiler().debug_wait_for_empty_queue();
+    ASSERT_EQ(compile_count.load(), 1);
+
+    // The Monad revisions are not recompiled.
+    auto [monad_bytecode, monad_hash] = make_bytecode(1);
+    auto monad_icode = make_shared_intercode(monad_bytecode);
+    (void)vm.try_insert_varcode(monad_hash, monad_icode);
+    (void)vm.compiler().cached_compile<MonadTraits<MONAD_FOUR>>(
+        monad_hash, monad_icode);
+    auto monad_vcode = vm.find_varcode(monad_hash);
+    ASSERT_TRUE(monad_vcode.has_value());
+    for (size_t i = 0; i < 4; ++i) {
+        auto result = vm.execute_raw<MonadTraits<MONAD_FOUR>>(
+            &host.get_interface(),
+            host.to_context(),
+            &msg,
+            monad_hash,
+            *monad_vcode);
+        ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+    }
+    vm.compiler().debug_wait_for_empty_queue();
+    ASSERT_EQ(compile_count.load(), 1);
+}
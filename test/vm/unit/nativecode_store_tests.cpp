@@ -0,0 +1,182 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/compiler.hpp>
+#include <category/vm/compiler/ir/x86.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/nativecode_store.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <asmjit/x86.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace monad;
+using namespace monad::vm;
+using namespace monad::vm::compiler::native;
+
+namespace
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    // Calls into the runtime, so the image has slots to relocate.
+    SharedIntercode const icode = make_shared_intercode(
+        {PUSH1, 1, PUSH1, 0, SSTORE, PUSH1, 0x20, PUSH1, 0, RETURN});
+
+    evmc::bytes32 const code_hash{0x1234};
+
+    struct NativecodeStoreTest : public testing::Test
+    {
+        std::filesystem::path dir;
+
+        void SetUp() override
+        {
+            std::string tmpl =
+                (std::filesystem::temp_directory_path() / "nativecode_XXXXXX")
+                    .string();
+            ASSERT_NE(mkdtemp(tmpl.data()), nullptr);
+            dir = tmpl;
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(dir);
+        }
+    };
+}
+
+TEST_F(NativecodeStoreTest, save_and_load)
+{
+    NativecodeStore const store{dir};
+    if (!store.enabled()) {
+        GTEST_SKIP() << "binary has no build id";
+    }
+
+    asmjit::JitRuntime rt;
+    std::vector<uint8_t> code;
+    bool saved = false;
+    CompilerConfig config;
+    config.code_image_hook = [&](CodeImage const &image) {
+        EXPECT_FALSE(image.external_function_offsets.empty());
+        code.assign(image.code.begin(), image.code.end());
+        saved = store.save(code_hash, traits::id(), icode, image);
+    };
+    auto const ncode = compile<traits>(
+        rt, icode->code(), icode->code_size(), config);
+    ASSERT_NE(ncode->entrypoint(), nullptr);
+    ASSERT_TRUE(saved);
+
+    // Loaded in the same process, the relocated slots hold the same
+    // addresses, so the whole image must be identical.
+    auto const loaded = store.load(rt, code_hash, traits::id());
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_NE(loaded->entrypoint(), nullptr);
+    EXPECT_NE(loaded->entrypoint(), ncode->entrypoint());
+    EXPECT_EQ(loaded->chain_id(), traits::id());
+    EXPECT_EQ(*loaded->code_size_estimate(), *ncode->code_size_estimate());
+    EXPECT_EQ(
+        std::memcmp(
+            reinterpret_cast<void const *>(loaded->entrypoint()),
+            code.data(),
+            code.size()),
+        0);
+
+    EXPECT_EQ(store.load(rt, code_hash, traits::id() + 1), nullptr);
+    EXPECT_EQ(store.load(rt, evmc::bytes32{1}, traits::id()), nullptr);
+}
+
+TEST_F(NativecodeStoreTest, load_all_drops_damaged_files)
+{
+    NativecodeStore const store{dir};
+    if (!store.enabled()) {
+        GTEST_SKIP() << "binary has no build id";
+    }
+
+    asmjit::JitRuntime rt;
+    CompilerConfig config;
+    config.code_image_hook = [&](CodeImage const &image) {
+        EXPECT_TRUE(store.save(code_hash, traits::id(), icode, image));
+        EXPECT_TRUE(store.save(evmc::bytes32{1}, traits::id(), icode, image));
+    };
+    auto const compiled = compile<traits>(
+        rt, icode->code(), icode->code_size(), config);
+    ASSERT_NE(compiled->entrypoint(), nullptr);
+
+    // Truncate one of the two images.
+    size_t n = 0;
+    for (auto const &entry : std::filesystem::directory_iterator{dir}) {
+        if (n++ == 0) {
+            std::filesystem::resize_file(
+                entry.path(), std::filesystem::file_size(entry.path()) - 1);
+        }
+    }
+    ASSERT_EQ(n, 2);
+
+    std::vector<SharedNativecode> loaded;
+    EXPECT_EQ(
+        store.load_all(
+            rt,
+            [&](evmc::bytes32 const &, SharedIntercode const &x,
+                SharedNativecode const &ncode) {
+                EXPECT_EQ(*x->code_size(), *icode->code_size());
+                EXPECT_EQ(
+                    std::memcmp(x->code(), icode->code(), *x->code_size()),
+                    0);
+                loaded.push_back(ncode);
+            }),
+        1);
+    ASSERT_EQ(loaded.size(), 1);
+    EXPECT_NE(loaded[0]->entrypoint(), nullptr);
+    EXPECT_EQ(
+        std::distance(
+            std::filesystem::directory_iterator{dir},
+            std::filesystem::directory_iterator{}),
+        1);
+}
+
+TEST_F(NativecodeStoreTest, compiler_warm_start)
+{
+    if (!NativecodeStore{dir}.enabled()) {
+        GTEST_SKIP() << "binary has no build id";
+    }
+    {
+        Compiler compiler{false};
+        EXPECT_EQ(compiler.enable_persistent_cache(dir), 0);
+        auto const ncode = compiler.cached_compile<traits>(code_hash, icode);
+        ASSERT_NE(ncode->entrypoint(), nullptr);
+    }
+
+    Compiler compiler{false};
+    EXPECT_EQ(compiler.enable_persistent_cache(dir), 1);
+    auto const vcode = compiler.find_varcode(code_hash);
+    ASSERT_TRUE(vcode.has_value());
+    auto const &ncode = (*vcode)->nativecode();
+    ASSERT_NE(ncode, nullptr);
+    EXPECT_NE(ncode->entrypoint(), nullptr);
+    EXPECT_EQ(ncode->chain_id(), traits::id());
+}
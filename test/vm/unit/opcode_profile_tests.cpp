@@ -0,0 +1,150 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/interpreter/opcode_counts.hpp>
+#include <category/vm/opcode_profile.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+#include <category/vm/vm.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+#include <evmc/mocked_host.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace monad;
+using namespace monad::vm;
+using namespace monad::vm::compiler;
+
+namespace
+{
+    std::filesystem::path temp_file()
+    {
+        std::string tmpl =
+            (std::filesystem::temp_directory_path() / "opcodes_XXXXXX")
+                .string();
+        int const fd = mkstemp(tmpl.data());
+        EXPECT_GE(fd, 0);
+        close(fd);
+        return tmpl;
+    }
+
+    std::string read_file(std::filesystem::path const &path)
+    {
+        std::ifstream in{path};
+        return {std::istreambuf_iterator<char>{in}, {}};
+    }
+
+    uint16_t pair(uint8_t const first, uint8_t const second)
+    {
+        return static_cast<uint16_t>((first << 8) | second);
+    }
+}
+
+TEST(OpcodeCounts, record)
+{
+    interpreter::OpcodeCounts counts;
+    EXPECT_TRUE(counts.empty());
+    counts.record(PUSH1, 100);
+    counts.record(SLOAD, 97);
+    counts.record(PUSH1, 3);
+    counts.finish(0);
+    EXPECT_FALSE(counts.empty());
+
+    EXPECT_EQ(counts.count[PUSH1], 2);
+    EXPECT_EQ(counts.count[SLOAD], 1);
+    EXPECT_EQ(counts.gas[PUSH1], 6);
+    EXPECT_EQ(counts.gas[SLOAD], 94);
+    EXPECT_EQ(counts.pairs.size(), 2);
+    EXPECT_EQ(counts.pairs[pair(PUSH1, SLOAD)], 1);
+    EXPECT_EQ(counts.pairs[pair(SLOAD, PUSH1)], 1);
+}
+
+TEST(OpcodeProfile, sample_period)
+{
+    OpcodeProfile profile{3};
+    std::vector<bool> sampled;
+    for (int i = 0; i < 6; ++i) {
+        sampled.push_back(profile.sample());
+    }
+    EXPECT_EQ(
+        sampled, (std::vector<bool>{true, false, false, true, false, false}));
+    OpcodeProfile every{0};
+    EXPECT_TRUE(every.sample());
+    EXPECT_TRUE(every.sample());
+}
+
+TEST(OpcodeProfile, max_entries)
+{
+    interpreter::OpcodeCounts counts;
+    counts.record(STOP, 0);
+    OpcodeProfile profile{1, 2};
+    profile.record(evmc::bytes32{1}, counts);
+    profile.record(evmc::bytes32{2}, counts);
+    profile.record(evmc::bytes32{3}, counts);
+    profile.record(evmc::bytes32{1}, counts);
+    EXPECT_EQ(profile.size(), 2);
+}
+
+TEST(OpcodeProfile, interpreter)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    VM vm;
+    auto &profile = vm.enable_opcode_profile(1);
+    evmc::MockedHost host;
+    evmc_message msg{};
+    msg.gas = 1000;
+
+    // The interpreter fuses PUSH1 2 ADD, which must still be recorded as
+    // two instructions.
+    std::vector<uint8_t> const code{PUSH1, 1, PUSH1, 2, ADD, 0xfe};
+    evmc::bytes32 const hash{1};
+    auto const vcode =
+        vm.try_insert_varcode(hash, make_shared_intercode(code));
+    for (int i = 0; i < 2; ++i) {
+        auto const result = vm.execute_raw<traits>(
+            &host.get_interface(), host.to_context(), &msg, hash, vcode);
+        ASSERT_EQ(result.status_code, EVMC_INVALID_INSTRUCTION);
+    }
+    ASSERT_EQ(profile.size(), 1);
+
+    auto const path = temp_file();
+    ASSERT_TRUE(profile.save(path));
+    auto const hex = utils::hex_string(hash);
+    auto const csv = read_file(path);
+    EXPECT_EQ(csv.find("code_hash,samples,opcode,next_opcode,count,gas\n"), 0);
+    EXPECT_NE(csv.find(hex + ",2,PUSH1,,4,12\n"), std::string::npos);
+    EXPECT_NE(csv.find(hex + ",2,ADD,,2,6\n"), std::string::npos);
+    // The invalid instruction consumes all the remaining gas.
+    EXPECT_NE(csv.find(hex + ",2,0xfe,,2,1982\n"), std::string::npos);
+    EXPECT_NE(csv.find(hex + ",2,PUSH1,PUSH1,2,\n"), std::string::npos);
+    EXPECT_NE(csv.find(hex + ",2,PUSH1,ADD,2,\n"), std::string::npos);
+    EXPECT_NE(csv.find(hex + ",2,ADD,0xfe,2,\n"), std::string::npos);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,135 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/compiler/ir/x86.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/perf_map.hpp>
+
+#include <evmc/evmc.h>
+#include <evmc/evmc.hpp>
+
+#include <asmjit/x86.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace monad;
+using namespace monad::vm;
+using namespace monad::vm::compiler::native;
+
+namespace
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+
+    std::filesystem::path temp_file()
+    {
+        std::string tmpl =
+            (std::filesystem::temp_directory_path() / "perf_map_XXXXXX")
+                .string();
+        int const fd = mkstemp(tmpl.data());
+        EXPECT_GE(fd, 0);
+        close(fd);
+        return tmpl;
+    }
+
+    std::vector<std::string> read_lines(std::filesystem::path const &path)
+    {
+        std::ifstream in{path};
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}
+
+TEST(PerfMap, add)
+{
+    auto const path = temp_file();
+    {
+        PerfMap map{path};
+        ASSERT_TRUE(map.enabled());
+        map.add(reinterpret_cast<void const *>(0x1000), 0x20, {});
+        map.add(reinterpret_cast<void const *>(0x2000), 0, {});
+    }
+    auto const lines = read_lines(path);
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(
+        lines[0],
+        "1000 20 "
+        "evm_0000000000000000000000000000000000000000000000000000000000000000");
+    std::filesystem::remove(path);
+}
+
+TEST(PerfMap, add_basic_blocks)
+{
+    auto const icode = make_shared_intercode(
+        {PUSH1, 4, JUMP, 0xFE, JUMPDEST, PUSH1, 0, DUP1, RETURN});
+    evmc::bytes32 const code_hash{1};
+    auto const path = temp_file();
+    PerfMap map{path};
+    ASSERT_TRUE(map.enabled());
+
+    asmjit::JitRuntime rt;
+    std::vector<BlockOffset> blocks;
+    uintptr_t base = 0;
+    CompilerConfig config;
+    config.record_block_offsets = true;
+    config.code_image_hook = [&](CodeImage const &image) {
+        blocks = image.block_offsets;
+        base = reinterpret_cast<uintptr_t>(image.code.data());
+        EXPECT_LE(image.blocks_end, image.code.size());
+        map.add(image, code_hash);
+    };
+    auto const ncode =
+        compile<traits>(rt, icode->code(), icode->code_size(), config);
+    ASSERT_NE(ncode->entrypoint(), nullptr);
+
+    ASSERT_GE(blocks.size(), 2);
+    EXPECT_EQ(blocks.front().bytecode_offset, 0);
+    EXPECT_EQ(blocks.back().bytecode_offset, 4);
+    for (size_t i = 1; i < blocks.size(); ++i) {
+        EXPECT_LE(blocks[i - 1].native_offset, blocks[i].native_offset);
+    }
+
+    auto const name = std::format("evm_{:064x}", 1);
+    auto const lines = read_lines(path);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_TRUE(lines.front().ends_with(" " + name));
+    EXPECT_TRUE(lines.back().ends_with(" " + name));
+    auto const block_line =
+        std::format("{:x} ", base + blocks.back().native_offset);
+    bool found = false;
+    for (auto const &line : lines) {
+        if (line.starts_with(block_line)) {
+            EXPECT_TRUE(line.ends_with(" " + name + "_bb4"));
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+    std::filesystem::remove(path);
+}
@@ -15,6 +15,7 @@
 
 #include "fixture.hpp"
 
+#include <category/vm/host.hpp>
 #include <category/vm/runtime/call.hpp>
 #include <category/vm/runtime/keccak.hpp>
 #include <category/vm/runtime/transmute.hpp>
@@ -23,6 +24,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -32,6 +34,120 @@ using namespace monad::vm::runtime;
 using namespace monad::vm::compiler::test;
 using namespace intx;
 
+namespace
+{
+    // Answers calls with a fixed result and counts them; the runtime calls
+    // nothing else of it
+    class CallCountingHost : public vm::Host
+    {
+        evmc_result result_;
+
+    public:
+        int calls = 0;
+
+        explicit CallCountingHost(evmc_result const &result)
+            : result_{result}
+        {
+        }
+
+        evmc::Result call(evmc_message const &) noexcept override
+        {
+            ++calls;
+            return evmc::Result{result_};
+        }
+
+        bool account_exists(evmc::address const &) const noexcept override
+        {
+            return false;
+        }
+
+        evmc::bytes32 get_storage(
+            evmc::address const &,
+            evmc::bytes32 const &) const noexcept override
+        {
+            return {};
+        }
+
+        evmc_storage_status set_storage(
+            evmc::address const &, evmc::bytes32 const &,
+            evmc::bytes32 const &) noexcept override
+        {
+            return EVMC_STORAGE_ASSIGNED;
+        }
+
+        evmc::uint256be
+        get_balance(evmc::address const &) const noexcept override
+        {
+            return {};
+        }
+
+        size_t get_code_size(evmc::address const &) const noexcept override
+        {
+            return 0;
+        }
+
+        evmc::bytes32
+        get_code_hash(evmc::address const &) const noexcept override
+        {
+            return {};
+        }
+
+        size_t copy_code(
+            evmc::address const &, size_t, uint8_t *,
+            size_t) const noexcept override
+        {
+            return 0;
+        }
+
+        bool selfdestruct(
+            evmc::address const &, evmc::address const &) noexcept override
+        {
+            return false;
+        }
+
+        evmc_tx_context get_tx_context() const noexcept override
+        {
+            return {};
+        }
+
+        evmc::bytes32 get_block_hash(int64_t) const noexcept override
+        {
+            return {};
+        }
+
+        void emit_log(
+            evmc::address const &, uint8_t const *, size_t,
+            evmc::bytes32 const[], size_t) noexcept override
+        {
+        }
+
+        evmc_access_status
+        access_account(evmc::address const &) noexcept override
+        {
+            return EVMC_ACCESS_COLD;
+        }
+
+        evmc_access_status access_storage(
+            evmc::address const &, evmc::bytes32 const &) noexcept override
+        {
+            return EVMC_ACCESS_COLD;
+        }
+
+        evmc::bytes32 get_transient_storage(
+            evmc::address const &,
+            evmc::bytes32 const &) const noexcept override
+        {
+            return {};
+        }
+
+        void set_transient_storage(
+            evmc::address const &, evmc::bytes32 const &,
+            evmc::bytes32 const &) noexcept override
+        {
+        }
+    };
+}
+
 TEST_F(RuntimeTest, CallBasic)
 {
     using traits = EvmTraits<EVMC_CANCUN>;
@@ -96,6 +212,29 @@ TEST_F(RuntimeTest, CallFailure)
     ASSERT_EQ(ctx_.gas_remaining, 87500);
 }
 
+TEST_F(RuntimeTest, CallThroughVmHost)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+    auto do_call = wrap(monad::vm::runtime::call<traits>);
+
+    CallCountingHost vm_host{success_result(2000)};
+    ctx_.vm_host = &vm_host;
+    ctx_.gas_remaining = 100000;
+    host_.call_result = failure_result();
+    host_.access_account(address_from_uint256(0));
+
+    auto res = do_call(10000, 0, 0, 0, 0, 0, 32);
+
+    ASSERT_EQ(res, 1);
+    ASSERT_EQ(vm_host.calls, 1);
+    ASSERT_TRUE(host_.recorded_calls.empty());
+    ASSERT_EQ(ctx_.memory.size, 32);
+    for (auto i = 0u; i < 32; ++i) {
+        ASSERT_EQ(ctx_.memory.data[i], i);
+    }
+    ASSERT_EQ(ctx_.gas_remaining, 91997);
+}
+
 TEST_F(RuntimeTest, DelegateCallIstanbul)
 {
     using traits = EvmTraits<EVMC_ISTANBUL>;
@@ -22,6 +22,7 @@
 #include <evmc/evmc.h>
 
 #include <cstdint>
+#include <cstring>
 #include <limits>
 
 using namespace monad;
@@ -323,3 +324,33 @@ TEST_F(RuntimeTest, ReturnDataCopyAll)
         ASSERT_EQ(ctx_.memory.data[i], i);
     }
 }
+
+TEST_F(RuntimeTest, ReturnDataCopyForwarded)
+{
+    auto copy = wrap(returndatacopy);
+
+    for (bool const overwrite : {false, true}) {
+        auto return_data = result_data();
+        ctx_.env.return_data = return_data.data();
+        ctx_.env.return_data_size = return_data.size();
+        ctx_.gas_remaining = 1000;
+        copy(32, 0, 128);
+        if (overwrite) {
+            ctx_.memory.data[32 + 64] ^= 1;
+        }
+
+        ctx_.result.status = StatusCode::Success;
+        uint256_t{32}.store_le(ctx_.result.offset);
+        uint256_t{128}.store_le(ctx_.result.size);
+        auto const result = ctx_.copy_to_evmc_result();
+
+        ASSERT_EQ(result.status_code, EVMC_SUCCESS);
+        ASSERT_EQ(result.output_size, 128);
+        ASSERT_EQ(
+            std::memcmp(result.output_data, ctx_.memory.data + 32, 128), 0);
+        // returned unchanged, the return data is handed on as the output
+        ASSERT_EQ(result.output_data == return_data.data(), !overwrite);
+        ASSERT_EQ(ctx_.env.return_data == nullptr, !overwrite);
+        ctx_.env.clear_return_data();
+    }
+}
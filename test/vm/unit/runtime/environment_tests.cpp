@@ -60,3 +60,42 @@ TEST_F(RuntimeTest, BlobHash)
     ASSERT_EQ(call(blobhash, 2), 0);
     ASSERT_EQ(call(blobhash, 3), 0);
 }
+
+TEST_F(RuntimeTest, ContextFromParent)
+{
+    auto const msg = evmc_message{
+        .kind = EVMC_CALL,
+        .flags = 0,
+        .depth = ctx_.env.depth + 1,
+        .gas = 5000,
+        .recipient = 0x0000000000000000000000000000000000000002_address,
+        .sender = ctx_.env.recipient,
+        .input_data = call_data_.data(),
+        .input_size = 32,
+        .value = {},
+        .create2_salt = {},
+        .code_address = 0x0000000000000000000000000000000000000002_address,
+        .code = nullptr,
+        .code_size = 0,
+    };
+
+    auto const child =
+        Context::from_parent(ctx_, &msg, {code_.data(), code_.size()});
+
+    ASSERT_EQ(child.host, ctx_.host);
+    ASSERT_EQ(child.context, ctx_.context);
+    ASSERT_EQ(child.gas_remaining, 5000);
+    ASSERT_EQ(child.env.depth, ctx_.env.depth + 1);
+    ASSERT_EQ(child.env.recipient, msg.recipient);
+    ASSERT_EQ(child.env.input_data_size, 32);
+    ASSERT_EQ(child.env.code_size, code_.size());
+    ASSERT_EQ(child.memory.size, 0);
+    ASSERT_NE(child.memory.data, ctx_.memory.data);
+    ASSERT_EQ(
+        child.env.tx_context.blob_hashes, ctx_.env.tx_context.blob_hashes);
+    ASSERT_EQ(
+        child.env.tx_context.blob_hashes_count,
+        ctx_.env.tx_context.blob_hashes_count);
+    ASSERT_EQ(
+        child.env.tx_context.block_number, ctx_.env.tx_context.block_number);
+}
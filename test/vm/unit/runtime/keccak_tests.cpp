@@ -17,8 +17,14 @@
 
 #include <category/vm/runtime/keccak.hpp>
 #include <category/vm/runtime/memory.hpp>
+#include <category/vm/runtime/types.hpp>
 #include <category/vm/runtime/uint256.hpp>
 
+#include <ethash/keccak.hpp>
+
+#include <array>
+#include <cstdint>
+
 using namespace monad::vm::runtime;
 using namespace monad::vm::compiler::test;
 
@@ -53,3 +59,43 @@ TEST_F(RuntimeTest, KeccakExpand)
     ASSERT_EQ(ctx_.memory.cost, 9);
     ASSERT_EQ(ctx_.gas_remaining, 0);
 }
+
+TEST_F(RuntimeTest, KeccakSingleBlock)
+{
+    std::array<std::uint8_t, KeccakMemo::max_input_size + 1> input;
+    for (auto i = 0u; i < input.size(); ++i) {
+        input[i] = static_cast<std::uint8_t>(i * 7 + 3);
+    }
+
+    for (auto size = 0u; size <= KeccakMemo::max_input_size; ++size) {
+        auto const expected = ethash::keccak256(input.data(), size);
+        ASSERT_EQ(
+            keccak256_single_block(input.data(), size),
+            uint256_t::load_be(expected.bytes));
+    }
+}
+
+TEST_F(RuntimeTest, KeccakMemo)
+{
+    ctx_.gas_remaining = 1'000;
+    call(mstore, 0, 1);
+    call(mstore, 32, 2);
+    auto const first = call(sha3, 0, 64);
+    ASSERT_TRUE(ctx_.keccak_memo.valid);
+    ASSERT_EQ(call(sha3, 0, 64), first);
+
+    // Same offset and size, different contents.
+    call(mstore, 32, 3);
+    auto const second = call(sha3, 0, 64);
+    ASSERT_NE(second, first);
+
+    // Same contents at a different offset.
+    call(mstore, 64, 1);
+    call(mstore, 96, 3);
+    ASSERT_EQ(call(sha3, 64, 64), second);
+
+    // Inputs larger than a single block are not memoized.
+    ctx_.keccak_memo.valid = false;
+    call(sha3, 0, KeccakMemo::max_input_size + 1);
+    ASSERT_FALSE(ctx_.keccak_memo.valid);
+}
@@ -190,6 +190,25 @@ TEST_F(RuntimeTest, MulMod)
         9);
 }
 
+TEST_F(RuntimeTest, MulModRepeatedModulus)
+{
+    auto f = wrap(mulmod);
+
+    auto const p =
+        0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47_u256;
+    auto const x =
+        0x1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef_u256;
+
+    for (auto i = 0; i < 3; ++i) {
+        ASSERT_EQ(f(x, x, p), mulmod(x, x, p));
+        ASSERT_EQ(f(p - 1, p - 1, p), 1);
+    }
+    ASSERT_EQ(ctx_.mulmod_cache.reducer.modulus(), p);
+
+    ASSERT_EQ(f(10, 10, 8), 4);
+    ASSERT_EQ(f(x, x, p), mulmod(x, x, p));
+}
+
 TEST_F(RuntimeTest, ExpOld)
 {
     auto f = wrap(exp<EvmTraits<EVMC_TANGERINE_WHISTLE>>);
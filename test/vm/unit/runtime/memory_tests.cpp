@@ -17,11 +17,14 @@
 
 #include <category/vm/runtime/allocator.hpp>
 #include <category/vm/runtime/memory.hpp>
+#include <category/vm/runtime/memory_reservation.hpp>
 #include <category/vm/runtime/types.hpp>
 #include <category/vm/runtime/uint256.hpp>
 
 #include <algorithm>
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 using namespace monad::vm::runtime;
 using namespace monad::vm::compiler::test;
@@ -233,3 +236,92 @@ TEST_F(RuntimeTest, RuntimeIncreaseMemory)
             return b == 0;
         }));
 }
+
+TEST_F(RuntimeTest, ExpandMemoryReservation)
+{
+    ctx_.gas_remaining = 100'000'000;
+
+    uint32_t const small_size = memory_reservation_threshold / 4;
+    ctx_.expand_memory(Bin<30>::unsafe_from(small_size));
+    ASSERT_EQ(ctx_.memory.capacity, small_size * 2);
+    ctx_.memory.data[small_size - 1] = 0xAB;
+
+    uint32_t const large_size = memory_reservation_threshold;
+    ctx_.expand_memory(Bin<30>::unsafe_from(large_size));
+    ASSERT_EQ(ctx_.memory.size, large_size);
+    ASSERT_EQ(ctx_.memory.capacity, memory_reservation_size);
+    ASSERT_EQ(ctx_.memory.data[small_size - 1], 0xAB);
+    ASSERT_TRUE(std::all_of(
+        ctx_.memory.data + small_size,
+        ctx_.memory.data + ctx_.memory.size,
+        [](auto b) { return b == 0; }));
+
+    // Further expansion happens in place.
+    auto *const data = ctx_.memory.data;
+    ctx_.expand_memory(Bin<30>::unsafe_from(large_size * 8));
+    ASSERT_EQ(ctx_.memory.data, data);
+    ASSERT_EQ(ctx_.memory.size, large_size * 8);
+    ASSERT_EQ(ctx_.memory.data[large_size * 8 - 1], 0);
+}
+
+TEST_F(RuntimeTest, MemoryReservationReuse)
+{
+    auto *const data = reserve_memory();
+    ASSERT_NE(data, nullptr);
+    data[0] = 1;
+    data[memory_reservation_threshold] = 2;
+    release_memory_reservation(data, memory_reservation_threshold + 1);
+
+    auto *const reused = reserve_memory();
+    ASSERT_EQ(reused, data);
+    ASSERT_EQ(reused[0], 0);
+    ASSERT_EQ(reused[memory_reservation_threshold], 0);
+    release_memory_reservation(reused, 0);
+}
+
+TEST(CachedAllocatorPool, SharedAcrossThreads)
+{
+    auto const alloc = EvmMemoryAllocator{2 * EvmMemoryAllocator::alloc_size};
+    alloc.debug_clear_cache();
+    EvmMemoryAllocatorMeta::shared_pool.trim(0);
+
+    std::vector<uint8_t *> ptrs;
+    for (auto i = 0; i < 40; ++i) {
+        ptrs.push_back(alloc.aligned_alloc_cached());
+    }
+    for (auto *const p : ptrs) {
+        alloc.free_cached(p);
+    }
+    ASSERT_LE(EvmMemoryAllocatorMeta::cache_list.size(), 2);
+    auto const pooled = EvmMemoryAllocator::pool_stats().size;
+    ASSERT_GE(pooled, 36);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().high_water, pooled);
+
+    auto const hits = EvmMemoryAllocator::pool_stats().hits;
+    std::thread{[&] {
+        auto *const p = alloc.aligned_alloc_cached();
+        ASSERT_EQ(
+            EvmMemoryAllocatorMeta::cache_list.size(),
+            CachedAllocatorPool::batch_size - 1);
+        alloc.free_cached(p);
+    }}.join();
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().hits, hits + 1);
+    // The other thread's full cache went back to the pool, except for the
+    // freed element that it kept.
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().size, pooled - 1);
+
+    auto const freed = EvmMemoryAllocator::pool_stats().freed;
+    EvmMemoryAllocatorMeta::shared_pool.trim(4);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().size, 4);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().freed, freed + pooled - 5);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().high_water, 4);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().low_water, 4);
+
+    // Nothing was taken from the pool since the trim, so all of it is idle
+    ASSERT_EQ(EvmMemoryAllocatorMeta::shared_pool.trim_idle(), 4);
+    ASSERT_EQ(EvmMemoryAllocator::pool_stats().size, 0);
+    ASSERT_EQ(EvmMemoryAllocatorMeta::shared_pool.trim_idle(), 0);
+
+    alloc.debug_clear_cache();
+    EvmMemoryAllocatorMeta::shared_pool.trim(0);
+}
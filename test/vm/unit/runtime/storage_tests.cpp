@@ -398,3 +398,28 @@ TEST_F(RuntimeTest, StorageCancunOriginalNonEmpty)
     ASSERT_EQ(ctx_.gas_refund, 4800);
     ASSERT_EQ(load(key), 0);
 }
+
+TEST_F(RuntimeTest, StorageCacheWarmLoad)
+{
+    using traits = EvmTraits<EVMC_CANCUN>;
+    auto load = wrap(sload<traits>);
+    auto store = wrap(sstore<traits>);
+
+    ctx_.gas_remaining = 2000;
+    ASSERT_EQ(load(key), 0);
+    ASSERT_EQ(ctx_.gas_remaining, 0);
+
+    // Warm loads are served from the cache without asking the host.
+    auto &loc =
+        host_.accounts[ctx_.env.recipient].storage[bytes32_from_uint256(key)];
+    loc.current = bytes32_from_uint256(val);
+    ASSERT_EQ(load(key), 0);
+
+    ctx_.storage_cache.clear();
+    ASSERT_EQ(load(key), val);
+
+    // Stores update the cached value.
+    ctx_.gas_remaining = 2301;
+    store(key, val_2);
+    ASSERT_EQ(load(key), val_2);
+}
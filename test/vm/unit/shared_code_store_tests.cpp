@@ -0,0 +1,164 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/evm/opcodes.hpp>
+#include <category/vm/shared_code_store.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <ethash/keccak.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+using namespace monad::vm;
+using namespace monad::vm::compiler;
+
+namespace
+{
+    evmc::bytes32 hash_of(Intercode const &icode)
+    {
+        evmc::bytes32 hash;
+        std::memcpy(
+            hash.bytes,
+            ethash::keccak256(icode.code(), icode.size()).bytes,
+            sizeof(hash.bytes));
+        return hash;
+    }
+
+    // The JUMPDEST byte inside the PUSH2 immediate is not a destination
+    SharedIntercode const icode = make_shared_intercode(
+        {PUSH1, 4, JUMP, PUSH2, JUMPDEST, 0, JUMPDEST, PUSH1, 0, JUMPDEST});
+
+    evmc::bytes32 const code_hash = hash_of(*icode);
+
+    // distinct code for tests that need several entries
+    SharedIntercode const icodes[] = {
+        make_shared_intercode({PUSH1, 1, STOP}),
+        make_shared_intercode({PUSH1, 2, STOP}),
+        make_shared_intercode({PUSH1, 3, STOP})};
+
+    struct SharedCodeStoreTest : public testing::Test
+    {
+        std::filesystem::path dir;
+        std::filesystem::path path;
+
+        void SetUp() override
+        {
+            std::string tmpl =
+                (std::filesystem::temp_directory_path() / "codestore_XXXXXX")
+                    .string();
+            ASSERT_NE(mkdtemp(tmpl.data()), nullptr);
+            dir = tmpl;
+            path = dir / "code";
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(dir);
+        }
+    };
+}
+
+TEST_F(SharedCodeStoreTest, insert_and_find)
+{
+    auto const store = SharedCodeStore::open_writable(path, 1 << 20);
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(store->find(code_hash), nullptr);
+    EXPECT_TRUE(store->insert(code_hash, *icode));
+    EXPECT_TRUE(store->insert(code_hash, *icode));
+    EXPECT_EQ(store->stats().entries, 1);
+
+    // a reader maps the same pages and sees later inserts too
+    auto const reader = SharedCodeStore::open(path);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_TRUE(store->insert(hash_of(*icodes[0]), *icodes[0]));
+    for (auto const &expected : {icode, icodes[0]}) {
+        auto const found = reader->find(hash_of(*expected));
+        ASSERT_NE(found, nullptr);
+        ASSERT_EQ(found->size(), expected->size());
+        EXPECT_EQ(
+            std::memcmp(found->code(), expected->code(), expected->size()),
+            0);
+        for (size_t pc = 0; pc <= expected->size(); ++pc) {
+            EXPECT_EQ(found->is_jumpdest(pc), expected->is_jumpdest(pc))
+                << pc;
+        }
+    }
+    EXPECT_EQ(reader->find(hash_of(*icodes[1])), nullptr);
+}
+
+TEST_F(SharedCodeStoreTest, reopen)
+{
+    EXPECT_EQ(SharedCodeStore::open(path), nullptr);
+    {
+        auto const store = SharedCodeStore::open_writable(path, 1 << 20);
+        ASSERT_NE(store, nullptr);
+        EXPECT_TRUE(store->insert(code_hash, *icode));
+    }
+    {
+        // the same size keeps the entries
+        auto const store = SharedCodeStore::open_writable(path, 1 << 20);
+        ASSERT_NE(store, nullptr);
+        EXPECT_NE(store->find(code_hash), nullptr);
+    }
+    {
+        // another size starts over
+        auto const store = SharedCodeStore::open_writable(path, 2 << 20);
+        ASSERT_NE(store, nullptr);
+        EXPECT_EQ(store->find(code_hash), nullptr);
+    }
+}
+
+TEST_F(SharedCodeStoreTest, full)
+{
+    // one entry per 2 KiB of code
+    auto const store = SharedCodeStore::open_writable(path, 4096);
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(store->stats().max_entries, 2);
+    EXPECT_TRUE(store->insert(hash_of(*icodes[0]), *icodes[0]));
+    EXPECT_TRUE(store->insert(hash_of(*icodes[1]), *icodes[1]));
+    EXPECT_FALSE(store->insert(hash_of(*icodes[2]), *icodes[2]));
+    EXPECT_EQ(store->find(hash_of(*icodes[2])), nullptr);
+    EXPECT_NE(store->find(hash_of(*icodes[1])), nullptr);
+}
+
+TEST_F(SharedCodeStoreTest, single_writer)
+{
+    auto store = SharedCodeStore::open_writable(path, 1 << 20);
+    ASSERT_NE(store, nullptr);
+    EXPECT_EQ(SharedCodeStore::open_writable(path, 1 << 20), nullptr);
+    EXPECT_NE(SharedCodeStore::open(path), nullptr);
+    store.reset();
+    EXPECT_NE(SharedCodeStore::open_writable(path, 1 << 20), nullptr);
+}
+
+TEST_F(SharedCodeStoreTest, code_not_matching_its_hash)
+{
+    auto const store = SharedCodeStore::open_writable(path, 1 << 20);
+    ASSERT_NE(store, nullptr);
+    evmc::bytes32 const wrong_hash{0x1234};
+    EXPECT_TRUE(store->insert(wrong_hash, *icode));
+    EXPECT_EQ(store->find(wrong_hash), nullptr);
+    auto const reader = SharedCodeStore::open(path);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->find(wrong_hash), nullptr);
+}
@@ -527,6 +527,37 @@ TEST(uint256, division)
     }
 }
 
+TEST(uint256, barrett_mulmod)
+{
+    constexpr auto bn254_prime =
+        0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47_u256;
+    constexpr auto max = std::numeric_limits<uint256_t>::max();
+
+    ASSERT_FALSE(barrett_reducer::supports(uint256_t{1} << 192));
+    ASSERT_FALSE(barrett_reducer::supports(uint256_t{1} << 191));
+    ASSERT_TRUE(barrett_reducer::supports((uint256_t{1} << 192) + 1));
+
+    auto moduli = std::vector<uint256_t>{
+        bn254_prime, max, (uint256_t{1} << 192) + 1, uint256_t{1} << 255};
+    for (auto const &z : test_inputs) {
+        if (barrett_reducer::supports(z)) {
+            moduli.push_back(z);
+        }
+    }
+
+    for (auto const &z : moduli) {
+        auto const reducer = barrett_reducer{z};
+        ASSERT_EQ(reducer.modulus(), z);
+        for (auto const &x : test_inputs) {
+            for (auto const &y : test_inputs) {
+                ASSERT_EQ(reducer.mulmod(x, y), mulmod(x, y, z));
+            }
+            ASSERT_EQ(reducer.mulmod(x, max), mulmod(x, max, z));
+        }
+        ASSERT_EQ(reducer.mulmod(z - 1, z - 1), mulmod(z - 1, z - 1, z));
+    }
+}
+
 TEST(uint256, predicates)
 {
     for (auto const &x : test_inputs) {
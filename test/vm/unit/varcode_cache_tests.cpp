@@ -0,0 +1,106 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/vm/code.hpp>
+#include <category/vm/utils/frequency_sketch.hpp>
+#include <category/vm/varcode_cache.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace monad::vm;
+
+TEST(FrequencySketch, counts_and_saturates)
+{
+    utils::FrequencySketch sketch{64};
+    EXPECT_EQ(sketch.frequency(1), 0);
+    for (int i = 0; i < 3; ++i) {
+        sketch.increment(1);
+    }
+    EXPECT_EQ(sketch.frequency(1), 3);
+    for (int i = 0; i < 100; ++i) {
+        sketch.increment(2);
+    }
+    EXPECT_EQ(sketch.frequency(2), utils::FrequencySketch::max_frequency);
+}
+
+TEST(FrequencySketch, ages)
+{
+    // Each row has 64 counters, so all counters are halved after 640
+    // counted accesses.
+    utils::FrequencySketch sketch{64};
+    for (int i = 0; i < 20; ++i) {
+        sketch.increment(1);
+    }
+    ASSERT_EQ(sketch.frequency(1), utils::FrequencySketch::max_frequency);
+    for (uint64_t k = 0; k < 700; ++k) {
+        sketch.increment(1000 + k);
+    }
+    EXPECT_LT(sketch.frequency(1), utils::FrequencySketch::max_frequency);
+}
+
+TEST(VarcodeCache, frequency_admission)
+{
+    // Each entry weighs 3kB, so the cache holds two at a time.
+    VarcodeCache cache{7, 7};
+    auto const icode = make_shared_intercode({0x00});
+    cache.try_set(evmc::bytes32{1}, icode);
+    cache.try_set(evmc::bytes32{2}, icode);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(cache.get(evmc::bytes32{1}).has_value());
+        ASSERT_TRUE(cache.get(evmc::bytes32{2}).has_value());
+    }
+
+    // A contract looked up once does not displace either of them.
+    EXPECT_FALSE(cache.get(evmc::bytes32{3}).has_value());
+    auto const vcode = cache.try_set(evmc::bytes32{3}, icode);
+    EXPECT_EQ(vcode->intercode(), icode);
+    EXPECT_FALSE(cache.get(evmc::bytes32{3}).has_value());
+    EXPECT_TRUE(cache.get(evmc::bytes32{1}).has_value());
+    EXPECT_TRUE(cache.get(evmc::bytes32{2}).has_value());
+
+    // Once it is looked up more often than the least recently used
+    // entry, it is admitted.
+    for (int i = 0; i < 8; ++i) {
+        (void)cache.get(evmc::bytes32{3});
+    }
+    cache.try_set(evmc::bytes32{3}, icode);
+    EXPECT_TRUE(cache.get(evmc::bytes32{3}).has_value());
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(VarcodeCache, shards)
+{
+    EXPECT_EQ(VarcodeCache{}.shard_count(), VarcodeCache::max_shard_count);
+    EXPECT_EQ((VarcodeCache{VarcodeCache::min_shard_kb, 0}.shard_count()), 1);
+    EXPECT_EQ(
+        (VarcodeCache{4 * VarcodeCache::min_shard_kb, 0}.shard_count()), 4);
+
+    VarcodeCache cache{16 * VarcodeCache::min_shard_kb, 0};
+    auto const icode = make_shared_intercode({0x00});
+    for (uint64_t i = 0; i < 100; ++i) {
+        cache.try_set(evmc::bytes32{i}, icode);
+    }
+    EXPECT_EQ(cache.size(), 100);
+    EXPECT_EQ(
+        cache.approx_weight(),
+        100 * VarcodeCache::code_size_to_cache_weight(1));
+    for (uint64_t i = 0; i < 100; ++i) {
+        EXPECT_TRUE(cache.get(evmc::bytes32{i}).has_value());
+    }
+}
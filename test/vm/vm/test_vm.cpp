@@ -113,6 +113,19 @@ namespace
             debug_trace_env && std::strcmp(debug_trace_env, "1") == 0;
         return debug_trace;
     }
+
+    basic_blocks::PassConfig ir_passes_from_env()
+    {
+        static auto *const ir_passes_env =
+            std::getenv("MONAD_COMPILER_IR_PASSES");
+        static bool const ir_passes =
+            ir_passes_env && std::strcmp(ir_passes_env, "1") == 0;
+        return {
+            .fold_constants = ir_passes,
+            .eliminate_dead_stack_ops = ir_passes,
+            .resolve_known_jumps = ir_passes,
+            .merge_jumpdest_gas_checks = ir_passes};
+    }
 }
 
 BlockchainTestVM::BlockchainTestVM(
@@ -123,7 +136,8 @@ BlockchainTestVM::BlockchainTestVM(
     , base_config{
           .runtime_debug_trace = is_compiler_runtime_debug_trace_enabled(),
           .max_code_size_offset = code_size_t::max(),
-          .post_instruction_emit_hook = post_hook}
+          .post_instruction_emit_hook = post_hook,
+          .ir_passes = ir_passes_from_env()}
 {
     MONAD_VM_ASSERT(!debug_dir_ || fs::is_directory(debug_dir_));
 }